@@ -17,6 +17,8 @@ def configure_deps(conf, local = True, with_openssl = True):
     conf.CBConfig('sqlite3', not local)
     conf.CBConfig('libyaml', not local)
     conf.CBConfig('leveldb', False)
+    conf.CBConfig('zstd', False)
+    conf.CBConfig('lz4', False)
 
     env.AppendUnique(prefer_dynamic = ['mariadbclient'])
     if conf.CBCheckCHeader('mysql/mysql.h') and \
@@ -59,6 +61,10 @@ def configure_deps(conf, local = True, with_openssl = True):
 
     conf.CBConfig('valgrind', False)
 
+    # Linux io_uring, used through raw system calls
+    if env['PLATFORM'] == 'posix' and conf.CBCheckCHeader('linux/io_uring.h'):
+        env.CBConfigDef('HAVE_IO_URING')
+
     # Debug
     if env.get('debug', 0):
         if conf.CBCheckCHeader('execinfo.h') and \
@@ -102,7 +108,7 @@ def generate(env):
         ('debug_level', 'Set log debug level', 1))
 
     env.CBLoadTools('''sqlite3 openssl pthreads valgrind osx zlib bzip2
-        XML chakra v8 event re2 libyaml leveldb'''.split(), GetHome() + '/..')
+        XML chakra v8 event re2 libyaml leveldb zstd lz4'''.split(), GetHome() + '/..')
 
 
 def exists(env):
@@ -0,0 +1,17 @@
+from SCons.Script import *
+
+
+def configure(conf):
+    conf.CBCheckHome('lz4', lib_suffix = ['', '/lib'],
+                     inc_suffix = ['/lib', '/include'])
+    conf.CBRequireHeader('lz4frame.h')
+    conf.CBRequireLib('lz4')
+    conf.env.CBConfigDef('HAVE_LZ4')
+
+
+def generate(env):
+    env.CBAddConfigTest('lz4', configure)
+
+
+def exists():
+    return 1
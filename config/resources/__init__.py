@@ -8,6 +8,14 @@ import time
 import textwrap
 import stat
 import shutil
+import hashlib
+import gzip
+import io
+import struct
+
+try:
+    import brotli
+except ImportError: brotli = None
 
 from SCons.Script import *
 
@@ -65,6 +73,38 @@ def is_excluded(exclude, path):
     return exclude != None and exclude.search(path) != None
 
 
+def write_data(ctx, output, out, name, data):
+    prototype = 'extern const unsigned char %s[]' % name
+
+    write_string(ctx, output, '%s;\n' % prototype)
+    write_string(ctx, out, prototype + ' = {', True)
+
+    for c in bytearray(data):
+        write_string(ctx, out, '%d,' % c)
+
+    write_string(ctx, out, '0};\n')
+
+
+def get_encodings(ctx, data):
+    encodings = []
+    if not ctx.compress: return encodings
+
+    buf = io.BytesIO()
+    with gzip.GzipFile(fileobj = buf, mode = 'wb', mtime = 0) as f:
+        f.write(data)
+    compressed = buf.getvalue()
+
+    if len(compressed) < len(data) * 0.9:
+        encodings.append(('gz', compressed))
+
+    if brotli is not None:
+        compressed = brotli.compress(data)
+        if len(compressed) < len(data) * 0.9:
+            encodings.append(('br', compressed))
+
+    return encodings
+
+
 def write_resource(ctx, output, data_dir, path, children = None,
                    exclude = None):
     name = os.path.basename(path)
@@ -73,7 +113,6 @@ def write_resource(ctx, output, data_dir, path, children = None,
     is_dir = os.path.isdir(path)
     id = ctx.next_id
     ctx.next_id += 1
-    length = 0
 
     if is_dir:
         typeStr = 'Directory'
@@ -95,27 +134,20 @@ def write_resource(ctx, output, data_dir, path, children = None,
         print('Writing resource: %s to %s' % (path, out_path))
 
         typeStr = 'File'
-        f = open(path, 'rb')
-
-        prototype = 'extern const unsigned char data%d[]' % id
-
-        write_string(ctx, output, '%s;\n' % prototype)
+        with open(path, 'rb') as f: data = f.read()
+        etag = hashlib.sha256(data).hexdigest()[:32]
+        encodings = get_encodings(ctx, data)
 
         out = start_file(ctx, out_path)
 
-        write_string(ctx, out, prototype + ' = {')
-
-        while True:
-            count = 0
-            for c in f.read(102400):
-                if not isinstance(c, int): c = ord(c)
-                write_string(ctx, out, '%d,' % c)
-                count += 1
+        write_data(ctx, output, out, 'data%d' % id, data)
 
-            if count == 0: break
-            length += count
-
-        write_string(ctx, out, '0};\n')
+        # Precompressed variants
+        for ext, encoded in encodings:
+            write_data(ctx, output, out, 'data%d_%s' % (id, ext), encoded)
+            output.write('const FileResource resource%d_%s("%s", '
+                         '(const char *)data%d_%s, %d, "\\"%s-%s\\"");\n' %
+                         (id, ext, name, id, ext, len(encoded), etag, ext))
 
         end_file(ctx, out)
 
@@ -125,7 +157,13 @@ def write_resource(ctx, output, data_dir, path, children = None,
                  (typeStr, id, name))
 
     if is_dir: output.write('children%d' % id)
-    else: output.write('(const char *)data%d, %d' % (id, length))
+    else:
+        encoded = dict(encodings)
+        variants = ''.join([', &resource%d_%s' % (id, ext)
+                            if ext in encoded else ', 0'
+                            for ext in ('gz', 'br')])
+        output.write('(const char *)data%d, %d, "\\"%s\\""%s' %
+                     (id, len(data), etag, variants))
 
     output.write(');\n')
 
@@ -164,6 +202,7 @@ def resources_build(target, source, env):
     ctx.env = env
     ctx.ns = env.get('RESOURCES_NS')
     ctx.exclude = get_exclude(env)
+    ctx.compress = env.get('RESOURCES_COMPRESS')
     ctx.next_id = 0
     ctx.col = 0
 
@@ -195,6 +234,100 @@ def resources_build(target, source, env):
     end_file(ctx, f)
 
 
+# Resource bundles, see cbang/util/ResourceBundle.h
+BUNDLE_ENTRY = '>QQQQIIIIII'
+BUNDLE_DIRECTORY = 1
+
+
+def bundle_children(ctx, path):
+    names = sorted(os.listdir(path))
+    paths = [os.path.join(path, name) for name in names]
+    return [p for p in paths if not is_excluded(ctx.exclude, p)]
+
+
+def bundle_fill(ctx, entries, blobs, index, path):
+    entry = entries[index]
+    entry['name'] = blobs.add(os.path.basename(path).encode() + b'\0')
+
+    if os.path.isdir(path):
+        children = bundle_children(ctx, path)
+        entry['flags'] = BUNDLE_DIRECTORY
+        entry['first'] = len(entries) if children else 0
+        entry['count'] = len(children)
+
+        # Children are consecutive entries
+        first = len(entries)
+        for i in range(len(children)): entries.append({})
+        for i, child in enumerate(children):
+            bundle_fill(ctx, entries, blobs, first + i, child)
+
+    else:
+        print('Bundling resource: %s' % path)
+        with open(path, 'rb') as f: data = f.read()
+        etag = hashlib.sha256(data).hexdigest()[:32]
+
+        entry['data'] = blobs.add(data)
+        entry['length'] = len(data)
+        entry['etag'] = blobs.add(('"%s"\0' % etag).encode())
+
+        # Precompressed variants
+        for ext, encoded in get_encodings(ctx, data):
+            entries.append(dict(
+                name = entry['name'], data = blobs.add(encoded),
+                length = len(encoded),
+                etag = blobs.add(('"%s-%s"\0' % (etag, ext)).encode())))
+            entry['gzip' if ext == 'gz' else 'brotli'] = len(entries) - 1
+
+
+class BundleBlobs:
+    def __init__(self):
+        self.data = io.BytesIO()
+
+    def add(self, data):
+        offset = self.data.tell()
+        self.data.write(data)
+        return offset
+
+
+def bundle_build(target, source, env):
+    ctx = ResourceContext()
+    ctx.exclude = get_exclude(env)
+    ctx.compress = env.get('RESOURCES_COMPRESS')
+
+    entries = [{}]
+    blobs = BundleBlobs()
+    sources = [str(src) for src in source]
+
+    # A single source is the root, otherwise they share an unnamed root
+    if len(sources) == 1: bundle_fill(ctx, entries, blobs, 0, sources[0])
+    else:
+        entries[0] = dict(name = blobs.add(b'\0'), flags = BUNDLE_DIRECTORY,
+                          first = 1, count = len(sources))
+        for src in sources: entries.append({})
+        for i, src in enumerate(sources):
+            bundle_fill(ctx, entries, blobs, i + 1, src)
+
+    # Blob offsets follow the header and entry table
+    base = 16 + struct.calcsize(BUNDLE_ENTRY) * len(entries)
+
+    with open(str(target[0]), 'wb') as f:
+        f.write(b'CBRB' + struct.pack('>III', 1, len(entries), 0))
+
+        for e in entries:
+            offset = lambda name: base + e[name] if name in e else 0
+            f.write(struct.pack(BUNDLE_ENTRY, offset('name'), offset('data'),
+                                e.get('length', 0), offset('etag'),
+                                e.get('flags', 0), e.get('first', 0),
+                                e.get('count', 0), e.get('gzip', 0),
+                                e.get('brotli', 0), 0))
+
+        f.write(blobs.data.getvalue())
+
+
+def bundle_message(target, source, env):
+    return 'building resource bundle "%s"' % str(target[0])
+
+
 def get_targets(exclude, path, data_dir, count = [0]):
     if is_excluded(exclude, path): return []
 
@@ -233,6 +366,7 @@ def generate(env):
     env.SetDefault(RESOURCES_NS = '')
     env.SetDefault(RESOURCES_EXCLUDES = [r'\.svn', r'.*~'])
     env.SetDefault(RESOURCES_ALWAYS_BUILD = True)
+    env.SetDefault(RESOURCES_COMPRESS = True)
 
     bld = env.Builder(action = resources_build,
                       source_factory = SCons.Node.FS.Entry,
@@ -240,6 +374,11 @@ def generate(env):
                       emitter = modify_targets)
     env.Append(BUILDERS = {'Resources' : bld})
 
+    bld = env.Builder(action = Action(bundle_build, bundle_message),
+                      source_factory = SCons.Node.FS.Entry,
+                      source_scanner = SCons.Defaults.DirScanner)
+    env.Append(BUILDERS = {'ResourceBundle' : bld})
+
 
 def exists():
     return True
@@ -17,6 +17,10 @@ def configure(conf):
 
     env.CBConfigDef('HAVE_LIBSQLITE')
 
+    # Only built with SQLITE_ENABLE_UNLOCK_NOTIFY
+    if conf.CBCheckFunc('sqlite3_unlock_notify'):
+        env.CBConfigDef('HAVE_SQLITE_UNLOCK_NOTIFY')
+
 
 def generate(env):
     env.CBAddConfigTest('sqlite3', configure)
@@ -0,0 +1,18 @@
+from SCons.Script import *
+
+
+def configure(conf):
+    conf.CBCheckHome('zstd', lib_suffix = ['', '/lib'],
+                     inc_suffix = ['/lib', '/include'])
+    conf.CBRequireHeader('zstd.h')
+    conf.CBRequireLib('zstd')
+    conf.CBRequireFunc('ZSTD_compressStream2')
+    conf.env.CBConfigDef('HAVE_ZSTD')
+
+
+def generate(env):
+    env.CBAddConfigTest('zstd', configure)
+
+
+def exists():
+    return 1
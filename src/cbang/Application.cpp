@@ -39,6 +39,7 @@
 #include <cbang/os/SystemUtilities.h>
 #include <cbang/os/SystemInfo.h>
 #include <cbang/os/SignalManager.h>
+#include <cbang/os/PowerManagement.h>
 
 #include <cbang/time/Timer.h>
 #include <cbang/time/Time.h>
@@ -56,6 +57,8 @@
 
 #include <sstream>
 #include <set>
+#include <thread>
+#include <exception>
 
 #ifndef _WIN32
 #include <sys/resource.h>
@@ -76,11 +79,19 @@ namespace cb {
 }
 
 
+struct Application::InitTask {
+  std::thread thread;
+  exception_ptr error;
+};
+
+
 Application::Application(const string &name, hasFeature_t hasFeature) :
   Features(hasFeature), Environment(name), logger(Logger::instance()),
   enumMan(new EnumerationManager(*this)), name(name), configRotate(true),
   configRotateMax(16), configRotateDir("configs"), initialized(false),
-  configured(false), quit(false), startTime(Timer::now()) {
+  configured(false), quit(false), startTime(Timer::now()),
+  profileStartup(SystemUtilities::getenv("STARTUP_PROFILE")),
+  lastPhaseTime(startTime) {
 
   // Core dumps
 #if defined(DEBUG) && !defined(_WIN32)
@@ -124,6 +135,7 @@ Application::Application(const string &name, hasFeature_t hasFeature) :
   }
 
   logger.addOptions(options);
+  startupPhase("options");
 
   // Command line
   if (hasFeature(FEATURE_CONFIG_FILE)) {
@@ -149,17 +161,18 @@ Application::Application(const string &name, hasFeature_t hasFeature) :
 
   cmdLine.popCategory();
   cmdLine.setKeywordOptions(&options);
+  startupPhase("command line");
 
   // Info
   if (hasFeature(FEATURE_INFO)) {
     Info &info = Info::instance();
     BuildInfo::addBuildInfo("CBang");
+    info.add("System"); // Filled in by init()
 
-    // Add to info
-    SystemInfo::instance().add(info);
-    info.add("System", "UTC Offset", String(Time::offset() / 3600));
-    info.add("System", "PID", String(SystemUtilities::getPID()));
-    info.add("System", "CWD", SystemUtilities::getcwd());
+    // Gather system info in parallel, singletons are created here first
+    SystemInfo::instance();
+    PowerManagement::instance();
+    addInitTask([this] () {SystemInfo::instance().getInfo(systemInfo);});
   }
 
   // Script functions
@@ -177,10 +190,13 @@ Application::Application(const string &name, hasFeature_t hasFeature) :
     for (unsigned i = 0; licenses->getChild(i); i++)
       cmdLine.addLicenseText(licenses->getChild(i)->getData());
   else LOG_ERROR("Error loading licenses");
+
+  startupPhase("setup");
 }
 
 
 Application::~Application() {
+  TRY_CATCH_ERROR(joinInitTasks());
   zap(enumMan);
 
 #ifdef DEBUG_LEAKS
@@ -206,11 +222,78 @@ bool Application::_hasFeature(int feature) {
 double Application::getUptime() const {return Timer::now() - startTime;}
 
 
+void Application::startupPhase(const string &name) {
+  if (!profileStartup) return;
+
+  double now = Timer::now();
+  startupPhases.push_back(make_pair(name, now - lastPhaseTime));
+  lastPhaseTime = now;
+}
+
+
+void Application::printStartupProfile() const {
+  if (!profileStartup) return;
+
+  LOG_INFO(1, "Startup profile:");
+  for (unsigned i = 0; i < startupPhases.size(); i++)
+    LOG_INFO(1, "  " << startupPhases[i].first << ": "
+             << String::printf("%0.3fms", startupPhases[i].second * 1000));
+
+  LOG_INFO(1, "  total: "
+           << String::printf("%0.3fms", (lastPhaseTime - startTime) * 1000));
+}
+
+
+void Application::addInitTask(const function<void ()> &task) {
+  SmartPointer<InitTask> t = new InitTask;
+  InitTask *ptr = t.get(); // Owned by initTasks until joined
+
+  t->thread = std::thread([ptr, task] () {
+      try {
+        task();
+      } catch (...) {
+        ptr->error = current_exception();
+      }
+    });
+
+  initTasks.push_back(t);
+}
+
+
+void Application::joinInitTasks() {
+  exception_ptr error;
+
+  for (unsigned i = 0; i < initTasks.size(); i++) {
+    initTasks[i]->thread.join();
+    if (!error) error = initTasks[i]->error;
+  }
+
+  initTasks.clear();
+  startupPhase("init tasks");
+
+  if (error) rethrow_exception(error);
+}
+
+
 int Application::init(int argc, char *argv[]) {
   if (initialized) THROW("Already initialized");
   initialized = true;
   quit = false;
 
+  joinInitTasks();
+
+  if (hasFeature(FEATURE_INFO)) {
+    Info &info = Info::instance();
+
+    for (unsigned i = 0; i < systemInfo.size(); i++)
+      info.add("System", systemInfo[i].first, systemInfo[i].second);
+    systemInfo.clear();
+
+    info.add("System", "UTC Offset", String(Time::offset() / 3600));
+    info.add("System", "PID", String(SystemUtilities::getPID()));
+    info.add("System", "CWD", SystemUtilities::getcwd());
+  }
+
   if (hasFeature(FEATURE_INFO) && !version.toU32()) {
     if (Info::instance().has(name, "Version"))
       version = Version(Info::instance().get(name, "Version"));
@@ -252,11 +335,13 @@ int Application::init(int argc, char *argv[]) {
   int ret = cmdLine.parse(argc, argv);
   if (ret == -1) return -1;
   afterCommandLineParse();
+  startupPhase("parse args");
 
   // Load default config
   if (hasFeature(FEATURE_CONFIG_FILE) && cmdLine["--config"].hasValue() &&
       !configured && SystemUtilities::exists(cmdLine["--config"]))
     configAction(cmdLine["--config"]);
+  startupPhase("config");
 
   logger.setOptions(options);
   LOG_DEBUG(3, "Initializing " << name);
@@ -272,8 +357,12 @@ int Application::init(int argc, char *argv[]) {
     catchExitSignals(); // Also enables SignalManager
 
   if (hasFeature(FEATURE_PRINT_INFO)) printInfo();
+  startupPhase("print info");
 
   initialize();
+  startupPhase("initialize");
+  printStartupProfile();
+
   return ret;
 }
 
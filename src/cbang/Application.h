@@ -47,6 +47,9 @@
 #include <cbang/script/Environment.h>
 
 #include <string>
+#include <vector>
+#include <utility>
+#include <functional>
 
 namespace cb {
   class Logger;
@@ -93,6 +96,14 @@ namespace cb {
 
     double startTime;
 
+    bool profileStartup;
+    double lastPhaseTime;
+    std::vector<std::pair<std::string, double> > startupPhases;
+
+    struct InitTask;
+    std::vector<SmartPointer<InitTask> > initTasks;
+    std::vector<std::pair<std::string, std::string> > systemInfo;
+
   public:
     Application(const std::string &name,
                 hasFeature_t hasFeature = Application::_hasFeature);
@@ -117,6 +128,18 @@ namespace cb {
 
     double getUptime() const;
 
+    /// Record the time since the last phase, if STARTUP_PROFILE is set
+    void startupPhase(const std::string &name);
+    void printStartupProfile() const;
+
+    /**
+     * Run @param task in a thread, in parallel with the rest of startup.
+     * Tasks must not depend on each other or on other startup code.  They
+     * are joined, and the first error rethrown, at the start of init().
+     */
+    void addInitTask(const std::function<void ()> &task);
+    void joinInitTasks();
+
     virtual int init(int argc, char *argv[]);
     virtual void afterCommandLineParse() {}
     virtual void initialize() {}
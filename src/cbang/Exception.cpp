@@ -97,6 +97,12 @@ unsigned Exception::causePrintLevel = 10;
 Exception::Exception(const string &message, int code,
                      const FileLocation &location,
                      const SmartPointer<Exception> &cause) :
+  Exception(message, code, location, cause, true) {}
+
+
+Exception::Exception(const string &message, int code,
+                     const FileLocation &location,
+                     const SmartPointer<Exception> &cause, bool withTrace) :
   message(message), code(code), location(location), cause(cause) {
 
 #if defined(_WIN32) && !defined(__MINGW32__)
@@ -104,9 +110,9 @@ Exception::Exception(const string &message, int code,
 #endif
 
 #ifdef HAVE_CBANG_BACKTRACE
-  if (enableStackTraces) {
-    trace = new StackTrace();
-    Debugger::instance().getStackTrace(*trace);
+  if (enableStackTraces && withTrace) {
+    trace = new StackTrace;
+    trace->capture(); // Symbolized on first use
   }
 #endif
 }
@@ -121,15 +127,23 @@ ostream &Exception::print(ostream &stream, unsigned level) const {
     stream << "\n       At: " << location;
 
   if (!trace.isNull()) {
+    trace->resolve();
+
     unsigned count = 0;
-    unsigned i = 0;
+    bool skip = true;
 
+    // Skip the frames which captured the trace
     StackTrace::iterator it;
-    for (it = trace->begin(); it != trace->end(); it++, i++) {
-      if (i < 3 && (it->getFunction().find("Debugger") ||
-                    it->getFunction().find("Exception")))
+    for (it = trace->begin(); it != trace->end(); it++) {
+      const string &func = it->getFunction();
+
+      if (skip && (func.find("Debugger") != string::npos ||
+                   func.find("StackTrace::capture") != string::npos ||
+                   func.find("Exception::Exception") != string::npos))
         continue;
-      else  stream << "\n  #" << ++count << ' ' << *it;
+
+      skip = false;
+      stream << "\n  #" << ++count << ' ' << *it;
     }
   }
 
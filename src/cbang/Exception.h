@@ -57,6 +57,12 @@ namespace cb {
    *   - FileLocation indicating where the exception occured.
    *   - A pointer to an exception which was the original cause.
    *   - A stack trace.
+   *
+   * When enableStackTraces is set only the return addresses are captured
+   * on construction.  They are symbolized the first time the trace is
+   * printed, written or accessed via getStackTrace().  Subclasses used for
+   * expected errors can skip the capture entirely by passing false for
+   * withTrace to the protected constructor.
    */
   class Exception : public std::exception {
   private:
@@ -86,6 +92,12 @@ namespace cb {
               const Exception &cause, int code = 0) :
       Exception(message, code, location, new Exception(cause)) {}
 
+  protected:
+    Exception(const std::string &message, int code,
+              const FileLocation &location,
+              const SmartPointer<Exception> &cause, bool withTrace);
+
+  public:
     /// Copy constructor
     Exception(const Exception &e) :
       message(e.message), code(e.code), location(e.location), cause(e.cause),
@@ -125,7 +137,9 @@ namespace cb {
      */
     SmartPointer<Exception> getCause() const {return cause;}
     void setCause(SmartPointer<Exception> cause) {this->cause = cause;}
-    SmartPointer<StackTrace> getStackTrace() const {return trace;}
+    bool hasStackTrace() const {return trace.isSet();}
+    SmartPointer<StackTrace> getStackTrace() const
+    {if (trace.isSet()) trace->resolve(); return trace;}
     void setStackTrace(SmartPointer<StackTrace> trace) {this->trace = trace;}
 
     /**
@@ -34,9 +34,9 @@
 
 #include "Deallocators.h"
 
-#include <cbang/os/Mutex.h>
-
+#include <string>
 #include <typeinfo>
+#include <atomic>
 
 
 namespace cb {
@@ -76,12 +76,55 @@ namespace cb {
   };
 
 
+  /**
+   * A RefCounter stored inside a RefCounted object, so that the first
+   * SmartPointer to the object does not have to allocate one.
+   */
+  class InlineRefCounter : public RefCounter {
+    unsigned count = 0;
+    void (*dealloc)(const void *ptr) = 0;
+
+    template<typename T, class Dealloc_T>
+    static void deallocT(const void *ptr) {Dealloc_T::dealloc((T *)ptr);}
+
+  public:
+    template<typename T, class Dealloc_T>
+    void init() {
+      count = 0;
+      dealloc = &deallocT<T, Dealloc_T>;
+    }
+
+    // From RefCounter
+    unsigned getCount() const {return count;}
+    void incCount() {count++;}
+
+    void decCount(const void *ptr) {
+      if (!count) raise("Already zero!");
+      // Deallocating the object also destroys this counter
+      if (!--count && ptr) dealloc(ptr);
+    }
+  };
+
+
   class RefCounted {
     RefCounter *counter = 0;
+    InlineRefCounter inlineCounter;
     friend class RefCounter;
 
   public:
+    RefCounted() {}
+    // A copy is a new object with its own references
+    RefCounted(const RefCounted &o) {}
+    RefCounted &operator=(const RefCounted &o) {return *this;}
+
     unsigned getRefCount() const {return counter ? counter->getCount() : 0;}
+
+    template<typename T, class Dealloc_T>
+    static RefCounter *createInlineCounter(const RefCounted *ref) {
+      InlineRefCounter &c = const_cast<RefCounted *>(ref)->inlineCounter;
+      c.init<T, Dealloc_T>();
+      return &c;
+    }
   };
 
 
@@ -119,51 +162,47 @@ namespace cb {
   };
 
 
+  /// A thread safe RefCounter using an atomic count rather than a lock
   template<typename T, class Dealloc_T = DeallocNew<T> >
-  class ProtectedRefCounterImpl :
-    public RefCounterImpl<T, Dealloc_T>, public Mutex {
+  class ProtectedRefCounterImpl : public RefCounter {
   protected:
-    typedef RefCounterImpl<T, Dealloc_T> Super_T;
-    using Super_T::count;
+    std::atomic<unsigned> count;
 
   public:
-    ProtectedRefCounterImpl(unsigned count = 0) : Super_T(count) {}
+    ProtectedRefCounterImpl(unsigned count = 0) : count(count) {}
     static RefCounter *create() {return new ProtectedRefCounterImpl;}
     static bool staticIsProtected() {return true;}
 
-    // From RefCounterImpl
-    bool isProtected() const {return true;}
-
-    unsigned getCount() const {
-      lock();
-      unsigned x = count;
-      unlock();
-      return x;
+    void release(const void *ptr) {
+      delete this;
+      if (ptr) Dealloc_T::dealloc((T *)ptr);
     }
 
+    // From RefCounter
+    bool isProtected() const {return true;}
+    unsigned getCount() const {return count.load(std::memory_order_acquire);}
+
     void incCount() {
-      lock();
-      count++;
 #ifdef DEBUG
-      Super_T::log(typeid(T).name(), count);
+      log(typeid(T).name(), count.fetch_add(1, std::memory_order_relaxed) + 1);
+#else
+      count.fetch_add(1, std::memory_order_relaxed);
 #endif
-      unlock();
     }
 
     void decCount(const void *ptr) {
-      lock();
-
-      if (!count) {unlock(); Super_T::raise("Already zero!");}
+      // Never decrement past zero
+      unsigned x = count.load(std::memory_order_relaxed);
+      do {
+        if (!x) raise("Already zero!");
+      } while (!count.compare_exchange_weak(x, x - 1, std::memory_order_acq_rel,
+                                            std::memory_order_relaxed));
 
 #ifdef DEBUG
-      Super_T::log(typeid(T).name(), count - 1);
+      log(typeid(T).name(), x - 1);
 #endif
 
-      if (!--count) {
-        unlock();
-        Super_T::release(ptr);
-
-      } else unlock();
+      if (x == 1) release(ptr);
     }
   };
 
@@ -36,6 +36,7 @@
 #include <cbang/os/SignalManager.h>
 #include <cbang/os/ProcessLock.h>
 #include <cbang/os/Subprocess.h>
+#include <cbang/socket/SocketHandoff.h>
 
 #include <cbang/log/Logger.h>
 #include <cbang/time/Time.h>
@@ -57,7 +58,8 @@ using namespace std;
 
 ServerApplication::ServerApplication(const string &name,
                                      hasFeature_t hasFeature) :
-  Application(name, hasFeature), restartChild(false), lifeline(0) {
+  Application(name, hasFeature), restartChild(false), hotRestartChild(false),
+  lifeline(0) {
 
   if (hasFeature(FEATURE_LIFELINE))
     cmdLine.addTarget("lifeline", lifeline, "The application will watch for "
@@ -87,6 +89,17 @@ ServerApplication::ServerApplication(const string &name,
   options.add("child", "Disable 'daemon', 'fork', 'pid' and 'respawn' options. "
               "Also defaults 'log-to-screen' to false. Used internally."
               )->setDefault(false);
+#ifndef _WIN32
+  options.add("hot-restart-socket", "Path of a Unix socket on which listening "
+              "sockets are handed to a replacement process.  With 'respawn', "
+              "SIGUSR2 starts a new child which takes over the listeners "
+              "while the old child drains its connections.");
+  options.add("hot-restart", "Take over the listening sockets of the process "
+              "serving 'hot-restart-socket' before binding."
+              )->setDefault(false);
+  options.add("hot-restart-timeout", "Seconds to let connections finish after "
+              "the listeners have been handed off.")->setDefault(30);
+#endif
 
   options.add("daemon", 0, this, &ServerApplication::daemonAction,
               "Short for --pid --service --respawn --log=''"
@@ -169,8 +182,9 @@ int ServerApplication::init(int argc, char *argv[]) {
 
   if (!options["child"].toBoolean() && options["respawn"].toBoolean()) {
 #ifndef _WIN32
-    // Child restart handler
+    // Child restart handlers
     SignalManager::instance().addHandler(SIGUSR1, this);
+    SignalManager::instance().addHandler(SIGUSR2, this);
 #endif
 
     // Setup child arguments
@@ -187,6 +201,11 @@ int ServerApplication::init(int argc, char *argv[]) {
 
     unsigned lastRespawn = 0;
     unsigned respawnCount = 0;
+    unsigned flags = Subprocess::NULL_STDOUT | Subprocess::NULL_STDERR;
+
+    // A child which has handed its listeners to its replacement
+    SmartPointer<Subprocess> retiring;
+    uint64_t retireKillTime = 0;
 
     while (!shouldQuit()) {
       // Check respawn rate
@@ -200,15 +219,16 @@ int ServerApplication::init(int argc, char *argv[]) {
       lastRespawn = now;
 
       // Spawn child
-      Subprocess child;
-      child.exec(args, Subprocess::NULL_STDOUT | Subprocess::NULL_STDERR);
+      SmartPointer<Subprocess> child = new Subprocess;
+      child->exec(args, flags);
 
       uint64_t killTime = 0;
-      while (child.isRunning()) {
+      while (child->isRunning()) {
         if (!killTime && (restartChild || shouldQuit())) {
-          LOG_INFO(1, "Shutting down child at PID=" << child.getPID());
+          LOG_INFO(1, "Shutting down child at PID=" << child->getPID());
 
-          child.interrupt();
+          child->interrupt();
+          if (retiring.isSet()) retiring->interrupt();
           restartChild = false;
           killTime = Time::now() + 300; // Give it 5 mins to shutdown
         }
@@ -217,22 +237,83 @@ int ServerApplication::init(int argc, char *argv[]) {
           LOG_INFO(1, "Child failed to shutdown cleanly, killing");
 
           killTime = 0;
-          child.kill();
+          child->kill();
+        }
+
+        if (hotRestartChild && !killTime) {
+          hotRestartChild = false;
+
+          if (!options["hot-restart-socket"].hasValue())
+            LOG_WARNING("Ignoring hot restart, 'hot-restart-socket' not set");
+          else if (retiring.isSet())
+            LOG_WARNING("Ignoring hot restart, one is already in progress");
+
+          else {
+            LOG_INFO(1, "Hot restarting child at PID=" << child->getPID());
+
+            // The new child takes the listeners from the old one, which
+            // exits once its connections have drained
+            vector<string> hotArgs = args;
+            hotArgs.push_back("--hot-restart");
+
+            retiring = child;
+            retireKillTime = Time::now() + getHotRestartTimeout() + 60;
+
+            child = new Subprocess;
+            child->exec(hotArgs, flags);
+          }
+        }
+
+        if (retiring.isSet()) {
+          if (!retiring->isRunning()) {
+            LOG_INFO(1, "Retired child exited with return code "
+                     << retiring->getReturnCode());
+            retiring.release();
+
+          } else if (retireKillTime < Time::now()) {
+            LOG_INFO(1, "Retired child failed to shutdown, killing");
+            retiring->kill();
+            retireKillTime = Time::now() + 60;
+          }
         }
 
         Timer::sleep(0.1);
       }
 
-      LOG_INFO(1, "Child exited with return code " << child.getReturnCode());
+      LOG_INFO(1, "Child exited with return code " << child->getReturnCode());
     }
 
+    if (retiring.isSet()) retiring->waitFor(0, 300);
+
     exit(0);
   }
 
+#ifndef _WIN32
+  if (options["hot-restart-socket"].hasValue()) {
+    string path = options["hot-restart-socket"];
+    SocketHandoff &handoff = SocketHandoff::instance();
+
+    // Bind new listeners if the previous process cannot hand them off
+    if (options["hot-restart"].toBoolean())
+      TRY_CATCH_ERROR(handoff.receive(path));
+
+    handoff.listen(path, [this] () {listenersHandedOff();});
+  }
+#endif
+
   return ret;
 }
 
 
+double ServerApplication::getHotRestartTimeout() const {
+#ifdef _WIN32
+  return 0;
+#else
+  return options["hot-restart-timeout"].toDouble();
+#endif
+}
+
+
 bool ServerApplication::shouldQuit() const {
   if (!quit && lostLifeline())
     const_cast<ServerApplication *>(this)->requestExit();
@@ -291,6 +372,12 @@ void ServerApplication::handleSignal(int sig) {
     restartChild = true;
     return;
   }
+
+  // Hot restart child
+  if (hasFeature(FEATURE_SERVER) && sig == SIGUSR2) {
+    hotRestartChild = true;
+    return;
+  }
 #endif
 
   Application::handleSignal(sig);
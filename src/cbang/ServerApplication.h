@@ -37,6 +37,7 @@
 namespace cb {
   class ServerApplication : public Application {
     bool restartChild;
+    bool hotRestartChild;
     uint64_t lifeline;
 
   public:
@@ -54,6 +55,16 @@ namespace cb {
 
     virtual void beforeDroppingPrivileges() {}
 
+    /**
+     * Called from the SocketHandoff thread once a new process has taken
+     * over the listeners, see the 'hot-restart' options.  The default
+     * requests exit.  Servers should instead drain their connections,
+     * e.g. with Event::HTTP::drain() and getHotRestartTimeout(), and then
+     * exit.
+     */
+    virtual void listenersHandedOff() {requestExit();}
+    double getHotRestartTimeout() const;
+
     // From Application
     int init(int argc, char *argv[]);
     void run() {}
@@ -162,13 +162,20 @@ namespace cb {
 
       // Create new RefCounter
       if (!refCounter) {
-        refCounter = CounterT::create();
+        refCounter = createCounter(ptr, (CounterT **)0);
         refCounter->setRefPtr(ptr);
       }
 
       refCounter->incCount();
     }
 
+    /// Take over the reference held by @param smartPtr, leaving it NULL.
+    SmartPointer(SmartPointerT &&smartPtr) :
+      refCounter(smartPtr.refCounter), ptr(smartPtr.ptr) {
+      smartPtr.refCounter = 0;
+      smartPtr.ptr = 0;
+    }
+
     /**
      * Destroy this smart pointer.  If this smart pointer is set to
      * a non-NULL value and there are no other references to the
@@ -260,6 +267,29 @@ namespace cb {
       return *this;
     }
 
+    /**
+     * Move another smart pointer's reference to this one.  No reference
+     * counts change, other than releasing this pointer's old reference.
+     *
+     * @param smartPtr The pointer to move from.  It is left NULL.
+     *
+     * @return A reference to this smart pointer.
+     */
+    SmartPointerT &operator=(SmartPointerT &&smartPtr) {
+      RefCounter *_refCounter = smartPtr.refCounter;
+      T *_ptr = smartPtr.ptr;
+
+      smartPtr.refCounter = 0;
+      smartPtr.ptr = 0;
+
+      release();
+
+      refCounter = _refCounter;
+      ptr = _ptr;
+
+      return *this;
+    }
+
     /**
      * Dereference this smart pointer.
      * A Exception will be thrown if the pointer is NULL.
@@ -395,6 +425,15 @@ namespace cb {
     void check() const {
       if (!ptr) referenceError("Can't dereference NULL pointer!");
     }
+
+    static RefCounter *createCounter(const void *ptr, const void *)
+    {return CounterT::create();}
+
+    /// RefCounted objects hold their own default RefCounter.  Matches only
+    /// when CounterT is exactly the default.
+    static RefCounter *createCounter(const RefCounted *ref,
+                                     RefCounterImpl<T, DeallocT> **)
+    {return RefCounted::createInlineCounter<T, DeallocT>(ref);}
   };
 }
 
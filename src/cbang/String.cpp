@@ -40,6 +40,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 #include <stdarg.h>
 #include <ctype.h>
@@ -59,6 +60,80 @@ using namespace cb;
 #define __va_copy(x, y) (x = y)
 #endif
 
+namespace {
+  /***
+   * Scans an integer like strtoull() with base 0, without requiring a
+   * null terminated string.  Sets @param s to the first character not
+   * consumed, or back to the start if there were no digits.
+   * @return False if the magnitude overflowed.
+   */
+  bool scanInteger(const char *&s, const char *end, bool &negative,
+                   uint64_t &magnitude) {
+    const char *start = s;
+
+    while (s < end && isspace(*s)) s++;
+
+    negative = false;
+    if (s < end && (*s == '+' || *s == '-')) negative = *s++ == '-';
+
+    unsigned base = 10;
+    if (s < end && *s == '0') {
+      base = 8;
+      if (s + 2 < end && (s[1] == 'x' || s[1] == 'X') && isxdigit(s[2])) {
+        base = 16;
+        s += 2;
+      }
+    }
+
+    const char *digits = s;
+    const uint64_t limit = numeric_limits<uint64_t>::max() / base;
+    const unsigned limitDigit = numeric_limits<uint64_t>::max() % base;
+    bool overflow = false;
+    magnitude = 0;
+
+    for (; s < end; s++) {
+      unsigned d;
+      char c = *s;
+
+      if ('0' <= c && c <= '9') d = c - '0';
+      else if ('a' <= c && c <= 'f') d = c - 'a' + 10;
+      else if ('A' <= c && c <= 'F') d = c - 'A' + 10;
+      else break;
+
+      if (base <= d) break;
+
+      if (limit < magnitude || (limit == magnitude && limitDigit < d))
+        overflow = true;
+      else magnitude = magnitude * base + d;
+    }
+
+    if (s == digits) s = start; // No conversion
+    return !overflow;
+  }
+
+
+  /// Writes the digits of @param x ending at @param end
+  char *formatUnsigned(uint64_t x, char *end) {
+    do {
+      *--end = '0' + x % 10;
+      x /= 10;
+    } while (x);
+
+    return end;
+  }
+
+
+  string formatInteger(int64_t x) {
+    char buf[21];
+    char *end = buf + sizeof(buf);
+    char *start =
+      formatUnsigned(x < 0 ? -(uint64_t)x : (uint64_t)x, end);
+    if (x < 0) *--start = '-';
+    return string(start, end - start);
+  }
+}
+
+
 const string String::DEFAULT_DELIMS = " \t\n\r";
 const string String::DEFAULT_LINE_DELIMS = "\n";
 const string String::LETTERS_LOWER_CASE = "abcdefghijklmnopqrstuvwxyz";
@@ -77,10 +152,18 @@ String::String(const char *s, size_type n) {
 }
 
 
-String::String(int32_t x)   : string(printf("%i", x)) {}
-String::String(uint32_t x)  : string(printf("%u", x)) {}
-String::String(int64_t x)   : string(printf("%lli", (long long int)x)) {}
-String::String(uint64_t x)  : string(printf("%llu", (long long unsigned)x)) {}
+String::String(int32_t x)   : string(formatInteger(x)) {}
+String::String(uint32_t x)  : string(formatInteger(x)) {}
+String::String(int64_t x)   : string(formatInteger(x)) {}
+
+
+String::String(uint64_t x) {
+  char buf[20];
+  char *end = buf + sizeof(buf);
+  char *start = formatUnsigned(x, end);
+  assign(start, end - start);
+}
+
 String::String(uint128_t x) : string(SSTR(x)) {}
 
 
@@ -213,81 +296,147 @@ bool String::isNumber(const string &s) {
 
 
 uint8_t String::parseU8(const string &s, bool full) {
-  uint32_t v = parseU32(s, full);
-  if (v > 255) TYPE_ERROR("Unsigned 8-bit value '" << s << "' out of range");
+  return parseU8(s.data(), s.length(), full);
+}
+
+
+int8_t String::parseS8(const string &s, bool full) {
+  return parseS8(s.data(), s.length(), full);
+}
+
+
+uint16_t String::parseU16(const string &s, bool full) {
+  return parseU16(s.data(), s.length(), full);
+}
+
+
+int16_t String::parseS16(const string &s, bool full) {
+  return parseS16(s.data(), s.length(), full);
+}
+
+
+uint32_t String::parseU32(const string &s, bool full) {
+  return parseU32(s.data(), s.length(), full);
+}
+
+
+int32_t String::parseS32(const string &s, bool full) {
+  return parseS32(s.data(), s.length(), full);
+}
+
+
+uint64_t String::parseU64(const string &s, bool full) {
+  return parseU64(s.data(), s.length(), full);
+}
+
+
+int64_t String::parseS64(const string &s, bool full) {
+  return parseS64(s.data(), s.length(), full);
+}
+
+
+uint8_t String::parseU8(const char *s, unsigned length, bool full) {
+  uint32_t v = parseU32(s, length, full);
+  if (v > 255)
+    TYPE_ERROR("Unsigned 8-bit value '" << string(s, length)
+               << "' out of range");
 
   return (uint8_t)v;
 }
 
 
-int8_t String::parseS8(const string &s, bool full) {
-  int32_t v = parseS32(s, full);
+int8_t String::parseS8(const char *s, unsigned length, bool full) {
+  int32_t v = parseS32(s, length, full);
   if (v < -127 || 127 < v)
-    TYPE_ERROR("Signed 8-bit value '" << s << "' out of range");
+    TYPE_ERROR("Signed 8-bit value '" << string(s, length)
+               << "' out of range");
 
   return (int8_t)v;
 }
 
 
-uint16_t String::parseU16(const string &s, bool full) {
-  uint32_t v = parseU32(s, full);
-  if (65535 < v) TYPE_ERROR("Unsigned 16-bit value '" << s << "' out of range");
+uint16_t String::parseU16(const char *s, unsigned length, bool full) {
+  uint32_t v = parseU32(s, length, full);
+  if (65535 < v)
+    TYPE_ERROR("Unsigned 16-bit value '" << string(s, length)
+               << "' out of range");
 
   return (uint16_t)v;
 }
 
 
-int16_t String::parseS16(const string &s, bool full) {
-  int32_t v = parseS32(s, full);
+int16_t String::parseS16(const char *s, unsigned length, bool full) {
+  int32_t v = parseS32(s, length, full);
   if (v < -32767 || 32767 < v)
-    TYPE_ERROR("Signed 16-bit value '" << s << "' out of range");
+    TYPE_ERROR("Signed 16-bit value '" << string(s, length)
+               << "' out of range");
 
   return (int16_t)v;
 }
 
 
-uint32_t String::parseU32(const string &s, bool full) {
-  errno = 0;
-  char *end = 0;
-  unsigned long v = strtoul(s.c_str(), &end, 0);
-  if (errno || numeric_limits<uint32_t>::max() < v || (full && end && *end))
-    TYPE_ERROR("Invalid unsigned 32-bit value '" << s << "'");
+uint32_t String::parseU32(const char *s, unsigned length, bool full) {
+  const char *ptr = s;
+  const char *end = s + length;
+  bool negative;
+  uint64_t v;
+
+  // Like strtoul() negative values wrap and then fail the range check
+  bool ok = scanInteger(ptr, end, negative, v);
+  if (negative) v = -v;
+
+  if (!ok || numeric_limits<uint32_t>::max() < v || (full && ptr != end))
+    TYPE_ERROR("Invalid unsigned 32-bit value '" << string(s, length) << "'");
 
   return (uint32_t)v;
 }
 
 
-int32_t String::parseS32(const string &s, bool full) {
-  errno = 0;
-  char *end = 0;
-  long v = strtol(s.c_str(), &end, 0);
-  if (errno || v < -numeric_limits<int32_t>::max() ||
-      numeric_limits<int32_t>::max() < v || (full && end && *end))
-    TYPE_ERROR("Invalid signed 32-bit value '" << s << "'");
+int32_t String::parseS32(const char *s, unsigned length, bool full) {
+  const char *ptr = s;
+  const char *end = s + length;
+  bool negative;
+  uint64_t v;
+
+  bool ok = scanInteger(ptr, end, negative, v);
+
+  if (!ok || (uint64_t)numeric_limits<int32_t>::max() < v ||
+      (full && ptr != end))
+    TYPE_ERROR("Invalid signed 32-bit value '" << string(s, length) << "'");
 
-  return (int32_t)v;
+  return negative ? -(int32_t)v : (int32_t)v;
 }
 
 
-uint64_t String::parseU64(const string &s, bool full) {
-  errno = 0;
-  char *end = 0;
-  unsigned long long v = strtoull(s.c_str(), &end, 0);
-  if (errno || (full && end && *end))
-    TYPE_ERROR("Invalid unsigned 64-bit value '" << s << "'");
+uint64_t String::parseU64(const char *s, unsigned length, bool full) {
+  const char *ptr = s;
+  const char *end = s + length;
+  bool negative;
+  uint64_t v;
+
+  bool ok = scanInteger(ptr, end, negative, v);
+
+  if (!ok || (full && ptr != end))
+    TYPE_ERROR("Invalid unsigned 64-bit value '" << string(s, length) << "'");
 
-  return (uint64_t)v;
+  // Like strtoull() negative values wrap
+  return negative ? -v : v;
 }
 
 
-int64_t String::parseS64(const string &s, bool full) {
-  errno = 0;
-  char *end = 0;
-  long long int v = strtoll(s.c_str(), &end, 0);
-  if (errno || (full && end && *end))
-    TYPE_ERROR("Invalid signed 64-bit value '" << s << "'");
+int64_t String::parseS64(const char *s, unsigned length, bool full) {
+  const char *ptr = s;
+  const char *end = s + length;
+  bool negative;
+  uint64_t v;
+
+  bool ok = scanInteger(ptr, end, negative, v);
+  uint64_t max = numeric_limits<int64_t>::max();
+
+  if (!ok || max + negative < v || (full && ptr != end))
+    TYPE_ERROR("Invalid signed 64-bit value '" << string(s, length) << "'");
 
-  return (int64_t)v;
+  return negative ? (int64_t)-v : (int64_t)v;
 }
 
 
@@ -326,6 +475,39 @@ float String::parseFloat(const string &s, bool full) {
 }
 
 
+double String::parseDouble(const char *s, unsigned length, bool full) {
+  // strtod() needs a terminated string, short ones are copied to the stack
+  char buf[64];
+  if (sizeof(buf) <= length) return parseDouble(string(s, length), full);
+
+  memcpy(buf, s, length);
+  buf[length] = 0;
+
+  errno = 0;
+  char *end = 0;
+  double v = strtod(buf, &end);
+  if (errno || (full && end && *end))
+    TYPE_ERROR("Invalid double '" << string(s, length) << "'");
+  return v;
+}
+
+
+float String::parseFloat(const char *s, unsigned length, bool full) {
+  char buf[64];
+  if (sizeof(buf) <= length) return parseFloat(string(s, length), full);
+
+  memcpy(buf, s, length);
+  buf[length] = 0;
+
+  errno = 0;
+  char *end = 0;
+  float v = strtof(buf, &end);
+  if (errno || (full && end && *end))
+    TYPE_ERROR("Invalid float '" << string(s, length) << "'");
+  return v;
+}
+
+
 bool String::parseBool(const string &s, bool full) {
   string v = toLower(trim(s));
 
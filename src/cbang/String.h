@@ -126,6 +126,20 @@ namespace cb {
     static float parseFloat(const std::string &s, bool full = false);
     static bool parseBool(const std::string &s, bool full = false);
 
+    /// Parse @param length characters of @param s, which need not be
+    /// null terminated, with the same rules and errors as above.  Integers
+    /// are parsed without strtol() or allocation.
+    static uint8_t parseU8(const char *s, unsigned length, bool full);
+    static int8_t parseS8(const char *s, unsigned length, bool full);
+    static uint16_t parseU16(const char *s, unsigned length, bool full);
+    static int16_t parseS16(const char *s, unsigned length, bool full);
+    static uint32_t parseU32(const char *s, unsigned length, bool full);
+    static int32_t parseS32(const char *s, unsigned length, bool full);
+    static uint64_t parseU64(const char *s, unsigned length, bool full);
+    static int64_t parseS64(const char *s, unsigned length, bool full);
+    static double parseDouble(const char *s, unsigned length, bool full);
+    static float parseFloat(const char *s, unsigned length, bool full);
+
     template <typename T> static T parse(const std::string &s,
                                          bool full = false);
 
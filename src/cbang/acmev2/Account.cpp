@@ -31,6 +31,7 @@
 \******************************************************************************/
 
 #include "Account.h"
+#include "Order.h"
 
 #include <cbang/String.h>
 #include <cbang/Catch.h>
@@ -39,12 +40,14 @@
 #include <cbang/net/Base64.h>
 #include <cbang/log/Logger.h>
 #include <cbang/json/BufferWriter.h>
+#include <cbang/json/Reader.h>
 
 #include <cbang/time/Timer.h>
 #include <cbang/time/HumanTime.h>
 
 #include <cbang/openssl/Digest.h>
 #include <cbang/openssl/CSR.h>
+#include <cbang/openssl/SSLContext.h>
 
 #include <cbang/event/Base.h>
 #include <cbang/event/Event.h>
@@ -57,10 +60,29 @@ using namespace cb::ACMEv2;
 using namespace std;
 
 
+namespace {
+  string getProblemType(Event::Request &req) {
+    if (req.inGet("Content-Type") != "application/problem+json") return "";
+
+    // Parse a copy, getInputJSON() consumes the input
+    try {
+      return JSON::Reader::parseString(req.getInput())->getString("type", "");
+    } CATCH_ERROR;
+
+    return "";
+  }
+}
+
+
 Account::Account(Event::Client &client) :
   client(client),
   retryEvent(client.getBase()
-             .newEvent(this, &Account::next, EF::EVENT_NO_SELF_REF)) {}
+             .newEvent(this, &Account::next, EF::EVENT_NO_SELF_REF)),
+  startEvent(client.getBase()
+             .newEvent(this, &Account::startOrders, EF::EVENT_NO_SELF_REF)) {}
+
+
+Account::~Account() {}
 
 
 void Account::addOptions(Options &options) {
@@ -72,7 +94,13 @@ void Account::addOptions(Options &options) {
   options.addTarget("acmev2-retries", maxRetries, "Maximum number of times "
                     "to retry an operation before giving up.");
   options.addTarget("acmev2-retry-wait", retryWait, "The time in seconds to "
-                    "wait between retries.");
+                    "wait before the first retry.  The wait doubles with "
+                    "each retry.");
+  options.addTarget("acmev2-max-retry-wait", maxRetryWait, "The maximum time "
+                    "in seconds to wait between retries, unless the server "
+                    "asks for longer with Retry-After.");
+  options.addTarget("acmev2-orders", maxOrders, "The number of certificate "
+                    "orders to process concurrently.");
   options.addTarget("acmev2-renewal-period", renewPeriod, "Renew certificates "
                     "this many days before expiration.");
   options.popCategory();
@@ -98,9 +126,34 @@ void Account::simpleInit(const KeyPair &key, const KeyPair &clientKey,
 }
 
 
+void Account::setKeyPool(const SmartPointer<KeyPool> &keyPool,
+                         const string &keyType) {
+  if (keyPool.isSet()) {
+    KeyPool::checkType(keyType);
+    if (!keyPool->getSize(keyType)) keyPool->setSize(keyType, 1);
+  }
+
+  this->keyPool = keyPool;
+  this->keyType = keyType;
+}
+
+
 void Account::addListener(listener_t listener) {listeners.push_back(listener);}
 
 
+void Account::addSSLContext(const SmartPointer<SSLContext> &sslCtx) {
+  listener_t cb = [sslCtx] (KeyCert &keyCert) {
+    sslCtx->setHostCertificate(keyCert.getDomains(), keyCert.getChain(),
+                               keyCert.getKey());
+  };
+
+  for (unsigned i = 0; i < keyCerts.size(); i++)
+    if (keyCerts[i]->hasCert()) cb(*keyCerts[i]);
+
+  addListener(cb);
+}
+
+
 void Account::addHandler(Event::HTTPHandlerGroup &group) {
   group.addMember(Event::RequestMethod::HTTP_GET,
                   "^/\\.well-known/acme-challenge/.*", this,
@@ -132,15 +185,17 @@ void Account::add(const SmartPointer<KeyCert> &keyCert) {
 void Account::update() {
   if (state != STATE_IDLE || !certsReadyForRenewal()) return;
 
+  nonces.clear(); // Nonces stale after idle
+  retries = 0;
+
   if (directory.isNull()) state = STATE_GET_DIR;
   else if (kid.empty()) state = STATE_REGISTER;
   else {
-    currentKeyCert = 0;
-    state = STATE_NEW_ORDER;
+    state = STATE_ORDERS;
+    nextOrder = 0;
   }
 
   try {
-    nonce.clear(); // Nonce stale after idle
     next();
   } CATCH_ERROR;
 }
@@ -148,25 +203,13 @@ void Account::update() {
 
 bool Account::matchChallengePath(const string &path) const {
   const string prefix = "/.well-known/acme-challenge/";
+  if (!String::startsWith(path, prefix)) return false;
 
-  return String::startsWith(path, prefix) &&
-    challengeToken == path.substr(prefix.length());
-}
-
-
-KeyCert &Account::getCurrentKeyCert() {
-  if (keyCerts.empty()) THROW("Not active KeyCerts");
-  return *keyCerts.at(currentKeyCert);
-}
-
-
-const KeyCert &Account::getCurrentKeyCert() const {
-  return const_cast<Account *>(this)->getCurrentKeyCert();
-}
-
+  string token = path.substr(prefix.length());
+  for (auto it = orders.begin(); it != orders.end(); it++)
+    if (!(*it)->isDone() && (*it)->getChallengeToken() == token) return true;
 
-const vector<string> &Account::getCurrentDomains() const {
-  return getCurrentKeyCert().getDomains();
+  return false;
 }
 
 
@@ -182,8 +225,8 @@ string Account::getThumbprint() const {
 }
 
 
-string Account::getKeyAuthorization() const {
-  return challengeToken + "." + getThumbprint();
+string Account::getKeyAuthorization(const string &token) const {
+  return token + "." + getThumbprint();
 }
 
 
@@ -202,7 +245,7 @@ void Account::writeJWK(JSON::Sink &sink) const {
 }
 
 
-string Account::getProtected(const URI &uri) const {
+string Account::getProtected(const URI &uri, const string &nonce) const {
   // TODO Implement ES256 (RFC7518 Section 3.1) and EdDSA var. Ed25519 (RFC8037)
   // signature algorithms.  See IETF ACME draft "Request Authentication".
 
@@ -227,8 +270,9 @@ string Account::getProtected(const URI &uri) const {
 }
 
 
-string Account::getSignedRequest(const URI &uri, const string &payload) const {
-  string protected64 = URLBase64().encode(getProtected(uri));
+string Account::getSignedRequest(const URI &uri, const string &payload,
+                                 const string &nonce) const {
+  string protected64 = URLBase64().encode(getProtected(uri, nonce));
   string payload64 = URLBase64().encode(payload);
   string signed64 =
     URLBase64().encode(key.signSHA256(protected64 + "." + payload64));
@@ -269,13 +313,13 @@ string Account::getNewAcctPayload() const {
 }
 
 
-string Account::getNewOrderPayload() const {
+string Account::getNewOrderPayload(const KeyCert &keyCert) const {
   JSON::BufferWriter writer(0, true);
 
   writer.beginDict();
   writer.insertList("identifiers");
 
-  const vector<string> &domains = getCurrentDomains();
+  const vector<string> &domains = keyCert.getDomains();
   for (unsigned i = 0; i < domains.size(); i++) {
     writer.appendDict();
     writer.insert("type", "dns");
@@ -291,26 +335,19 @@ string Account::getNewOrderPayload() const {
 }
 
 
-string Account::getFinalizePayload() const {
-  auto csr = getCurrentKeyCert().makeCSR();
-
-  JSON::BufferWriter writer(0, true);
-
-  writer.beginDict();
-  writer.insert("csr", URLBase64().encode(csr->toDER()));
-  writer.endDict();
-  writer.flush();
-
-  return writer.toString();
-}
+bool Account::challengeRequest(Event::Request &req) {
+  const string prefix = "/.well-known/acme-challenge/";
+  const string &path = req.getURI().getPath();
+  if (!String::startsWith(path, prefix)) return false;
 
+  string token = path.substr(prefix.length());
 
-bool Account::challengeRequest(Event::Request &req) {
-  if (matchChallengePath(req.getURI().getPath())) {
-    req.reply(getKeyAuthorization());
-    if (retryEvent->isPending()) retryEvent->activate();
-    return true;
-  }
+  for (auto it = orders.begin(); it != orders.end(); it++)
+    if (!(*it)->isDone() && (*it)->getChallengeToken() == token) {
+      req.reply(getKeyAuthorization(token));
+      (*it)->wake();
+      return true;
+    }
 
   return false;
 }
@@ -336,26 +373,97 @@ string Account::getProblemString(const JSON::Value &problem) const {
 }
 
 
-void Account::call(const string &url, Event::RequestMethod method) {
-  client.call(getURL(url), method, this, &Account::responseHandler)->send();
+void Account::call(const string &url, Event::RequestMethod method,
+                   callback_t cb) {
+  client.call(getURL(url), method, [this, cb] (Event::Request &req) {
+    addNonce(req);
+    cb(req);
+  })->send();
 }
 
 
-void Account::post(const string &url, const string &payload) {
+void Account::post(const string &url, const string &payload, callback_t cb,
+                   bool retryBadNonce) {
+  if (nonces.empty()) {
+    call("newNonce", HTTP_HEAD,
+         [this, url, payload, cb, retryBadNonce] (Event::Request &req) {
+           if (nonces.empty()) cb(req); // Let the caller retry
+           else post(url, payload, cb, retryBadNonce);
+         });
+    return;
+  }
+
   URI uri = getURL(url);
-  string data = getSignedRequest(uri, payload);
-  nonce.clear(); // Nonce used
+  string data = getSignedRequest(uri, payload, nonces.front());
+  nonces.pop_front(); // Nonce used
 
   LOG_DEBUG(5, "Posting " << data);
 
+  auto handler = [this, url, payload, cb, retryBadNonce] (Event::Request &req) {
+    addNonce(req);
+
+    // A rejected nonce is replaced by the one in the response
+    if (retryBadNonce && !nonces.empty() &&
+        getProblemType(req) == "urn:ietf:params:acme:error:badNonce")
+      return post(url, payload, cb, false);
+
+    cb(req);
+  };
+
   SmartPointer<Event::OutgoingRequest> pr =
-    client.call(uri, HTTP_POST, data, this, &Account::responseHandler);
+    client.call(uri, HTTP_POST, data, handler);
 
   pr->outSet("Content-Type", "application/jose+json");
   pr->send();
 }
 
 
+double Account::getRetryDelay(Event::Request &req, int retries) {
+  double delay = retryWait;
+  for (int i = 0; i < retries && delay < maxRetryWait; i++) delay *= 2;
+  if (maxRetryWait < delay) delay = maxRetryWait;
+
+  // Check for rate limit
+  if (req.inHas("Retry-After")) {
+    string s = req.inGet("Retry-After");
+    double retryAfter = 0;
+
+    try {
+      retryAfter = String::parseDouble(s);
+    } catch (...) {
+      try {
+        retryAfter = Time::parse(s, Time::httpFormat) - Time::now();
+      } catch (...) {
+        LOG_ERROR("Failed to parse HTTP header Retry-After: " << s);
+      }
+    }
+
+    if (delay < retryAfter) delay = retryAfter;
+
+    // Rate limits apply to the account, hold off new orders too
+    bool rateLimited =
+      getProblemType(req) == "urn:ietf:params:acme:error:rateLimited";
+
+    if (rateLimited && pausedUntil < Time::now() + retryAfter)
+      pausedUntil = Time::now() + retryAfter;
+  }
+
+  return delay;
+}
+
+
+void Account::completed(KeyCert &keyCert) {
+  for (unsigned i = 0; i < listeners.size(); i++)
+    TRY_CATCH_ERROR(listeners[i](keyCert));
+}
+
+
+void Account::orderDone() {
+  // Deferred so the Order is not freed while it is running
+  startEvent->activate();
+}
+
+
 void Account::error(const string &msg, const JSON::Value &json) const {
   string err = json.hasDict("error") ?
     getProblemString(*json.get("error")) : json.toString();
@@ -363,123 +471,82 @@ void Account::error(const string &msg, const JSON::Value &json) const {
 }
 
 
-void Account::nextKeyCert() {
-  currentKeyCert++;
-  state = STATE_NEW_ORDER;
-  next();
-}
-
+void Account::addNonce(Event::Request &req) {
+  if (!req.inHas("Replay-Nonce")) return;
 
-void Account::nextAuth() {
-  auto &auths = *order->get("authorizations");
-  if (++currentAuth < auths.size()) state = STATE_GET_AUTH;
-  else state = STATE_FINALIZE;
-  next();
+  nonces.push_back(req.inGet("Replay-Nonce"));
+  while (maxNonces < nonces.size()) nonces.pop_front();
 }
 
 
-void Account::next() {
-  retries = 0; // Reset retry count
+void Account::startOrders() {
+  for (auto it = orders.begin(); it != orders.end();)
+    if ((*it)->isDone()) it = orders.erase(it);
+    else it++;
+
+  if (state != STATE_ORDERS) return;
 
-  if (STATE_GET_DIR < state && nonce.empty()) {
-    head("newNonce");
+  uint64_t now = Time::now();
+  if (now < pausedUntil) {
+    LOG_INFO(1, "ACME rate limited, new orders paused for "
+             << HumanTime(pausedUntil - now));
+    startEvent->add(pausedUntil - now);
     return;
   }
 
-  switch (state) {
-  case STATE_IDLE: break;
-  case STATE_GET_DIR: get(uriBase + "/directory"); break;
-  case STATE_REGISTER: post("newAccount", getNewAcctPayload()); break;
+  while (orders.size() < maxOrders && nextOrder < keyCerts.size()) {
+    auto &keyCert = keyCerts[nextOrder++];
+    if (!needsRenewal(*keyCert)) continue;
 
-  case STATE_NEW_ORDER:
-    for (; currentKeyCert < keyCerts.size(); currentKeyCert++)
-      if (needsRenewal(getCurrentKeyCert())) {
-        post("newOrder", getNewOrderPayload());
-        return;
-      }
+    SmartPointer<Order> order = new Order(*this, keyCert);
+    orders.push_back(order);
 
-    state = STATE_IDLE;
-    break;
-
-  case STATE_GET_AUTH: {
-    auto &auths = *order->get("authorizations");
-    if (currentAuth < auths.size()) get(auths.getString(currentAuth));
-    else nextKeyCert();
-    break;
+    try {
+      order->start();
+    } catch (const Exception &e) {
+      LOG_ERROR("Failed to start certificate order for "
+                << String::join(keyCert->getDomains(), " ") << ": " << e);
+      orders.pop_back();
+    }
   }
 
-  case STATE_CHALLENGE: {
-    auto &challenges = *authorization->get("challenges");
-
-    for (unsigned i = 0; i < challenges.size(); i++) {
-      auto &challenge = *challenges.get(i);
-
-      if (challenge.getString("type", "") == "http-01") {
-        string uri = challenge.getString("url");
-        challengeToken = challenge.getString("token");
+  if (orders.empty()) state = STATE_IDLE;
+}
 
-        post(uri, "{}");
-        break;
-      }
-    }
 
+void Account::next() {
+  switch (state) {
+  case STATE_IDLE: break;
+  case STATE_GET_DIR:
+    call(uriBase + "/directory", HTTP_GET,
+         [this] (Event::Request &req) {responseHandler(req);});
     break;
-  }
 
-  case STATE_FINALIZE:
-    post(order->getString("finalize"), getFinalizePayload());
+  case STATE_REGISTER:
+    post("newAccount", getNewAcctPayload(),
+         [this] (Event::Request &req) {responseHandler(req);});
     break;
 
-  case STATE_GET_ORDER: post(orderLink, ""); break;
-  case STATE_GET_CERT: post(order->getString("certificate"), ""); break;
+  case STATE_ORDERS: startOrders(); break;
   }
 }
 
 
 void Account::retry(Event::Request &req) {
-  double delay = retryWait;
-
-  // Check for rate limit
-  if (req.inHas("Retry-After")) {
-    string s = req.inGet("Retry-After");
-
-    try {
-      delay = String::parseDouble(s);
-    } catch (...) {
-      try {
-        delay = Time::parse(s, Time::httpFormat) - Time::now();
-      } catch (...) {
-        LOG_ERROR("Failed to parse HTTP header Retry-After: " << s);
-      }
-    }
+  double delay = getRetryDelay(req, retries);
 
-    if (delay < retryWait) delay = retryWait;
-  }
-
-  LOG_DEBUG(3, "Retrying certificate operation in " << HumanTime(delay));
+  LOG_DEBUG(3, "Retrying ACME account operation in " << HumanTime(delay));
 
   if (retries++ < maxRetries) retryEvent->add(delay);
-  else {
-    getCurrentKeyCert().setWaitUntil(Time::now() + delay);
-    nextKeyCert();
-  }
+  else state = STATE_IDLE;
 }
 
 
-
 void Account::responseHandler(Event::Request &req) {
   if (!req.isOk()) LOG_ERROR(req.getInput());
   else try {
       LOG_DEBUG(5, "state=" << state << " response=" << req.getInput());
 
-      if (req.inHas("Replay-Nonce")) nonce = req.inGet("Replay-Nonce");
-
-      // Check if this was a nonce request
-      if (req.getMethod() == HTTP_HEAD) {
-        next();
-        return;
-      }
-
       if (req.inGet("Content-Type") == "application/problem+json") {
         LOG_WARNING("Account: " << getProblemString(*req.getInputJSON()));
         retry(req);
@@ -487,84 +554,15 @@ void Account::responseHandler(Event::Request &req) {
       }
 
       switch (state) {
-      case STATE_IDLE: return;
-
       case STATE_GET_DIR: directory = req.getInputJSON(); break;
       case STATE_REGISTER: kid = req.inGet("Location"); break;
-
-      case STATE_NEW_ORDER:
-        orderLink = req.inGet("Location");
-        order = req.getInputJSON();
-        currentAuth = 0;
-        break;
-
-      case STATE_GET_AUTH: {
-        authorization = req.getInputJSON();
-        string status = authorization->getString("status");
-
-        if (status == "pending") break;
-        if (status == "processing") return retry(req);
-        if (status == "valid") return nextAuth();
-
-        // status == invalid or revoked
-        auto &challenges = *authorization->get("challenges");
-
-        for (unsigned i = 0; i < challenges.size(); i++) {
-          auto &ch = *challenges.get(i);
-
-          if (ch.getString("type", "") == "http-01") {
-            error("Failed to complete certificate challenge", ch);
-            break;
-          }
-        }
-
-        return nextKeyCert();
-      }
-
-      case STATE_CHALLENGE: {
-        string status = req.getInputJSON()->getString("status");
-
-        if (status == "valid") nextAuth();
-
-        else if (status == "pending") {
-          state = STATE_GET_AUTH;
-          retry(req);
-
-        } else nextKeyCert();
-        return;
-      }
-
-      case STATE_FINALIZE: state = STATE_GET_ORDER;
-        // Fall through, finalize returns order
-
-      case STATE_GET_ORDER: {
-        order = req.getInputJSON();
-        string status = order->getString("status");
-
-        if (status == "processing") return retry(req);
-        if (status == "valid") break;
-
-        error("Unexpected certificate order status", *order);
-        return nextKeyCert();
-      }
-
-      case STATE_GET_CERT: {
-        auto &keyCert = getCurrentKeyCert();
-        auto &chain = keyCert.getChain();
-
-        chain.clear();
-        chain.parse(req.getInput());
-
-        for (unsigned i = 0; i < listeners.size(); i++)
-          TRY_CATCH_ERROR(listeners[i](keyCert));
-
-        nextKeyCert();
-        return;
-      }
+      default: return;
       }
 
       // Next state
       state = (state_t)(state + 1);
+      retries = 0;
+      if (state == STATE_ORDERS) nextOrder = 0;
       next();
       return;
 
@@ -35,6 +35,7 @@
 /// Based on https://tools.ietf.org/html/draft-ietf-acme-acme-09
 
 #include "KeyCert.h"
+#include "KeyPool.h"
 
 #include <cbang/event/Client.h>
 #include <cbang/event/RequestMethod.h>
@@ -44,10 +45,13 @@
 #include <cbang/json/Value.h>
 
 #include <vector>
+#include <list>
+#include <deque>
 
 
 namespace cb {
   class Options;
+  class SSLContext;
 
   namespace Event {class HTTPHandlerGroup;}
 
@@ -57,6 +61,8 @@ namespace cb {
     static std::string letsencrypt_staging =
       "https://acme-staging-v02.api.letsencrypt.org";
 
+    class Order;
+
     class Account : public Event::RequestMethod::Enum {
       Event::Client &client;
       KeyPair key;
@@ -65,48 +71,49 @@ namespace cb {
       std::string emails;
 
       double retryWait = 5;
+      double maxRetryWait = 60 * 60;
       int maxRetries = 5;
       double renewPeriod = 15;
+      unsigned maxOrders = 1;
+      unsigned maxNonces = 32;
 
       typedef enum {
         STATE_IDLE,
         STATE_GET_DIR,
         STATE_REGISTER,
-        STATE_NEW_ORDER,
-        STATE_GET_AUTH,
-        STATE_CHALLENGE,
-        STATE_FINALIZE,
-        STATE_GET_ORDER,
-        STATE_GET_CERT,
+        STATE_ORDERS,
       } state_t;
       state_t state = STATE_IDLE;
 
       int retries = 0;
 
-      unsigned currentKeyCert = 0;
+      unsigned nextOrder = 0;
       std::vector<SmartPointer<KeyCert> > keyCerts;
+      std::list<SmartPointer<Order> > orders;
 
       JSON::ValuePtr directory;
-      std::string nonce;
+      std::deque<std::string> nonces;
       std::string kid;
+      uint64_t pausedUntil = 0;
 
-      std::string orderLink;
-      JSON::ValuePtr order;
-      unsigned currentAuth = 0;
-      JSON::ValuePtr authorization;
-
-      std::string challengeToken;
+      SmartPointer<KeyPool> keyPool;
+      std::string keyType = "rsa:4096";
 
     public:
       typedef std::function<void (KeyCert &)> listener_t;
+      typedef std::function<void (Event::Request &)> callback_t;
 
     protected:
       std::vector<listener_t> listeners;
 
       SmartPointer<Event::Event> retryEvent;
+      SmartPointer<Event::Event> startEvent;
 
     public:
       Account(Event::Client &client);
+      ~Account();
+
+      Event::Client &getClient() const {return client;}
 
       const KeyPair &getKey() const {return key;}
       void setKey(const KeyPair &key) {this->key = key;}
@@ -114,9 +121,27 @@ namespace cb {
       void setURIBase(const std::string &uriBase) {this->uriBase = uriBase;}
       void setContactEmails(const std::string &emails) {this->emails = emails;}
       void setRetryWait(double retryWait) {this->retryWait = retryWait;}
+      /// The limit for exponential backoff, Retry-After may exceed it
+      void setMaxRetryWait(double x) {maxRetryWait = x;}
       void setMaxRetries(int maxRetries) {this->maxRetries = maxRetries;}
+      int getMaxRetries() const {return maxRetries;}
       void setRenewPeriod(double renewPeriod) {this->renewPeriod = renewPeriod;}
 
+      /// The number of certificate orders processed concurrently
+      void setMaxOrders(unsigned x) {maxOrders = x ? x : 1;}
+      unsigned getMaxOrders() const {return maxOrders;}
+      unsigned getNumOrders() const {return orders.size();}
+
+      /**
+       * When set each renewal gets a new key of @param keyType from
+       * @param keyPool so issuance does not wait for key generation.  The
+       * KeyCert's key is replaced when the new certificate arrives.
+       */
+      void setKeyPool(const SmartPointer<KeyPool> &keyPool,
+                      const std::string &keyType = "rsa:4096");
+      const SmartPointer<KeyPool> &getKeyPool() const {return keyPool;}
+      const std::string &getKeyType() const {return keyType;}
+
       void addOptions(Options &options);
       void simpleInit(const KeyPair &key, const KeyPair &clientKey,
                       const std::string &domains,
@@ -124,6 +149,11 @@ namespace cb {
                       Event::HTTPHandlerGroup &group, listener_t cb,
                       unsigned updateRate = 60 * 5);
       void addListener(listener_t listener);
+      /**
+       * Install each KeyCert in @param sslCtx as an SNI host certificate
+       * for its domains, now if it has one and again whenever it is renewed.
+       */
+      void addSSLContext(const SmartPointer<SSLContext> &sslCtx);
       void addHandler(Event::HTTPHandlerGroup &group);
       bool needsRenewal(const KeyCert &keyCert) const;
       unsigned certsReadyForRenewal() const;
@@ -131,35 +161,43 @@ namespace cb {
       void update();
       bool matchChallengePath(const std::string &path) const;
 
-      KeyCert &getCurrentKeyCert();
-      const KeyCert &getCurrentKeyCert() const;
-      const std::vector<std::string> &getCurrentDomains() const;
-
       std::string getURL(const std::string &name) const;
       std::string getThumbprint() const;
-      std::string getKeyAuthorization() const;
+      std::string getKeyAuthorization(const std::string &token) const;
 
       void writeJWK(JSON::Sink &sink) const;
-      std::string getProtected(const URI &uri) const;
-      std::string getSignedRequest(const URI &uri,
-                                   const std::string &payload) const;
+      std::string getProtected(const URI &uri,
+                               const std::string &nonce) const;
+      std::string getSignedRequest(const URI &uri, const std::string &payload,
+                                   const std::string &nonce) const;
       std::string getNewAcctPayload() const;
-      std::string getNewOrderPayload() const;
-      std::string getFinalizePayload() const;
+      std::string getNewOrderPayload(const KeyCert &keyCert) const;
 
       bool challengeRequest(Event::Request &req);
 
-    protected:
+      // Used by Order
       std::string getProblemString(const JSON::Value &problem) const;
+      void error(const std::string &msg, const JSON::Value &json) const;
 
-      void call(const std::string &url, Event::RequestMethod method);
-      void head(const std::string &url) {call(url, HTTP_HEAD);}
-      void get(const std::string &url) {call(url, HTTP_GET);}
-      void post(const std::string &url, const std::string &payload);
+      void call(const std::string &url, Event::RequestMethod method,
+                callback_t cb);
+      /// Sign and post @param payload with a replay nonce from the pool
+      void post(const std::string &url, const std::string &payload,
+                callback_t cb, bool retryBadNonce = true);
+
+      /**
+       * The delay before retry @param retries, doubling from the retry wait
+       * up to the max retry wait or as requested by the server with
+       * Retry-After.  A rate limit error with Retry-After also pauses
+       * starting new orders.
+       */
+      double getRetryDelay(Event::Request &req, int retries);
+      void completed(KeyCert &keyCert);
+      void orderDone();
 
-      void error(const std::string &msg, const JSON::Value &json) const;
-      void nextKeyCert();
-      void nextAuth();
+    protected:
+      void addNonce(Event::Request &req);
+      void startOrders();
       void next();
       void retry(Event::Request &req);
       void responseHandler(Event::Request &req);
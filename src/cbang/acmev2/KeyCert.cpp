@@ -62,7 +62,7 @@ bool KeyCert::expiredIn(unsigned secs) const {
 }
 
 
-SmartPointer<CSR> KeyCert::makeCSR() const {
+SmartPointer<CSR> KeyCert::makeCSR(const KeyPair &key) const {
   if (domains.empty()) THROW("No domains set");
 
   SmartPointer<CSR> csr = new CSR;
@@ -54,6 +54,7 @@ namespace cb {
       virtual ~KeyCert() {}
 
       const KeyPair &getKey() const {return key;}
+      void setKey(const KeyPair &key) {this->key = key;}
       CertificateChain &getChain() {return chain;}
       const CertificateChain &getChain() const {return chain;}
 
@@ -66,7 +67,9 @@ namespace cb {
       bool hasCert() const {return chain.size();}
       bool expiredIn(unsigned secs) const;
 
-      virtual SmartPointer<CSR> makeCSR() const;
+      SmartPointer<CSR> makeCSR() const {return makeCSR(key);}
+      /// Make a CSR for this KeyCert's domains signed with @param key
+      virtual SmartPointer<CSR> makeCSR(const KeyPair &key) const;
     };
   }
 }
@@ -0,0 +1,182 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "KeyPool.h"
+
+#include <cbang/String.h>
+#include <cbang/Catch.h>
+#include <cbang/log/Logger.h>
+#include <cbang/event/ConcurrentPool.h>
+
+using namespace cb;
+using namespace cb::ACMEv2;
+using namespace std;
+
+
+namespace {
+  void parseType(const string &type, string &alg, string &param) {
+    size_t colon = type.find(':');
+    alg = String::toLower(type.substr(0, colon));
+    param = colon == string::npos ? string() : type.substr(colon + 1);
+  }
+}
+
+
+KeyPool::KeyPool(Event::ConcurrentPool &pool) : pool(pool) {}
+
+
+void KeyPool::setSize(const string &type, unsigned size) {
+  getKeys(type).size = size;
+  fill(type);
+}
+
+
+unsigned KeyPool::getSize(const string &type) const {
+  auto it = types.find(type);
+  return it == types.end() ? 0 : it->second.size;
+}
+
+
+unsigned KeyPool::getReady(const string &type) const {
+  auto it = types.find(type);
+  return it == types.end() ? 0 : it->second.ready.size();
+}
+
+
+unsigned KeyPool::getPending(const string &type) const {
+  auto it = types.find(type);
+  return it == types.end() ? 0 : it->second.pending;
+}
+
+
+bool KeyPool::tryGet(const string &type, KeyPair &key) {
+  Keys &keys = getKeys(type);
+  if (keys.ready.empty()) return false;
+
+  key = keys.ready.front();
+  keys.ready.pop_front();
+  fill(type);
+
+  return true;
+}
+
+
+void KeyPool::get(const string &type, callback_t cb, error_cb_t errorCB) {
+  KeyPair key;
+  if (tryGet(type, key)) return cb(key);
+
+  getKeys(type).waiters.push_back(Waiter{cb, errorCB});
+  fill(type);
+}
+
+
+void KeyPool::checkType(const string &type) {
+  string alg, param;
+  parseType(type, alg, param);
+
+  if (alg == "rsa") {
+    if (!param.empty() && String::parseU32(param) < 1024)
+      THROW("RSA key size must be at least 1024 bits: " << type);
+
+  } else if (alg == "ec") {
+    if (param.empty()) THROW("Missing EC curve: " << type);
+
+  } else THROW("Unsupported key type: " << type);
+}
+
+
+KeyPair KeyPool::generate(const string &type) {
+  string alg, param;
+  parseType(type, alg, param);
+
+  KeyPair key;
+
+  if (alg == "rsa") key.generateRSA(param.empty() ? 4096 :
+                                    String::parseU32(param));
+  else if (alg == "ec") key.generateEC(param);
+  else THROW("Unsupported key type: " << type);
+
+  return key;
+}
+
+
+KeyPool::Keys &KeyPool::getKeys(const string &type) {
+  auto it = types.find(type);
+  if (it != types.end()) return it->second;
+
+  checkType(type);
+  return types[type];
+}
+
+
+void KeyPool::fill(const string &type) {
+  Keys &keys = getKeys(type);
+
+  // Generate enough keys for the waiters and to refill the pool
+  while (keys.pending + keys.ready.size() < keys.size + keys.waiters.size()) {
+    keys.pending++;
+
+    pool.submit<KeyPair>(
+      priority, [type] () {return generate(type);},
+      [this, type] (KeyPair &key) {generated(type, key);},
+      [this, type] (const Exception &e) {failed(type, e);});
+  }
+}
+
+
+void KeyPool::generated(const string &type, const KeyPair &key) {
+  Keys &keys = getKeys(type);
+  keys.pending--;
+
+  if (keys.waiters.empty()) keys.ready.push_back(key);
+  else {
+    Waiter waiter = keys.waiters.front();
+    keys.waiters.pop_front();
+    TRY_CATCH_ERROR(waiter.cb(key));
+  }
+}
+
+
+void KeyPool::failed(const string &type, const Exception &e) {
+  Keys &keys = getKeys(type);
+  keys.pending--;
+
+  LOG_ERROR("Failed to generate " << type << " key: " << e.getMessage());
+
+  // Fail one waiter rather than retrying in a loop
+  if (!keys.waiters.empty()) {
+    Waiter waiter = keys.waiters.front();
+    keys.waiters.pop_front();
+    if (waiter.errorCB) TRY_CATCH_ERROR(waiter.errorCB(e));
+  }
+}
@@ -0,0 +1,114 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cbang/openssl/KeyPair.h>
+
+#include <string>
+#include <map>
+#include <list>
+#include <functional>
+
+
+namespace cb {
+  class Exception;
+  namespace Event {class ConcurrentPool;}
+
+  namespace ACMEv2 {
+    /**
+     * Generates keys on a ConcurrentPool and keeps a number of them ready
+     * for each key type.  A key type is "rsa:<bits>" or "ec:<curve>", e.g.
+     * "rsa:4096" or "ec:prime256v1".  Keys taken from the pool are replaced
+     * in the background.
+     *
+     * All methods and callbacks run on the event loop thread.  The KeyPool
+     * must outlive the tasks it submits to the ConcurrentPool.
+     */
+    class KeyPool {
+    public:
+      typedef std::function<void (const KeyPair &)> callback_t;
+      typedef std::function<void (const Exception &)> error_cb_t;
+
+    protected:
+      Event::ConcurrentPool &pool;
+      int priority = -1;
+
+      struct Waiter {
+        callback_t cb;
+        error_cb_t errorCB;
+      };
+
+      struct Keys {
+        unsigned size = 0;
+        unsigned pending = 0;
+        std::list<KeyPair> ready;
+        std::list<Waiter> waiters;
+      };
+
+      std::map<std::string, Keys> types;
+
+    public:
+      KeyPool(Event::ConcurrentPool &pool);
+
+      /// Priority of key generation tasks on the ConcurrentPool
+      void setPriority(int priority) {this->priority = priority;}
+      int getPriority() const {return priority;}
+
+      /// Keep @param size keys of @param type ready
+      void setSize(const std::string &type, unsigned size);
+      unsigned getSize(const std::string &type) const;
+      unsigned getReady(const std::string &type) const;
+      unsigned getPending(const std::string &type) const;
+
+      /// @return false if no key of @param type is ready
+      bool tryGet(const std::string &type, KeyPair &key);
+      /**
+       * Call @param cb with a key of @param type, immediately if one is
+       * ready otherwise once one has been generated.  @param errorCB is
+       * called instead if generating the key fails.
+       */
+      void get(const std::string &type, callback_t cb,
+               error_cb_t errorCB = 0);
+
+      static void checkType(const std::string &type);
+      static KeyPair generate(const std::string &type);
+
+    protected:
+      Keys &getKeys(const std::string &type);
+      void fill(const std::string &type);
+      void generated(const std::string &type, const KeyPair &key);
+      void failed(const std::string &type, const Exception &e);
+    };
+  }
+}
@@ -0,0 +1,287 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "Order.h"
+#include "Account.h"
+
+#include <cbang/String.h>
+#include <cbang/Catch.h>
+
+#include <cbang/net/Base64.h>
+#include <cbang/log/Logger.h>
+#include <cbang/json/BufferWriter.h>
+#include <cbang/time/Time.h>
+#include <cbang/time/HumanTime.h>
+
+#include <cbang/openssl/CSR.h>
+
+#include <cbang/event/Base.h>
+#include <cbang/event/Event.h>
+#include <cbang/event/Request.h>
+
+using namespace cb;
+using namespace cb::ACMEv2;
+using namespace std;
+
+
+Order::Order(Account &account, const SmartPointer<KeyCert> &keyCert) :
+  account(account), keyCert(keyCert),
+  retryEvent(account.getClient().getBase()
+             .newEvent(this, &Order::next, EF::EVENT_NO_SELF_REF)) {}
+
+
+Order::~Order() {retryEvent->del();}
+
+
+void Order::wake() {if (retryEvent->isPending()) retryEvent->activate();}
+
+
+string Order::getFinalizePayload() const {
+  auto csr = newKey.isSet() ? keyCert->makeCSR(*newKey) : keyCert->makeCSR();
+
+  JSON::BufferWriter writer(0, true);
+
+  writer.beginDict();
+  writer.insert("csr", URLBase64().encode(csr->toDER()));
+  writer.endDict();
+  writer.flush();
+
+  return writer.toString();
+}
+
+
+void Order::get(const string &url) {
+  account.call(url, HTTP_GET,
+               [this] (Event::Request &req) {responseHandler(req);});
+}
+
+
+void Order::post(const string &url, const string &payload) {
+  account.post(url, payload,
+               [this] (Event::Request &req) {responseHandler(req);});
+}
+
+
+void Order::done() {
+  state = STATE_DONE;
+  newKey.release();
+  retryEvent->del();
+  account.orderDone();
+}
+
+
+void Order::nextAuth() {
+  auto &auths = *order->get("authorizations");
+  if (++currentAuth < auths.size()) state = STATE_GET_AUTH;
+  else state = STATE_FINALIZE;
+  next();
+}
+
+
+void Order::finalize() {
+  auto &keyPool = account.getKeyPool();
+
+  if (keyPool.isNull() || newKey.isSet())
+    return post(order->getString("finalize"), getFinalizePayload());
+
+  // Retries reuse the same key
+  keyPool->get(account.getKeyType(), [this] (const KeyPair &key) {
+    newKey = new KeyPair(key);
+    finalize();
+
+  }, [this] (const Exception &e) {
+    LOG_ERROR("Failed to get a new key for "
+              << String::join(keyCert->getDomains(), " ") << ": "
+              << e.getMessage());
+    done();
+  });
+}
+
+
+void Order::next() {
+  switch (state) {
+  case STATE_NEW_ORDER:
+    post("newOrder", account.getNewOrderPayload(*keyCert));
+    break;
+
+  case STATE_GET_AUTH: {
+    auto &auths = *order->get("authorizations");
+    if (currentAuth < auths.size()) get(auths.getString(currentAuth));
+    else done();
+    break;
+  }
+
+  case STATE_CHALLENGE: {
+    auto &challenges = *authorization->get("challenges");
+
+    for (unsigned i = 0; i < challenges.size(); i++) {
+      auto &challenge = *challenges.get(i);
+
+      if (challenge.getString("type", "") == "http-01") {
+        string uri = challenge.getString("url");
+        challengeToken = challenge.getString("token");
+
+        post(uri, "{}");
+        return;
+      }
+    }
+
+    account.error("No http-01 challenge", *authorization);
+    done();
+    break;
+  }
+
+  case STATE_FINALIZE: finalize(); break;
+
+  case STATE_GET_ORDER: post(orderLink, ""); break;
+  case STATE_GET_CERT: post(order->getString("certificate"), ""); break;
+  case STATE_DONE: break;
+  }
+}
+
+
+void Order::retry(Event::Request &req) {
+  // Count retries of the current state
+  if (retryState != state) {
+    retryState = state;
+    retries = 0;
+  }
+
+  double delay = account.getRetryDelay(req, retries);
+
+  if (retries++ < account.getMaxRetries()) {
+    LOG_DEBUG(3, "Retrying certificate operation for "
+              << String::join(keyCert->getDomains(), " ") << " in "
+              << HumanTime(delay));
+    retryEvent->add(delay);
+
+  } else {
+    keyCert->setWaitUntil(Time::now() + delay);
+    done();
+  }
+}
+
+
+void Order::responseHandler(Event::Request &req) {
+  if (!req.isOk()) LOG_ERROR(req.getInput());
+  else try {
+      LOG_DEBUG(5, "state=" << state << " response=" << req.getInput());
+
+      if (req.inGet("Content-Type") == "application/problem+json") {
+        LOG_WARNING("Account: "
+                    << account.getProblemString(*req.getInputJSON()));
+        retry(req);
+        return;
+      }
+
+      switch (state) {
+      case STATE_NEW_ORDER:
+        orderLink = req.inGet("Location");
+        order = req.getInputJSON();
+        currentAuth = 0;
+        break;
+
+      case STATE_GET_AUTH: {
+        authorization = req.getInputJSON();
+        string status = authorization->getString("status");
+
+        if (status == "pending") break;
+        if (status == "processing") return retry(req);
+        if (status == "valid") return nextAuth();
+
+        // status == invalid or revoked
+        auto &challenges = *authorization->get("challenges");
+
+        for (unsigned i = 0; i < challenges.size(); i++) {
+          auto &ch = *challenges.get(i);
+
+          if (ch.getString("type", "") == "http-01") {
+            account.error("Failed to complete certificate challenge", ch);
+            break;
+          }
+        }
+
+        return done();
+      }
+
+      case STATE_CHALLENGE: {
+        string status = req.getInputJSON()->getString("status");
+
+        if (status == "valid") nextAuth();
+
+        else if (status == "pending") {
+          state = STATE_GET_AUTH;
+          retry(req);
+
+        } else done();
+        return;
+      }
+
+      case STATE_FINALIZE: state = STATE_GET_ORDER;
+        // Fall through, finalize returns order
+
+      case STATE_GET_ORDER: {
+        order = req.getInputJSON();
+        string status = order->getString("status");
+
+        if (status == "processing") return retry(req);
+        if (status == "valid") break;
+
+        account.error("Unexpected certificate order status", *order);
+        return done();
+      }
+
+      case STATE_GET_CERT: {
+        auto &chain = keyCert->getChain();
+
+        chain.clear();
+        chain.parse(req.getInput());
+
+        if (newKey.isSet()) keyCert->setKey(*newKey);
+
+        account.completed(*keyCert);
+        return done();
+      }
+
+      case STATE_DONE: return;
+      }
+
+      // Next state
+      state = (state_t)(state + 1);
+      next();
+      return;
+
+    } CATCH_ERROR;
+
+  retry(req);
+}
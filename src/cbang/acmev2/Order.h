@@ -0,0 +1,109 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "KeyCert.h"
+
+#include <cbang/SmartPointer.h>
+#include <cbang/event/RequestMethod.h>
+#include <cbang/json/Value.h>
+
+#include <string>
+
+
+namespace cb {
+  namespace Event {
+    class Event;
+    class Request;
+  }
+
+  namespace ACMEv2 {
+    class Account;
+
+    /// Walks one KeyCert through an ACME certificate order
+    class Order : public Event::RequestMethod::Enum {
+      Account &account;
+      SmartPointer<KeyCert> keyCert;
+
+      typedef enum {
+        STATE_NEW_ORDER,
+        STATE_GET_AUTH,
+        STATE_CHALLENGE,
+        STATE_FINALIZE,
+        STATE_GET_ORDER,
+        STATE_GET_CERT,
+        STATE_DONE,
+      } state_t;
+      state_t state = STATE_NEW_ORDER;
+
+      state_t retryState = STATE_DONE;
+      int retries = 0;
+
+      std::string orderLink;
+      JSON::ValuePtr order;
+      unsigned currentAuth = 0;
+      JSON::ValuePtr authorization;
+
+      std::string challengeToken;
+      SmartPointer<KeyPair> newKey;
+
+      SmartPointer<Event::Event> retryEvent;
+
+    public:
+      Order(Account &account, const SmartPointer<KeyCert> &keyCert);
+      ~Order();
+
+      KeyCert &getKeyCert() const {return *keyCert;}
+      const std::string &getChallengeToken() const {return challengeToken;}
+      bool isDone() const {return state == STATE_DONE;}
+
+      void start() {next();}
+      /// Retry now if waiting, e.g. for the server to check a challenge
+      void wake();
+
+      std::string getFinalizePayload() const;
+
+    protected:
+      void get(const std::string &url);
+      void post(const std::string &url, const std::string &payload);
+
+      void done();
+      void nextAuth();
+      void finalize();
+      void next();
+      void retry(Event::Request &req);
+      void responseHandler(Event::Request &req);
+    };
+  }
+}
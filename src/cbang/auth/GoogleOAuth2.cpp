@@ -45,7 +45,8 @@ GoogleOAuth2::GoogleOAuth2(Options &options) :
          "https://accounts.google.com/o/oauth2/v2/auth",
          "https://www.googleapis.com/oauth2/v4/token",
          "https://www.googleapis.com/oauth2/v3/userinfo",
-         "openid email profile") {}
+         "openid email profile",
+         "https://accounts.google.com/.well-known/openid-configuration") {}
 
 
 SmartPointer<JSON::Value>
@@ -48,9 +48,10 @@ using namespace cb;
 
 OAuth2::OAuth2(Options &options, const string &provider,
                const string &authURL, const string &tokenURL,
-               const string &profileURL, const string &scope) :
+               const string &profileURL, const string &scope,
+               const string &discoveryURL) :
   provider(provider), authURL(authURL), tokenURL(tokenURL),
-  profileURL(profileURL), scope(scope) {
+  profileURL(profileURL), scope(scope), discoveryURL(discoveryURL) {
 
   options.pushCategory(String::capitalize(provider) + " OAuth2 Login");
   options.addTarget(provider + "-auth-url", this->authURL, "OAuth2 auth URL");
@@ -62,6 +63,10 @@ OAuth2::OAuth2(Options &options, const string &provider,
   options.addTarget(provider + "-client-id", clientID, "OAuth2 API client ID");
   options.addTarget(provider + "-client-secret", clientSecret,
                     "OAuth2 API client secret")->setObscured();
+  options.addTarget(provider + "-discovery-url", this->discoveryURL,
+                    "OpenID Connect discovery URL.  When set, ID tokens are "
+                    "verified with the provider's cached signing keys "
+                    "instead of requesting the user's profile");
   options.popCategory();
 }
 
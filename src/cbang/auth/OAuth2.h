@@ -52,15 +52,21 @@ namespace cb {
     std::string redirectBase;
     std::string clientID;
     std::string clientSecret;
+    std::string discoveryURL;
 
   public:
     OAuth2(Options &options, const std::string &provider,
            const std::string &authURL = "", const std::string &tokenURL = "",
-           const std::string &profileURL = "", const std::string &scope = "");
+           const std::string &profileURL = "", const std::string &scope = "",
+           const std::string &discoveryURL = "");
     virtual ~OAuth2();
 
     bool isConfigured() const;
 
+    const std::string &getClientID() const {return clientID;}
+    /// The OpenID Connect discovery document URL, if supported
+    const std::string &getDiscoveryURL() const {return discoveryURL;}
+
     virtual URI getRedirectURL(const std::string &path,
                                const std::string &state) const;
     virtual bool isForgery(const URI &uri, const std::string &state) const;
@@ -74,6 +80,11 @@ namespace cb {
     virtual SmartPointer<JSON::Value>
     processProfile(const SmartPointer<JSON::Value> &profile) const = 0;
 
+    /// Process the claims of a verified OpenID Connect ID token
+    virtual SmartPointer<JSON::Value>
+    processClaims(const SmartPointer<JSON::Value> &claims) const
+    {return processProfile(claims);}
+
   protected:
     void validateOption(const std::string &option,
                         const std::string &name) const;
@@ -0,0 +1,345 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "SliceBuffer.h"
+
+#include <cbang/Exception.h>
+#include <cbang/socket/Socket.h>
+
+#include <algorithm>
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <sys/uio.h>
+#endif
+
+using namespace std;
+using namespace cb;
+
+
+SliceBuffer::Block::Block(unsigned capacity) :
+  data((char *)malloc(capacity)), capacity(capacity), fill(0) {
+  if (!data && capacity) THROW("Failed to allocate memory");
+}
+
+
+SliceBuffer::Block::Block(const char *data, unsigned length,
+                          release_t release) :
+  data((char *)data), capacity(length), fill(length), release(release) {
+  if (!release) THROW("Block release callback cannot be null");
+}
+
+
+SliceBuffer::Block::~Block() {
+  if (release) release();
+  else free(data);
+}
+
+
+unsigned SliceBuffer::Block::append(const char *src, unsigned length) {
+  if (!isOwned()) return 0;
+
+  length = min(length, getSpace());
+  memcpy(data + fill, src, length);
+  fill += length;
+
+  return length;
+}
+
+
+SliceBuffer::SliceBuffer(const char *data, unsigned length) : SliceBuffer() {
+  add(data, length);
+}
+
+
+SliceBuffer::SliceBuffer(const string &s) : SliceBuffer() {add(s);}
+SliceBuffer::SliceBuffer(string &&s) : SliceBuffer() {add(move(s));}
+
+
+void SliceBuffer::clear() {
+  slices.clear();
+  length = 0;
+}
+
+
+void SliceBuffer::drain(unsigned length) {
+  while (length && !slices.empty()) {
+    Slice &front = slices.front();
+
+    if (length < front.length) {
+      front.offset += length;
+      front.length -= length;
+      this->length -= length;
+      return;
+    }
+
+    length -= front.length;
+    this->length -= front.length;
+    slices.pop_front();
+  }
+}
+
+
+SliceBuffer SliceBuffer::slice(unsigned offset, unsigned length) const {
+  SliceBuffer buf(blockSize);
+
+  for (auto it = begin(); it != end() && length; it++) {
+    if (it->length <= offset) {
+      offset -= it->length;
+      continue;
+    }
+
+    unsigned count = min(length, it->length - offset);
+    buf.add(Slice(it->block, it->offset + offset, count));
+    length -= count;
+    offset = 0;
+  }
+
+  return buf;
+}
+
+
+unsigned SliceBuffer::remove(SliceBuffer &buf, unsigned length) {
+  length = min(length, this->length);
+
+  buf.add(slice(0, length));
+  drain(length);
+
+  return length;
+}
+
+
+void SliceBuffer::add(const Slice &slice) {
+  if (!slice.length) return;
+
+  // Merge with the last slice if they are adjacent in the same block
+  if (!slices.empty()) {
+    Slice &back = slices.back();
+
+    if (back.block == slice.block && back.end() == slice.data()) {
+      back.length += slice.length;
+      length += slice.length;
+      return;
+    }
+  }
+
+  slices.push_back(slice);
+  length += slice.length;
+}
+
+
+void SliceBuffer::add(const SliceBuffer &buf) {
+  if (&buf == this) {
+    SliceBuffer copy(buf);
+    return add(copy);
+  }
+
+  for (auto it = buf.begin(); it != buf.end(); it++) add(*it);
+}
+
+
+void SliceBuffer::add(const char *data, unsigned length) {
+  while (length) {
+    // Append in place if no other buffer can see the end of the last block
+    if (!slices.empty()) {
+      Slice &back = slices.back();
+      Block &block = *back.block;
+
+      if (back.block.getRefCount() == 1 &&
+          back.offset + back.length == block.getFill()) {
+        unsigned count = block.append(data, length);
+
+        back.length += count;
+        this->length += count;
+        data += count;
+        length -= count;
+
+        if (!length) break;
+      }
+    }
+
+    BlockPtr block = new Block(max(length, blockSize));
+    unsigned count = block->append(data, length);
+    add(Slice(block, 0, count));
+    data += count;
+    length -= count;
+  }
+}
+
+
+void SliceBuffer::add(const char *s) {add(s, strlen(s));}
+void SliceBuffer::add(const string &s) {add(s.data(), s.length());}
+
+
+void SliceBuffer::add(string &&s) {
+  if (s.empty()) return;
+
+  string *ref = new string(move(s));
+  addRef(ref->data(), ref->length(), [ref] () {delete ref;});
+}
+
+
+void SliceBuffer::addRef(const char *data, unsigned length,
+                         const Block::release_t &release) {
+  add(Slice(new Block(data, length, release), 0, length));
+}
+
+
+unsigned SliceBuffer::copy(char *dst, unsigned length, unsigned offset) const {
+  unsigned total = 0;
+
+  for (auto it = begin(); it != end() && total < length; it++) {
+    if (it->length <= offset) {
+      offset -= it->length;
+      continue;
+    }
+
+    unsigned count = min(length - total, it->length - offset);
+    memcpy(dst + total, it->data() + offset, count);
+    total += count;
+    offset = 0;
+  }
+
+  return total;
+}
+
+
+string SliceBuffer::toString() const {
+  string s;
+  s.reserve(length);
+
+  for (auto it = begin(); it != end(); it++) s.append(it->data(), it->length);
+
+  return s;
+}
+
+
+const char *SliceBuffer::pullup() {
+  if (slices.empty()) return 0;
+
+  if (1 < slices.size()) {
+    BlockPtr block = new Block(length);
+    for (auto it = begin(); it != end(); it++)
+      block->append(it->data(), it->length);
+
+    slices.clear();
+    slices.push_back(Slice(block, 0, length));
+  }
+
+  return slices.front().data();
+}
+
+
+void SliceBuffer::peek(vector<SocketBuffer> &bufs) const {
+  bufs.resize(slices.size());
+
+  for (unsigned i = 0; i < slices.size(); i++) {
+    bufs[i].data = slices[i].data();
+    bufs[i].length = slices[i].length;
+  }
+}
+
+
+#ifndef _WIN32
+void SliceBuffer::peek(vector<iovec> &space) const {
+  space.resize(slices.size());
+
+  for (unsigned i = 0; i < slices.size(); i++) {
+    space[i].iov_base = (void *)slices[i].data();
+    space[i].iov_len = slices[i].length;
+  }
+}
+#endif
+
+
+streamsize SliceBuffer::write(Socket &socket, unsigned flags) {
+  vector<SocketBuffer> bufs;
+  peek(bufs);
+  if (bufs.empty()) return 0;
+
+  streamsize bytes = socket.writev(&bufs[0], bufs.size(), flags);
+  if (0 < bytes) drain(bytes);
+
+  return bytes;
+}
+
+
+unsigned SliceBuffer::read(char *dst, unsigned length) {
+  length = copy(dst, length);
+  drain(length);
+  return length;
+}
+
+
+unsigned SliceBuffer::write(const char *src, unsigned length) {
+  add(src, length);
+  return length;
+}
+
+
+unsigned SliceBuffer::writeTo(ostream &stream) {
+  unsigned total = 0;
+
+  while (!slices.empty() && stream) {
+    const Slice &front = slices.front();
+    unsigned count = front.length;
+
+    stream.write(front.data(), count);
+    if (!stream) break;
+
+    total += count;
+    drain(count);
+  }
+
+  return total;
+}
+
+
+unsigned SliceBuffer::readFrom(istream &stream) {
+  unsigned total = 0;
+
+  while (stream) {
+    BlockPtr block = new Block(blockSize);
+
+    stream.read(block->getData(), blockSize);
+    unsigned count = stream.gcount();
+    if (!count) break;
+
+    block->incFill(count);
+    add(Slice(block, 0, count));
+    total += count;
+  }
+
+  return total;
+}
@@ -0,0 +1,168 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Buffer.h"
+
+#include <cbang/SmartPointer.h>
+#include <cbang/socket/SocketImpl.h>
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <functional>
+
+#ifndef _WIN32
+struct iovec;
+#endif
+
+
+namespace cb {
+  /**
+   * A rope of slices of reference counted memory blocks.  Slices can be
+   * appended, split and shared between buffers without copying the data,
+   * so bytes can pass through several stages of processing intact.
+   *
+   * Block reference counts are atomic but a SliceBuffer itself is not
+   * thread safe.  The data in a shared block must be treated as read only.
+   */
+  class SliceBuffer : public Buffer {
+  public:
+    class Block {
+    public:
+      typedef std::function<void ()> release_t;
+
+    protected:
+      char *data;
+      unsigned capacity;
+      unsigned fill;
+      release_t release;
+
+    public:
+      /// Allocate an owned block with room for @param capacity bytes
+      Block(unsigned capacity);
+      /// Reference external memory, @param release is called on destruction
+      Block(const char *data, unsigned length, release_t release);
+      ~Block();
+
+      char *getData() const {return data;}
+      unsigned getCapacity() const {return capacity;}
+      unsigned getFill() const {return fill;}
+      unsigned getSpace() const {return capacity - fill;}
+      bool isOwned() const {return !release;}
+
+      unsigned append(const char *src, unsigned length);
+      void incFill(unsigned count) {fill += count;}
+    };
+
+    typedef SmartPointer<Block>::Protected BlockPtr;
+
+    struct Slice {
+      BlockPtr block;
+      unsigned offset;
+      unsigned length;
+
+      Slice(const BlockPtr &block, unsigned offset, unsigned length) :
+        block(block), offset(offset), length(length) {}
+
+      const char *data() const {return block->getData() + offset;}
+      const char *end() const {return data() + length;}
+    };
+
+    typedef std::deque<Slice> slices_t;
+    typedef slices_t::const_iterator iterator;
+
+  protected:
+    slices_t slices;
+    unsigned length = 0;
+    unsigned blockSize;
+
+  public:
+    /// @param blockSize is the minimum size of blocks allocated for copies
+    SliceBuffer(unsigned blockSize = 4096) : blockSize(blockSize) {}
+    SliceBuffer(const char *data, unsigned length);
+    SliceBuffer(const std::string &s);
+    SliceBuffer(std::string &&s);
+
+    unsigned getLength() const {return length;}
+    unsigned getSliceCount() const {return slices.size();}
+    iterator begin() const {return slices.begin();}
+    iterator end() const {return slices.end();}
+
+    void clear();
+    void drain(unsigned length);
+    /// @return a buffer sharing @param length bytes from @param offset
+    SliceBuffer slice(unsigned offset, unsigned length) const;
+    /// Move the first @param length bytes to @param buf without copying
+    unsigned remove(SliceBuffer &buf, unsigned length);
+
+    void add(const Slice &slice);
+    /// Share the contents of @param buf
+    void add(const SliceBuffer &buf);
+    void add(const char *data, unsigned length);
+    void add(const char *s);
+    void add(const std::string &s);
+    /// The string is moved into the buffer, not copied.
+    void add(std::string &&s);
+    /// Reference @param data until @param release is called.
+    void addRef(const char *data, unsigned length,
+                const Block::release_t &release);
+
+    /// Copy up to @param length bytes from @param offset without draining
+    unsigned copy(char *dst, unsigned length, unsigned offset = 0) const;
+    std::string toString() const;
+
+    /**
+     * Make the contents contiguous, copying only if there is more than one
+     * slice.
+     * @return a pointer to the data or null if the buffer is empty.
+     */
+    const char *pullup();
+
+    /// Point @param bufs at every slice of the buffer, without copying
+    void peek(std::vector<SocketBuffer> &bufs) const;
+#ifndef _WIN32
+    void peek(std::vector<iovec> &space) const;
+#endif
+    /// Write with as few system calls as possible and drain what was sent
+    std::streamsize write(Socket &socket, unsigned flags = 0);
+
+    // From Buffer
+    unsigned getFill() const {return length;}
+    unsigned getSpace() const {return ~0U - length;}
+    unsigned read(char *dst, unsigned length);
+    unsigned write(const char *src, unsigned length);
+    unsigned writeTo(std::ostream &stream);
+    unsigned readFrom(std::istream &stream);
+  };
+}
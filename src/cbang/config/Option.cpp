@@ -116,6 +116,7 @@ void Option::setDefault(bool defaultValue) {
 void Option::clearDefault() {
   defaultValue.clear();
   flags &= ~DEFAULT_SET_FLAG;
+  version++;
 }
 
 
@@ -145,6 +146,7 @@ void Option::reset() {
 
   flags &= ~SET_FLAG;
   value.clear();
+  version++;
 
   if (hasAction()) (*action)(*this);
 }
@@ -192,6 +194,8 @@ void Option::set(const string &value) {
     }
   }
 
+  version++;
+
   if (hasAction()) (*action)(*this);
 }
 
@@ -675,6 +679,7 @@ void Option::setDefault(const string &value, type_t type) {
   defaultValue = value;
   flags |= DEFAULT_SET_FLAG;
   this->type = type;
+  version++;
 
   if (defaultSetAction.get()) (*defaultSetAction)(*this);
 }
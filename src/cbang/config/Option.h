@@ -87,6 +87,7 @@ namespace cb {
     std::string value;
     uint32_t flags;
     const std::string *filename;
+    uint32_t version = 0;
 
     typedef std::set<std::string> aliases_t;
     aliases_t aliases;
@@ -198,6 +199,9 @@ namespace cb {
 
     bool isSet() const {return flags & SET_FLAG;}
     bool hasValue() const;
+    /// Changes whenever this option's, or its parent's, value or default does
+    uint32_t getVersion() const
+    {return version + (parent.isNull() ? 0 : parent->getVersion());}
 
     bool toBoolean() const;
     const std::string &toString() const;
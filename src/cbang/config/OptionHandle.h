@@ -0,0 +1,125 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Option.h"
+
+#include <cbang/SmartPointer.h>
+
+#include <string>
+
+
+namespace cb {
+  /**
+   * A typed reference to an Option which caches the parsed value.  The
+   * cache is refreshed only when Option::getVersion() changes, so reading
+   * an unchanged option does not parse its string value.
+   *
+   * A handle must not be read from several threads while its option may
+   * change.
+   */
+  template <typename T>
+  class OptionHandle {
+    SmartPointer<Option> option;
+    mutable bool valid = false;
+    mutable uint32_t version = 0;
+    mutable T value;
+
+  public:
+    OptionHandle() : value() {}
+    OptionHandle(const SmartPointer<Option> &option) :
+      option(option), value() {}
+
+    const SmartPointer<Option> &getOption() const {return option;}
+    bool isNull() const {return option.isNull();}
+    bool hasValue() const {return option->hasValue();}
+
+    const T &get() const {
+      uint32_t v = option->getVersion();
+
+      if (!valid || v != version) {
+        value = convert(*option);
+        version = v;
+        valid = true;
+      }
+
+      return value;
+    }
+
+    const T &operator*() const {return get();}
+    const T *operator->() const {return &get();}
+    operator const T &() const {return get();}
+
+    static T convert(const Option &option) {return (T)option.toInteger();}
+  };
+
+
+  template <>
+  inline bool OptionHandle<bool>::convert(const Option &option) {
+    return option.toBoolean();
+  }
+
+  template <>
+  inline double OptionHandle<double>::convert(const Option &option) {
+    return option.toDouble();
+  }
+
+  template <>
+  inline float OptionHandle<float>::convert(const Option &option) {
+    return option.toDouble();
+  }
+
+  template <>
+  inline std::string
+  OptionHandle<std::string>::convert(const Option &option) {
+    return option.toString();
+  }
+
+  template <>
+  inline Option::strings_t
+  OptionHandle<Option::strings_t>::convert(const Option &option) {
+    return option.toStrings();
+  }
+
+  template <>
+  inline Option::integers_t
+  OptionHandle<Option::integers_t>::convert(const Option &option) {
+    return option.toIntegers();
+  }
+
+  template <>
+  inline Option::doubles_t
+  OptionHandle<Option::doubles_t>::convert(const Option &option) {
+    return option.toDoubles();
+  }
+}
@@ -39,6 +39,7 @@
 
 #include "Option.h"
 #include "OptionActionSet.h"
+#include "OptionHandle.h"
 
 #include <cbang/xml/XMLHandlerFactory.h>
 #include <cbang/xml/XMLFileTracker.h>
@@ -105,6 +106,12 @@ namespace cb {
     }
 
     Option &operator[](const std::string &key) const {return *get(key);}
+
+    /// Resolve @param key once for fast, typed reads in hot paths
+    template <typename T>
+    OptionHandle<T> getHandle(const std::string &key)
+    {return OptionHandle<T>(localize(key));}
+
     void set(const std::string &name, const std::string &value,
              bool setDefault = false);
 
@@ -0,0 +1,271 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include <cbang/config.h>
+
+#ifdef HAVE_LEVELDB
+
+#include "AsyncLevelDB.h"
+
+#include <cbang/event/ConcurrentPool.h>
+#include <cbang/log/Logger.h>
+
+using namespace std;
+using namespace cb;
+
+
+struct AsyncLevelDB::Scan {
+  string seek;
+  string prefix;
+  bool reverse;
+  int options;
+  unsigned batchSize;
+
+  // Only accessed by the pool thread running the current batch
+  SmartPointer<LevelDB::Iterator> it;
+  bool done = false;
+};
+
+
+AsyncLevelDB::AsyncLevelDB(const LevelDB &db, Event::ConcurrentPool &pool) :
+  LevelDB(db), pool(pool) {}
+
+
+AsyncLevelDB::AsyncLevelDB(
+  Event::ConcurrentPool &pool,
+  const SmartPointer<LevelDB::Comparator> &comparator) :
+  LevelDB(comparator), pool(pool) {}
+
+
+AsyncLevelDB::AsyncLevelDB(
+  const string &name, Event::ConcurrentPool &pool,
+  const SmartPointer<LevelDB::Comparator> &comparator) :
+  LevelDB(name, comparator), pool(pool) {}
+
+
+AsyncLevelDB AsyncLevelDB::ns(const string &name) {
+  AsyncLevelDB db(LevelDB::ns(name), pool);
+  db.priority = priority;
+  db.errorCB = errorCB;
+  return db;
+}
+
+
+void AsyncLevelDB::open(const string &path, done_cb_t cb, int options) {
+  submit([this, path, options] () {LevelDB::open(path, options);}, cb);
+}
+
+
+void AsyncLevelDB::close(done_cb_t cb) {
+  submit([this] () {LevelDB::close();}, cb);
+}
+
+
+void AsyncLevelDB::has(const string &key, function<void (bool)> cb,
+                       int options) const {
+  submit<bool>([this, key, options] () {return LevelDB::has(key, options);},
+               [cb] (bool &result) {if (cb) cb(result);});
+}
+
+
+void AsyncLevelDB::get(const string &key, function<void (const string &)> cb,
+                       int options) const {
+  submit<string>([this, key, options] () {return LevelDB::get(key, options);},
+                 [cb] (string &result) {if (cb) cb(result);});
+}
+
+
+void AsyncLevelDB::get(const string &key, const string &defaultValue,
+                       function<void (const string &)> cb, int options) const {
+  submit<string>([this, key, defaultValue, options] () {
+      return LevelDB::get(key, defaultValue, options);
+    }, [cb] (string &result) {if (cb) cb(result);});
+}
+
+
+void AsyncLevelDB::getMany(const vector<string> &keys,
+                           function<void (const values_t &)> cb,
+                           int options) const {
+  auto run =
+    [this, keys, options] () {
+      values_t values;
+
+      for (unsigned i = 0; i < keys.size(); i++)
+        if (LevelDB::has(keys[i], options))
+          values[keys[i]] = LevelDB::get(keys[i], options);
+
+      return values;
+    };
+
+  submit<values_t>(run, [cb] (values_t &values) {if (cb) cb(values);});
+}
+
+
+void AsyncLevelDB::set(const string &key, const string &value, done_cb_t cb,
+                       int options) {
+  submit([this, key, value, options] () {LevelDB::set(key, value, options);},
+         cb);
+}
+
+
+void AsyncLevelDB::erase(const string &key, done_cb_t cb, int options) {
+  submit([this, key, options] () {LevelDB::erase(key, options);}, cb);
+}
+
+
+void AsyncLevelDB::foreach(foreach_cb_t cb, const string &seek, bool reverse,
+                           int options, unsigned batchSize,
+                           done_cb_t done) const {
+  if (!cb) THROW("Callback cannot be null");
+
+  auto batch =
+    [cb] (const results_t &results) {
+      for (unsigned i = 0; i < results.size(); i++)
+        if (!cb(results[i].first, results[i].second)) return false;
+      return true;
+    };
+
+  scan(batch, seek, reverse, options, batchSize, done);
+}
+
+
+void AsyncLevelDB::scan(batch_cb_t cb, const string &seek, bool reverse,
+                        int options, unsigned batchSize,
+                        done_cb_t done) const {
+  if (!cb) THROW("Callback cannot be null");
+
+  SmartPointer<Scan> scan = new Scan;
+  scan->seek = seek;
+  scan->reverse = reverse;
+  scan->options = options;
+  scan->batchSize = batchSize ? batchSize : 1;
+
+  nextBatch(scan, cb, done);
+}
+
+
+void AsyncLevelDB::prefix(const string &prefix, batch_cb_t cb,
+                          unsigned batchSize, done_cb_t done,
+                          int options) const {
+  if (!cb) THROW("Callback cannot be null");
+
+  SmartPointer<Scan> scan = new Scan;
+  scan->prefix = prefix;
+  scan->reverse = false;
+  scan->options = options;
+  scan->batchSize = batchSize ? batchSize : 1;
+
+  nextBatch(scan, cb, done);
+}
+
+
+void AsyncLevelDB::commit(const Batch &batch, done_cb_t cb, int options) {
+  Batch copy(batch);
+  submit([copy, options] () mutable {copy.commit(options);}, cb);
+}
+
+
+void AsyncLevelDB::compact(done_cb_t cb, const string &begin,
+                           const string &end) {
+  submit([this, begin, end] () {LevelDB::compact(begin, end);}, cb);
+}
+
+
+template <typename Data>
+void AsyncLevelDB::submit(function<Data ()> run,
+                          function<void (Data &)> success) const {
+  pool.submit<Data>(priority, run, success,
+                    [this] (const Exception &e) {error(e);});
+}
+
+
+void AsyncLevelDB::submit(function<void ()> run, done_cb_t cb) const {
+  submit<bool>([run] () {run(); return true;},
+               [cb] (bool &) {if (cb) cb();});
+}
+
+
+void AsyncLevelDB::nextBatch(const SmartPointer<Scan> &scan, batch_cb_t cb,
+                             done_cb_t done) const {
+  auto run =
+    [this, scan] () {
+      Scan &s = *scan;
+      results_t results;
+
+      if (s.it.isNull()) {
+        s.it = new LevelDB::Iterator(iterator(s.options));
+
+        if (!s.prefix.empty()) s.it->seek(s.prefix);
+        else if (!s.seek.empty()) s.it->seek(s.seek);
+        else if (s.reverse) s.it->last();
+        else s.it->first();
+      }
+
+      while (results.size() < s.batchSize && s.it->valid()) {
+        string key = s.it->key();
+
+        if (!s.prefix.empty() && key.compare(0, s.prefix.size(), s.prefix)) {
+          s.done = true;
+          break;
+        }
+
+        results.push_back(results_t::value_type(key, s.it->value()));
+
+        if (s.reverse) s.it->prev();
+        else s.it->next();
+      }
+
+      if (!s.it->valid()) s.done = true;
+      if (s.done) s.it.release(); // Free the LevelDB iterator early
+
+      return results;
+    };
+
+  auto success =
+    [this, scan, cb, done] (results_t &results) {
+      bool more = !scan->done;
+      if (!results.empty() && !cb(results)) more = false;
+
+      if (more) nextBatch(scan, cb, done);
+      else if (done) done();
+    };
+
+  submit<results_t>(run, success);
+}
+
+
+void AsyncLevelDB::error(const Exception &e) const {
+  if (errorCB) errorCB(e);
+  else LOG_ERROR("AsyncLevelDB: " << e);
+}
+
+#endif // HAVE_LEVELDB
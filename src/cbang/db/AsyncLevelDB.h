@@ -32,125 +32,124 @@
 
 #pragma once
 
+#include <cbang/config.h>
+
+#ifdef HAVE_LEVELDB
+
 #include "LevelDB.h"
 
 #include <cbang/SmartPointer.h>
-#include <cbang/async/AsyncScheduler.h>
+#include <cbang/Exception.h>
 
+#include <string>
+#include <vector>
+#include <map>
 #include <functional>
 
 
 namespace cb {
+  namespace Event {class ConcurrentPool;}
+
+  /**
+   * Runs LevelDB operations on an Event::ConcurrentPool so they do not block
+   * the event loop.  Callbacks are called on the pool's Event::Base thread.
+   * All arguments are copied so they need not outlive the call but the
+   * AsyncLevelDB itself must outlive any outstanding operations.
+   *
+   * Iteration is done in batches.  The next batch is only read once the
+   * previous one has been handed to the callback so large scans do not
+   * accumulate in memory.
+   */
   class AsyncLevelDB : public LevelDB {
-    SmartPointer<AsyncScheduler> scheduler;
-
   public:
-    AsyncLevelDB(const LevelDB &db,
-                 const SmartPointer<AsyncScheduler> &scheduler) :
-      LevelDB(db), scheduler(scheduler) {}
+    typedef std::vector<std::pair<std::string, std::string> > results_t;
+    typedef std::map<std::string, std::string> values_t;
 
-    AsyncLevelDB(const SmartPointer<AsyncScheduler> &scheduler,
-                 const SmartPointer<LevelDB::Comparator> &comparator = 0) :
-      LevelDB(comparator), scheduler(scheduler) {}
+    typedef std::function<void ()> done_cb_t;
+    typedef std::function<void (const Exception &e)> error_cb_t;
+    typedef std::function<bool (const std::string &key,
+                                const std::string &value)> foreach_cb_t;
+    /// Return false to stop iterating
+    typedef std::function<bool (const results_t &results)> batch_cb_t;
 
-    AsyncLevelDB(const std::string &name,
-                 const SmartPointer<AsyncScheduler> &scheduler,
-                 const SmartPointer<LevelDB::Comparator> &comparator = 0) :
-      LevelDB(name, comparator), scheduler(scheduler) {}
+  protected:
+    Event::ConcurrentPool &pool;
+    int priority = 0;
+    error_cb_t errorCB;
 
+    struct Scan;
 
-    AsyncLevelDB ns(const std::string &name) {
-      return AsyncLevelDB(LevelDB::ns(name), scheduler);
-    }
+  public:
+    AsyncLevelDB(const LevelDB &db, Event::ConcurrentPool &pool);
+    AsyncLevelDB(Event::ConcurrentPool &pool,
+                 const SmartPointer<LevelDB::Comparator> &comparator = 0);
+    AsyncLevelDB(const std::string &name, Event::ConcurrentPool &pool,
+                 const SmartPointer<LevelDB::Comparator> &comparator = 0);
 
+    Event::ConcurrentPool &getPool() const {return pool;}
 
-    void open(const std::string &path, std::function<void ()> cb,
-              int options = 0) {
-      scheduler->add([&] () {LevelDB::open(path, options);}, cb);
-    }
+    /// ConcurrentPool priority of submitted tasks
+    int getPriority() const {return priority;}
+    void setPriority(int priority) {this->priority = priority;}
 
+    /// Called when an operation fails.  By default errors are logged.
+    void setErrorCallback(error_cb_t cb) {errorCB = cb;}
 
-    void close(std::function<void ()> cb) {
-      scheduler->add([this] () {LevelDB::close();}, cb);
-    }
+    AsyncLevelDB ns(const std::string &name);
 
+    void open(const std::string &path, done_cb_t cb, int options = 0);
+    void close(done_cb_t cb);
 
     void has(const std::string &key, std::function<void (bool)> cb,
-             int options = 0) const {
-      bool result = false;
-
-      scheduler->add([&] () {result = LevelDB::has(key, options);},
-                     [&] () {if (cb) cb(result);});
-    }
-
-
+             int options = 0) const;
     void get(const std::string &key,
              std::function<void (const std::string &)> cb,
-             int options = 0) const {
-      std::string result;
-
-      scheduler->add([&] () {result = LevelDB::get(key, options);},
-                     [&] () {if (cb) cb(result);});
-    }
-
-
+             int options = 0) const;
     void get(const std::string &key, const std::string &defaultValue,
              std::function<void (const std::string &)> cb,
-             int options = 0) const {
-      std::string result;
-
-      scheduler->add([&] () {
-          result = LevelDB::get(key, defaultValue, options);
-        }, [&] () {if (cb) cb(result);});
-    }
-
-
-    void foreach(std::function<bool (const std::string &key,
-                                     const std::string &value)> cb,
-                 const std::string &seek = std::string(),
+             int options = 0) const;
+    /// Read many keys in one task.  Missing keys are left out of the result.
+    void getMany(const std::vector<std::string> &keys,
+                 std::function<void (const values_t &)> cb,
+                 int options = 0) const;
+
+    void set(const std::string &key, const std::string &value,
+             done_cb_t cb = 0, int options = 0);
+    void erase(const std::string &key, done_cb_t cb = 0, int options = 0);
+
+    /// Call @param cb for each entry until it returns false
+    void foreach(foreach_cb_t cb, const std::string &seek = std::string(),
                  bool reverse = false, int options = 0,
-                 int batchSize = 1000) const {
-      LevelDB::Iterator it = iterator(options);
-      bool first = true;
-
-      typedef std::vector<std::pair<std::string, std::string> > results_t;
-      results_t results(batchSize);
-
-      auto batch = [&] () {
-        if (first) {
-          if (seek.empty()) {
-            if (reverse) it.last();
-            else it.first();
-          } else it.seek(seek);
-
-          first = false;
-        }
-
-        for (int i = 0; i < batchSize && it.valid(); reverse ? it-- : it++)
-          results.push_back(results_t::value_type(it.key(), it.value()));
-      };
-
-      std::function<void ()> process = [&] () {
-        for (unsigned i = 0; i < results.size(); i++)
-          if (!cb(results[i].first, results[i].second)) return;
-        results.clear();
-
-        if (first || it.valid()) scheduler->add(batch, process);
-      };
-
-      process(); // Kick things off
-    }
-
-
-    void commit(Batch &batch, std::function<void ()> cb, int options = 0) {
-      scheduler->add([&] () {batch.commit(options);}, cb);
-    }
-
-
-    void compact(std::function<void ()> cb,
-                 const std::string &begin = std::string(),
-                 const std::string &end = std::string()) {
-      scheduler->add([&] () {LevelDB::compact(begin, end);}, cb);
-    }
+                 unsigned batchSize = 1000, done_cb_t done = 0) const;
+
+    /**
+     * Deliver entries in batches of up to @param batchSize starting at
+     * @param seek.  @param done is called after the last batch or once
+     * @param cb returns false.
+     */
+    void scan(batch_cb_t cb, const std::string &seek = std::string(),
+              bool reverse = false, int options = 0,
+              unsigned batchSize = 1000, done_cb_t done = 0) const;
+
+    /// Like scan() but only for keys which start with @param prefix
+    void prefix(const std::string &prefix, batch_cb_t cb,
+                unsigned batchSize = 1000, done_cb_t done = 0,
+                int options = 0) const;
+
+    void commit(const Batch &batch, done_cb_t cb = 0, int options = 0);
+    void compact(done_cb_t cb, const std::string &begin = std::string(),
+                 const std::string &end = std::string());
+
+  protected:
+    template <typename Data>
+    void submit(std::function<Data ()> run,
+                std::function<void (Data &)> success) const;
+    void submit(std::function<void ()> run, done_cb_t cb) const;
+
+    void nextBatch(const SmartPointer<Scan> &scan, batch_cb_t cb,
+                   done_cb_t done) const;
+    void error(const Exception &e) const;
   };
 }
+
+#endif // HAVE_LEVELDB
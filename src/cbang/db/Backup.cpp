@@ -35,26 +35,85 @@
 #include "Database.h"
 
 #include <cbang/Exception.h>
+#include <cbang/event/Base.h>
+#include <cbang/event/Event.h>
+#include <cbang/log/Logger.h>
 
 #include <sqlite3.h>
 
+using namespace cb;
 using namespace cb::DB;
 
 
+Backup::Backup(struct sqlite3_backup *backup) :
+  backup(backup), done(false) {}
+
+
 Backup::~Backup() {
+  if (event.isSet()) event->del();
   if (backup) sqlite3_backup_finish(backup);
 }
 
 
+unsigned Backup::getRemaining() const {
+  return sqlite3_backup_remaining(backup);
+}
+
+
+unsigned Backup::getPageCount() const {
+  return sqlite3_backup_pagecount(backup);
+}
+
+
+double Backup::getProgress() const {
+  if (done) return 1;
+
+  unsigned total = getPageCount();
+  return total ? (double)(total - getRemaining()) / total : 0;
+}
+
+
 bool Backup::step() {
   if (done) return false;
 
-  int ret = sqlite3_backup_step(backup, 10);
+  int ret = sqlite3_backup_step(backup, pagesPerStep);
 
   switch (ret) {
   case SQLITE_OK: return true; // More to do
   case SQLITE_DONE: done = true; return false;
+  case SQLITE_BUSY: case SQLITE_LOCKED: return true; // Try again later
   default:
     THROW("Error during database backup: " << Database::errorMsg(ret));
   }
 }
+
+
+void Backup::start(Event::Base &base, double interval,
+                   progress_cb_t progress, done_cb_t done,
+                   error_cb_t error) {
+  this->interval = interval;
+  progressCB = progress;
+  doneCB = done;
+  errorCB = error;
+
+  event = base.newEvent(this, &Backup::next, 0);
+  event->add(0);
+}
+
+
+void Backup::next() {
+  bool more;
+
+  try {
+    more = step();
+    if (progressCB) progressCB(getRemaining(), getPageCount());
+
+  } catch (const Exception &e) {
+    if (errorCB) errorCB(e);
+    else LOG_ERROR(e);
+    return;
+  }
+
+  if (more) event->add(interval);
+  else if (doneCB) doneCB();
+}
@@ -30,22 +30,75 @@
 
 \******************************************************************************/
 
+
 #pragma once
 
+#include <cbang/SmartPointer.h>
+
+#include <functional>
+
 struct sqlite3_backup;
 
 namespace cb {
+  class Exception;
+  namespace Event {class Base; class Event;}
+
   namespace DB {
+    /**
+     * Copies a database a few pages at a time.  The source is only locked
+     * while a step runs so writers can proceed between steps.  If another
+     * connection writes to the source the backup restarts, writes through
+     * the source connection are copied to the backup as they happen.
+     */
     class Backup {
+    public:
+      typedef std::function<void (unsigned remaining, unsigned total)>
+      progress_cb_t;
+      typedef std::function<void ()> done_cb_t;
+      typedef std::function<void (const Exception &e)> error_cb_t;
+
+    protected:
       struct sqlite3_backup *backup;
       bool done;
+      int pagesPerStep = 10;
+
+      SmartPointer<Event::Event> event;
+      double interval = 0;
+      progress_cb_t progressCB;
+      done_cb_t doneCB;
+      error_cb_t errorCB;
 
     public:
-      Backup(struct sqlite3_backup *backup) : backup(backup), done(false) {}
+      Backup(struct sqlite3_backup *backup);
       ~Backup();
 
+      int getPagesPerStep() const {return pagesPerStep;}
+      /// A negative value copies everything in the next step
+      void setPagesPerStep(int pages) {pagesPerStep = pages;}
+
       bool isDone() const {return done;}
+      /// Pages left to copy, as of the last step
+      unsigned getRemaining() const;
+      /// Pages in the source database, as of the last step
+      unsigned getPageCount() const;
+      /// The fraction copied, as of the last step
+      double getProgress() const;
+
+      /// @return true if there is more to copy
       bool step();
+
+      /**
+       * Copy a step every @param interval seconds from @param base's
+       * event loop.  @param progress is called after each step, then
+       * either @param done or @param error at the end.  The Backup must
+       * outlive the copy, destroying it stops the copy.
+       */
+      void start(Event::Base &base, double interval,
+                 progress_cb_t progress = 0, done_cb_t done = 0,
+                 error_cb_t error = 0);
+
+    protected:
+      void next();
     };
   }
 }
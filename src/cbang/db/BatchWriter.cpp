@@ -0,0 +1,89 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "BatchWriter.h"
+
+#include "Database.h"
+
+#include <cbang/time/Timer.h>
+#include <cbang/log/Logger.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::DB;
+
+
+BatchWriter::BatchWriter(Database &db, const string &sql,
+                         unsigned commitInterval) :
+  db(db), stmt(db.compile(sql)), commitInterval(commitInterval),
+  startTime(Timer::now()) {}
+
+
+BatchWriter::~BatchWriter() {
+  if (transaction.isSet() && pending)
+    LOG_WARNING("Rolling back " << pending << " uncommitted batch rows");
+}
+
+
+double BatchWriter::getRate() const {
+  return elapsed ? (rows - pending) / elapsed : 0;
+}
+
+
+void BatchWriter::write() {
+  if (!pending) begin();
+
+  stmt->execute();
+  stmt->clearBindings();
+
+  rows++;
+  if (commitInterval <= ++pending) commit();
+}
+
+
+void BatchWriter::commit() {
+  if (transaction.isSet()) {
+    transaction->commit();
+    transaction = 0;
+  }
+
+  pending = 0;
+  elapsed = Timer::now() - startTime;
+
+  LOG_DEBUG(3, "Committed " << rows << " batch rows at " << getRate()
+            << " rows/sec");
+}
+
+
+void BatchWriter::begin() {
+  if (!db.inTransaction()) transaction = db.begin(Database::IMMEDIATE);
+}
@@ -0,0 +1,124 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Statement.h"
+#include "Transaction.h"
+
+#include <cbang/SmartPointer.h>
+#include <cbang/Exception.h>
+
+#include <string>
+#include <vector>
+
+
+namespace cb {
+  namespace DB {
+    class Database;
+
+    /**
+     * Executes one prepared INSERT, REPLACE or UPSERT Statement for many rows
+     * inside a Transaction.  The Transaction is committed every
+     * @param commitInterval rows and by commit().  Rows which have not been
+     * committed are rolled back if the BatchWriter is destroyed first.  If
+     * the Database is already in a Transaction the rows become part of it
+     * instead.
+     */
+    class BatchWriter {
+      Database &db;
+      SmartPointer<Statement> stmt;
+      unsigned commitInterval;
+
+      SmartPointer<Transaction> transaction;
+      uint64_t rows = 0;
+      uint64_t pending = 0;
+      double startTime;
+      double elapsed = 0;
+
+    public:
+      BatchWriter(Database &db, const std::string &sql,
+                  unsigned commitInterval = 10000);
+      ~BatchWriter();
+
+      Statement &getStatement() {return *stmt;}
+
+      unsigned getCommitInterval() const {return commitInterval;}
+      void setCommitInterval(unsigned x) {commitInterval = x;}
+
+      /// Rows written, including those not yet committed
+      uint64_t getRows() const {return rows;}
+      uint64_t getPending() const {return pending;}
+      /// Rows per second from construction until the last commit()
+      double getRate() const;
+
+      Parameter parameter(unsigned i) const {return stmt->parameter(i);}
+      Parameter parameter(const std::string &name) const
+      {return stmt->parameter(name);}
+
+      /// Execute the currently bound row
+      void write();
+
+      /// Bind @param values to the parameters in order and write one row
+      template <typename... Args>
+      void insert(const Args &... values) {
+        unsigned i = 0;
+        int dummy[] = {0, (bind(stmt->parameter(i++), values), 0)...};
+        (void)dummy;
+        write();
+      }
+
+      /// Write one row for each index of the column vectors
+      template <typename... Columns>
+      void insertColumns(const std::vector<Columns> &... columns) {
+        static_assert(sizeof...(Columns), "Need at least one column");
+
+        size_t sizes[] = {columns.size()...};
+        for (unsigned i = 1; i < sizeof...(Columns); i++)
+          if (sizes[i] != sizes[0]) THROW("Column vector sizes differ");
+
+        for (size_t row = 0; row < sizes[0]; row++) insert(columns[row]...);
+      }
+
+      void commit();
+
+    protected:
+      void begin();
+
+      template <typename T>
+      static void bind(const Parameter &param, const T &value)
+      {param.bind(value);}
+      static void bind(const Parameter &param, const char *value)
+      {param.bind(std::string(value));}
+    };
+  }
+}
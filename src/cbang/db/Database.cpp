@@ -37,7 +37,11 @@
 #include <cbang/Exception.h>
 #include <cbang/String.h>
 
+#include <cbang/config.h>
+#include <cbang/config/Options.h>
 #include <cbang/os/SystemUtilities.h>
+#include <cbang/os/Condition.h>
+#include <cbang/util/SmartLock.h>
 
 #include <cbang/log/Logger.h>
 
@@ -50,6 +54,25 @@ using namespace cb;
 using namespace cb::DB;
 
 
+#ifdef HAVE_SQLITE_UNLOCK_NOTIFY
+namespace {
+  struct UnlockNotification : public Condition {
+    bool fired = false;
+  };
+
+
+  void unlockNotifyCB(void **args, int count) {
+    for (int i = 0; i < count; i++) {
+      UnlockNotification &un = *(UnlockNotification *)args[i];
+      SmartLock lock(&un);
+      un.fired = true;
+      un.signal();
+    }
+  }
+}
+#endif // HAVE_SQLITE_UNLOCK_NOTIFY
+
+
 Database::Database(double timeout) : timeout(timeout), db(0), transaction(0) {}
 
 
@@ -58,6 +81,39 @@ Database::~Database() {
 }
 
 
+void Database::addOptions(Options &options) {
+  options.pushCategory("Database");
+
+  options.addTarget("db-journal-mode", journalMode, "The SQLite journal "
+                    "mode.  WAL allows readers to proceed while writing.  "
+                    "Empty to leave unchanged.");
+  options.addTarget("db-synchronous", synchronous, "The SQLite synchronous "
+                    "mode.  NORMAL is safe in WAL mode.  Empty to leave "
+                    "unchanged.");
+  options.addTarget("db-mmap-size", mmapSize, "The maximum number of bytes "
+                    "of the database to access with memory-mapped I/O.");
+  options.addTarget("db-cache-size", cacheSize, "The SQLite page cache size.  "
+                    "Positive values are pages and negative values KiB.  Zero "
+                    "for the default.");
+  options.addTarget("db-statement-cache", statementCacheSize, "The maximum "
+                    "number of prepared statements to cache.");
+
+  options.popCategory();
+}
+
+
+void Database::setStatementCacheSize(unsigned size) {
+  statementCacheSize = size;
+  trimStatementCache();
+}
+
+
+void Database::clearStatementCache() {
+  statementCache.clear();
+  statementLRU.clear();
+}
+
+
 bool Database::isOpen() const {
   return db;
 }
@@ -74,10 +130,23 @@ void Database::open(const string &filename, unsigned flags) {
   }
 
   sqlite3_busy_timeout(db, (int)(timeout * 1000));
+
+  // Tuning failures are not fatal
+  try {
+    if (!(flags & READ_ONLY)) {
+      if (!journalMode.empty()) pragma("journal_mode", journalMode);
+      if (!synchronous.empty()) pragma("synchronous", synchronous);
+    }
+
+    pragma("mmap_size", String(mmapSize));
+    if (cacheSize) pragma("cache_size", String(cacheSize));
+  } CATCH_WARNING;
 }
 
 
 void Database::close() {
+  clearStatementCache();
+
   if (isOpen()) {
     if (sqlite3_close(db) != SQLITE_OK)
       LOG_WARNING("Failed to close DB connection: " << lastErrorMsg());
@@ -96,24 +165,33 @@ void Database::executef(const char *sql, ...) {
 
 
 void Database::execute(const string &sql) {
-  // TODO handle SQLITE_LOCKED return code with sqlite3_unlock_notify() and a
-  //   condition variable to support shared-cache mode.
-
   LOG_DEBUG(5, "SQL: " << sql);
 
-  char *err = 0;
-  int ret = sqlite3_exec(db, sql.c_str(), 0, 0, &err);
+  const char *next = sql.c_str();
+  const char *end = next + sql.length();
 
-  if (ret || err) {
-    string errMsg;
+  while (next < end) {
+    sqlite3_stmt *stmt = 0;
+    const char *tail = 0;
+    int ret;
 
-    if (err) {
-      errMsg = err;
-      sqlite3_free(err);
+    while ((ret = sqlite3_prepare_v2(db, next, end - next, &stmt, &tail)) ==
+           SQLITE_LOCKED && waitForUnlock())
+      continue;
 
-    } else errMsg = errorMsg(ret);
+    if (ret == SQLITE_OK && stmt) {
+      while ((ret = sqlite3_step(stmt)) == SQLITE_ROW ||
+             (ret == SQLITE_LOCKED && waitForUnlock()))
+        if (ret == SQLITE_LOCKED) sqlite3_reset(stmt);
 
-    THROW("Error executing: '" << sql << "': " << errMsg);
+      if (ret == SQLITE_DONE) ret = SQLITE_OK;
+    }
+
+    string errMsg = ret ? sqlite3_errmsg(db) : "";
+    if (stmt) sqlite3_finalize(stmt);
+    if (ret) THROW("Error executing: '" << sql << "': " << errMsg);
+
+    next = tail;
   }
 }
 
@@ -145,13 +223,37 @@ SmartPointer<Statement> Database::compilef(const char *sql, ...) {
 
 
 SmartPointer<Statement> Database::compile(const string &sql) {
-  return new Statement(*this, sql);
+  if (!statementCacheSize) return new Statement(*this, sql);
+
+  auto it = statementCache.find(sql);
+
+  if (it != statementCache.end()) {
+    SmartPointer<Statement> &stmt = it->second->second;
+
+    // Still in use elsewhere
+    if (stmt.getRefCount() != 1) return new Statement(*this, sql);
+
+    statementLRU.splice(statementLRU.begin(), statementLRU, it->second);
+    stmt->reset();
+    stmt->clearBindings();
+
+    return stmt;
+  }
+
+  SmartPointer<Statement> stmt = new Statement(*this, sql);
+  statementLRU.push_front(cache_entry_t(sql, stmt));
+  statementCache[sql] = statementLRU.begin();
+  trimStatementCache();
+
+  return stmt;
 }
 
 
 SmartPointer<Transaction> Database::begin(transaction_t type, double timeout) {
   if (transaction) THROW("Already in a transaction");
 
+  resetStatements();
+
   switch (type) {
   case DEFERRED: execute("BEGIN DEFERRED"); break;
   case IMMEDIATE: execute("BEGIN IMMEDIATE"); break;
@@ -165,6 +267,7 @@ SmartPointer<Transaction> Database::begin(transaction_t type, double timeout) {
 void Database::commit() {
   if (!transaction) THROW("Not in a transaction");
 
+  resetStatements();
   execute("COMMIT");
 
   // NOTE Transaction is deleted by the SmartPointer returned from begin()
@@ -176,6 +279,7 @@ void Database::commit() {
 void Database::rollback() {
   if (!transaction) THROW("Not in a transaction");
 
+  resetStatements();
   execute("ROLLBACK");
 
   // NOTE Transaction is deleted by the SmartPointer returned from begin()
@@ -201,6 +305,27 @@ const char *Database::lastErrorMsg() const {
 }
 
 
+bool Database::waitForUnlock() {
+#ifdef HAVE_SQLITE_UNLOCK_NOTIFY
+  if (sqlite3_extended_errcode(db) != SQLITE_LOCKED_SHAREDCACHE) return false;
+
+  UnlockNotification un;
+
+  // Fails with SQLITE_LOCKED if waiting would deadlock
+  if (sqlite3_unlock_notify(db, unlockNotifyCB, &un) != SQLITE_OK)
+    return false;
+
+  SmartLock lock(&un);
+  while (!un.fired) un.wait();
+
+  return true;
+
+#else
+  return false;
+#endif // HAVE_SQLITE_UNLOCK_NOTIFY
+}
+
+
 const char *Database::errorMsg(int code) {
   switch (code) {
   case SQLITE_OK:         return "Successful result";
@@ -243,3 +368,26 @@ string Database::escape(const string &s) {
   sqlite3_free(escaped);
   return result;
 }
+
+
+void Database::pragma(const string &name, const string &value) {
+  string result;
+  execute("PRAGMA " + name + "=" + value, result);
+  LOG_DEBUG(3, "SQLite " << name << "=" << result);
+}
+
+
+void Database::trimStatementCache() {
+  while (statementCacheSize < statementLRU.size()) {
+    statementCache.erase(statementLRU.back().first);
+    statementLRU.pop_back();
+  }
+}
+
+
+void Database::resetStatements() {
+  // Idle cached Statements left mid-result would hold open read transactions
+  for (auto &entry: statementLRU)
+    if (entry.second.getRefCount() == 1 && entry.second->isActive())
+      entry.second->reset();
+}
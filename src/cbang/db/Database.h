@@ -38,10 +38,14 @@
 #include <cbang/SmartPointer.h>
 
 #include <string>
+#include <list>
+#include <map>
 
 struct sqlite3;
 
 namespace cb {
+  class Options;
+
   namespace DB {
     class Statement;
     class Blob;
@@ -51,6 +55,17 @@ namespace cb {
       sqlite3 *db;
       Transaction *transaction;
 
+      std::string journalMode = "WAL";
+      std::string synchronous = "NORMAL";
+      int64_t mmapSize = 64 * 1024 * 1024;
+      int64_t cacheSize = 0;
+      unsigned statementCacheSize = 64;
+
+      typedef std::pair<std::string, SmartPointer<Statement> > cache_entry_t;
+      typedef std::list<cache_entry_t> statement_lru_t;
+      statement_lru_t statementLRU;
+      std::map<std::string, statement_lru_t::iterator> statementCache;
+
     public:
       typedef enum {
         DEFERRED,
@@ -74,6 +89,29 @@ namespace cb {
 
       sqlite3 *getDB() const {return db;}
 
+      void addOptions(Options &options);
+
+      /// These take effect on the next call to open()
+      const std::string &getJournalMode() const {return journalMode;}
+      void setJournalMode(const std::string &mode) {journalMode = mode;}
+      const std::string &getSynchronous() const {return synchronous;}
+      void setSynchronous(const std::string &mode) {synchronous = mode;}
+      int64_t getMMapSize() const {return mmapSize;}
+      void setMMapSize(int64_t size) {mmapSize = size;}
+      /// Positive values are pages, negative KiB and zero the SQLite default
+      int64_t getCacheSize() const {return cacheSize;}
+      void setCacheSize(int64_t size) {cacheSize = size;}
+
+      /**
+       * compile() keeps up to this many prepared Statements, keyed by their
+       * SQL, in an LRU cache.  A cached Statement is only handed out again
+       * once all other references to it have been released.  Zero disables
+       * the cache.
+       */
+      unsigned getStatementCacheSize() const {return statementCacheSize;}
+      void setStatementCacheSize(unsigned size);
+      void clearStatementCache();
+
       bool isOpen() const;
 
       void open(const std::string &con, unsigned flags = READ_WRITE | CREATE);
@@ -90,6 +128,7 @@ namespace cb {
 
       SmartPointer<Transaction> begin(transaction_t type = DEFERRED,
                                       double timeout = 30);
+      bool inTransaction() const {return transaction;}
       void commit();
       void rollback();
 
@@ -98,9 +137,23 @@ namespace cb {
       int lastError() const;
       const char *lastErrorMsg() const;
 
+      /**
+       * Block until the shared-cache lock which caused the last SQLITE_LOCKED
+       * error is released.
+       *
+       * @return False if the error was not a shared-cache lock, waiting
+       *   would deadlock or unlock notification is not available.
+       */
+      bool waitForUnlock();
+
       static const char *errorMsg(int code);
 
       static std::string escape(const std::string &s);
+
+    protected:
+      void pragma(const std::string &name, const std::string &value);
+      void trimStatementCache();
+      void resetStatements();
     };
   }
 }
@@ -0,0 +1,240 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "DatabasePool.h"
+
+#include <cbang/Exception.h>
+#include <cbang/String.h>
+#include <cbang/config/Options.h>
+#include <cbang/os/SystemInfo.h>
+#include <cbang/time/Timer.h>
+#include <cbang/util/SmartLock.h>
+#include <cbang/util/HistogramSet.h>
+#include <cbang/log/Logger.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::DB;
+
+
+DatabasePool::DatabasePool(unsigned readers, double timeout) :
+  timeout(timeout), readerCount(readers), writer(timeout) {}
+
+
+DatabasePool::~DatabasePool() {
+  TRY_CATCH_ERROR(close());
+}
+
+
+void DatabasePool::addOptions(Options &options) {
+  writer.addOptions(options);
+
+  options.pushCategory("Database");
+  options.addTarget("db-readers", readerCount, "The number of read-only "
+                    "database connections.  Zero for one per CPU.");
+  options.popCategory();
+}
+
+
+void DatabasePool::setReaderCount(unsigned count) {
+  if (isOpen()) THROW("Cannot change reader count while open");
+  readerCount = count;
+}
+
+
+void DatabasePool::open(const string &filename) {
+  if (isOpen()) THROW("Database pool already open");
+
+  writer.setJournalMode("WAL");
+  writer.open(filename, Database::READ_WRITE | Database::CREATE |
+              Database::NO_MUTEX);
+
+  try {
+    string mode;
+    writer.execute("PRAGMA journal_mode", mode);
+    if (String::toLower(mode) != "wal")
+      THROW("Database '" << filename << "' cannot use WAL mode");
+
+    unsigned count = readerCount;
+    if (!count) count = SystemInfo::instance().getCPUCount();
+
+    for (unsigned i = 0; i < count; i++) {
+      SmartPointer<Database> db = new Database(timeout);
+
+      db->setMMapSize(writer.getMMapSize());
+      db->setCacheSize(writer.getCacheSize());
+      db->setStatementCacheSize(writer.getStatementCacheSize());
+      db->open(filename, Database::READ_ONLY | Database::NO_MUTEX);
+
+      readers.push_back(db);
+      idle.push_back(db.get());
+    }
+
+  } catch (...) {
+    idle.clear();
+    readers.clear();
+    writer.close();
+    throw;
+  }
+
+  LOG_INFO(3, "Opened '" << filename << "' with " << readers.size()
+           << " readers");
+}
+
+
+void DatabasePool::close() {
+  SmartLock lock(this);
+
+  if (readerUsers || writeDepth) THROW("Database connections still in use");
+
+  idle.clear();
+  readers.clear();
+  writer.close();
+  broadcast(); // Fail any waiting checkouts
+}
+
+
+DatabasePool::Stats DatabasePool::getReadStats() const {
+  SmartLock lock(this);
+  return readStats;
+}
+
+
+DatabasePool::Stats DatabasePool::getWriteStats() const {
+  SmartLock lock(this);
+  return writeStats;
+}
+
+
+Database &DatabasePool::acquireReader() {
+  SmartLock lock(this);
+
+  if (!isOpen()) THROW("Database pool not open");
+
+  auto id = this_thread::get_id();
+  auto it = readHolders.find(id);
+  if (it != readHolders.end()) {
+    it->second.depth++;
+    return *it->second.db;
+  }
+
+  double start = 0;
+
+  while (idle.empty()) {
+    if (!start) start = Timer::now();
+    double remaining = start + timeout - Timer::now();
+    if (remaining <= 0) THROW("Timed out waiting for a database reader");
+    timedWait(remaining);
+    if (!isOpen()) THROW("Database pool closed");
+  }
+
+  waited(readStats, "read", start);
+
+  Database *db = idle.back();
+  idle.pop_back();
+  readHolders[id] = Holder{db, 1};
+  readerUsers++;
+
+  return *db;
+}
+
+
+void DatabasePool::releaseReader() {
+  SmartLock lock(this);
+
+  auto it = readHolders.find(this_thread::get_id());
+  if (it == readHolders.end()) THROW("Database reader not held");
+  if (--it->second.depth) return;
+
+  idle.push_back(it->second.db);
+  readHolders.erase(it);
+  readerUsers--;
+  broadcast();
+}
+
+
+Database &DatabasePool::acquireWriter() {
+  SmartLock lock(this);
+
+  if (!isOpen()) THROW("Database pool not open");
+
+  auto id = this_thread::get_id();
+  if (writeDepth && writeOwner == id) {
+    writeDepth++;
+    return writer;
+  }
+
+  double start = 0;
+
+  while (writeDepth) {
+    if (!start) start = Timer::now();
+    double remaining = start + timeout - Timer::now();
+    if (remaining <= 0) THROW("Timed out waiting for the database writer");
+    timedWait(remaining);
+    if (!isOpen()) THROW("Database pool closed");
+  }
+
+  waited(writeStats, "write", start);
+
+  writeOwner = id;
+  writeDepth = 1;
+
+  return writer;
+}
+
+
+void DatabasePool::releaseWriter() {
+  SmartLock lock(this);
+
+  if (!writeDepth || writeOwner != this_thread::get_id())
+    THROW("Database writer not held");
+
+  if (--writeDepth) return;
+
+  writeOwner = thread::id();
+  broadcast();
+}
+
+
+void DatabasePool::waited(Stats &stats, const char *key, double start) {
+  double delta = start ? Timer::now() - start : 0;
+
+  stats.checkouts++;
+  if (start) {
+    stats.waits++;
+    stats.waitTime += delta;
+    if (stats.maxWait < delta) stats.maxWait = delta;
+  }
+
+  if (waitStats.isSet()) waitStats->record(key, delta * 1e6);
+}
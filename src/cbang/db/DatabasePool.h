@@ -0,0 +1,169 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "Database.h"
+
+#include <cbang/SmartPointer.h>
+#include <cbang/os/Condition.h>
+
+#include <vector>
+#include <map>
+#include <thread>
+
+
+namespace cb {
+  class Options;
+  class HistogramSet;
+
+  namespace DB {
+    /**
+     * A SQLite database in WAL mode shared by many threads.  Writes go
+     * through one read/write connection, a thread at a time, while reads
+     * use a set of read-only connections and so proceed in parallel with
+     * each other and with the writer.  Each connection has its own
+     * prepared Statement cache.
+     *
+     * A thread which already holds a connection of the same kind is given
+     * it again rather than waiting.  A Reader does not see changes made by
+     * an uncommitted Writer on the same thread.
+     */
+    class DatabasePool : protected Condition {
+    public:
+      struct Stats {
+        uint64_t checkouts = 0;
+        uint64_t waits = 0;   ///< Checkouts which had to wait
+        double waitTime = 0;  ///< Total seconds spent waiting
+        double maxWait = 0;
+      };
+
+    protected:
+      double timeout;
+      unsigned readerCount;
+      unsigned readerUsers = 0;
+
+      Database writer;
+      std::thread::id writeOwner;
+      unsigned writeDepth = 0;
+
+      std::vector<SmartPointer<Database> > readers;
+      std::vector<Database *> idle;
+      struct Holder {Database *db; unsigned depth;};
+      std::map<std::thread::id, Holder> readHolders;
+
+      Stats readStats;
+      Stats writeStats;
+      SmartPointer<HistogramSet> waitStats;
+
+    public:
+      /// Checks out a read-only connection for its lifetime
+      class Reader {
+        DatabasePool &pool;
+        Database &db;
+
+      public:
+        Reader(DatabasePool &pool) : pool(pool), db(pool.acquireReader()) {}
+        ~Reader() {pool.releaseReader();}
+
+        Reader(const Reader &) = delete;
+        Reader &operator=(const Reader &) = delete;
+
+        Database &operator*() const {return db;}
+        Database *operator->() const {return &db;}
+      };
+
+
+      /// Checks out the read/write connection for its lifetime
+      class Writer {
+        DatabasePool &pool;
+        Database &db;
+
+      public:
+        Writer(DatabasePool &pool) : pool(pool), db(pool.acquireWriter()) {}
+        ~Writer() {pool.releaseWriter();}
+
+        Writer(const Writer &) = delete;
+        Writer &operator=(const Writer &) = delete;
+
+        Database &operator*() const {return db;}
+        Database *operator->() const {return &db;}
+      };
+
+
+      /**
+       * @param readers The number of read-only connections, zero for one
+       *   per CPU.
+       * @param timeout Seconds to wait for a connection or for SQLite locks
+       *   before failing.
+       */
+      DatabasePool(unsigned readers = 0, double timeout = 30);
+      ~DatabasePool();
+
+      /// Adds the Database tuning options and "db-readers"
+      void addOptions(Options &options);
+
+      /**
+       * The writer's settings, see Database, are copied to the readers by
+       * open().  The journal mode is always WAL.
+       */
+      Database &getSettings() {return writer;}
+
+      unsigned getReaderCount() const {return readerCount;}
+      void setReaderCount(unsigned count);
+
+      bool isOpen() const {return writer.isOpen();}
+      /// Open the writer, creating the database if needed, then the readers
+      void open(const std::string &filename);
+      /// All connections must have been returned
+      void close();
+
+      Stats getReadStats() const;
+      Stats getWriteStats() const;
+
+      /// Record checkout waits in microseconds as "read" and "write"
+      void setWaitStats(const SmartPointer<HistogramSet> &stats)
+        {waitStats = stats;}
+      const SmartPointer<HistogramSet> &getWaitStats() const
+        {return waitStats;}
+
+    protected:
+      Database &acquireReader();
+      void releaseReader();
+      Database &acquireWriter();
+      void releaseWriter();
+
+      void waited(Stats &stats, const char *key, double start);
+    };
+  }
+}
@@ -37,13 +37,26 @@
 #include "LevelDB.h"
 
 #include <cbang/Exception.h>
+#include <cbang/config/Options.h>
+#include <cbang/os/Condition.h>
+#include <cbang/os/ThreadPool.h>
+#include <cbang/os/SystemUtilities.h>
+#include <cbang/String.h>
+#include <cbang/log/Logger.h>
+#include <cbang/util/SmartLock.h>
 
 #include <leveldb/db.h>
 #include <leveldb/slice.h>
+#include <leveldb/cache.h>
+#include <leveldb/filter_policy.h>
 #include <leveldb/comparator.h>
 #include <leveldb/iterator.h>
 #include <leveldb/write_batch.h>
 
+#include <atomic>
+#include <deque>
+#include <list>
+
 #undef CBANG_EXCEPTION
 #define CBANG_EXCEPTION LevelDBError
 
@@ -58,6 +71,71 @@ namespace {
     "\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff"
     "\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff"
     "\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff\xff";
+
+
+  // The first key greater than all keys starting with prefix or empty
+  string prefixEnd(const string &prefix) {
+    string end = prefix;
+
+    while (!end.empty()) {
+      unsigned char c = end.back();
+      if (c != 0xff) {end.back() = c + 1; break;}
+      end.pop_back();
+    }
+
+    return end;
+  }
+
+
+  uint64_t keyToInt(const string &key, unsigned offset) {
+    uint64_t x = 0;
+
+    for (unsigned i = 0; i < 8; i++)
+      x = (x << 8) | (offset + i < key.size() ? (uint8_t)key[offset + i] : 0);
+
+    return x;
+  }
+
+
+  string intToKey(uint64_t x) {
+    string key(8, 0);
+    for (int i = 7; 0 <= i; i--, x >>= 8) key[i] = (char)(x & 0xff);
+    return key;
+  }
+
+
+  // A key between begin and end, empty end is unbounded, or empty if none
+  string midKey(const string &begin, const string &end) {
+    unsigned offset = 0;
+    while (offset < begin.size() && offset < end.size() &&
+           begin[offset] == end[offset]) offset++;
+
+    uint64_t lo = keyToInt(begin, offset);
+    uint64_t hi = end.empty() ? ~(uint64_t)0 : keyToInt(end, offset);
+    if (hi - lo < 2) return string();
+
+    string mid = begin.substr(0, offset) + intToKey(lo + (hi - lo) / 2);
+
+    // Drop trailing zeros while still after begin
+    while (offset + 1 < mid.size() && mid.back() == 0 &&
+           begin < mid.substr(0, mid.size() - 1))
+      mid.pop_back();
+
+    return mid;
+  }
+
+
+  struct ParallelScanRange {
+    string begin;
+    string end;
+    string lo; // Search window for the next split point
+    string hi;
+    uint64_t size = 0;
+    bool splittable = true;
+
+    ParallelScanRange(const string &begin, const string &end) :
+      begin(begin), end(end), lo(begin), hi(end) {}
+  };
 }
 
 
@@ -85,8 +163,232 @@ void LevelDBNS::check(const leveldb::Status &s, const std::string &key) const {
 }
 
 
-int LevelDB::Comparator::operator()(const string &, const string &) const {
-  THROW("Must implement one of the compare functions");
+void LevelDB::Config::addOptions(Options &options) {
+  options.pushCategory("LevelDB");
+
+  options.addTarget("leveldb-block-cache", blockCacheSize, "Size in bytes of "
+                    "the LRU cache of uncompressed blocks.  Shared by all "
+                    "namespaces of a database.");
+  options.addTarget("leveldb-bloom-bits", bloomFilterBits, "Bits per key of "
+                    "the bloom filter used to skip tables on point lookups.  "
+                    "Zero disables the filter.");
+  options.addTarget("leveldb-write-buffer", writeBufferSize, "Bytes to "
+                    "buffer in memory before converting to a sorted on-disk "
+                    "file.  Zero for the default.");
+  options.addTarget("leveldb-max-open-files", maxOpenFiles, "The number of "
+                    "open files LevelDB may use.  Zero for the default.");
+  options.addTarget("leveldb-block-size", blockSize, "Approximate bytes of "
+                    "user data packed per block.  Zero for the default.");
+  options.addTarget("leveldb-fill-cache", fillCache, "Add blocks read by "
+                    "lookups and iterators to the block cache, unless "
+                    "NO_FILL_CACHE is passed.");
+
+  options.popCategory();
+}
+
+
+namespace {
+  class CountingCache : public leveldb::Cache {
+    leveldb::Cache *cache;
+
+  public:
+    uint64_t capacity;
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> misses;
+
+    CountingCache(uint64_t capacity) :
+      cache(leveldb::NewLRUCache(capacity)), capacity(capacity), hits(0),
+      misses(0) {}
+    ~CountingCache() {delete cache;}
+
+    // From leveldb::Cache
+    Handle *Insert(const leveldb::Slice &key, void *value, size_t charge,
+                   void (*deleter)(const leveldb::Slice &key, void *value)) {
+      return cache->Insert(key, value, charge, deleter);
+    }
+
+    Handle *Lookup(const leveldb::Slice &key) {
+      Handle *handle = cache->Lookup(key);
+      (handle ? hits : misses)++;
+      return handle;
+    }
+
+    void Release(Handle *handle) {cache->Release(handle);}
+    void *Value(Handle *handle) {return cache->Value(handle);}
+    void Erase(const leveldb::Slice &key) {cache->Erase(key);}
+    uint64_t NewId() {return cache->NewId();}
+    void Prune() {cache->Prune();}
+    size_t TotalCharge() const {return cache->TotalCharge();}
+  };
+}
+
+
+LevelDB::Cache::Cache(uint64_t capacity) :
+  cache(new CountingCache(capacity)) {}
+
+
+LevelDB::Cache::~Cache() {delete cache;}
+
+
+LevelDB::CacheStats LevelDB::Cache::getStats() const {
+  CountingCache &c = *static_cast<CountingCache *>(cache);
+  CacheStats stats;
+
+  stats.hits = c.hits;
+  stats.misses = c.misses;
+  stats.usage = c.TotalCharge();
+  stats.capacity = c.capacity;
+
+  return stats;
+}
+
+
+void LevelDB::Cache::resetStats() {
+  CountingCache &c = *static_cast<CountingCache *>(cache);
+  c.hits = c.misses = 0;
+}
+
+
+namespace {
+  string tupleName(const vector<SmartPointer<LevelDB::Comparator> > &parts,
+                   char separator) {
+    string name = "cb.Tuple" + String((int)separator) + "(";
+
+    for (unsigned i = 0; i < parts.size(); i++) {
+      if (parts[i].isNull()) THROW("Null tuple comparator");
+      if (i) name += ",";
+      name += parts[i]->getName();
+    }
+
+    return name + ")";
+  }
+
+
+  string nsName(const map<string, SmartPointer<LevelDB::Comparator> > &ns) {
+    string name = "cb.NS(";
+
+    for (auto it = ns.begin(); it != ns.end(); it++) {
+      if (it->second.isNull())
+        THROW("Null comparator for namespace '" << it->first << "'");
+      if (it != ns.begin()) name += ",";
+      name += it->first + "=" + it->second->getName();
+    }
+
+    return name + ")";
+  }
+}
+
+
+int LevelDB::BytewiseComparator::cmp(const char *key1, unsigned len1,
+                                     const char *key2, unsigned len2) {
+  int ret = memcmp(key1, key2, min(len1, len2));
+  if (ret) return ret;
+  return len1 < len2 ? -1 : (len2 < len1 ? 1 : 0);
+}
+
+
+LevelDB::BigEndianComparator::BigEndianComparator(bool isSigned) :
+  Comparator(isSigned ? "cb.SignedBigEndian" : "cb.BigEndian"),
+  isSigned(isSigned) {}
+
+
+int LevelDB::BigEndianComparator::compare(const char *key1, unsigned len1,
+                                          const char *key2,
+                                          unsigned len2) const {
+  bool neg1 = isSigned && len1 && (key1[0] & 0x80);
+  bool neg2 = isSigned && len2 && (key2[0] & 0x80);
+  if (neg1 != neg2) return neg1 ? -1 : 1;
+
+  // Drop sign extension, the longer remaining magnitude is further from zero
+  if (neg1) {
+    while (1 < len1 && (uint8_t)key1[0] == 0xff && (key1[1] & 0x80))
+      {key1++; len1--;}
+    while (1 < len2 && (uint8_t)key2[0] == 0xff && (key2[1] & 0x80))
+      {key2++; len2--;}
+
+    if (len1 != len2) return len1 < len2 ? 1 : -1;
+
+  } else {
+    while (len1 && !key1[0]) {key1++; len1--;}
+    while (len2 && !key2[0]) {key2++; len2--;}
+
+    if (len1 != len2) return len1 < len2 ? -1 : 1;
+  }
+
+  return memcmp(key1, key2, len1);
+}
+
+
+LevelDB::TupleComparator::TupleComparator
+(const vector<SmartPointer<Comparator> > &parts, char separator) :
+  Comparator(tupleName(parts, separator)), parts(parts),
+  separator(separator) {
+  if (parts.empty()) THROW("Tuple comparator needs at least one part");
+}
+
+
+int LevelDB::TupleComparator::compare(const char *key1, unsigned len1,
+                                      const char *key2, unsigned len2) const {
+  const char *end1 = key1 + len1;
+  const char *end2 = key2 + len2;
+
+  for (unsigned i = 0; ; i++) {
+    const char *sep1 = (const char *)memchr(key1, separator, end1 - key1);
+    const char *sep2 = (const char *)memchr(key2, separator, end2 - key2);
+    if (!sep1) sep1 = end1;
+    if (!sep2) sep2 = end2;
+
+    const Comparator &part = *parts[min<size_t>(i, parts.size() - 1)];
+    int ret = part.compare(key1, sep1 - key1, key2, sep2 - key2);
+    if (ret) return ret;
+
+    bool more1 = sep1 != end1;
+    bool more2 = sep2 != end2;
+    if (!more1 || !more2) return (int)more1 - (int)more2;
+
+    key1 = sep1 + 1;
+    key2 = sep2 + 1;
+  }
+}
+
+
+LevelDB::NSComparator::NSComparator
+(const map<string, SmartPointer<Comparator> > &namespaces) :
+  Comparator(nsName(namespaces)),
+  namespaces(namespaces.begin(), namespaces.end()) {
+
+  // In sorted order a namespace prefixing another would be adjacent to it
+  for (unsigned i = 0; i < this->namespaces.size(); i++) {
+    const string &name = this->namespaces[i].first;
+    if (name.empty()) THROW("Comparator namespace cannot be empty");
+
+    if (i && String::startsWith(name, this->namespaces[i - 1].first))
+      THROW("Comparator namespace '" << this->namespaces[i - 1].first
+             << "' is a prefix of '" << name << "'");
+  }
+}
+
+
+int LevelDB::NSComparator::compare(const char *key1, unsigned len1,
+                                   const char *key2, unsigned len2) const {
+  const entry_t *ns = find(key1, len1);
+
+  if (ns && ns == find(key2, len2)) {
+    unsigned n = ns->first.length();
+    return ns->second->compare(key1 + n, len1 - n, key2 + n, len2 - n);
+  }
+
+  return BytewiseComparator::cmp(key1, len1, key2, len2);
+}
+
+
+const LevelDB::NSComparator::entry_t *
+LevelDB::NSComparator::find(const char *key, unsigned len) const {
+  for (auto &e: namespaces)
+    if (e.first.length() <= len &&
+        !memcmp(key, e.first.data(), e.first.length())) return &e;
+
+  return 0;
 }
 
 
@@ -146,6 +448,13 @@ bool LevelDB::Iterator::operator==(const Iterator &it) const {
 }
 
 
+LevelDB::Snapshot::Snapshot(const SmartPointer<leveldb::DB> &db) :
+  db(db), snapshot(db->GetSnapshot()) {}
+
+
+LevelDB::Snapshot::~Snapshot() {db->ReleaseSnapshot(snapshot);}
+
+
 LevelDB::Batch::Batch(const SmartPointer<leveldb::DB> &db,
                       const SmartPointer<leveldb::WriteBatch> &batch,
                       const string &name) :
@@ -193,7 +502,7 @@ namespace {
       comparator(comparator) {}
 
     int Compare(const leveldb::Slice &a, const leveldb::Slice &b) const {
-      return (*comparator)(a.data(), a.size(), b.data(), b.size());
+      return comparator->compare(a.data(), a.size(), b.data(), b.size());
     }
 
     const char *Name() const {return comparator->getName().c_str();}
@@ -219,8 +528,18 @@ LevelDB::LevelDB(const string &name,
   LevelDBNS(name), comparator(comparator), db(db) {}
 
 
+LevelDB::~LevelDB() {}
+
+
+LevelDB::CacheStats LevelDB::getCacheStats() const {
+  return cache.isNull() ? CacheStats() : cache->getStats();
+}
+
+
 LevelDB LevelDB::ns(const string &name) {
-  return LevelDB(getNS() + name, comparator, db);
+  LevelDB db(*this);
+  static_cast<LevelDBNS &>(db) = LevelDBNS(getNS() + name);
+  return db;
 }
 
 
@@ -228,21 +547,38 @@ void LevelDB::open(const string &path, int options) {
   leveldb::Options opts = getOptions(options);
   if (!comparator.isNull()) opts.comparator = comparator.get();
 
+  if (cache.isNull() && config.blockCacheSize)
+    cache = new Cache(config.blockCacheSize);
+  if (!cache.isNull()) opts.block_cache = cache->getCache();
+
+  if (config.bloomFilterBits)
+    filter = leveldb::NewBloomFilterPolicy(config.bloomFilterBits);
+  if (!filter.isNull()) opts.filter_policy = filter.get();
+
+  if (config.writeBufferSize) opts.write_buffer_size = config.writeBufferSize;
+  if (config.maxOpenFiles) opts.max_open_files = config.maxOpenFiles;
+  if (config.blockSize) opts.block_size = config.blockSize;
+
   leveldb::DB *db;
   leveldb::Status status = leveldb::DB::Open(opts, path, &db);
   if (!status.ok())
     THROW("Failed to open DB '" << path << "': " << status.ToString());
 
   this->db = db;
+  this->path = path;
 }
 
 
-void LevelDB::close() {db.release();}
+void LevelDB::close() {
+  db.release();
+  path.clear();
+  filter.release();
+}
 
 
 bool LevelDB::has(const string &key, int options) const {
   string value;
-  leveldb::Status s = db->Get(getReadOptions(options), nsKey(key), &value);
+  leveldb::Status s = db->Get(readOptions(options), nsKey(key), &value);
   if (s.IsNotFound()) return false;
   check(s, key);
   return true;
@@ -251,7 +587,7 @@ bool LevelDB::has(const string &key, int options) const {
 
 string LevelDB::get(const string &key, int options) const {
   string value;
-  leveldb::Status s = db->Get(getReadOptions(options), nsKey(key), &value);
+  leveldb::Status s = db->Get(readOptions(options), nsKey(key), &value);
   check(s, key);
   return value;
 }
@@ -260,7 +596,7 @@ string LevelDB::get(const string &key, int options) const {
 string LevelDB::get(const string &key, const string &defaultValue,
                     int options) const {
   string value;
-  leveldb::Status s = db->Get(getReadOptions(options), nsKey(key), &value);
+  leveldb::Status s = db->Get(readOptions(options), nsKey(key), &value);
   if (s.IsNotFound()) return defaultValue;
   check(s, key);
   return value;
@@ -284,7 +620,15 @@ void LevelDB::eraseAll(int options) {
 
 
 LevelDB::Iterator LevelDB::iterator(int options) const {
-  return Iterator(db->NewIterator(getReadOptions(options)), getNS());
+  return Iterator(db->NewIterator(readOptions(options)), getNS());
+}
+
+
+LevelDB::Iterator LevelDB::iterator(const Snapshot &snapshot,
+                                    int options) const {
+  leveldb::ReadOptions opts = readOptions(options);
+  opts.snapshot = snapshot.get();
+  return Iterator(db->NewIterator(opts), getNS());
 }
 
 
@@ -307,6 +651,294 @@ LevelDB::Batch LevelDB::batch() {
 }
 
 
+SmartPointer<LevelDB::Snapshot> LevelDB::snapshot() const {
+  return new Snapshot(db);
+}
+
+
+vector<string> LevelDB::split(const string &begin, const string &end,
+                              unsigned shards) const {
+  vector<string> bounds = rawSplit(nsKey(begin), rawEnd(end), shards);
+
+  for (unsigned i = 0; i < bounds.size() - 1; i++)
+    bounds[i] = stripKey(bounds[i]);
+  bounds.back() = end;
+
+  return bounds;
+}
+
+
+vector<string> LevelDB::rawSplit(const string &first, const string &last,
+                                 unsigned shards) const {
+  vector<string> bounds;
+  bounds.push_back(first);
+
+  if (1 < shards && comparator.isNull() && (last.empty() || first < last)) {
+    // Repeatedly bisect the largest range in key space
+    list<ParallelScanRange> ranges;
+    ranges.push_back(ParallelScanRange(first, last));
+    ranges.back().size = approximateSize(first, last);
+    uint64_t total = ranges.back().size;
+
+    for (unsigned i = 0; i < shards * 64 && ranges.size() < shards * 8; i++) {
+      auto largest = ranges.end();
+      for (auto it = ranges.begin(); it != ranges.end(); it++)
+        if (it->splittable && it->size &&
+            (largest == ranges.end() || largest->size < it->size))
+          largest = it;
+
+      if (largest == ranges.end()) break;
+      ParallelScanRange &r = *largest;
+
+      string mid = midKey(r.lo, r.hi);
+      if (mid.empty()) {r.splittable = false; continue;}
+
+      uint64_t lower = approximateSize(r.lo, mid);
+      uint64_t upper = approximateSize(mid, r.hi);
+
+      // Narrow the search window past empty halves
+      if (!lower && !upper) r.splittable = false;
+      else if (!lower) r.lo = mid;
+      else if (!upper) r.hi = mid;
+      else {
+        ParallelScanRange upperRange(mid, r.end);
+        upperRange.lo = mid;
+        upperRange.hi = r.hi;
+        upperRange.size = upper;
+        r.end = r.hi = mid;
+        r.size = lower;
+        ranges.insert(next(largest), upperRange);
+      }
+    }
+
+    // Cut where the running size crosses each multiple of total / shards
+    uint64_t sum = 0;
+    for (auto it = ranges.begin(); it != ranges.end(); it++) {
+      sum += it->size;
+      if (bounds.size() < shards && total * bounds.size() <= sum * shards &&
+          next(it) != ranges.end())
+        bounds.push_back(it->end);
+    }
+  }
+
+  bounds.push_back(last);
+
+  return bounds;
+}
+
+
+uint64_t LevelDB::approximateSize(const string &begin,
+                                  const string &end) const {
+  string limit = end.empty() ? string(8, '\xff') : end;
+  leveldb::Range range(begin, limit);
+  uint64_t size = 0;
+  db->GetApproximateSizes(&range, 1, &size);
+  return size;
+}
+
+
+namespace {
+  class ParallelScan : public ThreadPool {
+  public:
+    typedef pair<string, string> entry_t;
+    typedef deque<entry_t> buffer_t;
+
+    struct Shard {
+      string begin;
+      string end;
+      buffer_t buffer;
+      bool done = false;
+    };
+
+    leveldb::DB &db;
+    leveldb::ReadOptions opts;
+    unsigned bufferSize;
+    vector<Shard> shards;
+
+    Condition condition;
+    atomic<unsigned> nextShard;
+    atomic<bool> stopped;
+    bool failed = false;
+    string error;
+
+
+    ParallelScan(leveldb::DB &db, const leveldb::ReadOptions &opts,
+                 const vector<string> &bounds, unsigned bufferSize) :
+      ThreadPool(bounds.size() - 1), db(db), opts(opts),
+      bufferSize(bufferSize ? bufferSize : 1), shards(bounds.size() - 1),
+      nextShard(0), stopped(false) {
+
+      for (unsigned i = 0; i < shards.size(); i++) {
+        shards[i].begin = bounds[i];
+        shards[i].end = bounds[i + 1];
+      }
+    }
+
+
+    void halt() {
+      stopped = true;
+      SmartLock lock(&condition);
+      condition.broadcast();
+    }
+
+
+    // Called by the consumer with the lock held
+    bool next(buffer_t &batch) {
+      while (true) {
+        if (failed) THROW(error);
+
+        bool done = true;
+        for (unsigned i = 0; i < shards.size(); i++) {
+          Shard &shard = shards[i];
+
+          if (!shard.buffer.empty()) {
+            batch.swap(shard.buffer);
+            condition.broadcast();
+            return true;
+          }
+
+          if (!shard.done) done = false;
+        }
+
+        if (done) return false;
+        condition.wait();
+      }
+    }
+
+
+    void push(Shard &shard, buffer_t &chunk) {
+      SmartLock lock(&condition);
+
+      while (bufferSize <= shard.buffer.size() && !stopped)
+        condition.wait();
+
+      bool wasEmpty = shard.buffer.empty();
+      for (auto &entry: chunk) shard.buffer.push_back(move(entry));
+      chunk.clear();
+
+      if (wasEmpty) condition.broadcast();
+    }
+
+
+    void scan(Shard &shard) {
+      SmartPointer<leveldb::Iterator> it = db.NewIterator(opts);
+      buffer_t chunk;
+
+      for (it->Seek(shard.begin); it->Valid() && !stopped; it->Next()) {
+        leveldb::Slice key = it->key();
+        if (!shard.end.empty() && shard.end.compare(0, string::npos,
+                                                    key.data(),
+                                                    key.size()) <= 0) break;
+
+        chunk.push_back(entry_t(key.ToString(), it->value().ToString()));
+        if (chunk.size() == 64) push(shard, chunk);
+      }
+
+      if (!chunk.empty() && !stopped) push(shard, chunk);
+      if (!it->status().ok()) THROW("DB ERROR: " << it->status().ToString());
+    }
+
+
+    // From ThreadPool
+    void run() {
+      while (!stopped && !Thread::current().shouldShutdown()) {
+        unsigned i = nextShard++;
+        if (shards.size() <= i) break;
+
+        try {
+          scan(shards[i]);
+
+        } catch (const Exception &e) {
+          SmartLock lock(&condition);
+          failed = true;
+          error = e.getMessage();
+
+        } catch (const std::exception &e) {
+          SmartLock lock(&condition);
+          failed = true;
+          error = e.what();
+        }
+
+        SmartLock lock(&condition);
+        shards[i].done = true;
+        condition.broadcast();
+      }
+    }
+  };
+}
+
+
+void LevelDB::parallelForeach(const string &begin, const string &end,
+                              unsigned shards, scan_cb_t cb,
+                              unsigned bufferSize, int options) const {
+  if (!(options & FILL_CACHE)) options |= NO_FILL_CACHE;
+
+  SmartPointer<Snapshot> snapshot = this->snapshot();
+  leveldb::ReadOptions opts = readOptions(options);
+  opts.snapshot = snapshot->get();
+
+  vector<string> bounds = rawSplit(nsKey(begin), rawEnd(end), shards);
+  ParallelScan scan(*db, opts, bounds, bufferSize);
+  scan.start();
+
+  try {
+    ParallelScan::buffer_t batch;
+
+    while (true) {
+      {
+        SmartLock lock(&scan.condition);
+        if (!scan.next(batch)) break;
+      }
+
+      for (unsigned i = 0; i < batch.size(); i++)
+        if (!cb(stripKey(batch[i].first), batch[i].second)) {
+          scan.halt();
+          break;
+        }
+
+      if (scan.stopped) break;
+      batch.clear();
+    }
+
+  } catch (...) {
+    scan.halt();
+    scan.join();
+    throw;
+  }
+
+  scan.halt();
+  scan.join();
+}
+
+
+void LevelDB::checkpoint(const string &dir, unsigned retries) const {
+  if (db.isNull()) THROW("LevelDB not open");
+  if (SystemUtilities::exists(dir))
+    THROW("Checkpoint directory '" << dir << "' already exists");
+
+  for (unsigned i = 0; true; i++) {
+    SystemUtilities::mkdir(dir);
+
+    try {
+      if (checkpointFiles(dir)) return;
+      if (retries <= i) THROW("LevelDB changed during checkpoint");
+
+    } catch (const Exception &e) {
+      if (retries <= i) {
+        SystemUtilities::rmtree(dir);
+        SystemUtilities::rmdir(dir);
+        throw;
+      }
+
+      LOG_DEBUG(3, "Retrying LevelDB checkpoint: " << e.getMessage());
+    }
+
+    SystemUtilities::rmtree(dir);
+    SystemUtilities::rmdir(dir);
+  }
+}
+
+
 string LevelDB::getProperty(const string &name) {
   string value;
   if (!db->GetProperty(name, &value))
@@ -325,6 +957,48 @@ void LevelDB::compact(const string &begin, const string &end) {
 }
 
 
+bool LevelDB::checkpointFiles(const string &dir) const {
+  // The manifest lists the live files.  Files only become obsolete, and
+  // are deleted, after a new version is appended to it.  If it is
+  // unchanged at the end then every file it lists was copied.
+  string current = SystemUtilities::read(path + "/CURRENT");
+  string manifest = String::trim(current);
+  uint64_t size = SystemUtilities::getFileSize(path + "/" + manifest);
+
+  SystemUtilities::cp(path + "/" + manifest, dir + "/" + manifest, size);
+
+  vector<string> files;
+  SystemUtilities::listDirectory(files, path, ".*\\.(ldb|sst|log)");
+
+  for (unsigned i = 0; i < files.size(); i++) {
+    string name = SystemUtilities::basename(files[i]);
+    string target = dir + "/" + name;
+
+    // Logs are still being appended, copy what has been written so far
+    if (String::endsWith(name, ".log"))
+      SystemUtilities::cp(files[i], target);
+
+    else
+      try {
+        SystemUtilities::link(files[i], target);
+      } catch (const Exception &e) {
+        // Already deleted or on another filesystem
+        if (!SystemUtilities::exists(files[i])) throw;
+        SystemUtilities::cp(files[i], target);
+      }
+  }
+
+  if (SystemUtilities::read(path + "/CURRENT") != current ||
+      SystemUtilities::getFileSize(path + "/" + manifest) != size)
+    return false;
+
+  // Written last, the checkpoint is not valid without it
+  *SystemUtilities::oopen(dir + "/CURRENT") << current;
+
+  return true;
+}
+
+
 leveldb::Options LevelDB::getOptions(int options) {
   // TODO Support other options
 
@@ -343,12 +1017,23 @@ leveldb::ReadOptions LevelDB::getReadOptions(int options) {
   leveldb::ReadOptions opts;
 
   opts.verify_checksums = options & VERIFY_CHECKSUMS;
-  opts.fill_cache = options & FILL_CACHE;
+  opts.fill_cache = (options & FILL_CACHE) && !(options & NO_FILL_CACHE);
 
   return opts;
 }
 
 
+leveldb::ReadOptions LevelDB::readOptions(int options) const {
+  if (config.fillCache) options |= FILL_CACHE;
+  return getReadOptions(options);
+}
+
+
+string LevelDB::rawEnd(const string &end) const {
+  return end.empty() ? prefixEnd(getNS()) : nsKey(end);
+}
+
+
 leveldb::WriteOptions LevelDB::getWriteOptions(int options) {
   leveldb::WriteOptions opts;
 
@@ -37,11 +37,18 @@
 #ifdef HAVE_LEVELDB
 
 #include <cbang/SmartPointer.h>
+#include <cbang/StdTypes.h>
 
 #include <string>
+#include <vector>
+#include <map>
+#include <functional>
 
 namespace leveldb {
   class DB;
+  class Cache;
+  class Snapshot;
+  class FilterPolicy;
   class Comparator;
   class Iterator;
   class WriteBatch;
@@ -53,6 +60,8 @@ namespace leveldb {
 
 
 namespace cb {
+  class Options;
+
   CBANG_DEFINE_EXCEPTION_SUBCLASS(LevelDBError);
 
   class LevelDBNS {
@@ -73,8 +82,15 @@ namespace cb {
 
 
   class LevelDB : public LevelDBNS {
+  public:
+    class Cache;
+
+  private:
     SmartPointer<leveldb::Comparator> comparator; // Deallocate after db
+    SmartPointer<Cache> cache; // Deallocate after db
+    SmartPointer<const leveldb::FilterPolicy> filter; // Deallocate after db
     SmartPointer<leveldb::DB> db;
+    std::string path;
 
   public:
     typedef enum {
@@ -85,9 +101,54 @@ namespace cb {
       VERIFY_CHECKSUMS  = 1 << 4,
       FILL_CACHE        = 1 << 5,
       SYNC              = 1 << 6,
+      NO_FILL_CACHE     = 1 << 7,
     } options_t;
 
 
+    /// Tuning applied by open().  Zero sizes leave LevelDB's default.
+    struct Config {
+      uint64_t blockCacheSize = 8 * 1024 * 1024;
+      unsigned bloomFilterBits = 10;
+      uint64_t writeBufferSize = 0;
+      uint32_t maxOpenFiles = 0;
+      uint32_t blockSize = 0;
+      bool fillCache = true;
+
+      void addOptions(Options &options);
+    };
+
+
+    struct CacheStats {
+      uint64_t hits = 0;
+      uint64_t misses = 0;
+      uint64_t usage = 0;
+      uint64_t capacity = 0;
+
+      double getHitRate() const
+      {return hits + misses ? (double)hits / (hits + misses) : 0;}
+    };
+
+
+    /// An LRU block cache which may be shared between databases
+    class Cache {
+      leveldb::Cache *cache;
+
+    public:
+      Cache(uint64_t capacity);
+      ~Cache();
+
+      leveldb::Cache *getCache() const {return cache;}
+      CacheStats getStats() const;
+      void resetStats();
+    };
+
+
+    /**
+     * Orders the keys of a database.  LevelDB calls compare() on its raw
+     * key slices in every memtable and compaction loop so implementations
+     * should not allocate.  The name is stored in the database and must
+     * not change once it has been created.
+     */
     class Comparator {
       std::string name;
 
@@ -97,12 +158,89 @@ namespace cb {
 
       const std::string &getName() const {return name;}
 
-      virtual int operator()(const std::string &key1,
-                             const std::string &key2) const;
-      virtual int operator()(const char *key1, unsigned len1,
-                             const char *key2, unsigned len2) const {
-        return (*this)(std::string(key1, len1), std::string(key2, len2));
-      }
+      /// @return Less than, equal to or greater than zero as key1 < key2
+      virtual int compare(const char *key1, unsigned len1,
+                          const char *key2, unsigned len2) const = 0;
+
+      int operator()(const char *key1, unsigned len1,
+                     const char *key2, unsigned len2) const
+      {return compare(key1, len1, key2, len2);}
+      int operator()(const std::string &key1, const std::string &key2) const
+      {return compare(key1.data(), key1.size(), key2.data(), key2.size());}
+    };
+
+
+    /// LevelDB's default order, shorter keys first on a common prefix
+    class BytewiseComparator : public Comparator {
+    public:
+      BytewiseComparator() : Comparator("cb.Bytewise") {}
+
+      static int cmp(const char *key1, unsigned len1,
+                     const char *key2, unsigned len2);
+
+      // From Comparator
+      int compare(const char *key1, unsigned len1,
+                  const char *key2, unsigned len2) const
+      {return cmp(key1, len1, key2, len2);}
+    };
+
+
+    /**
+     * Keys are big-endian integers of any length, e.g. from hton64().
+     * Signed keys are two's complement.  Leading zero, or for negative
+     * numbers 0xff, bytes do not change the value.
+     */
+    class BigEndianComparator : public Comparator {
+      bool isSigned;
+
+    public:
+      BigEndianComparator(bool isSigned = false);
+
+      // From Comparator
+      int compare(const char *key1, unsigned len1,
+                  const char *key2, unsigned len2) const;
+    };
+
+
+    /**
+     * Keys are tuples of components joined by @param separator, which the
+     * components must not contain.  Component i is ordered by
+     * @param parts[i], or by the last of @param parts if there are fewer.
+     * A tuple sorts before any longer tuple it is a prefix of.
+     */
+    class TupleComparator : public Comparator {
+      std::vector<SmartPointer<Comparator> > parts;
+      char separator;
+
+    public:
+      TupleComparator(const std::vector<SmartPointer<Comparator> > &parts,
+                      char separator = 0);
+
+      // From Comparator
+      int compare(const char *key1, unsigned len1,
+                  const char *key2, unsigned len2) const;
+    };
+
+
+    /**
+     * Select a comparator for each namespace, see ns().  Keys in the same
+     * namespace are ordered by its comparator, all other keys bytewise.
+     * No namespace may be a prefix of another.
+     */
+    class NSComparator : public Comparator {
+      typedef std::pair<std::string, SmartPointer<Comparator> > entry_t;
+      std::vector<entry_t> namespaces;
+
+    public:
+      NSComparator(const std::map<std::string,
+                   SmartPointer<Comparator> > &namespaces);
+
+      // From Comparator
+      int compare(const char *key1, unsigned len1,
+                  const char *key2, unsigned len2) const;
+
+    protected:
+      const entry_t *find(const char *key, unsigned len) const;
     };
 
 
@@ -132,6 +270,19 @@ namespace cb {
     };
 
 
+    /// A consistent read-only view of the database at creation time
+    class Snapshot {
+      SmartPointer<leveldb::DB> db;
+      const leveldb::Snapshot *snapshot;
+
+    public:
+      Snapshot(const SmartPointer<leveldb::DB> &db);
+      ~Snapshot();
+
+      const leveldb::Snapshot *get() const {return snapshot;}
+    };
+
+
     class Batch : public LevelDBNS {
       SmartPointer<leveldb::DB> db;
       SmartPointer<leveldb::WriteBatch> batch; // Deallocate before db
@@ -142,6 +293,8 @@ namespace cb {
             const std::string &name);
       ~Batch();
 
+      leveldb::WriteBatch &getWriteBatch() const {return *batch;}
+
       Batch ns(const std::string &name);
 
       void clear();
@@ -152,18 +305,36 @@ namespace cb {
     };
 
 
+  private:
+    Config config;
+
+  public:
     LevelDB(const SmartPointer<Comparator> &comparator = 0);
     LevelDB(const std::string &name,
             const SmartPointer<Comparator> &comparator = 0);
     LevelDB(const std::string &name,
             const SmartPointer<leveldb::Comparator> &comparator,
             const SmartPointer<leveldb::DB> &db);
+    ~LevelDB();
 
     leveldb::DB &getDB() {return *db;}
     const SmartPointer<leveldb::Comparator> &getComparator() const {
       return comparator;
     }
 
+    const Config &getConfig() const {return config;}
+    void setConfig(const Config &config) {this->config = config;}
+    void addOptions(Options &options) {config.addOptions(options);}
+
+    const SmartPointer<Cache> &getCache() const {return cache;}
+    /**
+     * Use @param cache as the block cache instead of allocating one in
+     * open().  Must be called before open().
+     */
+    void setCache(const SmartPointer<Cache> &cache) {this->cache = cache;}
+    CacheStats getCacheStats() const;
+
+    /// Namespaces share the parent's database, config and block cache
     LevelDB ns(const std::string &name);
 
     void open(const std::string &path, int options = 0);
@@ -178,10 +349,50 @@ namespace cb {
     void eraseAll(int options = 0);
 
     Iterator iterator(int options = 0) const;
+    Iterator iterator(const Snapshot &snapshot, int options = 0) const;
     Iterator first(int options = 0) const;
     Iterator last(int options = 0) const;
     Batch batch();
 
+    SmartPointer<Snapshot> snapshot() const;
+
+    /**
+     * Split the keys in [@param begin, @param end) into at most
+     * @param shards ranges of roughly equal on-disk size, as estimated by
+     * LevelDB's GetApproximateSizes().  An empty @param end means the end
+     * of the namespace.  Returns the shard boundaries, begin first and end
+     * last.  Databases with a custom comparator are not split.
+     */
+    std::vector<std::string> split(const std::string &begin,
+                                   const std::string &end,
+                                   unsigned shards) const;
+
+    typedef std::function<bool (const std::string &key,
+                                const std::string &value)> scan_cb_t;
+
+    /**
+     * Scan [@param begin, @param end) as of a single snapshot.  The range is
+     * split with split() and each shard is read by its own thread into a
+     * buffer of at most @param bufferSize entries.  @param cb is called
+     * from the calling thread, in key order within a shard but with shards
+     * interleaved.  Scanning stops early if @param cb returns false.
+     * Scanned blocks are not added to the block cache unless FILL_CACHE is
+     * passed in @param options.
+     */
+    void parallelForeach(const std::string &begin, const std::string &end,
+                         unsigned shards, scan_cb_t cb,
+                         unsigned bufferSize = 4096, int options = 0) const;
+
+    /**
+     * Write a consistent copy of the open database to the new directory
+     * @param dir.  The immutable table files are hard linked, or copied if
+     * @param dir is on another filesystem.  The manifest and write-ahead
+     * logs are copied.  Writes may continue meanwhile.  If a compaction
+     * changes the set of files during the copy it is retried up to
+     * @param retries times.
+     */
+    void checkpoint(const std::string &dir, unsigned retries = 10) const;
+
     std::string getProperty(const std::string &name);
     void compact(const std::string &begin = std::string(),
                  const std::string &end = std::string());
@@ -189,6 +400,16 @@ namespace cb {
     static leveldb::Options getOptions(int options);
     static leveldb::ReadOptions getReadOptions(int options);
     static leveldb::WriteOptions getWriteOptions(int options);
+
+  protected:
+    leveldb::ReadOptions readOptions(int options) const;
+    std::string rawEnd(const std::string &end) const;
+    std::vector<std::string> rawSplit(const std::string &first,
+                                      const std::string &last,
+                                      unsigned shards) const;
+    uint64_t approximateSize(const std::string &begin,
+                             const std::string &end) const;
+    bool checkpointFiles(const std::string &dir) const;
   };
 }
 
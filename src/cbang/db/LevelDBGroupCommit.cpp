@@ -0,0 +1,139 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include <cbang/config.h>
+
+#ifdef HAVE_LEVELDB
+
+#include "LevelDBGroupCommit.h"
+
+#include <cbang/Exception.h>
+#include <cbang/time/Timer.h>
+#include <cbang/util/SmartLock.h>
+
+#include <leveldb/db.h>
+#include <leveldb/write_batch.h>
+
+#undef CBANG_EXCEPTION
+#define CBANG_EXCEPTION LevelDBError
+
+using namespace cb;
+using namespace std;
+
+
+struct LevelDBGroupCommit::Group {
+  leveldb::WriteBatch batch;
+  unsigned count = 0;
+  bool done = false;
+  string error;
+};
+
+
+LevelDBGroupCommit::LevelDBGroupCommit(const LevelDB &db, double window,
+                                       unsigned maxWrites) :
+  db(db), window(window), maxWrites(maxWrites) {}
+
+
+LevelDBGroupCommit::~LevelDBGroupCommit() {}
+
+
+uint64_t LevelDBGroupCommit::getWrites() const {
+  SmartLock lock(&condition);
+  return writes;
+}
+
+
+uint64_t LevelDBGroupCommit::getGroups() const {
+  SmartLock lock(&condition);
+  return groups;
+}
+
+
+void LevelDBGroupCommit::set(const string &key, const string &value) {
+  LevelDB::Batch batch = db.batch();
+  batch.set(key, value);
+  commit(batch);
+}
+
+
+void LevelDBGroupCommit::erase(const string &key) {
+  LevelDB::Batch batch = db.batch();
+  batch.erase(key);
+  commit(batch);
+}
+
+
+void LevelDBGroupCommit::commit(const LevelDB::Batch &batch) {
+  SmartLock lock(&condition);
+
+  bool leader = group.isNull();
+  if (leader) group = new Group;
+
+  SmartPointer<Group> group = this->group;
+  group->batch.Append(batch.getWriteBatch());
+  group->count++;
+  writes++;
+
+  if (leader) {
+    // Wait for others to join the group
+    double deadline = Timer::now() + window;
+
+    while (group->count < maxWrites) {
+      double remaining = deadline - Timer::now();
+      if (remaining <= 0) break;
+      condition.timedWait(remaining);
+    }
+
+    // Close the group, later commits start a new one
+    this->group.release();
+    groups++;
+
+    condition.unlock();
+
+    leveldb::WriteOptions opts = LevelDB::getWriteOptions(LevelDB::SYNC);
+    leveldb::Status s = db.getDB().Write(opts, &group->batch);
+
+    condition.lock();
+
+    if (!s.ok()) group->error = s.ToString();
+    group->done = true;
+    condition.broadcast();
+
+  } else {
+    if (group->count == maxWrites) condition.broadcast();
+    while (!group->done) condition.wait();
+  }
+
+  if (!group->error.empty()) THROW("DB ERROR: " << group->error);
+}
+
+#endif // HAVE_LEVELDB
@@ -0,0 +1,85 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/config.h>
+
+#ifdef HAVE_LEVELDB
+
+#include "LevelDB.h"
+
+#include <cbang/os/Condition.h>
+
+
+namespace cb {
+  /**
+   * Merges Batch commits from concurrent threads into a single synced
+   * LevelDB write.  The first thread to commit into an empty group waits up
+   * to the configured window for others to join, then writes the group
+   * with SYNC.  Every caller returns once the shared write is durable.
+   */
+  class LevelDBGroupCommit {
+    struct Group;
+
+    LevelDB db;
+    double window;
+    unsigned maxWrites;
+
+    Condition condition;
+    SmartPointer<Group> group;
+
+    uint64_t writes = 0;
+    uint64_t groups = 0;
+
+  public:
+    LevelDBGroupCommit(const LevelDB &db, double window = 0.002,
+                       unsigned maxWrites = 1024);
+    ~LevelDBGroupCommit();
+
+    double getWindow() const {return window;}
+    void setWindow(double window) {this->window = window;}
+
+    unsigned getMaxWrites() const {return maxWrites;}
+    void setMaxWrites(unsigned maxWrites) {this->maxWrites = maxWrites;}
+
+    /// Total batches committed and synced writes used to commit them
+    uint64_t getWrites() const;
+    uint64_t getGroups() const;
+
+    void set(const std::string &key, const std::string &value);
+    void erase(const std::string &key);
+    void commit(const LevelDB::Batch &batch);
+  };
+}
+
+#endif // HAVE_LEVELDB
@@ -109,6 +109,22 @@ void NameValueTable::set(const string &name) {
 }
 
 
+void NameValueTable::set(const vector<string> &names,
+                         const vector<string> &values,
+                         unsigned commitInterval) {
+  SmartPointer<BatchWriter> writer = batch(commitInterval);
+  writer->insertColumns(names, values);
+  writer->commit();
+}
+
+
+SmartPointer<BatchWriter> NameValueTable::batch(unsigned commitInterval) {
+  string sql = String::printf("REPLACE INTO \"%s\" (name, value) "
+                              "VALUES (?, ?)", table.c_str());
+  return new BatchWriter(db, sql, commitInterval);
+}
+
+
 void NameValueTable::unset(const string &name) {
   deleteStmt->parameter(0).bind(name);
   deleteStmt->execute();
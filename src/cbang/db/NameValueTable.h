@@ -34,11 +34,13 @@
 
 #include "Column.h"
 #include "Statement.h"
+#include "BatchWriter.h"
 
 #include <cbang/StdTypes.h>
 #include <cbang/SmartPointer.h>
 
 #include <string>
+#include <vector>
 #include <functional>
 
 
@@ -86,6 +88,13 @@ namespace cb {
       void set(const std::string &name, bool value);
       void set(const std::string &name);
 
+      /// Write all of the values with one Statement in batched Transactions
+      void set(const std::vector<std::string> &names,
+               const std::vector<std::string> &values,
+               unsigned commitInterval = 10000);
+      /// A BatchWriter which takes (name, value) rows
+      SmartPointer<BatchWriter> batch(unsigned commitInterval = 10000);
+
       void unset(const std::string &name);
 
       template <typename T>
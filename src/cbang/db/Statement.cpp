@@ -48,11 +48,17 @@ using namespace cb::DB;
 
 
 Statement::Statement(Database &db, const string &sql) :
-  stmt(0), done(false), validRow(false) {
+  db(db), stmt(0), done(false), validRow(false) {
 
   LOG_DEBUG(5, "SQL: " << sql);
 
-  if (sqlite3_prepare_v2(db.getDB(), sql.c_str(), sql.length(), &stmt, 0))
+  int ret;
+  while ((ret = sqlite3_prepare_v2(db.getDB(), sql.c_str(), sql.length(),
+                                   &stmt, 0)) == SQLITE_LOCKED &&
+         db.waitForUnlock())
+    continue;
+
+  if (ret)
     THROW("Failed to prepare statement: " << sql << ": "
            << sqlite3_errmsg(db.getDB()));
 }
@@ -66,9 +72,21 @@ Statement::~Statement() {
 }
 
 
+bool Statement::isActive() const {
+  return sqlite3_stmt_busy(stmt);
+}
+
+
 bool Statement::next() {
   if (done) return false;
   int code = sqlite3_step(stmt);
+
+  // Only restart if no rows have been returned yet
+  while (code == SQLITE_LOCKED && !validRow && db.waitForUnlock()) {
+    sqlite3_reset(stmt);
+    code = sqlite3_step(stmt);
+  }
+
   validRow = false;
 
   switch (code) {
@@ -89,6 +107,7 @@ bool Statement::next() {
 void Statement::reset() {
   sqlite3_reset(stmt); // Ignore errors
   done = false;
+  validRow = false;
 }
 
 
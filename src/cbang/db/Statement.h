@@ -47,6 +47,7 @@ namespace cb {
     class Database;
 
     class Statement {
+      Database &db;
       sqlite3_stmt *stmt;
       bool done;
       bool validRow;
@@ -56,6 +57,8 @@ namespace cb {
       ~Statement();
 
       bool isDone() const {return done;}
+      /// True if stepped but not yet run to completion or reset
+      bool isActive() const;
       bool next();
       void reset();
       void clearBindings();
@@ -0,0 +1,74 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "EventDB.h"
+
+#include <cbang/event/Coroutine.h>
+#include <cbang/json/Builder.h>
+
+
+namespace cb {
+  namespace MariaDB {
+    /**
+     * Run @param sql and resolve to a list with one entry per result set,
+     * each a list of row dicts.  See EventDB::stream().
+     */
+    inline Event::Future<JSON::ValuePtr>
+    query(EventDB &db, const std::string &sql,
+          const SmartPointer<const JSON::Value> &dict = 0) {
+      Event::Future<JSON::ValuePtr> f;
+      SmartPointer<JSON::Builder> builder = new JSON::Builder;
+      builder->beginList();
+
+      auto cb = [f, builder, &db] (EventDB::state_t state) mutable {
+        switch (state) {
+        case EventDB::EVENTDB_ERROR:
+          f.fail(Exception("DB: " + db.getError()));
+          break;
+
+        case EventDB::EVENTDB_DONE:
+          builder->endList();
+          f.set(builder->getRoot());
+          break;
+
+        default: break;
+        }
+      };
+
+      db.stream(cb, builder, sql, dict);
+
+      return f;
+    }
+  }
+}
@@ -227,6 +227,7 @@ void DB::close() {
     db = mysql_init(0);
   }
   connected = false;
+  clearStatements();
 }
 
 
@@ -245,6 +246,7 @@ bool DB::closeNB() {
 
   db = mysql_init(0);
   connected = false;
+  clearStatements();
   return true;
 }
 
@@ -364,6 +366,24 @@ bool DB::storeResultNB() {
 }
 
 
+bool DB::useResultNB() {
+  LOG_DEBUG(5, __func__ << "()");
+
+  assertConnected();
+  assertNotPending();
+  assertNonBlocking();
+  assertNotHaveResult();
+
+  // mysql_use_result() does not block, rows are read by fetchRowNB()
+  res = mysql_use_result(db);
+
+  if (res) stored = false;
+  else if (hasError()) RAISE_DB_ERROR("Failed to use result");
+
+  return true;
+}
+
+
 bool DB::haveResult() const {return res;}
 
 
@@ -762,6 +782,42 @@ void DB::assertInFieldRange(unsigned i) const {
 }
 
 
+SmartPointer<Statement> DB::getStatement(const string &sql) {
+  if (!maxStatements) return new Statement(*this, sql);
+
+  auto it = statements.find(sql);
+
+  if (it != statements.end()) {
+    SmartPointer<Statement> &stmt = it->second->second;
+
+    // Still in use elsewhere
+    if (stmt.getRefCount() != 1) return new Statement(*this, sql);
+
+    statementLRU.splice(statementLRU.begin(), statementLRU, it->second);
+    stmt->clearBindings();
+
+    return stmt;
+  }
+
+  SmartPointer<Statement> stmt = new Statement(*this, sql);
+  statementLRU.push_front(statement_entry_t(sql, stmt));
+  statements[sql] = statementLRU.begin();
+
+  while (maxStatements < statementLRU.size()) {
+    statements.erase(statementLRU.back().first);
+    statementLRU.pop_back();
+  }
+
+  return stmt;
+}
+
+
+void DB::clearStatements() {
+  statements.clear();
+  statementLRU.clear();
+}
+
+
 bool DB::continueNB(unsigned ready) {
   LOG_DEBUG(5, __func__ << "()");
 
@@ -835,6 +891,19 @@ void DB::threadEnd() {mysql_thread_end();}
 bool DB::threadSafe() {return mysql_thread_safe();}
 
 
+void DB::continueStatement(Statement *stmt, statement_continue_t func) {
+  pendingStatement = stmt;
+  statementContinueFunc = func;
+  continueFunc = &DB::statementContinue;
+}
+
+
+bool DB::statementContinue(unsigned ready) {
+  LOG_DEBUG(5, __func__ << "()");
+  return (pendingStatement->*statementContinueFunc)(ready);
+}
+
+
 bool DB::closeContinue(unsigned ready) {
   LOG_DEBUG(5, __func__ << "()");
 
@@ -843,6 +912,7 @@ bool DB::closeContinue(unsigned ready) {
 
   db = mysql_init(0);
   connected = false;
+  clearStatements();
   return true;
 }
 
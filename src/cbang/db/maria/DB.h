@@ -33,6 +33,7 @@
 #pragma once
 
 #include "Field.h"
+#include "Statement.h"
 
 #include <cbang/SmartPointer.h>
 #include <cbang/StdTypes.h>
@@ -40,6 +41,8 @@
 #include <string>
 #include <vector>
 #include <set>
+#include <list>
+#include <map>
 
 struct st_mysql;
 struct st_mysql_res;
@@ -104,6 +107,17 @@ namespace cb {
       int status;
       continue_func_t continueFunc;
 
+      typedef bool (Statement::*statement_continue_t)(unsigned ready);
+      Statement *pendingStatement = 0;
+      statement_continue_t statementContinueFunc = 0;
+
+      unsigned maxStatements = 64;
+      typedef std::pair<std::string, SmartPointer<Statement> >
+      statement_entry_t;
+      typedef std::list<statement_entry_t> statement_lru_t;
+      statement_lru_t statementLRU;
+      std::map<std::string, statement_lru_t::iterator> statements;
+
     public:
       DB(st_mysql *db = 0);
       ~DB();
@@ -157,6 +171,7 @@ namespace cb {
       void useResult();
       void storeResult();
       bool storeResultNB();
+      bool useResultNB();
       bool haveResult() const;
       bool nextResult();
       bool nextResultNB();
@@ -231,6 +246,18 @@ namespace cb {
       void assertNotHaveResult() const;
       void assertInFieldRange(unsigned i) const;
 
+      // Prepared statements
+      /**
+       * Get a prepared Statement for @param sql from a per-connection LRU
+       * cache, or a new one which is not yet prepared.  A cached Statement
+       * is only returned if it is not referenced elsewhere.  The cache is
+       * cleared when the connection closes.
+       */
+      SmartPointer<Statement> getStatement(const std::string &sql);
+      unsigned getMaxStatements() const {return maxStatements;}
+      void setMaxStatements(unsigned x) {maxStatements = x;}
+      void clearStatements();
+
       // Non-blocking API
       bool isNonBlocking() const {return nonBlocking;}
       bool isConnected() const {return connected;}
@@ -267,7 +294,11 @@ namespace cb {
       static bool threadSafe();
 
     protected:
+      friend class Statement;
+      void continueStatement(Statement *stmt, statement_continue_t func);
+
       // Continue non-blocking calls
+      bool statementContinue(unsigned ready);
       bool closeContinue(unsigned ready);
       bool connectContinue(unsigned ready);
       bool pingContinue(unsigned ready);
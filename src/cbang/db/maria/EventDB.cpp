@@ -38,6 +38,7 @@
 #include <cbang/Catch.h>
 #include <cbang/log/Logger.h>
 #include <cbang/json/Value.h>
+#include <cbang/json/Sink.h>
 
 #include <mysql/mysqld_error.h>
 
@@ -58,12 +59,62 @@ namespace {
     return ready;
   }
 
-  class QueryCallback {
+  class CallbackBase {
+  protected:
     EventDB &db;
     EventDB::callback_t cb;
-    string query;
     unsigned retry;
 
+  public:
+    CallbackBase(EventDB &db, EventDB::callback_t cb, unsigned retry) :
+      db(db), cb(cb), retry(retry) {}
+    virtual ~CallbackBase() {}
+
+    virtual bool next() = 0;
+    virtual void restart() = 0;
+    virtual unsigned getErrorNumber() const {return db.getErrorNumber();}
+
+
+    void call(EventDB::state_t state) {
+      try {
+        cb(state);
+        return;
+      } CATCH_ERROR;
+
+      if (state != EventDB::EVENTDB_ERROR && state != EventDB::EVENTDB_DONE)
+        try {
+          cb(EventDB::EVENTDB_ERROR);
+        } CATCH_ERROR;
+    }
+
+
+    void operator()(Event::Event &event, int fd, unsigned flags) {
+      try {
+        if (db.continueNB(event_flags_to_db_ready(flags))) {
+          if (!next()) db.renewEvent(event);
+        } else db.addEvent(event);
+
+      } catch (const Exception &e) {
+        // Retry deadlocks
+        if (getErrorNumber() == ER_LOCK_DEADLOCK && --retry) {
+          LOG_WARNING("DB deadlock detected, retrying");
+          call(EventDB::EVENTDB_RETRY);
+          restart();
+          if (!next()) db.renewEvent(event);
+
+        } else {
+          LOG_DEBUG(5, e);
+          call(EventDB::EVENTDB_ERROR);
+        }
+      }
+    }
+  };
+
+
+  class QueryCallback : public CallbackBase {
+    string query;
+    bool stream;
+
     typedef enum {
       STATE_START,
       STATE_QUERY,
@@ -78,22 +129,13 @@ namespace {
 
   public:
     QueryCallback(EventDB &db, EventDB::callback_t cb, const string &query,
-                  unsigned retry = 5) :
-      db(db), cb(cb), query(query), retry(retry),
+                  unsigned retry = 5, bool stream = false) :
+      CallbackBase(db, cb, retry), query(query), stream(stream),
       state(STATE_START) {}
 
 
-    void call(EventDB::state_t state) {
-      try {
-        cb(state);
-        return;
-      } CATCH_ERROR;
-
-      if (state != EventDB::EVENTDB_ERROR && state != EventDB::EVENTDB_DONE)
-        try {
-          cb(EventDB::EVENTDB_ERROR);
-        } CATCH_ERROR;
-    }
+    // From CallbackBase
+    void restart() {state = STATE_START;}
 
 
     bool next() {
@@ -105,7 +147,7 @@ namespace {
 
       case STATE_QUERY:
         state = STATE_STORE;
-        if (!db.storeResultNB()) return false;
+        if (!(stream ? db.useResultNB() : db.storeResultNB())) return false;
 
       case STATE_STORE:
         if (!db.haveResult()) {
@@ -147,29 +189,160 @@ namespace {
       default: THROW("Invalid state");
       }
     }
+  };
 
 
-    void operator()(Event::Event &event, int fd, unsigned flags) {
-      try {
-        if (db.continueNB(event_flags_to_db_ready(flags))) {
-          if (!next()) db.renewEvent(event);
-        } else db.addEvent(event);
+  class StatementCallback : public CallbackBase {
+    SmartPointer<Statement> stmt;
 
-      } catch (const Exception &e) {
-        // Retry deadlocks
-        if (db.getErrorNumber() == ER_LOCK_DEADLOCK && --retry) {
-          LOG_WARNING("DB deadlock detected, retrying");
-          call(EventDB::EVENTDB_RETRY);
-          state = STATE_START;
-          if (!next()) db.renewEvent(event);
+    typedef enum {
+      STATE_START,
+      STATE_PREPARE,
+      STATE_EXECUTE,
+      STATE_FETCH,
+      STATE_FREE,
+      STATE_DONE,
+    } state_t;
+
+    state_t state;
+
+  public:
+    StatementCallback(EventDB &db, EventDB::callback_t cb,
+                      const SmartPointer<Statement> &stmt) :
+      CallbackBase(db, cb, 5), stmt(stmt), state(STATE_START) {}
+
+
+    // From CallbackBase
+    void restart() {state = STATE_PREPARE;}
+    unsigned getErrorNumber() const {return stmt->getErrorNumber();}
+
+
+    bool next() {
+      switch (state) {
+      case STATE_START:
+        state = STATE_PREPARE;
+        if (!stmt->isPrepared() && !stmt->prepareNB()) return false;
+
+      case STATE_PREPARE:
+        state = STATE_EXECUTE;
+        LOG_DEBUG(5, "SQL: " << stmt->getSQL());
+        if (!stmt->executeNB()) return false;
+
+      case STATE_EXECUTE:
+        if (!stmt->haveResult()) {
+          state = STATE_DONE;
+          return next();
+        }
+
+        call(EventDB::EVENTDB_BEGIN_RESULT);
+        state = STATE_FETCH;
+        if (!stmt->fetchRowNB()) return false;
+
+      case STATE_FETCH:
+        while (stmt->isRowReady()) {
+          call(EventDB::EVENTDB_ROW);
+          if (!stmt->fetchRowNB()) return false;
+        }
+        state = STATE_FREE;
+        if (!stmt->freeResultNB()) return false;
+
+      case STATE_FREE:
+        call(EventDB::EVENTDB_END_RESULT);
+        state = STATE_DONE;
+
+      case STATE_DONE:
+        LOG_DEBUG(6, "EVENTDB_DONE");
+        call(EventDB::EVENTDB_DONE);
+        return true;
+
+      default: THROW("Invalid state");
+      }
+    }
+  };
+
+
+  class RowStreamer {
+    EventDB &db;
+    EventDB::callback_t cb;
+    SmartPointer<JSON::Sink> sink;
+    bool rowLists;
+
+    vector<string> names;
+    vector<bool> numbers;
+
+  public:
+    RowStreamer(EventDB &db, EventDB::callback_t cb,
+                const SmartPointer<JSON::Sink> &sink, bool rowLists) :
+      db(db), cb(cb), sink(sink), rowLists(rowLists) {}
+
+
+    void operator()(EventDB::state_t state) {
+      switch (state) {
+      case EventDB::EVENTDB_BEGIN_RESULT: {
+        cb(state);
+
+        names.clear();
+        numbers.clear();
+
+        for (unsigned i = 0; i < db.getFieldCount(); i++) {
+          Field field = db.getField(i);
+          names.push_back(field.getName());
+          numbers.push_back(field.isNumber());
+        }
+
+        sink->beginList();
+        break;
+      }
+
+      case EventDB::EVENTDB_ROW:
+        sink->beginAppend();
+
+        if (rowLists) {
+          sink->beginList();
+          for (unsigned i = 0; i < names.size(); i++) {
+            sink->beginAppend();
+            writeField(i);
+          }
+          sink->endList();
 
         } else {
-          LOG_DEBUG(5, e);
-          call(EventDB::EVENTDB_ERROR);
+          sink->beginDict();
+          for (unsigned i = 0; i < names.size(); i++) {
+            sink->beginInsert(names[i]);
+            writeField(i);
+          }
+          sink->endDict();
         }
+        break;
+
+      case EventDB::EVENTDB_END_RESULT:
+        sink->endList();
+        cb(state);
+        break;
+
+      default: cb(state); break;
       }
     }
+
+
+    void writeField(unsigned i) {
+      if (db.getNull(i)) sink->writeNull();
+      else if (numbers[i]) sink->write(db.getDouble(i));
+      else sink->write(string(db.getData(i), db.getLength(i)));
+    }
   };
+
+
+  void run(EventDB &db, const SmartPointer<CallbackBase> &queryCB) {
+    // By wrapping the event callback in a lambda the SmartPointer is kept
+    // alive
+    auto reply =
+      [queryCB] (Event::Event &event, int fd, unsigned flags) {
+        (*queryCB)(event, fd, flags);
+      };
+
+    if (db.isPending() || !queryCB->next()) db.newEvent(reply);
+  }
 }
 
 
@@ -263,13 +436,23 @@ void EventDB::close(callback_t cb) {
 void EventDB::query(callback_t cb, const string &s,
                     const SmartPointer<const JSON::Value> &dict) {
   string query = dict.isNull() ? s : format(s, dict->getDict());
-  SmartPointer<QueryCallback> queryCB = new QueryCallback(*this, cb, query);
+  run(*this, new QueryCallback(*this, cb, query));
+}
+
+
+void EventDB::stream(callback_t cb, const SmartPointer<JSON::Sink> &sink,
+                     const string &s,
+                     const SmartPointer<const JSON::Value> &dict,
+                     bool rowLists) {
+  if (sink.isNull()) THROW("Sink cannot be null");
+
+  string query = dict.isNull() ? s : format(s, dict->getDict());
+  RowStreamer streamer(*this, cb, sink, rowLists);
+  run(*this, new QueryCallback(*this, streamer, query, 1, true));
+}
 
-  // By wrapping the event callback in a lambda the SmartPointer is kept alive
-  auto reply =
-    [queryCB] (Event::Event &event, int fd, unsigned flags) {
-      (*queryCB)(event, fd, flags);
-    };
 
-  if (isPending() || !queryCB->next()) newEvent(reply);
+void EventDB::execute(callback_t cb, const SmartPointer<Statement> &stmt) {
+  if (stmt.isNull()) THROW("Statement cannot be null");
+  run(*this, new StatementCallback(*this, cb, stmt));
 }
@@ -118,6 +118,27 @@ namespace cb {
         query(std::bind(member, obj, _1), s, dict);
       }
 
+      /**
+       * Like query() but writes each result set to @param sink, as the rows
+       * arrive, as a list of row dicts or, if @param rowLists is true, a list
+       * of row lists.  Results are not buffered in memory.  Column names are
+       * resolved once per result set.  @param cb is called with
+       * EVENTDB_BEGIN_RESULT before a result's list is begun and with
+       * EVENTDB_END_RESULT after it is ended but not for each row.
+       * Deadlocks are not retried because rows may already have been written.
+       */
+      void stream(callback_t cb, const SmartPointer<JSON::Sink> &sink,
+                  const std::string &s,
+                  const SmartPointer<const JSON::Value> &dict = 0,
+                  bool rowLists = false);
+
+      /**
+       * Execute a Statement, preparing it first if necessary.  Rows are read
+       * from @param stmt on EVENTDB_ROW.  Use DB::getStatement() to reuse
+       * Statements already prepared on this connection.
+       */
+      void execute(callback_t cb, const SmartPointer<Statement> &stmt);
+
       // From DB
       using DB::connect;
       using DB::close;
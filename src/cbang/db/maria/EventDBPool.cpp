@@ -0,0 +1,246 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "EventDBPool.h"
+
+#include <cbang/Catch.h>
+#include <cbang/event/Event.h>
+#include <cbang/log/Logger.h>
+#include <cbang/time/Timer.h>
+#include <cbang/util/HistogramSet.h>
+
+#include <mysql/errmsg.h>
+
+#include <algorithm>
+
+using namespace std;
+using namespace cb;
+using namespace cb::MariaDB;
+
+
+namespace {
+  bool isConnectionError(unsigned err) {
+    switch (err) {
+    case CR_CONNECTION_ERROR:
+    case CR_CONN_HOST_ERROR:
+    case CR_SERVER_GONE_ERROR:
+    case CR_SERVER_LOST:
+      return true;
+    default: return false;
+    }
+  }
+}
+
+
+struct EventDBPool::Connection {
+  SmartPointer<EventDB> db;
+  SmartPointer<Event::Event> retryEvent;
+  double delay = 0;
+  bool connecting = false;
+  bool connected = false;
+  bool busy = false;
+};
+
+
+EventDBPool::EventDBPool(Event::Base &base, unsigned size,
+                         const string &host, const string &user,
+                         const string &password, const string &dbName,
+                         unsigned port, const string &socketName,
+                         DB::flags_t flags) :
+  base(base), host(host), user(user), password(password), dbName(dbName),
+  port(port), socketName(socketName), flags(flags) {
+  if (!size) THROW("EventDBPool size cannot be zero");
+  for (unsigned i = 0; i < size; i++) connections.push_back(new Connection);
+}
+
+
+EventDBPool::~EventDBPool() {}
+
+
+unsigned EventDBPool::getConnectedCount() const {
+  unsigned count = 0;
+  for (auto &con: connections) if (con->connected) count++;
+  return count;
+}
+
+
+void EventDBPool::connect() {
+  for (unsigned i = 0; i < connections.size(); i++) {
+    Connection &con = *connections[i];
+    if (!con.connected && !con.connecting) connect(i);
+  }
+}
+
+
+void EventDBPool::query(callback_t cb, const string &s,
+                        const SmartPointer<const JSON::Value> &dict,
+                        int priority) {
+  if (!cb) THROW("Callback cannot be null");
+  if (maxQueued && maxQueued <= queries.size())
+    THROW("EventDBPool queue full");
+
+  Query query = {priority, nextSeq++, s, dict, cb, Timer::now()};
+  queries.push(query);
+
+  dispatch();
+}
+
+
+void EventDBPool::connect(unsigned id) {
+  Connection &con = *connections[id];
+
+  con.connecting = true;
+  con.db = new EventDB(base);
+
+  auto cb =
+    [this, id] (EventDB::state_t state) {
+      Connection &con = *connections[id];
+      con.connecting = false;
+
+      if (state == EventDB::EVENTDB_DONE) {
+        LOG_DEBUG(3, "EventDBPool connection " << id << " open");
+        con.connected = true;
+        con.delay = 0;
+        dispatch();
+
+      } else {
+        LOG_WARNING("EventDBPool connection " << id << " to " << host
+                    << " failed: " << con.db->getError());
+        reconnect(id);
+      }
+    };
+
+  try {
+    con.db->enableNonBlocking();
+    con.db->connect(cb, host, user, password, dbName, port, socketName,
+                    flags);
+
+  } catch (const Exception &e) {
+    LOG_WARNING("EventDBPool connection " << id << ": " << e.getMessage());
+    con.connecting = false;
+    reconnect(id);
+  }
+}
+
+
+void EventDBPool::reconnect(unsigned id) {
+  Connection &con = *connections[id];
+
+  con.connected = false;
+  con.delay = con.delay ? min(con.delay * 2, maxReconnectDelay) :
+    reconnectDelay;
+
+  if (con.retryEvent.isNull())
+    con.retryEvent = base.newEvent([this, id] () {connect(id);},
+                                   Event::Base::EVENT_NO_SELF_REF);
+
+  con.retryEvent->add(con.delay);
+}
+
+
+void EventDBPool::dispatch() {
+  for (unsigned i = 0; i < connections.size() && !queries.empty(); i++) {
+    Connection &con = *connections[i];
+    if (!con.connected || con.busy || con.db->isPending()) continue;
+
+    Query query = queries.top();
+    queries.pop();
+    run(i, query);
+  }
+}
+
+
+void EventDBPool::run(unsigned id, const Query &query) {
+  Connection &con = *connections[id];
+  SmartPointer<EventDB> db = con.db;
+  double start = Timer::now();
+  bool results = false;
+
+  con.busy = true;
+  active++;
+  record("wait", start - query.queued);
+
+  auto cb =
+    [this, id, db, query, start, results] (EventDB::state_t state) mutable {
+      Connection &con = *connections[id];
+
+      switch (state) {
+      case EventDB::EVENTDB_BEGIN_RESULT:
+      case EventDB::EVENTDB_ROW:
+      case EventDB::EVENTDB_END_RESULT:
+        results = true;
+        break;
+
+      case EventDB::EVENTDB_RETRY: results = false; break;
+
+      case EventDB::EVENTDB_ERROR:
+        if (isConnectionError(db->getErrorNumber())) {
+          LOG_WARNING("EventDBPool connection " << id << " lost: "
+                      << db->getError());
+
+          con.busy = false;
+          active--;
+          reconnect(id);
+
+          // Nothing has been delivered yet so run it on another connection
+          if (!results) {
+            queries.push(query);
+            dispatch();
+            return;
+          }
+        }
+        break;
+
+      default: break;
+      }
+
+      TRY_CATCH_ERROR(query.cb(*db, state));
+
+      if (state == EventDB::EVENTDB_DONE || state == EventDB::EVENTDB_ERROR) {
+        record("query", Timer::now() - start);
+
+        if (con.busy && con.db == db) {
+          con.busy = false;
+          active--;
+        }
+
+        dispatch();
+      }
+    };
+
+  con.db->query(cb, query.sql, query.dict);
+}
+
+
+void EventDBPool::record(const string &key, double seconds) {
+  if (stats.isSet()) stats->record(key, (uint64_t)(seconds * 1000000));
+}
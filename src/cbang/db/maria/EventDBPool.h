@@ -0,0 +1,166 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "EventDB.h"
+
+#include <cbang/SmartPointer.h>
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <functional>
+
+
+namespace cb {
+  class HistogramSet;
+
+  namespace MariaDB {
+    /**
+     * Runs queries on a fixed number of EventDB connections.  Queries are
+     * queued by priority, then in order of arrival, and dispatched to idle
+     * connections.  A MariaDB connection can only run one query at a time so
+     * each connection has at most one query in flight.
+     *
+     * Connections which are lost or fail to connect are reopened with an
+     * exponential backoff.  A query whose connection is lost before it
+     * returned any results is requeued.
+     *
+     * The pool must outlive any queries it is running.
+     */
+    class EventDBPool {
+    public:
+      typedef std::function<void (EventDB &db, EventDB::state_t state)>
+      callback_t;
+
+      template <class T> struct Callback {
+        typedef void (T::*member_t)(EventDB &db, EventDB::state_t state);
+      };
+
+    protected:
+      Event::Base &base;
+
+      std::string host;
+      std::string user;
+      std::string password;
+      std::string dbName;
+      unsigned port;
+      std::string socketName;
+      DB::flags_t flags;
+
+      double reconnectDelay = 0.25;
+      double maxReconnectDelay = 30;
+      unsigned maxQueued = 0;
+
+      struct Connection;
+      std::vector<SmartPointer<Connection> > connections;
+
+      struct Query {
+        int priority;
+        uint64_t seq;
+        std::string sql;
+        SmartPointer<const JSON::Value> dict;
+        callback_t cb;
+        double queued;
+
+        bool operator<(const Query &o) const {
+          if (priority != o.priority) return priority < o.priority;
+          return o.seq < seq;
+        }
+      };
+
+      std::priority_queue<Query> queries;
+      uint64_t nextSeq = 0;
+      unsigned active = 0;
+
+      SmartPointer<HistogramSet> stats;
+
+    public:
+      EventDBPool(Event::Base &base, unsigned size,
+                  const std::string &host = "localhost",
+                  const std::string &user = "root",
+                  const std::string &password = std::string(),
+                  const std::string &dbName = std::string(),
+                  unsigned port = 3306,
+                  const std::string &socketName = std::string(),
+                  DB::flags_t flags = DB::FLAG_NONE);
+      ~EventDBPool();
+
+      double getReconnectDelay() const {return reconnectDelay;}
+      void setReconnectDelay(double x) {reconnectDelay = x;}
+      double getMaxReconnectDelay() const {return maxReconnectDelay;}
+      void setMaxReconnectDelay(double x) {maxReconnectDelay = x;}
+
+      /// Queries beyond this limit fail immediately.  Zero for no limit.
+      unsigned getMaxQueued() const {return maxQueued;}
+      void setMaxQueued(unsigned x) {maxQueued = x;}
+
+      unsigned getSize() const {return connections.size();}
+      unsigned getConnectedCount() const;
+      unsigned getActiveCount() const {return active;}
+      unsigned getQueuedCount() const {return queries.size();}
+
+      /**
+       * Record, in microseconds, the time each query waited for a connection
+       * under "wait" and the time it took to run under "query".
+       */
+      void setStats(const SmartPointer<HistogramSet> &stats)
+        {this->stats = stats;}
+      const SmartPointer<HistogramSet> &getStats() const {return stats;}
+
+      /// Open all connections
+      void connect();
+
+      /// Higher @param priority queries are run first
+      void query(callback_t cb, const std::string &s,
+                 const SmartPointer<const JSON::Value> &dict = 0,
+                 int priority = 0);
+
+      template <class T>
+      void query(T *obj, typename Callback<T>::member_t member,
+                 const std::string &s,
+                 const SmartPointer<const JSON::Value> &dict = 0,
+                 int priority = 0) {
+        using namespace std::placeholders;
+        query(std::bind(member, obj, _1, _2), s, dict, priority);
+      }
+
+    protected:
+      void connect(unsigned id);
+      void reconnect(unsigned id);
+      void dispatch();
+      void run(unsigned id, const Query &query);
+      void record(const std::string &key, double seconds);
+    };
+  }
+}
@@ -97,6 +97,11 @@ bool Field::isNull() const {
 }
 
 
+bool Field::isUnsigned() const {
+  return field->flags & UNSIGNED_FLAG;
+}
+
+
 bool Field::isInteger() const {
   switch (getType()) {
   case TYPE_TINY:
@@ -102,6 +102,7 @@ namespace cb {
       bool isInteger() const;
       bool isReal() const;
       bool isNumber() const {return isInteger() || isReal();}
+      bool isUnsigned() const;
       bool isBit() const;
       bool isTime() const;
       bool isBlob() const;
@@ -0,0 +1,564 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "Statement.h"
+#include "DB.h"
+
+#include <cbang/Exception.h>
+#include <cbang/String.h>
+#include <cbang/json/Sink.h>
+#include <cbang/json/Value.h>
+#include <cbang/log/Logger.h>
+
+#include <mysql/mysql.h>
+
+#include <string.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::MariaDB;
+
+
+namespace {
+  struct Cell {
+    int64_t integer = 0;
+    double real = 0;
+    string str;
+    unsigned long length = 0;
+    my_bool null = 0;
+    my_bool error = 0;
+  };
+}
+
+
+struct Statement::private_t {
+  vector<Cell> params;
+  vector<MYSQL_BIND> paramBinds;
+
+  vector<string> names;
+  vector<Cell> results;
+  vector<MYSQL_BIND> resultBinds;
+  MYSQL_RES *meta = 0;
+
+  ~private_t() {if (meta) mysql_free_result(meta);}
+};
+
+
+Statement::Statement(DB &db, const string &sql) :
+  db(db), sql(sql), stmt(mysql_stmt_init(db.getDB())), pri(new private_t),
+  prepared(false), haveRow(false) {
+  if (!stmt) THROW("MariaDB: Failed to allocate statement: " << sql);
+}
+
+
+Statement::~Statement() {
+  if (stmt) mysql_stmt_close(stmt);
+}
+
+
+unsigned Statement::getParameterCount() const {
+  return mysql_stmt_param_count(stmt);
+}
+
+
+void Statement::bindNull(unsigned i) {
+  MYSQL_BIND bind;
+  memset(&bind, 0, sizeof(bind));
+  bind.buffer_type = MYSQL_TYPE_NULL;
+
+  if (pri->params.size() <= i) {
+    pri->params.resize(i + 1);
+    pri->paramBinds.resize(i + 1, bind);
+  }
+
+  pri->paramBinds[i] = bind;
+}
+
+
+void Statement::bind(unsigned i, bool value) {bind(i, (int64_t)value);}
+
+
+void Statement::bind(unsigned i, int64_t value) {
+  bindNull(i);
+  pri->params[i].integer = value;
+  pri->paramBinds[i].buffer_type = MYSQL_TYPE_LONGLONG;
+}
+
+
+void Statement::bind(unsigned i, uint64_t value) {
+  bind(i, (int64_t)value);
+  pri->paramBinds[i].is_unsigned = 1;
+}
+
+
+void Statement::bind(unsigned i, double value) {
+  bindNull(i);
+  pri->params[i].real = value;
+  pri->paramBinds[i].buffer_type = MYSQL_TYPE_DOUBLE;
+}
+
+
+void Statement::bind(unsigned i, const string &value) {
+  bindNull(i);
+  pri->params[i].str = value;
+  pri->params[i].length = value.length();
+  pri->paramBinds[i].buffer_type = MYSQL_TYPE_STRING;
+}
+
+
+void Statement::bind(const JSON::Value &values) {
+  for (unsigned i = 0; i < values.size(); i++) {
+    const JSON::Value &value = *values.get(i);
+
+    if (value.isNull()) bindNull(i);
+    else if (value.isBoolean()) bind(i, value.getBoolean());
+    else if (value.isNumber()) {
+      double x = value.getNumber();
+      if ((double)(int64_t)x == x) bind(i, (int64_t)x);
+      else bind(i, x);
+
+    } else if (value.isString()) bind(i, value.getString());
+    else bind(i, value.toString());
+  }
+}
+
+
+void Statement::clearBindings() {
+  pri->params.clear();
+  pri->paramBinds.clear();
+}
+
+
+void Statement::prepare() {
+  if (mysql_stmt_prepare(stmt, sql.c_str(), sql.length()))
+    raiseError("Failed to prepare statement");
+  prepared = true;
+}
+
+
+bool Statement::prepareNB() {
+  LOG_DEBUG(5, __func__ << "() " << sql);
+
+  db.assertNotPending();
+  db.assertNonBlocking();
+
+  int ret = 0;
+  db.status = mysql_stmt_prepare_start(&ret, stmt, sql.c_str(), sql.length());
+  if (db.status) {
+    db.continueStatement(this, &Statement::prepareContinue);
+    return false;
+  }
+
+  if (ret) raiseError("Failed to prepare statement");
+  prepared = true;
+
+  return true;
+}
+
+
+void Statement::execute() {
+  if (!prepared) prepare();
+  bindParameters();
+  if (mysql_stmt_execute(stmt)) raiseError("Failed to execute statement");
+  bindResults();
+}
+
+
+bool Statement::executeNB() {
+  LOG_DEBUG(5, __func__ << "()");
+
+  db.assertNotPending();
+  db.assertNonBlocking();
+  bindParameters();
+
+  int ret = 0;
+  db.status = mysql_stmt_execute_start(&ret, stmt);
+  if (db.status) {
+    db.continueStatement(this, &Statement::executeContinue);
+    return false;
+  }
+
+  if (ret) raiseError("Failed to execute statement");
+  bindResults();
+
+  return true;
+}
+
+
+bool Statement::haveResult() const {return pri->meta;}
+
+
+bool Statement::fetchRow() {
+  rowFetched(mysql_stmt_fetch(stmt));
+  return haveRow;
+}
+
+
+bool Statement::fetchRowNB() {
+  LOG_DEBUG(5, __func__ << "()");
+
+  db.assertNotPending();
+  db.assertNonBlocking();
+
+  int ret = 0;
+  db.status = mysql_stmt_fetch_start(&ret, stmt);
+  if (db.status) {
+    db.continueStatement(this, &Statement::fetchRowContinue);
+    return false;
+  }
+
+  rowFetched(ret);
+
+  return true;
+}
+
+
+void Statement::freeResult() {
+  haveRow = false;
+  if (mysql_stmt_free_result(stmt)) raiseError("Failed to free result");
+}
+
+
+bool Statement::freeResultNB() {
+  LOG_DEBUG(5, __func__ << "()");
+
+  db.assertNotPending();
+  db.assertNonBlocking();
+  haveRow = false;
+
+  my_bool ret = 0;
+  db.status = mysql_stmt_free_result_start(&ret, stmt);
+  if (db.status) {
+    db.continueStatement(this, &Statement::freeResultContinue);
+    return false;
+  }
+
+  if (ret) raiseError("Failed to free result");
+
+  return true;
+}
+
+
+uint64_t Statement::getAffectedRowCount() const {
+  return mysql_stmt_affected_rows(stmt);
+}
+
+
+uint64_t Statement::getInsertID() const {return mysql_stmt_insert_id(stmt);}
+
+
+unsigned Statement::getFieldCount() const {return pri->names.size();}
+
+
+const string &Statement::getFieldName(unsigned i) const {
+  assertInFieldRange(i);
+  return pri->names[i];
+}
+
+
+bool Statement::isNull(unsigned i) const {
+  assertRow();
+  assertInFieldRange(i);
+  return pri->results[i].null;
+}
+
+
+bool Statement::isInteger(unsigned i) const {
+  assertInFieldRange(i);
+  return pri->resultBinds[i].buffer_type == MYSQL_TYPE_LONGLONG;
+}
+
+
+bool Statement::isReal(unsigned i) const {
+  assertInFieldRange(i);
+  return pri->resultBinds[i].buffer_type == MYSQL_TYPE_DOUBLE;
+}
+
+
+int64_t Statement::getS64(unsigned i) const {
+  if (isNull(i)) return 0;
+  if (isInteger(i)) return pri->results[i].integer;
+  if (isReal(i)) return (int64_t)pri->results[i].real;
+  return String::parseS64(pri->results[i].str);
+}
+
+
+uint64_t Statement::getU64(unsigned i) const {
+  if (isNull(i)) return 0;
+  if (isInteger(i)) return (uint64_t)pri->results[i].integer;
+  if (isReal(i)) return (uint64_t)pri->results[i].real;
+  return String::parseU64(pri->results[i].str);
+}
+
+
+double Statement::getDouble(unsigned i) const {
+  if (isNull(i)) return 0;
+  if (isReal(i)) return pri->results[i].real;
+  if (isInteger(i)) {
+    if (pri->resultBinds[i].is_unsigned)
+      return (double)(uint64_t)pri->results[i].integer;
+    return (double)pri->results[i].integer;
+  }
+  return String::parseDouble(pri->results[i].str);
+}
+
+
+bool Statement::getBoolean(unsigned i) const {
+  if (isNull(i)) return false;
+  if (isInteger(i)) return pri->results[i].integer;
+  if (isReal(i)) return pri->results[i].real;
+  return String::parseBool(pri->results[i].str);
+}
+
+
+string Statement::getString(unsigned i) const {
+  if (isNull(i)) return "";
+  if (isInteger(i)) {
+    if (pri->resultBinds[i].is_unsigned)
+      return String((uint64_t)pri->results[i].integer);
+    return String(pri->results[i].integer);
+  }
+  if (isReal(i)) return String(pri->results[i].real);
+  return pri->results[i].str;
+}
+
+
+void Statement::writeField(JSON::Sink &sink, unsigned i) const {
+  if (isNull(i)) sink.writeNull();
+  else if (isInteger(i)) {
+    if (pri->resultBinds[i].is_unsigned)
+      sink.write((uint64_t)pri->results[i].integer);
+    else sink.write(pri->results[i].integer);
+
+  } else if (isReal(i)) sink.write(pri->results[i].real);
+  else sink.write(pri->results[i].str);
+}
+
+
+void Statement::writeRowList(JSON::Sink &sink) const {
+  sink.beginList();
+
+  for (unsigned i = 0; i < getFieldCount(); i++) {
+    sink.beginAppend();
+    writeField(sink, i);
+  }
+
+  sink.endList();
+}
+
+
+void Statement::writeRowDict(JSON::Sink &sink, bool withNulls) const {
+  sink.beginDict();
+
+  for (unsigned i = 0; i < getFieldCount(); i++) {
+    if (!withNulls && isNull(i)) continue;
+    sink.beginInsert(pri->names[i]);
+    writeField(sink, i);
+  }
+
+  sink.endDict();
+}
+
+
+string Statement::getError() const {return mysql_stmt_error(stmt);}
+unsigned Statement::getErrorNumber() const {return mysql_stmt_errno(stmt);}
+
+
+void Statement::raiseError(const string &msg) const {
+  THROW("MariaDB: " << msg << ": " << getError() << ": " << sql);
+}
+
+
+void Statement::bindParameters() {
+  unsigned count = getParameterCount();
+  if (pri->paramBinds.size() < count)
+    raiseError(SSTR("Expected " << count << " parameters, have "
+                    << pri->paramBinds.size()));
+
+  // Buffers are pointed to once all parameters are in place
+  for (unsigned i = 0; i < count; i++) {
+    Cell &cell = pri->params[i];
+    MYSQL_BIND &bind = pri->paramBinds[i];
+
+    switch (bind.buffer_type) {
+    case MYSQL_TYPE_LONGLONG: bind.buffer = &cell.integer; break;
+    case MYSQL_TYPE_DOUBLE: bind.buffer = &cell.real; break;
+    case MYSQL_TYPE_STRING:
+      bind.buffer = (void *)cell.str.data();
+      bind.buffer_length = cell.length;
+      bind.length = &cell.length;
+      break;
+    default: break;
+    }
+  }
+
+  if (count && mysql_stmt_bind_param(stmt, &pri->paramBinds[0]))
+    raiseError("Failed to bind parameters");
+}
+
+
+void Statement::bindResults() {
+  if (pri->meta) {
+    mysql_free_result(pri->meta);
+    pri->meta = 0;
+  }
+
+  pri->names.clear();
+  pri->results.clear();
+  pri->resultBinds.clear();
+
+  pri->meta = mysql_stmt_result_metadata(stmt);
+  if (!pri->meta) return; // No result set
+
+  unsigned count = mysql_num_fields(pri->meta);
+  MYSQL_FIELD *fields = mysql_fetch_fields(pri->meta);
+
+  pri->results.resize(count);
+  pri->resultBinds.resize(count);
+  memset(&pri->resultBinds[0], 0, sizeof(MYSQL_BIND) * count);
+
+  for (unsigned i = 0; i < count; i++) {
+    Field field(&fields[i]);
+    Cell &cell = pri->results[i];
+    MYSQL_BIND &bind = pri->resultBinds[i];
+
+    pri->names.push_back(field.getName());
+
+    bind.is_null = &cell.null;
+    bind.error = &cell.error;
+    bind.length = &cell.length;
+
+    if (field.isInteger()) {
+      bind.buffer_type = MYSQL_TYPE_LONGLONG;
+      bind.buffer = &cell.integer;
+      bind.is_unsigned = field.isUnsigned();
+
+    } else if (field.getType() == Field::TYPE_FLOAT ||
+               field.getType() == Field::TYPE_DOUBLE) {
+      bind.buffer_type = MYSQL_TYPE_DOUBLE;
+      bind.buffer = &cell.real;
+
+    } else {
+      // Fetched with mysql_stmt_fetch_column() once the length is known
+      bind.buffer_type = MYSQL_TYPE_STRING;
+      bind.buffer = 0;
+      bind.buffer_length = 0;
+    }
+  }
+
+  if (mysql_stmt_bind_result(stmt, &pri->resultBinds[0]))
+    raiseError("Failed to bind results");
+}
+
+
+void Statement::rowFetched(int ret) {
+  haveRow = false;
+
+  if (ret == MYSQL_NO_DATA) return;
+  if (ret == 1) raiseError("Failed to fetch row");
+
+  // Strings are bound with zero length buffers so are always truncated
+  for (unsigned i = 0; i < pri->results.size(); i++) {
+    Cell &cell = pri->results[i];
+    MYSQL_BIND &bind = pri->resultBinds[i];
+
+    if (bind.buffer_type != MYSQL_TYPE_STRING || cell.null) continue;
+
+    cell.str.resize(cell.length);
+    if (!cell.length) continue;
+
+    MYSQL_BIND column = bind;
+    column.buffer = &cell.str[0];
+    column.buffer_length = cell.length;
+
+    if (mysql_stmt_fetch_column(stmt, &column, i, 0))
+      raiseError(SSTR("Failed to fetch column " << i));
+  }
+
+  haveRow = true;
+}
+
+
+void Statement::assertRow() const {
+  if (!haveRow) THROW("MariaDB: No row fetched");
+}
+
+
+void Statement::assertInFieldRange(unsigned i) const {
+  if (getFieldCount() <= i) THROW("MariaDB: Out of field range " << i);
+}
+
+
+bool Statement::prepareContinue(unsigned ready) {
+  int ret = 0;
+  db.status = mysql_stmt_prepare_cont(&ret, stmt, ready);
+  if (db.status) return false;
+
+  if (ret) raiseError("Failed to prepare statement");
+  prepared = true;
+
+  return true;
+}
+
+
+bool Statement::executeContinue(unsigned ready) {
+  int ret = 0;
+  db.status = mysql_stmt_execute_cont(&ret, stmt, ready);
+  if (db.status) return false;
+
+  if (ret) raiseError("Failed to execute statement");
+  bindResults();
+
+  return true;
+}
+
+
+bool Statement::fetchRowContinue(unsigned ready) {
+  int ret = 0;
+  db.status = mysql_stmt_fetch_cont(&ret, stmt, ready);
+  if (db.status) return false;
+
+  rowFetched(ret);
+
+  return true;
+}
+
+
+bool Statement::freeResultContinue(unsigned ready) {
+  my_bool ret = 0;
+  db.status = mysql_stmt_free_result_cont(&ret, stmt, ready);
+  if (db.status) return false;
+
+  if (ret) raiseError("Failed to free result");
+
+  return true;
+}
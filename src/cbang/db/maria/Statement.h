@@ -0,0 +1,144 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+#include <cbang/StdTypes.h>
+
+#include <string>
+#include <vector>
+
+struct st_mysql_stmt;
+
+
+namespace cb {
+  namespace JSON {
+    class Sink;
+    class Value;
+  }
+
+  namespace MariaDB {
+    class DB;
+
+    /**
+     * A server-side prepared statement.  Parameters are positional, '?' in
+     * the SQL, and are sent in the binary protocol.  Results are bound to
+     * native integers, doubles or strings according to the column type so
+     * numbers are not converted to text.
+     *
+     * A Statement must not outlive the DB which created it.  Use
+     * DB::getStatement() or EventDB::execute() to reuse prepared Statements.
+     */
+    class Statement {
+      DB &db;
+      const std::string sql;
+      st_mysql_stmt *stmt;
+
+      struct private_t;
+      SmartPointer<private_t> pri;
+
+      bool prepared;
+      bool haveRow;
+
+    public:
+      Statement(DB &db, const std::string &sql);
+      ~Statement();
+
+      const std::string &getSQL() const {return sql;}
+      bool isPrepared() const {return prepared;}
+
+      // Parameters
+      unsigned getParameterCount() const;
+      void bindNull(unsigned i);
+      void bind(unsigned i, bool value);
+      void bind(unsigned i, int64_t value);
+      void bind(unsigned i, uint64_t value);
+      void bind(unsigned i, int32_t value) {bind(i, (int64_t)value);}
+      void bind(unsigned i, uint32_t value) {bind(i, (uint64_t)value);}
+      void bind(unsigned i, double value);
+      void bind(unsigned i, const std::string &value);
+      void bind(unsigned i, const char *value) {bind(i, std::string(value));}
+      /// Bind each element of the JSON list @param values in order
+      void bind(const JSON::Value &values);
+      void clearBindings();
+
+      // Execution
+      void prepare();
+      bool prepareNB();
+      void execute();
+      bool executeNB();
+      bool haveResult() const;
+      bool fetchRow();
+      bool fetchRowNB();
+      bool isRowReady() const {return haveRow;}
+      void freeResult();
+      bool freeResultNB();
+
+      uint64_t getAffectedRowCount() const;
+      uint64_t getInsertID() const;
+
+      // Result row
+      unsigned getFieldCount() const;
+      const std::string &getFieldName(unsigned i) const;
+      bool isNull(unsigned i) const;
+      bool isInteger(unsigned i) const;
+      bool isReal(unsigned i) const;
+      int64_t getS64(unsigned i) const;
+      uint64_t getU64(unsigned i) const;
+      double getDouble(unsigned i) const;
+      bool getBoolean(unsigned i) const;
+      std::string getString(unsigned i) const;
+
+      void writeField(JSON::Sink &sink, unsigned i) const;
+      void writeRowList(JSON::Sink &sink) const;
+      void writeRowDict(JSON::Sink &sink, bool withNulls = true) const;
+
+      std::string getError() const;
+      unsigned getErrorNumber() const;
+      void raiseError(const std::string &msg) const;
+
+    protected:
+      void bindParameters();
+      void bindResults();
+      void rowFetched(int ret);
+      void assertRow() const;
+      void assertInFieldRange(unsigned i) const;
+
+      friend class DB;
+      bool prepareContinue(unsigned ready);
+      bool executeContinue(unsigned ready);
+      bool fetchRowContinue(unsigned ready);
+      bool freeResultContinue(unsigned ready);
+    };
+  }
+}
@@ -79,21 +79,30 @@ BacktraceDebugger::~BacktraceDebugger() {}
 bool BacktraceDebugger::supported() {return true;}
 
 
-bool BacktraceDebugger::getStackTrace(StackTrace &trace) {
-  init(); // Might set enabled false
-  if (!enabled) return false;
+unsigned BacktraceDebugger::captureStackTrace(void **stack, unsigned size) {
+  if (!enabled) return 0;
 
-  void *stack[maxStack];
-  int n = backtrace(stack, maxStack);
-  SmartPointer<char *>::Malloc symbols = backtrace_symbols(stack, n);
+  // Only walks the stack, symbols are not loaded until resolved
+  int n = backtrace(stack, size);
 
 #ifdef VALGRIND_MAKE_MEM_DEFINED
   (void)VALGRIND_MAKE_MEM_DEFINED(stack, n * sizeof(void *));
 #endif // VALGRIND_MAKE_MEM_DEFINED
 
+  return 0 < n ? n : 0;
+}
+
+
+bool BacktraceDebugger::resolveStackTrace(void *const *stack, unsigned n,
+                                          StackTrace &trace) {
+  init(); // Might set enabled false
+  if (!enabled) return false;
+
+  SmartPointer<char *>::Malloc symbols = backtrace_symbols(stack, n);
+
   SmartLock lock(this);
 
-  for (int i = 0; i < n; i++) {
+  for (unsigned i = 0; i < n; i++) {
     bfd_vma pc = (bfd_vma)stack[i];
 
     const char *filename = 0;
@@ -52,7 +52,11 @@ namespace cb {
     ~BacktraceDebugger();
 
     static bool supported();
-    bool getStackTrace(StackTrace &trace);
+
+    // From Debugger
+    unsigned captureStackTrace(void **stack, unsigned size);
+    bool resolveStackTrace(void *const *stack, unsigned count,
+                           StackTrace &trace);
 
   protected:
     void init();
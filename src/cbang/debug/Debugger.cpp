@@ -38,6 +38,7 @@
 #include <cbang/util/SmartLock.h>
 
 #include <stdexcept>
+#include <vector>
 
 #include <stdlib.h>
 
@@ -90,6 +91,13 @@ bool Debugger::printStackTrace(ostream &stream) {
 }
 
 
+bool Debugger::getStackTrace(StackTrace &trace) {
+  vector<void *> stack(maxStack);
+  unsigned count = captureStackTrace(stack.data(), maxStack);
+  return count && resolveStackTrace(stack.data(), count, trace);
+}
+
+
 StackTrace Debugger::getStackTrace() {
   StackTrace trace;
   instance().getStackTrace(trace);
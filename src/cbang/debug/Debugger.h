@@ -58,6 +58,14 @@ namespace cb {
 
     static std::string getExecutableName();
 
-    virtual bool getStackTrace(StackTrace &trace) {return 0;}
+    /// Capture then resolve up to maxStack frames
+    virtual bool getStackTrace(StackTrace &trace);
+
+    /// @return The number of return addresses written to @param stack
+    virtual unsigned captureStackTrace(void **stack, unsigned size)
+    {return 0;}
+    /// Append a symbolized StackFrame to @param trace for each address
+    virtual bool resolveStackTrace(void *const *stack, unsigned count,
+                                   StackTrace &trace) {return false;}
   };
 }
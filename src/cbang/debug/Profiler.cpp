@@ -0,0 +1,252 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "Profiler.h"
+#include "Debugger.h"
+
+#include <cbang/Exception.h>
+#include <cbang/String.h>
+#include <cbang/time/Timer.h>
+#include <cbang/json/Sink.h>
+#include <cbang/util/SmartLock.h>
+#include <cbang/os/SysError.h>
+
+#include <map>
+#include <vector>
+#include <algorithm>
+
+#include <errno.h>
+
+#ifndef _WIN32
+#include <signal.h>
+#include <sys/time.h>
+#endif
+
+using namespace std;
+using namespace cb;
+
+
+atomic<Profiler *> Profiler::active(0);
+
+
+Profiler::Profiler(Inaccessible) : next(0), running(false) {}
+
+
+Profiler::~Profiler() {
+  stop();
+  delete [] samples;
+}
+
+
+uint64_t Profiler::getSampleCount() const {
+  return min<uint64_t>(next.load(), maxSamples);
+}
+
+
+uint64_t Profiler::getDroppedCount() const {
+  uint64_t count = next.load();
+  return maxSamples < count ? count - maxSamples : 0;
+}
+
+
+double Profiler::getDuration() const {
+  return running ? Timer::now() - startTime : duration;
+}
+
+
+void Profiler::start(unsigned rate, unsigned maxSamples) {
+#ifdef _WIN32
+  THROW("Profiler not supported on Windows");
+
+#else
+  SmartLock lock(this);
+
+  if (running) THROW("Profiler already running");
+  if (!rate || 1000000 < rate) THROW("Invalid profiler rate " << rate);
+  if (!maxSamples) THROW("Profiler needs room for at least one sample");
+
+  if (!debugger) {
+    debugger = &Debugger::instance();
+
+    // Load the unwinder now, it may allocate on first use
+    void *addrs[maxDepth];
+    if (!debugger->captureStackTrace(addrs, maxDepth))
+      THROW("Profiler requires stack trace support");
+  }
+
+  if (this->maxSamples != maxSamples) {
+    delete [] samples;
+    samples = 0;
+    this->maxSamples = 0;
+    samples = new Sample[maxSamples];
+    this->maxSamples = maxSamples;
+  }
+
+  for (unsigned i = 0; i < maxSamples; i++) samples[i].depth = 0;
+
+  this->rate = rate;
+  next = 0;
+  running = true;
+  active = this;
+  startTime = Timer::now();
+
+  struct sigaction action = {};
+  action.sa_handler = &Profiler::signalHandler;
+  action.sa_flags = SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  if (sigaction(SIGPROF, &action, 0))
+    THROW("Failed to install SIGPROF handler: " << SysError());
+
+  struct itimerval timer = {};
+  timer.it_interval.tv_usec = 1000000 / rate;
+  timer.it_value = timer.it_interval;
+  if (setitimer(ITIMER_PROF, &timer, 0)) {
+    running = false;
+    THROW("Failed to start profiler timer: " << SysError());
+  }
+#endif
+}
+
+
+void Profiler::stop() {
+#ifndef _WIN32
+  SmartLock lock(this);
+
+  if (!running) return;
+
+  struct itimerval timer = {};
+  setitimer(ITIMER_PROF, &timer, 0);
+
+  running = false;
+  duration = Timer::now() - startTime;
+#endif
+}
+
+
+void Profiler::writeFolded(ostream &stream) const {
+  SmartLock lock(this);
+
+  typedef vector<void *> stack_t;
+  map<stack_t, uint64_t> stacks;
+  unsigned count = getSampleCount();
+
+  for (unsigned i = 0; i < count; i++) {
+    const Sample &sample = samples[i];
+    unsigned depth = sample.depth.load(memory_order_acquire);
+    if (depth) stacks[stack_t(sample.addrs, sample.addrs + depth)]++;
+  }
+
+  if (stacks.empty()) return;
+
+  // Symbolize each address once
+  map<void *, string> names;
+  for (auto it = stacks.begin(); it != stacks.end(); it++)
+    for (auto addr: it->first)
+      if (names.find(addr) == names.end()) names[addr] = getFrameName(addr);
+
+  // Skip the frames of the capture, signal handler and signal trampoline
+  const stack_t &first = stacks.begin()->first;
+  unsigned skip = 0;
+  for (unsigned i = 0; i < first.size() && i < 8; i++) {
+    const string &name = names[first[i]];
+
+    if (name.find("Profiler") != string::npos &&
+        name.find("signalHandler") != string::npos) {
+      skip = min<unsigned>(i + 2, first.size() - 1);
+      break;
+    }
+  }
+
+  for (auto it = stacks.begin(); it != stacks.end(); it++) {
+    const stack_t &stack = it->first;
+    if (stack.size() <= skip) continue;
+
+    for (unsigned i = stack.size(); skip < i; i--) {
+      stream << names[stack[i - 1]];
+      if (i - 1 != skip) stream << ';';
+    }
+
+    stream << ' ' << it->second << '\n';
+  }
+}
+
+
+void Profiler::write(JSON::Sink &sink) const {
+  SmartLock lock(this);
+
+  sink.beginDict();
+  sink.insertBoolean("running", running);
+  sink.insert("rate", rate);
+  sink.insert("duration", getDuration());
+  sink.insert("samples", getSampleCount());
+  sink.insert("dropped", getDroppedCount());
+  sink.insert("max_samples", maxSamples);
+  sink.endDict();
+}
+
+
+string Profiler::getFrameName(void *addr) const {
+  StackTrace trace;
+  debugger->resolveStackTrace(&addr, 1, trace);
+
+  // Inlined frames are listed innermost first
+  string name;
+  for (auto it = trace.rbegin(); it != trace.rend(); it++) {
+    string function = it->getFunction();
+    if (function.empty()) function = it->getAddrString();
+    replace(function.begin(), function.end(), ';', ':');
+
+    if (!name.empty()) name += ';';
+    name += function;
+  }
+
+  return name.empty() ? String::printf("%p", addr) : name;
+}
+
+
+void Profiler::signalHandler(int sig) {
+  Profiler *profiler = active.load();
+  if (!profiler || !profiler->running) return;
+
+  int savedErrno = errno;
+
+  uint64_t i = profiler->next.fetch_add(1, memory_order_relaxed);
+  if (i < profiler->maxSamples) {
+    Sample &sample = profiler->samples[i];
+    unsigned depth =
+      profiler->debugger->captureStackTrace(sample.addrs, maxDepth);
+    sample.depth.store(depth, memory_order_release);
+  }
+
+  errno = savedErrno;
+}
@@ -0,0 +1,117 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cbang/util/Singleton.h>
+#include <cbang/os/Mutex.h>
+#include <cbang/json/Serializable.h>
+
+#include <atomic>
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+
+namespace cb {
+  class Debugger;
+
+  /**
+   * A sampling CPU profiler.  While running, SIGPROF is delivered at the
+   * sampling rate, per second of process CPU time, and the return
+   * addresses of the interrupted thread are written to a preallocated
+   * sample buffer.  The signal handler claims buffer slots with an atomic
+   * increment so it never locks or allocates.  Samples are only symbolized
+   * when they are written out.  Once the buffer is full further samples are
+   * counted as dropped.
+   *
+   * Requires a Debugger which can capture stacks, i.e. HAVE_CBANG_BACKTRACE.
+   * Not supported on Windows.
+   */
+  class Profiler : public Singleton<Profiler>, public Mutex,
+                   public JSON::Serializable {
+  public:
+    static const unsigned maxDepth = 64;
+
+  protected:
+    struct Sample {
+      std::atomic<unsigned> depth;
+      void *addrs[maxDepth];
+    };
+
+    Debugger *debugger = 0;
+    Sample *samples = 0;
+    unsigned maxSamples = 0;
+    std::atomic<uint64_t> next;
+    std::atomic<bool> running;
+    unsigned rate = 0;
+    double startTime = 0;
+    double duration = 0;
+
+    static std::atomic<Profiler *> active;
+
+  public:
+    Profiler(Inaccessible);
+    ~Profiler();
+
+    bool isRunning() const {return running;}
+    unsigned getRate() const {return rate;}
+    unsigned getMaxSamples() const {return maxSamples;}
+    uint64_t getSampleCount() const;
+    uint64_t getDroppedCount() const;
+    /// @return Wall clock seconds profiled, so far if running
+    double getDuration() const;
+
+    /**
+     * Start sampling @param rate times per second of CPU time.  Up to
+     * @param maxSamples are kept.  Samples from any previous run are
+     * discarded.
+     */
+    void start(unsigned rate = 99, unsigned maxSamples = 10000);
+    void stop();
+
+    /**
+     * Write one line per unique stack in the folded format read by
+     * flamegraph.pl and speedscope.  Frames are listed from the root,
+     * separated by ';' and followed by a space and the number of samples.
+     */
+    void writeFolded(std::ostream &stream) const;
+
+    // From JSON::Serializable
+    void write(JSON::Sink &sink) const;
+
+  protected:
+    std::string getFrameName(void *addr) const;
+    static void signalHandler(int sig);
+  };
+}
@@ -44,7 +44,24 @@ using namespace std;
 StackTrace StackTrace::get() {return Debugger::getStackTrace();}
 
 
+void StackTrace::capture() {
+  clear();
+  addrCount = Debugger::instance().captureStackTrace(addrs, maxAddrs);
+}
+
+
+void StackTrace::resolve() const {
+  if (isResolved()) return;
+
+  // Only the frame list is filled in, the captured addresses are unchanged
+  StackTrace &self = const_cast<StackTrace &>(*this);
+  Debugger::instance().resolveStackTrace(addrs, addrCount, self);
+}
+
+
 ostream &StackTrace::print(ostream &stream) const {
+  resolve();
+
   unsigned count = 0;
 
   for (auto it = begin(); it != end(); it++)
@@ -55,6 +72,8 @@ ostream &StackTrace::print(ostream &stream) const {
 
 
 void StackTrace::write(JSON::Sink &sink) const {
+  resolve();
+
   sink.beginList();
 
   for (auto it = begin(); it != end(); it++) {
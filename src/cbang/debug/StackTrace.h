@@ -39,10 +39,30 @@
 
 
 namespace cb {
+  /**
+   * A list of StackFrames.  A StackTrace may instead capture() only the raw
+   * return addresses, which is cheap, and symbolize them on first use.
+   * The frame list is then filled in by resolve(), which print() and write()
+   * call automatically.
+   */
   class StackTrace : public std::vector<StackFrame> {
+  public:
+    static const unsigned maxAddrs = 64;
+
+  protected:
+    void *addrs[maxAddrs];
+    unsigned addrCount = 0;
+
   public:
     static StackTrace get();
 
+    /// Record the current return addresses without symbolizing them
+    void capture();
+    unsigned getAddrCount() const {return addrCount;}
+    bool isResolved() const {return !addrCount || !empty();}
+    /// Symbolize captured addresses if not already done
+    void resolve() const;
+
     std::ostream &print(std::ostream &stream) const;
     void write(cb::JSON::Sink &sink) const;
   };
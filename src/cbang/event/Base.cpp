@@ -32,6 +32,11 @@
 
 #include "Base.h"
 #include "Event.h"
+#include "IOUring.h"
+#include "TimerWheel.h"
+#include "ConcurrentPool.h"
+#include "BufferPool.h"
+#include "PostQueue.h"
 
 #include <event2/thread.h>
 #include <event2/event.h>
@@ -39,9 +44,12 @@
 
 #include <cbang/Exception.h>
 #include <cbang/socket/Socket.h>
+#include <cbang/json/ArenaPool.h>
+#include <cbang/util/MemoryAccounting.h>
+#include <cbang/time/Timer.h>
+#include <cbang/time/Time.h>
 
 using namespace cb::Event;
-using namespace cb;
 
 
 namespace {
@@ -55,22 +63,109 @@ namespace {
     counts.insert(std::pair<int, unsigned>(priority, 0)).first->second++;
     return 0;
   }
+
+
+  extern "C" void *buffer_pool_malloc(size_t size) {
+    return Base::getBufferPool()->allocate(size);
+  }
+
+
+  extern "C" void *buffer_pool_realloc(void *ptr, size_t size) {
+    return Base::getBufferPool()->reallocate(ptr, size);
+  }
+
+
+  extern "C" void buffer_pool_free(void *ptr) {
+    Base::getBufferPool()->release(ptr);
+  }
 }
 
 bool Base::_threadsEnabled = false;
+BufferPool *Base::_bufferPool = 0;
 
 
-Base::Base(bool withThreads, int priorities) {
+Base::Base(bool withThreads, int priorities, bool withIOURing) :
+  postQueue(0) {
   Socket::initialize(); // Windows needs this
 
   if (withThreads) enableThreads();
   base = event_base_new();
   if (!base) THROW("Failed to create event base");
   if (0 < priorities) initPriority(priorities);
+
+  // Without io_uring support file I/O remains blocking
+  if (withIOURing && IOUring::isSupported()) ioURing = new IOUring(*this);
+}
+
+
+Base::~Base() {
+  // Free their events first
+  if (cryptoPool.isSet()) cryptoPool->join();
+  cryptoPool.release();
+  timerWheel.release();
+  deferredPool.release();
+  delete postQueue.load();
+  ioURing.release();
+  if (base) event_base_free(base);
+}
+
+
+IOUring &Base::getIOURing() const {
+  if (ioURing.isNull()) THROW("No io_uring");
+  return *ioURing;
+}
+
+
+TimerWheel &Base::getTimerWheel() {
+  if (timerWheel.isNull()) timerWheel = new TimerWheel(*this);
+  return *timerWheel;
+}
+
+
+DeferredPool &Base::getDeferredPool() {
+  if (deferredPool.isNull()) deferredPool = new DeferredPool(*this);
+  return *deferredPool;
+}
+
+
+PostQueue &Base::getPostQueue() {
+  PostQueue *queue = postQueue.load();
+  if (queue) return *queue;
+
+  // Racing threads may both create one, only the first is kept
+  SmartPointer<PostQueue> created = new PostQueue(*this);
+  if (postQueue.compare_exchange_strong(queue, created.get()))
+    return *created.adopt();
+
+  return *queue;
+}
+
+
+void Base::post(bare_callback_t cb) {getPostQueue().post(std::move(cb));}
+bool Base::tryPost(bare_callback_t cb)
+{return getPostQueue().tryPost(std::move(cb));}
+
+
+const cb::SmartPointer<cb::JSON::ArenaPool> &Base::getArenaPool() {
+  if (arenaPool.isNull()) arenaPool = new JSON::ArenaPool;
+  return arenaPool;
+}
+
+
+void Base::setCryptoThreads(unsigned threads) {
+  if (threads == cryptoThreads) return;
+  if (cryptoPool.isSet()) THROW("Crypto threads already started");
+
+  cryptoPool = new ConcurrentPool(*this, threads);
+  cryptoPool->start();
+  cryptoThreads = threads;
 }
 
 
-Base::~Base() {if (base) event_base_free(base);}
+ConcurrentPool &Base::getCryptoPool() const {
+  if (cryptoPool.isNull()) THROW("No crypto pool");
+  return *cryptoPool;
+}
 
 
 void Base::initPriority(int num) {
@@ -99,19 +194,47 @@ void Base::countActiveEventsByPriority(std::map<int, unsigned> &counts) const {
 }
 
 
-SmartPointer<cb::Event::Event>
-Base::newEvent(callback_t cb, unsigned flags) {return newEvent(-1, cb, flags);}
+cb::SmartPointer<cb::Event::Event>
+Base::newEvent(callback_t cb, unsigned flags)
+{return newEvent(-1, std::move(cb), flags);}
 
 
-SmartPointer<cb::Event::Event>
+cb::SmartPointer<cb::Event::Event>
 Base::newEvent(socket_t fd, callback_t cb, unsigned flags) {
-  return new Event(*this, fd, cb, flags);
+  return new Event(*this, fd, std::move(cb), flags);
 }
 
 
-SmartPointer<cb::Event::Event>
+cb::SmartPointer<cb::Event::Event>
 Base::newSignal(int signal, callback_t cb, unsigned flags) {
-  return newEvent((socket_t)signal, cb, flags | EV_SIGNAL);
+  return newEvent((socket_t)signal, std::move(cb), flags | EV_SIGNAL);
+}
+
+
+double Base::getCachedTime() const {
+  struct timeval tv;
+  if (event_base_gettimeofday_cached(base, &tv))
+    THROW("Failed to get cached time");
+  return Timer::toDouble(tv);
+}
+
+
+const std::string &Base::getHTTPDate() {
+  uint64_t now = getCachedTime();
+
+  if (now != httpDateTime || httpDate.empty()) {
+    httpDateTime = now;
+    httpDate = Time(now, Time::httpFormat).toString();
+    httpDateHeader = "Date: " + httpDate + "\r\n";
+  }
+
+  return httpDate;
+}
+
+
+const std::string &Base::getHTTPDateHeader() {
+  getHTTPDate();
+  return httpDateHeader;
 }
 
 
@@ -163,3 +286,24 @@ void Base::enableThreads() {
 
   _threadsEnabled = true;
 }
+
+
+void Base::enableBufferPool(uint64_t maxBytes) {
+  if (_bufferPool) {
+    _bufferPool->setMaxBytes(maxBytes);
+    return;
+  }
+
+#ifdef EVENT__DISABLE_MM_REPLACEMENT
+  THROW("libevent not built with memory allocation replacement");
+
+#else
+  // Never freed, chains may be released as the process exits
+  _bufferPool = new BufferPool(maxBytes);
+  event_set_mem_functions(buffer_pool_malloc, buffer_pool_realloc,
+                          buffer_pool_free);
+
+  MemoryAccounting::instance().addSource
+    ("event.buffer_pool", [] () {return _bufferPool->getStats().slabBytes;});
+#endif
+}
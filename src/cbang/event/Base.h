@@ -33,24 +33,46 @@
 #pragma once
 
 #include "EventFlag.h"
+#include "DeferredPool.h"
 
 #include <cbang/SmartPointer.h>
 #include <cbang/socket/SocketType.h>
+#include <cbang/util/InlineFunction.h>
 
-#include <functional>
+#include <atomic>
 #include <map>
+#include <string>
 
 struct event_base;
 
 
 namespace cb {
+  namespace JSON {class ArenaPool;}
+
   namespace Event {
     class Event;
+    class IOUring;
+    class ConcurrentPool;
+    class TimerWheel;
+    class BufferPool;
+    class PostQueue;
 
     class Base : public EventFlag {
       static bool _threadsEnabled;
+      static BufferPool *_bufferPool;
 
       event_base *base;
+      SmartPointer<IOUring> ioURing;
+      SmartPointer<TimerWheel> timerWheel;
+      SmartPointer<DeferredPool> deferredPool;
+      std::atomic<PostQueue *> postQueue;
+      SmartPointer<JSON::ArenaPool> arenaPool;
+      SmartPointer<ConcurrentPool> cryptoPool;
+      unsigned cryptoThreads = 0;
+
+      uint64_t httpDateTime = 0;
+      std::string httpDate;
+      std::string httpDateHeader;
 
     public:
       template <class T> struct Callback {
@@ -58,14 +80,63 @@ namespace cb {
         typedef void (T::*bare_member_t)();
       };
 
-      typedef std::function<void (Event &, int, unsigned)> callback_t;
-      typedef std::function<void ()> bare_callback_t;
+      typedef InlineFunction<void ()> bare_callback_t;
+      /// Large enough to hold a wrapped bare_callback_t inline
+      typedef InlineFunction<void (Event &, int, unsigned), 64> callback_t;
 
-      Base(bool withThreads = false, int priorities = -1);
+      /**
+       * @param withIOURing also creates an IOUring for asynchronous file
+       * I/O, if the system supports it.  See hasIOURing().
+       */
+      Base(bool withThreads = false, int priorities = -1,
+           bool withIOURing = false);
       ~Base();
 
       struct event_base *getBase() const {return base;}
 
+      bool hasIOURing() const {return ioURing.isSet();}
+      IOUring &getIOURing() const;
+
+      /// Shared by connection timeouts and other coarse timers
+      TimerWheel &getTimerWheel();
+
+      DeferredPool &getDeferredPool();
+
+      /**
+       * Call @param f once, on this loop, after @param delay seconds.
+       * Unlike a one-shot newEvent() this allocates nothing once the pool
+       * has grown and @param f fits inline.  Cannot be canceled.  Must be
+       * called from the loop's thread.
+       */
+      template <typename F>
+      void defer(F &&f, double delay = 0)
+      {getDeferredPool().add(std::forward<F>(f), delay);}
+
+      /// Created on first use by any thread
+      PostQueue &getPostQueue();
+
+      /**
+       * Run @param cb on this loop.  May be called from any thread.  See
+       * PostQueue for the bounded variant.  Requires enableThreads().
+       */
+      void post(bare_callback_t cb);
+      /// @return false if a bounded PostQueue is full
+      bool tryPost(bare_callback_t cb);
+
+      /// Recycles the memory of per request JSON::Arenas
+      const SmartPointer<JSON::ArenaPool> &getArenaPool();
+
+      /**
+       * Run TLS handshakes, including their private key operations, on
+       * @param threads crypto threads so this loop keeps serving established
+       * connections.  Requires enableThreads().  Zero, the default, runs
+       * handshakes on the event loop.  May only be set once.
+       */
+      void setCryptoThreads(unsigned threads);
+      unsigned getCryptoThreads() const {return cryptoThreads;}
+      bool hasCryptoPool() const {return cryptoPool.isSet();}
+      ConcurrentPool &getCryptoPool() const;
+
       void initPriority(int num);
       int getNumPriorities() const;
       int getNumEvents() const;
@@ -80,28 +151,38 @@ namespace cb {
                                     unsigned flags = EVENT_PERSIST);
 
       // Bare Callbacks
-      callback_t bind(bare_callback_t cb)
-      {return [cb] (Event &, int, unsigned) {cb();};}
+      struct BareCallback {
+        bare_callback_t cb;
+        void operator()(Event &, int, unsigned) const {cb();}
+      };
+
+      callback_t bind(bare_callback_t cb) {return BareCallback{std::move(cb)};}
 
       SmartPointer<Event> newEvent(bare_callback_t cb,
                                    unsigned flags = EVENT_PERSIST)
-      {return newEvent(bind(cb), flags);}
+      {return newEvent(bind(std::move(cb)), flags);}
 
       SmartPointer<Event>
       newEvent(socket_t fd, bare_callback_t cb, unsigned flags = EVENT_PERSIST)
-        {return newEvent(fd, bind(cb), flags);}
+        {return newEvent(fd, bind(std::move(cb)), flags);}
 
       SmartPointer<Event> newSignal(int signal, bare_callback_t cb,
                                     unsigned flags = EVENT_PERSIST)
-      {return newSignal(signal, bind(cb), flags);}
+      {return newSignal(signal, bind(std::move(cb)), flags);}
 
 
       // Member Callbacks
+      template <class T> struct MemberCallback {
+        T *obj;
+        typename Callback<T>::member_t member;
+
+        void operator()(Event &e, int fd, unsigned flags) const
+        {(obj->*member)(e, fd, flags);}
+      };
+
       template <class T>
-      callback_t bind(T *obj, typename Callback<T>::member_t member) {
-        using namespace std::placeholders;
-        return std::bind(member, obj, _1, _2, _3);
-      }
+      callback_t bind(T *obj, typename Callback<T>::member_t member)
+      {return MemberCallback<T>{obj, member};}
 
       template <class T> SmartPointer<Event> newEvent
       (T *obj, typename Callback<T>::member_t member,
@@ -121,10 +202,16 @@ namespace cb {
 
 
       // Bare Member Callbacks
+      template <class T> struct BareMemberCallback {
+        T *obj;
+        typename Callback<T>::bare_member_t member;
+
+        void operator()(Event &, int, unsigned) const {(obj->*member)();}
+      };
+
       template <class T>
-      callback_t bind(T *obj, typename Callback<T>::bare_member_t member) {
-        return bind(std::bind(member, obj));
-      }
+      callback_t bind(T *obj, typename Callback<T>::bare_member_t member)
+      {return BareMemberCallback<T>{obj, member};}
 
       template <class T>
       SmartPointer<Event> newEvent
@@ -144,6 +231,21 @@ namespace cb {
       {return newSignal(signal, bind(obj, member), flags);}
 
 
+      /**
+       * @return The time, in seconds since 1970, cached by libevent when
+       * this loop last woke up.  Cheaper than Timer::now() for timestamps
+       * which need only about millisecond precision.
+       */
+      double getCachedTime() const;
+
+      /**
+       * @return The current time in HTTP Date header format.  Formatted at
+       * most once per second of getCachedTime().
+       */
+      const std::string &getHTTPDate();
+      /// @return "Date: " + getHTTPDate() + "\r\n"
+      const std::string &getHTTPDateHeader();
+
       void dispatch();
       void loop();
       void loopOnce();
@@ -154,6 +256,15 @@ namespace cb {
 
       static void enableThreads();
       static bool threadsEnabled() {return _threadsEnabled;}
+
+      /**
+       * Allocate libevent's buffer chains from a process wide BufferPool.
+       * Call before creating any Base so that all chains are pooled.
+       * @param maxBytes limits the pool's memory, zero for no limit.
+       */
+      static void enableBufferPool(uint64_t maxBytes = 0);
+      /// @return the pool or null if it is not enabled
+      static BufferPool *getBufferPool() {return _bufferPool;}
     };
   }
 }
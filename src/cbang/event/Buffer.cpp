@@ -35,6 +35,10 @@
 #include <cbang/Exception.h>
 #include <cbang/Catch.h>
 #include <cbang/String.h>
+#include <cbang/buffer/SliceBuffer.h>
+#include <cbang/net/Base64.h>
+#include <cbang/util/CRC32C.h>
+#include <cbang/util/XXH3.h>
 
 #include <event2/buffer.h>
 
@@ -45,6 +49,8 @@
 
 #ifdef _WIN32
 #include <io.h>
+#else
+#include <unistd.h>
 #endif
 
 using namespace std;
@@ -57,6 +63,20 @@ extern "C" {
 
 
 namespace {
+  // Shorter strings are cheaper to copy than to reference
+  const unsigned minRefLength = 4096;
+
+
+  void delete_string_cb(const void *data, size_t len, void *arg) {
+    delete (string *)arg;
+  }
+
+
+  void release_block_cb(const void *data, size_t len, void *arg) {
+    delete (cb::SliceBuffer::BlockPtr *)arg;
+  }
+
+
   void buffer_cb(struct evbuffer *buffer,
                  const struct evbuffer_cb_info *info, void *arg) {
     try {
@@ -84,6 +104,7 @@ Buffer::Buffer(const char *data, unsigned length) : Buffer() {
 
 Buffer::Buffer(const char *s) : Buffer() {add(s);}
 Buffer::Buffer(const string &s) : Buffer() {add(s);}
+Buffer::Buffer(string &&s) : Buffer() {add(move(s));}
 
 
 Buffer::~Buffer() {
@@ -201,6 +222,22 @@ unsigned Buffer::remove(Buffer &buf, unsigned length) {
 }
 
 
+unsigned Buffer::remove(cb::SliceBuffer &buf, unsigned length) {
+  // The slices keep the chains alive in a private buffer
+  cb::SmartPointer<Buffer>::Protected chains = new Buffer;
+  unsigned count = remove(*chains, length);
+
+  vector<iovec> space;
+  chains->peek(space);
+
+  for (unsigned i = 0; i < space.size(); i++)
+    buf.addRef((const char *)space[i].iov_base, space[i].iov_len,
+               [chains] () {});
+
+  return count;
+}
+
+
 unsigned Buffer::remove(ostream &stream, unsigned length) {
   unsigned total = 0;
   char buffer[4096];
@@ -236,6 +273,39 @@ void Buffer::peek(unsigned bytes, vector<iovec> &space) {
 }
 
 
+void Buffer::peek(vector<iovec> &space) const {
+  int n = evbuffer_peek(evb, -1, 0, 0, 0);
+  if (n < 0) THROW("Failed to peek");
+
+  space.resize(n);
+  if (n) evbuffer_peek(evb, -1, 0, &space[0], n);
+}
+
+
+uint32_t Buffer::getCRC32C() const {
+  vector<iovec> space;
+  peek(space);
+
+  CRC32C crc;
+  for (auto &v: space) crc.update(v.iov_base, v.iov_len);
+  return crc.get();
+}
+
+
+uint64_t Buffer::getXXH3() const {
+  vector<iovec> space;
+  peek(space);
+
+  // Contiguous buffers take the faster one-shot path
+  if (space.size() == 1)
+    return XXH3::compute(space[0].iov_base, space[0].iov_len);
+
+  XXH3 hash;
+  for (auto &v: space) hash.update(v.iov_base, v.iov_len);
+  return hash.get();
+}
+
+
 void Buffer::reserve(unsigned bytes, vector<iovec> &space) {
   int n = evbuffer_reserve_space(evb, bytes, &space[0], space.size());
   if (n < 0) THROW("Failed to reserve space");
@@ -252,12 +322,20 @@ void Buffer::commit(iovec &space) {evbuffer_commit_space(evb, &space, 1);}
 
 
 string Buffer::readLine(unsigned maxLength, eol_t eol) {
+  string line;
+  readLine(line, maxLength, eol);
+  return line;
+}
+
+
+bool Buffer::readLine(string &line, unsigned maxLength, eol_t eol) {
   // TODO Don't read more then maxLength
   size_t length = 0;
-  SmartPointer<char>::Malloc line =
+  SmartPointer<char>::Malloc s =
     evbuffer_readln(evb, &length, (evbuffer_eol_style)eol);
-  if (line.isNull()) return string();
-  return string(line.get(), length);
+  if (s.isNull()) return false;
+  line.assign(s.get(), length);
+  return true;
 }
 
 
@@ -272,6 +350,19 @@ void Buffer::addRef(const Buffer &buf) {
 }
 
 
+void Buffer::add(const cb::SliceBuffer &buf) {
+  for (auto it = buf.begin(); it != buf.end(); it++) {
+    auto ref = new cb::SliceBuffer::BlockPtr(it->block);
+
+    if (evbuffer_add_reference(evb, it->data(), it->length, release_block_cb,
+                               ref)) {
+      delete ref;
+      THROW("Buffer add reference failed");
+    }
+  }
+}
+
+
 void Buffer::add(const char *data, unsigned length) {
   if (evbuffer_add(evb, data, length)) THROW("Buffer add failed");
 }
@@ -281,18 +372,87 @@ void Buffer::add(const char *s) {add(s, strlen(s));}
 void Buffer::add(const string &s) {add(CBANG_CPP_TO_C_STR(s), s.length());}
 
 
-void Buffer::addFile(const string &path) {
+void Buffer::add(string &&s) {
+  if (s.length() < minRefLength) return add(s);
+
+  string *ref = new string(move(s));
+
+  if (evbuffer_add_reference(evb, ref->data(), ref->length(),
+                             delete_string_cb, ref)) {
+    delete ref;
+    THROW("Buffer add reference failed");
+  }
+}
+
+
+unsigned Buffer::add(istream &stream, unsigned length) {
+  vector<iovec> space(2);
+  reserve(length, space);
+
+  unsigned total = 0;
+  for (unsigned i = 0; i < space.size(); i++) {
+    unsigned bytes = min((unsigned)space[i].iov_len, length - total);
+
+    stream.read((char *)space[i].iov_base, bytes);
+    space[i].iov_len = stream.gcount();
+    total += space[i].iov_len;
+
+    if (space[i].iov_len < bytes || total == length) {
+      space.resize(i + 1);
+      break;
+    }
+  }
+
+  commit(space);
+
+  return total;
+}
+
+
+void Buffer::addFile(const string &path, uint64_t offset, int64_t length) {
   int fd = open(path.c_str(), O_RDONLY);
   if (fd == -1) THROW("Failed to open file " << path);
 
-  struct stat buf;
-  if (fstat(fd, &buf)) THROW("Failed to get file size " << path);
+  if (length < 0) {
+    struct stat buf;
+    if (fstat(fd, &buf)) {
+      ::close(fd);
+      THROW("Failed to get file size " << path);
+    }
+
+    length = offset < (uint64_t)buf.st_size ? buf.st_size - offset : 0;
+  }
 
-  if (evbuffer_add_file(evb, fd, 0, buf.st_size))
+  // Note, evbuffer_add_file() closes the file descriptor
+  if (evbuffer_add_file(evb, fd, offset, length))
     THROW("Failed to add file to buffer: " << path);
 }
 
 
+void Buffer::addBase64(const Base64 &codec, const char *data,
+                       unsigned length) {
+  // A single iovec is contiguous
+  iovec space;
+  if (evbuffer_reserve_space(evb, codec.getEncodedLength(length), &space, 1)
+      != 1) THROW("Failed to reserve space");
+
+  space.iov_len = codec.encode(data, length, (char *)space.iov_base);
+  commit(space);
+}
+
+
+void Buffer::addBase64Decoded(const Base64 &codec, const char *data,
+                              unsigned length) {
+  iovec space;
+  if (evbuffer_reserve_space(evb, codec.getMaxDecodedLength(length), &space,
+                             1) != 1) THROW("Failed to reserve space");
+
+  // Nothing is added if decoding throws
+  space.iov_len = codec.decode(data, length, (char *)space.iov_base);
+  commit(space);
+}
+
+
 void Buffer::prepend(const Buffer &buf) {
   if (evbuffer_prepend_buffer(evb, buf.getBuffer()))
     THROW("Prepend buffer failed");
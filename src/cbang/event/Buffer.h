@@ -35,7 +35,7 @@
 #include <cbang/socket/SocketType.h>
 
 #include <string>
-#include <ostream>
+#include <iostream>
 
 #include <functional>
 #include <vector>
@@ -53,6 +53,9 @@ struct iovec;
 
 
 namespace cb {
+  class SliceBuffer;
+  class Base64;
+
   namespace Event {
     class Buffer {
     public:
@@ -70,6 +73,7 @@ namespace cb {
       Buffer(const char *data, unsigned length);
       Buffer(const char *s);
       Buffer(const std::string &s);
+      Buffer(std::string &&s);
       ~Buffer();
 
       Buffer &operator=(const Buffer &o);
@@ -96,6 +100,8 @@ namespace cb {
       unsigned copy(std::ostream &stream);
       void drain(unsigned length);
       unsigned remove(Buffer &buf, unsigned length);
+      /// Move data to @param buf without copying it out of its chains
+      unsigned remove(SliceBuffer &buf, unsigned length);
       unsigned remove(char *data, unsigned length);
       unsigned remove(std::ostream &stream, unsigned length);
       unsigned remove(std::ostream &stream);
@@ -112,18 +118,38 @@ namespace cb {
       int write(socket_t fd, int size = -1);
 
       void peek(unsigned bytes, std::vector<iovec> &space);
+      /// Point @param space at every chunk of the buffer, without copying
+      void peek(std::vector<iovec> &space) const;
       void reserve(unsigned bytes, std::vector<iovec> &space);
+      /// Checksum the buffer's chunks in place, see cb::CRC32C
+      uint32_t getCRC32C() const;
+      /// Hash the buffer's chunks in place, see cb::XXH3
+      uint64_t getXXH3() const;
       void commit(std::vector<iovec> &space);
       void commit(iovec &space);
 
       std::string readLine(unsigned maxLength, eol_t eol = EOL_CRLF);
+      /// @return false if there is no complete line
+      bool readLine(std::string &line, unsigned maxLength,
+                    eol_t eol = EOL_CRLF);
 
       void add(const Buffer &buf);
       void addRef(const Buffer &buf);
+      /// Reference the slices of @param buf, without copying
+      void add(const SliceBuffer &buf);
       void add(const char *data, unsigned length);
       void add(const char *s);
       void add(const std::string &s);
-      void addFile(const std::string &path);
+      /// Large strings are moved into the buffer by reference, not copied.
+      void add(std::string &&s);
+      unsigned add(std::istream &stream, unsigned length);
+      void addFile(const std::string &path, uint64_t offset = 0,
+                   int64_t length = -1);
+      /// Add @param data Base64 encoded, without an intermediate string
+      void addBase64(const Base64 &codec, const char *data, unsigned length);
+      /// Add the bytes decoded from Base64 @param data
+      void addBase64Decoded(const Base64 &codec, const char *data,
+                            unsigned length);
 
       void prepend(const Buffer &buf);
       void prepend(const char *data, unsigned length);
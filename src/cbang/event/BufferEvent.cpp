@@ -34,6 +34,7 @@
 #include "Base.h"
 #include "Event.h"
 #include "DNSBase.h"
+#include "ConcurrentPool.h"
 
 #include <cbang/config.h>
 #include <cbang/Exception.h>
@@ -83,6 +84,50 @@ using namespace cb::Event;
 
 
 uint64_t BufferEvent::nextID = 0;
+std::atomic<uint64_t> BufferEvent::sslHandshakes(0);
+
+
+struct BufferEvent::HandshakeTask : public ConcurrentPool::Task {
+  SmartPointer<BufferEvent> bev;
+  SmartPointer<Socket> socket; // Keeps the fd open
+  int ret = 0;
+  int err = 0;
+  vector<int> errors;
+
+  HandshakeTask(BufferEvent *bev) :
+    Task(0), bev(bev), socket(bev->socket) {}
+
+
+  // From ConcurrentPool::Task
+  void run() {
+#ifdef HAVE_OPENSSL
+    // OpenSSL error queues are per thread
+    SSL::flushErrors();
+    ret = SSL_do_handshake(bev->ssl);
+    if (ret == 1) return;
+
+    err = SSL_get_error(bev->ssl, ret);
+    unsigned e;
+    while ((e = SSL::getError())) errors.push_back(e);
+#endif // HAVE_OPENSSL
+  }
+
+
+  void success() {bev->sslHandshakeDone(ret, err, errors);}
+
+
+  void error(const Exception &e) {
+    bev->sslOffloaded = false;
+    bev->scheduleErrorCB(BUFFEREVENT_READING | BUFFEREVENT_ERROR);
+  }
+
+
+  void complete() {
+    // Release on the event loop thread
+    bev.release();
+    socket.release();
+  }
+};
 
 
 BufferEvent::BufferEvent(cb::Event::Base &base, bool incoming,
@@ -91,10 +136,13 @@ BufferEvent::BufferEvent(cb::Event::Base &base, bool incoming,
   base(base) {
   LOG_DEBUG(4, __func__ << "()");
 
-  connectCBEvent = newEvent(&BufferEvent::connectCB);
-  writeCBEvent   = newEvent(&BufferEvent::writeCB);
-  readCBEvent    = newEvent(&BufferEvent::readCB);
-  errorCBEvent   = newEvent(&BufferEvent::errorCB);
+  // Idle timeouts, most are rescheduled long before firing
+  readTimer.setCallback([this] () {
+      scheduleErrorCB(BUFFEREVENT_READING | BUFFEREVENT_TIMEOUT);
+    });
+  writeTimer.setCallback([this] () {
+      scheduleErrorCB(BUFFEREVENT_WRITING | BUFFEREVENT_TIMEOUT);
+    });
 
   if (sslCtx.isNull()) {
     outputBuffer.setFlags(EVBUFFER_FLAG_DRAINS_TO_FD);
@@ -119,6 +167,9 @@ BufferEvent::BufferEvent(cb::Event::Base &base, bool incoming,
   }
 
   setSocket(socket);
+  inputBuffer.setCallback([this] (int added, int deleted, int orig) {
+                            inputBufferCB(added, deleted, orig);
+                          });
   outputBuffer.setCallback([this] (int added, int deleted, int orig) {
                              outputBufferCB(added, deleted, orig);
                            });
@@ -145,18 +196,50 @@ void BufferEvent::setSocket(const SmartPointer<Socket> &socket) {
 const SmartPointer<Socket> &BufferEvent::getSocket() const {return socket;}
 
 
+void BufferEvent::adopt(BufferEvent &o) {
+  LOG_DEBUG(4, __func__ << "(" << o.getID() << ")");
 
-int BufferEvent::getPriority() const {return readCBEvent->getPriority();}
+  if (!o.isReady()) THROW("Cannot adopt unconnected BufferEvent");
+  if (o.inputBuffer.getLength() || o.outputBuffer.getLength())
+    THROW("Cannot adopt BufferEvent with buffered data");
+
+  SmartPointer<Socket> socket = o.socket;
+  state_t state = o.state;
+
+#ifdef HAVE_OPENSSL
+  if (ssl) SSL_free(ssl);
+  ssl = o.ssl;
+  o.ssl = 0;
+#endif // HAVE_OPENSSL
+
+  o.close();
+
+  setSocket(socket); // Also rebinds the SSL BIO
+  this->state = state;
+  peerPort = o.peerPort;
+  sslWant = 0;
+  sslLastRead = sslLastWrite = 0;
+
+  updateEvents();
+}
+
+
+
+int BufferEvent::getPriority() const {return priority;}
 
 
 void BufferEvent::setPriority(int priority) {
+  this->priority = priority;
+
   if (readEvent.isSet()) readEvent->setPriority(priority);
   if (writeEvent.isSet()) writeEvent->setPriority(priority);
 
-  connectCBEvent->setPriority(priority);
-  writeCBEvent->setPriority(priority);
-  readCBEvent->setPriority(priority);
-  errorCBEvent->setPriority(priority);
+  SmartPointer<Event> *events[] = {
+    &connectCBEvent, &writeCBEvent, &readCBEvent, &writableCBEvent,
+    &errorCBEvent};
+
+  for (auto e: events)
+    if (e->isSet()) (*e)->setPriority(priority);
 }
 
 
@@ -172,6 +255,22 @@ cb::SSL BufferEvent::getSSL() const {return ssl;}
 #endif
 
 
+ssl_session_st *BufferEvent::getSSLSession() const {
+#ifdef HAVE_OPENSSL
+  if (ssl) return SSL_get1_session(ssl);
+#endif // HAVE_OPENSSL
+  return 0;
+}
+
+
+void BufferEvent::setSSLSession(ssl_session_st *session) {
+#ifdef HAVE_OPENSSL
+  if (ssl && session && !SSL_set_session(ssl, session))
+    LOG_WARNING("Failed to set SSL session: " << SSL::getErrorStr());
+#endif // HAVE_OPENSSL
+}
+
+
 void BufferEvent::logSSLErrors() {
 #ifdef HAVE_OPENSSL
   string errors = getSSLErrors();
@@ -205,6 +304,22 @@ void BufferEvent::setRead(bool enabled) {
 }
 
 
+void BufferEvent::setReadWatermarks(unsigned low, unsigned high) {
+  minRead = low;
+  readHighWater = high;
+  updateEvents();
+}
+
+
+void BufferEvent::setWriteWatermarks(unsigned low, unsigned high) {
+  if (high && high <= low) THROW("Write high watermark must exceed low");
+
+  writeLowWater = low;
+  writeHighWater = high;
+  outputBufferCB(0, 0, outputBuffer.getLength());
+}
+
+
 string BufferEvent::getEventsString(short events) {
   vector<string> parts;
 
@@ -219,20 +334,8 @@ string BufferEvent::getEventsString(short events) {
 
 
 void BufferEvent::close()  {
-  if (getFD() < 0) return;
-
-  readEvent.release();
-  writeEvent.release();
-
-  if (dnsReq.isSet()) {
-    dnsReq->cancel();
-    dnsReq.release();
-  }
-
-  socket.release();
-
-  state = STATE_IDLE;
-  enableRead = false;
+  cancelConnects();
+  closeSocket();
 }
 
 
@@ -242,8 +345,8 @@ void BufferEvent::connect(DNSBase &dns, const IPAddress &peer) {
   // Save peer port
   peerPort = peer.getPort();
 
-  // Skip DNS lookup if we already have an IP
-  if (peer.getIP()) {
+  // Skip DNS lookup if we already have an IP or a Unix socket
+  if (peer.isUnix() || peer.hasNumericIP()) {
     vector<IPAddress> ip;
     ip.push_back(peer);
     return dnsCB(0, ip);
@@ -268,25 +371,168 @@ void BufferEvent::dnsCB(int err, const vector<IPAddress> &addrs) {
 
   if (err || addrs.empty()) return scheduleErrorCB(BUFFEREVENT_ERROR);
 
-  // Make sure we have an open socket
-  if (socket.isNull()) socket = new Socket;
-  if (!socket->isOpen()) {
-    socket->open();
-    setFD(socket->get());
+  cancelConnects();
+  for (auto &addr: addrs)
+    connectAddrs.push_back
+      (addr.isUnix() ? addr : IPAddress(addr.getIP(), peerPort));
+
+  connectNext();
+}
+
+
+SmartPointer<Socket> BufferEvent::newSocket(const IPAddress &peer) {
+  SmartPointer<Socket> socket = new Socket;
+  if (peer.isUnix()) socket->openUnix();
+  else socket->open();
+  return socket;
+}
+
+
+void BufferEvent::closeSocket() {
+  readTimer.cancel();
+  writeTimer.cancel();
+
+  if (getFD() < 0) return;
+
+  readEvent.release();
+  writeEvent.release();
+
+  if (dnsReq.isSet()) {
+    dnsReq->cancel();
+    dnsReq.release();
   }
 
-  try {
-    IPAddress addr(addrs[0].getIP(), peerPort);
+  socket.release();
 
-    socket->setBlocking(false);
-    socket->connect(addr);
+  state = STATE_IDLE;
+  enableRead = false;
+}
+
+
+void BufferEvent::cancelConnects() {
+  for (auto &attempt: attempts) attempt.event->del();
+  attempts.clear();
+  connectAddrs.clear();
+  nextAddr = 0;
+  if (connectDelayEvent.isSet()) connectDelayEvent->del();
+}
+
+
+void BufferEvent::connectNext() {
+  // The first connect uses this BufferEvent's socket, later ones race it
+  while (nextAddr < connectAddrs.size()) {
+    const IPAddress &addr = connectAddrs[nextAddr++];
+    bool primary = state != STATE_SOCK_CONNECT;
+
+    try {
+      SmartPointer<Socket> socket = this->socket;
+
+      if (!primary || socket.isNull() || !socket->isOpen()) {
+        socket = newSocket(addr);
+        if (primary) setSocket(socket);
+      }
+
+      socket->setBlocking(false);
+      socket->connect(addr);
+
+      if (primary) {
+        state = STATE_SOCK_CONNECT;
+        updateEvents();
+
+      } else {
+        socket_t fd = socket->get();
+        auto cb = [this, fd] (Event &, int, unsigned) {attemptCB(fd);};
+        unsigned flags = EVENT_WRITE | EVENT_PERSIST | EVENT_NO_SELF_REF;
+
+        attempts.push_back(Attempt{socket, base.newEvent(fd, cb, flags)});
+        attempts.back().event->add();
+      }
+
+      LOG_DEBUG(4, __func__ << "() " << addr);
+      break;
+    } CATCH_WARNING;
+  }
+
+  if (state != STATE_SOCK_CONNECT && attempts.empty())
+    return scheduleErrorCB(BUFFEREVENT_ERROR);
+
+  // Stagger the remaining addresses
+  if (nextAddr < connectAddrs.size() && connectDelay) {
+    if (connectDelayEvent.isNull())
+      connectDelayEvent = base.newEvent
+        ([this] () {connectNext();}, EVENT_NO_SELF_REF);
+    connectDelayEvent->add(connectDelay);
+  }
+}
+
+
+bool BufferEvent::connectFailed(int err) {
+  if (attempts.empty() && connectAddrs.size() <= nextAddr) return false;
+
+  LOG_DEBUG(4, __func__ << "() " << SysError(err));
+
+  if (attempts.empty()) {
+    setSocket(0);
+    connectNext(); // Reports its own failure
+    return true;
+  }
+
+  // Continue with the oldest connect still in progress
+  SmartPointer<Socket> next = attempts.front().socket;
+  attempts.pop_front();
+
+  bool read = enableRead;
+  setSocket(next);
+  enableRead = read;
+  state = STATE_SOCK_CONNECT;
+
+  // Start the next address now rather than waiting for the delay
+  if (attempts.empty() && nextAddr < connectAddrs.size()) {
+    if (connectDelayEvent.isSet()) connectDelayEvent->del();
+    connectNext();
+  }
+
+  return true;
+}
+
+
+void BufferEvent::attemptCB(socket_t fd) {
+  SmartPointer<BufferEvent> self = this; // Don't deallocate during callback
+
+  auto it = attempts.begin();
+  while (it != attempts.end() && it->socket->get() != fd) it++;
+  if (it == attempts.end()) return;
+
+  int err = 0;
+  socklen_t elen = sizeof(err);
+
+  if (getsockopt(fd, SOL_SOCKET, SO_ERROR, (char *)&err, &elen) < 0)
+    err = SysError::get();
+  if (err && ERR_CONNECT_RETRIABLE(err)) return;
+
+  if (err) {
+    LOG_DEBUG(4, __func__ << "() " << SysError(err));
+    it->event->del();
+    attempts.erase(it);
+
+    if (attempts.empty() && nextAddr < connectAddrs.size()) {
+      if (connectDelayEvent.isSet()) connectDelayEvent->del();
+      connectNext();
+    }
 
-    state = STATE_SOCK_CONNECT;
-    updateEvents();
     return;
-  } CATCH_WARNING;
+  }
+
+  // This connect won the race, drop the others
+  SmartPointer<Socket> winner = it->socket;
+  bool read = enableRead;
+  cancelConnects();
+  setSocket(winner);
+  enableRead = read;
 
-  scheduleErrorCB(BUFFEREVENT_ERROR);
+  activate(connectCBEvent, &BufferEvent::connectCB);
+  state = ssl ? STATE_SSL_HANDSHAKE : STATE_SOCK_READY;
+  updateEvents();
 }
 
 
@@ -310,14 +556,21 @@ void BufferEvent::scheduleErrorCB(int flags, int err) {
   state = STATE_FAILED;
   pendingError = err ? err : SysError::get();
   pendingErrorFlags |= flags;
-  errorCBEvent->activate();
+  activate(errorCBEvent, &BufferEvent::errorCB);
 }
 
 
 void BufferEvent::scheduleReadCB() {
   if (inputBuffer.getLength() < minRead || state == STATE_FAILED) return;
   minRead = 0;
-  readCBEvent->activate();
+  activate(readCBEvent, &BufferEvent::readCB);
+}
+
+
+void BufferEvent::inputBufferCB(int added, int deleted, int orig) {
+  // Resume reading once the input drops below the high watermark
+  if (deleted && readHighWater && readHighWater <= (unsigned)orig &&
+      inputBuffer.getLength() < readHighWater) updateEvents();
 }
 
 
@@ -325,6 +578,15 @@ void BufferEvent::outputBufferCB(int added, int deleted, int orig) {
   LOG_DEBUG(4, __func__
             << "(" << added << ", " << deleted << ", " << orig << ")");
   if (added) updateEvents();
+
+  // Full from the high watermark until drained to the low watermark
+  unsigned length = outputBuffer.getLength();
+  bool full = writeHighWater &&
+    (writeFull ? writeLowWater < length : writeHighWater <= length);
+
+  if (writeFull && !full)
+    activate(writableCBEvent, &BufferEvent::writableCB);
+  writeFull = full;
 }
 
 
@@ -361,11 +623,12 @@ void BufferEvent::sockConnect() {
     return scheduleErrorCB(BUFFEREVENT_ERROR);
 
   if (err) {
-    if (ERR_CONNECT_RETRIABLE(err)) return;
+    if (ERR_CONNECT_RETRIABLE(err) || connectFailed(err)) return;
     return scheduleErrorCB(BUFFEREVENT_ERROR, err);
   }
 
-  connectCBEvent->activate();
+  cancelConnects();
+  activate(connectCBEvent, &BufferEvent::connectCB);
   state = ssl ? STATE_SSL_HANDSHAKE : STATE_SOCK_READY;
 }
 
@@ -391,7 +654,8 @@ void BufferEvent::sockWrite() {
   sent(ret);
 
   // Invoke the user callback if buffer drained
-  if (!outputBuffer.getLength()) writeCBEvent->activate();
+  if (!outputBuffer.getLength())
+    activate(writeCBEvent, &BufferEvent::writeCB);
 }
 
 
@@ -459,12 +723,16 @@ void BufferEvent::sslClosed(unsigned when, int code, int ret) {
 #ifdef HAVE_OPENSSL
   LOG_DEBUG(4, __func__ << "(" << when << ", " << code << ", " << ret << ")");
 
+  // Save SSL errors
+  unsigned err;
+  while ((err = SSL::getError())) sslErrors.push_back(err);
+
   unsigned event = BUFFEREVENT_ERROR;
 
   switch (code) {
   case SSL_ERROR_ZERO_RETURN: event = BUFFEREVENT_EOF; break;
   case SSL_ERROR_SYSCALL: // IO error; possible dirty shutdown
-    if (!ret && !SSL::peekError()) event = BUFFEREVENT_EOF;
+    if (!ret && sslErrors.empty()) event = BUFFEREVENT_EOF;
     break;
 
   case SSL_ERROR_SSL: break; // Protocol error
@@ -473,10 +741,6 @@ void BufferEvent::sslClosed(unsigned when, int code, int ret) {
     break;
   }
 
-  // Save SSL errors
-  unsigned err;
-  while ((err = SSL::getError())) sslErrors.push_back(err);
-
   // when is BUFFEREVENT_{READING|WRITING}
   scheduleErrorCB(event | when);
 #endif // HAVE_OPENSSL
@@ -485,8 +749,13 @@ void BufferEvent::sslClosed(unsigned when, int code, int ret) {
 
 void BufferEvent::sslError(unsigned event, int ret) {
 #ifdef HAVE_OPENSSL
-  int err = SSL_get_error(ssl, ret);
+  sslError(event, ret, SSL_get_error(ssl, ret));
+#endif // HAVE_OPENSSL
+}
+
 
+void BufferEvent::sslError(unsigned event, int ret, int err) {
+#ifdef HAVE_OPENSSL
   LOG_DEBUG(4, __func__ << "(" << getEventsString(event) << ", " << ret
             << ") err=" << err);
 
@@ -588,8 +857,9 @@ void BufferEvent::sslWrite() {
 
   if (bytesWritten) {
     outputBuffer.drain(bytesWritten);
-    if (!outputBuffer.getLength() && !errorCBEvent->isPending())
-      writeCBEvent->activate();
+    bool errorPending = errorCBEvent.isSet() && errorCBEvent->isPending();
+    if (!outputBuffer.getLength() && !errorPending)
+      activate(writeCBEvent, &BufferEvent::writeCB);
   }
 #endif // HAVE_OPENSSL
 }
@@ -600,17 +870,47 @@ void BufferEvent::sslHandshake() {
   LOG_DEBUG(4, __func__ << "()");
 
   sslWant = 0;
-  int ret = SSL_do_handshake(ssl);
 
-  if (ret == 1) {
-    LOG_DEBUG(4, "SSL Handshake complete");
-    state = STATE_SSL_READY;
+  if (base.hasCryptoPool()) {
+    if (!sslOffloaded) {
+      sslOffloaded = true;
+      base.getCryptoPool().submit(new HandshakeTask(this));
+    }
 
-  } else sslError(BUFFEREVENT_READING, ret);
+    return;
+  }
+
+  int ret = SSL_do_handshake(ssl);
+
+  if (ret == 1) sslReady();
+  else sslError(BUFFEREVENT_READING, ret);
 #endif // HAVE_OPENSSL
 }
 
 
+void BufferEvent::sslReady() {
+  LOG_DEBUG(4, "SSL Handshake complete");
+  state = STATE_SSL_READY;
+  sslHandshakes++;
+}
+
+
+void BufferEvent::sslHandshakeDone(int ret, int err,
+                                   const vector<int> &errors) {
+  LOG_DEBUG(4, __func__ << "(" << ret << ", " << err << ")");
+
+  sslOffloaded = false;
+  if (state != STATE_SSL_HANDSHAKE) return; // Closed or failed meanwhile
+
+  sslErrors.insert(sslErrors.end(), errors.begin(), errors.end());
+
+  if (ret == 1) sslReady();
+  else sslError(BUFFEREVENT_READING, ret, err);
+
+  updateEvents();
+}
+
+
 socket_t BufferEvent::getFD() const {
   return socket.isNull() ? -1 : socket->get();
 }
@@ -619,7 +919,7 @@ socket_t BufferEvent::getFD() const {
 void BufferEvent::setFD(socket_t fd) {
   int priority = getPriority();
 
-  close();
+  closeSocket();
 
   readEvent  = newEvent(fd, EVENT_READ,  priority, &BufferEvent::sockReadCB);
   writeEvent = newEvent(fd, EVENT_WRITE, priority, &BufferEvent::sockWriteCB);
@@ -639,17 +939,30 @@ void BufferEvent::setFD(socket_t fd) {
 
 
 void BufferEvent::enableEvents(unsigned events) {
-  if ((events & EVENT_READ) && readEvent.isSet() && !readEvent->isPending())
-    readEvent->add(readTimeout);
+  if ((events & EVENT_READ) && readEvent.isSet() && !readEvent->isPending()) {
+    readEvent->add();
+    if (readTimeout) readTimer.schedule(base.getTimerWheel(), readTimeout);
+  }
 
-  if ((events & EVENT_WRITE) && writeEvent.isSet() && !writeEvent->isPending())
-    writeEvent->add(writeTimeout);
+  if ((events & EVENT_WRITE) && writeEvent.isSet() &&
+      !writeEvent->isPending()) {
+    writeEvent->add();
+    if (writeTimeout)
+      writeTimer.schedule(base.getTimerWheel(), writeTimeout);
+  }
 }
 
 
 void BufferEvent::disableEvents(unsigned events) {
-  if ((events & EVENT_READ) && readEvent.isSet()) readEvent->del();
-  if ((events & EVENT_WRITE) && writeEvent.isSet()) writeEvent->del();
+  if (events & EVENT_READ) {
+    if (readEvent.isSet()) readEvent->del();
+    readTimer.cancel();
+  }
+
+  if (events & EVENT_WRITE) {
+    if (writeEvent.isSet()) writeEvent->del();
+    writeTimer.cancel();
+  }
 }
 
 
@@ -678,7 +991,12 @@ void BufferEvent::updateEvents() {
   case STATE_SOCK_CONNECT:  enableEvents(EVENT_WRITE); break;
 
   case STATE_SSL_HANDSHAKE:
-    if (sslWant) updateEventsSSLWant();
+    if (sslOffloaded) {
+      // Leave the socket to the crypto thread, idle timers keep running
+      if (readEvent.isSet()) readEvent->del();
+      if (writeEvent.isSet()) writeEvent->del();
+
+    } else if (sslWant) updateEventsSSLWant();
     else enableEvents();
     break;
 
@@ -690,7 +1008,9 @@ void BufferEvent::updateEvents() {
     if (outputBuffer.getLength()) enableEvents(EVENT_WRITE);
     else disableEvents(EVENT_WRITE);
 
-    if (enableRead) enableEvents(EVENT_READ);
+    if (enableRead && (!readHighWater ||
+                       inputBuffer.getLength() < readHighWater))
+      enableEvents(EVENT_READ);
     else disableEvents(EVENT_READ);
     break;
   }
@@ -729,3 +1049,14 @@ BufferEvent::newEvent(void (BufferEvent::*member)()) {
   auto e = base.newEvent(cb, EVENT_PERSIST | EVENT_NO_SELF_REF);
   return e;
 }
+
+
+void BufferEvent::activate(SmartPointer<Event> &e,
+                           void (BufferEvent::*member)()) {
+  if (e.isNull()) {
+    e = newEvent(member);
+    if (0 <= priority) e->setPriority(priority);
+  }
+
+  e->activate();
+}
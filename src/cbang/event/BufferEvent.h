@@ -34,13 +34,19 @@
 
 #include "EventFlag.h"
 #include "Buffer.h"
+#include "TimerWheel.h"
 
 #include <cbang/SmartPointer.h>
+#include <cbang/net/IPAddress.h>
 #include <cbang/socket/SocketType.h>
 
 #include <string>
+#include <vector>
+#include <list>
+#include <atomic>
 
 struct ssl_st;
+struct ssl_session_st;
 
 
 namespace cb {
@@ -59,6 +65,7 @@ namespace cb {
       Base &base;
 
       static uint64_t nextID;
+      static std::atomic<uint64_t> sslHandshakes;
       uint64_t id = ++nextID;
 
       SmartPointer<Socket> socket;
@@ -69,16 +76,36 @@ namespace cb {
       SmartPointer<Event> readEvent;
       SmartPointer<Event> writeEvent;
 
+      // Callback events are created on first use, most are never needed
+      int priority = -1;
       SmartPointer<Event> connectCBEvent;
       SmartPointer<Event> writeCBEvent;
       SmartPointer<Event> readCBEvent;
+      SmartPointer<Event> writableCBEvent;
       SmartPointer<Event> errorCBEvent;
       SmartPointer<DNSRequest> dnsReq;
 
+      struct Attempt {
+        SmartPointer<Socket> socket;
+        SmartPointer<Event> event;
+      };
+
+      std::list<Attempt> attempts;
+      std::vector<IPAddress> connectAddrs;
+      unsigned nextAddr = 0;
+      double connectDelay = 0.25;
+      SmartPointer<Event> connectDelayEvent;
+
       unsigned readTimeout = 50;
       unsigned writeTimeout = 50;
+      TimerWheel::Timer readTimer;
+      TimerWheel::Timer writeTimer;
 
       unsigned minRead = 0;
+      unsigned readHighWater = 0;
+      unsigned writeLowWater = 0;
+      unsigned writeHighWater = 0;
+      bool writeFull = false;
 
       typedef enum {
         STATE_FAILED,
@@ -93,6 +120,7 @@ namespace cb {
       state_t state;
       int peerPort = 0;
       int sslWant = 0;
+      bool sslOffloaded = false; // Handshake running in the crypto pool
       bool enableRead = false;
 
       ssl_st *ssl = 0;
@@ -131,17 +159,60 @@ namespace cb {
       int getPriority() const;
       void setPriority(int priority);
 
+      /// In seconds, zero disables the timeout
       void setTimeouts(unsigned read, unsigned write);
 
+      bool isReady() const
+      {return state == STATE_SOCK_READY || state == STATE_SSL_READY;}
+
+      /// Take over the connected socket and SSL state of another BufferEvent
+      void adopt(BufferEvent &o);
+
       bool hasSSL() const {return ssl;}
       SSL getSSL() const;
+
+      /// Returns a new reference which the caller must free
+      ssl_session_st *getSSLSession() const;
+      /// Resume a previous session, must be called before connecting
+      void setSSLSession(ssl_session_st *session);
       void logSSLErrors();
       std::string getSSLErrors();
 
       void setRead(bool enable);
       void setMinRead(unsigned bytes) {minRead = bytes;}
 
+      /**
+       * Stop reading from the socket while the input buffer holds
+       * @param high or more bytes and resume once it has been drained
+       * below.  Zero disables the limit.  @param low sets the minimum
+       * input, see setMinRead().
+       */
+      void setReadWatermarks(unsigned low, unsigned high);
+      unsigned getReadHighWater() const {return readHighWater;}
+
+      /**
+       * Once the output buffer reaches @param high bytes isWritable()
+       * returns false until it drains to @param low bytes, at which
+       * point writableCB() is called.  Zero @param high disables the
+       * limit.
+       */
+      void setWriteWatermarks(unsigned low, unsigned high);
+      unsigned getWriteLowWater() const {return writeLowWater;}
+      unsigned getWriteHighWater() const {return writeHighWater;}
+      bool isWritable() const {return !writeFull;}
+
+      /**
+       * When the peer resolves to several addresses a connect to the next
+       * is started after @param delay seconds, or as soon as the previous
+       * fails, and the first to succeed is used.  With zero each address is
+       * only tried after the previous fails.
+       */
+      void setConnectDelay(double delay) {connectDelay = delay;}
+      double getConnectDelay() const {return connectDelay;}
+
       static std::string getEventsString(short events);
+      /// @return The number of SSL handshakes completed by all BufferEvents
+      static uint64_t getSSLHandshakeCount() {return sslHandshakes;}
 
       void close();
       void connect(DNSBase &dns, const IPAddress &peer);
@@ -149,18 +220,30 @@ namespace cb {
       virtual void connectCB() {}
       virtual void readCB() {}
       virtual void writeCB() {}
+      /// Output drained to the low watermark after reaching high water
+      virtual void writableCB() {}
       virtual void errorCB(short what, int err) {}
 
       void dnsCB(int err, const std::vector<IPAddress> &addrs);
 
     protected:
+      /// Open, but do not connect, a socket for @param peer
+      virtual SmartPointer<Socket> newSocket(const IPAddress &peer);
+
       virtual void received(unsigned bytes) {}
       virtual void sent(unsigned bytes) {}
 
     private:
+      void closeSocket();
+      void cancelConnects();
+      void connectNext();
+      bool connectFailed(int err);
+      void attemptCB(socket_t fd);
+
       void errorCB();
       void scheduleErrorCB(int flags, int err = 0);
       void scheduleReadCB();
+      void inputBufferCB(int added, int deleted, int orig);
       void outputBufferCB(int added, int deleted, int orig);
 
       void sockRead();
@@ -172,9 +255,14 @@ namespace cb {
 
       void sslClosed(unsigned when, int errcode, int ret);
       void sslError(unsigned event, int ret);
+      void sslError(unsigned event, int ret, int err);
       void sslRead();
       void sslWrite();
       void sslHandshake();
+      void sslReady();
+
+      struct HandshakeTask;
+      void sslHandshakeDone(int ret, int err, const std::vector<int> &errors);
 
       socket_t getFD() const;
       void setFD(socket_t fd);
@@ -188,6 +276,7 @@ namespace cb {
       SmartPointer<Event> newEvent(socket_t fd, unsigned event, int priority,
                                    void (BufferEvent::*member)(unsigned));
       SmartPointer<Event> newEvent(void (BufferEvent::*member)());
+      void activate(SmartPointer<Event> &e, void (BufferEvent::*member)());
     };
   }
 }
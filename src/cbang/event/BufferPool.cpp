@@ -0,0 +1,197 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "BufferPool.h"
+
+#include <cbang/util/SmartLock.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+namespace {
+  void *slabAlloc() {
+#ifdef _WIN32
+    return _aligned_malloc(BufferPool::SLAB_SIZE, BufferPool::SLAB_SIZE);
+#else
+    void *ptr;
+    if (posix_memalign(&ptr, BufferPool::SLAB_SIZE, BufferPool::SLAB_SIZE))
+      return 0;
+    return ptr;
+#endif
+  }
+
+
+  void slabFree(void *ptr) {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+  }
+}
+
+
+BufferPool::BufferPool(uint64_t maxBytes) : maxBytes(maxBytes) {
+  for (size_t size = MIN_BLOCK_SIZE; size <= MAX_BLOCK_SIZE; size <<= 1) {
+    SizeClass c;
+    c.size = size;
+    classes.push_back(c);
+  }
+}
+
+
+BufferPool::~BufferPool() {
+  for (auto it = slabs.begin(); it != slabs.end(); it++)
+    slabFree((void *)it->first);
+}
+
+
+void BufferPool::setMaxBytes(uint64_t maxBytes) {
+  SmartLock guard(&lock);
+  this->maxBytes = maxBytes;
+}
+
+
+BufferPool::Stats BufferPool::getStats() const {
+  SmartLock guard(&lock);
+  return stats;
+}
+
+
+void *BufferPool::allocate(size_t size) {
+  int index = getClass(size);
+
+  if (index < 0) {
+    {
+      SmartLock guard(&lock);
+      stats.heapAllocs++;
+    }
+
+    return malloc(size);
+  }
+
+  SmartLock guard(&lock);
+  SizeClass &c = classes[index];
+
+  if (c.idle.empty() && !addSlab(c, index)) {
+    stats.failures++;
+    return 0;
+  }
+
+  char *block = c.idle.back();
+  c.idle.pop_back();
+  stats.usedBytes += c.size;
+  stats.allocs++;
+
+  return block;
+}
+
+
+void *BufferPool::reallocate(void *ptr, size_t size) {
+  if (!ptr) return allocate(size);
+
+  int index = findClass(ptr);
+  if (index < 0) return realloc(ptr, size); // Never moved into the pool
+
+  size_t oldSize = classes[index].size;
+  if (size <= oldSize && oldSize < 2 * size) return ptr;
+
+  void *newPtr = allocate(size);
+  if (!newPtr) return 0;
+
+  memcpy(newPtr, ptr, oldSize < size ? oldSize : size);
+  release(ptr);
+
+  return newPtr;
+}
+
+
+void BufferPool::release(void *ptr) {
+  if (!ptr) return;
+
+  int index = findClass(ptr);
+  if (index < 0) {
+    free(ptr);
+    return;
+  }
+
+  SmartLock guard(&lock);
+  SizeClass &c = classes[index];
+  c.idle.push_back((char *)ptr);
+  stats.usedBytes -= c.size;
+}
+
+
+int BufferPool::getClass(size_t size) const {
+  if (size < MIN_BLOCK_SIZE || MAX_BLOCK_SIZE < size) return -1;
+
+  for (unsigned i = 0; i < classes.size(); i++)
+    if (size <= classes[i].size) return i;
+
+  return -1;
+}
+
+
+int BufferPool::findClass(void *ptr) const {
+  uintptr_t slab = (uintptr_t)ptr & ~(uintptr_t)(SLAB_SIZE - 1);
+
+  SmartLock guard(&lock);
+  auto it = slabs.find(slab);
+  return it == slabs.end() ? -1 : (int)it->second;
+}
+
+
+bool BufferPool::addSlab(SizeClass &c, unsigned index) {
+  if (maxBytes && maxBytes < stats.slabBytes + SLAB_SIZE) return false;
+
+  char *slab = (char *)slabAlloc();
+  if (!slab) return false;
+
+  slabs[(uintptr_t)slab] = index;
+  stats.slabBytes += SLAB_SIZE;
+
+  for (size_t offset = SLAB_SIZE; offset;) {
+    offset -= c.size;
+    c.idle.push_back(slab + offset);
+  }
+
+  return true;
+}
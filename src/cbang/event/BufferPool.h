@@ -0,0 +1,107 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/os/SpinLock.h>
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+
+namespace cb {
+  namespace Event {
+    /**
+     * A slab allocator for libevent's buffer chains.  libevent sizes chains
+     * in powers of two, so chains of 1 KiB to 64 KiB are carved from large
+     * aligned slabs with one free list per size and reused rather than
+     * returned to the heap.  Other libevent allocations pass through to
+     * malloc().
+     *
+     * Once installed with Base::enableBufferPool() the pool serves every
+     * Event::Buffer in the process and is never freed.  Memory may be
+     * released from any thread.
+     */
+    class BufferPool {
+    public:
+      static const size_t MIN_BLOCK_SIZE = 1 << 10;
+      static const size_t MAX_BLOCK_SIZE = 1 << 16;
+      static const size_t SLAB_SIZE = 1 << 20;
+
+      struct Stats {
+        uint64_t slabBytes = 0;  ///< Memory held in slabs
+        uint64_t usedBytes = 0;  ///< Slab memory in use by chains
+        uint64_t allocs = 0;     ///< Blocks served from the pool
+        uint64_t heapAllocs = 0; ///< Allocations passed to malloc()
+        uint64_t failures = 0;   ///< Blocks refused because of the limit
+      };
+
+    protected:
+      struct SizeClass {
+        size_t size;
+        std::vector<char *> idle;
+      };
+
+      uint64_t maxBytes;
+
+      SpinLock lock;
+      std::vector<SizeClass> classes;
+      std::unordered_map<uintptr_t, unsigned> slabs;
+      Stats stats;
+
+    public:
+      /// @param maxBytes limits the slab memory, zero for no limit.
+      BufferPool(uint64_t maxBytes = 0);
+      ~BufferPool();
+
+      uint64_t getMaxBytes() const {return maxBytes;}
+      /**
+       * When the limit is reached chain allocations fail, and with them
+       * the Event::Buffer operations which need more space.
+       */
+      void setMaxBytes(uint64_t maxBytes);
+
+      Stats getStats() const;
+
+      void *allocate(size_t size);
+      void *reallocate(void *ptr, size_t size);
+      void release(void *ptr);
+
+    protected:
+      int getClass(size_t size) const;
+      int findClass(void *ptr) const;
+      bool addSlab(SizeClass &c, unsigned index);
+    };
+  }
+}
@@ -32,6 +32,7 @@
 
 #include "Client.h"
 #include "Buffer.h"
+#include "ConnectionPool.h"
 
 #include <cbang/config.h>
 #include <cbang/openssl/SSLContext.h>
@@ -42,12 +43,13 @@ using namespace cb::Event;
 
 
 Client::Client(cb::Event::Base &base, DNSBase &dns) :
-  base(base), dns(dns), priority(-1) {}
+  base(base), dns(dns), pool(new ConnectionPool(base)), priority(-1) {}
 
 
 Client::Client(cb::Event::Base &base, DNSBase &dns,
                const SmartPointer<SSLContext> &sslCtx) :
-  base(base), dns(dns), sslCtx(sslCtx), priority(-1) {}
+  base(base), dns(dns), sslCtx(sslCtx), pool(new ConnectionPool(base)),
+  priority(-1) {}
 
 
 Client::~Client() {}
@@ -57,7 +59,7 @@ SmartPointer<OutgoingRequest>
 Client::call(const URI &uri, RequestMethod method, const char *data,
              unsigned length, callback_t cb) {
   SmartPointer<OutgoingRequest> req =
-    new OutgoingRequest(*this, uri, method, cb);
+    new OutgoingRequest(*this, uri, method, std::move(cb));
 
   if (data) req->getOutputBuffer().add(data, length);
   if (0 <= priority) req->setPriority(priority);
@@ -69,11 +71,19 @@ Client::call(const URI &uri, RequestMethod method, const char *data,
 
 SmartPointer<OutgoingRequest> Client::call
 (const URI &uri, RequestMethod method, const string &data, callback_t cb) {
-  return call(uri, method, CPP_TO_C_STR(data), data.length(), cb);
+  return call(uri, method, CPP_TO_C_STR(data), data.length(), std::move(cb));
+}
+
+
+SmartPointer<OutgoingRequest> Client::call
+(const URI &uri, RequestMethod method, string &&data, callback_t cb) {
+  SmartPointer<OutgoingRequest> req = call(uri, method, 0, 0, std::move(cb));
+  req->getOutputBuffer().add(move(data));
+  return req;
 }
 
 
 SmartPointer<OutgoingRequest>
 Client::call(const URI &uri, RequestMethod method, callback_t cb) {
-  return call(uri, method, 0, 0, cb);
+  return call(uri, method, 0, 0, std::move(cb));
 }
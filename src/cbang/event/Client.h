@@ -35,6 +35,7 @@
 #include "OutgoingRequest.h"
 
 #include <cbang/SmartPointer.h>
+#include <cbang/socket/SocketOptions.h>
 
 #include <map>
 #include <functional>
@@ -47,11 +48,14 @@ namespace cb {
   namespace Event {
     class Base;
     class DNSBase;
+    class ConnectionPool;
 
     class Client {
       Base &base;
       DNSBase &dns;
       SmartPointer<SSLContext> sslCtx;
+      SmartPointer<ConnectionPool> pool;
+      SocketOptions socketOptions;
       int priority;
 
     public:
@@ -68,10 +72,14 @@ namespace cb {
       Base &getBase() {return base;}
       DNSBase &getDNS() {return dns;}
       const cb::SmartPointer<SSLContext> &getSSLContext() const {return sslCtx;}
+      const SmartPointer<ConnectionPool> &getPool() const {return pool;}
 
       int getPriority() const {return priority;}
       void setPriority(int priority) {this->priority = priority;}
 
+      const SocketOptions &getSocketOptions() const {return socketOptions;}
+      void setSocketOptions(const SocketOptions &x) {socketOptions = x;}
+
       SmartPointer<OutgoingRequest>
       call(const URI &uri, RequestMethod method, const char *data,
            unsigned length, callback_t cb);
@@ -80,15 +88,25 @@ namespace cb {
       call(const URI &uri, RequestMethod method, const std::string &data,
            callback_t cb);
 
+      /// Large @param data is moved into the request rather than copied.
+      SmartPointer<OutgoingRequest>
+      call(const URI &uri, RequestMethod method, std::string &&data,
+           callback_t cb);
+
       SmartPointer<OutgoingRequest>
       call(const URI &uri, RequestMethod method, callback_t cb);
 
 
       // Member callbacks
+      template <class T> struct MemberCallback {
+        T *obj;
+        typename Callback<T>::member_t member;
+        void operator()(Request &req) const {(obj->*member)(req);}
+      };
+
       template <class T>
-      callback_t bind(T *obj, typename Callback<T>::member_t member) {
-        return std::bind(member, obj, std::placeholders::_1);
-      }
+      callback_t bind(T *obj, typename Callback<T>::member_t member)
+      {return MemberCallback<T>{obj, member};}
 
       template <class T> SmartPointer<OutgoingRequest>
       call(const URI &uri, RequestMethod method, const char *data,
@@ -100,6 +118,11 @@ namespace cb {
            T *obj, typename Callback<T>::member_t member)
       {return call(uri, method, data, bind(obj, member));}
 
+      template <class T> SmartPointer<OutgoingRequest>
+      call(const URI &uri, RequestMethod method, std::string &&data,
+           T *obj, typename Callback<T>::member_t member)
+      {return call(uri, method, std::move(data), bind(obj, member));}
+
       template <class T> SmartPointer<OutgoingRequest>
       call(const URI &uri, RequestMethod method,
            T *obj, typename Callback<T>::member_t member)
@@ -50,6 +50,8 @@ ConcurrentPool::ConcurrentPool(cb::Event::Base &base, unsigned size) :
   if (!Base::threadsEnabled())
     THROW("Cannot use Event::ConcurrentPool without threads enabled.  "
           "Call Event::Base::enableThreads() before creating Event::Base.");
+
+  setProfileName("ConcurrentPool");
 }
 
 
@@ -74,6 +76,60 @@ unsigned ConcurrentPool::getNumCompleted() const {
 }
 
 
+void ConcurrentPool::setMaxBatchSize(unsigned size) {
+  SmartLock lock(this);
+  maxBatchSize = size;
+}
+
+
+unsigned ConcurrentPool::getMaxBatchSize() const {
+  SmartLock lock(this);
+  return maxBatchSize;
+}
+
+
+void ConcurrentPool::setBatchLatency(double latency) {
+  SmartLock lock(this);
+  batchLatency = latency;
+}
+
+
+double ConcurrentPool::getBatchLatency() const {
+  SmartLock lock(this);
+  return batchLatency;
+}
+
+
+uint64_t ConcurrentPool::getNumBatches() const {
+  SmartLock lock(this);
+  return numBatches;
+}
+
+
+uint64_t ConcurrentPool::getNumBatchedTasks() const {
+  SmartLock lock(this);
+  return numBatchedTasks;
+}
+
+
+unsigned ConcurrentPool::getLastBatchSize() const {
+  SmartLock lock(this);
+  return lastBatchSize;
+}
+
+
+unsigned ConcurrentPool::getLargestBatchSize() const {
+  SmartLock lock(this);
+  return largestBatchSize;
+}
+
+
+double ConcurrentPool::getAverageBatchSize() const {
+  SmartLock lock(this);
+  return numBatches ? (double)numBatchedTasks / numBatches : 0;
+}
+
+
 void ConcurrentPool::submit(const SmartPointer<Task> &task) {
   SmartLock lock(this);
   ready.push(task);
@@ -126,27 +182,59 @@ void ConcurrentPool::run() {
 
     // Put Task in completed queue
     completed.push(task);
-    if (!event->isPending()) event->activate();
+    notify();
     active--;
   }
 }
 
 
+void ConcurrentPool::notify() {
+  // Lock must be held
+  bool full = maxBatchSize && maxBatchSize <= completed.size();
+
+  if (full || !batchLatency) {
+    if (full || !event->isPending()) event->activate();
+
+  } else if (!event->isPending()) event->add(batchLatency);
+}
+
+
 void ConcurrentPool::complete() {
-  SmartLock lock(this);
+  vector<SmartPointer<Task> > batch;
+
+  {
+    SmartLock lock(this);
+
+    // Dequeue a batch of completed tasks
+    while (!completed.empty() &&
+           (!maxBatchSize || batch.size() < maxBatchSize)) {
+      batch.push_back(completed.top());
+      completed.pop();
+    }
+
+    if (batch.empty()) return;
+
+    numBatches++;
+    numBatchedTasks += batch.size();
+    lastBatchSize = batch.size();
+    if (largestBatchSize < lastBatchSize) largestBatchSize = lastBatchSize;
 
-  // Dequeue completed tasks
-  while (!completed.empty()) {
-    SmartPointer<Task> task = completed.top();
-    completed.pop();
+    // Deliver the rest on the next loop iteration
+    if (!completed.empty()) event->activate();
+  }
 
-    SmartUnlock unlock(this);
+  for (unsigned i = 0; i < batch.size(); i++) {
+    Task &task = *batch[i];
 
     try {
-      if (task->getFailed()) task->error(task->getException());
-      else task->success();
+      if (task.getFailed()) task.error(task.getException());
+      else task.success();
     } CATCH_ERROR;
 
-    try {task->complete();} CATCH_ERROR;
+    try {task.complete();} CATCH_ERROR;
   }
+
+  // Release Tasks under lock, their reference counters are not thread safe
+  SmartLock lock(this);
+  batch.clear();
 }
@@ -40,6 +40,7 @@
 #include <cbang/util/SmartLock.h>
 #include <cbang/util/SmartUnlock.h>
 #include <cbang/time/Time.h>
+#include <cbang/util/InlineFunction.h>
 
 #include <queue>
 #include <functional>
@@ -77,13 +78,15 @@ namespace cb {
 
 
       template <typename Data>
-      struct QueuedTask : public Task {
+      struct QueuedTask : public Task, public Mutex {
         std::queue<Data> queue;
         SmartPointer<Event> event;
 
         QueuedTask(Base &base, int priority) :
           Task(priority),
-          event(base.newEvent(this, &QueuedTask<Data>::dequeue, 0)) {}
+          event(base.newEvent(this, &QueuedTask<Data>::dequeue, 0)) {
+          setProfileName("ConcurrentPool::QueuedTask");
+        }
 
 
         virtual void process(Data) = 0;
@@ -124,10 +127,10 @@ namespace cb {
 
       template <typename Data>
       struct TaskFunctions : public Task {
-        typedef std::function<Data ()> run_cb_t;
-        typedef std::function<void (Data &)> success_cb_t;
-        typedef std::function<void (const Exception &)> error_cb_t;
-        typedef std::function<void ()> complete_cb_t;
+        typedef InlineFunction<Data ()> run_cb_t;
+        typedef InlineFunction<void (Data &)> success_cb_t;
+        typedef InlineFunction<void (const Exception &)> error_cb_t;
+        typedef InlineFunction<void ()> complete_cb_t;
 
         run_cb_t run_cb;
         success_cb_t success_cb;
@@ -139,8 +142,9 @@ namespace cb {
         TaskFunctions(int priority, run_cb_t run_cb,
                       success_cb_t success_cb = 0, error_cb_t error_cb = 0,
                       complete_cb_t complete_cb = 0) :
-          Task(priority), run_cb(run_cb), success_cb(success_cb),
-          error_cb(error_cb), complete_cb(complete_cb) {}
+          Task(priority), run_cb(std::move(run_cb)),
+          success_cb(std::move(success_cb)), error_cb(std::move(error_cb)),
+          complete_cb(std::move(complete_cb)) {}
 
         // From Task
         void run() {data = run_cb();}
@@ -166,6 +170,14 @@ namespace cb {
       queue_t ready;
       queue_t completed;
 
+      unsigned maxBatchSize = 0;
+      double batchLatency = 0;
+
+      uint64_t numBatches = 0;
+      uint64_t numBatchedTasks = 0;
+      unsigned lastBatchSize = 0;
+      unsigned largestBatchSize = 0;
+
     public:
       ConcurrentPool(Base &base, unsigned size);
       ~ConcurrentPool();
@@ -176,6 +188,28 @@ namespace cb {
       unsigned getNumActive() const;
       unsigned getNumCompleted() const;
 
+      /**
+       * Limit the number of completed tasks delivered per event loop
+       * wakeup.  Remaining tasks are delivered on the next loop iteration.
+       * Zero means no limit.
+       */
+      void setMaxBatchSize(unsigned size);
+      unsigned getMaxBatchSize() const;
+
+      /**
+       * Delay delivery of completed tasks by up to @param latency seconds so
+       * they may be coalesced in to fewer event loop wakeups.  Delivery is
+       * immediate once a full batch has accumulated.
+       */
+      void setBatchLatency(double latency);
+      double getBatchLatency() const;
+
+      uint64_t getNumBatches() const;
+      uint64_t getNumBatchedTasks() const;
+      unsigned getLastBatchSize() const;
+      unsigned getLargestBatchSize() const;
+      double getAverageBatchSize() const;
+
       void submit(const SmartPointer<Task> &task);
 
       template <typename Data>
@@ -184,7 +218,8 @@ namespace cb {
                   typename TaskFunctions<Data>::error_cb_t error = 0,
                   typename TaskFunctions<Data>::complete_cb_t complete = 0) {
         submit(new TaskFunctions<Data>
-               (priority, run, success, error, complete));
+               (priority, std::move(run), std::move(success), std::move(error),
+                std::move(complete)));
       }
 
       // From ThreadPool
@@ -195,6 +230,7 @@ namespace cb {
     protected:
       void run();
 
+      void notify();
       void complete();
     };
   }
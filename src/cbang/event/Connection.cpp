@@ -37,6 +37,7 @@
 #include "HTTP.h"
 #include "Event.h"
 #include "Websocket.h"
+#include "HTTP2Session.h"
 
 #include <cbang/config.h>
 #include <cbang/Exception.h>
@@ -76,22 +77,24 @@ Connection::Connection(cb::Event::Base &base, bool incoming,
                        const SmartPointer<SSLContext> &sslCtx) :
   BufferEvent(base, incoming, socket, sslCtx), base(base),
   state(incoming ? STATE_READING_FIRSTLINE : STATE_DISCONNECTED),
-  incoming(incoming), peer(peer), startTime(Timer::now()), sslCtx(sslCtx) {
+  incoming(incoming), peer(peer), startTime(base.getCachedTime()),
+  sslCtx(sslCtx), rateTracking(!incoming) {
 
   LOG_DEBUG(4, "created " << getStateString(state));
 }
 
 
 Connection::~Connection() {
-  if (retryEvent.isSet()) {
-    TRY_CATCH_ERROR(retryEvent->del());
-    retryEvent.release();
-  }
-
   LOG_DEBUG(4, "destroyed " << getStateString(state));
 }
 
 
+bool Connection::getPeerCredentials(SocketCredentials &cred) const {
+  return peer.isUnix() && getSocket().isSet() &&
+    getSocket()->getPeerCredentials(cred);
+}
+
+
 bool Connection::isConnected() const {
   return state != STATE_DISCONNECTED && state != STATE_CONNECTING;
 }
@@ -103,6 +106,12 @@ const SmartPointer<Request> &Connection::getRequest() const {
 }
 
 
+HTTP2Session &Connection::getHTTP2() const {
+  if (http2.isNull()) THROW("Not an HTTP/2 connection");
+  return *http2;
+}
+
+
 void Connection::checkActiveRequest(Request &req) const {
   if (getRequest() != &req) THROW("Not the active request");
 }
@@ -118,6 +127,18 @@ Websocket &Connection::getWebsocket() const {
 }
 
 
+const string &Connection::getDefaultContentType() const {
+  static const string defaultType = "text/html; charset=UTF-8";
+  return http.isSet() ? http->getDefaultContentType() : defaultType;
+}
+
+
+void Connection::setRateTracking(bool enable) {
+  rateTracking = enable;
+  if (!enable) rates.release();
+}
+
+
 double Connection::getRate() const {
   return isWriting() ? getRateOut() : getRateIn();
 }
@@ -157,6 +178,15 @@ void Connection::sendServiceUnavailable() {
 }
 
 
+void Connection::drain(bool force) {
+  LOG_DEBUG(4, __func__ << '(' << force << ')');
+
+  if (force) return free(CONN_ERR_TIMEOUT);
+  if (isHTTP2()) return http2->shutdown();
+  if (!hasRequest() && !getInput().getLength()) free(CONN_ERR_OK);
+}
+
+
 void Connection::makeRequest(Request &req) {
   LOG_DEBUG(4, __func__ << "()");
 
@@ -174,6 +204,7 @@ void Connection::acceptRequest() {
   LOG_DEBUG(4, __func__ << "()");
 
   if (requests.size()) THROW("Not a new Connection");
+  setTimeouts(readTimeout, writeTimeout);
   startRead();
 }
 
@@ -181,13 +212,27 @@ void Connection::acceptRequest() {
 void Connection::cancelRequest(Request &req) {
   LOG_DEBUG(4, __func__ << "()");
 
-  if (getRequest() == &req) fail(CONN_ERR_REQUEST_CANCEL);
-  else requests.remove(&req);
+  if (http2.isSet()) return http2->cancel(req);
+  if (getRequest() == &req || (readingRequest && requests.back() == &req))
+    fail(CONN_ERR_REQUEST_CANCEL);
+
+  else {
+    requests.remove(&req);
+
+    auto it = pipelined.find(&req);
+    if (it != pipelined.end()) {
+      pipelinedBytes -= it->second.getLength();
+      pipelined.erase(it);
+    }
+  }
 }
 
 
 void Connection::write(Request &req, const cb::Event::Buffer &buf) {
   LOG_DEBUG(4, __func__ << "() bytes=" << buf.getLength());
+
+  // Pipelined replies wait their turn
+  if (incoming && hasRequest() && getRequest() != &req) return hold(req, buf);
   checkActiveRequest(req);
 
   getOutput().add(buf);
@@ -196,13 +241,38 @@ void Connection::write(Request &req, const cb::Event::Buffer &buf) {
 
   // Don't change state or disable read if active Websocket
   if (!req.isWebsocket()) {
-    setRead(false);
-    setState(STATE_WRITING);
-    contentLength = getOutput().getLength();
+    if (incoming) responding = true;
+
+    // Continue reading pipelined requests
+    if (!isReadingAhead()) {
+      setRead(false);
+      setState(STATE_WRITING);
+      contentLength = getOutput().getLength();
+    }
+
+    req.traceStage("WRITING");
   }
 }
 
 
+void Connection::setReadPaused(bool paused) {
+  if (readPaused == paused) return;
+  readPaused = paused;
+
+  if (state != STATE_READING_BODY) return;
+  if (paused) setRead(false);
+  else if (getInput().getLength()) readCB();
+  else setRead(true);
+}
+
+
+bool Connection::isWritable(const Request &req) const {
+  if (http2.isSet()) return http2->isWritable(req);
+  if (incoming && hasRequest() && getRequest() != &req) return false;
+  return isWritable();
+}
+
+
 const char *Connection::getStateString(state_t state) {
   switch (state) {
   case STATE_DISCONNECTED:      return "DISCONNECTED";
@@ -215,6 +285,7 @@ const char *Connection::getStateString(state_t state) {
   case STATE_WEBSOCK_HEADER:    return "WEBSOCK_HEADER";
   case STATE_WEBSOCK_BODY:      return "WEBSOCK_BODY";
   case STATE_WRITING:           return "WRITING";
+  case STATE_HTTP2:             return "HTTP2";
   }
 
   return "INVALID";
@@ -225,6 +296,10 @@ void Connection::setState(state_t state) {
   if (state == this->state) return;
   LOG_DEBUG(4, getStateString(this->state) << " -> " << getStateString(state));
   this->state = state;
+
+  // Writing is split into the HANDLER and WRITING stages, see done()
+  if (state != STATE_WRITING && !requests.empty() && !isReadingAhead())
+    requests.front()->traceStage(getStateString(state));
 }
 
 
@@ -232,6 +307,7 @@ void Connection::push(const SmartPointer<Request> &req) {
   if (req->hasConnection()) THROW("Request already associated with Connection");
   req->setConnection(this);
   requests.push_back(req);
+  requestCount++;
 }
 
 
@@ -239,8 +315,15 @@ SmartPointer<Request> Connection::pop() {
   if (requests.empty()) THROW(__func__ << "() No requests");
   auto req = getRequest();
   requests.pop_front();
+  pipelined.erase(req.get());
+  responding = false;
+  if (requests.empty()) readingRequest = false;
   if (stats.isSet()) stats->event(req->getResponseCode().toString());
-  TRY_CATCH_ERROR(req->onComplete());
+  if (incoming && http.isSet()) {
+    http->recordLatency(*req);
+    req->finishTrace();
+  }
+  TRY_CATCH_ERROR(req->complete());
   return req;
 }
 
@@ -250,6 +333,13 @@ void Connection::free(ConnectionError error) {
 
   reset();
 
+  if (http2.isSet()) {
+    // Release the session first, completions may reference the Connection
+    SmartPointer<HTTP2Session> session = http2;
+    http2.release();
+    session->close();
+  }
+
   // Remove request and callback
   while (!requests.empty()) {
     auto req = pop();
@@ -282,6 +372,11 @@ void Connection::reset() {
   // Clear any buffered data
   getOutput().clear();
   getInput().clear();
+  headerParser.reset();
+  pipelined.clear();
+  pipelinedBytes = 0;
+  readingRequest = false;
+  responding = false;
 
   setState(STATE_DISCONNECTED);
 }
@@ -304,11 +399,19 @@ void Connection::done() {
 
   setRead(false); // Done reading
 
-  auto req = getRequest();
+  auto req = getReadRequest();
 
   if (incoming) {
+    readingRequest = false;
     setState(STATE_WRITING);                  // Start reply
-    TRY_CATCH_ERROR(return req->onRequest()); // Callback
+    req->traceStage("HANDLER");
+
+    try {
+      req->onRequest();                       // Callback
+      readAhead();                            // Next pipelined request
+      return;
+    } CATCH_ERROR;
+
     fail(CONN_ERR_EXCEPTION);                 // Error on exception
 
   } else {
@@ -343,19 +446,26 @@ void Connection::done() {
 }
 
 
+void Connection::setMaxTTL(double ttl) {
+  if (!incoming) THROW("Only incoming connections expire");
+  if (!ttl) return timer.cancel();
+
+  timer.setCallback([this] () {if (http.isSet()) http->expire(*this);});
+  timer.schedule(base.getTimerWheel(), startTime + ttl - Timer::now());
+}
+
+
 void Connection::retry() {
   LOG_DEBUG(4, __func__ << "(" << retries << ")");
 
   reset();
 
   if (!maxRetries || retries < maxRetries) {
-    if (retryEvent.isNull())
-      retryEvent = base.newEvent(this, &Connection::connect, 0);
-
     if (!retries++) retryTimeout = 2;
     else retryTimeout *= 2; // Backoff
 
-    retryEvent->add(retryTimeout);
+    timer.setCallback([this] () {connect();});
+    timer.schedule(base.getTimerWheel(), retryTimeout);
     return;
   }
 
@@ -374,11 +484,7 @@ void Connection::connect() {
   try {
     reset();
 
-    // Open and bind new socket
-    SmartPointer<Socket> socket = new Socket;
-    if (bind.getIP()) socket->bind(bind);
-    else socket->open();
-    BufferEvent::setSocket(socket);
+    BufferEvent::setSocket(newSocket(peer));
 
     setTimeouts(readTimeout, connectTimeout);
     setState(STATE_CONNECTING);
@@ -393,6 +499,29 @@ void Connection::connect() {
 }
 
 
+SmartPointer<Socket> Connection::newSocket(const IPAddress &peer) {
+  // Open and bind new socket
+  SmartPointer<Socket> socket = new Socket;
+  if (peer.isUnix()) socket->openUnix();
+  else if (bind.getIP()) socket->bind(bind);
+  else socket->open();
+  socketOptions.applyConnect(*socket);
+  return socket;
+}
+
+
+void Connection::adopted() {
+  LOG_DEBUG(4, __func__ << "()");
+
+  // Reusing an already connected socket, see ConnectionPool
+  if (!isReady()) THROW("Adopted connection is not ready");
+
+  retries = 0;
+  setState(STATE_IDLE);
+  setTimeouts(readTimeout, writeTimeout);
+}
+
+
 void Connection::websockClose(WebsockStatus status, const string &msg) {
   getWebsocket().close(status, msg);
 }
@@ -404,28 +533,105 @@ void Connection::websockReadHeader() {
   setRead(true);
   setState(STATE_WEBSOCK_HEADER);
 
-  if (getWebsocket().readHeader(getInput())) websockReadBody();
+  // Handle every complete frame already buffered
+  while (state == STATE_WEBSOCK_HEADER &&
+         getWebsocket().readHeader(getInput()))
+    if (!websockReadBody()) break;
 }
 
 
-void Connection::websockReadBody() {
+bool Connection::websockReadBody() {
   setState(STATE_WEBSOCK_BODY);
 
   auto &ws = getWebsocket();
 
-  if (ws.readBody(getInput())) {
-    if (ws.isActive()) setState(STATE_WEBSOCK_HEADER);
-    else setState(STATE_WRITING); // Writing close
+  if (!ws.readBody(getInput())) return false; // Wait for more
+
+  if (ws.isActive()) setState(STATE_WEBSOCK_HEADER);
+  else setState(STATE_WRITING); // Writing close
+
+  return true;
+}
+
+
+const SmartPointer<Request> &Connection::getReadRequest() const {
+  if (!incoming) return getRequest();
+  if (!readingRequest) THROW("No request");
+  return requests.back();
+}
+
+
+bool Connection::isReading() const {
+  switch (state) {
+  case STATE_READING_FIRSTLINE: case STATE_READING_HEADERS:
+  case STATE_READING_BODY: case STATE_READING_TRAILER: return true;
+  default: return false;
   }
 }
 
 
+bool Connection::isReadingAhead() const {
+  // Reading while earlier requests are in their handlers or replying
+  return incoming && isReading() &&
+    (readingRequest ? 1 : 0) < requests.size();
+}
+
+
+void Connection::readAhead() {
+  if (maxPipelined < 2 || state != STATE_WRITING || readingRequest ||
+      requests.empty() || maxPipelined <= requests.size() ||
+      maxPipelineBuffer <= pipelinedBytes) return;
+
+  // Only persistent HTTP/1.1 requests may be followed by more
+  auto &req = *requests.back();
+  if (req.getVersion() < Version(1, 1) || req.needsClose() ||
+      req.isWebsocket()) return;
+
+  // Idle reads would time out or see EOF, which closes the socket
+  if (!getInput().getLength()) return;
+
+  LOG_DEBUG(4, __func__ << "() pipelined=" << requests.size());
+  startRead();
+}
+
+
+void Connection::hold(Request &req, const cb::Event::Buffer &buf) {
+  LOG_DEBUG(4, __func__ << "() bytes=" << buf.getLength());
+
+  pipelinedBytes += buf.getLength();
+  pipelined[&req].add(buf);
+
+  // Stop reading ahead on an error reply to the request being read
+  if (readingRequest && requests.back() == &req) {
+    setRead(false);
+    setState(STATE_WRITING);
+  }
+}
+
+
+void Connection::nextReply() {
+  if (requests.empty()) return;
+
+  auto it = pipelined.find(requests.front().get());
+  if (it == pipelined.end()) return;
+
+  cb::Event::Buffer buf = it->second;
+  pipelinedBytes -= buf.getLength();
+  pipelined.erase(it);
+
+  write(*requests.front(), buf);
+}
+
+
 void Connection::startRead() {
   LOG_DEBUG(4, __func__ << "()");
 
   // Start reading response
   setRead(true);
   setState(STATE_READING_FIRSTLINE);
+
+  // Pipelined data may already be buffered
+  if (getInput().getLength()) readCB();
 }
 
 
@@ -442,6 +648,7 @@ void Connection::newRequest(const string &line) {
   Version version = Request::parseHTTPVersion(parts[2]);
 
   push(http->createRequest(*this, method, uri, version));
+  readingRequest = true;
 }
 
 
@@ -453,10 +660,19 @@ void Connection::readFirstLine() {
     if (line.empty()) return; // Need more data
 
     if (maxHeaderSize && maxHeaderSize < line.length())
-      return getRequest()->sendError(HTTP_BAD_REQUEST, "Header too long");
+      return getReadRequest()->sendError(HTTP_BAD_REQUEST, "Header too long");
 
     headerSize += line.length() + 2;
 
+    // HTTP/2 with prior knowledge or via TLS ALPN
+    if (incoming && requests.empty() && line == "PRI * HTTP/2.0" &&
+        http.isSet() && http->getHTTP2Enabled()) {
+      LOG_DEBUG(4, "Starting HTTP/2");
+      http2 = new HTTP2Session(*this);
+      setState(STATE_HTTP2);
+      return http2->read(getInput());
+    }
+
     if (incoming) newRequest(line);
     else getRequest()->parseResponseLine(line);
 
@@ -464,7 +680,7 @@ void Connection::readFirstLine() {
 
   } catch (const Exception &e) {
     LOG_ERROR(e.getMessages());
-    if (incoming) getRequest()->sendError(HTTP_BAD_REQUEST, e);
+    if (incoming) getReadRequest()->sendError(HTTP_BAD_REQUEST, e);
     else fail(CONN_ERR_EXCEPTION);
   }
 }
@@ -474,15 +690,17 @@ bool Connection::tryReadHeader() {
   try {
     unsigned maxSize = maxHeaderSize ? maxHeaderSize - headerSize : 0;
     unsigned bytes = getInput().getLength();
-    bool done = getRequest()->getInputHeaders().parse(getInput(), maxSize);
+    auto &headers = getReadRequest()->getInputHeaders();
+    bool done = headerParser.parse(getInput(), headers, maxSize);
 
     headerSize += bytes - getInput().getLength();
 
     return done;
 
   } catch (const Exception &e) {
+    headerParser.reset();
     LOG_ERROR(e.getMessages());
-    if (incoming) getRequest()->sendError(HTTP_BAD_REQUEST, e);
+    if (incoming) getReadRequest()->sendError(HTTP_BAD_REQUEST, e);
     else fail(CONN_ERR_EXCEPTION);
   }
 
@@ -491,7 +709,7 @@ bool Connection::tryReadHeader() {
 
 
 void Connection::headersCallback() {
-  TRY_CATCH_ERROR(return getRequest()->onHeaders());
+  TRY_CATCH_ERROR(return getReadRequest()->onHeaders());
   fail(CONN_ERR_EXCEPTION);
 }
 
@@ -502,17 +720,21 @@ void Connection::readHeader() {
   setState(STATE_READING_HEADERS);
 
   if (!tryReadHeader()) return;
+  if (incoming && http.isSet()) http->startTrace(*this, *getReadRequest());
 
   // Request may be canceled based on headers
   headersCallback();
   if (state != STATE_READING_HEADERS) return;
 
-  auto req = getRequest();
+  auto req = getReadRequest();
 
   // Done reading headers
   if (incoming) {
     // Handle protocol upgrades
     if (req->inHas("Upgrade")) {
+      if (1 < requests.size())
+        return req->sendError(HTTP_BAD_REQUEST, "Cannot upgrade pipelined");
+
       string upgrade = String::toLower(req->inFind("Upgrade"));
 
       if (upgrade == "websocket") {
@@ -543,13 +765,15 @@ void Connection::getBody() {
   LOG_DEBUG(4, __func__ << "()");
 
   // If this is a request without a body, then we are done
-  if (incoming && !getRequest()->mayHaveBody()) return done();
+  if (incoming && !getReadRequest()->mayHaveBody()) return done();
 
   setState(STATE_READING_BODY);
+  readPaused = false;
+  chunkedRequest = false;
   bytesToRead = -1;
   bodySize = 0;
   contentLength = -1;
-  auto req = getRequest();
+  auto req = getReadRequest();
 
   string xferEnc = String::toLower(req->inFind("Transfer-Encoding"));
   if (xferEnc == "chunked") chunkedRequest = true;
@@ -572,23 +796,26 @@ void Connection::getBody() {
 
     } else {
       try {
-        bytesToRead = String::parseU32(contentLength);
+        bytesToRead = String::parseU64(contentLength);
         this->contentLength = bytesToRead;
       } catch (const Exception &e) {
         return req->sendError(HTTP_BAD_REQUEST, "Invalid Content-Length");
       }
 
-      if (maxBodySize && maxBodySize < (uint64_t)bytesToRead)
-        return req->sendError(HTTP_REQUEST_ENTITY_TOO_LARGE);
+      if (!req->isBodyStreaming()) {
+        if (maxBodySize && maxBodySize < (uint64_t)bytesToRead)
+          return req->sendError(HTTP_REQUEST_ENTITY_TOO_LARGE);
 
-      // Allocate space
-      req->getInputBuffer().expand(bytesToRead);
+        // Allocate space
+        req->getInputBuffer().expand(bytesToRead);
+      }
     }
   }
 
-  // 100 HTTP continue
+  // 100 HTTP continue, not between the bytes of a pipelined reply
   auto &version = req->getVersion();
-  if (incoming && Version(1, 1) <= version && !getInput().getLength()) {
+  if (incoming && Version(1, 1) <= version && !getInput().getLength() &&
+      requests.size() == 1) {
     string expect = String::toLower(req->inFind("Expect"));
 
     if (!expect.empty()) {
@@ -614,13 +841,16 @@ void Connection::readBody() {
   LOG_DEBUG(4, __func__ << "()");
 
   auto buf = getInput();
-  auto req = getRequest();
+  auto req = getReadRequest();
+  bool streaming = req->isBodyStreaming();
+  bool lastChunk = false;
 
   if (chunkedRequest) {
     while (buf.getLength()) {
       if (bytesToRead < 0) {
         // Read chunk size
-        string size = buf.readLine(12);
+        string size;
+        if (!buf.readLine(size, 12)) break; // Wait for the rest of the line
 
         // Last chunk on a new line?
         if (size.empty()) continue;
@@ -630,22 +860,18 @@ void Connection::readBody() {
         bodySize += bytes;
         bytesToRead = bytes;
 
-        if (maxBodySize && maxBodySize < bodySize)
+        if (!streaming && maxBodySize && maxBodySize < bodySize)
           return req->sendError(HTTP_BAD_REQUEST, "Too long");
 
         if (!bytesToRead) {
-          // Finished last chunk
-          headerSize = 0;
-          return readTrailer();
+          lastChunk = true;
+          break;
         }
       }
 
-      // Wait for end of chunk
-      if (0 < bytesToRead && buf.getLength() < bytesToRead) break;
-
-      // Completed chunk
-      buf.remove(req->getInputBuffer(), bytesToRead);
-      bytesToRead = -1;
+      // Chunk data, possibly only part of it
+      bytesToRead -= buf.remove(req->getInputBuffer(), bytesToRead);
+      if (!bytesToRead) bytesToRead = -1;
     }
 
   } else {
@@ -658,17 +884,32 @@ void Connection::readBody() {
 
     bodySize += bytes;
 
-    if (maxBodySize && maxBodySize < bodySize)
+    if (!streaming && maxBodySize && maxBodySize < bodySize)
       return req->sendError(HTTP_BAD_REQUEST, "Too long");
 
     buf.remove(req->getInputBuffer(), bytes);
   }
 
+  if (streaming)
+    try {
+      req->bodyData();
+
+    } catch (const Exception &e) {
+      LOG_ERROR(e.getMessages());
+      if (incoming) return req->sendError(e);
+      return fail(CONN_ERR_EXCEPTION);
+    }
+
   // Report progress
   TRY_CATCH_ERROR(req->onProgress(bodySize, contentLength));
 
-  if (bytesToRead) {
-    setRead(true); // Read more
+  if (lastChunk) {
+    // Finished last chunk
+    headerSize = 0;
+    readTrailer();
+
+  } else if (bytesToRead) {
+    if (!readPaused) setRead(true); // Read more
     if (0 < bytesToRead) setMinRead(min((int64_t)1 << 14, bytesToRead));
 
   } else done();
@@ -712,8 +953,12 @@ void Connection::readCB() {
     case STATE_READING_BODY:      return readBody();
     case STATE_READING_TRAILER:   return readTrailer();
     case STATE_WEBSOCK_HEADER:    return websockReadHeader();
-    case STATE_WEBSOCK_BODY:      return websockReadBody();
+    case STATE_WEBSOCK_BODY:
+      if (websockReadBody() && state == STATE_WEBSOCK_HEADER)
+        websockReadHeader();
+      return;
     case STATE_WRITING:           return;
+    case STATE_HTTP2:             return http2->read(getInput());
     }
 
     THROW("Unexpected state " << state << " in read callback");
@@ -730,6 +975,13 @@ void Connection::writeCB() {
   try {
     switch (state) {
     case STATE_CONNECTING: return;
+    case STATE_HTTP2: return http2->writeCB();
+    case STATE_READING_FIRSTLINE:
+    case STATE_READING_HEADERS:
+    case STATE_READING_TRAILER:
+      // Replies are written while reading pipelined requests
+      if (!responding)
+        THROW("Unexpected state " << state << " in write callback");
     case STATE_READING_BODY: // Handle Continue during body read
     case STATE_WEBSOCK_HEADER:
     case STATE_WEBSOCK_BODY:
@@ -740,13 +992,17 @@ void Connection::writeCB() {
     default: THROW("Unexpected state " << state << " in write callback");
     }
 
-    if (state != STATE_WRITING) return;
+    if (state != STATE_WRITING && !responding) return;
 
     auto req = getRequest();
 
     if (incoming) {
+      if (req->stream(getOutput())) return; // Still streaming
       if (req->isChunked()) return; // Still writing
-      if (req->isWebsocket()) return websockReadHeader();
+      if (req->isWebsocket()) {
+        responding = false;
+        return websockReadHeader();
+      }
 
       // Done
       pop();
@@ -756,6 +1012,12 @@ void Connection::writeCB() {
       bool keepAlive = req->getInputHeaders().connectionKeepAlive();
       if ((version < Version(1, 1) && !keepAlive) || req->needsClose())
         return free(CONN_ERR_OK);
+
+      // Write the next pipelined reply, if held
+      nextReply();
+
+      if (isReading()) return;      // Still reading ahead
+      if (hasRequest()) return readAhead();
     }
 
     // Incoming: accept another request
@@ -769,6 +1031,14 @@ void Connection::writeCB() {
 }
 
 
+/// Invoked when the output drains below the low watermark
+void Connection::writableCB() {
+  // HTTP/2 streams are notified as the session pumps their data
+  if (http2.isNull() && hasRequest())
+    TRY_CATCH_ERROR(getRequest()->writable());
+}
+
+
 void Connection::errorCB(short what, int err) {
   LOG_DEBUG(5, __func__ << "(" << BufferEvent::getEventsString(what) << ") "
             << getStateString(state));
@@ -816,12 +1086,24 @@ void Connection::errorCB(short what, int err) {
 
 
 void Connection::received(unsigned bytes) {
-  rateIn.event(bytes);
+  bytesIn += bytes;
+
+  if (rateTracking) {
+    if (rates.isNull()) rates = new Rates;
+    rates->in.event(bytes);
+  }
+
   if (stats.isSet()) stats->event("receiving", bytes);
 }
 
 
 void Connection::sent(unsigned bytes) {
-  rateOut.event(bytes);
+  bytesOut += bytes;
+
+  if (rateTracking) {
+    if (rates.isNull()) rates = new Rates;
+    rates->out.event(bytes);
+  }
+
   if (stats.isSet()) stats->event("sending", bytes);
 }
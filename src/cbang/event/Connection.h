@@ -35,15 +35,20 @@
 #include "Request.h"
 #include "BufferEvent.h"
 #include "Enum.h"
+#include "HeaderParser.h"
 
 #include <cbang/SmartPointer.h>
 #include <cbang/net/IPAddress.h>
 #include <cbang/socket/SocketType.h>
+#include <cbang/socket/SocketOptions.h>
 #include <cbang/time/Time.h>
+#include <cbang/time/Timer.h>
 #include <cbang/util/Rate.h>
+#include <cbang/util/PoolAllocated.h>
 
 #include <limits>
 #include <list>
+#include <map>
 #include <vector>
 
 
@@ -52,14 +57,19 @@ namespace cb {
   class SSLContext;
   class Socket;
   class RateSet;
+  struct SocketCredentials;
 
   namespace Event {
     class Event;
     class HTTP;
     class Request;
     class Websocket;
+    class HTTP2Session;
+
+    class Connection :
+      public BufferEvent, public Enum, public PoolAllocated<Connection> {
+      friend class HTTP2Session;
 
-    class Connection : public BufferEvent, public Enum {
       Base &base;
 
       typedef enum {
@@ -73,22 +83,26 @@ namespace cb {
         STATE_WEBSOCK_HEADER,
         STATE_WEBSOCK_BODY,
         STATE_WRITING,
+        STATE_HTTP2,
       } state_t;
 
       state_t state;
       uint64_t start = Time::now();
+      uint64_t startNS = Timer::monotonicNS();
       bool incoming;
       IPAddress peer;
       IPAddress bind;
+      SocketOptions socketOptions;
       double startTime;
       SmartPointer<HTTP> http;
       SmartPointer<SSLContext> sslCtx;
 
       unsigned retries = 0;
-      SmartPointer<Event> retryEvent;
+      /// Retries outgoing or expires incoming connections
+      TimerWheel::Timer timer;
       std::list<SmartPointer<Request> > requests;
+      unsigned requestCount = 0;
 
-      std::string defaultContentType = "text/html; charset=UTF-8";
       uint32_t maxBodySize    = std::numeric_limits<unsigned>::max();
       uint32_t maxHeaderSize  = std::numeric_limits<unsigned>::max();
       double retryTimeout     = 0;
@@ -96,19 +110,37 @@ namespace cb {
       unsigned readTimeout    = 50;
       unsigned writeTimeout   = 50;
       unsigned connectTimeout = 50;
+      unsigned maxPipelined   = 1;
+      unsigned maxPipelineBuffer = 1 << 20;
 
       bool detectClose    = false;
       bool chunkedRequest = false;
+      bool readPaused     = false;
+      bool readingRequest = false;
+      bool responding     = false;
+
+      std::map<const Request *, Buffer> pipelined;
+      uint64_t pipelinedBytes = 0;
 
+      HeaderParser headerParser;
       uint32_t headerSize = 0;
-      uint32_t bodySize   = 0;
+      uint64_t bodySize   = 0;
       int64_t bytesToRead = 0;
-      int contentLength   = 0;
+      int64_t contentLength = 0;
+
+      uint64_t bytesIn  = 0;
+      uint64_t bytesOut = 0;
+
+      struct Rates {
+        Rate in  = 60;
+        Rate out = 60;
+      };
 
-      Rate rateIn  = 60;
-      Rate rateOut = 60;
+      bool rateTracking;
+      SmartPointer<Rates> rates;
 
       SmartPointer<RateSet> stats;
+      SmartPointer<HTTP2Session> http2;
 
     public:
       Connection(Base &base, bool incoming, const IPAddress &peer,
@@ -122,30 +154,50 @@ namespace cb {
       bool isWriting() const {return state == STATE_WRITING;}
       const char *getStateString() const {return getStateString(state);}
       uint64_t getStart() const {return start;}
+      /// Creation time on Timer::monotonicNS()
+      uint64_t getStartNS() const {return startNS;}
 
       bool isConnected() const;
+      /// Bytes queued but not yet written to the socket
+      unsigned getOutputLength() const
+        {return BufferEvent::getOutput().getLength();}
       bool isIncoming() const {return incoming;}
+      bool isHTTP2() const {return state == STATE_HTTP2;}
+      HTTP2Session &getHTTP2() const;
 
       const cb::IPAddress &getPeer() const {return peer;}
       void setPeer(const cb::IPAddress &peer) {this->peer = peer;}
 
+      /// @return False unless the peer is on a Unix socket
+      bool getPeerCredentials(SocketCredentials &cred) const;
+
       const cb::IPAddress &getLocalAddress() const {return bind;}
       void setLocalAddress(const cb::IPAddress &bind) {this->bind = bind;}
 
+      /// Applied to outgoing sockets on connect()
+      const SocketOptions &getSocketOptions() const {return socketOptions;}
+      void setSocketOptions(const SocketOptions &x) {socketOptions = x;}
+
       double getStartTime() const {return startTime;}
+      /**
+       * Expire this incoming connection @param ttl seconds after the start
+       * time, zero to never expire.
+       */
+      void setMaxTTL(double ttl);
 
       const SmartPointer<HTTP> &getHTTP() const {return http;}
       void setHTTP(const SmartPointer<HTTP> &http) {this->http = http;}
 
       bool hasRequest() const {return !requests.empty();}
+      /// The number of requests made on this connection so far
+      unsigned getRequestCount() const {return requestCount;}
       const SmartPointer<Request> &getRequest() const;
       void checkActiveRequest(Request &req) const;
       bool isWebsocket() const;
       Websocket &getWebsocket() const;
 
-      const std::string &getDefaultContentType() const
-        {return defaultContentType;}
-      void setDefaultContentType(const std::string &s) {defaultContentType = s;}
+      /// The HTTP's default, if set, see HTTP::setDefaultContentType()
+      const std::string &getDefaultContentType() const;
 
       void setMaxBodySize(uint32_t size) {maxBodySize = size;}
       uint32_t getMaxBodySize() const {return maxBodySize;}
@@ -165,15 +217,42 @@ namespace cb {
       void setConnectTimeout(unsigned t) {connectTimeout = t;}
       unsigned getConnectTimeout() const {return connectTimeout;}
 
-      uint32_t getHeaderSize() const {return headerSize;}
-      uint32_t getBodySize() const   {return bodySize;}
-
-      int getContentLength() const {return contentLength;}
+      using BufferEvent::setConnectDelay;
+      using BufferEvent::getConnectDelay;
+
+      /**
+       * Read ahead up to @param max persistent HTTP/1.1 requests on an
+       * incoming connection.  Requests already received are parsed and
+       * dispatched while earlier handlers are still running but the
+       * replies are written in request order.  Replies which are not yet
+       * at the front are held in memory.
+       */
+      void setMaxPipelined(unsigned max) {maxPipelined = max;}
+      unsigned getMaxPipelined() const {return maxPipelined;}
+
+      /// Stop reading ahead while more than @param bytes of replies are held
+      void setMaxPipelineBuffer(unsigned bytes) {maxPipelineBuffer = bytes;}
+      unsigned getMaxPipelineBuffer() const {return maxPipelineBuffer;}
+      /// Bytes of pipelined replies waiting for earlier replies
+      uint64_t getPipelinedBytes() const {return pipelinedBytes;}
 
-      uint64_t getBytesIn() const  {return rateIn.getTotal();}
-      uint64_t getBytesOut() const {return rateOut.getTotal();}
-      double getRateIn() const  {return rateIn.get();}
-      double getRateOut() const {return rateOut.get();}
+      uint32_t getHeaderSize() const {return headerSize;}
+      uint64_t getBodySize() const   {return bodySize;}
+
+      int64_t getContentLength() const {return contentLength;}
+
+      uint64_t getBytesIn() const  {return bytesIn;}
+      uint64_t getBytesOut() const {return bytesOut;}
+
+      /**
+       * Transfer rates are tracked by default on outgoing connections only.
+       * Each direction keeps a minute of per second samples, allocated
+       * when the first bytes are counted.
+       */
+      void setRateTracking(bool enable);
+      bool getRateTracking() const {return rateTracking;}
+      double getRateIn() const  {return rates.isSet() ? rates->in.get() : 0;}
+      double getRateOut() const {return rates.isSet() ? rates->out.get() : 0;}
       double getRate() const;
       unsigned getBytesRemaining() const;
       double getEstimatedTime() const;
@@ -183,11 +262,30 @@ namespace cb {
       const SmartPointer<RateSet> &getStats() const {return stats;}
 
       void sendServiceUnavailable();
+
+      /**
+       * Close this incoming connection if it is between requests.  HTTP/2
+       * sessions are sent GOAWAY and close once their open streams finish.
+       * @param force Close even if requests are in progress.
+       */
+      void drain(bool force = false);
+
       void makeRequest(Request &req);
       void acceptRequest();
       void cancelRequest(Request &req);
       void write(Request &req, const Buffer &buf);
 
+      /**
+       * Stop reading the body, until resumed, so that a consumer of it in
+       * Request::onProgress() or onBodyData() can apply backpressure.  Any
+       * data already buffered is processed on resume.
+       */
+      void setReadPaused(bool paused);
+      bool isReadPaused() const {return readPaused;}
+
+      using BufferEvent::isWritable;
+      bool isWritable(const Request &req) const;
+
     protected:
       static const char *getStateString(state_t state);
       void setState(state_t state);
@@ -202,10 +300,18 @@ namespace cb {
       void done();
       void retry();
       void connect();
+      void adopted();
 
       void websockClose(WebsockStatus status, const std::string &msg = "");
       void websockReadHeader();
-      void websockReadBody();
+      bool websockReadBody();
+
+      const SmartPointer<Request> &getReadRequest() const;
+      bool isReading() const;
+      bool isReadingAhead() const;
+      void readAhead();
+      void hold(Request &req, const cb::Event::Buffer &buf);
+      void nextReply();
 
       void startRead();
       void newRequest(const std::string &line);
@@ -230,8 +336,10 @@ namespace cb {
       void connectCB();
       void readCB();
       void writeCB();
+      void writableCB();
       void errorCB(short what, int err);
 
+      SmartPointer<Socket> newSocket(const IPAddress &peer);
       void received(unsigned bytes);
       void sent(unsigned bytes);
     };
@@ -0,0 +1,175 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "ConnectionPool.h"
+#include "BufferEvent.h"
+
+#include <cbang/config.h>
+#include <cbang/String.h>
+#include <cbang/net/URI.h>
+#include <cbang/log/Logger.h>
+#include <cbang/util/RateSet.h>
+
+#ifdef HAVE_OPENSSL
+#include <openssl/ssl.h>
+#endif // HAVE_OPENSSL
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+ConnectionPool::ConnectionPool(Base &base) : base(base) {}
+ConnectionPool::~ConnectionPool() {clear();}
+
+
+unsigned ConnectionPool::getIdleCount() {
+  purge();
+
+  unsigned count = 0;
+  for (auto it = pool.begin(); it != pool.end(); it++)
+    count += it->second.size();
+
+  return count;
+}
+
+
+string ConnectionPool::getKey(const URI &uri) {
+  return uri.getScheme() + "://" + String::toLower(uri.getHost()) + ":" +
+    String(uri.getPort());
+}
+
+
+bool ConnectionPool::acquire(const string &key, BufferEvent &bev) {
+  auto it = pool.find(key);
+
+  if (it != pool.end()) {
+    idle_t &idle = it->second;
+
+    // Most recently used first
+    while (!idle.empty()) {
+      SmartPointer<BufferEvent> con = idle.back();
+      idle.pop_back();
+
+      // Closed by peer, timed out or received unexpected data
+      if (!con->isReady() || con->getInput().getLength()) continue;
+
+      LOG_DEBUG(4, "Reusing connection to " << key);
+      bev.adopt(*con);
+      if (idle.empty()) pool.erase(it);
+      event("hit");
+
+      return true;
+    }
+
+    pool.erase(it);
+  }
+
+  event("miss");
+
+  auto it2 = sessions.find(key);
+  if (it2 != sessions.end()) {
+    bev.setSSLSession(it2->second);
+    event("resume");
+  }
+
+  return false;
+}
+
+
+void ConnectionPool::release(const string &key, BufferEvent &bev) {
+  if (!isEnabled() || !bev.isReady() || bev.getInput().getLength() ||
+      bev.getOutput().getLength()) return;
+
+  unsigned count = getIdleCount(); // Also purges closed connections
+  idle_t &idle = pool[key];
+
+  if (maxPerHost <= idle.size() || maxIdle <= count) {
+    event("discard");
+    if (idle.empty()) pool.erase(key);
+    return;
+  }
+
+  SmartPointer<BufferEvent> con = new BufferEvent(base, false);
+  con->adopt(bev);
+  con->setTimeouts(idleTimeout, idleTimeout);
+  con->setRead(true); // Detect close
+  idle.push_back(con);
+
+  LOG_DEBUG(4, "Pooled connection to " << key);
+}
+
+
+void ConnectionPool::saveSession(const string &key, const BufferEvent &bev) {
+#ifdef HAVE_OPENSSL
+  ssl_session_st *session = bev.getSSLSession();
+  if (!session) return;
+
+  auto it = sessions.find(key);
+  if (it == sessions.end()) sessions[key] = session;
+  else {
+    SSL_SESSION_free(it->second);
+    it->second = session;
+  }
+#endif // HAVE_OPENSSL
+}
+
+
+void ConnectionPool::clear() {
+  pool.clear();
+
+#ifdef HAVE_OPENSSL
+  for (auto it = sessions.begin(); it != sessions.end(); it++)
+    SSL_SESSION_free(it->second);
+#endif // HAVE_OPENSSL
+
+  sessions.clear();
+}
+
+
+void ConnectionPool::purge() {
+  for (auto it = pool.begin(); it != pool.end();) {
+    idle_t &idle = it->second;
+
+    for (auto it2 = idle.begin(); it2 != idle.end();)
+      if ((*it2)->isReady()) it2++;
+      else it2 = idle.erase(it2);
+
+    if (idle.empty()) pool.erase(it++);
+    else it++;
+  }
+}
+
+
+void ConnectionPool::event(const string &name) {
+  if (stats.isSet()) stats->event(name);
+}
@@ -0,0 +1,118 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+
+#include <string>
+#include <list>
+#include <map>
+
+struct ssl_session_st;
+
+
+namespace cb {
+  class URI;
+  class RateSet;
+
+  namespace Event {
+    class Base;
+    class BufferEvent;
+
+    /**
+     * Idle keep-alive connections for Client keyed by scheme, host and port.
+     * Idle connections continue reading so that a remote close or the idle
+     * timeout frees them.  TLS sessions are kept per key so that new
+     * connections can resume rather than perform a full handshake.
+     *
+     * Stats, if set, count "hit", "miss", "resume" and "discard" events.
+     */
+    class ConnectionPool : public RefCounted {
+      Base &base;
+
+      typedef std::list<SmartPointer<BufferEvent> > idle_t;
+      typedef std::map<std::string, idle_t> pool_t;
+      pool_t pool;
+
+      typedef std::map<std::string, ssl_session_st *> sessions_t;
+      sessions_t sessions;
+
+      unsigned maxIdle = 64;
+      unsigned maxPerHost = 8;
+      unsigned idleTimeout = 30;
+
+      SmartPointer<RateSet> stats;
+
+    public:
+      ConnectionPool(Base &base);
+      ~ConnectionPool();
+
+      bool isEnabled() const {return maxIdle && maxPerHost;}
+
+      unsigned getMaxIdle() const {return maxIdle;}
+      void setMaxIdle(unsigned x) {maxIdle = x;}
+
+      unsigned getMaxPerHost() const {return maxPerHost;}
+      void setMaxPerHost(unsigned x) {maxPerHost = x;}
+
+      unsigned getIdleTimeout() const {return idleTimeout;}
+      void setIdleTimeout(unsigned x) {idleTimeout = x;}
+
+      const SmartPointer<RateSet> &getStats() const {return stats;}
+      void setStats(const SmartPointer<RateSet> &stats) {this->stats = stats;}
+
+      unsigned getIdleCount();
+
+      static std::string getKey(const URI &uri);
+
+      /**
+       * Move an idle connection for @param key to @param bev.  On a miss
+       * any saved TLS session is set on @param bev instead.
+       * @return true if @param bev is now connected.
+       */
+      bool acquire(const std::string &key, BufferEvent &bev);
+
+      /// Keep the connection of @param bev if it is reusable
+      void release(const std::string &key, BufferEvent &bev);
+
+      /// Save the TLS session of @param bev for later resumption
+      void saveSession(const std::string &key, const BufferEvent &bev);
+
+      void clear();
+
+    protected:
+      void purge();
+      void event(const std::string &name);
+    };
+  }
+}
@@ -0,0 +1,303 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#if !defined(__cpp_impl_coroutine) || !__has_include(<coroutine>)
+#error cbang/event/Coroutine.h requires C++20 coroutines
+#endif
+
+#include "Base.h"
+#include "Event.h"
+#include "DNSBase.h"
+#include "Client.h"
+#include "ConcurrentPool.h"
+#include "Request.h"
+#include "HTTPRequestHandler.h"
+
+#include <cbang/Exception.h>
+#include <cbang/SmartPointer.h>
+#include <cbang/log/Logger.h>
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+
+/*
+ * Optional C++20 coroutine support.  The rest of the library is built as
+ * C++11 so this header is only usable by code compiled with -std=c++20.
+ *
+ * Example:
+ *
+ *   Coroutine handle(Client &client, SmartPointer<Request> req) {
+ *     auto a = call(client, "https://a.example.com/", HTTP_GET);
+ *     auto b = call(client, "https://b.example.com/", HTTP_GET);
+ *     auto ra = co_await a;
+ *     auto rb = co_await b;
+ *     req->reply(ra->getInput() + rb->getInput());
+ *   }
+ *
+ * Both calls are in flight before the first co_await.  Coroutines are always
+ * resumed from the event loop thread.
+ */
+namespace cb {
+  namespace Event {
+    class FutureBase {
+    protected:
+      struct state_t {
+        bool done = false;
+        std::exception_ptr error;
+        std::coroutine_handle<> waiter;
+      };
+
+    public:
+      bool isDone() const {return getState().done;}
+
+      void fail(std::exception_ptr e) {getState().error = e; complete();}
+      void fail(const Exception &e) {fail(std::make_exception_ptr(e));}
+
+      // Awaitable
+      bool await_ready() const {return isDone();}
+      void await_suspend(std::coroutine_handle<> h) {
+        if (getState().waiter)
+          CBANG_THROW("Future already has a waiting coroutine");
+        getState().waiter = h;
+      }
+
+    protected:
+      virtual ~FutureBase() {}
+      virtual state_t &getState() const = 0;
+
+      void check() const {
+        if (getState().error) std::rethrow_exception(getState().error);
+      }
+
+      void complete() {
+        state_t &state = getState();
+        if (state.done) return;
+        state.done = true;
+
+        std::coroutine_handle<> h = state.waiter;
+        state.waiter = nullptr;
+        if (h) h.resume();
+      }
+    };
+
+
+    /**
+     * The result of an asynchronous operation.  A Future is shared by copy
+     * between the operation, which calls set() or fail(), and the single
+     * coroutine which awaits it.  The operation starts when the Future is
+     * created, not when it is awaited.
+     */
+    template <typename T>
+    class Future : public FutureBase {
+      struct value_state_t : public state_t {std::optional<T> value;};
+      SmartPointer<value_state_t> state;
+
+    public:
+      Future() : state(new value_state_t) {}
+
+      void set(T value) {state->value = std::move(value); complete();}
+
+      // Awaitable
+      T await_resume() {check(); return std::move(*state->value);}
+
+    protected:
+      state_t &getState() const {return *state;}
+    };
+
+
+    template <>
+    class Future<void> : public FutureBase {
+      SmartPointer<state_t> state;
+
+    public:
+      Future() : state(new state_t) {}
+
+      void set() {complete();}
+
+      // Awaitable
+      void await_resume() {check();}
+
+    protected:
+      state_t &getState() const {return *state;}
+    };
+
+
+    /**
+     * The return type of a coroutine.  The body does not run until start()
+     * is called after which the coroutine owns itself and is freed when it
+     * returns.  Exceptions which escape the body are passed to the error
+     * callback or logged.
+     */
+    class Coroutine {
+    public:
+      typedef std::function<void (std::exception_ptr)> error_cb_t;
+
+      struct promise_type {
+        error_cb_t errorCB;
+
+        Coroutine get_return_object() {
+          return Coroutine
+            (std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept {return {};}
+        std::suspend_never final_suspend() noexcept {return {};}
+        void return_void() {}
+
+        void unhandled_exception() {
+          try {
+            if (errorCB) return errorCB(std::current_exception());
+            std::rethrow_exception(std::current_exception());
+
+          } catch (const Exception &e) {
+            LOG_ERROR("Coroutine: " << e);
+          } catch (const std::exception &e) {
+            LOG_ERROR("Coroutine: " << e.what());
+          } catch (...) {
+            LOG_ERROR("Coroutine: Unknown exception");
+          }
+        }
+      };
+
+    protected:
+      std::coroutine_handle<promise_type> handle;
+
+    public:
+      explicit Coroutine(std::coroutine_handle<promise_type> handle) :
+        handle(handle) {}
+      Coroutine(Coroutine &&o) : handle(o.handle) {o.handle = nullptr;}
+      ~Coroutine() {if (handle) handle.destroy();}
+
+      Coroutine(const Coroutine &) = delete;
+      Coroutine &operator=(const Coroutine &) = delete;
+
+      void start(error_cb_t errorCB = 0) {
+        if (!handle) CBANG_THROW("Coroutine already started");
+        auto h = handle;
+        handle = nullptr;
+        h.promise().errorCB = errorCB;
+        h.resume();
+      }
+    };
+
+
+    /**
+     * Runs a coroutine per request.  The coroutine must take the Request
+     * by SmartPointer value so that it stays alive while suspended.
+     * Uncaught exceptions are sent to the client as errors.
+     */
+    struct HTTPRequestCoroutineHandler : public HTTPRequestHandler {
+      typedef std::function<Coroutine (SmartPointer<Request>)> callback_t;
+      callback_t cb;
+
+      HTTPRequestCoroutineHandler(callback_t cb) : cb(cb) {}
+
+      // From HTTPRequestHandler
+      bool operator()(Request &req) {
+        SmartPointer<Request> ptr = &req;
+
+        cb(ptr).start([ptr] (std::exception_ptr e) {
+          try {
+            std::rethrow_exception(e);
+          } catch (const Exception &e) {
+            ptr->sendError(e);
+          } catch (const std::exception &e) {
+            ptr->sendError(e);
+          } catch (...) {
+            ptr->sendError(HTTP_INTERNAL_SERVER_ERROR);
+          }
+        });
+
+        return true;
+      }
+    };
+
+
+    // Awaitables
+    inline Future<void> sleep(Base &base, double seconds) {
+      Future<void> f;
+      // Not persistent, the Event references itself until it fires
+      base.newEvent([f] () mutable {f.set();}, 0)->add(seconds);
+      return f;
+    }
+
+
+    inline Future<std::vector<IPAddress> >
+    resolve(DNSBase &dns, const std::string &name, bool search = true) {
+      Future<std::vector<IPAddress> > f;
+
+      dns.resolve(name, [f, name] (int error, std::vector<IPAddress> &addrs,
+                                   int ttl) mutable {
+        if (error)
+          f.fail(Exception(SSTR("DNS lookup of '" << name << "' failed: "
+                                << DNSRequest::getErrorStr(error))));
+        else f.set(addrs);
+      }, search);
+
+      return f;
+    }
+
+
+    /// The response, or a connection error, is reported through the Request
+    inline Future<SmartPointer<Request> >
+    call(Client &client, const URI &uri, RequestMethod method,
+         std::string data = std::string()) {
+      Future<SmartPointer<Request> > f;
+
+      auto cb = [f] (Request &req) mutable {f.set(&req);};
+      client.call(uri, method, std::move(data), cb)->send();
+
+      return f;
+    }
+
+
+    /// @param run is called in a pool thread, the result on the event thread
+    template <typename Data>
+    Future<Data> submit(ConcurrentPool &pool, std::function<Data ()> run,
+                        int priority = 0) {
+      Future<Data> f;
+
+      pool.submit<Data>(priority, run,
+                        [f] (Data &data) mutable {f.set(std::move(data));},
+                        [f] (const Exception &e) mutable {f.fail(e);});
+
+      return f;
+    }
+  }
+}
@@ -35,6 +35,10 @@
 #include "Base.h"
 
 #include <cbang/Exception.h>
+#include <cbang/Catch.h>
+#include <cbang/String.h>
+#include <cbang/log/Logger.h>
+#include <cbang/time/Time.h>
 
 #include <event2/dns.h>
 
@@ -61,9 +65,46 @@ void DNSBase::addNameserver(const IPAddress &ns) {
 }
 
 
+void DNSBase::clearCache() {
+  for (auto it = cache.begin(); it != cache.end();)
+    if (it->second.pending) (it++)->second.expires = 0;
+    else cache.erase(it++);
+}
+
+
 SmartPointer<DNSRequest>
 DNSBase::resolve(const string &name, callback_t cb, bool search) {
-  return new DNSRequest(dns, name, cb, search);
+  if (!cacheEnabled) return new DNSRequest(dns, name, cb, search);
+
+  // A trailing dot marks names looked up without search domains
+  string key = String::toLower(name) + (search ? "" : ".");
+  uint64_t now = Time::now();
+
+  auto it = cache.find(key);
+  if (it == cache.end()) {
+    if (maxEntries <= cache.size()) purge(now);
+    it = cache.insert(cache_t::value_type(key, Entry(name, search))).first;
+  }
+
+  Entry &e = it->second;
+  SmartPointer<DNSRequest> req = new DNSRequest(cb);
+
+  if (now < e.expires) {
+    LOG_DEBUG(5, "DNS: cache hit '" << key << "'");
+
+    // Refresh in the background during the last tenth of the TTL
+    if (prefetch && !e.pending && !e.error &&
+        e.expires - now <= max(1U, e.ttl / 10)) lookup(key, e);
+
+    vector<IPAddress> addrs = e.addrs;
+    req->respond(e.error, addrs, e.expires - now);
+
+  } else {
+    e.waiters.push_back(req);
+    if (!e.pending) lookup(key, e);
+  }
+
+  return req;
 }
 
 
@@ -71,3 +112,83 @@ SmartPointer<DNSRequest>
 DNSBase::reverse(uint32_t ip, callback_t cb, bool search) {
   return new DNSRequest(dns, ip, cb, search);
 }
+
+
+void DNSBase::lookup(const string &key, Entry &e) {
+  auto cb =
+    [this, key] (int err, vector<IPAddress> &addrs, int ttl) {
+      lookupCB(key, err, addrs, ttl);
+    };
+
+  e.pending = true;
+
+  try {
+    SmartPointer<DNSRequest> req = new DNSRequest(dns, e.name, cb, e.search);
+    if (e.pending) e.lookup = req; // Callback may be immediate
+
+  } catch (...) {
+    e.pending = false;
+
+    auto waiters = e.waiters;
+    e.waiters.clear();
+    for (auto it = waiters.begin(); it != waiters.end(); it++) (*it)->cancel();
+
+    throw;
+  }
+}
+
+
+void DNSBase::lookupCB(const string &key, int error, vector<IPAddress> &addrs,
+                       int ttl) {
+  auto it = cache.find(key);
+  if (it == cache.end()) return;
+  Entry &e = it->second;
+
+  e.pending = false;
+  e.lookup.release();
+
+  uint64_t now = Time::now();
+
+  switch (error) {
+  case DNS_ERR_NONE:
+    e.error = error;
+    e.addrs = addrs;
+    e.ttl = min((unsigned)max(0, ttl), maxTTL);
+    e.expires = now + e.ttl;
+    break;
+
+  case DNS_ERR_NOTEXIST:
+  case DNS_ERR_NODATA:
+    e.error = error;
+    e.addrs.clear();
+    e.ttl = negativeTTL;
+    e.expires = now + negativeTTL;
+    break;
+
+  default: break; // Transient errors are not cached
+  }
+
+  if (now < e.expires) ttl = e.expires - now;
+
+  auto waiters = e.waiters;
+  e.waiters.clear();
+
+  for (auto it = waiters.begin(); it != waiters.end(); it++) {
+    vector<IPAddress> results = addrs;
+    (*it)->respond(error, results, ttl);
+  }
+}
+
+
+void DNSBase::purge(uint64_t now) {
+  for (auto it = cache.begin(); it != cache.end();) {
+    const Entry &e = it->second;
+    if (!e.pending && e.expires <= now) cache.erase(it++);
+    else it++;
+  }
+
+  // Still full, drop any idle entry
+  for (auto it = cache.begin(); maxEntries <= cache.size() && it != cache.end();)
+    if (it->second.pending) it++;
+    else cache.erase(it++);
+}
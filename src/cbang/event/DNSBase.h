@@ -34,6 +34,9 @@
 
 #include "DNSRequest.h"
 
+#include <map>
+#include <list>
+
 struct evdns_base;
 
 
@@ -42,10 +45,40 @@ namespace cb {
 
     class Base;
 
+    /**
+     * Name lookups are cached, honoring record TTLs up to the maximum TTL.
+     * Non-existent names are cached for the negative TTL.  Concurrent
+     * lookups of the same name share a single DNSRequest.  With prefetch
+     * enabled, a cache hit near expiry refreshes the entry in the background.
+     */
     class DNSBase {
       evdns_base *dns;
       bool failRequestsOnExit;
 
+      struct Entry {
+        std::string name;
+        bool search;
+        int error = 0;
+        std::vector<IPAddress> addrs;
+        uint64_t expires = 0;
+        unsigned ttl = 0;
+        bool pending = false;
+        SmartPointer<DNSRequest> lookup;
+        std::list<SmartPointer<DNSRequest> > waiters;
+
+        Entry(const std::string &name, bool search) :
+          name(name), search(search) {}
+      };
+
+      typedef std::map<std::string, Entry> cache_t;
+      cache_t cache;
+
+      bool cacheEnabled = true;
+      bool prefetch = false;
+      unsigned maxEntries = 1024;
+      unsigned maxTTL = 3600;
+      unsigned negativeTTL = 5;
+
     public:
       DNSBase(Base &base, bool initialize = true,
               bool failRequestsOnExit = true);
@@ -55,6 +88,24 @@ namespace cb {
 
       void addNameserver(const IPAddress &ns);
 
+      bool getCacheEnabled() const {return cacheEnabled;}
+      void setCacheEnabled(bool x) {cacheEnabled = x;}
+
+      bool getPrefetch() const {return prefetch;}
+      void setPrefetch(bool x) {prefetch = x;}
+
+      unsigned getMaxCacheEntries() const {return maxEntries;}
+      void setMaxCacheEntries(unsigned x) {maxEntries = x;}
+
+      unsigned getMaxTTL() const {return maxTTL;}
+      void setMaxTTL(unsigned x) {maxTTL = x;}
+
+      unsigned getNegativeTTL() const {return negativeTTL;}
+      void setNegativeTTL(unsigned x) {negativeTTL = x;}
+
+      unsigned getCacheSize() const {return cache.size();}
+      void clearCache();
+
       typedef std::function<void (int, std::vector<IPAddress> &, int)>
       callback_t;
 
@@ -63,6 +114,12 @@ namespace cb {
               bool search = true);
       SmartPointer<DNSRequest>
       reverse(uint32_t ip, DNSRequest::callback_t cb, bool search = true);
+
+    protected:
+      void lookup(const std::string &key, Entry &e);
+      void lookupCB(const std::string &key, int error,
+                    std::vector<IPAddress> &addrs, int ttl);
+      void purge(uint64_t now);
     };
   }
 }
@@ -77,9 +77,14 @@ DNSRequest::DNSRequest(evdns_base *dns, uint32_t ip, DNSRequest::callback_t cb,
 }
 
 
+DNSRequest::DNSRequest(DNSRequest::callback_t cb) :
+  dns(0), req(0), cb(cb), self(this) {}
+
+
 void DNSRequest::cancel() {
   cb = 0;
-  evdns_cancel_request(dns, req);
+  if (req) evdns_cancel_request(dns, req);
+  else self.release();
 }
 
 
@@ -88,39 +93,45 @@ void DNSRequest::callback(int error, char type, int count, int ttl,
   LOG_DEBUG(5, "DNS: " << getErrorStr(error) << " " << (int)type
             << " " << count << " " << ttl);
 
-  if (cb)
-    try {
-      // Get address results
-      vector<IPAddress> addrs;
-      if (error == DNS_ERR_NONE) {
-        if (type == DNS_IPv4_A) {
-          auto ips = (uint32_t *)addresses;
-
-          for (int i = 0; i < count; i++) {
-            addrs.push_back(IPAddress(hton32(ips[i])));
-            addrs.back().setHost(source.getHost());
-          }
-
-        } else if (type == DNS_PTR) {
-          auto names = (const char **)addresses;
-
-          for (int i = 0; i < count; i++) {
-            addrs.push_back(IPAddress(names[i]));
-            addrs.back().setIP(source.getIP());
-          }
-
-        } else {
-          LOG_ERROR("Unsupported DNS response type " << type);
-          error = DNS_ERR_NOTIMPL;
+  req = 0;
+
+  // Get address results
+  vector<IPAddress> addrs;
+
+  try {
+    if (error == DNS_ERR_NONE) {
+      if (type == DNS_IPv4_A) {
+        auto ips = (uint32_t *)addresses;
+
+        for (int i = 0; i < count; i++) {
+          addrs.push_back(IPAddress(hton32(ips[i])));
+          addrs.back().setHost(source.getHost());
         }
+
+      } else if (type == DNS_PTR) {
+        auto names = (const char **)addresses;
+
+        for (int i = 0; i < count; i++) {
+          addrs.push_back(IPAddress(names[i]));
+          addrs.back().setIP(source.getIP());
+        }
+
+      } else {
+        LOG_ERROR("Unsupported DNS response type " << type);
+        error = DNS_ERR_NOTIMPL;
       }
+    }
+  } CATCH_ERROR;
+
+  respond(error, addrs, ttl);
+}
 
-      // Calback
-      cb(error, addrs, ttl);
 
-    } CATCH_ERROR;
+void DNSRequest::respond(int error, vector<IPAddress> &addrs, int ttl) {
+  SmartPointer<DNSRequest> self = this->self; // Don't deallocate during cb
+  this->self.release();
 
-  self.release();
+  if (cb) TRY_CATCH_ERROR(cb(error, addrs, ttl));
 }
 
 
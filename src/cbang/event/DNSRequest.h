@@ -77,9 +77,12 @@ namespace cb {
                  DNSRequest::callback_t cb, bool search);
       DNSRequest(evdns_base *dns, uint32_t ip, DNSRequest::callback_t cb,
                  bool search);
+      /// A request answered by DNSBase from its cache or a shared lookup
+      DNSRequest(DNSRequest::callback_t cb);
 
       void cancel();
       void callback(int error, char type, int count, int ttl, void *addresses);
+      void respond(int error, std::vector<IPAddress> &addrs, int ttl);
 
       static const char *getErrorStr(int error);
     };
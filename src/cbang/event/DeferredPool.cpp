@@ -0,0 +1,103 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "DeferredPool.h"
+#include "Base.h"
+
+#include <cbang/Catch.h>
+#include <cbang/time/Timer.h>
+
+#include <event2/event.h>
+
+using namespace cb::Event;
+
+
+DeferredPool::Slot::Slot(DeferredPool &pool) :
+  pool(pool), e(event_new(pool.base.getBase(), -1, 0, &callback, this)) {
+  if (!e) THROW("Failed to create event");
+}
+
+
+DeferredPool::Slot::~Slot() {event_free(e);}
+
+
+void DeferredPool::Slot::call() {
+  pool.pending--;
+
+  // Free the callable, and any objects it holds, before returning the slot
+  TRY_CATCH_ERROR(cb());
+  cb.clear();
+  pool.release(this);
+}
+
+
+void DeferredPool::Slot::callback(int fd, short flags, void *arg) {
+  ((Slot *)arg)->call();
+}
+
+
+DeferredPool::~DeferredPool() {
+  for (auto slot: slots) delete slot;
+}
+
+
+DeferredPool::Slot *DeferredPool::allocate() {
+  if (!freeList) {
+    slots.reserve(slots.size() + 1);
+    slots.push_back(new Slot(*this));
+    return slots.back();
+  }
+
+  Slot *slot = freeList;
+  freeList = slot->nextFree;
+  return slot;
+}
+
+
+void DeferredPool::release(Slot *slot) {
+  slot->nextFree = freeList;
+  freeList = slot;
+}
+
+
+void DeferredPool::add(callback_t cb, double delay) {
+  Slot *slot = allocate();
+  slot->cb = std::move(cb);
+  pending++;
+
+  if (delay <= 0) event_active(slot->e, EV_TIMEOUT, 1);
+  else {
+    struct timeval tv = Timer::toTimeVal(delay);
+    event_add(slot->e, &tv);
+  }
+}
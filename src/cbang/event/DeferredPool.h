@@ -0,0 +1,98 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cbang/StdTypes.h>
+#include <cbang/util/InlineFunction.h>
+
+#include <vector>
+
+struct event;
+
+
+namespace cb {
+  namespace Event {
+    class Base;
+
+    /**
+     * Recycles one-shot timer events for Base::defer().  Each slot keeps its
+     * libevent event and stores the callback inline, so once the pool has
+     * grown to the number of calls pending at once scheduling allocates
+     * nothing.  Callables larger than the inline buffer are moved to the
+     * heap.  Not thread safe.
+     */
+    class DeferredPool {
+    public:
+      static const unsigned inlineSize = 48;
+      typedef InlineFunction<void (), inlineSize> callback_t;
+
+      class Slot {
+        friend class DeferredPool;
+
+        DeferredPool &pool;
+        event *e;
+        Slot *nextFree = 0;
+        callback_t cb;
+
+        Slot(DeferredPool &pool);
+        ~Slot();
+
+        void call();
+
+      public:
+        static void callback(int fd, short flags, void *arg);
+      };
+
+    protected:
+      Base &base;
+      std::vector<Slot *> slots;
+      Slot *freeList = 0;
+      unsigned pending = 0;
+
+    public:
+      DeferredPool(Base &base) : base(base) {}
+      ~DeferredPool();
+
+      unsigned getSize() const {return slots.size();}
+      unsigned getPending() const {return pending;}
+
+      /// Call @param cb once on the event loop after @param delay seconds
+      void add(callback_t cb, double delay = 0);
+
+    protected:
+      Slot *allocate();
+      void release(Slot *slot);
+    };
+  }
+}
@@ -56,7 +56,7 @@ namespace {
 Event::Event(Base &base, cb::socket_t fdOrSignal, callback_t cb,
              unsigned flags) :
   e(event_new(base.getBase(), fdOrSignal, flags & 0xff, event_cb, this)),
-  cb(cb), selfReferencing(!(flags & EVENT_NO_SELF_REF)) {
+  cb(std::move(cb)), selfReferencing(!(flags & EVENT_NO_SELF_REF)) {
   if (!e) THROW("Failed to create event");
 }
 
@@ -107,7 +107,7 @@ int Event::getPriority() const {return event_get_priority(e);}
 
 void Event::assign(Base &base, int fd, unsigned events, callback_t cb) {
   del();
-  this->cb = cb;
+  this->cb = std::move(cb);
   event_assign(e, base.getBase(), fd, events, event_cb, this);
 }
 
@@ -61,8 +61,8 @@ namespace cb {
 
       event *getEvent() const {return e;}
 
-      callback_t getCallback() const {return cb;}
-      void setCallback(callback_t cb) {this->cb = cb;}
+      const callback_t &getCallback() const {return cb;}
+      void setCallback(callback_t cb) {this->cb = std::move(cb);}
 
       bool getSelfReferencing() const {return selfReferencing;}
       void setSelfReferencing(bool enable);
@@ -0,0 +1,253 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "FanOut.h"
+#include "Client.h"
+#include "Base.h"
+#include "Event.h"
+#include "OutgoingRequest.h"
+
+#include <cbang/Catch.h>
+#include <cbang/time/Timer.h>
+#include <cbang/util/Histogram.h>
+#include <cbang/log/Logger.h>
+
+using namespace std;
+using namespace cb::Event;
+
+
+bool FanOut::Result::isOk() const {return req.isSet() && req->isOk();}
+
+
+FanOut::FanOut(Client &client, callback_t cb) :
+  client(client), cb(cb), latency(new Histogram) {}
+
+
+FanOut::~FanOut() {}
+
+
+double FanOut::getCurrentHedgeDelay() const {
+  if (latency.isNull() || latency->getCount() < minSamples) return hedgeDelay;
+  return latency->getPercentile(hedgePercentile) / 1e6;
+}
+
+
+unsigned FanOut::add(const vector<URI> &replicas, RequestMethod method,
+                     const string &data, double deadline) {
+  if (running) THROW("Cannot add to FanOut after send()");
+  if (replicas.empty()) THROW("FanOut request needs at least one replica");
+
+  calls.push_back(call_t());
+  call_t &c = calls.back();
+  c.replicas = replicas;
+  c.method = method;
+  c.data = data;
+  c.deadline = deadline;
+
+  return calls.size() - 1;
+}
+
+
+unsigned FanOut::add(const URI &uri, RequestMethod method,
+                     const string &data, double deadline) {
+  return add(vector<URI>(1, uri), method, data, deadline);
+}
+
+
+void FanOut::send() {
+  if (running) THROW("FanOut already sent");
+  if (!getRefCount()) THROW("FanOut must be held by a SmartPointer");
+
+  SmartPointer<FanOut> self = this; // Don't deallocate during send
+  running = true;
+  remaining = calls.size();
+  results.resize(calls.size());
+
+  if (!remaining) return complete();
+
+  Base &base = client.getBase();
+
+  for (unsigned i = 0; i < calls.size(); i++) {
+    call_t &c = calls[i];
+    double deadline = c.deadline ? c.deadline : this->deadline;
+
+    if (deadline) {
+      c.deadlineEvent = base.newEvent([this, i] () {deadlineCB(i);},
+                                      EVENT_NO_SELF_REF);
+      c.deadlineEvent->add(deadline);
+    }
+
+    if (sendNext(i, false)) scheduleHedge(i);
+  }
+}
+
+
+void FanOut::cancel() {
+  if (!running) return;
+
+  SmartPointer<FanOut> self = this; // Don't deallocate during callbacks
+
+  for (unsigned i = 0; i < calls.size() && running; i++)
+    if (!calls[i].done) finish(i, 0, 0, false);
+}
+
+
+bool FanOut::sendNext(unsigned index, bool hedged) {
+  call_t &c = calls[index];
+  if (c.done || c.replicas.size() <= c.next) return false;
+
+  attempt_t attempt;
+  attempt.replica = c.next++;
+  attempt.hedged = hedged;
+  attempt.start = Timer::monotonic();
+
+  unsigned a = c.attempts.size();
+  if (hedged) c.hedges++;
+
+  // The callback holds a reference so the FanOut outlives its requests
+  SmartPointer<FanOut> self = this;
+  auto cb = [self, index, a] (Request &req) {self->responseCB(index, a, req);};
+
+  attempt.req = client.call(c.replicas[attempt.replica], c.method, c.data, cb);
+  c.attempts.push_back(attempt);
+
+  LOG_DEBUG(4, "FanOut " << index << (hedged ? " hedging " : " sending ")
+            << c.replicas[attempt.replica]);
+
+  attempt.req->send();
+
+  return true;
+}
+
+
+void FanOut::scheduleHedge(unsigned index) {
+  call_t &c = calls[index];
+  if (c.done || maxHedges <= c.hedges || c.replicas.size() <= c.next) return;
+
+  if (c.hedgeEvent.isNull())
+    c.hedgeEvent = client.getBase().newEvent
+      ([this, index] () {hedgeCB(index);}, EVENT_NO_SELF_REF);
+
+  c.hedgeEvent->add(getCurrentHedgeDelay());
+}
+
+
+void FanOut::finish(unsigned index, const SmartPointer<Request> &req,
+                    unsigned replica, bool timedout) {
+  call_t &c = calls[index];
+  if (c.done) return;
+  c.done = true;
+
+  Result &result = results[index];
+  result.req = req.isSet() ? req : c.failure;
+  result.replica = req.isSet() ? replica : c.failureReplica;
+  result.timedout = timedout;
+
+  if (c.hedgeEvent.isSet()) c.hedgeEvent->del();
+  if (c.deadlineEvent.isSet()) c.deadlineEvent->del();
+
+  // Cancel the losers, their callbacks see done and return
+  vector<attempt_t> attempts;
+  attempts.swap(c.attempts);
+
+  for (unsigned i = 0; i < attempts.size(); i++) {
+    const SmartPointer<OutgoingRequest> &loser = attempts[i].req;
+    if (loser.isSet() && loser->hasConnection())
+      TRY_CATCH_ERROR(loser->cancel());
+  }
+
+  if (!--remaining) complete();
+}
+
+
+void FanOut::complete() {
+  running = false;
+
+  // Release requests, whose callbacks reference this FanOut
+  for (unsigned i = 0; i < calls.size(); i++) {
+    calls[i].attempts.clear();
+    calls[i].failure.release();
+    calls[i].hedgeEvent.release();
+    calls[i].deadlineEvent.release();
+  }
+
+  results_t results;
+  results.swap(this->results);
+
+  if (cb) TRY_CATCH_ERROR(cb(results));
+}
+
+
+void FanOut::responseCB(unsigned index, unsigned a, Request &req) {
+  call_t &c = calls[index];
+  if (c.done || c.attempts.size() <= a) return;
+
+  attempt_t &attempt = c.attempts[a];
+  SmartPointer<Request> ptr = attempt.req;
+  unsigned replica = attempt.replica;
+  attempt.req.release();
+
+  bool failed = req.getConnectionError() || 500 <= req.getResponseCode();
+
+  if (!failed) {
+    if (latency.isSet())
+      latency->record((uint64_t)((Timer::monotonic() - attempt.start) * 1e6));
+
+    if (attempt.hedged) results[index].hedged = true;
+    return finish(index, ptr, replica, false);
+  }
+
+  LOG_DEBUG(4, "FanOut " << index << " failed " << c.replicas[replica]);
+  c.failure = ptr;
+  c.failureReplica = replica;
+
+  // Fail over unless another attempt is still in flight
+  for (unsigned i = 0; i < c.attempts.size(); i++)
+    if (c.attempts[i].req.isSet()) return;
+
+  if (sendNext(index, false)) return scheduleHedge(index);
+
+  finish(index, ptr, replica, false);
+}
+
+
+void FanOut::hedgeCB(unsigned index) {
+  SmartPointer<FanOut> self = this; // Don't deallocate during callback
+  if (sendNext(index, true)) scheduleHedge(index);
+}
+
+
+void FanOut::deadlineCB(unsigned index) {
+  SmartPointer<FanOut> self = this; // Don't deallocate during callback
+  LOG_DEBUG(4, "FanOut " << index << " deadline expired");
+  finish(index, 0, 0, true);
+}
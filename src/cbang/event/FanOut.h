@@ -0,0 +1,180 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Enum.h"
+
+#include <cbang/SmartPointer.h>
+#include <cbang/net/URI.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+
+namespace cb {
+  class Histogram;
+
+  namespace Event {
+    class Client;
+    class Event;
+    class Request;
+    class OutgoingRequest;
+
+    /**
+     * Sends several requests in parallel and calls back once with all of
+     * the results.  Each request may list several replicas.  If the first
+     * replica has not answered after the hedge delay a duplicate is sent to
+     * the next one and whichever answers first wins, the others are
+     * cancelled.  Connection errors and 5xx responses fail over to the next
+     * replica immediately.  Requests which have not finished by their
+     * deadline are cancelled and reported as timed out.
+     *
+     * The hedge delay is the configured percentile of the latencies seen so
+     * far, once enough have been recorded.  Share one Histogram between
+     * FanOuts calling the same backends so they learn from each other.
+     */
+    class FanOut : public RefCounted, public Enum {
+    public:
+      struct Result {
+        /// The winning response or the last failure, null if none arrived
+        SmartPointer<Request> req;
+        unsigned replica = 0;
+        bool hedged = false;
+        bool timedout = false;
+
+        bool isOk() const;
+      };
+
+      typedef std::vector<Result> results_t;
+      typedef std::function<void (results_t &results)> callback_t;
+
+    protected:
+      struct attempt_t {
+        SmartPointer<OutgoingRequest> req;
+        unsigned replica;
+        bool hedged;
+        double start;
+      };
+
+      struct call_t {
+        std::vector<URI> replicas;
+        RequestMethod method;
+        std::string data;
+        double deadline;
+
+        unsigned next = 0;
+        unsigned hedges = 0;
+        bool done = false;
+        std::vector<attempt_t> attempts;
+        SmartPointer<Request> failure;
+        unsigned failureReplica = 0;
+        SmartPointer<Event> hedgeEvent;
+        SmartPointer<Event> deadlineEvent;
+      };
+
+      Client &client;
+      callback_t cb;
+
+      double deadline = 0;
+      double hedgeDelay = 0.05;
+      double hedgePercentile = 95;
+      unsigned maxHedges = 1;
+      unsigned minSamples = 20;
+      SmartPointer<Histogram> latency;
+
+      std::vector<call_t> calls;
+      results_t results;
+      unsigned remaining = 0;
+      bool running = false;
+
+    public:
+      FanOut(Client &client, callback_t cb);
+      ~FanOut();
+
+      double getDeadline() const {return deadline;}
+      /// Default seconds allowed per request, zero for none
+      void setDeadline(double x) {deadline = x;}
+
+      double getHedgeDelay() const {return hedgeDelay;}
+      /// Seconds to wait before hedging until the Histogram is warm
+      void setHedgeDelay(double x) {hedgeDelay = x;}
+
+      double getHedgePercentile() const {return hedgePercentile;}
+      void setHedgePercentile(double x) {hedgePercentile = x;}
+
+      unsigned getMaxHedges() const {return maxHedges;}
+      /// Zero disables hedging, failover still applies
+      void setMaxHedges(unsigned x) {maxHedges = x;}
+
+      unsigned getMinSamples() const {return minSamples;}
+      void setMinSamples(unsigned x) {minSamples = x;}
+
+      const SmartPointer<Histogram> &getLatency() const {return latency;}
+      /// Microsecond latencies of successful requests
+      void setLatency(const SmartPointer<Histogram> &x) {latency = x;}
+
+      /// @return The current hedge delay in seconds
+      double getCurrentHedgeDelay() const;
+
+      /// @param deadline overrides the default deadline when non-zero
+      unsigned add(const std::vector<URI> &replicas,
+                   RequestMethod method = HTTP_GET,
+                   const std::string &data = std::string(),
+                   double deadline = 0);
+      unsigned add(const URI &uri, RequestMethod method = HTTP_GET,
+                   const std::string &data = std::string(),
+                   double deadline = 0);
+
+      unsigned getCount() const {return calls.size();}
+      bool isRunning() const {return running;}
+
+      void send();
+      /// Cancel outstanding requests and call back with what has arrived
+      void cancel();
+
+    protected:
+      bool sendNext(unsigned index, bool hedged);
+      void scheduleHedge(unsigned index);
+      void finish(unsigned index, const SmartPointer<Request> &req,
+                  unsigned replica, bool timedout);
+      void complete();
+
+      void responseCB(unsigned index, unsigned attempt, Request &req);
+      void hedgeCB(unsigned index);
+      void deadlineCB(unsigned index);
+    };
+
+    typedef SmartPointer<FanOut> FanOutPtr;
+  }
+}
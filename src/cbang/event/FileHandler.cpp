@@ -32,7 +32,7 @@
 
 #include "FileHandler.h"
 #include "Request.h"
-#include "Buffer.h"
+#include "HTTPError.h"
 
 #include <cbang/os/SystemUtilities.h>
 #include <cbang/log/Logger.h>
@@ -47,6 +47,25 @@ FileHandler::FileHandler(const string &root, uint64_t timeout) :
 }
 
 
+string FileHandler::normalize(const string &path) {
+  // Remove unsafe parts
+  vector<string> parts;
+  String::tokenize(path, parts, "/");
+  vector<string> result;
+
+  for (unsigned i = 0; i < parts.size(); i++) {
+    if (parts[i] == ".") continue;
+    if (parts[i] == "..") {
+      if (result.empty()) THROW_HTTP("Invalid path", HTTP_UNAUTHORIZED);
+      result.pop_back();
+
+    } else result.push_back(parts[i]);
+  }
+
+  return String::join(result, "/");
+}
+
+
 bool FileHandler::operator()(Request &req) {
   string path;
 
@@ -54,22 +73,8 @@ bool FileHandler::operator()(Request &req) {
     string orig = req.getURI().getPath();
     if (orig.empty()) return false;
 
-    // Remove unsafe parts
-    vector<string> parts;
-    String::tokenize(orig, parts, "/");
-    vector<string> result;
-
-    for (unsigned i = 0; i < parts.size(); i++) {
-      if (parts[i] == ".") continue;
-      if (parts[i] == "..") {
-        if (result.empty()) THROWX("Invalid path", HTTP_UNAUTHORIZED);
-        result.pop_back();
-
-      } else result.push_back(parts[i]);
-    }
-
     // Relative to root
-    path = SystemUtilities::joinPath(root, String::join(result, "/"));
+    path = SystemUtilities::joinPath(root, normalize(orig));
     if (path.back() != '/' && orig.back() == '/') path += "/";
 
   } else path = root; // Single file
@@ -78,13 +83,24 @@ bool FileHandler::operator()(Request &req) {
 
   if (!SystemUtilities::isFile(path)) return false;
 
-  // Send file
-  Buffer buf;
-  buf.addFile(path);
-  req.reply(buf);
-
   if (!req.outHas("Cache-Control"))
     req.outSet("Cache-Control", "max-age=" + String(timeout));
 
+  // Validators
+  uint64_t size = SystemUtilities::getFileSize(path);
+  uint64_t modified = SystemUtilities::getModificationTime(path);
+  string etag = String::printf("\"%llx-%llx\"", (long long unsigned)modified,
+                               (long long unsigned)size);
+
+  if (req.checkNotModified(etag, modified)) return true;
+
+  // Send all or part of the file
+  uint64_t offset;
+  uint64_t length;
+  HTTPStatus code = req.getRange(size, offset, length);
+
+  if (code == HTTP_REQUESTED_RANGE_NOT_SATISFIABLE) req.reply(code);
+  else req.replyFile(path, code, offset, length);
+
   return true;
 }
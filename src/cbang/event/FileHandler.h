@@ -55,6 +55,9 @@ namespace cb {
       void setTimeout(uint64_t timeout) {this->timeout = timeout;}
       uint64_t getTimeout() const {return timeout;}
 
+      /// Resolve "." and ".." in a request path, which may not leave root
+      static std::string normalize(const std::string &path);
+
       // From HTTPRequestHandler
       bool operator()(Request &req);
     };
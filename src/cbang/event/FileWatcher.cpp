@@ -0,0 +1,96 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "FileWatcher.h"
+#include "Base.h"
+#include "Event.h"
+
+#include <cbang/Catch.h>
+#include <cbang/xml/XMLFileTracker.h>
+
+#include <vector>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+FileWatcher::FileWatcher(Base &base, double pollInterval) : base(base) {
+  unsigned flags = EF::EVENT_PERSIST | EF::EVENT_NO_SELF_REF;
+
+  if (FileNotifier::isSupported()) {
+    event = base.newEvent(notifier.getFD(), this, &FileWatcher::readCB,
+                          flags | EF::EVENT_READ);
+    event->add();
+
+  } else {
+    event = base.newEvent(this, &FileWatcher::readCB, flags);
+    event->add(pollInterval);
+  }
+}
+
+
+FileWatcher::~FileWatcher() {event->del();}
+
+
+void FileWatcher::add(const string &path, callback_t cb) {
+  if (!callbacks.count(path)) notifier.add(path);
+  callbacks[path] = cb;
+}
+
+
+void FileWatcher::add(const XMLFileTracker &tracker, callback_t cb) {
+  for (auto &path: tracker.getFiles()) add(path, cb);
+}
+
+
+void FileWatcher::remove(const string &path) {
+  if (callbacks.erase(path)) notifier.remove(path);
+}
+
+
+void FileWatcher::readCB() {
+  vector<FileNotifier::event_t> events;
+  if (!notifier.read(events)) return;
+
+  map<string, unsigned> changes;
+  for (auto &e: events) changes[e.path] |= e.flags;
+
+  for (auto &p: changes) {
+    // Callbacks may add or remove watches
+    auto it = callbacks.find(p.first);
+    if (it == callbacks.end()) continue;
+    callback_t cb = it->second;
+
+    TRY_CATCH_ERROR(cb(p.first, p.second));
+  }
+}
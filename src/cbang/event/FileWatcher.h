@@ -0,0 +1,85 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+#include <cbang/os/FileNotifier.h>
+
+#include <functional>
+#include <string>
+#include <map>
+
+
+namespace cb {
+  class XMLFileTracker;
+
+  namespace Event {
+    class Base;
+    class Event;
+
+    /**
+     * Calls back on the event loop when watched files change.  Uses a
+     * FileNotifier whose descriptor is watched by the Base or, where
+     * FileNotifier is not supported, a timer which polls the files.
+     *
+     * Changes read together are merged so each file gets at most one
+     * callback per pass with the FileNotifier::FILE_* flags combined.
+     */
+    class FileWatcher {
+    public:
+      typedef std::function<void (const std::string &path,
+                                  unsigned flags)> callback_t;
+
+    protected:
+      Base &base;
+      FileNotifier notifier;
+      SmartPointer<Event> event;
+      std::map<std::string, callback_t> callbacks;
+
+    public:
+      FileWatcher(Base &base, double pollInterval = 1);
+      ~FileWatcher();
+
+      void add(const std::string &path, callback_t cb);
+      /// Watch every file @param tracker has read, e.g. to reload config
+      void add(const XMLFileTracker &tracker, callback_t cb);
+      void remove(const std::string &path);
+
+      bool has(const std::string &path) const {return callbacks.count(path);}
+      unsigned size() const {return callbacks.size();}
+
+    protected:
+      void readCB();
+    };
+  }
+}
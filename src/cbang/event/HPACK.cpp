@@ -0,0 +1,413 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "HPACK.h"
+
+#include <cbang/Exception.h>
+
+using namespace std;
+using namespace cb::Event;
+
+
+namespace {
+  const HPACK::header_t staticTable[] = {
+    {":authority", ""},
+    {":method", "GET"},
+    {":method", "POST"},
+    {":path", "/"},
+    {":path", "/index.html"},
+    {":scheme", "http"},
+    {":scheme", "https"},
+    {":status", "200"},
+    {":status", "204"},
+    {":status", "206"},
+    {":status", "304"},
+    {":status", "400"},
+    {":status", "404"},
+    {":status", "500"},
+    {"accept-charset", ""},
+    {"accept-encoding", "gzip, deflate"},
+    {"accept-language", ""},
+    {"accept-ranges", ""},
+    {"accept", ""},
+    {"access-control-allow-origin", ""},
+    {"age", ""},
+    {"allow", ""},
+    {"authorization", ""},
+    {"cache-control", ""},
+    {"content-disposition", ""},
+    {"content-encoding", ""},
+    {"content-language", ""},
+    {"content-length", ""},
+    {"content-location", ""},
+    {"content-range", ""},
+    {"content-type", ""},
+    {"cookie", ""},
+    {"date", ""},
+    {"etag", ""},
+    {"expect", ""},
+    {"expires", ""},
+    {"from", ""},
+    {"host", ""},
+    {"if-match", ""},
+    {"if-modified-since", ""},
+    {"if-none-match", ""},
+    {"if-range", ""},
+    {"if-unmodified-since", ""},
+    {"last-modified", ""},
+    {"link", ""},
+    {"location", ""},
+    {"max-forwards", ""},
+    {"proxy-authenticate", ""},
+    {"proxy-authorization", ""},
+    {"range", ""},
+    {"referer", ""},
+    {"refresh", ""},
+    {"retry-after", ""},
+    {"server", ""},
+    {"set-cookie", ""},
+    {"strict-transport-security", ""},
+    {"transfer-encoding", ""},
+    {"user-agent", ""},
+    {"vary", ""},
+    {"via", ""},
+    {"www-authenticate", ""},
+  };
+
+  // Huffman codes and their lengths in bits, RFC 7541 Appendix B
+  const uint32_t huffmanCodes[] = {
+    0x00001ff8, 0x007fffd8, 0x0fffffe2, 0x0fffffe3, 0x0fffffe4, 0x0fffffe5,
+    0x0fffffe6, 0x0fffffe7, 0x0fffffe8, 0x00ffffea, 0x3ffffffc, 0x0fffffe9,
+    0x0fffffea, 0x3ffffffd, 0x0fffffeb, 0x0fffffec, 0x0fffffed, 0x0fffffee,
+    0x0fffffef, 0x0ffffff0, 0x0ffffff1, 0x0ffffff2, 0x3ffffffe, 0x0ffffff3,
+    0x0ffffff4, 0x0ffffff5, 0x0ffffff6, 0x0ffffff7, 0x0ffffff8, 0x0ffffff9,
+    0x0ffffffa, 0x0ffffffb, 0x00000014, 0x000003f8, 0x000003f9, 0x00000ffa,
+    0x00001ff9, 0x00000015, 0x000000f8, 0x000007fa, 0x000003fa, 0x000003fb,
+    0x000000f9, 0x000007fb, 0x000000fa, 0x00000016, 0x00000017, 0x00000018,
+    0x00000000, 0x00000001, 0x00000002, 0x00000019, 0x0000001a, 0x0000001b,
+    0x0000001c, 0x0000001d, 0x0000001e, 0x0000001f, 0x0000005c, 0x000000fb,
+    0x00007ffc, 0x00000020, 0x00000ffb, 0x000003fc, 0x00001ffa, 0x00000021,
+    0x0000005d, 0x0000005e, 0x0000005f, 0x00000060, 0x00000061, 0x00000062,
+    0x00000063, 0x00000064, 0x00000065, 0x00000066, 0x00000067, 0x00000068,
+    0x00000069, 0x0000006a, 0x0000006b, 0x0000006c, 0x0000006d, 0x0000006e,
+    0x0000006f, 0x00000070, 0x00000071, 0x00000072, 0x000000fc, 0x00000073,
+    0x000000fd, 0x00001ffb, 0x0007fff0, 0x00001ffc, 0x00003ffc, 0x00000022,
+    0x00007ffd, 0x00000003, 0x00000023, 0x00000004, 0x00000024, 0x00000005,
+    0x00000025, 0x00000026, 0x00000027, 0x00000006, 0x00000074, 0x00000075,
+    0x00000028, 0x00000029, 0x0000002a, 0x00000007, 0x0000002b, 0x00000076,
+    0x0000002c, 0x00000008, 0x00000009, 0x0000002d, 0x00000077, 0x00000078,
+    0x00000079, 0x0000007a, 0x0000007b, 0x00007ffe, 0x000007fc, 0x00003ffd,
+    0x00001ffd, 0x0ffffffc, 0x000fffe6, 0x003fffd2, 0x000fffe7, 0x000fffe8,
+    0x003fffd3, 0x003fffd4, 0x003fffd5, 0x007fffd9, 0x003fffd6, 0x007fffda,
+    0x007fffdb, 0x007fffdc, 0x007fffdd, 0x007fffde, 0x00ffffeb, 0x007fffdf,
+    0x00ffffec, 0x00ffffed, 0x003fffd7, 0x007fffe0, 0x00ffffee, 0x007fffe1,
+    0x007fffe2, 0x007fffe3, 0x007fffe4, 0x001fffdc, 0x003fffd8, 0x007fffe5,
+    0x003fffd9, 0x007fffe6, 0x007fffe7, 0x00ffffef, 0x003fffda, 0x001fffdd,
+    0x000fffe9, 0x003fffdb, 0x003fffdc, 0x007fffe8, 0x007fffe9, 0x001fffde,
+    0x007fffea, 0x003fffdd, 0x003fffde, 0x00fffff0, 0x001fffdf, 0x003fffdf,
+    0x007fffeb, 0x007fffec, 0x001fffe0, 0x001fffe1, 0x003fffe0, 0x001fffe2,
+    0x007fffed, 0x003fffe1, 0x007fffee, 0x007fffef, 0x000fffea, 0x003fffe2,
+    0x003fffe3, 0x003fffe4, 0x007ffff0, 0x003fffe5, 0x003fffe6, 0x007ffff1,
+    0x03ffffe0, 0x03ffffe1, 0x000fffeb, 0x0007fff1, 0x003fffe7, 0x007ffff2,
+    0x003fffe8, 0x01ffffec, 0x03ffffe2, 0x03ffffe3, 0x03ffffe4, 0x07ffffde,
+    0x07ffffdf, 0x03ffffe5, 0x00fffff1, 0x01ffffed, 0x0007fff2, 0x001fffe3,
+    0x03ffffe6, 0x07ffffe0, 0x07ffffe1, 0x03ffffe7, 0x07ffffe2, 0x00fffff2,
+    0x001fffe4, 0x001fffe5, 0x03ffffe8, 0x03ffffe9, 0x0ffffffd, 0x07ffffe3,
+    0x07ffffe4, 0x07ffffe5, 0x000fffec, 0x00fffff3, 0x000fffed, 0x001fffe6,
+    0x003fffe9, 0x001fffe7, 0x001fffe8, 0x007ffff3, 0x003fffea, 0x003fffeb,
+    0x01ffffee, 0x01ffffef, 0x00fffff4, 0x00fffff5, 0x03ffffea, 0x007ffff4,
+    0x03ffffeb, 0x07ffffe6, 0x03ffffec, 0x03ffffed, 0x07ffffe7, 0x07ffffe8,
+    0x07ffffe9, 0x07ffffea, 0x07ffffeb, 0x0ffffffe, 0x07ffffec, 0x07ffffed,
+    0x07ffffee, 0x07ffffef, 0x07fffff0, 0x03ffffee,
+    0x3fffffff, // EOS
+  };
+
+  const uint8_t huffmanLengths[] = {
+    13, 23, 28, 28, 28, 28, 28, 28, 28, 24, 30, 28, 28, 30, 28, 28,
+    28, 28, 28, 28, 28, 28, 30, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+    6, 10, 10, 12, 13, 6, 8, 11, 10, 10, 8, 11, 8, 6, 6, 6,
+    5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 7, 8, 15, 6, 12, 10,
+    13, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+    7, 7, 7, 7, 7, 7, 7, 7, 8, 7, 8, 13, 19, 13, 14, 6,
+    15, 5, 6, 5, 6, 5, 6, 6, 6, 5, 7, 7, 6, 6, 6, 5,
+    6, 7, 6, 5, 5, 6, 7, 7, 7, 7, 7, 15, 11, 14, 13, 28,
+    20, 22, 20, 20, 22, 22, 22, 23, 22, 23, 23, 23, 23, 23, 24, 23,
+    24, 24, 22, 23, 24, 23, 23, 23, 23, 21, 22, 23, 22, 23, 23, 24,
+    22, 21, 20, 22, 22, 23, 23, 21, 23, 22, 22, 24, 21, 22, 23, 23,
+    21, 21, 22, 21, 23, 22, 23, 23, 20, 22, 22, 22, 23, 22, 22, 23,
+    26, 26, 20, 19, 22, 23, 22, 25, 26, 26, 26, 27, 27, 26, 24, 25,
+    19, 21, 26, 27, 27, 26, 27, 24, 21, 21, 26, 26, 28, 27, 27, 27,
+    20, 24, 20, 21, 22, 21, 21, 23, 22, 22, 25, 25, 24, 24, 26, 23,
+    26, 27, 26, 26, 27, 27, 27, 27, 27, 28, 27, 27, 27, 27, 27, 26,
+    30, // EOS
+  };
+
+
+  const unsigned staticTableLength =
+    sizeof(staticTable) / sizeof(HPACK::header_t);
+
+
+  struct HuffmanTree {
+    struct Node {
+      int next[2] = {-1, -1};
+      int symbol = -1;
+    };
+
+    vector<Node> nodes;
+
+    HuffmanTree() {
+      nodes.push_back(Node());
+
+      for (unsigned sym = 0; sym < 257; sym++) {
+        unsigned node = 0;
+
+        for (int bit = huffmanLengths[sym] - 1; 0 <= bit; bit--) {
+          unsigned b = (huffmanCodes[sym] >> bit) & 1;
+
+          if (nodes[node].next[b] < 0) {
+            nodes[node].next[b] = nodes.size();
+            nodes.push_back(Node());
+          }
+
+          node = nodes[node].next[b];
+        }
+
+        nodes[node].symbol = sym;
+      }
+    }
+
+
+    static const HuffmanTree &instance() {
+      static HuffmanTree tree;
+      return tree;
+    }
+  };
+}
+
+
+void HPACK::setMaxTableSize(unsigned size) {
+  maxTableSize = size;
+  evict(0);
+}
+
+
+const HPACK::header_t &HPACK::lookup(unsigned index) const {
+  if (!index) THROW("Invalid HPACK index 0");
+  if (index <= staticTableLength) return staticTable[index - 1];
+
+  index -= staticTableLength + 1;
+  if (table.size() <= index) THROW("HPACK index " << index << " out of range");
+
+  return table[index];
+}
+
+
+void HPACK::insert(const header_t &header) {
+  unsigned size = getEntrySize(header);
+
+  evict(size);
+
+  // An entry larger than the table empties it and is not added
+  if (size <= maxTableSize) {
+    table.push_front(header);
+    tableSize += size;
+  }
+}
+
+
+unsigned HPACK::getStaticTableLength() {return staticTableLength;}
+
+
+string HPACK::huffmanDecode(const uint8_t *data, unsigned length) {
+  const HuffmanTree &tree = HuffmanTree::instance();
+  string s;
+  unsigned node = 0;
+  unsigned padding = 0;
+  bool ones = true;
+
+  for (unsigned i = 0; i < length; i++)
+    for (int bit = 7; 0 <= bit; bit--) {
+      unsigned b = (data[i] >> bit) & 1;
+      int next = tree.nodes[node].next[b];
+      if (next < 0) THROW("Invalid Huffman code");
+
+      padding++;
+      ones = ones && b;
+
+      int sym = tree.nodes[next].symbol;
+      if (sym == 256) THROW("Huffman EOS in string");
+
+      if (0 <= sym) {
+        s.push_back((char)sym);
+        node = 0;
+        padding = 0;
+        ones = true;
+
+      } else node = next;
+    }
+
+  // Padding must be a prefix of EOS and shorter than 8 bits
+  if (7 < padding || !ones) THROW("Invalid Huffman padding");
+
+  return s;
+}
+
+
+void HPACK::evict(unsigned size) {
+  while (!table.empty() && maxTableSize < tableSize + size) {
+    tableSize -= getEntrySize(table.back());
+    table.pop_back();
+  }
+}
+
+
+void HPACKDecoder::decode(const string &block, headers_t &headers) {
+  const uint8_t *ptr = (const uint8_t *)block.data();
+  const uint8_t *end = ptr + block.length();
+  bool first = true;
+
+  while (ptr < end) {
+    uint8_t c = *ptr;
+
+    if (c & 0x80) // Indexed
+      headers.push_back(lookup(decodeInt(ptr, end, 7)));
+
+    else if ((c & 0xe0) == 0x20) { // Dynamic table size update
+      if (!first) THROW("HPACK table size update after header");
+      uint64_t size = decodeInt(ptr, end, 5);
+      if (maxAllowedTableSize < size)
+        THROW("HPACK table size " << size << " exceeds limit");
+      setMaxTableSize(size);
+      continue;
+
+    } else {
+      // Literal with incremental indexing, without indexing or never indexed
+      bool indexing = (c & 0xc0) == 0x40;
+      uint64_t index = decodeInt(ptr, end, indexing ? 6 : 4);
+
+      header_t header;
+      if (index) header.first = lookup(index).first;
+      else header.first = decodeString(ptr, end);
+      header.second = decodeString(ptr, end);
+
+      if (indexing) insert(header);
+      headers.push_back(header);
+    }
+
+    first = false;
+  }
+}
+
+
+uint64_t HPACKDecoder::decodeInt(const uint8_t *&ptr, const uint8_t *end,
+                                 unsigned prefixBits) {
+  if (end <= ptr) THROW("HPACK integer truncated");
+
+  uint64_t mask = (1 << prefixBits) - 1;
+  uint64_t x = *ptr++ & mask;
+  if (x < mask) return x;
+
+  for (unsigned shift = 0; ; shift += 7) {
+    if (end <= ptr) THROW("HPACK integer truncated");
+    if (28 < shift) THROW("HPACK integer overflow");
+
+    uint8_t c = *ptr++;
+    x += (uint64_t)(c & 0x7f) << shift;
+    if (!(c & 0x80)) return x;
+  }
+}
+
+
+string HPACKDecoder::decodeString(const uint8_t *&ptr, const uint8_t *end) {
+  if (end <= ptr) THROW("HPACK string truncated");
+
+  bool huffman = *ptr & 0x80;
+  uint64_t length = decodeInt(ptr, end, 7);
+  if ((uint64_t)(end - ptr) < length) THROW("HPACK string truncated");
+
+  const uint8_t *data = ptr;
+  ptr += length;
+
+  if (huffman) return huffmanDecode(data, length);
+  return string((const char *)data, length);
+}
+
+
+void HPACKEncoder::encode(const headers_t &headers, string &block) const {
+  for (unsigned i = 0; i < headers.size(); i++) {
+    const header_t &header = headers[i];
+    unsigned nameIndex = 0;
+    unsigned index = 0;
+
+    for (unsigned j = 0; j < staticTableLength && !index; j++)
+      if (staticTable[j].first == header.first) {
+        if (!nameIndex) nameIndex = j + 1;
+        if (staticTable[j].second == header.second) index = j + 1;
+      }
+
+    if (index) encodeInt(block, index, 7, 0x80); // Indexed
+
+    else {
+      // Literal without indexing
+      encodeInt(block, nameIndex, 4);
+      if (!nameIndex) encodeString(block, header.first);
+      encodeString(block, header.second);
+    }
+  }
+}
+
+
+void HPACKEncoder::encodeInt(string &s, uint64_t x, unsigned prefixBits,
+                             uint8_t flags) {
+  uint64_t mask = (1 << prefixBits) - 1;
+
+  if (x < mask) {
+    s.push_back((char)(flags | x));
+    return;
+  }
+
+  s.push_back((char)(flags | mask));
+  x -= mask;
+
+  while (0x80 <= x) {
+    s.push_back((char)(0x80 | (x & 0x7f)));
+    x >>= 7;
+  }
+
+  s.push_back((char)x);
+}
+
+
+void HPACKEncoder::encodeString(string &s, const string &str) {
+  encodeInt(s, str.length(), 7);
+  s.append(str);
+}
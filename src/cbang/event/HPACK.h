@@ -0,0 +1,98 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <cstdint>
+
+
+namespace cb {
+  namespace Event {
+    /// HTTP/2 header compression as specified in RFC 7541
+    class HPACK {
+    public:
+      typedef std::pair<std::string, std::string> header_t;
+      typedef std::vector<header_t> headers_t;
+
+    protected:
+      std::deque<header_t> table;
+      unsigned tableSize = 0;
+      unsigned maxTableSize = 4096;
+
+    public:
+      unsigned getMaxTableSize() const {return maxTableSize;}
+      void setMaxTableSize(unsigned size);
+
+      /// @param index One based index into the static then dynamic table.
+      const header_t &lookup(unsigned index) const;
+      void insert(const header_t &header);
+
+      static unsigned getStaticTableLength();
+      static unsigned getEntrySize(const header_t &header)
+      {return header.first.length() + header.second.length() + 32;}
+
+      static std::string huffmanDecode(const uint8_t *data, unsigned length);
+
+    protected:
+      void evict(unsigned size);
+    };
+
+
+    class HPACKDecoder : public HPACK {
+      unsigned maxAllowedTableSize = 4096;
+
+    public:
+      /// Limit table size updates sent by the peer
+      void setMaxAllowedTableSize(unsigned size) {maxAllowedTableSize = size;}
+
+      void decode(const std::string &block, headers_t &headers);
+
+      static uint64_t decodeInt(const uint8_t *&ptr, const uint8_t *end,
+                                unsigned prefixBits);
+      static std::string decodeString(const uint8_t *&ptr, const uint8_t *end);
+    };
+
+
+    /// Encodes without a dynamic table so the peer's table never changes
+    class HPACKEncoder : public HPACK {
+    public:
+      void encode(const headers_t &headers, std::string &block) const;
+
+      static void encodeInt(std::string &s, uint64_t x, unsigned prefixBits,
+                            uint8_t flags = 0);
+      static void encodeString(std::string &s, const std::string &str);
+    };
+  }
+}
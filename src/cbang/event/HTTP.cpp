@@ -35,15 +35,21 @@
 #include "Request.h"
 #include "Event.h"
 #include "Connection.h"
+#include "Tracer.h"
 
 #include <cbang/config.h>
+#include <cbang/String.h>
 #include <cbang/Exception.h>
 #include <cbang/Catch.h>
 #include <cbang/log/Logger.h>
 #include <cbang/time/Timer.h>
 #include <cbang/socket/Socket.h>
+#include <cbang/socket/SocketHandoff.h>
 #include <cbang/openssl/SSLContext.h>
 #include <cbang/util/RateSet.h>
+#include <cbang/util/HistogramSet.h>
+#include <cbang/json/Arena.h>
+#include <cbang/net/Base64.h>
 
 using namespace std;
 using namespace cb::Event;
@@ -59,20 +65,14 @@ HTTP::HTTP(cb::Event::Base &base, const cb::SmartPointer<HTTPHandler> &handler,
 }
 
 
-HTTP::~HTTP() {}
+HTTP::~HTTP() {
+  if (socket.isSet()) SocketHandoff::instance().remove(boundAddr.toString());
+}
 
 
 void HTTP::setMaxConnectionTTL(unsigned x) {
   maxConnectionTTL = x;
-
-  if (maxConnectionTTL) {
-    if (expireEvent.isNull())
-      expireEvent = base.newEvent(this, &HTTP::expireCB);
-
-    expireEvent->setPriority(0 < priority ? priority - 1 : priority);
-    expireEvent->add(60); // Check once per minute
-
-  } else if (expireEvent->isPending()) expireEvent->del();
+  for (auto &con: connections) con->setMaxTTL(maxConnectionTTL);
 }
 
 
@@ -81,27 +81,152 @@ void HTTP::setEventPriority(int priority) {
 
   if (0 <= priority) {
     int p = 0 < priority ? priority - 1 : priority;
-    if (expireEvent.isSet()) expireEvent->setPriority(p);
     if (acceptEvent.isSet()) acceptEvent->setPriority(p);
   }
 }
 
 
+void HTTP::copySettings(const HTTP &o) {
+  defaultContentType = o.defaultContentType;
+  maxBodySize = o.maxBodySize;
+  maxHeaderSize = o.maxHeaderSize;
+  maxConnections = o.maxConnections;
+  connectionBacklog = o.connectionBacklog;
+  readTimeout = o.readTimeout;
+  writeTimeout = o.writeTimeout;
+  writeLowWater = o.writeLowWater;
+  writeHighWater = o.writeHighWater;
+  maxPipelined = o.maxPipelined;
+  maxPipelineBuffer = o.maxPipelineBuffer;
+  connectionRates = o.connectionRates;
+  reusePort = o.reusePort;
+  http2 = o.http2;
+  requestArenas = o.requestArenas;
+  socketOptions = o.socketOptions;
+  stats = o.stats;
+  latency = o.latency;
+  tracer = o.tracer;
+
+  setEventPriority(o.priority);
+  setMaxConnectionTTL(o.maxConnectionTTL);
+}
+
+
+void HTTP::setWriteWatermarks(unsigned low, unsigned high) {
+  if (high && high <= low) THROW("Write high watermark must exceed low");
+  writeLowWater = low;
+  writeHighWater = high;
+}
+
+
+void HTTP::expire(Connection &con) {
+  LOG_DEBUG(4, "Connection " << con.getID() << " expired");
+  if (stats.isSet()) stats->event("timedout");
+  remove(con);
+}
+
+
+void HTTP::recordLatency(const Request &req) {
+  if (latency.isNull() || !req.getResponseCode()) return;
+
+  uint64_t us = (Timer::monotonicNS() - req.getStartNS()) / 1000;
+  string status = String((unsigned)req.getResponseCode() / 100) + "xx";
+
+  latency->record(status, us);
+  if (!req.getRoute().empty())
+    latency->record(status + " " + req.getRoute(), us);
+}
+
+
+void HTTP::startTrace(Connection &con, Request &req) {
+  if (tracer.isNull()) return;
+
+  // The first request also covers the accept and any TLS handshake
+  bool first = req.getStreamID() ? req.getStreamID() == 1 :
+    con.getRequestCount() == 1;
+
+  uint64_t start = first ? con.getStartNS() : req.getStartNS();
+  SmartPointer<Trace> trace = tracer->start(req, start);
+  if (trace.isNull()) return;
+
+  if (first) trace->stage("ACCEPT", start);
+  trace->stage("READING_HEADERS", req.getStartNS());
+  req.setTrace(trace);
+}
+
+
 void HTTP::remove(Connection &con) {
+  unsigned size = connections.size();
   connections.remove(&con);
-  acceptEvent->add();
+  removed(size - connections.size());
+  if (acceptEvent.isSet()) acceptEvent->add();
+}
+
+
+void HTTP::setConnectionCounter(const SmartPointer<counter_t> &counter) {
+  if (counter.isSet()) *counter += connections.size();
+  if (connectionCounter.isSet()) *connectionCounter -= connections.size();
+  connectionCounter = counter;
+}
+
+
+unsigned HTTP::getTotalConnectionCount() const {
+  return connectionCounter.isSet() ? (unsigned)*connectionCounter :
+    getConnectionCount();
 }
 
 
 void HTTP::bind(const cb::IPAddress &addr) {
   // TODO Support binding multiple listener sockets
   if (this->socket.isSet()) THROW("Already bound");
+  if (draining) THROW("Cannot bind while draining");
 
+  SocketHandoff &handoff = SocketHandoff::instance();
+  string name = addr.toString();
   SmartPointer<Socket> socket = new Socket;
-  socket->setReuseAddr(true);
-  socket->bind(addr);
-  socket->listen(connectionBacklog);
-  socket_t fd = socket->get();
+  socket_t fd;
+
+  if (handoff.take(name, fd)) {
+    LOG_INFO(1, "Accepting on inherited listener " << addr);
+    socket->set(fd);
+
+  } else {
+    if (addr.isUnix()) socket->openUnix();
+    else {
+      socket->setReuseAddr(true);
+      if (reusePort) socket->setReusePort(true);
+    }
+    socket->bind(addr);
+    socketOptions.applyListener(*socket);
+    socket->listen(connectionBacklog);
+    fd = socket->get();
+  }
+
+  handoff.add(name, fd);
+
+#ifdef HAVE_OPENSSL
+  if (sslCtx.isSet()) {
+    // Resume TLS sessions across restarts using the same ticket keys
+    string keys = handoff.getState("tls-ticket-keys");
+    if (!keys.empty() && !sslCtx->getTicketKeys()) {
+      vector<string> data;
+      String::tokenize(keys, data);
+      for (auto &key: data) key = Base64().decode(key);
+      sslCtx->setTicketKeys(data);
+    }
+
+    if (sslCtx->getTicketKeys()) {
+      auto ctx = sslCtx;
+      handoff.addState("tls-ticket-keys", [ctx] () {
+        vector<string> data = ctx->getTicketKeyData();
+        string keys;
+        for (auto &key: data) keys += (keys.empty() ? "" : " ") +
+                                Base64().encode(key);
+        return keys;
+      });
+    }
+  }
+#endif // HAVE_OPENSSL
 
   // This event will be destroyed with the HTTP
   acceptEvent = base.newEvent(fd, this, &HTTP::acceptCB,
@@ -115,10 +240,38 @@ void HTTP::bind(const cb::IPAddress &addr) {
 }
 
 
+void HTTP::drain(double timeout, const function<void ()> &cb) {
+  LOG_INFO(1, "Draining " << connections.size() << " connection(s) on "
+           << boundAddr);
+
+  draining = true;
+  drainDeadline = Timer::now() + timeout;
+  drainedCB = cb;
+
+  // Stop accepting.  The listener may live on in another process.
+  acceptEvent.release();
+  acceptRetryEvent.release();
+  if (socket.isSet()) {
+    SocketHandoff::instance().remove(boundAddr.toString());
+    socket.release();
+  }
+
+  drainEvent = base.newEvent(this, &HTTP::drainCB,
+                             EVENT_PERSIST | EVENT_NO_SELF_REF);
+  drainEvent->add(0.25);
+  drainCB();
+}
+
+
 cb::SmartPointer<Request> HTTP::createRequest
 (Connection &con, RequestMethod method, const cb::URI &uri,
  const cb::Version &version) {
-  return handler->createRequest(con, method, uri, version);
+  auto req = handler->createRequest(con, method, uri, version);
+
+  if (requestArenas && req.isSet())
+    req->setArena(new JSON::Arena(base.getArenaPool()));
+
+  return req;
 }
 
 
@@ -126,6 +279,7 @@ void HTTP::handleRequest(Request &req) {
   LOG_DEBUG(5, "New request on " << boundAddr << ", connection count = "
             << getConnectionCount());
 
+  Trace::Scope scope(req.getTrace().get());
   TRY_CATCH_ERROR(dispatch(*handler, req));
 }
 
@@ -166,26 +320,56 @@ bool HTTP::dispatch(HTTPHandler &handler, Request &req) {
 }
 
 
-void HTTP::expireCB() {
-  double now = Timer::now();
-  unsigned count = 0;
+void HTTP::added() {if (connectionCounter.isSet()) (*connectionCounter)++;}
+
+
+void HTTP::removed(unsigned count) {
+  if (connectionCounter.isSet() && count) *connectionCounter -= count;
+}
+
 
-  for (auto it = connections.begin(); it != connections.end();)
-    if (maxConnectionTTL < now - (*it)->getStartTime()) {
-      it = connections.erase(it);
-      if (stats.isSet()) stats->event("timedout");
-      count++;
+void HTTP::drainCB() {
+  bool force = drainDeadline <= Timer::now();
+  if (force && connections.size())
+    LOG_WARNING("Closing " << connections.size() << " connection(s) on "
+                << boundAddr << " at drain deadline");
 
-    } else it++;
+  // Copy, draining may remove connections
+  connections_t cons = connections;
+  for (auto &con: cons) TRY_CATCH_ERROR(con->drain(force));
 
-  LOG_DEBUG(4, "Dropped " << count << " expired connections");
+  if (connections.empty()) {
+    drainEvent->del();
+
+    if (drainedCB) {
+      auto cb = drainedCB;
+      drainedCB = 0;
+      TRY_CATCH_ERROR(cb());
+    }
+  }
 }
 
 
 void HTTP::acceptCB() {
-  if (maxConnections && maxConnections <= connections.size()) {
+  if (maxConnections && maxConnections <= getTotalConnectionCount()) {
+    unsigned size = connections.size();
     handler->evict(connections);
-    if (maxConnections <= connections.size()) return acceptEvent->del();
+    removed(size - connections.size());
+
+    if (maxConnections <= getTotalConnectionCount()) {
+      acceptEvent->del();
+
+      // Connections freed by other HTTP instances sharing the counter will
+      // not reenable this listener so check back later.
+      if (connectionCounter.isSet()) {
+        if (acceptRetryEvent.isNull())
+          acceptRetryEvent = base.newEvent([this] () {acceptEvent->add();},
+                                           EVENT_NO_SELF_REF);
+        acceptRetryEvent->add(1);
+      }
+
+      return;
+    }
   }
 
   IPAddress peer;
@@ -198,9 +382,10 @@ void HTTP::acceptCB() {
 
   LOG_DEBUG(4, "New connection from " << peer);
 
-  // Maximize socket buffers
+  // Maximize socket buffers unless sizes are configured
   newSocket->setReceiveBuf();
   newSocket->setSendBuf();
+  socketOptions.applyAccepted(*newSocket);
 
   // Create new Connection
   SmartPointer<Connection> con =
@@ -210,10 +395,16 @@ void HTTP::acceptCB() {
   con->setMaxHeaderSize(maxHeaderSize);
   con->setMaxBodySize(maxBodySize);
   if (0 <= priority) con->setPriority(priority);
+  if (writeHighWater) con->setWriteWatermarks(writeLowWater, writeHighWater);
   con->setReadTimeout(readTimeout);
   con->setWriteTimeout(writeTimeout);
+  con->setMaxPipelined(maxPipelined);
+  con->setMaxPipelineBuffer(maxPipelineBuffer);
   con->setStats(stats);
+  con->setRateTracking(connectionRates);
+  con->setMaxTTL(maxConnectionTTL);
 
   connections.push_back(con);
+  added();
   con->acceptRequest();
 }
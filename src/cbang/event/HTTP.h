@@ -37,9 +37,12 @@
 
 #include <cbang/SmartPointer.h>
 #include <cbang/net/IPAddress.h>
+#include <cbang/socket/SocketOptions.h>
 
 #include <list>
 #include <limits>
+#include <atomic>
+#include <functional>
 
 
 namespace cb {
@@ -47,19 +50,26 @@ namespace cb {
   class IPAddress;
   class Socket;
   class RateSet;
+  class HistogramSet;
 
   namespace Event {
     class Base;
     class Event;
     class Connection;
+    class Tracer;
 
     class HTTP : public RefCounted, public Enum {
+    public:
+      typedef std::atomic<unsigned> counter_t;
+
+    protected:
       Base &base;
 
       SmartPointer<HTTPHandler> handler;
       SmartPointer<SSLContext> sslCtx;
-      cb::SmartPointer<Event> expireEvent;
       cb::SmartPointer<Event> acceptEvent;
+      cb::SmartPointer<Event> acceptRetryEvent;
+      cb::SmartPointer<Event> drainEvent;
 
       std::string defaultContentType = "text/html; charset=UTF-8";
       unsigned maxBodySize = std::numeric_limits<unsigned>::max();
@@ -70,12 +80,27 @@ namespace cb {
       int readTimeout = 50;
       int writeTimeout = 50;
       int priority = -1;
+      unsigned writeLowWater = 0;
+      unsigned writeHighWater = 0;
+      unsigned maxPipelined = 1;
+      unsigned maxPipelineBuffer = 1 << 20;
+      bool reusePort = false;
+      bool http2 = true;
+      bool requestArenas = false;
+      bool connectionRates = false;
+      bool draining = false;
+      double drainDeadline = 0;
+      std::function<void ()> drainedCB;
+      SocketOptions socketOptions;
 
       IPAddress boundAddr;
       SmartPointer<Socket> socket;
       typedef std::list<SmartPointer<Connection> > connections_t;
       connections_t connections;
+      SmartPointer<counter_t> connectionCounter;
       SmartPointer<RateSet> stats;
+      SmartPointer<HistogramSet> latency;
+      SmartPointer<Tracer> tracer;
 
     public:
       HTTP(Base &base, const SmartPointer<HTTPHandler> &handler,
@@ -110,9 +135,62 @@ namespace cb {
       int getEventPriority() const {return priority;}
       void setEventPriority(int priority);
 
+      unsigned getWriteLowWater() const {return writeLowWater;}
+      unsigned getWriteHighWater() const {return writeHighWater;}
+      /// Applied to new connections, see BufferEvent::setWriteWatermarks()
+      void setWriteWatermarks(unsigned low, unsigned high);
+
+      unsigned getMaxPipelined() const {return maxPipelined;}
+      /// Applied to new connections, see Connection::setMaxPipelined()
+      void setMaxPipelined(unsigned x) {maxPipelined = x;}
+
+      unsigned getMaxPipelineBuffer() const {return maxPipelineBuffer;}
+      void setMaxPipelineBuffer(unsigned x) {maxPipelineBuffer = x;}
+
+      bool getReusePort() const {return reusePort;}
+      void setReusePort(bool x) {reusePort = x;}
+
+      bool getHTTP2Enabled() const {return http2;}
+      void setHTTP2Enabled(bool x) {http2 = x;}
+
+      bool getRequestArenas() const {return requestArenas;}
+      /**
+       * When enabled each Request's arguments and parsed JSON input are
+       * allocated from a JSON::Arena whose blocks are recycled through the
+       * Base's ArenaPool.  The reference counts of these Values are not
+       * thread safe so they must not be shared between threads.
+       */
+      void setRequestArenas(bool x) {requestArenas = x;}
+
+      bool getConnectionRates() const {return connectionRates;}
+      /// Applied to new connections, see Connection::setRateTracking()
+      void setConnectionRates(bool x) {connectionRates = x;}
+
+      const SocketOptions &getSocketOptions() const {return socketOptions;}
+      /// Must be set before bind() to affect the listener socket
+      void setSocketOptions(const SocketOptions &x) {socketOptions = x;}
+
+      /// Copy configuration but not listen sockets or connections
+      void copySettings(const HTTP &o);
+
+      Base &getBase() const {return base;}
+      const SmartPointer<HTTPHandler> &getHandler() const {return handler;}
+      const SmartPointer<SSLContext> &getSSLContext() const {return sslCtx;}
+
       unsigned getConnectionCount() const {return connections.size();}
+      void expire(Connection &con);
       void remove(Connection &con);
 
+      /**
+       * A connection counter may be shared by several HTTP instances which
+       * accept connections on separate event loops.  When set, the
+       * maxConnections limit is applied to the shared total.
+       */
+      const SmartPointer<counter_t> &getConnectionCounter() const
+      {return connectionCounter;}
+      void setConnectionCounter(const SmartPointer<counter_t> &counter);
+      unsigned getTotalConnectionCount() const;
+
       typedef connections_t::const_iterator iterator;
       iterator begin() const {return connections.begin();}
       iterator end() const {return connections.end();}
@@ -120,8 +198,44 @@ namespace cb {
       void setStats(const SmartPointer<RateSet> &stats) {this->stats = stats;}
       const SmartPointer<RateSet> &getStats() const {return stats;}
 
+      /**
+       * Record the microseconds from the start of each request until its
+       * reply has been written.  Histograms are kept per status class,
+       * e.g. "2xx", and per route, e.g. "2xx /api/.*".
+       */
+      void setLatencyStats(const SmartPointer<HistogramSet> &latency)
+        {this->latency = latency;}
+      const SmartPointer<HistogramSet> &getLatencyStats() const
+        {return latency;}
+      void recordLatency(const Request &req);
+
+      /**
+       * Trace a sample of requests.  Each trace records the stages of the
+       * request from the connection's accept, for its first request, or
+       * from the request line through the handler and writing the reply.
+       */
+      void setTracer(const SmartPointer<Tracer> &tracer)
+        {this->tracer = tracer;}
+      const SmartPointer<Tracer> &getTracer() const {return tracer;}
+      void startTrace(Connection &con, Request &req);
+
+      /**
+       * Listen on @param addr, an IP address and port or "unix:<path>".  A
+       * listener on the same address inherited from a previous process
+       * through SocketHandoff is used instead of opening a new socket.
+       * The listener is offered to the next process in turn.
+       */
       void bind(const IPAddress &addr);
 
+      /**
+       * Stop accepting and close connections as they become idle.  While
+       * draining, HTTP/1 replies ask clients to close and HTTP/2 sessions
+       * are sent GOAWAY.  Connections still open after @param timeout
+       * seconds are closed.  @param cb is called once all are closed.
+       */
+      void drain(double timeout, const std::function<void ()> &cb = 0);
+      bool isDraining() const {return draining;}
+
       SmartPointer<Request> createRequest
       (Connection &con, RequestMethod method, const URI &uri,
        const Version &version);
@@ -130,8 +244,10 @@ namespace cb {
       static bool dispatch(HTTPHandler &handler, Request &req);
 
     protected:
-      void expireCB();
+      void added();
+      void removed(unsigned count = 1);
       void acceptCB();
+      void drainCB();
     };
   }
 }
@@ -0,0 +1,795 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "HTTP2Session.h"
+#include "Connection.h"
+#include "Request.h"
+#include "HTTP.h"
+#include "HeaderParser.h"
+
+#include <cbang/Catch.h>
+#include <cbang/String.h>
+#include <cbang/log/Logger.h>
+#include <cbang/util/RateSet.h>
+
+#include <cstring>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+#undef CBANG_LOG_PREFIX
+#define CBANG_LOG_PREFIX << "CON" << con.getID() << ':'
+
+
+namespace {
+  enum {
+    FLAG_END_STREAM  = 1 << 0,
+    FLAG_ACK         = 1 << 0,
+    FLAG_END_HEADERS = 1 << 2,
+    FLAG_PADDED      = 1 << 3,
+    FLAG_PRIORITY    = 1 << 5,
+  };
+
+
+  enum {
+    SETTINGS_HEADER_TABLE_SIZE = 1,
+    SETTINGS_ENABLE_PUSH,
+    SETTINGS_MAX_CONCURRENT_STREAMS,
+    SETTINGS_INITIAL_WINDOW_SIZE,
+    SETTINGS_MAX_FRAME_SIZE,
+    SETTINGS_MAX_HEADER_LIST_SIZE,
+  };
+
+
+  const int64_t maxWindow = 0x7fffffff;
+}
+
+
+const char *HTTP2Session::PREFACE_TAIL = "\r\nSM\r\n\r\n";
+
+
+HTTP2Session::HTTP2Session(Connection &con) : con(con) {sendSettings();}
+
+
+void HTTP2Session::read(Buffer &input) {
+  if (closing) return input.clear();
+
+  if (!prefaceReceived) {
+    unsigned length = strlen(PREFACE_TAIL);
+    if (input.getLength() < length) return; // Need more data
+
+    char buf[length];
+    input.remove(buf, length);
+    if (strncmp(buf, PREFACE_TAIL, length))
+      return goAway(H2_PROTOCOL_ERROR, "Invalid connection preface");
+
+    prefaceReceived = true;
+  }
+
+  while (9 <= input.getLength() && !closing) {
+    uint8_t header[9];
+    input.copy((char *)header, 9);
+
+    unsigned length = header[0] << 16 | header[1] << 8 | header[2];
+    if (maxFrameSize < length)
+      return goAway(H2_FRAME_SIZE_ERROR, "Frame too large");
+
+    if (input.getLength() < 9 + length) return; // Need more data
+
+    frame_t type = (frame_t)header[3];
+    uint8_t flags = header[4];
+    uint32_t id = (header[5] & 0x7f) << 24 | header[6] << 16 | header[7] << 8 |
+      header[8];
+
+    string payload(length, 0);
+    input.drain(9);
+    if (length) input.remove(&payload[0], length);
+
+    LOG_DEBUG(5, "HTTP/2 frame type=" << type << " flags=" << (int)flags
+              << " stream=" << id << " length=" << length);
+
+    try {
+      if (!settingsReceived && type != FRAME_SETTINGS)
+        THROW("Expected SETTINGS frame");
+
+      processFrame(type, flags, id, payload);
+
+    } catch (const Exception &e) {
+      error_t error = e.getCode() ? (error_t)e.getCode() : H2_PROTOCOL_ERROR;
+      return goAway(error, e.getMessage());
+    }
+  }
+}
+
+
+void HTTP2Session::writeCB() {
+  // Output drained, close after GOAWAY or continue sending
+  if (closing) con.free(CONN_ERR_OK);
+  else {
+    pump();
+    notifyWritable();
+  }
+}
+
+
+bool HTTP2Session::isWritable(const Request &req) const {
+  const Stream *stream = findStream(req);
+  return stream && stream->pending.getLength() < outputHighWater;
+}
+
+
+void HTTP2Session::writeResponse(Request &req) {
+  Stream *stream = findStream(req);
+  if (!stream) {
+    LOG_DEBUG(3, "HTTP/2 stream " << req.getStreamID() << " is closed");
+    return;
+  }
+
+  req.prepareResponseHeaders();
+
+  HPACK::headers_t headers;
+  headers.push_back(
+    HPACK::header_t(":status", String((unsigned)req.getResponseCode())));
+
+  const Headers &out = req.getOutputHeaders();
+  for (auto it = out.begin(); it != out.end(); it++) {
+    string name = String::toLower(it->first);
+    if (it->second.empty() || isConnectionHeader(name)) continue;
+    headers.push_back(HPACK::header_t(name, it->second));
+  }
+
+  string block;
+  encoder.encode(headers, block);
+
+  if (req.mustHaveBody()) stream->pending.add(req.getOutputBuffer());
+  else req.getOutputBuffer().clear();
+
+  bool end = !req.mustHaveBody() || (!req.isChunked() && !req.isStreaming());
+  bool endNow = end && !stream->pending.getLength();
+  uint32_t id = req.getStreamID();
+
+  // HEADERS followed by CONTINUATION frames if needed
+  unsigned offset = 0;
+  do {
+    unsigned length = min((unsigned)block.length() - offset, peerMaxFrameSize);
+    uint8_t flags = offset + length == block.length() ? FLAG_END_HEADERS : 0;
+    if (!offset && endNow) flags |= FLAG_END_STREAM;
+
+    sendFrame(offset ? FRAME_CONTINUATION : FRAME_HEADERS, flags, id,
+              block.data() + offset, length);
+
+    offset += length;
+  } while (offset < block.length());
+
+  stream->headersSent = true;
+  stream->endQueued = end;
+
+  if (endNow) complete(id);
+  else pump();
+}
+
+
+void HTTP2Session::writeData(Request &req, const Buffer &buf, bool end) {
+  Stream *stream = findStream(req);
+  if (!stream) return;
+
+  stream->pending.add(buf);
+  if (end) stream->endQueued = true;
+
+  pump();
+}
+
+
+void HTTP2Session::cancel(Request &req) {
+  if (!findStream(req)) return;
+  sendReset(req.getStreamID(), H2_CANCEL);
+  streams.erase(req.getStreamID());
+}
+
+
+void HTTP2Session::close() {
+  streams_t streams;
+  streams.swap(this->streams);
+
+  for (auto it = streams.begin(); it != streams.end(); it++)
+    TRY_CATCH_ERROR(it->second.req->complete());
+}
+
+
+void HTTP2Session::sendFrameHeader(frame_t type, uint8_t flags, uint32_t id,
+                                   unsigned length) {
+  char header[9] = {
+    (char)(length >> 16), (char)(length >> 8), (char)length, (char)type,
+    (char)flags, (char)((id >> 24) & 0x7f), (char)(id >> 16), (char)(id >> 8),
+    (char)id,
+  };
+
+  con.getOutput().add(header, 9);
+}
+
+
+void HTTP2Session::sendFrame(frame_t type, uint8_t flags, uint32_t id,
+                             const char *data, unsigned length) {
+  sendFrameHeader(type, flags, id, length);
+  if (length) con.getOutput().add(data, length);
+}
+
+
+void HTTP2Session::sendFrame(frame_t type, uint8_t flags, uint32_t id,
+                             const string &payload) {
+  sendFrame(type, flags, id, payload.data(), payload.length());
+}
+
+
+void HTTP2Session::sendSettings() {
+  string payload;
+
+  payload.push_back(0);
+  payload.push_back(SETTINGS_MAX_CONCURRENT_STREAMS);
+  addU32(payload, maxConcurrentStreams);
+
+  payload.push_back(0);
+  payload.push_back(SETTINGS_ENABLE_PUSH);
+  addU32(payload, 0);
+
+  sendFrame(FRAME_SETTINGS, 0, 0, payload);
+}
+
+
+void HTTP2Session::sendWindowUpdate(uint32_t id, uint32_t increment) {
+  string payload;
+  addU32(payload, increment);
+  sendFrame(FRAME_WINDOW_UPDATE, 0, id, payload);
+}
+
+
+void HTTP2Session::sendReset(uint32_t id, error_t error) {
+  LOG_DEBUG(4, "HTTP/2 RST_STREAM stream=" << id << " error=" << error);
+
+  string payload;
+  addU32(payload, error);
+  sendFrame(FRAME_RST_STREAM, 0, id, payload);
+}
+
+
+void HTTP2Session::goAway(error_t error, const string &msg) {
+  if (error) LOG_WARNING("HTTP/2 connection error " << error << ": " << msg);
+
+  string payload;
+  addU32(payload, lastStreamID);
+  addU32(payload, error);
+  payload += msg;
+  sendFrame(FRAME_GOAWAY, 0, 0, payload);
+
+  closing = true;
+  close();
+}
+
+
+void HTTP2Session::shutdown() {
+  if (shuttingDown || closing) return;
+  shuttingDown = goingAway = true;
+
+  string payload;
+  addU32(payload, lastStreamID);
+  addU32(payload, H2_NO_ERROR);
+  sendFrame(FRAME_GOAWAY, 0, 0, payload);
+
+  // Close once the GOAWAY is written, see writeCB()
+  if (streams.empty()) closing = true;
+}
+
+
+HTTP2Session::Stream *HTTP2Session::findStream(uint32_t id) {
+  auto it = streams.find(id);
+  return it == streams.end() ? 0 : &it->second;
+}
+
+
+HTTP2Session::Stream *HTTP2Session::findStream(Request &req) {
+  return findStream(req.getStreamID());
+}
+
+
+const HTTP2Session::Stream *
+HTTP2Session::findStream(const Request &req) const {
+  auto it = streams.find(req.getStreamID());
+  return it == streams.end() ? 0 : &it->second;
+}
+
+
+void HTTP2Session::notifyWritable() {
+  // Callbacks may add or close streams
+  vector<SmartPointer<Request> > reqs;
+  for (auto it = streams.begin(); it != streams.end(); it++)
+    if (it->second.req.isSet()) reqs.push_back(it->second.req);
+
+  for (unsigned i = 0; i < reqs.size(); i++)
+    TRY_CATCH_ERROR(reqs[i]->writable());
+}
+
+
+void HTTP2Session::complete(uint32_t id) {
+  auto it = streams.find(id);
+  if (it == streams.end()) return;
+
+  SmartPointer<Request> req = it->second.req;
+  streams.erase(it);
+
+  // Close after the last reply is written
+  if (shuttingDown && streams.empty()) closing = true;
+
+  if (con.getStats().isSet())
+    con.getStats()->event(req->getResponseCode().toString());
+  if (con.isIncoming() && con.getHTTP().isSet()) {
+    con.getHTTP()->recordLatency(*req);
+    req->finishTrace();
+  }
+
+  TRY_CATCH_ERROR(req->complete());
+}
+
+
+void HTTP2Session::pump() {
+  for (auto it = streams.begin(); it != streams.end();) {
+    uint32_t id = it->first;
+    Stream &stream = it++->second; // Advance first, stream may complete
+
+    if (!pump(id, stream)) break;
+  }
+}
+
+
+bool HTTP2Session::pump(uint32_t id, Stream &stream) {
+  if (!stream.headersSent) return true;
+
+  while (con.getOutput().getLength() < outputHighWater) {
+    auto &req = *stream.req;
+
+    // Pull more data from streaming replies
+    if (!stream.pending.getLength() && !stream.endQueued) {
+      if (!req.isStreaming()) return true; // Wait for more data
+
+      try {
+        req.stream(stream.pending);
+      } catch (const Exception &e) {
+        LOG_ERROR("HTTP/2 stream " << id << ": " << e.getMessage());
+        sendReset(id, H2_INTERNAL_ERROR);
+        streams.erase(id);
+        return true;
+      }
+
+      if (!req.isStreaming() && !req.isChunked()) stream.endQueued = true;
+    }
+
+    unsigned length = stream.pending.getLength();
+
+    if (!length) {
+      if (!stream.endQueued) return true;
+
+      sendFrame(FRAME_DATA, FLAG_END_STREAM, id);
+      complete(id);
+      return true;
+    }
+
+    // Flow control
+    int64_t window = min(sendWindow, stream.sendWindow);
+    if (window <= 0) return 0 < sendWindow;
+
+    unsigned bytes = min((int64_t)min(length, peerMaxFrameSize), window);
+    bool end = bytes == length && stream.endQueued;
+
+    sendFrameHeader(FRAME_DATA, end ? FLAG_END_STREAM : 0, id, bytes);
+    stream.pending.remove(con.getOutput(), bytes);
+
+    sendWindow -= bytes;
+    stream.sendWindow -= bytes;
+
+    if (end) {
+      complete(id);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+void HTTP2Session::processFrame(frame_t type, uint8_t flags, uint32_t id,
+                                const string &payload) {
+  if (continuationID && (type != FRAME_CONTINUATION || id != continuationID))
+    THROW("Expected CONTINUATION frame");
+
+  switch (type) {
+  case FRAME_DATA: return processData(flags, id, payload);
+  case FRAME_HEADERS: return processHeaders(flags, id, payload);
+
+  case FRAME_PRIORITY:
+    if (!id) THROW("PRIORITY on stream 0");
+    if (payload.length() != 5) THROWX("Invalid PRIORITY", H2_FRAME_SIZE_ERROR);
+    return; // Ignored
+
+  case FRAME_RST_STREAM: return processReset(id, payload);
+
+  case FRAME_SETTINGS:
+    if (id) THROW("SETTINGS on stream " << id);
+    return processSettings(flags, payload);
+
+  case FRAME_PUSH_PROMISE: THROW("Client sent PUSH_PROMISE");
+
+  case FRAME_PING:
+    if (id) THROW("PING on stream " << id);
+    if (payload.length() != 8) THROWX("Invalid PING", H2_FRAME_SIZE_ERROR);
+    if (!(flags & FLAG_ACK)) sendFrame(FRAME_PING, FLAG_ACK, 0, payload);
+    return;
+
+  case FRAME_GOAWAY:
+    if (id) THROW("GOAWAY on stream " << id);
+    goingAway = true; // Finish open streams but accept no more
+    return;
+
+  case FRAME_WINDOW_UPDATE: return processWindowUpdate(id, payload);
+
+  case FRAME_CONTINUATION:
+    if (!continuationID) THROW("Unexpected CONTINUATION frame");
+
+    headerBlock += payload;
+    if (con.getMaxHeaderSize() < headerBlock.length())
+      THROWX("Header block too large", H2_ENHANCE_YOUR_CALM);
+
+    if (flags & FLAG_END_HEADERS) processHeaderBlock(continuationFlags, id);
+    return;
+
+  default: return; // Unknown frames must be ignored
+  }
+}
+
+
+void HTTP2Session::processData(uint8_t flags, uint32_t id,
+                               const string &payload) {
+  if (!id) THROW("DATA on stream 0");
+
+  // Padding counts toward flow control
+  unsigned length = payload.length();
+  const char *data = payload.data();
+  unsigned size = length;
+
+  if (flags & FLAG_PADDED) {
+    unsigned padding = size ? (uint8_t)data[0] : 0;
+    if (!size || size <= padding) THROW("Invalid DATA padding");
+    data++;
+    size -= padding + 1;
+  }
+
+  recvWindow -= length;
+  if (recvWindow < 0) THROWX("Flow control window exceeded",
+                             H2_FLOW_CONTROL_ERROR);
+
+  // Replenish the connection window right away, data is buffered in Request
+  if (length) {
+    sendWindowUpdate(0, length);
+    recvWindow += length;
+  }
+
+  Stream *stream = findStream(id);
+  if (!stream || stream->remoteClosed) {
+    if (lastStreamID < id) THROW("DATA on idle stream " << id);
+    return sendReset(id, H2_STREAM_CLOSED);
+  }
+
+  auto &req = *stream->req;
+  req.getInputBuffer().add(data, size);
+  stream->bodySize += size;
+
+  if (req.isBodyStreaming())
+    try {
+      req.bodyData();
+
+    } catch (const Exception &e) {
+      LOG_ERROR(e.getMessages());
+      stream->remoteClosed = true;
+      return req.sendError(e);
+    }
+
+  else if (con.getMaxBodySize() < req.getInputBuffer().getLength()) {
+    stream->remoteClosed = true;
+    return req.sendError(HTTP_REQUEST_ENTITY_TOO_LARGE);
+  }
+
+  int64_t total = -1;
+  if (req.inHas("Content-Length"))
+    total = String::parseU64(req.inGet("Content-Length"));
+  TRY_CATCH_ERROR(req.onProgress(stream->bodySize, total));
+
+  if (flags & FLAG_END_STREAM) dispatch(*stream);
+  else if (length) sendWindowUpdate(id, length);
+}
+
+
+void HTTP2Session::processReset(uint32_t id, const string &payload) {
+  if (!id) THROW("RST_STREAM on stream 0");
+  if (payload.length() != 4) THROWX("Invalid RST_STREAM", H2_FRAME_SIZE_ERROR);
+  if (lastStreamID < id) THROW("RST_STREAM on idle stream " << id);
+
+  LOG_DEBUG(4, "HTTP/2 stream " << id << " reset by peer error="
+            << getU32(payload, 0));
+
+  streams.erase(id);
+}
+
+
+void HTTP2Session::processHeaders(uint8_t flags, uint32_t id,
+                                  const string &payload) {
+  if (!id) THROW("HEADERS on stream 0");
+
+  unsigned offset = 0;
+  unsigned size = payload.length();
+
+  if (flags & FLAG_PADDED) {
+    unsigned padding = size ? (uint8_t)payload[0] : 0;
+    if (!size || size <= padding) THROW("Invalid HEADERS padding");
+    offset++;
+    size -= padding + 1;
+  }
+
+  if (flags & FLAG_PRIORITY) {
+    if (size < 5) THROWX("Invalid HEADERS priority", H2_FRAME_SIZE_ERROR);
+    offset += 5;
+    size -= 5;
+  }
+
+  headerBlock = payload.substr(offset, size);
+
+  if (flags & FLAG_END_HEADERS) processHeaderBlock(flags, id);
+  else {
+    continuationID = id;
+    continuationFlags = flags;
+  }
+}
+
+
+void HTTP2Session::processHeaderBlock(uint8_t flags, uint32_t id) {
+  continuationID = 0;
+
+  // The block must be decoded to keep the HPACK state in sync
+  HPACK::headers_t headers;
+  try {
+    decoder.decode(headerBlock, headers);
+  } catch (const Exception &e) {
+    THROWX("HPACK: " << e.getMessage(), H2_COMPRESSION_ERROR);
+  }
+
+  headerBlock.clear();
+  bool end = flags & FLAG_END_STREAM;
+
+  Stream *stream = findStream(id);
+  if (stream) {
+    // Trailers
+    if (stream->remoteClosed) return sendReset(id, H2_STREAM_CLOSED);
+    if (!end) THROW("Trailers without END_STREAM");
+
+    for (unsigned i = 0; i < headers.size(); i++)
+      if (headers[i].first[0] != ':')
+        stream->req->inSet(canonicalName(headers[i].first), headers[i].second);
+
+    return dispatch(*stream);
+  }
+
+  if (!(id & 1) || id <= lastStreamID) THROW("Invalid stream ID " << id);
+  lastStreamID = id;
+
+  if (goingAway) return sendReset(id, H2_REFUSED_STREAM);
+  if (maxConcurrentStreams <= streams.size())
+    return sendReset(id, H2_REFUSED_STREAM);
+
+  newRequest(id, headers, end);
+}
+
+
+void HTTP2Session::processSettings(uint8_t flags, const string &payload) {
+  if (flags & FLAG_ACK) {
+    if (payload.length()) THROWX("Invalid SETTINGS ACK", H2_FRAME_SIZE_ERROR);
+    return;
+  }
+
+  if (payload.length() % 6) THROWX("Invalid SETTINGS", H2_FRAME_SIZE_ERROR);
+
+  for (unsigned i = 0; i < payload.length(); i += 6) {
+    unsigned key = (uint8_t)payload[i] << 8 | (uint8_t)payload[i + 1];
+    uint32_t value = getU32(payload, i + 2);
+
+    switch (key) {
+    case SETTINGS_HEADER_TABLE_SIZE:
+      // Our encoder does not use the dynamic table
+      encoder.setMaxTableSize(value);
+      break;
+
+    case SETTINGS_ENABLE_PUSH:
+      if (1 < value) THROW("Invalid SETTINGS_ENABLE_PUSH");
+      break;
+
+    case SETTINGS_INITIAL_WINDOW_SIZE: {
+      if (maxWindow < value)
+        THROWX("Invalid initial window size", H2_FLOW_CONTROL_ERROR);
+
+      int64_t delta = (int64_t)value - peerInitialWindow;
+      for (auto it = streams.begin(); it != streams.end(); it++)
+        it->second.sendWindow += delta;
+
+      peerInitialWindow = value;
+      break;
+    }
+
+    case SETTINGS_MAX_FRAME_SIZE:
+      if (value < 16384 || 16777215 < value)
+        THROW("Invalid SETTINGS_MAX_FRAME_SIZE " << value);
+      peerMaxFrameSize = value;
+      break;
+
+    default: break; // Ignore others
+    }
+  }
+
+  settingsReceived = true;
+  sendFrame(FRAME_SETTINGS, FLAG_ACK, 0);
+  pump();
+}
+
+
+void HTTP2Session::processWindowUpdate(uint32_t id, const string &payload) {
+  if (payload.length() != 4)
+    THROWX("Invalid WINDOW_UPDATE", H2_FRAME_SIZE_ERROR);
+
+  uint32_t increment = getU32(payload, 0) & 0x7fffffff;
+
+  if (!id) {
+    if (!increment) THROW("Zero WINDOW_UPDATE");
+    sendWindow += increment;
+    if (maxWindow < sendWindow)
+      THROWX("Window overflow", H2_FLOW_CONTROL_ERROR);
+
+  } else {
+    Stream *stream = findStream(id);
+    if (!stream) return;
+    if (!increment) return sendReset(id, H2_PROTOCOL_ERROR);
+
+    stream->sendWindow += increment;
+    if (maxWindow < stream->sendWindow) {
+      sendReset(id, H2_FLOW_CONTROL_ERROR);
+      streams.erase(id);
+      return;
+    }
+  }
+
+  pump();
+}
+
+
+void HTTP2Session::newRequest(uint32_t id, const HPACK::headers_t &headers,
+                              bool end) {
+  string method;
+  string authority;
+  string path;
+  unsigned i;
+
+  // Pseudo headers come first
+  for (i = 0; i < headers.size() && headers[i].first[0] == ':'; i++) {
+    const string &name = headers[i].first;
+
+    if (name == ":method") method = headers[i].second;
+    else if (name == ":authority") authority = headers[i].second;
+    else if (name == ":path") path = headers[i].second;
+    else if (name != ":scheme") return sendReset(id, H2_PROTOCOL_ERROR);
+  }
+
+  if (method.empty() || path.empty()) return sendReset(id, H2_PROTOCOL_ERROR);
+
+  SmartPointer<Request> req;
+  try {
+    req = con.getHTTP()->createRequest(con, RequestMethod::parse(method),
+                                       URI(path), Version(2, 0));
+  } catch (const Exception &e) {
+    LOG_WARNING("HTTP/2 invalid request: " << e.getMessage());
+    return sendReset(id, H2_PROTOCOL_ERROR);
+  }
+
+  req->setConnection(&con);
+  req->setStreamID(id);
+
+  if (!authority.empty()) req->inSet("Host", authority);
+
+  for (; i < headers.size(); i++) {
+    const string &name = headers[i].first;
+    if (name[0] == ':') return sendReset(id, H2_PROTOCOL_ERROR);
+
+    // Combine repeated headers, cookies may be split in HTTP/2
+    string key = canonicalName(name);
+    string value = headers[i].second;
+    if (req->inHas(key))
+      value = req->inGet(key) + (key == "Cookie" ? "; " : ", ") + value;
+
+    req->inSet(key, value);
+  }
+
+  Stream &stream = streams[id];
+  stream.req = req;
+  stream.sendWindow = peerInitialWindow;
+
+  con.getHTTP()->startTrace(con, *req);
+  TRY_CATCH_ERROR(req->onHeaders());
+
+  if (end) dispatch(stream);
+}
+
+
+void HTTP2Session::dispatch(Stream &stream) {
+  stream.remoteClosed = true;
+
+  SmartPointer<Request> req = stream.req;
+  req->traceStage("HANDLER");
+  TRY_CATCH_ERROR(return req->onRequest());
+
+  cancel(*req);
+}
+
+
+string HTTP2Session::canonicalName(const string &name) {
+  const string *interned = HeaderParser::intern(name.data(), name.length());
+  if (interned) return *interned;
+
+  string s = name;
+
+  for (unsigned i = 0; i < s.length(); i++)
+    if (!i || s[i - 1] == '-') s[i] = toupper(s[i]);
+
+  return s;
+}
+
+
+bool HTTP2Session::isConnectionHeader(const string &name) {
+  return name == "connection" || name == "keep-alive" ||
+    name == "proxy-connection" || name == "transfer-encoding" ||
+    name == "upgrade";
+}
+
+
+uint32_t HTTP2Session::getU32(const string &s, unsigned offset) {
+  const uint8_t *p = (const uint8_t *)s.data() + offset;
+  return (uint32_t)p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3];
+}
+
+
+void HTTP2Session::addU32(string &s, uint32_t x) {
+  for (int shift = 24; 0 <= shift; shift -= 8) s.push_back((char)(x >> shift));
+}
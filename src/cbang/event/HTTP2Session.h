@@ -0,0 +1,194 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "HPACK.h"
+#include "Buffer.h"
+#include "Enum.h"
+
+#include <cbang/SmartPointer.h>
+
+#include <map>
+#include <string>
+
+
+namespace cb {
+  namespace Event {
+    class Connection;
+    class Request;
+
+    /**
+     * Server side HTTP/2, RFC 9113, on an incoming Connection.  Each stream
+     * is mapped to a Request so existing handlers work unchanged.  Server
+     * push and stream priorities are not implemented.
+     */
+    class HTTP2Session : public Enum {
+    public:
+      typedef enum {
+        FRAME_DATA,
+        FRAME_HEADERS,
+        FRAME_PRIORITY,
+        FRAME_RST_STREAM,
+        FRAME_SETTINGS,
+        FRAME_PUSH_PROMISE,
+        FRAME_PING,
+        FRAME_GOAWAY,
+        FRAME_WINDOW_UPDATE,
+        FRAME_CONTINUATION,
+      } frame_t;
+
+      typedef enum {
+        H2_NO_ERROR,
+        H2_PROTOCOL_ERROR,
+        H2_INTERNAL_ERROR,
+        H2_FLOW_CONTROL_ERROR,
+        H2_SETTINGS_TIMEOUT,
+        H2_STREAM_CLOSED,
+        H2_FRAME_SIZE_ERROR,
+        H2_REFUSED_STREAM,
+        H2_CANCEL,
+        H2_COMPRESSION_ERROR,
+        H2_CONNECT_ERROR,
+        H2_ENHANCE_YOUR_CALM,
+        H2_INADEQUATE_SECURITY,
+        H2_HTTP_1_1_REQUIRED,
+      } error_t;
+
+      /// The part of the client preface following "PRI * HTTP/2.0\r\n"
+      static const char *PREFACE_TAIL;
+
+    private:
+      Connection &con;
+
+      HPACKDecoder decoder;
+      HPACKEncoder encoder;
+
+      struct Stream {
+        SmartPointer<Request> req;
+        int64_t sendWindow;
+        Buffer pending;
+        uint64_t bodySize = 0;
+        bool headersSent = false;
+        bool endQueued = false;
+        bool remoteClosed = false;
+      };
+
+      typedef std::map<uint32_t, Stream> streams_t;
+      streams_t streams;
+
+      bool prefaceReceived = false;
+      bool settingsReceived = false;
+      bool goingAway = false;
+      bool shuttingDown = false;
+      bool closing = false;
+
+      uint32_t lastStreamID = 0;
+      uint32_t continuationID = 0;
+      uint8_t continuationFlags = 0;
+      std::string headerBlock;
+
+      int64_t sendWindow = 65535;
+      int64_t recvWindow = 65535;
+      uint32_t peerInitialWindow = 65535;
+      uint32_t peerMaxFrameSize = 16384;
+
+      unsigned maxConcurrentStreams = 100;
+      unsigned maxFrameSize = 16384;
+      unsigned outputHighWater = 1 << 17;
+
+    public:
+      HTTP2Session(Connection &con);
+
+      unsigned getMaxConcurrentStreams() const {return maxConcurrentStreams;}
+      void setMaxConcurrentStreams(unsigned x) {maxConcurrentStreams = x;}
+
+      unsigned getStreamCount() const {return streams.size();}
+
+      /// Parse and process frames from @param input
+      void read(Buffer &input);
+
+      /// Called when the connection's output buffer has drained
+      void writeCB();
+
+      // Used by Request
+      bool isWritable(const Request &req) const;
+      void writeResponse(Request &req);
+      void writeData(Request &req, const Buffer &buf, bool end);
+      void cancel(Request &req);
+
+      /// Send GOAWAY, refuse new streams and close once open streams finish
+      void shutdown();
+
+      /// Release all streams
+      void close();
+
+    protected:
+      void sendFrameHeader(frame_t type, uint8_t flags, uint32_t id,
+                           unsigned length);
+      void sendFrame(frame_t type, uint8_t flags, uint32_t id,
+                     const char *data = 0, unsigned length = 0);
+      void sendFrame(frame_t type, uint8_t flags, uint32_t id,
+                     const std::string &payload);
+      void sendSettings();
+      void sendWindowUpdate(uint32_t id, uint32_t increment);
+      void sendReset(uint32_t id, error_t error);
+      void goAway(error_t error, const std::string &msg);
+
+      Stream *findStream(uint32_t id);
+      Stream *findStream(Request &req);
+      const Stream *findStream(const Request &req) const;
+      void notifyWritable();
+      void complete(uint32_t id);
+      void pump();
+      bool pump(uint32_t id, Stream &stream);
+
+      void processFrame(frame_t type, uint8_t flags, uint32_t id,
+                        const std::string &payload);
+      void processData(uint8_t flags, uint32_t id, const std::string &payload);
+      void processReset(uint32_t id, const std::string &payload);
+      void processHeaders(uint8_t flags, uint32_t id,
+                          const std::string &payload);
+      void processHeaderBlock(uint8_t flags, uint32_t id);
+      void processSettings(uint8_t flags, const std::string &payload);
+      void processWindowUpdate(uint32_t id, const std::string &payload);
+
+      void newRequest(uint32_t id, const HPACK::headers_t &headers, bool end);
+      void dispatch(Stream &stream);
+
+      static std::string canonicalName(const std::string &name);
+      static bool isConnectionHeader(const std::string &name);
+      static uint32_t getU32(const std::string &s, unsigned offset);
+      static void addU32(std::string &s, uint32_t x);
+    };
+  }
+}
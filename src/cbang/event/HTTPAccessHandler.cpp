@@ -33,9 +33,13 @@
 #include "HTTPAccessHandler.h"
 
 #include "Request.h"
+#include "Connection.h"
+#include "HTTPError.h"
 
+#include <cbang/String.h>
 #include <cbang/log/Logger.h>
 #include <cbang/net/Session.h>
+#include <cbang/socket/Socket.h>
 
 using namespace std;
 using namespace cb;
@@ -67,8 +71,16 @@ bool HTTPAccessHandler::operator()(Request &req) {
   string user = req.getUser();
   bool allow;
   bool deny;
+  SocketCredentials cred;
 
-  if (session.isNull()) {
+  if (session.isNull() && req.hasConnection() &&
+      req.getConnection().getPeerCredentials(cred)) {
+    user  = "uid:" + String(cred.uid);
+    string group = "gid:" + String(cred.gid);
+    allow = userAllow(user) || groupAllow(group) || groupAllow("local");
+    deny  = userDeny(user) || groupDeny(group) || groupDeny("local");
+
+  } else if (session.isNull()) {
     user  = "@unauthenticted";
     allow = groupAllow("unauthenticted");
     deny  = groupDeny("unauthenticted");
@@ -94,7 +106,7 @@ bool HTTPAccessHandler::operator()(Request &req) {
            << user << ", " << req.getClientIP().getHost() << ") = "
            << ((allow && !deny) ? "true" : "false"));
 
-  if (!allow || deny) THROWX("Access denied", HTTP_UNAUTHORIZED);
+  if (!allow || deny) THROW_HTTP("Access denied", HTTP_UNAUTHORIZED);
 
   return false;
 }
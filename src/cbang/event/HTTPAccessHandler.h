@@ -42,6 +42,12 @@ namespace cb {
   namespace Event {
     class Request;
 
+    /**
+     * Allow or deny requests by session user and group.  Requests without
+     * a session from a Unix socket peer are instead identified, by the
+     * kernel, as user "uid:<uid>" in groups "gid:<gid>" and "local".
+     * Other requests without a session are in group "unauthenticted".
+     */
     class HTTPAccessHandler : public HTTPRequestHandler {
       std::set<std::string> userAllowed;
       std::set<std::string> userDenied;
@@ -0,0 +1,576 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "HTTPCacheHandler.h"
+#include "Request.h"
+#include "Connection.h"
+#include "Base.h"
+#include "Event.h"
+
+#include <cbang/String.h>
+#include <cbang/Catch.h>
+#include <cbang/log/Logger.h>
+#include <cbang/time/Timer.h>
+#include <cbang/util/RateSet.h>
+#include <cbang/util/SmartLock.h>
+
+#include <event2/buffer.h>
+
+#include <algorithm>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+namespace {
+  // Not stored, their values are set by each reply
+  const char *transientHeaders[] = {
+    "Age", "Connection", "Content-Length", "Date", "Keep-Alive",
+    "Transfer-Encoding", 0
+  };
+
+
+  bool isCacheableStatus(HTTPStatus code) {
+    switch (code) {
+    case HTTPStatus::HTTP_OK:
+    case HTTPStatus::HTTP_NON_AUTHORITATIVE_INFORMATION:
+    case HTTPStatus::HTTP_NO_CONTENT:
+    case HTTPStatus::HTTP_MULTIPLE_CHOICES:
+    case HTTPStatus::HTTP_MOVED_PERMANENTLY:
+    case HTTPStatus::HTTP_NOT_FOUND:
+    case HTTPStatus::HTTP_METHOD_NOT_ALLOWED:
+    case HTTPStatus::HTTP_GONE:
+    case HTTPStatus::HTTP_REQUEST_URI_TOO_LARGE:
+    case HTTPStatus::HTTP_NOT_IMPLEMENTED:
+      return true;
+    default: return false;
+    }
+  }
+
+
+  /// A copy of a client's request whose reply is captured but not sent
+  class Revalidation : public Request {
+  public:
+    Revalidation(Request &req) :
+      Request(req.getMethod(), req.getURI(), req.getVersion()) {
+      getInputHeaders() = req.getInputHeaders();
+      for (const char *name: {"If-None-Match", "If-Modified-Since", "Range",
+            "If-Range"})
+        inRemove(name);
+
+      setConnection(&req.getConnection());
+      setSession(req.getSession());
+      getArgs() = req.getArgs();
+    }
+
+    // From Request
+    void write() {}
+  };
+}
+
+
+struct HTTPCacheHandler::Entry {
+  string key;
+  string variant;
+  vector<string> vary;
+
+  bool pass = false; // Not storable, bypass the cache
+  HTTPStatus code;
+  Headers headers;
+  Buffer body;
+  string etag;
+
+  double created;
+  double expires;
+  double staleUntil;
+  unsigned size;
+};
+
+
+struct HTTPCacheHandler::Capture {
+  HTTPCacheHandler &handler;
+  string key;
+  string id;
+  bool leader;
+  bool done = false;
+
+  Capture(HTTPCacheHandler &handler, const string &key, const string &id,
+          bool leader) : handler(handler), key(key), id(id), leader(leader) {}
+
+  // The request was dropped or not handled without a reply
+  ~Capture() {if (!done) TRY_CATCH_ERROR(handler.store(*this, 0));}
+};
+
+
+/// Passes results to the requests waiting on one event loop
+struct HTTPCacheHandler::Mailbox {
+  HTTPCacheHandler &handler;
+  SmartPointer<Event> event;
+
+  Mutex lock;
+  vector<pair<string, EntryPtr> > results;
+
+  // Only accessed from the Base's thread
+  unordered_map<string, vector<SmartPointer<Request> > > waiting;
+
+  Mailbox(HTTPCacheHandler &handler, Base &base) :
+    handler(handler), event(base.newEvent(this, &Mailbox::deliver,
+                                          EF::EVENT_NO_SELF_REF)) {}
+
+
+  void post(const string &id, const EntryPtr &entry) {
+    SmartLock guard(&lock);
+    results.push_back(make_pair(id, entry));
+    event->activate();
+  }
+
+
+  void deliver() {
+    vector<pair<string, EntryPtr> > results;
+
+    {
+      SmartLock guard(&lock);
+      results.swap(this->results);
+    }
+
+    for (unsigned i = 0; i < results.size(); i++) {
+      auto it = waiting.find(results[i].first);
+      if (it == waiting.end()) continue;
+
+      vector<SmartPointer<Request> > reqs;
+      reqs.swap(it->second);
+      waiting.erase(it);
+
+      for (unsigned j = 0; j < reqs.size(); j++)
+        handler.resume(*reqs[j], results[i].second);
+    }
+  }
+};
+
+
+HTTPCacheHandler::HTTPCacheHandler(const HTTPRequestHandlerPtr &child,
+                                   uint64_t maxBytes, double ttl,
+                                   double staleTTL) :
+  child(child), maxBytes(maxBytes), ttl(ttl), staleTTL(staleTTL),
+  maxEntrySize(min<uint64_t>(maxBytes / 16, ~0U)) {
+  if (child.isNull()) THROW("Cache handler child cannot be NULL");
+}
+
+
+HTTPCacheHandler::~HTTPCacheHandler() {}
+
+
+uint64_t HTTPCacheHandler::getBytes() const {
+  SmartLock guard(&lock);
+  return bytes;
+}
+
+
+unsigned HTTPCacheHandler::getEntryCount() const {
+  SmartLock guard(&lock);
+  return lru.size();
+}
+
+
+void HTTPCacheHandler::clear() {
+  SmartLock guard(&lock);
+  lru.clear();
+  index.clear();
+  bytes = 0;
+}
+
+
+bool HTTPCacheHandler::isCacheable(const Request &req) const {
+  RequestMethod method = req.getMethod();
+  if (method != HTTP_GET && method != HTTP_HEAD) return false;
+  if (!req.hasConnection()) return false;
+
+  if (req.inHas("Authorization") &&
+      std::find(keyHeaders.begin(), keyHeaders.end(), "Authorization") ==
+      keyHeaders.end())
+    return false;
+
+  return true;
+}
+
+
+string HTTPCacheHandler::getKey(const Request &req) const {
+  const URI &uri = req.getURI();
+  string key = string(req.getMethod().toString()) + ' ' + uri.getPath();
+
+  for (unsigned i = 0; i < keyArgs.size(); i++)
+    if (uri.has(keyArgs[i]))
+      key += '\n' + keyArgs[i] + '=' + uri.get(keyArgs[i]);
+
+  for (unsigned i = 0; i < keyHeaders.size(); i++)
+    if (req.inHas(keyHeaders[i]))
+      key += '\n' + keyHeaders[i] + ": " + req.inGet(keyHeaders[i]);
+
+  return key;
+}
+
+
+bool HTTPCacheHandler::operator()(Request &req) {
+  if (!isCacheable(req)) return (*child)(req);
+
+  const Headers &hdrs = req.getInputHeaders();
+  bool refresh = hdrs.keyContains("Cache-Control", "no-cache") ||
+    hdrs.keyContains("Pragma", "no-cache");
+
+  string key = getKey(req);
+  string variant;
+  string id;
+  double now = Timer::now();
+  enum {MISS, HIT, STALE, WAIT} state = MISS;
+  bool leader = false;
+  bool revalidating = false;
+  EntryPtr entry;
+
+  {
+    SmartLock guard(&lock);
+
+    if (!refresh) entry = find(key, req, variant);
+    id = key + '\n' + variant;
+    bool usable = entry.isSet() && !entry->pass;
+
+    if (usable && now < entry->expires) state = HIT;
+
+    else if (usable && now < entry->staleUntil) {
+      // Serve stale and revalidate unless already in progress
+      state = STALE;
+      revalidating = pending.insert(make_pair(id, set<Mailbox *>())).second;
+
+    } else if (!refresh && (entry.isNull() || !entry->pass)) {
+      auto it = pending.find(id);
+
+      if (it == pending.end()) {
+        pending[id];
+        leader = true;
+
+      } else {
+        // Wait for the request already in progress
+        Mailbox &mailbox = getMailbox(req.getConnection().getBase());
+        it->second.insert(&mailbox);
+        mailbox.waiting[id].push_back(&req);
+        state = WAIT;
+      }
+    }
+  }
+
+  switch (state) {
+  case HIT:
+    event("cache-hit");
+    serve(req, *entry, now);
+    return true;
+
+  case STALE:
+    event("cache-stale");
+    serve(req, *entry, now);
+    if (revalidating) revalidate(req, key, id);
+    return true;
+
+  case WAIT:
+    event("cache-coalesced");
+    return true;
+
+  case MISS: break;
+  }
+
+  event("cache-miss");
+  capture(req, key, id, leader);
+  if ((*child)(req)) return true;
+
+  req.onReply(0); // Releases any waiting requests
+  return false;
+}
+
+
+string HTTPCacheHandler::getVariant(const Request &req,
+                                    const vector<string> &vary) const {
+  string variant;
+
+  for (unsigned i = 0; i < vary.size(); i++) {
+    if (i) variant += '\n';
+    variant += req.inFind(vary[i]);
+  }
+
+  return variant;
+}
+
+
+HTTPCacheHandler::EntryPtr
+HTTPCacheHandler::find(const string &key, const Request &req,
+                       string &variant) {
+  auto it = index.find(key);
+  if (it == index.end()) return 0;
+
+  Variants &variants = it->second;
+  variant = getVariant(req, variants.vary);
+
+  auto it2 = variants.entries.find(variant);
+  if (it2 == variants.entries.end()) return 0;
+
+  lru.splice(lru.begin(), lru, it2->second);
+  return *it2->second;
+}
+
+
+void HTTPCacheHandler::insert(const EntryPtr &entry) {
+  // A changed Vary invalidates the other variants
+  auto it2 = index.find(entry->key);
+  if (it2 != index.end() && it2->second.vary != entry->vary)
+    while (index.count(entry->key))
+      remove(index[entry->key].entries.begin()->second);
+
+  Variants &v = index[entry->key];
+  v.vary = entry->vary;
+
+  auto it = v.entries.find(entry->variant);
+  if (it != v.entries.end()) {
+    bytes -= (*it->second)->size;
+    lru.erase(it->second);
+  }
+
+  lru.push_front(entry);
+  v.entries[entry->variant] = lru.begin();
+  bytes += entry->size;
+
+  while (maxBytes < bytes && 1 < lru.size()) remove(--lru.end());
+}
+
+
+void HTTPCacheHandler::remove(lru_t::iterator it) {
+  const Entry &entry = **it;
+
+  auto it2 = index.find(entry.key);
+  if (it2 != index.end()) {
+    it2->second.entries.erase(entry.variant);
+    if (it2->second.entries.empty()) index.erase(it2);
+  }
+
+  bytes -= entry.size;
+  lru.erase(it);
+}
+
+
+HTTPCacheHandler::Mailbox &HTTPCacheHandler::getMailbox(Base &base) {
+  auto &mailbox = mailboxes[&base];
+  if (mailbox.isNull()) mailbox = new Mailbox(*this, base);
+  return *mailbox;
+}
+
+
+void HTTPCacheHandler::capture(Request &req, const string &key,
+                               const string &id, bool leader) {
+  SmartPointer<Capture> capture = new Capture(*this, key, id, leader);
+
+  req.onReply([capture] (Request &req) {
+    capture->done = true;
+    capture->handler.store(*capture, &req);
+  });
+}
+
+
+HTTPCacheHandler::EntryPtr
+HTTPCacheHandler::createEntry(const string &key, Request &req, double now) {
+  if (req.isChunked() || req.isStreaming()) return 0;
+  if (!isCacheableStatus(req.getResponseCode())) return 0;
+
+  EntryPtr entry = new Entry;
+  entry->key = key;
+  entry->code = req.getResponseCode();
+  entry->created = now;
+
+  const Headers &hdrs = req.getOutputHeaders();
+  bool pass = !hdrs.find("Set-Cookie").empty();
+  double maxAge = ttl;
+  double stale = staleTTL;
+
+  // Cache-Control
+  vector<string> directives;
+  String::tokenize(String::toLower(hdrs.find("Cache-Control")), directives,
+                   ", ");
+
+  bool sharedMaxAge = false;
+  for (unsigned i = 0; i < directives.size(); i++) {
+    const string &d = directives[i];
+    string value;
+
+    size_t eq = d.find('=');
+    if (eq != string::npos) value = String::trim(d.substr(eq + 1), "\"");
+    string name = d.substr(0, eq);
+
+    try {
+      if (name == "no-store" || name == "no-cache" || name == "private")
+        pass = true;
+      else if (name == "s-maxage") {
+        maxAge = String::parseDouble(value);
+        sharedMaxAge = true;
+      } else if (name == "max-age" && !sharedMaxAge)
+        maxAge = String::parseDouble(value);
+      else if (name == "stale-while-revalidate")
+        stale = String::parseDouble(value);
+    } catch (const Exception &e) {pass = true;}
+  }
+
+  if (maxAge <= 0 && stale <= 0) pass = true;
+
+  // Vary
+  vector<string> vary;
+  String::tokenize(hdrs.find("Vary"), vary, ", ");
+  for (unsigned i = 0; i < vary.size(); i++)
+    if (vary[i] == "*") pass = true;
+
+  // Body
+  const Buffer &out = req.getOutputBuffer();
+  if (maxEntrySize < out.getLength()) pass = true;
+
+  if (pass) {
+    entry->pass = true;
+    entry->expires = now + ttl;
+    entry->staleUntil = entry->expires;
+    entry->size = key.size() + sizeof(Entry);
+    return entry;
+  }
+
+  sort(vary.begin(), vary.end());
+  entry->vary = vary;
+  entry->variant = getVariant(req, vary);
+  entry->expires = now + max(0.0, maxAge);
+  entry->staleUntil = entry->expires + max(0.0, stale);
+
+  entry->headers = hdrs;
+  for (unsigned i = 0; transientHeaders[i]; i++)
+    entry->headers.remove(transientHeaders[i]);
+  entry->etag = hdrs.find("ETag");
+
+  // Copy the body once so each reply can reference it.  Locking lets
+  // replies on other threads reference it concurrently.
+  vector<iovec> space;
+  out.peek(space);
+  for (unsigned i = 0; i < space.size(); i++)
+    entry->body.add((const char *)space[i].iov_base, space[i].iov_len);
+  evbuffer_enable_locking(entry->body.getBuffer(), 0);
+
+  entry->size = sizeof(Entry) + key.size() + entry->variant.size() +
+    out.getLength();
+  for (auto it = hdrs.begin(); it != hdrs.end(); it++)
+    entry->size += it->first.size() + it->second.size();
+
+  return entry;
+}
+
+
+void HTTPCacheHandler::store(Capture &capture, Request *req) {
+  EntryPtr entry;
+  if (req) entry = createEntry(capture.key, *req, Timer::now());
+
+  set<Mailbox *> waiting;
+
+  {
+    SmartLock guard(&lock);
+
+    if (entry.isSet()) insert(entry);
+
+    if (capture.leader) {
+      auto it = pending.find(capture.id);
+
+      if (it != pending.end()) {
+        waiting.swap(it->second);
+        pending.erase(it);
+      }
+    }
+  }
+
+  if (entry.isSet() && entry->pass) entry.release();
+
+  for (auto it = waiting.begin(); it != waiting.end(); it++)
+    (*it)->post(capture.id, entry);
+}
+
+
+void HTTPCacheHandler::serve(Request &req, const Entry &entry, double now) {
+  const Headers &hdrs = entry.headers;
+
+  for (auto it = hdrs.begin(); it != hdrs.end(); it++)
+    if (!it->second.empty()) req.outSet(it->first, it->second);
+
+  req.outSet("Age", String((uint64_t)max(0.0, now - entry.created)));
+
+  if (entry.code == HTTPStatus::HTTP_OK && !entry.etag.empty() &&
+      req.checkNotModified(entry.etag)) return;
+
+  if (entry.body.getLength()) req.getOutputBuffer().addRef(entry.body);
+  req.reply(entry.code);
+}
+
+
+void HTTPCacheHandler::revalidate(Request &req, const string &key,
+                                  const string &id) {
+  SmartPointer<Request> reval = new Revalidation(req);
+  capture(*reval, key, id, true);
+
+  try {
+    if ((*child)(*reval)) return;
+  } catch (const Exception &e) {
+    LOG_WARNING("Cache revalidation of " << req.getURI() << " failed: "
+                << e.getMessages());
+  }
+
+  reval->onReply(0);
+}
+
+
+void HTTPCacheHandler::resume(Request &req, const EntryPtr &entry) {
+  if (!req.isConnected()) return;
+
+  try {
+    if (entry.isSet()) {
+      if (entry->variant == getVariant(req, entry->vary))
+        return serve(req, *entry, Timer::now());
+
+      // The response varies on headers which were not known, look again
+      if (!(*this)(req)) req.sendError(HTTPStatus::HTTP_NOT_FOUND);
+
+    } else if (!(*child)(req)) req.sendError(HTTPStatus::HTTP_NOT_FOUND);
+
+  } catch (const Exception &e) {
+    if (!req.isReplying()) req.sendError(e);
+  }
+}
+
+
+void HTTPCacheHandler::event(const char *name) {
+  if (stats.isSet()) stats->event(name);
+}
@@ -0,0 +1,181 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "HTTPRequestHandler.h"
+
+#include <cbang/SmartPointer.h>
+#include <cbang/os/Mutex.h>
+
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <set>
+#include <unordered_map>
+
+
+namespace cb {
+  class RateSet;
+
+  namespace Event {
+    class Base;
+    class Request;
+
+    /**
+     * Caches the responses of another handler in memory.
+     *
+     * Only GET and HEAD requests without an Authorization header, unless
+     * Authorization is one of the key headers, are cached.  Responses are
+     * keyed on the method, the path, the configured query arguments and
+     * request headers and the request headers named by the response's Vary.
+     * A response is stored if its status is cacheable by default, its
+     * Cache-Control allows a shared cache to store it and it has no
+     * Set-Cookie.  Its freshness comes from Cache-Control max-age, or
+     * s-maxage, or the default TTL.  Stale-while-revalidate, from the
+     * response or the default, lets a stale response be served while a
+     * single request refreshes it in the background.
+     *
+     * Bodies are kept as pre-encoded Buffers which are referenced, not
+     * copied, by each reply.  The cache is bounded in bytes and evicts the
+     * least recently used responses first.
+     *
+     * Concurrent misses for the same response are coalesced.  The first
+     * request goes to the backend handler and the others wait for its
+     * reply, even when they arrive on other event loops.  Responses which
+     * must not be stored are remembered for the default TTL so that later
+     * requests for them go straight to the backend instead of waiting.
+     *
+     * Revalidation runs the backend on a copy of the client's request
+     * whose reply is not written.  Backend handlers which cast the Request
+     * to a derived type are therefore only supported without stale
+     * serving.
+     */
+    class HTTPCacheHandler : public HTTPRequestHandler {
+    public:
+      struct Entry;
+      typedef SmartPointer<Entry>::Protected EntryPtr;
+
+    protected:
+      struct Capture;
+      struct Mailbox;
+      typedef std::list<EntryPtr> lru_t;
+
+      struct Variants {
+        std::vector<std::string> vary;
+        std::unordered_map<std::string, lru_t::iterator> entries;
+      };
+
+      HTTPRequestHandlerPtr child;
+      uint64_t maxBytes;
+      double ttl;
+      double staleTTL;
+      unsigned maxEntrySize;
+      std::vector<std::string> keyArgs;
+      std::vector<std::string> keyHeaders;
+      SmartPointer<RateSet> stats;
+
+      Mutex lock;
+      uint64_t bytes = 0;
+      lru_t lru; // Most recently used first
+      std::unordered_map<std::string, Variants> index;
+      std::unordered_map<std::string, std::set<Mailbox *> > pending;
+      std::map<Base *, SmartPointer<Mailbox> > mailboxes;
+
+    public:
+      /**
+       * @param child The handler whose responses are cached.
+       * @param maxBytes The approximate memory limit of the cache.
+       * @param ttl Seconds a response is fresh if it does not say.
+       * @param staleTTL Seconds a response may be served stale while it is
+       *   revalidated, if it does not say.
+       */
+      HTTPCacheHandler(const HTTPRequestHandlerPtr &child,
+                       uint64_t maxBytes = 64 * 1024 * 1024, double ttl = 60,
+                       double staleTTL = 0);
+      ~HTTPCacheHandler();
+
+      const HTTPRequestHandlerPtr &getChild() const {return child;}
+
+      uint64_t getMaxBytes() const {return maxBytes;}
+      double getTTL() const {return ttl;}
+      void setTTL(double ttl) {this->ttl = ttl;}
+      double getStaleTTL() const {return staleTTL;}
+      void setStaleTTL(double staleTTL) {this->staleTTL = staleTTL;}
+
+      unsigned getMaxEntrySize() const {return maxEntrySize;}
+      /// Larger responses are not stored, defaults to 1/16 of maxBytes
+      void setMaxEntrySize(unsigned size) {maxEntrySize = size;}
+
+      /// Include query argument @param name in the cache key
+      void addKeyArg(const std::string &name) {keyArgs.push_back(name);}
+      /// Include request header @param name in the cache key
+      void addKeyHeader(const std::string &name) {keyHeaders.push_back(name);}
+
+      /// Counts "cache-hit", "cache-stale", "cache-miss" and
+      /// "cache-coalesced" events
+      void setStats(const SmartPointer<RateSet> &stats) {this->stats = stats;}
+      const SmartPointer<RateSet> &getStats() const {return stats;}
+
+      uint64_t getBytes() const;
+      unsigned getEntryCount() const;
+      void clear();
+
+      bool isCacheable(const Request &req) const;
+      std::string getKey(const Request &req) const;
+
+      // From HTTPRequestHandler
+      bool operator()(Request &req);
+
+    protected:
+      std::string getVariant(const Request &req,
+                             const std::vector<std::string> &vary) const;
+      EntryPtr find(const std::string &key, const Request &req,
+                    std::string &variant);
+      void insert(const EntryPtr &entry);
+      void remove(lru_t::iterator it);
+      Mailbox &getMailbox(Base &base);
+
+      void capture(Request &req, const std::string &key,
+                   const std::string &id, bool leader);
+      EntryPtr createEntry(const std::string &key, Request &req, double now);
+      void store(Capture &capture, Request *req);
+      void serve(Request &req, const Entry &entry, double now);
+      void revalidate(Request &req, const std::string &key,
+                      const std::string &id);
+      void resume(Request &req, const EntryPtr &entry);
+      void event(const char *name);
+    };
+  }
+}
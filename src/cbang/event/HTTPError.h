@@ -0,0 +1,66 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "HTTPStatus.h"
+
+#include <cbang/Throw.h>
+
+
+namespace cb {
+  namespace Event {
+    /**
+     * Thrown to reject a request with an HTTP error status.  These are
+     * expected, e.g. 404s or failed validation, so no stack trace is
+     * captured.  Request::sendError() replies with the code.
+     */
+    class HTTPError : public Exception {
+    public:
+      HTTPError(const std::string &message, const FileLocation &location,
+                int code = HTTPStatus::HTTP_INTERNAL_SERVER_ERROR) :
+        Exception(message, code, location, 0, false) {}
+
+      HTTPError(HTTPStatus code, const std::string &message = std::string()) :
+        Exception(message.empty() ? code.getDescription() : message, code,
+                  FileLocation(), 0, false) {}
+    };
+  }
+}
+
+/// Throw an Event::HTTPError with status @param CODE
+#define CBANG_THROW_HTTP(MSG, CODE)                     \
+  CBANG_THROWTX(cb::Event::HTTPError, MSG, CODE)
+
+#ifdef USING_CBANG
+#define THROW_HTTP(MSG, CODE) CBANG_THROW_HTTP(MSG, CODE)
+#endif
@@ -31,14 +31,121 @@
 \******************************************************************************/
 
 #include "HTTPHandlerGroup.h"
+#include "HTTPMethodMatcher.h"
+#include "HTTPRE2PatternMatcher.h"
+#include "Request.h"
+
+#include <cbang/util/SmartLock.h>
+
+#include <re2/re2.h>
+#include <re2/set.h>
+
+#include <algorithm>
+#include <map>
 
 using namespace cb::Event;
 using namespace cb;
 using namespace std;
 
 
+/**
+ * Every handler's method and pattern, compiled so that one pass over the
+ * request path finds the handlers which may match.  Those are then tried
+ * in their original order so the matchers still extract the captures.
+ */
+struct HTTPHandlerGroup::Router {
+  vector<unsigned> methods;
+  vector<unsigned> unmatched; // Handlers without a recognized pattern
+  map<string, vector<unsigned> > literals;
+  SmartPointer<RE2::Set> set;
+  vector<unsigned> setHandlers;
+
+
+  static bool isLiteral(const string &pattern) {
+    return pattern.find_first_of("\\.^$|?*+()[]{}") == string::npos;
+  }
+
+
+  Router(const handlers_t &handlers) :
+    set(new RE2::Set(RE2::Options(), RE2::ANCHOR_BOTH)) {
+    for (unsigned i = 0; i < handlers.size(); i++) {
+      const HTTPRequestHandler *handler = handlers[i].get();
+      unsigned m = RequestMethod::HTTP_ANY;
+
+      auto methodMatcher = dynamic_cast<const HTTPMethodMatcher *>(handler);
+      if (methodMatcher) {
+        m = methodMatcher->getMethods();
+        handler = methodMatcher->getChild().get();
+      }
+
+      methods.push_back(m);
+
+      auto patternMatcher =
+        dynamic_cast<const HTTPRE2PatternMatcher *>(handler);
+      if (!patternMatcher) {
+        unmatched.push_back(i);
+        continue;
+      }
+
+      const string &pattern = patternMatcher->getPattern();
+      string error;
+
+      if (isLiteral(pattern)) literals[pattern].push_back(i);
+      else if (set->Add(pattern, &error) < 0) unmatched.push_back(i);
+      else setHandlers.push_back(i);
+    }
+
+    if (setHandlers.empty()) set.release();
+
+    else if (!set->Compile()) {
+      // Out of memory, try these handlers on every request
+      set.release();
+      unmatched.insert(unmatched.end(), setHandlers.begin(),
+                       setHandlers.end());
+      sort(unmatched.begin(), unmatched.end());
+      setHandlers.clear();
+    }
+  }
+
+
+  void add(unsigned i, unsigned method, vector<unsigned> &routes) const {
+    if (methods[i] & method) routes.push_back(i);
+  }
+
+
+  void match(const string &path, unsigned method,
+             vector<unsigned> &routes) const {
+    for (unsigned i = 0; i < unmatched.size(); i++)
+      add(unmatched[i], method, routes);
+
+    auto it = literals.find(path);
+    if (it != literals.end())
+      for (unsigned i = 0; i < it->second.size(); i++)
+        add(it->second[i], method, routes);
+
+    vector<int> hits;
+    if (set.isSet() && set->Match(path, &hits))
+      for (unsigned i = 0; i < hits.size(); i++)
+        add(setHandlers[hits[i]], method, routes);
+
+    sort(routes.begin(), routes.end());
+  }
+};
+
+
+HTTPHandlerGroup::HTTPHandlerGroup
+(const SmartPointer<HTTPHandlerFactory> &factory) : factory(factory) {}
+
+
+HTTPHandlerGroup::~HTTPHandlerGroup() {}
+
+
 void HTTPHandlerGroup::addHandler
-(const SmartPointer<HTTPRequestHandler> &handler) {handlers.push_back(handler);}
+(const SmartPointer<HTTPRequestHandler> &handler) {
+  SmartLock lock(&routerLock);
+  handlers.push_back(handler);
+  router.release(); // Rebuild on next request
+}
 
 
 void HTTPHandlerGroup::addHandler
@@ -88,8 +195,18 @@ HTTPHandlerGroup::addGroup(unsigned methods, const string &search,
 
 
 bool HTTPHandlerGroup::operator()(Request &req) {
-  for (unsigned i = 0; i < handlers.size(); i++)
-    if ((*handlers[i])(req)) return true;
+  vector<unsigned> routes;
+  getRouter()->match(req.getURI().getEscapedPath(), req.getMethod(), routes);
+
+  for (unsigned i = 0; i < routes.size(); i++)
+    if ((*handlers[routes[i]])(req)) return true;
 
   return false;
 }
+
+
+SmartPointer<HTTPHandlerGroup::Router> HTTPHandlerGroup::getRouter() {
+  SmartLock lock(&routerLock);
+  if (router.isNull()) router = new Router(handlers);
+  return router;
+}
@@ -35,6 +35,8 @@
 #include "HTTPHandlerFactory.h"
 #include "HTTPRequestHandler.h"
 
+#include <cbang/os/Mutex.h>
+
 #include <vector>
 
 
@@ -48,10 +50,14 @@ namespace cb {
       typedef std::vector<SmartPointer<HTTPRequestHandler> > handlers_t;
       handlers_t handlers;
 
+      struct Router;
+      SmartPointer<Router> router;
+      Mutex routerLock;
+
     public:
       HTTPHandlerGroup(const SmartPointer<HTTPHandlerFactory> &factory =
-                       new HTTPHandlerFactory) : factory(factory) {}
-      virtual ~HTTPHandlerGroup() {}
+                       new HTTPHandlerFactory);
+      virtual ~HTTPHandlerGroup();
 
       void addHandler(const SmartPointer<HTTPRequestHandler> &handler);
       void addHandler(unsigned methods, const std::string &search,
@@ -102,15 +108,17 @@ namespace cb {
 
       // JSON member callbacks
       template <class T> void addMember
-      (T *obj, typename HTTPRequestJSONMemberHandler<T>::member_t member) {
-        addHandler(new HTTPRequestJSONMemberHandler<T>(obj, member));
+      (T *obj, typename HTTPRequestJSONMemberHandler<T>::member_t member,
+       const SmartPointer<JSON::Schema> &schema = 0) {
+        addHandler(new HTTPRequestJSONMemberHandler<T>(obj, member, schema));
       }
 
       template <class T> void addMember
       (unsigned methods, const std::string &pattern,
-       T *obj, typename HTTPRequestJSONMemberHandler<T>::member_t member) {
+       T *obj, typename HTTPRequestJSONMemberHandler<T>::member_t member,
+       const SmartPointer<JSON::Schema> &schema = 0) {
         addHandler(methods, pattern,
-                   new HTTPRequestJSONMemberHandler<T>(obj, member));
+                   new HTTPRequestJSONMemberHandler<T>(obj, member, schema));
       }
 
       // JSON Recast member callbacks
@@ -128,6 +136,9 @@ namespace cb {
 
       // From HTTPRequestHandler
       bool operator()(Request &req);
+
+    protected:
+      SmartPointer<Router> getRouter();
     };
   }
 }
@@ -48,6 +48,9 @@ namespace cb {
                         const SmartPointer<HTTPRequestHandler> &child) :
         methods(methods), child(child) {}
 
+      unsigned getMethods() const {return methods;}
+      const SmartPointer<HTTPRequestHandler> &getChild() const {return child;}
+
       // From HTTPRequestHandler
       bool operator()(Request &req);
     };
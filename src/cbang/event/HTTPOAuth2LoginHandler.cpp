@@ -105,6 +105,8 @@ bool HTTPOAuth2LoginHandler::operator()(Request &req) {
       (req, session->getID(), session->getString("redirect_uri", "")))
     return true;
 
+  loadKeys();
+
   URI redirectURI =
     getOAuth2()->getRedirectURL(req.getURI().getPath(), session->getID());
 
@@ -67,6 +67,11 @@ HTTPRE2PatternMatcher::HTTPRE2PatternMatcher
 }
 
 
+const string &HTTPRE2PatternMatcher::getPattern() const {
+  return pri->regex.pattern();
+}
+
+
 bool HTTPRE2PatternMatcher::operator()(Request &req) {
   int n = pri->regex.NumberOfCapturingGroups();
   vector<RE2::Arg> args(n);
@@ -105,5 +110,10 @@ bool HTTPRE2PatternMatcher::operator()(Request &req) {
     uri.setPath(path);
 
   // Call child
-  return (*child)(req);
+  string route = req.getRoute();
+  req.setRoute(pri->regex.pattern());
+  if ((*child)(req)) return true;
+
+  req.setRoute(route);
+  return false;
 }
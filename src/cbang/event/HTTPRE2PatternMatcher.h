@@ -54,6 +54,7 @@ namespace cb {
                             const std::string &replace,
                             const SmartPointer<HTTPRequestHandler> &child);
 
+      const std::string &getPattern() const;
       const std::set<std::string> &getArgs() const {return args;}
 
       // From HTTPRequestHandler
@@ -33,6 +33,7 @@
 #include "HTTPRequestHandler.h"
 
 #include <cbang/json/Writer.h>
+#include <cbang/json/CBORWriter.h>
 #include <cbang/log/Logger.h>
 
 using namespace cb::Event;
@@ -42,10 +43,15 @@ using namespace std;
 bool HTTPRequestJSONHandler::operator()(Request &req) {
   try {
     // Setup JSON output
-    SmartPointer<JSON::Writer> writer = req.getJSONWriter();
-
-    // Parse JSON message
-    JSON::ValuePtr msg = req.getJSONMessage();
+    SmartPointer<JSON::NullSink> writer = req.getJSONSink();
+
+    // Parse and validate JSON message
+    JSON::ValuePtr msg;
+    try {
+      msg = req.getJSONMessage(schema);
+    } catch (const Exception &e) {
+      THROWX(e.getMessage(), HTTP_BAD_REQUEST);
+    }
 
     // Log JSON call
     const string &path = req.getURI().getPath();
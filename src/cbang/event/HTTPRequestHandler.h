@@ -37,6 +37,7 @@
 
 #include <cbang/json/Value.h>
 #include <cbang/json/Sink.h>
+#include <cbang/json/Schema.h>
 
 #include <functional>
 
@@ -97,6 +98,12 @@ namespace cb {
 
 
     struct HTTPRequestJSONHandler : public HTTPRequestHandler {
+      /// When set, messages which do not match are rejected with 400
+      SmartPointer<JSON::Schema> schema;
+
+      HTTPRequestJSONHandler(const SmartPointer<JSON::Schema> &schema = 0) :
+        schema(schema) {}
+
       virtual void operator()
       (Request &, const JSON::ValuePtr &, JSON::Sink &) = 0;
 
@@ -112,8 +119,9 @@ namespace cb {
       T *obj;
       member_t member;
 
-      HTTPRequestJSONMemberHandler(T *obj, member_t member) :
-        obj(obj), member(member) {
+      HTTPRequestJSONMemberHandler
+      (T *obj, member_t member, const SmartPointer<JSON::Schema> &schema = 0) :
+        HTTPRequestJSONHandler(schema), obj(obj), member(member) {
         if (!obj) CBANG_THROW("Object cannot be NULL");
         if (!member) CBANG_THROW("Member cannot be NULL");
       }
@@ -0,0 +1,70 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Base.h"
+
+#include <cbang/SmartPointer.h>
+#include <cbang/os/Thread.h>
+
+
+namespace cb {
+  namespace Event {
+    class HTTP;
+
+    /// Runs HTTP and HTTPS listeners on their own event loop and thread
+    class HTTPThread : public Thread {
+      Base base;
+      SmartPointer<HTTP> http;
+      SmartPointer<HTTP> https;
+
+    public:
+      /// Creates HTTP listeners with the same handlers and settings
+      HTTPThread(const HTTP &http, const SmartPointer<HTTP> &https = 0);
+      ~HTTPThread();
+
+      Base &getBase() {return base;}
+      const SmartPointer<HTTP> &getHTTP() const {return http;}
+      const SmartPointer<HTTP> &getHTTPS() const {return https;}
+
+      // From Thread
+      void stop();
+
+    protected:
+      SmartPointer<HTTP> clone(const HTTP &http);
+
+      // From Thread
+      void run();
+    };
+  }
+}
@@ -0,0 +1,161 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "HeaderParser.h"
+#include "Headers.h"
+#include "Buffer.h"
+
+#include <cbang/Exception.h>
+#include <cbang/String.h>
+
+#include <cstring>
+#include <strings.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+namespace {
+  const string names[] = {
+    "Accept", "Accept-Charset", "Accept-Encoding", "Accept-Language",
+    "Accept-Ranges", "Access-Control-Allow-Origin", "Age", "Allow",
+    "Authorization", "Cache-Control", "Connection", "Content-Disposition",
+    "Content-Encoding", "Content-Language", "Content-Length",
+    "Content-Range", "Content-Type", "Cookie", "Date", "DNT", "ETag",
+    "Expect", "Expires", "Forwarded", "From", "Host", "If-Match",
+    "If-Modified-Since", "If-None-Match", "If-Range", "If-Unmodified-Since",
+    "Keep-Alive", "Last-Modified", "Link", "Location", "Origin", "Pragma",
+    "Proxy-Authorization", "Range", "Referer", "Sec-Fetch-Dest",
+    "Sec-Fetch-Mode", "Sec-Fetch-Site", "Sec-WebSocket-Accept",
+    "Sec-WebSocket-Extensions", "Sec-WebSocket-Key", "Sec-WebSocket-Protocol",
+    "Sec-WebSocket-Version", "Server", "Set-Cookie", "TE",
+    "Transfer-Encoding", "Upgrade", "Upgrade-Insecure-Requests",
+    "User-Agent", "Vary", "Via", "WWW-Authenticate", "X-Forwarded-For",
+    "X-Forwarded-Host", "X-Forwarded-Proto", "X-Real-IP",
+    "X-Requested-With",
+  };
+
+
+  bool isSpace(char c) {return c == ' ' || c == '\t';}
+}
+
+
+bool HeaderParser::parse(Buffer &buf, Headers &headers, unsigned maxSize) {
+  unsigned length = buf.getLength();
+
+  // Scan only new data for the blank line which ends the block
+  while (scanned < length) {
+    // Pull up no more than needed, the body may follow the headers
+    unsigned window = min(length, max(2 * scanned, 8192U));
+    const char *data = buf.pullup(window);
+    const char *eol =
+      (const char *)memchr(data + scanned, '\n', window - scanned);
+
+    if (!eol) {
+      scanned = window;
+      if (maxSize && maxSize < scanned) THROW("Header too long");
+      continue;
+    }
+
+    unsigned end = eol - data + 1;
+    if (maxSize && maxSize < end) THROW("Header too long");
+
+    unsigned lineLength = end - lineStart - 1;
+    if (lineLength && data[end - 2] == '\r') lineLength--;
+
+    if (!lineLength) {
+      // Last header
+      parseBlock(data, lineStart, headers);
+      buf.drain(end);
+      reset();
+      return true;
+    }
+
+    lineStart = scanned = end;
+  }
+
+  return false;
+}
+
+
+const string *HeaderParser::intern(const char *name, unsigned length) {
+  const unsigned count = sizeof(names) / sizeof(string);
+
+  for (unsigned i = 0; i < count; i++)
+    if (names[i].length() == length &&
+        !strncasecmp(names[i].data(), name, length))
+      return &names[i];
+
+  return 0;
+}
+
+
+void HeaderParser::parseBlock(const char *data, unsigned length,
+                              Headers &headers) {
+  const char *end = data + length;
+
+  while (data < end) {
+    const char *eol = (const char *)memchr(data, '\n', end - data);
+    const char *lineEnd = eol ? eol : end;
+    const char *next = eol ? eol + 1 : end;
+    if (data < lineEnd && lineEnd[-1] == '\r') lineEnd--;
+
+    // Continuation line
+    if (isSpace(*data)) {
+      if (headers.empty())
+        THROW("Invalid header line: " << string(data, lineEnd - data));
+
+      while (data < lineEnd && isSpace(*data)) data++;
+      while (data < lineEnd && isSpace(lineEnd[-1])) lineEnd--;
+      headers.get(headers.size() - 1).append(data, lineEnd - data);
+
+      data = next;
+      continue;
+    }
+
+    const char *colon = (const char *)memchr(data, ':', lineEnd - data);
+    if (!colon) THROW("Invalid header line: " << string(data, lineEnd - data));
+
+    // Value without surrounding white space
+    const char *value = colon + 1;
+    while (value < lineEnd && isSpace(*value)) value++;
+    while (value < lineEnd && isSpace(lineEnd[-1])) lineEnd--;
+
+    const string *name = intern(data, colon - data);
+    if (name) headers.insert(*name, string(value, lineEnd - value));
+    else headers.insert(string(data, colon - data),
+                        string(value, lineEnd - value));
+
+    data = next;
+  }
+}
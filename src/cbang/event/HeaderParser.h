@@ -0,0 +1,68 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <string>
+
+
+namespace cb {
+  namespace Event {
+    class Buffer;
+    class Headers;
+
+    /**
+     * Resumable HTTP header block parser.  Remembers how much of the input
+     * has already been scanned between calls and parses the complete block
+     * in place once the terminating blank line arrives, rather than reading
+     * and allocating one line at a time.  Common header names are mapped to
+     * their canonical spelling.
+     */
+    class HeaderParser {
+      unsigned lineStart = 0;
+      unsigned scanned = 0;
+
+    public:
+      void reset() {lineStart = scanned = 0;}
+
+      /// @return true when the block is complete and removed from @param buf
+      bool parse(Buffer &buf, Headers &headers, unsigned maxSize = 0);
+
+      /// @return the canonical name of a common header or null
+      static const std::string *intern(const char *name, unsigned length);
+
+    protected:
+      static void parseBlock(const char *data, unsigned length,
+                             Headers &headers);
+    };
+  }
+}
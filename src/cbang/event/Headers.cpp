@@ -32,33 +32,38 @@
 
 #include "Headers.h"
 #include "Buffer.h"
+#include "HeaderParser.h"
 
 #include <cbang/Exception.h>
 #include <cbang/String.h>
 #include <cbang/http/ContentTypes.h>
 
+#include <strings.h>
+
 using namespace cb::Event;
 using namespace std;
 
 
-string Headers::find(const string &key) const {return has(key) ? get(key) : "";}
-void Headers::remove(const std::string &key) {if (has(key)) insert(key, "");}
-
+bool Headers::keyContains(const string &key, const string &value) const {
+  const string &hdr = find(key);
 
-bool Headers::keyContains(const string &key, const string &value) const{
-  string hdr = String::toLower(find(key));
-  vector<string> parts;
+  // Compare each space or comma separated token, ignoring case
+  for (size_t start = 0; start < hdr.size();) {
+    size_t end = hdr.find_first_of(" ,", start);
+    if (end == string::npos) end = hdr.size();
 
-  String::tokenize(hdr, parts, " ,");
+    if (end - start == value.size() &&
+        !strncasecmp(hdr.data() + start, value.data(), value.size()))
+      return true;
 
-  for (unsigned i = 0; i < parts.size(); i++)
-    if (parts[i] == String::toLower(value)) return true;
+    start = end + 1;
+  }
 
   return false;
 }
 
 
-string Headers::getContentType() const {return find("Content-Type");}
+const string &Headers::getContentType() const {return find("Content-Type");}
 
 
 void Headers::setContentType(const string &contentType) {
@@ -81,35 +86,17 @@ bool Headers::connectionKeepAlive() const {
 
 
 bool Headers::parse(Buffer &buf, unsigned maxSize) {
-  unsigned bytes = 0;
-
-  while (buf.getLength()) {
-    string line = buf.readLine(maxSize ? maxSize - bytes : 0);
-
-    // Last header
-    if (line.empty()) return true;
-
-    bytes += line.length() + 2;
-    if (maxSize && maxSize < bytes) THROW("Header too long");
+  return HeaderParser().parse(buf, *this, maxSize);
+}
 
-    // Continuation line
-    if (line[0] == ' ' || line[0] == '\t') {
-      if (empty()) THROW("Invalid header line: " << line);
-      get(size() - 1) += String::trim(line);
-      continue;
-    }
 
-    // Parse
-    size_t semi = line.find_first_of(':');
-    if (semi == string::npos) THROW("Invalid header line: " << line);
+const string &Headers::valueAt(int i) const {
+  static const string none;
+  return i < 0 ? none : get(i);
+}
 
-    string key = line.substr(0, semi);
-    string value = String::trim(line.substr(semi + 1));
-    insert(key, value);
-  }
 
-  return false;
-}
+void Headers::clearAt(int i) {if (0 <= i) get(i).clear();}
 
 
 void Headers::write(ostream &stream) const {
@@ -32,7 +32,7 @@
 
 #pragma once
 
-#include <cbang/util/OrderedDict.h>
+#include <cbang/util/FlatOrderedDict.h>
 
 #include <ostream>
 
@@ -41,16 +41,29 @@ namespace cb {
   namespace Event {
     class Buffer;
 
-    class Headers : public OrderedDict<std::string> {
+    /**
+     * Headers may be looked up by string literal without constructing a
+     * std::string.  find() returns a reference which is valid until the
+     * header is next changed.
+     */
+    class Headers : public FlatOrderedDict<std::string> {
     public:
-      std::string find(const std::string &key) const;
+      const std::string &find(const std::string &key) const
+        {return valueAt(lookup(key));}
+      template <size_t N>
+      const std::string &find(const char (&key)[N]) const
+        {return valueAt(lookup(key));}
       void set(const std::string &key, const std::string &value)
         {insert(key, value);}
-      void remove(const std::string &key);
+      void set(const std::string &key, std::string &&value)
+        {insert(key, std::move(value));}
+      void remove(const std::string &key) {clearAt(lookup(key));}
+      template <size_t N>
+      void remove(const char (&key)[N]) {clearAt(lookup(key));}
       bool keyContains(const std::string &key, const std::string &value) const;
 
       bool hasContentType() const {return has("Content-Type");}
-      std::string getContentType() const;
+      const std::string &getContentType() const;
       void setContentType(const std::string &contentType);
       void guessContentType(const std::string &ext);
       bool needsClose() const;
@@ -58,6 +71,10 @@ namespace cb {
 
       bool parse(Buffer &buf, unsigned maxSize = 0);
       void write(std::ostream &stream) const;
+
+    protected:
+      const std::string &valueAt(int i) const;
+      void clearAt(int i);
     };
 
 
@@ -0,0 +1,444 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "IOUring.h"
+#include "Base.h"
+#include "Event.h"
+
+#include <cbang/config.h>
+#include <cbang/Exception.h>
+#include <cbang/Catch.h>
+#include <cbang/log/Logger.h>
+#include <cbang/os/SysError.h>
+
+#ifdef HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#endif
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+#ifdef HAVE_IO_URING
+namespace {
+  template <typename T> T loadAcquire(T *ptr) {
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+  }
+
+
+  template <typename T> void storeRelease(T *ptr, T value) {
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+  }
+
+
+  int ioURingEnter(int fd, unsigned submit, unsigned wait, unsigned flags) {
+    return syscall(__NR_io_uring_enter, fd, submit, wait, flags, 0, 0);
+  }
+
+
+  int ioURingRegister(int fd, unsigned op, const void *arg, unsigned count) {
+    return syscall(__NR_io_uring_register, fd, op, arg, count);
+  }
+}
+
+
+struct IOUring::private_t {
+  int fd = -1;
+  int eventFD = -1;
+
+  void *sqRing = MAP_FAILED;
+  size_t sqRingSize = 0;
+  void *cqRing = MAP_FAILED;
+  size_t cqRingSize = 0;
+  struct io_uring_sqe *sqes = (struct io_uring_sqe *)MAP_FAILED;
+  size_t sqesSize = 0;
+
+  unsigned sqEntries = 0;
+  unsigned *sqHead = 0;
+  unsigned *sqTail = 0;
+  unsigned *sqMask = 0;
+  unsigned *sqArray = 0;
+
+  unsigned *cqHead = 0;
+  unsigned *cqTail = 0;
+  unsigned *cqMask = 0;
+  struct io_uring_cqe *cqes = 0;
+
+  unsigned queued = 0;
+  bool scheduled = false;
+  bool buffersRegistered = false;
+
+
+  ~private_t() {
+    if (sqes != MAP_FAILED) munmap(sqes, sqesSize);
+    if (cqRing != MAP_FAILED && cqRing != sqRing) munmap(cqRing, cqRingSize);
+    if (sqRing != MAP_FAILED) munmap(sqRing, sqRingSize);
+    if (eventFD != -1) close(eventFD);
+    if (fd != -1) close(fd);
+  }
+
+
+  void open(unsigned entries) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) THROW("io_uring_setup() failed: " << SysError());
+
+    sqEntries = params.sq_entries;
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize =
+      params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+    bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single && sqRingSize < cqRingSize) sqRingSize = cqRingSize;
+
+    sqRing = mmap(0, sqRingSize, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED) THROW("Failed to map io_uring: " << SysError());
+
+    if (single) cqRing = sqRing;
+    else {
+      cqRing = mmap(0, cqRingSize, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+      if (cqRing == MAP_FAILED)
+        THROW("Failed to map io_uring: " << SysError());
+    }
+
+    sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqes = (struct io_uring_sqe *)
+      mmap(0, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+           fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) THROW("Failed to map io_uring: " << SysError());
+
+    char *sq = (char *)sqRing;
+    sqHead  = (unsigned *)(sq + params.sq_off.head);
+    sqTail  = (unsigned *)(sq + params.sq_off.tail);
+    sqMask  = (unsigned *)(sq + params.sq_off.ring_mask);
+    sqArray = (unsigned *)(sq + params.sq_off.array);
+
+    char *cq = (char *)cqRing;
+    cqHead = (unsigned *)(cq + params.cq_off.head);
+    cqTail = (unsigned *)(cq + params.cq_off.tail);
+    cqMask = (unsigned *)(cq + params.cq_off.ring_mask);
+    cqes   = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+
+    // Signal completions to the event loop
+    eventFD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (eventFD < 0) THROW("Failed to create eventfd: " << SysError());
+
+    if (ioURingRegister(fd, IORING_REGISTER_EVENTFD, &eventFD, 1))
+      THROW("Failed to register io_uring eventfd: " << SysError());
+  }
+
+
+  bool full() const {return sqEntries <= *sqTail - loadAcquire(sqHead);}
+};
+
+
+IOUring::IOUring(Base &base, unsigned entries) : base(base), pri(new private_t) {
+  pri->open(entries);
+
+  submitEvent =
+    base.newEvent(this, &IOUring::submitCB, EF::EVENT_NO_SELF_REF);
+  completeEvent =
+    base.newEvent(pri->eventFD, this, &IOUring::completeCB,
+                  EF::EVENT_READ | EF::EVENT_PERSIST | EF::EVENT_NO_SELF_REF);
+  completeEvent->add();
+}
+
+
+IOUring::~IOUring() {
+  if (!callbacks.empty())
+    LOG_WARNING("Closing io_uring with " << callbacks.size()
+                << " requests pending");
+}
+
+
+bool IOUring::isSupported() {
+  static int supported = -1;
+
+  if (supported == -1) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    int fd = syscall(__NR_io_uring_setup, 1, &params);
+    supported = 0 <= fd;
+    if (0 <= fd) close(fd);
+  }
+
+  return supported;
+}
+
+
+unsigned IOUring::registerBuffer(char *data, unsigned length) {
+  buffers.push_back(buffer_t{data, length});
+  buffersChanged = true;
+  return buffers.size() - 1;
+}
+
+
+void IOUring::unregisterBuffers() {
+  buffers.clear();
+  buffersChanged = true;
+}
+
+
+void IOUring::read(int fd, char *data, unsigned length, uint64_t offset,
+                   callback_t cb) {
+  queue(IORING_OP_READ, fd, (uint64_t)data, length, offset, -1, cb);
+}
+
+
+void IOUring::write(int fd, const char *data, unsigned length,
+                    uint64_t offset, callback_t cb) {
+  queue(IORING_OP_WRITE, fd, (uint64_t)data, length, offset, -1, cb);
+}
+
+
+void IOUring::readFixed(int fd, unsigned buffer, unsigned length,
+                        uint64_t offset, callback_t cb) {
+  if (buffers.size() <= buffer || buffers[buffer].length < length)
+    THROW("Invalid io_uring buffer " << buffer);
+
+  queue(IORING_OP_READ_FIXED, fd, (uint64_t)buffers[buffer].data, length,
+        offset, buffer, cb);
+}
+
+
+void IOUring::writeFixed(int fd, unsigned buffer, unsigned length,
+                         uint64_t offset, callback_t cb) {
+  if (buffers.size() <= buffer || buffers[buffer].length < length)
+    THROW("Invalid io_uring buffer " << buffer);
+
+  queue(IORING_OP_WRITE_FIXED, fd, (uint64_t)buffers[buffer].data, length,
+        offset, buffer, cb);
+}
+
+
+void IOUring::recv(int fd, char *data, unsigned length, callback_t cb) {
+  queue(IORING_OP_RECV, fd, (uint64_t)data, length, 0, -1, cb);
+}
+
+
+void IOUring::send(int fd, const char *data, unsigned length, callback_t cb) {
+  queue(IORING_OP_SEND, fd, (uint64_t)data, length, 0, -1, cb);
+}
+
+
+unsigned IOUring::submit() {
+  pri->scheduled = false;
+  syncBuffers();
+  if (!pri->queued) return 0;
+
+  int ret = ioURingEnter(pri->fd, pri->queued, 0, 0);
+
+  if (ret < 0) {
+    if (errno == EINTR || errno == EAGAIN || errno == EBUSY) return 0;
+    THROW("io_uring_enter() failed: " << SysError());
+  }
+
+  LOG_DEBUG(5, "io_uring submitted " << ret << " of " << pri->queued);
+
+  pri->queued -= ret;
+  return ret;
+}
+
+
+unsigned IOUring::complete() {
+  vector<pair<uint64_t, int> > done;
+
+  unsigned head = *pri->cqHead;
+  unsigned tail = loadAcquire(pri->cqTail);
+
+  for (; head != tail; head++) {
+    struct io_uring_cqe &cqe = pri->cqes[head & *pri->cqMask];
+    done.push_back(make_pair((uint64_t)cqe.user_data, (int)cqe.res));
+  }
+
+  storeRelease(pri->cqHead, head);
+
+  // Callbacks may queue or wait on further requests
+  for (unsigned i = 0; i < done.size(); i++) {
+    auto it = callbacks.find(done[i].first);
+    if (it == callbacks.end()) continue;
+
+    callback_t cb = it->second;
+    callbacks.erase(it);
+
+    try {
+      cb(done[i].second);
+    } CATCH_ERROR;
+  }
+
+  return done.size();
+}
+
+
+void IOUring::wait() {
+  submit();
+
+  while (!callbacks.empty() && !complete())
+    if (ioURingEnter(pri->fd, 0, 1, IORING_ENTER_GETEVENTS) < 0 &&
+        errno != EINTR)
+      THROW("io_uring_enter() failed: " << SysError());
+}
+
+
+void IOUring::queue(uint8_t op, int fd, uint64_t addr, unsigned length,
+                    uint64_t offset, int buffer, callback_t cb) {
+  if (pri->full()) submit();
+  if (pri->full()) THROW("io_uring submission queue full");
+
+  unsigned tail = *pri->sqTail;
+  unsigned index = tail & *pri->sqMask;
+  struct io_uring_sqe &sqe = pri->sqes[index];
+
+  memset(&sqe, 0, sizeof(sqe));
+  sqe.opcode = op;
+  sqe.fd = fd;
+  sqe.addr = addr;
+  sqe.len = length;
+  sqe.off = offset;
+  if (0 <= buffer) sqe.buf_index = buffer;
+  sqe.user_data = nextID;
+
+  callbacks[nextID++] = cb;
+
+  pri->sqArray[index] = index;
+  storeRelease(pri->sqTail, tail + 1);
+  pri->queued++;
+
+  // Submit everything queued during this pass of the event loop at once
+  if (!pri->scheduled) {
+    pri->scheduled = true;
+    submitEvent->activate();
+  }
+}
+
+
+void IOUring::syncBuffers() {
+  if (!buffersChanged) return;
+  buffersChanged = false;
+
+  if (pri->buffersRegistered) {
+    ioURingRegister(pri->fd, IORING_UNREGISTER_BUFFERS, 0, 0);
+    pri->buffersRegistered = false;
+  }
+
+  if (buffers.empty()) return;
+
+  vector<struct iovec> iov(buffers.size());
+  for (unsigned i = 0; i < buffers.size(); i++) {
+    iov[i].iov_base = buffers[i].data;
+    iov[i].iov_len = buffers[i].length;
+  }
+
+  if (ioURingRegister(pri->fd, IORING_REGISTER_BUFFERS, &iov[0], iov.size()))
+    THROW("Failed to register io_uring buffers: " << SysError());
+
+  pri->buffersRegistered = true;
+}
+
+
+void IOUring::submitCB() {submit();}
+
+
+void IOUring::completeCB() {
+  uint64_t count;
+  while (::read(pri->eventFD, &count, sizeof(count)) == sizeof(count))
+    continue;
+
+  complete();
+}
+
+
+#else // HAVE_IO_URING
+struct IOUring::private_t {};
+
+
+IOUring::IOUring(Base &base, unsigned entries) : base(base) {
+  THROW("io_uring not supported");
+}
+
+
+IOUring::~IOUring() {}
+bool IOUring::isSupported() {return false;}
+unsigned IOUring::registerBuffer(char *, unsigned) {THROW("Not supported");}
+void IOUring::unregisterBuffers() {}
+
+
+void IOUring::read(int, char *, unsigned, uint64_t, callback_t) {
+  THROW("Not supported");
+}
+
+
+void IOUring::write(int, const char *, unsigned, uint64_t, callback_t) {
+  THROW("Not supported");
+}
+
+
+void IOUring::readFixed(int, unsigned, unsigned, uint64_t, callback_t) {
+  THROW("Not supported");
+}
+
+
+void IOUring::writeFixed(int, unsigned, unsigned, uint64_t, callback_t) {
+  THROW("Not supported");
+}
+
+
+void IOUring::recv(int, char *, unsigned, callback_t) {THROW("Not supported");}
+
+
+void IOUring::send(int, const char *, unsigned, callback_t) {
+  THROW("Not supported");
+}
+
+
+unsigned IOUring::submit() {return 0;}
+unsigned IOUring::complete() {return 0;}
+void IOUring::wait() {}
+void IOUring::queue(uint8_t, int, uint64_t, unsigned, uint64_t, int,
+                    callback_t) {}
+void IOUring::syncBuffers() {}
+void IOUring::submitCB() {}
+void IOUring::completeCB() {}
+#endif // HAVE_IO_URING
@@ -0,0 +1,125 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+#include <cbang/StdTypes.h>
+
+#include <functional>
+#include <vector>
+#include <map>
+
+
+namespace cb {
+  namespace Event {
+    class Base;
+    class Event;
+
+    /**
+     * Asynchronous file and socket I/O through a Linux io_uring.
+     *
+     * Requests are queued and submitted together, with one system call, on
+     * the next pass of the event loop.  Completions are signaled through an
+     * eventfd watched by the Base, so callbacks run on the event loop
+     * thread just like Event callbacks.  Not thread safe.
+     */
+    class IOUring {
+    public:
+      /// Called with the bytes transferred or a negative errno
+      typedef std::function<void (int result)> callback_t;
+
+    protected:
+      Base &base;
+
+      struct private_t;
+      SmartPointer<private_t> pri;
+
+      SmartPointer<Event> submitEvent;
+      SmartPointer<Event> completeEvent;
+
+      uint64_t nextID = 1;
+      std::map<uint64_t, callback_t> callbacks;
+
+      struct buffer_t {
+        char *data;
+        unsigned length;
+      };
+      std::vector<buffer_t> buffers;
+      bool buffersChanged = false;
+
+    public:
+      IOUring(Base &base, unsigned entries = 256);
+      ~IOUring();
+
+      /// @return True if io_uring is available on this system
+      static bool isSupported();
+
+      /**
+       * Pin @param data for use with readFixed() and writeFixed(), which
+       * avoid mapping the buffer on each request.
+       * @return The buffer index.
+       */
+      unsigned registerBuffer(char *data, unsigned length);
+      void unregisterBuffers();
+
+      void read(int fd, char *data, unsigned length, uint64_t offset,
+                callback_t cb);
+      void write(int fd, const char *data, unsigned length, uint64_t offset,
+                 callback_t cb);
+      void readFixed(int fd, unsigned buffer, unsigned length,
+                     uint64_t offset, callback_t cb);
+      void writeFixed(int fd, unsigned buffer, unsigned length,
+                      uint64_t offset, callback_t cb);
+      void recv(int fd, char *data, unsigned length, callback_t cb);
+      void send(int fd, const char *data, unsigned length, callback_t cb);
+
+      unsigned getPending() const {return callbacks.size();}
+
+      /// Submit all queued requests.  @return The number submitted.
+      unsigned submit();
+
+      /// Run callbacks for finished requests.  @return The number run.
+      unsigned complete();
+
+      /// Block until at least one request finishes then run its callbacks.
+      void wait();
+
+    protected:
+      void queue(uint8_t op, int fd, uint64_t addr, unsigned length,
+                 uint64_t offset, int buffer, callback_t cb);
+      void syncBuffers();
+      void submitCB();
+      void completeCB();
+    };
+  }
+}
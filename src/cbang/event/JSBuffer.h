@@ -0,0 +1,68 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Buffer.h"
+
+#include <cbang/js/Factory.h>
+#include <cbang/js/Value.h>
+
+
+namespace cb {
+  namespace Event {
+    /**
+     * Move the contents of @param buf into a JS ArrayBuffer without copying
+     * its data out of libevent.  @param buf is left empty.  A buffer made
+     * of several chains is coalesced into one, which may copy once.  The
+     * memory is freed when the JS engine collects the ArrayBuffer.
+     */
+    inline SmartPointer<js::Value> toArrayBuffer(js::Factory &factory,
+                                                 Buffer &buf) {
+      Buffer owned;
+      owned.add(buf);
+
+      unsigned length = owned.getLength();
+      char *data = length ? owned.pullup() : 0;
+
+      return factory.createArrayBuffer(data, length, [owned] () {});
+    }
+
+
+    /// Append the contents of JS ArrayBuffer @param value to @param buf
+    inline void fromArrayBuffer(const js::Value &value, Buffer &buf) {
+      unsigned length;
+      const char *data = value.getArrayBufferData(length);
+      buf.add(data, length);
+    }
+  }
+}
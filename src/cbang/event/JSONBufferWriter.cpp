@@ -0,0 +1,105 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "JSONBufferWriter.h"
+
+#include <cbang/Catch.h>
+
+#include <event2/buffer.h>
+
+#include <cstring>
+
+using namespace cb;
+using namespace cb::Event;
+using namespace std;
+
+
+JSONBufferWriter::JSONBufferWriter(const Buffer &buffer, unsigned indentStart,
+                                   bool compact, unsigned indentSpace,
+                                   int precision, unsigned reserveSize) :
+  JSON::Writer(stream, indentStart, compact, indentSpace, precision),
+  buffer(buffer), stream(buffer), reserveSize(reserveSize) {}
+
+
+JSONBufferWriter::~JSONBufferWriter() {TRY_CATCH_ERROR(flush());}
+
+
+void JSONBufferWriter::flush() {
+  if (!start) return;
+
+  iovec space;
+  space.iov_base = start;
+  space.iov_len = ptr - start;
+  buffer.commit(space);
+
+  start = ptr = end = 0;
+}
+
+
+void JSONBufferWriter::close() {
+  JSON::Writer::close();
+  flush();
+}
+
+
+void JSONBufferWriter::reset() {
+  JSON::Writer::reset();
+  flush();
+}
+
+
+void JSONBufferWriter::reserve(size_t n) {
+  flush();
+
+  vector<iovec> space(1);
+  buffer.reserve(reserveSize < n ? n : reserveSize, space);
+
+  start = ptr = (char *)space[0].iov_base;
+  end = start + space[0].iov_len;
+}
+
+
+void JSONBufferWriter::put(const char *s, size_t n) {
+  if ((size_t)(end - ptr) < n) {
+    // Large data is added without copying it twice
+    if (reserveSize < n) {
+      flush();
+      buffer.add(s, n);
+      return;
+    }
+
+    reserve(n);
+  }
+
+  memcpy(ptr, s, n);
+  ptr += n;
+}
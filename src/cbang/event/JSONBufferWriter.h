@@ -0,0 +1,82 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Buffer.h"
+#include "BufferDevice.h"
+
+#include <cbang/json/Writer.h>
+
+
+namespace cb {
+  namespace Event {
+    /**
+     * A JSON::Writer which writes directly into reserved space at the end of
+     * an Event::Buffer.  Strings are escaped in place rather than through
+     * temporary copies.  Output is committed to the Buffer on flush(),
+     * close(), reset() or destruction.  The Buffer must not be otherwise
+     * modified while output is pending.
+     */
+    class JSONBufferWriter : public JSON::Writer {
+      Buffer buffer;
+      BufferStream<> stream;
+
+      unsigned reserveSize;
+      char *start = 0;
+      char *ptr = 0;
+      char *end = 0;
+
+    public:
+      JSONBufferWriter(const Buffer &buffer, unsigned indentStart = 0,
+                       bool compact = false, unsigned indentSpace = 2,
+                       int precision = 6, unsigned reserveSize = 4096);
+      ~JSONBufferWriter();
+
+      const Buffer &getBuffer() const {return buffer;}
+
+      void flush();
+
+      // From JSON::Writer
+      void close();
+      void reset();
+
+    protected:
+      void reserve(size_t n);
+
+      // From JSON::Writer
+      void put(char c) {if (ptr == end) reserve(1); *ptr++ = c;}
+      void put(const char *s, size_t n);
+      using JSON::Writer::put;
+    };
+  }
+}
@@ -35,6 +35,8 @@
 #include <cbang/Catch.h>
 #include <cbang/iostream/VectorDevice.h>
 
+#include <sstream>
+
 
 using namespace cb;
 using namespace cb::Event;
@@ -56,10 +58,52 @@ namespace {
       ws->send(data(), size());
     }
   };
+
+
+  struct CBORWriter :
+    vector<char>, cb::VectorStream<>, public JSON::CBORWriter {
+    SmartPointer<Websocket> ws;
+
+    CBORWriter(const SmartPointer<Websocket> &ws) :
+      cb::VectorStream<>((vector<char> &)*this),
+      JSON::CBORWriter((ostream &)*this), ws(ws) {}
+
+    ~CBORWriter() {TRY_CATCH_ERROR(close(););}
+
+    void close() {
+      JSON::CBORWriter::close();
+      ws->sendBinary(data(), size());
+    }
+  };
 }
 
 
-void JSONWebsocket::send(const JSON::Value &value) {send(value.toString());}
+void JSONWebsocket::send(const JSON::Value &value) {
+  if (batching && isActive()) {
+    if (batchSink.isNull()) {
+      if (isCBOR()) batchSink = new JSON::CBORWriter(batch);
+      else batchSink = new JSON::Writer(batch);
+      batchSink->beginList();
+    }
+
+    batchSink->beginAppend();
+    value.write(*batchSink);
+
+    if (getCoalesceBytes() <= (uint64_t)batch.tellp()) flush();
+    else scheduleFlush();
+    return;
+  }
+
+  if (!isCBOR()) return send(value.toString());
+
+  ostringstream str;
+  JSON::CBORWriter writer(str);
+  value.write(writer);
+  writer.close();
+
+  string s = str.str();
+  sendBinary(s.data(), s.length());
+}
 
 
 SmartPointer<JSON::Writer> JSONWebsocket::getJSONWriter() {
@@ -67,9 +111,44 @@ SmartPointer<JSON::Writer> JSONWebsocket::getJSONWriter() {
 }
 
 
+SmartPointer<JSON::CBORWriter> JSONWebsocket::getCBORWriter() {
+  return new CBORWriter(this);
+}
+
+
+SmartPointer<JSON::NullSink> JSONWebsocket::getSink() {
+  if (isCBOR()) return getCBORWriter();
+  return getJSONWriter();
+}
+
+
+void JSONWebsocket::onFlush() {
+  if (batchSink.isNull()) return;
+
+  batchSink->endList();
+  batchSink->close();
+  batchSink.release();
+
+  string s = batch.str();
+  batch.str("");
+
+  if (isCBOR()) sendBinary(s.data(), s.length());
+  else send(s);
+}
+
+
 void JSONWebsocket::onMessage(const JSON::ValuePtr &msg) {if (cb) cb(msg);}
 
 
+string JSONWebsocket::selectProtocol(const vector<string> &offered) {
+  for (auto &name: offered)
+    if ((name == "cbor" && cborEnabled) || name == "json") return name;
+
+  return "";
+}
+
+
 void JSONWebsocket::onMessage(const char *data, uint64_t length) {
-  onMessage(JSON::Reader::parse(InputSource(data, length)));
+  if (isCBOR()) onMessage(JSON::CBORReader::parse(data, length));
+  else onMessage(JSON::Reader::parse(InputSource(data, length)));
 }
@@ -36,28 +36,57 @@
 
 #include <cbang/json/JSON.h>
 
+#include <sstream>
+
 
 namespace cb {
   namespace Event {
+    /**
+     * Sends and receives JSON messages.  Clients which offer the "cbor"
+     * subprotocol exchange binary CBOR messages instead of text.
+     */
     class JSONWebsocket : public Websocket {
       typedef std::function<void (const JSON::ValuePtr &)> cb_t;
       cb_t cb;
+      bool cborEnabled = true;
+      bool batching = false;
+      std::ostringstream batch;
+      SmartPointer<JSON::NullSink> batchSink;
 
     public:
       using Websocket::Websocket;
 
       void setCallback(const cb_t &cb) {this->cb = cb;}
 
+      bool getCBOREnabled() const {return cborEnabled;}
+      void setCBOREnabled(bool x) {cborEnabled = x;}
+      bool isCBOR() const {return getProtocol() == "cbor";}
+
+      /**
+       * Combine the messages sent before the next flush, see
+       * setCoalescing(), into a single list message.  Receivers must
+       * expect lists of updates.
+       */
+      void setBatching(bool x) {batching = x;}
+      bool isBatching() const {return batching;}
+
       void send(const JSON::Value &msg);
       SmartPointer<JSON::Writer> getJSONWriter();
+      SmartPointer<JSON::CBORWriter> getCBORWriter();
+      /// A CBOR or JSON writer depending on the negotiated subprotocol
+      SmartPointer<JSON::NullSink> getSink();
 
       virtual void onMessage(const JSON::ValuePtr &msg);
 
       // From Websocket
+      std::string selectProtocol(const std::vector<std::string> &offered);
       void onMessage(const char *data, uint64_t length);
 
     protected:
       using Websocket::send;
+
+      // From Websocket
+      void onFlush();
     };
   }
 }
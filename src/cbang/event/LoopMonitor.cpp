@@ -0,0 +1,167 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "LoopMonitor.h"
+#include "Base.h"
+#include "Event.h"
+
+#include <cbang/debug/Debugger.h>
+#include <cbang/log/Logger.h>
+#include <cbang/time/Timer.h>
+#include <cbang/util/Histogram.h>
+
+#include <algorithm>
+
+#include <signal.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+Debugger *LoopMonitor::debugger = 0;
+atomic<LoopMonitor *> LoopMonitor::capturing(0);
+
+#ifdef _WIN32
+int LoopMonitor::stackSignal = 0;
+#else
+int LoopMonitor::stackSignal = SIGURG;
+#endif
+
+
+LoopMonitor::LoopMonitor(Base &base, double interval, double threshold) :
+  base(base), interval(interval), threshold(threshold),
+  event(base.newEvent(this, &LoopMonitor::tick,
+                      EF::EVENT_PERSIST | EF::EVENT_NO_SELF_REF)),
+  lag(new Histogram), heartbeat(0), loopThread(0), stalls(0),
+  frameCount(0) {
+  setName("LoopMonitor");
+  event->add(interval);
+
+#ifndef _WIN32
+  if (!debugger) {
+    // Load the unwinder now, it may allocate on first use
+    debugger = &Debugger::instance();
+    debugger->captureStackTrace(frames, StackTrace::maxAddrs);
+
+    struct sigaction action = {};
+    action.sa_handler = &LoopMonitor::signalHandler;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(stackSignal, &action, 0);
+  }
+#endif
+}
+
+
+LoopMonitor::~LoopMonitor() {
+  join();
+  event->del();
+}
+
+
+void LoopMonitor::tick() {
+  double now = Timer::monotonic();
+  if (expected) lag->record(max(0.0, now - expected) * 1e6);
+  expected = now + interval;
+
+  loopThread = Thread::self();
+  heartbeat.store(Timer::monotonicNS(), memory_order_release);
+}
+
+
+void LoopMonitor::report(double seconds) {
+  StackTrace trace;
+  bool captured = captureStack(trace);
+
+  LOG_WARNING("Event loop stalled for " << seconds << " seconds"
+              << (captured ? ", loop thread stack:\n" : "") << trace);
+}
+
+
+bool LoopMonitor::captureStack(StackTrace &trace) {
+#ifdef _WIN32
+  return false;
+
+#else
+  if (!debugger || !loopThread) return false;
+
+  LoopMonitor *expected = 0;
+  if (!capturing.compare_exchange_strong(expected, this)) return false;
+
+  frameCount = -1;
+  pthread_kill((pthread_t)loopThread.load(), stackSignal);
+
+  // Wait up to a second for the signal handler
+  for (unsigned i = 0; i < 100 && frameCount < 0; i++) Timer::sleep(0.01);
+
+  int count = frameCount.exchange(0);
+  capturing = 0;
+
+  return 0 < count && debugger->resolveStackTrace(frames, count, trace);
+#endif
+}
+
+
+void LoopMonitor::signalHandler(int sig) {
+  LoopMonitor *monitor = capturing.load();
+  if (!monitor || monitor->frameCount != -1) return;
+
+  monitor->frameCount =
+    debugger->captureStackTrace(monitor->frames, StackTrace::maxAddrs);
+}
+
+
+void LoopMonitor::run() {
+  bool stalled = false;
+
+  while (!shouldShutdown()) {
+    Timer::sleep(interval);
+
+    uint64_t last = heartbeat.load(memory_order_acquire);
+    if (!last) continue; // Loop not yet running
+
+    double idle = (Timer::monotonicNS() - last) * 1e-9;
+
+    if (idle < threshold) stalled = false;
+    else if (!stalled) {
+      stalled = true;
+      stalls++;
+      report(idle);
+    }
+  }
+}
@@ -0,0 +1,112 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+#include <cbang/os/Thread.h>
+#include <cbang/debug/StackTrace.h>
+
+#include <atomic>
+
+
+namespace cb {
+  class Histogram;
+  class Debugger;
+
+  namespace Event {
+    class Base;
+    class Event;
+
+    /**
+     * Measures event loop lag as the drift of a periodic timer and records
+     * it, in microseconds, to a Histogram which may be exported with
+     * MetricRegistry::addHistogram().
+     *
+     * A watchdog thread checks the timer's heartbeat.  When the loop has
+     * not run for longer than the stall threshold the loop thread's stack
+     * is captured, by sending it stackSignal, and logged while the loop is
+     * still stuck.  Each stall is reported once.  The handler is installed
+     * with SA_RESTART but calls such as sleeps may still return early.
+     * Stack capture is not supported on Windows.
+     *
+     * The watchdog must be started with start() and should be stopped
+     * before the loop stops running, otherwise the idle loop is reported
+     * as stalled.
+     */
+    class LoopMonitor : public Thread {
+      Base &base;
+      double interval;
+      double threshold;
+
+      SmartPointer<Event> event;
+      SmartPointer<Histogram> lag;
+      double expected = 0;
+
+      std::atomic<uint64_t> heartbeat;
+      std::atomic<uint64_t> loopThread;
+      std::atomic<uint64_t> stalls;
+
+      void *frames[StackTrace::maxAddrs];
+      std::atomic<int> frameCount;
+
+      static Debugger *debugger;
+      static std::atomic<LoopMonitor *> capturing;
+
+    public:
+      /// Sent to the loop thread to capture its stack, SIGURG by default
+      static int stackSignal;
+
+      /**
+       * @param interval seconds between loop timer ticks
+       * @param threshold seconds without a tick before a stall is reported
+       */
+      LoopMonitor(Base &base, double interval = 0.1, double threshold = 1);
+      ~LoopMonitor();
+
+      double getInterval() const {return interval;}
+      double getThreshold() const {return threshold;}
+      const SmartPointer<Histogram> &getLagHistogram() const {return lag;}
+      uint64_t getStallCount() const {return stalls;}
+
+    protected:
+      void tick();
+      void report(double seconds);
+      bool captureStack(StackTrace &trace);
+      static void signalHandler(int sig);
+
+      // From Thread
+      void run();
+    };
+  }
+}
@@ -0,0 +1,150 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "MetricsHandler.h"
+#include "Request.h"
+#include "HTTP.h"
+#include "ConcurrentPool.h"
+#include "BufferEvent.h"
+
+#include <cbang/config.h>
+#include <cbang/log/Logger.h>
+#include <cbang/openssl/SSLContext.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+MetricsHandler::MetricsHandler(const SmartPointer<MetricRegistry> &registry) :
+  registry(registry) {
+  if (registry.isNull()) THROW("Registry cannot be NULL");
+}
+
+
+void MetricsHandler::addHTTP(MetricRegistry &registry,
+                             const SmartPointer<HTTP> &http,
+                             const labels_t &labels) {
+  registry.addCallback
+    (MetricRegistry::METRIC_GAUGE, "cbang_http_connections",
+     "Open HTTP connections",
+     [http] () {return (double)http->getConnectionCount();}, labels);
+
+  registry.addCallback
+    (MetricRegistry::METRIC_GAUGE, "cbang_http_max_connections",
+     "HTTP connection limit",
+     [http] () {return (double)http->getMaxConnections();}, labels);
+}
+
+
+void MetricsHandler::addConcurrentPool(MetricRegistry &registry,
+                                       const ConcurrentPool &pool,
+                                       const labels_t &labels) {
+  const ConcurrentPool *p = &pool;
+
+  registry.addCallback
+    (MetricRegistry::METRIC_GAUGE, "cbang_pool_ready_tasks",
+     "Tasks waiting to run in a ConcurrentPool",
+     [p] () {return (double)p->getNumReady();}, labels);
+
+  registry.addCallback
+    (MetricRegistry::METRIC_GAUGE, "cbang_pool_active_tasks",
+     "Tasks running in a ConcurrentPool",
+     [p] () {return (double)p->getNumActive();}, labels);
+
+  registry.addCallback
+    (MetricRegistry::METRIC_GAUGE, "cbang_pool_completed_tasks",
+     "Completed tasks waiting for delivery to the event loop",
+     [p] () {return (double)p->getNumCompleted();}, labels);
+}
+
+
+void MetricsHandler::addLogger(MetricRegistry &registry) {
+  registry.addCallback
+    (MetricRegistry::METRIC_COUNTER, "cbang_log_errors_total",
+     "Error messages logged",
+     [] () {return (double)Logger::instance().getErrorCount();});
+
+  registry.addCallback
+    (MetricRegistry::METRIC_COUNTER, "cbang_log_warnings_total",
+     "Warning messages logged",
+     [] () {return (double)Logger::instance().getWarningCount();});
+}
+
+
+void MetricsHandler::addSSL(MetricRegistry &registry) {
+  registry.addCallback
+    (MetricRegistry::METRIC_COUNTER, "cbang_ssl_handshakes_total",
+     "SSL handshakes completed",
+     [] () {return (double)BufferEvent::getSSLHandshakeCount();});
+}
+
+
+void MetricsHandler::addSSLContext(MetricRegistry &registry,
+                                   const SmartPointer<SSLContext> &ctx,
+                                   const labels_t &labels) {
+#ifdef HAVE_OPENSSL
+  registry.addCallback
+    (MetricRegistry::METRIC_GAUGE, "cbang_ssl_sessions",
+     "TLS sessions in the server cache",
+     [ctx] () {return (double)ctx->getSessionCount();}, labels);
+
+  registry.addCallback
+    (MetricRegistry::METRIC_COUNTER, "cbang_ssl_session_hits_total",
+     "TLS sessions resumed from the cache or a ticket",
+     [ctx] () {return (double)ctx->getSessionHits();}, labels);
+
+  registry.addCallback
+    (MetricRegistry::METRIC_COUNTER, "cbang_ssl_session_misses_total",
+     "TLS session resumptions requested but not found",
+     [ctx] () {return (double)ctx->getSessionMisses();}, labels);
+
+  registry.addCallback
+    (MetricRegistry::METRIC_COUNTER, "cbang_ssl_session_timeouts_total",
+     "TLS session resumptions rejected because the session expired",
+     [ctx] () {return (double)ctx->getSessionTimeouts();}, labels);
+#endif // HAVE_OPENSSL
+}
+
+
+bool MetricsHandler::operator()(Request &req) {
+  // Reuse the buffer so scrapes do not reallocate it
+  static thread_local string buffer;
+
+  buffer.clear();
+  registry->render(buffer);
+
+  req.setContentType("text/plain; version=0.0.4; charset=utf-8");
+  req.reply(HTTP_OK, buffer.data(), buffer.size());
+
+  return true;
+}
@@ -0,0 +1,81 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "HTTPRequestHandler.h"
+
+#include <cbang/SmartPointer.h>
+#include <cbang/util/MetricRegistry.h>
+
+
+namespace cb {
+  class SSLContext;
+
+  namespace Event {
+    class HTTP;
+    class ConcurrentPool;
+
+    /// Serves a MetricRegistry in the Prometheus text exposition format
+    class MetricsHandler : public HTTPRequestHandler {
+      SmartPointer<MetricRegistry> registry;
+
+    public:
+      typedef MetricRegistry::labels_t labels_t;
+
+      MetricsHandler(const SmartPointer<MetricRegistry> &registry);
+
+      const SmartPointer<MetricRegistry> &getRegistry() const
+        {return registry;}
+
+      /// Export connection counts of @param http
+      static void addHTTP(MetricRegistry &registry,
+                          const SmartPointer<HTTP> &http,
+                          const labels_t &labels = labels_t());
+      /// Export queue depths.  @param pool must outlive @param registry.
+      static void addConcurrentPool(MetricRegistry &registry,
+                                    const ConcurrentPool &pool,
+                                    const labels_t &labels = labels_t());
+      /// Export Logger error and warning counts
+      static void addLogger(MetricRegistry &registry);
+      /// Export the number of SSL handshakes completed
+      static void addSSL(MetricRegistry &registry);
+      /// Export TLS session cache size and resumption counts of @param ctx
+      static void addSSLContext(MetricRegistry &registry,
+                                const SmartPointer<SSLContext> &ctx,
+                                const labels_t &labels = labels_t());
+
+      // From HTTPRequestHandler
+      bool operator()(Request &req);
+    };
+  }
+}
@@ -0,0 +1,253 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "MultipartParser.h"
+#include "HTTPError.h"
+
+#include <cbang/String.h>
+
+#include <event2/buffer.h>
+
+#include <cstring>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+MultipartParser::MultipartParser(const string &boundary) :
+  delimiter("\r\n--" + boundary) {
+  if (boundary.empty() || 70 < boundary.length())
+    THROW_HTTP("Invalid multipart boundary '" << boundary << "'",
+               HTTPStatus::HTTP_BAD_REQUEST);
+
+  // Horspool shift table
+  const unsigned m = delimiter.length();
+  for (unsigned i = 0; i < 256; i++) skip[i] = m;
+  for (unsigned i = 0; i < m - 1; i++)
+    skip[(uint8_t)delimiter[i]] = m - 1 - i;
+
+  // The first boundary need not follow a line break
+  pending.add("\r\n");
+}
+
+
+string MultipartParser::getBoundary(const string &contentType) {
+  if (!String::startsWith(String::toLower(contentType), "multipart/"))
+    return "";
+
+  return getParameter(contentType, "boundary");
+}
+
+
+string MultipartParser::getParameter(const string &value, const string &name) {
+  string::size_type i = value.find(';');
+
+  while (i < value.length()) {
+    // Name
+    i = value.find_first_not_of(" \t;", i);
+    if (i == string::npos) break;
+    string::size_type end = value.find_first_of("=;", i);
+    string key = String::toLower(String::trim(value.substr(i, end - i)));
+    if (end == string::npos || value[end] == ';') {i = end; continue;}
+
+    // Value
+    i = value.find_first_not_of(" \t", end + 1);
+    if (i == string::npos) break;
+    string result;
+
+    if (value[i] == '"') {
+      for (i++; i < value.length() && value[i] != '"'; i++) {
+        if (value[i] == '\\' && i + 1 < value.length()) i++;
+        result += value[i];
+      }
+      i++;
+
+    } else {
+      end = value.find(';', i);
+      result = String::trim(value.substr(i, end - i));
+      i = end;
+    }
+
+    if (key == name) return result;
+  }
+
+  return "";
+}
+
+
+void MultipartParser::parse(Buffer &buf) {
+  if (state == STATE_DONE) return buf.clear(); // Epilogue
+
+  pending.add(buf);
+
+  while (true)
+    switch (state) {
+    case STATE_PREAMBLE: case STATE_DATA: if (!parseData()) return; break;
+    case STATE_DELIMITER: if (!parseDelimiterEnd()) return; break;
+    case STATE_HEADERS: if (!parseHeaders()) return; break;
+    case STATE_DONE: return pending.clear();
+    }
+}
+
+
+void MultipartParser::finish() {
+  if (state != STATE_DONE)
+    THROW_HTTP("Incomplete multipart body",
+               HTTPStatus::HTTP_BAD_REQUEST);
+}
+
+
+int64_t MultipartParser::find(const vector<iovec> &space,
+                              uint64_t length) const {
+  const unsigned m = delimiter.length();
+  const uint8_t *pat = (const uint8_t *)delimiter.data();
+  if (length < m) return -1;
+
+  vector<uint64_t> offsets(space.size() + 1, 0);
+  for (unsigned i = 0; i < space.size(); i++)
+    offsets[i + 1] = offsets[i] + space[i].iov_len;
+
+  unsigned s = 0;
+  auto at = [&] (uint64_t pos) {
+    while (offsets[s + 1] <= pos) s++;
+    while (pos < offsets[s]) s--;
+    return ((const uint8_t *)space[s].iov_base)[pos - offsets[s]];
+  };
+
+  for (uint64_t pos = 0; pos + m <= length; ) {
+    uint8_t last = at(pos + m - 1);
+
+    if (last == pat[m - 1]) {
+      if (offsets[s] <= pos) {
+        // The window is in one chain
+        const uint8_t *window =
+          (const uint8_t *)space[s].iov_base + (pos - offsets[s]);
+        if (!memcmp(window, pat, m - 1)) return pos;
+
+      } else {
+        unsigned j = m - 1;
+        while (j && at(pos + j - 1) == pat[j - 1]) j--;
+        if (!j) return pos;
+        at(pos + m - 1); // Back to the window's last chain
+      }
+    }
+
+    pos += skip[last];
+  }
+
+  return -1;
+}
+
+
+void MultipartParser::emit(const vector<iovec> &space, uint64_t length) {
+  if (state == STATE_DATA)
+    for (unsigned i = 0; i < space.size() && length; i++) {
+      unsigned n = min<uint64_t>(space[i].iov_len, length);
+      part.size += n;
+      length -= n;
+      onPartData(part, (const char *)space[i].iov_base, n);
+    }
+}
+
+
+bool MultipartParser::parseDelimiterEnd() {
+  if (pending.getLength() < 2) return false;
+
+  char c[2];
+  pending.copy(c, 2);
+
+  if (c[0] == '-' && c[1] == '-') {
+    state = STATE_DONE;
+    return true;
+  }
+
+  if (c[0] == '\r' && c[1] == '\n') {
+    pending.drain(2);
+    part = Part();
+    state = STATE_HEADERS;
+    return true;
+  }
+
+  // Transport padding
+  if (c[0] == ' ' || c[0] == '\t') {
+    pending.drain(1);
+    return true;
+  }
+
+  THROW_HTTP("Invalid multipart delimiter",
+             HTTPStatus::HTTP_BAD_REQUEST);
+}
+
+
+bool MultipartParser::parseHeaders() {
+  if (!headerParser.parse(pending, part.headers, maxHeaderSize)) return false;
+
+  string disposition = part.headers.find("Content-Disposition");
+  part.name = getParameter(disposition, "name");
+  part.filename = getParameter(disposition, "filename");
+  part.contentType = part.headers.find("Content-Type");
+
+  partCount++;
+  state = STATE_DATA;
+  onPartBegin(part);
+
+  return true;
+}
+
+
+bool MultipartParser::parseData() {
+  vector<iovec> space;
+  pending.peek(space);
+  uint64_t length = pending.getLength();
+  int64_t pos = find(space, length);
+
+  if (pos < 0) {
+    // Hold back what may be the start of a delimiter
+    uint64_t keep = delimiter.length() - 1;
+
+    if (keep < length) {
+      emit(space, length - keep);
+      pending.drain(length - keep);
+    }
+
+    return false;
+  }
+
+  emit(space, pos);
+  pending.drain(pos + delimiter.length());
+  if (state == STATE_DATA) onPartEnd(part);
+  state = STATE_DELIMITER;
+
+  return true;
+}
@@ -0,0 +1,123 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "Buffer.h"
+#include "Headers.h"
+#include "HeaderParser.h"
+
+#include <string>
+#include <vector>
+
+
+namespace cb {
+  namespace Event {
+    /**
+     * Incremental multipart/form-data parser.  Body data is passed to
+     * parse() as it arrives, for example from Request::onBodyData(), and
+     * each part is reported through onPartBegin(), any number of
+     * onPartData() calls and onPartEnd().  Part data is passed straight
+     * from the buffer's chains.
+     *
+     * The boundary is found with a Boyer-Moore-Horspool search over the
+     * chains so the body is never pulled up into one block.
+     */
+    class MultipartParser {
+    public:
+      struct Part {
+        Headers headers;
+        std::string name;
+        std::string filename;
+        std::string contentType;
+        uint64_t size = 0;
+
+        bool isFile() const {return !filename.empty();}
+      };
+
+    protected:
+      enum state_t {
+        STATE_PREAMBLE,
+        STATE_DELIMITER,
+        STATE_HEADERS,
+        STATE_DATA,
+        STATE_DONE,
+      };
+
+      std::string delimiter;
+      unsigned skip[256];
+      unsigned maxHeaderSize = 16 * 1024;
+
+      state_t state = STATE_PREAMBLE;
+      Buffer pending;
+      HeaderParser headerParser;
+      Part part;
+      unsigned partCount = 0;
+
+    public:
+      MultipartParser(const std::string &boundary);
+      virtual ~MultipartParser() {}
+
+      /// @return the boundary parameter of @param contentType or ""
+      static std::string getBoundary(const std::string &contentType);
+      /// @return parameter @param name of a header value such as
+      /// Content-Disposition or ""
+      static std::string getParameter(const std::string &value,
+                                      const std::string &name);
+
+      unsigned getMaxHeaderSize() const {return maxHeaderSize;}
+      void setMaxHeaderSize(unsigned size) {maxHeaderSize = size;}
+
+      bool isDone() const {return state == STATE_DONE;}
+      unsigned getPartCount() const {return partCount;}
+
+      /// Consumes @param buf.  Throws on malformed input.
+      void parse(Buffer &buf);
+      /// Throws if the closing boundary has not been seen
+      void finish();
+
+    protected:
+      virtual void onPartBegin(const Part &part) {}
+      virtual void onPartData(const Part &part, const char *data,
+                              unsigned length) {}
+      virtual void onPartEnd(const Part &part) {}
+
+      /// @return the offset of the delimiter in pending or -1
+      int64_t find(const std::vector<iovec> &space, uint64_t length) const;
+      void emit(const std::vector<iovec> &space, uint64_t length);
+      bool parseDelimiterEnd();
+      bool parseHeaders();
+      bool parseData();
+    };
+  }
+}
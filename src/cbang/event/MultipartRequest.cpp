@@ -0,0 +1,96 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "MultipartRequest.h"
+
+#include <cbang/String.h>
+#include <cbang/log/Logger.h>
+
+#include <cstdlib>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+MultipartRequest::MultipartRequest(RequestMethod method, const URI &uri,
+                                   const Version &version, const string &dir) :
+  Request(method, uri, version), dir(dir) {
+
+  if (this->dir.empty()) {
+    const char *tmp = getenv("TMPDIR");
+    this->dir = tmp && *tmp ? tmp : "/tmp";
+  }
+}
+
+
+void MultipartRequest::onHeaders() {
+  if (!mayHaveBody() || writer.isSet()) return;
+
+  string type = inFind("Content-Type");
+  if (!String::startsWith(String::toLower(type), "multipart/form-data"))
+    return;
+
+  string boundary = MultipartParser::getBoundary(type);
+  if (boundary.empty()) return; // Rejected by the handler
+
+  writer = createWriter(boundary);
+  setBodyStreaming(true);
+}
+
+
+void MultipartRequest::onBodyData(Buffer &buf) {writer->parse(buf);}
+
+
+void MultipartRequest::onRequest() {
+  if (writer.isSet())
+    try {
+      writer->finish();
+
+      auto &fields = writer->getFields();
+      for (auto it = fields.begin(); it != fields.end(); it++)
+        insertArg(it->first, it->second);
+
+    } catch (const Exception &e) {
+      LOG_ERROR(e.getMessages());
+      return sendError(e);
+    }
+
+  Request::onRequest();
+}
+
+
+SmartPointer<MultipartWriter>
+MultipartRequest::createWriter(const string &boundary) {
+  return new MultipartWriter(boundary, dir);
+}
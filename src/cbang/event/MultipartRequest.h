@@ -0,0 +1,77 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "Request.h"
+#include "MultipartWriter.h"
+
+#include <cbang/SmartPointer.h>
+
+#include <string>
+
+
+namespace cb {
+  namespace Event {
+    /**
+     * A Request which parses multipart/form-data bodies as they arrive.
+     * Return it from HTTPHandler::createRequest().  File parts are handled
+     * by the MultipartWriter from createWriter() and the other parts are
+     * added to the request's arguments.  Other bodies are buffered as
+     * usual.
+     */
+    class MultipartRequest : public Request {
+      std::string dir;
+      SmartPointer<MultipartWriter> writer;
+
+    public:
+      MultipartRequest(RequestMethod method, const URI &uri,
+                       const Version &version, const std::string &dir = "");
+
+      const std::string &getDirectory() const {return dir;}
+
+      bool isMultipart() const {return writer.isSet();}
+      const SmartPointer<MultipartWriter> &getWriter() const {return writer;}
+
+      // From Request
+      void onHeaders();
+      void onBodyData(Buffer &buf);
+      void onRequest();
+
+    protected:
+      /// Override to, for example, set a TarFileWriter
+      virtual SmartPointer<MultipartWriter>
+      createWriter(const std::string &boundary);
+    };
+  }
+}
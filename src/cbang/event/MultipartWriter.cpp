@@ -0,0 +1,125 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "MultipartWriter.h"
+#include "HTTPError.h"
+
+#include <cbang/String.h>
+#include <cbang/Catch.h>
+#include <cbang/log/Logger.h>
+#include <cbang/os/SystemUtilities.h>
+#include <cbang/tar/TarFileWriter.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+MultipartWriter::MultipartWriter(const string &boundary, const string &dir) :
+  MultipartParser(boundary), dir(dir) {}
+
+
+MultipartWriter::~MultipartWriter() {
+  stream.release();
+  if (!tmpDir.empty()) TRY_CATCH_ERROR(SystemUtilities::rmtree(tmpDir));
+}
+
+
+string MultipartWriter::getSafeName(const string &filename, unsigned index) {
+  // Browsers on Windows may send the full path
+  string name = filename.substr(filename.find_last_of("/\\") + 1);
+  if (name.empty() || name == "." || name == "..")
+    name = "file-" + String(index);
+
+  return name;
+}
+
+
+void MultipartWriter::onPartBegin(const Part &part) {
+  if (!part.isFile()) {
+    field.clear();
+    return;
+  }
+
+  if (tmpDir.empty()) tmpDir = SystemUtilities::createTempDir(dir);
+
+  File file;
+  file.name = part.name;
+  file.filename = part.filename;
+  file.contentType = part.contentType;
+  file.path = tmpDir + "/part-" + String(getPartCount());
+
+  stream = SystemUtilities::oopen(file.path);
+  files.push_back(file);
+}
+
+
+void MultipartWriter::onPartData(const Part &part, const char *data,
+                                 unsigned length) {
+  if (!part.isFile()) {
+    if (maxFieldSize < field.length() + length)
+      THROW_HTTP("Form field '" << part.name << "' too large",
+                 HTTPStatus::HTTP_REQUEST_ENTITY_TOO_LARGE);
+
+    field.append(data, length);
+    return;
+  }
+
+  stream->write(data, length);
+  if (stream->fail()) THROW("Failed to write '" << files.back().path << "'");
+}
+
+
+void MultipartWriter::onPartEnd(const Part &part) {
+  if (!part.isFile()) {
+    fields[part.name] = field;
+    field.clear();
+    return;
+  }
+
+  File &file = files.back();
+  file.size = part.size;
+
+  stream->flush();
+  if (stream->fail()) THROW("Failed to write '" << file.path << "'");
+  stream.release();
+
+  if (tar.isSet()) {
+    tar->add(file.path, getSafeName(file.filename, files.size()), 0644);
+    SystemUtilities::unlink(file.path);
+    file.path.clear();
+  }
+
+  LOG_DEBUG(4, "Received file '" << file.filename << "' " << file.size
+            << " bytes");
+}
@@ -0,0 +1,109 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "MultipartParser.h"
+
+#include <cbang/SmartPointer.h>
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include <map>
+
+
+namespace cb {
+  class TarFileWriter;
+
+  namespace Event {
+    /**
+     * Writes the file parts of a multipart/form-data body to disk as they
+     * arrive and collects the other parts as form fields.  Files are
+     * written to a new temporary directory under @param dir which is
+     * removed, along with any files not moved out of it, on destruction.
+     *
+     * With a TarFileWriter set, each file is instead added to the archive,
+     * named after the client's file name, when the part ends.  Tar headers
+     * record the size so the part is still spooled to disk first.
+     */
+    class MultipartWriter : public MultipartParser {
+    public:
+      struct File {
+        std::string name;
+        std::string filename;
+        std::string contentType;
+        std::string path; ///< Empty when added to a tar file
+        uint64_t size = 0;
+      };
+
+      typedef std::map<std::string, std::string> fields_t;
+
+    protected:
+      std::string dir;
+      std::string tmpDir;
+      SmartPointer<TarFileWriter> tar;
+      unsigned maxFieldSize = 64 * 1024;
+
+      std::vector<File> files;
+      fields_t fields;
+      SmartPointer<std::ostream> stream;
+      std::string field;
+
+    public:
+      MultipartWriter(const std::string &boundary, const std::string &dir);
+      ~MultipartWriter();
+
+      const SmartPointer<TarFileWriter> &getTarFile() const {return tar;}
+      void setTarFile(const SmartPointer<TarFileWriter> &tar)
+        {this->tar = tar;}
+
+      unsigned getMaxFieldSize() const {return maxFieldSize;}
+      void setMaxFieldSize(unsigned size) {maxFieldSize = size;}
+
+      const std::vector<File> &getFiles() const {return files;}
+      const fields_t &getFields() const {return fields;}
+
+      /// @return the base name of the client's @param filename or a
+      /// generated one if it has none
+      static std::string getSafeName(const std::string &filename,
+                                     unsigned index);
+
+    protected:
+      // From MultipartParser
+      void onPartBegin(const Part &part);
+      void onPartData(const Part &part, const char *data, unsigned length);
+      void onPartEnd(const Part &part);
+    };
+  }
+}
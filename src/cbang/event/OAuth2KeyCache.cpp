@@ -0,0 +1,264 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "OAuth2KeyCache.h"
+
+#ifdef HAVE_OPENSSL
+#include "Client.h"
+#include "Request.h"
+#include "OutgoingRequest.h"
+#include "Event.h"
+#include "Base.h"
+
+#include <cbang/Catch.h>
+#include <cbang/String.h>
+#include <cbang/json/JSON.h>
+#include <cbang/openssl/JWKS.h>
+#include <cbang/time/Time.h>
+#include <cbang/time/Timer.h>
+#include <cbang/log/Logger.h>
+
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+OAuth2KeyCache::OAuth2KeyCache(Client &client) : client(client) {}
+
+
+OAuth2KeyCache::~OAuth2KeyCache() {
+  for (auto it = providers.begin(); it != providers.end(); it++) {
+    Provider &p = *it->second;
+    if (p.discovery.refreshEvent.isSet()) p.discovery.refreshEvent->del();
+    if (p.jwks.refreshEvent.isSet()) p.jwks.refreshEvent->del();
+  }
+}
+
+
+void OAuth2KeyCache::add(const string &discoveryURL) {
+  if (find(discoveryURL)) return;
+
+  SmartPointer<Provider> p = new Provider;
+  p->discovery.url = discoveryURL;
+  providers[discoveryURL] = p;
+
+  fetch(*p, p->discovery);
+}
+
+
+bool OAuth2KeyCache::isReady(const string &discoveryURL) const {
+  Provider *p = find(discoveryURL);
+  return p && p->keys.isSet() && p->discovery.value.isSet();
+}
+
+
+SmartPointer<JSON::Value>
+OAuth2KeyCache::getDiscovery(const string &discoveryURL) const {
+  Provider *p = find(discoveryURL);
+  return p ? p->discovery.value : 0;
+}
+
+
+SmartPointer<JWKS> OAuth2KeyCache::getKeys(const string &discoveryURL) const {
+  Provider *p = find(discoveryURL);
+  return p ? p->keys : 0;
+}
+
+
+SmartPointer<JSON::Value>
+OAuth2KeyCache::verify(const string &discoveryURL, const string &jwt,
+                       const string &audience) {
+  Provider *p = find(discoveryURL);
+  if (!p || p->keys.isNull() || p->discovery.value.isNull())
+    THROW("OAuth2 keys for " << discoveryURL << " not loaded");
+
+  // Providers rotate keys, an unknown key ID may be a new one
+  string kid = JWKS::getHeader(jwt)->getString("kid", "");
+  if (!kid.empty() && !p->keys->has(kid) &&
+      p->jwks.lastFetch + minTTL < Timer::now()) {
+    LOG_INFO(3, "Unknown key ID '" << kid << "', refreshing "
+             << p->jwks.url);
+    fetch(*p, p->jwks);
+  }
+
+  SmartPointer<JSON::Value> claims = p->keys->verify(jwt);
+
+  // Issuer, some providers omit the scheme
+  string issuer = p->discovery.value->getString("issuer", "");
+  string iss = claims->getString("iss", "");
+  if (!issuer.empty() && iss != issuer && "https://" + iss != issuer)
+    THROW("JWT issuer '" << iss << "' does not match '" << issuer << "'");
+
+  // Audience
+  if (!audience.empty()) {
+    bool found = false;
+    SmartPointer<JSON::Value> aud = claims->get("aud", 0);
+
+    if (aud.isSet() && aud->isString()) found = aud->getString() == audience;
+    else if (aud.isSet() && aud->isList())
+      for (unsigned i = 0; i < aud->size() && !found; i++)
+        found = aud->get(i)->isString() &&
+          aud->get(i)->getString() == audience;
+
+    if (!found) THROW("JWT audience does not include '" << audience << "'");
+  }
+
+  return claims;
+}
+
+
+unsigned OAuth2KeyCache::getTTL(const Request &req) const {
+  double ttl = defaultTTL;
+  bool maxAge = false;
+
+  vector<string> directives;
+  String::tokenize(String::toLower(req.inFind("Cache-Control")), directives,
+                   ", ");
+
+  for (unsigned i = 0; i < directives.size(); i++) {
+    const string &d = directives[i];
+    size_t eq = d.find('=');
+    string name = d.substr(0, eq);
+
+    try {
+      if (name == "no-store" || name == "no-cache") return minTTL;
+      if (name == "max-age" && eq != string::npos) {
+        ttl = String::parseDouble(String::trim(d.substr(eq + 1), "\""));
+        maxAge = true;
+      }
+    } catch (const Exception &e) {}
+  }
+
+  try {
+    string age = req.inFind("Age");
+    if (maxAge && !age.empty()) ttl -= String::parseDouble(age);
+
+    string expires = req.inFind("Expires");
+    if (!maxAge && !expires.empty())
+      ttl = (double)Time::parse(expires, Time::httpFormat) - Time::now();
+  } catch (const Exception &e) {}
+
+  return (unsigned)max((double)minTTL, min((double)maxTTL, ttl));
+}
+
+
+OAuth2KeyCache::Provider *
+OAuth2KeyCache::find(const string &discoveryURL) const {
+  auto it = providers.find(discoveryURL);
+  return it == providers.end() ? 0 : it->second.get();
+}
+
+
+void OAuth2KeyCache::fetch(Provider &p, Document &doc) {
+  if (doc.pending) return;
+  doc.pending = true;
+  doc.lastFetch = Timer::now();
+
+  auto cb = [this, &p, &doc] (Request &req) {response(p, doc, req);};
+
+  SmartPointer<OutgoingRequest> req = client.call(doc.url, HTTP_GET, cb);
+  req->outSet("Accept", "application/json");
+  if (!doc.etag.empty() && doc.value.isSet())
+    req->outSet("If-None-Match", doc.etag);
+  req->send();
+}
+
+
+void OAuth2KeyCache::response(Provider &p, Document &doc, Request &req) {
+  doc.pending = false;
+  unsigned delay = retryTTL;
+
+  try {
+    HTTPStatus code = req.getResponseCode();
+
+    if (code == HTTP_NOT_MODIFIED && doc.value.isSet()) {
+      LOG_DEBUG(4, doc.url << " not modified");
+      delay = getTTL(req);
+
+    } else if (req.isOk()) {
+      // Parse a copy, leaving the input intact
+      SmartPointer<JSON::Value> value =
+        JSON::Reader::parseString(req.getInput());
+      delay = getTTL(req);
+
+      doc.value = value;
+      doc.etag = req.inFind("ETag");
+      updated(p, doc);
+
+    } else THROW("HTTP " << code);
+
+  } catch (const Exception &e) {
+    LOG_WARNING("Failed to fetch " << doc.url << ": " << e.getMessage()
+                << ", retrying in " << retryTTL << "s");
+    delay = retryTTL;
+  }
+
+  schedule(p, doc, delay);
+}
+
+
+void OAuth2KeyCache::updated(Provider &p, Document &doc) {
+  if (&doc == &p.discovery) {
+    string url = doc.value->getString("jwks_uri");
+
+    if (url != p.jwks.url) {
+      p.jwks.url = url;
+      p.jwks.etag.clear();
+      p.jwks.value.release();
+      if (p.jwks.refreshEvent.isSet()) p.jwks.refreshEvent->del();
+      fetch(p, p.jwks);
+    }
+
+  } else {
+    SmartPointer<JWKS> keys = new JWKS(*doc.value);
+    if (!keys->size()) THROW("No usable keys");
+    p.keys = keys;
+
+    LOG_INFO(3, "Loaded " << keys->size() << " OAuth2 keys from "
+             << doc.url);
+  }
+}
+
+
+void OAuth2KeyCache::schedule(Provider &p, Document &doc, unsigned delay) {
+  if (doc.refreshEvent.isNull())
+    doc.refreshEvent =
+      client.getBase().newEvent([this, &p, &doc] () {fetch(p, doc);}, 0);
+
+  doc.refreshEvent->add(delay);
+}
+
+#endif // HAVE_OPENSSL
@@ -0,0 +1,140 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "RequestMethod.h"
+#include "HTTPStatus.h"
+
+#include <cbang/config.h>
+#include <cbang/SmartPointer.h>
+
+#ifdef HAVE_OPENSSL
+#include <string>
+#include <map>
+
+
+namespace cb {
+  class JWKS;
+  namespace JSON {class Value;}
+
+  namespace Event {
+    class Client;
+    class Event;
+    class Request;
+
+    /**
+     * Caches the OpenID Connect discovery documents of OAuth2 providers and
+     * the signing keys published at their "jwks_uri".  Documents are kept
+     * for as long as their Cache-Control or Expires headers allow, bounded
+     * by the min and max TTLs, then revalidated in the background with
+     * If-None-Match.  The current keys remain in use until new ones arrive
+     * so verifying an ID token never waits on the network.
+     */
+    class OAuth2KeyCache : public RequestMethod, public HTTPStatus {
+      Client &client;
+
+      unsigned minTTL = 300;
+      unsigned defaultTTL = 3600;
+      unsigned maxTTL = 86400;
+      unsigned retryTTL = 60;
+
+      struct Document {
+        std::string url;
+        std::string etag;
+        SmartPointer<JSON::Value> value;
+        bool pending = false;
+        double lastFetch = 0;
+        SmartPointer<Event> refreshEvent;
+      };
+
+      struct Provider {
+        Document discovery;
+        Document jwks;
+        SmartPointer<JWKS> keys;
+      };
+
+      typedef std::map<std::string, SmartPointer<Provider> > providers_t;
+      providers_t providers;
+
+    public:
+      OAuth2KeyCache(Client &client);
+      ~OAuth2KeyCache();
+
+      unsigned getMinTTL() const {return minTTL;}
+      void setMinTTL(unsigned x) {minTTL = x;}
+      unsigned getDefaultTTL() const {return defaultTTL;}
+      /// Used when a response has no Cache-Control max-age or Expires
+      void setDefaultTTL(unsigned x) {defaultTTL = x;}
+      unsigned getMaxTTL() const {return maxTTL;}
+      void setMaxTTL(unsigned x) {maxTTL = x;}
+      unsigned getRetryTTL() const {return retryTTL;}
+      /// Delay before retrying a failed fetch
+      void setRetryTTL(unsigned x) {retryTTL = x;}
+
+      /// Start loading and refreshing the keys of @param discoveryURL
+      void add(const std::string &discoveryURL);
+      bool isReady(const std::string &discoveryURL) const;
+
+      SmartPointer<JSON::Value>
+      getDiscovery(const std::string &discoveryURL) const;
+      SmartPointer<JWKS> getKeys(const std::string &discoveryURL) const;
+
+      /**
+       * Verify the signature and claims of the ID token @param jwt with the
+       * cached keys of @param discoveryURL.  The issuer must match the
+       * discovery document and, if given, @param audience must be one of
+       * the token's audiences.  An unknown key ID triggers a refresh of
+       * the keys, rate limited by the min TTL.  Throws on failure.
+       * @return The token's claims.
+       */
+      SmartPointer<JSON::Value> verify(const std::string &discoveryURL,
+                                       const std::string &jwt,
+                                       const std::string &audience = "");
+
+      /// @return The seconds @param req may be cached
+      unsigned getTTL(const Request &req) const;
+
+    protected:
+      Provider *find(const std::string &discoveryURL) const;
+      void fetch(Provider &p, Document &doc);
+      void response(Provider &p, Document &doc, Request &req);
+      void updated(Provider &p, Document &doc);
+      void schedule(Provider &p, Document &doc, unsigned delay);
+    };
+  }
+}
+
+#else // HAVE_OPENSSL
+namespace cb {namespace Event {class OAuth2KeyCache {};}}
+#endif // HAVE_OPENSSL
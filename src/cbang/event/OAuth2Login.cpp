@@ -34,13 +34,15 @@
 #include "Request.h"
 #include "OutgoingRequest.h"
 #include "Client.h"
+#include "OAuth2KeyCache.h"
 
 #include <cbang/Catch.h>
 #include <cbang/auth/OAuth2.h>
 #include <cbang/net/URI.h>
-#include <cbang/json/Value.h>
+#include <cbang/json/JSON.h>
 #include <cbang/log/Logger.h>
 #include <cbang/event/HTTPStatus.h>
+#include <cbang/String.h>
 
 using namespace std;
 using namespace cb::Event;
@@ -59,6 +61,7 @@ bool OAuth2Login::authorize(Request &req, const string &state) {
 
 
 bool OAuth2Login::authRedirect(Request &req, const string &state) {
+  loadKeys();
   req.redirect(getOAuth2()->getRedirectURL(req.getURI().getPath(), state));
   return true;
 }
@@ -101,6 +104,14 @@ bool OAuth2Login::requestToken(Request &req, const string &state,
 }
 
 
+void OAuth2Login::loadKeys() {
+#ifdef HAVE_OPENSSL
+  const string &discoveryURL = getOAuth2()->getDiscoveryURL();
+  if (keyCache.isSet() && !discoveryURL.empty()) keyCache->add(discoveryURL);
+#endif // HAVE_OPENSSL
+}
+
+
 void OAuth2Login::verifyToken(Request &req, const string &response) {
   auto handler =
     [this, &req] (Request &_req) {
@@ -117,6 +128,37 @@ void OAuth2Login::verifyToken(Request &req, const string &response) {
       processProfile(req, 0);
     };
 
+#ifdef HAVE_OPENSSL
+  const string &discoveryURL = getOAuth2()->getDiscoveryURL();
+  SmartPointer<JSON::Value> profile;
+
+  if (keyCache.isSet() && !discoveryURL.empty() && !response.empty() &&
+      !String::startsWith(response, "access_token="))
+    try {
+      loadKeys();
+
+      if (keyCache->isReady(discoveryURL)) {
+        SmartPointer<JSON::Value> json = JSON::Reader::parseString(response);
+        string idToken = json->getString("id_token", "");
+
+        if (!idToken.empty()) {
+          SmartPointer<JSON::Value> claims = keyCache->verify
+            (discoveryURL, idToken, getOAuth2()->getClientID());
+          profile = getOAuth2()->processClaims(claims);
+        }
+      }
+    } catch (const Exception &e) {
+      LOG_WARNING("OAuth2Login ID token verification failed, requesting "
+                  "profile: " << e.getMessage());
+    }
+
+  if (profile.isSet()) {
+    LOG_DEBUG(3, "OAuth2 Profile: " << *profile);
+    processProfile(req, profile);
+    return;
+  }
+#endif // HAVE_OPENSSL
+
   if (!response.empty())
     try {
       // Verify
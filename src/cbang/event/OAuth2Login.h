@@ -47,10 +47,12 @@ namespace cb {
   namespace Event {
     class Client;
     class Request;
+    class OAuth2KeyCache;
 
     class OAuth2Login : public RequestMethod, public HTTPStatus {
       Client &client;
       SmartPointer<OAuth2> oauth2;
+      SmartPointer<OAuth2KeyCache> keyCache;
 
     public:
       OAuth2Login(Client &client, const SmartPointer<OAuth2> &oauth2 = 0);
@@ -60,6 +62,16 @@ namespace cb {
       void setOAuth2(const SmartPointer<OAuth2> &oauth2)
       {this->oauth2 = oauth2;}
 
+      const SmartPointer<OAuth2KeyCache> &getKeyCache() {return keyCache;}
+      /**
+       * When the provider has a discovery URL and its keys are cached, the
+       * ID token returned with the access token is verified locally and
+       * its claims are used as the profile.  Otherwise the profile is
+       * requested from the provider.
+       */
+      void setKeyCache(const SmartPointer<OAuth2KeyCache> &keyCache)
+      {this->keyCache = keyCache;}
+
       virtual void processProfile(Request &req,
                                   const SmartPointer<JSON::Value> &profile) = 0;
 
@@ -69,6 +81,8 @@ namespace cb {
                         const std::string &redirect_uri = std::string());
 
     protected:
+      /// Start loading the provider's keys before the token arrives
+      void loadKeys();
       void verifyToken(Request &req, const std::string &response);
     };
   }
@@ -0,0 +1,122 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "OTLPTraceExporter.h"
+#include "Trace.h"
+#include "Client.h"
+#include "Base.h"
+#include "Event.h"
+
+#include <cbang/Catch.h>
+#include <cbang/json/Writer.h>
+#include <cbang/log/Logger.h>
+
+#include <sstream>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+OTLPTraceExporter::OTLPTraceExporter(Client &client, const URI &endpoint,
+                                     const string &service,
+                                     double interval) :
+  client(client), endpoint(endpoint), service(service) {
+  flushEvent = client.getBase().newEvent(this, &OTLPTraceExporter::flush);
+  flushEvent->add(interval);
+}
+
+
+OTLPTraceExporter::~OTLPTraceExporter() {flushEvent->del();}
+
+
+void OTLPTraceExporter::flush() {
+  if (batch.empty()) return;
+
+  if (maxPending <= pending) {
+    LOG_WARNING("OTLP collector is behind, dropping " << batchSize
+                << " spans");
+    dropped += batchSize;
+
+  } else {
+    // The spans are already encoded, see add()
+    string body =
+      "{\"resourceSpans\":[{\"resource\":{\"attributes\":[{\"key\":"
+      "\"service.name\",\"value\":{\"stringValue\":\"" +
+      JSON::Writer::escape(service) + "\"}}]},\"scopeSpans\":[{\"scope\":"
+      "{\"name\":\"cbang\"},\"spans\":[" + batch + "]}]}]}";
+
+    SmartPointer<OTLPTraceExporter> self = this;
+    unsigned count = batchSize;
+
+    auto cb = [this, self, count] (Request &req) {
+      pending--;
+
+      if (!req.isOk()) {
+        dropped += count;
+        LOG_WARNING("Failed to send " << count << " spans to " << endpoint
+                    << ": " << req.getResponseCode() << ' '
+                    << req.getConnectionError());
+      }
+    };
+
+    auto req =
+      client.call(endpoint, RequestMethod::HTTP_POST, std::move(body), cb);
+    req->setContentType("application/json");
+    req->send();
+    pending++;
+  }
+
+  batch.clear();
+  batchSize = 0;
+}
+
+
+void OTLPTraceExporter::add(const Trace &trace, uint64_t clockOffset) {
+  ostringstream str;
+  JSON::Writer writer(str, 0, true);
+
+  // Write the spans as list elements then strip the list
+  writer.beginList();
+  trace.writeOTLP(writer, clockOffset);
+  writer.endList();
+  writer.close();
+
+  string spans = str.str();
+  if (spans.length() <= 2) return;
+
+  if (!batch.empty()) batch += ',';
+  batch.append(spans, 1, spans.length() - 2);
+  batchSize += trace.getSpanCount();
+
+  if (maxBatch <= batchSize) flush();
+}
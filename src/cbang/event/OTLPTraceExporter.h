@@ -0,0 +1,88 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "TraceExporter.h"
+
+#include <cbang/net/URI.h>
+
+#include <string>
+
+
+namespace cb {
+  namespace Event {
+    class Client;
+    class Event;
+
+    /**
+     * Sends spans in batches to an OpenTelemetry collector using OTLP/HTTP
+     * with JSON encoding, e.g. to http://localhost:4318/v1/traces.  Spans
+     * are sent every @param interval seconds or sooner when the batch is
+     * full.  When the collector falls behind spans are dropped rather than
+     * held without bound.
+     */
+    class OTLPTraceExporter : public TraceExporter {
+      Client &client;
+      URI endpoint;
+      std::string service;
+
+      unsigned maxBatch = 512;
+      unsigned maxPending = 8;
+      unsigned pending = 0;
+      uint64_t dropped = 0;
+
+      std::string batch;
+      unsigned batchSize = 0;
+      SmartPointer<Event> flushEvent;
+
+    public:
+      OTLPTraceExporter(Client &client, const URI &endpoint,
+                        const std::string &service, double interval = 5);
+      ~OTLPTraceExporter();
+
+      unsigned getMaxBatch() const {return maxBatch;}
+      void setMaxBatch(unsigned x) {maxBatch = x ? x : 1;}
+
+      /// The most batches sent but not yet acknowledged
+      unsigned getMaxPending() const {return maxPending;}
+      void setMaxPending(unsigned x) {maxPending = x;}
+
+      uint64_t getDropped() const {return dropped;}
+
+      void flush();
+
+      // From TraceExporter
+      void add(const Trace &trace, uint64_t clockOffset);
+    };
+  }
+}
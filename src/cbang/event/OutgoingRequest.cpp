@@ -32,6 +32,7 @@
 
 #include "OutgoingRequest.h"
 #include "Client.h"
+#include "ConnectionPool.h"
 #include "Buffer.h"
 #include "Headers.h"
 
@@ -42,6 +43,14 @@
 #include <cbang/socket/Socket.h>
 #include <cbang/time/Timer.h>
 #include <cbang/openssl/SSLContext.h>
+#include <cbang/openssl/Digest.h>
+
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/uio.h>
+#endif
 
 
 using namespace std;
@@ -56,8 +65,11 @@ using namespace cb::Event;
 OutgoingRequest::OutgoingRequest(Client &client, const URI &uri,
                                  RequestMethod method, callback_t cb) :
   Connection(client.getBase(), false, uri.getIPAddress(), 0,
-             uri.getScheme() == "https" ? client.getSSLContext() : 0),
-  Request(method, uri), dns(client.getDNS()), cb(cb) {
+             uri.getScheme() == "https" || uri.getScheme() == "https+unix" ?
+             client.getSSLContext() : 0),
+  Request(method, uri), dns(client.getDNS()), pool(client.getPool()),
+  cb(std::move(cb)), parentTrace(Trace::getCurrent()) {
+  setSocketOptions(client.getSocketOptions());
   LOG_DEBUG(5, "Connecting to " << uri.getHost() << ':' << uri.getPort());
 }
 
@@ -66,15 +78,53 @@ OutgoingRequest::~OutgoingRequest() {}
 
 
 void OutgoingRequest::setProgressCallback(progress_cb_t cb, double delay) {
-  progressCB = cb;
+  progressCB = std::move(cb);
   progressDelay = delay;
 }
 
 
+void OutgoingRequest::setBodyFD(int fd) {bodyFD = fd;}
+
+
+void OutgoingRequest::setBodyStream(const SmartPointer<ostream> &stream) {
+  bodyStream = stream;
+}
+
+
+void OutgoingRequest::setResumeOffset(uint64_t offset) {
+  resumeOffset = offset;
+  if (offset) outSet("Range", "bytes=" + String(offset) + "-");
+  else outRemove("Range");
+}
+
+
+void OutgoingRequest::setBodyDigest(const string &algorithm,
+                                    const string &expected) {
+  digest = new Digest(algorithm);
+  expectedDigest = String::toLower(expected);
+}
+
+
 void OutgoingRequest::send() {
   // Set output headers
-  if (!outHas("Host")) outSet("Host", getURI().getHost());
-  if (!outHas("Connection")) outSet("Connection", "close");
+  if (!outHas("Host"))
+    outSet("Host", getURI().isUnixSocket() ? "localhost" : getURI().getHost());
+
+  // Propagate trace context
+  if (parentTrace.isSet() && !parentTrace->isFinished() && !traceSpan &&
+      !outHas("traceparent")) {
+    traceSpan = parentTrace->begin(string(getMethod().toString()) + " " +
+                                   getURI().getHost(), 0, Trace::KIND_CLIENT);
+    parentTrace->setAttribute(traceSpan, "http.url", getURI().toString());
+    outSet("traceparent", parentTrace->getTraceParent(traceSpan));
+  }
+
+  // Reuse an idle connection if possible, otherwise close when done
+  if (pool.isSet() && pool->isEnabled() && !Connection::isConnected()) {
+    poolKey = ConnectionPool::getKey(getURI());
+    if (pool->acquire(poolKey, *this)) adopted();
+
+  } else if (!outHas("Connection")) outSet("Connection", "close");
 
   // Set Content-Length
   if (mayHaveBody() && !outHas("Content-Length"))
@@ -89,10 +139,22 @@ void OutgoingRequest::send() {
 }
 
 
-void OutgoingRequest::onProgress(unsigned bytes, int total) {
+void OutgoingRequest::onHeaders() {
+  unsigned code = getResponseCode();
+  if (hasBodySink() && 200 <= code && code < 300 && mustHaveBody())
+    startBody();
+}
+
+
+void OutgoingRequest::onProgress(uint64_t bytes, int64_t total) {
   double now = Timer::now();
 
-  if (progressCB && ((int)bytes == total || lastProgress + progressDelay < now))
+  // Count the part of a resumed body which was already downloaded
+  bytes += bodyOffset;
+  if (0 <= total) total += bodyOffset;
+
+  if (progressCB &&
+      ((int64_t)bytes == total || lastProgress + progressDelay < now))
     try {
       progressCB(bytes, total);
       lastProgress = now;
@@ -100,7 +162,44 @@ void OutgoingRequest::onProgress(unsigned bytes, int total) {
 }
 
 
+void OutgoingRequest::onBodyData(Buffer &buf) {
+  if (digest.isSet()) digest->update(buf);
+
+  if (bodyStream.isSet()) {
+    buf.remove(*bodyStream);
+    if (!*bodyStream) THROW("Failed to write response body to stream");
+    return;
+  }
+
+#ifndef _WIN32
+  // Write straight from the buffer's chains
+  while (buf.getLength()) {
+    vector<iovec> space(16);
+    buf.peek(space);
+
+    ssize_t n = ::writev(bodyFD, &space[0], space.size());
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      THROW("Failed to write response body: " << SysError());
+    }
+
+    buf.drain(n);
+  }
+#endif // _WIN32
+}
+
+
 void OutgoingRequest::onResponse(ConnectionError error) {
+  if (!error && isBodyStreaming()) {
+    if (bodyStream.isSet()) bodyStream->flush();
+
+    if (digest.isSet() && digest->toHexString() != expectedDigest) {
+      LOG_ERROR("Response body " << digest->toHexString()
+                << " does not match digest " << expectedDigest);
+      error = CONN_ERR_EXCEPTION;
+    }
+  }
+
   if (error) {
     LOG_ERROR("< " << getPeer() << ' ' << error);
 
@@ -115,8 +214,74 @@ void OutgoingRequest::onResponse(ConnectionError error) {
     LOG_DEBUG(6, getInputBuffer().hexdump() << '\n');
   }
 
+  // Return the connection to the pool before the callback makes more calls
+  if (!poolKey.empty()) {
+    pool->saveSession(poolKey, *this);
+    if (!error && !needsClose()) pool->release(poolKey, *this);
+  }
+
+  if (traceSpan) {
+    parentTrace->end(traceSpan);
+    parentTrace->setAttribute(traceSpan, "http.status_code",
+                              String((unsigned)getResponseCode()));
+  }
+
   setConnectionError(error);
   if (cb) TRY_CATCH_ERROR(cb(*this));
 
   setConnection(0); // Release self reference
 }
+
+
+void OutgoingRequest::startBody() {
+  bodyOffset = 0;
+
+  if (resumeOffset && getResponseCode() == HTTP_PARTIAL_CONTENT) {
+    // Content-Range: bytes <first>-<last>/<length>
+    string range = inFind("Content-Range");
+    if (!String::startsWith(range, "bytes " + String(resumeOffset) + "-"))
+      THROW("Unexpected Content-Range '" << range << "' resuming at "
+            << resumeOffset);
+
+    bodyOffset = resumeOffset;
+  }
+
+  if (bodyStream.isSet()) {
+    if (resumeOffset && !bodyOffset)
+      THROW("Server sent the whole body, cannot restart a body stream");
+    if (bodyOffset && digest.isSet())
+      THROW("Cannot verify the digest of a resumed body stream");
+
+  } else {
+#ifdef _WIN32
+    THROW("Body file descriptors are not supported on Windows");
+#else
+    // Continue after the part already downloaded, or start over
+    if (resumeOffset && (ftruncate(bodyFD, bodyOffset) ||
+                         lseek(bodyFD, bodyOffset, SEEK_SET) < 0))
+      THROW("Failed to seek response body file: " << SysError());
+
+    if (bodyOffset && digest.isSet()) hashFile(bodyOffset);
+#endif // _WIN32
+  }
+
+  setBodyStreaming(true);
+}
+
+
+void OutgoingRequest::hashFile(uint64_t length) {
+#ifndef _WIN32
+  vector<uint8_t> block(1 << 20);
+
+  for (uint64_t offset = 0; offset < length;) {
+    size_t size = min<uint64_t>(block.size(), length - offset);
+    ssize_t n = ::pread(bodyFD, &block[0], size, offset);
+
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) THROW("Failed to read response body file: " << SysError());
+
+    digest->update(&block[0], n);
+    offset += n;
+  }
+#endif // _WIN32
+}
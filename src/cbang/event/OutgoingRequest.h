@@ -36,36 +36,103 @@
 #include "Connection.h"
 
 #include <cbang/SmartPointer.h>
+#include <cbang/util/InlineFunction.h>
 
 #include <functional>
+#include <ostream>
 
 
 namespace cb {
   class URI;
+  class Digest;
 
   namespace Event {
     class Client;
     class HTTPHandler;
+    class ConnectionPool;
 
     class OutgoingRequest : public Connection, public Request {
     public:
-      typedef std::function<void (Request &)> callback_t;
-      typedef std::function<void (unsigned bytes, int total)> progress_cb_t;
+      typedef InlineFunction<void (Request &)> callback_t;
+      typedef InlineFunction<void (uint64_t bytes, int64_t total)>
+      progress_cb_t;
 
     protected:
       DNSBase &dns;
+      SmartPointer<ConnectionPool> pool;
+      std::string poolKey;
       callback_t cb;
       double lastProgress = 0;
       double progressDelay;
       progress_cb_t progressCB;
+      SmartPointer<Trace> parentTrace;
+      unsigned traceSpan = 0;
+
+      int bodyFD = -1;
+      SmartPointer<std::ostream> bodyStream;
+      uint64_t resumeOffset = 0;
+      uint64_t bodyOffset = 0;
+      SmartPointer<Digest> digest;
+      std::string expectedDigest;
 
     public:
+      using PoolAllocated<Connection>::operator new;
+      using PoolAllocated<Connection>::operator delete;
+
       OutgoingRequest(Client &client, const URI &uri, RequestMethod method,
                       callback_t cb);
       ~OutgoingRequest();
 
+      /**
+       * With resume, @param bytes and @param total include the part of the
+       * body which was already downloaded.
+       */
       void setProgressCallback(progress_cb_t cb, double delay = 0.25);
 
+      /**
+       * Write the body of a successful response to @param fd as it arrives
+       * rather than collecting it in the input buffer.  The descriptor is
+       * not closed.  Other responses, such as errors, are buffered as usual.
+       */
+      void setBodyFD(int fd);
+      int getBodyFD() const {return bodyFD;}
+      /// As setBodyFD() but write to @param stream
+      void setBodyStream(const SmartPointer<std::ostream> &stream);
+      const SmartPointer<std::ostream> &getBodyStream() const
+        {return bodyStream;}
+      bool hasBodySink() const {return bodyFD != -1 || bodyStream.isSet();}
+
+      /**
+       * Ask for the body from @param offset on, with a Range header, to
+       * finish an earlier partial download.  A 206 reply is written to the
+       * body file from @param offset.  If the server sends the whole body
+       * instead, the file is truncated and written from the start.  With a
+       * body stream only a 206 reply can be accepted.
+       */
+      void setResumeOffset(uint64_t offset);
+      uint64_t getResumeOffset() const {return resumeOffset;}
+      /// The offset in the body sink at which the response body started
+      uint64_t getBodyOffset() const {return bodyOffset;}
+
+      /**
+       * Hash the body with @param algorithm, for example "sha256", as it is
+       * written to the body sink and fail the request unless it matches
+       * the hex digest @param expected.  When resuming, the part already in
+       * the body file is read back and hashed first, which is not possible
+       * with a body stream.
+       */
+      void setBodyDigest(const std::string &algorithm,
+                         const std::string &expected);
+
+      /**
+       * Record this request as a client span of @param trace and send its
+       * context in a traceparent header.  Defaults to the Trace of the
+       * handler running when the request was created.
+       */
+      void setParentTrace(const SmartPointer<Trace> &trace)
+        {parentTrace = trace;}
+      const SmartPointer<Trace> &getParentTrace() const {return parentTrace;}
+
       using Request::send;
       void send();
 
@@ -74,8 +141,14 @@ namespace cb {
 
       // From Request
       void onRequest() {}
-      void onProgress(unsigned bytes, int total);
+      void onHeaders();
+      void onProgress(uint64_t bytes, int64_t total);
+      void onBodyData(Buffer &buf);
       void onResponse(ConnectionError error);
+
+    protected:
+      void startBody();
+      void hashFile(uint64_t length);
     };
 
     typedef SmartPointer<OutgoingRequest> OutgoingRequestPtr;
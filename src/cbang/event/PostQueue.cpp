@@ -0,0 +1,131 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "PostQueue.h"
+#include "Base.h"
+#include "Event.h"
+
+#include <cbang/Catch.h>
+#include <cbang/util/SmartLock.h>
+
+using namespace cb::Event;
+using namespace std;
+
+
+PostQueue::PostQueue(Base &base) :
+  base(base), event(base.newEvent(this, &PostQueue::drain,
+                                  EF::EVENT_NO_SELF_REF)),
+  signaled(false), size(0), waiting(0) {
+  if (!Base::threadsEnabled())
+    THROW("Cannot use Event::PostQueue without threads enabled.  "
+          "Call Event::Base::enableThreads() before creating Event::Base.");
+}
+
+
+PostQueue::~PostQueue() {event->del();}
+
+
+void PostQueue::setEventPriority(int priority) {event->setPriority(priority);}
+
+
+void PostQueue::post(callback_t cb) {
+  if (isConsumer()) size++; // Blocking here would never end
+  else reserve(true);
+
+  push(std::move(cb));
+}
+
+
+bool PostQueue::tryPost(callback_t cb) {
+  if (!reserve(false)) return false;
+  push(std::move(cb));
+  return true;
+}
+
+
+bool PostQueue::reserve(bool block) {
+  if (!capacity) {
+    size++;
+    return true;
+  }
+
+  while (true) {
+    unsigned n = size;
+    if (n < capacity) {
+      if (size.compare_exchange_weak(n, n + 1)) return true;
+      continue;
+    }
+
+    if (!block) return false;
+
+    // Wait for the loop to drain, rechecking periodically in case a wakeup
+    // slips between the check and the wait
+    SmartLock lock(&notFull);
+    waiting++;
+    if (capacity <= size) notFull.timedWait(0.1);
+    waiting--;
+  }
+}
+
+
+bool PostQueue::isConsumer() const {
+  return consumer.load(memory_order_relaxed) == this_thread::get_id();
+}
+
+
+void PostQueue::push(callback_t cb) {
+  queue.push(std::move(cb));
+
+  // Only the first post since the last drain wakes the loop
+  if (!signaled.exchange(true)) event->activate();
+}
+
+
+void PostQueue::drain() {
+  consumer.store(this_thread::get_id(), memory_order_relaxed);
+
+  // Clear before draining so a post that is missed below wakes us again
+  signaled = false;
+
+  callback_t cb;
+  while (queue.pop(cb)) {
+    TRY_CATCH_ERROR(cb());
+    cb = 0;
+
+    size--;
+    if (waiting) {
+      SmartLock lock(&notFull);
+      notFull.broadcast();
+    }
+  }
+}
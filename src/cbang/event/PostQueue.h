@@ -0,0 +1,97 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+#include <cbang/os/Condition.h>
+#include <cbang/util/MPSCQueue.h>
+#include <cbang/util/InlineFunction.h>
+
+#include <atomic>
+#include <thread>
+
+
+namespace cb {
+  namespace Event {
+    class Base;
+    class Event;
+
+    /**
+     * Runs closures posted from any thread on the Base's loop.  Producers
+     * push on to a lock-free MPSCQueue.  Only the post that finds the
+     * queue idle activates the loop's event, so a burst of posts costs one
+     * wakeup and the loop drains every pending closure in one callback.
+     *
+     * With a capacity set, post() blocks while the queue is full and
+     * tryPost() fails instead.  Posts from the loop's own thread never
+     * block.  Requires Base::enableThreads().
+     */
+    class PostQueue {
+    public:
+      typedef InlineFunction<void ()> callback_t;
+
+    protected:
+      Base &base;
+      SmartPointer<Event> event;
+      MPSCQueue<callback_t> queue;
+
+      std::atomic<bool> signaled;
+      std::atomic<unsigned> size;
+      std::atomic<unsigned> waiting;
+      unsigned capacity = 0;
+      std::atomic<std::thread::id> consumer;
+      Condition notFull;
+
+    public:
+      PostQueue(Base &base);
+      ~PostQueue();
+
+      unsigned getSize() const {return size;}
+      unsigned getCapacity() const {return capacity;}
+      /// Zero for no limit.  Set before posting from other threads.
+      void setCapacity(unsigned capacity) {this->capacity = capacity;}
+      void setEventPriority(int priority);
+
+      void post(callback_t cb);
+      /// @return false if the queue is full
+      bool tryPost(callback_t cb);
+
+    protected:
+      bool reserve(bool block);
+      bool isConsumer() const;
+      void push(callback_t cb);
+      void drain();
+    };
+  }
+}
@@ -0,0 +1,105 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "ProfilerHandler.h"
+#include "Base.h"
+#include "Event.h"
+#include "Connection.h"
+
+#include <cbang/String.h>
+#include <cbang/debug/Profiler.h>
+
+#include <sstream>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+bool ProfilerHandler::operator()(Request &req) {
+  const URI &uri = req.getURI();
+  string action = uri.get("action", uri.has("seconds") ? "profile" : "folded");
+
+  if (action == "start") {
+    start(uri);
+    replyStatus(req);
+
+  } else if (action == "stop") {
+    Profiler::instance().stop();
+    replyStatus(req);
+
+  } else if (action == "status") replyStatus(req);
+  else if (action == "folded") replyFolded(req);
+
+  else if (action == "profile") {
+    double seconds = String::parseDouble(uri.get("seconds"));
+    if (!(0 < seconds && seconds <= maxSeconds))
+      THROWX("Profile duration must be between 0 and " << maxSeconds
+             << " seconds", HTTP_BAD_REQUEST);
+
+    start(uri);
+
+    SmartPointer<Request> ptr = &req;
+    auto cb = [ptr] () {Profiler::instance().stop(); replyFolded(*ptr);};
+    req.getConnection().getBase().newEvent(cb, 0)->add(seconds);
+
+  } else THROWX("Unknown profiler action '" << action << "'",
+                HTTP_BAD_REQUEST);
+
+  return true;
+}
+
+
+void ProfilerHandler::start(const URI &uri) {
+  unsigned rate = String::parseU32(uri.get("rate", "99"));
+  unsigned samples = String::parseU32(uri.get("samples", "10000"));
+
+  Profiler::instance().start(rate, samples);
+}
+
+
+void ProfilerHandler::replyStatus(Request &req) {
+  auto writer = req.getJSONWriter();
+  Profiler::instance().write(*writer);
+  writer->close();
+  req.reply();
+}
+
+
+void ProfilerHandler::replyFolded(Request &req) {
+  ostringstream str;
+  Profiler::instance().writeFolded(str);
+
+  req.setContentType("text/plain");
+  req.reply(str.str());
+}
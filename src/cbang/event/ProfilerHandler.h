@@ -0,0 +1,68 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "HTTPRequestHandler.h"
+
+
+namespace cb {
+  namespace Event {
+    /**
+     * Controls the process wide Profiler.  The "action" argument selects:
+     *
+     *   start  - Start sampling at "rate" Hz keeping up to "samples".
+     *   stop   - Stop sampling.
+     *   status - Reply with the profiler's state as JSON.
+     *   folded - Reply with the samples as folded stacks.  The default.
+     *
+     * With a "seconds" argument and no action the profiler is started and
+     * the folded stacks are sent once it has run that long.  Should only be
+     * reachable by administrators.
+     */
+    class ProfilerHandler : public HTTPRequestHandler {
+      double maxSeconds;
+
+    public:
+      ProfilerHandler(double maxSeconds = 300) : maxSeconds(maxSeconds) {}
+
+      // From HTTPRequestHandler
+      bool operator()(Request &req);
+
+    protected:
+      void start(const URI &uri);
+      static void replyStatus(Request &req);
+      static void replyFolded(Request &req);
+    };
+  }
+}
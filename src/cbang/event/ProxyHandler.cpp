@@ -0,0 +1,403 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "ProxyHandler.h"
+#include "Client.h"
+#include "OutgoingRequest.h"
+#include "Base.h"
+#include "Event.h"
+
+#include <cbang/String.h>
+#include <cbang/Catch.h>
+#include <cbang/log/Logger.h>
+#include <cbang/time/Timer.h>
+
+#include <sstream>
+#include <limits>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+namespace {
+  const unsigned maxAttempts = 2;
+
+
+  bool isListed(const string &name, const vector<string> &names) {
+    string lower = String::toLower(name);
+
+    for (unsigned i = 0; i < names.size(); i++)
+      if (names[i] == lower) return true;
+
+    return false;
+  }
+
+
+  /// Headers named by Connection are hop-by-hop too
+  vector<string> getConnectionHeaders(const Headers &hdrs) {
+    vector<string> names;
+    String::tokenize(String::toLower(hdrs.find("Connection")), names, ", ");
+    return names;
+  }
+}
+
+
+/// A forwarded request which relays its response to the client's request
+class ProxyHandler::Forward : public OutgoingRequest {
+  ProxyHandler &handler;
+  SmartPointer<Request> req;
+  UpstreamPtr upstream;
+  unsigned attempt;
+
+  bool started = false;   // Response headers relayed to the client
+  bool streaming = false; // Relaying the body with chunks
+  bool finished = false;
+
+public:
+  Forward(ProxyHandler &handler, const SmartPointer<Request> &req,
+          const UpstreamPtr &upstream, unsigned attempt) :
+    OutgoingRequest(handler.getClient(),
+                    handler.getUpstreamURI(*upstream, *req),
+                    req->getMethod(), 0),
+    handler(handler), req(req), upstream(upstream), attempt(attempt) {
+
+    // Request headers
+    const Headers &in = req->getInputHeaders();
+    vector<string> hopByHop = getConnectionHeaders(in);
+
+    for (auto it = in.begin(); it != in.end(); it++) {
+      const string &name = it->first;
+
+      if (it->second.empty() || isHopByHop(name) || isListed(name, hopByHop) ||
+          name == "Content-Length" || name == "Expect" ||
+          (name == "Host" && !handler.getPreserveHost()))
+        continue;
+
+      outSet(name, it->second);
+    }
+
+    string client = req->getClientIP().getHost();
+    string forwarded = in.find("X-Forwarded-For");
+    outSet("X-Forwarded-For",
+           forwarded.empty() ? client : forwarded + ", " + client);
+    outSet("X-Forwarded-Proto", req->isSecure() ? "https" : "http");
+    if (in.has("Host")) outSet("X-Forwarded-Host", in.get("Host"));
+
+    // Reference the body so it can be sent again on retry
+    if (req->getInputBuffer().getLength())
+      getOutputBuffer().addRef(req->getInputBuffer());
+  }
+
+
+  void start() {
+    // Backpressure needs a limit on the client's output
+    Connection &con = req->getConnection();
+    unsigned size = handler.getBufferSize();
+    if (!con.getWriteHighWater() && size)
+      con.setWriteWatermarks(size / 4, size);
+
+    SmartPointer<Forward> self = this;
+    req->setCompleteCallback([self] () {self->abort();});
+    send();
+  }
+
+
+  /// The client has gone, stop forwarding
+  void abort() {
+    if (finished) return;
+    finished = true;
+
+    LOG_DEBUG(3, "Client closed, canceling proxied request");
+    req->onWritable(0);
+    if (Request::hasConnection()) Request::cancel();
+  }
+
+
+  void relayHeaders() {
+    const Headers &in = getInputHeaders();
+    vector<string> hopByHop = getConnectionHeaders(in);
+
+    for (auto it = in.begin(); it != in.end(); it++) {
+      const string &name = it->first;
+
+      if (it->second.empty() || isHopByHop(name) || isListed(name, hopByHop) ||
+          (streaming && name == "Content-Length"))
+        continue;
+
+      req->outSet(name, it->second);
+    }
+
+    started = true;
+  }
+
+
+  void relayBody() {
+    if (!streaming || finished || !getInputBuffer().getLength()) return;
+
+    Buffer chunk;
+    chunk.add(getInputBuffer()); // Moves the data
+    req->sendChunk(chunk);
+
+    if (!req->isWritable()) {
+      // Backpressure, wait for the client
+      setReadPaused(true);
+      SmartPointer<Forward> self = this;
+      req->onWritable([self] () {self->setReadPaused(false);});
+    }
+  }
+
+
+  // From Request
+  void onHeaders() {
+    if (getResponseCode() < 200 || finished) return; // Interim response
+
+    streaming = mustHaveBody() && Version(1, 1) <= req->getVersion();
+    relayHeaders();
+    if (streaming) req->startChunked(getResponseCode());
+  }
+
+
+  void onProgress(uint64_t bytes, int64_t total) {
+    OutgoingRequest::onProgress(bytes, total);
+    relayBody();
+  }
+
+
+  void onResponse(ConnectionError error) {
+    SmartPointer<Forward> self = this; // Base releases the self reference
+    OutgoingRequest::onResponse(error);
+
+    bool canceled = finished;
+    handler.complete(*upstream, error && !canceled);
+    if (canceled) return;
+    finished = true;
+
+    if (error) {
+      req->onWritable(0);
+
+      if (!started) {
+        bool retry = attempt + 1 < maxAttempts &&
+          (error == CONN_ERR_CONNECT || isIdempotent(getMethod()));
+
+        if (retry && req->isConnected())
+          return handler.forward(req, attempt + 1, upstream.get());
+
+        req->setCompleteCallback(0);
+        return req->sendError(error == CONN_ERR_TIMEOUT ?
+                              HTTP_GATEWAY_TIME_OUT : HTTP_BAD_GATEWAY);
+      }
+
+      // The response was cut off, close the client's request too
+      req->setCompleteCallback(0);
+      return req->cancel();
+    }
+
+    req->setCompleteCallback(0);
+
+    if (streaming) {
+      finished = false; // Let relayBody() send the rest
+      relayBody();
+      finished = true;
+      req->endChunked();
+
+    } else {
+      if (!started) relayHeaders();
+      req->send(getInputBuffer());
+      req->reply(getResponseCode());
+    }
+  }
+};
+
+
+ProxyHandler::ProxyHandler(Client &client, balance_t balance) :
+  client(client), balance(balance) {}
+
+
+ProxyHandler::~ProxyHandler() {}
+
+
+void ProxyHandler::addUpstream(const URI &uri) {
+  if (uri.getHost().empty()) THROW("Upstream '" << uri << "' has no host");
+  upstreams.push_back(new Upstream(uri));
+}
+
+
+void ProxyHandler::setHealthCheck(const string &path, double interval) {
+  if (interval <= 0) THROW("Invalid health check interval " << interval);
+
+  healthPath = path;
+  healthEvent = client.getBase().newEvent
+    (this, &ProxyHandler::checkHealth,
+     EF::EVENT_PERSIST | EF::EVENT_NO_SELF_REF);
+  healthEvent->add(interval);
+
+  checkHealth();
+}
+
+
+void ProxyHandler::checkHealth() {
+  for (unsigned i = 0; i < upstreams.size(); i++) {
+    UpstreamPtr upstream = upstreams[i];
+
+    URI uri(upstream->uri.getScheme() + "://" + upstream->uri.getHost() +
+            ":" + String(upstream->uri.getPort()) + healthPath);
+
+    auto cb = [upstream] (Request &req) {
+      bool ok = req.isOk();
+
+      if (ok != upstream->healthy)
+        LOG_INFO(1, "Upstream " << upstream->uri << " is "
+                 << (ok ? "healthy" : "unhealthy"));
+
+      upstream->healthy = ok;
+
+      if (ok) {
+        upstream->failures = 0;
+        upstream->downUntil = 0;
+      }
+    };
+
+    client.call(uri, HTTP_GET, cb)->send();
+  }
+}
+
+
+ProxyHandler::Upstream *ProxyHandler::select(const Upstream *exclude) {
+  if (upstreams.empty()) return 0;
+
+  double now = Timer::now();
+  Upstream *best = 0;
+
+  // An excluded upstream is only used if there is no other
+  for (int pass = 0; pass < 2 && !best; pass++)
+    for (unsigned i = 0; i < upstreams.size(); i++) {
+      unsigned index = (next + i) % upstreams.size();
+      Upstream *upstream = upstreams[index].get();
+
+      if (!upstream->isUp(now) || (!pass && upstream == exclude)) continue;
+
+      if (balance == BALANCE_ROUND_ROBIN) {
+        next = index + 1;
+        return upstream;
+      }
+
+      if (!best || upstream->active < best->active) best = upstream;
+    }
+
+  if (best) next++;
+
+  return best;
+}
+
+
+URI ProxyHandler::getUpstreamURI(const Upstream &upstream,
+                                 const Request &req) const {
+  const URI &base = upstream.uri;
+  const URI &uri = req.getURI();
+
+  string prefix = base.getEscapedPath();
+  if (!prefix.empty() && prefix.back() == '/') prefix.pop_back();
+
+  ostringstream str;
+  str << base.getScheme() << "://" << base.getHost() << ':' << base.getPort()
+      << prefix << uri.getEscapedPath();
+  if (!uri.empty()) uri.writeQuery(str << '?');
+
+  return URI(str.str());
+}
+
+
+bool ProxyHandler::isHopByHop(const string &header) {
+  static const char *headers[] = {
+    "connection", "keep-alive", "proxy-authenticate", "proxy-authorization",
+    "proxy-connection", "te", "trailer", "transfer-encoding", "upgrade", 0
+  };
+
+  string name = String::toLower(header);
+
+  for (unsigned i = 0; headers[i]; i++)
+    if (name == headers[i]) return true;
+
+  return false;
+}
+
+
+bool ProxyHandler::isIdempotent(RequestMethod method) {
+  switch (method) {
+  case HTTP_GET: case HTTP_HEAD: case HTTP_PUT: case HTTP_DELETE:
+  case HTTP_OPTIONS: case HTTP_TRACE: return true;
+  default: return false;
+  }
+}
+
+
+bool ProxyHandler::operator()(Request &req) {
+  forward(&req, 0, 0);
+  return true;
+}
+
+
+void ProxyHandler::forward(const SmartPointer<Request> &req,
+                           unsigned attempt, const Upstream *exclude) {
+  Upstream *upstream = select(exclude);
+
+  if (!upstream) {
+    LOG_WARNING("No upstream available for " << req->getURI());
+    return req->sendError(attempt ? HTTP_BAD_GATEWAY :
+                          HTTP_SERVICE_UNAVAILABLE);
+  }
+
+  upstream->active++;
+  upstream->requests++;
+
+  SmartPointer<Forward> fwd = new Forward(*this, req, upstream, attempt);
+  fwd->start();
+}
+
+
+void ProxyHandler::complete(Upstream &upstream, bool failed) {
+  if (upstream.active) upstream.active--;
+
+  if (!failed) {
+    upstream.failures = 0;
+    return;
+  }
+
+  if (maxFails <= ++upstream.failures) {
+    LOG_WARNING("Upstream " << upstream.uri << " failed " << upstream.failures
+                << " times, skipping it for " << failTimeout << " sec");
+    upstream.downUntil = Timer::now() + failTimeout;
+    upstream.failures = 0;
+  }
+}
@@ -0,0 +1,167 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "HTTPRequestHandler.h"
+
+#include <cbang/SmartPointer.h>
+#include <cbang/net/URI.h>
+
+#include <string>
+#include <vector>
+
+
+namespace cb {
+  namespace Event {
+    class Client;
+    class Event;
+    class Request;
+
+    /**
+     * Forwards requests to a pool of upstream HTTP servers with Client.
+     *
+     * Response bodies are streamed to the client as they arrive, with
+     * chunked encoding, or HTTP/2 data frames.  When the client falls
+     * behind, reading from the upstream is paused until the client's
+     * output drains.  HTTP/1.0 clients, which cannot receive a chunked
+     * reply, get the response once it is complete.  Request bodies have
+     * already been read by the Connection when the handler runs so they
+     * are forwarded, without copying, from the Request's input buffer.
+     *
+     * Hop-by-hop headers, and any named in Connection, are not forwarded
+     * in either direction.  X-Forwarded-For, X-Forwarded-Proto and
+     * X-Forwarded-Host are added to forwarded requests.
+     *
+     * Upstreams are chosen round-robin or by the fewest active requests
+     * among those which are up.  An upstream which fails maxFails times in
+     * a row is skipped for failTimeout seconds.  With a health check
+     * configured, each upstream is also polled and skipped while its check
+     * fails.  A request which fails before any response was received is
+     * retried once on another upstream if it was never sent or its method
+     * is idempotent.
+     *
+     * The handler must be used on the Client's event loop.
+     */
+    class ProxyHandler : public HTTPRequestHandler {
+    public:
+      typedef enum {
+        BALANCE_ROUND_ROBIN,
+        BALANCE_LEAST_CONNECTIONS,
+      } balance_t;
+
+      struct Upstream : public RefCounted {
+        URI uri;
+        unsigned active = 0;
+        unsigned failures = 0;
+        uint64_t requests = 0;
+        double downUntil = 0;
+        bool healthy = true; ///< Result of the last health check
+
+        Upstream(const URI &uri) : uri(uri) {}
+
+        bool isUp(double now) const {return healthy && downUntil <= now;}
+      };
+
+      typedef SmartPointer<Upstream> UpstreamPtr;
+
+    protected:
+      class Forward;
+
+      Client &client;
+      balance_t balance;
+      std::vector<UpstreamPtr> upstreams;
+      unsigned next = 0;
+
+      unsigned maxFails = 1;
+      double failTimeout = 10;
+      bool preserveHost = false;
+      unsigned bufferSize = 1 << 20;
+
+      std::string healthPath;
+      SmartPointer<Event> healthEvent;
+
+    public:
+      ProxyHandler(Client &client, balance_t balance = BALANCE_ROUND_ROBIN);
+      ~ProxyHandler();
+
+      Client &getClient() const {return client;}
+      balance_t getBalance() const {return balance;}
+
+      /**
+       * @param uri The scheme, host and port of the upstream.  A path,
+       *   other than "/", is prefixed to each request's path.
+       */
+      void addUpstream(const URI &uri);
+      const std::vector<UpstreamPtr> &getUpstreams() const {return upstreams;}
+
+      unsigned getMaxFails() const {return maxFails;}
+      void setMaxFails(unsigned x) {maxFails = x ? x : 1;}
+      double getFailTimeout() const {return failTimeout;}
+      void setFailTimeout(double x) {failTimeout = x;}
+
+      bool getPreserveHost() const {return preserveHost;}
+      /// Send the client's Host header rather than the upstream's
+      void setPreserveHost(bool x) {preserveHost = x;}
+
+      unsigned getBufferSize() const {return bufferSize;}
+      /**
+       * Pause the upstream once this many bytes are waiting to be written to
+       * a client whose connection has no write watermarks of its own.
+       */
+      void setBufferSize(unsigned x) {bufferSize = x;}
+
+      /**
+       * GET @param path on each upstream every @param interval seconds.
+       * Upstreams are skipped until their check returns a 2xx status.
+       */
+      void setHealthCheck(const std::string &path, double interval = 5);
+      void checkHealth();
+
+      /// @return An upstream which is up or null if there is none
+      Upstream *select(const Upstream *exclude = 0);
+      URI getUpstreamURI(const Upstream &upstream, const Request &req) const;
+
+      static bool isHopByHop(const std::string &header);
+      static bool isIdempotent(RequestMethod method);
+
+      // From HTTPRequestHandler
+      bool operator()(Request &req);
+
+    protected:
+      void forward(const SmartPointer<Request> &req, unsigned attempt,
+                   const Upstream *exclude);
+      void complete(Upstream &upstream, bool failed);
+    };
+  }
+}
@@ -0,0 +1,169 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "RateLimitHandler.h"
+#include "Request.h"
+
+#include <cbang/String.h>
+#include <cbang/log/Logger.h>
+#include <cbang/os/SpinLock.h>
+#include <cbang/time/Timer.h>
+#include <cbang/util/RateSet.h>
+#include <cbang/util/SmartLock.h>
+
+#include <list>
+#include <unordered_map>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+namespace {
+  const unsigned numShards = 16;
+}
+
+
+struct RateLimitHandler::Shard {
+  struct Bucket {
+    string key;
+    double tokens;
+    double last;
+  };
+
+  typedef list<Bucket> lru_t;
+
+  SpinLock lock;
+  unsigned maxKeys;
+  lru_t lru; // Most recently used first
+  unordered_map<string, lru_t::iterator> index;
+
+  Shard(unsigned maxKeys) : maxKeys(maxKeys) {}
+};
+
+
+RateLimitHandler::RateLimitHandler(double rate, double burst, key_t keyType,
+                                   const string &header, unsigned maxKeys) :
+  rate(rate), burst(burst), keyType(keyType), header(header) {
+  if (rate <= 0) THROW("Invalid rate limit " << rate);
+  if (burst < 1) THROW("Rate limit burst must be at least one");
+  if (keyType == KEY_HEADER && header.empty())
+    THROW("Rate limit header not set");
+
+  unsigned shardKeys = max(1U, (maxKeys + numShards - 1) / numShards);
+  for (unsigned i = 0; i < numShards; i++)
+    shards.push_back(new Shard(shardKeys));
+}
+
+
+RateLimitHandler::~RateLimitHandler() {}
+
+
+unsigned RateLimitHandler::getKeyCount() const {
+  unsigned count = 0;
+
+  for (unsigned i = 0; i < shards.size(); i++) {
+    SmartLock guard(&shards[i]->lock);
+    count += shards[i]->lru.size();
+  }
+
+  return count;
+}
+
+
+string RateLimitHandler::getKey(const Request &req) const {
+  switch (keyType) {
+  case KEY_USER:
+    if (req.getSession().isSet() && req.getSession()->hasUser())
+      return "user:" + req.getUser();
+    break;
+
+  case KEY_HEADER:
+    if (req.inHas(header)) return "header:" + req.inGet(header);
+    break;
+
+  default: break;
+  }
+
+  return req.getClientIP().getHost();
+}
+
+
+double RateLimitHandler::take(const string &key, double now) {
+  Shard &shard = *shards[hash<string>()(key) % shards.size()];
+  SmartLock guard(&shard.lock);
+
+  auto it = shard.index.find(key);
+
+  if (it == shard.index.end()) {
+    if (shard.maxKeys <= shard.lru.size()) {
+      shard.index.erase(shard.lru.back().key);
+      shard.lru.pop_back();
+    }
+
+    shard.lru.push_front(Shard::Bucket{key, burst, now});
+    shard.index[key] = shard.lru.begin();
+
+  } else shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+
+  Shard::Bucket &bucket = shard.lru.front();
+
+  // Refill
+  if (bucket.last < now)
+    bucket.tokens = min(burst, bucket.tokens + (now - bucket.last) * rate);
+  bucket.last = now;
+
+  if (1 <= bucket.tokens) {
+    bucket.tokens -= 1;
+    return 0;
+  }
+
+  return (1 - bucket.tokens) / rate;
+}
+
+
+bool RateLimitHandler::operator()(Request &req) {
+  string key = getKey(req);
+  double retry = take(key, Timer::now());
+  if (!retry) return false;
+
+  LOG_DEBUG(3, "Rate limited " << key << " for " << retry << " sec");
+  if (stats.isSet()) stats->event("ratelimited");
+
+  req.outSet("Retry-After", String((uint64_t)ceil(retry)));
+  req.reply(HTTP_TOO_MANY_REQUESTS);
+
+  return true;
+}
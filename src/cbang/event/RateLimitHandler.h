@@ -0,0 +1,108 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "HTTPRequestHandler.h"
+
+#include <cbang/SmartPointer.h>
+
+#include <string>
+#include <vector>
+
+
+namespace cb {
+  class RateSet;
+
+  namespace Event {
+    class Request;
+
+    /**
+     * Limits each client to an average number of requests per second with
+     * a token bucket per key.  Requests over the limit are answered with
+     * 429 Too Many Requests and a Retry-After header.  Allowed requests
+     * fall through to the next handler.
+     *
+     * Buckets are kept in a fixed number of independently locked shards.
+     * When a shard is full its least recently used bucket is evicted.
+     */
+    class RateLimitHandler : public HTTPRequestHandler {
+    public:
+      typedef enum {
+        KEY_CLIENT_IP,
+        KEY_USER,   ///< Unauthenticated requests are keyed by client IP
+        KEY_HEADER, ///< Requests without the header are keyed by client IP
+      } key_t;
+
+    protected:
+      struct Shard;
+
+      double rate;
+      double burst;
+      key_t keyType;
+      std::string header;
+      std::vector<SmartPointer<Shard> > shards;
+      SmartPointer<RateSet> stats;
+
+    public:
+      /**
+       * @param rate Requests per second allowed on average.
+       * @param burst The number of requests allowed at once.
+       * @param maxKeys The number of keys to track before evicting.
+       */
+      RateLimitHandler(double rate, double burst, key_t keyType = KEY_CLIENT_IP,
+                       const std::string &header = std::string(),
+                       unsigned maxKeys = 64 * 1024);
+      ~RateLimitHandler();
+
+      double getRate() const {return rate;}
+      double getBurst() const {return burst;}
+      unsigned getKeyCount() const;
+
+      /// Limited requests are counted as "ratelimited" events
+      void setStats(const SmartPointer<RateSet> &stats) {this->stats = stats;}
+      const SmartPointer<RateSet> &getStats() const {return stats;}
+
+      std::string getKey(const Request &req) const;
+
+      /**
+       * Take a token from @param key's bucket.
+       * @return Zero if allowed, otherwise the seconds until the next
+       *   token is available.
+       */
+      double take(const std::string &key, double now);
+
+      // From HTTPRequestHandler
+      bool operator()(Request &req);
+    };
+  }
+}
@@ -35,6 +35,9 @@
 #include "Connection.h"
 #include "Event.h"
 #include "HTTP.h"
+#include "HTTP2Session.h"
+#include "JSONBufferWriter.h"
+#include "IOUring.h"
 
 #include <cbang/Exception.h>
 #include <cbang/Catch.h>
@@ -43,11 +46,25 @@
 #include <cbang/http/Cookie.h>
 #include <cbang/json/JSON.h>
 #include <cbang/time/Time.h>
+#include <cbang/time/Timer.h>
+#include <cbang/os/SystemUtilities.h>
+#include <cbang/os/SysError.h>
+#include <cbang/iostream/ZstdCompressor.h>
 
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
 #include <boost/iostreams/filter/zlib.hpp>
 #include <boost/iostreams/filter/bzip2.hpp>
+
+#include <algorithm>
+
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 namespace io = boost::iostreams;
 
 using namespace cb::Event;
@@ -56,23 +73,119 @@ using namespace std;
 
 
 namespace {
+  // Reads the next chunk of a file through an IOUring while the last is sent
+  struct FileReadAhead : public RefCounted {
+    IOUring &ring;
+    int fd;
+    uint64_t offset;
+    uint64_t remaining;
+    vector<char> buffer;
+    int result = 0;
+    bool pending = false;
+
+    FileReadAhead(IOUring &ring, const string &path, uint64_t offset,
+                  uint64_t length, unsigned chunkSize) :
+      ring(ring), fd(open(path.c_str(), O_RDONLY)), offset(offset),
+      remaining(length), buffer(chunkSize) {
+      if (fd == -1) THROW("Failed to open file " << path);
+    }
+
+    ~FileReadAhead() {close(fd);}
+
+
+    static void read(const SmartPointer<FileReadAhead> &self) {
+      unsigned length = min((uint64_t)self->buffer.size(), self->remaining);
+
+      self->pending = true;
+      self->ring.read(self->fd, &self->buffer[0], length, self->offset,
+                      [self] (int result) {
+                        self->pending = false;
+                        self->result = result;
+                        if (result <= 0) return;
+                        self->offset += result;
+                        self->remaining -= result;
+                      });
+    }
+  };
+
+
+  // Error bodies without a custom message are formatted once per status
+  class ErrorPages {
+    vector<string> pages;
+
+  public:
+    ErrorPages() : pages(600) {
+      for (unsigned i = 0; i < HTTPStatus::getCount(); i++) {
+        unsigned code = HTTPStatus::getValue(i);
+        if (code < pages.size())
+          pages[code] = format((HTTPStatus::enum_t)code);
+      }
+    }
+
+
+    static const ErrorPages &instance() {
+      static ErrorPages pages;
+      return pages;
+    }
+
+
+    static string format(HTTPStatus code) {
+      string msg = String((int)code) + " " + code.getDescription();
+      return "<html><head><title>" + msg + "</title></head><body><h1>" +
+        msg + "</h1></body></html>";
+    }
+
+
+    void send(Request &req, HTTPStatus code) const {
+      if (code < pages.size() && !pages[code].empty()) req.send(pages[code]);
+      else req.send(format(code));
+    }
+  };
+
+
   struct FilteringOStreamWithRef : public io::filtering_ostream {
     SmartPointer<ostream> ref;
     virtual ~FilteringOStreamWithRef() {reset();}
   };
 
 
+  bool pushCompressor(io::filtering_ostream &out,
+                      Request::compression_t compression, int level) {
+    switch (compression) {
+    case Request::COMPRESS_ZLIB:
+      out.push(io::zlib_compressor(level < 0 ? io::zlib::default_compression :
+                                   level));
+      return true;
+
+    case Request::COMPRESS_GZIP:
+      out.push(io::gzip_compressor(level < 0 ? io::zlib::default_compression :
+                                   level));
+      return true;
+
+    case Request::COMPRESS_BZIP2:
+      out.push(io::bzip2_compressor(level < 1 ? io::bzip2::default_block_size :
+                                    std::min(level, 9)));
+      return true;
+
+#ifdef HAVE_ZSTD
+    case Request::COMPRESS_ZSTD:
+      out.push(ZstdCompressor(level < 0 ? ZSTD_CLEVEL_DEFAULT : level));
+      return true;
+#else
+    case Request::COMPRESS_ZSTD: THROW("Not built with zstd support");
+#endif
+
+    default: return false;
+    }
+  }
+
+
   SmartPointer<ostream> compressBufferStream
-  (cb::Event::Buffer buffer, Request::compression_t compression) {
+  (cb::Event::Buffer buffer, Request::compression_t compression, int level) {
     SmartPointer<ostream> target = new BufferStream<>(buffer);
     SmartPointer<FilteringOStreamWithRef> out = new FilteringOStreamWithRef;
 
-    switch (compression) {
-    case Request::COMPRESS_ZLIB:  out->push(io::zlib_compressor()); break;
-    case Request::COMPRESS_GZIP:  out->push(io::gzip_compressor()); break;
-    case Request::COMPRESS_BZIP2: out->push(io::bzip2_compressor()); break;
-    default: return target;
-    }
+    if (!pushCompressor(*out, compression, level)) return target;
 
     out->ref = target;
     out->push(*target);
@@ -86,24 +199,28 @@ namespace {
     case Request::COMPRESS_ZLIB:  return "zlib";
     case Request::COMPRESS_GZIP:  return "gzip";
     case Request::COMPRESS_BZIP2: return "bzip2";
+    case Request::COMPRESS_ZSTD:  return "zstd";
     default: return 0;
     }
   }
 
 
-  struct JSONWriter :
-    cb::Event::Buffer, SmartPointer<ostream>, public JSON::Writer {
+  template <class Writer_T>
+  struct RequestWriter :
+    cb::Event::Buffer, SmartPointer<ostream>, public Writer_T {
     SmartPointer<Request> req;
     bool closed = false;
 
-    JSONWriter(const SmartPointer<Request> &req, unsigned indent, bool compact,
-               Request::compression_t compression) :
-      SmartPointer<ostream>(compressBufferStream(*this, compression)),
-      JSON::Writer(*SmartPointer<ostream>::get(), indent, compact), req(req) {
+    template <typename... Args>
+    RequestWriter(const SmartPointer<Request> &req,
+                  Request::compression_t compression, Args... args) :
+      SmartPointer<ostream>(compressBufferStream
+                            (*this, compression, req->getCompressionLevel())),
+      Writer_T(*SmartPointer<ostream>::get(), args...), req(req) {
       req->outSetContentEncoding(compression);
     }
 
-    ~JSONWriter() {TRY_CATCH_ERROR(close(););}
+    ~RequestWriter() {TRY_CATCH_ERROR(close(););}
 
     ostream &getStream() {return *SmartPointer<ostream>::get();}
     unsigned getID() {return req->getID();}
@@ -112,7 +229,7 @@ namespace {
     void close() {
       if (closed) return;
       closed = true;
-      JSON::Writer::close();
+      Writer_T::close();
       SmartPointer<ostream>::get()->flush();
       if (!getLength()) req->outRemove("Content-Type");
       send(*this);
@@ -120,6 +237,90 @@ namespace {
 
     virtual void send(cb::Event::Buffer &buffer) {req->send(buffer);}
   };
+
+
+  struct JSONWriter : public RequestWriter<JSON::Writer> {
+    JSONWriter(const SmartPointer<Request> &req, unsigned indent, bool compact,
+               Request::compression_t compression) :
+      RequestWriter<JSON::Writer>(req, compression, indent, compact) {}
+  };
+
+
+  typedef RequestWriter<JSON::CBORWriter> CBORWriter;
+
+
+  struct DirectJSONWriter : cb::Event::Buffer, public JSONBufferWriter {
+    SmartPointer<Request> req;
+    bool closed = false;
+
+    DirectJSONWriter(const SmartPointer<Request> &req, unsigned indent,
+                     bool compact) :
+      JSONBufferWriter(*this, indent, compact), req(req) {}
+
+    ~DirectJSONWriter() {TRY_CATCH_ERROR(close(););}
+
+    // From JSON::NullSink
+    void close() {
+      if (closed) return;
+      closed = true;
+      JSONBufferWriter::close();
+      if (!getLength()) req->outRemove("Content-Type");
+      req->send(*this);
+    }
+  };
+
+
+  class ChunkSink {
+    SmartPointer<Request> req;
+    cb::Event::Buffer buffer;
+    unsigned chunkSize;
+    double latency;
+    double lastFlush;
+
+  public:
+    typedef char char_type;
+    struct category : io::sink_tag, io::closable_tag, io::flushable_tag {};
+
+    ChunkSink(const SmartPointer<Request> &req, unsigned chunkSize,
+              double latency) :
+      req(req), chunkSize(chunkSize), latency(latency),
+      lastFlush(Timer::now()) {}
+
+    streamsize write(const char *s, streamsize n) {
+      buffer.add(s, n);
+
+      if (chunkSize <= buffer.getLength() ||
+          (latency && lastFlush + latency <= Timer::now())) flush();
+
+      return n;
+    }
+
+    bool flush() {
+      // Never send an empty chunk, it would end the reply
+      if (buffer.getLength()) req->sendChunk(buffer);
+      lastFlush = Timer::now();
+      return true;
+    }
+
+    void close() {flush();}
+  };
+
+
+  struct ChunkedStream : public io::filtering_ostream {
+    SmartPointer<Request> req;
+    bool end;
+
+    ChunkedStream(const SmartPointer<Request> &req,
+                  Request::compression_t compression, unsigned chunkSize,
+                  double latency, bool end) : req(req), end(end) {
+      pushCompressor(*this, compression, req->getCompressionLevel());
+      push(ChunkSink(req, chunkSize, latency));
+    }
+
+    ~ChunkedStream() {
+      TRY_CATCH_ERROR(reset(); if (end && req->isChunked()) req->endChunked());
+    }
+  };
 }
 
 
@@ -129,6 +330,7 @@ namespace {
 
 Request::Request(RequestMethod method, const URI &uri, const Version &version) :
   method(method), originalURI(uri), uri(uri), version(version),
+  startTime(Timer::now()), startNS(Timer::monotonicNS()),
   args(new JSON::Dict) {
   LOG_DEBUG(4, "created");
 }
@@ -189,10 +391,26 @@ SSL Request::getSSL() const {return connection->getSSL();}
 void Request::resetOutput() {getOutputBuffer().clear();}
 
 
+void Request::setArena(const SmartPointer<JSON::Arena> &arena) {
+  if (args->size()) THROW("Cannot set arena after adding arguments");
+  this->arena = arena;
+  args = arena.isSet() ? arena->createDict() : new JSON::Dict;
+}
+
+
 const JSON::ValuePtr &Request::parseJSONArgs() {
   Headers &hdrs = getInputHeaders();
 
-  if (hdrs.hasContentType() &&
+  if (isCBORInput()) {
+    string input = getInputBuffer().toString();
+    JSON::CBORReader reader(input);
+
+    if (input.length() && reader.isDict()) {
+      JSON::Builder builder(arena, args);
+      reader.parseDict(builder);
+    }
+
+  } else if (hdrs.hasContentType() &&
       String::startsWith(hdrs.getContentType(), "application/json")) {
 
     Buffer buf = getInputBuffer();
@@ -202,7 +420,7 @@ const JSON::ValuePtr &Request::parseJSONArgs() {
 
       // Find start of dict & parse keys into request args
       if (reader.next() == '{') {
-        JSON::Builder builder(args);
+        JSON::Builder builder(arena, args);
         reader.parseDict(builder);
       }
     }
@@ -235,12 +453,12 @@ bool Request::inHas(const string &name) const {
 }
 
 
-string Request::inFind(const string &name) const {
+const string &Request::inFind(const string &name) const {
   return getInputHeaders().find(name);
 }
 
 
-string Request::inGet(const string &name) const {
+const string &Request::inGet(const string &name) const {
   return getInputHeaders().get(name);
 }
 
@@ -258,12 +476,12 @@ bool Request::outHas(const string &name) const {
 }
 
 
-string Request::outFind(const string &name) const {
+const string &Request::outFind(const string &name) const {
   return getOutputHeaders().find(name);
 }
 
 
-string Request::outGet(const string &name) const {
+const string &Request::outGet(const string &name) const {
   return getOutputHeaders().get(name);
 }
 
@@ -273,6 +491,11 @@ void Request::outSet(const string &name, const string &value) {
 }
 
 
+void Request::outSet(const string &name, string &&value) {
+  getOutputHeaders().insert(name, move(value));
+}
+
+
 void Request::outRemove(const string &name) {
   getOutputHeaders().remove(name);
 }
@@ -289,7 +512,8 @@ void Request::setPersistent(bool x) {
 
 
 void Request::setCache(uint32_t age) {
-  string now = Time(Time::httpFormat).toString();
+  string now = connection.isSet() ?
+    connection->getBase().getHTTPDate() : Time(Time::httpFormat).toString();
 
   outSet("Date", now);
 
@@ -304,6 +528,118 @@ void Request::setCache(uint32_t age) {
 }
 
 
+bool Request::checkNotModified(const string &etag, uint64_t modified) {
+  string lastModified;
+
+  if (!etag.empty()) outSet("ETag", etag);
+  if (modified) {
+    lastModified = Time(modified, Time::httpFormat).toString();
+    outSet("Last-Modified", lastModified);
+  }
+
+  if (method != HTTP_GET && method != HTTP_HEAD) return false;
+
+  bool notModified = false;
+
+  // If-None-Match takes precedence over If-Modified-Since
+  if (inHas("If-None-Match")) {
+    if (etag.empty()) return false;
+
+    // Weak comparison
+    auto strip = [] (const string &tag) {
+      return String::startsWith(tag, "W/") ? tag.substr(2) : tag;
+    };
+
+    vector<string> tags;
+    String::tokenize(inGet("If-None-Match"), tags, ", \t");
+
+    for (unsigned i = 0; i < tags.size() && !notModified; i++)
+      notModified = tags[i] == "*" || strip(tags[i]) == strip(etag);
+
+  } else if (modified && inHas("If-Modified-Since"))
+    try {
+      notModified =
+        modified <= Time::parse(inGet("If-Modified-Since"), Time::httpFormat);
+    } catch (const Exception &e) {} // Invalid dates are ignored
+
+  if (notModified) reply(HTTP_NOT_MODIFIED);
+
+  return notModified;
+}
+
+
+HTTPStatus Request::getRange(uint64_t size, uint64_t &offset,
+                             uint64_t &length) {
+  offset = 0;
+  length = size;
+  outSet("Accept-Ranges", "bytes");
+
+  if (method != HTTP_GET || !inHas("Range")) return HTTP_OK;
+
+  // The client's copy is stale, send the whole entity
+  if (inHas("If-Range")) {
+    string ifRange = String::trim(inGet("If-Range"));
+
+    if (ifRange.empty() || ifRange[0] == '"' || ifRange[0] == 'W') {
+      // Strong comparison
+      string etag = outFind("ETag");
+      if (etag.empty() || String::startsWith(etag, "W/") || ifRange != etag)
+        return HTTP_OK;
+
+    } else if (ifRange != outFind("Last-Modified")) return HTTP_OK;
+  }
+
+  string range = String::trim(inGet("Range"));
+  if (!String::startsWith(range, "bytes=")) return HTTP_OK;
+  range = range.substr(6);
+
+  // Multiple ranges are not supported, send the whole entity
+  size_t dash = range.find('-');
+  if (range.find(',') != string::npos || dash == string::npos) return HTTP_OK;
+
+  string first = String::trim(range.substr(0, dash));
+  string last = String::trim(range.substr(dash + 1));
+  uint64_t start;
+  uint64_t end;
+
+  try {
+    if (first.empty()) {
+      // Suffix range
+      if (last.empty()) return HTTP_OK;
+      uint64_t suffix = String::parseU64(last, true);
+      start = suffix < size ? size - suffix : 0;
+      if (!suffix) start = size; // Not satisfiable
+
+      end = size;
+
+    } else {
+      start = String::parseU64(first, true);
+      end = size;
+
+      if (!last.empty()) {
+        uint64_t lastByte = String::parseU64(last, true);
+        if (lastByte < start) return HTTP_OK;
+        if (lastByte < size) end = lastByte + 1;
+      }
+    }
+
+  } catch (const Exception &e) {return HTTP_OK;} // Invalid ranges are ignored
+
+  if (size <= start) {
+    offset = length = 0;
+    outSet("Content-Range", "bytes */" + String(size));
+    return HTTP_REQUESTED_RANGE_NOT_SATISFIABLE;
+  }
+
+  offset = start;
+  length = end - start;
+  outSet("Content-Range", "bytes " + String(start) + "-" + String(end - 1) +
+         "/" + String(size));
+
+  return HTTP_PARTIAL_CONTENT;
+}
+
+
 bool Request::hasContentType() const {
   return getOutputHeaders().hasContentType();
 }
@@ -329,6 +665,7 @@ void Request::outSetContentEncoding(compression_t compression) {
   case COMPRESS_ZLIB:
   case COMPRESS_GZIP:
   case COMPRESS_BZIP2:
+  case COMPRESS_ZSTD:
     outSet("Content-Encoding", getContentEncoding(compression));
     break;
   default: break;
@@ -370,7 +707,16 @@ Request::compression_t Request::getRequestedCompression() const {
       else if (name == "gzip")  compression = COMPRESS_GZIP;
       else if (name == "zlib")  compression = COMPRESS_ZLIB;
       else if (name == "bzip2") compression = COMPRESS_BZIP2;
+#ifdef HAVE_ZSTD
+      else if (name == "zstd")  compression = COMPRESS_ZSTD;
+#endif
       else q = 0;
+
+#ifdef HAVE_ZSTD
+    } else if (q && q == maxQ && name == "zstd") {
+      // Prefer zstd over other codings with the same quality
+      if (compression != COMPRESS_NONE) compression = COMPRESS_ZSTD;
+#endif
     }
 
     if (maxQ < q) maxQ = q;
@@ -386,6 +732,74 @@ Request::compression_t Request::getRequestedCompression() const {
 }
 
 
+bool Request::acceptsEncoding(const string &coding) const {
+  if (!inHas("Accept-Encoding")) return false;
+
+  vector<string> accept;
+  String::tokenize(inGet("Accept-Encoding"), accept, ",");
+
+  double q = 0;
+  bool found = false;
+
+  for (unsigned i = 0; i < accept.size(); i++) {
+    string name = String::toLower(String::trim(accept[i]));
+    double quality = 1;
+
+    // Check for quality value
+    size_t pos = name.find_first_of(';');
+    if (pos != string::npos) {
+      string arg = String::trim(name.substr(pos + 1));
+      name = String::trim(name.substr(0, pos));
+
+      if (2 < arg.length() && arg[0] == 'q' && arg[1] == '=')
+        try {
+          quality = String::parseDouble(arg.substr(2));
+        } catch (const Exception &e) {quality = 0;}
+    }
+
+    // An explicit entry overrides the wildcard
+    if (name == coding) {q = quality; found = true;}
+    else if (name == "*" && !found) q = quality;
+  }
+
+  return 0 < q;
+}
+
+
+bool Request::acceptsType(const string &type) const {
+  if (!inHas("Accept")) return false;
+
+  vector<string> accept;
+  String::tokenize(inGet("Accept"), accept, ",");
+
+  // Only an explicit entry counts, wildcards are ignored
+  for (unsigned i = 0; i < accept.size(); i++) {
+    string name = String::toLower(String::trim(accept[i]));
+    size_t pos = name.find_first_of(';');
+
+    if (String::trim(name.substr(0, pos)) != type) continue;
+    if (pos == string::npos) return true;
+
+    string arg = String::trim(name.substr(pos + 1));
+    if (2 < arg.length() && arg[0] == 'q' && arg[1] == '=')
+      try {
+        return 0 < String::parseDouble(arg.substr(2));
+      } catch (const Exception &e) {return false;}
+
+    return true;
+  }
+
+  return false;
+}
+
+
+bool Request::isCBORInput() const {
+  const Headers &hdrs = getInputHeaders();
+  return hdrs.hasContentType() &&
+    String::startsWith(hdrs.getContentType(), "application/cbor");
+}
+
+
 bool Request::hasCookie(const string &name) const {
   if (!inHas("Cookie")) return false;
 
@@ -436,31 +850,66 @@ string Request::getInput() const {return getInputBuffer().toString();}
 string Request::getOutput() const {return getOutputBuffer().toString();}
 
 
-SmartPointer<JSON::Value> Request::getInputJSON() const {
+SmartPointer<JSON::Value>
+Request::getInputJSON(const SmartPointer<JSON::Schema> &schema) const {
+  Buffer buf = getInputBuffer();
+
+  if (!buf.getLength()) {
+    if (schema.isSet()) JSON::SchemaValidator(*schema).writeNull();
+    return 0;
+  }
+
+  JSON::Builder builder(arena);
+  SmartPointer<JSON::Sink> sink = SmartPointer<JSON::Sink>::Phony(&builder);
+
+  // Validate before each part reaches the Builder
+  if (schema.isSet()) sink = new JSON::SchemaValidator(*schema, sink);
+
+  if (isCBORInput())
+    JSON::CBORReader::parse(buf.pullup(), buf.getLength(), *sink);
+
+  else {
+    BufferStream<> stream(buf);
+    JSON::Reader(stream).parse(*sink);
+  }
+
+  return builder.getRoot();
+}
+
+
+SmartPointer<JSON::View> Request::getInputJSONView() const {
   Buffer buf = getInputBuffer();
   if (!buf.getLength()) return 0;
-  BufferStream<> stream(buf);
-  return JSON::Reader(stream).parse();
+
+  if (isCBORInput()) return new JSON::View(getInputJSON());
+
+  return new JSON::View(buf.pullup(), buf.getLength());
 }
 
 
-SmartPointer<JSON::Value> Request::getJSONMessage() const {
+SmartPointer<JSON::Value>
+Request::getJSONMessage(const SmartPointer<JSON::Schema> &schema) const {
   const Headers &hdrs = getInputHeaders();
 
-  if (hdrs.hasContentType() &&
-      String::startsWith(hdrs.getContentType(), "application/json"))
-    return getInputJSON();
+  if (isCBORInput() || (hdrs.hasContentType() &&
+      String::startsWith(hdrs.getContentType(), "application/json")))
+    return getInputJSON(schema);
 
   SmartPointer<JSON::Value> msg;
   const URI &uri = getURI();
 
   if (!uri.empty()) {
-    msg = new JSON::Dict;
+    msg = arena.isSet() ? arena->createDict() : new JSON::Dict;
 
     for (URI::const_iterator it = uri.begin(); it != uri.end(); it++)
       msg->insert(it->first, it->second);
   }
 
+  if (schema.isSet()) {
+    if (msg.isNull()) JSON::SchemaValidator(*schema).writeNull();
+    else schema->validate(*msg);
+  }
+
   return msg;
 }
 
@@ -471,7 +920,12 @@ Request::getJSONWriter(unsigned indent, bool compact,
   resetOutput();
   setContentType("application/json");
 
-  return new JSONWriter(this, indent, compact, compression);
+  switch (compression) {
+  case COMPRESS_ZLIB: case COMPRESS_GZIP: case COMPRESS_BZIP2:
+  case COMPRESS_ZSTD:
+    return new JSONWriter(this, indent, compact, compression);
+  default: return new DirectJSONWriter(this, indent, compact);
+  }
 }
 
 
@@ -501,6 +955,21 @@ SmartPointer<JSON::Writer> Request::getJSONPWriter(const string &callback) {
 }
 
 
+SmartPointer<JSON::CBORWriter>
+Request::getCBORWriter(compression_t compression) {
+  resetOutput();
+  setContentType("application/cbor");
+
+  return new CBORWriter(this, compression);
+}
+
+
+SmartPointer<JSON::NullSink> Request::getJSONSink(compression_t compression) {
+  if (acceptsType("application/cbor")) return getCBORWriter(compression);
+  return getJSONWriter(compression);
+}
+
+
 SmartPointer<istream> Request::getInputStream() const {
   return new BufferStream<>(getInputBuffer());
 }
@@ -510,7 +979,8 @@ SmartPointer<ostream> Request::getOutputStream(compression_t compression) {
   // Auto select compression type based on Accept-Encoding
   if (compression == COMPRESS_AUTO) compression = getRequestedCompression();
   outSetContentEncoding(compression);
-  return compressBufferStream(getOutputBuffer(), compression);
+  return compressBufferStream(getOutputBuffer(), compression,
+                              compressionLevel);
 }
 
 
@@ -521,10 +991,7 @@ void Request::sendError(HTTPStatus code) {
   outSet("Connection", "close");
 
   if (!code) code = HTTP_INTERNAL_SERVER_ERROR;
-  string msg = String((int)code) + " " + code.getDescription();
-
-  send(SSTR("<html><head><title>" << msg << "</title></head><body><h1>"
-            << msg << "</h1></body></html>"));
+  ErrorPages::instance().send(*this, code);
 
   reply(code);
 }
@@ -569,12 +1036,22 @@ void Request::sendError(const exception &e) {
 
 
 void Request::sendJSONError(HTTPStatus code, const string &message) {
-  auto writer = getJSONWriter();
+  if (message.empty()) {
+    resetOutput();
+    setContentType("application/json");
+    // Same as the JSON::Writer output
+    static const char *compact = "{\"error\":\"\"}";
+    static const char *pretty = "{\n  \"error\": \"\"\n}";
+    send(getURI().has("pretty") ? pretty : compact);
 
-  writer->beginDict();
-  writer->insert("error", message);
-  writer->endDict();
-  writer->close();
+  } else {
+    auto writer = getJSONWriter();
+
+    writer->beginDict();
+    writer->insert("error", message);
+    writer->endDict();
+    writer->close();
+  }
 
   if (!code) code = HTTP_INTERNAL_SERVER_ERROR;
   reply(code);
@@ -591,6 +1068,7 @@ void Request::send(const char *data, unsigned length) {
 
 void Request::send(const char *s) {getOutputBuffer().add(s);}
 void Request::send(const string &s) {getOutputBuffer().add(s);}
+void Request::send(string &&s) {getOutputBuffer().add(move(s));}
 void Request::sendFile(const string &path) {getOutputBuffer().addFile(path);}
 
 
@@ -605,6 +1083,12 @@ void Request::reply(HTTPStatus code) {
   LOG_DEBUG(5, getResponseLine() << '\n' << getOutputHeaders() << '\n');
   LOG_DEBUG(6, getOutputBuffer().hexdump() << '\n');
 
+  if (replyCB) {
+    reply_cb_t cb;
+    swap(cb, replyCB);
+    TRY_CATCH_ERROR(cb(*this));
+  }
+
   write();
 }
 
@@ -622,6 +1106,64 @@ void Request::reply(HTTPStatus code, const char *data, unsigned length) {
 }
 
 
+void Request::replyStream(HTTPStatus code, uint64_t length, stream_cb_t cb) {
+  if (outputBuffer.getLength())
+    THROW("Cannot stream reply with data in output buffer");
+
+  outSet("Content-Length", String(length));
+  if (length && mustHaveBody()) streamCB = cb;
+  reply(code);
+}
+
+
+void Request::replyFile(const string &path, HTTPStatus code, uint64_t offset,
+                        int64_t length) {
+  uint64_t size = SystemUtilities::getFileSize(path);
+  if (size < offset) offset = size;
+  if (length < 0 || size < offset + length) length = size - offset;
+
+  if (!isSecure())
+    // Add the whole file to the sendfile capable output buffer
+    return replyStream(code, length, [path, offset, length] (Buffer &out) {
+        out.addFile(path, offset, length);
+        return false;
+      });
+
+  // SSL data must pass through user space, read in bounded chunks
+  const unsigned chunkSize = 1 << 18;
+
+  if (length && connection->getBase().hasIOURing()) {
+    SmartPointer<FileReadAhead> reader =
+      new FileReadAhead(connection->getBase().getIOURing(), path, offset,
+                        length, chunkSize);
+    FileReadAhead::read(reader);
+
+    return replyStream(code, length, [reader] (Buffer &out) {
+        while (reader->pending) reader->ring.wait();
+        if (reader->result <= 0)
+          THROW("Failed to read file: " << SysError(-reader->result));
+
+        out.add(&reader->buffer[0], reader->result);
+
+        bool more = 0 < reader->remaining;
+        if (more) FileReadAhead::read(reader);
+        return more;
+      });
+  }
+
+  SmartPointer<istream> in = SystemUtilities::iopen(path);
+  in->seekg(offset);
+  uint64_t remaining = length;
+
+  replyStream(code, length, [in, remaining] (Buffer &out) mutable {
+      unsigned bytes = out.add(*in, min((uint64_t)chunkSize, remaining));
+      if (!bytes) THROW("Failed to read file");
+      remaining -= bytes;
+      return 0 < remaining;
+    });
+}
+
+
 void Request::startChunked(HTTPStatus code) {
   if (outHas("Content-Length"))
     THROW("Cannot start chunked with Content-Length set");
@@ -637,12 +1179,75 @@ void Request::startChunked(HTTPStatus code) {
 }
 
 
+void Request::replyChunked(HTTPStatus code, stream_cb_t cb,
+                           compression_t compression) {
+  if (compression == COMPRESS_AUTO) compression = getRequestedCompression();
+  outSetContentEncoding(compression);
+
+  Buffer compressed;
+  SmartPointer<ostream> stream =
+    compressBufferStream(compressed, compression, compressionLevel);
+
+  startChunked(code);
+
+  streamCB = [cb, compressed, stream] (Buffer &out) mutable {
+    bool more;
+
+    // The compressor may consume input without producing output
+    do {
+      Buffer raw;
+      more = cb(raw);
+      bool empty = !raw.getLength();
+
+      if (!empty) {
+        SmartPointer<istream> in = new BufferStream<>(raw);
+        *stream << in->rdbuf();
+        stream->flush();
+      }
+
+      if (!more) stream.release(); // Writes the compression trailer
+      else if (empty) break; // Let stream() raise an error
+    } while (!compressed.getLength() && more);
+
+    out.add(compressed); // Framed by stream()
+
+    return more;
+  };
+}
+
+
+SmartPointer<ostream> Request::getChunkedStream(compression_t compression,
+                                                unsigned chunkSize,
+                                                double latency) {
+  if (!chunked) THROW("Not chunked");
+  return new ChunkedStream(this, compression, chunkSize, latency, false);
+}
+
+
+SmartPointer<ostream>
+Request::startChunkedStream(HTTPStatus code, compression_t compression,
+                            unsigned chunkSize, double latency) {
+  if (compression == COMPRESS_AUTO) compression = getRequestedCompression();
+  outSetContentEncoding(compression);
+  startChunked(code);
+
+  return new ChunkedStream(this, compression, chunkSize, latency, true);
+}
+
+
 void Request::sendChunk(const cb::Event::Buffer &buf) {
   if (!chunked) THROW("Not chunked");
 
   LOG_DEBUG(4, "Sending " << buf.getLength() << " byte chunk");
   bool empty = !buf.getLength(); // Must be before add() below
 
+  if (streamID) {
+    // HTTP/2 frames the data itself
+    connection->getHTTP2().writeData(*this, buf, empty);
+    if (empty) chunked = false;
+    return;
+  }
+
   Buffer out;
   out.add(String::printf("%x\r\n", buf.getLength()));
   out.add(buf);
@@ -659,25 +1264,65 @@ void Request::sendChunk(const char *data, unsigned length) {
 }
 
 
-SmartPointer<JSON::Writer> Request::getJSONChunkWriter() {
-  struct Writer : public JSONWriter {
-    Writer(const SmartPointer<Request> &req) :
-      JSONWriter(req, 0, true, COMPRESS_NONE) {}
+SmartPointer<JSON::Writer> Request::getJSONChunkWriter(unsigned chunkSize) {
+  // Send chunks as the JSON is written rather than buffering all of it
+  struct Writer : SmartPointer<ostream>, public JSON::Writer {
+    uint64_t id;
+
+    Writer(const SmartPointer<ostream> &stream, uint64_t id) :
+      SmartPointer<ostream>(stream), JSON::Writer(*stream, 0, true), id(id) {}
 
-    // NOTE, destructor must be duplicated so virtual function call works
     ~Writer() {TRY_CATCH_ERROR(close(););}
 
-    // From JSONWriter
-    void send(Buffer &buffer) {req->sendChunk(buffer);}
+    uint64_t getID() const {return id;}
+
+    // From JSON::NullSink
+    void close() {
+      if (SmartPointer<ostream>::isNull()) return;
+      JSON::Writer::close();
+      SmartPointer<ostream>::release(); // Sends the remaining data
+    }
   };
 
-  return new Writer(this);
+  return new Writer(getChunkedStream(COMPRESS_NONE, chunkSize), getID());
 }
 
 
 void Request::endChunked() {sendChunk(Buffer(""));}
 
 
+bool Request::isWritable() const {
+  return hasConnection() && getConnection().isWritable(*this);
+}
+
+
+void Request::writable() {
+  if (!writableCB || !isWritable()) return;
+
+  writable_cb_t cb;
+  swap(cb, writableCB);
+  cb();
+}
+
+
+void Request::bodyData() {
+  if (!inputBuffer.getLength()) return;
+  onBodyData(inputBuffer);
+  inputBuffer.clear();
+}
+
+
+void Request::complete() {
+  onComplete();
+
+  if (completeCB) {
+    complete_cb_t cb;
+    swap(cb, completeCB);
+    cb();
+  }
+}
+
+
 void Request::redirect(const URI &uri, HTTPStatus code) {
   outSet("Location", uri);
   outSet("Content-Length", "0");
@@ -694,7 +1339,8 @@ void Request::onRequest() {
   LOG_DEBUG(6, inputBuffer.hexdump() << '\n');
 
   if (connection.isSet()) {
-    bytesRead = connection->getHeaderSize() + connection->getBodySize();
+    if (streamID) bytesRead = inputBuffer.getLength();
+    else bytesRead = connection->getHeaderSize() + connection->getBodySize();
 
     if (connection->getHTTP().isSet())
       connection->getHTTP()->handleRequest(*this);
@@ -740,6 +1386,11 @@ void Request::parseResponseLine(const string &line) {
 
 
 void Request::write() {
+  if (streamID) {
+    bytesWritten += outputBuffer.getLength();
+    return connection->getHTTP2().writeResponse(*this);
+  }
+
   Buffer out;
 
   writeHeaders(out);
@@ -750,13 +1401,74 @@ void Request::write() {
 }
 
 
-void Request::writeResponse(cb::Event::Buffer &buf) {
-  buf.add(getResponseLine() + "\r\n");
+bool Request::stream(Buffer &out) {
+  if (!streamCB) return false;
 
-  if (version.getMajor() == 1) {
-    if (1 <= version.getMinor() && !outHas("Date"))
-      outSet("Date", Time("%a, %d %b %Y %H:%M:%S GMT"));
+  unsigned start = out.getLength();
+
+  if (chunked) {
+    Buffer chunk;
+    bool more = streamCB(chunk);
+
+    if (streamID) out.add(chunk); // HTTP/2 frames the data itself
+    else if (chunk.getLength()) {
+      out.add(String::printf("%x\r\n", chunk.getLength()));
+      out.add(chunk);
+      out.add("\r\n");
+    }
+
+    if (!more) {
+      if (!streamID) out.add("0\r\n\r\n"); // Last chunk
+      streamCB = 0;
+      chunked = false;
+    }
+
+  } else if (!streamCB(out)) streamCB = 0;
+
+  unsigned bytes = out.getLength() - start;
+  bytesWritten += bytes;
+
+  if (!bytes && streamCB) THROW("Stream callback produced no data");
+
+  return bytes;
+}
 
+
+void Request::writeResponse(string &header) {
+  prepareResponseHeaders();
+
+  if (version.getMajor() == 1 && version.getMinor() <= 1 &&
+      responseCodeLine.empty()) {
+    // Avoid formatting the common status lines through a stream
+    unsigned code = (unsigned)responseCode % 1000;
+    char line[] = "HTTP/1.x 000 ";
+    line[7] = '0' + version.getMinor();
+    line[9] += code / 100;
+    line[10] += code / 10 % 10;
+    line[11] += code % 10;
+
+    header += line;
+    header += responseCode.getDescription();
+
+  } else header += getResponseLine();
+
+  header += "\r\n";
+
+  // Preformatted once per second by the Base
+  if (1 <= version.getMinor() && !outHas("Date"))
+    header += connection->getBase().getHTTPDateHeader();
+}
+
+
+void Request::prepareResponseHeaders() {
+  if (version.getMajor() == 2) {
+    if (!outHas("Date")) outSet("Date", connection->getBase().getHTTPDate());
+
+    if (mustHaveBody() && !chunked && !streamCB && !outHas("Content-Length"))
+      outSet("Content-Length", String(outputBuffer.getLength()));
+  }
+
+  if (version.getMajor() == 1) {
     // If the protocol is 1.0 and connection was keep-alive add keep-alive
     bool keepAlive = inputHeaders.connectionKeepAlive();
     if (!version.getMinor() && keepAlive) outSet("Connection", "keep-alive");
@@ -776,14 +1488,17 @@ void Request::writeResponse(cb::Event::Buffer &buf) {
     }
   }
 
-  // If request asked for close, send close
-  if (inputHeaders.needsClose()) outSet("Connection", "close");
+  // If request asked for close or the server is draining, send close
+  if (inputHeaders.needsClose() ||
+      (version.getMajor() == 1 && connection->getHTTP().isSet() &&
+       connection->getHTTP()->isDraining()))
+    outSet("Connection", "close");
 }
 
 
-void Request::writeRequest(cb::Event::Buffer &buf) {
+void Request::writeRequest(string &header) {
   // Generate request line
-  buf.add(getRequestLine() + "\r\n");
+  header += getRequestLine() + "\r\n";
 
   // Add the content length on a post or put request if missing
   if ((method == HTTP_POST || method == HTTP_PUT) && !outHas("Content-Length"))
@@ -792,15 +1507,25 @@ void Request::writeRequest(cb::Event::Buffer &buf) {
 
 
 void Request::writeHeaders(cb::Event::Buffer &buf) {
-  if (connection->isIncoming()) writeResponse(buf);
-  else writeRequest(buf);
+  // Serialize the whole header block before copying it to the buffer once
+  string header;
+  header.reserve(512);
+
+  if (connection->isIncoming()) writeResponse(header);
+  else writeRequest(header);
 
   for (auto it = outputHeaders.begin(); it != outputHeaders.end(); it++) {
     const string &key = it->first;
     const string &value = it->second;
-    if (!value.empty())
-      buf.add(String::printf("%s: %s\r\n", key.c_str(), value.c_str()));
+
+    if (!value.empty()) {
+      header += key;
+      header += ": ";
+      header += value;
+      header += "\r\n";
+    }
   }
 
-  buf.add("\r\n");
+  header += "\r\n";
+  buf.add(header);
 }
@@ -35,19 +35,24 @@
 #include "Enum.h"
 #include "Headers.h"
 #include "Buffer.h"
+#include "Trace.h"
 
 #include <cbang/SmartPointer.h>
 #include <cbang/util/Version.h>
 #include <cbang/util/Base.h>
+#include <cbang/util/PoolAllocated.h>
 #include <cbang/net/IPAddress.h>
 #include <cbang/net/URI.h>
 #include <cbang/net/Session.h>
 #include <cbang/json/Value.h>
 #include <cbang/json/Writer.h>
+#include <cbang/json/CBORWriter.h>
+#include <cbang/json/View.h>
 
 #include <string>
 #include <iostream>
 #include <typeinfo>
+#include <functional>
 
 
 namespace cb {
@@ -55,10 +60,24 @@ namespace cb {
   class IPAddress;
   class SSL;
 
+  namespace JSON {
+    class Arena;
+    class Schema;
+  }
+
   namespace Event {
     class Connection;
 
-    class Request : virtual public RefCounted, public Enum {
+    class Request : virtual public RefCounted, public Enum,
+                    public PoolAllocated<Request> {
+    public:
+      /// Add more body data to @param out.  Return false when done.
+      typedef std::function<bool (Buffer &out)> stream_cb_t;
+      typedef std::function<void ()> writable_cb_t;
+      typedef std::function<void (Request &)> reply_cb_t;
+      typedef std::function<void ()> complete_cb_t;
+
+    private:
       Headers inputHeaders;
       Headers outputHeaders;
 
@@ -78,14 +97,27 @@ namespace cb {
       SmartPointer<Session> session;
       std::string user = "anonymous";
 
+      uint32_t streamID = 0;
       bool chunked = false;
       bool replying = false;
+      bool bodyStreaming = false;
+      int compressionLevel = -1;
+      stream_cb_t streamCB;
+      writable_cb_t writableCB;
+      reply_cb_t replyCB;
+      complete_cb_t completeCB;
 
       uint64_t bytesRead = 0;
       uint64_t bytesWritten = 0;
+      double startTime;
+      uint64_t startNS;
+      std::string route;
 
+      SmartPointer<JSON::Arena> arena;
       JSON::ValuePtr args;
 
+      SmartPointer<Trace> trace;
+
     public:
       Request(RequestMethod method = RequestMethod(), const URI &uri = URI(),
               const Version &version = Version(1, 1));
@@ -136,6 +168,10 @@ namespace cb {
       ConnectionError getConnectionError() const {return connError;}
       void setConnectionError(ConnectionError err) {connError = err;}
 
+      /// Non-zero if this Request is an HTTP/2 stream
+      uint32_t getStreamID() const {return streamID;}
+      void setStreamID(uint32_t id) {streamID = id;}
+
       const SmartPointer<Session> &getSession() const {return session;}
       void setSession(const SmartPointer<Session> &session)
       {this->session = session;}
@@ -148,9 +184,33 @@ namespace cb {
 
       bool isChunked() const {return chunked;}
       bool isReplying() const {return replying;}
+      bool isStreaming() const {return (bool)streamCB;}
+
+      bool isBodyStreaming() const {return bodyStreaming;}
+      /**
+       * When enabled, from the constructor or onHeaders(), the body is
+       * passed to onBodyData(), as it arrives and with any chunked encoding
+       * removed, instead of being collected in the input buffer.  The
+       * connection's maximum body size does not apply.
+       */
+      void setBodyStreaming(bool x) {bodyStreaming = x;}
 
       uint64_t getBytesRead() const {return bytesRead;}
       uint64_t getBytesWritten() const {return bytesWritten;}
+      double getStartTime() const {return startTime;}
+      /// Creation time on Timer::monotonicNS(), for measuring latency
+      uint64_t getStartNS() const {return startNS;}
+
+      /// The pattern of the innermost handler which accepted the request
+      const std::string &getRoute() const {return route;}
+      void setRoute(const std::string &route) {this->route = route;}
+
+      /// Set by HTTP on incoming requests which its Tracer sampled
+      const SmartPointer<Trace> &getTrace() const {return trace;}
+      void setTrace(const SmartPointer<Trace> &trace) {this->trace = trace;}
+      void traceStage(const char *name)
+        {if (trace.isSet()) trace->stage(name);}
+      void finishTrace() {if (trace.isSet()) trace->finish(*this);}
 
       bool isSecure() const;
       SSL getSSL() const;
@@ -158,6 +218,13 @@ namespace cb {
       virtual bool isWebsocket() const {return false;}
       virtual void resetOutput();
 
+      const SmartPointer<JSON::Arena> &getArena() const {return arena;}
+      /**
+       * Allocate the request arguments and parsed JSON input from
+       * @param arena.  Must be set before any arguments are added.
+       */
+      void setArena(const SmartPointer<JSON::Arena> &arena);
+
       virtual void appendArg(const std::string &arg)
       {args->insert(String(args->size()), arg);}
       virtual void insertArg(const std::string &key, const std::string &arg)
@@ -178,20 +245,58 @@ namespace cb {
       const IPAddress &getClientIP() const;
 
       bool inHas(const std::string &name) const;
-      std::string inFind(const std::string &name) const;
-      std::string inGet(const std::string &name) const;
+      template <size_t N> bool inHas(const char (&name)[N]) const
+        {return inputHeaders.has(name);}
+      const std::string &inFind(const std::string &name) const;
+      template <size_t N>
+      const std::string &inFind(const char (&name)[N]) const
+        {return inputHeaders.find(name);}
+      const std::string &inGet(const std::string &name) const;
+      template <size_t N>
+      const std::string &inGet(const char (&name)[N]) const
+        {return inputHeaders.get(name);}
       void inSet(const std::string &name, const std::string &value);
       void inRemove(const std::string &name);
 
       bool outHas(const std::string &name) const;
-      std::string outFind(const std::string &name) const;
-      std::string outGet(const std::string &name) const;
+      template <size_t N> bool outHas(const char (&name)[N]) const
+        {return outputHeaders.has(name);}
+      const std::string &outFind(const std::string &name) const;
+      template <size_t N>
+      const std::string &outFind(const char (&name)[N]) const
+        {return outputHeaders.find(name);}
+      const std::string &outGet(const std::string &name) const;
+      template <size_t N>
+      const std::string &outGet(const char (&name)[N]) const
+        {return outputHeaders.get(name);}
       void outSet(const std::string &name, const std::string &value);
+      void outSet(const std::string &name, std::string &&value);
       void outRemove(const std::string &name);
 
       void setPersistent(bool x);
       virtual void setCache(uint32_t age);
 
+      /**
+       * Set the ETag and Last-Modified validators and evaluate the
+       * request's If-None-Match and If-Modified-Since headers.
+       * @param etag A quoted entity tag or empty if there is none.
+       * @param modified Modification time in seconds or zero if unknown.
+       * @return True if the client's copy is current and a
+       *   304 Not Modified reply has been sent.
+       */
+      virtual bool checkNotModified(const std::string &etag,
+                                    uint64_t modified = 0);
+
+      /**
+       * Evaluate the Range and If-Range headers for a body of @param size
+       * bytes.  Only single byte ranges are honored.  Must be called after
+       * checkNotModified() so If-Range can be compared to the validators.
+       * @return HTTP_OK to send the whole body, HTTP_PARTIAL_CONTENT to send
+       *   @param length bytes from @param offset or
+       *   HTTP_REQUESTED_RANGE_NOT_SATISFIABLE.
+       */
+      HTTPStatus getRange(uint64_t size, uint64_t &offset, uint64_t &length);
+
       bool hasContentType() const;
       std::string getContentType() const;
       void setContentType(const std::string &contentType);
@@ -199,11 +304,22 @@ namespace cb {
 
       typedef enum {
         COMPRESS_NONE, COMPRESS_AUTO, COMPRESS_ZLIB, COMPRESS_GZIP,
-        COMPRESS_BZIP2
+        COMPRESS_BZIP2, COMPRESS_ZSTD
       } compression_t;
 
+      int getCompressionLevel() const {return compressionLevel;}
+      /// Level for compressed output, -1 selects each format's default
+      void setCompressionLevel(int level) {compressionLevel = level;}
+
       void outSetContentEncoding(compression_t compression);
+      /// zstd is preferred over gzip at equal quality when available.
       compression_t getRequestedCompression() const;
+      /// True if Accept-Encoding allows the content @param coding.
+      bool acceptsEncoding(const std::string &coding) const;
+      /// True if Accept lists the media type @param type.
+      bool acceptsType(const std::string &type) const;
+      /// True if the input Content-Type is application/cbor.
+      bool isCBORInput() const;
 
       bool hasCookie(const std::string &name) const;
       std::string findCookie(const std::string &name) const;
@@ -217,14 +333,29 @@ namespace cb {
       std::string getInput() const;
       std::string getOutput() const;
 
-      SmartPointer<JSON::Value> getInputJSON() const;
-      SmartPointer<JSON::Value> getJSONMessage() const;
+      /**
+       * With @param schema the input is validated while it is parsed and
+       * an Exception is thrown at the first part which does not match.
+       * Missing input is validated as null.
+       */
+      SmartPointer<JSON::Value>
+      getInputJSON(const SmartPointer<JSON::Schema> &schema = 0) const;
+      /// Index the input but only parse the parts which are selected.
+      SmartPointer<JSON::View> getInputJSONView() const;
+      /// URI arguments are validated against @param schema as strings
+      SmartPointer<JSON::Value>
+      getJSONMessage(const SmartPointer<JSON::Schema> &schema = 0) const;
       SmartPointer<JSON::Writer>
       getJSONWriter(unsigned indent, bool compact,
                     compression_t compression = COMPRESS_AUTO);
       SmartPointer<JSON::Writer>
       getJSONWriter(compression_t compression = COMPRESS_AUTO);
       SmartPointer<JSON::Writer> getJSONPWriter(const std::string &callback);
+      SmartPointer<JSON::CBORWriter>
+      getCBORWriter(compression_t compression = COMPRESS_AUTO);
+      /// CBOR if the client accepts application/cbor, otherwise JSON
+      SmartPointer<JSON::NullSink>
+      getJSONSink(compression_t compression = COMPRESS_AUTO);
 
       SmartPointer<std::istream> getInputStream() const;
       SmartPointer<std::ostream>
@@ -241,6 +372,7 @@ namespace cb {
       virtual void send(const char *data, unsigned length);
       virtual void send(const char *s);
       virtual void send(const std::string &s);
+      virtual void send(std::string &&s);
       virtual void sendFile(const std::string &path);
 
       virtual void reply(HTTPStatus code = HTTP_OK);
@@ -249,14 +381,81 @@ namespace cb {
       virtual void reply(HTTPStatus code, const char *data, unsigned length);
 
       template <typename T>
-      void reply(HTTPStatus code, const T &data) {send(data); reply(code);}
+      void reply(HTTPStatus code, T &&data)
+      {send(std::forward<T>(data)); reply(code);}
+
+      /**
+       * Reply with a body of @param length bytes which is produced on
+       * demand.  @param cb is called each time the connection's output
+       * buffer has drained until it returns false.
+       */
+      virtual void replyStream(HTTPStatus code, uint64_t length,
+                               stream_cb_t cb);
+
+      /**
+       * Reply with all or part of a file.  On plain connections the file is
+       * sent with sendfile() where available.  On SSL connections it is
+       * read and encrypted in bounded chunks.
+       */
+      virtual void replyFile(const std::string &path,
+                             HTTPStatus code = HTTP_OK, uint64_t offset = 0,
+                             int64_t length = -1);
+
+      /**
+       * Start a chunked reply whose body is produced by @param cb each time
+       * the connection's output buffer has drained, until it returns false.
+       * Because data is only pulled as fast as the peer reads it, memory use
+       * stays bounded.  The body is compressed incrementally.
+       */
+      virtual void replyChunked(HTTPStatus code, stream_cb_t cb,
+                                compression_t compression = COMPRESS_AUTO);
+
+      /**
+       * Start a chunked reply and return a stream for its body.  Data is
+       * compressed as it is written and sent as a chunk whenever
+       * @param chunkSize bytes have accumulated, @param latency seconds
+       * have passed since the last chunk or the stream is flushed.
+       * Destroying the stream ends the reply.
+       */
+      virtual SmartPointer<std::ostream>
+      startChunkedStream(HTTPStatus code = HTTP_OK,
+                         compression_t compression = COMPRESS_AUTO,
+                         unsigned chunkSize = 1 << 16, double latency = 0);
 
       virtual void startChunked(HTTPStatus code = HTTP_OK);
       virtual void sendChunk(const Buffer &buf);
       virtual void sendChunk(const char *data, unsigned length);
-      virtual SmartPointer<JSON::Writer> getJSONChunkWriter();
+      /// Like startChunkedStream() but for an already started chunked reply.
+      /// Destroying the stream sends any remaining data without ending it.
+      virtual SmartPointer<std::ostream>
+      getChunkedStream(compression_t compression = COMPRESS_NONE,
+                       unsigned chunkSize = 1 << 16, double latency = 0);
+      virtual SmartPointer<JSON::Writer>
+      getJSONChunkWriter(unsigned chunkSize = 1 << 16);
       virtual void endChunked();
 
+      /**
+       * False while the connection's output, or for HTTP/2 this stream's
+       * queued data, is above the high watermark.  Producers, such as
+       * chunked replies or Websockets, should stop sending and wait for
+       * onWritable().
+       */
+      bool isWritable() const;
+      /// Call @param cb once after isWritable() becomes true again
+      void onWritable(const writable_cb_t &cb) {writableCB = cb;}
+      /**
+       * Call @param cb once when reply() is called, after the response
+       * code is set but before anything is written.  The response headers
+       * and, unless the reply is chunked or streamed, the whole body are
+       * in the output buffer.
+       */
+      void onReply(const reply_cb_t &cb) {replyCB = cb;}
+      /**
+       * Call @param cb once, after onComplete(), when the request has been
+       * completed or dropped because its connection closed.
+       */
+      void setCompleteCallback(const complete_cb_t &cb) {completeCB = cb;}
+
       virtual void redirect(const URI &uri,
                             HTTPStatus code = HTTP_TEMPORARY_REDIRECT);
       virtual void cancel();
@@ -265,11 +464,16 @@ namespace cb {
       virtual void onHeaders() {}
       virtual void onRequest();
       virtual bool onContinue() {return true;}
-      virtual void onProgress(unsigned bytes, int total) {}
+      virtual void onProgress(uint64_t bytes, int64_t total) {}
+      /// Data left in @param buf is discarded, see setBodyStreaming()
+      virtual void onBodyData(Buffer &buf) {}
       virtual void onResponse(ConnectionError code) {}
       virtual void onComplete() {}
 
       // Used by Connection
+      void writable();
+      void complete();
+      void bodyData();
       bool mustHaveBody() const;
       bool mayHaveBody() const;
       bool needsClose() const;
@@ -278,10 +482,12 @@ namespace cb {
       void parseResponseLine(const std::string &line);
 
       virtual void write();
+      bool stream(Buffer &out);
+      void prepareResponseHeaders();
 
     protected:
-      void writeResponse(Buffer &buf);
-      void writeRequest(Buffer &buf);
+      void writeResponse(std::string &header);
+      void writeRequest(std::string &header);
       void writeHeaders(Buffer &buf);
     };
   }
@@ -47,10 +47,36 @@ bool ResourceHTTPHandler::operator()(Request &req) {
 
   if (!res || res->isDirectory()) return false;
 
-  req.reply(HTTP_OK, res->getData(), res->getLength());
-
   if (!req.outHas("Cache-Control"))
     req.outSet("Cache-Control", "max-age=" + String(timeout));
 
+  // Select a precompressed variant
+  const char *codings[] = {"br", "gzip", 0};
+  const Resource *variant = 0;
+
+  for (unsigned i = 0; codings[i]; i++) {
+    const Resource *encoded = res->getEncoded(codings[i]);
+    if (!encoded) continue;
+
+    req.outSet("Vary", "Accept-Encoding");
+
+    if (!variant && req.acceptsEncoding(codings[i])) {
+      req.outSet("Content-Encoding", codings[i]);
+      variant = encoded;
+    }
+  }
+
+  if (variant) res = variant;
+
+  const char *etag = res->getETag();
+  if (etag && req.checkNotModified(etag)) return true;
+
+  uint64_t offset;
+  uint64_t length;
+  HTTPStatus code = req.getRange(res->getLength(), offset, length);
+
+  if (code == HTTP_REQUESTED_RANGE_NOT_SATISFIABLE) req.reply(code);
+  else req.reply(code, res->getData() + offset, length);
+
   return true;
 }
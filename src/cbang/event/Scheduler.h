@@ -48,7 +48,7 @@ namespace cb {
       void schedule(void (T::*member)(), double secs = 0) {
         T *self = dynamic_cast<T *>(this);
         if (!self || !member) CBANG_THROW("Invalid use of Event::Scheduler");
-        base.newEvent(self, member, 0)->add(secs);
+        base.defer([self, member] () {(self->*member)();}, secs);
       }
     };
   }
@@ -0,0 +1,153 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "SharedChannel.h"
+#include "Base.h"
+#include "Event.h"
+
+#include <cbang/Catch.h>
+#include <cbang/json/JSON.h>
+#include <cbang/os/SysError.h>
+#include <cbang/log/Logger.h>
+
+#include <sstream>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+#include <errno.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+SharedChannel::SharedChannel(Base &base, const string &path,
+                             uint32_t capacity) :
+  base(base), ring(path, capacity), fifoPath(path + ".fifo") {}
+
+
+SharedChannel::~SharedChannel() {
+  if (event.isSet()) event->del();
+
+#ifndef _WIN32
+  if (readFD != -1) ::close(readFD);
+  if (writeFD != -1) ::close(writeFD);
+#endif
+}
+
+
+void SharedChannel::setReceiver(message_cb_t cb) {
+  this->cb = cb;
+  if (event.isSet()) return;
+
+#ifdef _WIN32
+  // No FIFOs, poll instead
+  event = base.newEvent(this, &SharedChannel::receive, Event::EVENT_PERSIST);
+  event->add(0.001);
+
+#else
+  if (mkfifo(fifoPath.c_str(), 0600) && errno != EEXIST)
+    THROW("Failed to create FIFO '" << fifoPath << "': " << SysError());
+
+  readFD = ::open(fifoPath.c_str(), O_RDONLY | O_NONBLOCK);
+  if (readFD == -1)
+    THROW("Failed to open FIFO '" << fifoPath << "': " << SysError());
+
+  event = base.newEvent(readFD, this, &SharedChannel::receive,
+                        Event::EVENT_READ | Event::EVENT_PERSIST);
+  event->add();
+#endif
+
+  // Deliver anything sent before the receiver started
+  event->activate();
+}
+
+
+void SharedChannel::setReceiver(json_cb_t cb) {
+  setReceiver([cb] (const char *data, uint32_t length) {
+    cb(JSON::CBORReader(data, length).parse());
+  });
+}
+
+
+bool SharedChannel::send(const char *data, uint32_t length) {
+  if (!ring.write(data, length)) return false;
+  if (ring.wasWaiting()) notify();
+  return true;
+}
+
+
+bool SharedChannel::send(const JSON::Value &msg) {
+  ostringstream str;
+  JSON::CBORWriter writer(str);
+  msg.write(writer);
+  writer.close();
+
+  return send(str.str());
+}
+
+
+void SharedChannel::notify() {
+#ifndef _WIN32
+  // Fails until the receiver has opened the FIFO, it then checks the ring
+  if (writeFD == -1) writeFD = ::open(fifoPath.c_str(), O_WRONLY | O_NONBLOCK);
+
+  // A full FIFO already has a wake up pending
+  if (writeFD != -1 && ::write(writeFD, "", 1) == -1 && errno != EAGAIN) {
+    ::close(writeFD);
+    writeFD = -1;
+  }
+#endif
+}
+
+
+void SharedChannel::receive() {
+#ifndef _WIN32
+  char buf[64];
+  while (0 < ::read(readFD, buf, sizeof(buf))) continue;
+#endif
+
+  do {
+    const char *data;
+    uint32_t length;
+
+    while (ring.peek(data, length)) {
+      TRY_CATCH_ERROR(if (cb) cb(data, length));
+      ring.consume();
+    }
+  } while (!ring.setWaiting());
+}
@@ -0,0 +1,97 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+#include <cbang/os/SharedRing.h>
+
+#include <string>
+#include <functional>
+
+
+namespace cb {
+  namespace JSON {class Value;}
+
+  namespace Event {
+    class Base;
+    class Event;
+
+    /**
+     * A message channel between processes on the same host over a
+     * SharedRing.  Any number of processes may send but only one should
+     * call setReceiver().  The receiver sleeps in its Event::Base and is
+     * woken through the FIFO "<path>.fifo" only when it was idle, so a busy
+     * channel makes no system calls.
+     *
+     * JSON messages are sent as CBOR.
+     */
+    class SharedChannel {
+    public:
+      typedef std::function<void (const char *data, uint32_t length)>
+      message_cb_t;
+      typedef std::function<void (const SmartPointer<JSON::Value> &msg)>
+      json_cb_t;
+
+    protected:
+      Base &base;
+      SharedRing ring;
+      const std::string fifoPath;
+
+      message_cb_t cb;
+      int readFD = -1;
+      int writeFD = -1;
+      SmartPointer<Event> event;
+
+    public:
+      SharedChannel(Base &base, const std::string &path,
+                    uint32_t capacity = 1 << 20);
+      ~SharedChannel();
+
+      SharedRing &getRing() {return ring;}
+
+      /// Call @param cb with each message, on the Base's thread
+      void setReceiver(message_cb_t cb);
+      void setReceiver(json_cb_t cb);
+
+      /// @return false if the channel is full
+      bool send(const char *data, uint32_t length);
+      bool send(const std::string &msg) {return send(msg.data(), msg.size());}
+      bool send(const JSON::Value &msg);
+
+    protected:
+      void notify();
+      void receive();
+    };
+  }
+}
@@ -0,0 +1,242 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "SpoolRequest.h"
+
+#include <cbang/Exception.h>
+#include <cbang/String.h>
+#include <cbang/log/Logger.h>
+#include <cbang/os/SysError.h>
+#include <cbang/os/SystemUtilities.h>
+
+#include <event2/buffer.h>
+
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#endif
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+SpoolRequest::SpoolRequest(RequestMethod method, const URI &uri,
+                           const Version &version, const string &dir,
+                           uint64_t threshold) :
+  Request(method, uri, version), dir(dir), threshold(threshold) {
+
+  if (this->dir.empty()) {
+    const char *tmp = getenv("TMPDIR");
+    this->dir = tmp && *tmp ? tmp : "/tmp";
+  }
+}
+
+
+SpoolRequest::~SpoolRequest() {
+#ifndef _WIN32
+  if (fd != -1) {
+    ::close(fd);
+    SystemUtilities::unlink(path); // Fails if the handler moved it
+  }
+#endif
+}
+
+
+void SpoolRequest::onHeaders() {
+#ifndef _WIN32
+  if (!mayHaveBody() || isSpooled()) return;
+
+  uint64_t length = 0;
+  string contentLength = inFind("Content-Length");
+
+  if (!contentLength.empty()) {
+    try {
+      length = String::parseU64(contentLength);
+    } catch (const Exception &e) {return;} // Rejected by Connection
+
+    if (length < threshold) return;
+  }
+
+  try {
+    open(length);
+    setBodyStreaming(true);
+
+  } catch (const Exception &e) {
+    // The body is buffered instead, subject to the maximum body size
+    LOG_WARNING("Not spooling request body: " << e.getMessage());
+  }
+#endif // _WIN32
+}
+
+
+void SpoolRequest::onBodyData(Buffer &buf) {
+#ifndef _WIN32
+  size += buf.getLength();
+
+  if (direct) {
+    // Collect aligned blocks
+    while (buf.getLength()) {
+      fill += buf.remove(block.get() + fill, blockSize - fill);
+
+      if (fill == blockSize) {
+        writeBlock(block.get(), blockSize);
+        fill = 0;
+      }
+    }
+
+    return;
+  }
+
+  // Write straight from the buffer's chains
+  while (buf.getLength()) {
+    vector<iovec> space(16);
+    buf.peek(space);
+
+    ssize_t n = ::writev(fd, &space[0], space.size());
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      THROW("Failed to write spool file '" << path << "': " << SysError());
+    }
+
+    buf.drain(n);
+  }
+#endif // _WIN32
+}
+
+
+void SpoolRequest::onRequest() {
+  if (isSpooled())
+    try {
+      finish();
+    } catch (const Exception &e) {
+      LOG_ERROR(e.getMessages());
+      return sendError(e);
+    }
+
+  Request::onRequest();
+}
+
+
+void SpoolRequest::open(uint64_t length) {
+#ifndef _WIN32
+  SystemUtilities::ensureDirectory(dir);
+
+  string name = dir + "/spool-XXXXXX";
+  vector<char> tmpl(name.begin(), name.end());
+  tmpl.push_back(0);
+
+  fd = mkstemp(&tmpl[0]);
+  if (fd == -1)
+    THROW("Failed to create spool file in '" << dir << "': " << SysError());
+  path = &tmpl[0];
+
+#ifdef O_DIRECT
+  if (directIO) {
+    void *mem = 0;
+    int flags = fcntl(fd, F_GETFL);
+
+    // Not all filesystems support O_DIRECT
+    if (flags != -1 && !fcntl(fd, F_SETFL, flags | O_DIRECT) &&
+        !posix_memalign(&mem, alignment, blockSize)) {
+      block = (char *)mem;
+      direct = true;
+    }
+  }
+#endif // O_DIRECT
+
+#ifdef __linux__
+  // Reserve space up front so a full disk fails early and the file is
+  // laid out contiguously
+  if (length) {
+    int err = posix_fallocate(fd, 0, length);
+    if (err) LOG_WARNING("Failed to preallocate " << length << " bytes for '"
+                         << path << "': " << SysError(err));
+  }
+#endif // __linux__
+
+  LOG_DEBUG(4, "Spooling request body to " << path);
+#endif // _WIN32
+}
+
+
+void SpoolRequest::writeBlock(const char *data, unsigned length) {
+#ifndef _WIN32
+  while (length) {
+    ssize_t n = ::write(fd, data, length);
+
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      THROW("Failed to write spool file '" << path << "': " << SysError());
+    }
+
+    data += n;
+    length -= n;
+  }
+#endif // _WIN32
+}
+
+
+void SpoolRequest::finish() {
+#ifndef _WIN32
+  if (direct) {
+    // Pad the last block then cut the file back to size
+    if (fill) {
+      unsigned length = (fill + alignment - 1) / alignment * alignment;
+      memset(block.get() + fill, 0, length - fill);
+      writeBlock(block.get(), length);
+      fill = 0;
+    }
+
+    block.release();
+    direct = false;
+
+#ifdef O_DIRECT
+    // Let the handler read without alignment restrictions
+    int flags = fcntl(fd, F_GETFL);
+    if (flags != -1) fcntl(fd, F_SETFL, flags & ~O_DIRECT);
+#endif
+  }
+
+  if (ftruncate(fd, size))
+    THROW("Failed to truncate spool file '" << path << "': " << SysError());
+
+  if (lseek(fd, 0, SEEK_SET) < 0)
+    THROW("Failed to rewind spool file '" << path << "': " << SysError());
+#endif // _WIN32
+}
@@ -0,0 +1,106 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "Request.h"
+
+#include <cbang/SmartPointer.h>
+
+#include <string>
+
+
+namespace cb {
+  namespace Event {
+    /**
+     * A Request which writes large bodies to a temporary file as they
+     * arrive rather than holding them in memory.  Return it from
+     * HTTPHandler::createRequest().  Bodies with a Content-Length below
+     * the threshold are buffered as usual.  Chunked bodies, whose size is
+     * not known in advance, are always spooled.
+     *
+     * When the handler runs the file is complete and its descriptor is at
+     * the start.  The file is removed when the Request is destroyed unless
+     * the handler renames it first.
+     */
+    class SpoolRequest : public Request {
+      std::string dir;
+      uint64_t threshold;
+      bool directIO = false;
+
+      int fd = -1;
+      bool direct = false;
+      std::string path;
+      uint64_t size = 0;
+
+      SmartPointer<char>::Malloc block;
+      unsigned fill = 0;
+
+    public:
+      /// O_DIRECT transfers must be aligned to this
+      static const unsigned alignment = 4096;
+      static const unsigned blockSize = 1 << 20;
+
+      SpoolRequest(RequestMethod method, const URI &uri,
+                   const Version &version, const std::string &dir = "",
+                   uint64_t threshold = 1 << 20);
+      ~SpoolRequest();
+
+      const std::string &getDirectory() const {return dir;}
+      uint64_t getThreshold() const {return threshold;}
+
+      bool getDirectIO() const {return directIO;}
+      /**
+       * Write with O_DIRECT, where supported, so that large uploads do not
+       * push other data out of the page cache.  This costs a copy into an
+       * aligned block.
+       */
+      void setDirectIO(bool x) {directIO = x;}
+
+      bool isSpooled() const {return fd != -1;}
+      const std::string &getSpoolPath() const {return path;}
+      uint64_t getSpoolSize() const {return size;}
+      int getSpoolFD() const {return fd;}
+
+      // From Request
+      void onHeaders();
+      void onBodyData(Buffer &buf);
+      void onRequest();
+
+    protected:
+      void open(uint64_t length);
+      void writeBlock(const char *data, unsigned length);
+      void finish();
+    };
+  }
+}
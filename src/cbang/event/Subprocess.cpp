@@ -0,0 +1,259 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "Subprocess.h"
+#include "Base.h"
+#include "Event.h"
+
+#include <cbang/Exception.h>
+#include <cbang/Catch.h>
+#include <cbang/String.h>
+#include <cbang/log/Logger.h>
+#include <cbang/os/SysError.h>
+
+#include <event2/buffer.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#endif
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+using namespace std;
+using namespace cb::Event;
+
+
+Subprocess::Subprocess(Base &base) : base(base) {}
+
+
+Subprocess::~Subprocess() {
+  for (auto &pipe: pipes)
+    if (pipe->event.isSet()) pipe->event->del();
+
+  if (exitEvent.isSet()) exitEvent->del();
+
+#ifndef _WIN32
+  if (pidFD != -1) ::close(pidFD);
+#endif
+}
+
+
+void Subprocess::exec(const vector<string> &args, unsigned flags,
+                      ProcessPriority priority) {
+#ifdef _WIN32
+  THROW("Event::Subprocess is not supported on Windows");
+
+#else
+  pipes.clear();
+  exited = endingInput = false;
+  openOutputs = 0;
+  if (pidFD != -1) {::close(pidFD); pidFD = -1;}
+
+  cb::Subprocess::exec(args, flags | NO_PIPE_STREAMS, priority);
+
+  if (logPrefix.empty()) logPrefix = SSTR('P' << getPID() << ": ");
+
+  unsigned evFlags = EF::EVENT_PERSIST | EF::EVENT_NO_SELF_REF;
+
+  for (unsigned i = 0; i < getPipeCount(); i++) {
+    if (!hasPipeHandle(i)) continue;
+
+    SmartPointer<pipe_t> pipe = new pipe_t;
+    pipe->index = i;
+    pipe->fd = getPipeHandle(i, false);
+    pipe->toChild = isPipeToChild(i);
+    pipes.push_back(pipe);
+
+    int fl = fcntl(pipe->fd, F_GETFL);
+    if (fl == -1 || fcntl(pipe->fd, F_SETFL, fl | O_NONBLOCK))
+      THROW("Failed to make pipe " << i << " nonblocking: " << SysError());
+
+    pipe_t *p = pipe.get();
+    if (pipe->toChild)
+      pipe->event = base.newEvent(pipe->fd, [this, p] () {writeCB(*p);},
+                                  evFlags | EF::EVENT_WRITE);
+
+    else {
+      pipe->event = base.newEvent(pipe->fd, [this, p] () {readCB(*p);},
+                                  evFlags | EF::EVENT_READ);
+      pipe->event->add();
+      openOutputs++;
+    }
+  }
+
+  // Exit notification
+#ifdef SYS_pidfd_open
+  pidFD = syscall(SYS_pidfd_open, (pid_t)getPID(), 0);
+#endif
+
+  if (pidFD != -1)
+    exitEvent = base.newEvent(pidFD, this, &Subprocess::exitedCB,
+                              evFlags | EF::EVENT_READ);
+  else exitEvent = base.newSignal(SIGCHLD, this, &Subprocess::exitedCB,
+                                  evFlags);
+
+  exitEvent->add();
+
+  // The child may already be gone
+  if (!isRunning()) exitedCB();
+#endif // _WIN32
+}
+
+
+void Subprocess::exec(const string &command, unsigned flags,
+                      ProcessPriority priority) {
+  vector<string> args;
+  parse(command, args);
+  exec(args, flags, priority);
+}
+
+
+void Subprocess::write(const char *data, unsigned length) {
+  pipe_t *pipe = findPipe(0);
+  if (!pipe || !pipe->toChild) THROW("Subprocess stdin not redirected");
+  if (endingInput) THROW("Subprocess input already ended");
+
+  pipe->buffer.add(data, length);
+  if (!pipe->event->isPending()) pipe->event->add();
+}
+
+
+void Subprocess::endInput() {
+  pipe_t *pipe = findPipe(0);
+  if (!pipe || !pipe->toChild) return;
+
+  endingInput = true;
+  if (!pipe->buffer.getLength()) close(*pipe);
+}
+
+
+Subprocess::pipe_t *Subprocess::findPipe(unsigned index) const {
+  for (auto &pipe: pipes)
+    if (pipe->index == index && pipe->fd != -1) return pipe.get();
+  return 0;
+}
+
+
+void Subprocess::close(pipe_t &pipe) {
+  if (pipe.fd == -1) return;
+
+  pipe.event->del();
+  closePipe(pipe.index);
+  pipe.fd = -1;
+
+  if (!pipe.toChild) {
+    openOutputs--;
+    if (pipe.buffer.getLength()) log(pipe.index, pipe.buffer, true);
+    checkDone();
+  }
+}
+
+
+void Subprocess::readCB(pipe_t &pipe) {
+  int ret = pipe.buffer.read(pipe.fd, 64 * 1024);
+
+  if (ret < 0 && (errno == EAGAIN || errno == EINTR)) return;
+
+  if (0 < ret) {
+    if (outputCB) TRY_CATCH_ERROR(outputCB(pipe.index, pipe.buffer));
+    else log(pipe.index, pipe.buffer, false);
+
+  } else close(pipe); // EOF or error
+}
+
+
+void Subprocess::writeCB(pipe_t &pipe) {
+  if (pipe.buffer.getLength()) {
+    int ret = pipe.buffer.write(pipe.fd);
+
+    if (ret < 0 && errno != EAGAIN && errno != EINTR) {
+      LOG_DEBUG(3, logPrefix << "stdin closed: " << SysError());
+      pipe.buffer.clear();
+      close(pipe);
+      return;
+    }
+  }
+
+  if (!pipe.buffer.getLength()) {
+    if (endingInput) close(pipe);
+    else pipe.event->del();
+  }
+}
+
+
+void Subprocess::exitedCB() {
+  if (exited) return;
+
+  // With SIGCHLD this may be a different child
+  TRY_CATCH_ERROR(if (isRunning()) return);
+
+  exited = true;
+  exitEvent->del();
+  checkDone();
+}
+
+
+void Subprocess::checkDone() {
+  if (!isDone() || !exitCB) return;
+
+  // Stay allocated if the callback drops the last reference
+  SmartPointer<Subprocess> self = getRefCount() ? this : 0;
+
+  exit_cb_t cb = exitCB;
+  exitCB = 0;
+  TRY_CATCH_ERROR(cb(*this));
+}
+
+
+void Subprocess::log(unsigned pipe, Buffer &buffer, bool all) {
+  if (outputCB) {
+    if (all) TRY_CATCH_ERROR(outputCB(pipe, buffer));
+    return;
+  }
+
+  while (buffer.getLength()) {
+    size_t length = 0;
+    SmartPointer<char>::Malloc line =
+      evbuffer_readln(buffer.getBuffer(), &length, EVBUFFER_EOL_CRLF);
+
+    if (line.isSet()) LOG_INFO(1, logPrefix << string(line.get(), length));
+    else if (all) { // Last partial line
+      LOG_INFO(1, logPrefix << buffer.toString());
+      buffer.clear();
+
+    } else break;
+  }
+}
@@ -0,0 +1,128 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Buffer.h"
+
+#include <cbang/SmartPointer.h>
+#include <cbang/os/Subprocess.h>
+
+#include <functional>
+#include <vector>
+
+
+namespace cb {
+  namespace Event {
+    class Base;
+    class Event;
+
+    /**
+     * A Subprocess whose pipes are read and written by an Event::Base, so
+     * many children can be supervised from one event loop.
+     *
+     * Output is collected in a Buffer per pipe and passed to the output
+     * callback, or logged line by line if there is none.  Input queued
+     * with write() is sent as the child reads it.  Exit is detected with
+     * a pidfd on Linux and SIGCHLD elsewhere.  The exit callback runs once
+     * the child has exited and all its output has been read.
+     *
+     * Writing to a child which has closed stdin raises SIGPIPE, which
+     * Application ignores by default.  Not supported on Windows.
+     */
+    class Subprocess : public cb::Subprocess, public RefCounted {
+    public:
+      typedef std::function<void (unsigned pipe, Buffer &buffer)>
+      output_cb_t;
+      typedef std::function<void (Subprocess &)> exit_cb_t;
+
+    protected:
+      Base &base;
+
+      struct pipe_t {
+        unsigned index;
+        int fd;
+        bool toChild;
+        Buffer buffer;
+        SmartPointer<Event> event;
+      };
+
+      std::vector<SmartPointer<pipe_t> > pipes;
+      SmartPointer<Event> exitEvent;
+      int pidFD = -1;
+
+      output_cb_t outputCB;
+      exit_cb_t exitCB;
+      std::string logPrefix;
+
+      bool exited = false;
+      bool endingInput = false;
+      unsigned openOutputs = 0;
+
+    public:
+      Subprocess(Base &base);
+      ~Subprocess();
+
+      Base &getBase() const {return base;}
+
+      void setOutputCallback(output_cb_t cb) {outputCB = cb;}
+      void setExitCallback(exit_cb_t cb) {exitCB = cb;}
+
+      /// Prefix for logged output lines, "P<pid>: " by default
+      void setLogPrefix(const std::string &prefix) {logPrefix = prefix;}
+
+      /// Start the child.  Pipes are added for REDIR_* flags as usual.
+      void exec(const std::vector<std::string> &args, unsigned flags = 0,
+                ProcessPriority priority = ProcessPriority::PRIORITY_INHERIT);
+      void exec(const std::string &command, unsigned flags = 0,
+                ProcessPriority priority = ProcessPriority::PRIORITY_INHERIT);
+
+      /// Queue data for the child's stdin, requires REDIR_STDIN
+      void write(const char *data, unsigned length);
+      void write(const std::string &s) {write(s.data(), s.length());}
+      /// Close the child's stdin once queued input has been written
+      void endInput();
+
+      /// @return True after the child exited and its output was read
+      bool isDone() const {return exited && !openOutputs;}
+
+    protected:
+      pipe_t *findPipe(unsigned index) const;
+      void close(pipe_t &pipe);
+      void readCB(pipe_t &pipe);
+      void writeCB(pipe_t &pipe);
+      void exitedCB();
+      void checkDone();
+      void log(unsigned pipe, Buffer &buffer, bool all);
+    };
+  }
+}
@@ -0,0 +1,85 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "TarFileHandler.h"
+#include "FileHandler.h"
+#include "Request.h"
+
+#include <cbang/tar/IndexedTarFile.h>
+#include <cbang/log/Logger.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+TarFileHandler::TarFileHandler(const SmartPointer<IndexedTarFile> &tar,
+                               const string &prefix, uint64_t timeout) :
+  tar(tar), prefix(prefix), timeout(timeout) {}
+
+
+bool TarFileHandler::operator()(Request &req) {
+  string path = prefix + FileHandler::normalize(req.getURI().getPath());
+
+  const IndexedTarFile::Entry *entry = tar->find(path);
+  if (!entry || !entry->isFile()) return false;
+
+  LOG_INFO(5, "TarFileHandler() " << tar->getPath() << ":" << path);
+
+  if (!req.outHas("Cache-Control"))
+    req.outSet("Cache-Control", "max-age=" + String(timeout));
+
+  // Validators
+  string etag = String::printf("\"%llx-%llx-%llx\"",
+                               (long long unsigned)entry->modTime,
+                               (long long unsigned)entry->size,
+                               (long long unsigned)entry->offset);
+
+  if (req.checkNotModified(etag, entry->modTime)) return true;
+
+  // Send all or part of the file
+  uint64_t offset;
+  uint64_t length;
+  HTTPStatus code = req.getRange(entry->size, offset, length);
+
+  if (code == HTTP_REQUESTED_RANGE_NOT_SATISFIABLE) req.reply(code);
+
+  else if (tar->getCompression() == IndexedTarFile::TARFILE_NONE)
+    req.replyFile(tar->getPath(), code, entry->offset + offset, length);
+
+  else {
+    string data = tar->read(*entry);
+    req.reply(code, data.data() + offset, length);
+  }
+
+  return true;
+}
@@ -0,0 +1,73 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "HTTPRequestHandler.h"
+
+#include <cbang/SmartPointer.h>
+#include <cbang/time/Time.h>
+
+#include <string>
+
+
+namespace cb {
+  class IndexedTarFile;
+
+  namespace Event {
+    class Request;
+
+    /**
+     * Serve the files of a tar archive.  Files in uncompressed archives are
+     * sent as ranges of the archive file, with sendfile() where possible.
+     */
+    class TarFileHandler : public HTTPRequestHandler {
+      SmartPointer<IndexedTarFile> tar;
+      std::string prefix;
+      uint64_t timeout;
+
+    public:
+      /// Request paths map to @param prefix followed by the normalized path
+      TarFileHandler(const SmartPointer<IndexedTarFile> &tar,
+                     const std::string &prefix = std::string(),
+                     uint64_t timeout = Time::SEC_PER_HOUR);
+
+      const SmartPointer<IndexedTarFile> &getTarFile() const {return tar;}
+
+      void setTimeout(uint64_t timeout) {this->timeout = timeout;}
+      uint64_t getTimeout() const {return timeout;}
+
+      // From HTTPRequestHandler
+      bool operator()(Request &req);
+    };
+  }
+}
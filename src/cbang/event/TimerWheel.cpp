@@ -0,0 +1,211 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "TimerWheel.h"
+#include "Base.h"
+#include "Event.h"
+
+#include <cbang/Catch.h>
+#include <cbang/time/Timer.h>
+
+#include <cmath>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+void TimerWheel::Node::unlink() {
+  prev->next = next;
+  next->prev = prev;
+  prev = next = this;
+}
+
+
+void TimerWheel::Node::insertBefore(Node &node) {
+  prev = node.prev;
+  next = &node;
+  node.prev->next = this;
+  node.prev = this;
+}
+
+
+void TimerWheel::Node::takeList(Node &list) {
+  if (!list.isLinked()) return;
+
+  next = list.next;
+  prev = list.prev;
+  next->prev = prev->next = this;
+  list.prev = list.next = &list;
+}
+
+
+double TimerWheel::Timer::getRemaining() const {
+  if (!wheel) return 0;
+  double t = wheel->start + expires * wheel->resolution - cb::Timer::monotonic();
+  return t < 0 ? 0 : t;
+}
+
+
+void TimerWheel::Timer::schedule(TimerWheel &wheel, double delay) {
+  wheel.schedule(*this, delay);
+}
+
+
+void TimerWheel::Timer::cancel() {if (wheel) wheel->cancel(*this);}
+
+
+TimerWheel::TimerWheel(Base &base, double resolution) :
+  base(base), resolution(resolution), start(cb::Timer::monotonic()) {
+  if (resolution <= 0) THROW("Invalid timer wheel resolution " << resolution);
+  tickEvent = base.newEvent(this, &TimerWheel::tickCB, EF::EVENT_NO_SELF_REF);
+}
+
+
+TimerWheel::~TimerWheel() {
+  // Detach any remaining timers
+  for (unsigned level = 0; level < levels; level++)
+    for (unsigned i = 0; i < levelSlots; i++)
+      while (slots[level][i].isLinked()) {
+        Timer &timer = *static_cast<Timer *>(slots[level][i].next);
+        timer.unlink();
+        timer.wheel = 0;
+      }
+}
+
+
+void TimerWheel::schedule(Timer &timer, double delay) {
+  if (timer.wheel) cancel(timer);
+
+  // An empty wheel need not catch up on missed ticks
+  uint64_t current = getCurrentTick();
+  if (!count && now < current) now = current;
+
+  uint64_t ticks = 0 < delay ? (uint64_t)ceil(delay / resolution) : 0;
+  timer.expires = current + ticks;
+  if (timer.expires <= now) timer.expires = now + 1;
+
+  timer.wheel = this;
+  insert(timer);
+  count++;
+
+  if (!tickEvent->isPending()) tickEvent->add(resolution);
+}
+
+
+void TimerWheel::cancel(Timer &timer) {
+  if (timer.wheel != this) return;
+
+  timer.unlink();
+  timer.wheel = 0;
+  count--;
+}
+
+
+uint64_t TimerWheel::getCurrentTick() const {
+  double t = cb::Timer::monotonic() - start;
+  return t < 0 ? 0 : (uint64_t)(t / resolution);
+}
+
+
+void TimerWheel::insert(Timer &timer) {
+  uint64_t expires = timer.expires < now ? now : timer.expires;
+
+  // Use the lowest level at which the expiration and now share all
+  // higher digits.  The timer then moves down as those digits are reached.
+  unsigned level = 0;
+  while (level < levels &&
+         (expires >> ((level + 1) * levelBits)) !=
+         (now >> ((level + 1) * levelBits))) level++;
+
+  unsigned slot;
+  if (level == levels) {
+    // Out of range, park in the top level slot which is cascaded last
+    level = levels - 1;
+    slot = ((now >> (level * levelBits)) - 1) & (levelSlots - 1);
+
+  } else slot = (expires >> (level * levelBits)) & (levelSlots - 1);
+
+  timer.insertBefore(slots[level][slot]);
+}
+
+
+void TimerWheel::cascade(unsigned level) {
+  Node list;
+  list.takeList(slots[level][(now >> (level * levelBits)) & (levelSlots - 1)]);
+
+  while (list.isLinked()) {
+    Timer &timer = *static_cast<Timer *>(list.next);
+    timer.unlink();
+    insert(timer);
+  }
+}
+
+
+void TimerWheel::advance() {
+  now++;
+
+  // Move timers down from each higher level slot which begins now
+  unsigned top = 0;
+  while (top + 1 < levels &&
+         !(now & ((1ULL << ((top + 1) * levelBits)) - 1))) top++;
+
+  for (unsigned level = top; 0 < level; level--) cascade(level);
+
+  // Fire due timers, callbacks may schedule or cancel others
+  Node due;
+  due.takeList(slots[0][now & (levelSlots - 1)]);
+
+  while (due.isLinked()) {
+    Timer &timer = *static_cast<Timer *>(due.next);
+    timer.unlink();
+
+    if (now < timer.expires) {
+      insert(timer);
+      continue;
+    }
+
+    timer.wheel = 0;
+    count--;
+
+    // Copy, the callback may destroy the timer
+    callback_t cb = timer.cb;
+    if (cb) TRY_CATCH_ERROR(cb());
+  }
+}
+
+
+void TimerWheel::tickCB() {
+  uint64_t current = getCurrentTick();
+  while (count && now < current) advance();
+  if (count) tickEvent->add(resolution);
+}
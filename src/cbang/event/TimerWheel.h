@@ -0,0 +1,133 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+#include <cbang/StdTypes.h>
+#include <cbang/util/InlineFunction.h>
+
+
+
+namespace cb {
+  namespace Event {
+    class Base;
+    class Event;
+
+    /**
+     * A hierarchical timing wheel for coarse timeouts.
+     *
+     * Scheduling, rescheduling and canceling a timer are O(1) regardless
+     * of how many timers are pending, which suits very many long idle
+     * timeouts that are usually rescheduled before they expire.  Timers
+     * fire on the Base's event loop within one resolution tick after they
+     * are due.  Not thread safe.
+     */
+    class TimerWheel {
+    public:
+      typedef InlineFunction<void ()> callback_t;
+
+
+      struct Node {
+        Node *prev;
+        Node *next;
+
+        Node() : prev(this), next(this) {}
+        bool isLinked() const {return next != this;}
+        void unlink();
+        void insertBefore(Node &node);
+        /// Move all nodes following @param list to this empty list
+        void takeList(Node &list);
+      };
+
+
+      /// Usually a member of the object it times out
+      class Timer : protected Node {
+        friend class TimerWheel;
+
+        TimerWheel *wheel = 0;
+        uint64_t expires = 0;
+        callback_t cb;
+
+        // Don't allow copy constructor or assignment
+        Timer(const Timer &o) {}
+        Timer &operator=(const Timer &o) {return *this;}
+
+      public:
+        Timer(callback_t cb = 0) : cb(std::move(cb)) {}
+        ~Timer() {cancel();}
+
+        void setCallback(callback_t cb) {this->cb = std::move(cb);}
+
+        bool isPending() const {return wheel;}
+        /// @return Seconds until the timer fires or zero if not pending
+        double getRemaining() const;
+
+        /// Schedule or reschedule the timer to fire after @param delay
+        void schedule(TimerWheel &wheel, double delay);
+        void cancel();
+      };
+
+
+    protected:
+      static const unsigned levelBits = 8;
+      static const unsigned levelSlots = 1 << levelBits;
+      static const unsigned levels = 4;
+
+      Base &base;
+      double resolution;
+      double start;
+      uint64_t now = 0;
+      unsigned count = 0;
+
+      Node slots[levels][levelSlots];
+      SmartPointer<Event> tickEvent;
+
+    public:
+      TimerWheel(Base &base, double resolution = 0.1);
+      ~TimerWheel();
+
+      double getResolution() const {return resolution;}
+      unsigned getCount() const {return count;}
+
+      void schedule(Timer &timer, double delay);
+      void cancel(Timer &timer);
+
+    protected:
+      uint64_t getCurrentTick() const;
+      void insert(Timer &timer);
+      void cascade(unsigned level);
+      void advance();
+      void tickCB();
+    };
+  }
+}
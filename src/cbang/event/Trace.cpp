@@ -0,0 +1,310 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "Trace.h"
+#include "Tracer.h"
+#include "Request.h"
+
+#include <cbang/String.h>
+#include <cbang/json/Sink.h>
+#include <cbang/time/Timer.h>
+#include <cbang/util/Random.h>
+
+#include <cstring>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+thread_local Trace *Trace::current = 0;
+
+
+namespace {
+  int fromHex(char c) {
+    if ('0' <= c && c <= '9') return c - '0';
+    if ('a' <= c && c <= 'f') return c - 'a' + 10;
+    return -1; // W3C trace context is lower case only
+  }
+
+
+  bool parseHex(const char *s, unsigned length, uint8_t *data) {
+    for (unsigned i = 0; i < length; i += 2) {
+      int hi = fromHex(s[i]);
+      int lo = fromHex(s[i + 1]);
+      if (hi < 0 || lo < 0) return false;
+      data[i / 2] = hi << 4 | lo;
+    }
+
+    return true;
+  }
+
+
+  bool isZero(const uint8_t *data, unsigned length) {
+    for (unsigned i = 0; i < length; i++)
+      if (data[i]) return false;
+    return true;
+  }
+}
+
+
+Trace::Trace(const SmartPointer<Tracer> &tracer, const string &name,
+             uint64_t start, const uint8_t *traceID, uint64_t remoteParent) :
+  tracer(tracer), remoteParent(remoteParent) {
+  if (traceID) memcpy(this->traceID, traceID, 16);
+  else
+    do Random::instance().bytes(this->traceID, 16);
+    while (isZero(this->traceID, 16));
+
+  spans.reserve(8);
+  begin(name, 0, KIND_SERVER, start);
+}
+
+
+string Trace::getTraceID() const {return toHex(traceID, 16);}
+
+
+unsigned Trace::begin(const string &name, unsigned parent, kind_t kind) {
+  return begin(name, parent, kind, Timer::monotonicNS());
+}
+
+
+unsigned Trace::begin(const string &name, unsigned parent, kind_t kind,
+                      uint64_t start) {
+  if (!spans.empty() && spans.size() <= parent)
+    THROW("Invalid parent span " << parent);
+
+  spans.push_back(Span());
+  Span &span = spans.back();
+  span.name = name;
+  span.id = newSpanID();
+  span.parent = parent;
+  span.kind = kind;
+  span.start = start;
+  span.end = 0;
+
+  return spans.size() - 1;
+}
+
+
+void Trace::end(unsigned span) {end(span, Timer::monotonicNS());}
+
+
+void Trace::end(unsigned span, uint64_t time) {
+  Span &s = spans.at(span);
+  if (!s.end) s.end = time;
+}
+
+
+void Trace::setAttribute(unsigned span, const string &key,
+                         const string &value) {
+  spans.at(span).attributes.push_back(make_pair(key, value));
+}
+
+
+void Trace::stage(const char *name) {stage(name, Timer::monotonicNS());}
+
+
+void Trace::stage(const char *name, uint64_t time) {
+  if (finished) return;
+
+  if (0 <= stageSpan) {
+    if (spans[stageSpan].name == name) return;
+    end(stageSpan, time);
+  }
+
+  stageSpan = begin(name, 0, KIND_INTERNAL, time);
+}
+
+
+void Trace::finish(const Request &req) {
+  if (finished) return;
+
+  uint64_t now = Timer::monotonicNS();
+  for (unsigned i = 0; i < spans.size(); i++) end(i, now);
+
+  setAttribute(0, "http.method", req.getMethod().toString());
+  setAttribute(0, "http.target", req.getURI().getEscapedPath());
+  setAttribute(0, "http.status_code",
+               String((unsigned)req.getResponseCode()));
+  if (!req.getRoute().empty()) setAttribute(0, "http.route", req.getRoute());
+
+  finished = true;
+  tracer->finish(*this);
+}
+
+
+string Trace::getTraceParent(unsigned span) const {
+  return "00-" + getTraceID() + "-" + toHex(spans.at(span).id) + "-01";
+}
+
+
+bool Trace::parseTraceParent(const string &header, uint8_t traceID[16],
+                             uint64_t &parent, uint8_t &flags) {
+  // version "-" trace-id "-" parent-id "-" trace-flags
+  if (header.length() < 55) return false;
+
+  const char *s = header.data();
+  if (s[2] != '-' || s[35] != '-' || s[52] != '-') return false;
+
+  // Version ff is invalid, later versions may append fields
+  uint8_t version;
+  if (!parseHex(s, 2, &version) || version == 0xff) return false;
+  if (!version && header.length() != 55) return false;
+  if (version && 55 < header.length() && s[55] != '-') return false;
+
+  uint8_t id[8];
+  if (!parseHex(s + 3, 32, traceID) || isZero(traceID, 16) ||
+      !parseHex(s + 36, 16, id) || isZero(id, 8) ||
+      !parseHex(s + 53, 2, &flags)) return false;
+
+  parent = 0;
+  for (unsigned i = 0; i < 8; i++) parent = parent << 8 | id[i];
+
+  return true;
+}
+
+
+string Trace::toHex(const uint8_t *data, unsigned length) {
+  static const char *digits = "0123456789abcdef";
+  string s(length * 2, '0');
+
+  for (unsigned i = 0; i < length; i++) {
+    s[i * 2] = digits[data[i] >> 4];
+    s[i * 2 + 1] = digits[data[i] & 15];
+  }
+
+  return s;
+}
+
+
+string Trace::toHex(uint64_t id) {
+  uint8_t data[8];
+  for (unsigned i = 0; i < 8; i++) data[i] = id >> (56 - i * 8);
+  return toHex(data, 8);
+}
+
+
+void Trace::writeOTLP(JSON::Sink &sink, uint64_t clockOffset) const {
+  string traceID = getTraceID();
+
+  for (unsigned i = 0; i < spans.size(); i++) {
+    const Span &span = spans[i];
+
+    sink.appendDict();
+    sink.insert("traceId", traceID);
+    sink.insert("spanId", toHex(span.id));
+
+    if (i) sink.insert("parentSpanId", toHex(spans[span.parent].id));
+    else if (remoteParent) sink.insert("parentSpanId", toHex(remoteParent));
+
+    sink.insert("name", span.name);
+    sink.insert("kind", (unsigned)span.kind);
+
+    // OTLP JSON encodes 64-bit integers as strings
+    sink.insert("startTimeUnixNano", String(span.start + clockOffset));
+    sink.insert("endTimeUnixNano", String(span.end + clockOffset));
+
+    if (!span.attributes.empty()) {
+      sink.insertList("attributes");
+
+      for (unsigned j = 0; j < span.attributes.size(); j++) {
+        sink.appendDict();
+        sink.insert("key", span.attributes[j].first);
+        sink.insertDict("value");
+        sink.insert("stringValue", span.attributes[j].second);
+        sink.endDict();
+        sink.endDict();
+      }
+
+      sink.endList();
+    }
+
+    sink.endDict();
+  }
+}
+
+
+void Trace::write(JSON::Sink &sink) const {
+  const Span &root = spans[0];
+
+  sink.beginDict();
+  sink.insert("trace", getTraceID());
+  sink.insert("span", toHex(root.id));
+  if (remoteParent) sink.insert("parent", toHex(remoteParent));
+  sink.insert("name", root.name);
+  sink.insert("duration_us", (root.end - root.start) / 1000.0);
+
+  for (unsigned i = 0; i < root.attributes.size(); i++)
+    sink.insert(root.attributes[i].first, root.attributes[i].second);
+
+  sink.insertList("spans");
+  for (unsigned i = 1; i < spans.size(); i++) {
+    const Span &span = spans[i];
+
+    sink.appendDict();
+    sink.insert("name", span.name);
+    if (span.parent) sink.insert("parent", spans[span.parent].name);
+    sink.insert("offset_us", (span.start - root.start) / 1000.0);
+    sink.insert("duration_us", (span.end - span.start) / 1000.0);
+
+    for (unsigned j = 0; j < span.attributes.size(); j++)
+      sink.insert(span.attributes[j].first, span.attributes[j].second);
+
+    sink.endDict();
+  }
+  sink.endList();
+
+  sink.endDict();
+}
+
+
+uint64_t Trace::newSpanID() {
+  uint64_t id;
+  do id = Random::instance().rand<uint64_t>();
+  while (!id);
+  return id;
+}
+
+
+TraceSpan::TraceSpan(const Request &req, const string &name) :
+  trace(req.getTrace()) {
+  if (trace.isSet()) span = trace->begin(name);
+}
+
+
+TraceSpan::~TraceSpan() {if (trace.isSet()) trace->end(span);}
+
+
+void TraceSpan::setAttribute(const string &key, const string &value) {
+  if (trace.isSet()) trace->setAttribute(span, key, value);
+}
@@ -0,0 +1,162 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+#include <cbang/json/Serializable.h>
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+
+namespace cb {
+  namespace Event {
+    class Request;
+    class Tracer;
+
+    /**
+     * The spans of one sampled request.  Span zero covers the whole request
+     * and its children record each stage of the Connection, such as
+     * READING_BODY, HANDLER and WRITING, as well as any spans a handler
+     * adds with begin() and end(), e.g. around an EventDB query.  Times are
+     * on Timer::monotonicNS().
+     *
+     * Unsampled requests have no Trace so tracing costs only a null check.
+     */
+    class Trace : public RefCounted, public JSON::Serializable {
+    public:
+      typedef enum {
+        KIND_INTERNAL = 1,
+        KIND_SERVER   = 2,
+        KIND_CLIENT   = 3,
+      } kind_t;
+
+      struct Span {
+        std::string name;
+        uint64_t id;
+        unsigned parent;
+        kind_t kind;
+        uint64_t start;
+        uint64_t end;
+        std::vector<std::pair<std::string, std::string> > attributes;
+      };
+
+    protected:
+      SmartPointer<Tracer> tracer;
+      uint8_t traceID[16];
+      uint64_t remoteParent;
+      std::vector<Span> spans;
+      int stageSpan = -1;
+      bool finished = false;
+
+      static thread_local Trace *current;
+
+    public:
+      /**
+       * @param traceID and @param remoteParent continue a trace started by
+       * the caller, otherwise a new trace ID is generated.
+       */
+      Trace(const SmartPointer<Tracer> &tracer, const std::string &name,
+            uint64_t start, const uint8_t *traceID = 0,
+            uint64_t remoteParent = 0);
+
+      const SmartPointer<Tracer> &getTracer() const {return tracer;}
+      std::string getTraceID() const;
+      uint64_t getRemoteParent() const {return remoteParent;}
+      bool isFinished() const {return finished;}
+
+      unsigned getSpanCount() const {return spans.size();}
+      const Span &getSpan(unsigned i) const {return spans.at(i);}
+
+      /// @return The index of the new span
+      unsigned begin(const std::string &name, unsigned parent = 0,
+                     kind_t kind = KIND_INTERNAL);
+      unsigned begin(const std::string &name, unsigned parent, kind_t kind,
+                     uint64_t start);
+      void end(unsigned span);
+      void end(unsigned span, uint64_t time);
+      void setAttribute(unsigned span, const std::string &key,
+                        const std::string &value);
+
+      /// End the current stage and start a new one named @param name
+      void stage(const char *name);
+      void stage(const char *name, uint64_t time);
+
+      /// End all open spans and pass the trace to the Tracer's exporter
+      void finish(const Request &req);
+
+      /// @return A W3C traceparent header value for a child of @param span
+      std::string getTraceParent(unsigned span = 0) const;
+      /// Parse a W3C traceparent header.  @return false if it is invalid.
+      static bool parseTraceParent(const std::string &header,
+                                   uint8_t traceID[16], uint64_t &parent,
+                                   uint8_t &flags);
+
+      /// The Trace of the handler running on this thread, if any
+      static Trace *getCurrent() {return current;}
+
+      class Scope {
+        Trace *last;
+      public:
+        Scope(Trace *trace) : last(current) {current = trace;}
+        ~Scope() {current = last;}
+      };
+
+      static std::string toHex(const uint8_t *data, unsigned length);
+      static std::string toHex(uint64_t id);
+
+      /// Write spans in OTLP JSON form, times offset by @param clockOffset
+      void writeOTLP(JSON::Sink &sink, uint64_t clockOffset) const;
+
+      // From JSON::Serializable
+      void write(JSON::Sink &sink) const;
+
+    protected:
+      static uint64_t newSpanID();
+    };
+
+
+    /// Records a span for the life time of the object, if @param req is traced
+    class TraceSpan {
+      SmartPointer<Trace> trace;
+      unsigned span = 0;
+
+    public:
+      TraceSpan(const Request &req, const std::string &name);
+      ~TraceSpan();
+
+      void setAttribute(const std::string &key, const std::string &value);
+    };
+  }
+}
@@ -0,0 +1,89 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "Tracer.h"
+#include "Trace.h"
+#include "TraceExporter.h"
+#include "Request.h"
+
+#include <cbang/Exception.h>
+#include <cbang/time/Timer.h>
+#include <cbang/util/Random.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+Tracer::Tracer(const SmartPointer<TraceExporter> &exporter,
+               double sampleRate) :
+  exporter(exporter),
+  clockOffset((uint64_t)(Timer::now() * 1e9) - Timer::monotonicNS()) {
+  if (exporter.isNull()) THROW("Tracer requires an exporter");
+  setSampleRate(sampleRate);
+}
+
+
+void Tracer::setSampleRate(double rate) {
+  if (rate < 0 || 1 < rate) THROW("Invalid trace sample rate " << rate);
+  sampleRate = rate;
+}
+
+
+SmartPointer<Trace> Tracer::start(const Request &req, uint64_t start) {
+  if (!sampleRate && !followParent) return 0;
+
+  uint8_t traceID[16];
+  uint64_t parent = 0;
+  uint8_t flags = 0;
+
+  string header = req.inFind("traceparent");
+  bool hasParent = !header.empty() &&
+    Trace::parseTraceParent(header, traceID, parent, flags);
+
+  if (!(followParent && hasParent && (flags & 1)) && !sample()) return 0;
+
+  string name = string(req.getMethod().toString()) + " " +
+    req.getURI().getPath();
+
+  return new Trace(this, name, start, hasParent ? traceID : 0, parent);
+}
+
+
+void Tracer::finish(const Trace &trace) {exporter->add(trace, clockOffset);}
+
+
+bool Tracer::sample() const {
+  if (sampleRate <= 0) return false;
+  if (1 <= sampleRate) return true;
+  return Random::instance().rand<uint32_t>() < sampleRate * 4294967296.0;
+}
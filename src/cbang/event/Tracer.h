@@ -0,0 +1,85 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+
+#include <cstdint>
+
+
+namespace cb {
+  namespace Event {
+    class Request;
+    class Trace;
+    class TraceExporter;
+
+    /**
+     * Decides which requests are traced and passes finished traces to a
+     * TraceExporter.  Requests whose W3C traceparent header has the sampled
+     * flag set are traced when following the parent is enabled, others are
+     * sampled at a fixed rate.  Set on an HTTP with HTTP::setTracer().
+     */
+    class Tracer : public RefCounted {
+      SmartPointer<TraceExporter> exporter;
+      double sampleRate;
+      bool followParent = true;
+      uint64_t clockOffset;
+
+    public:
+      Tracer(const SmartPointer<TraceExporter> &exporter,
+             double sampleRate = 0.01);
+
+      const SmartPointer<TraceExporter> &getExporter() const {return exporter;}
+
+      double getSampleRate() const {return sampleRate;}
+      /// The fraction, from zero to one, of untraced requests to sample
+      void setSampleRate(double rate);
+
+      bool getFollowParent() const {return followParent;}
+      void setFollowParent(bool x) {followParent = x;}
+
+      /// Nanoseconds to add to Timer::monotonicNS() to get Unix time
+      uint64_t getClockOffset() const {return clockOffset;}
+
+      /**
+       * @return A new Trace, starting at @param start, if @param req is
+       * sampled, otherwise null.
+       */
+      SmartPointer<Trace> start(const Request &req, uint64_t start);
+      void finish(const Trace &trace);
+
+    protected:
+      bool sample() const;
+    };
+  }
+}
@@ -32,7 +32,10 @@
 
 #include "WebServer.h"
 #include "HTTP.h"
+#include "HTTPThread.h"
+#include "Base.h"
 #include "Request.h"
+#include "HTTPError.h"
 
 #include <cbang/config.h>
 #include <cbang/config/Options.h>
@@ -41,6 +44,7 @@
 #include <cbang/os/SystemUtilities.h>
 #include <cbang/openssl/SSLContext.h>
 #include <cbang/util/RateSet.h>
+#include <cbang/util/HistogramSet.h>
 
 using namespace std;
 using namespace cb::Event;
@@ -49,7 +53,7 @@ using namespace cb::Event;
 WebServer::WebServer(cb::Options &options, Base &base,
                      const cb::SmartPointer<cb::SSLContext> &sslCtx,
                      const cb::SmartPointer<HTTPHandlerFactory> &factory) :
-  HTTPHandlerGroup(factory), options(options), sslCtx(sslCtx),
+  HTTPHandlerGroup(factory), options(options), base(base), sslCtx(sslCtx),
   initialized(false), logPrefix(false) {
 
   SmartPointer<HTTPHandler>::Phony handler(this);
@@ -60,7 +64,9 @@ WebServer::WebServer(cb::Options &options, Base &base,
 }
 
 
-WebServer::~WebServer() {}
+WebServer::~WebServer() {
+  for (unsigned i = 0; i < threads.size(); i++) threads[i]->join();
+}
 
 
 void WebServer::addOptions(cb::Options &options) {
@@ -87,6 +93,13 @@ void WebServer::addOptions(cb::Options &options) {
               "request times out.");
   options.add("http-connection-backlog", "Size of the connection backlog "
               "queue.  Once this is full connections are rejected.");
+  options.add("http-threads", "Number of threads, each with its own event "
+              "loop and listener socket, used to accept and process "
+              "connections.  Values greater than one require SO_REUSEPORT "
+              "support.")->setDefault(1);
+  options.add("http2", "Accept HTTP/2 connections, via TLS ALPN or with "
+              "prior knowledge on plain connections.")->setDefault(true);
+  socketOptions.addOptions(options, "http-");
 
   options.popCategory();
 
@@ -103,6 +116,19 @@ void WebServer::addOptions(cb::Options &options) {
                 "format.")->setDefault("certificate.pem");
     options.add("private-key-file", "The servers private key file in PEM "
                 "format.")->setDefault("private.pem");
+    options.add("ssl-session-cache-size", "The maximum number of TLS "
+                "sessions to cache for resumption.  Zero for no limit.");
+    options.add("ssl-session-timeout", "The lifetime in seconds of cached "
+                "TLS sessions and session tickets.");
+    opt = options.add("ssl-ticket-key-files", "Files each holding a 48 or 80 "
+                      "byte TLS session ticket key.  Servers sharing these "
+                      "keys can resume each other's sessions.  The first key "
+                      "encrypts new tickets.");
+    opt->setType(Option::STRINGS_TYPE);
+    options.add("ssl-handshake-threads", "Number of threads per event loop "
+                "which run TLS handshakes so that private key operations do "
+                "not stall established connections.  Zero runs handshakes on "
+                "the event loop.")->setDefault(0);
     options.popCategory();
   }
 }
@@ -125,6 +151,9 @@ void WebServer::init() {
     setTimeout(options["http-server-timeout"].toInteger());
   if (options["http-connection-backlog"].hasValue())
     setConnectionBacklog(options["http-connection-backlog"].toInteger());
+  setHTTP2Enabled(options["http2"].toBoolean());
+  setSocketOptions(socketOptions);
+  setThreads(options["http-threads"].toInteger());
 
   // Configure ports
   Option::strings_t addresses = options["http-addresses"].toStrings();
@@ -134,6 +163,20 @@ void WebServer::init() {
 #ifdef HAVE_OPENSSL
   // SSL
   if (!https.isNull()) {
+    if (options["http2"].toBoolean())
+      sslCtx->setALPNProtocols({"h2", "http/1.1"});
+
+    // Session resumption
+    if (options["ssl-session-cache-size"].hasValue())
+      sslCtx->setSessionCacheSize
+        (options["ssl-session-cache-size"].toInteger());
+    if (options["ssl-session-timeout"].hasValue())
+      sslCtx->setSessionTimeout(options["ssl-session-timeout"].toInteger());
+    if (options["ssl-ticket-key-files"].hasValue())
+      sslCtx->loadTicketKeys(options["ssl-ticket-key-files"].toStrings());
+
+    setCryptoThreads(options["ssl-handshake-threads"].toInteger());
+
     // Configure secure ports
     addresses = options["https-addresses"].toStrings();
     for (unsigned i = 0; i < addresses.size(); i++)
@@ -166,6 +209,9 @@ bool WebServer::allow(Request &req) const {
 
 
 void WebServer::shutdown() {
+  for (unsigned i = 0; i < threads.size(); i++) threads[i]->join();
+  threads.clear();
+
   http.release();
   https.release();
 }
@@ -186,7 +232,7 @@ bool WebServer::handleRequest(Request &req) {
   if (logPrefix)
     Logger::instance().setThreadPrefix(String::printf("REQ%lld:", req.getID()));
 
-  if (!allow(req)) THROWX("Unauthorized", HTTP_UNAUTHORIZED);
+  if (!allow(req)) THROW_HTTP("Unauthorized", HTTP_UNAUTHORIZED);
 
   return HTTPHandlerGroup::operator()(req);
 }
@@ -197,33 +243,78 @@ void WebServer::endRequest(Request &req) {
 }
 
 
+void WebServer::setThreads(unsigned count) {
+  if (count == getThreads()) return;
+  if (!ports.empty() || !securePorts.empty())
+    THROW("Cannot change HTTP thread count after binding listen ports");
+
+  for (unsigned i = 0; i < threads.size(); i++) threads[i]->join();
+  threads.clear();
+
+  bool shared = 1 < count;
+  SmartPointer<HTTP::counter_t> counter;
+  SmartPointer<HTTP::counter_t> secureCounter;
+
+  if (shared) {
+    Base::enableThreads();
+    counter = new HTTP::counter_t(0);
+    secureCounter = new HTTP::counter_t(0);
+  }
+
+  http->setReusePort(shared);
+  http->setConnectionCounter(counter);
+
+  if (https.isSet()) {
+    https->setReusePort(shared);
+    https->setConnectionCounter(secureCounter);
+  }
+
+  for (unsigned i = 1; i < count; i++)
+    threads.push_back(new HTTPThread(*http, https));
+}
+
+
+unsigned WebServer::getConnectionCount() const {
+  unsigned count = http->getTotalConnectionCount();
+  if (https.isSet()) count += https->getTotalConnectionCount();
+  return count;
+}
+
+
 void WebServer::setEventPriority(int priority) {
-  http->setEventPriority(priority);
-  if (!https.isNull()) http->setEventPriority(priority);
+  forEachHTTP([priority] (HTTP &http) {http.setEventPriority(priority);});
 }
 
 
 void WebServer::setMaxConnections(unsigned x) {
-  http->setMaxConnections(x);
-  if (!https.isNull()) http->setMaxConnections(x);
+  forEachHTTP([x] (HTTP &http) {http.setMaxConnections(x);});
 }
 
 
 void WebServer::setMaxConnectionTTL(unsigned x) {
-  http->setMaxConnectionTTL(x);
-  if (!https.isNull()) http->setMaxConnectionTTL(x);
+  forEachHTTP([x] (HTTP &http) {http.setMaxConnectionTTL(x);});
 }
 
 
 void WebServer::setConnectionBacklog(unsigned x) {
-  http->setConnectionBacklog(x);
-  if (!https.isNull()) http->setConnectionBacklog(x);
+  forEachHTTP([x] (HTTP &http) {http.setConnectionBacklog(x);});
+}
+
+
+void WebServer::setCryptoThreads(unsigned threads) {
+  forEachHTTP([threads] (HTTP &http) {
+      http.getBase().setCryptoThreads(threads);
+    });
+}
+
+
+void WebServer::setSocketOptions(const SocketOptions &x) {
+  forEachHTTP([x] (HTTP &http) {http.setSocketOptions(x);});
 }
 
 
 void WebServer::setStats(const cb::SmartPointer<cb::RateSet> &stats) {
-  http->setStats(stats);
-  if (https.isSet()) https->setStats(stats);
+  forEachHTTP([stats] (HTTP &http) {http.setStats(stats);});
 }
 
 
@@ -232,42 +323,73 @@ const cb::SmartPointer<cb::RateSet> &WebServer::getStats() const {
 }
 
 
+void WebServer::setLatencyStats
+(const cb::SmartPointer<cb::HistogramSet> &latency) {
+  forEachHTTP([latency] (HTTP &http) {http.setLatencyStats(latency);});
+}
+
+
+const cb::SmartPointer<cb::HistogramSet> &
+WebServer::getLatencyStats() const {return http->getLatencyStats();}
+
+
 void WebServer::allow(const cb::IPAddress &addr) {ipFilter.allow(addr);}
 void WebServer::deny(const cb::IPAddress &addr) {ipFilter.deny(addr);}
 
 
 void WebServer::addListenPort(const cb::IPAddress &addr) {
   LOG_INFO(1, "Listening for HTTP on " << addr);
-  http->bind(addr);
+  forEachHTTP([addr] (HTTP &http) {http.bind(addr);}, false);
   ports.push_back(addr);
+  startThreads();
 }
 
 
 void WebServer::addSecureListenPort(const cb::IPAddress &addr) {
   LOG_INFO(1, "Listening for HTTPS on " << addr);
   https->bind(addr);
+  for (unsigned i = 0; i < threads.size(); i++)
+    threads[i]->getHTTPS()->bind(addr);
   securePorts.push_back(addr);
+  startThreads();
 }
 
 
 void WebServer::setMaxBodySize(unsigned size) {
-  http->setMaxBodySize(size);
-  if (!https.isNull()) https->setMaxBodySize(size);
+  forEachHTTP([size] (HTTP &http) {http.setMaxBodySize(size);});
 }
 
 
 void WebServer::setMaxHeadersSize(unsigned size) {
-  http->setMaxHeadersSize(size);
-  if (!https.isNull()) https->setMaxHeadersSize(size);
+  forEachHTTP([size] (HTTP &http) {http.setMaxHeadersSize(size);});
+}
+
+
+void WebServer::setHTTP2Enabled(bool enabled) {
+  forEachHTTP([enabled] (HTTP &http) {http.setHTTP2Enabled(enabled);});
 }
 
 
 void WebServer::setTimeout(int timeout) {
-  http->setReadTimeout(timeout);
-  http->setWriteTimeout(timeout);
+  forEachHTTP([timeout] (HTTP &http) {
+      http.setReadTimeout(timeout);
+      http.setWriteTimeout(timeout);
+    });
+}
 
-  if (https.isSet()) {
-    https->setReadTimeout(timeout);
-    https->setWriteTimeout(timeout);
+
+void WebServer::startThreads() {
+  for (unsigned i = 0; i < threads.size(); i++)
+    if (!threads[i]->isRunning()) threads[i]->start();
+}
+
+
+void WebServer::forEachHTTP(function<void (HTTP &)> cb, bool secure) {
+  cb(*http);
+  if (secure && https.isSet()) cb(*https);
+
+  for (unsigned i = 0; i < threads.size(); i++) {
+    cb(*threads[i]->getHTTP());
+    if (secure && threads[i]->getHTTPS().isSet()) cb(*threads[i]->getHTTPS());
   }
 }
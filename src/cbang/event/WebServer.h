@@ -36,28 +36,38 @@
 #include "HTTPHandlerGroup.h"
 
 #include <cbang/net/IPAddressFilter.h>
+#include <cbang/socket/SocketOptions.h>
+
+#include <functional>
 
 
 namespace cb {
   class SSLContext;
   class Options;
   class RateSet;
+  class HistogramSet;
 
   namespace Event {
     class Base;
     class HTTP;
+    class HTTPThread;
     class Request;
 
     class WebServer : public HTTPHandlerGroup, public HTTPHandler {
       Options &options;
+      Base &base;
       SmartPointer<SSLContext> sslCtx;
 
       SmartPointer<HTTP> http;
       SmartPointer<HTTP> https;
 
+      typedef std::vector<SmartPointer<HTTPThread> > threads_t;
+      threads_t threads;
+
       bool initialized;
 
       IPAddressFilter ipFilter;
+      SocketOptions socketOptions;
 
       typedef std::vector<IPAddress> ports_t;
       ports_t ports;
@@ -96,6 +106,19 @@ namespace cb {
       const SmartPointer<HTTP> &getHTTP() const {return http;}
       const SmartPointer<HTTP> &getHTTPS() const {return https;}
 
+      /**
+       * Accept and process connections with @param count event loops.  The
+       * additional loops each run in their own thread with a separate
+       * listener socket bound with SO_REUSEPORT.  Handlers are shared and
+       * must therefore be thread safe.  Must be called before any listen
+       * ports are added.
+       */
+      void setThreads(unsigned count);
+      unsigned getThreads() const {return threads.size() + 1;}
+
+      /// @return The total connection count over all threads
+      unsigned getConnectionCount() const;
+
       void addListenPort(const IPAddress &addr);
       unsigned getNumListenPorts() const {return ports.size();}
       const IPAddress &getListenPort(unsigned i) const {return ports.at(i);}
@@ -104,9 +127,12 @@ namespace cb {
       void setMaxConnections(unsigned x);
       void setMaxConnectionTTL(unsigned x);
       void setConnectionBacklog(unsigned x);
+      void setSocketOptions(const SocketOptions &x);
 
       void setStats(const SmartPointer<RateSet> &stats);
       const SmartPointer<RateSet> &getStats() const;
+      void setLatencyStats(const SmartPointer<HistogramSet> &latency);
+      const SmartPointer<HistogramSet> &getLatencyStats() const;
 
       void allow(const IPAddress &addr);
       void deny(const IPAddress &addr);
@@ -119,6 +145,13 @@ namespace cb {
       void setMaxBodySize(unsigned size);
       void setMaxHeadersSize(unsigned size);
       void setTimeout(int timeout);
+      void setHTTP2Enabled(bool enabled);
+      /// Configure every event loop, see Base::setCryptoThreads()
+      void setCryptoThreads(unsigned threads);
+
+    protected:
+      void startThreads();
+      void forEachHTTP(std::function<void (HTTP &)> cb, bool secure = true);
     };
   }
 }
@@ -0,0 +1,222 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "WebsockDeflate.h"
+
+#include <cbang/Exception.h>
+#include <cbang/String.h>
+
+#include <vector>
+#include <set>
+#include <cstring>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+namespace {
+  // Every compressed message ends with an empty stored block
+  const char tail[4] = {0, 0, (char)0xff, (char)0xff};
+
+
+  bool parseWindowBits(const string &value, unsigned &bits) {
+    string s = String::trim(value, "\"");
+    if (!String::isInteger(s)) return false;
+    bits = String::parseU32(s);
+    return 8 <= bits && bits <= 15;
+  }
+}
+
+
+WebsockDeflate::WebsockDeflate(unsigned windowBits, bool resetDeflater,
+                               bool resetInflater) :
+  resetDeflater(resetDeflater), resetInflater(resetInflater) {
+  // zlib does not support a raw window of 8 bits
+  if (windowBits < 9 || 15 < windowBits)
+    THROW("Invalid deflate window bits " << windowBits);
+
+  memset(&deflater, 0, sizeof(deflater));
+  memset(&inflater, 0, sizeof(inflater));
+
+  // Negative window bits select raw deflate without a zlib header
+  if (deflateInit2(&deflater, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                   -(int)windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    THROW("Failed to initialize deflate");
+
+  if (inflateInit2(&inflater, -15) != Z_OK) {
+    deflateEnd(&deflater);
+    THROW("Failed to initialize inflate");
+  }
+}
+
+
+WebsockDeflate::~WebsockDeflate() {
+  deflateEnd(&deflater);
+  inflateEnd(&inflater);
+}
+
+
+void WebsockDeflate::compress(const char *data, uint64_t length,
+                              string &out) {
+  out.clear();
+
+  deflater.next_in = (Bytef *)data;
+  deflater.avail_in = length;
+
+  char buffer[16384];
+  do {
+    deflater.next_out = (Bytef *)buffer;
+    deflater.avail_out = sizeof(buffer);
+
+    int ret = deflate(&deflater, Z_SYNC_FLUSH);
+    if (ret != Z_OK && ret != Z_BUF_ERROR)
+      THROW("Deflate failed: " << (deflater.msg ? deflater.msg : "?"));
+
+    out.append(buffer, sizeof(buffer) - deflater.avail_out);
+  } while (deflater.avail_in || !deflater.avail_out);
+
+  // Remove the sync flush tail, the receiver puts it back
+  if (4 <= out.size() && !out.compare(out.size() - 4, 4, tail, 4))
+    out.resize(out.size() - 4);
+
+  if (resetDeflater) deflateReset(&deflater);
+}
+
+
+void WebsockDeflate::decompress(const char *data, uint64_t length,
+                                string &out, uint64_t maxSize) {
+  out.clear();
+
+  char buffer[16384];
+  const char *input[2] = {data, tail};
+  uint64_t inputLen[2] = {length, 4};
+
+  for (unsigned i = 0; i < 2; i++) {
+    inflater.next_in = (Bytef *)input[i];
+    inflater.avail_in = inputLen[i];
+
+    do {
+      inflater.next_out = (Bytef *)buffer;
+      inflater.avail_out = sizeof(buffer);
+
+      int ret = inflate(&inflater, Z_SYNC_FLUSH);
+      out.append(buffer, sizeof(buffer) - inflater.avail_out);
+
+      if (maxSize && maxSize < out.size())
+        THROW("Decompressed message too large");
+
+      // The sender may end with a final block, start a new stream
+      if (ret == Z_STREAM_END) {
+        inflateReset(&inflater);
+        if (i) break; // Ignore the tail after a final block
+        continue;
+      }
+
+      if (ret == Z_BUF_ERROR) break; // No progress possible
+      if (ret != Z_OK)
+        THROW("Inflate failed: " << (inflater.msg ? inflater.msg : "?"));
+    } while (inflater.avail_in || !inflater.avail_out);
+  }
+
+  if (resetInflater) inflateReset(&inflater);
+}
+
+
+SmartPointer<WebsockDeflate>
+WebsockDeflate::negotiate(const string &offers, bool contextTakeover,
+                          string &response) {
+  vector<string> extensions;
+  String::tokenize(offers, extensions, ",");
+
+  for (unsigned i = 0; i < extensions.size(); i++) {
+    vector<string> params;
+    String::tokenize(extensions[i], params, ";");
+    if (params.empty() ||
+        String::toLower(String::trim(params[0])) != "permessage-deflate")
+      continue;
+
+    bool serverNoContext = !contextTakeover;
+    bool clientNoContext = !contextTakeover;
+    unsigned windowBits = 15;
+    bool limitWindow = false;
+    bool valid = true;
+    set<string> seen;
+
+    for (unsigned j = 1; j < params.size() && valid; j++) {
+      string param = String::trim(params[j]);
+      string name = param;
+      string value;
+
+      size_t eq = param.find('=');
+      if (eq != string::npos) {
+        name = String::trim(param.substr(0, eq));
+        value = String::trim(param.substr(eq + 1));
+      }
+
+      name = String::toLower(name);
+      if (!seen.insert(name).second) valid = false; // Duplicate
+
+      else if (name == "server_no_context_takeover") {
+        serverNoContext = true;
+        if (!value.empty()) valid = false;
+
+      } else if (name == "client_no_context_takeover") {
+        clientNoContext = true;
+        if (!value.empty()) valid = false;
+
+      } else if (name == "server_max_window_bits") {
+        limitWindow = true;
+        // zlib cannot produce an 8 bit window so decline this offer
+        valid = parseWindowBits(value, windowBits) && 8 < windowBits;
+
+      } else if (name == "client_max_window_bits") {
+        // Any client window can be inflated, no reply needed
+        unsigned bits;
+        if (!value.empty() && !parseWindowBits(value, bits)) valid = false;
+
+      } else valid = false; // Unknown parameter
+    }
+
+    if (!valid) continue;
+
+    response = "permessage-deflate";
+    if (serverNoContext) response += "; server_no_context_takeover";
+    if (clientNoContext) response += "; client_no_context_takeover";
+    if (limitWindow)
+      response += "; server_max_window_bits=" + String(windowBits);
+
+    return new WebsockDeflate(windowBits, serverNoContext, clientNoContext);
+  }
+
+  return 0;
+}
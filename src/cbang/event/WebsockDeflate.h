@@ -0,0 +1,87 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+#include <cbang/StdTypes.h>
+
+#include <string>
+
+#include <zlib.h>
+
+
+namespace cb {
+  namespace Event {
+    /// The permessage-deflate Websocket extension, RFC 7692
+    class WebsockDeflate {
+      z_stream deflater;
+      z_stream inflater;
+      bool resetDeflater;
+      bool resetInflater;
+
+      // Don't allow copy constructor or assignment
+      WebsockDeflate(const WebsockDeflate &o) {}
+      WebsockDeflate &operator=(const WebsockDeflate &o) {return *this;}
+
+    public:
+      /**
+       * @param windowBits the LZ77 window size used to compress.
+       * @param resetDeflater discard the compression context after each
+       *   message.
+       * @param resetInflater discard the decompression context after each
+       *   message.
+       */
+      WebsockDeflate(unsigned windowBits = 15, bool resetDeflater = false,
+                     bool resetInflater = false);
+      ~WebsockDeflate();
+
+      void compress(const char *data, uint64_t length, std::string &out);
+      /// Throws if the result would exceed @param maxSize, if non-zero
+      void decompress(const char *data, uint64_t length, std::string &out,
+                      uint64_t maxSize = 0);
+
+      /**
+       * Select the first acceptable permessage-deflate offer.
+       *
+       * @param offers the client's Sec-WebSocket-Extensions header.
+       * @param contextTakeover if false, ask both sides to discard the
+       *   compression context after each message.  This saves memory.
+       * @param response set to the accepted extension parameters.
+       * @return A new WebsockDeflate or null if no offer was acceptable.
+       */
+      static SmartPointer<WebsockDeflate>
+      negotiate(const std::string &offers, bool contextTakeover,
+                std::string &response);
+    };
+  }
+}
@@ -32,34 +32,96 @@
 
 #include "Websocket.h"
 #include "Connection.h"
+#include "Base.h"
 
 #include <cbang/Catch.h>
 #include <cbang/net/Swab.h>
+#include <cbang/os/CPUDispatch.h>
 #include <cbang/util/Random.h>
 
 #ifdef HAVE_OPENSSL
 #include <cbang/openssl/Digest.h>
 #endif
 
+#include <event2/buffer.h>
+
 #include <cstring> // memcpy()
 
+#ifdef CBANG_SIMD_X86
+#include <immintrin.h>
+#endif
+
 using namespace std;
 using namespace cb;
 using namespace cb::Event;
 
 
-void Websocket::send(const char *data, unsigned length) {
-  if (!active) return Request::send(data, length);
+namespace {
+  typedef void (*mask_t)(uint8_t *data, uint64_t length,
+                         const uint8_t mask8[8]);
 
-  const unsigned frameSize = 0xffff;
 
-  for (unsigned i = 0; length; i += frameSize) {
-    unsigned bytes = frameSize < length ? frameSize : length;
-    length -= bytes;
-    writeFrame(i ? WS_OP_CONTINUE : WS_OP_TEXT, !length, data + i, bytes);
+  void maskNone(uint8_t *data, uint64_t length, const uint8_t mask8[8]) {
+    uint64_t word;
+    memcpy(&word, mask8, 8);
+
+    // Eight bytes at a time
+    uint64_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+      uint64_t x;
+      memcpy(&x, data + i, 8);
+      x ^= word;
+      memcpy(data + i, &x, 8);
+    }
+
+    for (; i < length; i++) data[i] ^= mask8[i & 7];
   }
 
-  msgSent++;
+
+#ifdef CBANG_SIMD_X86
+  CBANG_TARGET_AVX2 void
+  maskAVX2(uint8_t *data, uint64_t length, const uint8_t mask8[8]) {
+    uint64_t word;
+    memcpy(&word, mask8, 8);
+    const __m256i mask = _mm256_set1_epi64x(word);
+
+    uint64_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+      __m256i x = _mm256_loadu_si256((const __m256i *)(data + i));
+      _mm256_storeu_si256((__m256i *)(data + i), _mm256_xor_si256(x, mask));
+    }
+
+    // Whole blocks keep the mask's phase
+    maskNone(data + i, length - i, mask8);
+  }
+
+
+  const CPUDispatch::Function<mask_t> maskFn(maskNone, 0, maskAVX2);
+
+#else // CBANG_SIMD_X86
+  const CPUDispatch::Function<mask_t> maskFn(maskNone);
+#endif // CBANG_SIMD_X86
+
+
+  /// @param offset is the position of @param data within the masked payload
+  void applyMask(uint8_t *data, uint64_t length, const uint8_t mask[4],
+                 uint64_t offset = 0) {
+    uint8_t mask8[8];
+    for (unsigned i = 0; i < 8; i++) mask8[i] = mask[(offset + i) & 3];
+    maskFn(data, length, mask8);
+  }
+}
+
+
+void Websocket::send(const char *data, unsigned length) {
+  if (!active) return Request::send(data, length);
+  sendFrames(WS_OP_TEXT, data, length);
+}
+
+
+void Websocket::sendBinary(const char *data, unsigned length) {
+  if (!active) return Request::send(data, length);
+  sendFrames(WS_OP_BINARY, data, length);
 }
 
 
@@ -69,13 +131,78 @@ void Websocket::send(const string &s) {
 }
 
 
+void Websocket::send(const Buffer &buf) {
+  if (!active) return Request::send(buf);
+  sendFrames(WS_OP_TEXT, buf);
+}
+
+
+void Websocket::sendBinary(const Buffer &buf) {
+  if (!active) return Request::send(buf);
+  sendFrames(WS_OP_BINARY, buf);
+}
+
+
+void Websocket::formatFrame(Buffer &frame, WebsockOpCode opcode,
+                            const char *data, uint64_t length) {
+  uint8_t header[10];
+  uint8_t bytes = formatHeader(header, opcode, true, length, false);
+
+  frame.expand(bytes + length);
+  frame.add((char *)header, bytes);
+  frame.add(data, length);
+}
+
+
+bool Websocket::canSendFrame() const {
+  return active && getConnection().isIncoming(); // Servers do not mask
+}
+
+
+void Websocket::sendFrame(const Buffer &frame) {
+  if (!canSendFrame()) THROW("Cannot send shared frame");
+
+  Buffer out;
+  out.addRef(frame);
+  output(out);
+  msgSent++;
+}
+
+
+unsigned Websocket::getOutputBacklog() const {
+  return getConnection().getOutputLength() +
+    (pending.isSet() ? pending->getLength() : 0);
+}
+
+
+void Websocket::setCoalescing(bool enable, double delay, unsigned maxBytes) {
+  coalesceDelay = delay;
+  coalesceBytes = maxBytes;
+  if (coalescing && !enable) flush();
+  coalescing = enable;
+}
+
+
+void Websocket::flush() {
+  if (flushEvent.isSet()) flushEvent->del();
+  onFlush();
+  if (pending.isSet() && pending->getLength())
+    getConnection().write(*this, *pending);
+}
+
+
 void Websocket::close(WebsockStatus status, const std::string &msg) {
   LOG_DEBUG(4, __func__ << '(' << status << ", " << msg << ')');
 
   if (!active) return; // Already closed
 
-  pingEvent.release();
-  pongEvent.release();
+  pingTimer.cancel();
+  pongTimer.cancel();
+  deflate.release();
+
+  // Queued messages precede the close frame
+  flush();
+  coalescing = false;
 
   uint16_t data = hton16(status);
   writeFrame(WS_OP_CLOSE, true, &data, 2);
@@ -109,6 +236,20 @@ bool Websocket::upgrade() {
     THROW("Cannot open Websocket, C! not built with openssl support");
 #endif
 
+    // Negotiate subprotocol
+    vector<string> offered;
+    String::tokenize(inFind("Sec-WebSocket-Protocol"), offered, ", \t");
+    protocol = selectProtocol(offered);
+    if (!protocol.empty()) outSet("Sec-WebSocket-Protocol", protocol);
+
+    // Negotiate compression
+    if (deflateEnabled) {
+      string response;
+      deflate = WebsockDeflate::negotiate
+        (inFind("Sec-WebSocket-Extensions"), deflateContextTakeover, response);
+      if (deflate.isSet()) outSet("Sec-WebSocket-Extensions", response);
+    }
+
     setVersion(Version(1, 1));
     outSet("Upgrade", "websocket");
     outSet("Connection", "upgrade");
@@ -163,31 +304,51 @@ bool Websocket::readHeader(Buffer &input) {
   uint8_t opcode = header[0] & 0xf;
   wsOpCode = (WebsockOpCode::enum_t)opcode;
 
-  if (wsOpCode != WS_OP_CONTINUE) wsMsg.clear();
+  // RSV1 marks a compressed message and is only valid on its first frame
+  bool rsv1 = header[0] & 0x40;
+  if ((header[0] & 0x30) || (rsv1 && (deflate.isNull() ||
+                                      (wsOpCode != WS_OP_TEXT &&
+                                       wsOpCode != WS_OP_BINARY)))) {
+    close(WS_STATUS_PROTOCOL);
+    return false;
+  }
+
+  // Copy mask
+  memcpy(wsMask, &header[bytes - 4], 4);
+  frameOffset = 0;
+
+  // Last part of message?
+  wsFinish = 0x80 & header[0];
 
   switch (wsOpCode) {
   case WS_OP_TEXT:
   case WS_OP_BINARY:
   case WS_OP_CONTINUE: {
+    if (wsOpCode != WS_OP_CONTINUE) {
+      wsMsg.clear();
+      streamedBytes = 0;
+      wsCompressed = rsv1;
+    }
+
     // Check total message size
     auto maxBodySize = getConnection().getMaxBodySize();
-    if (maxBodySize && maxBodySize < wsMsg.size() + bytesToRead) {
+    if (maxBodySize &&
+        maxBodySize < wsMsg.size() + streamedBytes + bytesToRead) {
       close(WS_STATUS_TOO_BIG);
       return false;
     }
-
-    // Copy mask
-    memcpy(wsMask, &header[bytes - 4], 4);
-
-    // Last part of message?
-    wsFinish = 0x80 & header[0];
     break;
   }
 
   case WS_OP_CLOSE:
   case WS_OP_PING:
   case WS_OP_PONG:
-    break; // Control codes
+    // Control frames may arrive between fragments but are never fragmented
+    if (!wsFinish || 125 < bytesToRead) {
+      close(WS_STATUS_PROTOCOL);
+      return false;
+    }
+    break;
 
   default: {
     close(WS_STATUS_PROTOCOL);
@@ -203,94 +364,183 @@ bool Websocket::readBody(Buffer &input) {
   LOG_DEBUG(4, __func__ << "() bytesToRead=" << bytesToRead
             << " inBuf=" << input.getLength());
 
+  bool dataFrame = wsOpCode == WS_OP_TEXT || wsOpCode == WS_OP_BINARY ||
+    wsOpCode == WS_OP_CONTINUE;
+  if (streaming && dataFrame && !wsCompressed) return streamBody(input);
+
   if (input.getLength() < bytesToRead) return false; // Wait for more
 
+  // Deliver unfragmented messages straight from the input buffer
+  if (dataFrame && wsFinish && !wsCompressed && wsMsg.empty()) {
+    char *data = bytesToRead ? input.pullup(bytesToRead) : 0;
+    applyMask((uint8_t *)data, bytesToRead, wsMask);
+
+    if (streaming) fragment(data, bytesToRead, true);
+    else message(data, bytesToRead);
+
+    input.drain(bytesToRead);
+    return true;
+  }
+
+  // Control frames
+  if (!dataFrame) {
+    string payload(bytesToRead, 0);
+    if (bytesToRead) input.remove(&payload[0], bytesToRead);
+    applyMask((uint8_t *)&payload[0], bytesToRead, wsMask);
+
+    switch (wsOpCode) {
+    case WS_OP_CLOSE: {
+      // Get close status
+      WebsockStatus status = WS_STATUS_NONE;
+      if (1 < bytesToRead)
+        status = (WebsockStatus::enum_t)hton16(*(uint16_t *)payload.data());
+
+      // Send close response and close payload if any
+      close(status, 2 < bytesToRead ? payload.substr(2) : string());
+      break;
+    }
+
+    case WS_OP_PING:
+      // Schedule pong to aggregate backlogged pings
+      pongPayload = payload;
+      schedulePong();
+      schedulePing();
+      break;
+
+    case WS_OP_PONG: schedulePing(); break;
+
+    default: close(WS_STATUS_PROTOCOL); break;
+    }
+
+    return true;
+  }
+
   uint64_t offset = wsMsg.size();
   wsMsg.resize(offset + bytesToRead);
   input.remove(&wsMsg[offset], bytesToRead);
 
-  // Demask
-  for (uint64_t i = 0; i < bytesToRead; i++)
-    wsMsg[offset +  i] ^= wsMask[i & 3];
+  applyMask((uint8_t *)&wsMsg[offset], bytesToRead, wsMask);
 
   LOG_DEBUG(5, "Frame body\n"
             << String::hexdump(string(wsMsg.begin() + offset, wsMsg.end()))
             << '\n');
 
-  switch (wsOpCode) {
-  case WS_OP_CONTINUE:
-  case WS_OP_TEXT:
-  case WS_OP_BINARY:
-    if (wsFinish) {
-      message(wsMsg.data(), wsMsg.size());
-      wsMsg.clear();
+  if (!wsFinish) return true;
+
+  if (wsCompressed) {
+    string msg;
+
+    try {
+      deflate->decompress(wsMsg.data(), wsMsg.size(), msg,
+                          getConnection().getMaxBodySize());
+    } catch (const Exception &e) {
+      LOG_WARNING("Websocket decompression failed: " << e.getMessage());
+      close(WS_STATUS_TOO_BIG);
+      return true;
     }
-    break;
 
-  case WS_OP_CLOSE: {
-    // Get close status
-    WebsockStatus status = WS_STATUS_NONE;
-    if (1 < bytesToRead)
-      status = (WebsockStatus::enum_t)hton16(*(uint16_t *)wsMsg.data());
+    vector<char>().swap(wsMsg); // Release idle memory
+    if (streaming) fragment(msg.data(), msg.size(), true);
+    else message(msg.data(), msg.size());
 
-    // Send close response and close payload if any
-    close(status, string(wsMsg.begin() + 2, wsMsg.end()));
-    break;
+  } else {
+    message(wsMsg.data(), wsMsg.size());
+    vector<char>().swap(wsMsg); // Release idle memory
   }
 
-  case WS_OP_PING:
-    // Schedule pong to aggregate backlogged pings
-    pongPayload = string(wsMsg.begin(), wsMsg.end());
-    schedulePong();
-    schedulePing();
-    break;
+  return true;
+}
+
+
+bool Websocket::streamBody(Buffer &input) {
+  uint64_t length = input.getLength();
+  if (bytesToRead < length) length = bytesToRead;
+  if (!length && bytesToRead) return false; // Wait for more
 
-  case WS_OP_PONG: schedulePing(); break;
+  // Demask and deliver each contiguous part of the input buffer in place
+  vector<iovec> space;
+  while (length) {
+    space.resize(16);
+    input.peek(length, space);
 
-  default: close(WS_STATUS_PROTOCOL); break;
+    uint64_t delivered = 0;
+    for (unsigned i = 0; i < space.size() && delivered < length; i++) {
+      uint64_t bytes = space[i].iov_len;
+      if (length - delivered < bytes) bytes = length - delivered;
+
+      uint8_t *data = (uint8_t *)space[i].iov_base;
+      applyMask(data, bytes, wsMask, frameOffset);
+      frameOffset += bytes;
+      delivered += bytes;
+
+      bool final = wsFinish && delivered == bytesToRead;
+      fragment((const char *)data, bytes, final);
+      if (!active) return true; // Closed by callback
+    }
+
+    input.drain(delivered);
+    bytesToRead -= delivered;
+    streamedBytes += delivered;
+    length -= delivered;
   }
 
-  return true;
+  if (!frameOffset && wsFinish) fragment(0, 0, true); // Empty final frame
+
+  return !bytesToRead;
 }
 
 
-void Websocket::onMessage(const char *data, uint64_t length) {
-  if (cb) cb(data, length);
+void Websocket::fragment(const char *data, uint64_t length, bool final) {
+  if (final) msgReceived++;
+  schedulePing();
+  TRY_CATCH_ERROR(return onFragment(data, length, final));
+  close(WS_STATUS_UNACCEPTABLE, "Message rejected");
 }
 
 
+void Websocket::onMessage(const char *data, uint64_t length) {
+  if (cb) cb(data, length);
+}
 
-void Websocket::writeFrame(WebsockOpCode opcode, bool finish,
-                           const void *data, uint64_t len) {
-  LOG_DEBUG(4, __func__ << '(' << opcode << ", " << finish << ", " << len
-            << ')');
 
-  if (!active) THROW("Not active");
-
-  uint8_t header[14];
-  uint8_t bytes = 2;
 
+uint8_t Websocket::formatHeader(uint8_t *header, WebsockOpCode opcode,
+                                bool finish, uint64_t len, bool compressed) {
   // Opcode
-  header[0] = (finish ? 0x80 : 0) | opcode;
+  header[0] = (finish ? 0x80 : 0) | (compressed ? 0x40 : 0) | opcode;
 
   // Format payload length
-  if (len < 126) header[1] = len;
+  if (len < 126) {
+    header[1] = len;
+    return 2;
+  }
 
-  else if (len <= 0xffff) {
+  if (len <= 0xffff) {
     header[1] = 126;
     *(uint16_t *)&header[2] = hton16(len);
-    bytes = 4;
-
-  } else {
-    header[1] = 127;
-    *(uint64_t *)&header[2] = hton64(len);
-    bytes = 10;
+    return 4;
   }
 
+  header[1] = 127;
+  *(uint64_t *)&header[2] = hton64(len);
+  return 10;
+}
+
+
+void Websocket::writeFrame(WebsockOpCode opcode, bool finish,
+                           const void *data, uint64_t len, bool compressed) {
+  LOG_DEBUG(4, __func__ << '(' << opcode << ", " << finish << ", " << len
+            << ')');
+
+  if (!active) THROW("Not active");
+
+  uint8_t header[14];
+  uint8_t bytes = formatHeader(header, opcode, finish, len, compressed);
+
   // Create mask
   bool maskData = !getConnection().isIncoming();
   if (maskData) {
-    header[1] &= 1 << 7; // Set mask bit
+    header[1] |= 1 << 7; // Set mask bit
 
     // Generate random mask
     Random::instance().bytes(header + bytes, 4);
@@ -303,44 +553,106 @@ void Websocket::writeFrame(WebsockOpCode opcode, bool finish,
   out.add((char *)data, len);
 
   // Mask data
-  if (maskData) {
-    uint8_t *ptr = (uint8_t *)out.pullup(len + bytes) + bytes;
-    uint8_t *mask = &header[bytes - 4];
+  if (maskData)
+    applyMask((uint8_t *)out.pullup(len + bytes) + bytes, len,
+              &header[bytes - 4]);
 
-    for (uint64_t i = 0; i < len; i++)
-      ptr[i] ^= mask[i & 3];
+  output(out);
+}
+
+
+void Websocket::sendFrames(WebsockOpCode opcode, const char *data,
+                           unsigned length) {
+  const unsigned frameSize = 0xffff;
+
+  string compressed;
+  bool compress = deflate.isSet() && deflateMinSize <= length;
+  if (compress) {
+    deflate->compress(data, length, compressed);
+    data = compressed.data();
+    length = compressed.size();
   }
 
-  getConnection().write(*this, out);
+  for (unsigned i = 0; length; i += frameSize) {
+    unsigned bytes = frameSize < length ? frameSize : length;
+    length -= bytes;
+    writeFrame(i ? WS_OP_CONTINUE : (WebsockOpCode::enum_t)opcode, !length,
+               data + i, bytes, compress && !i);
+  }
+
+  msgSent++;
+}
+
+
+void Websocket::sendFrames(WebsockOpCode opcode, const Buffer &buf) {
+  uint64_t length = buf.getLength();
+
+  // Masked or compressed payloads must be copied
+  if (!getConnection().isIncoming() ||
+      (deflate.isSet() && deflateMinSize <= length)) {
+    string s = buf.toString();
+    return sendFrames(opcode, s.data(), s.size());
+  }
+
+  if (!active) THROW("Not active");
+
+  // Send as a single frame which references the payload
+  uint8_t header[10];
+  uint8_t bytes = formatHeader(header, opcode, true, length, false);
+
+  Buffer out;
+  out.add((char *)header, bytes);
+  out.addRef(buf);
+
+  output(out);
+  msgSent++;
+}
+
+
+void Websocket::scheduleFlush() {
+  if (flushEvent.isNull())
+    flushEvent = getConnection().getBase().newEvent
+      ([this] () {flush();}, EF::EVENT_NO_SELF_REF);
+
+  if (!coalesceDelay) flushEvent->activate();
+  else if (!flushEvent->isPending()) flushEvent->add(coalesceDelay);
+}
+
+
+void Websocket::output(Buffer &frame) {
+  unsigned length = frame.getLength();
+
+  if (coalescing && length < coalesceBytes) {
+    // Copy small frames so they share chains and TLS records
+    if (pending.isNull()) pending = new Buffer;
+    pending->add(frame.pullup(), length);
+    if (coalesceBytes <= pending->getLength()) flush();
+    else scheduleFlush();
+    return;
+  }
+
+  flush(); // Keep frames in order
+  getConnection().write(*this, frame);
 }
 
 
 void Websocket::pong() {
   writeFrame(WS_OP_PONG, true, pongPayload.data(), pongPayload.size());
-  pongPayload.clear();
+  string().swap(pongPayload);
 }
 
 
 void Websocket::schedulePong() {
-  if (pongEvent.isNull()) {
-    auto cb = [this] () {pong();};
-    pongEvent = getConnection().getBase().newEvent(cb, EVENT_NO_SELF_REF);
-  }
-
-  if (pongEvent.isSet() && !pongEvent->isPending()) pongEvent->add(5);
+  if (pongTimer.isPending()) return;
+  pongTimer.setCallback([this] () {pong();});
+  pongTimer.schedule(getConnection().getBase().getTimerWheel(), 5);
 }
 
 
 void Websocket::schedulePing() {
-  if (pingEvent.isNull()) {
-    auto cb = [this] () {ping(); schedulePing();};
-    pingEvent = getConnection().getBase().newEvent(cb, EVENT_NO_SELF_REF);
-  }
-
-  if (pingEvent.isSet()) {
-    double timeout = getConnection().getReadTimeout();
-    pingEvent->add(timeout / 2);
-  }
+  pingTimer.setCallback([this] () {ping(); schedulePing();});
+  double timeout = getConnection().getReadTimeout();
+  pingTimer.schedule(getConnection().getBase().getTimerWheel(), timeout / 2);
 }
 
 
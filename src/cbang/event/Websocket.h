@@ -34,6 +34,8 @@
 
 #include "Request.h"
 #include "Event.h"
+#include "TimerWheel.h"
+#include "WebsockDeflate.h"
 
 #include <functional>
 
@@ -50,28 +52,96 @@ namespace cb {
       WebsockOpCode wsOpCode;
       uint8_t wsMask[4];
       bool wsFinish = false;
+      bool wsCompressed = false;
       std::vector<char> wsMsg;
+      uint64_t frameOffset = 0;
+      uint64_t streamedBytes = 0;
+      bool streaming = false;
+
+      bool deflateEnabled = false;
+      bool deflateContextTakeover = true;
+      unsigned deflateMinSize = 64;
+      SmartPointer<WebsockDeflate> deflate;
 
       std::string pongPayload;
-      SmartPointer<Event> pingEvent;
-      SmartPointer<Event> pongEvent;
+      TimerWheel::Timer pingTimer;
+      TimerWheel::Timer pongTimer;
+
+      bool coalescing = false;
+      double coalesceDelay = 0;
+      unsigned coalesceBytes = 1 << 16;
+      SmartPointer<Buffer> pending; ///< Allocated when first coalescing
+      SmartPointer<Event> flushEvent;
 
       uint64_t msgSent = 0;
       uint64_t msgReceived = 0;
 
+      std::string protocol;
+
     public:
       using Request::Request;
 
       bool isActive() const {return active;}
+      /// The subprotocol selected during the upgrade, if any
+      const std::string &getProtocol() const {return protocol;}
 
       void setCallback(const cb_t &cb) {this->cb = cb;}
 
+      /// Accept permessage-deflate if the client offers it, set before upgrade
+      void setDeflateEnabled(bool x) {deflateEnabled = x;}
+      bool getDeflateEnabled() const {return deflateEnabled;}
+      /// If false, compress each message independently to save memory
+      void setDeflateContextTakeover(bool x) {deflateContextTakeover = x;}
+      bool getDeflateContextTakeover() const {return deflateContextTakeover;}
+      /// Messages shorter than this are sent uncompressed
+      void setDeflateMinSize(unsigned x) {deflateMinSize = x;}
+      unsigned getDeflateMinSize() const {return deflateMinSize;}
+      bool isDeflateActive() const {return deflate.isSet();}
+
+      /**
+       * Deliver data messages to onFragment() as they arrive rather than
+       * assembling them for onMessage().  Compressed messages are still
+       * assembled and delivered as a single final fragment.
+       */
+      void setStreaming(bool x) {streaming = x;}
+      bool isStreaming() const {return streaming;}
+
+      /**
+       * Queue outgoing frames and write them to the connection together so
+       * that many small messages make fewer writes and TLS records.  Queued
+       * frames are written at the end of the current event loop iteration,
+       * or after @param delay seconds, or once @param maxBytes are queued.
+       */
+      void setCoalescing(bool enable, double delay = 0,
+                         unsigned maxBytes = 1 << 16);
+      bool isCoalescing() const {return coalescing;}
+      double getCoalesceDelay() const {return coalesceDelay;}
+      unsigned getCoalesceBytes() const {return coalesceBytes;}
+      /// Write queued frames now
+      void flush();
+
       uint64_t getMessagesSent() const {return msgSent;}
       uint64_t getMessagesReceived() const {return msgReceived;}
 
       void send(const char *data, unsigned length);
       void send(const std::string &s);
+      void send(std::string &&s) {send((const std::string &)s);}
       void send(const char *s) {send(std::string(s));}
+      void sendBinary(const char *data, unsigned length);
+      /// Unless compressed or masked, @param buf is referenced not copied
+      /// and must not be modified until sent.
+      void send(const Buffer &buf);
+      void sendBinary(const Buffer &buf);
+
+      /// Build an unmasked, uncompressed frame which may be shared
+      static void formatFrame(Buffer &frame, WebsockOpCode opcode,
+                              const char *data, uint64_t length);
+      /// Can frames from formatFrame() be sent on this connection?
+      bool canSendFrame() const;
+      /// Reference a frame built by formatFrame()
+      void sendFrame(const Buffer &frame);
+      /// Output bytes not yet written to the socket
+      unsigned getOutputBacklog() const;
 
       void close(WebsockStatus status, const std::string &msg = "");
       void ping(const std::string &payload = "");
@@ -86,16 +156,32 @@ namespace cb {
 
       // Callbacks
       virtual bool onUpgrade() {return true;}
+      /// Select one of the Sec-WebSocket-Protocol values offered by the client
+      virtual std::string
+      selectProtocol(const std::vector<std::string> &offered) {return "";}
       virtual void onOpen() {}
       virtual void onMessage(const char *data, uint64_t length);
+      /// Called in streaming mode with parts of a message, in order
+      virtual void onFragment(const char *data, uint64_t length, bool final) {}
       virtual void onClose(WebsockStatus status, const std::string &msg) {}
 
     protected:
       using Request::send;
       using Request::reply;
 
+      /// Called before queued frames are written
+      virtual void onFlush() {}
+      void scheduleFlush();
+      void output(Buffer &frame);
+
+      void sendFrames(WebsockOpCode opcode, const char *data, unsigned length);
+      void sendFrames(WebsockOpCode opcode, const Buffer &buf);
+      static uint8_t formatHeader(uint8_t *header, WebsockOpCode opcode,
+                                  bool finish, uint64_t len, bool compressed);
       void writeFrame(WebsockOpCode opcode, bool finish,
-                      const void *data, uint64_t len);
+                      const void *data, uint64_t len, bool compressed = false);
+      bool streamBody(Buffer &input);
+      void fragment(const char *data, uint64_t length, bool final);
       void pong();
       void schedulePong();
       void schedulePing();
@@ -0,0 +1,143 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "WebsocketGroup.h"
+#include "JSONWebsocket.h"
+
+#include <cbang/Catch.h>
+#include <cbang/json/CBORWriter.h>
+
+#include <sstream>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Event;
+
+
+void WebsocketGroup::remove(Websocket &ws) {
+  members.erase(SmartPointer<Websocket>(&ws));
+}
+
+
+bool WebsocketGroup::has(Websocket &ws) const {
+  return members.count(SmartPointer<Websocket>(&ws));
+}
+
+
+unsigned WebsocketGroup::broadcast(const string &msg) {
+  return broadcast(WS_OP_TEXT, msg.data(), msg.size());
+}
+
+
+unsigned WebsocketGroup::broadcastBinary(const char *data, unsigned length) {
+  return broadcast(WS_OP_BINARY, data, length);
+}
+
+
+unsigned WebsocketGroup::broadcast(const JSON::Value &msg) {
+  // Encode and frame each format once, on first use
+  string text;
+  string cbor;
+  Buffer textFrame;
+  Buffer cborFrame;
+
+  return forEach([&] (Websocket &ws) {
+      JSONWebsocket *jws = dynamic_cast<JSONWebsocket *>(&ws);
+      bool isCBOR = jws && jws->isCBOR();
+      string &payload = isCBOR ? cbor : text;
+      Buffer &frame = isCBOR ? cborFrame : textFrame;
+
+      if (!frame.getLength()) {
+        if (isCBOR) {
+          ostringstream str;
+          JSON::CBORWriter writer(str);
+          msg.write(writer);
+          writer.close();
+          payload = str.str();
+
+        } else payload = msg.toString();
+
+        Websocket::formatFrame(frame, isCBOR ? WS_OP_BINARY : WS_OP_TEXT,
+                               payload.data(), payload.size());
+      }
+
+      if (ws.canSendFrame()) ws.sendFrame(frame);
+      else if (isCBOR) ws.sendBinary(payload.data(), payload.size());
+      else ws.send(payload);
+    });
+}
+
+
+bool WebsocketGroup::isSlow(Websocket &ws) {
+  if (!highWaterMark || ws.getOutputBacklog() <= highWaterMark) return false;
+
+  if (slowPolicy == SLOW_CLOSE) {
+    LOG_INFO(3, "Closing slow Websocket " << ws.getID());
+    ws.close(WS_STATUS_VIOLATION, "Too slow");
+    closed++;
+
+  } else dropped++;
+
+  return true;
+}
+
+
+unsigned WebsocketGroup::forEach(const function<void (Websocket &)> &cb) {
+  unsigned count = 0;
+
+  for (auto it = members.begin(); it != members.end();) {
+    Websocket &ws = **it;
+
+    if (ws.isActive() && !isSlow(ws)) {
+      TRY_CATCH_ERROR(cb(ws); count++);
+    }
+
+    // Drop closed members
+    if (ws.isActive()) it++;
+    else it = members.erase(it);
+  }
+
+  return count;
+}
+
+
+unsigned WebsocketGroup::broadcast(WebsockOpCode opcode, const char *data,
+                                   unsigned length) {
+  Buffer frame;
+  Websocket::formatFrame(frame, opcode, data, length);
+
+  return forEach([&] (Websocket &ws) {
+      if (ws.canSendFrame()) ws.sendFrame(frame);
+      else if (opcode == WS_OP_BINARY) ws.sendBinary(data, length);
+      else ws.send(data, length);
+    });
+}
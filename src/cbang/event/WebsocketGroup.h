@@ -0,0 +1,99 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Websocket.h"
+#include "Enum.h"
+
+#include <cbang/json/Value.h>
+
+#include <set>
+
+
+namespace cb {
+  namespace Event {
+    /**
+     * Sends the same message to many Websockets.  Each message is encoded
+     * and framed once then referenced, not copied, into every member's
+     * output buffer.  Members whose output backlog exceeds the high-water
+     * mark are treated as slow consumers.  Members are removed once they
+     * close.  Not thread safe, use from the members' event loop.
+     */
+    class WebsocketGroup : public Enum {
+    public:
+      typedef enum {
+        SLOW_DROP,  ///< Skip messages for slow members
+        SLOW_CLOSE, ///< Close slow members
+      } slow_policy_t;
+
+    protected:
+      typedef std::set<SmartPointer<Websocket> > members_t;
+      members_t members;
+
+      unsigned highWaterMark = 1024 * 1024;
+      slow_policy_t slowPolicy = SLOW_DROP;
+      uint64_t dropped = 0;
+      uint64_t closed = 0;
+
+    public:
+      void add(const SmartPointer<Websocket> &ws) {members.insert(ws);}
+      void remove(Websocket &ws);
+      bool has(Websocket &ws) const;
+      unsigned size() const {return members.size();}
+      bool empty() const {return members.empty();}
+      void clear() {members.clear();}
+
+      unsigned getHighWaterMark() const {return highWaterMark;}
+      void setHighWaterMark(unsigned x) {highWaterMark = x;}
+      slow_policy_t getSlowPolicy() const {return slowPolicy;}
+      void setSlowPolicy(slow_policy_t x) {slowPolicy = x;}
+
+      /// Messages not sent to slow members
+      uint64_t getDropped() const {return dropped;}
+      /// Slow members closed
+      uint64_t getClosed() const {return closed;}
+
+      /// @return The number of members the message was sent to
+      unsigned broadcast(const std::string &msg);
+      unsigned broadcastBinary(const char *data, unsigned length);
+      /// Sends CBOR to JSONWebsocket members which negotiated it
+      unsigned broadcast(const JSON::Value &msg);
+
+    protected:
+      bool isSlow(Websocket &ws);
+      unsigned forEach(const std::function<void (Websocket &)> &cb);
+      unsigned broadcast(WebsockOpCode opcode, const char *data,
+                         unsigned length);
+    };
+  }
+}
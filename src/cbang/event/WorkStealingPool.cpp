@@ -0,0 +1,181 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "WorkStealingPool.h"
+
+#include <cbang/Catch.h>
+
+using namespace cb::Event;
+using namespace cb;
+using namespace std;
+
+
+WorkStealingPool::WorkStealingPool(cb::Event::Base &base, unsigned size) :
+  ThreadPool(size), base(base),
+  event(base.newEvent(this, &WorkStealingPool::complete,
+                      EF::EVENT_NO_SELF_REF)),
+  nextWorker(0), numReady(0), numActive(0), numCompleted(0), numSleeping(0),
+  notified(false) {
+  if (!Base::threadsEnabled())
+    THROW("Cannot use Event::WorkStealingPool without threads enabled.  "
+          "Call Event::Base::enableThreads() before creating Event::Base.");
+
+  if (!size) THROW("WorkStealingPool size must be greater than zero");
+
+  for (unsigned i = 0; i < size; i++) workers.push_back(new Worker);
+}
+
+
+WorkStealingPool::~WorkStealingPool() {}
+
+
+void WorkStealingPool::submit(const SmartPointer<Task> &task) {
+  Worker &worker = *workers[nextWorker++ % workers.size()];
+
+  {
+    SmartLock lock(&worker.lock);
+    worker.ready.push(task);
+  }
+
+  numReady++;
+
+  // Wake a sleeping worker.  Holding the lock ensures the signal cannot be
+  // lost between a worker's final check for work and its wait.
+  if (numSleeping) {
+    SmartLock lock(&idle);
+    idle.signal();
+  }
+}
+
+
+void WorkStealingPool::stop() {
+  ThreadPool::stop();
+
+  SmartLock lock(&idle);
+  idle.broadcast();
+}
+
+
+void WorkStealingPool::join() {
+  stop();
+  ThreadPool::wait();
+}
+
+
+unsigned WorkStealingPool::getWorkerIndex() const {
+  Thread *self = &Thread::current();
+
+  unsigned i = 0;
+  for (auto it = begin(); it != end(); it++, i++)
+    if (it->get() == self) return i;
+
+  THROW("Not a WorkStealingPool thread");
+}
+
+
+SmartPointer<WorkStealingPool::Task> WorkStealingPool::take(unsigned index) {
+  // Try our own queue first then steal from the others
+  for (unsigned i = 0; i < workers.size(); i++) {
+    Worker &worker = *workers[(index + i) % workers.size()];
+
+    SmartLock lock(&worker.lock);
+    if (worker.ready.empty()) continue;
+
+    SmartPointer<Task> task = worker.ready.top();
+    worker.ready.pop();
+    numReady--;
+
+    return task;
+  }
+
+  return 0;
+}
+
+
+void WorkStealingPool::sleep() {
+  SmartLock lock(&idle);
+
+  numSleeping++;
+  if (!numReady && !Thread::current().shouldShutdown()) idle.wait();
+  numSleeping--;
+}
+
+
+void WorkStealingPool::run() {
+  unsigned index = getWorkerIndex();
+
+  while (!Thread::current().shouldShutdown()) {
+    SmartPointer<Task> task = take(index);
+    if (task.isNull()) {sleep(); continue;}
+
+    numActive++;
+
+    try {
+      task->run();
+
+    } catch (const Exception &e) {
+      task->setException(e);
+
+    } catch (const std::exception &e) {
+      task->setException(string(e.what()));
+
+    } catch (...) {
+      task->setException(string("Unknown exception"));
+    }
+
+    numCompleted++;
+    numActive--;
+    completed.transfer(task);
+
+    // Only wake the event loop if it has not already been notified
+    if (!notified.exchange(true)) event->activate();
+  }
+}
+
+
+void WorkStealingPool::complete() {
+  notified.exchange(false);
+
+  SmartPointer<Task> task;
+  while (completed.pop(task)) {
+    numCompleted--;
+
+    try {
+      if (task->getFailed()) task->error(task->getException());
+      else task->success();
+    } CATCH_ERROR;
+
+    try {task->complete();} CATCH_ERROR;
+  }
+
+  task.release();
+}
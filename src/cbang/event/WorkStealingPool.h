@@ -0,0 +1,122 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "ConcurrentPool.h"
+
+#include <cbang/os/SpinLock.h>
+#include <cbang/util/MPSCQueue.h>
+
+#include <atomic>
+#include <vector>
+
+
+namespace cb {
+  namespace Event {
+    /**
+     * A drop-in alternative to ConcurrentPool for many worker threads
+     * running short tasks.  Each worker has its own ready queue, guarded by
+     * a SpinLock, and idle workers steal from the others.  Completed tasks
+     * are passed back to the event loop through a lock-free queue and
+     * delivered in batches.  Task priority is honored per worker queue.
+     */
+    class WorkStealingPool : protected ThreadPool {
+    public:
+      typedef ConcurrentPool::Task Task;
+      template <typename Data>
+      using QueuedTask = ConcurrentPool::QueuedTask<Data>;
+      template <typename Data>
+      using TaskFunctions = ConcurrentPool::TaskFunctions<Data>;
+
+    protected:
+      typedef std::priority_queue<SmartPointer<Task>,
+                                  std::vector<SmartPointer<Task> >,
+                                  ConcurrentPool::TaskPtrCompare> queue_t;
+
+      struct Worker {
+        SpinLock lock;
+        queue_t ready;
+      };
+
+      Base &base;
+      SmartPointer<Event> event;
+
+      std::vector<SmartPointer<Worker> > workers;
+      MPSCQueue<SmartPointer<Task> > completed;
+      Condition idle;
+
+      std::atomic<unsigned> nextWorker;
+      std::atomic<unsigned> numReady;
+      std::atomic<unsigned> numActive;
+      std::atomic<unsigned> numCompleted;
+      std::atomic<unsigned> numSleeping;
+      std::atomic<bool> notified;
+
+    public:
+      WorkStealingPool(Base &base, unsigned size);
+      ~WorkStealingPool();
+
+      void setEventPriority(int priority) {event->setPriority(priority);}
+
+      unsigned getNumReady() const {return numReady;}
+      unsigned getNumActive() const {return numActive;}
+      unsigned getNumCompleted() const {return numCompleted;}
+
+      void submit(const SmartPointer<Task> &task);
+
+      template <typename Data>
+      void submit(int priority, typename TaskFunctions<Data>::run_cb_t run,
+                  typename TaskFunctions<Data>::success_cb_t success = 0,
+                  typename TaskFunctions<Data>::error_cb_t error = 0,
+                  typename TaskFunctions<Data>::complete_cb_t complete = 0) {
+        submit(new TaskFunctions<Data>
+               (priority, run, success, error, complete));
+      }
+
+      // From ThreadPool
+      using ThreadPool::start;
+      void stop();
+      void join();
+
+    protected:
+      unsigned getWorkerIndex() const;
+      SmartPointer<Task> take(unsigned index);
+      void sleep();
+
+      // From ThreadPool
+      void run();
+
+      void complete();
+    };
+  }
+}
@@ -0,0 +1,97 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "Buffer.h"
+#include "BufferDevice.h"
+
+#include <cbang/xml/XMLWriter.h>
+
+#include <functional>
+
+
+namespace cb {
+  namespace Event {
+    /**
+     * An XMLWriter which writes directly into reserved space at the end of
+     * an Event::Buffer, like JSONBufferWriter.  Output is committed to the
+     * Buffer on flush() or destruction and whenever the reserved space is
+     * full.  The Buffer must not be otherwise modified while output is
+     * pending.
+     *
+     * With a chunk callback, the callback is called each time at least the
+     * chunk size has been committed.  It should remove the data it sends,
+     * as Request::sendChunk() does, so that large documents are streamed.
+     */
+    class XMLBufferWriter : public XMLWriter {
+    public:
+      typedef std::function<void (Buffer &buffer)> chunk_cb_t;
+
+    private:
+      Buffer buffer;
+      BufferStream<> stream;
+
+      unsigned reserveSize;
+      char *start = 0;
+      char *ptr = 0;
+      char *end = 0;
+
+      unsigned chunkSize = 0;
+      chunk_cb_t chunkCB;
+
+    public:
+      XMLBufferWriter(const Buffer &buffer, bool pretty = false,
+                      unsigned reserveSize = 4096);
+      ~XMLBufferWriter();
+
+      const Buffer &getBuffer() const {return buffer;}
+
+      /// Call @param cb once at least @param chunkSize bytes are committed
+      void setChunkCallback(unsigned chunkSize, const chunk_cb_t &cb);
+
+      /// Commit pending output, then call the chunk callback if set
+      void flush();
+
+    protected:
+      void commit();
+      void checkChunk();
+      void reserve(size_t n);
+
+      // From XMLWriter
+      void put(char c) {if (ptr == end) reserve(1); *ptr++ = c;}
+      void put(const char *s, size_t n);
+      using XMLWriter::put;
+    };
+  }
+}
@@ -0,0 +1,515 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Primitive.h"
+
+#include <cbang/os/ThreadPool.h>
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+
+
+namespace cb {
+  /**
+   * A bounding volume hierarchy over Segments, Triangles, Rectangles or
+   * points, built with the binned surface area heuristic.  Nodes are
+   * stored depth first in one array: an interior node's first child
+   * follows it and the second is at @c offset.  Query results are indices
+   * into the primitives passed to build().
+   */
+  template <const unsigned DIM, typename T, typename P = Segment<DIM, T> >
+  class BVH {
+  public:
+    typedef Rectangle<DIM, T> Bounds_T;
+    typedef Vector<DIM, T> Point_T;
+    typedef std::pair<T, unsigned> result_t;
+
+    struct Node {
+      Bounds_T bounds;
+      uint32_t offset; // Second child or first primitive
+      uint32_t count;  // Zero for interior nodes
+
+      bool isLeaf() const {return count;}
+    };
+
+    static const unsigned BINS = 16;
+    static const unsigned MAX_LEAF = 16;
+    /// Deeper nodes split at the median so the stacks below cannot overflow
+    static const unsigned MAX_SAH_DEPTH = 64;
+    static const unsigned STACK_SIZE = MAX_SAH_DEPTH + 64;
+
+  protected:
+    std::vector<P> primitives;
+    std::vector<Node> nodes;
+    std::vector<uint32_t> order;
+
+    // Build state
+    std::vector<Bounds_T> bounds;
+    std::vector<Point_T> centroids;
+
+    struct Subtree {
+      uint32_t begin;
+      uint32_t end;
+      unsigned depth;
+      std::vector<Node> nodes;
+    };
+
+    // Top of the tree built before the subtrees are built in parallel
+    struct TopNode {
+      Bounds_T bounds;
+      int left;
+      int right;
+      int subtree;
+    };
+
+    class Builder : public ThreadPool {
+      BVH &bvh;
+      std::vector<Subtree> &subtrees;
+      std::atomic<unsigned> next;
+
+    public:
+      Builder(unsigned threads, BVH &bvh, std::vector<Subtree> &subtrees) :
+        ThreadPool(threads), bvh(bvh), subtrees(subtrees), next(0) {}
+
+    protected:
+      void run() {
+        while (true) {
+          unsigned i = next++;
+          if (subtrees.size() <= i) break;
+
+          Subtree &s = subtrees[i];
+          bvh.buildNode(s.nodes, s.begin, s.end, s.depth);
+        }
+      }
+    };
+
+  public:
+    BVH() {}
+    BVH(const std::vector<P> &primitives, unsigned threads = 1)
+    {build(primitives, threads);}
+
+    unsigned size() const {return primitives.size();}
+    bool empty() const {return primitives.empty();}
+    const P &get(unsigned i) const {return primitives.at(i);}
+    const std::vector<P> &getPrimitives() const {return primitives;}
+    const std::vector<Node> &getNodes() const {return nodes;}
+
+    Bounds_T getBounds() const
+    {return nodes.empty() ? Bounds_T() : nodes[0].bounds;}
+
+
+    /**
+     * Build the hierarchy.  With more than one thread the top of the tree
+     * is split serially into subtrees which are then built concurrently on
+     * a ThreadPool.
+     */
+    void build(const std::vector<P> &primitives, unsigned threads = 1) {
+      this->primitives = primitives;
+      nodes.clear();
+
+      const unsigned n = primitives.size();
+      order.resize(n);
+      bounds.resize(n);
+      centroids.resize(n);
+
+      for (unsigned i = 0; i < n; i++) {
+        order[i] = i;
+        bounds[i] = Primitive::getBounds(primitives[i]);
+        centroids[i] = bounds[i].getCenter();
+      }
+
+      if (!n) {}
+      else if (threads < 2 || n < 4096) buildNode(nodes, 0, n, 0);
+      else {
+        std::vector<TopNode> top;
+        std::vector<Subtree> subtrees;
+        buildTop(top, subtrees, 0, n, n / (threads * 4), 0);
+
+        Builder builder(threads, *this, subtrees);
+        builder.start();
+        builder.join();
+
+        flatten(top, subtrees, 0);
+      }
+
+      bounds.clear();
+      centroids.clear();
+    }
+
+
+    /// Call @param cb with the index of each primitive whose bounds
+    /// intersect @param query
+    template <typename F>
+    void query(const Bounds_T &query, F cb) const {
+      if (nodes.empty()) return;
+
+      uint32_t stack[STACK_SIZE];
+      unsigned top = 0;
+      stack[top++] = 0;
+
+      while (top) {
+        const Node &node = nodes[stack[--top]];
+        if (!node.bounds.intersects(query)) continue;
+
+        if (node.isLeaf()) {
+          for (unsigned i = 0; i < node.count; i++) {
+            uint32_t index = order[node.offset + i];
+            if (Primitive::getBounds(primitives[index]).intersects(query))
+              cb(index);
+          }
+
+        } else {
+          stack[top++] = node.offset;
+          stack[top++] = &node - &nodes[0] + 1;
+        }
+      }
+    }
+
+
+    void query(const Bounds_T &query, std::vector<unsigned> &results) const {
+      this->query(query, [&results] (unsigned i) {results.push_back(i);});
+    }
+
+
+    /// Find the @param k closest primitives to @param p, sorted by distance
+    void nearest(const Point_T &p, unsigned k,
+                 std::vector<result_t> &results) const {
+      Primitive::Nearest<T> best(k);
+
+      if (!nodes.empty() && k) {
+        std::pair<T, uint32_t> stack[STACK_SIZE];
+        unsigned top = 0;
+        stack[top++] = std::make_pair(0, 0);
+
+        while (top) {
+          std::pair<T, uint32_t> entry = stack[--top];
+          if (best.getLimit() <= entry.first) continue;
+
+          const Node &node = nodes[entry.second];
+
+          if (node.isLeaf()) {
+            for (unsigned i = 0; i < node.count; i++) {
+              uint32_t index = order[node.offset + i];
+              best.add(Primitive::distanceSquared(primitives[index], p),
+                       index);
+            }
+
+            continue;
+          }
+
+          // Push the farther child first so the nearer is visited first
+          uint32_t a = entry.second + 1;
+          uint32_t b = node.offset;
+          T da = Primitive::distanceSquared(nodes[a].bounds, p);
+          T db = Primitive::distanceSquared(nodes[b].bounds, p);
+          if (da < db) {std::swap(a, b); std::swap(da, db);}
+
+          stack[top++] = std::make_pair(da, a);
+          stack[top++] = std::make_pair(db, b);
+        }
+      }
+
+      best.getResults(results);
+    }
+
+
+    /// @return False if empty, otherwise the closest primitive and distance
+    bool nearest(const Point_T &p, unsigned &index, T &dist) const {
+      std::vector<result_t> results;
+      nearest(p, 1, results);
+      if (results.empty()) return false;
+
+      index = results[0].second;
+      dist = results[0].first;
+      return true;
+    }
+
+
+    /**
+     * Visit primitives whose bounds are hit by the ray from @param origin
+     * in direction @param dir, roughly nearest first.  @param cb is called
+     * as cb(index, tmax) and may lower tmax when it finds a hit, which
+     * prunes farther nodes.
+     */
+    template <typename F>
+    void ray(const Point_T &origin, const Point_T &dir, T tmax, F cb) const {
+      if (nodes.empty()) return;
+
+      Point_T invDir;
+      for (unsigned i = 0; i < DIM; i++) invDir[i] = 1 / dir[i];
+
+      std::pair<T, uint32_t> stack[STACK_SIZE];
+      unsigned top = 0;
+
+      T t;
+      if (!Primitive::intersectRay(nodes[0].bounds, origin, invDir, tmax, t))
+        return;
+      stack[top++] = std::make_pair(t, 0);
+
+      while (top) {
+        std::pair<T, uint32_t> entry = stack[--top];
+        if (tmax < entry.first) continue;
+
+        const Node &node = nodes[entry.second];
+
+        if (node.isLeaf()) {
+          for (unsigned i = 0; i < node.count; i++) {
+            uint32_t index = order[node.offset + i];
+            if (Primitive::intersectRay(Primitive::getBounds(primitives[index]),
+                                        origin, invDir, tmax, t))
+              cb(index, tmax);
+          }
+
+          continue;
+        }
+
+        uint32_t a = entry.second + 1;
+        uint32_t b = node.offset;
+        T ta, tb;
+        bool hitA =
+          Primitive::intersectRay(nodes[a].bounds, origin, invDir, tmax, ta);
+        bool hitB =
+          Primitive::intersectRay(nodes[b].bounds, origin, invDir, tmax, tb);
+
+        if (hitA && hitB && ta < tb) {
+          stack[top++] = std::make_pair(tb, b);
+          stack[top++] = std::make_pair(ta, a);
+
+        } else {
+          if (hitA) stack[top++] = std::make_pair(ta, a);
+          if (hitB) stack[top++] = std::make_pair(tb, b);
+        }
+      }
+    }
+
+
+    /// Nearest ray hit for primitives with an exact Primitive::intersectRay()
+    bool intersectRay(const Point_T &origin, const Point_T &dir,
+                      unsigned &index, T &t,
+                      T limit = std::numeric_limits<T>::max()) const {
+      bool hit = false;
+
+      ray(origin, dir, limit, [&] (unsigned i, T &tmax) {
+        T x;
+        if (Primitive::intersectRay(primitives[i], origin, dir, x) &&
+            x < tmax) {
+          tmax = t = x;
+          index = i;
+          hit = true;
+        }
+      });
+
+      return hit;
+    }
+
+
+  protected:
+    Bounds_T getBounds(uint32_t begin, uint32_t end) const {
+      Bounds_T b;
+      for (uint32_t i = begin; i < end; i++) b.add(bounds[order[i]]);
+      return b;
+    }
+
+
+    uint32_t splitMedian(uint32_t begin, uint32_t end, unsigned axis) {
+      uint32_t mid = begin + (end - begin) / 2;
+
+      std::nth_element
+        (&order[0] + begin, &order[0] + mid, &order[0] + end,
+         [&] (uint32_t a, uint32_t b) {
+          return centroids[a][axis] < centroids[b][axis];
+        });
+
+      return mid;
+    }
+
+
+    /// Partition [begin, end) by the SAH.  @return The split point or
+    /// @param begin if a leaf is cheaper
+    uint32_t split(const Bounds_T &nodeBounds, uint32_t begin, uint32_t end,
+                   unsigned depth) {
+      const uint32_t count = end - begin;
+      if (count <= 2) return begin;
+
+      Bounds_T cb;
+      for (uint32_t i = begin; i < end; i++) cb.add(centroids[order[i]]);
+
+      unsigned axis = cb.getDimensions().findLargest();
+      T lo = cb.rmin[axis];
+      T extent = cb.rmax[axis] - lo;
+
+      if (!(0 < extent) || MAX_SAH_DEPTH <= depth) {
+        // Split by count if the leaf is too big
+        if (count <= MAX_LEAF) return begin;
+        return splitMedian(begin, end, axis);
+      }
+
+      // Bin the centroids
+      Bounds_T binBounds[BINS];
+      uint32_t binCounts[BINS] = {0};
+      T scale = BINS / extent;
+
+      for (uint32_t i = begin; i < end; i++) {
+        uint32_t index = order[i];
+        unsigned bin = (unsigned)((centroids[index][axis] - lo) * scale);
+        if (BINS <= bin) bin = BINS - 1;
+        binCounts[bin]++;
+        binBounds[bin].add(bounds[index]);
+      }
+
+      // Sweep from the right then the left to cost each split
+      T rightCost[BINS];
+      Bounds_T right;
+      uint32_t rightCount = 0;
+
+      for (unsigned i = BINS - 1; i; i--) {
+        right.add(binBounds[i]);
+        rightCount += binCounts[i];
+        rightCost[i] = rightCount ? rightCount * Primitive::getArea(right) : 0;
+      }
+
+      Bounds_T left;
+      uint32_t leftCount = 0;
+      T bestCost = std::numeric_limits<T>::max();
+      unsigned bestBin = 0;
+
+      for (unsigned i = 1; i < BINS; i++) {
+        left.add(binBounds[i - 1]);
+        leftCount += binCounts[i - 1];
+        if (!leftCount || leftCount == count) continue;
+
+        T cost = leftCount * Primitive::getArea(left) + rightCost[i];
+        if (cost < bestCost) {
+          bestCost = cost;
+          bestBin = i;
+        }
+      }
+
+      // Traversal costs about as much as one primitive test
+      T area = Primitive::getArea(nodeBounds);
+      T leafCost = count;
+      T splitCost = 1 + (0 < area ? bestCost / area : count);
+
+      if (count <= MAX_LEAF && leafCost <= splitCost) return begin;
+
+      uint32_t *mid = std::partition
+        (&order[0] + begin, &order[0] + end, [&] (uint32_t index) {
+          unsigned bin = (unsigned)((centroids[index][axis] - lo) * scale);
+          return (BINS <= bin ? BINS - 1 : bin) < bestBin;
+        });
+
+      return mid - &order[0];
+    }
+
+
+    void buildNode(std::vector<Node> &nodes, uint32_t begin, uint32_t end,
+                   unsigned depth) {
+      uint32_t self = nodes.size();
+      nodes.push_back(Node());
+      nodes[self].bounds = getBounds(begin, end);
+
+      uint32_t mid = split(nodes[self].bounds, begin, end, depth);
+
+      if (mid == begin) {
+        nodes[self].offset = begin;
+        nodes[self].count = end - begin;
+        return;
+      }
+
+      nodes[self].count = 0;
+      buildNode(nodes, begin, mid, depth + 1);
+      nodes[self].offset = nodes.size();
+      buildNode(nodes, mid, end, depth + 1);
+    }
+
+
+    int buildTop(std::vector<TopNode> &top, std::vector<Subtree> &subtrees,
+                 uint32_t begin, uint32_t end, uint32_t grain,
+                 unsigned depth) {
+      int self = top.size();
+      top.push_back(TopNode());
+      top[self].bounds = getBounds(begin, end);
+      top[self].subtree = -1;
+
+      uint32_t mid = end - begin <= grain ? begin :
+        split(top[self].bounds, begin, end, depth);
+
+      if (mid == begin) {
+        top[self].subtree = subtrees.size();
+        subtrees.push_back(Subtree());
+        subtrees.back().begin = begin;
+        subtrees.back().end = end;
+        subtrees.back().depth = depth;
+        return self;
+      }
+
+      int left = buildTop(top, subtrees, begin, mid, grain, depth + 1);
+      int right = buildTop(top, subtrees, mid, end, grain, depth + 1);
+      top[self].left = left;
+      top[self].right = right;
+
+      return self;
+    }
+
+
+    void flatten(const std::vector<TopNode> &top,
+                 std::vector<Subtree> &subtrees, int index) {
+      const TopNode &node = top[index];
+
+      if (0 <= node.subtree) {
+        // Subtree child offsets are relative to its own array
+        std::vector<Node> &sub = subtrees[node.subtree].nodes;
+        uint32_t base = nodes.size();
+
+        for (unsigned i = 0; i < sub.size(); i++) {
+          if (!sub[i].isLeaf()) sub[i].offset += base;
+          nodes.push_back(sub[i]);
+        }
+
+        std::vector<Node>().swap(sub);
+        return;
+      }
+
+      uint32_t self = nodes.size();
+      nodes.push_back(Node());
+      nodes[self].bounds = node.bounds;
+      nodes[self].count = 0;
+
+      flatten(top, subtrees, node.left);
+      nodes[self].offset = nodes.size();
+      flatten(top, subtrees, node.right);
+    }
+  };
+}
@@ -0,0 +1,228 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Segment.h"
+#include "Triangle.h"
+
+#include <vector>
+#include <cmath>
+#include <limits>
+
+
+namespace cb {
+  /**
+   * Points stored as one array per axis.  Loops over many points then
+   * touch contiguous memory and the compiler can vectorize them across
+   * points rather than across the few coordinates of a single Vector.
+   * The loops below avoid floating point comparisons, which the compiler
+   * will not vectorize unless -fno-trapping-math is set.
+   */
+  template <const unsigned DIM, typename T>
+  class PointBatch {
+    std::vector<T> coords[DIM];
+
+  public:
+    unsigned size() const {return coords[0].size();}
+    bool empty() const {return coords[0].empty();}
+
+    void clear() {for (unsigned i = 0; i < DIM; i++) coords[i].clear();}
+    void reserve(unsigned n)
+    {for (unsigned i = 0; i < DIM; i++) coords[i].reserve(n);}
+    void resize(unsigned n)
+    {for (unsigned i = 0; i < DIM; i++) coords[i].resize(n);}
+
+    void push_back(const Vector<DIM, T> &p)
+    {for (unsigned i = 0; i < DIM; i++) coords[i].push_back(p[i]);}
+
+    Vector<DIM, T> get(unsigned index) const {
+      Vector<DIM, T> p;
+      for (unsigned i = 0; i < DIM; i++) p[i] = coords[i][index];
+      return p;
+    }
+
+    void set(unsigned index, const Vector<DIM, T> &p)
+    {for (unsigned i = 0; i < DIM; i++) coords[i][index] = p[i];}
+
+    const T *getAxis(unsigned axis) const {return coords[axis].data();}
+    T *getAxis(unsigned axis) {return coords[axis].data();}
+  };
+
+
+  template <const unsigned DIM, typename T>
+  class SegmentBatch {
+    PointBatch<DIM, T> starts;
+    PointBatch<DIM, T> ends;
+
+  public:
+    unsigned size() const {return starts.size();}
+    bool empty() const {return starts.empty();}
+    void clear() {starts.clear(); ends.clear();}
+    void reserve(unsigned n) {starts.reserve(n); ends.reserve(n);}
+
+    void push_back(const Segment<DIM, T> &s)
+    {starts.push_back(s.getStart()); ends.push_back(s.getEnd());}
+
+    Segment<DIM, T> get(unsigned i) const
+    {return Segment<DIM, T>(starts.get(i), ends.get(i));}
+
+    const PointBatch<DIM, T> &getStarts() const {return starts;}
+    const PointBatch<DIM, T> &getEnds() const {return ends;}
+
+
+    /// Write the squared distance from @param p to each segment to @param out
+    void distanceSquared(const Vector<DIM, T> &p, T *out) const {
+      const T *s[DIM];
+      const T *e[DIM];
+      T q[DIM];
+      for (unsigned j = 0; j < DIM; j++) {
+        s[j] = starts.getAxis(j);
+        e[j] = ends.getAxis(j);
+        q[j] = p[j];
+      }
+
+      const unsigned n = size();
+      for (unsigned i = 0; i < n; i++) {
+        // Same projection as Segment::closest() without branches
+        T len2 = 0;
+        T proj = 0;
+
+        for (unsigned j = 0; j < DIM; j++) {
+          T d = e[j][i] - s[j][i];
+          len2 += d * d;
+          proj += (q[j] - s[j][i]) * d;
+        }
+
+        // A zero length segment also has zero projection
+        T t = proj / (len2 + std::numeric_limits<T>::min());
+        t = (std::fabs(t) - std::fabs(t - 1) + 1) / 2; // Clamp to [0, 1]
+
+        T dist = 0;
+        for (unsigned j = 0; j < DIM; j++) {
+          T x = q[j] - (s[j][i] + (e[j][i] - s[j][i]) * t);
+          dist += x * x;
+        }
+
+        out[i] = dist;
+      }
+    }
+
+
+    /// @return The index of the segment closest to @param p or size() if empty
+    unsigned closest(const Vector<DIM, T> &p, T &dist) const {
+      std::vector<T> d(size());
+      if (d.empty()) return 0;
+
+      distanceSquared(p, d.data());
+
+      unsigned index = 0;
+      for (unsigned i = 1; i < d.size(); i++)
+        if (d[i] < d[index]) index = i;
+
+      dist = std::sqrt(d[index]);
+      return index;
+    }
+  };
+
+
+  template <typename T>
+  class TriangleBatch {
+    PointBatch<3, T> points[3];
+
+  public:
+    typedef Vector<3, Vector<3, T> > Triangle_T;
+
+    unsigned size() const {return points[0].size();}
+    bool empty() const {return points[0].empty();}
+    void clear() {for (unsigned i = 0; i < 3; i++) points[i].clear();}
+    void reserve(unsigned n)
+    {for (unsigned i = 0; i < 3; i++) points[i].reserve(n);}
+
+    void push_back(const Triangle_T &t)
+    {for (unsigned i = 0; i < 3; i++) points[i].push_back(t[i]);}
+
+    Triangle_T get(unsigned i) const {
+      return Triangle_T(points[0].get(i), points[1].get(i), points[2].get(i));
+    }
+
+    const PointBatch<3, T> &getPoints(unsigned i) const {return points[i];}
+
+
+    /// Unnormalized normals, (b - a) x (c - a), for each triangle
+    void normals(PointBatch<3, T> &out) const {
+      const unsigned n = size();
+      out.resize(n);
+
+      const T *ax = points[0].getAxis(0);
+      const T *ay = points[0].getAxis(1);
+      const T *az = points[0].getAxis(2);
+      const T *bx = points[1].getAxis(0);
+      const T *by = points[1].getAxis(1);
+      const T *bz = points[1].getAxis(2);
+      const T *cx = points[2].getAxis(0);
+      const T *cy = points[2].getAxis(1);
+      const T *cz = points[2].getAxis(2);
+      T *nx = out.getAxis(0);
+      T *ny = out.getAxis(1);
+      T *nz = out.getAxis(2);
+
+      // Separate loops keep the number of possible aliases small enough
+      // for the compiler to vectorize
+      for (unsigned i = 0; i < n; i++)
+        nx[i] = (by[i] - ay[i]) * (cz[i] - az[i]) -
+          (bz[i] - az[i]) * (cy[i] - ay[i]);
+
+      for (unsigned i = 0; i < n; i++)
+        ny[i] = (bz[i] - az[i]) * (cx[i] - ax[i]) -
+          (bx[i] - ax[i]) * (cz[i] - az[i]);
+
+      for (unsigned i = 0; i < n; i++)
+        nz[i] = (bx[i] - ax[i]) * (cy[i] - ay[i]) -
+          (by[i] - ay[i]) * (cx[i] - ax[i]);
+    }
+
+
+    /// Write the area of each triangle to @param out
+    void areas(T *out) const {
+      PointBatch<3, T> n;
+      normals(n);
+
+      const T *x = n.getAxis(0);
+      const T *y = n.getAxis(1);
+      const T *z = n.getAxis(2);
+
+      for (unsigned i = 0; i < n.size(); i++)
+        out[i] = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]) / 2;
+    }
+  };
+}
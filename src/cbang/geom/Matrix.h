@@ -236,6 +236,18 @@ namespace cb {
       return result;
     }
 
+    /// Rows of the result are sums of scaled rows of @param o, which lets
+    /// Vector's SIMD kernels do the work
+    Matrix<ROWS, COLS, T> operator*(const Matrix<COLS, COLS, T> &o) const {
+      Matrix<ROWS, COLS, T> result;
+
+      for (unsigned row = 0; row < ROWS; row++)
+        for (unsigned i = 0; i < COLS; i++)
+          result[row] += o[i] * data[row][i];
+
+      return result;
+    }
+
     template <unsigned OROWS>
     Matrix<ROWS, OROWS, T> operator*=(const Matrix<OROWS, COLS, T> &o) {
       return *this = *this * o;
@@ -255,11 +267,7 @@ namespace cb {
     Vector<ROWS, T> operator*(const Vector<COLS, T> &v) const {
       Vector<ROWS, T> result;
 
-      for (unsigned row = 0; row < ROWS; row++) {
-        result[row] = 0;
-        for (unsigned col = 0; col < COLS; col++)
-          result[row] += data[row][col] * v[col];
-      }
+      for (unsigned row = 0; row < ROWS; row++) result[row] = data[row].dot(v);
 
       return result;
     }
@@ -0,0 +1,254 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Rectangle.h"
+#include "Segment.h"
+#include "Triangle.h"
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+
+
+namespace cb {
+  /// Operations on the primitives indexed by BVH and RTree
+  namespace Primitive {
+    template <const unsigned DIM, typename T>
+    Rectangle<DIM, T> getBounds(const Vector<DIM, T> &p) {
+      return Rectangle<DIM, T>(p, p);
+    }
+
+
+    template <const unsigned DIM, typename T>
+    Rectangle<DIM, T> getBounds(const Segment<DIM, T> &s) {
+      return Rectangle<DIM, T>(s.getStart(), s.getEnd());
+    }
+
+
+    template <const unsigned DIM, typename T>
+    Rectangle<DIM, T> getBounds(const Rectangle<DIM, T> &r) {return r;}
+
+
+    template <const unsigned DIM, typename T>
+    Rectangle<DIM, T> getBounds(const Vector<3, Vector<DIM, T> > &t) {
+      Rectangle<DIM, T> r;
+      for (unsigned i = 0; i < 3; i++) r.add(t[i]);
+      return r;
+    }
+
+
+    template <const unsigned DIM, typename T>
+    T distanceSquared(const Vector<DIM, T> &a, const Vector<DIM, T> &p) {
+      return a.distanceSquared(p);
+    }
+
+
+    template <const unsigned DIM, typename T>
+    T distanceSquared(const Segment<DIM, T> &s, const Vector<DIM, T> &p) {
+      return s.closest(p).distanceSquared(p);
+    }
+
+
+    template <const unsigned DIM, typename T>
+    T distanceSquared(const Rectangle<DIM, T> &r, const Vector<DIM, T> &p) {
+      T d = 0;
+
+      for (unsigned i = 0; i < DIM; i++) {
+        T x = p[i] < r.rmin[i] ? r.rmin[i] - p[i] :
+          (r.rmax[i] < p[i] ? p[i] - r.rmax[i] : 0);
+        d += x * x;
+      }
+
+      return d;
+    }
+
+
+    /// From Ericson, Real-Time Collision Detection, 5.1.5
+    template <const unsigned DIM, typename T>
+    Vector<DIM, T> closest(const Vector<3, Vector<DIM, T> > &t,
+                           const Vector<DIM, T> &p) {
+      const Vector<DIM, T> &a = t[0];
+      const Vector<DIM, T> &b = t[1];
+      const Vector<DIM, T> &c = t[2];
+
+      Vector<DIM, T> ab = b - a;
+      Vector<DIM, T> ac = c - a;
+      Vector<DIM, T> ap = p - a;
+      T d1 = ab.dot(ap);
+      T d2 = ac.dot(ap);
+      if (d1 <= 0 && d2 <= 0) return a;
+
+      Vector<DIM, T> bp = p - b;
+      T d3 = ab.dot(bp);
+      T d4 = ac.dot(bp);
+      if (0 <= d3 && d4 <= d3) return b;
+
+      T vc = d1 * d4 - d3 * d2;
+      if (vc <= 0 && 0 <= d1 && d3 <= 0) return a + ab * (d1 / (d1 - d3));
+
+      Vector<DIM, T> cp = p - c;
+      T d5 = ab.dot(cp);
+      T d6 = ac.dot(cp);
+      if (0 <= d6 && d5 <= d6) return c;
+
+      T vb = d5 * d2 - d1 * d6;
+      if (vb <= 0 && 0 <= d2 && d6 <= 0) return a + ac * (d2 / (d2 - d6));
+
+      T va = d3 * d6 - d5 * d4;
+      if (va <= 0 && 0 <= d4 - d3 && 0 <= d5 - d6)
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+      T denom = 1 / (va + vb + vc);
+      return a + ab * (vb * denom) + ac * (vc * denom);
+    }
+
+
+    template <const unsigned DIM, typename T>
+    T distanceSquared(const Vector<3, Vector<DIM, T> > &t,
+                      const Vector<DIM, T> &p) {
+      return closest(t, p).distanceSquared(p);
+    }
+
+
+    /// Surface area of a box, or half the perimeter in 2D, for the SAH
+    template <const unsigned DIM, typename T>
+    T getArea(const Rectangle<DIM, T> &r) {
+      if (DIM == 1) return r.getDimension(0);
+
+      T area = 0;
+      for (unsigned i = 0; i < DIM; i++) {
+        T face = 1;
+        for (unsigned j = 0; j < DIM; j++)
+          if (i != j) face *= r.getDimension(j);
+        area += face;
+      }
+
+      return area;
+    }
+
+
+    /**
+     * Slab test of a ray against a box.  @param invDir holds the inverse
+     * of each component of the ray direction.
+     *
+     * @return True if the ray enters the box before @param tmax, in which
+     * case @param tnear is set to the entry distance.
+     */
+    template <const unsigned DIM, typename T>
+    bool intersectRay(const Rectangle<DIM, T> &r, const Vector<DIM, T> &origin,
+                      const Vector<DIM, T> &invDir, T tmax, T &tnear) {
+      T t0 = 0;
+      T t1 = tmax;
+
+      for (unsigned i = 0; i < DIM; i++) {
+        T a = (r.rmin[i] - origin[i]) * invDir[i];
+        T b = (r.rmax[i] - origin[i]) * invDir[i];
+        if (b < a) std::swap(a, b);
+
+        if (t0 < a) t0 = a;
+        if (b < t1) t1 = b;
+        if (t1 < t0) return false;
+      }
+
+      tnear = t0;
+      return true;
+    }
+
+
+    /// Moller-Trumbore ray triangle intersection
+    template <typename T>
+    bool intersectRay(const Vector<3, Vector<3, T> > &tri,
+                      const Vector<3, T> &origin, const Vector<3, T> &dir,
+                      T &t) {
+      Vector<3, T> e1 = tri[1] - tri[0];
+      Vector<3, T> e2 = tri[2] - tri[0];
+      Vector<3, T> h = dir.cross(e2);
+
+      T det = e1.dot(h);
+      if (!det) return false; // Parallel
+
+      T f = 1 / det;
+      Vector<3, T> s = origin - tri[0];
+      T u = f * s.dot(h);
+      if (u < 0 || 1 < u) return false;
+
+      Vector<3, T> q = s.cross(e1);
+      T v = f * dir.dot(q);
+      if (v < 0 || 1 < u + v) return false;
+
+      t = f * e2.dot(q);
+      return 0 <= t;
+    }
+
+
+    /// Keeps the @param k closest candidates seen by a nearest search
+    template <typename T>
+    class Nearest {
+      typedef std::pair<T, unsigned> entry_t;
+      std::vector<entry_t> heap;
+      unsigned k;
+
+    public:
+      Nearest(unsigned k) : k(k) {heap.reserve(k);}
+
+      bool isFull() const {return heap.size() == k;}
+
+      /// @return The squared distance a candidate must beat
+      T getLimit() const {
+        return isFull() ? heap.front().first : std::numeric_limits<T>::max();
+      }
+
+      void add(T dist2, unsigned index) {
+        if (!k || (isFull() && getLimit() <= dist2)) return;
+
+        if (isFull()) {
+          std::pop_heap(heap.begin(), heap.end());
+          heap.pop_back();
+        }
+
+        heap.push_back(entry_t(dist2, index));
+        std::push_heap(heap.begin(), heap.end());
+      }
+
+      /// Sorted closest first with the distances, not their squares
+      void getResults(std::vector<entry_t> &results) {
+        std::sort_heap(heap.begin(), heap.end());
+        for (unsigned i = 0; i < heap.size(); i++)
+          heap[i].first = std::sqrt(heap[i].first);
+        results.swap(heap);
+      }
+    };
+  }
+}
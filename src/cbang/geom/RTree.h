@@ -0,0 +1,360 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Primitive.h"
+
+#include <vector>
+#include <algorithm>
+
+
+namespace cb {
+  /**
+   * An R-tree supporting incremental inserts, using Guttman's quadratic
+   * split.  Unlike BVH, which is built once over a fixed set, primitives
+   * may be added at any time.  Nodes live in one array and refer to each
+   * other by index.  Query results are the indices returned by insert().
+   */
+  template <const unsigned DIM, typename T, typename P = Segment<DIM, T> >
+  class RTree {
+  public:
+    typedef Rectangle<DIM, T> Bounds_T;
+    typedef Vector<DIM, T> Point_T;
+    typedef std::pair<T, unsigned> result_t;
+
+    static const unsigned MAX_CHILDREN = 8;
+    static const unsigned MIN_CHILDREN = 3;
+
+    struct Node {
+      Bounds_T bounds[MAX_CHILDREN];
+      uint32_t children[MAX_CHILDREN]; // Nodes or, in leaves, primitives
+      uint32_t count;
+      bool leaf;
+
+      Node(bool leaf = true) : children(), count(0), leaf(leaf) {}
+
+      Bounds_T getBounds() const {
+        Bounds_T b;
+        for (unsigned i = 0; i < count; i++) b.add(bounds[i]);
+        return b;
+      }
+    };
+
+  protected:
+    // Height is at most log3(2^32) so this many entries are always enough
+    static const unsigned STACK_SIZE = 32 * MAX_CHILDREN;
+
+    std::vector<P> primitives;
+    std::vector<Node> nodes;
+    uint32_t root;
+    unsigned height;
+
+    struct Entry {
+      Bounds_T bounds;
+      uint32_t child;
+    };
+
+  public:
+    RTree() {clear();}
+
+    unsigned size() const {return primitives.size();}
+    bool empty() const {return primitives.empty();}
+    unsigned getHeight() const {return height;}
+    const P &get(unsigned i) const {return primitives.at(i);}
+    const std::vector<P> &getPrimitives() const {return primitives;}
+    Bounds_T getBounds() const {return nodes[root].getBounds();}
+
+
+    void clear() {
+      primitives.clear();
+      nodes.assign(1, Node());
+      root = 0;
+      height = 1;
+    }
+
+
+    /// @return The index of the new primitive
+    unsigned insert(const P &p) {
+      uint32_t id = primitives.size();
+      primitives.push_back(p);
+
+      Entry e = {Primitive::getBounds(p), id};
+      Entry split;
+
+      if (insert(root, e, split)) {
+        Node node(false);
+        node.bounds[0] = nodes[root].getBounds();
+        node.children[0] = root;
+        node.bounds[1] = split.bounds;
+        node.children[1] = split.child;
+        node.count = 2;
+
+        root = nodes.size();
+        nodes.push_back(node);
+        height++;
+      }
+
+      return id;
+    }
+
+
+    /// Call @param cb with the index of each primitive whose bounds
+    /// intersect @param query
+    template <typename F>
+    void query(const Bounds_T &query, F cb) const {
+      uint32_t stack[STACK_SIZE];
+      unsigned top = 0;
+      stack[top++] = root;
+
+      while (top) {
+        const Node &node = nodes[stack[--top]];
+
+        for (unsigned i = 0; i < node.count; i++)
+          if (node.bounds[i].intersects(query)) {
+            if (node.leaf) cb(node.children[i]);
+            else stack[top++] = node.children[i];
+          }
+      }
+    }
+
+
+    void query(const Bounds_T &query, std::vector<unsigned> &results) const {
+      this->query(query, [&results] (unsigned i) {results.push_back(i);});
+    }
+
+
+    /// Find the @param k closest primitives to @param p, sorted by distance
+    void nearest(const Point_T &p, unsigned k,
+                 std::vector<result_t> &results) const {
+      Primitive::Nearest<T> best(k);
+
+      std::pair<T, uint32_t> stack[STACK_SIZE];
+      unsigned top = 0;
+      if (k) stack[top++] = std::make_pair(0, root);
+
+      while (top) {
+        std::pair<T, uint32_t> entry = stack[--top];
+        if (best.getLimit() <= entry.first) continue;
+
+        const Node &node = nodes[entry.second];
+
+        if (node.leaf) {
+          for (unsigned i = 0; i < node.count; i++) {
+            uint32_t index = node.children[i];
+            best.add(Primitive::distanceSquared(primitives[index], p), index);
+          }
+
+          continue;
+        }
+
+        // Push the farthest first so the nearest is visited next
+        std::pair<T, uint32_t> children[MAX_CHILDREN];
+        for (unsigned i = 0; i < node.count; i++)
+          children[i] = std::make_pair
+            (Primitive::distanceSquared(node.bounds[i], p), node.children[i]);
+
+        std::sort(children, children + node.count);
+        for (unsigned i = node.count; i; i--)
+          if (children[i - 1].first < best.getLimit())
+            stack[top++] = children[i - 1];
+      }
+
+      best.getResults(results);
+    }
+
+
+    /// @return False if empty, otherwise the closest primitive and distance
+    bool nearest(const Point_T &p, unsigned &index, T &dist) const {
+      std::vector<result_t> results;
+      nearest(p, 1, results);
+      if (results.empty()) return false;
+
+      index = results[0].second;
+      dist = results[0].first;
+      return true;
+    }
+
+
+  protected:
+    static T getCost(const Bounds_T &b) {return Primitive::getArea(b);}
+
+
+    static T getEnlargement(const Bounds_T &b, const Bounds_T &add) {
+      Bounds_T u = b;
+      u.add(add);
+      return getCost(u) - getCost(b);
+    }
+
+
+    unsigned chooseChild(const Node &node, const Bounds_T &b) const {
+      unsigned best = 0;
+      T bestEnlargement = 0;
+      T bestCost = 0;
+
+      for (unsigned i = 0; i < node.count; i++) {
+        T enlargement = getEnlargement(node.bounds[i], b);
+        T cost = getCost(node.bounds[i]);
+
+        if (!i || enlargement < bestEnlargement ||
+            (enlargement == bestEnlargement && cost < bestCost)) {
+          best = i;
+          bestEnlargement = enlargement;
+          bestCost = cost;
+        }
+      }
+
+      return best;
+    }
+
+
+    /// @return True if @param index was split, with the new node in @param
+    /// split
+    bool insert(uint32_t index, const Entry &e, Entry &split) {
+      if (!nodes[index].leaf) {
+        unsigned i = chooseChild(nodes[index], e.bounds);
+        uint32_t child = nodes[index].children[i];
+
+        Entry childSplit;
+        bool didSplit = insert(child, e, childSplit);
+
+        // Index again, the recursive call may have reallocated nodes
+        if (!didSplit) {
+          nodes[index].bounds[i].add(e.bounds);
+          return false;
+        }
+
+        nodes[index].bounds[i] = nodes[child].getBounds();
+        return add(index, childSplit, split);
+      }
+
+      return add(index, e, split);
+    }
+
+
+    bool add(uint32_t index, const Entry &e, Entry &split) {
+      Node &node = nodes[index];
+
+      if (node.count < MAX_CHILDREN) {
+        node.bounds[node.count] = e.bounds;
+        node.children[node.count++] = e.child;
+        return false;
+      }
+
+      // Overflow, distribute MAX_CHILDREN + 1 entries over two nodes
+      const unsigned n = MAX_CHILDREN + 1;
+      Entry entries[n];
+      for (unsigned i = 0; i < MAX_CHILDREN; i++) {
+        entries[i].bounds = node.bounds[i];
+        entries[i].child = node.children[i];
+      }
+      entries[MAX_CHILDREN] = e;
+
+      // Pick the pair of seeds which would waste the most space together
+      unsigned seedA = 0;
+      unsigned seedB = 1;
+      T worst = -std::numeric_limits<T>::max();
+
+      for (unsigned i = 0; i < n; i++)
+        for (unsigned j = i + 1; j < n; j++) {
+          Bounds_T u = entries[i].bounds;
+          u.add(entries[j].bounds);
+          T waste = getCost(u) - getCost(entries[i].bounds) -
+            getCost(entries[j].bounds);
+
+          if (worst < waste) {
+            worst = waste;
+            seedA = i;
+            seedB = j;
+          }
+        }
+
+      Node a(node.leaf);
+      Node b(node.leaf);
+      Bounds_T boundsA = entries[seedA].bounds;
+      Bounds_T boundsB = entries[seedB].bounds;
+      bool assigned[n] = {false};
+
+      a.bounds[a.count] = entries[seedA].bounds;
+      a.children[a.count++] = entries[seedA].child;
+      b.bounds[b.count] = entries[seedB].bounds;
+      b.children[b.count++] = entries[seedB].child;
+      assigned[seedA] = assigned[seedB] = true;
+
+      for (unsigned remaining = n - 2; remaining; remaining--) {
+        // Give the rest to a group which needs them to reach the minimum
+        bool toA = a.count + remaining <= MIN_CHILDREN;
+        bool toB = b.count + remaining <= MIN_CHILDREN;
+
+        // Otherwise take the entry with the strongest preference
+        unsigned next = 0;
+        T bestDiff = -1;
+        T enlargeA = 0;
+        T enlargeB = 0;
+
+        for (unsigned i = 0; i < n; i++) {
+          if (assigned[i]) continue;
+
+          T da = getEnlargement(boundsA, entries[i].bounds);
+          T db = getEnlargement(boundsB, entries[i].bounds);
+          T diff = da < db ? db - da : da - db;
+
+          if (bestDiff < diff) {
+            bestDiff = diff;
+            next = i;
+            enlargeA = da;
+            enlargeB = db;
+          }
+        }
+
+        if (!toA && !toB)
+          toA = enlargeA < enlargeB ||
+            (enlargeA == enlargeB && (getCost(boundsA) < getCost(boundsB) ||
+                                      (getCost(boundsA) == getCost(boundsB) &&
+                                       a.count <= b.count)));
+
+        Node &group = toA ? a : b;
+        group.bounds[group.count] = entries[next].bounds;
+        group.children[group.count++] = entries[next].child;
+        (toA ? boundsA : boundsB).add(entries[next].bounds);
+        assigned[next] = true;
+      }
+
+      nodes[index] = a;
+      split.bounds = boundsB;
+      split.child = nodes.size();
+      nodes.push_back(b);
+
+      return true;
+    }
+  };
+}
@@ -32,6 +32,8 @@
 
 #pragma once
 
+#include "VectorSIMD.h"
+
 #include <cbang/Exception.h>
 #include <cbang/String.h>
 #include <cbang/Math.h>
@@ -56,8 +58,10 @@
 namespace cb {
   template <const unsigned DIM, typename T>
   class Vector {
+    typedef VectorSIMD<DIM, T> SIMD;
+
   public:
-    T data[DIM];
+    alignas(VectorAlign<DIM, T>::value) T data[DIM];
 
     Vector(T v = 0) {for (unsigned i = 0; i < DIM; i++) data[i] = v;}
 
@@ -181,11 +185,7 @@ namespace cb {
     }
 
 
-    T lengthSquared() const {
-      T result = 0;
-      for (unsigned i = 0; i < DIM; i++) result += data[i] * data[i];
-      return result;
-    }
+    T lengthSquared() const {return SIMD::dot(data, data);}
 
     T length() const {return sqrt(lengthSquared());}
 
@@ -196,10 +196,7 @@ namespace cb {
 
 
     T distanceSquared(const Vector<DIM, T> &v) const {
-      T d = 0;
-      for (unsigned i = 0; i < DIM; i++)
-        d += (data[i] - v.data[i]) * (data[i] - v.data[i]);
-      return d;
+      return (*this - v).lengthSquared();
     }
 
     T distance(const Vector<DIM, T> &v) const {
@@ -220,9 +217,7 @@ namespace cb {
     }
 
     T dotProduct(const Vector<DIM, T> &v) const {
-      T result = 0;
-      for (unsigned i = 0; i < DIM; i++) result += data[i] * v.data[i];
-      return result;
+      return SIMD::dot(data, v.data);
     }
 
     T dot(const Vector<DIM, T> &v) const {return dotProduct(v);}
@@ -297,19 +292,19 @@ namespace cb {
     // Arithmetic
     Vector<DIM, T> operator+(const Vector<DIM, T> &v) const {
       Vector<DIM, T> result;
-      for (unsigned i = 0; i < DIM; i++) result[i] = data[i] + v.data[i];
+      SIMD::add(data, v.data, result.data);
       return result;
     }
 
     Vector<DIM, T> operator-(const Vector<DIM, T> &v) const {
       Vector<DIM, T> result;
-      for (unsigned i = 0; i < DIM; i++) result[i] = data[i] - v.data[i];
+      SIMD::sub(data, v.data, result.data);
       return result;
     }
 
     Vector<DIM, T> operator*(const Vector<DIM, T> &v) const {
       Vector<DIM, T> result;
-      for (unsigned i = 0; i < DIM; i++) result[i] = data[i] * v.data[i];
+      SIMD::mul(data, v.data, result.data);
       return result;
     }
 
@@ -334,7 +329,7 @@ namespace cb {
 
     Vector<DIM, T> operator*(T v) const {
       Vector<DIM, T> result;
-      for (unsigned i = 0; i < DIM; i++) result[i] = data[i] * v;
+      SIMD::scale(data, v, result.data);
       return result;
     }
 
@@ -352,17 +347,17 @@ namespace cb {
     }
 
     Vector<DIM, T> &operator+=(const Vector<DIM, T> &v) {
-      for (unsigned i = 0; i < DIM; i++) data[i] += v.data[i];
+      SIMD::add(data, v.data, data);
       return *this;
     }
 
     Vector<DIM, T> &operator-=(const Vector<DIM, T> &v) {
-      for (unsigned i = 0; i < DIM; i++) data[i] -= v.data[i];
+      SIMD::sub(data, v.data, data);
       return *this;
     }
 
     Vector<DIM, T> &operator*=(const Vector<DIM, T> &v) {
-      for (unsigned i = 0; i < DIM; i++) data[i] *= v.data[i];
+      SIMD::mul(data, v.data, data);
       return *this;
     }
 
@@ -383,7 +378,7 @@ namespace cb {
     }
 
     Vector<DIM, T> &operator*=(T v) {
-      for (unsigned i = 0; i < DIM; i++) data[i] *= v;
+      SIMD::scale(data, v, data);
       return *this;
     }
 
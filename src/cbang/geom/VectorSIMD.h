@@ -0,0 +1,230 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+
+namespace cb {
+  /**
+   * Alignment of Vector::data.  Vectors which fill a 16 byte register are
+   * aligned so they do not straddle cache lines.  This does not depend on
+   * the instruction set so code built with different flags agrees on the
+   * layout.
+   */
+  template <unsigned DIM, typename T>
+  struct VectorAlign {static const unsigned value = alignof(T);};
+
+  template <> struct VectorAlign<4, float> {static const unsigned value = 16;};
+  template <> struct VectorAlign<2, double> {static const unsigned value = 16;};
+  template <> struct VectorAlign<4, double> {static const unsigned value = 16;};
+
+
+  /**
+   * Element-wise kernels used by Vector.  The generic loops are specialized
+   * below with SSE, AVX or NEON for the small float and double vectors that
+   * fit in one or two registers.  Loads are unaligned so any address works.
+   */
+  template <unsigned DIM, typename T>
+  struct VectorSIMD {
+
+    static T dot(const T *a, const T *b) {
+      T result = 0;
+      for (unsigned i = 0; i < DIM; i++) result += a[i] * b[i];
+      return result;
+    }
+
+    static void add(const T *a, const T *b, T *r)
+    {for (unsigned i = 0; i < DIM; i++) r[i] = a[i] + b[i];}
+
+    static void sub(const T *a, const T *b, T *r)
+    {for (unsigned i = 0; i < DIM; i++) r[i] = a[i] - b[i];}
+
+    static void mul(const T *a, const T *b, T *r)
+    {for (unsigned i = 0; i < DIM; i++) r[i] = a[i] * b[i];}
+
+    static void scale(const T *a, T x, T *r)
+    {for (unsigned i = 0; i < DIM; i++) r[i] = a[i] * x;}
+  };
+
+
+#ifdef __SSE2__
+  template <>
+  struct VectorSIMD<4, float> {
+    static float sum(__m128 x) {
+      x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+      return _mm_cvtss_f32(_mm_add_ss(x, _mm_shuffle_ps(x, x, 1)));
+    }
+
+    static float dot(const float *a, const float *b)
+    {return sum(_mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));}
+
+    static void add(const float *a, const float *b, float *r)
+    {_mm_storeu_ps(r, _mm_add_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));}
+
+    static void sub(const float *a, const float *b, float *r)
+    {_mm_storeu_ps(r, _mm_sub_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));}
+
+    static void mul(const float *a, const float *b, float *r)
+    {_mm_storeu_ps(r, _mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));}
+
+    static void scale(const float *a, float x, float *r)
+    {_mm_storeu_ps(r, _mm_mul_ps(_mm_loadu_ps(a), _mm_set1_ps(x)));}
+  };
+
+
+  template <>
+  struct VectorSIMD<2, double> {
+    static double sum(__m128d x)
+    {return _mm_cvtsd_f64(_mm_add_sd(x, _mm_unpackhi_pd(x, x)));}
+
+    static double dot(const double *a, const double *b)
+    {return sum(_mm_mul_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)));}
+
+    static void add(const double *a, const double *b, double *r)
+    {_mm_storeu_pd(r, _mm_add_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)));}
+
+    static void sub(const double *a, const double *b, double *r)
+    {_mm_storeu_pd(r, _mm_sub_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)));}
+
+    static void mul(const double *a, const double *b, double *r)
+    {_mm_storeu_pd(r, _mm_mul_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)));}
+
+    static void scale(const double *a, double x, double *r)
+    {_mm_storeu_pd(r, _mm_mul_pd(_mm_loadu_pd(a), _mm_set1_pd(x)));}
+  };
+
+
+#ifdef __AVX__
+  template <>
+  struct VectorSIMD<4, double> {
+    static double dot(const double *a, const double *b) {
+      __m256d x = _mm256_mul_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b));
+      return VectorSIMD<2, double>::sum
+        (_mm_add_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1)));
+    }
+
+    static void add(const double *a, const double *b, double *r) {
+      _mm256_storeu_pd
+        (r, _mm256_add_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b)));
+    }
+
+    static void sub(const double *a, const double *b, double *r) {
+      _mm256_storeu_pd
+        (r, _mm256_sub_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b)));
+    }
+
+    static void mul(const double *a, const double *b, double *r) {
+      _mm256_storeu_pd
+        (r, _mm256_mul_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b)));
+    }
+
+    static void scale(const double *a, double x, double *r) {
+      _mm256_storeu_pd
+        (r, _mm256_mul_pd(_mm256_loadu_pd(a), _mm256_set1_pd(x)));
+    }
+  };
+
+#else // __AVX__
+  template <>
+  struct VectorSIMD<4, double> {
+    typedef VectorSIMD<2, double> Half;
+    static double dot(const double *a, const double *b) {
+      return Half::sum
+        (_mm_add_pd(_mm_mul_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)),
+                    _mm_mul_pd(_mm_loadu_pd(a + 2), _mm_loadu_pd(b + 2))));
+    }
+
+    static void add(const double *a, const double *b, double *r)
+    {Half::add(a, b, r); Half::add(a + 2, b + 2, r + 2);}
+
+    static void sub(const double *a, const double *b, double *r)
+    {Half::sub(a, b, r); Half::sub(a + 2, b + 2, r + 2);}
+
+    static void mul(const double *a, const double *b, double *r)
+    {Half::mul(a, b, r); Half::mul(a + 2, b + 2, r + 2);}
+
+    static void scale(const double *a, double x, double *r)
+    {Half::scale(a, x, r); Half::scale(a + 2, x, r + 2);}
+  };
+#endif // __AVX__
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  template <>
+  struct VectorSIMD<4, float> {
+    static float dot(const float *a, const float *b)
+    {return vaddvq_f32(vmulq_f32(vld1q_f32(a), vld1q_f32(b)));}
+
+    static void add(const float *a, const float *b, float *r)
+    {vst1q_f32(r, vaddq_f32(vld1q_f32(a), vld1q_f32(b)));}
+
+    static void sub(const float *a, const float *b, float *r)
+    {vst1q_f32(r, vsubq_f32(vld1q_f32(a), vld1q_f32(b)));}
+
+    static void mul(const float *a, const float *b, float *r)
+    {vst1q_f32(r, vmulq_f32(vld1q_f32(a), vld1q_f32(b)));}
+
+    static void scale(const float *a, float x, float *r)
+    {vst1q_f32(r, vmulq_n_f32(vld1q_f32(a), x));}
+  };
+
+
+  template <>
+  struct VectorSIMD<2, double> {
+    static double dot(const double *a, const double *b)
+    {return vaddvq_f64(vmulq_f64(vld1q_f64(a), vld1q_f64(b)));}
+
+    static void add(const double *a, const double *b, double *r)
+    {vst1q_f64(r, vaddq_f64(vld1q_f64(a), vld1q_f64(b)));}
+
+    static void sub(const double *a, const double *b, double *r)
+    {vst1q_f64(r, vsubq_f64(vld1q_f64(a), vld1q_f64(b)));}
+
+    static void mul(const double *a, const double *b, double *r)
+    {vst1q_f64(r, vmulq_f64(vld1q_f64(a), vld1q_f64(b)));}
+
+    static void scale(const double *a, double x, double *r)
+    {vst1q_f64(r, vmulq_n_f64(vld1q_f64(a), x));}
+  };
+#endif // __SSE2__
+}
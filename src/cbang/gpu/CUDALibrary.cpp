@@ -36,6 +36,11 @@
 
 #include <cbang/Exception.h>
 #include <cbang/Catch.h>
+#include <cbang/String.h>
+#include <cbang/time/Timer.h>
+
+#include <algorithm>
+#include <functional>
 
 using namespace std;
 using namespace cb;
@@ -72,11 +77,91 @@ namespace {
   typedef int (CUDA_API *cuDeviceGetCount_t)(int *);
   typedef int (CUDA_API *cuDeviceComputeCapability_t)(int *, int *, int);
   typedef int (CUDA_API *cuDeviceGetAttribute_t)(int *, int, int);
+  typedef int (CUDA_API *cuDeviceGetUuid_t)(char *, int);
+  typedef int (CUDA_API *cuDeviceTotalMem_v2_t)(size_t *, int);
+  typedef int (CUDA_API *cuCtxCreate_v2_t)(void **, unsigned, int);
+  typedef int (CUDA_API *cuCtxDestroy_v2_t)(void *);
+  typedef int (CUDA_API *cuCtxSynchronize_t)();
+  typedef int (CUDA_API *cuMemAlloc_v2_t)(uint64_t *, size_t);
+  typedef int (CUDA_API *cuMemFree_v2_t)(uint64_t);
+  typedef int (CUDA_API *cuMemcpyHtoD_v2_t)(uint64_t, const void *, size_t);
+  typedef int (CUDA_API *cuMemcpyDtoD_v2_t)(uint64_t, uint64_t, size_t);
+  typedef int (CUDA_API *cuModuleLoadData_t)(void **, const void *);
+  typedef int (CUDA_API *cuModuleUnload_t)(void *);
+  typedef int (CUDA_API *cuModuleGetFunction_t)(void **, void *, const char *);
+  typedef int (CUDA_API *cuLaunchKernel_t)
+  (void *, unsigned, unsigned, unsigned, unsigned, unsigned, unsigned,
+   unsigned, void *, void **, void **);
 
   const int CU_DEVICE_ATTRIBUTE_PCI_BUS_ID = 33;
   const int CU_DEVICE_ATTRIBUTE_PCI_DEVICE_ID = 34;
   const int CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MAJOR = 75;
   const int CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MINOR = 76;
+
+  const unsigned FMA_ITERATIONS = 256;
+  const unsigned FMA_BLOCK = 256;
+
+
+  /// Calls the added functions in reverse order when destroyed
+  class Releaser {
+    vector<function<void ()> > fns;
+
+  public:
+    ~Releaser() {
+      for (; !fns.empty(); fns.pop_back())
+        try {fns.back()();} CATCH_DEBUG(3);
+    }
+
+    void add(const function<void ()> &fn) {fns.push_back(fn);}
+  };
+
+
+  // Four independent FMA chains per thread, as in OpenCLLibrary
+  const char *benchmarkPTX =
+    ".version 6.0\n"
+    ".target sm_30\n"
+    ".address_size 64\n"
+    "\n"
+    ".visible .entry bench(.param .u64 out, .param .$T a) {\n"
+    "  .reg .pred %p;\n"
+    "  .reg .u32 %r<5>;\n"
+    "  .reg .u64 %rd<4>;\n"
+    "  .reg .$T %f<6>;\n"
+    "\n"
+    "  ld.param.u64 %rd1, [out];\n"
+    "  ld.param.$T %f5, [a];\n"
+    "  mov.u32 %r1, %ctaid.x;\n"
+    "  mov.u32 %r2, %ntid.x;\n"
+    "  mov.u32 %r3, %tid.x;\n"
+    "  mad.lo.u32 %r1, %r1, %r2, %r3;\n"
+    "  cvt.rn.$T.u32 %f1, %r1;\n"
+    "  add.$T %f2, %f1, %f5;\n"
+    "  add.$T %f3, %f2, %f5;\n"
+    "  add.$T %f4, %f3, %f5;\n"
+    "  mov.u32 %r4, 0;\n"
+    "\n"
+    "LOOP:\n"
+    "  fma.rn.$T %f1, %f1, %f5, %f5;\n"
+    "  fma.rn.$T %f2, %f2, %f5, %f5;\n"
+    "  fma.rn.$T %f3, %f3, %f5, %f5;\n"
+    "  fma.rn.$T %f4, %f4, %f5, %f5;\n"
+    "  fma.rn.$T %f1, %f1, %f5, %f5;\n"
+    "  fma.rn.$T %f2, %f2, %f5, %f5;\n"
+    "  fma.rn.$T %f3, %f3, %f5, %f5;\n"
+    "  fma.rn.$T %f4, %f4, %f5, %f5;\n"
+    "  add.u32 %r4, %r4, 1;\n"
+    "  setp.lt.u32 %p, %r4, $N;\n"
+    "  @%p bra LOOP;\n"
+    "\n"
+    "  add.$T %f1, %f1, %f2;\n"
+    "  add.$T %f3, %f3, %f4;\n"
+    "  add.$T %f1, %f1, %f3;\n"
+    "  cvta.to.global.u64 %rd1, %rd1;\n"
+    "  mul.wide.u32 %rd2, %r1, $B;\n"
+    "  add.u64 %rd3, %rd1, %rd2;\n"
+    "  st.global.$T [%rd3], %f1;\n"
+    "  ret;\n"
+    "}\n";
 }
 
 
@@ -113,6 +198,12 @@ CUDALibrary::CUDALibrary(Inaccessible) : DynamicLibrary(cudaLib) {
       cd.pciBus = getAttribute(CU_DEVICE_ATTRIBUTE_PCI_BUS_ID, device);
       cd.pciSlot = getAttribute(CU_DEVICE_ATTRIBUTE_PCI_DEVICE_ID, device);
 
+      try {
+        char uuid[16];
+        DYNAMIC_CALL(cuDeviceGetUuid, (uuid, device));
+        cd.uuid = String::hexEncode(string(uuid, 16));
+      } CATCH_DEBUG(3); // Requires CUDA 9.2
+
       devices.push_back(cd);
     } CATCH_ERROR;
   }
@@ -131,3 +222,103 @@ int CUDALibrary::getAttribute(int id, int dev) {
   DYNAMIC_CALL(cuDeviceGetAttribute, (&value, id, dev));
   return value;
 }
+
+
+ComputeBenchmark CUDALibrary::benchmark(unsigned i) {
+  int err;
+  int device = 0;
+  DYNAMIC_CALL(cuDeviceGet, (&device, getDevice(i).deviceIndex));
+
+  Releaser cleanup;
+
+  void *ctx = 0;
+  DYNAMIC_CALL(cuCtxCreate_v2, (&ctx, 0, device));
+  cleanup.add([this, ctx] () {
+    int err;
+    DYNAMIC_CALL(cuCtxDestroy_v2, (ctx));
+  });
+
+  size_t total = 0;
+  DYNAMIC_CALL(cuDeviceTotalMem_v2, (&total, device));
+  size_t size = std::min<size_t>(64 << 20, total / 4) & ~(size_t)15;
+  if (!size) THROW("CUDA device " << i << " has no memory");
+
+  uint64_t in = 0;
+  uint64_t out = 0;
+  for (uint64_t *ptr: {&in, &out}) {
+    DYNAMIC_CALL(cuMemAlloc_v2, (ptr, size));
+    uint64_t mem = *ptr;
+    cleanup.add([this, mem] () {
+      int err;
+      DYNAMIC_CALL(cuMemFree_v2, (mem));
+    });
+  }
+
+  // Each test is run once to warm up and the fastest of the rest is kept
+  auto measure = [&] (const function<void ()> &run) {
+    run();
+
+    double best = 0;
+    for (unsigned j = 0; j < 3; j++) {
+      double start = Timer::now();
+      run();
+      DYNAMIC_CALL(cuCtxSynchronize, ());
+      double delta = Timer::now() - start;
+      if (!j || delta < best) best = delta;
+    }
+
+    return std::max(best, 1e-9);
+  };
+
+  ComputeBenchmark result;
+
+  // Host to device
+  vector<char> host(size);
+  result.transferRate = size / measure([&] () {
+    DYNAMIC_CALL(cuMemcpyHtoD_v2, (in, &host[0], size));
+  }) / 1e9;
+
+  // Device memory
+  result.memoryBandwidth = 2.0 * size / measure([&] () {
+    DYNAMIC_CALL(cuMemcpyDtoD_v2, (out, in, size));
+  }) / 1e9;
+
+  // Floating point
+  auto fma = [&] (bool fp64) {
+    string ptx = benchmarkPTX;
+    ptx = String::replace(ptx, "\\$T", fp64 ? "f64" : "f32");
+    ptx = String::replace(ptx, "\\$B", fp64 ? "8" : "4");
+    ptx = String::replace(ptx, "\\$N", String(FMA_ITERATIONS));
+
+    void *module = 0;
+    DYNAMIC_CALL(cuModuleLoadData, (&module, ptx.c_str()));
+    cleanup.add([this, module] () {
+      int err;
+      DYNAMIC_CALL(cuModuleUnload, (module));
+    });
+
+    void *bench = 0;
+    DYNAMIC_CALL(cuModuleGetFunction, (&bench, module, "bench"));
+
+    float a32 = 0.999f;
+    double a64 = 0.999;
+    void *args[] = {&out, fp64 ? (void *)&a64 : (void *)&a32};
+
+    unsigned blocks = std::min<size_t>(1 << 20, size / 8) / FMA_BLOCK;
+    double flops = 16.0 * FMA_ITERATIONS * blocks * FMA_BLOCK;
+
+    return flops / measure([&] () {
+      DYNAMIC_CALL(cuLaunchKernel,
+                   (bench, blocks, 1, 1, FMA_BLOCK, 1, 1, 0, 0, args, 0));
+    }) / 1e9;
+  };
+
+  result.fp32 = fma(false);
+
+  // All CUDA devices since compute capability 1.3 support FP64
+  try {
+    result.fp64 = fma(true);
+  } CATCH_DEBUG(3);
+
+  return devices[i].benchmark = result;
+}
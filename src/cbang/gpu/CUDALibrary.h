@@ -56,6 +56,9 @@ namespace cb {
     iterator begin() const {return devices.begin();}
     iterator end() const {return devices.end();}
 
+    /// See OpenCLLibrary::benchmark()
+    ComputeBenchmark benchmark(unsigned i);
+
   private:
     int getAttribute(int id, int dev);
   };
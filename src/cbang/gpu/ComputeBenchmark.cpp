@@ -0,0 +1,72 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "ComputeBenchmark.h"
+
+#include <cbang/json/JSON.h>
+
+#include <cmath>
+
+using namespace std;
+using namespace cb;
+
+
+double ComputeBenchmark::getScore() const {
+  return isValid() ? sqrt(fp32 * memoryBandwidth) : 0;
+}
+
+
+void ComputeBenchmark::print(ostream &stream) const {
+  stream << "Memory:" << memoryBandwidth << "GB/s"
+         << " FP32:" << fp32 << "GFLOPS"
+         << " FP64:" << fp64 << "GFLOPS"
+         << " Transfer:" << transferRate << "GB/s";
+}
+
+
+void ComputeBenchmark::read(const JSON::Value &value) {
+  memoryBandwidth = value.getNumber("memory", 0);
+  fp32 = value.getNumber("fp32", 0);
+  fp64 = value.getNumber("fp64", 0);
+  transferRate = value.getNumber("transfer", 0);
+}
+
+
+void ComputeBenchmark::write(JSON::Sink &sink) const {
+  sink.beginDict();
+  sink.insert("memory", memoryBandwidth);
+  sink.insert("fp32", fp32);
+  sink.insert("fp64", fp64);
+  sink.insert("transfer", transferRate);
+  sink.endDict();
+}
@@ -0,0 +1,68 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cbang/json/Serializable.h>
+
+#include <ostream>
+
+
+namespace cb {
+  /// Results of the quick calibration of a compute device
+  struct ComputeBenchmark : public JSON::Serializable {
+    double memoryBandwidth; ///< Device memory copy in GB/s
+    double fp32;            ///< Single precision FMA in GFLOP/s
+    double fp64;            ///< Double precision FMA in GFLOP/s, 0 if none
+    double transferRate;    ///< Host to device copy in GB/s
+
+    ComputeBenchmark() :
+      memoryBandwidth(0), fp32(0), fp64(0), transferRate(0) {}
+    ComputeBenchmark(const JSON::Value &value) {read(value);}
+
+    bool isValid() const {return 0 < fp32 && 0 < memoryBandwidth;}
+
+    /**
+     * The geometric mean of the FP32 throughput and memory bandwidth, or
+     * zero if not measured.  Higher is faster.  Work which depends on
+     * FP64 or PCIe transfers should also compare those values.
+     */
+    double getScore() const;
+
+    void print(std::ostream &stream) const;
+
+    // From JSON::Serializable
+    void read(const JSON::Value &value);
+    void write(JSON::Sink &sink) const;
+  };
+}
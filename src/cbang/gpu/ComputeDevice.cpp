@@ -33,6 +33,7 @@
 #include "ComputeDevice.h"
 
 #include <cbang/String.h>
+#include <cbang/json/JSON.h>
 
 using namespace std;
 using namespace cb;
@@ -44,6 +45,17 @@ bool ComputeDevice::isValid() const {
 }
 
 
+string ComputeDevice::getBenchmarkKey() const {
+  string key = uuid;
+
+  if (key.empty())
+    key = String::printf("%d:%d:%d:%d", platformIndex, deviceIndex, pciBus,
+                         pciSlot);
+
+  return key + " " + driverVersion.toString();
+}
+
+
 void ComputeDevice::print(ostream &stream) const {
   stream << "Platform:" << platformIndex
          << " Device:" << deviceIndex
@@ -51,4 +63,45 @@ void ComputeDevice::print(ostream &stream) const {
          << " Slot:" << ((pciSlot == -1) ? "NA" : String(pciSlot))
          << " Compute:" << computeVersion
          << " Driver:" << driverVersion;
+
+  if (benchmark.isValid()) {
+    stream << ' ';
+    benchmark.print(stream);
+  }
+}
+
+
+void ComputeDevice::read(const JSON::Value &value) {
+  driverVersion = VersionU16(value.getString("driver", "0.0"));
+  computeVersion = VersionU16(value.getString("compute", "0.0"));
+  vendorID = value.getS32("vendor", -1);
+  platformIndex = value.getS32("platform", -1);
+  deviceIndex = value.getS32("device", -1);
+  gpu = value.getBoolean("gpu", false);
+  pciBus = value.getS32("bus", -1);
+  pciSlot = value.getS32("slot", -1);
+  uuid = value.getString("uuid", "");
+  if (value.has("benchmark")) benchmark.read(*value.get("benchmark"));
+  else benchmark = ComputeBenchmark();
+}
+
+
+void ComputeDevice::write(JSON::Sink &sink) const {
+  sink.beginDict();
+  sink.insert("driver", driverVersion.toString());
+  sink.insert("compute", computeVersion.toString());
+  if (vendorID != -1) sink.insert("vendor", vendorID);
+  sink.insert("platform", platformIndex);
+  sink.insert("device", deviceIndex);
+  sink.insertBoolean("gpu", gpu);
+  if (pciBus != -1) sink.insert("bus", pciBus);
+  if (pciSlot != -1) sink.insert("slot", pciSlot);
+  if (!uuid.empty()) sink.insert("uuid", uuid);
+
+  if (benchmark.isValid()) {
+    sink.beginInsert("benchmark");
+    benchmark.write(sink);
+  }
+
+  sink.endDict();
 }
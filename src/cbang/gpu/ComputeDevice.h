@@ -32,14 +32,17 @@
 
 #pragma once
 
+#include "ComputeBenchmark.h"
+
 #include <cbang/StdTypes.h>
 #include <cbang/util/Version.h>
+#include <cbang/json/Serializable.h>
 
 #include <ostream>
 
 
 namespace cb {
-  struct ComputeDevice {
+  struct ComputeDevice : public JSON::Serializable {
     VersionU16 driverVersion;
     VersionU16 computeVersion;
     int32_t vendorID;
@@ -48,14 +51,30 @@ namespace cb {
     bool gpu;
     int pciBus;
     int pciSlot;
+    std::string uuid;
+    ComputeBenchmark benchmark;
 
     ComputeDevice() :
       vendorID(-1), platformIndex(-1), deviceIndex(-1), gpu(false), pciBus(-1),
       pciSlot(-1) {}
+    ComputeDevice(const JSON::Value &value) {read(value);}
 
     bool isValid() const;
 
+    /// @return The measured speed, zero if the device was not calibrated
+    double getScore() const {return benchmark.getScore();}
+
+    /**
+     * Identifies the device and driver for cached benchmark results.  The
+     * UUID is used when the driver reports one, otherwise the PCI location.
+     */
+    std::string getBenchmarkKey() const;
+
     void print(std::ostream &stream) const;
+
+    // From JSON::Serializable
+    void read(const JSON::Value &value);
+    void write(JSON::Sink &sink) const;
   };
 
 
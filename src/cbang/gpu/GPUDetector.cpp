@@ -0,0 +1,335 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "GPUDetector.h"
+#include "CUDALibrary.h"
+#include "OpenCLLibrary.h"
+
+#include <cbang/String.h>
+#include <cbang/Catch.h>
+#include <cbang/pci/PCIInfo.h>
+#include <cbang/os/SystemInfo.h>
+#include <cbang/os/SystemUtilities.h>
+#include <cbang/util/SmartLock.h>
+#include <cbang/time/Timer.h>
+#include <cbang/json/JSON.h>
+#include <cbang/log/Logger.h>
+
+#ifndef _WIN32
+#include <sys/utsname.h>
+#endif
+
+using namespace std;
+using namespace cb;
+
+
+GPUDetector::GPUDetector(Inaccessible) :
+  ThreadPool(BACKEND_COUNT), nextBackend(0) {
+  for (unsigned i = 0; i < BACKEND_COUNT; i++) done[i] = false;
+  setNames("GPUDetect");
+}
+
+
+GPUDetector::~GPUDetector() {
+  // Detection threads cannot be interrupted in the vendor libraries
+  if (started) ThreadPool::wait();
+}
+
+
+bool GPUDetector::detect() {
+  if (!started) {
+    if (loadCache()) return true;
+
+    started = true;
+    start();
+  }
+
+  bool complete = waitFor(timeout);
+
+  if (!complete)
+    for (unsigned i = 0; i < BACKEND_COUNT; i++)
+      if (!isDone((backend_t)i))
+        LOG_WARNING(getBackendName((backend_t)i) << " detection did not "
+                    "finish within " << timeout << " seconds");
+
+  if (complete && !cacheFile.empty())
+    try {
+      saveCache();
+    } CATCH_WARNING;
+
+  return complete;
+}
+
+
+bool GPUDetector::isDone(backend_t backend) const {
+  SmartLock lock(&condition);
+  return done[backend];
+}
+
+
+GPUDetector::compute_devices_t GPUDetector::getCUDADevices() const {
+  SmartLock lock(&condition);
+  return cudaDevices;
+}
+
+
+GPUDetector::compute_devices_t GPUDetector::getOpenCLDevices() const {
+  SmartLock lock(&condition);
+  return openclDevices;
+}
+
+
+GPUDetector::pci_devices_t GPUDetector::getPCIDevices() const {
+  SmartLock lock(&condition);
+  return pciDevices;
+}
+
+
+string GPUDetector::getCacheKey() {
+  string key;
+
+#ifdef _WIN32
+  key = SystemInfo::instance().getOSVersion().toString();
+
+  // Driver updates replace the vendor DLLs
+  const char *root = SystemUtilities::getenv("SystemRoot");
+  const char *libs[] = {"nvcuda.dll", "OpenCL.dll", 0};
+
+  for (unsigned i = 0; root && libs[i]; i++) {
+    string path =
+      SystemUtilities::joinPath(string(root) + "\\System32", libs[i]);
+
+    if (SystemUtilities::exists(path))
+      key += String::printf(" %s:%llu", libs[i], (unsigned long long)
+                            SystemUtilities::getModificationTime(path));
+  }
+
+#else
+  struct utsname info;
+  if (!uname(&info)) key = string(info.release) + " " + info.version;
+
+  // Kernel module versions of the GPU drivers
+  const char *files[] = {
+    "/proc/driver/nvidia/version", "/sys/module/amdgpu/version", 0};
+
+  for (unsigned i = 0; files[i]; i++)
+    if (SystemUtilities::exists(files[i]))
+      try {
+        SmartPointer<iostream> f = SystemUtilities::open(files[i], ios::in);
+        string line;
+        getline(*f, line);
+        key += " " + String::trim(line);
+      } CATCH_DEBUG(3);
+#endif
+
+  return key;
+}
+
+
+const char *GPUDetector::getBackendName(backend_t backend) {
+  switch (backend) {
+  case BACKEND_CUDA: return "CUDA";
+  case BACKEND_OPENCL: return "OpenCL";
+  case BACKEND_PCI: return "PCI";
+  default: return "Unknown";
+  }
+}
+
+
+bool GPUDetector::allDone() const {
+  for (unsigned i = 0; i < BACKEND_COUNT; i++)
+    if (!done[i]) return false;
+  return true;
+}
+
+
+bool GPUDetector::waitFor(double timeout) {
+  double deadline = Timer::now() + timeout;
+
+  SmartLock lock(&condition);
+
+  while (!allDone()) {
+    if (timeout < 0) condition.wait();
+    else {
+      double remaining = deadline - Timer::now();
+      if (remaining <= 0) break;
+      condition.timedWait(remaining);
+    }
+  }
+
+  return allDone();
+}
+
+
+bool GPUDetector::loadCache() {
+  if (cacheFile.empty() || !SystemUtilities::exists(cacheFile)) return false;
+
+  try {
+    JSON::ValuePtr cache = JSON::Reader::parse(InputSource(cacheFile));
+
+    const JSON::Value &cuda = *cache->get("cuda");
+    for (unsigned i = 0; i < cuda.size(); i++)
+      cudaDevices.push_back(ComputeDevice(*cuda.get(i)));
+
+    const JSON::Value &opencl = *cache->get("opencl");
+    for (unsigned i = 0; i < opencl.size(); i++)
+      openclDevices.push_back(ComputeDevice(*opencl.get(i)));
+
+    // Measurements are reused even if detection must run again
+    bool calibrated = true;
+    for (auto *devices: {&cudaDevices, &openclDevices})
+      for (auto &dev: *devices)
+        if (dev.benchmark.isValid())
+          benchmarks[dev.getBenchmarkKey()] = dev.benchmark;
+        else calibrated = false;
+
+    if (cache->getString("key", "") != getCacheKey())
+      LOG_INFO(3, "GPU detection cache is out of date");
+
+    else if (calibrate && !calibrated)
+      LOG_INFO(3, "GPU detection cache is not calibrated");
+
+    else {
+      const JSON::Value &pci = *cache->get("pci");
+      for (unsigned i = 0; i < pci.size(); i++)
+        pciDevices.push_back(PCIDevice(*pci.get(i)));
+
+      for (unsigned i = 0; i < BACKEND_COUNT; i++) done[i] = true;
+
+      LOG_INFO(3, "Loaded GPU detection results from " << cacheFile);
+
+      return true;
+    }
+  } CATCH_WARNING;
+
+  cudaDevices.clear();
+  openclDevices.clear();
+  pciDevices.clear();
+
+  return false;
+}
+
+
+void GPUDetector::saveCache() const {
+  SmartPointer<ostream> stream = SystemUtilities::oopen(cacheFile);
+  JSON::Writer writer(*stream, 0, false);
+
+  writer.beginDict();
+  writer.insert("key", getCacheKey());
+
+  writer.insertList("cuda");
+  for (unsigned i = 0; i < cudaDevices.size(); i++) {
+    writer.beginAppend();
+    cudaDevices[i].write(writer);
+  }
+  writer.endList();
+
+  writer.insertList("opencl");
+  for (unsigned i = 0; i < openclDevices.size(); i++) {
+    writer.beginAppend();
+    openclDevices[i].write(writer);
+  }
+  writer.endList();
+
+  writer.insertList("pci");
+  for (unsigned i = 0; i < pciDevices.size(); i++) {
+    writer.beginAppend();
+    pciDevices[i].write(writer);
+  }
+  writer.endList();
+
+  writer.endDict();
+  writer.close();
+}
+
+
+template <typename LIB>
+void GPUDetector::calibrateDevices(LIB &lib, compute_devices_t &devices) {
+  SmartLock lock(&calibrating);
+
+  for (unsigned i = 0; i < devices.size(); i++) {
+    ComputeDevice &dev = devices[i];
+    auto it = benchmarks.find(dev.getBenchmarkKey());
+
+    if (it != benchmarks.end()) dev.benchmark = it->second;
+    else
+      try {
+        dev.benchmark = lib.benchmark(i);
+        LOG_INFO(3, "Calibrated " << dev);
+      } CATCH_WARNING;
+  }
+}
+
+
+void GPUDetector::run() {
+  unsigned backend;
+
+  while ((backend = nextBackend++) < BACKEND_COUNT) {
+    compute_devices_t devices;
+    pci_devices_t pci;
+
+    try {
+      switch (backend) {
+      case BACKEND_CUDA: {
+        CUDALibrary &lib = CUDALibrary::instance();
+        devices.assign(lib.begin(), lib.end());
+        if (calibrate) calibrateDevices(lib, devices);
+        break;
+      }
+
+      case BACKEND_OPENCL: {
+        OpenCLLibrary &lib = OpenCLLibrary::instance();
+        devices.assign(lib.begin(), lib.end());
+        if (calibrate) calibrateDevices(lib, devices);
+        break;
+      }
+
+      case BACKEND_PCI: {
+        PCIInfo &info = PCIInfo::instance();
+        pci.assign(info.begin(), info.end());
+        break;
+      }
+      }
+    } CATCH_DEBUG(3);
+
+    SmartLock lock(&condition);
+
+    switch (backend) {
+    case BACKEND_CUDA: cudaDevices = devices; break;
+    case BACKEND_OPENCL: openclDevices = devices; break;
+    case BACKEND_PCI: pciDevices = pci; break;
+    }
+
+    done[backend] = true;
+    condition.broadcast();
+  }
+}
@@ -0,0 +1,143 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "ComputeDevice.h"
+
+#include <cbang/pci/PCIDevice.h>
+#include <cbang/os/ThreadPool.h>
+#include <cbang/os/Condition.h>
+#include <cbang/os/Mutex.h>
+#include <cbang/util/Singleton.h>
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <map>
+
+
+namespace cb {
+  /**
+   * Runs CUDA, OpenCL and PCI device detection concurrently, one backend
+   * per thread, and waits at most a configurable timeout for the results.
+   * A backend which has not finished in time is reported as not done and
+   * its results become available if it completes later.
+   *
+   * When a cache file is set, complete results are saved as JSON keyed by
+   * the kernel and GPU driver versions and reused until either changes.
+   *
+   * With calibration enabled each CUDA and OpenCL device is also measured,
+   * see ComputeDevice::getScore().  Measurements are kept in the cache by
+   * device and driver version, so they survive other system updates.
+   *
+   * While detection is running, CUDALibrary, OpenCLLibrary and PCIInfo
+   * should only be accessed through this class.
+   */
+  class GPUDetector : public ThreadPool, public Singleton<GPUDetector> {
+  public:
+    typedef enum {
+      BACKEND_CUDA,
+      BACKEND_OPENCL,
+      BACKEND_PCI,
+      BACKEND_COUNT,
+    } backend_t;
+
+    typedef std::vector<ComputeDevice> compute_devices_t;
+    typedef std::vector<PCIDevice> pci_devices_t;
+
+  protected:
+    std::string cacheFile;
+    double timeout = 10;
+    bool calibrate = false;
+    bool started = false;
+
+    Condition condition;
+    std::atomic<unsigned> nextBackend;
+    bool done[BACKEND_COUNT];
+
+    compute_devices_t cudaDevices;
+    compute_devices_t openclDevices;
+    pci_devices_t pciDevices;
+
+    /// Previous measurements by ComputeDevice::getBenchmarkKey()
+    std::map<std::string, ComputeBenchmark> benchmarks;
+    Mutex calibrating; // CUDA and OpenCL may use the same devices
+
+  public:
+    GPUDetector(Inaccessible);
+    ~GPUDetector();
+
+    const std::string &getCacheFile() const {return cacheFile;}
+    void setCacheFile(const std::string &path) {cacheFile = path;}
+
+    double getTimeout() const {return timeout;}
+    /// Seconds detect() waits for the backends, -1 to wait forever
+    void setTimeout(double timeout) {this->timeout = timeout;}
+
+    bool getCalibrate() const {return calibrate;}
+    /// Must be set before detect() to benchmark uncached devices
+    void setCalibrate(bool calibrate) {this->calibrate = calibrate;}
+
+    /**
+     * Load results from the cache or run detection.  Only the first call
+     * starts the detection threads, later calls wait for any remaining
+     * backends for up to the timeout again.
+     * @return True if all backends finished.
+     */
+    bool detect();
+
+    bool isDone(backend_t backend) const;
+
+    compute_devices_t getCUDADevices() const;
+    compute_devices_t getOpenCLDevices() const;
+    pci_devices_t getPCIDevices() const;
+
+    /// Identifies the kernel and GPU driver versions of this system
+    static std::string getCacheKey();
+
+    static const char *getBackendName(backend_t backend);
+
+  protected:
+    bool allDone() const;
+    bool waitFor(double timeout);
+
+    bool loadCache();
+    void saveCache() const;
+
+    template <typename LIB>
+    void calibrateDevices(LIB &lib, compute_devices_t &devices);
+
+    // From ThreadPool
+    void run();
+  };
+}
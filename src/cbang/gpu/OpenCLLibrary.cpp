@@ -37,6 +37,11 @@
 #include <cbang/Exception.h>
 #include <cbang/StdTypes.h>
 #include <cbang/Catch.h>
+#include <cbang/String.h>
+#include <cbang/time/Timer.h>
+
+#include <algorithm>
+#include <functional>
 
 #include <string.h>
 
@@ -80,6 +85,13 @@ namespace {
   typedef cl_uint cl_device_info;
   typedef void *cl_platform_id;
   typedef cl_ulong cl_device_type;
+  typedef void *cl_context;
+  typedef void *cl_command_queue;
+  typedef void *cl_program;
+  typedef void *cl_kernel;
+  typedef void *cl_mem;
+  typedef void *cl_event;
+  typedef cl_ulong cl_mem_flags;
 
   typedef union {
     struct {
@@ -107,6 +119,38 @@ namespace {
   typedef cl_int (CL_API_CALL *clGetDeviceIDs_t)
   (cl_platform_id, cl_device_type, cl_uint, cl_device_id *, cl_uint *);
 
+  typedef cl_context (CL_API_CALL *clCreateContext_t)
+  (const intptr_t *, cl_uint, const cl_device_id *, void *, void *, cl_int *);
+
+  typedef cl_command_queue (CL_API_CALL *clCreateCommandQueue_t)
+  (cl_context, cl_device_id, cl_ulong, cl_int *);
+
+  typedef cl_mem (CL_API_CALL *clCreateBuffer_t)
+  (cl_context, cl_mem_flags, size_t, void *, cl_int *);
+
+  typedef cl_program (CL_API_CALL *clCreateProgramWithSource_t)
+  (cl_context, cl_uint, const char **, const size_t *, cl_int *);
+
+  typedef cl_int (CL_API_CALL *clBuildProgram_t)
+  (cl_program, cl_uint, const cl_device_id *, const char *, void *, void *);
+
+  typedef cl_kernel (CL_API_CALL *clCreateKernel_t)
+  (cl_program, const char *, cl_int *);
+
+  typedef cl_int (CL_API_CALL *clSetKernelArg_t)
+  (cl_kernel, cl_uint, size_t, const void *);
+
+  typedef cl_int (CL_API_CALL *clEnqueueNDRangeKernel_t)
+  (cl_command_queue, cl_kernel, cl_uint, const size_t *, const size_t *,
+   const size_t *, cl_uint, const cl_event *, cl_event *);
+
+  typedef cl_int (CL_API_CALL *clEnqueueWriteBuffer_t)
+  (cl_command_queue, cl_mem, cl_uint, size_t, size_t, const void *, cl_uint,
+   const cl_event *, cl_event *);
+
+  typedef cl_int (CL_API_CALL *clFinish_t)(cl_command_queue);
+  typedef cl_int (CL_API_CALL *clRelease_t)(void *);
+
 
   // OpenCL defines
   enum _cl_device_type_t {
@@ -121,8 +165,11 @@ namespace {
   enum _cl_param_t {
     CL_DEVICE_TYPE =                   0x1000,
     CL_DEVICE_VENDOR_ID =              0x1001,
+    CL_DEVICE_MAX_MEM_ALLOC_SIZE =     0x1010,
+    CL_DEVICE_DOUBLE_FP_CONFIG =       0x1032,
     CL_DRIVER_VERSION =                0x102d,
     CL_DEVICE_VERSION =                0x102f,
+    CL_DEVICE_UUID_KHR =               0x106a,
     CL_DEVICE_TOPOLOGY_AMD =           0x4037,
     CL_DEVICE_TOPOLOGY_TYPE_PCIE_AMD = 0x0001,
     CL_DEVICE_PCI_BUS_ID_NV =          0x4008,
@@ -136,6 +183,12 @@ namespace {
     if ((err = name args)) THROW(#name "() returned " << err);         \
   }
 
+#define DYNAMIC_CREATE(lib, var, name, args) {                          \
+    name##_t name = (name##_t)lib->getSymbol(#name);                    \
+    var = name args;                                                    \
+    if (err) THROW(#name "() returned " << err);                       \
+  }
+
 
 namespace {
   size_t getDeviceInfoSize(DynamicLibrary *lib, cl_device_id dev,
@@ -172,6 +225,45 @@ namespace {
 
     return string(data.get(), strnlen(data.get(), size));
   }
+
+
+  /// Releases an OpenCL object when it goes out of scope
+  class CLObject {
+    DynamicLibrary *lib;
+    const char *release;
+
+  public:
+    void *obj = 0;
+
+    CLObject(DynamicLibrary *lib, const char *release) :
+      lib(lib), release(release) {}
+    ~CLObject() {if (obj) ((clRelease_t)lib->getSymbol(release))(obj);}
+
+    operator void *() const {return obj;}
+  };
+
+
+  const unsigned FMA_ITERATIONS = 256;
+
+  const char *benchmarkSource =
+    "#ifdef FP64\n"
+    "#pragma OPENCL EXTENSION cl_khr_fp64 : enable\n"
+    "#endif\n"
+    "\n"
+    "__kernel void copy(__global const float4 *in, __global float4 *out) {\n"
+    "  out[get_global_id(0)] = in[get_global_id(0)];\n"
+    "}\n"
+    "\n"
+    "__kernel void bench(__global REAL *out, REAL a) {\n"
+    "  REAL x0 = get_global_id(0), x1 = x0 + 1, x2 = x0 + 2, x3 = x0 + 3;\n"
+    "  for (int i = 0; i < ITERATIONS; i++) {\n"
+    "    x0 = mad(x0, a, a); x1 = mad(x1, a, a);\n"
+    "    x2 = mad(x2, a, a); x3 = mad(x3, a, a);\n"
+    "    x0 = mad(x0, a, a); x1 = mad(x1, a, a);\n"
+    "    x2 = mad(x2, a, a); x3 = mad(x3, a, a);\n"
+    "  }\n"
+    "  out[get_global_id(0)] = x0 + x1 + x2 + x3;\n"
+    "}\n";
 }
 
 
@@ -292,7 +384,16 @@ OpenCLLibrary::OpenCLLibrary(Inaccessible) : DynamicLibrary(openclLib) {
           }
         } CATCH_DEBUG(3);
 
+        // Get UUID, cl_khr_device_uuid
+        try {
+          size_t size = 0;
+          SmartPointer<char> data =
+            getDeviceInfoData(this, device, CL_DEVICE_UUID_KHR, &size);
+          if (size == 16) cd.uuid = String::hexEncode(string(data.get(), 16));
+        } CATCH_DEBUG(3);
+
         this->devices.push_back(cd);
+        ids.push_back(device);
       } CATCH_ERROR;
     }
   }
@@ -303,3 +404,110 @@ const ComputeDevice &OpenCLLibrary::getDevice(unsigned i) const {
   if (getDeviceCount() <= i) THROW("Invalid OpenCL device index " << i);
   return devices.at(i);
 }
+
+
+ComputeBenchmark OpenCLLibrary::benchmark(unsigned i) {
+  getDevice(i); // Check index
+  cl_device_id device = ids[i];
+  cl_int err;
+
+  CLObject context(this, "clReleaseContext");
+  DYNAMIC_CREATE(this, context.obj, clCreateContext,
+                 (0, 1, &device, 0, 0, &err));
+
+  CLObject queue(this, "clReleaseCommandQueue");
+  DYNAMIC_CREATE(this, queue.obj, clCreateCommandQueue,
+                 (context, device, 0, &err));
+
+  cl_ulong maxAlloc = 0;
+  DYNAMIC_CALL(this, clGetDeviceInfo, (device, CL_DEVICE_MAX_MEM_ALLOC_SIZE,
+                                       sizeof(maxAlloc), &maxAlloc, 0));
+  size_t size = std::min<cl_ulong>(64 << 20, maxAlloc / 2) & ~(size_t)15;
+  if (!size) THROW("OpenCL device " << i << " has no memory");
+
+  CLObject in(this, "clReleaseMemObject");
+  CLObject out(this, "clReleaseMemObject");
+  DYNAMIC_CREATE(this, in.obj, clCreateBuffer, (context, 1, size, 0, &err));
+  DYNAMIC_CREATE(this, out.obj, clCreateBuffer, (context, 1, size, 0, &err));
+
+  // Each test is run once to warm up and the fastest of the rest is kept
+  auto measure = [&] (const std::function<void ()> &run) {
+    run();
+
+    double best = 0;
+    for (unsigned j = 0; j < 3; j++) {
+      double start = Timer::now();
+      run();
+      double delta = Timer::now() - start;
+      if (!j || delta < best) best = delta;
+    }
+
+    return std::max(best, 1e-9);
+  };
+
+  ComputeBenchmark result;
+
+  // Host to device
+  vector<char> host(size);
+  result.transferRate = size / measure([&] () {
+    DYNAMIC_CALL(this, clEnqueueWriteBuffer,
+                 (queue, in, 1, 0, size, &host[0], 0, 0, 0));
+  }) / 1e9;
+
+  // Device memory and floating point
+  auto runKernel = [&] (cl_kernel kernel, size_t items) {
+    DYNAMIC_CALL(this, clEnqueueNDRangeKernel,
+                 (queue, kernel, 1, 0, &items, 0, 0, 0, 0));
+    DYNAMIC_CALL(this, clFinish, (queue));
+  };
+
+  auto fma = [&] (bool fp64) {
+    CLObject program(this, "clReleaseProgram");
+    DYNAMIC_CREATE(this, program.obj, clCreateProgramWithSource,
+                   (context, 1, &benchmarkSource, 0, &err));
+
+    string options = String::printf("-DITERATIONS=%u -DREAL=%s",
+                                    FMA_ITERATIONS, fp64 ? "double" : "float");
+    if (fp64) options += " -DFP64";
+    DYNAMIC_CALL(this, clBuildProgram,
+                 (program, 1, &device, options.c_str(), 0, 0));
+
+    if (!fp64) {
+      CLObject copy(this, "clReleaseKernel");
+      DYNAMIC_CREATE(this, copy.obj, clCreateKernel,
+                     (program, "copy", &err));
+      DYNAMIC_CALL(this, clSetKernelArg, (copy, 0, sizeof(cl_mem), &in.obj));
+      DYNAMIC_CALL(this, clSetKernelArg, (copy, 1, sizeof(cl_mem), &out.obj));
+
+      result.memoryBandwidth =
+        2.0 * size / measure([&] () {runKernel(copy, size / 16);}) / 1e9;
+    }
+
+    CLObject bench(this, "clReleaseKernel");
+    DYNAMIC_CREATE(this, bench.obj, clCreateKernel, (program, "bench", &err));
+    DYNAMIC_CALL(this, clSetKernelArg, (bench, 0, sizeof(cl_mem), &out.obj));
+
+    float a32 = 0.999f;
+    double a64 = 0.999;
+    size_t argSize = fp64 ? sizeof(a64) : sizeof(a32);
+    const void *arg = fp64 ? (const void *)&a64 : (const void *)&a32;
+    DYNAMIC_CALL(this, clSetKernelArg, (bench, 1, argSize, arg));
+
+    size_t items = std::min<size_t>(1 << 20, size / 8);
+    double flops = 16.0 * FMA_ITERATIONS * items;
+
+    return flops / measure([&] () {runKernel(bench, items);}) / 1e9;
+  };
+
+  result.fp32 = fma(false);
+
+  try {
+    cl_ulong fp64Config = 0;
+    DYNAMIC_CALL(this, clGetDeviceInfo,
+                 (device, CL_DEVICE_DOUBLE_FP_CONFIG, sizeof(fp64Config),
+                  &fp64Config, 0));
+    if (fp64Config) result.fp64 = fma(true);
+  } CATCH_DEBUG(3);
+
+  return devices[i].benchmark = result;
+}
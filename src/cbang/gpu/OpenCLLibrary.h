@@ -45,6 +45,7 @@ namespace cb {
   class OpenCLLibrary : public DynamicLibrary, public Singleton<OpenCLLibrary> {
     typedef std::vector<ComputeDevice> devices_t;
     devices_t devices;
+    std::vector<void *> ids;
 
   public:
     OpenCLLibrary(Inaccessible);
@@ -55,5 +56,12 @@ namespace cb {
     typedef devices_t::const_iterator iterator;
     iterator begin() const {return devices.begin();}
     iterator end() const {return devices.end();}
+
+    /**
+     * Measure device @param i with built-in kernels.  Takes a fraction of
+     * a second on most GPUs but blocks while other work uses the device.
+     * The results are also stored in the device.
+     */
+    ComputeBenchmark benchmark(unsigned i);
   };
 }
@@ -0,0 +1,146 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "CaptureWriter.h"
+
+#include <cbang/Catch.h>
+#include <cbang/String.h>
+#include <cbang/os/SystemUtilities.h>
+#include <cbang/util/SmartLock.h>
+#include <cbang/util/SmartUnlock.h>
+#include <cbang/tar/TarFileWriter.h>
+#include <cbang/time/Time.h>
+#include <cbang/log/Logger.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::HTTP;
+
+
+CaptureWriter::CaptureWriter(const string &dir, unsigned maxQueue,
+                             bool archive, uint64_t archiveSize,
+                             const string &archiveExt) :
+  dir(dir), maxQueue(maxQueue), archive(archive), archiveSize(archiveSize),
+  archiveExt(archiveExt), dropped(0) {
+  setName("HTTPCapture");
+}
+
+
+CaptureWriter::~CaptureWriter() {
+  stop();
+  join();
+}
+
+
+bool CaptureWriter::add(const string &name, string data) {
+  SmartLock lock(this);
+
+  if (maxQueue <= queue.size()) {
+    if (!dropped++) LOG_WARNING("HTTP capture queue full, dropping captures");
+    return false;
+  }
+
+  queue.push_back(Capture());
+  queue.back().name = name;
+  queue.back().data.swap(data);
+  signal();
+
+  return true;
+}
+
+
+void CaptureWriter::stop() {
+  SmartLock lock(this);
+  Thread::stop();
+  signal();
+}
+
+
+void CaptureWriter::write(const Capture &capture) {
+  SystemUtilities::ensureDirectory(dir);
+
+  if (!archive) {
+    string path = SystemUtilities::joinPath(dir, capture.name);
+    SystemUtilities::open(path, ios::out | ios::trunc)
+      ->write(capture.data.data(), capture.data.size());
+    return;
+  }
+
+  if (tar.isNull()) {
+    // Numbered in case archives are rolled within the same second
+    string name = "capture-" + Time("%Y%m%d-%H%M%S-").toString() +
+      String(archives++) + "." + archiveExt;
+    string path = SystemUtilities::joinPath(dir, name);
+
+    tar = new TarFileWriter(path, ios::out | ios::trunc);
+    tarBytes = 0;
+  }
+
+  tar->add(capture.data.data(), capture.data.size(), capture.name);
+  tarBytes += capture.data.size();
+
+  if (archiveSize <= tarBytes) closeArchive();
+}
+
+
+void CaptureWriter::closeArchive() {
+  tar.release(); // Flushes and closes the archive
+}
+
+
+void CaptureWriter::run() {
+  SmartLock lock(this);
+
+  while (true) {
+    if (queue.empty()) {
+      if (shouldShutdown()) break;
+      Condition::wait();
+      continue;
+    }
+
+    Capture capture;
+    swap(capture, queue.front());
+    queue.pop_front();
+
+    SmartUnlock unlock(this);
+
+    try {
+      write(capture);
+    } catch (const Exception &e) {
+      LOG_WARNING("Writing HTTP capture " << capture.name << " failed: " << e);
+    }
+  }
+
+  SmartUnlock unlock(this);
+  TRY_CATCH_ERROR(closeArchive());
+}
@@ -0,0 +1,102 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+#include <cbang/os/Thread.h>
+#include <cbang/os/Condition.h>
+
+#include <string>
+#include <deque>
+#include <atomic>
+
+
+namespace cb {
+  class TarFileWriter;
+
+  namespace HTTP {
+    /**
+     * Writes request and response captures on a background thread so that
+     * capturing does not add disk latency to connection processing.  When
+     * the queue is full new captures are dropped and counted.
+     *
+     * Captures are either written to separate files in the capture
+     * directory or appended to compressed tar archives there, which are
+     * rolled over once @param archiveSize bytes have been added.  An
+     * archive is only complete, and readable, once it has been closed.
+     */
+    class CaptureWriter : public Thread, protected Condition {
+      std::string dir;
+      unsigned maxQueue;
+      bool archive;
+      uint64_t archiveSize;
+      std::string archiveExt;
+
+      struct Capture {
+        std::string name;
+        std::string data;
+      };
+
+      std::deque<Capture> queue;
+      std::atomic<uint64_t> dropped;
+
+      SmartPointer<TarFileWriter> tar;
+      uint64_t tarBytes = 0;
+      unsigned archives = 0;
+
+    public:
+      /// @param archiveExt is the archive extension, e.g. "tar.bz2", which
+      /// selects the compression.
+      CaptureWriter(const std::string &dir, unsigned maxQueue = 1024,
+                    bool archive = true, uint64_t archiveSize = 64 << 20,
+                    const std::string &archiveExt = "tar.bz2");
+      ~CaptureWriter();
+
+      uint64_t getDropped() const {return dropped;}
+
+      /// @return False if the capture was dropped
+      bool add(const std::string &name, std::string data);
+
+      // From Thread
+      void stop();
+
+    protected:
+      void write(const Capture &capture);
+      void closeArchive();
+
+      // From Thread
+      void run();
+    };
+  }
+}
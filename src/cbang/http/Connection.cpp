@@ -71,7 +71,7 @@ Connection::Connection(Server &server, SmartPointer<Socket> socket,
   SocketConnection(socket, clientIP), ConnectionStream(*this),
   server(server), readBuf(4096), utilBuf(4096), contentLength(0),
   lastUpdate(startTime), priority(0), state(READING_HEADER), restartTime(0),
-  handler(0), ctx(0), failed(false) {
+  queueTime(0), handler(0), ctx(0), failed(false) {
 
   memset(readBuf.begin(), 0, readBuf.getCapacity());
   memset(utilBuf.begin(), 0, utilBuf.getCapacity());
@@ -362,7 +362,8 @@ bool Connection::writeHeader() {
     LOG_DEBUG(5, *this << " HTTP Response (\n" << response << ")");
   }
 
-  utilBuf.incPosition(writeSocket(utilBuf.begin(), utilBuf.getFill()));
+  // Send the header together with the start of the response data
+  writeGathered(responseBuf.begin());
 
   return utilBuf.isEmpty();
 }
@@ -370,8 +371,6 @@ bool Connection::writeHeader() {
 
 bool Connection::write() {
   while (!responseBuf.empty()) {
-    MemoryBuffer *buf;
-
     if (utilBuf.isEmpty()) {
       // Find the first non-empty buffer
       SmartPointer<Buffer> &bufPtr = responseBuf.front();
@@ -382,19 +381,18 @@ bool Connection::write() {
 
       // If this is not a MemoryBuffer use utilBuf to read it
       if (!bufPtr.isInstance<MemoryBuffer>()) {
-        buf = &utilBuf;
-        buf->clear();
-        buf->increase(4096);
-        buf->incFill(bufPtr->read(buf->begin(), buf->getSpace()));
-
-      } else buf = bufPtr.castPtr<MemoryBuffer>();
+        utilBuf.clear();
+        utilBuf.increase(4096);
+        utilBuf.incFill(bufPtr->read(utilBuf.begin(), utilBuf.getSpace()));
+      }
+    }
 
-    } else buf = &utilBuf;
+    // When utilBuf holds data from the first buffer continue after it
+    responseBuf_t::iterator it = responseBuf.begin();
+    if (!utilBuf.isEmpty()) it++;
 
     // Write the data to the socket
-    uint64_t count = writeSocket(buf->begin(), buf->getFill());
-    if (!count) break;
-    buf->incPosition(count);
+    if (!writeGathered(it)) break;
   }
 
   return responseBuf.empty();
@@ -445,6 +443,51 @@ uint64_t Connection::readSocket(char *buffer, unsigned length) {
 }
 
 
+uint64_t Connection::writeGathered(responseBuf_t::iterator it) {
+  const unsigned maxBufs = 16;
+  SocketBuffer bufs[maxBufs];
+  MemoryBuffer *sources[maxBufs];
+  unsigned count = 0;
+
+  if (!utilBuf.isEmpty()) {
+    sources[count] = &utilBuf;
+    bufs[count].data = utilBuf.begin();
+    bufs[count++].length = utilBuf.getFill();
+  }
+
+  // Consecutive MemoryBuffers can be sent directly
+  for (; it != responseBuf.end() && count < maxBufs; it++) {
+    if (!it->isInstance<MemoryBuffer>()) break;
+
+    MemoryBuffer *buf = it->castPtr<MemoryBuffer>();
+    if (buf->isEmpty()) continue;
+
+    sources[count] = buf;
+    bufs[count].data = buf->begin();
+    bufs[count++].length = buf->getFill();
+  }
+
+  if (!count) return 0;
+
+  uint64_t written = socket->writev(bufs, count, Socket::NONBLOCKING);
+  if (!written) return 0;
+
+  lastUpdate = Time::now();
+  LOG_DEBUG(5, *this << " wrote " << written << " from " << count
+            << " buffers");
+
+  // Consume the data written
+  uint64_t left = written;
+  for (unsigned i = 0; left; i++) {
+    unsigned n = left < sources[i]->getFill() ? left : sources[i]->getFill();
+    sources[i]->incPosition(n);
+    left -= n;
+  }
+
+  return written;
+}
+
+
 uint64_t Connection::writeSocket(const char *buffer, unsigned length) {
   if (!length) return 0;
   uint64_t count = socket->write(buffer, length, Socket::NONBLOCKING);
@@ -84,6 +84,7 @@ namespace cb {
       int priority;
       state_t state;
       double restartTime;
+      double queueTime;
 
       Handler *handler;
       Context *ctx;
@@ -107,6 +108,10 @@ namespace cb {
       int getPriority() const {return priority;}
       void setPriority(int priority) {this->priority = priority;}
 
+      /// Time the connection was last added to the ConnectionQueue
+      double getQueueTime() const {return queueTime;}
+      void setQueueTime(double queueTime) {this->queueTime = queueTime;}
+
       state_t getState() const;
       void setState(state_t state);
 
@@ -164,6 +169,7 @@ namespace cb {
 
       uint64_t readSocket(char *buffer, unsigned length);
       uint64_t writeSocket(const char *buffer, unsigned length);
+      uint64_t writeGathered(responseBuf_t::iterator it);
     };
 
     inline static
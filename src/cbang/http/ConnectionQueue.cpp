@@ -30,11 +30,14 @@
 
 \******************************************************************************/
 
+
 #include "ConnectionQueue.h"
 
 #include "Connection.h"
 
 #include <cbang/util/SmartLock.h>
+#include <cbang/time/Timer.h>
+#include <cbang/json/Sink.h>
 
 #include <algorithm>
 
@@ -43,6 +46,9 @@ using namespace cb;
 using namespace cb::HTTP;
 
 namespace {
+  uint64_t nowUS() {return (uint64_t)(Timer::now() * 1e6);}
+
+
   struct ConnectionCompare {
     bool operator()(const SocketConnectionPtr &c1,
                     const SocketConnectionPtr &c2) const {
@@ -52,34 +58,185 @@ namespace {
 }
 
 
+void ConnectionQueue::Stats::write(JSON::Sink &sink) const {
+  sink.beginDict();
+  sink.insert("depth", depth);
+  sink.insert("capacity", capacity);
+  sink.insert("queued", queued);
+  sink.insert("rejected", rejected);
+  sink.insert("dequeued", dequeued);
+  sink.insert("average_wait", averageWait);
+  sink.insert("recent_wait", recentWait);
+  sink.insert("max_wait", maxWait);
+  sink.endDict();
+}
+
+
+ConnectionQueue::ConnectionQueue(unsigned capacity, bool block) :
+  ring(new ring_t(capacity)), block(block), numPrioritized(0),
+  consumersWaiting(0), producersWaiting(0), quit(false), queued(0),
+  rejected(0), dequeued(0), totalWait(0), maxWait(0), recentWait(0),
+  lastDequeue(0) {
+  lock.setProfileName("ConnectionQueue");
+}
+
+
+ConnectionQueue::Stats ConnectionQueue::getStats() const {
+  Stats stats;
+
+  stats.depth = size();
+  stats.capacity = getCapacity();
+  stats.queued = queued;
+  stats.rejected = rejected;
+  stats.dequeued = dequeued;
+  stats.averageWait =
+    stats.dequeued ? totalWait / 1e6 / stats.dequeued : 0;
+  stats.recentWait = recentWait / 1e6;
+  stats.maxWait = maxWait / 1e6;
+
+  return stats;
+}
+
+
+double ConnectionQueue::getStalledTime() const {
+  if (!size()) return 0;
+
+  uint64_t last = lastDequeue;
+  uint64_t now = nowUS();
+
+  return last < now ? (now - last) / 1e6 : 0;
+}
+
+
+void ConnectionQueue::setCapacity(unsigned capacity) {
+  if (!ring->empty()) THROW("Cannot resize non-empty ConnectionQueue");
+  ring = new ring_t(capacity);
+}
+
+
 void ConnectionQueue::shutdown() {
-  SmartLock lock(this);
   quit = true;
-  broadcast();
+
+  pushed.increment();
+  pushed.wakeAll();
+  popped.increment();
+  popped.wakeAll();
 }
 
 
-void ConnectionQueue::add(const SocketConnectionPtr &con) {
-  SmartLock lock(this);
-  push_back(con);
-  push_heap(begin(), end(), ConnectionCompare());
-  signal();
+bool ConnectionQueue::add(const SocketConnectionPtr &con) {
+  if (quit) return false;
+
+  Connection *c = con.castPtr<Connection>();
+  c->setQueueTime(Timer::now());
+
+  // Don't count the time the queue was empty as a stall
+  if (!size()) lastDequeue = nowUS();
+
+  if (c->getPriority()) {
+    SmartLock lock(&this->lock);
+    prioritized.push_back(con);
+    push_heap(prioritized.begin(), prioritized.end(), ConnectionCompare());
+    numPrioritized++;
+
+  } else
+    while (!ring->push(con)) {
+      if (!block || quit) {rejected++; return false;}
+
+      // Wait for a consumer to free a slot
+      uint32_t seq = popped.load();
+      producersWaiting++;
+      bool added = ring->push(con);
+      if (!added && !quit) popped.wait(seq, 0.1);
+      producersWaiting--;
+
+      if (added) break;
+    }
+
+  queued++;
+  pushed.increment();
+  if (consumersWaiting) pushed.wake();
+
+  return true;
 }
 
 
 SocketConnectionPtr ConnectionQueue::next(double timeout) {
-  SmartLock lock(this);
+  SocketConnectionPtr con;
+  double deadline = 0 < timeout ? Timer::now() + timeout : 0;
 
-  while (empty()) {
+  while (!pop(con)) {
     if (quit || !timeout) return 0;
 
-    if (timeout < 0) wait();
-    else timedWait(timeout);
+    // Spin briefly then sleep until something is pushed
+    uint32_t seq = pushed.load();
+    if (pushed.spin(seq) && pop(con)) break;
+    consumersWaiting++;
+
+    if (pop(con)) {consumersWaiting--; break;}
+
+    if (!quit) {
+      double remaining = 0 < timeout ? deadline - Timer::now() : -1;
+      if (0 < timeout && remaining <= 0) remaining = 0;
+      if (remaining) pushed.wait(seq, remaining);
+    }
+
+    consumersWaiting--;
+
+    if (0 < timeout && deadline <= Timer::now()) {
+      if (!pop(con)) return 0;
+      break;
+    }
   }
 
-  SocketConnectionPtr con = front();
-  pop_heap(begin(), end(), ConnectionCompare());
-  pop_back();
+  popped.increment();
+  if (producersWaiting) popped.wake();
+
+  recordWait(con);
 
   return con;
 }
+
+
+bool ConnectionQueue::pop(SocketConnectionPtr &con) {
+  // Higher priorities go first, then the ring, then lower priorities
+  return popPrioritized(con, true) || ring->pop(con) ||
+    popPrioritized(con, false);
+}
+
+
+bool ConnectionQueue::popPrioritized(SocketConnectionPtr &con,
+                                     bool positive) {
+  if (!numPrioritized) return false;
+
+  SmartLock lock(&this->lock);
+  if (prioritized.empty()) return false;
+
+  int priority = prioritized.front().castPtr<Connection>()->getPriority();
+  if (positive != (0 < priority)) return false;
+
+  con = prioritized.front();
+  pop_heap(prioritized.begin(), prioritized.end(), ConnectionCompare());
+  prioritized.pop_back();
+  numPrioritized--;
+
+  return true;
+}
+
+
+void ConnectionQueue::recordWait(const SocketConnectionPtr &con) {
+  uint64_t now = nowUS();
+  uint64_t start = con.castPtr<Connection>()->getQueueTime() * 1e6;
+  uint64_t wait = start && start < now ? now - start : 0;
+
+  dequeued++;
+  lastDequeue = now;
+  totalWait += wait;
+
+  uint64_t max = maxWait;
+  while (max < wait && !maxWait.compare_exchange_weak(max, wait)) continue;
+
+  // Exponential moving average, concurrent updates may occasionally be lost
+  uint64_t recent = recentWait;
+  recentWait = recent - recent / 8 + wait / 8;
+}
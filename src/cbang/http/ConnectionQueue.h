@@ -30,31 +30,103 @@
 
 \******************************************************************************/
 
+
 #pragma once
 
 #include <cbang/SmartPointer.h>
 
-#include <cbang/os/Condition.h>
+#include <cbang/os/Mutex.h>
+#include <cbang/os/Futex.h>
+#include <cbang/util/MPMCQueue.h>
 
 #include <cbang/socket/SocketConnection.h>
 
 #include <vector>
+#include <atomic>
 
 namespace cb {
-  class SocketConnection;
+  namespace JSON {class Sink;}
 
   namespace HTTP {
-    class ConnectionQueue :
-      public Condition, protected std::vector<SocketConnectionPtr> {
-      bool quit;
+    /**
+     * Hands connections from the server thread to pool threads.
+     *
+     * Connections are kept in a bounded lock-free ring.  When the ring is
+     * full add() either fails, so the server can reply 503, or blocks until a
+     * pool thread frees a slot.  Connections with a non-zero priority bypass
+     * the ring and are ordered in a locked heap.
+     */
+    class ConnectionQueue {
+      typedef MPMCQueue<SocketConnectionPtr> ring_t;
+      SmartPointer<ring_t> ring;
+      bool block;
+
+      Mutex lock;
+      std::vector<SocketConnectionPtr> prioritized;
+      std::atomic<unsigned> numPrioritized;
+
+      Futex pushed;
+      Futex popped;
+      std::atomic<unsigned> consumersWaiting;
+      std::atomic<unsigned> producersWaiting;
+      std::atomic<bool> quit;
+
+      // Statistics, times in microseconds
+      std::atomic<uint64_t> queued;
+      std::atomic<uint64_t> rejected;
+      std::atomic<uint64_t> dequeued;
+      std::atomic<uint64_t> totalWait;
+      std::atomic<uint64_t> maxWait;
+      std::atomic<uint64_t> recentWait;
+      std::atomic<uint64_t> lastDequeue;
 
     public:
-      ConnectionQueue() : quit(false) {}
+      struct Stats {
+        unsigned depth;
+        unsigned capacity;
+        uint64_t queued;
+        uint64_t rejected;
+        uint64_t dequeued;
+        double averageWait;
+        double recentWait; ///< Moving average of recent waits
+        double maxWait;
+
+        void write(JSON::Sink &sink) const;
+      };
+
+      ConnectionQueue(unsigned capacity = 1024, bool block = false);
+
+      /// Must not be called while the queue is in use.
+      void setCapacity(unsigned capacity);
+      unsigned getCapacity() const {return ring->getCapacity();}
+
+      /// If true add() waits for space rather than failing when full.
+      void setBlocking(bool block) {this->block = block;}
+      bool getBlocking() const {return block;}
+
+      unsigned size() const {return ring->size() + numPrioritized;}
+
+      Stats getStats() const;
+
+      /// @return Moving average of recent queue wait times in seconds.
+      double getRecentWait() const {return recentWait / 1e6;}
+
+      /**
+       * @return Seconds since a connection was last taken off the queue if
+       * connections are waiting, otherwise zero.
+       */
+      double getStalledTime() const;
 
       void shutdown();
 
-      void add(const SocketConnectionPtr &con);
+      /// @return False if the queue is full or shutting down.
+      bool add(const SocketConnectionPtr &con);
       SocketConnectionPtr next(double timeout = -1);
-   };
+
+    protected:
+      bool pop(SocketConnectionPtr &con);
+      bool popPrioritized(SocketConnectionPtr &con, bool positive);
+      void recordWait(const SocketConnectionPtr &con);
+    };
   }
 }
@@ -63,8 +63,6 @@ bool ScriptedWebContext::eval(const Script::Context &ctx) {
   //   directly in to the ScriptedWebContext to avoid the cost of mapping them
   //   for every HTTP connection.  Could be a bit of a premature optimization
   //   but it's fast.
-  WebContextMethods::enableFastParse(); // Enable binary search
-
   if (getEnvironment().eval(ctx)) return true;
 
   switch (WebContextMethods::parse(ctx.args[0],
@@ -35,11 +35,13 @@
 #include "Connection.h"
 #include "Context.h"
 #include "Handler.h"
+#include "CaptureWriter.h"
 
 #include <cbang/config.h>
 #include <cbang/Exception.h>
 
 #include <cbang/config/Options.h>
+#include <cbang/json/Sink.h>
 
 #include <cbang/socket/SocketSet.h>
 #include <cbang/socket/SocketDebugger.h>
@@ -53,6 +55,9 @@
 #include <cbang/Catch.h>
 #include <cbang/openssl/SSLContext.h>
 
+#include <algorithm>
+#include <sstream>
+
 using namespace std;
 using namespace cb;
 using namespace cb::HTTP;
@@ -77,11 +82,12 @@ Handler *Server::match(Connection *con) {
 
 
 void Server::captureRequest(Connection *con) {
-  SystemUtilities::ensureDirectory(captureDir);
+  if (!captureOnError && !isCaptureSampled(con->getID())) return;
 
   try {
-    string filename = getCaptureFilename("request", con->getID());
-    con->writeRequest(*SystemUtilities::open(filename, ios::out | ios::trunc));
+    ostringstream stream;
+    con->writeRequest(stream);
+    capture("request", con->getID(), stream.str());
 
   } catch (const Exception &e) {
     LOG_WARNING("Packet capture request " << con->getID() << " failed: " << e);
@@ -90,11 +96,12 @@ void Server::captureRequest(Connection *con) {
 
 
 void Server::captureResponse(Connection *con) {
-  SystemUtilities::ensureDirectory(captureDir);
+  if (!captureOnError && !isCaptureSampled(con->getID())) return;
 
   try {
-    string filename = getCaptureFilename("response", con->getID());
-    con->writeResponse(*SystemUtilities::open(filename, ios::out | ios::trunc));
+    ostringstream stream;
+    con->writeResponse(stream);
+    capture("response", con->getID(), stream.str());
 
   } catch (const Exception &e) {
     LOG_WARNING("Packet capture response " << con->getID() << " failed: " << e);
@@ -163,7 +170,14 @@ bool Server::handleConnection(double timeout) {
     Connection *con = ptr.castPtr<Connection>();
 
     if (!con) return false;
-    if (con->getState() == Connection::PROCESSING) process(*con);
+
+    if (con->getState() == Connection::PROCESSING) {
+      busyThreads++;
+      try {
+        process(*con);
+      } catch (...) {busyThreads--; throw;}
+      busyThreads--;
+    }
 
   } CATCH_ERROR;
 
@@ -171,39 +185,90 @@ bool Server::handleConnection(double timeout) {
 }
 
 
-void Server::createThreadPool(unsigned size) {
+void Server::createThreadPool(unsigned size, unsigned maxSize) {
   if (!pool.isNull()) pool->join();
 
   // Process connections via connection queue
   queueConnections = true;
+  maxThreads = size < maxSize ? maxSize : size;
 
   pool = new ThreadPoolFunc<Server>(size, this, &Server::poolThread);
 }
 
 
+unsigned Server::getNumThreads() const {
+  return (pool.isNull() ? 0 : pool->getSize()) + extraThreads.size();
+}
+
+
+void Server::writeStatus(JSON::Sink &sink) const {
+  sink.beginDict();
+  sink.insert("connections", getNumConnections());
+
+  if (queueConnections) {
+    sink.insertDict("threads");
+    sink.insert("min", pool.isNull() ? 0 : pool->getSize());
+    sink.insert("max", maxThreads);
+    sink.insert("current", getNumThreads());
+    sink.insert("busy", busyThreads.load());
+    sink.endDict();
+
+    sink.beginInsert("queue");
+    queue.getStats().write(sink);
+  }
+
+  sink.endDict();
+}
+
+
 void Server::start() {
   if (getState() != THREAD_STOPPED) THROW("HTTPServer already running");
+
+  if (!queue.size()) queue.setCapacity(queueSize);
+  queue.setBlocking(queueBlock);
+
+  if (captureWriter.isNull() &&
+      (captureRequests || captureResponses || captureOnError)) {
+    captureWriter = new CaptureWriter
+      (captureDir, captureQueueSize, captureArchive,
+       (uint64_t)captureArchiveSize << 20, captureArchiveExt);
+    captureWriter->start();
+  }
+
   startThreadPool();
   SocketServer::start();
 }
 
 
 void Server::stop() {
-  Thread::stop();
+  SocketServer::stop();
   queue.shutdown();
   stopThreadPool();
+  if (!captureWriter.isNull()) captureWriter->stop();
 }
 
 
 void Server::join() {
   joinThreadPool();
   Thread::join();
+  if (!captureWriter.isNull()) captureWriter->join();
+
+  for (unsigned i = 0; i < extraThreads.size(); i++)
+    extraThreads[i]->join();
+  extraThreads.clear();
 }
 
 
 void Server::construct() {
   initialized = false;
   queueConnections = false;
+  queueSize = 1024;
+  queueBlock = false;
+  maxThreads = 0;
+  threadWaitTarget = 0.1;
+  threadIdleTimeout = 60;
+  lastThreadSpawn = 0;
+  busyThreads = 0;
   maxRequestLength = 1024 * 1024 * 50;
   maxConnections = 800;
   connectionTimeout = 60;
@@ -212,6 +277,11 @@ void Server::construct() {
   captureRequests = false;
   captureResponses = false;
   captureOnError = false;
+  captureSample = 1;
+  captureQueueSize = 1024;
+  captureArchive = true;
+  captureArchiveSize = 64;
+  captureArchiveExt = "tar.bz2";
 
   SmartPointer<Option> opt;
 
@@ -235,6 +305,16 @@ void Server::construct() {
 
   options.addTarget("max-connections", maxConnections,
                     "Sets the maximum number of simultaneous connections.");
+  options.addTarget("request-queue-size", queueSize, "The maximum number "
+                    "of requests waiting for a processing thread.");
+  options.addTarget("request-queue-block", queueBlock, "When the request "
+                    "queue is full wait for space rather than replying with "
+                    "503 Service Unavailable.  This stalls all network I/O.");
+  options.addTarget("request-wait-target", threadWaitTarget, "Add "
+                    "processing threads, up to the pool maximum, while "
+                    "requests wait longer than this many seconds.");
+  options.addTarget("thread-idle-timeout", threadIdleTimeout, "Remove added "
+                    "processing threads after this many idle seconds.");
   options.addTarget("max-request-length", maxRequestLength,
                     "Sets the maximum length of a client request packet.");
   options.addTarget("connection-timeout", connectionTimeout, "The maximum "
@@ -281,6 +361,18 @@ void Server::construct() {
                     "responses and save them to 'capture-directory'.");
   options.addTarget("capture-on-error", captureOnError, "Capture HTTP request "
                     "and response packets only in case of errors.");
+  options.addTarget("capture-sample", captureSample, "The fraction of "
+                    "connections, from 0 to 1, whose requests and responses "
+                    "are captured.");
+  options.addTarget("capture-queue-size", captureQueueSize, "The maximum "
+                    "number of captures waiting to be written.  Further "
+                    "captures are dropped.");
+  options.addTarget("capture-archive", captureArchive, "Append captures to "
+                    "compressed tar archives rather than separate files.");
+  options.addTarget("capture-archive-size", captureArchiveSize, "Start a new "
+                    "capture archive after this many MiB of captures.");
+  options.addTarget("capture-archive-ext", captureArchiveExt, "The capture "
+                    "archive extension, which selects its compression.");
   options.popCategory();
 }
 
@@ -294,6 +386,9 @@ void Server::process(Connection &con) {
   // DELAY_PROCESSING state otherwise proceed directly to WRITING_HEADER.
   con.setState(con.getRestartTime() ? Connection::DELAY_PROCESSING :
                Connection::WRITING_HEADER);
+
+  // Processed in a pool thread, let service() pick up the new state
+  if (queueConnections) wake();
 }
 
 
@@ -302,6 +397,59 @@ void Server::poolThread() {
 }
 
 
+void Server::extraThread() {
+  double lastWork = Timer::now();
+
+  while (!shouldShutdown())
+    if (handleConnection(0.1)) lastWork = Timer::now();
+    else if (lastWork + threadIdleTimeout < Timer::now()) break;
+}
+
+
+void Server::adjustThreadPool() {
+  // Reap retired threads
+  for (unsigned i = 0; i < extraThreads.size();)
+    if (extraThreads[i]->getState() == Thread::THREAD_DONE) {
+      extraThreads[i]->wait();
+      extraThreads.erase(extraThreads.begin() + i);
+      LOG_INFO(3, "Removed idle processing thread, " << getNumThreads()
+               << " threads");
+
+    } else i++;
+
+  if (pool.isNull() || maxThreads <= getNumThreads() || !queue.size()) return;
+
+  double wait = std::max(queue.getRecentWait(), queue.getStalledTime());
+  if (wait <= threadWaitTarget) return;
+
+  // Give the last thread added a chance to take effect
+  double now = Timer::now();
+  if (now < lastThreadSpawn + threadWaitTarget) return;
+  lastThreadSpawn = now;
+
+  SmartPointer<Thread> thread =
+    new ThreadFunc<Server>(this, &Server::extraThread);
+  thread->start();
+  extraThreads.push_back(thread);
+
+  LOG_INFO(3, "Requests waited " << wait << "s, added processing thread, "
+           << getNumThreads() << " threads");
+}
+
+
+bool Server::queueConnection(const SocketConnectionPtr &_con) {
+  if (queue.add(_con)) return true;
+
+  Connection *con = _con.castPtr<Connection>();
+  LOG_WARNING("Request queue full, rejecting " << *con);
+
+  con->fail(StatusCode::HTTP_SERVICE_UNAVAILABLE);
+  con->setState(Connection::WRITING_HEADER);
+
+  return false;
+}
+
+
 void Server::processConnection(const SocketConnectionPtr &_con, bool ready) {
   Connection *con = _con.castPtr<Connection>();
 
@@ -356,7 +504,7 @@ void Server::processConnection(const SocketConnectionPtr &_con, bool ready) {
 
         // Add the connection SmartPointer to the queue
         if (queueConnections) {
-          queue.add(_con);
+          if (!queueConnection(_con)) continue;
           break;
         }
 
@@ -372,7 +520,7 @@ void Server::processConnection(const SocketConnectionPtr &_con, bool ready) {
           con->setState(Connection::PROCESSING);
 
           // Put connection SmartPointer back on the queue
-          if (queueConnections) queue.add(_con);
+          if (queueConnections && !queueConnection(_con)) continue;
         }
         break;
 
@@ -487,6 +635,8 @@ Server::createConnection(SmartPointer<Socket> socket,
 void Server::addConnectionSockets(SocketSet &sockSet) {
   SocketServer::addConnectionSockets(sockSet);
 
+  if (queueConnections) adjustThreadPool();
+
   for (iterator it = begin(); it != end(); it++) {
     Connection &con = *it->castPtr<Connection>();
 
@@ -519,6 +669,29 @@ bool Server::connectionsReady() const {
 }
 
 
+double Server::getServiceTimeout() const {
+  double timeout = SocketServer::getServiceTimeout();
+
+  if (connections.empty()) {
+    // Wake periodically to remove idle processing threads
+    if (!extraThreads.empty() && (timeout < 0 || 1 < timeout)) return 1;
+    return timeout;
+  }
+
+  // Context::isReady() cannot signal a change so it must be polled
+  for (iterator it = begin(); it != end(); it++) {
+    const Connection &con = *it->castPtr<Connection>();
+
+    if ((con.getState() == Connection::WRITING_HEADER ||
+         con.getState() == Connection::WRITING_DATA) &&
+        con.getContext() && !con.getContext()->isReady()) return 0.1;
+  }
+
+  // Wake periodically to check connection timeouts
+  return timeout < 0 || 1 < timeout ? 1 : timeout;
+}
+
+
 void Server::processConnections(SocketSet &sockSet) {
   if (!initialized) THROW("HTTP::Server not initialized");
 
@@ -543,6 +716,29 @@ void Server::closeConnection(const SocketConnectionPtr &con) {
 
 
 string Server::getCaptureFilename(const string &name, unsigned id) {
-  return captureDir + "/" + name + "." +
-    Time("%Y%m%d-%H%M%S.").toString() + String(id);
+  return captureDir + "/" + getCaptureName(name, id);
+}
+
+
+string Server::getCaptureName(const string &name, unsigned id) {
+  return name + "." + Time("%Y%m%d-%H%M%S.").toString() + String(id);
+}
+
+
+bool Server::isCaptureSampled(unsigned id) const {
+  if (1 <= captureSample) return true;
+  if (captureSample <= 0) return false;
+
+  // Hash the ID so requests and responses of a connection are sampled
+  // together and consecutive connections are spread out
+  uint32_t h = id * 0x9e3779b1;
+  h ^= h >> 16;
+
+  return h < captureSample * 4294967296.0;
+}
+
+
+void Server::capture(const string &name, unsigned id, const string &data) {
+  if (captureWriter.isNull()) THROW("HTTP capture writer not started");
+  captureWriter->add(getCaptureName(name, id), data);
 }
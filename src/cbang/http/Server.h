@@ -41,15 +41,18 @@
 
 #include <vector>
 #include <list>
+#include <atomic>
 
 
 namespace cb {
   class SSLContext;
   class Options;
+  namespace JSON {class Sink;}
 
   namespace HTTP {
     class Handler;
     class Connection;
+    class CaptureWriter;
 
     class Server : public SocketServer {
     protected:
@@ -59,8 +62,16 @@ namespace cb {
 
       ConnectionQueue queue;
       bool queueConnections;
+      unsigned queueSize;
+      bool queueBlock;
 
       SmartPointer<ThreadPool> pool;
+      unsigned maxThreads;
+      double threadWaitTarget;
+      double threadIdleTimeout;
+      double lastThreadSpawn;
+      std::vector<SmartPointer<Thread> > extraThreads;
+      std::atomic<unsigned> busyThreads;
 
       typedef std::vector<Handler *> handlers_t;
       handlers_t handlers;
@@ -76,7 +87,13 @@ namespace cb {
       bool captureRequests;
       bool captureResponses;
       bool captureOnError;
+      double captureSample;
+      unsigned captureQueueSize;
+      bool captureArchive;
+      unsigned captureArchiveSize;
+      std::string captureArchiveExt;
       std::string captureDir;
+      SmartPointer<CaptureWriter> captureWriter;
 
     public:
       Server(Options &options);
@@ -100,7 +117,17 @@ namespace cb {
 
       bool handleConnection(double timeout);
 
-      void createThreadPool(unsigned size);
+      /// Write connection, thread and request queue statistics
+      void writeStatus(JSON::Sink &sink) const;
+
+      /**
+       * Process requests in a pool of at least @param size threads.  If
+       * @param maxSize is larger, threads are added while requests wait in
+       * the queue longer than request-wait-target and removed again after
+       * thread-idle-timeout seconds without work.
+       */
+      void createThreadPool(unsigned size, unsigned maxSize = 0);
+      unsigned getNumThreads() const;
       void startThreadPool() {if (!pool.isNull()) pool->start();}
       void stopThreadPool() {if (!pool.isNull()) pool->stop();}
       void joinThreadPool() {if (!pool.isNull()) pool->join();}
@@ -115,7 +142,10 @@ namespace cb {
 
       void process(Connection &con);
       void poolThread();
+      void extraThread();
+      void adjustThreadPool();
 
+      bool queueConnection(const SocketConnectionPtr &con);
       void processConnection(const SocketConnectionPtr &con, bool ready);
       void limitConnections();
 
@@ -126,8 +156,13 @@ namespace cb {
       bool connectionsReady() const;
       void processConnections(SocketSet &sockSet);
       void closeConnection(const SocketConnectionPtr &con);
+      double getServiceTimeout() const;
 
       std::string getCaptureFilename(const std::string &name, unsigned id);
+      std::string getCaptureName(const std::string &name, unsigned id);
+      bool isCaptureSampled(unsigned id) const;
+      void capture(const std::string &name, unsigned id,
+                   const std::string &data);
     };
   }
 }
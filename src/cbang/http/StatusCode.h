@@ -82,6 +82,7 @@ CBANG_ENUM_VALUE(HTTP_REQUEST_URI_TOO_LARGE,           414)
 CBANG_ENUM_VALUE(HTTP_UNSUPPORTED_MEDIA_TYPE,          415)
 CBANG_ENUM_VALUE(HTTP_REQUESTED_RANGE_NOT_SATISFIABLE, 416)
 CBANG_ENUM_VALUE(HTTP_EXPECTATION_FAILED,              417)
+CBANG_ENUM_VALUE(HTTP_TOO_MANY_REQUESTS,               429)
 
 CBANG_ENUM_VALUE(HTTP_INTERNAL_SERVER_ERROR,           500)
 CBANG_ENUM_VALUE(HTTP_NOT_IMPLEMENTED,                 501)
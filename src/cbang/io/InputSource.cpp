@@ -52,7 +52,7 @@ InputSource::InputSource(Buffer &buffer, const string &name) :
 InputSource::InputSource(const char *array, streamsize length,
                          const string &name) :
   Named(name), stream(new ArrayStream<const char>(array, length)),
-  length(length) {}
+  length(length), data(array) {}
 
 
 InputSource::InputSource(const string &filename) :
@@ -71,8 +71,20 @@ InputSource::InputSource(const SmartPointer<istream> &stream,
 
 InputSource::InputSource(const Resource &resource) :
   Named(resource.getName()),
-  stream(new ArrayStream<const char>(resource.getData(), resource.getLength()))
-{}
+  stream(new ArrayStream<const char>(resource.getData(), resource.getLength())),
+  length(resource.getLength()), data(resource.getData()) {}
+
+
+InputSource::InputSource(const SmartPointer<MappedFile> &mapping) :
+  Named(mapping->getPath()),
+  stream(new ArrayStream<const char>(mapping->getData(),
+                                     mapping->getLength())),
+  length(mapping->getLength()), data(mapping->getData()), mapping(mapping) {}
+
+
+InputSource InputSource::map(const string &filename) {
+  return InputSource(new MappedFile(filename));
+}
 
 
 streamsize InputSource::getLength() const {
@@ -32,6 +32,8 @@
 
 #pragma once
 
+#include "MappedFile.h"
+
 #include <cbang/SmartPointer.h>
 #include <cbang/util/Named.h>
 
@@ -46,6 +48,8 @@ namespace cb {
   class InputSource : public Named {
     cb::SmartPointer<std::istream> stream;
     std::streamsize length;
+    const char *data = 0;
+    SmartPointer<MappedFile> mapping;
 
   public:
     InputSource(Buffer &buffer, const std::string &name = "<buffer>");
@@ -58,8 +62,19 @@ namespace cb {
                 const std::string &name = std::string(),
                 std::streamsize length = -1);
     InputSource(const Resource &resource);
+    /// Read from mapped memory, the mapping is kept while in use
+    InputSource(const SmartPointer<MappedFile> &mapping);
+
+    /// Memory map @param filename rather than reading it.
+    static InputSource map(const std::string &filename);
 
     std::istream &getStream() const {return *stream;}
+    /**
+     * @return the whole input as one contiguous buffer of getLength()
+     * bytes, for in memory sources, otherwise null.  Reading from the
+     * stream does not advance it.
+     */
+    const char *getData() const {return data;}
     std::streamsize getLength() const;
     std::string toString() const;
     std::string getLine(unsigned maxLength = 4096) const;
@@ -0,0 +1,199 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "MappedFile.h"
+
+#include <cbang/Exception.h>
+#include <cbang/os/SysError.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace cb;
+
+
+struct MappedFile::private_t {
+#ifdef _WIN32
+  HANDLE file = INVALID_HANDLE_VALUE;
+  HANDLE mapping = 0;
+#endif
+};
+
+
+MappedFile::MappedFile(const string &path, bool writable, uint64_t length) :
+  pri(new private_t), path(path), writable(writable) {
+  if (!writable) length = 0;
+
+#ifdef _WIN32
+  pri->file = CreateFile(path.c_str(), GENERIC_READ |
+                         (writable ? GENERIC_WRITE : 0), FILE_SHARE_READ |
+                         (writable ? 0 : FILE_SHARE_WRITE), 0,
+                         writable ? OPEN_ALWAYS : OPEN_EXISTING,
+                         FILE_ATTRIBUTE_NORMAL, 0);
+
+  if (pri->file == INVALID_HANDLE_VALUE) {
+    delete pri;
+    THROW("Failed to open '" << path << "': " << SysError());
+  }
+
+  if (!length) {
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(pri->file, &size)) length = size.QuadPart;
+  }
+
+  this->length = length;
+  if (!length) return; // Empty files cannot be mapped
+
+  pri->mapping =
+    CreateFileMapping(pri->file, 0, writable ? PAGE_READWRITE : PAGE_READONLY,
+                      (DWORD)(length >> 32), (DWORD)length, 0);
+
+  if (pri->mapping)
+    data = (char *)MapViewOfFile(pri->mapping, writable ?
+                                 FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+
+  if (!data) {
+    SysError err;
+    if (pri->mapping) CloseHandle(pri->mapping);
+    CloseHandle(pri->file);
+    delete pri;
+    THROW("Failed to map '" << path << "': " << err);
+  }
+
+#else // _WIN32
+  int fd = ::open(path.c_str(), writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+  if (fd == -1) {
+    delete pri;
+    THROW("Failed to open '" << path << "': " << SysError());
+  }
+
+  if (length && ftruncate(fd, length)) {
+    SysError err;
+    ::close(fd);
+    delete pri;
+    THROW("Failed to resize '" << path << "': " << err);
+  }
+
+  if (!length) {
+    struct stat info;
+    if (!fstat(fd, &info)) length = info.st_size;
+  }
+
+  this->length = length;
+
+  if (length) {
+    void *ptr = mmap(0, length, PROT_READ | (writable ? PROT_WRITE : 0),
+                     MAP_SHARED, fd, 0);
+
+    if (ptr == MAP_FAILED) {
+      SysError err;
+      ::close(fd);
+      delete pri;
+      THROW("Failed to map '" << path << "': " << err);
+    }
+
+    data = (char *)ptr;
+  }
+
+  ::close(fd); // The mapping keeps the file open
+#endif // _WIN32
+}
+
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+  if (data) UnmapViewOfFile(data);
+  if (pri->mapping) CloseHandle(pri->mapping);
+  if (pri->file != INVALID_HANDLE_VALUE) CloseHandle(pri->file);
+
+#else
+  if (data) munmap(data, length);
+#endif
+
+  delete pri;
+}
+
+
+char *MappedFile::getWritableData() {
+  if (!writable) THROW("'" << path << "' is mapped read only");
+  return data;
+}
+
+
+void MappedFile::advise(advice_t advice, uint64_t offset, uint64_t length) {
+  if (this->length <= offset || !data) return;
+  if (!length || this->length < offset + length)
+    length = this->length - offset;
+
+#ifndef _WIN32
+  int flag;
+
+  switch (advice) {
+  case ADVISE_NORMAL:     flag = MADV_NORMAL;     break;
+  case ADVISE_SEQUENTIAL: flag = MADV_SEQUENTIAL; break;
+  case ADVISE_RANDOM:     flag = MADV_RANDOM;     break;
+  case ADVISE_WILLNEED:   flag = MADV_WILLNEED;   break;
+  case ADVISE_DONTNEED:   flag = MADV_DONTNEED;   break;
+  default: THROW("Invalid mmap advice " << advice);
+  }
+
+  // madvise() requires a page aligned address
+  uint64_t page = sysconf(_SC_PAGESIZE);
+  uint64_t start = offset - offset % page;
+
+  if (madvise(data + start, length + offset - start, flag))
+    THROW("madvise() failed on '" << path << "': " << SysError());
+#endif
+}
+
+
+void MappedFile::sync(bool async) {
+  if (!data || !writable) return;
+
+#ifdef _WIN32
+  if (!FlushViewOfFile(data, 0) || (!async && !FlushFileBuffers(pri->file)))
+    THROW("Failed to sync '" << path << "': " << SysError());
+
+#else
+  if (msync(data, length, async ? MS_ASYNC : MS_SYNC))
+    THROW("Failed to sync '" << path << "': " << SysError());
+#endif
+}
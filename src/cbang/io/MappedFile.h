@@ -0,0 +1,92 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/util/NonCopyable.h>
+
+#include <string>
+#include <cstdint>
+
+
+namespace cb {
+  /**
+   * Maps a whole file into memory for the lifetime of the object.  Pages
+   * are read on demand, so very large files can be accessed as one
+   * contiguous buffer without copying them.
+   *
+   * A read only mapping must not outlive truncation of the file by
+   * another process.
+   */
+  class MappedFile : public NonCopyable {
+    struct private_t;
+    private_t *pri;
+
+    std::string path;
+    char *data = 0;
+    uint64_t length = 0;
+    bool writable;
+
+  public:
+    typedef enum {
+      ADVISE_NORMAL,
+      ADVISE_SEQUENTIAL,
+      ADVISE_RANDOM,
+      ADVISE_WILLNEED,
+      ADVISE_DONTNEED,
+    } advice_t;
+
+    /**
+     * @param writable maps the file shared and read-write so that changes
+     * are written back to it.
+     * @param length when writable and non-zero, the file is created or
+     * resized to this many bytes first.
+     */
+    MappedFile(const std::string &path, bool writable = false,
+               uint64_t length = 0);
+    ~MappedFile();
+
+    const std::string &getPath() const {return path;}
+    const char *getData() const {return data;}
+    char *getWritableData();
+    uint64_t getLength() const {return length;}
+    bool isWritable() const {return writable;}
+
+    const char *begin() const {return data;}
+    const char *end() const {return data + length;}
+
+    /// Hint the expected access pattern, zero @param length to the end
+    void advise(advice_t advice, uint64_t offset = 0, uint64_t length = 0);
+    /// Write modified pages back to the file
+    void sync(bool async = false);
+  };
+}
@@ -0,0 +1,141 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+#include <cbang/Exception.h>
+#include <cbang/openssl/AEADStream.h>
+
+#include <boost/iostreams/concepts.hpp>
+#include <boost/iostreams/operations.hpp>
+#include <boost/iostreams/detail/ios.hpp>
+namespace io = boost::iostreams;
+
+#include <string>
+#include <cstring>
+#include <algorithm>
+
+
+namespace cb {
+  /**
+   * Decrypts and authenticates an input stream written by AEADEncryptor.
+   * Each frame is verified before any of its data is returned.  Throws if
+   * the stream was modified or truncated.
+   */
+  class AEADDecryptor {
+    class AEADDecryptorImpl {
+      std::string key;
+      SmartPointer<AEADStream> aead;
+      std::string frame;
+      std::string plain;
+      unsigned offset = 0;
+      uint64_t index = 0;
+      bool eof = false;
+      bool done = false;
+
+    public:
+      AEADDecryptorImpl(const std::string &key) : key(key) {}
+
+
+      template<typename Source>
+      std::streamsize read(Source &src, char *s, std::streamsize n) {
+        if (aead.isNull()) {
+          fill(src, AEADStream::HEADER_SIZE);
+          if (frame.size() != AEADStream::HEADER_SIZE)
+            THROW("Truncated AEAD stream header");
+
+          aead = new AEADStream(key, frame);
+          frame.clear();
+        }
+
+        while (offset == plain.size() && !done) readFrame(src);
+
+        std::streamsize count =
+          std::min<std::streamsize>(n, plain.size() - offset);
+        if (!count) return -1; // EOF
+
+        memcpy(s, plain.data() + offset, count);
+        offset += count;
+
+        return count;
+      }
+
+
+    protected:
+      template<typename Source> void fill(Source &src, unsigned size) {
+        while (frame.size() < size && !eof) {
+          unsigned start = frame.size();
+          frame.resize(size);
+
+          std::streamsize bytes = io::read(src, &frame[start], size - start);
+          frame.resize(start + (0 < bytes ? bytes : 0));
+          if (bytes <= 0) eof = true;
+        }
+      }
+
+
+      template<typename Source> void readFrame(Source &src) {
+        // Read one byte past the frame to find out if it is the last
+        unsigned size = aead->getEncryptedFrameSize();
+        fill(src, size + 1);
+
+        bool last = frame.size() <= size;
+        unsigned length = last ? frame.size() : size;
+
+        plain.resize(aead->getFrameSize());
+        plain.resize(aead->decrypt(index++, last, frame.data(), length,
+                                   &plain[0]));
+        offset = 0;
+
+        frame.erase(0, length);
+        done = last;
+      }
+    };
+
+
+    SmartPointer<AEADDecryptorImpl> impl;
+
+  public:
+    typedef char char_type;
+    struct category : io::input, io::filter_tag, io::multichar_tag {};
+
+
+    AEADDecryptor(const std::string &key) : impl(new AEADDecryptorImpl(key)) {}
+
+
+    template<typename Source>
+    std::streamsize read(Source &src, char *s, std::streamsize n) {
+      return impl->read(src, s, n);
+    }
+  };
+}
@@ -0,0 +1,135 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+#include <cbang/openssl/AEADStream.h>
+
+#include <boost/iostreams/concepts.hpp>
+#include <boost/iostreams/operations.hpp>
+#include <boost/iostreams/close.hpp>
+#include <boost/iostreams/detail/ios.hpp>
+namespace io = boost::iostreams;
+
+#include <string>
+#include <cstring>
+#include <algorithm>
+
+
+namespace cb {
+  /// Encrypts an output stream in AEADStream format, see AEADDecryptor
+  class AEADEncryptor {
+    class AEADEncryptorImpl {
+      AEADStream aead;
+      std::string plain;
+      std::string frame;
+      uint64_t index = 0;
+      bool started = false;
+      bool done = false;
+
+    public:
+      AEADEncryptorImpl(const AEADStream &aead) : aead(aead) {
+        plain.reserve(aead.getFrameSize());
+        frame.resize(aead.getEncryptedFrameSize());
+      }
+
+
+      template<typename Sink>
+      std::streamsize write(Sink &dest, const char *s, std::streamsize n) {
+        if (done) return 0;
+        start(dest);
+
+        std::streamsize consumed = 0;
+        while (consumed < n) {
+          // Only the last frame may be short, so hold full frames until
+          // more data arrives
+          if (plain.size() == aead.getFrameSize()) writeFrame(dest, false);
+
+          std::streamsize count = std::min<std::streamsize>
+            (n - consumed, aead.getFrameSize() - plain.size());
+          plain.append(s + consumed, count);
+          consumed += count;
+        }
+
+        return n;
+      }
+
+
+      template<typename Sink> void close(Sink &dest) {
+        if (done) return;
+        start(dest);
+        writeFrame(dest, true);
+        done = true;
+      }
+
+
+    protected:
+      template<typename Sink> void start(Sink &dest) {
+        if (started) return;
+        started = true;
+        io::write(dest, aead.getHeader().data(), AEADStream::HEADER_SIZE);
+      }
+
+
+      template<typename Sink> void writeFrame(Sink &dest, bool last) {
+        aead.encrypt(index++, last, plain.data(), plain.size(), &frame[0]);
+        io::write(dest, frame.data(), plain.size() + AEADStream::TAG_SIZE);
+        plain.clear();
+      }
+    };
+
+
+    SmartPointer<AEADEncryptorImpl> impl;
+
+  public:
+    typedef char char_type;
+    struct category :
+      io::output, io::filter_tag, io::multichar_tag, io::closable_tag {};
+
+
+    AEADEncryptor(const AEADStream &aead) : impl(new AEADEncryptorImpl(aead)) {}
+    AEADEncryptor(const std::string &key,
+                  AEADStream::cipher_t cipher = AEADStream::AES_256_GCM,
+                  unsigned frameSize = 64 * 1024) :
+      impl(new AEADEncryptorImpl(AEADStream(key, cipher, frameSize))) {}
+
+
+    template<typename Sink>
+    std::streamsize write(Sink &dest, const char *s, std::streamsize n) {
+      return impl->write(dest, s, n);
+    }
+
+
+    template<typename Sink> void close(Sink &dest) {impl->close(dest);}
+  };
+}
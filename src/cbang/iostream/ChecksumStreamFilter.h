@@ -0,0 +1,85 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+#include <cbang/util/CRC32C.h>
+#include <cbang/util/XXH3.h>
+
+#include <iosfwd> // streamsize
+#include <boost/iostreams/concepts.hpp>
+#include <boost/iostreams/operations.hpp>
+namespace io = boost::iostreams;
+
+namespace cb {
+  /**
+   * Checksums the data passing through a filtering stream with @param T,
+   * e.g. CRC32C or XXH3.  Filters are copied when pushed so copies share
+   * the checksum.  In the stream given to TarFileWriter or TarFileReader
+   * it checksums the archive as stored, after compression.
+   */
+  template <typename T>
+  class ChecksumStreamFilter : public io::multichar_dual_use_filter {
+    SmartPointer<T> checksum;
+
+  public:
+    struct category :
+      io::multichar_dual_use_filter::category, io::flushable_tag {};
+
+    ChecksumStreamFilter() : checksum(new T) {}
+
+    T &getChecksum() const {return *checksum;}
+    decltype(T().get()) get() const {return checksum->get();}
+
+    template<typename Source>
+    std::streamsize read(Source &src, char *s, std::streamsize n) {
+      n = io::read(src, s, n);
+      if (n > 0) checksum->update(s, n);
+      return n;
+    }
+
+    template<typename Sink>
+    std::streamsize write(Sink &dest, const char *s, std::streamsize n) {
+      n = io::write(dest, s, n);
+      if (n > 0) checksum->update(s, n);
+      return n;
+    }
+
+    template<typename Sink> bool flush(Sink &snk) {return true;}
+  };
+
+
+  typedef ChecksumStreamFilter<CRC32C> CRC32CStreamFilter;
+  typedef ChecksumStreamFilter<XXH3> XXH3StreamFilter;
+}
@@ -0,0 +1,145 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/config.h>
+
+#ifdef HAVE_LZ4
+
+#include <cbang/SmartPointer.h>
+#include <cbang/Exception.h>
+
+#include <boost/iostreams/concepts.hpp>
+#include <boost/iostreams/operations.hpp>
+#include <boost/iostreams/close.hpp>
+#include <boost/iostreams/detail/ios.hpp>
+namespace io = boost::iostreams;
+
+#include <lz4frame.h>
+
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+
+namespace cb {
+  /// Compresses an output stream to the LZ4 frame format
+  class LZ4Compressor {
+    class LZ4CompressorImpl {
+      static const unsigned BLOCK_SIZE = 64 * 1024;
+
+      LZ4F_cctx *ctx;
+      LZ4F_preferences_t prefs;
+      std::vector<char> buffer;
+      bool started = false;
+      bool done = false;
+
+    public:
+      LZ4CompressorImpl(int level) {
+        if (LZ4F_isError(LZ4F_createCompressionContext(&ctx, LZ4F_VERSION)))
+          THROW("Failed to create LZ4 context");
+
+        memset(&prefs, 0, sizeof(prefs));
+        prefs.compressionLevel = level;
+        prefs.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+
+        buffer.resize(std::max((size_t)LZ4F_HEADER_SIZE_MAX,
+                               LZ4F_compressBound(BLOCK_SIZE, &prefs)));
+      }
+
+
+      ~LZ4CompressorImpl() {LZ4F_freeCompressionContext(ctx);}
+
+
+      template<typename Sink>
+      std::streamsize write(Sink &dest, const char *s, std::streamsize n) {
+        if (done) return 0;
+        begin(dest);
+
+        for (std::streamsize i = 0; i < n; i += BLOCK_SIZE) {
+          size_t length = std::min((std::streamsize)BLOCK_SIZE, n - i);
+          put(dest, LZ4F_compressUpdate(ctx, &buffer[0], buffer.size(),
+                                        s + i, length, 0));
+        }
+
+        return n;
+      }
+
+
+      template<typename Sink> void close(Sink &dest) {
+        if (done) return;
+        begin(dest);
+        done = true;
+
+        put(dest, LZ4F_compressEnd(ctx, &buffer[0], buffer.size(), 0));
+      }
+
+
+      template<typename Sink> void begin(Sink &dest) {
+        if (started) return;
+        started = true;
+
+        put(dest, LZ4F_compressBegin(ctx, &buffer[0], buffer.size(), &prefs));
+      }
+
+
+      template<typename Sink> void put(Sink &dest, size_t ret) {
+        if (LZ4F_isError(ret)) THROW("LZ4: " << LZ4F_getErrorName(ret));
+        if (ret) io::write(dest, &buffer[0], ret);
+      }
+    };
+
+
+    SmartPointer<LZ4CompressorImpl> impl;
+
+  public:
+    typedef char char_type;
+    struct category :
+      io::output_filter_tag, io::multichar_tag, io::closable_tag {};
+
+
+    /// @param level 0 is fast mode, 3 to 12 use LZ4 HC
+    LZ4Compressor(int level = 0) : impl(new LZ4CompressorImpl(level)) {}
+
+
+    template<typename Sink>
+    std::streamsize write(Sink &dest, const char *s, std::streamsize n) {
+      return impl->write(dest, s, n);
+    }
+
+
+    template<typename Sink> void close(Sink &dest) {impl->close(dest);}
+  };
+}
+
+#endif // HAVE_LZ4
@@ -0,0 +1,126 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/config.h>
+
+#ifdef HAVE_LZ4
+
+#include <cbang/SmartPointer.h>
+#include <cbang/Exception.h>
+
+#include <boost/iostreams/concepts.hpp>
+#include <boost/iostreams/operations.hpp>
+#include <boost/iostreams/close.hpp>
+#include <boost/iostreams/detail/ios.hpp>
+namespace io = boost::iostreams;
+
+#include <lz4frame.h>
+
+#include <vector>
+
+
+namespace cb {
+  /// Decompresses an input stream of one or more LZ4 frames
+  class LZ4Decompressor {
+    class LZ4DecompressorImpl {
+      LZ4F_dctx *ctx;
+      std::vector<char> buffer;
+      size_t inPos = 0;
+      size_t inSize = 0;
+      bool eof = false;
+      bool inFrame = false;
+
+    public:
+      LZ4DecompressorImpl() : buffer(64 * 1024) {
+        if (LZ4F_isError(LZ4F_createDecompressionContext(&ctx, LZ4F_VERSION)))
+          THROW("Failed to create LZ4 context");
+      }
+
+
+      ~LZ4DecompressorImpl() {LZ4F_freeDecompressionContext(ctx);}
+
+
+      template<typename Source>
+      std::streamsize read(Source &src, char *s, std::streamsize n) {
+        std::streamsize total = 0;
+
+        while (total < n) {
+          if (inPos == inSize && !eof) {
+            std::streamsize count = io::read(src, &buffer[0], buffer.size());
+
+            if (count <= 0) eof = true;
+            else {
+              inPos = 0;
+              inSize = count;
+            }
+          }
+
+          size_t outLength = n - total;
+          size_t inLength = inSize - inPos;
+          size_t ret = LZ4F_decompress(ctx, s + total, &outLength,
+                                       &buffer[inPos], &inLength, 0);
+          if (LZ4F_isError(ret)) THROW("LZ4: " << LZ4F_getErrorName(ret));
+
+          inPos += inLength;
+          total += outLength;
+          inFrame = ret;
+
+          if (eof && inPos == inSize && !outLength) break;
+        }
+
+        if (!total && eof && inFrame) THROW("Truncated LZ4 stream");
+
+        return total ? total : -1;
+      }
+    };
+
+
+    SmartPointer<LZ4DecompressorImpl> impl;
+
+  public:
+    typedef char char_type;
+    struct category : io::input_filter_tag, io::multichar_tag {};
+
+
+    LZ4Decompressor() : impl(new LZ4DecompressorImpl) {}
+
+
+    template<typename Source>
+    std::streamsize read(Source &src, char *s, std::streamsize n) {
+      return impl->read(src, s, n);
+    }
+  };
+}
+
+#endif // HAVE_LZ4
@@ -0,0 +1,437 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "ParallelCompressor.h"
+
+#include <cbang/Exception.h>
+#include <cbang/os/Condition.h>
+#include <cbang/os/ThreadPool.h>
+#include <cbang/os/SystemInfo.h>
+#include <cbang/util/BZip2.h>
+#include <cbang/util/SmartLock.h>
+
+#include <bzlib.h>
+#include <zlib.h>
+
+#include <deque>
+#include <algorithm>
+#include <string.h>
+
+using namespace cb;
+using namespace std;
+
+
+namespace {
+  const uint64_t bzip2BlockMagic = 0x314159265359ULL;
+  const uint64_t bzip2EndMagic = 0x177245385090ULL;
+
+
+  uint64_t readBits(const string &data, uint64_t pos, unsigned count) {
+    uint64_t x = 0;
+
+    for (unsigned i = 0; i < count; i++, pos++)
+      x = (x << 1) | (((uint8_t)data[pos >> 3] >> (7 - (pos & 7))) & 1);
+
+    return x;
+  }
+
+
+  struct Job {
+    string input;
+    string dict;
+    string output;
+    bool last = false;
+    bool done = false;
+    string error;
+    uint32_t check = 0;
+  };
+}
+
+
+class ParallelCompressor::Impl : public ThreadPool {
+  format_t format;
+  int level;
+  unsigned blockSize;
+  unsigned maxPending;
+
+  Condition condition;
+  deque<Job *> queue; // Waiting to be compressed
+  bool stopping = false;
+
+  // Only accessed by the writing thread
+  deque<SmartPointer<Job> > pending; // In output order
+  SmartPointer<Job> current;
+  string tail; // Deflate dictionary for the next block
+  bool started = false;
+  bool headerWritten = false;
+  bool closed = false;
+
+  string out;
+  uint64_t totalIn = 0;
+  uint32_t check;
+  uint64_t bitBuffer = 0;
+  unsigned bitCount = 0;
+
+public:
+  Impl(format_t format, unsigned threads, int level, unsigned blockSize) :
+    ThreadPool(threads ? threads : SystemInfo::instance().getCPUCount()),
+    format(format), level(level), blockSize(blockSize),
+    check(format == ZLIB ? 1 : 0) {
+
+    if (format == BZIP2) {
+      if (this->level < 1 || 9 < this->level) this->level = 9;
+
+      // Never overflow one bzip2 block, even if run-length encoding expands
+      // the input by 5/4
+      unsigned maxBlock = (100000 * this->level - 19) * 4 / 5;
+      if (!blockSize || maxBlock < blockSize) this->blockSize = maxBlock;
+
+    } else {
+      if (this->level < 0 || 9 < this->level)
+        this->level = Z_DEFAULT_COMPRESSION;
+      if (!blockSize) this->blockSize = 256 * 1024;
+    }
+
+    maxPending = 2 * getSize();
+  }
+
+
+  ~Impl() {
+    {
+      SmartLock lock(&condition);
+      stopping = true;
+      condition.broadcast();
+    }
+
+    if (started) join();
+  }
+
+
+  void write(const char *s, streamsize n, sink_t sink) {
+    if (closed) THROW("ParallelCompressor already closed");
+
+    while (n) {
+      if (current.isNull()) {
+        current = new Job;
+        current->input.reserve(blockSize);
+      }
+
+      streamsize count =
+        min((streamsize)(blockSize - current->input.size()), n);
+      current->input.append(s, count);
+      s += count;
+      n -= count;
+
+      if (current->input.size() == blockSize) submit(sink);
+    }
+
+    drain(sink, false);
+  }
+
+
+  void close(sink_t sink) {
+    if (closed) return;
+    closed = true;
+
+    if (current.isNull()) current = new Job;
+    current->last = true;
+    submit(sink);
+    drain(sink, true);
+
+    writeTrailer();
+    flush(sink);
+  }
+
+
+  void submit(sink_t sink) {
+    if (!started) {start(); started = true;}
+
+    SmartPointer<Job> job = current;
+    current.release();
+
+    if (format != BZIP2) {
+      job->dict = tail;
+
+      const unsigned dictSize = 32768;
+      const string &input = job->input;
+
+      if (dictSize <= input.size())
+        tail = input.substr(input.size() - dictSize);
+
+      else {
+        tail += input;
+        if (dictSize < tail.size()) tail.erase(0, tail.size() - dictSize);
+      }
+    }
+
+    pending.push_back(job);
+
+    {
+      SmartLock lock(&condition);
+      queue.push_back(job.get());
+      condition.broadcast();
+    }
+
+    // Bound memory use
+    while (maxPending < pending.size()) drainOne(sink);
+  }
+
+
+  void drain(sink_t sink, bool wait) {
+    while (!pending.empty()) {
+      if (!wait) {
+        SmartLock lock(&condition);
+        if (!pending.front()->done) break;
+      }
+
+      drainOne(sink);
+    }
+  }
+
+
+  void drainOne(sink_t sink) {
+    SmartPointer<Job> job = pending.front();
+    pending.pop_front();
+
+    {
+      SmartLock lock(&condition);
+      while (!job->done) condition.wait();
+    }
+
+    if (!job->error.empty()) THROW("Compression failed: " << job->error);
+
+    writeHeader();
+    if (format == BZIP2) spliceBZip2(*job);
+    else {
+      out.append(job->output);
+      uint64_t size = job->input.size();
+      if (format == GZIP) check = crc32_combine(check, job->check, size);
+      else check = adler32_combine(check, job->check, size);
+    }
+
+    totalIn += job->input.size();
+    flush(sink);
+  }
+
+
+  void flush(sink_t sink) {
+    if (out.empty()) return;
+    sink(out.data(), out.size());
+    out.clear();
+  }
+
+
+  void putBits(uint64_t bits, unsigned count) {
+    bitBuffer = (bitBuffer << count) | bits;
+    bitCount += count;
+
+    while (8 <= bitCount) {
+      bitCount -= 8;
+      out.push_back((char)(bitBuffer >> bitCount));
+    }
+
+    bitBuffer &= (1ULL << bitCount) - 1;
+  }
+
+
+  void putBytes(const char *data, unsigned length) {
+    if (!bitCount) out.append(data, length);
+    else for (unsigned i = 0; i < length; i++) putBits((uint8_t)data[i], 8);
+  }
+
+
+  void writeHeader() {
+    if (headerWritten) return;
+    headerWritten = true;
+
+    switch (format) {
+    case BZIP2: out = string("BZh") + (char)('0' + level); break;
+
+    case GZIP: {
+      const char header[] = {
+        '\x1f', '\x8b', 8, 0, 0, 0, 0, 0,
+        (char)(level == 9 ? 2 : level == 1 ? 4 : 0), (char)255};
+      out.append(header, sizeof(header));
+      break;
+    }
+
+    case ZLIB: {
+      unsigned cmf = 0x78;
+      unsigned flevel =
+        level == Z_DEFAULT_COMPRESSION || level == 6 ? 2 : level < 2 ? 0 :
+        level < 6 ? 1 : 3;
+      unsigned flg = flevel << 6;
+      flg += 31 - (cmf * 256 + flg) % 31;
+      out.push_back((char)cmf);
+      out.push_back((char)flg);
+      break;
+    }
+    }
+  }
+
+
+  void writeTrailer() {
+    writeHeader();
+
+    switch (format) {
+    case BZIP2:
+      putBits(bzip2EndMagic >> 24, 24);
+      putBits(bzip2EndMagic & 0xffffff, 24);
+      putBits(check, 32);
+      if (bitCount) putBits(0, 8 - bitCount);
+      break;
+
+    case GZIP:
+      for (unsigned i = 0; i < 4; i++) out.push_back((char)(check >> (8 * i)));
+      for (unsigned i = 0; i < 4; i++)
+        out.push_back((char)(totalIn >> (8 * i)));
+      break;
+
+    case ZLIB:
+      for (int i = 3; 0 <= i; i--) out.push_back((char)(check >> (8 * i)));
+      break;
+    }
+  }
+
+
+  void spliceBZip2(const Job &job) {
+    if (job.input.empty()) return;
+
+    // Each block was compressed to its own single block stream.  Copy the
+    // block's bits, between the stream header and end of stream marker.
+    const string &data = job.output;
+    uint64_t end = 0;
+
+    for (unsigned pad = 0; pad < 8 && !end; pad++) {
+      uint64_t pos = 8 * data.size() - 80 - pad;
+      if (readBits(data, pos, 48) == bzip2EndMagic) end = pos;
+    }
+
+    if (!end || readBits(data, 32, 48) != bzip2BlockMagic ||
+        readBits(data, end + 48, 32) != readBits(data, 80, 32))
+      THROW("Unexpected bzip2 block layout");
+
+    uint32_t blockCRC = readBits(data, 80, 32);
+    check = ((check << 1) | (check >> 31)) ^ blockCRC;
+
+    putBytes(data.data() + 4, end / 8 - 4);
+    if (end & 7) putBits(readBits(data, end & ~7ULL, end & 7), end & 7);
+  }
+
+
+  void compress(Job &job) {
+    if (format == BZIP2) {
+      if (job.input.empty()) return;
+
+      unsigned length = job.input.size() + job.input.size() / 100 + 600;
+      job.output.resize(length);
+
+      int ret = BZ2_bzBuffToBuffCompress
+        (&job.output[0], &length, (char *)job.input.data(), job.input.size(),
+         level, 0, 0);
+      if (ret != BZ_OK) THROW(BZip2::errorStr(ret));
+
+      job.output.resize(length);
+      return;
+    }
+
+    const Bytef *input = (const Bytef *)job.input.data();
+    uInt size = job.input.size();
+
+    if (format == GZIP) job.check = crc32(0, input, size);
+    else job.check = adler32(1, input, size);
+
+    // Raw deflate which ends on a byte boundary so blocks can be joined
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+    if (deflateInit2(&z, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) !=
+        Z_OK) THROW("deflateInit2() failed");
+
+    if (!job.dict.empty())
+      deflateSetDictionary(&z, (const Bytef *)job.dict.data(),
+                           job.dict.size());
+
+    job.output.resize(deflateBound(&z, size) + 16);
+    z.next_in = (Bytef *)input;
+    z.avail_in = size;
+    z.next_out = (Bytef *)&job.output[0];
+    z.avail_out = job.output.size();
+
+    int ret = deflate(&z, job.last ? Z_FINISH : Z_SYNC_FLUSH);
+    job.output.resize(z.total_out);
+    deflateEnd(&z);
+
+    if (ret != (job.last ? Z_STREAM_END : Z_OK) || z.avail_in)
+      THROW("deflate() failed");
+  }
+
+
+  // From ThreadPool
+  void run() {
+    while (true) {
+      Job *job;
+
+      {
+        SmartLock lock(&condition);
+        while (queue.empty() && !stopping) condition.wait();
+        if (queue.empty()) return;
+
+        job = queue.front();
+        queue.pop_front();
+      }
+
+      try {
+        compress(*job);
+
+      } catch (const Exception &e) {
+        job->error = e.getMessage();
+      }
+
+      SmartLock lock(&condition);
+      job->done = true;
+      condition.broadcast();
+    }
+  }
+};
+
+
+ParallelCompressor::ParallelCompressor(format_t format, unsigned threads,
+                                       int level, unsigned blockSize) :
+  impl(new Impl(format, threads, level, blockSize)) {}
+
+
+void ParallelCompressor::compress(const char *s, streamsize n, sink_t sink) {
+  impl->write(s, n, sink);
+}
+
+
+void ParallelCompressor::finish(sink_t sink) {impl->close(sink);}
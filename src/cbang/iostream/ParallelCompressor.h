@@ -0,0 +1,108 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+
+#include <iosfwd> // streamsize
+#include <functional>
+#include <string>
+
+#include <boost/iostreams/concepts.hpp>
+#include <boost/iostreams/operations.hpp>
+#include <boost/iostreams/close.hpp>
+#include <boost/iostreams/detail/ios.hpp>
+namespace io = boost::iostreams;
+
+
+namespace cb {
+  /**
+   * An output filter which splits its input into blocks and compresses
+   * them on a pool of threads, like pigz and pbzip2.  Blocks are written
+   * in order and spliced into a single standard bzip2, gzip or zlib
+   * stream, so any decompressor can read the result.
+   */
+  class ParallelCompressor {
+  public:
+    typedef enum {
+      BZIP2,
+      GZIP,
+      ZLIB,
+    } format_t;
+
+    typedef std::function<void (const char *data, std::streamsize n)> sink_t;
+
+    class Impl;
+
+  private:
+    SmartPointer<Impl> impl;
+
+  public:
+    typedef char char_type;
+    struct category :
+      io::output_filter_tag, io::multichar_tag, io::closable_tag {};
+
+
+    /**
+     * @param threads zero uses one thread per CPU.
+     * @param level is the bzip2 block size in 100k, 1-9, or the deflate
+     *   level, 0-9, with -1 for the default.
+     * @param blockSize is the uncompressed bytes per block, zero picks a
+     *   size based on the format and level.
+     */
+    ParallelCompressor(format_t format, unsigned threads = 0, int level = -1,
+                       unsigned blockSize = 0);
+
+
+    template<typename Sink>
+    std::streamsize write(Sink &dest, const char *s, std::streamsize n) {
+      compress(s, n, [&dest] (const char *data, std::streamsize n) {
+          io::write(dest, data, n);
+        });
+
+      return n;
+    }
+
+
+    template<typename Sink> void close(Sink &dest) {
+      finish([&dest] (const char *data, std::streamsize n) {
+          io::write(dest, data, n);
+        });
+    }
+
+
+    /// Compressed output is passed to @param sink as blocks complete
+    void compress(const char *s, std::streamsize n, sink_t sink);
+    void finish(sink_t sink);
+  };
+}
@@ -0,0 +1,132 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/config.h>
+
+#ifdef HAVE_ZSTD
+
+#include <cbang/SmartPointer.h>
+#include <cbang/Exception.h>
+
+#include <boost/iostreams/concepts.hpp>
+#include <boost/iostreams/operations.hpp>
+#include <boost/iostreams/close.hpp>
+#include <boost/iostreams/detail/ios.hpp>
+namespace io = boost::iostreams;
+
+#include <zstd.h>
+
+#include <vector>
+
+
+namespace cb {
+  /// Compresses an output stream to the Zstandard frame format
+  class ZstdCompressor {
+    class ZstdCompressorImpl {
+      ZSTD_CStream *stream;
+      std::vector<char> buffer;
+      bool done = false;
+
+    public:
+      ZstdCompressorImpl(int level) :
+        stream(ZSTD_createCStream()), buffer(ZSTD_CStreamOutSize()) {
+        if (!stream) THROW("Failed to create zstd stream");
+        check(ZSTD_CCtx_setParameter(stream, ZSTD_c_compressionLevel, level));
+      }
+
+
+      ~ZstdCompressorImpl() {ZSTD_freeCStream(stream);}
+
+
+      template<typename Sink>
+      std::streamsize write(Sink &dest, const char *s, std::streamsize n) {
+        if (done) return 0;
+
+        ZSTD_inBuffer in = {s, (size_t)n, 0};
+
+        while (in.pos < in.size) {
+          ZSTD_outBuffer out = {&buffer[0], buffer.size(), 0};
+          check(ZSTD_compressStream2(stream, &out, &in, ZSTD_e_continue));
+          if (out.pos) io::write(dest, &buffer[0], out.pos);
+        }
+
+        return n;
+      }
+
+
+      template<typename Sink> void close(Sink &dest) {
+        if (done) return;
+        done = true;
+
+        ZSTD_inBuffer in = {0, 0, 0};
+        size_t remaining;
+
+        do {
+          ZSTD_outBuffer out = {&buffer[0], buffer.size(), 0};
+          remaining = ZSTD_compressStream2(stream, &out, &in, ZSTD_e_end);
+          check(remaining);
+          if (out.pos) io::write(dest, &buffer[0], out.pos);
+        } while (remaining);
+      }
+
+
+      static void check(size_t ret) {
+        if (ZSTD_isError(ret)) THROW("zstd: " << ZSTD_getErrorName(ret));
+      }
+    };
+
+
+    SmartPointer<ZstdCompressorImpl> impl;
+
+  public:
+    typedef char char_type;
+    struct category :
+      io::output_filter_tag, io::multichar_tag, io::closable_tag {};
+
+
+    ZstdCompressor(int level = ZSTD_CLEVEL_DEFAULT) :
+      impl(new ZstdCompressorImpl(level)) {}
+
+
+    template<typename Sink>
+    std::streamsize write(Sink &dest, const char *s, std::streamsize n) {
+      return impl->write(dest, s, n);
+    }
+
+
+    template<typename Sink> void close(Sink &dest) {impl->close(dest);}
+  };
+}
+
+#endif // HAVE_ZSTD
@@ -0,0 +1,121 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/config.h>
+
+#ifdef HAVE_ZSTD
+
+#include <cbang/SmartPointer.h>
+#include <cbang/Exception.h>
+
+#include <boost/iostreams/concepts.hpp>
+#include <boost/iostreams/operations.hpp>
+#include <boost/iostreams/close.hpp>
+#include <boost/iostreams/detail/ios.hpp>
+namespace io = boost::iostreams;
+
+#include <zstd.h>
+
+#include <vector>
+
+
+namespace cb {
+  /// Decompresses an input stream of one or more Zstandard frames
+  class ZstdDecompressor {
+    class ZstdDecompressorImpl {
+      ZSTD_DStream *stream;
+      std::vector<char> buffer;
+      ZSTD_inBuffer in = {0, 0, 0};
+      bool eof = false;
+      bool inFrame = false;
+
+    public:
+      ZstdDecompressorImpl() :
+        stream(ZSTD_createDStream()), buffer(ZSTD_DStreamInSize()) {
+        if (!stream) THROW("Failed to create zstd stream");
+      }
+
+
+      ~ZstdDecompressorImpl() {ZSTD_freeDStream(stream);}
+
+
+      template<typename Source>
+      std::streamsize read(Source &src, char *s, std::streamsize n) {
+        ZSTD_outBuffer out = {s, (size_t)n, 0};
+
+        while (out.pos < out.size) {
+          if (in.pos == in.size && !eof) {
+            std::streamsize count = io::read(src, &buffer[0], buffer.size());
+
+            if (count <= 0) eof = true;
+            else {
+              in.src = &buffer[0];
+              in.size = count;
+              in.pos = 0;
+            }
+          }
+
+          size_t pos = out.pos;
+          size_t ret = ZSTD_decompressStream(stream, &out, &in);
+          if (ZSTD_isError(ret)) THROW("zstd: " << ZSTD_getErrorName(ret));
+          inFrame = ret;
+
+          if (eof && in.pos == in.size && out.pos == pos) break;
+        }
+
+        if (!out.pos && eof && inFrame) THROW("Truncated zstd stream");
+
+        return out.pos ? (std::streamsize)out.pos : -1;
+      }
+    };
+
+
+    SmartPointer<ZstdDecompressorImpl> impl;
+
+  public:
+    typedef char char_type;
+    struct category : io::input_filter_tag, io::multichar_tag {};
+
+
+    ZstdDecompressor() : impl(new ZstdDecompressorImpl) {}
+
+
+    template<typename Source>
+    std::streamsize read(Source &src, char *s, std::streamsize n) {
+      return impl->read(src, s, n);
+    }
+  };
+}
+
+#endif // HAVE_ZSTD
@@ -0,0 +1,129 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "CodeCache.h"
+
+#include <cbang/String.h>
+#include <cbang/Catch.h>
+#include <cbang/os/SystemUtilities.h>
+#include <cbang/log/Logger.h>
+
+using namespace cb::js;
+using namespace cb;
+using namespace std;
+
+
+CodeCache::CodeCache(const string &dir) : dir(dir) {
+  SystemUtilities::ensureDirectory(dir);
+}
+
+
+bool CodeCache::isCacheable(const string &path) {
+  return !path.empty() && path[0] != '<' && SystemUtilities::exists(path);
+}
+
+
+bool CodeCache::load(const string &path, const string &source,
+                     string &data) const {
+  try {
+    string filename = getFilename(path);
+    if (!SystemUtilities::exists(filename)) return false;
+
+    string contents = SystemUtilities::read(filename);
+    string key = getKey(path, source);
+
+    if (contents.compare(0, key.length(), key)) {
+      LOG_DEBUG(4, "Code cache stale for " << path);
+      return false;
+    }
+
+    data = contents.substr(key.length());
+    LOG_DEBUG(5, "Code cache hit for " << path);
+
+    return true;
+  } CATCH_WARNING;
+
+  return false;
+}
+
+
+void CodeCache::store(const string &path, const string &source,
+                      const string &data) const {
+  try {
+    string filename = getFilename(path);
+    string tmp = filename + ".tmp";
+
+    // Write then rename so readers never see a partial entry
+    {
+      SmartPointer<ostream> stream = SystemUtilities::oopen(tmp);
+      *stream << getKey(path, source);
+      stream->write(data.data(), data.length());
+    }
+
+    SystemUtilities::rename(tmp, filename);
+    LOG_DEBUG(5, "Code cache stored " << data.length() << " bytes for "
+              << path);
+  } CATCH_WARNING;
+}
+
+
+void CodeCache::remove(const string &path) const {
+  TRY_CATCH_WARNING(SystemUtilities::unlink(getFilename(path)));
+}
+
+
+uint64_t CodeCache::hash(const string &s) {
+  // 64-bit FNV-1a, stable across builds unlike std::hash
+  uint64_t h = 0xcbf29ce484222325ULL;
+
+  for (unsigned i = 0; i < s.length(); i++) {
+    h ^= (uint8_t)s[i];
+    h *= 0x100000001b3ULL;
+  }
+
+  return h;
+}
+
+
+string CodeCache::getFilename(const string &path) const {
+  string abs = SystemUtilities::absolute(path);
+  return SystemUtilities::joinPath(dir, String::printf("%016llx.cache",
+                                   (unsigned long long)hash(abs)));
+}
+
+
+string CodeCache::getKey(const string &path, const string &source) {
+  return String::printf
+    ("%s %llu %016llx %u\n", SystemUtilities::absolute(path).c_str(),
+     (unsigned long long)SystemUtilities::getModificationTime(path),
+     (unsigned long long)hash(source), (unsigned)source.length());
+}
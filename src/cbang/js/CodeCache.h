@@ -0,0 +1,74 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+
+namespace cb {
+  namespace js {
+    /**
+     * Stores engine specific compiled code for script files in a directory.
+     * Entries are keyed by the script's path and validated against its
+     * modification time and a hash of its source, so edited scripts are
+     * recompiled.  Errors are logged and treated as cache misses.
+     */
+    class CodeCache {
+      std::string dir;
+
+    public:
+      CodeCache(const std::string &dir);
+
+      const std::string &getDirectory() const {return dir;}
+
+      /// Only real files are cached, not e.g. "<eval>"
+      static bool isCacheable(const std::string &path);
+
+      /// @return True and the cached code in @param data on a hit
+      bool load(const std::string &path, const std::string &source,
+                std::string &data) const;
+      void store(const std::string &path, const std::string &source,
+                 const std::string &data) const;
+      /// Drop an entry the engine rejected, e.g. after an upgrade
+      void remove(const std::string &path) const;
+
+      static uint64_t hash(const std::string &s);
+
+    protected:
+      std::string getFilename(const std::string &path) const;
+      static std::string getKey(const std::string &path,
+                                const std::string &source);
+    };
+  }
+}
@@ -36,12 +36,18 @@
 #include "Function.h"
 
 #include <cbang/StdTypes.h>
+#include <cbang/Exception.h>
+
+#include <functional>
+#include <string>
 
 
 namespace cb {
   namespace js {
     class Factory {
     public:
+      typedef std::function<void ()> release_t;
+
       virtual ~Factory() {}
 
       virtual SmartPointer<Value> create(const std::string &value) = 0;
@@ -74,6 +80,22 @@ namespace cb {
       virtual SmartPointer<Value> createBoolean(bool value) = 0;
       virtual SmartPointer<Value> createUndefined() = 0;
       virtual SmartPointer<Value> createNull() = 0;
+
+      /**
+       * Wrap @param length bytes at @param data as an ArrayBuffer without
+       * copying.  @param release is called, possibly from the garbage
+       * collector, once the engine no longer references the memory.
+       */
+      virtual SmartPointer<Value>
+      createArrayBuffer(char *data, unsigned length, const release_t &release)
+      {CBANG_THROW("External ArrayBuffers not supported");}
+
+      /// Reference @param s, which must not change while JS can see it
+      SmartPointer<Value>
+      createArrayBuffer(const SmartPointer<std::string> &s) {
+        return createArrayBuffer(s->empty() ? 0 : &(*s)[0], s->length(),
+                                 [s] () {});
+      }
     };
   }
 }
@@ -35,6 +35,7 @@
 #include "Module.h"
 #include "Factory.h"
 #include "Scope.h"
+#include "CodeCache.h"
 
 #include <cbang/io/InputSource.h>
 
@@ -42,9 +43,19 @@
 namespace cb {
   namespace js {
     class Impl {
+    protected:
+      SmartPointer<CodeCache> codeCache;
+
     public:
       virtual ~Impl() {}
 
+      /// Used to name the engine's directory in a shared code cache
+      virtual const char *getName() const = 0;
+
+      const SmartPointer<CodeCache> &getCodeCache() const {return codeCache;}
+      void setCodeCache(const SmartPointer<CodeCache> &cache)
+        {codeCache = cache;}
+
       virtual SmartPointer<Factory> getFactory() = 0;
       virtual SmartPointer<Scope> enterScope() = 0;
       virtual SmartPointer<Scope> newScope() = 0;
@@ -89,6 +89,13 @@ Javascript::Javascript(const string &implName,
 SmartPointer<js::Factory> Javascript::getFactory() {return impl->getFactory();}
 
 
+void Javascript::setCodeCacheDir(const string &dir) {
+  if (dir.empty()) impl->setCodeCache(0);
+  else impl->setCodeCache
+         (new CodeCache(SystemUtilities::joinPath(dir, impl->getName())));
+}
+
+
 void Javascript::define(NativeModule &mod) {
   SmartPointer<Scope> scope = impl->enterScope();
 
@@ -39,6 +39,8 @@
 
 #include <cbang/io/InputSource.h>
 
+#include <map>
+
 
 namespace cb {
   namespace js {
@@ -59,6 +61,13 @@ namespace cb {
                  cb::SmartPointer<std::ostream>::Phony(&std::cout));
 
       SmartPointer<js::Factory> getFactory();
+
+      /**
+       * Cache compiled scripts loaded from files under @param dir.  Each
+       * engine uses its own subdirectory.  Empty disables the cache.
+       */
+      void setCodeCacheDir(const std::string &dir);
+
       void define(NativeModule &mod);
       void import(const std::string &module,
                   const std::string &as = std::string());
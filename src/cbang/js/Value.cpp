@@ -32,6 +32,7 @@
 
 #include "Value.h"
 
+#include <cbang/Exception.h>
 #include <cbang/json/Writer.h>
 
 using namespace cb::js;
@@ -39,6 +40,11 @@ using namespace cb;
 using namespace std;
 
 
+const char *Value::getArrayBufferData(unsigned &length) const {
+  THROW("Value is not an ArrayBuffer");
+}
+
+
 void Value::copyProperties(const Value &value) {
   SmartPointer<Value> props = value.getOwnPropertyNames();
   unsigned length = props->length();
@@ -51,15 +57,22 @@ void Value::copyProperties(const Value &value) {
 
 
 void Value::write(JSON::Sink &sink) const {
-  if (isObject()) {
+  // Values are streamed to the Sink, e.g. a JSON::Writer, without a DOM
+  if (isArrayBuffer()) {
+    unsigned length;
+    const char *data = getArrayBufferData(length);
+    sink.write(string(data, length));
+
+  } else if (isObject()) {
     sink.beginDict();
 
     SmartPointer<Value> props = getOwnPropertyNames();
     for (unsigned i = 0; i < props->length(); i++) {
       string key = props->get(i)->toString();
-      if (get(key)->isUndefined()) continue;
+      SmartPointer<Value> value = get(key);
+      if (value->isUndefined()) continue;
       sink.beginInsert(key);
-      get(key)->write(sink);
+      value->write(sink);
     }
 
     sink.endDict();
@@ -68,9 +81,10 @@ void Value::write(JSON::Sink &sink) const {
     sink.beginList();
 
     for (unsigned i = 0; i < length(); i++) {
-      if (get(i)->isUndefined()) continue;
+      SmartPointer<Value> value = get(i);
+      if (value->isUndefined()) continue;
       sink.beginAppend();
-      get(i)->write(sink);
+      value->write(sink);
     }
 
     sink.endList();
@@ -57,12 +57,16 @@ namespace cb {
       virtual bool isObject() const {return false;}
       virtual bool isString() const {return false;}
       virtual bool isUndefined() const {return false;}
+      virtual bool isArrayBuffer() const {return false;}
 
       virtual bool toBoolean() const = 0;
       virtual int toInteger() const = 0;
       virtual double toNumber() const = 0;
       virtual std::string toString() const = 0;
 
+      /// @return The ArrayBuffer's memory, valid while this Value is alive
+      virtual const char *getArrayBufferData(unsigned &length) const;
+
       virtual unsigned length() const = 0;
       virtual SmartPointer<Value> get(int i) const = 0;
 
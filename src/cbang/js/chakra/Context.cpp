@@ -62,14 +62,64 @@ void Context::enter() {CHAKRA_CHECK(JsSetCurrentContext(context));}
 void Context::leave() {JsSetCurrentContext(JS_INVALID_REFERENCE);}
 
 
+namespace {
+  bool CHAKRA_CALLBACK loadSource(JsSourceContext ctx, JsValueRef *value,
+                                  JsParseScriptAttributes *attrs) {
+    *value = (JsValueRef)ctx;
+    *attrs = JsParseScriptAttributeNone;
+    return true;
+  }
+}
+
+
 Value Context::eval(const string &path, const string &code) {
   impl.enable();
   enter();
 
   JsValueRef result;
-  JsRun(Value::createArrayBuffer(code), 0, Value(path),
-        JsParseScriptAttributeNone, &result);
+  Value source = Value::createArrayBuffer(code);
+
+  // ChakraCore can only cache the parser state, scripts are still compiled
+  const SmartPointer<js::CodeCache> &cache = impl.getCodeCache();
+  if (cache.isSet() && js::CodeCache::isCacheable(path)) {
+    string cached;
+    bool hit = cache->load(path, code, cached);
+
+    if (!hit) {
+      JsValueRef buffer;
+      if (JsSerialize(source, &buffer, JsParseScriptAttributeNone) ==
+          JsNoError) {
+        uint8_t *data;
+        unsigned length;
+        CHAKRA_CHECK(JsGetArrayBufferStorage(buffer, &data, &length));
+        cached = string((const char *)data, length);
+        cache->store(path, code, cached);
+        hit = true;
+      }
+    }
+
+    if (hit) {
+      // Chakra reads the buffer and source lazily so they must be kept
+      Value buffer = Value::createArrayBuffer(cached);
+      impl.retain(buffer);
+      impl.retain(source);
+
+      JsErrorCode err =
+        JsRunSerialized(buffer, &loadSource, (JsSourceContext)(void *)source,
+                        Value(path), &result);
+
+      if (err != JsErrorBadSerializedScript) return finishEval(path, result);
+      cache->remove(path);
+    }
+  }
+
+  JsRun(source, 0, Value(path), JsParseScriptAttributeNone, &result);
+
+  return finishEval(path, result);
+}
+
 
+Value Context::finishEval(const string &path, JsValueRef result) {
   // Check for errors
   if (Value::hasException()) {
     Value ex = Value::getException();
@@ -78,6 +78,9 @@ namespace cb {
 
       Value eval(const std::string &path, const std::string &code);
       Value eval(const InputSource &source);
+
+    protected:
+      Value finishEval(const std::string &path, JsValueRef result);
     };
   }
 }
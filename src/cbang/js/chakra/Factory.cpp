@@ -33,11 +33,24 @@
 #include "Factory.h"
 #include "Value.h"
 
+#include <cbang/Catch.h>
+
+#include <ChakraCore.h>
+
 using namespace cb::chakra;
 using namespace cb;
 using namespace std;
 
 
+namespace {
+  void CHAKRA_CALLBACK finalizeCB(void *data) {
+    js::Factory::release_t *release = (js::Factory::release_t *)data;
+    if (*release) TRY_CATCH_ERROR((*release)());
+    delete release;
+  }
+}
+
+
 Factory::Factory() :
   trueValue(true), falseValue(false), undefinedValue(Value::getUndefined()),
   nullValue(Value::getNull()) {}
@@ -86,3 +99,22 @@ SmartPointer<js::Value> Factory::createUndefined() {
 SmartPointer<js::Value> Factory::createNull() {
   return SmartPointer<js::Value>::Phony(&nullValue);
 }
+
+
+SmartPointer<js::Value>
+Factory::createArrayBuffer(char *data, unsigned length,
+                           const release_t &release) {
+  release_t *cb = new release_t(release);
+
+  JsValueRef ref;
+  JsErrorCode code =
+    JsCreateExternalArrayBuffer(data, length, finalizeCB, cb, &ref);
+
+  if (code != JsNoError) {
+    delete cb;
+    THROW("JsCreateExternalArrayBuffer() failed with 0x" << hex << code
+          << ' ' << Value::errorToString(code));
+  }
+
+  return new Value(ref);
+}
@@ -58,6 +58,9 @@ namespace cb {
       SmartPointer<js::Value> createBoolean(bool value);
       SmartPointer<js::Value> createUndefined();
       SmartPointer<js::Value> createNull();
+      SmartPointer<js::Value>
+      createArrayBuffer(char *data, unsigned length, const release_t &release);
+      using js::Factory::createArrayBuffer;
     };
   }
 }
@@ -46,6 +46,7 @@ JSImpl::JSImpl(js::Javascript &js) {
 
 
 JSImpl::~JSImpl() {
+  retained.clear();
   ctx.release();
   JsSetCurrentContext(JS_INVALID_REFERENCE);
   JsDisposeRuntime(runtime);
@@ -56,6 +56,7 @@ namespace cb {
       SmartPointer<Context> ctx;
 
       std::vector<SmartPointer<js::Callback> > callbacks;
+      std::vector<SmartPointer<ValueRef> > retained;
 
     public:
       JSImpl(js::Javascript &js);
@@ -65,9 +66,12 @@ namespace cb {
       static JSImpl &current();
 
       void add(const SmartPointer<js::Callback> &cb) {callbacks.push_back(cb);}
+      /// Keep @param value alive as long as the runtime
+      void retain(const Value &value) {retained.push_back(new ValueRef(value));}
       void enable();
 
       // From js::Impl
+      const char *getName() const {return "chakra";}
       SmartPointer<js::Factory> getFactory();
       SmartPointer<js::Scope> enterScope();
       SmartPointer<js::Scope> newScope();
@@ -145,6 +145,7 @@ bool Value::isObject() const {
 
 bool Value::isString() const {return getType() == JsString;}
 bool Value::isUndefined() const {return getType() == JsUndefined;}
+bool Value::isArrayBuffer() const {return getType() == JsArrayBuffer;}
 
 
 bool Value::toBoolean() const {
@@ -188,6 +189,16 @@ string Value::toString() const {
 }
 
 
+const char *Value::getArrayBufferData(unsigned &length) const {
+  if (!isArrayBuffer()) THROW("Value is not an ArrayBuffer");
+
+  uint8_t *buffer;
+  CHAKRA_CHECK(JsGetArrayBufferStorage(ref, &buffer, &length));
+
+  return (const char *)buffer;
+}
+
+
 unsigned Value::length() const {
   if (isObject()) return getOwnPropertyNames()->length();
   return getInteger("length");
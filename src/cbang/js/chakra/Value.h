@@ -72,12 +72,15 @@ namespace cb {
       bool isObject() const;
       bool isString() const;
       bool isUndefined() const;
+      bool isArrayBuffer() const;
 
       bool toBoolean() const;
       int toInteger() const;
       double toNumber() const;
       std::string toString() const;
 
+      const char *getArrayBufferData(unsigned &length) const;
+
       unsigned length() const;
       SmartPointer<js::Value> get(int i) const;
 
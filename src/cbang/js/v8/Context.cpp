@@ -31,6 +31,7 @@
 \******************************************************************************/
 
 #include "Context.h"
+#include "JSImpl.h"
 
 #include <cbang/js/JSInterrupted.h>
 
@@ -52,13 +53,41 @@ Value Context::eval(const InputSource &src) {
   if (!filename.empty()) origin = Value::createString(filename);
 
   // Get script source
-  v8::Local<v8::String> source = Value::createString(src.toString());
+  string code = src.toString();
+  v8::Local<v8::String> sourceStr = Value::createString(code);
+
+  // Look for cached code
+  const SmartPointer<js::CodeCache> &cache = JSImpl::current().getCodeCache();
+  bool cacheable = cache.isSet() && js::CodeCache::isCacheable(filename);
+  v8::ScriptCompiler::CompileOptions options =
+    cacheable ? v8::ScriptCompiler::kProduceCodeCache :
+    v8::ScriptCompiler::kNoCompileOptions;
+
+  string cached;
+  v8::ScriptCompiler::CachedData *cachedData = 0;
+  if (cacheable && cache->load(filename, code, cached)) {
+    cachedData = new v8::ScriptCompiler::CachedData
+      ((const uint8_t *)cached.data(), cached.length());
+    options = v8::ScriptCompiler::kConsumeCodeCache;
+  }
+
+  // Source takes ownership of cachedData
+  v8::ScriptOrigin scriptOrigin(origin);
+  v8::ScriptCompiler::Source source(sourceStr, scriptOrigin, cachedData);
 
   // Compile
   v8::TryCatch tryCatch(Value::getIso());
-  v8::Handle<v8::Script> script = v8::Script::Compile(source, origin);
+  v8::Handle<v8::Script> script =
+    v8::ScriptCompiler::Compile(Value::getIso(), &source, options);
   if (tryCatch.HasCaught()) translateException(tryCatch, false);
 
+  // Save new code or drop a cache entry V8 rejected
+  const v8::ScriptCompiler::CachedData *data = source.GetCachedData();
+  if (options == v8::ScriptCompiler::kProduceCodeCache && data)
+    cache->store(filename, code, string((const char *)data->data,
+                                        data->length));
+  else if (data && data->rejected) cache->remove(filename);
+
   // Execute
   v8::Handle<v8::Value> ret = script->Run();
   if (tryCatch.HasCaught()) translateException(tryCatch, true);
@@ -33,11 +33,34 @@
 #include "Factory.h"
 #include "Value.h"
 
+#include <cbang/Catch.h>
+
 using namespace cb::gv8;
 using namespace cb;
 using namespace std;
 
 
+namespace {
+  struct External {
+    v8::Persistent<v8::ArrayBuffer> handle;
+    js::Factory::release_t release;
+    unsigned length;
+  };
+
+
+  void externalWeakCB(const v8::WeakCallbackInfo<External> &info) {
+    External *ext = info.GetParameter();
+
+    ext->handle.Reset();
+    info.GetIsolate()->AdjustAmountOfExternalAllocatedMemory
+      (-(int64_t)ext->length);
+    if (ext->release) TRY_CATCH_ERROR(ext->release());
+
+    delete ext;
+  }
+}
+
+
 Factory::Factory() :
   trueValue(true), falseValue(false), undefinedValue(),
   nullValue(Value::createNull()) {}
@@ -86,3 +109,25 @@ SmartPointer<js::Value> Factory::createUndefined() {
 SmartPointer<js::Value> Factory::createNull() {
   return SmartPointer<js::Value>::Phony(&nullValue);
 }
+
+
+SmartPointer<js::Value>
+Factory::createArrayBuffer(char *data, unsigned length,
+                           const release_t &release) {
+  v8::Isolate *iso = Value::getIso();
+
+  // Externalized memory is not freed by V8, a weak handle reports release
+  v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New
+    (iso, data, length, v8::ArrayBufferCreationMode::kExternalized);
+
+  External *ext = new External;
+  ext->release = release;
+  ext->length = length;
+  ext->handle.Reset(iso, buffer);
+  ext->handle.SetWeak(ext, externalWeakCB, v8::WeakCallbackType::kParameter);
+
+  // Let the GC account for the memory it keeps alive
+  iso->AdjustAmountOfExternalAllocatedMemory(length);
+
+  return new Value(v8::Local<v8::Value>(buffer));
+}
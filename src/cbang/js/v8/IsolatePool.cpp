@@ -0,0 +1,127 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "IsolatePool.h"
+
+#include <cbang/Exception.h>
+#include <cbang/util/SmartLock.h>
+#include <cbang/log/Logger.h>
+
+using namespace cb::gv8;
+using namespace cb;
+using namespace std;
+
+
+IsolatePool::IsolatePool(Inaccessible) {}
+IsolatePool::~IsolatePool() {clear();}
+
+
+void IsolatePool::setSnapshotSource(const string &source) {
+  SmartLock lock(this);
+
+  clear();
+  snapshotSource = source;
+
+  if (snapshot.data) delete [] snapshot.data;
+  snapshot = {0, 0};
+
+  if (source.empty()) return;
+
+  snapshot = v8::V8::CreateSnapshotDataBlob(source.c_str());
+  if (!snapshot.data) THROW("Failed to create V8 startup snapshot");
+
+  LOG_DEBUG(3, "V8 startup snapshot " << snapshot.raw_size << " bytes");
+}
+
+
+void IsolatePool::prewarm(unsigned count) {
+  SmartLock lock(this);
+  while (idle.size() < count) idle.push_back(create());
+}
+
+
+void IsolatePool::clear() {
+  SmartLock lock(this);
+
+  for (unsigned i = 0; i < idle.size(); i++) dispose(idle[i]);
+  idle.clear();
+}
+
+
+IsolatePool::Entry IsolatePool::acquire() {
+  SmartLock lock(this);
+
+  if (idle.empty()) return create();
+
+  Entry entry = idle.back();
+  idle.pop_back();
+  reused++;
+
+  return entry;
+}
+
+
+void IsolatePool::release(const Entry &entry) {
+  // Let V8 know the old Contexts are garbage
+  {
+    v8::Locker locker(entry.isolate);
+    entry.isolate->ContextDisposedNotification();
+  }
+
+  SmartLock lock(this);
+
+  if (idle.size() < maxIdle) idle.push_back(entry);
+  else dispose(entry);
+}
+
+
+IsolatePool::Entry IsolatePool::create() {
+  Entry entry;
+  entry.allocator = v8::ArrayBuffer::Allocator::NewDefaultAllocator();
+
+  v8::Isolate::CreateParams params;
+  params.array_buffer_allocator = entry.allocator;
+  if (snapshot.data) params.snapshot_blob = &snapshot;
+  if (heapLimit) params.constraints.set_max_old_space_size(heapLimit);
+  if (youngLimit) params.constraints.set_max_semi_space_size(youngLimit);
+
+  entry.isolate = v8::Isolate::New(params);
+  created++;
+
+  return entry;
+}
+
+
+void IsolatePool::dispose(const Entry &entry) {
+  entry.isolate->Dispose();
+  delete entry.allocator;
+}
@@ -0,0 +1,114 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "V8.h"
+
+#include <cbang/os/Mutex.h>
+#include <cbang/util/Singleton.h>
+
+#include <string>
+#include <vector>
+
+
+namespace cb {
+  namespace gv8 {
+    /**
+     * Keeps idle v8::Isolates for reuse so that creating a js::Javascript
+     * does not pay for a new Isolate and heap each time.  Isolates are
+     * created with the configured heap limits and, if a snapshot source
+     * is set, from a startup snapshot in which that script has already
+     * run.  Only plain Javascript can be snapshotted, native modules bind
+     * C++ callbacks by pointer so they are still defined per Javascript.
+     *
+     * A released Isolate's Contexts are discarded by its owner, the Isolate
+     * is told its Contexts were disposed and returned to the idle list.
+     */
+    class IsolatePool : public Singleton<IsolatePool>, public Mutex {
+    public:
+      struct Entry {
+        v8::Isolate *isolate = 0;
+        v8::ArrayBuffer::Allocator *allocator = 0;
+      };
+
+    protected:
+      std::vector<Entry> idle;
+      unsigned maxIdle = 4;
+      unsigned heapLimit = 0;
+      unsigned youngLimit = 0;
+
+      std::string snapshotSource;
+      v8::StartupData snapshot = {0, 0};
+
+      uint64_t created = 0;
+      uint64_t reused = 0;
+
+    public:
+      IsolatePool(Inaccessible);
+      ~IsolatePool();
+
+      unsigned getMaxIdle() const {return maxIdle;}
+      void setMaxIdle(unsigned x) {maxIdle = x;}
+
+      unsigned getHeapLimit() const {return heapLimit;}
+      /// Maximum old generation size in MiB, zero for V8's default
+      void setHeapLimit(unsigned mb) {heapLimit = mb;}
+
+      unsigned getYoungLimit() const {return youngLimit;}
+      /// Maximum young generation semi-space size in MiB
+      void setYoungLimit(unsigned mb) {youngLimit = mb;}
+
+      const std::string &getSnapshotSource() const {return snapshotSource;}
+      /**
+       * Run @param source once and start new Isolates from a snapshot of
+       * the resulting heap.  Idle Isolates are discarded.
+       */
+      void setSnapshotSource(const std::string &source);
+
+      unsigned getIdleCount() const {return idle.size();}
+      uint64_t getCreatedCount() const {return created;}
+      uint64_t getReusedCount() const {return reused;}
+
+      /// Create Isolates until @param count are idle
+      void prewarm(unsigned count);
+      void clear();
+
+      Entry acquire();
+      void release(const Entry &entry);
+
+    protected:
+      Entry create();
+      static void dispose(const Entry &entry);
+    };
+  }
+}
@@ -44,28 +44,22 @@ using namespace cb;
 using namespace std;
 
 
-JSImpl *JSImpl::singleton = 0;
-
-
-JSImpl::JSImpl(js::Javascript &js) {
-  if (singleton) THROW("There can be only one. . .");
-  singleton = this;
-
-  v8::Isolate::CreateParams params;
-  params.array_buffer_allocator =
-    v8::ArrayBuffer::Allocator::NewDefaultAllocator();
-  isolate = v8::Isolate::New(params);
-
+JSImpl::JSImpl(js::Javascript &js) :
+  entry(IsolatePool::instance().acquire()), isolate(entry.isolate) {
   scope = new Scope(isolate);
+  isolate->SetData(0, this);
   ctx = new Context(isolate);
 }
 
 
 JSImpl::~JSImpl() {
+  // Drop this instance's Context and callbacks before reuse
   ctx.release();
+  callbacks.clear();
+  isolate->SetData(0, 0);
   scope.release();
-  isolate->Dispose();
-  singleton = 0;
+
+  IsolatePool::instance().release(entry);
 }
 
 
@@ -77,8 +71,23 @@ void JSImpl::init(int *argc, char *argv[]) {
 
 
 JSImpl &JSImpl::current() {
-  if (!singleton) THROW("No instance created");
-  return *singleton;
+  v8::Isolate *iso = v8::Isolate::GetCurrent();
+  if (!iso || !iso->GetData(0)) THROW("No instance created");
+  return *(JSImpl *)iso->GetData(0);
+}
+
+
+uint64_t JSImpl::getHeapUsed() const {
+  v8::HeapStatistics stats;
+  isolate->GetHeapStatistics(&stats);
+  return stats.used_heap_size();
+}
+
+
+uint64_t JSImpl::getHeapLimit() const {
+  v8::HeapStatistics stats;
+  isolate->GetHeapStatistics(&stats);
+  return stats.heap_size_limit();
 }
 
 
@@ -34,6 +34,7 @@
 
 #include "ValueRef.h"
 #include "Context.h"
+#include "IsolatePool.h"
 
 #include <cbang/SmartPointer.h>
 #include <cbang/js/Impl.h>
@@ -50,6 +51,7 @@ namespace cb {
     class Module;
 
     class JSImpl : public js::Impl {
+      IsolatePool::Entry entry;
       v8::Isolate *isolate = 0;
 
       struct Scope {
@@ -65,18 +67,22 @@ namespace cb {
 
       std::vector<SmartPointer<js::Callback> > callbacks;
 
-      static JSImpl *singleton;
-
     public:
       JSImpl(js::Javascript &js);
       ~JSImpl();
 
       static void init(int *argc = 0, char *argv[] = 0);
+      /// @return The JSImpl which owns the current Isolate
       static JSImpl &current();
 
+      v8::Isolate *getIsolate() const {return isolate;}
+      uint64_t getHeapUsed() const;
+      uint64_t getHeapLimit() const;
+
       void add(const SmartPointer<js::Callback> &cb) {callbacks.push_back(cb);}
 
       // From js::Impl
+      const char *getName() const {return "v8";}
       SmartPointer<js::Factory> getFactory();
       SmartPointer<js::Scope> enterScope();
       SmartPointer<js::Scope> newScope();
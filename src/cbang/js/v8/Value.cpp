@@ -195,6 +195,17 @@ unsigned Value::length() const {
 }
 
 
+const char *Value::getArrayBufferData(unsigned &length) const {
+  if (!isArrayBuffer()) THROW("Value is not an ArrayBuffer");
+
+  v8::ArrayBuffer::Contents contents =
+    v8::ArrayBuffer::Cast(*value)->GetContents();
+  length = contents.ByteLength();
+
+  return (const char *)contents.Data();
+}
+
+
 Value Value::call(Value arg0, const vector<Value> &args) const {
   if (!isFunction()) THROW("Value is not a function");
 
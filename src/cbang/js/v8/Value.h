@@ -140,6 +140,10 @@ namespace cb {
       bool isArray() const {return value->IsArray();}
       unsigned length() const;
 
+      // ArrayBuffer
+      bool isArrayBuffer() const {return value->IsArrayBuffer();}
+      const char *getArrayBufferData(unsigned &length) const;
+
       // Function
       bool isFunction() const {return value->IsFunction();}
       Value call(Value arg0, const std::vector<Value> &args) const;
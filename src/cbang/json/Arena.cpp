@@ -0,0 +1,189 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "Arena.h"
+
+#include "Dict.h"
+#include "InternedDict.h"
+#include "List.h"
+#include "NumberList.h"
+#include "Number.h"
+#include "String.h"
+
+#include <cbang/Exception.h>
+#include <cbang/util/MemoryAccounting.h>
+
+#include <new>
+#include <cstdlib>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+namespace {
+  const size_t alignment = alignof(max_align_t);
+  inline size_t align(size_t size) {
+    return (size + alignment - 1) & ~(alignment - 1);
+  }
+}
+
+
+/// Counts references to a Value allocated in an Arena.  Both the Counter and
+/// the Value live in the Arena's memory so neither is deleted.
+class Arena::Counter : public RefCounter {
+  SmartPointer<Arena> arena;
+  Value *value;
+  unsigned count = 0;
+
+public:
+  Counter(Arena *arena, Value *value) : arena(arena), value(value) {}
+
+  // From RefCounter
+  unsigned getCount() const {return count;}
+  void incCount() {count++;}
+
+  void decCount(const void *ptr) {
+    if (!count) raise("Already zero!");
+    if (--count) return;
+
+    // Keep the Arena until after this Counter is destroyed
+    SmartPointer<Arena> arena = this->arena;
+
+    value->~Value();
+    this->~Counter();
+  }
+};
+
+
+Arena::Arena(size_t blockSize) : blockSize(blockSize) {
+  if (blockSize < 1024) THROW("Arena block size too small: " << blockSize);
+}
+
+
+Arena::Arena(const SmartPointer<ArenaPool> &pool) :
+  blockSize(pool->getBlockSize()), pool(pool) {}
+
+
+Arena::~Arena() {
+  while (blocks) {
+    Block *next = blocks->next;
+    if (pool.isSet() && blocks->size == blockSize) pool->put(blocks);
+    else {
+      ArenaPool::getMemoryTag().released(blocks->size);
+      free(blocks);
+    }
+    blocks = next;
+  }
+}
+
+
+void *Arena::allocate(size_t size) {
+  size = align(size);
+
+  if ((size_t)(end - ptr) < size) {
+    const size_t header = align(sizeof(Block));
+    // Oversized allocations get their own block
+    size_t blockSize = size + header < this->blockSize / 4 ?
+      this->blockSize : size + header;
+
+    Block *block;
+    if (pool.isSet() && blockSize == this->blockSize)
+      block = (Block *)pool->get();
+
+    else {
+      block = (Block *)malloc(blockSize);
+      if (!block) throw bad_alloc();
+      ArenaPool::getMemoryTag().allocated(blockSize);
+    }
+    allocated += blockSize;
+
+    block->next = blocks;
+    block->size = blockSize;
+    blocks = block;
+
+    char *data = (char *)block + header;
+    if (blockSize != this->blockSize) return data;
+
+    ptr = data;
+    end = (char *)block + blockSize;
+  }
+
+  void *data = ptr;
+  ptr += size;
+  return data;
+}
+
+
+ValuePtr Arena::createDict(const SmartPointer<KeyPool> &pool) const {
+  return make<InternedDict>(pool);
+}
+
+
+ValuePtr Arena::createNumberList() const {return make<NumberList>();}
+ValuePtr Arena::createDict() const {return make<Dict>();}
+ValuePtr Arena::createList() const {return make<List>();}
+ValuePtr Arena::create(double value) const {return make<Number>(value);}
+
+
+ValuePtr Arena::create(int64_t value) const {
+  return isSmall(value) ? Factory::create(value) : make<S64>(value);
+}
+
+
+ValuePtr Arena::create(uint64_t value) const {
+  return isSmall(value) ? Factory::create(value) : make<U64>(value);
+}
+
+
+ValuePtr Arena::create(const string &value) const {
+  return make<String>(value);
+}
+
+
+template <typename T, typename... Args>
+ValuePtr Arena::make(Args &&...args) const {
+  Arena *self = const_cast<Arena *>(this);
+  return adopt(new (self->allocate(sizeof(T))) T(forward<Args>(args)...));
+}
+
+
+ValuePtr Arena::adopt(Value *value) const {
+  Arena *self = const_cast<Arena *>(this);
+  Counter *counter =
+    new (self->allocate(sizeof(Counter))) Counter(self, value);
+
+  counter->setRefPtr(value);
+  self->count++;
+
+  return ValuePtr(value, counter);
+}
@@ -0,0 +1,112 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Factory.h"
+#include "ArenaPool.h"
+#include "KeyPool.h"
+
+#include <cbang/RefCounter.h>
+
+#include <utility>
+#include <cstddef>
+
+
+namespace cb {
+  namespace JSON {
+    /**
+     * A Factory which allocates Values from large blocks of memory.  Building
+     * a large document this way avoids separate heap allocations for every
+     * Value and its RefCounter.  The blocks are released together once the
+     * Arena and every Value allocated from it have been released.
+     *
+     * Values are still reference counted and can be used like any other
+     * Value, however, their reference counters are not thread safe.
+     *
+     * An Arena must be allocated with new and held by a SmartPointer.
+     * When created with an ArenaPool its blocks are recycled through the
+     * pool rather than returned to the heap.
+     */
+    class Arena : public RefCounted, public Factory {
+      class Counter;
+
+      struct Block {
+        Block *next;
+        size_t size;
+      };
+
+      size_t blockSize;
+      SmartPointer<ArenaPool> pool;
+      Block *blocks = 0;
+      char *ptr = 0;
+      char *end = 0;
+      size_t allocated = 0;
+      unsigned count = 0;
+
+    public:
+      static const size_t DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+      Arena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+      Arena(const SmartPointer<ArenaPool> &pool);
+      ~Arena();
+
+      size_t getBlockSize() const {return blockSize;}
+      const SmartPointer<ArenaPool> &getPool() const {return pool;}
+      /// @return The total number of bytes allocated from the heap.
+      size_t getAllocated() const {return allocated;}
+      /// @return The number of Values allocated from this Arena.
+      unsigned getCount() const {return count;}
+
+      void *allocate(size_t size);
+
+      /// @return An InternedDict whose keys are interned in @param pool
+      ValuePtr createDict(const SmartPointer<KeyPool> &pool) const;
+      /// @return A NumberList
+      ValuePtr createNumberList() const;
+
+      // From Factory
+      ValuePtr createDict() const;
+      ValuePtr createList() const;
+      ValuePtr create(double value) const;
+      ValuePtr create(int64_t value) const;
+      ValuePtr create(uint64_t value) const;
+      ValuePtr create(const std::string &value) const;
+      using Factory::create;
+
+    protected:
+      template <typename T, typename... Args>
+      ValuePtr make(Args &&...args) const;
+      ValuePtr adopt(Value *value) const;
+    };
+  }
+}
@@ -0,0 +1,108 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "ArenaPool.h"
+
+#include <cbang/Exception.h>
+#include <cbang/util/SmartLock.h>
+#include <cbang/util/MemoryAccounting.h>
+
+#include <new>
+#include <cstdlib>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+ArenaPool::ArenaPool(size_t blockSize, unsigned maxFree) :
+  blockSize(blockSize), maxFree(maxFree) {
+  if (blockSize < 1024) THROW("Arena block size too small: " << blockSize);
+}
+
+
+ArenaPool::~ArenaPool() {
+  for (unsigned i = 0; i < idle.size(); i++) {
+    free(idle[i]);
+    getMemoryTag().released(blockSize);
+  }
+}
+
+
+unsigned ArenaPool::getFreeCount() const {
+  SmartLock guard(&lock);
+  return idle.size();
+}
+
+
+void *ArenaPool::get() {
+  {
+    SmartLock guard(&lock);
+
+    if (!idle.empty()) {
+      void *block = idle.back();
+      idle.pop_back();
+      return block;
+    }
+
+    allocated++;
+  }
+
+  void *block = malloc(blockSize);
+  if (!block) throw bad_alloc();
+  getMemoryTag().allocated(blockSize);
+
+  return block;
+}
+
+
+void ArenaPool::put(void *block) {
+  {
+    SmartLock guard(&lock);
+
+    if (idle.size() < maxFree) {
+      idle.push_back(block);
+      return;
+    }
+
+    allocated--;
+  }
+
+  free(block);
+  getMemoryTag().released(blockSize);
+}
+
+
+cb::MemoryTag &ArenaPool::getMemoryTag() {
+  static MemoryTag &tag = MemoryAccounting::instance().getTag("json.arena");
+  return tag;
+}
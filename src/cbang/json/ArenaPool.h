@@ -0,0 +1,83 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+#include <cbang/os/SpinLock.h>
+
+#include <vector>
+#include <cstddef>
+
+
+namespace cb {
+  class MemoryTag;
+
+  namespace JSON {
+    /**
+     * A free list of equally sized memory blocks which are shared by
+     * short lived Arenas.  An Arena created with a pool takes its blocks
+     * from the pool and returns them when it is destroyed, so a steady
+     * stream of Arenas, such as one per request, rarely touches the heap.
+     *
+     * Blocks may be returned from any thread.
+     */
+    class ArenaPool : public RefCounted {
+      size_t blockSize;
+      unsigned maxFree;
+
+      SpinLock lock;
+      std::vector<void *> idle;
+      unsigned allocated = 0;
+
+    public:
+      static const size_t DEFAULT_BLOCK_SIZE = 16 * 1024;
+
+      /// @param maxFree The maximum number of idle blocks to keep.
+      ArenaPool(size_t blockSize = DEFAULT_BLOCK_SIZE, unsigned maxFree = 256);
+      ~ArenaPool();
+
+      size_t getBlockSize() const {return blockSize;}
+      unsigned getMaxFree() const {return maxFree;}
+      /// @return The number of idle blocks.
+      unsigned getFreeCount() const;
+      /// @return The number of blocks allocated from the heap.
+      unsigned getAllocatedCount() const {return allocated;}
+
+      void *get();
+      void put(void *block);
+
+      /// Heap blocks of Arenas and ArenaPools are charged to "json.arena"
+      static MemoryTag &getMemoryTag();
+    };
+  }
+}
@@ -0,0 +1,330 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "BufferReader.h"
+#include "Builder.h"
+#include "Sink.h"
+
+#include <cbang/String.h>
+#include <cbang/Errors.h>
+#include <cbang/FileLocation.h>
+#include <cbang/util/ByteScan.h>
+
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+
+#include <errno.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+BufferReader::BufferReader(const char *data, size_t length,
+                           const string &name) :
+  start(data), ptr(data), end(data + length), name(name) {}
+
+
+BufferReader::BufferReader(const string &s, const string &name) :
+  BufferReader(s.data(), s.length(), name) {}
+
+
+void BufferReader::parse(Sink &sink) {
+  switch (next()) {
+  case 'N': case 'n':
+    parseNull();
+    return sink.writeNull();
+
+  case 'T': case 't': case 'F': case 'f':
+    return sink.writeBoolean(parseBoolean());
+
+  case '-': case '.':
+  case '0': case '1': case '2': case '3': case '4':
+  case '5': case '6': case '7': case '8': case '9':
+    parseNumber(sink);
+    return;
+
+  case '"':
+    return sink.write(parseString());
+
+  case '[':
+    sink.beginList();
+    parseList(sink);
+    sink.endList();
+    return;
+
+  case '{':
+    sink.beginDict();
+    parseDict(sink);
+    sink.endDict();
+    return;
+
+  default: match("NnTtFf-.0123456789\"[{");
+  }
+}
+
+
+ValuePtr BufferReader::parse() {
+  Builder builder;
+  parse(builder);
+  return builder.getRoot();
+}
+
+
+ValuePtr BufferReader::parse(const char *data, size_t length) {
+  return BufferReader(data, length).parse();
+}
+
+
+void BufferReader::parse(const char *data, size_t length, Sink &sink) {
+  BufferReader(data, length).parse(sink);
+}
+
+
+unsigned BufferReader::getLine() const {
+  unsigned line = 0;
+  for (const char *p = start; p < ptr; p++)
+    if (*p == '\n') line++;
+  return line;
+}
+
+
+unsigned BufferReader::getColumn() const {
+  unsigned column = 0;
+  for (const char *p = ptr; start < p && p[-1] != '\n'; p--)
+    if (p[-1] != '\r') column++;
+  return column;
+}
+
+
+char BufferReader::next() {
+  while (ptr < end)
+    switch (*ptr) {
+    case '\n': case '\r': case '\t': case ' ':
+      ptr = skipSpaces(ptr + 1, end);
+      break;
+
+    case '#': {
+      const char *eol = (const char *)memchr(ptr, '\n', end - ptr);
+      ptr = eol ? eol : end;
+      break;
+    }
+
+    default: return *ptr;
+    }
+
+  error("Unexpected end of expression");
+  throw "Unreachable";
+}
+
+
+bool BufferReader::tryMatch(char c) {
+  if (c == next()) {
+    ptr++;
+    return true;
+  }
+
+  return false;
+}
+
+
+char BufferReader::match(const char *chars) {
+  char x = next();
+
+  for (int i = 0; chars[i]; i++)
+    if (x == chars[i]) {
+      ptr++;
+      return x;
+    }
+
+  error(SSTR("Expected one of '" << cb::String::escapeC(chars)
+             << "' but found '" << cb::String::escapeC(string(1, x)) << '\''));
+  throw "Unreachable";
+}
+
+
+string BufferReader::parseKeyword() {
+  const char *s = ptr;
+  while (ptr < end && isalpha(*ptr)) ptr++;
+  return string(s, ptr - s);
+}
+
+
+void BufferReader::parseNull() {
+  string value = cb::String::toLower(parseKeyword());
+
+  if (value != "none" && value != "null")
+    error(SSTR("Expected keyword 'None' or 'null' but found '" << value
+               << '\''));
+}
+
+
+bool BufferReader::parseBoolean() {
+  string value = cb::String::toLower(parseKeyword());
+
+  if (value == "true") return true;
+  else if (value == "false") return false;
+
+  error(SSTR("Expected keyword 'true' or 'false' but found '" << value
+             << '\''));
+  throw "Unreachable";
+}
+
+
+void BufferReader::parseNumber(Sink &sink) {
+  const char *s = ptr;
+  bool negative = false;
+  bool decimal = false;
+
+  if (*ptr == '-') {
+    ptr++;
+    negative = true;
+  }
+
+  if (ptr < end && *ptr == '0') ptr++;
+  else while (ptr < end && isdigit(*ptr)) ptr++;
+
+  if (ptr < end && *ptr == '.') {
+    decimal = true;
+    ptr++;
+    while (ptr < end && isdigit(*ptr)) ptr++;
+  }
+
+  if (ptr < end && (*ptr == 'e' || *ptr == 'E')) {
+    decimal = true;
+    ptr++;
+    if (ptr < end && (*ptr == '+' || *ptr == '-')) ptr++;
+    while (ptr < end && isdigit(*ptr)) ptr++;
+  }
+
+  // The buffer is not null terminated
+  const string value(s, ptr - s);
+  const char *cstr = value.c_str();
+  char *stop;
+  errno = 0;
+
+  if (!decimal && negative) {
+    long long int v = strtoll(cstr, &stop, 0);
+
+    if (!errno && (size_t)(stop - cstr) == value.length()) {
+      sink.write((int64_t)v);
+      return;
+    }
+
+  } else if (!decimal) {
+    long long unsigned v = strtoull(cstr, &stop, 0);
+
+    if (!errno && (size_t)(stop - cstr) == value.length()) {
+      sink.write((uint64_t)v);
+      return;
+    }
+  }
+
+  double v = strtod(cstr, &stop);
+  if (errno || (size_t)(stop - cstr) != value.length())
+    error(SSTR("Invalid JSON number '" << value << "'"));
+  sink.write(v);
+}
+
+
+string BufferReader::parseString() {
+  match("\"");
+
+  const char *s = ptr;
+  bool escaped = false;
+
+  while (true) {
+    ptr = findQuoteOrEscape(ptr, end);
+
+    if (ptr == end) break; // Unterminated, like Reader accept it
+
+    if (*ptr == '\\') {
+      escaped = true;
+      ptr += 2; // Skip escaped character
+      if (end < ptr) ptr = end;
+      continue;
+    }
+
+    break; // Found closing quote
+  }
+
+  string value(s, ptr - s);
+  if (ptr < end) ptr++; // Closing quote
+
+  return escaped ? cb::String::unescapeC(value) : value;
+}
+
+
+void BufferReader::parseList(Sink &sink) {
+  match("[");
+
+  while (true) {
+    if (tryMatch(']')) return; // End or trailing comma
+
+    sink.beginAppend();
+    parse(sink);
+
+    if (match(",]") == ']') return; // Continuation or end
+  }
+}
+
+
+void BufferReader::parseDict(Sink &sink) {
+  match("{");
+
+  while (true) {
+    if (tryMatch('}')) return; // Empty or trailing comma
+
+    string key = parseString();
+    match(":");
+    sink.beginInsert(key);
+    parse(sink);
+
+    if (match(",}") == '}') return; // Continuation or end
+  }
+}
+
+
+void BufferReader::error(const string &msg) const {
+  throw ParseError(msg, FileLocation(name, getLine(), getColumn()));
+}
+
+
+const char *BufferReader::findQuoteOrEscape(const char *p, const char *end) {
+  return scanForEither(p, end, '"', '\\');
+}
+
+
+const char *BufferReader::skipSpaces(const char *p, const char *end) {
+  return scanPast(p, end, ' '); // Indented JSON has long runs of spaces
+}
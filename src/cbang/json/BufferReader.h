@@ -0,0 +1,93 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Value.h"
+
+#include <string>
+
+
+namespace cb {
+  namespace JSON {
+    class Sink;
+
+    /**
+     * A JSON reader for data already in memory, such as a std::string or a
+     * pulled up Event::Buffer.  It accepts the same syntax and makes the same
+     * Sink calls as Reader but scans the buffer directly, using SSE2 where
+     * available to skip over string contents and white space.  Line and
+     * column are only computed when reporting an error.
+     *
+     * The data must remain valid while parsing.
+     */
+    class BufferReader {
+      const char *start;
+      const char *ptr;
+      const char *end;
+      std::string name;
+
+    public:
+      BufferReader(const char *data, size_t length,
+                   const std::string &name = std::string());
+      BufferReader(const std::string &s,
+                   const std::string &name = std::string());
+
+      void parse(Sink &sink);
+      ValuePtr parse();
+      static ValuePtr parse(const char *data, size_t length);
+      static void parse(const char *data, size_t length, Sink &sink);
+
+      size_t getOffset() const {return ptr - start;}
+      unsigned getLine() const;
+      unsigned getColumn() const;
+
+    protected:
+      char next();
+      bool tryMatch(char c);
+      char match(const char *chars);
+
+      std::string parseKeyword();
+      void parseNull();
+      bool parseBoolean();
+      void parseNumber(Sink &sink);
+      std::string parseString();
+      void parseList(Sink &sink);
+      void parseDict(Sink &sink);
+
+      void error(const std::string &msg) const;
+
+      static const char *findQuoteOrEscape(const char *p, const char *end);
+      static const char *skipSpaces(const char *p, const char *end);
+    };
+  }
+}
@@ -67,6 +67,12 @@ namespace cb {
         flush();
         return toString();
       }
+
+    protected:
+      // From Writer, append directly rather than through the stream
+      void put(char c) {buffer.push_back(c);}
+      void put(const char *s, size_t n) {buffer.insert(buffer.end(), s, s + n);}
+      using Writer::put;
     };
   }
 }
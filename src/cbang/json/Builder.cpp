@@ -43,6 +43,12 @@ Builder::Builder(const ValuePtr &root) : appendNext(false) {
 }
 
 
+Builder::Builder(const SmartPointer<Arena> &arena, const ValuePtr &root) :
+  Builder(root) {
+  this->arena = arena;
+}
+
+
 ValuePtr Builder::build(function<void (Sink &sink)> cb) {
   Builder builder;
   cb(builder);
@@ -50,15 +56,81 @@ ValuePtr Builder::build(function<void (Sink &sink)> cb) {
 }
 
 
+ValuePtr Builder::buildInArena(function<void (Sink &sink)> cb,
+                               size_t blockSize) {
+  Builder builder(new Arena(blockSize));
+  cb(builder);
+  return builder.getRoot();
+}
+
+
 ValuePtr Builder::getRoot() const {return stack.empty() ? 0 : stack.front();}
 
+ValuePtr Builder::createDict() const {
+  if (keyPool.isSet())
+    return arena.isNull() ? new InternedDict(keyPool) :
+      arena->createDict(keyPool);
+
+  return arena.isNull() ? Factory::createDict() : arena->createDict();
+}
+
+
+ValuePtr Builder::createList() const {
+  if (numberLists)
+    return arena.isNull() ? new NumberList : arena->createNumberList();
+
+  return arena.isNull() ? Factory::createList() : arena->createList();
+}
+
+
+ValuePtr Builder::create(double value) const {
+  return arena.isNull() ? Factory::create(value) : arena->create(value);
+}
+
+
+ValuePtr Builder::create(int64_t value) const {
+  return arena.isNull() ? Factory::create(value) : arena->create(value);
+}
+
+
+ValuePtr Builder::create(uint64_t value) const {
+  return arena.isNull() ? Factory::create(value) : arena->create(value);
+}
+
+
+ValuePtr Builder::create(const string &value) const {
+  return arena.isNull() ? Factory::create(value) : arena->create(value);
+}
+
+
 void Builder::writeNull() {add(createNull());}
 void Builder::writeBoolean(bool value) {add(createBoolean(value));}
-void Builder::write(double value) {add(create(value));}
-void Builder::write(uint64_t value) {add(create(value));}
-void Builder::write(int64_t value) {add(create(value));}
+
+
+void Builder::write(double value) {
+  if (!appendNumber(value)) add(create(value));
+}
+
+
+void Builder::write(uint64_t value) {
+  if (!appendNumber(value)) add(create(value));
+}
+
+
+void Builder::write(int64_t value) {
+  if (!appendNumber(value)) add(create(value));
+}
+
+
 void Builder::write(const string &value) {add(create(value));}
 
+
+void Builder::writeRef(const ValuePtr &value) {
+  if (stack.empty()) stack.push_back(value);
+  else link(value);
+}
+
+
 void Builder::beginList(bool simple) {add(createList());}
 
 
@@ -101,17 +173,33 @@ void Builder::endDict() {
 }
 
 
+template <typename T>
+bool Builder::appendNumber(T value) {
+  if (!numberLists || !appendNext || stack.empty()) return false;
+
+  NumberList *list = dynamic_cast<NumberList *>(stack.back().get());
+  if (!list || !list->tryAppend(value)) return false;
+
+  appendNext = false;
+  return true;
+}
+
+
 void Builder::add(const ValuePtr &value) {
+  if (!stack.empty()) link(value);
+  if (stack.empty() || value->isList() || value->isDict())
+    stack.push_back(value);
+}
+
+
+void Builder::link(const ValuePtr &value) {
   if (shouldAppend()) stack.back()->append(value);
 
   else if (shouldInsert()) {
     stack.back()->insert(nextKey, value);
     nextKey.clear();
 
-  } else if (!stack.empty()) THROW("Cannot add " << value->getType());
-
-  if (stack.empty() || value->isList() || value->isDict())
-    stack.push_back(value);
+  } else THROW("Cannot add " << value->getType());
 }
 
 
@@ -35,6 +35,8 @@
 #include "Sink.h"
 #include "Value.h"
 #include "Factory.h"
+#include "Arena.h"
+#include "KeyPool.h"
 
 #include <vector>
 #include <functional>
@@ -46,15 +48,50 @@ namespace cb {
       std::vector<ValuePtr> stack;
       bool appendNext;
       std::string nextKey;
+      SmartPointer<Arena> arena;
+      SmartPointer<KeyPool> keyPool;
+      bool numberLists = false;
 
     public:
       Builder(const ValuePtr &root = 0);
+      Builder(const SmartPointer<Arena> &arena, const ValuePtr &root = 0);
 
       static ValuePtr build(std::function<void (Sink &sink)> cb);
+      static ValuePtr buildInArena(std::function<void (Sink &sink)> cb,
+                                   size_t blockSize =
+                                   Arena::DEFAULT_BLOCK_SIZE);
+
+      /// When set, new Values are allocated from the Arena
+      void setArena(const SmartPointer<Arena> &arena) {this->arena = arena;}
+      const SmartPointer<Arena> &getArena() const {return arena;}
+
+      /**
+       * When set, new dictionaries are InternedDicts which share the keys
+       * in @param pool.  Use a new KeyPool per document, or
+       * KeyPool::getGlobal() when many documents repeat the same keys.
+       */
+      void setKeyPool(const SmartPointer<KeyPool> &pool) {keyPool = pool;}
+      const SmartPointer<KeyPool> &getKeyPool() const {return keyPool;}
+
+      /**
+       * When set, new lists are NumberLists which store numbers appended
+       * through this Builder without creating a Value for each.
+       */
+      void setNumberLists(bool x) {numberLists = x;}
+      bool getNumberLists() const {return numberLists;}
 
       ValuePtr getRoot() const;
       void clear() {stack.clear();}
 
+      // From Factory
+      ValuePtr createDict() const;
+      ValuePtr createList() const;
+      ValuePtr create(double value) const;
+      ValuePtr create(int64_t value) const;
+      ValuePtr create(uint64_t value) const;
+      ValuePtr create(const std::string &value) const;
+      using Factory::create;
+
       // From Sink
       void writeNull();
       void writeBoolean(bool value);
@@ -63,6 +100,7 @@ namespace cb {
       void write(int64_t value);
       void write(const std::string &value);
       using Sink::write;
+      void writeRef(const ValuePtr &value);
       void beginList(bool simple = false);
       void beginAppend();
       void endList();
@@ -72,7 +110,9 @@ namespace cb {
       void endDict();
 
     protected:
+      template <typename T> bool appendNumber(T value);
       void add(const ValuePtr &value);
+      void link(const ValuePtr &value);
       void assertNotPending();
       bool shouldAppend();
       bool shouldInsert() {return !nextKey.empty();}
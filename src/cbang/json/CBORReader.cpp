@@ -0,0 +1,286 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "CBORReader.h"
+#include "Builder.h"
+#include "Sink.h"
+
+#include <cbang/Exception.h>
+#include <cbang/SStream.h>
+
+#include <cstring>
+#include <cmath>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+namespace {
+  const uint8_t CBOR_INDEFINITE = 31;
+  const uint8_t CBOR_BREAK      = 0xff;
+}
+
+
+CBORReader::CBORReader(const char *data, size_t length) :
+  start((const uint8_t *)data), ptr(start), end(start + length) {}
+
+
+CBORReader::CBORReader(const string &s) : CBORReader(s.data(), s.length()) {}
+
+
+bool CBORReader::isDict() {
+  skipTags();
+  return ptr < end && *ptr >> 5 == 5;
+}
+
+
+void CBORReader::parse(Sink &sink) {
+  skipTags();
+
+  uint8_t byte = next();
+  uint8_t major = byte >> 5;
+  uint8_t info = byte & 0x1f;
+
+  switch (major) {
+  case 0: return sink.write(readArg(info));
+
+  case 1: {
+    uint64_t n = readArg(info);
+    if (n >> 63) return sink.write(-1.0 - (double)n);
+    return sink.write((int64_t)~n); // -1 - n
+  }
+
+  case 2: case 3: return sink.write(readString(major, info));
+
+  case 4:
+    sink.beginList();
+    parseList(sink, info);
+    return sink.endList();
+
+  case 5:
+    sink.beginDict();
+    parseDict(sink, info);
+    return sink.endDict();
+
+  case 7:
+    switch (info) {
+    case 20: return sink.writeBoolean(false);
+    case 21: return sink.writeBoolean(true);
+    case 22: case 23: return sink.writeNull();
+    case 25: return sink.write(readHalf());
+
+    case 26: {
+      uint32_t bits = readUInt(4);
+      float f;
+      memcpy(&f, &bits, 4);
+      return sink.write((double)f);
+    }
+
+    case 27: {
+      uint64_t bits = readUInt(8);
+      double d;
+      memcpy(&d, &bits, 8);
+      return sink.write(d);
+    }
+
+    case CBOR_INDEFINITE: error("Unexpected break");
+    }
+    break;
+  }
+
+  error(SSTR("Unsupported CBOR item 0x" << hex << (unsigned)byte));
+}
+
+
+ValuePtr CBORReader::parse() {
+  Builder builder;
+  parse(builder);
+  return builder.getRoot();
+}
+
+
+void CBORReader::parseDict(Sink &sink) {
+  skipTags();
+
+  uint8_t byte = next();
+  if (byte >> 5 != 5) error("Expected CBOR map");
+
+  parseDict(sink, byte & 0x1f);
+}
+
+
+ValuePtr CBORReader::parse(const char *data, size_t length) {
+  CBORReader reader(data, length);
+  ValuePtr value = reader.parse();
+  if (!reader.atEnd()) reader.error("Trailing data");
+  return value;
+}
+
+
+ValuePtr CBORReader::parseString(const string &s) {
+  return parse(s.data(), s.length());
+}
+
+
+void CBORReader::parse(const char *data, size_t length, Sink &sink) {
+  CBORReader reader(data, length);
+  reader.parse(sink);
+  if (!reader.atEnd()) reader.error("Trailing data");
+}
+
+
+uint8_t CBORReader::next() {
+  if (ptr == end) error("Unexpected end of CBOR data");
+  return *ptr++;
+}
+
+
+uint64_t CBORReader::readArg(uint8_t info) {
+  if (info < 24) return info;
+
+  switch (info) {
+  case 24: return readUInt(1);
+  case 25: return readUInt(2);
+  case 26: return readUInt(4);
+  case 27: return readUInt(8);
+  }
+
+  error(SSTR("Invalid CBOR argument " << (unsigned)info));
+  return 0;
+}
+
+
+uint64_t CBORReader::readUInt(unsigned bytes) {
+  if ((size_t)(end - ptr) < bytes) error("Unexpected end of CBOR data");
+
+  uint64_t value = 0;
+  for (unsigned i = 0; i < bytes; i++) value = value << 8 | *ptr++;
+
+  return value;
+}
+
+
+double CBORReader::readHalf() {
+  unsigned half = readUInt(2);
+  unsigned exp = (half >> 10) & 0x1f;
+  unsigned mant = half & 0x3ff;
+  double value;
+
+  if (!exp) value = ldexp(mant, -24);
+  else if (exp != 31) value = ldexp(mant + 1024, exp - 25);
+  else value = mant ? NAN : INFINITY;
+
+  return half & 0x8000 ? -value : value;
+}
+
+
+bool CBORReader::isBreak() {
+  if (ptr == end) error("Unexpected end of CBOR data");
+  if (*ptr != CBOR_BREAK) return false;
+  ptr++;
+  return true;
+}
+
+
+string CBORReader::readString(uint8_t major, uint8_t info) {
+  if (info == CBOR_INDEFINITE) {
+    string s;
+
+    // Concatenate definite length chunks of the same major type
+    while (!isBreak()) {
+      uint8_t byte = next();
+      if (byte >> 5 != major || (byte & 0x1f) == CBOR_INDEFINITE)
+        error("Invalid CBOR string chunk");
+      s += readString(major, byte & 0x1f);
+    }
+
+    return s;
+  }
+
+  uint64_t length = readArg(info);
+  if ((uint64_t)(end - ptr) < length) error("Unexpected end of CBOR data");
+
+  string s((const char *)ptr, length);
+  ptr += length;
+  return s;
+}
+
+
+void CBORReader::parseList(Sink &sink, uint8_t info) {
+  if (MAX_DEPTH < ++depth) error("CBOR nested too deeply");
+
+  if (info == CBOR_INDEFINITE)
+    while (!isBreak()) {
+      sink.beginAppend();
+      parse(sink);
+    }
+
+  else
+    for (uint64_t n = readArg(info); n; n--) {
+      sink.beginAppend();
+      parse(sink);
+    }
+
+  depth--;
+}
+
+
+void CBORReader::parseDict(Sink &sink, uint8_t info) {
+  if (MAX_DEPTH < ++depth) error("CBOR nested too deeply");
+
+  bool indefinite = info == CBOR_INDEFINITE;
+  uint64_t n = indefinite ? 0 : readArg(info);
+
+  while (indefinite ? !isBreak() : n--) {
+    skipTags();
+
+    uint8_t byte = next();
+    uint8_t major = byte >> 5;
+    if (major != 2 && major != 3) error("CBOR map keys must be strings");
+
+    sink.beginInsert(readString(major, byte & 0x1f));
+    parse(sink);
+  }
+
+  depth--;
+}
+
+
+void CBORReader::skipTags() {
+  while (ptr < end && *ptr >> 5 == 6) readArg(next() & 0x1f);
+}
+
+
+void CBORReader::error(const string &msg) const {
+  THROW(msg << " at offset " << getOffset());
+}
@@ -0,0 +1,88 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Value.h"
+
+#include <string>
+
+
+namespace cb {
+  namespace JSON {
+    class Sink;
+
+    /**
+     * Reads CBOR (RFC 8949) and makes the same Sink calls as Reader.  Text
+     * and byte strings are both passed on as strings, tags are ignored and
+     * undefined is read as null.  Map keys must be strings.
+     */
+    class CBORReader {
+      const uint8_t *start;
+      const uint8_t *ptr;
+      const uint8_t *end;
+      unsigned depth = 0;
+
+    public:
+      static const unsigned MAX_DEPTH = 1024;
+
+      CBORReader(const char *data, size_t length);
+      CBORReader(const std::string &s);
+
+      bool atEnd() const {return ptr == end;}
+      size_t getOffset() const {return ptr - start;}
+
+      bool isDict();
+
+      void parse(Sink &sink);
+      ValuePtr parse();
+      void parseDict(Sink &sink);
+
+      static ValuePtr parse(const char *data, size_t length);
+      static ValuePtr parseString(const std::string &s);
+      static void parse(const char *data, size_t length, Sink &sink);
+
+    protected:
+      uint8_t next();
+      uint64_t readArg(uint8_t info);
+      uint64_t readUInt(unsigned bytes);
+      double readHalf();
+      bool isBreak();
+      std::string readString(uint8_t major, uint8_t info);
+      void parseList(Sink &sink, uint8_t info);
+      void parseDict(Sink &sink, uint8_t info);
+      void skipTags();
+
+      void error(const std::string &msg) const;
+    };
+  }
+}
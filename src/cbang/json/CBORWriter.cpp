@@ -0,0 +1,184 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "CBORWriter.h"
+
+#include <cstring>
+
+using namespace std;
+using namespace cb::JSON;
+
+
+namespace {
+  enum {
+    CBOR_UINT     = 0,
+    CBOR_NEGINT   = 1,
+    CBOR_TEXT     = 3,
+    CBOR_ARRAY    = 4,
+    CBOR_MAP      = 5,
+    CBOR_SIMPLE   = 7,
+  };
+
+  const uint8_t CBOR_FALSE      = 0xf4;
+  const uint8_t CBOR_TRUE       = 0xf5;
+  const uint8_t CBOR_NULL       = 0xf6;
+  const uint8_t CBOR_FLOAT32    = 0xfa;
+  const uint8_t CBOR_FLOAT64    = 0xfb;
+  const uint8_t CBOR_INDEFINITE = 0x1f;
+  const uint8_t CBOR_BREAK      = 0xff;
+}
+
+
+void CBORWriter::close() {
+  NullSink::close();
+  stream.flush();
+}
+
+
+void CBORWriter::reset() {
+  NullSink::reset();
+  stream.flush();
+}
+
+
+void CBORWriter::writeNull() {
+  NullSink::writeNull();
+  stream.put(CBOR_NULL);
+}
+
+
+void CBORWriter::writeBoolean(bool value) {
+  NullSink::writeBoolean(value);
+  stream.put(value ? CBOR_TRUE : CBOR_FALSE);
+}
+
+
+void CBORWriter::write(double value) {
+  NullSink::write(value);
+
+  uint8_t buf[9];
+  unsigned length;
+  float f = (float)value;
+
+  if ((double)f == value || value != value) {
+    uint32_t bits;
+    memcpy(&bits, &f, 4);
+
+    buf[0] = CBOR_FLOAT32;
+    for (int i = 0; i < 4; i++) buf[4 - i] = bits >> (8 * i);
+    length = 5;
+
+  } else {
+    uint64_t bits;
+    memcpy(&bits, &value, 8);
+
+    buf[0] = CBOR_FLOAT64;
+    for (int i = 0; i < 8; i++) buf[8 - i] = bits >> (8 * i);
+    length = 9;
+  }
+
+  stream.write((const char *)buf, length);
+}
+
+
+void CBORWriter::write(uint64_t value) {
+  NullSink::write(value);
+  writeHead(CBOR_UINT, value);
+}
+
+
+void CBORWriter::write(int64_t value) {
+  NullSink::write(value);
+  if (value < 0) writeHead(CBOR_NEGINT, ~(uint64_t)value); // -1 - value
+  else writeHead(CBOR_UINT, value);
+}
+
+
+void CBORWriter::write(const string &value) {
+  NullSink::write(value);
+  writeString(value);
+}
+
+
+void CBORWriter::beginList(bool simple) {
+  NullSink::beginList(simple);
+  stream.put((CBOR_ARRAY << 5) | CBOR_INDEFINITE);
+}
+
+
+void CBORWriter::endList() {
+  NullSink::endList();
+  stream.put(CBOR_BREAK);
+}
+
+
+void CBORWriter::beginDict(bool simple) {
+  NullSink::beginDict(simple);
+  stream.put((CBOR_MAP << 5) | CBOR_INDEFINITE);
+}
+
+
+void CBORWriter::beginInsert(const string &key) {
+  NullSink::beginInsert(key);
+  writeString(key);
+}
+
+
+void CBORWriter::endDict() {
+  NullSink::endDict();
+  stream.put(CBOR_BREAK);
+}
+
+
+void CBORWriter::writeHead(uint8_t major, uint64_t value) {
+  uint8_t buf[9];
+  unsigned bytes;
+
+  major <<= 5;
+
+  if (value < 24) {buf[0] = major | value; bytes = 0;}
+  else if (value <= 0xff) {buf[0] = major | 24; bytes = 1;}
+  else if (value <= 0xffff) {buf[0] = major | 25; bytes = 2;}
+  else if (value <= 0xffffffff) {buf[0] = major | 26; bytes = 4;}
+  else {buf[0] = major | 27; bytes = 8;}
+
+  for (unsigned i = 0; i < bytes; i++)
+    buf[bytes - i] = value >> (8 * i);
+
+  stream.write((const char *)buf, bytes + 1);
+}
+
+
+void CBORWriter::writeString(const string &s) {
+  writeHead(CBOR_TEXT, s.length());
+  stream.write(s.data(), s.length());
+}
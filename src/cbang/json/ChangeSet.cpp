@@ -0,0 +1,213 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "ChangeSet.h"
+#include "Value.h"
+#include "Sink.h"
+
+#include <cbang/String.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+namespace {
+  bool isContainer(const Value *value) {
+    return value && (value->isDict() || value->isList());
+  }
+}
+
+
+const char *Change::getOpString() const {
+  switch (op) {
+  case CHANGE_ADD:     return "add";
+  case CHANGE_REPLACE: return "replace";
+  case CHANGE_REMOVE:  return "remove";
+  case CHANGE_CLEAR:   return "replace";
+  }
+
+  return "invalid";
+}
+
+
+string Change::getPointer() const {
+  string pointer;
+
+  for (auto it = path.begin(); it != path.end(); it++) {
+    string key = (*it)->asString();
+    pointer += '/';
+
+    for (unsigned i = 0; i < key.length(); i++)
+      switch (key[i]) {
+      case '~': pointer += "~0"; break;
+      case '/': pointer += "~1"; break;
+      default: pointer += key[i]; break;
+      }
+  }
+
+  return pointer;
+}
+
+
+void Change::write(Sink &sink) const {
+  sink.beginDict();
+  sink.insert("op", getOpString());
+  sink.insert("path", getPointer());
+  if (op != CHANGE_REMOVE) {
+    sink.beginInsert("value");
+    value->write(sink);
+  }
+  sink.endDict();
+}
+
+
+void ChangeSet::add(const Change &change) {
+  const Value *container = change.chain.back();
+  bool clear = change.op == Change::CHANGE_CLEAR;
+  const Value *old = clear ? container : change.old.get();
+
+  // Changes inside a replaced or removed subtree no longer matter
+  if (isContainer(old)) {
+    auto range = byContainer.equal_range(old);
+    for (auto it = range.first; it != range.second; it++) drop(it->second);
+    byContainer.erase(old);
+  }
+
+  // Included in an added or replaced subtree, reported as it is at commit
+  for (unsigned i = 0; i < change.chain.size(); i++)
+    if (byValue.find(change.chain[i]) != byValue.end()) return;
+
+  string slot;
+  if (!clear) {
+    slot = getSlot(change);
+
+    // Coalesce repeated writes of one location
+    auto it = bySlot.find(slot);
+    if (it != bySlot.end() && entries[it->second].live) {
+      unsigned index = it->second;
+      Change &last = entries[index].change;
+      bool isList = container->isList();
+
+      if (change.op == Change::CHANGE_REMOVE) {
+        // List removals shift later indices so they cannot be merged
+        if (!isList) {
+          if (last.op == Change::CHANGE_ADD) drop(index);
+          else {
+            byValue.erase(last.value.get());
+            last.op = Change::CHANGE_REMOVE;
+            last.value.release();
+          }
+
+          return;
+        }
+
+      } else if (last.op != Change::CHANGE_REMOVE ||
+                 change.op == Change::CHANGE_ADD) {
+        if (last.op == Change::CHANGE_REMOVE)
+          last.op = Change::CHANGE_REPLACE;
+
+        byValue.erase(last.value.get());
+        last.value = change.value;
+        if (isContainer(change.value.get()))
+          byValue[change.value.get()] = index;
+
+        return;
+      }
+    }
+  }
+
+  // Record
+  unsigned index = entries.size();
+  entries.push_back(Entry(change));
+  count++;
+
+  for (unsigned i = 0; i < change.chain.size(); i++) {
+    byContainer.insert(make_pair(change.chain[i], index));
+    if (i) hold(change.chain[i]);
+  }
+
+  if (isContainer(change.value.get())) byValue[change.value.get()] = index;
+
+  if (container->isList() && change.op != Change::CHANGE_REPLACE) {
+    epochs[container]++;
+    slot = getSlot(change);
+  }
+
+  if (!clear) bySlot[slot] = index;
+}
+
+
+void ChangeSet::visit(visitor_t visitor) const {
+  for (unsigned i = 0; i < entries.size(); i++)
+    if (entries[i].live) visitor(entries[i].change);
+}
+
+
+void ChangeSet::write(Sink &sink) const {
+  sink.beginList();
+  for (unsigned i = 0; i < entries.size(); i++)
+    if (entries[i].live) {
+      sink.beginAppend();
+      entries[i].change.write(sink);
+    }
+  sink.endList();
+}
+
+
+string ChangeSet::getSlot(const Change &change) {
+  const Value *container = change.chain.back();
+  string slot = String::printf("%p/", container);
+
+  if (container->isList()) slot += String(epochs[container]) + "/";
+  if (!change.path.empty()) slot += change.path.back()->asString();
+
+  return slot;
+}
+
+
+void ChangeSet::hold(const Value *value) {
+  if (refs.find(value) == refs.end())
+    refs[value] = const_cast<Value *>(value);
+}
+
+
+void ChangeSet::drop(unsigned index) {
+  Entry &entry = entries[index];
+  if (!entry.live) return;
+
+  entry.live = false;
+  count--;
+
+  auto it = byValue.find(entry.change.value.get());
+  if (it != byValue.end() && it->second == index) byValue.erase(it);
+}
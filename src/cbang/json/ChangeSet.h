@@ -0,0 +1,139 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Serializable.h"
+
+#include <cbang/SmartPointer.h>
+
+#include <list>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <functional>
+
+
+namespace cb {
+  namespace JSON {
+    class Value;
+    typedef SmartPointer<Value> ValuePtr;
+
+
+    /// One mutation of an Observable tree, see Observable::notify()
+    struct Change {
+      typedef enum {
+        CHANGE_ADD,
+        CHANGE_REPLACE,
+        CHANGE_REMOVE,
+        CHANGE_CLEAR,
+      } op_t;
+
+      op_t op;
+      /// Keys and list indices from the root, as String and Number Values
+      std::list<ValuePtr> path;
+      /// The new value, null when removed.  When cleared, the container.
+      ValuePtr value;
+      /// The replaced or removed value, if any
+      ValuePtr old;
+      /// The containers from the root down to the one which changed
+      std::vector<Value *> chain;
+
+      Change(op_t op, const ValuePtr &value, const ValuePtr &old) :
+        op(op), value(value), old(old) {}
+
+      const char *getOpString() const;
+      /// @return The RFC 6901 JSON Pointer of the changed location
+      std::string getPointer() const;
+      /// Write as an RFC 6902 JSON Patch operation
+      void write(Sink &sink) const;
+    };
+
+
+    /**
+     * The changes made to an Observable tree during a batch, coalesced so
+     * that each location is reported at most once where that preserves
+     * the result.  A change inside a subtree which is later replaced or
+     * removed is dropped, a change inside a subtree added or replaced
+     * earlier in the batch is dropped because that change reports the
+     * subtree as it is at commit, and repeated writes of one location
+     * become a single write of the final value.  Reported values are the
+     * live values in the tree.
+     *
+     * Written as JSON this is an RFC 6902 JSON Patch which transforms the
+     * tree as it was before the batch into its state at commit.
+     */
+    class ChangeSet : public Serializable {
+      struct Entry {
+        Change change;
+        bool live;
+
+        Entry(const Change &change) : change(change), live(true) {}
+      };
+
+      std::vector<Entry> entries;
+      unsigned count = 0;
+
+      // Holds containers in the chains of recorded changes so their
+      // addresses are not reused while the batch is open
+      std::unordered_map<const Value *, ValuePtr> refs;
+
+      // Entries by the containers they were made within
+      std::unordered_multimap<const Value *, unsigned> byContainer;
+      // Live entries by the container they added or replaced
+      std::unordered_map<const Value *, unsigned> byValue;
+      // The last entry which wrote each location.  List locations include
+      // a count of the list's appends and removals so they stop matching
+      // once later indices have shifted.
+      std::unordered_map<std::string, unsigned> bySlot;
+      std::unordered_map<const Value *, unsigned> epochs;
+
+    public:
+      bool empty() const {return !count;}
+      /// @return The number of changes after coalescing
+      unsigned size() const {return count;}
+
+      void add(const Change &change);
+
+      typedef std::function<void (const Change &)> visitor_t;
+      void visit(visitor_t visitor) const;
+
+      // From Serializable
+      void write(Sink &sink) const;
+
+    protected:
+      std::string getSlot(const Change &change);
+      void hold(const Value *value);
+      void drop(unsigned index);
+    };
+  }
+}
@@ -53,7 +53,7 @@ ValuePtr Dict::copy(bool deep) const {
 
 unsigned Dict::insert(const string &key, const ValuePtr &value) {
   if (value->isList() || value->isDict()) simple = false;
-  return (unsigned)OrderedDict<ValuePtr>::insert(key, value);
+  return (unsigned)Super_T::insert(key, value);
 }
 
 
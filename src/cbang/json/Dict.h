@@ -34,20 +34,20 @@
 
 #include "Value.h"
 
-#include <cbang/util/OrderedDict.h>
+#include <cbang/util/FlatOrderedDict.h>
 
 
 namespace cb {
   namespace JSON {
-    class Dict : public Value, protected OrderedDict<ValuePtr> {
-      typedef OrderedDict<ValuePtr> Super_T;
+    class Dict : public Value, protected FlatOrderedDict<ValuePtr> {
+      typedef FlatOrderedDict<ValuePtr> Super_T;
 
       bool simple;
 
     public:
       Dict() : simple(true) {}
 
-      // From OrderedDict<ValuePtr>
+      // From FlatOrderedDict<ValuePtr>
       using Super_T::empty;
       using Super_T::has;
 
@@ -65,7 +65,11 @@ namespace cb {
       unsigned size() const {return Super_T::size();}
       const std::string &keyAt(unsigned i) const
       {return Super_T::keyAt(i);}
+      using Value::indexOf;
       int indexOf(const std::string &key) const {return lookup(key);}
+      int indexOf(const char *key, size_t length) const
+      {return lookup(key, length);}
+      using Value::get;
       const ValuePtr &get(unsigned i) const
       {return Super_T::get(i);}
       const ValuePtr &get(const std::string &key) const
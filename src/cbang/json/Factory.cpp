@@ -41,10 +41,26 @@
 #include "False.h"
 #include "String.h"
 
+#include <vector>
+
 using namespace std;
 using namespace cb::JSON;
 
 
+namespace {
+  template <typename T>
+  struct SmallIntegers {
+    vector<ValuePtr> values;
+
+    SmallIntegers(int first) {
+      // Never freed, so references need not be counted
+      for (int i = first; i <= Factory::smallMax; i++)
+        values.push_back(ValuePtr::Phony(new NumberValue<T>(i)));
+    }
+  };
+}
+
+
 ValuePtr Factory::createDict() const {return new Dict;}
 ValuePtr Factory::createList() const {return new List;}
 ValuePtr Factory::createUndefined() const {return Undefined::instancePtr();}
@@ -64,6 +80,18 @@ ValuePtr Factory::create(int16_t value) const {return create((int64_t)value);}
 ValuePtr Factory::create(uint16_t value) const {return create((uint64_t)value);}
 ValuePtr Factory::create(int32_t value) const {return create((int64_t)value);}
 ValuePtr Factory::create(uint32_t value) const {return create((uint64_t)value);}
-ValuePtr Factory::create(int64_t value) const {return new S64(value);}
-ValuePtr Factory::create(uint64_t value) const {return new U64(value);}
+
+
+ValuePtr Factory::create(int64_t value) const {
+  static SmallIntegers<int64_t> small(smallMin);
+  return isSmall(value) ? small.values[value - smallMin] : new S64(value);
+}
+
+
+ValuePtr Factory::create(uint64_t value) const {
+  static SmallIntegers<uint64_t> small(0);
+  return isSmall(value) ? small.values[value] : new U64(value);
+}
+
+
 ValuePtr Factory::create(const string &value) const {return new String(value);}
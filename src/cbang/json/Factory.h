@@ -45,8 +45,16 @@ namespace cb {
 
     class Factory {
     public:
+      /// Integers in this range share immutable singleton Values
+      static const int smallMin = -128;
+      static const int smallMax = 1023;
+
       virtual ~Factory() {}
 
+      static bool isSmall(int64_t value)
+      {return smallMin <= value && value <= smallMax;}
+      static bool isSmall(uint64_t value) {return value <= smallMax;}
+
       virtual ValuePtr createDict() const;
       virtual ValuePtr createList() const;
       virtual ValuePtr createUndefined() const;
@@ -0,0 +1,123 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "InternedDict.h"
+
+#include <cbang/Exception.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+InternedDict::InternedDict(const SmartPointer<KeyPool> &pool) :
+  pool(pool), simple(true) {
+  if (pool.isNull()) CBANG_THROW("InternedDict requires a KeyPool");
+}
+
+
+ValuePtr InternedDict::copy(bool deep) const {
+  SmartPointer<InternedDict> c = new InternedDict(pool);
+
+  for (const_iterator it = begin(); it != end(); it++)
+    c->insert(it->first, deep ? it->second->copy(true) : it->second);
+
+  return c;
+}
+
+
+int InternedDict::indexOf(const string &key) const {
+  const string *k = pool->find(key);
+  return k ? lookup(k) : -1;
+}
+
+
+const ValuePtr &InternedDict::get(const string &key) const {
+  int i = indexOf(key);
+  if (i < 0) CBANG_KEY_ERROR("Key '" << key << "' not found");
+  return Super_T::get(i);
+}
+
+
+unsigned InternedDict::insert(const string &key, const ValuePtr &value) {
+  return insert(pool->intern(key), value);
+}
+
+
+void InternedDict::erase(const string &key) {
+  int i = indexOf(key);
+  if (i < 0) CBANG_KEY_ERROR("Key '" << key << "' not found");
+  Super_T::erase(i);
+}
+
+
+void InternedDict::write(Sink &sink) const {
+  sink.beginDict(isSimple());
+
+  for (const_iterator it = begin(); it != end(); it++) {
+    if (!it->second->canWrite(sink)) continue;
+    sink.beginInsert(*it->first);
+    it->second->write(sink);
+  }
+
+  sink.endDict();
+}
+
+
+void InternedDict::visitChildren(const_visitor_t visitor,
+                                 bool depthFirst) const {
+  for (unsigned i = 0; i < size(); i++) {
+    const Value &child = *get(i);
+
+    if (depthFirst) child.visitChildren(visitor, depthFirst);
+    visitor(child, this, i);
+    if (!depthFirst) child.visitChildren(visitor, depthFirst);
+  }
+}
+
+
+void InternedDict::visitChildren(visitor_t visitor, bool depthFirst) {
+  for (unsigned i = 0; i < size(); i++) {
+    Value &child = *get(i);
+
+    if (depthFirst) child.visitChildren(visitor, depthFirst);
+    visitor(child, this, i);
+    if (!depthFirst) child.visitChildren(visitor, depthFirst);
+  }
+}
+
+
+unsigned InternedDict::insert(const string *key, const ValuePtr &value) {
+  if (value->isList() || value->isDict()) simple = false;
+  return (unsigned)Super_T::insert(key, value);
+}
@@ -0,0 +1,106 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "Value.h"
+#include "KeyPool.h"
+
+#include <cbang/util/FlatOrderedDict.h>
+
+
+namespace cb {
+  namespace JSON {
+    /**
+     * A Dict whose keys are interned in a KeyPool.  Each entry holds a
+     * pointer to the pool's copy of its key, rather than its own string,
+     * and keys are compared by pointer.  A lookup first finds the key in
+     * the pool, a key not in the pool cannot be in the dictionary.
+     *
+     * InternedDict is a JSON_DICT but not a Dict, so code which casts to
+     * Dict rather than using the Value interface will not accept it.
+     */
+    class InternedDict :
+      public Value, protected FlatOrderedDict<ValuePtr, const std::string *> {
+      typedef FlatOrderedDict<ValuePtr, const std::string *> Super_T;
+
+      SmartPointer<KeyPool> pool;
+      bool simple;
+
+    public:
+      InternedDict(const SmartPointer<KeyPool> &pool = KeyPool::getGlobal());
+
+      const SmartPointer<KeyPool> &getKeyPool() const {return pool;}
+
+      // From FlatOrderedDict<ValuePtr, const std::string *>
+      using Super_T::empty;
+
+      // From Value
+      ValueType getType() const {return JSON_DICT;}
+      bool isDict() const {return true;}
+      ValuePtr copy(bool deep = false) const;
+      bool isSimple() const {return simple;}
+
+      using Value::getDict;
+      Value &getDict() {return *this;}
+
+      bool toBoolean() const {return size();}
+      unsigned size() const {return Super_T::size();}
+      const std::string &keyAt(unsigned i) const
+      {return *Super_T::keyAt(i);}
+      using Value::indexOf;
+      int indexOf(const std::string &key) const;
+      using Value::get;
+      const ValuePtr &get(unsigned i) const
+      {return Super_T::get(i);}
+      const ValuePtr &get(const std::string &key) const;
+
+      unsigned insert(const std::string &key, const ValuePtr &value);
+      using Value::insert;
+
+      void clear() {Super_T::clear();}
+      void erase(unsigned i) {Super_T::erase(i);}
+      void erase(const std::string &key);
+
+      void setParent(Value *parent, unsigned index)
+        {CBANG_TYPE_ERROR("Not an ObservableDict");}
+      void write(Sink &sink) const;
+
+      void visitChildren(const_visitor_t visitor, bool depthFirst = true) const;
+      void visitChildren(visitor_t visitor, bool depthFirst = true);
+
+    protected:
+      unsigned insert(const std::string *key, const ValuePtr &value);
+    };
+  }
+}
@@ -38,13 +38,23 @@
 #include "Number.h"
 #include "String.h"
 #include "List.h"
+#include "NumberList.h"
 #include "Dict.h"
+#include "InternedDict.h"
 #include "Reader.h"
+#include "BufferReader.h"
+#include "View.h"
 #include "YAMLReader.h"
 #include "Writer.h"
 #include "Builder.h"
+#include "Arena.h"
 #include "NullSink.h"
 #include "BufferWriter.h"
+#include "CBORWriter.h"
+#include "CBORReader.h"
+#include "RecordStream.h"
+#include "Schema.h"
+#include "SchemaValidator.h"
 #include "Integer.h"
 #include "Factory.h"
 #include "Serializable.h"
@@ -0,0 +1,73 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+#include <cbang/os/Mutex.h>
+
+#include <string>
+#include <unordered_set>
+
+
+namespace cb {
+  namespace JSON {
+    /**
+     * Interns Dict keys so that each distinct key is stored once.  The
+     * address of an interned string is stable for the life of the pool, so
+     * two interned keys are equal exactly when their pointers are.
+     *
+     * Pools are never pruned.  A per document pool is freed with the last
+     * InternedDict which refers to it.  The global pool is thread safe and
+     * should only be used for a bounded set of keys.
+     */
+    class KeyPool : public RefCounted {
+      std::unordered_set<std::string> keys;
+      bool threadSafe;
+      Mutex lock;
+
+    public:
+      KeyPool(bool threadSafe = false) : threadSafe(threadSafe) {}
+
+      static const SmartPointer<KeyPool> &getGlobal();
+
+      bool isThreadSafe() const {return threadSafe;}
+      unsigned size() const;
+
+      /// @return The interned copy of @param key, added if not present
+      const std::string *intern(const std::string &key);
+      /// @return The interned copy of @param key or null if not present
+      const std::string *find(const std::string &key) const;
+    };
+  }
+}
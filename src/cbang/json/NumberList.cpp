@@ -0,0 +1,292 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "NumberList.h"
+#include "Number.h"
+
+#include <cbang/Exception.h>
+
+#include <limits>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+namespace {
+  // Integers which a double holds exactly
+  const int64_t maxExact = 1LL << 53;
+  bool isExact(int64_t x) {return -maxExact <= x && x <= maxExact;}
+}
+
+
+bool NumberList::tryAppend(int64_t value) {
+  if (mode == PACKED_EMPTY) mode = PACKED_INTEGERS;
+
+  if (mode == PACKED_INTEGERS) integers.push_back(value);
+
+  else if (mode == PACKED_DOUBLES && isExact(value)) {
+    if (integral.empty()) integral.assign(doubles.size(), false);
+    doubles.push_back(value);
+    integral.push_back(true);
+
+  } else return false;
+
+  return true;
+}
+
+
+bool NumberList::tryAppend(uint64_t value) {
+  if ((uint64_t)numeric_limits<int64_t>::max() < value) return false;
+  return tryAppend((int64_t)value);
+}
+
+
+bool NumberList::tryAppend(double value) {
+  if (mode == PACKED_EMPTY) mode = PACKED_DOUBLES;
+
+  if (mode == PACKED_INTEGERS) {
+    for (auto it = integers.begin(); it != integers.end(); it++)
+      if (!isExact(*it)) return false;
+
+    doubles.assign(integers.begin(), integers.end());
+    integral.assign(integers.size(), true);
+    integers = vector<int64_t>();
+    mode = PACKED_DOUBLES;
+  }
+
+  if (mode != PACKED_DOUBLES) return false;
+
+  doubles.push_back(value);
+  if (!integral.empty()) integral.push_back(false);
+
+  return true;
+}
+
+
+ValuePtr NumberList::copy(bool deep) const {
+  SmartPointer<NumberList> c = new NumberList;
+
+  c->mode = mode;
+  c->integers = integers;
+  c->doubles = doubles;
+  c->integral = integral;
+  c->simple = simple;
+
+  if (mode == UNPACKED)
+    for (unsigned i = 0; i < values.size(); i++)
+      c->values.push_back(deep ? values[i]->copy(true) : values[i]);
+
+  return c;
+}
+
+
+unsigned NumberList::size() const {
+  switch (mode) {
+  case PACKED_INTEGERS: return integers.size();
+  case PACKED_DOUBLES: return doubles.size();
+  default: return values.size();
+  }
+}
+
+
+const ValuePtr &NumberList::get(unsigned i) const {
+  check(i);
+  if (mode == UNPACKED) return values[i];
+
+  if (values.size() < size()) values.resize(size());
+  ValuePtr &value = values[i];
+
+  if (value.isNull()) {
+    if (mode == PACKED_INTEGERS) value = createInteger(integers[i]);
+    else if (isIntegral(i)) value = createInteger((int64_t)doubles[i]);
+    else value = create(doubles[i]);
+  }
+
+  return value;
+}
+
+
+void NumberList::append(const ValuePtr &value) {
+  const Value *v = value.get();
+
+  if (auto *n = dynamic_cast<const S64 *>(v)) {
+    if (tryAppend(n->getValue())) return;
+
+  } else if (auto *n = dynamic_cast<const U64 *>(v)) {
+    if (tryAppend(n->getValue())) return;
+
+  } else if (auto *n = dynamic_cast<const Number *>(v)) {
+    if (tryAppend(n->getValue())) return;
+  }
+
+  unpack();
+  if (value->isList() || value->isDict()) simple = false;
+  values.push_back(value);
+}
+
+
+void NumberList::set(unsigned i, const ValuePtr &value) {
+  check(i);
+  if (trySet(i, value)) return;
+
+  unpack();
+  if (value->isList() || value->isDict()) simple = false;
+  values[i] = value;
+}
+
+
+void NumberList::clear() {
+  mode = PACKED_EMPTY;
+  integers.clear();
+  doubles.clear();
+  integral.clear();
+  values.clear();
+  simple = true;
+}
+
+
+void NumberList::erase(unsigned i) {
+  check(i);
+
+  if (mode == PACKED_INTEGERS) integers.erase(integers.begin() + i);
+  if (mode == PACKED_DOUBLES) doubles.erase(doubles.begin() + i);
+  if (!integral.empty()) integral.erase(integral.begin() + i);
+  if (i < values.size()) values.erase(values.begin() + i);
+}
+
+
+void NumberList::write(Sink &sink) const {
+  sink.beginList(isSimple());
+
+  switch (mode) {
+  case PACKED_INTEGERS:
+    for (auto it = integers.begin(); it != integers.end(); it++) {
+      sink.beginAppend();
+      if (*it < 0) sink.write(*it);
+      else sink.write((uint64_t)*it);
+    }
+    break;
+
+  case PACKED_DOUBLES:
+    for (unsigned i = 0; i < doubles.size(); i++) {
+      sink.beginAppend();
+      int64_t x = (int64_t)doubles[i];
+
+      if (!isIntegral(i)) sink.write(doubles[i]);
+      else if (x < 0) sink.write(x);
+      else sink.write((uint64_t)x);
+    }
+    break;
+
+  default:
+    for (auto it = values.begin(); it != values.end(); it++) {
+      if (!(*it)->canWrite(sink)) continue;
+      sink.beginAppend();
+      (*it)->write(sink);
+    }
+  }
+
+  sink.endList();
+}
+
+
+void NumberList::visitChildren(const_visitor_t visitor,
+                               bool depthFirst) const {
+  for (unsigned i = 0; i < size(); i++) {
+    const Value &child = *get(i);
+
+    if (depthFirst) child.visitChildren(visitor, depthFirst);
+    visitor(child, this, i);
+    if (!depthFirst) child.visitChildren(visitor, depthFirst);
+  }
+}
+
+
+void NumberList::visitChildren(visitor_t visitor, bool depthFirst) {
+  for (unsigned i = 0; i < size(); i++) {
+    Value &child = *get(i);
+
+    if (depthFirst) child.visitChildren(visitor, depthFirst);
+    visitor(child, this, i);
+    if (!depthFirst) child.visitChildren(visitor, depthFirst);
+  }
+}
+
+
+void NumberList::check(unsigned i) const {
+  if (size() <= i) KEY_ERROR("Index " << i << " out of range " << size());
+}
+
+
+bool NumberList::trySet(unsigned i, const ValuePtr &value) {
+  const Value *v = value.get();
+
+  if (mode == PACKED_INTEGERS) {
+    if (auto *n = dynamic_cast<const S64 *>(v)) integers[i] = n->getValue();
+    else if (auto *n = dynamic_cast<const U64 *>(v)) {
+      if ((uint64_t)numeric_limits<int64_t>::max() < n->getValue())
+        return false;
+      integers[i] = (int64_t)n->getValue();
+
+    } else return false;
+
+  } else if (mode == PACKED_DOUBLES) {
+    if (auto *n = dynamic_cast<const Number *>(v)) {
+      doubles[i] = n->getValue();
+      if (!integral.empty()) integral[i] = false;
+
+    } else return false;
+
+  } else return false;
+
+  if (i < values.size()) values[i] = value;
+  return true;
+}
+
+
+ValuePtr NumberList::createInteger(int64_t value) const {
+  return value < 0 ? create(value) : create((uint64_t)value);
+}
+
+
+void NumberList::unpack() {
+  if (mode == UNPACKED) return;
+
+  for (unsigned i = 0; i < size(); i++) get(i);
+
+  mode = UNPACKED;
+  integers = vector<int64_t>();
+  doubles = vector<double>();
+  integral = vector<bool>();
+}
@@ -0,0 +1,123 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "Value.h"
+
+#include <vector>
+
+
+namespace cb {
+  namespace JSON {
+    /**
+     * A List which stores numbers contiguously rather than as separate
+     * Values.  A list of integers is stored as int64_t and a list of
+     * doubles, or of doubles and integers of at most 53 bits, as double.
+     * Appending any other Value, or an integer which cannot be stored
+     * exactly, converts the list to a vector of ValuePtrs which then
+     * behaves like List.
+     *
+     * The Values returned by get() are created on first access and kept.
+     * Unlike a List, get() changes the list so it must not be called from
+     * several threads at once.  Non-negative integers are returned as U64
+     * and negative integers as S64, as Reader creates them.
+     */
+    class NumberList : public Value {
+      enum {
+        PACKED_EMPTY,
+        PACKED_INTEGERS,
+        PACKED_DOUBLES,
+        UNPACKED,
+      } mode = PACKED_EMPTY;
+
+      std::vector<int64_t> integers;
+      std::vector<double> doubles;
+      std::vector<bool> integral; // Which doubles are integers, if any
+      mutable std::vector<ValuePtr> values;
+      bool simple = true;
+
+    public:
+      bool isPacked() const {return mode != UNPACKED;}
+
+      /// @return False if @param value cannot be stored in packed form
+      bool tryAppend(int64_t value);
+      bool tryAppend(uint64_t value);
+      bool tryAppend(double value);
+
+      // From Value
+      ValueType getType() const {return JSON_LIST;}
+      bool isList() const {return true;}
+      ValuePtr copy(bool deep = false) const;
+      bool isSimple() const {return simple;}
+
+      Value &getList() {return *this;}
+      const Value &getList() const {return *this;}
+
+      bool toBoolean() const {return size();}
+      unsigned size() const;
+
+      const ValuePtr &get(unsigned i) const;
+      const ValuePtr &operator[](unsigned i) const {return get(i);}
+
+      void append(const ValuePtr &value);
+      void set(unsigned i, const ValuePtr &value);
+      void clear();
+      void erase(unsigned i);
+
+      void setParent(Value *parent, unsigned index)
+        {CBANG_TYPE_ERROR("Not an ObservableList");}
+
+      void write(Sink &sink) const;
+
+      void visitChildren(const_visitor_t visitor, bool depthFirst = true) const;
+      void visitChildren(visitor_t visitor, bool depthFirst = true);
+
+      using Value::getList;
+      using Value::get;
+      using Value::append;
+      using Value::set;
+      using Value::insert;
+      using Value::erase;
+      using Value::empty;
+
+    protected:
+      void check(unsigned i) const;
+      bool isIntegral(unsigned i) const
+      {return !integral.empty() && integral[i];}
+      ValuePtr createInteger(int64_t value) const;
+      bool trySet(unsigned i, const ValuePtr &value);
+      void unpack();
+    };
+  }
+}
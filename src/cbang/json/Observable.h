@@ -34,18 +34,33 @@
 
 #include "Dict.h"
 #include "List.h"
+#include "ChangeSet.h"
 
+#include <algorithm>
 #include <functional>
 
 
 namespace cb {
   namespace JSON {
+    /**
+     * A Dict or List which reports each change to itself or its
+     * descendants to the root of the tree, where notify() is called with
+     * the path to the change followed by the new value, or null if it was
+     * removed.  Plain Dicts and Lists are converted to Observables when
+     * added and Observable subtrees are adopted as they are.
+     *
+     * Between begin() and commit() on the root changes are instead
+     * collected in a ChangeSet and reported together at commit.
+     */
     template <typename T>
     class Observable : public T {
     protected:
       Value *parent = 0;
       unsigned index = 0;
 
+      unsigned batchDepth = 0;
+      SmartPointer<ChangeSet> changes;
+
     public:
       ~Observable() {
         for (unsigned i = 0; i < T::size(); i++)
@@ -53,18 +68,24 @@ namespace cb {
       }
 
 
+      static bool isObservable(const ValuePtr &value) {
+        return value.isInstance<Observable<Dict> >() ||
+          value.isInstance<Observable<List> >();
+      }
+
+
       ValuePtr convert(const ValuePtr &value) {
-        if (value.isInstance<Dict>() &&
-            !value.isInstance<Observable<Dict> >()) {
-          ValuePtr d = createDict();
-          d->merge(*value);
+        if (isObservable(value)) return value;
+
+        if (value.isInstance<Dict>()) {
+          SmartPointer<Observable<Dict> > d = new Observable<Dict>;
+          d->adopt(*value);
           return d;
         }
 
-        if (value.isInstance<List>() &&
-            !value.isInstance<Observable<List> >()) {
-          ValuePtr l = createList();
-          l->appendFrom(*value);
+        if (value.isInstance<List>()) {
+          SmartPointer<Observable<List> > l = new Observable<List>;
+          l->adopt(*value);
           return l;
         }
 
@@ -72,31 +93,73 @@ namespace cb {
       }
 
 
+      /// Fill this empty container from @param value without notification
+      void adopt(const Value &value) {
+        for (unsigned i = 0; i < value.size(); i++) {
+          ValuePtr child = convert(value.get(i));
+
+          if (T::isList()) T::append(child);
+          else T::insert(value.keyAt(i), child);
+
+          child->setParentRef(this, T::size() - 1);
+        }
+      }
+
+
+      /// Start a batch on the root of the tree.  Batches may be nested.
+      void begin() {
+        if (parent) THROW("Batches must begin at the root");
+        if (!batchDepth++) changes = new ChangeSet;
+      }
+
+
+      /// End a batch and report its changes when the outermost one ends
+      void commit() {
+        if (!batchDepth) THROW("No batch to commit");
+        if (--batchDepth) return;
+
+        SmartPointer<ChangeSet> changes = this->changes;
+        this->changes.release();
+
+        if (!changes->empty()) notify(*changes);
+      }
+
+
+      bool inBatch() const {return batchDepth;}
+
+
       // From Value
       void append(const ValuePtr &_value) {
         ValuePtr value = convert(_value);
         int i = T::size();
         T::append(value);
         value->setParentRef(this, i);
-        notify(i, value);
+        notify(Change::CHANGE_ADD, T::create(i), value);
       }
 
 
       void set(unsigned i, const ValuePtr &_value) {
         ValuePtr value = convert(_value);
-        T::get(i)->clearParentRef();
+        ValuePtr old = T::get(i);
+        old->clearParentRef();
         T::set(i, value);
         value->setParentRef(this, i);
-        notify(i, value);
+        notify(Change::CHANGE_REPLACE, getKey(i), value, old);
       }
 
 
       unsigned insert(const std::string &key, const ValuePtr &_value) {
         ValuePtr value = convert(_value);
-        if (T::has(key)) T::get(key)->clearParentRef();
+        ValuePtr old;
+        if (T::has(key)) {
+          old = T::get(key);
+          old->clearParentRef();
+        }
+
         unsigned i = T::insert(key, value);
         value->setParentRef(this, i);
-        notify(key, value);
+        notify(old.isSet() ? Change::CHANGE_REPLACE : Change::CHANGE_ADD,
+               T::create(key), value, old);
         return i;
       }
 
@@ -107,25 +170,36 @@ namespace cb {
 
         T::clear();
 
-        std::list<ValuePtr> change;
-        change.push_front(T::isList() ? T::createList() : T::createDict());
+        // The root may not be reference counted, report a new container
+        ValuePtr value;
+        if (parent) value = this;
+        else value = T::isList() ? T::createList() : T::createDict();
+
+        Change change(Change::CHANGE_CLEAR, value, 0);
         notify(change);
       }
 
 
       void erase(unsigned i) {
-        T::get(i)->clearParentRef();
+        ValuePtr key = getKey(i);
+        ValuePtr old = T::get(i);
+        old->clearParentRef();
         T::erase(i);
         for (unsigned j = i; j < T::size(); j++)
           T::get(j)->decParentRef();
-        notify(i);
+        notify(Change::CHANGE_REMOVE, key, 0, old);
       }
 
 
       void erase(const std::string &key) {
-        T::get(key)->clearParentRef();
+        ValuePtr old = T::get(key);
+        unsigned i = T::indexOf(key);
+        ValuePtr _key = T::create(key); // May refer to the erased key
+        old->clearParentRef();
         T::erase(key);
-        notify(key);
+        for (unsigned j = i; j < T::size(); j++)
+          T::get(j)->decParentRef();
+        notify(Change::CHANGE_REMOVE, _key, 0, old);
       }
 
 
@@ -149,25 +223,43 @@ namespace cb {
       }
 
 
-      void notify(unsigned index, const ValuePtr &value = 0) {
-        std::list<ValuePtr> change;
+      void notify(Change &change) {
+        change.chain.push_back(this);
 
-        if (value.isSet()) change.push_back(value);
-        else change.push_back(T::createNull());
+        if (parent) {
+          if (parent->isList()) change.path.push_front(T::create(index));
+          else change.path.push_front(T::create(parent->keyAt(index)));
 
-        change.push_front(T::create(index));
-        notify(change);
-      }
+          return parent->notify(change);
+        }
 
+        // At the root
+        std::reverse(change.chain.begin(), change.chain.end());
+        if (batchDepth) return changes->add(change);
 
-      void notify(const std::string &key, const ValuePtr &value = 0) {
-        std::list<ValuePtr> change;
+        // Report from where the change was made, as notify() always has
+        std::list<ValuePtr> path;
+        if (change.op == Change::CHANGE_CLEAR)
+          path.push_back(T::isList() ? T::createList() : T::createDict());
 
-        if (value.isSet()) change.push_back(value);
-        else change.push_back(T::createNull());
+        else {
+          path.push_back(change.path.back());
+          if (change.value.isSet()) path.push_back(change.value);
+          else path.push_back(T::createNull());
+        }
 
-        change.push_front(T::create(key));
-        notify(change);
+        change.chain.back()->notify(path);
+      }
+
+
+      /// Called on the root with the changes of each committed batch
+      virtual void notify(const ChangeSet &changes) {
+        changes.visit([this] (const Change &change) {
+            std::list<ValuePtr> path = change.path;
+            if (change.value.isSet()) path.push_back(change.value);
+            else path.push_back(T::createNull());
+            this->notify(path);
+          });
       }
 
 
@@ -179,6 +271,17 @@ namespace cb {
       ValuePtr createDict() const {return new Observable<Dict>;}
       ValuePtr createList() const {return new Observable<List>;}
 
+    protected:
+      ValuePtr getKey(unsigned i) const
+      {return T::isList() ? T::create(i) : T::create(T::keyAt(i));}
+
+
+      void notify(Change::op_t op, const ValuePtr &key, const ValuePtr &value,
+                  const ValuePtr &old = 0) {
+        Change change(op, value, old);
+        change.path.push_back(key);
+        notify(change);
+      }
     };
 
 
@@ -0,0 +1,165 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "ParallelWriter.h"
+#include "NumberList.h"
+
+#include <cbang/os/ParallelPipeline.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+namespace {
+  /// Writes a range of a container's children to a buffer
+  class RangeWriter : public Writer {
+  public:
+    string out;
+
+    // Output goes to out, never to the stream
+    RangeWriter(ostream &stream, unsigned indentStart, bool compact,
+                unsigned indentSpace, int precision) :
+      Writer(stream, indentStart, compact, indentSpace, precision) {}
+
+
+    void write(const Value &value, uint64_t first, uint64_t last) {
+      if (value.isList()) beginList(value.isSimple());
+      else beginDict(value.isSimple());
+
+      // Drop the bracket and separate every child, the first child of the
+      // whole container has its separator removed when it is written out.
+      out.clear();
+      this->first = false;
+
+      for (uint64_t i = first; i < last; i++) {
+        const Value &child = *value.get(i);
+        if (!child.canWrite(*this)) continue;
+
+        if (value.isList()) beginAppend();
+        else beginInsert(value.keyAt(i));
+
+        child.write(*this);
+      }
+    }
+
+  protected:
+    // From Writer
+    void put(char c) {out.push_back(c);}
+    void put(const char *s, size_t n) {out.append(s, n);}
+  };
+
+
+  struct Range {
+    uint64_t first;
+    uint64_t last;
+    string out;
+  };
+}
+
+
+void ParallelWriter::write(const Value &value) {
+  bool list = value.isList();
+
+  if (!list && !value.isDict()) return value.write(*this);
+
+  // NumberList creates its Values on access, which is not thread safe
+  if (dynamic_cast<const NumberList *>(&value)) return value.write(*this);
+  if (threshold <= value.size()) return writeParallel(value);
+
+  // Recurse to find large containers further down
+  if (list) beginList(value.isSimple());
+  else beginDict(value.isSimple());
+
+  for (unsigned i = 0; i < value.size(); i++) {
+    const Value &child = *value.get(i);
+    if (!child.canWrite(*this)) continue;
+
+    if (list) beginAppend();
+    else beginInsert(value.keyAt(i));
+
+    write(child);
+  }
+
+  if (list) endList();
+  else endDict();
+}
+
+
+void ParallelWriter::writeParallel(const Value &value) {
+  bool list = value.isList();
+  bool simple = value.isSimple();
+  uint64_t size = value.size();
+  uint64_t next = 0;
+  bool empty = true;
+
+  if (list) beginList(simple);
+  else beginDict(simple);
+
+  unsigned indentStart = getIndentStart() + getDepth() - 1;
+
+  ParallelPipeline<Range>(pool)
+    .setSource([&] (Range &range) {
+      if (size <= next) return false;
+      range.first = next;
+      range.last = next = min(size, next + grain);
+      return true;
+    })
+
+    .addStage([&] (Range &range) {
+      RangeWriter writer(stream, indentStart, compact, indentSpace,
+                         precision);
+      writer.write(value, range.first, range.last);
+      range.out.swap(writer.out);
+    })
+
+    .setSink([&] (Range &range) {
+      if (range.out.empty()) return;
+
+      size_t skip = 0;
+      if (empty) {
+        // The first child has no separator
+        skip = 1 + (simple && !compact);
+        empty = false;
+      }
+
+      put(range.out.data() + skip, range.out.size() - skip);
+    })
+
+    .run();
+
+  first = empty;
+
+  if (list) endList();
+  else endDict();
+}
@@ -0,0 +1,84 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "Writer.h"
+#include "Value.h"
+
+
+namespace cb {
+  class ParallelPool;
+
+  namespace JSON {
+    /**
+     * A Writer which serializes large Lists and Dicts in parallel.  The
+     * children of a container with at least getThreshold() children are
+     * split into ranges of getGrain() and each range is written to its own
+     * buffer on a ParallelPool.  Buffers are written to the stream in order
+     * so the output is exactly that of Writer.  Only a bounded number of
+     * buffers are held at once.
+     *
+     * Smaller containers are written on the calling thread, recursing so
+     * that large containers nested in them are also split.  Values must not
+     * be modified while they are being written.
+     *
+     * For compressed output write to a boost::iostreams::filtering_ostream
+     * with a cb::ParallelCompressor.
+     */
+    class ParallelWriter : public Writer {
+      ParallelPool &pool;
+      unsigned grain = 1024;
+      unsigned threshold = 4096;
+
+    public:
+      ParallelWriter(ParallelPool &pool, std::ostream &stream,
+                     unsigned indentStart = 0, bool compact = false,
+                     unsigned indentSpace = 2, int precision = 6) :
+        Writer(stream, indentStart, compact, indentSpace, precision),
+        pool(pool) {}
+
+      unsigned getGrain() const {return grain;}
+      void setGrain(unsigned x) {grain = x ? x : 1;}
+
+      unsigned getThreshold() const {return threshold;}
+      void setThreshold(unsigned x) {threshold = x;}
+
+      void write(const Value &value);
+      using Writer::write;
+
+    protected:
+      void writeParallel(const Value &value);
+    };
+  }
+}
@@ -36,38 +36,73 @@
 #include <cbang/String.h>
 #include <cbang/log/Logger.h>
 
+#include <unordered_map>
+
 using namespace std;
 using namespace cb;
 using namespace cb::JSON;
 
 
+namespace {
+  const unsigned maxCachedPaths = 1024;
+}
+
+
+Path::Part::Part(const string &key) :
+  key(key), index(-1), wildcard(key == "*"), hint(0) {
+  try {
+    index = String::parseU32(key, true);
+  } catch (const Exception &e) {}
+}
+
+
+Path::Part::Part(const Part &o) :
+  key(o.key), index(o.index), wildcard(o.wildcard), hint(o.hint.load()) {}
+
+
 Path::Path(const string &path) : path(path) {
   String::tokenize(path, parts, ".");
   if (path.empty()) THROW("JSON Path cannot be empty");
+
+  compiled.reserve(parts.size());
+  for (unsigned i = 0; i < parts.size(); i++) {
+    compiled.push_back(Part(parts[i]));
+    if (compiled.back().wildcard) wildcards = true;
+  }
 }
 
 
-ConstValuePtr Path::select(const Value &value, fail_cb_t fail_cb) const {
-  ConstValuePtr ptr; // Cannot create pointer to passed value
-  unsigned i;
+const Path &Path::get(const string &path) {
+  static thread_local unordered_map<string, Path> cache;
 
-  for (i = 0; i < parts.size(); i++) {
-    const Value &v = i ? *ptr : value;
+  auto it = cache.find(path);
+  if (it != cache.end()) return it->second;
 
-    int index = -1;
+  if (maxCachedPaths <= cache.size()) cache.clear();
+  return cache.emplace(path, path).first->second;
+}
 
-    if (v.isList())
-      try {
-        index = String::parseU32(parts[i], true);
-      } catch (const Exception &e) {}
 
-    else if (v.isDict()) index = v.indexOf(parts[i]);
+ConstValuePtr Path::select(const Value &value, fail_cb_t fail_cb) const {
+  unsigned i = 0;
 
-    if (index == -1 || (int)v.size() <= index) break;
-    ptr = v.get(index);
-  }
+  if (wildcards) {
+    vector<ConstValuePtr> results = selectAll(value);
+    if (!results.empty()) return results.front();
 
-  if (i == parts.size()) return ptr;
+  } else {
+    // Walk without reference counting, cannot point to the passed value
+    const ValuePtr *ptr = 0;
+
+    for (; i < compiled.size(); i++) {
+      const Value &v = i ? **ptr : value;
+      int index = find(v, compiled[i]);
+      if (index == -1) break;
+      ptr = &v.get(index);
+    }
+
+    if (i == compiled.size()) return *ptr;
+  }
 
   string path =
     cb::String::join(vector<string>(parts.begin(), parts.begin() + i + 1), ".");
@@ -97,6 +132,13 @@ ValuePtr Path::select(Value &value, const ValuePtr &defaultValue) const {
 }
 
 
+vector<ConstValuePtr> Path::selectAll(const Value &value) const {
+  vector<ConstValuePtr> results;
+  selectAll(value, 0, results);
+  return results;
+}
+
+
 #define CBANG_JSON_VT(NAME, TYPE)                                   \
   TYPE Path::select##NAME(const Value &value) const {               \
     ConstValuePtr result = select(value);                           \
@@ -120,3 +162,42 @@ ValuePtr Path::select(Value &value, const ValuePtr &defaultValue) const {
     return result->get##NAME();                                     \
   }
 #include "ValueTypes.def"
+
+
+int Path::find(const Value &value, const Part &part) const {
+  if (value.isList())
+    return part.index < (int)value.size() ? part.index : -1;
+
+  if (!value.isDict()) return -1;
+
+  unsigned hint = part.hint.load(memory_order_relaxed);
+  if (hint < value.size() && value.keyAt(hint) == part.key) return hint;
+
+  int index = value.indexOf(part.key);
+  if (index != -1) part.hint.store(index, memory_order_relaxed);
+
+  return index;
+}
+
+
+void Path::selectAll(const Value &value, unsigned i,
+                     vector<ConstValuePtr> &results) const {
+  const Part &part = compiled[i];
+  bool last = i == compiled.size() - 1;
+
+  if (part.wildcard) {
+    if (!value.isList() && !value.isDict()) return;
+
+    for (unsigned j = 0; j < value.size(); j++)
+      if (last) results.push_back(value.get(j));
+      else selectAll(*value.get(j), i + 1, results);
+
+    return;
+  }
+
+  int index = find(value, part);
+  if (index == -1) return;
+
+  if (last) results.push_back(value.get(index));
+  else selectAll(*value.get(index), i + 1, results);
+}
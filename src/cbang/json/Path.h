@@ -35,19 +35,53 @@
 #include "Factory.h"
 
 #include <functional>
+#include <vector>
+#include <atomic>
 
 
 namespace cb {
   namespace JSON {
+    /**
+     * A dot separated path of Dict keys and List indices, for example
+     * "servers.0.name".  A "*" part matches every child of a Dict or List.
+     *
+     * Parts are parsed once at construction and each remembers the Dict
+     * slot where its key was last found, so selecting the same Path on
+     * many Values of the same shape avoids most key lookups.  Keep Paths
+     * which are used repeatedly rather than constructing them per call.
+     */
     class Path {
+      struct Part {
+        std::string key;
+        int index; // -1 if not a List index
+        bool wildcard;
+        mutable std::atomic<unsigned> hint;
+
+        Part(const std::string &key);
+        Part(const Part &o);
+      };
+
       std::string path;
       std::vector<std::string> parts;
+      std::vector<Part> compiled;
+      bool wildcards = false;
 
     public:
       Path(const std::string &path);
 
+      /**
+       * @return a Path from a per thread cache of recently used Paths.
+       * The reference is valid until the next call on the same thread.
+       */
+      static const Path &get(const std::string &path);
+
+      const std::string &toString() const {return path;}
+      const std::vector<std::string> &getParts() const {return parts;}
+      bool hasWildcards() const {return wildcards;}
+
       typedef std::function <ConstValuePtr (const std::string &path)> fail_cb_t;
 
+      /// With wildcards these return the first match
       ConstValuePtr select(const Value &value, fail_cb_t fail_cb = 0) const;
       ConstValuePtr select(const Value &value,
                            const ConstValuePtr &defaultValue) const;
@@ -55,11 +89,18 @@ namespace cb {
       ValuePtr select(Value &value, fail_cb_t fail_cb = 0) const;
       ValuePtr select(Value &value, const ValuePtr &defaultValue) const;
 
+      /// @return all matches in document order
+      std::vector<ConstValuePtr> selectAll(const Value &value) const;
 
 #define CBANG_JSON_VT(NAME, TYPE)                                       \
       TYPE select##NAME(const Value &value) const;                      \
       TYPE select##NAME(const Value &value, TYPE defaultValue) const;
 #include "ValueTypes.def"
+
+    protected:
+      int find(const Value &value, const Part &part) const;
+      void selectAll(const Value &value, unsigned i,
+                     std::vector<ConstValuePtr> &results) const;
    };
   }
 }
@@ -109,6 +109,12 @@ void ProxySink::write(const string &value) {
 }
 
 
+void ProxySink::writeRef(const SmartPointer<Value> &value) {
+  NullSink::writeNull(); // Stands in for the complete value
+  if (target.isSet()) target->writeRef(value);
+}
+
+
 void ProxySink::beginList(bool simple) {
   NullSink::beginList(simple);
   if (target.isSet()) target->beginList(simple);
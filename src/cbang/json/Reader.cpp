@@ -32,9 +32,9 @@
 
 #include "Reader.h"
 #include "Builder.h"
+#include "BufferReader.h"
 
 #include <cbang/String.h>
-#include <cbang/io/StringInputSource.h>
 
 #include <vector>
 #include <cctype>
@@ -100,7 +100,7 @@ SmartPointer<Value> Reader::parse(const InputSource &src) {
 
 
 SmartPointer<Value> Reader::parseString(const string &s) {
-  return parse(StringInputSource(s));
+  return BufferReader(s).parse();
 }
 
 
@@ -110,7 +110,7 @@ void Reader::parse(const InputSource &src, Sink &sink) {
 
 
 void Reader::parseString(const string &s, Sink &sink) {
-  parse(StringInputSource(s), sink);
+  BufferReader(s).parse(sink);
 }
 
 
@@ -0,0 +1,275 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "RecordStream.h"
+#include "Builder.h"
+#include "Reader.h"
+#include "BufferReader.h"
+
+#include <cbang/String.h>
+#include <cbang/Catch.h>
+#include <cbang/os/ThreadPoolFunc.h>
+#include <cbang/util/SmartLock.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+RecordStream::RecordStream(const string &path, const callback_t &cb,
+                           unsigned threads, unsigned maxQueue) :
+  cb(cb), maxQueue(maxQueue ? maxQueue : 1) {
+  String::tokenize(path, this->path, ".");
+
+  if (threads) {
+    pool = new ThreadPoolFunc<RecordStream>(threads, this, &RecordStream::work);
+    pool->start();
+  }
+}
+
+
+RecordStream::~RecordStream() {TRY_CATCH_ERROR(stop());}
+
+
+void RecordStream::read(const InputSource &src) {
+  Reader(src).parse(*this);
+  finish();
+}
+
+
+void RecordStream::read(const char *data, size_t length) {
+  BufferReader(data, length).parse(*this);
+  finish();
+}
+
+
+void RecordStream::finish() {
+  stop();
+  if (!error.empty()) THROW("Record callback failed: " << error);
+}
+
+
+void RecordStream::stop() {
+  if (pool.isNull()) return;
+
+  {
+    SmartLock lock(&condition);
+    done = true;
+    condition.broadcast();
+  }
+
+  pool->wait();
+  pool.release();
+}
+
+
+void RecordStream::writeNull() {
+  if (beginValue()) {builder->writeNull(); endValue();}
+}
+
+
+void RecordStream::writeBoolean(bool value) {
+  if (beginValue()) {builder->writeBoolean(value); endValue();}
+}
+
+
+void RecordStream::write(double value) {
+  if (beginValue()) {builder->write(value); endValue();}
+}
+
+
+void RecordStream::write(int64_t value) {
+  if (beginValue()) {builder->write(value); endValue();}
+}
+
+
+void RecordStream::write(uint64_t value) {
+  if (beginValue()) {builder->write(value); endValue();}
+}
+
+
+void RecordStream::write(const string &value) {
+  if (beginValue()) {builder->write(value); endValue();}
+}
+
+
+void RecordStream::beginList(bool simple) {
+  if (beginValue()) {builder->beginList(simple); recordDepth++;}
+  else beginContainer(true);
+}
+
+
+void RecordStream::beginAppend() {
+  if (recordDepth) return builder->beginAppend();
+  if (stack.empty() || !stack.back().isList) TYPE_ERROR("Not a List");
+  stack.back().index++;
+}
+
+
+void RecordStream::endList() {
+  if (recordDepth) {
+    builder->endList();
+    if (!--recordDepth) endValue();
+
+  } else endContainer();
+}
+
+
+void RecordStream::beginDict(bool simple) {
+  if (beginValue()) {builder->beginDict(simple); recordDepth++;}
+  else beginContainer(false);
+}
+
+
+bool RecordStream::has(const string &key) const {
+  return recordDepth && builder->has(key);
+}
+
+
+void RecordStream::beginInsert(const string &key) {
+  if (recordDepth) return builder->beginInsert(key);
+  if (stack.empty() || stack.back().isList) TYPE_ERROR("Not a Dict");
+  stack.back().index++;
+  if (stack.back().matches) stack.back().key = key;
+}
+
+
+void RecordStream::endDict() {
+  if (recordDepth) {
+    builder->endDict();
+    if (!--recordDepth) endValue();
+
+  } else endContainer();
+}
+
+
+bool RecordStream::isRecordStart() const {
+  return !stack.empty() && stack.back().matches &&
+    stack.size() == path.size() + 1;
+}
+
+
+bool RecordStream::beginValue() {
+  if (recordDepth) return true;
+  if (!isRecordStart()) return false;
+
+  builder = new Builder;
+  if (arenaBlockSize) builder->setArena(new Arena(arenaBlockSize));
+
+  return true;
+}
+
+
+void RecordStream::endValue() {
+  if (recordDepth) return;
+
+  ValuePtr record = builder->getRoot();
+  builder.release();
+  count++;
+
+  dispatch(record);
+}
+
+
+void RecordStream::beginContainer(bool isList) {
+  bool matches = stack.empty();
+
+  if (!matches) {
+    const Frame &parent = stack.back();
+    unsigned depth = stack.size() - 1;
+
+    if (parent.matches && depth < path.size()) {
+      const string &part = path[depth];
+      if (parent.isList) matches = String(parent.index - 1) == part;
+      else matches = parent.key == part;
+    }
+  }
+
+  stack.push_back(Frame());
+  Frame &frame = stack.back();
+  frame.isList = isList;
+  frame.matches = matches;
+  frame.index = 0;
+}
+
+
+void RecordStream::endContainer() {
+  if (stack.empty()) THROW("Not in a List or Dict");
+  stack.pop_back();
+}
+
+
+void RecordStream::dispatch(ValuePtr &record) {
+  if (pool.isNull()) return cb(record);
+
+  SmartLock lock(&condition);
+
+  while (maxQueue <= queue.size() && error.empty()) condition.wait();
+  if (!error.empty()) THROW("Record callback failed: " << error);
+
+  // Reference counts are not thread safe, let go of the record while locked
+  queue.push_back(record);
+  record.release();
+  condition.broadcast();
+}
+
+
+void RecordStream::work() {
+  while (true) {
+    ValuePtr record;
+
+    {
+      SmartLock lock(&condition);
+
+      while (queue.empty() && !done) condition.wait();
+      if (queue.empty() || !error.empty()) return;
+
+      record = queue.front();
+      queue.pop_front();
+      condition.broadcast();
+    }
+
+    try {
+      cb(record);
+
+    } catch (const Exception &e) {
+      SmartLock lock(&condition);
+      if (error.empty()) error = e.getMessage();
+      condition.broadcast();
+
+    } catch (const std::exception &e) {
+      SmartLock lock(&condition);
+      if (error.empty()) error = e.what();
+      condition.broadcast();
+    }
+  }
+}
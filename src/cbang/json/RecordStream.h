@@ -0,0 +1,138 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Sink.h"
+#include "Value.h"
+
+#include <cbang/SmartPointer.h>
+#include <cbang/os/Condition.h>
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <functional>
+
+
+namespace cb {
+  class InputSource;
+  class ThreadPool;
+
+  namespace JSON {
+    class Builder;
+
+    /**
+     * Parses a large document one record at a time.  Each element of the
+     * List or Dict at the given path is built on its own and passed to the
+     * callback.  Values outside the path are skipped without being built.
+     * An empty path selects the elements of the top-level List.
+     *
+     * With threads greater than zero the records are handed to a pool of
+     * workers.  At most maxQueue records wait at once after which parsing
+     * blocks, so memory is bounded either way.  The callback must then be
+     * thread safe.  An exception thrown by the callback stops further
+     * dispatch and is rethrown by finish().
+     */
+    class RecordStream : public Sink {
+    public:
+      typedef std::function<void (const ValuePtr &record)> callback_t;
+
+    private:
+      struct Frame {
+        bool isList;
+        bool matches;
+        uint64_t index;
+        std::string key;
+      };
+
+      std::vector<std::string> path;
+      callback_t cb;
+      unsigned maxQueue;
+      unsigned arenaBlockSize = 0;
+
+      std::vector<Frame> stack;
+      SmartPointer<Builder> builder;
+      unsigned recordDepth = 0;
+      uint64_t count = 0;
+
+      SmartPointer<ThreadPool> pool;
+      Condition condition;
+      std::deque<ValuePtr> queue;
+      bool done = false;
+      std::string error;
+
+    public:
+      RecordStream(const std::string &path, const callback_t &cb,
+                   unsigned threads = 0, unsigned maxQueue = 64);
+      ~RecordStream();
+
+      /// If non-zero each record is built in its own Arena
+      void setArenaBlockSize(unsigned x) {arenaBlockSize = x;}
+      unsigned getArenaBlockSize() const {return arenaBlockSize;}
+
+      /// @return The number of records found so far.
+      uint64_t getCount() const {return count;}
+
+      void read(const InputSource &src);
+      void read(const char *data, size_t length);
+      /// Wait for queued records and rethrow any callback error.
+      void finish();
+
+      // From Sink
+      void writeNull();
+      void writeBoolean(bool value);
+      void write(double value);
+      void write(int64_t value);
+      void write(uint64_t value);
+      void write(const std::string &value);
+      using Sink::write;
+      void beginList(bool simple = false);
+      void beginAppend();
+      void endList();
+      void beginDict(bool simple = false);
+      bool has(const std::string &key) const;
+      void beginInsert(const std::string &key);
+      void endDict();
+
+    protected:
+      bool isRecordStart() const;
+      bool beginValue();
+      void endValue();
+      void beginContainer(bool isList);
+      void endContainer();
+      void dispatch(ValuePtr &record);
+      void stop();
+      void work();
+    };
+  }
+}
@@ -0,0 +1,279 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "Schema.h"
+#include "SchemaValidator.h"
+#include "Value.h"
+
+#include <cbang/Exception.h>
+#include <cbang/String.h>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+namespace {
+  string joinPath(const string &path, const string &key) {
+    return path.empty() ? key : path + "." + key;
+  }
+
+
+  string joinList(const vector<string> &parts, const string &sep) {
+    string s;
+
+    for (unsigned i = 0; i < parts.size(); i++) {
+      if (i) s += sep;
+      s += parts[i];
+    }
+
+    return s;
+  }
+
+
+  string bounds(uint64_t min, uint64_t max) {
+    if (max == numeric_limits<uint64_t>::max())
+      return "at least " + String(min);
+    if (!min) return "at most " + String(max);
+    if (min == max) return String(min);
+    return "between " + String(min) + " and " + String(max);
+  }
+
+
+  bool isAnnotation(const string &key) {
+    static const set<string> keys = {
+      "$schema", "$id", "$comment", "title", "description", "default",
+      "examples", "readOnly", "writeOnly", "deprecated", "format",
+    };
+
+    return keys.find(key) != keys.end();
+  }
+}
+
+
+Schema::Schema(const Value &schema) {
+  nodes.push_back(Node()); // Accepts anything
+  compile(schema, "");
+}
+
+
+void Schema::validate(const Value &value) const {
+  SchemaValidator validator(*this);
+  value.write(validator);
+}
+
+
+unsigned Schema::compile(const Value &schema, const string &path) {
+  unsigned index = nodes.size();
+  nodes.push_back(Node());
+
+  Node node;
+  string name = path.empty() ? string("JSON input") : "'" + path + "'";
+
+  // true accepts anything and false nothing
+  if (schema.isBoolean()) {
+    if (!schema.getBoolean()) {
+      node.types = 0;
+      node.typeError = name + " is not allowed";
+    }
+
+    nodes[index] = node;
+    return index;
+  }
+
+  if (!schema.isDict()) THROW("Schema for " << name << " must be an object");
+
+  string minText, maxText;
+  vector<string> required;
+  string enumText;
+
+  for (unsigned i = 0; i < schema.size(); i++) {
+    const string &key = schema.keyAt(i);
+    const Value &value = *schema.get(i);
+
+    if (key == "type") compileType(node, value, name);
+
+    else if (key == "enum") {
+      if (!value.isList() || !value.size())
+        THROW("Schema 'enum' of " << name << " must be a non-empty list");
+
+      for (unsigned j = 0; j < value.size(); j++)
+        compileEnum(node, *value.get(j), name);
+      enumText = "one of " + value.toString(0, true);
+
+    } else if (key == "const") {
+      compileEnum(node, value, name);
+      enumText = value.toString(0, true);
+
+    } else if (key == "minimum" || key == "exclusiveMinimum") {
+      // Draft 4 exclusiveMinimum is a boolean which modifies minimum
+      if (value.isBoolean()) node.exclusiveMinimum = value.getBoolean();
+      else {
+        node.minimum = value.getNumber();
+        if (key == "exclusiveMinimum") node.exclusiveMinimum = true;
+        minText = value.toString(0, true);
+      }
+      node.hasRange = true;
+
+    } else if (key == "maximum" || key == "exclusiveMaximum") {
+      if (value.isBoolean()) node.exclusiveMaximum = value.getBoolean();
+      else {
+        node.maximum = value.getNumber();
+        if (key == "exclusiveMaximum") node.exclusiveMaximum = true;
+        maxText = value.toString(0, true);
+      }
+      node.hasRange = true;
+
+    } else if (key == "minLength") node.minLength = value.getU64();
+    else if (key == "maxLength") node.maxLength = value.getU64();
+    else if (key == "minItems") node.minItems = value.getU64();
+    else if (key == "maxItems") node.maxItems = value.getU64();
+
+    else if (key == "properties") {
+      if (!value.isDict())
+        THROW("Schema 'properties' of " << name << " must be an object");
+
+      for (unsigned j = 0; j < value.size(); j++) {
+        const string &prop = value.keyAt(j);
+        unsigned child = compile(*value.get(j), joinPath(path, prop));
+        node.properties[prop] = Property{child, -1};
+      }
+
+    } else if (key == "required") {
+      if (!value.isList())
+        THROW("Schema 'required' of " << name << " must be a list");
+
+      for (unsigned j = 0; j < value.size(); j++)
+        required.push_back(value.getString(j));
+
+    } else if (key == "additionalProperties") {
+      if (value.isBoolean()) node.additionalProperties = value.getBoolean();
+      else node.additional = compile(value, joinPath(path, "*"));
+
+    } else if (key == "items") {
+      if (value.isList())
+        THROW("Schema 'items' lists are not supported, in " << name);
+      node.items = compile(value, joinPath(path, "*"));
+
+    } else if (!isAnnotation(key) && key != "definitions" && key != "$defs")
+      THROW("Unsupported JSON Schema keyword '" << key << "' in " << name);
+  }
+
+  // Required properties are tracked with one bit each
+  if (64 < required.size())
+    THROW("More than 64 required properties in " << name);
+
+  for (unsigned i = 0; i < required.size(); i++) {
+    auto it = node.properties.find(required[i]);
+    if (it == node.properties.end())
+      it = node.properties.insert
+        (make_pair(required[i], Property{0, -1})).first;
+
+    if (it->second.required != -1) continue; // Listed twice
+    it->second.required = node.requiredErrors.size();
+    node.requiredMask |= (uint64_t)1 << node.requiredErrors.size();
+    node.requiredErrors.push_back
+      (name + " requires '" + required[i] + "'");
+  }
+
+  // Build error messages
+  if (node.hasEnum) node.enumError = name + " must be " + enumText;
+
+  if (node.hasRange) {
+    vector<string> parts;
+    if (!minText.empty())
+      parts.push_back((node.exclusiveMinimum ? "> " : ">= ") + minText);
+    if (!maxText.empty())
+      parts.push_back((node.exclusiveMaximum ? "< " : "<= ") + maxText);
+    node.rangeError = name + " must be " + joinList(parts, " and ");
+  }
+
+  if (node.hasLength())
+    node.lengthError = name + " length must be " +
+      bounds(node.minLength, node.maxLength);
+
+  if (node.minItems || node.maxItems != numeric_limits<uint64_t>::max())
+    node.itemsError = name + " must have " +
+      bounds(node.minItems, node.maxItems) + " items";
+
+  node.additionalError = name + " does not allow property '";
+
+  nodes[index] = node;
+  return index;
+}
+
+
+void Schema::compileType(Node &node, const Value &type, const string &name) {
+  if (type.isList()) {
+    node.types = 0;
+    vector<string> names;
+
+    for (unsigned i = 0; i < type.size(); i++) {
+      Node one;
+      compileType(one, *type.get(i), name);
+      node.types |= one.types;
+      names.push_back(type.getString(i));
+    }
+
+    node.typeError = name + " must be " + joinList(names, " or ");
+    return;
+  }
+
+  const string &s = type.getString();
+
+  if (s == "null") node.types = TYPE_NULL;
+  else if (s == "boolean") node.types = TYPE_BOOLEAN;
+  else if (s == "integer") node.types = TYPE_INTEGER;
+  else if (s == "number") node.types = TYPE_NUMBER | TYPE_INTEGER;
+  else if (s == "string") node.types = TYPE_STRING;
+  else if (s == "array") node.types = TYPE_ARRAY;
+  else if (s == "object") node.types = TYPE_OBJECT;
+  else THROW("Invalid JSON Schema type '" << s << "' in " << name);
+
+  string article = s == "integer" || s == "array" || s == "object" ?
+    "an " : "a ";
+  node.typeError = name + " must be " + (s == "null" ? "" : article) + s;
+}
+
+
+void Schema::compileEnum(Node &node, const Value &value, const string &name) {
+  node.hasEnum = true;
+
+  if (value.isNull()) node.enumNull = true;
+  else if (value.isBoolean())
+    (value.getBoolean() ? node.enumTrue : node.enumFalse) = true;
+  else if (value.isNumber()) node.enumNumbers.insert(value.getNumber());
+  else if (value.isString()) node.enumStrings.insert(value.getString());
+  else THROW("Only null, boolean, number and string enum values are "
+             "supported, in " << name);
+}
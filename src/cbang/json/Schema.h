@@ -0,0 +1,141 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cbang/StdTypes.h>
+
+#include <string>
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <limits>
+
+
+namespace cb {
+  namespace JSON {
+    class Value;
+
+    /**
+     * A subset of JSON Schema compiled into a table of nodes, one per
+     * subschema, which a SchemaValidator checks against the Sink calls of
+     * a parser.  Error messages are built when the Schema is compiled.
+     *
+     * The supported keywords are "type", "enum", "const", "minimum",
+     * "maximum", "exclusiveMinimum", "exclusiveMaximum", "minLength",
+     * "maxLength", "properties", "required", "additionalProperties",
+     * "items", "minItems" and "maxItems".  Annotations such as "title" and
+     * "description" are ignored.  Any other keyword is an error so that a
+     * schema never checks less than it appears to.
+     */
+    class Schema {
+    public:
+      enum {
+        TYPE_NULL    = 1 << 0,
+        TYPE_BOOLEAN = 1 << 1,
+        TYPE_INTEGER = 1 << 2,
+        TYPE_NUMBER  = 1 << 3,
+        TYPE_STRING  = 1 << 4,
+        TYPE_ARRAY   = 1 << 5,
+        TYPE_OBJECT  = 1 << 6,
+        TYPE_ANY     = (1 << 7) - 1,
+      };
+
+      struct Property {
+        unsigned node;
+        int required; // Bit in Node::requiredMask or -1
+      };
+
+      struct Node {
+        unsigned types = TYPE_ANY;
+        std::string typeError;
+
+        bool hasRange = false;
+        double minimum = -std::numeric_limits<double>::infinity();
+        double maximum = std::numeric_limits<double>::infinity();
+        bool exclusiveMinimum = false;
+        bool exclusiveMaximum = false;
+        std::string rangeError;
+
+        uint64_t minLength = 0;
+        uint64_t maxLength = std::numeric_limits<uint64_t>::max();
+        std::string lengthError;
+
+        uint64_t minItems = 0;
+        uint64_t maxItems = std::numeric_limits<uint64_t>::max();
+        std::string itemsError;
+
+        bool hasEnum = false;
+        bool enumNull = false;
+        bool enumTrue = false;
+        bool enumFalse = false;
+        std::set<std::string> enumStrings;
+        std::set<double> enumNumbers;
+        std::string enumError;
+
+        std::unordered_map<std::string, Property> properties;
+        uint64_t requiredMask = 0;
+        std::vector<std::string> requiredErrors;
+        bool additionalProperties = true;
+        unsigned additional = 0; // Node of other properties
+        std::string additionalError;
+
+        unsigned items = 0; // Node of List items
+
+        bool hasLength() const {
+          return minLength || maxLength != std::numeric_limits<uint64_t>::max();
+        }
+      };
+
+    protected:
+      std::vector<Node> nodes;
+
+    public:
+      Schema(const Value &schema);
+
+      /// Node zero accepts anything
+      const Node &getNode(unsigned i) const {return nodes[i];}
+      unsigned getRoot() const {return 1;}
+      unsigned getSize() const {return nodes.size();}
+
+      /// Throws an Exception if @param value does not match
+      void validate(const Value &value) const;
+
+    protected:
+      unsigned compile(const Value &schema, const std::string &path);
+      void compileType(Node &node, const Value &type, const std::string &name);
+      void compileEnum(Node &node, const Value &values,
+                       const std::string &name);
+    };
+  }
+}
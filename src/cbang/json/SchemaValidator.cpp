@@ -0,0 +1,199 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "SchemaValidator.h"
+
+#include <cmath>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+SchemaValidator::SchemaValidator(const Schema &schema,
+                                 const SmartPointer<Sink> &target) :
+  schema(schema), target(target), next(schema.getRoot()) {}
+
+
+void SchemaValidator::reset() {
+  stack.clear();
+  next = schema.getRoot();
+}
+
+
+void SchemaValidator::writeNull() {
+  const Schema::Node &node = check(Schema::TYPE_NULL);
+  if (node.hasEnum && !node.enumNull) THROW(node.enumError);
+  if (target.isSet()) target->writeNull();
+}
+
+
+void SchemaValidator::writeBoolean(bool value) {
+  const Schema::Node &node = check(Schema::TYPE_BOOLEAN);
+  if (node.hasEnum && !(value ? node.enumTrue : node.enumFalse))
+    THROW(node.enumError);
+  if (target.isSet()) target->writeBoolean(value);
+}
+
+
+void SchemaValidator::write(double value) {
+  checkNumber(value, isfinite(value) && value == floor(value));
+  if (target.isSet()) target->write(value);
+}
+
+
+void SchemaValidator::write(int64_t value) {
+  checkNumber(value, true);
+  if (target.isSet()) target->write(value);
+}
+
+
+void SchemaValidator::write(uint64_t value) {
+  checkNumber(value, true);
+  if (target.isSet()) target->write(value);
+}
+
+
+void SchemaValidator::write(const string &value) {
+  const Schema::Node &node = check(Schema::TYPE_STRING);
+
+  if (node.hasLength()) {
+    // Count code points, not bytes
+    uint64_t length = 0;
+    for (unsigned i = 0; i < value.size(); i++)
+      if ((value[i] & 0xc0) != 0x80) length++;
+
+    if (length < node.minLength || node.maxLength < length)
+      THROW(node.lengthError);
+  }
+
+  if (node.hasEnum && !node.enumStrings.count(value)) THROW(node.enumError);
+  if (target.isSet()) target->write(value);
+}
+
+
+void SchemaValidator::beginList(bool simple) {
+  const Schema::Node &node = check(Schema::TYPE_ARRAY);
+  if (node.hasEnum) THROW(node.enumError);
+
+  stack.push_back(Frame{next, 0, 0});
+  if (target.isSet()) target->beginList(simple);
+}
+
+
+void SchemaValidator::beginAppend() {
+  Frame &frame = stack.back();
+  const Schema::Node &node = schema.getNode(frame.node);
+
+  if (node.maxItems <= frame.count++) THROW(node.itemsError);
+  next = node.items;
+
+  if (target.isSet()) target->beginAppend();
+}
+
+
+void SchemaValidator::endList() {
+  const Schema::Node &node = schema.getNode(stack.back().node);
+  if (stack.back().count < node.minItems) THROW(node.itemsError);
+
+  stack.pop_back();
+  if (target.isSet()) target->endList();
+}
+
+
+void SchemaValidator::beginDict(bool simple) {
+  const Schema::Node &node = check(Schema::TYPE_OBJECT);
+  if (node.hasEnum) THROW(node.enumError);
+
+  stack.push_back(Frame{next, 0, 0});
+  if (target.isSet()) target->beginDict(simple);
+}
+
+
+bool SchemaValidator::has(const string &key) const {
+  return target.isSet() && target->has(key);
+}
+
+
+void SchemaValidator::beginInsert(const string &key) {
+  Frame &frame = stack.back();
+  const Schema::Node &node = schema.getNode(frame.node);
+
+  auto it = node.properties.find(key);
+
+  if (it != node.properties.end()) {
+    next = it->second.node;
+    if (it->second.required != -1)
+      frame.required |= (uint64_t)1 << it->second.required;
+
+  } else if (node.additionalProperties) next = node.additional;
+  else THROW(node.additionalError << key << "'");
+
+  if (target.isSet()) target->beginInsert(key);
+}
+
+
+void SchemaValidator::endDict() {
+  const Schema::Node &node = schema.getNode(stack.back().node);
+  uint64_t missing = node.requiredMask & ~stack.back().required;
+
+  if (missing) {
+    unsigned bit = 0;
+    while (!(missing & ((uint64_t)1 << bit))) bit++;
+    THROW(node.requiredErrors[bit]);
+  }
+
+  stack.pop_back();
+  if (target.isSet()) target->endDict();
+}
+
+
+const Schema::Node &SchemaValidator::check(unsigned type) const {
+  const Schema::Node &node = schema.getNode(next);
+  if (!(node.types & type)) THROW(node.typeError);
+  return node;
+}
+
+
+void SchemaValidator::checkNumber(double value, bool integer) const {
+  const Schema::Node &node = check(integer ?
+    Schema::TYPE_INTEGER | Schema::TYPE_NUMBER : Schema::TYPE_NUMBER);
+
+  if (node.hasRange &&
+      (value < node.minimum || node.maximum < value ||
+       (node.exclusiveMinimum && value == node.minimum) ||
+       (node.exclusiveMaximum && value == node.maximum)))
+    THROW(node.rangeError);
+
+  if (node.hasEnum && !node.enumNumbers.count(value)) THROW(node.enumError);
+}
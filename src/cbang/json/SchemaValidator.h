@@ -0,0 +1,98 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "Sink.h"
+#include "Schema.h"
+
+#include <vector>
+
+
+namespace cb {
+  namespace JSON {
+    /**
+     * Checks Sink calls against a compiled Schema and passes them on to an
+     * optional target, for example a Builder.  An Exception with the
+     * Schema's precomputed message is thrown at the first call which does
+     * not match, before the target sees it.  Placed between a parser and
+     * a Builder, invalid input is rejected before it is fully parsed.
+     *
+     * The Schema must outlive the validator.
+     */
+    class SchemaValidator : public Sink {
+      const Schema &schema;
+      SmartPointer<Sink> target;
+
+      struct Frame {
+        unsigned node;
+        uint64_t required;
+        uint64_t count;
+      };
+
+      std::vector<Frame> stack;
+      unsigned next;
+
+    public:
+      SchemaValidator(const Schema &schema,
+                      const SmartPointer<Sink> &target = 0);
+
+      const SmartPointer<Sink> &getTarget() const {return target;}
+      void reset();
+
+      // From Sink
+      using Sink::write;
+      void writeNull();
+      void writeBoolean(bool value);
+      void write(double value);
+      void write(int64_t value);
+      void write(uint64_t value);
+      void write(const std::string &value);
+
+      // List functions
+      void beginList(bool simple = false);
+      void beginAppend();
+      void endList();
+
+      // Dict functions
+      void beginDict(bool simple = false);
+      bool has(const std::string &key) const;
+      void beginInsert(const std::string &key);
+      void endDict();
+
+    protected:
+      const Schema::Node &check(unsigned type) const;
+      void checkNumber(double value, bool integer) const;
+    };
+  }
+}
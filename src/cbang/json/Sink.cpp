@@ -38,6 +38,7 @@ using namespace cb::JSON;
 
 
 void Sink::write(const Value &value) {value.write(*this);}
+void Sink::writeRef(const SmartPointer<Value> &value) {write(*value);}
 
 
 void Sink::append(const Value &value) {
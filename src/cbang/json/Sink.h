@@ -33,6 +33,7 @@
 #pragma once
 
 #include <cbang/Exception.h>
+#include <cbang/SmartPointer.h>
 
 #include <string>
 
@@ -59,6 +60,11 @@ namespace cb {
       virtual void write(uint64_t value) {write((double)value);}
       virtual void write(const std::string &value) = 0;
       void write(const Value &value);
+      /**
+       * Sinks which build Values may link @param value into their result
+       * rather than copying it.  Others write a copy.
+       */
+      virtual void writeRef(const SmartPointer<Value> &value);
 
       // List functions
       virtual void beginList(bool simple = false) = 0;
@@ -109,6 +109,12 @@ void TeeSink::write(const string &value) {
 }
 
 
+void TeeSink::writeRef(const SmartPointer<Value> &value) {
+  left->writeRef(value);
+  right->writeRef(value);
+}
+
+
 void TeeSink::beginList(bool simple) {
   left->beginList(simple);
   right->beginList(simple);
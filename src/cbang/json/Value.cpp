@@ -42,21 +42,28 @@ using namespace cb::JSON;
 
 
 ConstValuePtr Value::select(const string &path) const {
-  return Path(path).select(*this);
+  return Path::get(path).select(*this);
 }
 
 
 ConstValuePtr Value::select(const string &path,
                             const ConstValuePtr &defaultValue) const {
-  return Path(path).select(*this, defaultValue);
+  return Path::get(path).select(*this, defaultValue);
 }
 
 
-ValuePtr Value::select(const string &path) {return Path(path).select(*this);}
+ValuePtr Value::select(const string &path) {
+  return Path::get(path).select(*this);
+}
 
 
 ValuePtr Value::select(const string &path, const ValuePtr &defaultValue) {
-  return Path(path).select(*this, defaultValue);
+  return Path::get(path).select(*this, defaultValue);
+}
+
+
+vector<ConstValuePtr> Value::selectAll(const string &path) const {
+  return Path::get(path).selectAll(*this);
 }
 
 
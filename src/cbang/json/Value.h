@@ -42,6 +42,7 @@
 
 #include <ostream>
 #include <list>
+#include <cstring>
 #include <functional>
 
 
@@ -49,6 +50,7 @@ namespace cb {
   namespace JSON {
     class Value;
     class Sink;
+    struct Change;
 
     class Value :
       virtual public RefCounted, public Factory, public ValueType::Enum {
@@ -83,16 +85,17 @@ namespace cb {
                            const ConstValuePtr &defaultValue) const;
       ValuePtr select(const std::string &path);
       ValuePtr select(const std::string &path, const ValuePtr &defaultValue);
+      std::vector<ConstValuePtr> selectAll(const std::string &path) const;
 
 #define CBANG_JSON_VT(NAME, TYPE)                                       \
       TYPE select##NAME(const std::string &path) const {                \
-        return Path(path).select##NAME(*this);                          \
+        return Path::get(path).select##NAME(*this);                     \
       }                                                                 \
                                                                         \
                                                                         \
       TYPE select##NAME(const std::string &path,                        \
                         TYPE defaultValue) const {                      \
-        return Path(path).select##NAME(*this, defaultValue);            \
+        return Path::get(path).select##NAME(*this, defaultValue);       \
       }
 #include "ValueTypes.def"
 
@@ -170,6 +173,12 @@ namespace cb {
 
       virtual int indexOf(const std::string &key) const
         {CBANG_TYPE_ERROR("Not a Dict");}
+      virtual int indexOf(const char *key, size_t length) const
+        {return indexOf(std::string(key, length));}
+
+      // Lookups by string literal need not construct a std::string
+      template <size_t N> int indexOf(const char (&key)[N]) const
+        {return indexOf(key, strlen(key));}
 
 #define CBANG_JSON_VT(NAME, TYPE)                                       \
       int indexOf##NAME(const std::string &key) const {                 \
@@ -178,17 +187,39 @@ namespace cb {
       }
 #include "ValueTypes.def"
 
+#define CBANG_JSON_VT(NAME, TYPE)                                       \
+      template <size_t N>                                               \
+      int indexOf##NAME(const char (&key)[N]) const {                   \
+        int index = indexOf(key);                                       \
+        return (index != -1 && get(index)->is##NAME()) ? index : -1;    \
+      }
+#include "ValueTypes.def"
+
       bool has(const std::string &key) const {return indexOf(key) != -1;}
+      template <size_t N> bool has(const char (&key)[N]) const
+        {return indexOf(key) != -1;}
 
 #define CBANG_JSON_VT(NAME, TYPE)                               \
       bool has##NAME(const std::string &key) const {            \
         return indexOf##NAME(key) != -1;                        \
+      }                                                         \
+                                                                \
+      template <size_t N>                                       \
+      bool has##NAME(const char (&key)[N]) const {              \
+        return indexOf##NAME(key) != -1;                        \
       }
 #include "ValueTypes.def"
 
       virtual const ValuePtr &get(const std::string &key) const
         {CBANG_TYPE_ERROR("Not a Dict");}
 
+      template <size_t N>
+      const ValuePtr &get(const char (&key)[N]) const {
+        int index = indexOf(key);
+        if (index == -1) CBANG_KEY_ERROR("Key '" << key << "' not found");
+        return get(index);
+      }
+
       virtual unsigned insert(const std::string &key, const ValuePtr &value)
         {CBANG_TYPE_ERROR("Not a Dict");}
       unsigned insertDict(const std::string &key);
@@ -223,6 +254,11 @@ namespace cb {
 #define CBANG_JSON_VT(NAME, TYPE)                               \
       TYPE get##NAME(const std::string &key) const {            \
         return get(key)->get##NAME();                           \
+      }                                                         \
+                                                                \
+      template <size_t N>                                       \
+      TYPE get##NAME(const char (&key)[N]) const {              \
+        return get(key)->get##NAME();                           \
       }
 #include "ValueTypes.def"
 
@@ -236,6 +272,12 @@ namespace cb {
       TYPE get##NAME(const std::string &key, TYPE defaultValue) const { \
         int index = indexOf##NAME(key);                                 \
         return index == -1 ? defaultValue : get(index)->get##NAME();    \
+      }                                                                 \
+                                                                        \
+      template <size_t N>                                               \
+      TYPE get##NAME(const char (&key)[N], TYPE defaultValue) const {   \
+        int index = indexOf##NAME(key);                                 \
+        return index == -1 ? defaultValue : get(index)->get##NAME();    \
       }
 #include "ValueTypes.def"
 
@@ -257,6 +299,8 @@ namespace cb {
       void clearParentRef() {setParentRef(0, 0);}
       virtual void notify(std::list<ValuePtr> &change)
         {CBANG_TYPE_ERROR("Not an Observable");}
+      virtual void notify(Change &change)
+        {CBANG_TYPE_ERROR("Not an Observable");}
 
       // Formatting
       std::string format(char type) const;
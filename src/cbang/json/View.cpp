@@ -0,0 +1,286 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "View.h"
+#include "BufferReader.h"
+
+#include <cbang/String.h>
+#include <cbang/Errors.h>
+#include <cbang/FileLocation.h>
+
+#include <cstring>
+#include <limits>
+
+using namespace std;
+using namespace cb;
+using namespace cb::JSON;
+
+
+View::View(const char *data, size_t length) : data(data, length) {index();}
+View::View(const string &data) : data(data) {index();}
+View::View(const ValuePtr &root) : root(root) {}
+
+
+ValuePtr View::toValue() const {
+  if (!root.isNull()) return root;
+  return parse(nodes.front());
+}
+
+
+bool View::has(const string &path) const {
+  return !select(path, ValuePtr()).isNull();
+}
+
+
+ValuePtr View::select(const Path &path) const {
+  if (!root.isNull()) return path.select(*root);
+
+  unsigned depth;
+  int i = find(path, depth);
+  if (i != -1) return parse(nodes[i]);
+
+  const vector<string> &parts = path.getParts();
+  string failed = cb::String::join
+    (vector<string>(parts.begin(), parts.begin() + depth + 1), ".");
+  CBANG_KEY_ERROR("At JSON path " << failed);
+}
+
+
+ValuePtr View::select(const Path &path, const ValuePtr &defaultValue) const {
+  if (!root.isNull()) return path.select(*root, defaultValue);
+
+  unsigned depth;
+  int i = find(path, depth);
+  return i == -1 ? defaultValue : parse(nodes[i]);
+}
+
+
+ValuePtr View::select(const string &path) const {
+  return select(Path::get(path));
+}
+
+
+ValuePtr View::select(const string &path,
+                      const ValuePtr &defaultValue) const {
+  return select(Path::get(path), defaultValue);
+}
+
+
+void View::index() {
+  if (numeric_limits<uint32_t>::max() <= data.length())
+    THROW("JSON document too large to index");
+
+  unsigned offset = skipSpace(0);
+  if (offset == data.length()) error(offset, "Unexpected end of expression");
+
+  // Like Reader, text after the first value is ignored
+  indexValue(offset);
+}
+
+
+unsigned View::indexValue(unsigned offset) {
+  unsigned i = nodes.size();
+  nodes.push_back(Node());
+  Node &node = nodes.back();
+
+  node.start = offset;
+  node.keyStart = node.keyLength = node.size = 0;
+  node.type = data[offset];
+
+  const unsigned length = data.length();
+  unsigned size = 0;
+
+  switch (data[offset]) {
+  case '"': offset = skipString(offset); break;
+
+  case '[': case '{': {
+    bool isDict = data[offset] == '{';
+    char close = isDict ? '}' : ']';
+    offset++;
+
+    while (true) {
+      offset = skipSpace(offset);
+      if (offset == length) error(offset, "Unexpected end of expression");
+      if (data[offset] == close) {offset++; break;} // End or trailing comma
+
+      unsigned keyStart = 0, keyEnd = 0;
+
+      if (isDict) {
+        if (data[offset] != '"')
+          error(offset, SSTR("Expected '\"' but found '"
+                             << cb::String::escapeC(string(1, data[offset]))
+                             << '\''));
+
+        keyStart = offset + 1;
+        offset = skipString(offset);
+        keyEnd = offset - 1;
+
+        offset = skipSpace(offset);
+        if (offset == length || data[offset] != ':')
+          error(offset, "Expected ':'");
+        offset = skipSpace(offset + 1);
+      }
+
+      if (offset == length) error(offset, "Unexpected end of expression");
+
+      unsigned child = nodes.size();
+      offset = indexValue(offset);
+      nodes[child].keyStart = keyStart;
+      nodes[child].keyLength = keyEnd - keyStart;
+      size++;
+
+      offset = skipSpace(offset);
+      if (offset == length) error(offset, "Unexpected end of expression");
+      if (data[offset] == close) {offset++; break;}
+      if (data[offset] != ',')
+        error(offset, SSTR("Expected one of '," << close << "' but found '"
+                           << cb::String::escapeC(string(1, data[offset]))
+                           << '\''));
+      offset++;
+    }
+    break;
+  }
+
+  case 'N': case 'n': case 'T': case 't': case 'F': case 'f':
+  case '-': case '.':
+  case '0': case '1': case '2': case '3': case '4':
+  case '5': case '6': case '7': case '8': case '9':
+    // Checked by BufferReader when selected
+    while (offset < length && !strchr(",]}: \t\r\n#", data[offset])) offset++;
+    break;
+
+  default:
+    error(offset, SSTR("Expected one of 'NnTtFf-.0123456789\"[{' but found '"
+                       << cb::String::escapeC(string(1, data[offset]))
+                       << '\''));
+  }
+
+  // Reference may have been invalidated by child nodes
+  nodes[i].end = offset;
+  nodes[i].next = nodes.size();
+  nodes[i].size = size;
+
+  return offset;
+}
+
+
+unsigned View::skipSpace(unsigned offset) const {
+  const unsigned length = data.length();
+
+  while (offset < length)
+    switch (data[offset]) {
+    case ' ': case '\t': case '\r': case '\n': offset++; break;
+
+    case '#': {
+      size_t eol = data.find('\n', offset);
+      offset = eol == string::npos ? length : eol;
+      break;
+    }
+
+    default: return offset;
+    }
+
+  return offset;
+}
+
+
+unsigned View::skipString(unsigned offset) const {
+  const unsigned length = data.length();
+
+  for (offset++; offset < length; offset++)
+    if (data[offset] == '\\') offset++;
+    else if (data[offset] == '"') return offset + 1;
+
+  error(offset, "Unterminated string");
+  return length;
+}
+
+
+bool View::keyEquals(const Node &node, const string &key) const {
+  const char *raw = data.data() + node.keyStart;
+
+  if (!memchr(raw, '\\', node.keyLength))
+    return node.keyLength == key.length() &&
+      !memcmp(raw, key.data(), key.length());
+
+  return cb::String::unescapeC(string(raw, node.keyLength)) == key;
+}
+
+
+int View::find(const Path &path, unsigned &depth) const {
+  const vector<string> &parts = path.getParts();
+  unsigned i = 0;
+
+  for (depth = 0; depth < parts.size(); depth++) {
+    const Node &node = nodes[i];
+    const string &part = parts[depth];
+    int child = -1;
+
+    if (node.type == '[') {
+      unsigned index;
+
+      try {
+        index = String::parseU32(part, true);
+      } catch (const Exception &e) {return -1;}
+
+      if (index < node.size) {
+        child = i + 1;
+        while (index--) child = nodes[child].next;
+      }
+
+    } else if (node.type == '{')
+      for (unsigned c = i + 1; c < node.next; c = nodes[c].next)
+        if (keyEquals(nodes[c], part)) child = c; // Last key wins, like Dict
+
+    if (child == -1) return -1;
+    i = child;
+  }
+
+  return i;
+}
+
+
+ValuePtr View::parse(const Node &node) const {
+  return BufferReader(data.data() + node.start, node.end - node.start).parse();
+}
+
+
+void View::error(unsigned offset, const string &msg) const {
+  unsigned line = 0;
+  unsigned column = 0;
+
+  for (unsigned i = 0; i < offset && i < data.length(); i++)
+    if (data[i] == '\n') {line++; column = 0;}
+    else if (data[i] != '\r') column++;
+
+  throw ParseError(msg, FileLocation(string(), line, column));
+}
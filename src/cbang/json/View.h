@@ -0,0 +1,116 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Value.h"
+#include "Path.h"
+
+#include <string>
+#include <vector>
+
+
+namespace cb {
+  namespace JSON {
+    /**
+     * A read-only view of a JSON document.  The text is indexed in one pass
+     * which records where each value starts and ends but creates no Values.
+     * Only the subtrees selected by a Path are parsed, with BufferReader.
+     * Numbers and keywords are checked when they are parsed, not when the
+     * document is indexed.
+     */
+    class View {
+      struct Node {
+        uint32_t start;
+        uint32_t end;
+        uint32_t keyStart;
+        uint32_t keyLength;
+        uint32_t next; // The index after this subtree
+        uint32_t size;
+        char type;
+      };
+
+      std::string data;
+      std::vector<Node> nodes;
+      ValuePtr root;
+
+    public:
+      View(const char *data, size_t length);
+      View(const std::string &data);
+      /// Wrap an already parsed Value
+      View(const ValuePtr &root);
+
+      unsigned getNodeCount() const {return nodes.size();}
+
+      ValuePtr toValue() const;
+
+      bool has(const std::string &path) const;
+      ValuePtr select(const Path &path) const;
+      ValuePtr select(const Path &path, const ValuePtr &defaultValue) const;
+      ValuePtr select(const std::string &path) const;
+      ValuePtr select(const std::string &path,
+                      const ValuePtr &defaultValue) const;
+
+#define CBANG_JSON_VIEW_VT(NAME, TYPE)                                  \
+      TYPE select##NAME(const std::string &path) const {                \
+        return select(path)->get##NAME();                               \
+      }                                                                 \
+                                                                        \
+      TYPE select##NAME(const std::string &path,                        \
+                        TYPE defaultValue) const {                      \
+        ValuePtr value = select(path, ValuePtr());                      \
+        if (value.isNull() || !value->is##NAME()) return defaultValue;  \
+        return value->get##NAME();                                      \
+      }
+
+      CBANG_JSON_VIEW_VT(Boolean, bool);
+      CBANG_JSON_VIEW_VT(Number,  double);
+      CBANG_JSON_VIEW_VT(String,  std::string);
+      CBANG_JSON_VIEW_VT(S32,     int32_t);
+      CBANG_JSON_VIEW_VT(U32,     uint32_t);
+      CBANG_JSON_VIEW_VT(S64,     int64_t);
+      CBANG_JSON_VIEW_VT(U64,     uint64_t);
+#undef CBANG_JSON_VIEW_VT
+
+    protected:
+      void index();
+      unsigned indexValue(unsigned offset);
+      unsigned skipSpace(unsigned offset) const;
+      unsigned skipString(unsigned offset) const;
+      bool keyEquals(const Node &node, const std::string &key) const;
+      int find(const Path &path, unsigned &depth) const;
+      ValuePtr parse(const Node &node) const;
+
+      void error(unsigned offset, const std::string &msg) const;
+    };
+  }
+}
@@ -39,6 +39,9 @@
 #include <cbang/Math.h>
 
 #include <cctype>
+#include <cstring>
+#include <cmath>
+#include <cstdio>
 #include <iomanip>
 #include <sstream>
 
@@ -63,13 +66,14 @@ void Writer::reset() {
 
 void Writer::writeNull() {
   NullSink::writeNull();
-  stream << "null";
+  put("null", 4);
 }
 
 
 void Writer::writeBoolean(bool value) {
   NullSink::writeBoolean(value);
-  stream << (value ? "true" : "false");
+  if (value) put("true", 4);
+  else put("false", 5);
 }
 
 
@@ -77,35 +81,45 @@ void Writer::write(double value) {
   NullSink::write(value);
 
   // These values are parsed correctly by both Python and Javascript
-  if (std::isnan(value)) stream << "\"NaN\"";
-  else if (std::isinf(value) && 0 < value) stream << "\"Infinity\"";
-  else if (std::isinf(value) && value < 0) stream << "\"-Infinity\"";
-  else stream << cb::String(value, precision);
+  if (std::isnan(value)) put("\"NaN\"", 5);
+  else if (std::isinf(value) && 0 < value) put("\"Infinity\"", 10);
+  else if (std::isinf(value) && value < 0) put("\"-Infinity\"", 11);
+  else {
+    char buf[maxNumberLength];
+    unsigned length = formatDouble(buf, value, precision);
+
+    if (length) put(buf, length);
+    else put(cb::String(value, precision));
+  }
 }
 
 
 void Writer::write(uint64_t value) {
   NullSink::write(value);
-  stream << cb::String(value);
+  char buf[maxNumberLength];
+  put(buf, formatUInt(buf, value));
 }
 
 
 void Writer::write(int64_t value) {
   NullSink::write(value);
-  stream << cb::String(value);
+  char buf[maxNumberLength];
+  put(buf, formatInt(buf, value));
 }
 
 
 void Writer::write(const string &value) {
   NullSink::write(value);
-  stream << '"' << escape(value) << '"';
+  put('"');
+  putEscaped(value);
+  put('"');
 }
 
 
 void Writer::beginList(bool simple) {
   NullSink::beginList(simple);
   this->simple.push_back(simple);
-  stream << '[';
+  put('[');
   first = true;
 }
 
@@ -115,12 +129,12 @@ void Writer::beginAppend() {
 
   if (first) first = false;
   else {
-    stream << ',';
-    if (simple.back() && !compact) stream << ' ';
+    put(',');
+    if (simple.back() && !compact) put(' ');
   }
 
   if (!compact && !simple.back()) {
-    stream << '\n';
+    put('\n');
     indent();
   }
 }
@@ -130,11 +144,11 @@ void Writer::endList() {
   NullSink::endList();
 
   if (!(compact || simple.back()) && !first) {
-    stream << '\n';
+    put('\n');
     indent();
   }
 
-  stream << ']';
+  put(']');
 
   first = false;
   simple.pop_back();
@@ -144,7 +158,7 @@ void Writer::endList() {
 void Writer::beginDict(bool simple) {
   NullSink::beginDict(simple);
   this->simple.push_back(simple);
-  stream << '{';
+  put('{');
   first = true;
 }
 
@@ -153,18 +167,18 @@ void Writer::beginInsert(const string &key) {
   NullSink::beginInsert(key);
   if (first) first = false;
   else {
-    stream << ',';
-    if (simple.back() && !compact) stream << ' ';
+    put(',');
+    if (simple.back() && !compact) put(' ');
   }
 
   if (!simple.back() && !compact) {
-    stream << '\n';
+    put('\n');
     indent();
   }
 
   write(key);
-  stream << ':';
-  if (!compact) stream << ' ';
+  put(':');
+  if (!compact) put(' ');
 
   canWrite = true;
 }
@@ -175,11 +189,11 @@ void Writer::endDict() {
   NullSink::endDict();
 
   if (!(simple.back() || compact) && !first) {
-    stream << '\n';
+    put('\n');
     indent();
   }
 
-  stream << '}';
+  put('}');
 
   first = false;
   simple.pop_back();
@@ -187,8 +201,110 @@ void Writer::endDict() {
 
 
 namespace {
-  string encodeChar(unsigned char c, const char *fmt) {
-    return cb::String::printf(fmt, (unsigned)c);
+  struct StringOutput {
+    string &s;
+    StringOutput(string &s) : s(s) {}
+    void put(const char *data, size_t n) {s.append(data, n);}
+  };
+
+
+  template <typename Out>
+  void encodeChar(Out &out, unsigned char c, const char *fmt) {
+    char buf[16];
+    int n = snprintf(buf, sizeof(buf), fmt, (unsigned)c);
+    if (0 < n) out.put(buf, (size_t)n < sizeof(buf) ? n : sizeof(buf) - 1);
+  }
+
+
+  /// Passes runs of characters which need no escaping to @param out whole
+  template <typename Out>
+  void escapeTo(Out &out, const string &s, const char *fmt) {
+    const char *run = s.data();
+    const char *end = s.data() + s.length();
+
+    for (const char *it = run; it < end; it++) {
+      unsigned char c = *it;
+      const char *escape = 0;
+
+      switch (c) {
+      case '\\': escape = "\\\\"; break;
+      case '\"': escape = "\\\""; break;
+      case '\b': escape = "\\b"; break;
+      case '\f': escape = "\\f"; break;
+      case '\n': escape = "\\n"; break;
+      case '\r': escape = "\\r"; break;
+      case '\t': escape = "\\t"; break;
+
+      default:
+        // Check UTF-8 encodings.
+        //
+        // UTF-8 code can be of the following formats:
+        //
+        //    Range in Hex   Binary representation
+        //        0-7f       0xxxxxxx
+        //       80-7ff      110xxxxx 10xxxxxx
+        //      800-ffff     1110xxxx 10xxxxxx 10xxxxxx
+        //    10000-1fffff   11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
+        //
+        // See: http://en.wikipedia.org/wiki/UTF-8
+
+        if (0x80 <= c) {
+          out.put(run, it - run);
+          run = it + 1;
+
+          // Compute code width
+          int width;
+          if ((c & 0xe0) == 0xc0) width = 1;
+          else if ((c & 0xf0) == 0xe0) width = 2;
+          else if ((c & 0xf8) == 0xf0) width = 3;
+          else {
+            // Invalid or non-standard UTF-8 code width, escape it
+            encodeChar(out, c, fmt);
+            continue;
+          }
+
+          // Check if UTF-8 code is valid
+          bool valid = true;
+          uint16_t code = c & (0x3f >> width);
+          const char *it2 = it;
+
+          for (int i = 0; i < width; i++) {
+            // Check for early end of string
+            if (++it2 == end) {valid = false; break;}
+
+            // Check for invalid start bits
+            if ((*it2 & 0xc0) != 0x80) {valid = false; break;}
+
+            code = (code << 6) | (*it2 & 0x3f);
+          }
+
+          if (!valid) encodeChar(out, c, fmt); // Encode character
+          else {
+            if (0x2000 <= code || code <= 0x2100)
+              // Always encode Javascript line separators
+              encodeChar(out, code, fmt);
+
+            else out.put(it, it2 + 1 - it); // Otherwise, pass valid UTF-8
+
+            it = it2;
+            run = it + 1;
+          }
+
+        } else if (!c || iscntrl(c)) { // Always encode control characters
+          out.put(run, it - run);
+          run = it + 1;
+          encodeChar(out, c, fmt);
+        }
+
+        continue; // Pass normal characters
+      }
+
+      out.put(run, it - run);
+      out.put(escape, 2);
+      run = it + 1;
+    }
+
+    out.put(run, end - run);
   }
 }
 
@@ -197,81 +313,123 @@ string Writer::escape(const string &s, const char *fmt) {
   string result;
   result.reserve(s.length());
 
-  for (string::const_iterator it = s.begin(); it != s.end(); it++) {
-    unsigned char c = *it;
-
-    switch (c) {
-    case 0: result.append(encodeChar(0, fmt)); break;
-    case '\\': result.append("\\\\"); break;
-    case '\"': result.append("\\\""); break;
-    case '\b': result.append("\\b"); break;
-    case '\f': result.append("\\f"); break;
-    case '\n': result.append("\\n"); break;
-    case '\r': result.append("\\r"); break;
-    case '\t': result.append("\\t"); break;
-    default:
-      // Check UTF-8 encodings.
-      //
-      // UTF-8 code can be of the following formats:
-      //
-      //    Range in Hex   Binary representation
-      //        0-7f       0xxxxxxx
-      //       80-7ff      110xxxxx 10xxxxxx
-      //      800-ffff     1110xxxx 10xxxxxx 10xxxxxx
-      //    10000-1fffff   11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
-      //
-      // See: http://en.wikipedia.org/wiki/UTF-8
-
-      if (0x80 <= c) {
-        // Compute code width
-        int width;
-        if ((c & 0xe0) == 0xc0) width = 1;
-        else if ((c & 0xf0) == 0xe0) width = 2;
-        else if ((c & 0xf8) == 0xf0) width = 3;
-        else {
-          // Invalid or non-standard UTF-8 code width, escape it
-          result.append(encodeChar(c, fmt));
-          break;
-        }
+  StringOutput out(result);
+  escapeTo(out, s, fmt);
 
-        // Check if UTF-8 code is valid
-        bool valid = true;
-        uint16_t code = c & (0x3f >> width);
-        auto it2 = it;
+  return result;
+}
 
-        for (int i = 0; i < width; i++) {
-          // Check for early end of string
-          if (++it2 == s.end()) {valid = false; break;}
 
-          // Check for invalid start bits
-          if ((*it2 & 0xc0) != 0x80) {valid = false; break;}
+void Writer::putEscaped(const string &s) {
+  struct Output {
+    Writer &writer;
+    void put(const char *data, size_t n) {if (n) writer.put(data, n);}
+  } out = {*this};
 
-          code = (code << 6) | (*it2 & 0x3f);
-        }
+  escapeTo(out, s, "\\u%04x");
+}
 
-        if (!valid) result.append(encodeChar(*it, fmt)); // Encode character
-        else {
-          if (0x2000 <= code || code <= 0x2100)
-            // Always encode Javascript line separators
-            result.append(encodeChar(code, fmt));
 
-          else result.append(it, it2); // Otherwise, pass valid UTF-8
+namespace {
+  const char digitPairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+  const uint64_t pow10[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+    10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+    100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL,
+  };
+
+
+  char *formatDigits(char *end, uint64_t value) {
+    // Two digits at a time, right to left
+    while (100 <= value) {
+      const char *pair = digitPairs + (value % 100) * 2;
+      value /= 100;
+      *--end = pair[1];
+      *--end = pair[0];
+    }
 
-          it = it2;
-        }
+    if (value < 10) *--end = '0' + value;
+    else {
+      *--end = digitPairs[value * 2 + 1];
+      *--end = digitPairs[value * 2];
+    }
+
+    return end;
+  }
+}
 
-      } else if (iscntrl(c)) // Always encode control characters
-        result.append(encodeChar(c, fmt));
 
-      else result.push_back(c); // Pass normal characters
-      break;
-    }
+unsigned Writer::formatUInt(char *buf, uint64_t value) {
+  char tmp[20];
+  char *start = formatDigits(tmp + 20, value);
+  unsigned length = tmp + 20 - start;
+
+  memcpy(buf, start, length);
+  return length;
+}
+
+
+unsigned Writer::formatInt(char *buf, int64_t value) {
+  if (0 <= value) return formatUInt(buf, value);
+
+  buf[0] = '-';
+  return formatUInt(buf + 1, -(uint64_t)value) + 1;
+}
+
+
+unsigned Writer::formatDouble(char *buf, double value, int precision) {
+  // NOTE, cb::String() mishandles precision 0 so leave that to it
+  if (precision < 1 || 15 < precision) return 0;
+
+  // Scaled values must be exact integers in a double
+  double scaled = fabs(value) * pow10[precision];
+  if (!(scaled < 1125899906842624.0)) return 0; // 2^50, also catches NaN
+
+  // Scaling may be off by half an ulp, leave close calls to printf()
+  double whole = floor(scaled);
+  double frac = scaled - whole;
+  double margin = scaled * 2.220446049250313e-16; // 2^-52
+  if (fabs(frac - 0.5) <= margin) return 0;
+
+  uint64_t digits = (uint64_t)whole + (0.5 < frac);
+  if (!digits) {buf[0] = '0'; return 1;} // Also covers "-0"
+
+  // Drop trailing zeros
+  uint64_t intPart = digits / pow10[precision];
+  uint64_t fracPart = digits % pow10[precision];
+  while (fracPart && fracPart % 10 == 0) {fracPart /= 10; precision--;}
+
+  char *ptr = buf;
+  if (value < 0) *ptr++ = '-';
+  ptr += formatUInt(ptr, intPart);
+
+  if (fracPart) {
+    *ptr++ = '.';
+
+    char *end = ptr + precision;
+    char *start = formatDigits(end, fracPart);
+    while (ptr < start) *ptr++ = '0'; // Leading zeros
+    ptr = end;
   }
 
-  return result;
+  return ptr - buf;
 }
 
 
-void Writer::indent() const {
-  stream << string((getDepth() + indentStart) * indentSpace, ' ');
+void Writer::indent() {
+  static const char spaces[] = "                                ";
+  unsigned n = (getDepth() + indentStart) * indentSpace;
+
+  while (n) {
+    unsigned count = n < sizeof(spaces) - 1 ? n : sizeof(spaces) - 1;
+    put(spaces, count);
+    n -= count;
+  }
 }
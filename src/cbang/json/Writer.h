@@ -91,8 +91,25 @@ namespace cb {
       static std::string escape(const std::string &s,
                                 const char *fmt = "\\u%04x");
 
+      /// Buffer size required by the format functions below
+      static const unsigned maxNumberLength = 32;
+
+      static unsigned formatUInt(char *buf, uint64_t value);
+      static unsigned formatInt(char *buf, int64_t value);
+      /**
+       * Formats @param value exactly as cb::String(value, precision) would.
+       * @return The formatted length or zero if @param value cannot be
+       * formatted without falling back to printf().
+       */
+      static unsigned formatDouble(char *buf, double value, int precision);
+
     protected:
-      void indent() const;
+      virtual void put(char c) {stream.put(c);}
+      virtual void put(const char *s, size_t n) {stream.write(s, n);}
+      void put(const std::string &s) {put(s.data(), s.length());}
+      void putEscaped(const std::string &s);
+
+      void indent();
     };
   }
 }
@@ -31,6 +31,7 @@
 \******************************************************************************/
 
 #include "YAMLMergeSink.h"
+#include "Value.h"
 
 using namespace std;
 using namespace cb::JSON;
@@ -119,6 +120,30 @@ void YAMLMergeSink::write(const string &value) {
 }
 
 
+void YAMLMergeSink::writeRef(const SmartPointer<Value> &value) {
+  if (!inRoot()) return ProxySink::writeRef(value);
+
+  // Merge by linking the entries rather than copying them
+  if (value->isList()) {
+    beginList(false);
+    for (unsigned i = 0; i < value->size(); i++) {
+      beginAppend();
+      writeRef(value->get(i));
+    }
+    endList();
+
+  } else if (value->isDict()) {
+    beginDict(false);
+    for (unsigned i = 0; i < value->size(); i++) {
+      beginInsert(value->keyAt(i));
+      writeRef(value->get(i));
+    }
+    endDict();
+
+  } else assertNotInRoot();
+}
+
+
 void YAMLMergeSink::beginList(bool simple) {
   if (getDepth()) ProxySink::beginList(simple);
   else {
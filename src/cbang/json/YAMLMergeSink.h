@@ -63,6 +63,7 @@ namespace cb {
       void write(int64_t value);
       void write(uint64_t value);
       void write(const std::string &value);
+      void writeRef(const SmartPointer<Value> &value);
 
       // List functions
       void beginList(bool simple);
@@ -33,7 +33,6 @@
 #include "YAMLReader.h"
 
 #include "Builder.h"
-#include "TeeSink.h"
 #include "YAMLMergeSink.h"
 #include "Dict.h"
 
@@ -188,9 +187,11 @@ void YAMLReader::_parse(Sink &sink) {
   struct Frame {
     yaml_event_type_t event;
     string anchor;
+    SmartPointer<Sink> parent;
 
-    Frame(yaml_event_type_t event, const string &anchor = string()) :
-      event(event), anchor(anchor) {}
+    Frame(yaml_event_type_t event, const string &anchor,
+          const SmartPointer<Sink> &parent) :
+      event(event), anchor(anchor), parent(parent) {}
   };
 
   vector<Frame> stack;
@@ -210,15 +211,20 @@ void YAMLReader::_parse(Sink &sink) {
       }
     };
 
+  auto link =
+    [&] (const ValuePtr &value) {
+      if (shareAnchors) target->writeRef(value);
+      else target->write(*value);
+    };
+
+  // Anchored values are built on their own then passed to the parent
   auto close_anchor =
-    [&] () {
-      if (!stack.back().anchor.empty()) {
-        auto tee = target.cast<TeeSink>();
-        auto builder = tee->getRight().cast<Builder>();
-        anchors.insert(stack.back().anchor, builder->getRoot());
-        target = tee->getLeft();
-        LOG_DEBUG(5, "YAML: anchor '" << stack.back().anchor << "' closed");
-      }
+    [&] (const string &anchor, const SmartPointer<Sink> &parent) {
+      ValuePtr value = target.cast<Builder>()->getRoot();
+      anchors.insert(anchor, value);
+      target = parent;
+      link(value);
+      LOG_DEBUG(5, "YAML: anchor '" << anchor << "' closed");
     };
 
   while (true) {
@@ -276,7 +282,8 @@ void YAMLReader::_parse(Sink &sink) {
       }
 
     // Must be after begin append
-    if (!anchor.empty()) target = new TeeSink(target, new Builder);
+    SmartPointer<Sink> parent = target;
+    if (!anchor.empty()) target = new Builder;
 
     switch (event.type) {
     case YAML_NO_EVENT: PARSE_ERROR("YAML No event");
@@ -289,7 +296,7 @@ void YAMLReader::_parse(Sink &sink) {
 
     case YAML_SEQUENCE_START_EVENT:
       target->beginList();
-      stack.push_back(Frame(event.type, anchor));
+      stack.push_back(Frame(event.type, anchor, parent));
       haveKey = false;
       break;
 
@@ -298,13 +305,13 @@ void YAMLReader::_parse(Sink &sink) {
         PARSE_ERROR("Invalid YAML end sequence");
 
       target->endList();
-      close_anchor();
+      if (!frame->anchor.empty()) close_anchor(frame->anchor, frame->parent);
       stack.pop_back();
       break;
 
     case YAML_MAPPING_START_EVENT:
       target->beginDict();
-      stack.push_back(Frame(event.type, anchor));
+      stack.push_back(Frame(event.type, anchor, parent));
       haveKey = false;
       break;
 
@@ -313,7 +320,7 @@ void YAMLReader::_parse(Sink &sink) {
         PARSE_ERROR("Invalid YAML end mapping");
 
       target->endDict();
-      close_anchor();
+      if (!frame->anchor.empty()) close_anchor(frame->anchor, frame->parent);
       stack.pop_back();
       break;
 
@@ -322,7 +329,7 @@ void YAMLReader::_parse(Sink &sink) {
       int i = anchors.indexOf(anchor);
       if (i == -1) PARSE_ERROR("Invalid anchor '" << anchor << "'");
 
-      anchors.get(i)->write(*target);
+      link(anchors.get(i));
       haveKey = false;
       break;
     }
@@ -371,6 +378,7 @@ void YAMLReader::_parse(Sink &sink) {
           string path = SystemUtilities::absolute(src.getName(), value);
           LOG_DEBUG(5, "YAML: !include " << path);
           YAMLReader reader(path);
+          reader.setShareAnchors(shareAnchors);
           reader.parse(*target);
 
         } else target->write(value);
@@ -399,12 +407,7 @@ void YAMLReader::_parse(Sink &sink) {
       }
 
       // Close scaler anchor
-      if (!anchor.empty()) {
-        auto tee = target.cast<TeeSink>();
-        auto builder = tee->getRight().cast<Builder>();
-        anchors.insert(anchor, builder->getRoot());
-        target = tee->getLeft();
-      }
+      if (!anchor.empty()) close_anchor(anchor, parent);
       break;
     }
     }
@@ -47,6 +47,7 @@ namespace cb {
 
     class YAMLReader {
       InputSource src;
+      bool shareAnchors = false;
 
       class Private;
       cb::SmartPointer<Private> pri;
@@ -61,6 +62,16 @@ namespace cb {
     public:
       YAMLReader(const InputSource &src);
 
+      bool getShareAnchors() const {return shareAnchors;}
+      /**
+       * When enabled, anchored values are linked, not copied, where they
+       * are first defined, where they are aliased and where they are
+       * merged.  Sinks which build Values, such as Builder, then share one
+       * Value between all uses.  Shared Values must be copied before one
+       * use is modified.
+       */
+      void setShareAnchors(bool x) {shareAnchors = x;}
+
       void parse(Sink &sink);
 
       SmartPointer<Value> parse();
@@ -32,37 +32,21 @@
 
 #include "AsyncCopyStreamToLog.h"
 
-#include "Logger.h"
+#include "LogLineBuffer.h"
 
 #include <cbang/Catch.h>
 
-#include <string.h>
-
 using namespace std;
 using namespace cb;
 
 
 void AsyncCopyStreamToLog::run() {
   try {
-    Logger::LogStream log = Logger::instance().createStream
-      (CBANG_LOG_DOMAIN, CBANG_LOG_INFO_LEVEL(1), prefix);
-
-    const unsigned bufferSize = 4096;
-    char buffer[bufferSize];
-    unsigned fill = 0;
-
-    while (!in->fail() && !log->fail() && !shouldShutdown()) {
-      int c = in->get();
-      if (c == char_traits<char>::eof()) break;
-
-      buffer[fill++] = c;
+    LogLineBuffer lines(prefix);
 
-      if (c == '\n' || fill == bufferSize) {
-        log->write(buffer, fill);
-        fill = 0;
-      }
-    }
+    while (!in->fail() && !shouldShutdown())
+      if (!lines.readSome(*in)) break;
 
-    if (fill) log->write(buffer, fill);
+    lines.flush();
   } CATCH_ERROR;
 }
@@ -0,0 +1,326 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "AsyncLogWriter.h"
+
+#include <cbang/String.h>
+#include <cbang/util/SmartLock.h>
+
+#ifndef _WIN32
+#include <sys/uio.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+using namespace std;
+using namespace cb;
+
+
+namespace {
+  const unsigned maxBatch = 1024; // Lines per write, within IOV_MAX
+  atomic<uint64_t> nextWriterID(1);
+}
+
+
+class AsyncLogWriter::Ring {
+  atomic<unsigned> refs;
+  atomic<bool> closed;
+
+  const uint64_t mask;
+  vector<string> lines;
+
+  atomic<uint64_t> head; // Next line to write, advanced by the writer
+  atomic<uint64_t> tail; // Next free slot, advanced by the producer
+
+public:
+  const uint64_t writerID;
+
+  Ring(unsigned size, uint64_t writerID) :
+    refs(2), closed(false), mask(size - 1), lines(size), head(0), tail(0),
+    writerID(writerID) {}
+
+  void release() {if (!--refs) delete this;}
+
+  void close() {closed = true;}
+  bool isClosed() const {return closed;}
+  bool empty() const {return head.load() == tail.load();}
+
+
+  bool push(const char *s, unsigned length) {
+    uint64_t t = tail.load(memory_order_relaxed);
+    if (mask < t - head.load(memory_order_acquire)) return false; // Full
+
+    // Reuse the slot's allocation
+    lines[t & mask].assign(s, length);
+    tail.store(t + 1);
+
+    return true;
+  }
+
+
+  uint64_t peek(vector<pair<const char *, unsigned> > &out, unsigned max) {
+    uint64_t h = head.load(memory_order_relaxed);
+    uint64_t t = tail.load(memory_order_acquire);
+    uint64_t count = 0;
+
+    for (; h + count < t && count < max; count++) {
+      const string &line = lines[(h + count) & mask];
+      out.push_back(make_pair(line.data(), (unsigned)line.size()));
+    }
+
+    return count;
+  }
+
+
+  void pop(uint64_t count) {
+    uint64_t h = head.load(memory_order_relaxed);
+    for (uint64_t i = 0; i < count; i++) lines[(h + i) & mask].clear();
+    head.store(h + count, memory_order_release);
+  }
+};
+
+
+namespace {
+  // Releases the calling thread's ring when the thread exits
+  struct LocalRing {
+    AsyncLogWriter::Ring *ring;
+
+    LocalRing() : ring(0) {}
+    ~LocalRing() {reset();}
+
+    void reset() {
+      if (ring) {
+        ring->close();
+        ring->release();
+        ring = 0;
+      }
+    }
+  };
+
+  thread_local LocalRing localRing;
+}
+
+
+AsyncLogWriter::AsyncLogWriter(unsigned ringSize, bool block) :
+  ringSize(ringSize), block(block), id(nextWriterID++), sleeping(false),
+  dropped(0), reportedDropped(0) {
+  if (!ringSize || (ringSize & (ringSize - 1)))
+    THROW("Async log ring size must be a power of two, got " << ringSize);
+}
+
+
+AsyncLogWriter::~AsyncLogWriter() {
+  join();
+
+  Ring *ring;
+  while (newRings.pop(ring)) rings.push_back(ring);
+  for (unsigned i = 0; i < rings.size(); i++) rings[i]->release();
+
+#ifndef _WIN32
+  for (unsigned i = 0; i < fds.size(); i++)
+    if (fds[i].close) ::close(fds[i].fd);
+#endif
+}
+
+
+#ifndef _WIN32
+void AsyncLogWriter::addOutput(int fd, bool close) {
+  fds.push_back(FD(fd, close));
+}
+#endif
+
+
+void AsyncLogWriter::addOutput(const SmartPointer<ostream> &stream) {
+  streams.push_back(stream);
+}
+
+
+void AsyncLogWriter::write(const char *s, unsigned length) {
+  Ring &ring = getRing();
+
+  while (!ring.push(s, length)) {
+    if (!block || !isRunning()) {
+      dropped++;
+      return;
+    }
+
+    notify();
+    Thread::yield();
+  }
+
+  notify();
+}
+
+
+void AsyncLogWriter::stop() {
+  Thread::stop();
+
+  SmartLock lock(&condition);
+  condition.signal();
+}
+
+
+AsyncLogWriter::Ring &AsyncLogWriter::getRing() {
+  if (localRing.ring && localRing.ring->writerID == id) return *localRing.ring;
+
+  // First line from this thread or from a previous writer's thread
+  localRing.reset();
+  localRing.ring = new Ring(ringSize, id);
+  newRings.push(localRing.ring);
+
+  return *localRing.ring;
+}
+
+
+void AsyncLogWriter::notify() {
+  // Only the first producer to see the writer sleeping takes the lock
+  if (sleeping.load() && sleeping.exchange(false)) {
+    SmartLock lock(&condition);
+    condition.signal();
+  }
+}
+
+
+bool AsyncLogWriter::drain() {
+  Ring *ring;
+  while (newRings.pop(ring)) rings.push_back(ring);
+
+  vector<pair<const char *, unsigned> > lines;
+  vector<uint64_t> counts(rings.size());
+  bool wrote = false;
+
+  // Report lines dropped since the last drain
+  uint64_t dropped = this->dropped;
+  string dropMsg;
+  if (reportedDropped != dropped) {
+    dropMsg = SSTR("WARNING:Async log dropped " << (dropped - reportedDropped)
+                   << " lines\n");
+    lines.push_back(make_pair(dropMsg.data(), (unsigned)dropMsg.size()));
+    reportedDropped = dropped;
+  }
+
+  while (true) {
+    for (unsigned i = 0; i < rings.size() && lines.size() < maxBatch; i++)
+      counts[i] = rings[i]->peek(lines, maxBatch - lines.size());
+
+    if (lines.empty()) break;
+
+    writeOutputs(lines);
+    wrote = true;
+    lines.clear();
+
+    for (unsigned i = 0; i < rings.size(); i++)
+      if (counts[i]) {
+        rings[i]->pop(counts[i]);
+        counts[i] = 0;
+      }
+  }
+
+  // Free rings of exited threads
+  for (unsigned i = 0; i < rings.size();)
+    if (rings[i]->isClosed() && rings[i]->empty()) {
+      rings[i]->release();
+      rings[i] = rings.back();
+      rings.pop_back();
+
+    } else i++;
+
+  return wrote;
+}
+
+
+void AsyncLogWriter::writeOutputs(const vector<pair<const char *, unsigned> >
+                                  &lines) {
+#ifndef _WIN32
+  vector<iovec> iov(lines.size());
+
+  for (unsigned i = 0; i < fds.size(); i++) {
+    for (unsigned j = 0; j < lines.size(); j++) {
+      iov[j].iov_base = (void *)lines[j].first;
+      iov[j].iov_len = lines[j].second;
+    }
+
+    iovec *v = &iov[0];
+    int count = iov.size();
+
+    while (count) {
+      ssize_t n = writev(fds[i].fd, v, count);
+
+      if (n < 0) {
+        if (errno == EINTR) continue;
+        break; // Nowhere to report the error
+      }
+
+      // Skip what was written
+      while (count && v->iov_len <= (size_t)n) {
+        n -= v->iov_len;
+        v++;
+        count--;
+      }
+
+      if (count) {
+        v->iov_base = (char *)v->iov_base + n;
+        v->iov_len -= n;
+      }
+    }
+  }
+#endif
+
+  for (unsigned i = 0; i < streams.size(); i++) {
+    for (unsigned j = 0; j < lines.size(); j++)
+      streams[i]->write(lines[j].first, lines[j].second);
+
+    streams[i]->flush();
+  }
+}
+
+
+void AsyncLogWriter::run() {
+  while (!shouldShutdown())
+    if (!drain()) {
+      SmartLock lock(&condition);
+      sleeping = true;
+
+      // Recheck after announcing sleep so a concurrent push is not missed
+      bool pending = false;
+      for (unsigned i = 0; i < rings.size() && !pending; i++)
+        pending = !rings[i]->empty();
+
+      if (!pending && newRings.empty() && !shouldShutdown())
+        condition.timedWait(0.25);
+
+      sleeping = false;
+    }
+
+  drain();
+}
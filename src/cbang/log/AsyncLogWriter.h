@@ -0,0 +1,119 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+#include <cbang/os/Thread.h>
+#include <cbang/os/Condition.h>
+#include <cbang/util/MPSCQueue.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <ostream>
+
+
+namespace cb {
+  /**
+   * Writes log lines from a background thread.
+   *
+   * Each thread which calls write() gets its own lock-free single producer,
+   * single consumer ring of lines.  The writer thread drains all rings and
+   * writes the lines to its outputs in batches, with one writev() per file
+   * descriptor.  Lines from one thread stay in order but lines from different
+   * threads may be reordered slightly.
+   *
+   * When a ring is full write() either drops the line, counting it, or blocks
+   * until the writer catches up.
+   */
+  class AsyncLogWriter : public Thread {
+  public:
+    class Ring;
+
+  private:
+    const unsigned ringSize;
+    const bool block;
+    const uint64_t id;
+
+    MPSCQueue<Ring *> newRings;
+    std::vector<Ring *> rings;
+
+    struct FD {
+      int fd;
+      bool close;
+      FD(int fd, bool close) : fd(fd), close(close) {}
+    };
+
+    std::vector<FD> fds;
+    std::vector<SmartPointer<std::ostream> > streams;
+
+    Condition condition;
+    std::atomic<bool> sleeping;
+    std::atomic<uint64_t> dropped;
+    uint64_t reportedDropped;
+
+  public:
+    /**
+     * @param ringSize The maximum number of lines buffered per thread.
+     * @param block If true, block when a ring is full.  Otherwise, drop the
+     * line.
+     */
+    AsyncLogWriter(unsigned ringSize = 4096, bool block = false);
+    ~AsyncLogWriter();
+
+    /// Outputs must be added before the writer is started.
+#ifndef _WIN32
+    void addOutput(int fd, bool close = false);
+#endif
+    void addOutput(const SmartPointer<std::ostream> &stream);
+
+    uint64_t getDropped() const {return dropped;}
+
+    /// Queue a complete log line, including its EOL, from the calling thread.
+    void write(const char *s, unsigned length);
+
+    // From Thread
+    void stop();
+
+  protected:
+    Ring &getRing();
+    void notify();
+    bool drain();
+    void writeOutputs(const std::vector<std::pair<const char *, unsigned> >
+                      &lines);
+
+    // From Thread
+    void run();
+  };
+}
@@ -0,0 +1,187 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "BinaryLog.h"
+
+#include <cbang/Exception.h>
+
+using namespace std;
+using namespace cb;
+
+
+namespace {
+  const char magic[] = "CBLOG";
+  const unsigned magicLength = 5;
+
+  uint64_t zigZag(int64_t x) {return ((uint64_t)x << 1) ^ (x >> 63);}
+  int64_t unZigZag(uint64_t x) {return (x >> 1) ^ -(int64_t)(x & 1);}
+}
+
+
+BinaryLogWriter::BinaryLogWriter(const SmartPointer<ostream> &stream) :
+  stream(stream), lastTime(0) {
+  stream->write(magic, magicLength);
+  stream->put((char)VERSION);
+}
+
+
+void BinaryLogWriter::write(uint64_t time, uint64_t thread, int level,
+                            const string &domain, const char *msg,
+                            unsigned length) {
+  buffer.clear();
+
+  // Domain
+  domains_t::iterator it = domains.find(domain);
+  if (it == domains.end()) {
+    unsigned id = domains.size();
+    it = domains.insert(domains_t::value_type(domain, id)).first;
+
+    buffer.push_back('D');
+    writeVarInt(id);
+    writeVarInt(domain.size());
+    buffer.append(domain);
+  }
+
+  // Message
+  buffer.push_back('M');
+  writeVarInt(zigZag((int64_t)(time - lastTime)));
+  writeVarInt(thread);
+  writeVarInt((unsigned)level);
+  writeVarInt(it->second);
+  writeVarInt(length);
+  buffer.append(msg, length);
+
+  lastTime = time;
+  stream->write(buffer.data(), buffer.size());
+}
+
+
+void BinaryLogWriter::writeVarInt(uint64_t x) {
+  while (0x80 <= x) {
+    buffer.push_back((char)(x | 0x80));
+    x >>= 7;
+  }
+
+  buffer.push_back((char)x);
+}
+
+
+BinaryLogReader::BinaryLogReader(istream &stream) :
+  stream(stream), lastTime(0) {
+  if (stream.get() != magic[0]) THROW("Not a binary log");
+  readHeader();
+}
+
+
+bool BinaryLogReader::next(Record &record) {
+  while (true) {
+    int type = stream.get();
+
+    switch (type) {
+    case EOF: return false;
+
+    case 'C': readHeader(); break;
+
+    case 'D': {
+      uint64_t id = readVarInt();
+      if (id != domains.size()) THROW("Unexpected binary log domain " << id);
+      domains.push_back(readString());
+      break;
+    }
+
+    case 'M': {
+      lastTime += unZigZag(readVarInt());
+      record.time = lastTime;
+      record.thread = readVarInt();
+      record.level = (int)readVarInt();
+
+      uint64_t id = readVarInt();
+      if (domains.size() <= id) THROW("Undefined binary log domain " << id);
+      record.domain = domains[id];
+      record.message = readString();
+
+      return true;
+    }
+
+    default: THROW("Invalid binary log record type " << type);
+    }
+  }
+}
+
+
+void BinaryLogReader::readHeader() {
+  // The leading 'C' has already been read
+  char header[magicLength];
+  stream.read(header, magicLength);
+
+  if (stream.gcount() != magicLength ||
+      string(header, magicLength - 1) != magic + 1)
+    THROW("Invalid binary log header");
+
+  unsigned version = (unsigned char)header[magicLength - 1];
+  if (version != BinaryLogWriter::VERSION)
+    THROW("Unsupported binary log version " << version);
+
+  domains.clear();
+  lastTime = 0;
+}
+
+
+uint64_t BinaryLogReader::readVarInt() {
+  uint64_t x = 0;
+
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    int c = stream.get();
+    if (c == EOF) THROW("Truncated binary log");
+
+    x |= (uint64_t)(c & 0x7f) << shift;
+    if (!(c & 0x80)) return x;
+  }
+
+  THROW("Invalid binary log varint");
+}
+
+
+string BinaryLogReader::readString() {
+  uint64_t length = readVarInt();
+  if (1 << 30 < length) THROW("Invalid binary log string length " << length);
+
+  string s(length, 0);
+
+  if (length) {
+    stream.read(&s[0], length);
+    if ((uint64_t)stream.gcount() != length) THROW("Truncated binary log");
+  }
+
+  return s;
+}
@@ -0,0 +1,107 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+#include <cbang/StdTypes.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+
+
+namespace cb {
+  /**
+   * Writes log lines as compact binary records rather than formatted text.
+   *
+   * A file starts with the header "CBLOG" plus a version byte.  The header
+   * may repeat, e.g. when a log is appended to, and resets the reader.
+   * Then come records, each starting with a type byte.  All integers are
+   * LEB128 varints:
+   *
+   *   'D' <id> <length> <bytes>         Defines a domain, once per file.
+   *   'M' <time delta> <thread> <level> <domain id> <length> <bytes>
+   *                                     One log line without its header.
+   *
+   * Times are microseconds since the epoch, stored as a zig-zag encoded
+   * delta from the previous record.
+   */
+  class BinaryLogWriter {
+    SmartPointer<std::ostream> stream;
+
+    typedef std::map<std::string, unsigned> domains_t;
+    domains_t domains;
+    uint64_t lastTime;
+    std::string buffer;
+
+  public:
+    static const unsigned VERSION = 1;
+
+    BinaryLogWriter(const SmartPointer<std::ostream> &stream);
+
+    void write(uint64_t time, uint64_t thread, int level,
+               const std::string &domain, const char *msg, unsigned length);
+    void flush() {stream->flush();}
+
+  protected:
+    void writeVarInt(uint64_t x);
+  };
+
+
+  class BinaryLogReader {
+    std::istream &stream;
+    std::vector<std::string> domains;
+    uint64_t lastTime;
+
+  public:
+    struct Record {
+      uint64_t time; // Microseconds since the epoch
+      uint64_t thread;
+      int level;
+      std::string domain;
+      std::string message;
+    };
+
+    BinaryLogReader(std::istream &stream);
+
+    /// @return False at the end of the stream.
+    bool next(Record &record);
+
+  protected:
+    void readHeader();
+    uint64_t readVarInt();
+    std::string readString();
+  };
+}
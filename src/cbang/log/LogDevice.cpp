@@ -39,9 +39,10 @@ using namespace cb;
 
 
 LogDevice::impl::impl(const std::string &prefix, const std::string &suffix,
-                      const std::string &trailer) :
-  prefix(prefix), suffix(suffix), trailer(trailer), startOfLine(true),
-  locked(false) {
+                      const std::string &trailer, const std::string &domain,
+                      int level, unsigned headerLength) :
+  prefix(prefix), suffix(suffix), trailer(trailer), domain(domain),
+  level(level), headerLength(headerLength), startOfLine(true), locked(false) {
 
   buffer.reserve(1024);
 }
@@ -91,18 +92,27 @@ streamsize LogDevice::impl::write(const char_type *s, streamsize n) {
 void LogDevice::impl::flushLine() {
   if (startOfLine) return;
 
+  Logger &logger = Logger::instance();
+
+  if (logger.getLogBinary() && headerLength <= buffer.size())
+    logger.writeRecord(domain, level, buffer.data() + headerLength,
+                       buffer.size() - headerLength);
+
   // Add suffix
   buffer.insert(buffer.end(), suffix.begin(), suffix.end());
 
-  Logger &logger = Logger::instance();
-
   // Add EOL
   if (logger.getLogCRLF()) buffer.push_back('\r');
   buffer.push_back('\n');
 
-  flush();
+  if (logger.getLogAsync()) {
+    // Lines are queued whole, without taking the Logger lock
+    logger.write(&buffer[0], buffer.size());
+    buffer.clear();
+
+  } else writeBuffer();
 
-  logger.unlock();
+  if (locked) logger.unlock();
   locked = false;
   startOfLine = true;
 }
@@ -113,6 +123,18 @@ bool LogDevice::impl::flush() {
 
   Logger &logger = Logger::instance();
 
+  // Partial lines wait for their EOL in async and binary modes
+  if ((logger.getLogAsync() || logger.getLogBinary()) && !locked) return true;
+
+  writeBuffer();
+
+  return true;
+}
+
+
+void LogDevice::impl::writeBuffer() {
+  Logger &logger = Logger::instance();
+
   if (!locked) {
     logger.lock();
     locked = true;
@@ -124,6 +146,4 @@ bool LogDevice::impl::flush() {
 
   // Flush the buffer
   buffer.clear();
-
-  return true;
 }
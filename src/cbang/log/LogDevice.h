@@ -57,6 +57,9 @@ namespace cb {
       std::string prefix;
       std::string suffix;
       std::string trailer;
+      std::string domain;
+      int level;
+      unsigned headerLength;
 
       std::vector<char> buffer;
       bool startOfLine;
@@ -66,22 +69,30 @@ namespace cb {
 #endif
 
       impl(const std::string &prefix, const std::string &suffix,
-           const std::string &trailer);
+           const std::string &trailer, const std::string &domain, int level,
+           unsigned headerLength);
       ~impl();
 
       std::streamsize write(const char_type *s, std::streamsize n);
       void flushLine();
       bool flush();
+      void writeBuffer();
     };
 
     SmartPointer<impl> _impl;
 
   public:
     LogDevice(const SmartPointer<impl> &_impl) : _impl(_impl) {}
+    /**
+     * @param headerLength The length of the log header at the start of
+     * @param prefix.  It is left out of binary log records.
+     */
     LogDevice(const std::string &prefix,
               const std::string &suffix = std::string(),
-              const std::string &trailer = std::string()) :
-      _impl(new impl(prefix, suffix, trailer)) {}
+              const std::string &trailer = std::string(),
+              const std::string &domain = std::string(), int level = 0,
+              unsigned headerLength = 0) :
+      _impl(new impl(prefix, suffix, trailer, domain, level, headerLength)) {}
 
     std::streamsize write(const char_type *s, std::streamsize n)
     {return _impl->write(s, n);}
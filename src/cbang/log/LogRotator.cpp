@@ -0,0 +1,114 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "LogRotator.h"
+#include "Logger.h"
+
+#include <cbang/Catch.h>
+#include <cbang/String.h>
+#include <cbang/util/BZip2.h>
+#include <cbang/os/SystemUtilities.h>
+
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+namespace io = boost::iostreams;
+
+using namespace std;
+using namespace cb;
+
+
+LogRotator::LogRotator(const string &path, const string &dir,
+                       const string &rotated, unsigned maxFiles,
+                       uint64_t maxBytes, compression_t compression) :
+  path(path), dir(dir), rotated(rotated), maxFiles(maxFiles),
+  maxBytes(maxBytes), compression(compression) {}
+
+
+LogRotator::compression_t LogRotator::parseCompression(const string &name) {
+  string s = String::toLower(name);
+
+  if (s == "none" || s.empty()) return COMPRESS_NONE;
+  if (s == "gzip") return COMPRESS_GZIP;
+  if (s == "bzip2") return COMPRESS_BZIP2;
+
+  THROW("Invalid log compression '" << name << "'");
+}
+
+
+const char *LogRotator::getExtension(compression_t compression) {
+  switch (compression) {
+  case COMPRESS_GZIP: return ".gz";
+  case COMPRESS_BZIP2: return ".bz2";
+  default: return "";
+  }
+}
+
+
+void LogRotator::compress() {
+  string target = rotated + getExtension(compression);
+
+  try {
+    SmartPointer<istream> in = SystemUtilities::iopen(rotated);
+    SmartPointer<ostream> out = SystemUtilities::oopen(target);
+
+    if (compression == COMPRESS_BZIP2) BZip2::compress(*in, *out);
+    else {
+      io::filtering_ostream gzip;
+      gzip.push(io::gzip_compressor());
+      gzip.push(*out);
+      io::copy(*in, gzip);
+    }
+
+    out->flush();
+
+  } catch (...) {
+    // Keep the uncompressed log
+    if (SystemUtilities::exists(target)) SystemUtilities::unlink(target);
+    throw;
+  }
+
+  SystemUtilities::unlink(rotated);
+}
+
+
+void LogRotator::run() {
+  if (compression != COMPRESS_NONE && !rotated.empty())
+    try {
+      LOG_INFO(3, "Compressing rotated log '" << rotated << "'");
+      compress();
+    } CATCH_ERROR;
+
+  if (maxFiles || maxBytes)
+    SystemUtilities::removeRotated(path, dir, maxFiles, maxBytes);
+}
@@ -0,0 +1,83 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cbang/StdTypes.h>
+#include <cbang/os/Thread.h>
+
+#include <string>
+
+
+namespace cb {
+  /**
+   * Compresses a rotated log file and then removes old rotated logs, in the
+   * background, so that starting a new log file only has to rename the old
+   * one.
+   */
+  class LogRotator : public Thread {
+  public:
+    enum compression_t {
+      COMPRESS_NONE,
+      COMPRESS_GZIP,
+      COMPRESS_BZIP2,
+    };
+
+  private:
+    std::string path;
+    std::string dir;
+    std::string rotated;
+    unsigned maxFiles;
+    uint64_t maxBytes;
+    compression_t compression;
+
+  public:
+    /**
+     * @param path The log file name.
+     * @param dir The rotated log directory.
+     * @param rotated The name @param path was rotated to.
+     */
+    LogRotator(const std::string &path, const std::string &dir,
+               const std::string &rotated, unsigned maxFiles,
+               uint64_t maxBytes, compression_t compression);
+
+    static compression_t parseCompression(const std::string &name);
+    static const char *getExtension(compression_t compression);
+
+  protected:
+    void compress();
+
+    // From Thread
+    void run();
+  };
+}
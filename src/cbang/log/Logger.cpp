@@ -33,12 +33,16 @@
 #include "Logger.h"
 
 #include "LogDevice.h"
+#include "AsyncLogWriter.h"
+#include "BinaryLog.h"
+#include "LogRotator.h"
 
 #include <cbang/config.h>
 #include <cbang/Exception.h>
 #include <cbang/String.h>
 
 #include <cbang/time/Time.h>
+#include <cbang/time/Timer.h>
 #include <cbang/iostream/NullDevice.h>
 #include <cbang/util/SmartLock.h>
 #include <cbang/debug/Debugger.h>
@@ -50,8 +54,14 @@
 #include <cbang/config/OptionActionSet.h>
 
 #include <iostream>
+#include <chrono>
 #include <stdio.h> // for freopen()
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include <boost/ref.hpp>
 #include <boost/iostreams/stream.hpp>
 #include <boost/iostreams/tee.hpp>
@@ -69,6 +79,35 @@ using namespace cb;
 #endif
 
 
+namespace {
+  // Sets an option target which affects Logger::enabled()
+  template <typename T>
+  class EnabledOptionAction : public OptionActionSet<T> {
+  public:
+    EnabledOptionAction(T &ref) : OptionActionSet<T>(ref) {}
+
+    int operator()(Option &option) {
+      OptionActionSet<T>::operator()(option);
+      Logger::invalidateSites();
+      return 0;
+    }
+  };
+
+
+  template <typename T>
+  void addEnabledTarget(Options &options, const string &name, T &target,
+                        const string &help) {
+    SmartPointer<Option> option = options.addTarget(name, target, help);
+    SmartPointer<OptionActionBase> action = new EnabledOptionAction<T>(target);
+    option->setAction(action);
+    option->setDefaultSetAction(action);
+  }
+}
+
+
+atomic<unsigned> Logger::generation(1);
+
+
 Logger::Logger(Inaccessible) :
   verbosity(DEFAULT_VERBOSITY), logCRLF(false),
 #ifdef DEBUG
@@ -80,11 +119,15 @@ Logger::Logger(Inaccessible) :
   logLevel(true), logThreadPrefix(false), logDomain(false),
   logSimpleDomains(true), logThreadID(false), logHeader(true),
   logNoInfoHeader(false), logColor(true), logToScreen(true), logTrunc(false),
-  logRedirect(false), logRotate(true), logRotateMax(0), logRotateDir("logs"),
+  logRedirect(false), logRotate(true), logRotateMax(0),
+  logRotateMaxBytes(0), logRotateDir("logs"), logRotateCompress("none"),
+  logAsync(false), logAsyncBuffer(4096), logAsyncBlock(false),
+  logBinary(false), errorCount(0), warningCount(0),
   threadIDStorage(new ThreadLocalStorage<unsigned long>),
   threadPrefixStorage(new ThreadLocalStorage<string>),
   screenStream(SmartPointer<ostream>::Phony(&cout)), idWidth(1),
   lastDate(Time::now()) {
+  setProfileName("Logger");
 
 #ifdef _WIN32
   logCRLF = true;
@@ -93,18 +136,26 @@ Logger::Logger(Inaccessible) :
 }
 
 
+Logger::~Logger() {
+  if (!rotator.isNull()) rotator->join();
+  stopAsync();
+}
+
+
 void Logger::addOptions(Options &options) {
   options.pushCategory("Logging");
   options.add("log", "Set log file.");
-  options.addTarget("verbosity", verbosity, "Set logging level for INFO "
+  addEnabledTarget(options, "verbosity", verbosity,
+                   "Set logging level for INFO "
 #ifdef DEBUG
-                    "and DEBUG "
+                   "and DEBUG "
 #endif
-                    "messages.");
+                   "messages.");
   options.addTarget("log-crlf", logCRLF, "Print carriage return and line feed "
                     "at end of log lines.");
 #ifdef DEBUG
-  options.addTarget("log-debug", logDebug, "Disable or enable debugging info.");
+  addEnabledTarget(options, "log-debug", logDebug,
+                   "Disable or enable debugging info.");
 #endif
   options.addTarget("log-time", logTime,
                     "Print time information with log entries.");
@@ -121,10 +172,10 @@ void Logger::addOptions(Options &options) {
                     "Print thread prefixes, if set, with log entries.");
   options.addTarget("log-domain", logDomain,
                     "Print domain information with log entries.");
-  options.addTarget("log-simple-domains", logSimpleDomains, "Remove any "
-                    "leading directories and trailing file extensions from "
-                    "domains so that source code file names can be easily used "
-                    "as log domains.");
+  addEnabledTarget(options, "log-simple-domains", logSimpleDomains, "Remove "
+                   "any leading directories and trailing file extensions from "
+                   "domains so that source code file names can be easily used "
+                   "as log domains.");
   options.add("log-domain-levels", 0,
               new OptionAction<Logger>(this, &Logger::domainLevelsAction),
               "Set log levels by domain.  Format is:\n"
@@ -162,12 +213,29 @@ void Logger::addOptions(Options &options) {
                     "Put rotated logs in this directory.");
   options.addTarget("log-rotate-max", logRotateMax,
                     "Maximum number of rotated logs to keep.");
+  options.addTarget("log-rotate-max-bytes", logRotateMaxBytes,
+                    "Maximum total size of rotated logs to keep.");
+  options.addTarget("log-rotate-compress", logRotateCompress,
+                    "Compress rotated logs in the background.  One of 'none', "
+                    "'gzip' or 'bzip2'.");
+  options.addTarget("log-async", logAsync, "Write log lines from a background "
+                    "thread so that logging threads do not wait on I/O.");
+  options.addTarget("log-async-buffer", logAsyncBuffer, "The number of lines "
+                    "each thread may queue for the async log writer.  Must be "
+                    "a power of two.");
+  options.addTarget("log-async-block", logAsyncBlock, "Block logging threads "
+                    "when their async log buffer is full rather than dropping "
+                    "lines.");
+  options.addTarget("log-binary", logBinary, "Write the log file as compact "
+                    "binary records.  Use the logcat tool to convert it to "
+                    "text.");
   options.popCategory();
 }
 
 
 void Logger::setOptions(Options &options) {
   if (options["log"].hasValue()) startLogFile(options["log"]);
+  if (logAsync) startAsync();
 }
 
 
@@ -183,19 +251,44 @@ void Logger::setScreenStream(ostream &stream) {
 
 
 void Logger::setScreenStream(const SmartPointer<std::ostream> &stream) {
+  bool async = getLogAsync();
+  stopAsync();
   screenStream = stream;
+  if (async) startAsync();
 }
 
 
 void Logger::startLogFile(const string &filename) {
+  bool async = getLogAsync();
+  stopAsync();
+  logFilename = filename;
+
   // Rotate log
-  if (logRotate) SystemUtilities::rotate(filename, logRotateDir, logRotateMax);
+  if (logRotate) {
+    LogRotator::compression_t compression =
+      LogRotator::parseCompression(logRotateCompress);
+    string rotated = SystemUtilities::rotate(filename, logRotateDir);
+
+    // Compress and remove old logs in the background
+    if (compression != LogRotator::COMPRESS_NONE || logRotateMax ||
+        logRotateMaxBytes) {
+      if (!rotator.isNull()) rotator->join();
+      rotator = new LogRotator(filename, logRotateDir, rotated, logRotateMax,
+                               logRotateMaxBytes, compression);
+      rotator->start();
+    }
+  }
 
   logFile = SystemUtilities::open(filename, ios::out |
                                   (logTrunc ? ios::trunc : ios::app));
 
-  *logFile << String::bar(SSTR("Log Started " << Time()))
-           << (logCRLF ? "\r\n" : "\n");
+  if (logBinary) binaryLog = new BinaryLogWriter(logFile);
+  else {
+    binaryLog.release();
+    *logFile << String::bar(SSTR("Log Started " << Time()))
+             << (logCRLF ? "\r\n" : "\n");
+  }
+
   logFile->flush();
   lastDate = Time::now();
 
@@ -209,6 +302,8 @@ void Logger::startLogFile(const string &filename) {
         !freopen(filename.c_str(), "a", stderr))
       THROW("Redirecting output to '" << filename << "'");
   }
+
+  if (async) startAsync();
 }
 
 
@@ -248,6 +343,8 @@ void Logger::setLogDomainLevels(const string &levels) {
     if (invalid) THROW("Invalid log domain level entry " << (i + 1)
                         << " '" << entries[i] << "'");
   }
+
+  invalidateSites();
 }
 
 
@@ -256,6 +353,18 @@ unsigned Logger::getHeaderWidth() const {
 }
 
 
+void Logger::setLogAsync(bool x) {
+  logAsync = x;
+  if (x) startAsync();
+  else stopAsync();
+}
+
+
+uint64_t Logger::getLogDropped() const {
+  return asyncWriter.isNull() ? 0 : asyncWriter->getDropped();
+}
+
+
 void Logger::setThreadID(unsigned long id) {threadIDStorage->set(id);}
 
 
@@ -423,6 +532,9 @@ Logger::LogStream Logger::createStream(const string &_domain, int level,
                                        const std::string &_prefix) {
   string domain = simplifyDomain(_domain);
 
+  if (level == LEVEL_ERROR || level == LEVEL_CRITICAL) errorCount++;
+  else if (level == LEVEL_WARNING) warningCount++;
+
   if (!enabled(domain, level)) return new NullStream<>;
 
   // Log date periodically
@@ -432,8 +544,11 @@ Logger::LogStream Logger::createStream(const string &_domain, int level,
           (logCRLF ? "\r\n" : "\n"));
   }
 
-  string prefix = startColor(level) + getHeader(domain, level) + _prefix;
-  string suffix = endColor(level);
+  // Skip formatting text headers which would not be written
+  bool text = binaryLog.isNull() || logToScreen;
+  string header = text ? startColor(level) + getHeader(domain, level) : "";
+  string prefix = header + _prefix;
+  string suffix = text ? endColor(level) : "";
   string trailer;
 
 #ifdef HAVE_CBANG_BACKTRACE
@@ -445,12 +560,18 @@ Logger::LogStream Logger::createStream(const string &_domain, int level,
   }
 #endif
 
-  return new cb::LogStream(prefix, suffix, trailer);
+  return new cb::LogStream
+    (LogDevice(prefix, suffix, trailer, domain, level, header.size()));
 }
 
 
 streamsize Logger::write(const char *s, streamsize n) {
-  if (!logFile.isNull()) logFile->write(s, n);
+  if (!asyncWriter.isNull()) {
+    asyncWriter->write(s, n);
+    return n;
+  }
+
+  if (!logFile.isNull() && binaryLog.isNull()) logFile->write(s, n);
   if (logToScreen && !screenStream.isNull()) screenStream->write(s, n);
   return n;
 }
@@ -459,8 +580,82 @@ streamsize Logger::write(const char *s, streamsize n) {
 void Logger::write(const string &s) {write(s.c_str(), s.length());}
 
 
+void Logger::writeRecord(const string &domain, int level, const char *msg,
+                         unsigned length) {
+  SmartLock lock(this);
+  binaryLog->write((uint64_t)(Timer::now() * 1e6), getThreadID(), level,
+                   domain, msg, length);
+  binaryLog->flush();
+}
+
+
 bool Logger::flush() {
+  if (!asyncWriter.isNull()) return true; // The writer flushes each batch
+
   if (!logFile.isNull()) logFile->flush();
   if (logToScreen && !screenStream.isNull()) screenStream->flush();
   return true;
 }
+
+
+void Logger::startAsync() {
+  if (!asyncWriter.isNull()) return;
+
+  SmartPointer<AsyncLogWriter> writer =
+    new AsyncLogWriter(logAsyncBuffer, logAsyncBlock);
+
+  // Binary records are written under the Logger lock
+  if (!logFile.isNull() && binaryLog.isNull()) {
+    logFile->flush();
+
+#ifdef _WIN32
+    writer->addOutput(logFile);
+#else
+    // Append through a descriptor so batches can be written with writev()
+    int fd = ::open(logFilename.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd == -1) THROW("Opening '" << logFilename << "' for async logging");
+    writer->addOutput(fd, true);
+#endif
+  }
+
+  if (logToScreen && !screenStream.isNull()) {
+#ifndef _WIN32
+    if (screenStream.get() == &cout) {
+      cout.flush();
+      writer->addOutput(STDOUT_FILENO);
+
+    } else
+#endif
+      writer->addOutput(screenStream);
+  }
+
+  writer->start();
+  asyncWriter = writer;
+}
+
+
+void Logger::stopAsync() {
+  if (asyncWriter.isNull()) return;
+
+  SmartPointer<AsyncLogWriter> writer = asyncWriter;
+  asyncWriter.release();
+  writer->join(); // Writes any queued lines
+
+  // The log file may not be in append mode
+  if (!logFile.isNull()) logFile->seekp(0, ios::end);
+}
+
+
+bool LogLimiter::rate(double seconds) {
+  int64_t now = chrono::duration_cast<chrono::nanoseconds>
+    (chrono::steady_clock::now().time_since_epoch()).count();
+  int64_t next = nextTime.load(memory_order_relaxed);
+
+  // Only one of several threads passing at once wins the exchange
+  if (next <= now && nextTime.compare_exchange_strong
+      (next, now + (int64_t)(seconds * 1e9), memory_order_relaxed))
+    return true;
+
+  suppressed.fetch_add(1, memory_order_relaxed);
+  return false;
+}
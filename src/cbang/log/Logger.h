@@ -36,12 +36,14 @@
 #include <string>
 #include <map>
 #include <set>
+#include <atomic>
 
 #include <cbang/SStream.h>
 #include <cbang/SmartPointer.h>
 #include <cbang/Exception.h>
 
 #include <cbang/util/Singleton.h>
+#include <cbang/util/ShardedCounter.h>
 #include <cbang/os/Mutex.h>
 
 
@@ -49,6 +51,9 @@ namespace cb {
   class Option;
   class Options;
   class CommandLine;
+  class AsyncLogWriter;
+  class BinaryLogWriter;
+  class LogRotator;
   template <typename T> class ThreadLocalStorage;
 
   /**
@@ -91,17 +96,27 @@ namespace cb {
     bool logRedirect;
     bool logRotate;
     unsigned logRotateMax;
+    uint64_t logRotateMaxBytes;
     std::string logRotateDir;
+    std::string logRotateCompress;
+    bool logAsync;
+    unsigned logAsyncBuffer;
+    bool logAsyncBlock;
+    bool logBinary;
 
-    uint64_t errorCount;
-    uint64_t warningCount;
+    ShardedCounter errorCount;
+    ShardedCounter warningCount;
 
     SmartPointer<ThreadLocalStorage<unsigned long> > threadIDStorage;
     SmartPointer<ThreadLocalStorage<std::string> > threadPrefixStorage;
 
 
+    std::string logFilename;
     SmartPointer<std::iostream> logFile;
     SmartPointer<std::ostream> screenStream;
+    SmartPointer<AsyncLogWriter> asyncWriter;
+    SmartPointer<BinaryLogWriter> binaryLog;
+    SmartPointer<LogRotator> rotator;
 
     mutable unsigned idWidth;
 
@@ -114,8 +129,11 @@ namespace cb {
 
     uint64_t lastDate;
 
+    static std::atomic<unsigned> generation;
+
   public:
     Logger(Inaccessible);
+    ~Logger();
 
     void addOptions(Options &options);
     void setOptions(Options &options);
@@ -135,8 +153,8 @@ namespace cb {
      * Set the logging verbosity level.
      * @param verbosity The level.
      */
-    void setVerbosity(unsigned x) {verbosity = x;}
-    void setLogDebug(bool x) {logDebug = x;}
+    void setVerbosity(unsigned x) {verbosity = x; invalidateSites();}
+    void setLogDebug(bool x) {logDebug = x; invalidateSites();}
     void setLogCRLF(bool x) {logCRLF = x;}
     void setLogTime(bool x) {logTime = x;}
     void setLogDate(bool x) {logDate = x;}
@@ -144,7 +162,8 @@ namespace cb {
     void setLogLevel(bool x) {logLevel = x;}
     void setLogThreadPrefix(bool x) {logThreadPrefix = x;}
     void setLogDomain(bool x) {logDomain = x;}
-    void setLogSimpleDomains(bool x) {logSimpleDomains = x;}
+    void setLogSimpleDomains(bool x)
+    {logSimpleDomains = x; invalidateSites();}
     void setLogThreadID(bool x) {logThreadID = x;}
     void setLogNoInfoHeader(bool x) {logNoInfoHeader = x;}
     void setLogHeader(bool x) {logHeader = x;}
@@ -154,7 +173,29 @@ namespace cb {
     void setLogRedirect(bool x) {logRedirect = x;}
     void setLogRotate(bool x) {logRotate = x;}
     void setLogRotateMax(unsigned x) {logRotateMax = x;}
+    void setLogRotateMaxBytes(uint64_t x) {logRotateMaxBytes = x;}
+    /// One of "none", "gzip" or "bzip2".
+    void setLogRotateCompress(const std::string &x) {logRotateCompress = x;}
     void setLogDomainLevels(const std::string &levels);
+    /// Takes effect when the log file is started.
+    void setLogBinary(bool x) {logBinary = x;}
+    bool getLogBinary() const {return !binaryLog.isNull();}
+    void setLogAsyncBuffer(unsigned x) {logAsyncBuffer = x;}
+    void setLogAsyncBlock(bool x) {logAsyncBlock = x;}
+
+    /**
+     * Start or stop writing log lines from a background thread.  Outputs are
+     * fixed while it runs, so startLogFile() and setScreenStream() restart
+     * it.  It must not be stopped while other threads are logging.
+     */
+    void setLogAsync(bool x);
+    bool getLogAsync() const {return !asyncWriter.isNull();}
+    /// @return The number of lines dropped because the async buffer was full.
+    uint64_t getLogDropped() const;
+    /// @return The number of error messages logged
+    uint64_t getErrorCount() const {return errorCount;}
+    /// @return The number of warning messages logged
+    uint64_t getWarningCount() const {return warningCount;}
 
     unsigned getVerbosity() const {return verbosity;}
     bool getLogCRLF() const {return logCRLF;}
@@ -171,6 +212,11 @@ namespace cb {
     const char *startColor(int level) const;
     const char *endColor(int level) const;
 
+    /// Discard the enabled state cached by each LOG_*() call site.
+    static void invalidateSites() {generation++;}
+    static unsigned getGeneration()
+    {return generation.load(std::memory_order_relaxed);}
+
     // These functions should not be called directly.  Use the macros.
     bool enabled(const std::string &domain, int level) const;
     typedef SmartPointer<std::ostream> LogStream;
@@ -180,10 +226,82 @@ namespace cb {
   protected:
     std::streamsize write(const char *s, std::streamsize n);
     void write(const std::string &s);
+    void writeRecord(const std::string &domain, int level, const char *msg,
+                     unsigned length);
     bool flush();
+    void startAsync();
+    void stopAsync();
 
     friend class LogDevice;
   };
+
+
+  /**
+   * Caches Logger::enabled() for one LOG_*() call site.  The domain at a
+   * site is fixed, the level is cached with the result and Logger
+   * generation changes invalidate it.  There is one relaxed atomic word per
+   * site, so concurrent updates are harmless.
+   */
+  class LogSite {
+    // generation << 32 | level << 1 | enabled
+    std::atomic<uint64_t> state;
+
+  public:
+    constexpr LogSite() : state(0) {}
+
+    bool enabled(const char *domain, int level) {
+      uint64_t key = (uint64_t)Logger::getGeneration() << 32 |
+        (uint64_t)(uint32_t)level << 1;
+      uint64_t s = state.load(std::memory_order_relaxed);
+
+      if ((s & ~(uint64_t)1) == key) return s & 1;
+
+      bool enabled = Logger::instance().enabled(domain, level);
+      state.store(key | enabled, std::memory_order_relaxed);
+
+      return enabled;
+    }
+  };
+
+
+  /**
+   * Limits the messages logged by one LOG_*_RATE() or LOG_*_SAMPLE() call
+   * site and counts those it drops.  The count is added to the next
+   * message logged.  Only calls at enabled levels are counted.
+   */
+  class LogLimiter {
+    std::atomic<uint64_t> calls;
+    std::atomic<uint64_t> suppressed;
+    std::atomic<int64_t> nextTime;
+
+  public:
+    constexpr LogLimiter() : calls(0), suppressed(0), nextTime(0) {}
+
+    /// @return True for the first of every @param n calls
+    bool sample(unsigned n) {
+      if (n < 2 || !(calls.fetch_add(1, std::memory_order_relaxed) % n))
+        return true;
+
+      suppressed.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    /// @return True at most once every @param seconds
+    bool rate(double seconds);
+
+    struct Suppressed {uint64_t count;};
+    /// @return The count of messages dropped since the last call
+    Suppressed takeSuppressed()
+    {return Suppressed{suppressed.exchange(0, std::memory_order_relaxed)};}
+  };
+
+
+  inline static
+  std::ostream &operator<<(std::ostream &stream,
+                           const LogLimiter::Suppressed &s) {
+    if (s.count) stream << " (" << s.count << " similar suppressed)";
+    return stream;
+  }
 }
 
 #ifndef CBANG_LOG_DOMAIN
@@ -203,9 +321,24 @@ namespace cb {
 #define CBANG_LOG_INFO_LEVEL(x)  (cb::Logger::LEVEL_INFO + ((x) << 8))
 
 
+// Orders levels by type then verbosity
+#define CBANG_LOG_RANK(level)                                   \
+  ((((level) & cb::Logger::LEVEL_MASK) << 16) + ((level) >> 8))
+
+// Define CBANG_LOG_MAX_LEVEL, e.g. to CBANG_LOG_INFO_LEVEL(3), to compile out
+// all more verbose messages
+#ifdef CBANG_LOG_MAX_LEVEL
+#define CBANG_LOG_COMPILED(level)                                       \
+  (CBANG_LOG_RANK(level) <= CBANG_LOG_RANK(CBANG_LOG_MAX_LEVEL))
+#else
+#define CBANG_LOG_COMPILED(level) true
+#endif
+
+
 // Check if logging level is enabled
-#define CBANG_LOG_ENABLED(domain, level)        \
-  cb::Logger::instance().enabled(domain, level)
+#define CBANG_LOG_ENABLED(domain, level)                                \
+  (CBANG_LOG_COMPILED(level) &&                                         \
+   cb::Logger::instance().enabled(domain, level))
 #ifdef DEBUG
 #define CBANG_LOG_DEBUG_ENABLED(x)                              \
   CBANG_LOG_ENABLED(CBANG_LOG_DOMAIN, CBANG_LOG_DEBUG_LEVEL(x))
@@ -244,7 +377,39 @@ namespace cb {
       *CBANG_LOG_STREAM(domain, level) CBANG_LOG_PREFIX << msg;       \
   } while (false)
 
-#define CBANG_LOG_LEVEL(level, msg) CBANG_LOG(CBANG_LOG_DOMAIN, level, msg)
+// Like CBANG_LOG() but caches the enabled check, so the domain must be fixed
+#define CBANG_LOG_SITE(domain, level, msg)                              \
+  do {                                                                  \
+    if (CBANG_LOG_COMPILED(level)) {                                    \
+      static cb::LogSite _cbangLogSite;                                 \
+      if (_cbangLogSite.enabled(domain, level))                         \
+        *CBANG_LOG_STREAM(domain, level) CBANG_LOG_PREFIX << msg;       \
+    }                                                                   \
+  } while (false)
+
+#define CBANG_LOG_LEVEL(level, msg)                     \
+  CBANG_LOG_SITE(CBANG_LOG_DOMAIN, level, msg)
+
+// Like CBANG_LOG_SITE() but only logs if LogLimiter::limit passes
+#define CBANG_LOG_LIMITED(domain, level, limit, msg)                    \
+  do {                                                                  \
+    if (CBANG_LOG_COMPILED(level)) {                                    \
+      static cb::LogSite _cbangLogSite;                                 \
+      static cb::LogLimiter _cbangLogLimiter;                           \
+      if (_cbangLogSite.enabled(domain, level) &&                       \
+          _cbangLogLimiter.limit)                                       \
+        *CBANG_LOG_STREAM(domain, level) CBANG_LOG_PREFIX << msg        \
+          << _cbangLogLimiter.takeSuppressed();                         \
+    }                                                                   \
+  } while (false)
+
+// At most one message per seconds from the call site
+#define CBANG_LOG_LEVEL_RATE(level, seconds, msg)                       \
+  CBANG_LOG_LIMITED(CBANG_LOG_DOMAIN, level, rate(seconds), msg)
+
+// One in every n messages from the call site
+#define CBANG_LOG_LEVEL_SAMPLE(level, n, msg)                   \
+  CBANG_LOG_LIMITED(CBANG_LOG_DOMAIN, level, sample(n), msg)
 
 #define CBANG_LOG_RAW(msg)      CBANG_LOG_LEVEL(CBANG_LOG_RAW_LEVEL, msg)
 #define CBANG_LOG_ERROR(msg)    CBANG_LOG_LEVEL(CBANG_LOG_ERROR_LEVEL, msg)
@@ -258,6 +423,34 @@ namespace cb {
 #define CBANG_LOG_DEBUG(x, msg) do {} while (false)
 #endif
 
+#define CBANG_LOG_ERROR_RATE(secs, msg)                                 \
+  CBANG_LOG_LEVEL_RATE(CBANG_LOG_ERROR_LEVEL, secs, msg)
+#define CBANG_LOG_CRITICAL_RATE(secs, msg)                              \
+  CBANG_LOG_LEVEL_RATE(CBANG_LOG_CRITICAL_LEVEL, secs, msg)
+#define CBANG_LOG_WARNING_RATE(secs, msg)                               \
+  CBANG_LOG_LEVEL_RATE(CBANG_LOG_WARNING_LEVEL, secs, msg)
+#define CBANG_LOG_INFO_RATE(x, secs, msg)                               \
+  CBANG_LOG_LEVEL_RATE(CBANG_LOG_INFO_LEVEL(x), secs, msg)
+
+#define CBANG_LOG_ERROR_SAMPLE(n, msg)                          \
+  CBANG_LOG_LEVEL_SAMPLE(CBANG_LOG_ERROR_LEVEL, n, msg)
+#define CBANG_LOG_CRITICAL_SAMPLE(n, msg)                       \
+  CBANG_LOG_LEVEL_SAMPLE(CBANG_LOG_CRITICAL_LEVEL, n, msg)
+#define CBANG_LOG_WARNING_SAMPLE(n, msg)                        \
+  CBANG_LOG_LEVEL_SAMPLE(CBANG_LOG_WARNING_LEVEL, n, msg)
+#define CBANG_LOG_INFO_SAMPLE(x, n, msg)                        \
+  CBANG_LOG_LEVEL_SAMPLE(CBANG_LOG_INFO_LEVEL(x), n, msg)
+
+#ifdef DEBUG
+#define CBANG_LOG_DEBUG_RATE(x, secs, msg)                              \
+  CBANG_LOG_LEVEL_RATE(CBANG_LOG_DEBUG_LEVEL(x), secs, msg)
+#define CBANG_LOG_DEBUG_SAMPLE(x, n, msg)                       \
+  CBANG_LOG_LEVEL_SAMPLE(CBANG_LOG_DEBUG_LEVEL(x), n, msg)
+#else
+#define CBANG_LOG_DEBUG_RATE(x, secs, msg) do {} while (false)
+#define CBANG_LOG_DEBUG_SAMPLE(x, n, msg) do {} while (false)
+#endif
+
 
 #ifdef USING_CBANG
 #define LOG_RAW_LEVEL CBANG_LOG_RAW_LEVEL
@@ -287,4 +480,16 @@ namespace cb {
 #define LOG_WARNING(msg) CBANG_LOG_WARNING(msg)
 #define LOG_INFO(x, msg) CBANG_LOG_INFO(x, msg)
 #define LOG_DEBUG(x, msg) CBANG_LOG_DEBUG(x, msg)
+
+#define LOG_ERROR_RATE(secs, msg) CBANG_LOG_ERROR_RATE(secs, msg)
+#define LOG_CRITICAL_RATE(secs, msg) CBANG_LOG_CRITICAL_RATE(secs, msg)
+#define LOG_WARNING_RATE(secs, msg) CBANG_LOG_WARNING_RATE(secs, msg)
+#define LOG_INFO_RATE(x, secs, msg) CBANG_LOG_INFO_RATE(x, secs, msg)
+#define LOG_DEBUG_RATE(x, secs, msg) CBANG_LOG_DEBUG_RATE(x, secs, msg)
+
+#define LOG_ERROR_SAMPLE(n, msg) CBANG_LOG_ERROR_SAMPLE(n, msg)
+#define LOG_CRITICAL_SAMPLE(n, msg) CBANG_LOG_CRITICAL_SAMPLE(n, msg)
+#define LOG_WARNING_SAMPLE(n, msg) CBANG_LOG_WARNING_SAMPLE(n, msg)
+#define LOG_INFO_SAMPLE(x, n, msg) CBANG_LOG_INFO_SAMPLE(x, n, msg)
+#define LOG_DEBUG_SAMPLE(x, n, msg) CBANG_LOG_DEBUG_SAMPLE(x, n, msg)
 #endif // USING_CBANG
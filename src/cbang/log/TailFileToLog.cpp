@@ -33,74 +33,85 @@
 #include "TailFileToLog.h"
 
 #include <cbang/String.h>
-#include <cbang/time/Timer.h>
+#include <cbang/Catch.h>
 #include <cbang/os/SystemUtilities.h>
 
-#include <string.h>
-
 using namespace std;
 using namespace cb;
 
 
 void TailFileToLog::run() {
-  Timer timer;
+  // Fall back to polling if the file's directory cannot be watched
+  bool watching = false;
+  TRY_CATCH_ERROR(notifier.add(filename); watching = true);
+  if (!FileNotifier::isSupported()) watching = false;
+
+  vector<FileNotifier::event_t> events;
+  bool changed = true;
 
   while (!shouldShutdown()) {
-    if (stream.isNull()) {
-      if (SystemUtilities::exists(filename))
-        stream = SystemUtilities::open(filename, ios::in);
-
-    } else {
-      while (!stream->fail() && !shouldShutdown()) {
-        // Try to read some data
-        stream->read(buffer + fill, bufferSize - fill);
-        fill += stream->gcount();
-
-        while (fill) {
-          // Find end of line
-          buffer[fill] = 0; // Terminate buffer
-          char *eol = strchr(buffer, '\n');
-
-          if (eol) {
-            // Terminate line
-            char *ptr = eol;
-            *ptr-- = 0;
-            if (*ptr == '\r') *ptr = 0;
-
-            // Log the line
-            log();
-
-            // Update buffer
-            fill -= (eol - buffer) + 1;
-            if (fill) {
-              memmove(buffer, eol + 1, fill);
-              continue;
-            }
-
-          } else { // EOL not found
-            if (fill == bufferSize) {
-              // Buffer is full so just log it as is
-              log();
-              fill = 0;
-            }
-
-            break;
-          }
-        }
-
-        // Ignore end of stream but not bad/closed stream
-        if (stream->eof() && !stream->bad()) {
-          stream->clear();
-          break;
-        }
+    if (changed) {
+      if (stream.isNull()) open();
+      else if (truncated()) {
+        // Start over
+        stream->clear();
+        stream->seekg(0);
       }
+
+      if (stream.isSet()) read();
     }
 
-    timer.throttle(0.25);
+    // Wait for changes, waking periodically to check for shutdown
+    notifier.wait(0.25);
+
+    events.clear();
+    changed = notifier.read(events) || !watching;
+
+    for (auto &e: events)
+      if (e.flags & (FileNotifier::FILE_DELETED | FileNotifier::FILE_MOVED))
+        close(); // Reopened when the file is recreated
+  }
+}
+
+
+void TailFileToLog::open() {
+  if (!SystemUtilities::exists(filename)) return;
+  TRY_CATCH_ERROR(stream = SystemUtilities::open(filename, ios::in));
+}
+
+
+bool TailFileToLog::truncated() {
+  streamoff pos = stream->tellg();
+  if (pos <= 0) return false;
+
+  try {
+    return SystemUtilities::getFileSize(filename) < (uint64_t)pos;
+  } catch (const Exception &e) {
+    return false; // Removed, reopened later
   }
 }
 
 
-void TailFileToLog::log() {
-  LOG(logDomain, logLevel, prefix + buffer);
+void TailFileToLog::close() {
+  if (stream.isNull()) return;
+
+  // Anything written before the file was replaced can still be read
+  read();
+  flush();
+
+  stream.release();
+}
+
+
+void TailFileToLog::read() {
+  LineBuffer::read(*stream);
+
+  // Ignore end of stream but not bad/closed stream
+  if (stream->eof() && !stream->bad()) stream->clear();
+}
+
+
+void TailFileToLog::line(const char *data, unsigned length) {
+  if (length && data[length - 1] == '\r') length--;
+  LOG(logDomain, logLevel, prefix + string(data, length));
 }
@@ -34,35 +34,45 @@
 
 #include <cbang/SmartPointer.h>
 #include <cbang/os/Thread.h>
+#include <cbang/os/FileNotifier.h>
 #include <cbang/log/Logger.h>
+#include <cbang/util/LineBuffer.h>
 
 #include <string>
 #include <iostream>
 
 namespace cb {
-  class TailFileToLog : public Thread {
+  /**
+   * Logs lines appended to a file.  The thread sleeps until a FileNotifier
+   * reports a change, so idle files cost nothing.  The file may be created
+   * later, truncated or replaced, e.g. by log rotation.
+   */
+  class TailFileToLog : public Thread, protected LineBuffer {
     const std::string filename;
     const std::string prefix;
     const char *logDomain;
     unsigned logLevel;
     SmartPointer<std::iostream> stream;
-
-    static const unsigned bufferSize = 4096;
-    char buffer[bufferSize + 1]; // Room for null terminator
-    unsigned fill;
+    FileNotifier notifier;
 
   public:
     TailFileToLog(const std::string &filename,
                   const std::string &prefix = std::string(),
                   const char *logDomain = CBANG_LOG_DOMAIN,
                   unsigned logLevel = CBANG_LOG_INFO_LEVEL(1)) :
-      filename(filename), prefix(prefix), logDomain(logDomain),
-      logLevel(logLevel), fill(0) {}
+      LineBuffer(4096), filename(filename), prefix(prefix),
+      logDomain(logDomain), logLevel(logLevel) {}
 
   protected:
     // From Thread
     void run();
 
-    void log();
+    void open();
+    bool truncated();
+    void close();
+    void read();
+
+    // From LineBuffer
+    void line(const char *data, unsigned length);
   };
 }
@@ -33,9 +33,13 @@
 #include "Base64.h"
 
 #include <cbang/Exception.h>
+#include <cbang/os/CPUDispatch.h>
 
-#include <locale>
-#include <utility> // std::move()
+#include <string.h>
+
+#ifdef CBANG_SIMD_X86
+#include <immintrin.h>
+#endif
 
 
 using namespace std;
@@ -43,18 +47,10 @@ using namespace cb;
 
 
 namespace {
-  char next(string::const_iterator &it, string::const_iterator end) {
-    char c = *it++;
-    while (it != end && isspace(*it)) it++;
-    return c;
-  }
-}
-
-
-const char *Base64::encodeTable =
-  "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+  const char *standardEncode =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
 
-const signed char Base64::decodeTable[256] = {
+  const signed char standardDecode[256] = {
   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
   -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
@@ -74,105 +70,305 @@ const signed char Base64::decodeTable[256] = {
 };
 
 
-string Base64::encode(const string &s) const {
-  return encode(s.c_str(), s.length());
-}
+  enum {
+    INVALID = -1,
+    PAD = -2,
+    SPACE = -3,
+  };
 
 
-string Base64::encode(const char *_s, unsigned length) const {
-  const uint8_t *s = (uint8_t *)_s;
-  const uint8_t *end = s + length;
+  // Return the number of bytes consumed, the scalar code does the rest
+  typedef unsigned (*encode_t)(const uint8_t *s, unsigned length, char *dst,
+                               char a, char b);
+  typedef unsigned (*decode_t)(const uint8_t *s, unsigned length, char *dst,
+                               unsigned space, char a, char b);
 
-  struct Result : public string {
-    unsigned col = 0;
-    unsigned width;
+  unsigned encodeNone(const uint8_t *, unsigned, char *, char, char) {
+    return 0;
+  }
 
-    Result(unsigned length, unsigned width) : width(width) {
-      unsigned size = length / 3 * 4 + 4; // Not exact
-      if (width) size += (size / width) * 2;
-      reserve(size);
-    }
 
-    void append(char c) {
-      if (width) {
-        if (col == width) {
-          col = 0;
-          string::append("\r\n");
+  unsigned decodeNone(const uint8_t *, unsigned, char *, unsigned, char,
+                      char) {
+    return 0;
+  }
 
-        } else col++;
-      }
 
-      string::append(1, c);
-    }
-  };
+#ifdef CBANG_SIMD_X86
+  // Encodes 24 bytes to 32 characters, reads 28 bytes
+  CBANG_TARGET_AVX2 inline void
+  encodeAVX2(const uint8_t *s, char *dst, char a, char b) {
+    // Bytes 0-11 in the low lane and 12-23 in the high lane
+    __m256i in = _mm256_inserti128_si256
+      (_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)s)),
+       _mm_loadu_si128((const __m128i *)(s + 12)), 1);
+
+    // Arrange each 3 byte group as b, a, c, b
+    in = _mm256_shuffle_epi8(in, _mm256_setr_epi8(
+      1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+      1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+
+    // Move the four 6-bit indices of each group in to separate bytes
+    __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+    __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+    __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+    __m256i indices = _mm256_or_si256(t1, t3);
+
+    // Map index ranges to the offset of their characters
+    __m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+    range = _mm256_or_si256(range, _mm256_and_si256(upper,
+                                                    _mm256_set1_epi8(13)));
+
+    const char d = '0' - 52;
+    __m256i offsets = _mm256_setr_epi8(
+      'a' - 26, d, d, d, d, d, d, d, d, d, d, a - 62, b - 63, 'A', 0, 0,
+      'a' - 26, d, d, d, d, d, d, d, d, d, d, a - 62, b - 63, 'A', 0, 0);
+
+    __m256i out =
+      _mm256_add_epi8(_mm256_shuffle_epi8(offsets, range), indices);
+    _mm256_storeu_si256((__m256i *)dst, out);
+  }
 
-  Result result(length, width);
-  int padding = 0;
-  uint8_t a, b, c;
-
-  while (s != end) {
-    a = *s++;
-    if (s == end) {c = b = 0; padding = 2;}
-    else {
-      b = *s++;
-      if (s == end) {c = 0; padding = 1;}
-      else c = *s++;
-    }
 
-    result.append(encode(63 & (a >> 2)));
-    result.append(encode(63 & (a << 4 | b >> 4)));
-    if (padding == 2) {if (pad) result.append(pad);}
-    else result.append(encode(63 & (b << 2 | c >> 6)));
-    if (padding) {if (pad) result.append(pad);}
-    else result.append(encode(63 & c));
+  CBANG_TARGET_AVX2 inline __m256i inRange(__m256i x, char lo, char hi) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(x, _mm256_set1_epi8(lo - 1)),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8(hi + 1), x));
   }
 
-  return move(result);
-}
 
+  // Decodes 32 characters to 24 bytes, writes 32 bytes
+  CBANG_TARGET_AVX2 inline bool
+  decodeAVX2(const uint8_t *s, char *dst, char a, char b) {
+    __m256i in = _mm256_loadu_si256((const __m256i *)s);
+
+    __m256i upper = inRange(in, 'A', 'Z');
+    __m256i lower = inRange(in, 'a', 'z');
+    __m256i digit = inRange(in, '0', '9');
+    __m256i isA = _mm256_cmpeq_epi8(in, _mm256_set1_epi8(a));
+    __m256i isB = _mm256_cmpeq_epi8(in, _mm256_set1_epi8(b));
+
+    __m256i valid = _mm256_or_si256(_mm256_or_si256(upper, lower),
+                                    _mm256_or_si256(digit, isA));
+    valid = _mm256_or_si256(valid, isB);
+
+    // Padding, white space and errors are left to the scalar code
+    if (_mm256_movemask_epi8(valid) != -1) return false;
+
+    __m256i offset = _mm256_or_si256(
+      _mm256_and_si256(upper, _mm256_set1_epi8(-'A')),
+      _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a')));
+    offset = _mm256_or_si256(
+      offset, _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')));
+    offset = _mm256_or_si256(
+      offset, _mm256_and_si256(isA, _mm256_set1_epi8(62 - a)));
+    offset = _mm256_or_si256(
+      offset, _mm256_and_si256(isB, _mm256_set1_epi8(63 - b)));
+
+    __m256i values = _mm256_add_epi8(in, offset);
+
+    // Pack four 6-bit values per 32-bit word in to 3 bytes
+    __m256i merged =
+      _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+    merged = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+    merged = _mm256_shuffle_epi8(merged, _mm256_setr_epi8(
+      2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+      2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    merged = _mm256_permutevar8x32_epi32
+      (merged, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+
+    _mm256_storeu_si256((__m256i *)dst, merged);
+
+    return true;
+  }
 
-string Base64::decode(const string &s) const {
-  string result;
-  result.reserve(s.length() / 4 * 3 + 1);
 
-  string::const_iterator it = s.begin();
-  while (it != s.end() && isspace(*it)) it++;
+  CBANG_TARGET_AVX2 unsigned
+  encodeBlocksAVX2(const uint8_t *s, unsigned length, char *dst, char a,
+                   char b) {
+    unsigned i = 0;
+    for (; i + 28 <= length; i += 24, dst += 32) encodeAVX2(s + i, dst, a, b);
+    return i;
+  }
 
-  while (it != s.end()) {
-    char w = decode(next(it, s.end()));
-    char x = it == s.end() ? -2 : decode(next(it, s.end()));
-    char y = it == s.end() ? -2 : decode(next(it, s.end()));
-    char z = it == s.end() ? -2 : decode(next(it, s.end()));
 
-    if (w == -1 || w == -2 || x == -1 || x == -2 || y == -1 || z == -1)
-      THROW("Invalid Base64 data at " << (it - s.begin()));
+  // Stops at padding, white space or errors, writes 32 bytes per block
+  CBANG_TARGET_AVX2 unsigned
+  decodeBlocksAVX2(const uint8_t *s, unsigned length, char *dst,
+                   unsigned space, char a, char b) {
+    unsigned i = 0;
 
-    result += (char)(w << 2 | x >> 4);
-    if (y != -2) {
-      result += (char)(x << 4 | y >> 2);
-      if (z != -2) result += (char)(y << 6 | z);
-    }
+    for (; i + 32 <= length && 32 <= space; i += 32, dst += 24, space -= 24)
+      if (!decodeAVX2(s + i, dst, a, b)) break;
+
+    return i;
   }
 
+
+  const CPUDispatch::Function<encode_t>
+  encodeBlocks(encodeNone, 0, encodeBlocksAVX2);
+  const CPUDispatch::Function<decode_t>
+  decodeBlocks(decodeNone, 0, decodeBlocksAVX2);
+
+#else // CBANG_SIMD_X86
+  const CPUDispatch::Function<encode_t> encodeBlocks(encodeNone);
+  const CPUDispatch::Function<decode_t> decodeBlocks(decodeNone);
+#endif // CBANG_SIMD_X86
+}
+
+
+Base64::Base64(char pad, char a, char b, unsigned width) :
+  pad(pad), a(a), b(b), width(width) {
+  memcpy(encodeTable, standardEncode, 62);
+  encodeTable[62] = a;
+  encodeTable[63] = b;
+
+  memcpy(decodeTable, standardDecode, sizeof(decodeTable));
+  const char *space = " \t\n\v\f\r";
+  for (int i = 0; space[i]; i++) decodeTable[(uint8_t)space[i]] = SPACE;
+  decodeTable[(uint8_t)pad] = PAD;
+  decodeTable[(uint8_t)b] = 63;
+  decodeTable[(uint8_t)a] = 62;
+}
+
+
+string Base64::encode(const string &s) const {
+  return encode(s.data(), s.length());
+}
+
+
+string Base64::encode(const char *s, unsigned length) const {
+  string result(getEncodedLength(length), 0);
+  encode(s, length, &result[0]);
   return result;
 }
 
 
+string Base64::decode(const string &s) const {
+  return decode(s.data(), s.length());
+}
+
+
 string Base64::decode(const char *s, unsigned length) const {
-  return decode(string(s, length));
+  string result(getMaxDecodedLength(length), 0);
+  result.resize(decode(s, length, &result[0]));
+  return result;
 }
 
 
-char Base64::encode(int x) const {
-  if (x == 62) return a;
-  if (x == 63) return b;
-  return encodeTable[x];
+unsigned Base64::getEncodedLength(unsigned length) const {
+  unsigned size = length / 3 * 4;
+  if (length % 3) size += pad ? 4 : length % 3 + 1;
+  if (width && size) size += (size - 1) / width * 2;
+  return size;
 }
 
 
-int Base64::decode(char x) const {
-  if (x == a) return 62;
-  if (x == b) return 63;
-  if (x == pad) return -2;
-  return decodeTable[(int)x];
+unsigned Base64::getMaxDecodedLength(unsigned length) const {
+  return length / 4 * 3 + 3;
+}
+
+
+unsigned Base64::encode(const char *_s, unsigned length, char *dst) const {
+  const uint8_t *s = (const uint8_t *)_s;
+  const uint8_t *end = s + length;
+  char *out = dst;
+
+  unsigned bytes = encodeBlocks(s, length, out, a, b);
+  s += bytes;
+  out += bytes / 3 * 4;
+
+  for (; 3 <= end - s; s += 3) {
+    uint32_t x = s[0] << 16 | s[1] << 8 | s[2];
+    *out++ = encodeTable[63 & (x >> 18)];
+    *out++ = encodeTable[63 & (x >> 12)];
+    *out++ = encodeTable[63 & (x >> 6)];
+    *out++ = encodeTable[63 & x];
+  }
+
+  if (s != end) {
+    uint8_t x = s[0];
+    uint8_t y = s + 1 == end ? 0 : s[1];
+
+    *out++ = encodeTable[63 & (x >> 2)];
+    *out++ = encodeTable[63 & (x << 4 | y >> 4)];
+    if (s + 1 != end) *out++ = encodeTable[63 & (y << 2)];
+    else if (pad) *out++ = pad;
+    if (pad) *out++ = pad;
+  }
+
+  unsigned size = out - dst;
+
+  if (width && width < size) {
+    // Move lines in to place from the back to insert line breaks
+    unsigned breaks = (size - 1) / width;
+    unsigned last = size - breaks * width;
+    char *src = dst + size - last;
+    out = dst + size + breaks * 2 - last;
+    memmove(out, src, last);
+
+    for (unsigned i = 0; i < breaks; i++) {
+      *--out = '\n';
+      *--out = '\r';
+      out -= width;
+      src -= width;
+      memmove(out, src, width);
+    }
+
+    size += breaks * 2;
+  }
+
+  return size;
+}
+
+
+unsigned Base64::decode(const char *_s, unsigned length, char *dst) const {
+  const uint8_t *s = (const uint8_t *)_s;
+  const uint8_t *it = s;
+  const uint8_t *end = s + length;
+  char *out = dst;
+
+  char *limit = dst + getMaxDecodedLength(length);
+
+  while (true) {
+    unsigned chars = decodeBlocks(it, end - it, out, limit - out, a, b);
+    it += chars;
+    out += chars / 4 * 3;
+
+    // Whole groups without padding or white space
+    for (; 4 <= end - it; it += 4) {
+      int w = decodeTable[it[0]];
+      int x = decodeTable[it[1]];
+      int y = decodeTable[it[2]];
+      int z = decodeTable[it[3]];
+      if ((w | x | y | z) < 0) break;
+
+      uint32_t v = w << 18 | x << 12 | y << 6 | z;
+      *out++ = v >> 16;
+      *out++ = v >> 8;
+      *out++ = v;
+    }
+
+    // One group at a time, skipping white space
+    while (it != end && decodeTable[*it] == SPACE) it++;
+    if (it == end) break;
+
+    int v[4];
+    for (unsigned i = 0; i < 4; i++) {
+      while (it != end && decodeTable[*it] == SPACE) it++;
+      v[i] = it == end ? PAD : decodeTable[*it++];
+    }
+
+    if (v[0] < 0 || v[1] < 0 || v[2] == INVALID || v[3] == INVALID)
+      THROW("Invalid Base64 data at " << (it - s));
+
+    *out++ = v[0] << 2 | v[1] >> 4;
+    if (v[2] != PAD) {
+      *out++ = v[1] << 4 | v[2] >> 2;
+      if (v[3] != PAD) *out++ = v[2] << 6 | v[3];
+    }
+  }
+
+  return out - dst;
 }
@@ -44,21 +44,39 @@ namespace cb {
     const char b;
     unsigned width;
 
-    static const char *encodeTable;
-    static const signed char decodeTable[256];
+    char encodeTable[64];
+    signed char decodeTable[256];
 
   public:
-    Base64(char pad = '=', char a = '+', char b = '/', unsigned width = 0) :
-      pad(pad), a(a), b(b), width(width) {}
+    Base64(char pad = '=', char a = '+', char b = '/', unsigned width = 0);
 
     std::string encode(const std::string &s) const;
     std::string encode(const char *s, unsigned length) const;
     std::string decode(const std::string &s) const;
     std::string decode(const char *s, unsigned length) const;
 
+    /// @return The exact size of the encoding of @param length bytes
+    unsigned getEncodedLength(unsigned length) const;
+    /// @return The most bytes @param length characters can decode to
+    unsigned getMaxDecodedLength(unsigned length) const;
+
+    /**
+     * Encode in to a caller provided buffer which must hold at least
+     * getEncodedLength(length) characters.
+     * @return The number of characters written.
+     */
+    unsigned encode(const char *s, unsigned length, char *dst) const;
+
+    /**
+     * Decode in to a caller provided buffer which must hold at least
+     * getMaxDecodedLength(length) bytes.
+     * @return The number of bytes written.
+     */
+    unsigned decode(const char *s, unsigned length, char *dst) const;
+
   protected:
-    char encode(int x) const;
-    int decode(char x) const;
+    char encode(int x) const {return encodeTable[x];}
+    int decode(char x) const {return decodeTable[(uint8_t)x];}
   };
 
 
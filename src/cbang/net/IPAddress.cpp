@@ -51,6 +51,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <netdb.h>
+#include <arpa/inet.h>
 #endif
 
 #include <string.h>
@@ -60,9 +61,10 @@ using namespace cb;
 
 
 IPAddress::IPAddress(const string &host) :
-  host(host), ip(0), port(portFromString(host)) {
+  host(host), ip(0), port(isUnix() ? 0 : portFromString(host)) {
 
   Socket::initialize(); // Windows needs this
+  if (isUnix()) return;
 
   size_t ptr = host.find(":");
   if (ptr != string::npos) this->host = host.substr(0, ptr);
@@ -98,22 +100,44 @@ bool IPAddress::hasHost() const {
 }
 
 
-void IPAddress::lookupHost() {host = hostFromIP(*this);}
+void IPAddress::lookupHost() {if (!isUnix()) host = hostFromIP(*this);}
+
+
+string IPAddress::getUnixPath() const {
+  if (!isUnix()) THROW("'" << *this << "' is not a Unix socket address");
+  return host.substr(5);
+}
 
 
 uint32_t IPAddress::getIP() const {
-  if (!ip && !host.empty())
+  if (!ip && !host.empty() && !isUnix())
     const_cast<IPAddress *>(this)->ip = ipFromString(host);
   return ip;
 }
 
 
+bool IPAddress::hasNumericIP() const {
+  if (ip) return true;
+  if (host.empty() || isUnix()) return false;
+
+  struct in_addr addr;
+  if (inet_pton(AF_INET, host.c_str(), &addr) != 1) return false;
+
+  const_cast<IPAddress *>(this)->ip = ntohl(addr.s_addr);
+  return true;
+}
+
+
 string IPAddress::toString() const {
   return getHost() + (getPort() ? String::printf(":%d", getPort()) : string());
 }
 
 
 uint32_t IPAddress::ipFromString(const string &host) {
+  // Avoid getaddrinfo() for numeric addresses
+  struct in_addr addr;
+  if (inet_pton(AF_INET, host.c_str(), &addr) == 1) return ntohl(addr.s_addr);
+
   vector<IPAddress> addrs;
 
   if (!ipsFromString(host, addrs, 0, 1))
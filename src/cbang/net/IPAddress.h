@@ -40,7 +40,13 @@
 
 
 namespace cb {
-  /// Used for printing and comparing IP addresses
+  /**
+   * Used for printing and comparing IP addresses.
+   *
+   * A host of the form "unix:<path>" names a Unix domain socket rather than
+   * an IP address.  A path starting with '@' is in the Linux abstract
+   * namespace.
+   */
   class IPAddress {
     std::string host;
     uint32_t ip; // Host byte order
@@ -57,8 +63,13 @@ namespace cb {
     bool hasHost() const;
     void lookupHost();
 
+    bool isUnix() const {return host.compare(0, 5, "unix:") == 0;}
+    std::string getUnixPath() const;
+
     void setIP(uint32_t ip) {this->ip = ip;}
     uint32_t getIP() const;
+    /// @return True if the IP is known without a blocking name lookup
+    bool hasNumericIP() const;
 
     void setPort(uint16_t port) {this->port = port;}
     uint16_t getPort() const {return port;}
@@ -69,14 +80,17 @@ namespace cb {
     operator uint32_t () const {return getIP();}
 
     bool operator<(const IPAddress &a) const {
+      if (isUnix() || a.isUnix()) return host < a.host;
       return
         getIP() == a.getIP() ? getPort() < a.getPort() : getIP() < a.getIP();
     }
     bool operator<=(const IPAddress &a) const {return !(a < *this);}
     bool operator>(const IPAddress &a) const {return a < *this;}
     bool operator>=(const IPAddress &a) const {return !(*this < a);}
-    bool operator==(const IPAddress &a) const
-    {return getIP() == a.getIP() && getPort() == a.getPort();}
+    bool operator==(const IPAddress &a) const {
+      if (isUnix() || a.isUnix()) return host == a.host;
+      return getIP() == a.getIP() && getPort() == a.getPort();
+    }
     bool operator!=(const IPAddress &a) const {return !(*this == a);}
 
     static uint32_t ipFromString(const std::string &host);
@@ -36,31 +36,77 @@ using namespace std;
 using namespace cb;
 
 
-void IPAddressFilter::deny(const string &spec) {
-  blackList.insert(spec);
+void IPAddressFilter::deny(const string &spec) {add(blackList, spec);}
+void IPAddressFilter::allow(const string &spec) {add(whiteList, spec);}
+void IPAddressFilter::deny(IPAddressRange &range) {add(blackList, range);}
+void IPAddressFilter::allow(IPAddressRange &range) {add(whiteList, range);}
+
+
+void IPAddressFilter::setDenyList(const list_t &list) {
+  atomic_store(&blackList, list);
 }
 
 
-void IPAddressFilter::allow(const string &spec) {
-  whiteList.insert(spec);
+void IPAddressFilter::setAllowList(const list_t &list) {
+  atomic_store(&whiteList, list);
 }
 
 
-void IPAddressFilter::deny(IPAddressRange &range) {
-  blackList.insert(range);
+IPAddressFilter::list_t IPAddressFilter::getDenyList() const {
+  return atomic_load(&blackList);
 }
 
 
-void IPAddressFilter::allow(IPAddressRange &range) {
-  whiteList.insert(range);
+IPAddressFilter::list_t IPAddressFilter::getAllowList() const {
+  return atomic_load(&whiteList);
 }
 
 
 bool IPAddressFilter::isAllowed(const IPAddress &addr) const {
-  return whiteList.contains(addr) || !blackList.contains(addr);
+  if (isExplicitlyAllowed(addr)) return true;
+  list_t list = getDenyList();
+  return !list || !list->contains(addr);
+}
+
+
+bool IPAddressFilter::isAllowed(const uint8_t addr[16]) const {
+  list_t list = getAllowList();
+  if (list && list->contains(addr)) return true;
+  list = getDenyList();
+  return !list || !list->contains(addr);
 }
 
 
 bool IPAddressFilter::isExplicitlyAllowed(const IPAddress &addr) const {
-  return whiteList.contains(addr);
+  list_t list = getAllowList();
+  return list && list->contains(addr);
+}
+
+
+uint64_t IPAddressFilter::getMemoryUsage() const {
+  list_t white = getAllowList();
+  list_t black = getDenyList();
+
+  return (white ? white->getMemoryUsage() : 0) +
+    (black ? black->getMemoryUsage() : 0);
+}
+
+
+void IPAddressFilter::add(list_t &list, const string &spec) {
+  list_t old = atomic_load(&list);
+  shared_ptr<IPPrefixSet> set =
+    old ? make_shared<IPPrefixSet>(*old) : make_shared<IPPrefixSet>();
+
+  set->insert(spec);
+  atomic_store(&list, list_t(set));
+}
+
+
+void IPAddressFilter::add(list_t &list, const IPAddressRange &range) {
+  list_t old = atomic_load(&list);
+  shared_ptr<IPPrefixSet> set =
+    old ? make_shared<IPPrefixSet>(*old) : make_shared<IPPrefixSet>();
+
+  set->insert(range);
+  atomic_store(&list, list_t(set));
 }
@@ -32,20 +32,30 @@
 
 #pragma once
 
-#include <string>
+#include <cbang/net/IPPrefixSet.h>
+#include <cbang/net/IPAddressRange.h>
 
-#include <cbang/net/IPRangeSet.h>
+#include <string>
+#include <memory>
 
 namespace cb {
   /**
    * Used to allow or deny clients by IP address.
    * Used a white (allow) and black (deny) list to filter IPs.
    *
-   * @see IPRangeSet
+   * Both lists are compiled IPPrefixSets which are replaced atomically, so
+   * lookups never block and may run on any thread while a list is being
+   * rebuilt.  The functions which modify the lists copy and recompile the
+   * whole list and must not be called concurrently with each other.  Large
+   * lists should be built on their own and installed with setAllowList() or
+   * setDenyList().
+   *
+   * @see IPPrefixSet
    */
   class IPAddressFilter {
-    IPRangeSet whiteList;
-    IPRangeSet blackList;
+    typedef std::shared_ptr<const IPPrefixSet> list_t;
+    list_t whiteList;
+    list_t blackList;
 
   public:
     /// Add a IP address specification to the deny list.
@@ -58,10 +68,27 @@ namespace cb {
     /// Add a IP address range to the allow list.
     void allow(IPAddressRange &range);
 
+    /// Replace the deny list with a compiled set.
+    void setDenyList(const list_t &list);
+    /// Replace the allow list with a compiled set.
+    void setAllowList(const list_t &list);
+
+    list_t getDenyList() const;
+    list_t getAllowList() const;
+
     /// @return True if the IP address is allowed by the current rules.
     bool isAllowed(const IPAddress &addr) const;
+    /// @return True if the IPv6 address is allowed by the current rules.
+    bool isAllowed(const uint8_t addr[16]) const;
 
     /// @return True if the IP address is in the white list
     bool isExplicitlyAllowed(const IPAddress &addr) const;
+
+    /// @return The number of bytes allocated by both lists.
+    uint64_t getMemoryUsage() const;
+
+  protected:
+    static void add(list_t &list, const std::string &spec);
+    static void add(list_t &list, const IPAddressRange &range);
   };
 }
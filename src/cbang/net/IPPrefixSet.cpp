@@ -0,0 +1,426 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "IPPrefixSet.h"
+#include "IPAddressRange.h"
+
+#include <cbang/Exception.h>
+#include <cbang/String.h>
+#include <cbang/SStream.h>
+#include <cbang/json/Sink.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+using namespace std;
+using namespace cb;
+
+
+namespace {
+  const uint64_t IPV4_MAPPED = 0xffff00000000ULL;
+
+
+  inline uint64_t maskHi(unsigned bits) {
+    return 64 <= bits ? ~0ULL : bits ? ~0ULL << (64 - bits) : 0;
+  }
+
+
+  inline uint64_t maskLo(unsigned bits) {
+    return bits <= 64 ? 0 : 128 <= bits ? ~0ULL : ~0ULL << (128 - bits);
+  }
+
+
+  inline unsigned clz(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_clzll(x);
+#else
+    unsigned n = 0;
+    while (!(x & (1ULL << 63))) {x <<= 1; n++;}
+    return n;
+#endif
+  }
+
+
+  inline bool getBit(uint64_t hi, uint64_t lo, unsigned i) {
+    return i < 64 ? (hi >> (63 - i)) & 1 : (lo >> (127 - i)) & 1;
+  }
+}
+
+
+IPPrefixSet::Prefix::Prefix(uint64_t hi, uint64_t lo, uint8_t bits) :
+  hi(hi & maskHi(bits)), lo(lo & maskLo(bits)), bits(bits) {
+  if (128 < bits) THROW("Invalid IPv6 prefix length /" << (unsigned)bits);
+}
+
+
+IPPrefixSet::Prefix::Prefix(const uint8_t ip[16], uint8_t bits) :
+  Prefix(0, 0, 0) {
+  if (128 < bits) THROW("Invalid IPv6 prefix length /" << (unsigned)bits);
+
+  for (unsigned i = 0; i < 8; i++) {
+    hi = (hi << 8) | ip[i];
+    lo = (lo << 8) | ip[i + 8];
+  }
+
+  hi &= maskHi(bits);
+  lo &= maskLo(bits);
+  this->bits = bits;
+}
+
+
+IPPrefixSet::Prefix::Prefix(uint32_t ip, uint8_t bits) :
+  Prefix(0, IPV4_MAPPED | ip, bits + 96) {
+  if (32 < bits) THROW("Invalid IP bit mask /" << (unsigned)bits);
+}
+
+
+bool IPPrefixSet::Prefix::isIPv4() const {
+  return 96 <= bits && !hi && (lo >> 32) == 0xffff;
+}
+
+
+bool IPPrefixSet::Prefix::getBit(unsigned i) const {
+  return ::getBit(hi, lo, i);
+}
+
+
+bool IPPrefixSet::Prefix::contains(const Prefix &o) const {
+  return bits <= o.bits && (o.hi & maskHi(bits)) == hi &&
+    (o.lo & maskLo(bits)) == lo;
+}
+
+
+bool IPPrefixSet::Prefix::operator<(const Prefix &o) const {
+  if (hi != o.hi) return hi < o.hi;
+  if (lo != o.lo) return lo < o.lo;
+  return bits < o.bits;
+}
+
+
+string IPPrefixSet::Prefix::toString() const {
+  if (isIPv4()) {
+    uint32_t ip = (uint32_t)lo;
+    string s = String::printf("%d.%d.%d.%d", ip >> 24, (ip >> 16) & 0xff,
+                              (ip >> 8) & 0xff, ip & 0xff);
+    if (bits < 128) s += String::printf("/%d", bits - 96);
+    return s;
+  }
+
+  uint16_t groups[8];
+  for (unsigned i = 0; i < 4; i++) {
+    groups[i] = hi >> (48 - 16 * i);
+    groups[i + 4] = lo >> (48 - 16 * i);
+  }
+
+  // Find the longest run of zeros to replace with "::"
+  int gap = -1;
+  unsigned gapLen = 1;
+  for (unsigned i = 0; i < 8; i++) {
+    unsigned j = i;
+    while (j < 8 && !groups[j]) j++;
+    if (gapLen < j - i) {gap = i; gapLen = j - i;}
+    if (i < j) i = j - 1;
+  }
+
+  string s;
+  for (unsigned i = 0; i < 8; i++)
+    if ((int)i == gap) {
+      s += "::";
+      i += gapLen - 1;
+
+    } else {
+      if (i && (int)i != gap + (int)gapLen) s += ':';
+      s += String::printf("%x", groups[i]);
+    }
+
+  if (bits < 128) s += String::printf("/%d", bits);
+
+  return s;
+}
+
+
+void IPPrefixSet::clear() {
+  prefixes.clear();
+  nodes.clear();
+  table.clear();
+  root = tableBits = 0;
+  dirty = false;
+}
+
+
+void IPPrefixSet::insert(const string &spec) {
+  add(spec);
+  compile();
+}
+
+
+void IPPrefixSet::insert(const IPAddressRange &range) {
+  add(range);
+  compile();
+}
+
+
+void IPPrefixSet::insert(const Prefix &prefix) {
+  add(prefix);
+  compile();
+}
+
+
+void IPPrefixSet::add(const string &spec) {
+  vector<string> tokens;
+  String::tokenize(spec, tokens, " \r\n\t,;");
+
+  for (unsigned i = 0; i < tokens.size(); i++)
+    if (1 < count(tokens[i].begin(), tokens[i].end(), ':'))
+      add(parseIPv6(tokens[i]));
+    else add(IPAddressRange(tokens[i]));
+}
+
+
+void IPPrefixSet::add(const IPAddressRange &range) {
+  uint64_t start = range.getStart().getIP();
+  uint64_t end = range.getEnd().getIP();
+
+  if (end < start) swap(start, end);
+
+  // Split in to the largest aligned CIDR blocks
+  while (start <= end) {
+    uint64_t size = start ? start & (~start + 1) : 1ULL << 32;
+    while (end < start + size - 1) size >>= 1;
+
+    unsigned bits = 32;
+    while (1ULL < size) {size >>= 1; bits--;}
+
+    add(Prefix((uint32_t)start, bits));
+    start += 1ULL << (32 - bits);
+  }
+}
+
+
+void IPPrefixSet::compile() {
+  if (!dirty) return;
+  dirty = false;
+
+  // Sort and drop prefixes covered by another prefix
+  sort(prefixes.begin(), prefixes.end());
+
+  unsigned n = 0;
+  for (unsigned i = 0; i < prefixes.size(); i++)
+    if (!n || !prefixes[n - 1].contains(prefixes[i]))
+      prefixes[n++] = prefixes[i];
+
+  prefixes.resize(n);
+  prefixes.shrink_to_fit();
+
+  nodes.clear();
+  table.clear();
+  root = tableBits = 0;
+  if (prefixes.empty()) return;
+
+  nodes.reserve(prefixes.size() - 1);
+  root = build(0, prefixes.size());
+
+  if (TABLE_MIN <= prefixes.size()) {
+    // About one prefix per slot
+    tableBits = 16;
+    while (tableBits < 22 && (1ULL << tableBits) < prefixes.size())
+      tableBits++;
+
+    table.resize(1 << tableBits);
+    for (uint64_t i = 0; i < table.size(); i++)
+      table[i] = descend(root, 0, IPV4_MAPPED | (i << (32 - tableBits)),
+                         96 + tableBits);
+  }
+}
+
+
+bool IPPrefixSet::contains(const IPAddress &ip) const {
+  return contains(0, IPV4_MAPPED | ip.getIP());
+}
+
+
+bool IPPrefixSet::contains(const uint8_t ip[16]) const {
+  Prefix p(ip, 128);
+  return contains(p.hi, p.lo);
+}
+
+
+bool IPPrefixSet::contains(uint64_t hi, uint64_t lo) const {
+  if (prefixes.empty()) return false;
+
+  uint32_t ref = root;
+  if (!table.empty() && !hi && (lo >> 32) == 0xffff)
+    ref = table[(uint32_t)lo >> (32 - tableBits)];
+
+  return prefixes[descend(ref, hi, lo, 128) & ~LEAF].contains
+    (Prefix(hi, lo, 128));
+}
+
+
+uint64_t IPPrefixSet::getMemoryUsage() const {
+  return sizeof(IPPrefixSet) + prefixes.capacity() * sizeof(Prefix) +
+    nodes.capacity() * sizeof(Node) + table.capacity() * sizeof(uint32_t);
+}
+
+
+string IPPrefixSet::toString() const {
+  return SSTR(*this);
+}
+
+
+void IPPrefixSet::print(ostream &stream) const {
+  for (unsigned i = 0; i < prefixes.size(); i++) {
+    if (i) stream << ' ';
+    stream << prefixes[i].toString();
+  }
+}
+
+
+void IPPrefixSet::write(JSON::Sink &sink) const {
+  sink.beginList();
+
+  for (unsigned i = 0; i < prefixes.size(); i++)
+    sink.append(prefixes[i].toString());
+
+  sink.endList();
+}
+
+
+IPPrefixSet::Prefix IPPrefixSet::parseIPv6(const string &s) {
+  string addr = s;
+  unsigned bits = 128;
+
+  size_t slash = s.find('/');
+  if (slash != string::npos) {
+    bits = String::parseU8(s.substr(slash + 1));
+    if (128 < bits) THROW("Invalid IPv6 prefix length /" << bits);
+    addr = s.substr(0, slash);
+  }
+
+  uint16_t groups[8] = {0};
+  unsigned count = 0;
+  int gap = -1; // Position of "::"
+  const char *p = addr.c_str();
+
+  if (p[0] == ':' && p[1] == ':') {gap = 0; p += 2;}
+
+  while (*p) {
+    if (count == 8) THROW("Invalid IPv6 address '" << s << "'");
+
+    const char *q = p;
+    while (isxdigit(*q)) q++;
+
+    if (*q == '.') { // Embedded IPv4 address
+      if (6 < count) THROW("Invalid IPv6 address '" << s << "'");
+      uint32_t ip = IPAddress(string(p)).getIP();
+      groups[count++] = ip >> 16;
+      groups[count++] = ip & 0xffff;
+      break;
+    }
+
+    if (q == p || 4 < q - p) THROW("Invalid IPv6 address '" << s << "'");
+    groups[count++] = strtoul(string(p, q - p).c_str(), 0, 16);
+
+    p = q;
+    if (!*p) break;
+    if (*p++ != ':' || !*p) THROW("Invalid IPv6 address '" << s << "'");
+
+    if (*p == ':') {
+      if (0 <= gap) THROW("Invalid IPv6 address '" << s << "'");
+      gap = count;
+      p++;
+    }
+  }
+
+  if (gap < 0 ? count != 8 : count == 8)
+    THROW("Invalid IPv6 address '" << s << "'");
+
+  // Expand "::"
+  if (0 <= gap) {
+    unsigned fill = 8 - count;
+    for (int i = count - 1; gap <= i; i--) {
+      groups[i + fill] = groups[i];
+      groups[i] = 0;
+    }
+  }
+
+  uint64_t hi = 0;
+  uint64_t lo = 0;
+  for (unsigned i = 0; i < 4; i++) {
+    hi = (hi << 16) | groups[i];
+    lo = (lo << 16) | groups[i + 4];
+  }
+
+  return Prefix(hi, lo, bits);
+}
+
+
+uint32_t IPPrefixSet::build(unsigned start, unsigned end) {
+  if (end - start == 1) return start | LEAF;
+
+  // The first bit where the outer prefixes differ splits the range
+  const Prefix &a = prefixes[start];
+  const Prefix &b = prefixes[end - 1];
+  unsigned bit = a.hi != b.hi ? clz(a.hi ^ b.hi) : 64 + clz(a.lo ^ b.lo);
+
+  unsigned lo = start;
+  unsigned hi = end;
+  while (lo < hi) {
+    unsigned mid = lo + (hi - lo) / 2;
+    if (prefixes[mid].getBit(bit)) hi = mid;
+    else lo = mid + 1;
+  }
+
+  uint32_t index = nodes.size();
+  nodes.push_back(Node());
+  nodes[index].bit = bit;
+
+  uint32_t left = build(start, lo);
+  nodes[index].child[0] = left;
+  uint32_t right = build(lo, end);
+  nodes[index].child[1] = right;
+
+  return index;
+}
+
+
+uint32_t IPPrefixSet::descend(uint32_t ref, uint64_t hi, uint64_t lo,
+                              unsigned maxBit) const {
+  while (!(ref & LEAF)) {
+    const Node &node = nodes[ref];
+    if (maxBit <= node.bit) break;
+    ref = node.child[::getBit(hi, lo, node.bit)];
+  }
+
+  return ref;
+}
@@ -0,0 +1,152 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/StdTypes.h>
+#include <cbang/SmartPointer.h>
+#include <cbang/net/IPAddress.h>
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+namespace cb {namespace JSON {class Sink;}}
+
+
+namespace cb {
+  class IPAddressRange;
+
+  /**
+   * A compiled set of IPv4 and IPv6 network prefixes.
+   *
+   * IPv4 addresses are stored in the IPv4-mapped part of the IPv6 address
+   * space, ::ffff:0:0/96.  Prefixes covered by another prefix are dropped
+   * and the rest are compiled in to a path compressed binary trie held in
+   * one contiguous array.  A lookup tests one bit per branch and compares
+   * the address only once, at the leaf.  Large sets also get a table
+   * indexed by the leading 16 to 22 bits of IPv4 addresses, sized to the
+   * number of prefixes, which skips the top of the trie.
+   *
+   * insert() recompiles the set each time.  Large lists, such as block
+   * lists loaded from a feed, should be collected with add() and compiled
+   * once with compile().
+   */
+  class IPPrefixSet {
+  public:
+    struct Prefix {
+      uint64_t hi;
+      uint64_t lo;
+      uint8_t bits;
+
+      Prefix() : hi(0), lo(0), bits(0) {}
+      Prefix(uint64_t hi, uint64_t lo, uint8_t bits);
+      Prefix(const uint8_t ip[16], uint8_t bits);
+      Prefix(uint32_t ip, uint8_t bits);
+
+      bool isIPv4() const;
+      bool getBit(unsigned i) const;
+      bool contains(const Prefix &o) const;
+      bool operator<(const Prefix &o) const;
+      std::string toString() const;
+    };
+
+  protected:
+    struct Node {
+      uint32_t child[2];
+      uint8_t bit;
+    };
+
+    static const uint32_t LEAF = 1U << 31;
+    static const unsigned TABLE_MIN = 4096;
+
+    std::vector<Prefix> prefixes;
+    std::vector<Node> nodes;
+    std::vector<uint32_t> table;
+    uint32_t root = 0;
+    unsigned tableBits = 0;
+    bool dirty = false;
+
+  public:
+    IPPrefixSet() {}
+    IPPrefixSet(const std::string &spec) {insert(spec);}
+
+    void clear();
+    bool empty() const {return prefixes.empty();}
+    unsigned size() const {return prefixes.size();}
+    const Prefix &get(unsigned i) const {return prefixes.at(i);}
+
+    /// Add prefixes and compile the set
+    void insert(const std::string &spec);
+    void insert(const IPAddressRange &range);
+    void insert(const Prefix &prefix);
+
+    /**
+     * Add prefixes without compiling the set.  Accepts the same addresses,
+     * ranges and CIDRs as IPAddressRange, separated by whitespace, commas
+     * or semicolons, plus IPv6 addresses with an optional /bits suffix.
+     * IPv4 ranges are split in to the fewest covering CIDRs.
+     */
+    void add(const std::string &spec);
+    void add(const IPAddressRange &range);
+    void add(const Prefix &prefix) {prefixes.push_back(prefix); dirty = true;}
+    /// Must be called after add() before the new prefixes are matched
+    void compile();
+
+    bool contains(const IPAddress &ip) const;
+    bool contains(const uint8_t ip[16]) const;
+    bool contains(uint64_t hi, uint64_t lo) const;
+
+    /// @return The number of bytes allocated by the set.
+    uint64_t getMemoryUsage() const;
+
+    std::string toString() const;
+    void print(std::ostream &stream) const;
+    void write(JSON::Sink &sink) const;
+
+    static SmartPointer<IPPrefixSet> parse(const std::string &s)
+    {return new IPPrefixSet(s);}
+    static Prefix parseIPv6(const std::string &s);
+
+  protected:
+    uint32_t build(unsigned start, unsigned end);
+    uint32_t descend(uint32_t ref, uint64_t hi, uint64_t lo,
+                     unsigned maxBit) const;
+  };
+
+
+  static inline
+  std::ostream &operator<<(std::ostream &stream, const IPPrefixSet &s) {
+    s.print(stream);
+    return stream;
+  }
+}
@@ -34,7 +34,9 @@
 
 #include <cbang/config.h>
 #include <cbang/config/Options.h>
+#include <cbang/os/Mutex.h>
 #include <cbang/util/Random.h>
+#include <cbang/util/SmartLock.h>
 #include <cbang/json/JSON.h>
 
 #ifdef HAVE_OPENSSL
@@ -42,21 +44,93 @@
 #endif
 
 #include <vector>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
 
 using namespace cb;
 using namespace std;
 
 
-SessionManager::SessionManager() :
-  lifetime(Time::SEC_PER_DAY), timeout(Time::SEC_PER_HOUR), cookie("sid") {}
+namespace {
+  const unsigned numShards = 64;
+  const unsigned wheelSize = 4096; // Seconds
+}
+
+
+struct SessionManager::Shard {
+  typedef list<const string *> slot_t;
+
+  struct Entry {
+    SmartPointer<Session> session;
+    uint64_t created;  // Parsing the Session's time strings is slow
+    uint64_t lastUsed;
+    slot_t::iterator pos;
+    unsigned slot;
+  };
+
+  typedef unordered_map<string, Entry> sessions_t;
+
+  Mutex lock;
+  sessions_t sessions;
+  vector<slot_t> wheel;   // The last slot holds sessions that never expire
+  uint64_t next;          // The next second to sweep
+  unordered_set<string> dirty;
+
+  Shard() : wheel(wheelSize + 1), next(Time::now()) {}
+
+
+  void schedule(sessions_t::iterator it, uint64_t expires) {
+    Entry &e = it->second;
+    unsigned slot = expires ? max(expires, next) % wheelSize : wheelSize;
+
+    if (e.slot == slot) return;
+    wheel[slot].splice(wheel[slot].end(), wheel[e.slot], e.pos);
+    e.slot = slot;
+  }
+
 
+  sessions_t::iterator insert(const SmartPointer<Session> &session) {
+    auto result = sessions.insert
+      (sessions_t::value_type(session->getID(), Entry()));
 
-SessionManager::SessionManager(Options &options) :
+    Entry &e = result.first->second;
+    e.session = session;
+    e.created = session->getCreationTime();
+    e.lastUsed = session->getLastUsed();
+
+    if (result.second) {
+      e.slot = wheelSize;
+      e.pos = wheel[e.slot].insert(wheel[e.slot].end(),
+                                   &result.first->first);
+    }
+
+    return result.first;
+  }
+
+
+  void erase(sessions_t::iterator it) {
+    wheel[it->second.slot].erase(it->second.pos);
+    sessions.erase(it);
+  }
+};
+
+
+SessionManager::SessionManager() :
   lifetime(Time::SEC_PER_DAY), timeout(Time::SEC_PER_HOUR), cookie("sid") {
+  for (unsigned i = 0; i < numShards; i++) shards.push_back(new Shard);
+}
+
+
+SessionManager::SessionManager(Options &options) : SessionManager() {
   addOptions(options);
 }
 
 
+SessionManager::~SessionManager() {}
+
+
 void SessionManager::addOptions(Options &options) {
   options.pushCategory("Session Management");
 
@@ -71,6 +145,74 @@ void SessionManager::addOptions(Options &options) {
 }
 
 
+void SessionManager::load() {
+  if (backend.isNull()) THROW("Session backend not set");
+
+  backend->load([this] (const string &sid, const string &json) {
+      SmartPointer<Session> session =
+        new Session(*JSON::Reader::parseString(json));
+      session->setID(sid);
+      add(session, false);
+    });
+}
+
+
+void SessionManager::flush() {
+  if (backend.isNull()) return;
+
+  vector<pair<string, string> > saves;
+  vector<string> erases;
+
+  // Serialize under the shard locks but write without them
+  for (unsigned i = 0; i < shards.size(); i++) {
+    Shard &shard = *shards[i];
+    SmartLock lock(&shard.lock);
+
+    for (auto it = shard.dirty.begin(); it != shard.dirty.end(); it++) {
+      auto it2 = shard.sessions.find(*it);
+
+      if (it2 == shard.sessions.end()) erases.push_back(*it);
+      else saves.push_back
+             (make_pair(*it, it2->second.session->toString(0, true)));
+    }
+
+    shard.dirty.clear();
+  }
+
+  if (saves.empty() && erases.empty()) return;
+
+  try {
+    backend->begin();
+
+    for (unsigned i = 0; i < saves.size(); i++)
+      backend->save(saves[i].first, saves[i].second);
+
+    for (unsigned i = 0; i < erases.size(); i++)
+      backend->erase(erases[i]);
+
+    backend->commit();
+
+  } catch (...) {
+    // Queue the changes again for the next flush()
+    for (unsigned i = 0; i < saves.size(); i++) requeue(saves[i].first);
+    for (unsigned i = 0; i < erases.size(); i++) requeue(erases[i]);
+    throw;
+  }
+}
+
+
+unsigned SessionManager::getSessionCount() const {
+  unsigned count = 0;
+
+  for (unsigned i = 0; i < shards.size(); i++) {
+    SmartLock lock(&shards[i]->lock);
+    count += shards[i]->sessions.size();
+  }
+
+  return count;
+}
+
+
 string SessionManager::generateID(const IPAddress &ip) {
 #ifdef HAVE_OPENSSL
   Digest digest("sha256");
@@ -87,34 +229,60 @@ string SessionManager::generateID(const IPAddress &ip) {
 }
 
 
-bool SessionManager::isExpired(const Session &session) const {
-  uint64_t now = Time::now();
-  uint64_t timeout = session.getU64("timeout", this->timeout);
-  uint64_t lifetime = session.getU64("lifetime", this->lifetime);
+uint64_t SessionManager::getExpiration(const Session &session) const {
+  return getExpiration(session, session.getCreationTime(),
+                       session.getLastUsed());
+}
+
 
-  return (timeout && session.getLastUsed() + timeout < now) ||
-    (lifetime && session.getCreationTime() + lifetime < now);
+bool SessionManager::isExpired(const Session &session) const {
+  uint64_t expires = getExpiration(session);
+  return expires && expires < Time::now();
 }
 
 
 bool SessionManager::hasSession(const string &sid) const {
-  sessions_t::const_iterator it = sessions.find(sid);
-  return it != sessions.end() && !isExpired(*it->second);
+  Shard &shard = getShard(sid);
+  SmartLock lock(&shard.lock);
+
+  auto it = shard.sessions.find(sid);
+  if (it == shard.sessions.end()) return false;
+
+  const Shard::Entry &e = it->second;
+  return !isExpired(*e.session, e.created, e.lastUsed, Time::now());
 }
 
 
 SmartPointer<Session> SessionManager::lookupSession(const string &sid) const {
-  iterator it = sessions.find(sid);
-  if (it == end()) THROW("Session ID '" << sid << "' does not exist");
-  if (isExpired(*it->second))
+  Shard &shard = getShard(sid);
+  SmartLock lock(&shard.lock);
+
+  auto it = shard.sessions.find(sid);
+  if (it == shard.sessions.end())
+    THROW("Session ID '" << sid << "' does not exist");
+
+  Shard::Entry &e = it->second;
+  SmartPointer<Session> session = e.session;
+  uint64_t now = Time::now();
+
+  if (isExpired(*session, e.created, e.lastUsed, now)) {
+    shard.erase(it);
+    shard.dirty.insert(sid);
+
     THROW("Session ID '" << sid << "' has expired, last_used="
-           << Time(it->second->getLastUsed()).toString() << " created="
-           << Time(it->second->getCreationTime()).toString() << " now="
+           << Time(session->getLastUsed()).toString() << " created="
+           << Time(session->getCreationTime()).toString() << " now="
            << Time().toString());
+  }
 
-  it->second->touch(); // Update timestamp
+  // Update timestamp, which has a resolution of one second
+  if (e.lastUsed != now) {
+    session->setLastUsed(e.lastUsed = now);
+    shard.schedule(it, getExpiration(*session, e.created, now));
+    shard.dirty.insert(sid);
+  }
 
-  return it->second;
+  return session;
 }
 
 
@@ -129,22 +297,49 @@ SmartPointer<Session> SessionManager::openSession(const IPAddress &ip) {
 }
 
 
-void SessionManager::closeSession(const string &sid) {sessions.erase(sid);}
+void SessionManager::closeSession(const string &sid) {
+  Shard &shard = getShard(sid);
+  SmartLock lock(&shard.lock);
 
+  auto it = shard.sessions.find(sid);
+  if (it == shard.sessions.end()) return;
 
-void SessionManager::addSession(const SmartPointer<Session> &session) {
-  pair<sessions_t::iterator, bool> result =
-    sessions.insert(sessions_t::value_type(session->getID(), session));
+  shard.erase(it);
+  shard.dirty.insert(sid);
+}
 
-  if (!result.second) result.first->second = session;
+
+void SessionManager::addSession(const SmartPointer<Session> &session) {
+  add(session, true);
 }
 
 
 void SessionManager::cleanup() {
-  // Remove expired Sessions
-  for (sessions_t::iterator it = sessions.begin(); it != sessions.end();)
-    if (isExpired(*it->second)) sessions.erase(it++);
-    else it++;
+  uint64_t now = Time::now();
+
+  // Remove expired Sessions from the slots which have come due
+  for (unsigned i = 0; i < shards.size(); i++) {
+    Shard &shard = *shards[i];
+    SmartLock lock(&shard.lock);
+
+    if (shard.next + wheelSize < now) shard.next = now - wheelSize;
+
+    for (; shard.next < now; shard.next++) {
+      Shard::slot_t &slot = shard.wheel[shard.next % wheelSize];
+
+      for (auto it = slot.begin(); it != slot.end();) {
+        const string &sid = **it++;
+        auto it2 = shard.sessions.find(sid);
+        const Shard::Entry &e = it2->second;
+
+        // Later revolutions of the wheel stay in the slot
+        if (isExpired(*e.session, e.created, e.lastUsed, now)) {
+          shard.dirty.insert(sid);
+          shard.erase(it2);
+        }
+      }
+    }
+  }
 }
 
 
@@ -160,10 +355,64 @@ void SessionManager::read(const JSON::Value &value) {
 void SessionManager::write(JSON::Sink &sink) const {
   sink.beginDict();
 
-  for (iterator it = begin(); it != end(); it++) {
-    sink.beginInsert(it->first);
-    it->second->write(sink);
+  for (unsigned i = 0; i < shards.size(); i++) {
+    SmartLock lock(&shards[i]->lock);
+
+    for (auto it = shards[i]->sessions.begin();
+         it != shards[i]->sessions.end(); it++) {
+      sink.beginInsert(it->first);
+      it->second.session->write(sink);
+    }
   }
 
   sink.endDict();
 }
+
+
+SessionManager::Shard &SessionManager::getShard(const string &sid) const {
+  return *shards[hash<string>()(sid) % shards.size()];
+}
+
+
+void SessionManager::requeue(const string &sid) {
+  Shard &shard = getShard(sid);
+  SmartLock lock(&shard.lock);
+  shard.dirty.insert(sid);
+}
+
+
+void SessionManager::add(const SmartPointer<Session> &session, bool dirty) {
+  const string &sid = session->getID();
+  Shard &shard = getShard(sid);
+  SmartLock lock(&shard.lock);
+
+  auto it = shard.insert(session);
+  Shard::Entry &e = it->second;
+  shard.schedule(it, getExpiration(*session, e.created, e.lastUsed));
+  if (dirty) shard.dirty.insert(sid);
+}
+
+
+uint64_t SessionManager::getExpiration(const Session &session,
+                                       uint64_t created,
+                                       uint64_t lastUsed) const {
+  uint64_t timeout = session.getU64("timeout", this->timeout);
+  uint64_t lifetime = session.getU64("lifetime", this->lifetime);
+  uint64_t expires = 0;
+
+  if (timeout) expires = lastUsed + timeout;
+
+  if (lifetime) {
+    uint64_t end = created + lifetime;
+    if (!expires || end < expires) expires = end;
+  }
+
+  return expires;
+}
+
+
+bool SessionManager::isExpired(const Session &session, uint64_t created,
+                               uint64_t lastUsed, uint64_t now) const {
+  uint64_t expires = getExpiration(session, created, lastUsed);
+  return expires && expires < now;
+}
@@ -33,20 +33,33 @@
 #pragma once
 
 #include "Session.h"
+#include "SessionBackend.h"
 
 #include <cbang/SmartPointer.h>
 
 #include <string>
-#include <map>
+#include <vector>
 
 
 namespace cb {
   class Options;
 
 
+  /**
+   * Sessions are kept in memory in a fixed number of independently locked
+   * hash shards.  Each shard files its sessions in a wheel of one second
+   * slots by expiration time so cleanup() only visits the slots which have
+   * come due rather than every session.
+   *
+   * When a SessionBackend is set, changed and closed sessions are queued
+   * and written by flush().  Lookups never touch the backend, so flush()
+   * and cleanup() should be called periodically off the request path.
+   */
   class SessionManager : public JSON::Serializable {
-    typedef std::map<std::string, SmartPointer<Session> > sessions_t;
-    sessions_t sessions;
+  protected:
+    struct Shard;
+    std::vector<SmartPointer<Shard> > shards;
+    SmartPointer<SessionBackend> backend;
 
     uint64_t lifetime;
     uint64_t timeout;
@@ -55,6 +68,7 @@ namespace cb {
   public:
     SessionManager();
     SessionManager(Options &options);
+    virtual ~SessionManager();
 
     void addOptions(Options &options);
 
@@ -67,8 +81,22 @@ namespace cb {
     const std::string &getSessionCookie() const {return cookie;}
     void setSessionCookie(const std::string &cookie) {this->cookie = cookie;}
 
+    const SmartPointer<SessionBackend> &getBackend() const {return backend;}
+    void setBackend(const SmartPointer<SessionBackend> &backend)
+      {this->backend = backend;}
+
+    /// Add all sessions stored in the backend
+    void load();
+    /// Write queued changes to the backend
+    void flush();
+
+    unsigned getSessionCount() const;
+
     std::string generateID(const IPAddress &ip);
 
+    /// @return The time at which @param session expires or zero for never.
+    uint64_t getExpiration(const Session &session) const;
+
     virtual bool isExpired(const Session &session) const;
     virtual bool hasSession(const std::string &sid) const;
     virtual SmartPointer<Session> lookupSession(const std::string &sid) const;
@@ -77,12 +105,17 @@ namespace cb {
     virtual void addSession(const SmartPointer<Session> &session);
     virtual void cleanup();
 
-    typedef sessions_t::const_iterator iterator;
-    iterator begin() const {return sessions.begin();}
-    iterator end() const {return sessions.end();}
-
     // From JSON::Serializable
     void read(const JSON::Value &value);
     void write(JSON::Sink &sink) const;
+
+  protected:
+    Shard &getShard(const std::string &sid) const;
+    void requeue(const std::string &sid);
+    void add(const SmartPointer<Session> &session, bool dirty);
+    uint64_t getExpiration(const Session &session, uint64_t created,
+                           uint64_t lastUsed) const;
+    bool isExpired(const Session &session, uint64_t created,
+                   uint64_t lastUsed, uint64_t now) const;
   };
 }
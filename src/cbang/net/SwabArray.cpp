@@ -0,0 +1,153 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "SwabArray.h"
+
+#include <cbang/os/CPUDispatch.h>
+
+#ifdef CBANG_SIMD_X86
+#include <immintrin.h>
+#endif
+
+#include <string.h>
+
+using namespace cb;
+
+
+namespace {
+  typedef void (*swap_t)(void *, const void *, size_t);
+
+
+  // Loads and stores through memcpy() allow unaligned spans.  These loops
+  // are simple enough for the compiler to vectorize at the baseline level.
+  template <typename T, T (*SWAP)(T)>
+  void swapNone(void *dst, const void *src, size_t count) {
+    char *out = (char *)dst;
+    const char *in = (const char *)src;
+
+    for (size_t i = 0; i < count; i++) {
+      T x;
+      memcpy(&x, in + i * sizeof(T), sizeof(T));
+      x = SWAP(x);
+      memcpy(out + i * sizeof(T), &x, sizeof(T));
+    }
+  }
+
+
+  uint16_t bswap16(uint16_t x) {return __builtin_bswap16(x);}
+  uint32_t bswap32(uint32_t x) {return __builtin_bswap32(x);}
+  uint64_t bswap64(uint64_t x) {return __builtin_bswap64(x);}
+
+
+#ifdef CBANG_SIMD_X86
+  // pshufb masks reversing each 2, 4 or 8-byte group of a 128-bit lane
+  template <unsigned WIDTH> __m256i reverseMask();
+
+  template <> CBANG_TARGET_AVX2 __m256i reverseMask<2>() {
+    return _mm256_broadcastsi128_si256(_mm_setr_epi8(
+      1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14));
+  }
+
+
+  template <> CBANG_TARGET_AVX2 __m256i reverseMask<4>() {
+    return _mm256_broadcastsi128_si256(_mm_setr_epi8(
+      3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+  }
+
+
+  template <> CBANG_TARGET_AVX2 __m256i reverseMask<8>() {
+    return _mm256_broadcastsi128_si256(_mm_setr_epi8(
+      7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8));
+  }
+
+
+  template <typename T, T (*SWAP)(T)>
+  CBANG_TARGET_AVX2 void swapAVX2(void *dst, const void *src, size_t count) {
+    char *out = (char *)dst;
+    const char *in = (const char *)src;
+    size_t bytes = count * sizeof(T);
+    const __m256i mask = reverseMask<sizeof(T)>();
+
+    size_t i = 0;
+    for (; i + 64 <= bytes; i += 64) {
+      __m256i a = _mm256_loadu_si256((const __m256i *)(in + i));
+      __m256i b = _mm256_loadu_si256((const __m256i *)(in + i + 32));
+      _mm256_storeu_si256((__m256i *)(out + i), _mm256_shuffle_epi8(a, mask));
+      _mm256_storeu_si256((__m256i *)(out + i + 32),
+                          _mm256_shuffle_epi8(b, mask));
+    }
+
+    for (; i + 32 <= bytes; i += 32) {
+      __m256i a = _mm256_loadu_si256((const __m256i *)(in + i));
+      _mm256_storeu_si256((__m256i *)(out + i), _mm256_shuffle_epi8(a, mask));
+    }
+
+    swapNone<T, SWAP>(out + i, in + i, (bytes - i) / sizeof(T));
+  }
+
+
+  const CPUDispatch::Function<swap_t> swap16Fn
+  (swapNone<uint16_t, bswap16>, 0, swapAVX2<uint16_t, bswap16>);
+  const CPUDispatch::Function<swap_t> swap32Fn
+  (swapNone<uint32_t, bswap32>, 0, swapAVX2<uint32_t, bswap32>);
+  const CPUDispatch::Function<swap_t> swap64Fn
+  (swapNone<uint64_t, bswap64>, 0, swapAVX2<uint64_t, bswap64>);
+
+#else // CBANG_SIMD_X86
+  const CPUDispatch::Function<swap_t> swap16Fn(swapNone<uint16_t, bswap16>);
+  const CPUDispatch::Function<swap_t> swap32Fn(swapNone<uint32_t, bswap32>);
+  const CPUDispatch::Function<swap_t> swap64Fn(swapNone<uint64_t, bswap64>);
+#endif // CBANG_SIMD_X86
+}
+
+
+namespace cb {
+  void swap16Array(void *dst, const void *src, size_t count) {
+    swap16Fn(dst, src, count);
+  }
+
+
+  void swap32Array(void *dst, const void *src, size_t count) {
+    swap32Fn(dst, src, count);
+  }
+
+
+  void swap64Array(void *dst, const void *src, size_t count) {
+    swap64Fn(dst, src, count);
+  }
+
+
+  void copyArray(void *dst, const void *src, size_t bytes) {
+    if (dst != src) memmove(dst, src, bytes);
+  }
+}
@@ -0,0 +1,86 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "Swab.h"
+
+#include <cstddef>
+
+
+namespace cb {
+  /**
+   * Byte swap @param count 16, 32 or 64-bit values from @param src to
+   * @param dst.  The spans may be the same but must not otherwise overlap.
+   * Alignment is not required.
+   */
+  void swap16Array(void *dst, const void *src, size_t count);
+  void swap32Array(void *dst, const void *src, size_t count);
+  void swap64Array(void *dst, const void *src, size_t count);
+
+  /// Copy without swapping, for hosts already in network byte order
+  void copyArray(void *dst, const void *src, size_t bytes);
+
+
+#if BYTE_ORDER == LITTLE_ENDIAN
+  inline void hton16Array(void *dst, const void *src, size_t count)
+  {swap16Array(dst, src, count);}
+  inline void hton32Array(void *dst, const void *src, size_t count)
+  {swap32Array(dst, src, count);}
+  inline void hton64Array(void *dst, const void *src, size_t count)
+  {swap64Array(dst, src, count);}
+
+#else // BIG_ENDIAN
+  inline void hton16Array(void *dst, const void *src, size_t count)
+  {copyArray(dst, src, count * 2);}
+  inline void hton32Array(void *dst, const void *src, size_t count)
+  {copyArray(dst, src, count * 4);}
+  inline void hton64Array(void *dst, const void *src, size_t count)
+  {copyArray(dst, src, count * 8);}
+#endif
+
+
+  /// Convert @param count values of type T, 1, 2, 4 or 8 bytes wide
+  template <typename T>
+  void htonArray(T *dst, const T *src, size_t count) {
+    static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 ||
+                  sizeof(T) == 8, "Unsupported size");
+
+    switch (sizeof(T)) {
+    case 1: copyArray(dst, src, count); break;
+    case 2: hton16Array(dst, src, count); break;
+    case 4: hton32Array(dst, src, count); break;
+    case 8: hton64Array(dst, src, count); break;
+    }
+  }
+}
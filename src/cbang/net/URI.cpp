@@ -46,19 +46,16 @@ using namespace std;
 
 
 #define DIGIT_CHARS        "1234567890"
-#define HEX_CHARS          DIGIT_CHARS "abcdefABCDEF"
 #define LOWER_CHARS        "abcdefghijklmnopqrstuvwxyz"
 #define UPPER_CHARS        "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
 #define ALPHA_CHARS        LOWER_CHARS UPPER_CHARS
 #define ALPHANUMERIC_CHARS ALPHA_CHARS DIGIT_CHARS
-#define RESERVED_CHARS     ";/?:@&=+$,"
 #define UNRESERVED_CHARS   ALPHANUMERIC_CHARS "-_.!~*'()"
 #define USER_PASS_CHARS    UNRESERVED_CHARS ";&=+$,"
 #define NAME_CHARS         UNRESERVED_CHARS ";/?:@+$,"
 #define VALUE_CHARS        NAME_CHARS "="
 #define PATH_SEGMENT_CHARS UNRESERVED_CHARS ":@&=+$,"
 #define HOST_CHARS         ALPHANUMERIC_CHARS "-."
-#define SCHEME_CHARS       ALPHANUMERIC_CHARS "+-."
 
 
 namespace {
@@ -72,20 +69,6 @@ namespace {
   }
 
 
-  char match(const char *&s, char c) {
-    if (*s != c) THROW("Expected '" << c << "'");
-    s++;
-    return c;
-  }
-
-
-  bool consume(const char *&s, char c) {
-    if (*s == c) s++;
-    else return false;
-    return true;
-  }
-
-
   bool contains(const char *s, char c) {
     return c && strchr(s, c);
   }
@@ -108,8 +91,13 @@ URI::URI(const char *uri) : port(0) {
 }
 
 
+URI::URI(const URIView &view) : port(0) {
+  read(view);
+}
+
+
 unsigned URI::getPort() const {
-  if (port || scheme.empty()) return port;
+  if (port || scheme.empty() || isUnixSocket()) return port;
 
   if (scheme == "ftp") return 21;
   if (scheme == "ssh") return 22;
@@ -135,6 +123,15 @@ unsigned URI::getPort() const {
 }
 
 
+bool URI::isUnixSocket() const {return String::endsWith(scheme, "+unix");}
+
+
+IPAddress URI::getIPAddress() const {
+  if (isUnixSocket()) return IPAddress("unix:" + host);
+  return IPAddress(getHost(), getPort());
+}
+
+
 string URI::getEscapedPath() const {
   string path;
   for (unsigned i = 0; i < pathSegs.size(); i++)
@@ -163,15 +160,11 @@ void URI::setQuery(const string &query) {
 
 
 void URI::setQuery(const char *query) {
-  StringMap::clear(); // Reset query string vars
-  const char *s = query;
+  URIView view;
+  view.readQuery(query);
 
-  try {
-    parseQuery(s);
-  } catch (const Exception &e) {
-    THROW("Failed to parse URI query '" << String::escapeC(query)
-           << "' at char " << (s - query) << ": " << e.getMessage());
-  }
+  StringMap::clear(); // Reset query string vars
+  readQuery(view);
 }
 
 
@@ -205,30 +198,26 @@ void URI::read(const string &uri) {
 }
 
 
-void URI::read(const char *uri) {
-  // See RFC2396
-  // Does not support:
-  //   opaque URI data (Section 3)
-  //   registry-based naming (Section 3.2.1)
-  //   path parameters (Section 3.3)
+void URI::read(const char *uri) {read(URIView(uri));}
+
 
+void URI::read(const URIView &view) {
   clear(); // Reset all
 
-  const char *s = uri;
-  try {
-    if (!*s) THROW("Cannot be empty");
+  scheme = view.getScheme().toString();
+  user = view.getUser().decode();
+  pass = view.getPass().decode();
+  host = view.getHost().decode();
+  port = view.getPort();
 
-    if (*s == '/') parseAbsPath(s);
-    else {
-      parseScheme(s);
-      parseNetPath(s);
-    }
-    if (consume(s, '?')) parseQuery(s);
+  URIView::PathIterator it;
+  for (it = view.beginPath(); it != view.endPath(); ++it)
+    pathSegs.push_back(it->decode());
 
-  } catch (const Exception &e) {
-    THROW("Failed to parse URI '" << String::escapeC(uri) << "' at char "
-           << (s - uri) << ": " << e.getMessage());
-  }
+  // TODO This fails for encoded / i.e. %2f
+  path = view.getPath().decode();
+
+  readQuery(view);
 }
 
 
@@ -285,6 +274,7 @@ string URI::encode(const string &s, const char *unescaped) {
 
 string URI::decode(const string &s) {
   string result;
+  result.reserve(s.length());
 
   for (unsigned i = 0; i < s.length(); i++)
     if (s[i] == '%' && i < s.length() - 2 &&
@@ -298,148 +288,8 @@ string URI::decode(const string &s) {
 }
 
 
-char URI::parseEscape(const char *&s) {
-  match(s, '%');
-
-  char a, b;
-  if (!isxdigit(a = *s++) || !isxdigit(b = *s++))
-    THROW("Expected hexadecimal digit in escape sequence");
-
-  return nibblesToChar(a, b);
-}
-
-
-void URI::parseAbsPath(const char *&s) {
-  match(s, '/');
-
-  do {
-    parsePathSegment(s);
-  } while (consume(s, '/'));
-
-  // TODO This fails for encoded / i.e. %2f
-  path = "/" + String::join(pathSegs, "/");
-}
-
-
-void URI::parsePathSegment(const char *&s) {
-  string seg;
-
-  while (true)
-    if (contains(PATH_SEGMENT_CHARS, *s)) seg.append(1, *s++);
-    else if (*s == '%') seg.append(1, parseEscape(s));
-    else break;
-
-  pathSegs.push_back(seg);
-}
-
-
-void URI::parseScheme(const char *&s) {
-  if (!isalpha(*s)) THROW("Expected alpha at start of scheme");
-
-  while (true)
-    if (contains(SCHEME_CHARS, *s)) scheme.append(1, *s++);
-    else break;
-
-  match(s, ':');
-}
-
-
-void URI::parseNetPath(const char *&s) {
-  match(s, '/');
-  consume(s, '/');
-  parseAuthority(s);
-  if (*s == '/') parseAbsPath(s);
-}
-
-
-void URI::parseAuthority(const char *&s) {
-  // Try parsing user info
-  const char *save = s;
-  parseUserInfo(s);
-  if (!consume(s, '@')) {
-    // Backtrack, wasn't user info
-    s = save;
-    user.clear();
-    pass.clear();
-  }
-
-  parseHost(s);
-  if (consume(s, ':')) parsePort(s);
-}
-
-
-string URI::parseUserPass(const char *&s) {
-  string result;
-
-  while (true)
-    if (contains(USER_PASS_CHARS, *s)) result.append(1, *s++);
-    else if (*s == '%') result.append(1, parseEscape(s));
-    else break;
-
-  return result;
-}
-
-
-void URI::parseUserInfo(const char *&s) {
-  user = parseUserPass(s);
-  if (consume(s, ':')) pass = parseUserPass(s);
-}
-
-
-void URI::parseHost(const char *&s) {
-  while (true)
-    if (contains(HOST_CHARS, *s)) host.append(1, *s++);
-    else break;
-
-  if (host.empty()) THROW("Expected host character");
-}
-
-
-void URI::parsePort(const char *&s) {
-  string result;
-
-  while (isdigit(*s)) result.append(1, *s++);
-
-  if (result.empty()) return;
-  port = String::parseU32(result);
-}
-
-
-void URI::parseQuery(const char *&s) {
-  if (!*s) return; // Empty query
-  parsePair(s);
-  while (consume(s, '&')) parsePair(s);
-}
-
-
-void URI::parsePair(const char *&s) {
-  string name = parseName(s);
-  string value = consume(s, '=') ? parseValue(s) : "";
-  set(name, value);
-}
-
-
-string URI::parseName(const char *&s) {
-  string result;
-
-  while (true)
-    if (contains(NAME_CHARS, *s)) result.append(1, *s++);
-    else if (*s == '%') result.append(1, parseEscape(s));
-    else break;
-
-  if (result.empty()) THROW("Expected query name character");
-
-  return result;
-}
-
-
-string URI::parseValue(const char *&s) {
-  string result;
-
-  while (true)
-    if (contains(VALUE_CHARS, *s)) result.append(1, *s++);
-    else if (*s == '%') result.append(1, parseEscape(s));
-    else break;
-
-  return result;
+void URI::readQuery(const URIView &view) {
+  URIView::QueryIterator it;
+  for (it = view.beginQuery(); it != view.endQuery(); ++it)
+    set(it.getName().decode(), it.getValue().decode());
 }
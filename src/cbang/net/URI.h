@@ -33,6 +33,7 @@
 #pragma once
 
 #include "IPAddress.h"
+#include "URIView.h"
 
 #include <cbang/util/StringMap.h>
 
@@ -57,11 +58,18 @@ namespace cb {
     URI();
     URI(const std::string &uri);
     URI(const char *uri);
+    URI(const URIView &view);
 
     const std::string &getScheme() const {return scheme;}
     const std::string &getHost() const {return host;}
     unsigned getPort() const;
-    IPAddress getIPAddress() const {return IPAddress(getHost(), getPort());}
+
+    /**
+     * True for schemes such as "http+unix" where the host is a Unix socket
+     * path, e.g. http+unix://%2Frun%2Fapp.sock/status.
+     */
+    bool isUnixSocket() const;
+    IPAddress getIPAddress() const;
     const std::string &getPath() const {return path;}
     std::string getEscapedPath() const;
     const std::vector<std::string> &getPathSegments() const {return pathSegs;}
@@ -84,6 +92,8 @@ namespace cb {
 
     void read(const std::string &s);
     void read(const char *s);
+    /// Copy and decode the parts of a view
+    void read(const URIView &view);
     std::ostream &write(std::ostream &stream) const;
     std::ostream &writeQuery(std::ostream &stream) const;
 
@@ -95,20 +105,7 @@ namespace cb {
     static std::string decode(const std::string &s);
 
   protected:
-    char parseEscape(const char *&s);
-    void parseAbsPath(const char *&s);
-    void parsePathSegment(const char *&s);
-    void parseScheme(const char *&s);
-    void parseNetPath(const char *&s);
-    void parseAuthority(const char *&s);
-    std::string parseUserPass(const char *&s);
-    void parseUserInfo(const char *&s);
-    void parseHost(const char *&s);
-    void parsePort(const char *&s);
-    void parseQuery(const char *&s);
-    void parsePair(const char *&s);
-    std::string parseName(const char *&s);
-    std::string parseValue(const char *&s);
+    void readQuery(const URIView &view);
   };
 
 
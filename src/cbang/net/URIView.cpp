@@ -0,0 +1,402 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "URIView.h"
+
+#include <cbang/String.h>
+#include <cbang/Exception.h>
+
+#include <string.h>
+#include <ctype.h>
+
+using namespace cb;
+using namespace std;
+
+
+#define DIGIT_CHARS        "1234567890"
+#define LOWER_CHARS        "abcdefghijklmnopqrstuvwxyz"
+#define UPPER_CHARS        "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+#define ALPHA_CHARS        LOWER_CHARS UPPER_CHARS
+#define ALPHANUMERIC_CHARS ALPHA_CHARS DIGIT_CHARS
+#define UNRESERVED_CHARS   ALPHANUMERIC_CHARS "-_.!~*'()"
+#define USER_PASS_CHARS    UNRESERVED_CHARS ";&=+$,"
+#define NAME_CHARS         UNRESERVED_CHARS ";/?:@+$,"
+#define VALUE_CHARS        NAME_CHARS "="
+#define PATH_SEGMENT_CHARS UNRESERVED_CHARS ":@&=+$,"
+#define HOST_CHARS         ALPHANUMERIC_CHARS "-."
+#define SCHEME_CHARS       ALPHANUMERIC_CHARS "+-."
+
+
+namespace {
+  enum {
+    USER_PASS    = 1 << 0,
+    NAME         = 1 << 1,
+    VALUE        = 1 << 2,
+    PATH_SEGMENT = 1 << 3,
+    HOST         = 1 << 4,
+    SCHEME       = 1 << 5,
+    HEX          = 1 << 6,
+  };
+
+
+  // Replaces strchr() over the character set strings
+  struct CharClasses {
+    uint8_t table[256];
+
+    CharClasses() {
+      memset(table, 0, sizeof(table));
+      add(USER_PASS_CHARS, USER_PASS);
+      add(NAME_CHARS, NAME);
+      add(VALUE_CHARS, VALUE);
+      add(PATH_SEGMENT_CHARS, PATH_SEGMENT);
+      add(HOST_CHARS, HOST);
+      add(SCHEME_CHARS, SCHEME);
+      add(DIGIT_CHARS "abcdefABCDEF", HEX);
+    }
+
+    void add(const char *s, uint8_t bit) {
+      while (*s) table[(uint8_t)*s++] |= bit;
+    }
+  };
+
+
+  const uint8_t *getClasses() {
+    static CharClasses classes;
+    return classes.table;
+  }
+
+
+  int hexToInt(char x) {
+    return x <= '9' ? x - '0' : ((x | 0x20) - 'a' + 10);
+  }
+
+
+  void match(const char *&s, char c) {
+    if (*s != c) THROW("Expected '" << c << "'");
+    s++;
+  }
+
+
+  bool consume(const char *&s, char c) {
+    if (*s == c) s++;
+    else return false;
+    return true;
+  }
+
+
+  class Parser {
+    const uint8_t *classes;
+
+  public:
+    Parser() : classes(getClasses()) {}
+
+
+    bool is(char c, uint8_t bit) const {return classes[(uint8_t)c] & bit;}
+
+
+    void escape(const char *&s) const {
+      match(s, '%');
+
+      if (!is(*s++, HEX) || !is(*s++, HEX))
+        THROW("Expected hexadecimal digit in escape sequence");
+    }
+
+
+    URIView::Part chars(const char *&s, uint8_t bit) const {
+      const char *start = s;
+
+      while (true)
+        if (is(*s, bit)) s++;
+        else if (*s == '%') escape(s);
+        else break;
+
+      return URIView::Part(start, s - start);
+    }
+
+
+    URIView::Part absPath(const char *&s) const {
+      const char *start = s;
+
+      match(s, '/');
+      do {
+        chars(s, PATH_SEGMENT);
+      } while (consume(s, '/'));
+
+      return URIView::Part(start, s - start);
+    }
+
+
+    URIView::Part scheme(const char *&s) const {
+      const char *start = s;
+
+      if (!isalpha(*s)) THROW("Expected alpha at start of scheme");
+      while (is(*s, SCHEME)) s++;
+
+      URIView::Part part(start, s - start);
+      match(s, ':');
+
+      return part;
+    }
+
+
+    URIView::Part host(const char *&s) const {
+      // Escapes are allowed in registered names, e.g. Unix socket paths
+      URIView::Part part = chars(s, HOST);
+      if (part.empty()) THROW("Expected host character");
+      return part;
+    }
+
+
+    unsigned port(const char *&s) const {
+      const char *start = s;
+      uint64_t port = 0;
+
+      while (isdigit(*s) && port <= 0xffffffff) port = port * 10 + *s++ - '0';
+      while (isdigit(*s)) s++;
+
+      // Let parseU32() report out of range ports
+      if (0xffffffff < port) String::parseU32(string(start, s - start));
+
+      return port;
+    }
+
+
+    void query(const char *&s) const {
+      if (!*s) return; // Empty query
+
+      do {
+        if (chars(s, NAME).empty()) THROW("Expected query name character");
+        if (consume(s, '=')) chars(s, VALUE);
+      } while (consume(s, '&'));
+    }
+  };
+}
+
+
+bool URIView::Part::isEscaped() const {return memchr(data, '%', length);}
+
+
+string URIView::Part::decode() const {
+  if (!isEscaped()) return toString();
+
+  string result(length, 0);
+  result.resize(decode(&result[0]));
+  return result;
+}
+
+
+unsigned URIView::Part::decode(char *dst) const {
+  const char *end = data + length;
+  char *out = dst;
+
+  // Escapes were validated by read()
+  for (const char *s = data; s < end; s++)
+    if (*s == '%' && s + 2 < end) {
+      *out++ = (char)(hexToInt(s[1]) << 4 | hexToInt(s[2]));
+      s += 2;
+
+    } else *out++ = *s;
+
+  return out - dst;
+}
+
+
+bool URIView::Part::equals(const char *s) const {
+  const char *end = data + length;
+
+  for (const char *p = data; p < end; p++, s++)
+    if (*p == '%' && p + 2 < end) {
+      if ((char)(hexToInt(p[1]) << 4 | hexToInt(p[2])) != *s) return false;
+      p += 2;
+
+    } else if (*p != *s) return false;
+
+  return !*s;
+}
+
+
+URIView::PathIterator::PathIterator(const char *ptr, const char *end) :
+  ptr(ptr), end(end) {
+  if (ptr) load();
+}
+
+
+void URIView::PathIterator::load() {
+  const char *next = (const char *)memchr(ptr, '/', end - ptr);
+  segment = Part(ptr, (next ? next : end) - ptr);
+}
+
+
+URIView::PathIterator &URIView::PathIterator::operator++() {
+  const char *next = segment.data + segment.length;
+
+  if (next == end) ptr = 0;
+  else {
+    ptr = next + 1;
+    load();
+  }
+
+  return *this;
+}
+
+
+URIView::QueryIterator::QueryIterator(const char *ptr, const char *end) :
+  ptr(ptr), end(end), pairEnd(0) {
+  if (ptr) load();
+}
+
+
+void URIView::QueryIterator::load() {
+  pairEnd = (const char *)memchr(ptr, '&', end - ptr);
+  if (!pairEnd) pairEnd = end;
+
+  const char *equals = (const char *)memchr(ptr, '=', pairEnd - ptr);
+  if (equals) {
+    name = Part(ptr, equals - ptr);
+    value = Part(equals + 1, pairEnd - equals - 1);
+
+  } else {
+    name = Part(ptr, pairEnd - ptr);
+    value = Part();
+  }
+}
+
+
+URIView::QueryIterator &URIView::QueryIterator::operator++() {
+  if (pairEnd == end) ptr = 0;
+  else {
+    ptr = pairEnd + 1;
+    load();
+  }
+
+  return *this;
+}
+
+
+URIView::PathIterator URIView::beginPath() const {
+  if (path.empty()) return PathIterator();
+  return PathIterator(path.data + 1, path.data + path.length);
+}
+
+
+URIView::PathIterator URIView::endPath() const {return PathIterator();}
+
+
+URIView::QueryIterator URIView::beginQuery() const {
+  if (query.empty()) return QueryIterator();
+  return QueryIterator(query.data, query.data + query.length);
+}
+
+
+URIView::QueryIterator URIView::endQuery() const {return QueryIterator();}
+
+
+bool URIView::findArg(const char *name, Part &value) const {
+  for (QueryIterator it = beginQuery(); it != endQuery(); ++it)
+    if (it.getName().equals(name)) {
+      value = it.getValue();
+      return true;
+    }
+
+  return false;
+}
+
+
+void URIView::clear() {
+  scheme = user = pass = host = path = query = Part();
+  port = 0;
+}
+
+
+void URIView::read(const char *uri) {
+  // See RFC2396
+  // Does not support:
+  //   opaque URI data (Section 3)
+  //   registry-based naming (Section 3.2.1)
+  //   path parameters (Section 3.3)
+
+  clear();
+
+  Parser parser;
+  const char *s = uri;
+  try {
+    if (!*s) THROW("Cannot be empty");
+
+    if (*s == '/') path = parser.absPath(s);
+    else {
+      scheme = parser.scheme(s);
+
+      // Net path, a second '/' is optional for old clients
+      match(s, '/');
+      consume(s, '/');
+
+      // Try parsing user info
+      const char *save = s;
+      user = parser.chars(s, USER_PASS);
+      if (consume(s, ':')) pass = parser.chars(s, USER_PASS);
+      if (!consume(s, '@')) {
+        // Backtrack, wasn't user info
+        s = save;
+        user = pass = Part();
+      }
+
+      host = parser.host(s);
+      if (consume(s, ':')) port = parser.port(s);
+      if (*s == '/') path = parser.absPath(s);
+    }
+
+    if (consume(s, '?')) {
+      const char *start = s;
+      parser.query(s);
+      query = Part(start, s - start);
+    }
+
+  } catch (const Exception &e) {
+    THROW("Failed to parse URI '" << String::escapeC(uri) << "' at char "
+           << (s - uri) << ": " << e.getMessage());
+  }
+}
+
+
+void URIView::readQuery(const char *query) {
+  clear();
+
+  const char *s = query;
+  try {
+    Parser().query(s);
+    this->query = Part(query, s - query);
+
+  } catch (const Exception &e) {
+    THROW("Failed to parse URI query '" << String::escapeC(query)
+           << "' at char " << (s - query) << ": " << e.getMessage());
+  }
+}
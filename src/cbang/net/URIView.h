@@ -0,0 +1,153 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <string>
+
+
+namespace cb {
+  /**
+   * Parses a URI in place.  Each component is recorded as a range of the
+   * original string, which must outlive the view.  Nothing is copied or
+   * decoded until asked for, so handlers which only need a few parts of
+   * a URI, e.g. one query argument, avoid building a full URI.
+   *
+   * The grammar and error messages are the same as URI::read().
+   */
+  class URIView {
+  public:
+    /// A range of the original string which may contain % escapes
+    struct Part {
+      const char *data;
+      unsigned length;
+
+      Part(const char *data = 0, unsigned length = 0) :
+        data(data), length(length) {}
+
+      bool empty() const {return !length;}
+      bool isEscaped() const;
+
+      /// @return The raw text without decoding
+      std::string toString() const {return std::string(data, length);}
+
+      /// @return The text with % escapes decoded
+      std::string decode() const;
+
+      /**
+       * Decode in to @param dst which must hold at least length bytes.
+       * @return The number of bytes written.
+       */
+      unsigned decode(char *dst) const;
+
+      /// Compare the decoded text to @param s
+      bool equals(const char *s) const;
+    };
+
+
+    class PathIterator {
+      const char *ptr;
+      const char *end;
+      Part segment;
+
+      void load();
+
+    public:
+      PathIterator(const char *ptr = 0, const char *end = 0);
+
+      const Part &operator*() const {return segment;}
+      const Part *operator->() const {return &segment;}
+      PathIterator &operator++();
+
+      bool operator==(const PathIterator &o) const {return ptr == o.ptr;}
+      bool operator!=(const PathIterator &o) const {return ptr != o.ptr;}
+    };
+
+
+    class QueryIterator {
+      const char *ptr;
+      const char *end;
+      const char *pairEnd;
+      Part name;
+      Part value;
+
+      void load();
+
+    public:
+      QueryIterator(const char *ptr = 0, const char *end = 0);
+
+      const Part &getName() const {return name;}
+      const Part &getValue() const {return value;}
+      QueryIterator &operator++();
+
+      bool operator==(const QueryIterator &o) const {return ptr == o.ptr;}
+      bool operator!=(const QueryIterator &o) const {return ptr != o.ptr;}
+    };
+
+  protected:
+    Part scheme;
+    Part user;
+    Part pass;
+    Part host;
+    unsigned port;
+    Part path;
+    Part query;
+
+  public:
+    URIView() : port(0) {}
+    URIView(const char *uri) : port(0) {read(uri);}
+    URIView(const std::string &uri) : port(0) {read(uri.c_str());}
+
+    const Part &getScheme() const {return scheme;}
+    const Part &getUser() const {return user;}
+    const Part &getPass() const {return pass;}
+    const Part &getHost() const {return host;}
+    /// @return The port or zero if it was not given
+    unsigned getPort() const {return port;}
+    const Part &getPath() const {return path;}
+    const Part &getQuery() const {return query;}
+
+    PathIterator beginPath() const;
+    PathIterator endPath() const;
+
+    QueryIterator beginQuery() const;
+    QueryIterator endQuery() const;
+
+    /// Find the first query argument whose decoded name is @param name
+    bool findArg(const char *name, Part &value) const;
+
+    void clear();
+    void read(const char *uri);
+    /// Parse only a query string, as used by URI::setQuery()
+    void readQuery(const char *query);
+  };
+}
@@ -0,0 +1,186 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "AEADStream.h"
+
+#include "SSL.h"
+#include "HMACContext.h"
+
+#include <cbang/Exception.h>
+
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#include <cstring>
+
+using namespace std;
+using namespace cb;
+
+
+namespace {
+  const char magic[4] = {'C', 'B', 'A', 'E'};
+  const uint8_t version = 1;
+  const unsigned saltOffset = 12;
+
+
+  const EVP_CIPHER *getEVPCipher(AEADStream::cipher_t cipher) {
+    switch (cipher) {
+    case AEADStream::AES_256_GCM: return EVP_aes_256_gcm();
+    case AEADStream::CHACHA20_POLY1305: return EVP_chacha20_poly1305();
+    default: THROW("Invalid AEAD cipher " << cipher);
+    }
+  }
+
+
+  void makeNonce(uint8_t nonce[12], uint64_t frame, bool last) {
+    for (unsigned i = 0; i < 8; i++) nonce[i] = frame >> (56 - 8 * i);
+    nonce[8] = nonce[9] = nonce[10] = 0;
+    nonce[11] = last;
+  }
+
+
+  struct CipherCTX {
+    EVP_CIPHER_CTX *ctx;
+
+    CipherCTX() : ctx(EVP_CIPHER_CTX_new()) {
+      if (!ctx) THROW("Failed to create cipher context: "
+                      << cb::SSL::getErrorStr());
+    }
+
+    ~CipherCTX() {EVP_CIPHER_CTX_free(ctx);}
+  };
+}
+
+
+AEADStream::AEADStream(const string &key, cipher_t cipher,
+                       unsigned frameSize) :
+  cipher(cipher), frameSize(frameSize), header(HEADER_SIZE, 0) {
+  cb::SSL::init();
+
+  getEVPCipher(cipher); // Validate
+  if (!frameSize || (1U << 30) < frameSize)
+    THROW("Invalid AEAD frame size " << frameSize);
+
+  memcpy(&header[0], magic, 4);
+  header[4] = version;
+  header[5] = cipher;
+  for (unsigned i = 0; i < 4; i++) header[8 + i] = frameSize >> (24 - 8 * i);
+
+  if (RAND_bytes((uint8_t *)&header[saltOffset], HEADER_SIZE - saltOffset) !=
+      1) THROW("Failed to generate AEAD salt: " << cb::SSL::getErrorStr());
+
+  this->key = HMACContext(key).sign(header);
+}
+
+
+AEADStream::AEADStream(const string &key, const string &header) :
+  header(header) {
+  cb::SSL::init();
+
+  if (header.size() != HEADER_SIZE || memcmp(header.data(), magic, 4))
+    THROW("Invalid AEAD stream header");
+  if (header[4] != version)
+    THROW("Unsupported AEAD stream version " << (unsigned)header[4]);
+
+  cipher = (cipher_t)header[5];
+  getEVPCipher(cipher); // Validate
+
+  frameSize = 0;
+  for (unsigned i = 0; i < 4; i++)
+    frameSize = frameSize << 8 | (uint8_t)header[8 + i];
+  if (!frameSize || (1U << 30) < frameSize)
+    THROW("Invalid AEAD frame size " << frameSize);
+
+  this->key = HMACContext(key).sign(header);
+}
+
+
+uint64_t AEADStream::getEncryptedSize(uint64_t size) const {
+  uint64_t frames = size ? (size + frameSize - 1) / frameSize : 1;
+  return HEADER_SIZE + size + frames * TAG_SIZE;
+}
+
+
+void AEADStream::encrypt(uint64_t frame, bool last, const char *in,
+                         unsigned length, char *out) const {
+  if (frameSize < length || (!last && length != frameSize))
+    THROW("Invalid AEAD frame length " << length);
+
+  uint8_t nonce[12];
+  makeNonce(nonce, frame, last);
+
+  CipherCTX c;
+  int len = 0;
+
+  if (!EVP_EncryptInit_ex(c.ctx, getEVPCipher(cipher), 0,
+                          (const uint8_t *)key.data(), nonce) ||
+      !EVP_EncryptUpdate(c.ctx, 0, &len, (const uint8_t *)header.data(),
+                         header.size()) ||
+      !EVP_EncryptUpdate(c.ctx, (uint8_t *)out, &len, (const uint8_t *)in,
+                         length) ||
+      !EVP_EncryptFinal_ex(c.ctx, (uint8_t *)out + len, &len) ||
+      !EVP_CIPHER_CTX_ctrl(c.ctx, EVP_CTRL_AEAD_GET_TAG, TAG_SIZE,
+                           out + length))
+    THROW("AEAD encryption failed: " << cb::SSL::getErrorStr());
+}
+
+
+unsigned AEADStream::decrypt(uint64_t frame, bool last, const char *in,
+                             unsigned length, char *out) const {
+  if (length < TAG_SIZE || getEncryptedFrameSize() < length ||
+      (!last && length != getEncryptedFrameSize()))
+    THROW("Invalid AEAD frame length " << length);
+
+  unsigned size = length - TAG_SIZE;
+  uint8_t nonce[12];
+  makeNonce(nonce, frame, last);
+
+  CipherCTX c;
+  int len = 0;
+
+  if (!EVP_DecryptInit_ex(c.ctx, getEVPCipher(cipher), 0,
+                          (const uint8_t *)key.data(), nonce) ||
+      !EVP_DecryptUpdate(c.ctx, 0, &len, (const uint8_t *)header.data(),
+                         header.size()) ||
+      !EVP_DecryptUpdate(c.ctx, (uint8_t *)out, &len, (const uint8_t *)in,
+                         size) ||
+      !EVP_CIPHER_CTX_ctrl(c.ctx, EVP_CTRL_AEAD_SET_TAG, TAG_SIZE,
+                           (void *)(in + size)))
+    THROW("AEAD decryption failed: " << cb::SSL::getErrorStr());
+
+  if (EVP_DecryptFinal_ex(c.ctx, (uint8_t *)out + len, &len) <= 0) {
+    cb::SSL::flushErrors();
+    THROW("AEAD frame " << frame << " failed authentication");
+  }
+
+  return size;
+}
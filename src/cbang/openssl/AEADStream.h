@@ -0,0 +1,100 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/StdTypes.h>
+
+#include <string>
+
+
+namespace cb {
+  /**
+   * Chunked authenticated encryption.  A stream is a HEADER_SIZE byte
+   * header followed by frames.  Each frame holds up to getFrameSize()
+   * bytes of plaintext, encrypted with AES-256-GCM or ChaCha20-Poly1305,
+   * followed by its TAG_SIZE byte tag.  Only the last frame may be short.
+   *
+   * The header carries a random salt from which a per stream key is derived
+   * with HMAC-SHA256, so one key may encrypt any number of streams.  Frame
+   * nonces are the frame index plus a last frame flag.  Frames therefore
+   * cannot be reordered, and truncating the stream is detected.  The header
+   * is authenticated with every frame.
+   *
+   * Frames are at fixed offsets and may be encrypted or decrypted
+   * independently, in any order, from any number of threads.
+   */
+  class AEADStream {
+  public:
+    typedef enum {
+      AES_256_GCM = 1,
+      CHACHA20_POLY1305,
+    } cipher_t;
+
+    static const unsigned HEADER_SIZE = 32;
+    static const unsigned TAG_SIZE = 16;
+
+  protected:
+    cipher_t cipher;
+    unsigned frameSize;
+    std::string header;
+    std::string key;
+
+  public:
+    /// Start a new stream with a random salt
+    AEADStream(const std::string &key, cipher_t cipher = AES_256_GCM,
+               unsigned frameSize = 64 * 1024);
+    /// Continue a stream from its header
+    AEADStream(const std::string &key, const std::string &header);
+
+    cipher_t getCipher() const {return cipher;}
+    unsigned getFrameSize() const {return frameSize;}
+    const std::string &getHeader() const {return header;}
+
+    unsigned getEncryptedFrameSize() const {return frameSize + TAG_SIZE;}
+    uint64_t getFrameOffset(uint64_t frame) const
+    {return HEADER_SIZE + frame * getEncryptedFrameSize();}
+    /// @return The size of the whole stream for @param size bytes of data
+    uint64_t getEncryptedSize(uint64_t size) const;
+
+    /// Write @param length + TAG_SIZE bytes to @param out
+    void encrypt(uint64_t frame, bool last, const char *in, unsigned length,
+                 char *out) const;
+    /**
+     * Decrypt an encrypted frame of @param length bytes, tag included.
+     * @return The plaintext length written to @param out.
+     * Throws if the frame is not authentic.
+     */
+    unsigned decrypt(uint64_t frame, bool last, const char *in,
+                     unsigned length, char *out) const;
+  };
+}
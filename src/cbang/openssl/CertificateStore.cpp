@@ -37,10 +37,14 @@
 #include "CertificateStoreContext.h"
 #include "CertificateChain.h"
 #include "CRL.h"
+#include "CertificateVerifyCache.h"
+
+#include <cbang/Exception.h>
 
 #include <openssl/x509_vfy.h>
 #include <openssl/opensslv.h>
 
+using namespace std;
 using namespace cb;
 
 #if OPENSSL_VERSION_NUMBER < 0x1010000fL
@@ -50,7 +54,8 @@ using namespace cb;
 #endif /* OPENSSL_VERSION_NUMBER < 0x1010000fL */
 
 
-CertificateStore::CertificateStore(const CertificateStore &o) : store(o.store) {
+CertificateStore::CertificateStore(const CertificateStore &o) :
+  store(o.store), cache(o.cache) {
   X509_STORE_up_ref(store);
 }
 
@@ -69,6 +74,7 @@ CertificateStore::~CertificateStore() {if (store) X509_STORE_free(store);}
 CertificateStore &CertificateStore::operator=(const CertificateStore &o) {
   if (store) X509_STORE_free(store);
   store = o.store;
+  cache = o.cache;
   X509_STORE_up_ref(store);
   return *this;
 }
@@ -77,17 +83,19 @@ CertificateStore &CertificateStore::operator=(const CertificateStore &o) {
 void CertificateStore::add(const Certificate &cert) {
   if (!X509_STORE_add_cert(store, cert.getX509()))
     THROW("Failed to add certificate to store: " << SSL::getErrorStr());
+  if (cache.isSet()) cache->invalidate();
 }
 
 
 void CertificateStore::add(const CRL &crl) {
   if (!X509_STORE_add_crl(store, crl.getX509_CRL()))
     THROW("Failed to add CRL to store: " << SSL::getErrorStr());
+  if (cache.isSet()) cache->invalidate();
 }
 
 
 void CertificateStore::verify(const Certificate &cert) const {
-  CertificateStoreContext(*this, cert).verify();
+  verify(cert, CertificateChain());
 }
 
 
@@ -95,5 +103,35 @@ void CertificateStore::verify(const Certificate &cert,
                               const Certificate &inter) const {
   CertificateChain chain;
   chain.add(inter);
-  CertificateStoreContext(*this, cert, chain).verify();
+  verify(cert, chain);
+}
+
+
+void CertificateStore::verify(const Certificate &cert,
+                              const CertificateChain &chain) const {
+  if (cache.isNull())
+    return CertificateStoreContext(*this, cert, chain).verify();
+
+  string key = cache->getKey(cert.getX509(), chain.getX509_CHAIN());
+  bool ok;
+  int error;
+
+  if (cache->lookup(key, ok, error)) {
+    if (ok) return;
+    THROW("Failed to verify certificate: "
+          << CertificateStoreContext::getErrorString(error));
+  }
+
+  uint64_t generation = cache->getGeneration();
+  CertificateStoreContext ctx(*this, cert, chain);
+
+  try {
+    ctx.verify();
+  } catch (...) {
+    if (ctx.getError() != X509_V_OK)
+      cache->insert(key, generation, false, ctx.getError());
+    throw;
+  }
+
+  cache->insert(key, generation, true, X509_V_OK);
 }
@@ -32,15 +32,20 @@
 
 #pragma once
 
+#include <cbang/SmartPointer.h>
+
 typedef struct x509_store_st X509_STORE;
 
 
 namespace cb {
   class Certificate;
   class CRL;
+  class CertificateChain;
+  class CertificateVerifyCache;
 
   class CertificateStore {
     X509_STORE *store;
+    SmartPointer<CertificateVerifyCache> cache;
 
   public:
     CertificateStore(const CertificateStore &o);
@@ -51,10 +56,20 @@ namespace cb {
 
     X509_STORE *getX509_STORE() const {return store;}
 
+    /**
+     * Cache verify() results.  Copies of this store share the cache.  It is
+     * invalidated when certificates or CRLs are added through this class.
+     */
+    void setVerifyCache(const SmartPointer<CertificateVerifyCache> &cache)
+      {this->cache = cache;}
+    const SmartPointer<CertificateVerifyCache> &getVerifyCache() const
+      {return cache;}
+
     void add(const Certificate &cert);
     void add(const CRL &crl);
 
     void verify(const Certificate &cert) const;
     void verify(const Certificate &cert, const Certificate &inter) const;
+    void verify(const Certificate &cert, const CertificateChain &chain) const;
   };
 }
@@ -0,0 +1,159 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "CertificateVerifyCache.h"
+
+#include <cbang/util/SmartLock.h>
+#include <cbang/time/Time.h>
+
+#include <openssl/x509.h>
+#include <openssl/evp.h>
+
+#include <ctime>
+
+using namespace std;
+using namespace cb;
+
+
+namespace {
+  bool addFingerprint(string &key, X509 *cert, time_t expires) {
+    // Results must not outlive the certificate
+    if (X509_cmp_time(X509_get_notAfter(cert), &expires) <= 0) return false;
+
+    unsigned char md[EVP_MAX_MD_SIZE];
+    unsigned len = 0;
+    if (!X509_digest(cert, EVP_sha256(), md, &len)) return false;
+
+    key.append((const char *)md, len);
+    return true;
+  }
+}
+
+
+CertificateVerifyCache::CertificateVerifyCache(unsigned ttl,
+                                               unsigned maxEntries) :
+  ttl(ttl), maxEntries(maxEntries) {}
+
+
+void CertificateVerifyCache::setMaxEntries(unsigned maxEntries) {
+  SmartLock lock(this);
+  this->maxEntries = maxEntries;
+  evict(maxEntries);
+}
+
+
+unsigned CertificateVerifyCache::getSize() const {
+  SmartLock lock(this);
+  return entries.size();
+}
+
+
+uint64_t CertificateVerifyCache::getGeneration() const {
+  SmartLock lock(this);
+  return generation;
+}
+
+
+string CertificateVerifyCache::getKey(X509 *cert, X509_CHAIN *chain) const {
+  if (!cert || !ttl || !maxEntries) return string();
+
+  time_t expires = Time::now() + ttl;
+  string key;
+
+  if (!addFingerprint(key, cert, expires)) return string();
+
+  for (int i = 0; chain && i < sk_X509_num(chain); i++)
+    if (!addFingerprint(key, sk_X509_value(chain, i), expires))
+      return string();
+
+  return key;
+}
+
+
+bool CertificateVerifyCache::lookup(const string &key, bool &ok, int &error) {
+  if (key.empty()) return false;
+
+  SmartLock lock(this);
+
+  auto it = entries.find(key);
+  if (it == entries.end()) return false;
+
+  Entry &entry = it->second;
+  if (entry.expires <= Time::now()) {
+    order.erase(entry.order);
+    entries.erase(it);
+    return false;
+  }
+
+  ok = entry.ok;
+  error = entry.error;
+  return true;
+}
+
+
+void CertificateVerifyCache::insert(const string &key, uint64_t generation,
+                                    bool ok, int error) {
+  if (key.empty()) return;
+
+  SmartLock lock(this);
+
+  // The store changed while verifying
+  if (generation != this->generation) return;
+
+  auto it = entries.find(key);
+  if (it != entries.end()) order.erase(it->second.order);
+  else {
+    evict(maxEntries ? maxEntries - 1 : 0);
+    if (!maxEntries) return;
+  }
+
+  order.push_back(key);
+  entries[key] = Entry{ok, error, Time::now() + ttl, --order.end()};
+}
+
+
+void CertificateVerifyCache::invalidate() {
+  SmartLock lock(this);
+  generation++;
+  entries.clear();
+  order.clear();
+}
+
+
+void CertificateVerifyCache::evict(unsigned maxEntries) {
+  // Oldest first
+  while (maxEntries < entries.size()) {
+    entries.erase(order.front());
+    order.pop_front();
+  }
+}
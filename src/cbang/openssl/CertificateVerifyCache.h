@@ -0,0 +1,96 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cbang/StdTypes.h>
+#include <cbang/os/Mutex.h>
+
+#include <string>
+#include <map>
+#include <list>
+
+typedef struct x509_st X509;
+typedef struct stack_st_X509 X509_CHAIN;
+
+
+namespace cb {
+  /**
+   * Caches certificate chain verification results keyed by the SHA-256
+   * fingerprints of the leaf and the untrusted intermediates.  Entries expire
+   * after the TTL.  Chains with a certificate which expires within the TTL
+   * are not cached.  Changes to the trusted certificates or CRLs must call
+   * invalidate().  Verifications which started before the last invalidate()
+   * are not cached.
+   */
+  class CertificateVerifyCache : public Mutex {
+    struct Entry {
+      bool ok;
+      int error;
+      uint64_t expires;
+      std::list<std::string>::iterator order;
+    };
+
+    unsigned ttl;
+    unsigned maxEntries;
+    uint64_t generation = 0;
+
+    typedef std::map<std::string, Entry> entries_t;
+    entries_t entries;
+    std::list<std::string> order;
+
+  public:
+    CertificateVerifyCache(unsigned ttl = 300, unsigned maxEntries = 10000);
+
+    unsigned getTTL() const {return ttl;}
+    void setTTL(unsigned ttl) {this->ttl = ttl;}
+
+    unsigned getMaxEntries() const {return maxEntries;}
+    void setMaxEntries(unsigned maxEntries);
+
+    unsigned getSize() const;
+    uint64_t getGeneration() const;
+
+    /// Returns an empty string if the chain should not be cached
+    std::string getKey(X509 *cert, X509_CHAIN *chain = 0) const;
+
+    bool lookup(const std::string &key, bool &ok, int &error);
+    /// @param generation The value of getGeneration() before verifying
+    void insert(const std::string &key, uint64_t generation, bool ok,
+                int error);
+    void invalidate();
+
+  protected:
+    void evict(unsigned maxEntries);
+  };
+}
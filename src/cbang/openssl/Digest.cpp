@@ -35,10 +35,14 @@
 #include "SSL.h"
 #include "KeyPair.h"
 #include "KeyContext.h"
+#include "HMACContext.h"
 
 #include <cbang/Exception.h>
 #include <cbang/String.h>
 #include <cbang/net/Base64.h>
+#include <cbang/event/Buffer.h>
+
+#include <event2/buffer.h>
 
 #include <openssl/evp.h>
 
@@ -96,6 +100,15 @@ void Digest::update(const uint8_t *data, unsigned length) {
 }
 
 
+void Digest::update(const Event::Buffer &buf) {
+  vector<iovec> space;
+  buf.peek(space);
+
+  for (unsigned i = 0; i < space.size(); i++)
+    update((const uint8_t *)space[i].iov_base, space[i].iov_len);
+}
+
+
 void Digest::finalize() {
   if (digest.empty()) digest.resize(size());
 
@@ -251,6 +264,23 @@ string Digest::hash(const string &s, const string &digest, ENGINE *e) {
 }
 
 
+vector<string> Digest::hash(const vector<string> &data, const string &digest,
+                            ENGINE *e) {
+  Digest d(digest);
+  vector<string> hashes;
+  hashes.reserve(data.size());
+
+  for (unsigned i = 0; i < data.size(); i++) {
+    d.reset();
+    d.init(e);
+    d.update(data[i]);
+    hashes.push_back(d.toString());
+  }
+
+  return hashes;
+}
+
+
 string Digest::hashHex(const string &s, const string &digest, ENGINE *e) {
   Digest d(digest);
   d.init(e);
@@ -296,11 +326,13 @@ bool Digest::hasAlgorithm(const string &digest) {
 
 string Digest::signHMAC(const string &key, const string &s,
                         const string &digest, ENGINE *e) {
+  if (!e) return HMACContext(key, digest).sign(s);
   return sign(KeyPair(key, KeyPair::HMAC_KEY, e), s, digest, e);
 }
 
 
 bool Digest::verifyHMAC(const string &key, const string &s, const string &sig,
                         const string &digest, ENGINE *e) {
+  if (!e) return HMACContext(key, digest).verify(s, sig);
   return verify(KeyPair(key, KeyPair::HMAC_KEY, e), s, sig, digest, e);
 }
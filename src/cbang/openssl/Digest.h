@@ -53,6 +53,7 @@ typedef struct engine_st ENGINE;
 namespace cb {
   class KeyPair;
   class KeyContext;
+  namespace Event {class Buffer;}
 
   class Digest {
     const EVP_MD *md;
@@ -78,6 +79,8 @@ namespace cb {
     void update(std::istream &stream);
     void update(const std::string &data);
     virtual void update(const uint8_t *data, unsigned length);
+    /// Hash the Buffer's contents in place, without pulling them up
+    void update(const Event::Buffer &buf);
 
     template <typename T>
     void updateWith(const T &o) {update((const uint8_t *)&o, sizeof(T));}
@@ -114,6 +117,10 @@ namespace cb {
     // Static
     static std::string hash(const std::string &s, const std::string &digest,
                             ENGINE *e = 0);
+    /// Hash each string, reusing one digest context
+    static std::vector<std::string>
+    hash(const std::vector<std::string> &data, const std::string &digest,
+         ENGINE *e = 0);
     static std::string hashHex(const std::string &s, const std::string &digest,
                                ENGINE *e = 0);
     static std::string base64(const std::string &s, const std::string &digest,
@@ -0,0 +1,219 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "HMACContext.h"
+
+#include "SSL.h"
+
+#include <cbang/Exception.h>
+#include <cbang/event/Buffer.h>
+
+#include <event2/buffer.h>
+
+#include <openssl/evp.h>
+#include <openssl/crypto.h>
+
+#if 0x30000000L <= OPENSSL_VERSION_NUMBER
+#include <openssl/core_names.h>
+#else
+#include <openssl/hmac.h>
+#endif
+
+using namespace cb;
+using namespace std;
+
+
+HMACContext::HMACContext(const string &key, const string &digest) {
+  SSL::init();
+
+#if 0x30000000L <= OPENSSL_VERSION_NUMBER
+  EVP_MAC *mac = EVP_MAC_fetch(0, "HMAC", 0);
+  if (!mac) THROW("HMAC not available: " << SSL::getErrorStr());
+
+  ctx = EVP_MAC_CTX_new(mac);
+  EVP_MAC_free(mac); // The context holds a reference
+  if (!ctx) THROW("Failed to create HMAC context: " << SSL::getErrorStr());
+
+  OSSL_PARAM params[] = {
+    OSSL_PARAM_construct_utf8_string
+    (OSSL_MAC_PARAM_DIGEST, (char *)digest.c_str(), 0),
+    OSSL_PARAM_construct_end(),
+  };
+
+  if (!EVP_MAC_init(ctx, (const uint8_t *)key.data(), key.size(), params)) {
+    EVP_MAC_CTX_free(ctx);
+    THROW("Failed to initialize HMAC with digest '" << digest << "': "
+          << SSL::getErrorStr());
+  }
+
+  length = EVP_MAC_CTX_get_mac_size(ctx);
+
+#else
+  const EVP_MD *md = EVP_get_digestbyname(digest.c_str());
+  if (!md) THROW("Unrecognized digest '" << digest << "'");
+
+  ctx = HMAC_CTX_new();
+  if (!ctx) THROW("Failed to create HMAC context: " << SSL::getErrorStr());
+
+  if (!HMAC_Init_ex(ctx, key.data(), key.size(), md, 0)) {
+    HMAC_CTX_free(ctx);
+    THROW("Failed to initialize HMAC: " << SSL::getErrorStr());
+  }
+
+  length = EVP_MD_size(md);
+#endif
+}
+
+
+HMACContext::HMACContext(const HMACContext &o) : length(o.length) {
+#if 0x30000000L <= OPENSSL_VERSION_NUMBER
+  ctx = EVP_MAC_CTX_dup(o.ctx);
+  if (!ctx) THROW("Failed to copy HMAC context: " << SSL::getErrorStr());
+
+#else
+  ctx = HMAC_CTX_new();
+  if (!ctx || !HMAC_CTX_copy(ctx, o.ctx)) {
+    if (ctx) HMAC_CTX_free(ctx);
+    THROW("Failed to copy HMAC context: " << SSL::getErrorStr());
+  }
+#endif
+
+  if (o.dirty) reset();
+}
+
+
+HMACContext::~HMACContext() {
+#if 0x30000000L <= OPENSSL_VERSION_NUMBER
+  EVP_MAC_CTX_free(ctx);
+#else
+  HMAC_CTX_free(ctx);
+#endif
+}
+
+
+void HMACContext::update(const uint8_t *data, unsigned length) {
+  dirty = true;
+
+#if 0x30000000L <= OPENSSL_VERSION_NUMBER
+  if (!EVP_MAC_update(ctx, data, length))
+#else
+  if (!HMAC_Update(ctx, data, length))
+#endif
+    THROW("Error updating HMAC: " << SSL::getErrorStr());
+}
+
+
+void HMACContext::update(const string &data) {
+  update((const uint8_t *)data.data(), data.size());
+}
+
+
+void HMACContext::update(const Event::Buffer &buf) {
+  vector<iovec> space;
+  buf.peek(space);
+
+  for (unsigned i = 0; i < space.size(); i++)
+    update((const uint8_t *)space[i].iov_base, space[i].iov_len);
+}
+
+
+void HMACContext::finalize(uint8_t *mac) {
+#if 0x30000000L <= OPENSSL_VERSION_NUMBER
+  size_t len = 0;
+  if (!EVP_MAC_final(ctx, mac, &len, length))
+#else
+  unsigned len = 0;
+  if (!HMAC_Final(ctx, mac, &len))
+#endif
+    THROW("Error finalizing HMAC: " << SSL::getErrorStr());
+
+  reset();
+}
+
+
+string HMACContext::finalize() {
+  string mac(length, 0);
+  finalize((uint8_t *)&mac[0]);
+  return mac;
+}
+
+
+void HMACContext::reset() {
+  // Restarts from the keyed state computed by the constructor
+#if 0x30000000L <= OPENSSL_VERSION_NUMBER
+  if (!EVP_MAC_init(ctx, 0, 0, 0))
+#else
+  if (!HMAC_Init_ex(ctx, 0, 0, 0, 0))
+#endif
+    THROW("Error resetting HMAC: " << SSL::getErrorStr());
+
+  dirty = false;
+}
+
+
+string HMACContext::sign(const string &data) {
+  if (dirty) reset();
+  update(data);
+  return finalize();
+}
+
+
+string HMACContext::sign(const Event::Buffer &buf) {
+  if (dirty) reset();
+  update(buf);
+  return finalize();
+}
+
+
+vector<string> HMACContext::sign(const vector<string> &data) {
+  vector<string> macs;
+  macs.reserve(data.size());
+
+  for (unsigned i = 0; i < data.size(); i++)
+    macs.push_back(sign(data[i]));
+
+  return macs;
+}
+
+
+bool HMACContext::verify(const string &data, const string &mac) {
+  string expected = sign(data);
+  return mac.size() == expected.size() &&
+    !CRYPTO_memcmp(mac.data(), expected.data(), mac.size());
+}
+
+
+bool HMACContext::verify(const Event::Buffer &buf, const string &mac) {
+  string expected = sign(buf);
+  return mac.size() == expected.size() &&
+    !CRYPTO_memcmp(mac.data(), expected.data(), mac.size());
+}
@@ -0,0 +1,96 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/StdTypes.h>
+
+#include <string>
+#include <vector>
+
+#include <openssl/opensslv.h>
+
+#if 0x30000000L <= OPENSSL_VERSION_NUMBER
+typedef struct evp_mac_ctx_st EVP_MAC_CTX;
+#else
+typedef struct hmac_ctx_st HMAC_CTX;
+#endif
+
+
+namespace cb {
+  namespace Event {class Buffer;}
+
+  /**
+   * A pre-keyed HMAC which may be reused for any number of messages.  The
+   * key schedule is computed once.  Copies duplicate the keyed state, which
+   * is cheaper than keying again, and may be given to other threads.  A
+   * single HMACContext must not be used by more than one thread at a time.
+   */
+  class HMACContext {
+#if 0x30000000L <= OPENSSL_VERSION_NUMBER
+    EVP_MAC_CTX *ctx = 0;
+#else
+    HMAC_CTX *ctx = 0;
+#endif
+    unsigned length = 0;
+    bool dirty = false;
+
+  public:
+    HMACContext(const std::string &key, const std::string &digest = "sha256");
+    HMACContext(const HMACContext &o);
+    ~HMACContext();
+
+    HMACContext &operator=(const HMACContext &o) = delete;
+
+    /// The length of the HMAC in bytes
+    unsigned size() const {return length;}
+
+    void update(const uint8_t *data, unsigned length);
+    void update(const std::string &data);
+    /// Hash the Buffer's contents in place, without pulling them up
+    void update(const Event::Buffer &buf);
+
+    /// Write size() bytes to @param mac and reset for the next message
+    void finalize(uint8_t *mac);
+    std::string finalize();
+    /// Discard any data since the last finalize()
+    void reset();
+
+    // One-shot
+    std::string sign(const std::string &data);
+    std::string sign(const Event::Buffer &buf);
+    std::vector<std::string> sign(const std::vector<std::string> &data);
+    /// Compares in constant time
+    bool verify(const std::string &data, const std::string &mac);
+    bool verify(const Event::Buffer &buf, const std::string &mac);
+  };
+}
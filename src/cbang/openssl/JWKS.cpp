@@ -0,0 +1,137 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "JWKS.h"
+#include "Digest.h"
+
+#include <cbang/Exception.h>
+#include <cbang/String.h>
+#include <cbang/json/JSON.h>
+#include <cbang/net/Base64.h>
+#include <cbang/time/Time.h>
+#include <cbang/log/Logger.h>
+
+#include <vector>
+
+using namespace std;
+using namespace cb;
+
+
+namespace {
+  void split(const string &jwt, vector<string> &parts) {
+    String::tokenize(jwt, parts, ".", true);
+    if (parts.size() != 3) THROW("Invalid JWT");
+  }
+
+
+  SmartPointer<JSON::Value> decode(const string &part) {
+    SmartPointer<JSON::Value> value =
+      JSON::Reader::parseString(URLBase64().decode(part));
+    if (!value->isDict()) THROW("Invalid JWT");
+    return value;
+  }
+}
+
+
+void JWKS::load(const JSON::Value &jwks) {
+  keys_t keys;
+  const JSON::Value &list = *jwks.get("keys");
+
+  for (unsigned i = 0; i < list.size(); i++) {
+    const JSON::Value &jwk = *list.get(i);
+
+    if (jwk.getString("kty", "") != "RSA" ||
+        jwk.getString("use", "sig") != "sig" ||
+        jwk.getString("alg", "RS256") != "RS256") continue;
+
+    try {
+      URLBase64 base64;
+      KeyPair key;
+      key.setRSAPublic(base64.decode(jwk.getString("n")),
+                       base64.decode(jwk.getString("e")));
+      keys.insert(keys_t::value_type(jwk.getString("kid", ""), key));
+
+    } catch (const Exception &e) {
+      LOG_WARNING("Ignoring invalid JWK: " << e.getMessage());
+    }
+  }
+
+  this->keys.swap(keys);
+}
+
+
+const KeyPair &JWKS::get(const string &kid) const {
+  keys_t::const_iterator it = keys.find(kid);
+  if (it == keys.end()) THROW("Unknown JWK key ID '" << kid << "'");
+  return it->second;
+}
+
+
+SmartPointer<JSON::Value> JWKS::getHeader(const string &jwt) {
+  vector<string> parts;
+  split(jwt, parts);
+  return decode(parts[0]);
+}
+
+
+SmartPointer<JSON::Value> JWKS::verify(const string &jwt,
+                                       unsigned leeway) const {
+  vector<string> parts;
+  split(jwt, parts);
+
+  // Header
+  SmartPointer<JSON::Value> header = decode(parts[0]);
+  string alg = header->getString("alg", "");
+  if (alg != "RS256") THROW("Unsupported JWT algorithm '" << alg << "'");
+
+  // A set with a single key may omit key IDs
+  string kid = header->getString("kid", "");
+  const KeyPair &key =
+    kid.empty() && keys.size() == 1 ? keys.begin()->second : get(kid);
+
+  // Signature
+  string data = parts[0] + "." + parts[1];
+  key.verify(URLBase64().decode(parts[2]), Digest::hash(data, "sha256"));
+
+  // Claims
+  SmartPointer<JSON::Value> claims = decode(parts[1]);
+  uint64_t now = Time::now();
+
+  if (claims->hasNumber("exp") && claims->getNumber("exp") + leeway < now)
+    THROW("JWT expired");
+
+  if (claims->hasNumber("nbf") && now + leeway < claims->getNumber("nbf"))
+    THROW("JWT not yet valid");
+
+  return claims;
+}
@@ -0,0 +1,77 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "KeyPair.h"
+
+#include <cbang/SmartPointer.h>
+
+#include <string>
+#include <map>
+
+
+namespace cb {
+  namespace JSON {class Value;}
+
+  /**
+   * A JSON Web Key Set of RSA signing keys, as published at an OpenID
+   * Connect provider's "jwks_uri", used to verify RS256 signed JSON Web
+   * Tokens without contacting the provider.
+   */
+  class JWKS {
+    typedef std::map<std::string, KeyPair> keys_t;
+    keys_t keys;
+
+  public:
+    JWKS() {}
+    JWKS(const JSON::Value &jwks) {load(jwks);}
+
+    /// Keys with an unsupported type, use or algorithm are ignored
+    void load(const JSON::Value &jwks);
+
+    unsigned size() const {return keys.size();}
+    bool has(const std::string &kid) const {return keys.count(kid);}
+    const KeyPair &get(const std::string &kid) const;
+
+    static SmartPointer<JSON::Value> getHeader(const std::string &jwt);
+
+    /**
+     * Check the signature of @param jwt and its "exp" and "nbf" claims,
+     * allowing @param leeway seconds of clock skew.  Throws on failure.
+     * @return The token's claims.
+     */
+    SmartPointer<JSON::Value> verify(const std::string &jwt,
+                                     unsigned leeway = 60) const;
+  };
+}
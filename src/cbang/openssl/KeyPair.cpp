@@ -49,6 +49,7 @@
 #include <openssl/pem.h>
 #include <openssl/evp.h>
 #include <openssl/rsa.h>
+#include <openssl/bn.h>
 #include <openssl/dsa.h>
 #include <openssl/ec.h>
 #include <openssl/engine.h>
@@ -247,6 +248,32 @@ void KeyPair::generateEC(const string &curve,
 }
 
 
+void KeyPair::setRSAPublic(const string &n, const string &e) {
+  ::RSA *rsa = RSA_new();
+  BIGNUM *bnN = BN_bin2bn((const uint8_t *)n.data(), n.length(), 0);
+  BIGNUM *bnE = BN_bin2bn((const uint8_t *)e.data(), e.length(), 0);
+
+#if OPENSSL_VERSION_NUMBER < 0x1010000fL
+  bool ok = rsa && bnN && bnE;
+  if (ok) {rsa->n = bnN; rsa->e = bnE;}
+#else
+  bool ok = rsa && bnN && bnE && RSA_set0_key(rsa, bnN, bnE, 0);
+#endif
+
+  if (!ok) {
+    if (bnN) BN_free(bnN);
+    if (bnE) BN_free(bnE);
+    if (rsa) RSA_free(rsa);
+    THROW("Failed to create RSA public key: " << SSL::getErrorStr());
+  }
+
+  if (!EVP_PKEY_assign_RSA(key, rsa)) {
+    RSA_free(rsa);
+    THROW("Failed to assign RSA public key: " << SSL::getErrorStr());
+  }
+}
+
+
 string KeyPair::publicToString() const {
   ostringstream str;
   writePublic(str);
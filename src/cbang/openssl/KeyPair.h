@@ -95,6 +95,9 @@ namespace cb {
     void generateEC(const std::string &curve = "secp192k1",
                     SmartPointer<KeyGenCallback> callback = 0);
 
+    /// Set an RSA public key from its big-endian modulus and exponent
+    void setRSAPublic(const std::string &n, const std::string &e);
+
     // To PEM string
     std::string publicToString() const;
     std::string privateToString() const;
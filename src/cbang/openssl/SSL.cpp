@@ -145,6 +145,9 @@ SmartPointer<Certificate> cb::SSL::getPeerCertificate() const {
 }
 
 
+bool cb::SSL::isSessionReused() const {return SSL_session_reused(ssl);}
+
+
 void cb::SSL::setTLSExtHostname(const string &hostname) {
   if (!SSL_set_tlsext_host_name(ssl, hostname.c_str()))
     THROW("Failed to set TLS host name extension to '" << hostname << "'");
@@ -78,6 +78,8 @@ namespace cb {
     bool hasPeerCertificate() const;
     void verifyPeerCertificate() const;
     SmartPointer<Certificate> getPeerCertificate() const;
+    /// @return True if the session was resumed from a cache or ticket
+    bool isSessionReused() const;
     void setTLSExtHostname(const std::string &hostname);
 
     void connect();
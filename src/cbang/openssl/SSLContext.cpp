@@ -38,8 +38,11 @@
 #include "Certificate.h"
 #include "CertificateChain.h"
 #include "CRL.h"
+#include "CertificateVerifyCache.h"
 
+#include <cbang/String.h>
 #include <cbang/Exception.h>
+#include <cbang/os/SystemUtilities.h>
 
 // This avoids a conflict with OCSP_RESPONSE in wincrypt.h
 #ifdef OCSP_RESPONSE
@@ -52,6 +55,15 @@
 #include <openssl/x509.h>
 #include <openssl/x509_vfy.h>
 #include <openssl/opensslv.h>
+#include <openssl/rand.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+
+#if 0x30000000L <= OPENSSL_VERSION_NUMBER
+#include <openssl/core_names.h>
+#endif
+
+#include <cstring>
 
 using namespace std;
 using namespace cb;
@@ -62,6 +74,163 @@ using namespace cb;
 #endif // OPENSSL_VERSION_NUMBER < 0x1010000fL
 
 
+namespace {
+  int alpnSelectCB(::SSL *ssl, const unsigned char **out, unsigned char *outlen,
+                   const unsigned char *in, unsigned inlen, void *arg) {
+    const string &alpn = *(const string *)arg;
+
+    // Server preference
+    unsigned char *selected;
+    int ret = SSL_select_next_proto(&selected, outlen,
+                                    (const unsigned char *)alpn.data(),
+                                    alpn.length(), in, inlen);
+    if (ret != OPENSSL_NPN_NEGOTIATED) return SSL_TLSEXT_ERR_NOACK;
+
+    *out = selected;
+    return SSL_TLSEXT_ERR_OK;
+  }
+
+
+  int getExIndex() {
+    static int index = SSL_CTX_get_ex_new_index(0, 0, 0, 0, 0);
+    return index;
+  }
+
+
+  // Recorded on an SSL when SNI selects a host context
+  struct HostSelection {
+    SSLContext *server;
+    shared_ptr<SSLContext> host; // Keeps the ALPN callback data alive
+  };
+
+
+  void freeHostSelection(void *parent, void *ptr, CRYPTO_EX_DATA *ad, int idx,
+                         long argl, void *argp) {
+    delete (HostSelection *)ptr;
+  }
+
+
+  int getSSLExIndex() {
+    static int index = SSL_get_ex_new_index(0, 0, 0, 0, freeHostSelection);
+    return index;
+  }
+
+
+  int serverNameCB(::SSL *ssl, int *alert, void *arg) {
+    SSLContext *ctx = (SSLContext *)arg;
+
+    const char *name = SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name);
+    if (!name) return SSL_TLSEXT_ERR_OK; // Use the default certificate
+
+    auto host = ctx->findHostContext(name);
+    if (!host) return SSL_TLSEXT_ERR_OK;
+
+    if (!SSL_set_ex_data(ssl, getSSLExIndex(), new HostSelection{ctx, host}))
+      return SSL_TLSEXT_ERR_ALERT_FATAL;
+
+    SSL_set_SSL_CTX(ssl, host->getCTX());
+
+    return SSL_TLSEXT_ERR_OK;
+  }
+
+
+  int certVerifyCB(X509_STORE_CTX *ctx, void *arg) {
+    CertificateVerifyCache &cache = *(CertificateVerifyCache *)arg;
+
+    // Only cache client certificates, server names are checked by clients
+    ::SSL *ssl = (::SSL *)
+      X509_STORE_CTX_get_ex_data(ctx, SSL_get_ex_data_X509_STORE_CTX_idx());
+    if (!ssl || !SSL_is_server(ssl)) return X509_verify_cert(ctx);
+
+    string key = cache.getKey(X509_STORE_CTX_get0_cert(ctx),
+                              X509_STORE_CTX_get0_untrusted(ctx));
+    bool ok;
+    int error;
+
+    if (cache.lookup(key, ok, error)) {
+      X509_STORE_CTX_set_error(ctx, error);
+      return ok;
+    }
+
+    uint64_t generation = cache.getGeneration();
+    int ret = X509_verify_cert(ctx);
+
+    // Negative results are internal errors, not verification results
+    if (0 <= ret)
+      cache.insert(key, generation, ret, X509_STORE_CTX_get_error(ctx));
+
+    return ret;
+  }
+
+
+#if 0x30000000L <= OPENSSL_VERSION_NUMBER
+  typedef EVP_MAC_CTX hmac_ctx_t;
+
+  bool initHMAC(hmac_ctx_t *hctx, const SSLContext::TicketKey &key) {
+    OSSL_PARAM params[] = {
+      OSSL_PARAM_construct_octet_string
+      (OSSL_MAC_PARAM_KEY, (void *)key.hmacKey, key.keySize),
+      OSSL_PARAM_construct_utf8_string
+      (OSSL_MAC_PARAM_DIGEST, (char *)"sha256", 0),
+      OSSL_PARAM_construct_end(),
+    };
+
+    return EVP_MAC_CTX_set_params(hctx, params);
+  }
+
+#else
+  typedef HMAC_CTX hmac_ctx_t;
+
+  bool initHMAC(hmac_ctx_t *hctx, const SSLContext::TicketKey &key) {
+    return HMAC_Init_ex(hctx, key.hmacKey, key.keySize, EVP_sha256(), 0);
+  }
+#endif
+
+
+  int ticketKeyCB(::SSL *ssl, unsigned char *name, unsigned char *iv,
+                  EVP_CIPHER_CTX *cctx, hmac_ctx_t *hctx, int enc) {
+    // Tickets belong to the server context even after SNI switched hosts
+    HostSelection *sel =
+      (HostSelection *)SSL_get_ex_data(ssl, getSSLExIndex());
+    SSLContext *ctx = sel ? sel->server :
+      (SSLContext *)SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), getExIndex());
+    if (!ctx) return -1;
+
+    auto keys = ctx->getTicketKeys();
+    if (!keys || keys->empty()) return 0;
+
+    if (enc) {
+      const SSLContext::TicketKey &key = keys->front();
+      const EVP_CIPHER *cipher =
+        key.keySize == 16 ? EVP_aes_128_cbc() : EVP_aes_256_cbc();
+
+      if (RAND_bytes(iv, EVP_CIPHER_iv_length(cipher)) != 1) return -1;
+      memcpy(name, key.name, 16);
+
+      if (!EVP_EncryptInit_ex(cctx, cipher, 0, key.aesKey, iv) ||
+          !initHMAC(hctx, key)) return -1;
+
+      return 1;
+    }
+
+    for (unsigned i = 0; i < keys->size(); i++) {
+      const SSLContext::TicketKey &key = keys->at(i);
+      if (memcmp(name, key.name, 16)) continue;
+
+      const EVP_CIPHER *cipher =
+        key.keySize == 16 ? EVP_aes_128_cbc() : EVP_aes_256_cbc();
+
+      if (!initHMAC(hctx, key) ||
+          !EVP_DecryptInit_ex(cctx, cipher, 0, key.aesKey, iv)) return -1;
+
+      return i ? 2 : 1; // Renew tickets from older keys
+    }
+
+    return 0; // Unknown key, do a full handshake
+  }
+}
+
+
 SSLContext::SSLContext() : ctx(0) {
   cb::SSL::init();
 
@@ -72,6 +241,8 @@ SSLContext::SSLContext() : ctx(0) {
 
   // A session ID is required for session caching to work
   SSL_CTX_set_session_id_context(ctx, (unsigned char *)"cbang", 5);
+
+  SSL_CTX_set_ex_data(ctx, getExIndex(), this);
 }
 
 
@@ -103,6 +274,27 @@ void SSLContext::setCipherList(const string &list) {
 }
 
 
+void SSLContext::setALPNProtocols(const vector<string> &protocols) {
+  // Wire format, length prefixed protocol names
+  alpn.clear();
+  for (unsigned i = 0; i < protocols.size(); i++) {
+    if (protocols[i].empty() || 255 < protocols[i].length())
+      THROW("Invalid ALPN protocol '" << protocols[i] << "'");
+
+    alpn.push_back((char)protocols[i].length());
+    alpn += protocols[i];
+  }
+
+  // Used by servers
+  SSL_CTX_set_alpn_select_cb(ctx, alpnSelectCB, &alpn);
+
+  // Used by clients, returns zero on success
+  if (SSL_CTX_set_alpn_protos(ctx, (const unsigned char *)alpn.data(),
+                              alpn.length()))
+    THROW("Failed to set ALPN protocols: " << cb::SSL::getErrorStr());
+}
+
+
 void SSLContext::setVerifyNone() {
   SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, 0);
 }
@@ -115,6 +307,7 @@ void SSLContext::setVerifyPeer(bool verifyClientOnce, bool failIfNoPeerCert,
   if (failIfNoPeerCert) mode |= SSL_VERIFY_FAIL_IF_NO_PEER_CERT;
   SSL_CTX_set_verify(ctx, mode, 0);
   if (depth) SSL_CTX_set_verify_depth(ctx, depth);
+  invalidateVerifyCache();
 }
 
 
@@ -179,6 +372,7 @@ void SSLContext::addTrustedCA(const Certificate &cert) {
   X509_STORE *store = getStore();
   if (!X509_STORE_add_cert(store, X509_dup(cert.getX509())))
     THROW("Failed to add certificate to store " << cb::SSL::getErrorStr());
+  invalidateVerifyCache();
 }
 
 
@@ -201,6 +395,7 @@ void SSLContext::addTrustedCA(BIO *bio) {
   X509_STORE *store = getStore();
   if (!X509_STORE_add_cert(store, cert))
     THROW("Failed to add certificate to store " << cb::SSL::getErrorStr());
+  invalidateVerifyCache();
 }
 
 
@@ -208,12 +403,14 @@ void SSLContext::loadVerifyLocationsFile(const string &path) {
   if (!SSL_CTX_load_verify_locations(ctx, path.c_str(), 0))
     THROW("Failed to load verify locations file '" << path << "': "
           << cb::SSL::getErrorStr());
+  invalidateVerifyCache();
 }
 
 
 void SSLContext::loadVerifyLocationsPath(const string &path) {
   if (!SSL_CTX_load_verify_locations(ctx, 0, path.c_str()))
     THROW("Failed to load verify locations path '" << path << "'");
+  invalidateVerifyCache();
 }
 
 
@@ -257,6 +454,7 @@ void SSLContext::addCRL(BIO *bio) {
 
 void SSLContext::setVerifyDepth(unsigned depth) {
   SSL_CTX_set_verify_depth(ctx, depth);
+  invalidateVerifyCache();
 }
 
 
@@ -268,8 +466,214 @@ void SSLContext::setCheckCRL(bool x) {
   X509_VERIFY_PARAM_set_flags(param, X509_V_FLAG_CRL_CHECK);
   X509_STORE_set1_param(store, param);
   X509_VERIFY_PARAM_free(param);
+  invalidateVerifyCache();
+}
+
+
+void SSLContext::setVerifyCache
+(const SmartPointer<CertificateVerifyCache> &cache) {
+  verifyCache = cache;
+
+  if (cache.isSet()) SSL_CTX_set_cert_verify_callback(ctx, certVerifyCB,
+                                                      cache.get());
+  else SSL_CTX_set_cert_verify_callback(ctx, 0, 0);
+}
+
+
+void SSLContext::invalidateVerifyCache() {
+  if (verifyCache.isSet()) verifyCache->invalidate();
 }
 
 
 long SSLContext::getOptions() const {return SSL_CTX_get_options(ctx);}
 void SSLContext::setOptions(long options) {SSL_CTX_set_options(ctx, options);}
+
+
+void SSLContext::setSessionCacheSize(long size) {
+  SSL_CTX_sess_set_cache_size(ctx, size);
+}
+
+
+long SSLContext::getSessionCacheSize() const {
+  return SSL_CTX_sess_get_cache_size(ctx);
+}
+
+
+void SSLContext::setSessionTimeout(long seconds) {
+  SSL_CTX_set_timeout(ctx, seconds);
+}
+
+
+long SSLContext::getSessionTimeout() const {return SSL_CTX_get_timeout(ctx);}
+
+
+void SSLContext::setTicketKeys(const vector<string> &keys) {
+  if (keys.empty()) THROW("No session ticket keys");
+
+  auto ticketKeys = make_shared<ticket_keys_t>(keys.size());
+
+  for (unsigned i = 0; i < keys.size(); i++) {
+    const string &data = keys[i];
+    TicketKey &key = ticketKeys->at(i);
+
+    if (data.size() != 48 && data.size() != 80)
+      THROW("Session ticket key must be 48 or 80 bytes, got "
+            << data.size());
+
+    key.keySize = (data.size() - 16) / 2;
+    memcpy(key.name, data.data(), 16);
+    memcpy(key.hmacKey, data.data() + 16, key.keySize);
+    memcpy(key.aesKey, data.data() + 16 + key.keySize, key.keySize);
+  }
+
+  bool first = !getTicketKeys();
+  atomic_store(&this->ticketKeys,
+               shared_ptr<const ticket_keys_t>(ticketKeys));
+
+  if (first) {
+#if 0x30000000L <= OPENSSL_VERSION_NUMBER
+    SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx, ticketKeyCB);
+#else
+    SSL_CTX_set_tlsext_ticket_key_cb(ctx, ticketKeyCB);
+#endif
+  }
+}
+
+
+void SSLContext::loadTicketKeys(const vector<string> &filenames) {
+  vector<string> keys;
+
+  for (unsigned i = 0; i < filenames.size(); i++)
+    keys.push_back(SystemUtilities::read(filenames[i]));
+
+  setTicketKeys(keys);
+}
+
+
+shared_ptr<const SSLContext::ticket_keys_t>
+SSLContext::getTicketKeys() const {
+  return atomic_load(&ticketKeys);
+}
+
+
+vector<string> SSLContext::getTicketKeyData() const {
+  vector<string> data;
+
+  auto keys = getTicketKeys();
+  if (keys)
+    for (auto &key: *keys)
+      data.push_back(string((const char *)key.name, 16) +
+                     string((const char *)key.hmacKey, key.keySize) +
+                     string((const char *)key.aesKey, key.keySize));
+
+  return data;
+}
+
+
+void SSLContext::setHostContext(const vector<string> &hostnames,
+                                const shared_ptr<SSLContext> &host) {
+  if (!host) THROW("Host context cannot be null");
+
+  auto old = getHostContexts();
+  auto hosts = old ? make_shared<host_contexts_t>(*old) :
+    make_shared<host_contexts_t>();
+
+  for (unsigned i = 0; i < hostnames.size(); i++) {
+    string name = String::toLower(hostnames[i]);
+    if (name.empty()) THROW("Empty SNI hostname");
+    (*hosts)[name] = host;
+  }
+
+  atomic_store(&hostContexts, shared_ptr<const host_contexts_t>(hosts));
+
+  if (!old) {
+    SSL_CTX_set_tlsext_servername_callback(ctx, serverNameCB);
+    SSL_CTX_set_tlsext_servername_arg(ctx, this);
+  }
+}
+
+
+void SSLContext::setHostContext(const string &hostname,
+                                const shared_ptr<SSLContext> &host) {
+  setHostContext(vector<string>(1, hostname), host);
+}
+
+
+shared_ptr<SSLContext>
+SSLContext::createHostContext(const CertificateChain &chain,
+                              const KeyPair &key) const {
+  auto host = make_shared<SSLContext>();
+
+  host->setOptions(getOptions());
+  SSL_CTX_set_verify(host->ctx, SSL_CTX_get_verify_mode(ctx),
+                     SSL_CTX_get_verify_callback(ctx));
+
+  // Host contexts have their own certificate store
+  if (verifyCache.isSet())
+    host->setVerifyCache(new CertificateVerifyCache
+                         (verifyCache->getTTL(), verifyCache->getMaxEntries()));
+
+  if (!alpn.empty()) {
+    host->alpn = alpn;
+    SSL_CTX_set_alpn_select_cb(host->ctx, alpnSelectCB, &host->alpn);
+  }
+
+  host->useCertificateChain(chain);
+  host->usePrivateKey(key);
+
+  return host;
+}
+
+
+void SSLContext::setHostCertificate(const vector<string> &hostnames,
+                                    const CertificateChain &chain,
+                                    const KeyPair &key) {
+  setHostContext(hostnames, createHostContext(chain, key));
+}
+
+
+void SSLContext::removeHostContext(const string &hostname) {
+  auto old = getHostContexts();
+  if (!old) return;
+
+  auto hosts = make_shared<host_contexts_t>(*old);
+  if (!hosts->erase(String::toLower(hostname))) return;
+
+  atomic_store(&hostContexts, shared_ptr<const host_contexts_t>(hosts));
+}
+
+
+shared_ptr<const SSLContext::host_contexts_t>
+SSLContext::getHostContexts() const {
+  return atomic_load(&hostContexts);
+}
+
+
+shared_ptr<SSLContext>
+SSLContext::findHostContext(const string &hostname) const {
+  auto hosts = getHostContexts();
+  if (!hosts || hosts->empty()) return 0;
+
+  string name = String::toLower(hostname);
+  if (!name.empty() && name.back() == '.') name.pop_back();
+
+  auto it = hosts->find(name);
+  if (it != hosts->end()) return it->second;
+
+  // Wildcard, replace the first label
+  size_t dot = name.find('.');
+  if (dot == string::npos || !dot) return 0;
+
+  it = hosts->find("*" + name.substr(dot));
+  return it == hosts->end() ? 0 : it->second;
+}
+
+
+long SSLContext::getSessionCount() const {return SSL_CTX_sess_number(ctx);}
+long SSLContext::getSessionHits() const {return SSL_CTX_sess_hits(ctx);}
+long SSLContext::getSessionMisses() const {return SSL_CTX_sess_misses(ctx);}
+
+
+long SSLContext::getSessionTimeouts() const {
+  return SSL_CTX_sess_timeouts(ctx);
+}
@@ -33,9 +33,14 @@
 #pragma once
 
 #include <cbang/config.h>
+#include <cbang/StdTypes.h>
+#include <cbang/SmartPointer.h>
 #include <cbang/io/InputSource.h>
 
 #include <string>
+#include <vector>
+#include <map>
+#include <memory>
 
 #ifdef HAVE_OPENSSL
 typedef struct ssl_ctx_st SSL_CTX;
@@ -48,9 +53,27 @@ namespace cb {
   class Certificate;
   class CertificateChain;
   class CRL;
+  class CertificateVerifyCache;
 
   class SSLContext {
+  public:
+    /// A session ticket name, HMAC secret and AES key
+    struct TicketKey {
+      uint8_t name[16];
+      uint8_t hmacKey[32];
+      uint8_t aesKey[32];
+      unsigned keySize; ///< 16 or 32
+    };
+
+    typedef std::vector<TicketKey> ticket_keys_t;
+    typedef std::map<std::string, std::shared_ptr<SSLContext> > host_contexts_t;
+
+  protected:
     SSL_CTX *ctx;
+    std::string alpn;
+    std::shared_ptr<const ticket_keys_t> ticketKeys;
+    std::shared_ptr<const host_contexts_t> hostContexts;
+    SmartPointer<CertificateVerifyCache> verifyCache;
 
   public:
     SSLContext();
@@ -63,6 +86,10 @@ namespace cb {
 
     void setCipherList(const std::string &list);
 
+    /// Protocols for ALPN in order of preference, e.g. "h2", "http/1.1"
+    void setALPNProtocols(const std::vector<std::string> &protocols);
+    const std::string &getALPNProtocols() const {return alpn;}
+
     void setVerifyNone();
     void setVerifyPeer(bool verifyClientOnce = true,
                        bool failIfNoPeerCert = false, unsigned depth = 1);
@@ -93,8 +120,80 @@ namespace cb {
     void setVerifyDepth(unsigned depth);
     void setCheckCRL(bool x = true);
 
+    /**
+     * Cache the results of verifying client certificate chains so repeat
+     * handshakes skip path building and CRL checks.  The cache is
+     * invalidated when trusted CAs, CRLs or verify settings change.  On a
+     * cache hit the verify callback is not called and
+     * SSL_get0_verified_chain() is not available.  Host contexts created
+     * afterwards get their own cache with the same limits.  A null cache
+     * disables caching.
+     */
+    void setVerifyCache(const SmartPointer<CertificateVerifyCache> &cache);
+    const SmartPointer<CertificateVerifyCache> &getVerifyCache() const
+      {return verifyCache;}
+
     long getOptions() const;
     void setOptions(long options);
+
+    /// The maximum number of sessions in the server cache, zero for no limit
+    void setSessionCacheSize(long size);
+    long getSessionCacheSize() const;
+    /// The lifetime of cached sessions and session tickets in seconds
+    void setSessionTimeout(long seconds);
+    long getSessionTimeout() const;
+
+    /**
+     * Share session ticket keys between servers so clients can resume
+     * sessions on any of them.  Each key is 48 or 80 bytes, a 16 byte name
+     * followed by an HMAC secret and an AES key of 16 or 32 bytes each, the
+     * same layout nginx uses.  The first key encrypts new tickets.  Tickets
+     * encrypted with the others are still accepted and renewed.  Keys may be
+     * rotated while connections are being accepted.
+     */
+    void setTicketKeys(const std::vector<std::string> &keys);
+    /// Load one ticket key from each file
+    void loadTicketKeys(const std::vector<std::string> &filenames);
+    std::shared_ptr<const ticket_keys_t> getTicketKeys() const;
+    /// @return The ticket keys in the layout setTicketKeys() accepts
+    std::vector<std::string> getTicketKeyData() const;
+
+    /**
+     * Serve the certificate and key of @param host to clients which ask for
+     * one of @param hostnames via SNI.  A name starting with "*." matches
+     * any one label in its place.  Other clients get this context's
+     * certificate.  Session caching and tickets stay with this context.
+     *
+     * The host table is swapped atomically, so certificates may be replaced
+     * while connections are being accepted.  Handshakes already in progress
+     * keep the host context they selected.
+     */
+    void setHostContext(const std::vector<std::string> &hostnames,
+                        const std::shared_ptr<SSLContext> &host);
+    void setHostContext(const std::string &hostname,
+                        const std::shared_ptr<SSLContext> &host);
+    /// Create a host context with this context's ALPN, options and verify mode
+    std::shared_ptr<SSLContext>
+    createHostContext(const CertificateChain &chain, const KeyPair &key) const;
+    void setHostCertificate(const std::vector<std::string> &hostnames,
+                            const CertificateChain &chain, const KeyPair &key);
+    void removeHostContext(const std::string &hostname);
+    std::shared_ptr<const host_contexts_t> getHostContexts() const;
+    /// @return The context selected for @param hostname or null
+    std::shared_ptr<SSLContext>
+    findHostContext(const std::string &hostname) const;
+
+    /// The number of server sessions currently cached
+    long getSessionCount() const;
+    /// The number of sessions resumed from the cache or a ticket
+    long getSessionHits() const;
+    /// The number of resumptions requested but not found
+    long getSessionMisses() const;
+    /// The number of resumptions rejected because the session expired
+    long getSessionTimeouts() const;
+
+  protected:
+    void invalidateVerifyCache();
   };
 }
 
@@ -0,0 +1,124 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "CPUDispatch.h"
+#include "CPUID.h"
+
+#include <cbang/Exception.h>
+
+#include <atomic>
+#include <cstdlib>
+
+using namespace std;
+using namespace cb;
+
+
+namespace {
+  SIMDLevel detect() {
+#if defined(__x86_64) || defined(__i386__) || defined(_M_IX86) || \
+  defined(_M_AMD64)
+    CPUID cpuid;
+
+    if (!cpuid.cpuHasFeature(CPUFeature::FEATURE_SSE2))
+      return SIMDLevel::SIMD_NONE;
+
+    // The OS must also save the YMM and ZMM registers
+    uint64_t xcr0 = cpuid.getXCR0();
+    if ((xcr0 & 6) != 6 || !cpuid.cpuHasFeature(CPUFeature::FEATURE_AVX) ||
+        !cpuid.cpuHasExtendedFeature(CPUExtendedFeature::FEATURE_AVX2))
+      return SIMDLevel::SIMD_SSE2;
+
+    if ((xcr0 & 0xe6) != 0xe6 ||
+        !cpuid.cpuHasExtendedFeature(CPUExtendedFeature::FEATURE_AVX512F) ||
+        !cpuid.cpuHasExtendedFeature(CPUExtendedFeature::FEATURE_AVX512BW))
+      return SIMDLevel::SIMD_AVX2;
+
+    return SIMDLevel::SIMD_AVX512;
+
+#elif defined(CBANG_SIMD_NEON)
+    return SIMDLevel::SIMD_NEON;
+
+#else
+    return SIMDLevel::SIMD_NONE;
+#endif
+  }
+
+
+  SIMDLevel initialLevel() {
+    const char *name = getenv("CBANG_SIMD");
+
+    if (name)
+      try {
+        SIMDLevel level = SIMDLevel::parse(name);
+        if (CPUDispatch::isSupported(level)) return level;
+      } catch (const Exception &e) {}
+
+    return CPUDispatch::getSupportedLevel();
+  }
+
+
+  atomic<int> &level() {
+    static atomic<int> level(initialLevel());
+    return level;
+  }
+}
+
+
+SIMDLevel CPUDispatch::getSupportedLevel() {
+  static SIMDLevel supported = detect();
+  return supported;
+}
+
+
+bool CPUDispatch::isSupported(SIMDLevel level) {
+  SIMDLevel supported = getSupportedLevel();
+
+  if (level == SIMDLevel::SIMD_NONE || level == supported) return true;
+  if (level == SIMDLevel::SIMD_NEON || supported == SIMDLevel::SIMD_NEON)
+    return false;
+
+  return level < supported;
+}
+
+
+SIMDLevel CPUDispatch::getLevel() {
+  return (SIMDLevel::enum_t)level().load(memory_order_relaxed);
+}
+
+
+void CPUDispatch::setLevel(SIMDLevel level) {
+  if (!isSupported(level))
+    THROW("SIMD level " << level << " is not supported by this CPU");
+
+  ::level().store(level, memory_order_relaxed);
+}
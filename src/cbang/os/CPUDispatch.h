@@ -0,0 +1,99 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cbang/enum/SIMDLevel.h>
+
+
+/**
+ * Kernels for an instruction set beyond the compiler's baseline are
+ * compiled with the matching CBANG_TARGET_* attribute and selected at
+ * runtime through CPUDispatch::Function.  Their intrinsics headers may be
+ * included whenever CBANG_SIMD_X86 is defined.
+ */
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CBANG_SIMD_X86
+#define CBANG_TARGET_SSE2   __attribute__((target("sse2")))
+#define CBANG_TARGET_SSE42  __attribute__((target("sse4.2")))
+#define CBANG_TARGET_AVX2   __attribute__((target("avx2")))
+#define CBANG_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#endif
+
+#if defined(__ARM_NEON) || defined(__aarch64__)
+#define CBANG_SIMD_NEON
+#endif
+
+
+namespace cb {
+  class CPUDispatch {
+  public:
+    /// The best level supported by both the CPU and the OS
+    static SIMDLevel getSupportedLevel();
+    static bool isSupported(SIMDLevel level);
+
+    /**
+     * The level kernels are currently dispatched to.  It starts at the
+     * supported level unless the environment variable CBANG_SIMD names
+     * another supported level, e.g. CBANG_SIMD=none to test the fallback
+     * code.
+     */
+    static SIMDLevel getLevel();
+
+    /// Dispatch to @param level, which must be supported, from now on
+    static void setLevel(SIMDLevel level);
+
+
+    /**
+     * A function with one implementation per level.  Levels without one
+     * fall back to the next lower level of the same family and finally
+     * to the generic implementation which is always required.
+     */
+    template <typename Fn>
+    class Function {
+      Fn fns[SIMDLevel::SIMD_NEON + 1];
+
+    public:
+      // Constant initialized so static instances are usable at any time
+      constexpr Function(Fn generic, Fn sse2 = 0, Fn avx2 = 0,
+                         Fn avx512 = 0, Fn neon = 0) :
+        fns{generic, sse2 ? sse2 : generic,
+            avx2 ? avx2 : sse2 ? sse2 : generic,
+            avx512 ? avx512 : avx2 ? avx2 : sse2 ? sse2 : generic,
+            neon ? neon : generic} {}
+
+      Fn get() const {return fns[getLevel()];}
+      operator Fn() const {return get();}
+    };
+  };
+}
@@ -150,6 +150,24 @@ bool CPUID::cpuHasFeature80000001(CPUFeature80000001 feature) {
 }
 
 
+uint64_t CPUID::getXCR0() {
+  if (!cpuHasFeature(CPUFeature::FEATURE_OSXSAVE)) return 0;
+
+#ifdef _WIN32
+#if 1500 < _MSC_VER && (defined(_M_IX86) || defined(_M_AMD64))
+  return _xgetbv(0);
+#endif
+
+#elif defined(__x86_64) || defined(__i386__)
+  uint32_t eax, edx;
+  asm volatile ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+  return (uint64_t)edx << 32 | eax;
+#endif
+
+  return 0;
+}
+
+
 unsigned CPUID::getCPUFamily() {
   uint32_t signature = getCPUSignature();
   uint32_t family = getBits(signature, 11, 8);
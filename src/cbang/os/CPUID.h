@@ -69,6 +69,8 @@ namespace cb {
     bool cpuHasFeature(CPUFeature feature);
     bool cpuHasExtendedFeature(CPUExtendedFeature feature);
     bool cpuHasFeature80000001(CPUFeature80000001 feature);
+    /// The register state enabled by the OS, zero without OSXSAVE
+    uint64_t getXCR0();
     unsigned getCPUFamily();
     unsigned getCPUModel();
     unsigned getCPUStepping();
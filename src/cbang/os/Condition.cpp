@@ -42,6 +42,12 @@
 #include <cbang/log/Logger.h>
 #include <cbang/util/SmartLock.h>
 
+#ifdef __linux__
+#include "Futex.h"
+
+#include <atomic>
+#endif
+
 using namespace cb;
 
 namespace cb {
@@ -66,6 +72,16 @@ namespace cb {
 
     private_t() : waitersCount(0), wasBroadcast(false) {}
 
+#elif defined(__linux__)
+    // Incremented by each signal.  Waiters spin on it briefly then park in
+    // the kernel.
+    Futex seq;
+
+    // Parked waiters, signal() makes no system call when there are none
+    std::atomic<unsigned> sleepers;
+
+    private_t() : sleepers(0) {}
+
 #else // pthreads
     pthread_cond_t cond;
 #endif
@@ -79,6 +95,9 @@ Condition::Condition() : p(new Condition::private_t) {
   InitializeCriticalSection(&p->waitersCountLock);
   p->waitersDone = CreateEvent(0, FALSE, FALSE, 0);
 
+#elif defined(__linux__)
+  // Nothing to do
+
 #else
   if (pthread_cond_init(&p->cond, 0))
     THROW("Failed to initialize condition");
@@ -87,7 +106,7 @@ Condition::Condition() : p(new Condition::private_t) {
 
 
 Condition::~Condition() {
-#ifndef _WIN32 // pthreads
+#if !defined(_WIN32) && !defined(__linux__) // pthreads
   if (p) pthread_cond_destroy(&p->cond);
 #endif
 
@@ -100,9 +119,15 @@ void Condition::wait() {
 #ifdef _WIN32
   timedWait(-1);
 
+#elif defined(__linux__)
+  futexWait(-1);
+
 #else // pthreads
-  if (pthread_cond_wait(&p->cond, &Mutex::p->mutex))
-    THROW("Failed to wait on condition");
+  profileRelease();
+  int ret = pthread_cond_wait(&p->cond, &Mutex::p->mutex);
+  profileReacquire();
+
+  if (ret) THROW("Failed to wait on condition");
 #endif
 }
 
@@ -126,6 +151,7 @@ bool Condition::timedWait(double timeout) {
   // This call atomically releases the mutex and waits on the semaphore until
   // signal() is called by another thread.
   DWORD t = timeout < 0 ? INFINITE : (DWORD)(timeout * 1000);
+  profileRelease();
   DWORD ret = SignalObjectAndWait(Mutex::p->h, p->sema, t, FALSE);
 
   // Reacquire lock to avoid race conditions.
@@ -149,6 +175,8 @@ bool Condition::timedWait(double timeout) {
     // Always regain the mutex since that's the guarantee we give our callers.
     WaitForSingleObject(Mutex::p->h, INFINITE);
 
+  profileReacquire();
+
   // Process return code from SignalObjectAndWait() above.
   if (ret == WAIT_TIMEOUT) return true;
   else if (ret == WAIT_FAILED) THROW("Wait failed: " << SysError());
@@ -157,11 +185,18 @@ bool Condition::timedWait(double timeout) {
 
   return false;
 
+#elif defined(__linux__)
+  return futexWait(timeout);
+
 #else // pthreads
   timeout += Timer::now(); // Convert to absolute time
   struct timespec t = Timer::toTimeSpec(timeout);
 
-  return pthread_cond_timedwait(&p->cond, &Mutex::p->mutex, &t) == 0;
+  profileRelease();
+  int ret = pthread_cond_timedwait(&p->cond, &Mutex::p->mutex, &t);
+  profileReacquire();
+
+  return ret == 0;
 #endif
 }
 
@@ -204,8 +239,39 @@ void Condition::signal(bool broadcast) {
     if (haveWaiters) ReleaseSemaphore(p->sema, 1, 0);
   }
 
+#elif defined(__linux__)
+  p->seq.increment();
+
+  // Broadcast wakes every sleeper, signal only one
+  if (p->sleepers) p->seq.wake(broadcast ? ~0U >> 1 : 1);
+
 #else // pthreads
   if (broadcast) pthread_cond_broadcast(&p->cond);
   else pthread_cond_signal(&p->cond);
 #endif
 }
+
+
+#ifdef __linux__
+bool Condition::futexWait(double timeout) {
+  // Read under the lock so a signal() after the unlock is not missed
+  uint32_t seq = p->seq.load();
+  bool signaled = true;
+
+  profileRelease();
+  int ret = pthread_mutex_unlock(&Mutex::p->mutex);
+  if (ret) THROW("Failed to release lock in wait: " << SysError(ret));
+
+  if (!p->seq.spin(seq)) {
+    p->sleepers++;
+    signaled = p->seq.wait(seq, timeout);
+    p->sleepers--;
+  }
+
+  ret = pthread_mutex_lock(&Mutex::p->mutex);
+  if (ret) THROW("Failed to reacquire lock in wait: " << SysError(ret));
+  profileReacquire();
+
+  return signaled;
+}
+#endif
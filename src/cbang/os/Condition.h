@@ -47,5 +47,10 @@ namespace cb {
     bool timedWait(double time);
     void signal(bool broadcast = false);
     void broadcast() {signal(true);}
+
+#ifdef __linux__
+  protected:
+    bool futexWait(double timeout);
+#endif
   };
 }
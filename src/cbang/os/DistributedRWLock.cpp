@@ -0,0 +1,184 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "DistributedRWLock.h"
+#include "Thread.h"
+
+#include <thread>
+
+using namespace cb;
+using namespace std;
+
+
+namespace {
+  atomic<uint64_t> nextThreadID(1);
+
+  uint64_t getThreadID() {
+    static thread_local uint64_t id = nextThreadID++;
+    return id;
+  }
+
+
+  void backoff(unsigned i) {if (64 <= i) Thread::yield();}
+}
+
+
+ostream &DistributedRWLock::Stats::write(ostream &stream) const {
+  return stream << "readWaits=" << readWaits << " writeLocks=" << writeLocks
+                << " writeWaits=" << writeWaits;
+}
+
+
+DistributedRWLock::DistributedRWLock(unsigned count) :
+  slots(0), mask(0), writer(false), owner(0), readWaits(0), writeLocks(0),
+  writeWaits(0) {
+  if (!count) count = thread::hardware_concurrency();
+  if (!count) count = 1;
+
+  // Round up to a power of two
+  unsigned size = 1;
+  while (size < count) size <<= 1;
+
+  slots = new Slot[size];
+  mask = size - 1;
+
+  for (unsigned i = 0; i < size; i++) slots[i].readers = 0;
+}
+
+
+DistributedRWLock::~DistributedRWLock() {delete [] slots;}
+
+
+DistributedRWLock::Stats DistributedRWLock::getStats() const {
+  Stats stats;
+
+  stats.readWaits = readWaits.load(memory_order_relaxed);
+  stats.writeLocks = writeLocks.load(memory_order_relaxed);
+  stats.writeWaits = writeWaits.load(memory_order_relaxed);
+
+  return stats;
+}
+
+
+void DistributedRWLock::resetStats() {
+  readWaits = 0;
+  writeLocks = 0;
+  writeWaits = 0;
+}
+
+
+void DistributedRWLock::readLock() const {
+  if (tryReadLock()) return;
+
+  readWaits.fetch_add(1, memory_order_relaxed);
+
+  for (unsigned i = 0; !tryReadLock(); i++) {
+    // Wait for the writer to finish before trying again
+    while (writer.load(memory_order_relaxed)) backoff(i++);
+  }
+}
+
+
+void DistributedRWLock::writeLock() const {
+  bool waited = false;
+
+  // Acquire the writer flag
+  for (unsigned i = 0;; i++) {
+    bool expected = false;
+    if (writer.compare_exchange_weak(expected, true)) break;
+    waited = true;
+    backoff(i);
+  }
+
+  // New readers will now back off, wait for existing ones to leave
+  for (unsigned i = 0; !drained(); i++) {
+    waited = true;
+    backoff(i);
+  }
+
+  owner.store(getThreadID(), memory_order_relaxed);
+  writeLocks.fetch_add(1, memory_order_relaxed);
+  if (waited) writeWaits.fetch_add(1, memory_order_relaxed);
+}
+
+
+void DistributedRWLock::unlock() const {
+  if (writer.load(memory_order_relaxed) &&
+      owner.load(memory_order_relaxed) == getThreadID()) {
+    owner.store(0, memory_order_relaxed);
+    writer.store(false, memory_order_release);
+
+  } else getSlot().readers.fetch_sub(1, memory_order_release);
+}
+
+
+bool DistributedRWLock::tryReadLock() const {
+  Slot &slot = getSlot();
+
+  // Both this increment and the writer check must be sequentially consistent
+  // so that a writer cannot miss this reader while this reader misses it.
+  slot.readers.fetch_add(1);
+  if (!writer.load()) return true;
+
+  slot.readers.fetch_sub(1, memory_order_release);
+  return false;
+}
+
+
+bool DistributedRWLock::tryWriteLock() const {
+  bool expected = false;
+  if (!writer.compare_exchange_strong(expected, true)) return false;
+
+  if (!drained()) {
+    writer.store(false, memory_order_release);
+    return false;
+  }
+
+  owner.store(getThreadID(), memory_order_relaxed);
+  writeLocks.fetch_add(1, memory_order_relaxed);
+
+  return true;
+}
+
+
+DistributedRWLock::Slot &DistributedRWLock::getSlot() const {
+  return slots[getThreadID() & mask];
+}
+
+
+bool DistributedRWLock::drained() const {
+  for (unsigned i = 0; i <= mask; i++)
+    if (slots[i].readers.load()) return false;
+
+  return true;
+}
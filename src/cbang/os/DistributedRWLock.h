@@ -0,0 +1,103 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cbang/util/RWLockable.h>
+#include <cbang/util/NonCopyable.h>
+
+#include <atomic>
+#include <ostream>
+#include <cstdint>
+
+
+namespace cb {
+  /**
+   * A reader biased read-write lock.  Readers increment a counter in one of
+   * several cache line sized slots chosen by thread so that concurrent
+   * readers do not contend on a shared cache line.  A writer raises a flag and
+   * then waits for every slot to drain.  Writes are therefore expensive and
+   * this lock should only be used where reads greatly outnumber writes.
+   *
+   * The lock is not recursive.  Waiting threads spin briefly then yield.
+   */
+  class DistributedRWLock : public RWLockable, public NonCopyable {
+    struct Slot {
+      std::atomic<unsigned> readers;
+      char pad[64 - sizeof(std::atomic<unsigned>)];
+    };
+
+    Slot *slots;
+    unsigned mask;
+
+    mutable std::atomic<bool> writer;
+    mutable std::atomic<uint64_t> owner;
+
+    mutable std::atomic<uint64_t> readWaits;
+    mutable std::atomic<uint64_t> writeLocks;
+    mutable std::atomic<uint64_t> writeWaits;
+
+  public:
+    struct Stats {
+      uint64_t readWaits;  ///< Read locks which had to wait on a writer
+      uint64_t writeLocks; ///< Total write locks acquired
+      uint64_t writeWaits; ///< Write locks which had to wait
+
+      std::ostream &write(std::ostream &stream) const;
+    };
+
+    /// @param slots Number of reader slots, 0 for one per CPU.
+    DistributedRWLock(unsigned slots = 0);
+    ~DistributedRWLock();
+
+    Stats getStats() const;
+    void resetStats();
+
+    // From RWLockable
+    void readLock() const;
+    void writeLock() const;
+    void unlock() const;
+    bool tryReadLock() const;
+    bool tryWriteLock() const;
+
+  protected:
+    Slot &getSlot() const;
+    bool drained() const;
+  };
+
+
+  inline std::ostream &operator<<(std::ostream &stream,
+                                  const DistributedRWLock::Stats &stats) {
+    return stats.write(stream);
+  }
+}
@@ -0,0 +1,473 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "FileNotifier.h"
+#include "SystemUtilities.h"
+#include "SysError.h"
+
+#include <cbang/Exception.h>
+#include <cbang/time/Timer.h>
+
+#include <map>
+#include <set>
+
+#if defined(__linux__)
+#define CBANG_INOTIFY
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <limits.h>
+
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || \
+  defined(__NetBSD__)
+#define CBANG_KQUEUE
+#include <sys/types.h>
+#include <sys/event.h>
+#include <sys/time.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+#ifndef O_EVTONLY
+#define O_EVTONLY O_RDONLY
+#endif
+#endif
+
+using namespace std;
+using namespace cb;
+
+
+namespace {
+  typedef FileNotifier::event_t event_t;
+
+
+  void split(const string &path, string &dir, string &name) {
+    dir = SystemUtilities::dirname(path);
+    name = SystemUtilities::basename(path);
+  }
+
+
+#if defined(CBANG_INOTIFY) || defined(CBANG_KQUEUE)
+  bool pollFD(int fd, double timeout) {
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    int ms = timeout < 0 ? -1 : (int)(timeout * 1000);
+    int ret = poll(&pfd, 1, ms);
+    if (ret < 0 && errno != EINTR) THROW("poll() failed: " << SysError());
+
+    return 0 < ret;
+  }
+#endif
+}
+
+
+#if defined(CBANG_INOTIFY)
+struct FileNotifier::private_t {
+  int fd;
+
+  struct dir_t {
+    string path;
+    map<string, string> names; // Name to path as added
+  };
+
+  map<int, dir_t> watches;
+  map<string, int> dirs;
+
+
+  private_t() : fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) {
+    if (fd < 0) THROW("inotify_init1() failed: " << SysError());
+  }
+
+
+  ~private_t() {close(fd);}
+
+
+  void add(const string &path) {
+    string dir, name;
+    split(path, dir, name);
+
+    const uint32_t mask = IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE |
+      IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF |
+      IN_MOVE_SELF | IN_ONLYDIR;
+
+    int wd = inotify_add_watch(fd, dir.c_str(), mask);
+    if (wd < 0) THROW("Failed to watch '" << dir << "': " << SysError());
+
+    dir_t &d = watches[wd];
+    d.path = dir;
+    d.names[name] = path;
+    dirs[dir] = wd;
+  }
+
+
+  void remove(const string &path) {
+    string dir, name;
+    split(path, dir, name);
+
+    auto it = dirs.find(dir);
+    if (it == dirs.end()) return;
+
+    int wd = it->second;
+    dir_t &d = watches[wd];
+    d.names.erase(name);
+
+    if (d.names.empty()) {
+      inotify_rm_watch(fd, wd);
+      watches.erase(wd);
+      dirs.erase(it);
+    }
+  }
+
+
+  static unsigned toFlags(uint32_t mask) {
+    unsigned flags = 0;
+
+    if (mask & (IN_MODIFY | IN_CLOSE_WRITE)) flags |= FILE_MODIFIED;
+    if (mask & IN_ATTRIB) flags |= FILE_ATTRIB;
+    if (mask & IN_CREATE) flags |= FILE_CREATED;
+    if (mask & (IN_DELETE | IN_DELETE_SELF)) flags |= FILE_DELETED;
+    if (mask & (IN_MOVED_FROM | IN_MOVED_TO | IN_MOVE_SELF))
+      flags |= FILE_MOVED;
+
+    return flags;
+  }
+
+
+  bool read(vector<event_t> &events) {
+    bool found = false;
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+    while (true) {
+      ssize_t len = ::read(fd, buf, sizeof(buf));
+
+      if (len < 0) {
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN) break;
+        THROW("Failed to read inotify events: " << SysError());
+      }
+
+      if (!len) break;
+
+      for (char *ptr = buf; ptr < buf + len;) {
+        const struct inotify_event *e = (const struct inotify_event *)ptr;
+        ptr += sizeof(struct inotify_event) + e->len;
+
+        auto it = watches.find(e->wd);
+        if (it == watches.end()) continue;
+        dir_t &d = it->second;
+
+        if (e->mask & IN_IGNORED) {
+          // The directory itself went away
+          for (auto &p: d.names) events.push_back({p.second, FILE_DELETED});
+
+          found = found || !d.names.empty();
+          dirs.erase(d.path);
+          watches.erase(it);
+          continue;
+        }
+
+        if (!e->len) continue;
+        auto it2 = d.names.find(e->name);
+        if (it2 == d.names.end()) continue;
+
+        unsigned flags = toFlags(e->mask);
+        if (!flags) continue;
+
+        events.push_back({it2->second, flags});
+        found = true;
+      }
+    }
+
+    return found;
+  }
+
+
+  bool wait(double timeout) {return pollFD(fd, timeout);}
+};
+
+
+#elif defined(CBANG_KQUEUE)
+struct FileNotifier::private_t {
+  int fd;
+
+  struct watch_t {
+    string path;
+    int fd = -1;
+    watch_t *dir = 0;
+    set<string> names; // Only for directories
+
+    ~watch_t() {if (fd != -1) close(fd);}
+  };
+
+  map<string, watch_t *> watches; // Files and directories by path
+  map<int, watch_t *> fds;
+
+
+  private_t() : fd(kqueue()) {
+    if (fd < 0) THROW("kqueue() failed: " << SysError());
+  }
+
+
+  ~private_t() {
+    for (auto &p: watches) delete p.second;
+    close(fd);
+  }
+
+
+  bool open(watch_t &w, unsigned fflags) {
+    w.fd = ::open(w.path.c_str(), O_EVTONLY | O_CLOEXEC);
+    if (w.fd < 0) return false;
+
+    struct kevent ev;
+    EV_SET(&ev, w.fd, EVFILT_VNODE, EV_ADD | EV_CLEAR, fflags, 0, &w);
+
+    if (kevent(fd, &ev, 1, 0, 0, 0) < 0) {
+      close(w.fd);
+      w.fd = -1;
+      THROW("Failed to watch '" << w.path << "': " << SysError());
+    }
+
+    fds[w.fd] = &w;
+    return true;
+  }
+
+
+  void close(watch_t &w) {
+    if (w.fd == -1) return;
+    fds.erase(w.fd);
+    ::close(w.fd); // Also removes the kevent
+    w.fd = -1;
+  }
+
+
+  bool openFile(watch_t &w) {
+    return open(w, NOTE_WRITE | NOTE_EXTEND | NOTE_ATTRIB | NOTE_DELETE |
+                NOTE_RENAME);
+  }
+
+
+  void add(const string &path) {
+    if (watches.count(path)) return;
+
+    string dir, name;
+    split(path, dir, name);
+
+    watch_t *d = watches[dir];
+    if (!d) {
+      d = watches[dir] = new watch_t;
+      d->path = dir;
+
+      if (!open(*d, NOTE_WRITE | NOTE_DELETE | NOTE_RENAME)) {
+        watches.erase(dir);
+        delete d;
+        THROW("Failed to watch '" << dir << "': " << SysError());
+      }
+    }
+
+    watch_t *w = watches[path] = new watch_t;
+    w->path = path;
+    w->dir = d;
+    d->names.insert(path);
+
+    openFile(*w);
+  }
+
+
+  void remove(const string &path) {
+    auto it = watches.find(path);
+    if (it == watches.end() || !it->second->dir) return;
+
+    watch_t *w = it->second;
+    watch_t *d = w->dir;
+    close(*w);
+    watches.erase(it);
+    delete w;
+
+    d->names.erase(path);
+    if (d->names.empty()) {
+      close(*d);
+      watches.erase(d->path);
+      delete d;
+    }
+  }
+
+
+  bool read(vector<event_t> &events) {
+    bool found = false;
+    struct kevent evs[64];
+    struct timespec zero = {0, 0};
+
+    while (true) {
+      int n = kevent(fd, 0, 0, evs, 64, &zero);
+
+      if (n < 0) {
+        if (errno == EINTR) continue;
+        THROW("Failed to read kqueue events: " << SysError());
+      }
+
+      for (int i = 0; i < n; i++) {
+        if (!fds.count((int)evs[i].ident)) continue; // Already closed
+        watch_t &w = *(watch_t *)evs[i].udata;
+        unsigned fflags = evs[i].fflags;
+
+        if (w.dir) { // A file
+          unsigned flags = 0;
+          if (fflags & (NOTE_WRITE | NOTE_EXTEND)) flags |= FILE_MODIFIED;
+          if (fflags & NOTE_ATTRIB) flags |= FILE_ATTRIB;
+          if (fflags & NOTE_DELETE) flags |= FILE_DELETED;
+          if (fflags & NOTE_RENAME) flags |= FILE_MOVED;
+
+          // The file must be reopened if it is replaced
+          if (flags & (FILE_DELETED | FILE_MOVED)) close(w);
+
+          if (flags) {
+            events.push_back({w.path, flags});
+            found = true;
+          }
+
+        } else { // A directory, look for new files
+          for (auto &path: w.names) {
+            watch_t &f = *watches[path];
+
+            if (f.fd == -1 && openFile(f)) {
+              events.push_back({path, FILE_CREATED});
+              found = true;
+            }
+          }
+        }
+      }
+
+      if (n < 64) break;
+    }
+
+    return found;
+  }
+
+
+  bool wait(double timeout) {return pollFD(fd, timeout);}
+};
+
+
+#else // Poll
+struct FileNotifier::private_t {
+  int fd = -1;
+
+  struct state_t {
+    bool exists = false;
+    uint64_t size = 0;
+    uint64_t mtime = 0;
+  };
+
+  map<string, state_t> files;
+
+
+  static state_t stat(const string &path) {
+    state_t s;
+
+    try {
+      s.exists = SystemUtilities::exists(path);
+      if (s.exists) {
+        s.size = SystemUtilities::getFileSize(path);
+        s.mtime = SystemUtilities::getModificationTime(path);
+      }
+    } catch (const Exception &e) {
+      s.exists = false; // Removed while checking
+    }
+
+    return s;
+  }
+
+
+  void add(const string &path) {
+    if (!files.count(path)) files[path] = stat(path);
+  }
+
+
+  void remove(const string &path) {files.erase(path);}
+
+
+  bool read(vector<event_t> &events) {
+    bool found = false;
+
+    for (auto &p: files) {
+      state_t s = stat(p.first);
+      state_t &last = p.second;
+      unsigned flags = 0;
+
+      if (s.exists != last.exists)
+        flags = s.exists ? FILE_CREATED : FILE_DELETED;
+      else if (s.exists && (s.size != last.size || s.mtime != last.mtime))
+        flags = FILE_MODIFIED;
+
+      last = s;
+
+      if (flags) {
+        events.push_back({p.first, flags});
+        found = true;
+      }
+    }
+
+    return found;
+  }
+
+
+  bool wait(double timeout) {
+    Timer::sleep(timeout < 0 ? 0.25 : timeout);
+    return true;
+  }
+};
+#endif
+
+
+FileNotifier::FileNotifier() : pri(new private_t) {}
+FileNotifier::~FileNotifier() {delete pri;}
+
+
+bool FileNotifier::isSupported() {
+#if defined(CBANG_INOTIFY) || defined(CBANG_KQUEUE)
+  return true;
+#else
+  return false;
+#endif
+}
+
+
+int FileNotifier::getFD() const {return pri->fd;}
+void FileNotifier::add(const string &path) {pri->add(path);}
+void FileNotifier::remove(const string &path) {pri->remove(path);}
+bool FileNotifier::read(vector<event_t> &events) {return pri->read(events);}
+bool FileNotifier::wait(double timeout) {return pri->wait(timeout);}
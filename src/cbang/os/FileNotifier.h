@@ -0,0 +1,95 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/util/NonCopyable.h>
+
+#include <string>
+#include <vector>
+
+
+namespace cb {
+  /**
+   * Reports changes to a set of files using inotify on Linux and kqueue on
+   * BSD and macOS.  Elsewhere the files are polled with stat().
+   *
+   * The containing directory of each file is watched so that files which
+   * do not exist yet, or which are replaced by log rotation, are still
+   * reported.  getFD() may be watched for readability, e.g. by an
+   * Event::Base, then read() collects the pending changes.  Not thread
+   * safe.
+   */
+  class FileNotifier : public NonCopyable {
+  public:
+    enum {
+      FILE_MODIFIED = 1 << 0,
+      FILE_CREATED  = 1 << 1,
+      FILE_DELETED  = 1 << 2,
+      FILE_MOVED    = 1 << 3,
+      FILE_ATTRIB   = 1 << 4,
+    };
+
+    struct event_t {
+      std::string path;
+      unsigned flags;
+    };
+
+  protected:
+    struct private_t;
+    private_t *pri;
+
+  public:
+    FileNotifier();
+    ~FileNotifier();
+
+    /// @return False if changes are detected by polling
+    static bool isSupported();
+
+    /// @return A descriptor which becomes readable on changes or -1
+    int getFD() const;
+
+    void add(const std::string &path);
+    void remove(const std::string &path);
+
+    /// Append pending changes to @param events without blocking.
+    /// @return True if any were added.
+    bool read(std::vector<event_t> &events);
+
+    /**
+     * Block until changes may be pending.  When polling this just sleeps.
+     * @param timeout Seconds to wait or -1 to wait forever.
+     * @return False if the timeout expired.
+     */
+    bool wait(double timeout = -1);
+  };
+}
@@ -0,0 +1,183 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "Futex.h"
+
+#include <cbang/Exception.h>
+
+#include <algorithm>
+
+#ifdef __linux__
+#include "SysError.h"
+
+#include <cbang/time/Timer.h>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+
+#elif !defined(_WIN32)
+#include "Condition.h"
+
+#include <cbang/util/SmartLock.h>
+
+#include <unistd.h>
+
+#else
+#include "Condition.h"
+
+#include <cbang/util/SmartLock.h>
+
+#define WIN32_LEAN_AND_MEAN // Avoid including winsock.h
+#include <windows.h>
+#endif
+
+using namespace cb;
+
+
+namespace {
+  const unsigned maxSpins = 200;
+
+
+  bool canSpin() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    static bool multiCPU = 1 < info.dwNumberOfProcessors;
+#else
+    static bool multiCPU = 1 < sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return multiCPU;
+  }
+
+
+  inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile ("yield");
+#elif defined(_WIN32)
+    YieldProcessor();
+#endif
+  }
+}
+
+
+bool Futex::spin(uint32_t expected) {
+  if (!canSpin()) return value.load() != expected;
+
+  unsigned estimate = spins.load(std::memory_order_relaxed);
+  unsigned limit = std::min(maxSpins, 2 * estimate + 10);
+
+  for (unsigned i = 0; i < limit; i++) {
+    if (value.load(std::memory_order_acquire) != expected) {
+      // Move the estimate toward the spins this change took
+      spins.store(estimate + ((int)i - (int)estimate) / 8,
+                  std::memory_order_relaxed);
+      return true;
+    }
+
+    cpuRelax();
+  }
+
+  // Spinning did not pay off, back off next time
+  spins.store(estimate / 2, std::memory_order_relaxed);
+
+  return false;
+}
+
+
+#ifdef __linux__
+struct Futex::private_t {};
+
+
+namespace {
+  long futex(std::atomic<uint32_t> &addr, int op, uint32_t val,
+             const struct timespec *ts = 0) {
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+                  "Unexpected std::atomic<uint32_t> size");
+    return syscall(SYS_futex, (uint32_t *)&addr, op, val, ts, 0, 0);
+  }
+}
+
+
+Futex::Futex(uint32_t value) : value(value), spins(0), p(0) {}
+Futex::~Futex() {}
+
+
+bool Futex::wait(uint32_t expected, double timeout) {
+  struct timespec ts;
+  if (0 <= timeout) ts = Timer::toTimeSpec(timeout);
+
+  if (!futex(value, FUTEX_WAIT_PRIVATE, expected, 0 <= timeout ? &ts : 0))
+    return true;
+
+  switch (errno) {
+  case ETIMEDOUT: return false;
+  case EAGAIN: case EINTR: return true;
+  default: THROW("futex() wait failed: " << SysError());
+  }
+}
+
+
+void Futex::wake(unsigned count) {
+  futex(value, FUTEX_WAKE_PRIVATE, count);
+}
+
+
+#else // Condition fallback
+struct Futex::private_t : public Condition {};
+
+
+Futex::Futex(uint32_t value) :
+  value(value), spins(0), p(new private_t) {}
+Futex::~Futex() {delete p;}
+
+
+bool Futex::wait(uint32_t expected, double timeout) {
+  SmartLock lock(p);
+
+  // Changes made before wake() locks are seen here
+  if (value.load() != expected) return true;
+
+  if (timeout < 0) {p->wait(); return true;}
+  return p->timedWait(timeout);
+}
+
+
+void Futex::wake(unsigned count) {
+  SmartLock lock(p);
+  p->signal(1 < count);
+}
+#endif
@@ -0,0 +1,89 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cbang/StdTypes.h>
+#include <cbang/util/NonCopyable.h>
+
+#include <atomic>
+
+
+namespace cb {
+  /**
+   * A 32-bit value threads can sleep on until it changes.  On Linux this is
+   * a futex and costs no system call unless a thread is actually waiting.
+   * Elsewhere it falls back to a Condition.
+   *
+   * Typical use is an event counter: a waiter loads the value, checks its
+   * own condition and then calls wait() with the loaded value.  A notifier
+   * updates its state, increments the value and calls wake().
+   */
+  class Futex : public NonCopyable {
+    std::atomic<uint32_t> value;
+    std::atomic<unsigned> spins;
+
+    struct private_t;
+    private_t *p;
+
+  public:
+    Futex(uint32_t value = 0);
+    ~Futex();
+
+    std::atomic<uint32_t> &get() {return value;}
+    uint32_t load() const {return value.load();}
+    uint32_t increment() {return ++value;}
+
+    /**
+     * Block while the value equals @param expected.  May also return
+     * spuriously.
+     *
+     * @param timeout Seconds to wait or -1 to wait forever.
+     * @return False if the timeout expired.
+     */
+    bool wait(uint32_t expected, double timeout = -1);
+
+    /**
+     * Spin briefly while the value equals @param expected.  The number of
+     * spins adapts to how long recent changes took to arrive.  Does not
+     * spin on single CPU systems.
+     *
+     * @return True if the value changed.
+     */
+    bool spin(uint32_t expected);
+
+    /// Wake up to @param count waiting threads
+    void wake(unsigned count = 1);
+    void wakeAll() {wake(~0U >> 1);}
+  };
+}
@@ -47,6 +47,7 @@
 #endif
 
 using namespace cb;
+using namespace std;
 
 
 Mutex::Mutex() : p(new Mutex::private_t), locked(0) {
@@ -83,7 +84,64 @@ Mutex::~Mutex() {
 }
 
 
+void Mutex::setProfileName(const string &name) {
+#ifdef CBANG_MUTEX_PROFILE
+  p->entry = MutexProfiler::getEntry(name);
+#endif
+}
+
+
 bool Mutex::lock(double timeout) const {
+#ifdef CBANG_MUTEX_PROFILE
+  MutexProfiler::Entry *entry = p->entry;
+
+  if (entry && MutexProfiler::isEnabled()) {
+    bool contended = !acquire(0);
+    uint64_t start = 0;
+
+    if (contended) {
+      if (!timeout) return false;
+      start = MutexProfiler::now();
+      if (!acquire(timeout)) return false;
+    }
+
+    uint64_t now = MutexProfiler::now();
+    entry->acquired(contended ? now - start : 0, contended);
+    if (locked == 1) p->holdStart = now;
+
+    return true;
+  }
+#endif // CBANG_MUTEX_PROFILE
+
+  return acquire(timeout);
+}
+
+
+void Mutex::unlock() const {
+  if (!locked) THROW("Mutex " << ID((uint64_t)this) << " was not locked");
+
+  if (locked == 1) profileRelease();
+  locked--;
+
+  int ret = 0;
+
+#ifdef _WIN32
+  if (ReleaseMutex(p->h)) return;
+#else // pthreads
+  if ((ret = pthread_mutex_unlock(&p->mutex)) == 0) return;
+#endif // _WIN32
+
+  locked++;
+  THROW("Mutex " << ID((uint64_t)this) << " unlock failed: " << SysError(ret));
+}
+
+
+bool Mutex::tryLock() const {
+  return lock(0);
+}
+
+
+bool Mutex::acquire(double timeout) const {
 #ifdef _WIN32
   DWORD t = timeout < 0 ? INFINITE : (DWORD)(timeout * 1000);
   DWORD ret = WaitForSingleObject(p->h, t);
@@ -140,24 +198,19 @@ bool Mutex::lock(double timeout) const {
 }
 
 
-void Mutex::unlock() const {
-  if (!locked) THROW("Mutex " << ID((uint64_t)this) << " was not locked");
-
-  locked--;
-
-  int ret = 0;
-
-#ifdef _WIN32
-  if (ReleaseMutex(p->h)) return;
-#else // pthreads
-  if ((ret = pthread_mutex_unlock(&p->mutex)) == 0) return;
-#endif // _WIN32
-
-  locked++;
-  THROW("Mutex " << ID((uint64_t)this) << " unlock failed: " << SysError(ret));
+void Mutex::profileRelease() const {
+#ifdef CBANG_MUTEX_PROFILE
+  if (p->holdStart) {
+    p->entry->released(MutexProfiler::now() - p->holdStart);
+    p->holdStart = 0;
+  }
+#endif
 }
 
 
-bool Mutex::tryLock() const {
-  return lock(0);
+void Mutex::profileReacquire() const {
+#ifdef CBANG_MUTEX_PROFILE
+  if (p->entry && MutexProfiler::isEnabled())
+    p->holdStart = MutexProfiler::now();
+#endif
 }
@@ -37,6 +37,8 @@
 #include <cbang/util/Lockable.h>
 #include <cbang/util/NonCopyable.h>
 
+#include <string>
+
 namespace cb {
   /// Mutual exclusion class
   class Mutex : public Lockable, public NonCopyable {
@@ -52,6 +54,12 @@ namespace cb {
 
     bool isLocked() const {return locked;}
 
+    /**
+     * Name this Mutex for lock profiling.  Has no effect unless cbang was
+     * built with CBANG_MUTEX_PROFILE.  See MutexProfiler.
+     */
+    void setProfileName(const std::string &name);
+
     /**
      * Aquire this lock.  Will block the current thread until the lock is
      * obtained.
@@ -69,5 +77,10 @@ namespace cb {
      * @return False if the lock is not immediately available.
      */
     bool tryLock() const;
+
+  protected:
+    bool acquire(double timeout) const;
+    void profileRelease() const;
+    void profileReacquire() const;
   };
 }
@@ -34,6 +34,10 @@
 
 #include "Mutex.h"
 
+#ifdef CBANG_MUTEX_PROFILE
+#include "MutexProfiler.h"
+#endif
+
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN // Avoid including winsock.h
 #include <windows.h>
@@ -51,5 +55,12 @@ namespace cb {
     pthread_mutex_t mutex;
     pthread_mutexattr_t attr;
 #endif
+
+#ifdef CBANG_MUTEX_PROFILE
+    MutexProfiler::Entry *entry;
+    uint64_t holdStart;
+
+    private_t() : entry(0), holdStart(0) {}
+#endif
   };
 };
@@ -0,0 +1,170 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "MutexProfiler.h"
+#include "SpinLock.h"
+
+#include <cbang/json/Sink.h>
+#include <cbang/util/SmartLock.h>
+
+#include <chrono>
+#include <map>
+
+using namespace cb;
+using namespace std;
+
+
+namespace {
+  struct Entries {
+    SpinLock lock;
+    map<string, MutexProfiler::Entry *> entries;
+  };
+
+
+  Entries &getEntries() {
+    // Never deallocated so that Mutexes may be used during static destruction
+    static Entries *entries = new Entries;
+    return *entries;
+  }
+
+
+  void updateMax(atomic<uint64_t> &max, uint64_t value) {
+    uint64_t current = max.load(memory_order_relaxed);
+
+    while (current < value &&
+           !max.compare_exchange_weak(current, value, memory_order_relaxed))
+      continue;
+  }
+}
+
+
+atomic<bool> MutexProfiler::enabled(false);
+
+
+MutexProfiler::Entry::Entry(const string &name) :
+  name(name), acquisitions(0), contended(0), waitTime(0), maxWait(0),
+  holdTime(0), maxHold(0) {}
+
+
+void MutexProfiler::Entry::acquired(uint64_t wait, bool contended) {
+  acquisitions.fetch_add(1, memory_order_relaxed);
+
+  if (contended) {
+    this->contended.fetch_add(1, memory_order_relaxed);
+    waitTime.fetch_add(wait, memory_order_relaxed);
+    updateMax(maxWait, wait);
+  }
+}
+
+
+void MutexProfiler::Entry::released(uint64_t hold) {
+  holdTime.fetch_add(hold, memory_order_relaxed);
+  updateMax(maxHold, hold);
+}
+
+
+void MutexProfiler::Entry::reset() {
+  acquisitions = 0;
+  contended = 0;
+  waitTime = 0;
+  maxWait = 0;
+  holdTime = 0;
+  maxHold = 0;
+}
+
+
+void MutexProfiler::Entry::write(JSON::Sink &sink) const {
+  sink.beginDict();
+  sink.insert("acquisitions", acquisitions.load());
+  sink.insert("contended", contended.load());
+  sink.insert("wait_time", waitTime.load() / 1e9);
+  sink.insert("max_wait", maxWait.load() / 1e9);
+  sink.insert("hold_time", holdTime.load() / 1e9);
+  sink.insert("max_hold", maxHold.load() / 1e9);
+  sink.endDict();
+}
+
+
+bool MutexProfiler::isCompiled() {
+#ifdef CBANG_MUTEX_PROFILE
+  return true;
+#else
+  return false;
+#endif
+}
+
+
+void MutexProfiler::setEnabled(bool enabled) {
+  MutexProfiler::enabled = enabled;
+}
+
+
+MutexProfiler::Entry *MutexProfiler::getEntry(const string &name) {
+  Entries &e = getEntries();
+  SmartLock lock(&e.lock);
+
+  Entry *&entry = e.entries[name];
+  if (!entry) entry = new Entry(name);
+
+  return entry;
+}
+
+
+void MutexProfiler::reset() {
+  Entries &e = getEntries();
+  SmartLock lock(&e.lock);
+
+  for (auto it = e.entries.begin(); it != e.entries.end(); it++)
+    it->second->reset();
+}
+
+
+uint64_t MutexProfiler::now() {
+  return chrono::duration_cast<chrono::nanoseconds>
+    (chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+void MutexProfiler::write(JSON::Sink &sink) const {
+  Entries &e = getEntries();
+  SmartLock lock(&e.lock);
+
+  sink.beginDict();
+
+  for (auto it = e.entries.begin(); it != e.entries.end(); it++) {
+    sink.beginInsert(it->first);
+    it->second->write(sink);
+  }
+
+  sink.endDict();
+}
@@ -0,0 +1,88 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cbang/json/Serializable.h>
+
+#include <atomic>
+#include <string>
+
+
+namespace cb {
+  /**
+   * Collects lock wait and hold times for named Mutexes.  Profiling is only
+   * available when cbang is built with CBANG_MUTEX_PROFILE and must also be
+   * turned on at runtime with setEnabled().  Mutexes are named with
+   * Mutex::setProfileName() and all Mutexes sharing a name are reported
+   * together.
+   *
+   * Times are reported in seconds.
+   */
+  class MutexProfiler : public JSON::Serializable {
+    static std::atomic<bool> enabled;
+
+  public:
+    struct Entry {
+      const std::string name;
+
+      std::atomic<uint64_t> acquisitions;
+      std::atomic<uint64_t> contended;
+      std::atomic<uint64_t> waitTime;
+      std::atomic<uint64_t> maxWait;
+      std::atomic<uint64_t> holdTime;
+      std::atomic<uint64_t> maxHold;
+
+      Entry(const std::string &name);
+
+      void acquired(uint64_t wait, bool contended);
+      void released(uint64_t hold);
+      void reset();
+      void write(JSON::Sink &sink) const;
+    };
+
+    static bool isCompiled();
+    static bool isEnabled() {return enabled.load(std::memory_order_relaxed);}
+    static void setEnabled(bool enabled);
+
+    /// Entries are never freed so the returned pointer is always valid.
+    static Entry *getEntry(const std::string &name);
+    static void reset();
+
+    /// @return a monotonic time in nanoseconds.
+    static uint64_t now();
+
+    // From JSON::Serializable
+    void write(JSON::Sink &sink) const;
+  };
+}
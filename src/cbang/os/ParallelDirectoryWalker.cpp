@@ -0,0 +1,325 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "ParallelDirectoryWalker.h"
+#include "SystemInfo.h"
+#include "SystemUtilities.h"
+#include "SysError.h"
+#include "Directory.h"
+
+#include <cbang/Exception.h>
+#include <cbang/log/Logger.h>
+#include <cbang/util/SmartLock.h>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+using namespace std;
+using namespace cb;
+
+
+namespace {
+#ifdef __linux__
+  struct dirent64_t {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+  };
+#endif
+
+
+  bool globMatch(const char *pattern, const char *name) {
+#ifdef _WIN32
+    // Only '*' and '?'
+    switch (*pattern) {
+    case 0: return !*name;
+    case '*':
+      do if (globMatch(pattern + 1, name)) return true; while (*name++);
+      return false;
+    case '?': return *name && globMatch(pattern + 1, name + 1);
+    default: return *pattern == *name && globMatch(pattern + 1, name + 1);
+    }
+#else
+    return !fnmatch(pattern, name, FNM_PERIOD);
+#endif
+  }
+}
+
+
+ParallelDirectoryWalker::ParallelDirectoryWalker(unsigned threads) :
+  ThreadPool(threads ? threads : SystemInfo::instance().getCPUCount()),
+  pending(0), nextWorker(0), sleeping(0), abort(false), fileCount(0),
+  dirCount(0) {
+  for (unsigned i = 0; i < getSize(); i++) queues.push_back(new queue_t);
+}
+
+
+ParallelDirectoryWalker::~ParallelDirectoryWalker() {}
+
+
+void ParallelDirectoryWalker::setPattern(const string &pattern) {
+  re = pattern.empty() ? 0 : new Regex(pattern);
+}
+
+
+void ParallelDirectoryWalker::walk(const string &root, callback_t cb) {
+  if (!SystemUtilities::isDirectory(root))
+    THROW("Not a directory '" << root << "'");
+
+  this->cb = cb;
+  pending = nextWorker = sleeping = 0;
+  abort = false;
+  fileCount = dirCount = 0;
+  error.release();
+
+  string path = root;
+  if (path.empty() || path[path.length() - 1] != '/') path += '/';
+  push(0, path, 1);
+
+  start();
+  wait();
+
+  for (auto &q: queues) q->work.clear();
+  this->cb = 0;
+
+  if (error.isSet()) throw *error;
+}
+
+
+bool ParallelDirectoryWalker::matches(const char *name) const {
+  if (!glob.empty() && !globMatch(glob.c_str(), name)) return false;
+  return re.isNull() || re->match(name);
+}
+
+
+void ParallelDirectoryWalker::push(unsigned id, const string &path,
+                                   unsigned depth) {
+  pending++;
+
+  queue_t &q = *queues[id];
+  {
+    SmartLock lock(&q.lock);
+    q.work.push_back(work_t{path, depth});
+  }
+
+  if (sleeping) {
+    SmartLock lock(&idle);
+    idle.signal();
+  }
+}
+
+
+bool ParallelDirectoryWalker::take(unsigned id, work_t &work) {
+  // Newest first from our own queue, for locality
+  queue_t &own = *queues[id];
+  {
+    SmartLock lock(&own.lock);
+    if (!own.work.empty()) {
+      work = std::move(own.work.back());
+      own.work.pop_back();
+      return true;
+    }
+  }
+
+  // Steal the oldest, likely the largest subtree, from another queue
+  for (unsigned i = 1; i < queues.size(); i++) {
+    queue_t &q = *queues[(id + i) % queues.size()];
+    SmartLock lock(&q.lock);
+
+    if (!q.work.empty()) {
+      work = std::move(q.work.front());
+      q.work.pop_front();
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+bool ParallelDirectoryWalker::hasWork() const {
+  for (auto &q: queues) {
+    SmartLock lock(&q->lock);
+    if (!q->work.empty()) return true;
+  }
+
+  return false;
+}
+
+
+void ParallelDirectoryWalker::scan(unsigned id, const work_t &work) {
+  dirCount++;
+
+#ifdef _WIN32
+  for (Directory dir(work.path); dir && !abort; dir.next()) {
+    string name = dir.getFilename();
+    if (name == "." || name == "..") continue;
+    entry(id, work, name.c_str(), dir.isSubdirectory());
+  }
+
+#else
+  int fd = open(work.path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) {
+    LOG_WARNING("Failed to open directory '" << work.path << "': "
+                << SysError());
+    return;
+  }
+
+  auto resolve = [&] (const char *name, unsigned char type) {
+    if (type == DT_DIR) return true;
+    if (type != DT_UNKNOWN && (type != DT_LNK || !followLinks)) return false;
+
+    struct stat st;
+    int flags = followLinks ? 0 : AT_SYMLINK_NOFOLLOW;
+    return !fstatat(fd, name, &st, flags) && S_ISDIR(st.st_mode);
+  };
+
+  auto add = [&] (const char *name, unsigned char type) {
+    if (name[0] == '.' && (!name[1] || (name[1] == '.' && !name[2])))
+      return;
+    entry(id, work, name, resolve(name, type));
+  };
+
+#ifdef __linux__
+  char buf[65536];
+
+  while (!abort) {
+    long len = syscall(SYS_getdents64, fd, buf, sizeof(buf));
+
+    if (len < 0) {
+      if (errno == EINTR) continue;
+      LOG_WARNING("Failed to read directory '" << work.path << "': "
+                  << SysError());
+    }
+
+    if (len <= 0) break;
+
+    for (long offset = 0; offset < len && !abort;) {
+      const dirent64_t *e = (const dirent64_t *)(buf + offset);
+      offset += e->d_reclen;
+      add(e->d_name, e->d_type);
+    }
+  }
+
+  close(fd);
+
+#else
+  DIR *dir = fdopendir(fd);
+  if (!dir) {
+    close(fd);
+    LOG_WARNING("Failed to read directory '" << work.path << "': "
+                << SysError());
+    return;
+  }
+
+  struct dirent *e;
+  while (!abort && (e = readdir(dir))) add(e->d_name, e->d_type);
+
+  closedir(dir); // Also closes fd
+#endif
+#endif // _WIN32
+}
+
+
+void ParallelDirectoryWalker::entry(unsigned id, const work_t &work,
+                                    const char *name, bool isDir) {
+  if (isDir) {
+    string path = work.path + name + '/';
+    if (work.depth < maxDepth) push(id, path, work.depth + 1);
+    if (listDirs) cb(path.substr(0, path.length() - 1), true);
+
+  } else if (matches(name)) {
+    fileCount++;
+    cb(work.path + name, false);
+  }
+}
+
+
+void ParallelDirectoryWalker::setError(const Exception &e) {
+  SmartLock lock(&errorLock);
+  if (error.isNull()) error = new Exception(e);
+  abort = true;
+}
+
+
+void ParallelDirectoryWalker::run() {
+  unsigned id = nextWorker++;
+
+  while (!abort && !Thread::current().shouldShutdown()) {
+    work_t work;
+
+    if (take(id, work)) {
+      try {
+        scan(id, work);
+
+      } catch (const Exception &e) {
+        setError(e);
+      } catch (const std::exception &e) {
+        setError(Exception(e.what()));
+      }
+
+      if (!--pending) {
+        SmartLock lock(&idle);
+        idle.broadcast();
+      }
+
+      continue;
+    }
+
+    if (!pending) break; // Done
+
+    SmartLock lock(&idle);
+    sleeping++; // Before checking so push() does not miss us
+
+    if (pending && !hasWork()) idle.timedWait(0.1);
+
+    sleeping--;
+  }
+
+  if (abort) {
+    SmartLock lock(&idle);
+    idle.broadcast();
+  }
+}
@@ -0,0 +1,143 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "ThreadPool.h"
+#include "Condition.h"
+#include "SpinLock.h"
+
+#include <cbang/SmartPointer.h>
+#include <cbang/StdTypes.h>
+#include <cbang/util/Regex.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <deque>
+#include <atomic>
+
+
+namespace cb {
+  class Exception;
+
+  /**
+   * Walk a directory tree with a pool of threads.
+   *
+   * Each thread scans directories from its own queue and pushes the
+   * subdirectories it finds back onto it.  Idle threads steal from the
+   * other queues.  Entry types come from the directory listing itself,
+   * getdents64() on Linux and readdir() elsewhere, so entries are only
+   * stat()ed when the filesystem does not report a type or to follow
+   * symbolic links.  File names are matched before the full path is built.
+   *
+   * Results are passed to a callback, concurrently from the worker threads,
+   * in no particular order.  Unlike DirectoryWalker directories are
+   * reported before their contents.
+   */
+  class ParallelDirectoryWalker : protected ThreadPool {
+  public:
+    typedef std::function<void (const std::string &path, bool isDir)>
+    callback_t;
+
+  protected:
+    SmartPointer<Regex> re;
+    std::string glob;
+    unsigned maxDepth = ~0;
+    bool listDirs = false;
+    bool followLinks = false;
+
+    struct work_t {
+      std::string path;
+      unsigned depth;
+    };
+
+    struct queue_t {
+      SpinLock lock;
+      std::deque<work_t> work;
+    };
+
+    std::vector<SmartPointer<queue_t> > queues;
+    callback_t cb;
+
+    std::atomic<unsigned> pending;
+    std::atomic<unsigned> nextWorker;
+    std::atomic<unsigned> sleeping;
+    std::atomic<bool> abort;
+    std::atomic<uint64_t> fileCount;
+    std::atomic<uint64_t> dirCount;
+
+    Condition idle;
+    SpinLock errorLock;
+    SmartPointer<Exception> error;
+
+  public:
+    /// @param threads The number of threads or 0 for one per CPU.
+    ParallelDirectoryWalker(unsigned threads = 0);
+    ~ParallelDirectoryWalker();
+
+    using ThreadPool::getSize;
+
+    /// Only report files whose names match the regular expression
+    void setPattern(const std::string &pattern);
+    /// Only report files whose names match the shell wildcard pattern
+    void setGlob(const std::string &pattern) {glob = pattern;}
+    /// A maxDepth of 0 or 1 only searches the root
+    void setMaxDepth(unsigned depth) {maxDepth = depth;}
+    void setListDirs(bool x) {listDirs = x;}
+    /// Descend into symbolic links to directories.  Beware of cycles.
+    void setFollowLinks(bool x) {followLinks = x;}
+
+    /**
+     * Walk the tree below @param root and block until done.  An exception
+     * thrown by @param cb stops the walk and is rethrown here.
+     */
+    void walk(const std::string &root, callback_t cb);
+
+    /// @return The number of files reported by the last walk
+    uint64_t getFileCount() const {return fileCount;}
+    /// @return The number of directories scanned by the last walk
+    uint64_t getDirCount() const {return dirCount;}
+
+  protected:
+    bool matches(const char *name) const;
+    void push(unsigned id, const std::string &path, unsigned depth);
+    bool take(unsigned id, work_t &work);
+    bool hasWork() const;
+    void scan(unsigned id, const work_t &work);
+    void entry(unsigned id, const work_t &work, const char *name, bool isDir);
+    void setError(const Exception &e);
+
+    // From ThreadPool
+    void run();
+  };
+}
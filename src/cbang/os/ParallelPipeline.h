@@ -0,0 +1,183 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "ParallelPool.h"
+#include "Condition.h"
+
+#include <cbang/util/SmartLock.h>
+#include <cbang/util/SmartUnlock.h>
+
+#include <map>
+#include <vector>
+#include <atomic>
+#include <functional>
+
+
+namespace cb {
+  /**
+   * A bounded pipeline of the form read -> stages -> write.  Items are
+   * read by the serial source in order, pass through the stages in
+   * parallel and reach the serial sink in the order they were read.  At
+   * most capacity items are in flight at once, so a slow sink holds back
+   * the source rather than accumulating items in memory.
+   *
+   * Stages modify the item in place, so T should have room for the
+   * results of each stage.
+   */
+  template <typename T>
+  class ParallelPipeline : protected Condition {
+  public:
+    /// Reads the next item and returns false at the end of the input
+    typedef std::function<bool (T &item)> source_t;
+    typedef std::function<void (T &item)> stage_t;
+
+  protected:
+    ParallelPool &pool;
+    unsigned capacity;
+
+    source_t source;
+    std::vector<stage_t> stages;
+    stage_t sink;
+
+    Mutex sourceLock;
+    uint64_t nextRead = 0;
+    uint64_t nextWrite = 0;
+    unsigned inFlight = 0;
+    std::atomic<bool> done;
+    bool failed = false;
+    bool writing = false;
+    std::map<uint64_t, T> pending;
+
+  public:
+    /// @param capacity zero for twice the number of threads
+    ParallelPipeline(ParallelPool &pool, unsigned capacity = 0) :
+      pool(pool), capacity(capacity ? capacity : 2 * (pool.getSize() + 1)),
+      done(false) {}
+
+    ParallelPipeline &setSource(source_t source)
+    {this->source = source; return *this;}
+    ParallelPipeline &addStage(stage_t stage)
+    {stages.push_back(stage); return *this;}
+    ParallelPipeline &setSink(stage_t sink) {this->sink = sink; return *this;}
+
+    /// Blocks until every item read has been written or the pool stops
+    void run() {
+      if (!source) CBANG_THROW("Pipeline source not set");
+
+      nextRead = nextWrite = inFlight = 0;
+      done = failed = writing = false;
+      pending.clear();
+
+      pool.parallel(capacity, [this] () {
+        try {
+          return step();
+
+        } catch (...) {
+          SmartLock lock(this);
+          failed = true;
+          broadcast();
+          throw;
+        }
+      });
+    }
+
+  protected:
+    bool step() {
+      T item;
+      uint64_t seq;
+
+      {
+        SmartLock lock(this);
+
+        while (!done && !failed && capacity <= inFlight) {
+          if (pool.shouldStop()) return false;
+          timedWait(0.1);
+        }
+
+        if (done || failed) return false;
+        inFlight++;
+      }
+
+      {
+        SmartLock lock(&sourceLock);
+
+        if (done || !source(item)) {
+          SmartLock lock(this);
+          done = true;
+          inFlight--;
+          broadcast();
+          return false;
+        }
+
+        seq = nextRead++;
+      }
+
+      for (auto &stage: stages) stage(item);
+
+      write(seq, item);
+      return true;
+    }
+
+
+    void write(uint64_t seq, T &item) {
+      SmartLock lock(this);
+
+      pending.insert(std::make_pair(seq, std::move(item)));
+      if (writing) return; // The current writer will pick it up
+      writing = true;
+
+      // Write consecutive items, unlocked so others may keep depositing
+      while (!pending.empty() && pending.begin()->first == nextWrite) {
+        T next = std::move(pending.begin()->second);
+        pending.erase(pending.begin());
+
+        try {
+          SmartUnlock unlock(this);
+          if (sink) sink(next);
+
+        } catch (...) {
+          writing = false;
+          throw;
+        }
+
+        nextWrite++;
+        inFlight--;
+        broadcast();
+      }
+
+      writing = false;
+    }
+  };
+}
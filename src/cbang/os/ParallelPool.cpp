@@ -0,0 +1,165 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "ParallelPool.h"
+#include "SystemInfo.h"
+
+#include <cbang/Catch.h>
+#include <cbang/util/SmartLock.h>
+
+#include <memory>
+#include <exception>
+
+using namespace std;
+using namespace cb;
+
+
+class ParallelPool::Group : public Condition {
+  const step_t &step;
+
+  bool closed = false;
+  unsigned active = 0;
+  atomic<bool> failed;
+  exception_ptr error;
+
+public:
+  atomic<bool> canceled;
+
+  Group(const step_t &step) : step(step), failed(false), canceled(false) {}
+
+
+  void run(const ParallelPool &pool) {
+    {
+      SmartLock lock(this);
+      if (closed) return; // Started too late, step may no longer exist
+      active++;
+    }
+
+    try {
+      while (!failed) {
+        if (pool.shouldStop()) {canceled = true; break;}
+        if (!step()) break;
+      }
+
+    } catch (...) {
+      SmartLock lock(this);
+      if (!failed.exchange(true)) error = current_exception();
+    }
+
+    SmartLock lock(this);
+    if (!--active && closed) broadcast();
+  }
+
+
+  void close() {
+    SmartLock lock(this);
+    closed = true;
+    while (active) wait();
+
+    if (error) rethrow_exception(error);
+    if (canceled) THROW("Parallel operation canceled");
+  }
+};
+
+
+ParallelPool::ParallelPool(unsigned size) :
+  ThreadPool(size ? size : SystemInfo::instance().getCPUCount()),
+  stopping(false) {}
+
+
+ParallelPool::~ParallelPool() {join();}
+
+
+void ParallelPool::submit(task_t task) {
+  SmartLock lock(this);
+  tasks.push_back(move(task));
+  signal();
+}
+
+
+bool ParallelPool::shouldStop() const {
+  Thread *thread = Thread::getCurrent();
+  return stopping || (thread && thread->shouldShutdown());
+}
+
+
+void ParallelPool::parallel(unsigned width, const step_t &step) {
+  // Shared with workers, which may release it concurrently
+  auto group = make_shared<Group>(step);
+
+  {
+    SmartLock lock(this);
+
+    for (unsigned i = 1; i < width && i <= getSize(); i++)
+      tasks.push_back([this, group] () {group->run(*this);});
+
+    broadcast();
+  }
+
+  group->run(*this);
+  group->close();
+}
+
+
+void ParallelPool::stop() {
+  stopping = true;
+  ThreadPool::stop();
+
+  SmartLock lock(this);
+  broadcast();
+}
+
+
+void ParallelPool::join() {
+  stop();
+  ThreadPool::join();
+}
+
+
+void ParallelPool::run() {
+  while (true) {
+    task_t task;
+
+    {
+      SmartLock lock(this);
+
+      while (tasks.empty() && !shouldStop()) Condition::wait();
+      if (shouldStop()) return;
+
+      task = move(tasks.front());
+      tasks.pop_front();
+    }
+
+    TRY_CATCH_ERROR(task());
+  }
+}
@@ -0,0 +1,171 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "ThreadPool.h"
+#include "Condition.h"
+
+#include <cbang/util/InlineFunction.h>
+
+#include <deque>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include <cstdint>
+
+
+namespace cb {
+  /**
+   * A ThreadPool whose workers run tasks from a shared queue, with blocking
+   * data parallel algorithms built on it.  The calling thread takes part
+   * in each algorithm and only waits for workers which have started on
+   * it, so algorithms may be nested or called from the pool's own tasks.
+   *
+   * An algorithm stops early, throwing an Exception, when the pool is
+   * stopped or the calling Thread's shouldShutdown() becomes true.  The
+   * first exception thrown by a callback stops the algorithm and is
+   * rethrown to the caller.
+   */
+  class ParallelPool : public ThreadPool, protected Condition {
+  public:
+    typedef InlineFunction<void ()> task_t;
+    typedef std::function<bool ()> step_t;
+
+  protected:
+    class Group;
+
+    std::deque<task_t> tasks;
+    std::atomic<bool> stopping;
+
+  public:
+    /// @param size worker threads, zero for one per CPU
+    ParallelPool(unsigned size = 0);
+    ~ParallelPool();
+
+    /// Run @param task on a worker
+    void submit(task_t task);
+
+    /// @return True if work on the calling thread should end
+    bool shouldStop() const;
+
+    /**
+     * Call @param step repeatedly on the calling thread and up to
+     * @param width - 1 workers.  Each thread stops once its call returns
+     * false.  Returns when all threads which started have stopped.
+     */
+    void parallel(unsigned width, const step_t &step);
+
+    /// Call @param fn(first, last) on consecutive ranges of @param grain
+    template <typename F>
+    void parallelFor(uint64_t begin, uint64_t end, uint64_t grain, F fn) {
+      if (end <= begin) return;
+      if (!grain) grain = 1;
+
+      uint64_t chunks = (end - begin - 1) / grain + 1;
+      std::atomic<uint64_t> next(0);
+
+      parallel(std::min<uint64_t>(chunks, getSize() + 1), [&] () {
+        uint64_t chunk = next.fetch_add(1);
+        if (chunks <= chunk) return false;
+
+        uint64_t first = begin + chunk * grain;
+        fn(first, std::min(end, first + grain));
+        return true;
+      });
+    }
+
+
+    /**
+     * @param map(first, last) computes the value of each range of
+     * @param grain.  The values are combined in order, starting with
+     * @param identity, with @param reduce(a, b).
+     */
+    template <typename T, typename Map, typename Reduce>
+    T parallelReduce(uint64_t begin, uint64_t end, uint64_t grain,
+                     T identity, Map map, Reduce reduce) {
+      if (end <= begin) return identity;
+      if (!grain) grain = 1;
+
+      // Wrapped so that vector<bool> does not pack concurrent writes
+      struct Partial {T value;};
+      std::vector<Partial> partials((end - begin - 1) / grain + 1,
+                                    Partial{identity});
+
+      parallelFor(0, partials.size(), 1, [&] (uint64_t i, uint64_t) {
+        uint64_t first = begin + i * grain;
+        partials[i].value = map(first, std::min(end, first + grain));
+      });
+
+      T result = identity;
+      for (auto &partial: partials) result = reduce(result, partial.value);
+      return result;
+    }
+
+
+    /// Sort ranges of @param grain in parallel then merge them in rounds
+    template <typename It, typename Less>
+    void parallelSort(It begin, It end, Less less, uint64_t grain = 4096) {
+      uint64_t n = end - begin;
+      if (!grain) grain = 1;
+
+      parallelFor(0, n, grain, [&] (uint64_t first, uint64_t last) {
+        std::sort(begin + first, begin + last, less);
+      });
+
+      for (uint64_t width = grain; width < n; width *= 2)
+        parallelFor(0, n, 2 * width, [&] (uint64_t first, uint64_t last) {
+          uint64_t middle = std::min(n, first + width);
+          if (middle < last)
+            std::inplace_merge(begin + first, begin + middle, begin + last,
+                               less);
+        });
+    }
+
+
+    template <typename It>
+    void parallelSort(It begin, It end) {
+      typedef typename std::iterator_traits<It>::value_type value_t;
+      parallelSort(begin, end, std::less<value_t>());
+    }
+
+    // From ThreadPool
+    void stop();
+    void join();
+
+  protected:
+    // From ThreadPool
+    void run();
+  };
+}
@@ -32,8 +32,10 @@
 
 #pragma once
 
+#include <cbang/util/RWLockable.h>
+
 namespace cb {
-  class RWLock {
+  class RWLock : public RWLockable {
     struct private_t;
     private_t *p;
 
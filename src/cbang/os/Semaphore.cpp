@@ -54,6 +54,10 @@
 #include <uuid/uuid.h>
 #endif
 
+#ifdef __linux__
+#include "Futex.h"
+#endif
+
 using namespace std;
 using namespace cb;
 
@@ -67,11 +71,33 @@ namespace cb {
 #ifdef __APPLE__
     char name2[39];
 #endif
+#ifdef __linux__
+    // Unnamed semaphores count in a futex and spin before parking
+    Futex count;
+    std::atomic<unsigned> sleepers;
+
+    private_t() : sem(0), sleepers(0) {}
+#endif
 #endif // _WIN32
   };
 }
 
 
+#ifdef __linux__
+namespace {
+  bool tryDecrement(atomic<uint32_t> &count) {
+    uint32_t c = count.load(memory_order_relaxed);
+
+    while (c)
+      if (count.compare_exchange_weak(c, c - 1, memory_order_acquire))
+        return true;
+
+    return false;
+  }
+}
+#endif
+
+
 Semaphore::Semaphore(const string &name, unsigned count, unsigned mode) :
   p(new private_t), name(name) {
 
@@ -100,6 +126,9 @@ Semaphore::Semaphore(const string &name, unsigned count, unsigned mode) :
     if (p->sem == SEM_FAILED)
       THROW("Failed to create Semaphore: " << SysError());
 
+#elif defined(__linux__)
+    p->count.get() = count;
+
 #else
     p->sem = new sem_t;
     if (sem_init(p->sem, 0, count))
@@ -137,6 +166,29 @@ Semaphore::~Semaphore() {
 
 
 bool Semaphore::wait(double timeout) const {
+#ifdef __linux__
+  if (!isNamed()) {
+    atomic<uint32_t> &count = p->count.get();
+
+    if (tryDecrement(count)) return true;
+    if (!timeout) return false;
+    if (p->count.spin(0) && tryDecrement(count)) return true;
+
+    double deadline = 0 < timeout ? Timer::now() + timeout : 0;
+
+    while (true) {
+      double remaining = 0 < timeout ? deadline - Timer::now() : -1;
+      if (0 < timeout && remaining <= 0) return tryDecrement(count);
+
+      p->sleepers++;
+      p->count.wait(0, remaining);
+      p->sleepers--;
+
+      if (tryDecrement(count)) return true;
+    }
+  }
+#endif // __linux__
+
 #ifdef _WIN32
   DWORD t = timeout < 0 ? INFINITE : (DWORD)(timeout * 1000);
   DWORD ret = WaitForSingleObject(p->sem, t);
@@ -168,7 +220,7 @@ bool Semaphore::wait(double timeout) const {
 #endif // __APPLE__
   }
 
-  if (ret == ETIMEDOUT || ret == EAGAIN) return false;
+  if (ret && (errno == ETIMEDOUT || errno == EAGAIN)) return false;
   else if (!ret) return true;
 #endif // _WIN32
 
@@ -179,6 +231,14 @@ bool Semaphore::wait(double timeout) const {
 void Semaphore::post(unsigned count) const {
   if (!count) return;
 
+#ifdef __linux__
+  if (!isNamed()) {
+    p->count.get() += count;
+    if (p->sleepers) p->count.wake(count);
+    return;
+  }
+#endif // __linux__
+
 #ifdef _WIN32
   if (!ReleaseSemaphore(p->sem, count, 0))
     THROW("Semaphore post failed: " << SysError());
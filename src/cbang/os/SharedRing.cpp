@@ -0,0 +1,226 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "SharedRing.h"
+
+#include <cbang/Exception.h>
+#include <cbang/io/MappedFile.h>
+#include <cbang/os/ProcessLock.h>
+#include <cbang/os/SystemUtilities.h>
+
+#include <atomic>
+#include <thread>
+#include <new>
+
+#include <string.h>
+
+using namespace std;
+using namespace cb;
+
+
+namespace {
+  const uint32_t MAGIC = 0x52474e52; // RNGR
+  const uint32_t VERSION = 1;
+  const uint32_t HEADER_SIZE = 512;
+  const uint32_t PADDING = 0xffffffff;
+
+  uint64_t frameSize(uint32_t length) {return (4 + (uint64_t)length + 7) & ~7;}
+}
+
+
+struct SharedRing::Header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t capacity;
+
+  // Each counter on its own cache line
+  alignas(64) atomic<uint64_t> head;     // Next byte the reader consumes
+  alignas(64) atomic<uint64_t> reserved; // End of space claimed by writers
+  alignas(64) atomic<uint64_t> tail;     // End of published messages
+  alignas(64) atomic<uint32_t> waiting;  // The reader is sleeping
+};
+
+
+SharedRing::SharedRing(const string &path, uint32_t capacity) :
+  header(0), data(0), mask(0) {
+  static_assert(sizeof(Header) <= HEADER_SIZE, "Header too large");
+  static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Atomics must be lock free");
+
+  ProcessLock lock(path + ".lock", 10);
+
+  if (SystemUtilities::exists(path) &&
+      HEADER_SIZE < SystemUtilities::getFileSize(path)) {
+    file = new MappedFile(path, true);
+    header = (Header *)file->getWritableData();
+
+    if (header->magic != MAGIC || header->version != VERSION ||
+        file->getLength() != (uint64_t)HEADER_SIZE + header->capacity)
+      file.release(); // Recreate it
+  }
+
+  if (file.isNull()) init(path, capacity);
+
+  data = file->getWritableData() + HEADER_SIZE;
+  mask = header->capacity - 1;
+}
+
+
+SharedRing::~SharedRing() {}
+
+
+const string &SharedRing::getPath() const {return file->getPath();}
+uint32_t SharedRing::getMaxMessage() const {return getCapacity() / 2 - 8;}
+
+
+bool SharedRing::isEmpty() const {
+  return header->head.load(memory_order_acquire) ==
+    header->tail.load(memory_order_acquire);
+}
+
+
+bool SharedRing::write(const void *msg, uint32_t length) {
+  if (getMaxMessage() < length)
+    THROW("Message of " << length << " bytes exceeds the maximum of "
+          << getMaxMessage());
+
+  uint64_t size = frameSize(length);
+  uint64_t capacity = getCapacity();
+  uint64_t start = header->reserved.load(memory_order_relaxed);
+  uint64_t pad, end;
+
+  // Reserve space, messages do not wrap so skip to the start if needed
+  do {
+    uint64_t offset = start & mask;
+    pad = capacity - offset < size ? capacity - offset : 0;
+    end = start + pad + size;
+
+    if (capacity < end - header->head.load(memory_order_acquire))
+      return false; // Full
+
+  } while (!header->reserved.compare_exchange_weak
+           (start, end, memory_order_acq_rel, memory_order_relaxed));
+
+  if (pad) memcpy(data + (start & mask), &PADDING, 4);
+
+  char *frame = data + ((start + pad) & mask);
+  memcpy(frame, &length, 4);
+  memcpy(frame + 4, msg, length);
+
+  // Publish after any earlier reservations
+  while (header->tail.load(memory_order_acquire) != start)
+    this_thread::yield();
+
+  header->tail.store(end, memory_order_seq_cst);
+
+  return true;
+}
+
+
+bool SharedRing::peek(const char *&msg, uint32_t &length) {
+  uint64_t head = header->head.load(memory_order_relaxed);
+
+  while (true) {
+    if (head == header->tail.load(memory_order_acquire)) return false;
+
+    const char *frame = data + (head & mask);
+    memcpy(&length, frame, 4);
+
+    if (length != PADDING) {
+      msg = frame + 4;
+      return true;
+    }
+
+    // Skip padding at the end of the ring
+    head += getCapacity() - (head & mask);
+    header->head.store(head, memory_order_release);
+  }
+}
+
+
+void SharedRing::consume() {
+  uint64_t head = header->head.load(memory_order_relaxed);
+  if (head == header->tail.load(memory_order_acquire)) return;
+
+  uint32_t length;
+  memcpy(&length, data + (head & mask), 4);
+  header->head.store(head + frameSize(length), memory_order_release);
+}
+
+
+bool SharedRing::read(string &msg) {
+  const char *data;
+  uint32_t length;
+
+  if (!peek(data, length)) return false;
+  msg.assign(data, length);
+  consume();
+
+  return true;
+}
+
+
+bool SharedRing::setWaiting() {
+  header->waiting.store(1, memory_order_seq_cst);
+
+  if (header->tail.load(memory_order_seq_cst) !=
+      header->head.load(memory_order_relaxed)) {
+    header->waiting.store(0, memory_order_relaxed);
+    return false;
+  }
+
+  return true;
+}
+
+
+bool SharedRing::wasWaiting() {
+  return header->waiting.load(memory_order_seq_cst) &&
+    header->waiting.exchange(0, memory_order_seq_cst);
+}
+
+
+void SharedRing::init(const string &path, uint32_t capacity) {
+  uint64_t size = 4096;
+  while (size < capacity) size <<= 1;
+  if (size >> 31) THROW("SharedRing capacity too large: " << capacity);
+
+  file = new MappedFile(path, true, HEADER_SIZE + size);
+  char *ptr = file->getWritableData();
+  memset(ptr, 0, HEADER_SIZE);
+
+  header = new (ptr) Header;
+  header->version = VERSION;
+  header->capacity = size;
+  header->head = header->reserved = header->tail = 0;
+  header->waiting = 0;
+  header->magic = MAGIC;
+}
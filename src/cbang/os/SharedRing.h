@@ -0,0 +1,111 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+#include <cbang/util/NonCopyable.h>
+
+#include <string>
+#include <cstdint>
+
+
+namespace cb {
+  class MappedFile;
+
+  /**
+   * A ring of framed messages in a shared memory mapped file through which
+   * processes on the same host exchange messages without system calls.
+   * Any number of processes may write but only one may read.
+   *
+   * The first process to open the ring creates and initializes it, while
+   * holding a ProcessLock on "<path>.lock".  Put the file on a memory
+   * backed filesystem, such as /dev/shm, so it is never written to disk.
+   *
+   * Writers reserve space with an atomic compare and swap then publish
+   * their messages in reservation order.  A writer which dies between the
+   * two stalls the other writers.  Notification of the reader is left to
+   * the caller, see Event::SharedChannel.
+   */
+  class SharedRing : public NonCopyable {
+    struct Header;
+
+    SmartPointer<MappedFile> file;
+    Header *header;
+    char *data;
+    uint64_t mask;
+
+  public:
+    /**
+     * Open or create the ring at @param path.  @param capacity, rounded up
+     * to a power of two, is only used when creating it.
+     */
+    SharedRing(const std::string &path, uint32_t capacity = 1 << 20);
+    ~SharedRing();
+
+    const std::string &getPath() const;
+    uint32_t getCapacity() const {return mask + 1;}
+    /// The largest message write() accepts
+    uint32_t getMaxMessage() const;
+
+    bool isEmpty() const;
+
+    /// @return false if the ring does not have space for the message
+    bool write(const void *data, uint32_t length);
+    bool write(const std::string &msg) {return write(msg.data(), msg.size());}
+
+    /**
+     * Zero copy read.  Points @param data at the next message, which stays
+     * valid until consume() is called.
+     * @return false if the ring is empty.
+     */
+    bool peek(const char *&data, uint32_t &length);
+    /// Release the message returned by peek()
+    void consume();
+    /// @return false if the ring is empty
+    bool read(std::string &msg);
+
+    /**
+     * Called by the reader before it sleeps.  Writers see the flag and
+     * notify the reader, see wasWaiting().
+     * @return false if a message arrived meanwhile so the reader should
+     * not sleep.
+     */
+    bool setWaiting();
+    /// Called by writers after write().  Clears the reader's waiting flag.
+    bool wasWaiting();
+
+  protected:
+    void init(const std::string &path, uint32_t capacity);
+  };
+}
@@ -0,0 +1,57 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/util/Lockable.h>
+#include <cbang/util/NonCopyable.h>
+
+#include <atomic>
+
+
+namespace cb {
+  /**
+   * A busy waiting lock for very short critical sections.  Unlike Mutex
+   * it is not recursive.  After a number of failed attempts the calling
+   * thread yields its time slice.
+   */
+  class SpinLock : public Lockable, public NonCopyable {
+    mutable std::atomic_flag flag = ATOMIC_FLAG_INIT;
+
+  public:
+    /// @param timeout Seconds to wait or -1 to wait forever.
+    bool lock(double timeout = -1) const;
+    void unlock() const {flag.clear(std::memory_order_release);}
+    bool tryLock() const
+    {return !flag.test_and_set(std::memory_order_acquire);}
+  };
+}
@@ -59,6 +59,23 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <spawn.h>
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 29)
+#define HAVE_SPAWN_CHDIR
+#endif
+
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 34)
+#define HAVE_SPAWN_CLOSEFROM
+#endif
+
+extern char **environ;
 #endif // _WIN32
 
 #include <boost/version.hpp>
@@ -96,6 +113,34 @@ namespace {
   typedef HANDLE pipe_handle_t;
 #else
   typedef int pipe_handle_t;
+
+
+  // Must be safe to call after vfork(), so no allocation
+  void closeRange(int first, int last, bool toEnd = false) {
+    if (last < first) return;
+
+#ifdef SYS_close_range
+    unsigned end = toEnd ? ~0U : (unsigned)last;
+    if (!syscall(SYS_close_range, (unsigned)first, end, 0)) return;
+#endif
+
+    // Without close_range() stop at the descriptor limit
+    for (int fd = first; fd <= last; fd++) ::close(fd);
+  }
+
+
+  /// Close descriptors from 3 to @param max except the sorted @param keep
+  void closeFDs(const int *keep, unsigned count, int max) {
+    int next = 3;
+
+    for (unsigned i = 0; i < count; i++)
+      if (next <= keep[i]) {
+        closeRange(next, keep[i] - 1);
+        next = keep[i] + 1;
+      }
+
+    closeRange(next, max, true);
+  }
 #endif
 
 
@@ -153,6 +198,20 @@ namespace {
 #endif
 
 
+    void closeChild() {
+      unsigned i = toChild ? 0 : 1;
+
+      if (closeHandles[i]) {
+#ifdef _WIN32
+        CloseHandle(handles[i]);
+#else
+        ::close(handles[i]);
+#endif
+        closeHandles[i] = false;
+      }
+    }
+
+
     void close() {
       for (unsigned i = 0; i < 2; i++)
         if (closeHandles[i]) {
@@ -252,6 +311,28 @@ Subprocess::handle_t Subprocess::getPipeHandle(unsigned i, bool childEnd) {
 }
 
 
+unsigned Subprocess::getPipeCount() const {return p->pipes.size();}
+
+
+bool Subprocess::isPipeToChild(unsigned i) const {
+  if (p->pipes.size() <= i) THROW("Subprocess does not have pipe " << i);
+  return p->pipes[i].toChild;
+}
+
+
+bool Subprocess::hasPipeHandle(unsigned i) const {
+  if (p->pipes.size() <= i) return false;
+  const Pipe &pipe = p->pipes[i];
+  return pipe.closeHandles[pipe.toChild ? 1 : 0];
+}
+
+
+void Subprocess::closePipe(unsigned i) {
+  if (p->pipes.size() <= i) THROW("Subprocess does not have pipe " << i);
+  p->pipes[i].close();
+}
+
+
 const SmartPointer<iostream> &Subprocess::getStream(unsigned i) const {
   if (p->pipes.size() <= i || p->pipes[i].stream.isNull())
     THROW("Subprocess stream " << i << " not available");
@@ -395,68 +476,88 @@ void Subprocess::exec(const vector<string> &_args, unsigned flags,
     }
 
 #else // _WIN32
-    // Convert args
-    vector<char *> args;
-    for (unsigned i = 0; i < _args.size(); i++)
-      args.push_back((char *)_args[i].c_str());
-    args.push_back(0); // Sentinal
+    if (!(flags & USE_SPAWN) || !spawn(_args, flags, priority)) {
+      // Convert args
+      vector<char *> args;
+      for (unsigned i = 0; i < _args.size(); i++)
+        args.push_back((char *)_args[i].c_str());
+      args.push_back(0); // Sentinal
+
+      // Descriptors to keep, computed before fork() so the child does not
+      // allocate.  With close_range() the rest are closed in a few calls
+      // instead of one per possible descriptor.
+      vector<int> keep;
+      int maxFD = 0;
+
+      if (flags & CLOSE_FDS) {
+        for (unsigned i = 3; i < p->pipes.size(); i++)
+          keep.push_back(p->pipes[i].getChildHandle());
+        sort(keep.begin(), keep.end());
+
+        long max = sysconf(_SC_OPEN_MAX);
+        maxFD = max < 0 ? 65535 : (int)max - 1;
+      }
 
-    if (flags & USE_VFORK) p->pid = vfork();
-    else p->pid = fork();
+      if (flags & USE_VFORK) p->pid = vfork();
+      else p->pid = fork();
 
-    if (!p->pid) { // Child
-      // Process group
-      if (flags & CREATE_PROCESS_GROUP) setpgid(0, 0);
+      if (!p->pid) { // Child
+        // Process group
+        if (flags & CREATE_PROCESS_GROUP) setpgid(0, 0);
 
-      // Configure pipes
-      if (flags & REDIR_STDIN) p->pipes[0].inChildProc(0);
-      if (flags & REDIR_STDOUT) p->pipes[1].inChildProc(1);
+        // Configure pipes
+        if (flags & REDIR_STDIN) p->pipes[0].inChildProc(0);
+        if (flags & REDIR_STDOUT) p->pipes[1].inChildProc(1);
 
-      if (flags & MERGE_STDOUT_AND_STDERR)
-        if (dup2(1, 2) != 2) perror("Copying stdout to stderr");
+        if (flags & MERGE_STDOUT_AND_STDERR)
+          if (dup2(1, 2) != 2) perror("Copying stdout to stderr");
 
-      if (flags & REDIR_STDERR) p->pipes[2].inChildProc(2);
+        if (flags & REDIR_STDERR) p->pipes[2].inChildProc(2);
 
-      if ((flags & NULL_STDOUT) || (flags & NULL_STDERR)) {
-        int fd = open("/dev/null", O_WRONLY);
+        if ((flags & NULL_STDOUT) || (flags & NULL_STDERR)) {
+          int fd = open("/dev/null", O_WRONLY);
 
-        if (fd != -1) {
-          if (flags & NULL_STDOUT) dup2(fd, 1);
-          if (flags & NULL_STDERR) dup2(fd, 2);
+          if (fd != -1) {
+            if (flags & NULL_STDOUT) dup2(fd, 1);
+            if (flags & NULL_STDERR) dup2(fd, 2);
 
-        } else {
-          if (flags & NULL_STDOUT) close(1);
-          if (flags & NULL_STDERR) close(2);
+          } else {
+            if (flags & NULL_STDOUT) close(1);
+            if (flags & NULL_STDERR) close(2);
+          }
         }
-      }
 
-      for (unsigned i = 3; i < p->pipes.size(); i++)
-        p->pipes[i].inChildProc();
+        for (unsigned i = 3; i < p->pipes.size(); i++)
+          p->pipes[i].inChildProc();
 
-      // Priority
-      SystemUtilities::setPriority(priority);
+        if (flags & CLOSE_FDS)
+          closeFDs(keep.empty() ? 0 : &keep[0], keep.size(), maxFD);
 
-      // Working directory
-      if (wd != "") SystemUtilities::chdir(wd);
+        // Priority
+        SystemUtilities::setPriority(priority);
 
-      // Setup environment
-      if (flags & CLEAR_ENVIRONMENT) SystemUtilities::clearenv();
+        // Working directory
+        if (wd != "") SystemUtilities::chdir(wd);
 
-      for (iterator it = begin(); it != end(); it++)
-        SystemUtilities::setenv(it->first, it->second);
+        // Setup environment
+        if (flags & CLEAR_ENVIRONMENT) SystemUtilities::clearenv();
 
-      SysError::clear();
+        for (iterator it = begin(); it != end(); it++)
+          SystemUtilities::setenv(it->first, it->second);
 
-      if (flags & SHELL) execvp(args[0], &args[0]);
-      else execv(args[0], &args[0]);
+        SysError::clear();
 
-      // Execution failed
-      string errorStr = "Failed to execute: " + String::join(_args);
-      perror(errorStr.c_str());
-      exit(-1);
+        if (flags & SHELL) execvp(args[0], &args[0]);
+        else execv(args[0], &args[0]);
 
-    } else if (p->pid == -1)
-      THROW("Failed to spawn subprocess: " << SysError());
+        // Execution failed
+        string errorStr = "Failed to execute: " + String::join(_args);
+        perror(errorStr.c_str());
+        exit(-1);
+
+      } else if (p->pid == -1)
+        THROW("Failed to spawn subprocess: " << SysError());
+    }
 #endif // _WIN32
 
   } catch (...) {
@@ -465,11 +566,13 @@ void Subprocess::exec(const vector<string> &_args, unsigned flags,
   }
 
   // Create pipe streams
-  if (flags & REDIR_STDIN) p->pipes[0].openStream();
-  if (flags & REDIR_STDOUT) p->pipes[1].openStream();
-  if (flags & REDIR_STDERR) p->pipes[2].openStream();
-  for (unsigned i = 3; i < p->pipes.size(); i++)
-    p->pipes[i].openStream();
+  if (!(flags & NO_PIPE_STREAMS)) {
+    if (flags & REDIR_STDIN) p->pipes[0].openStream();
+    if (flags & REDIR_STDOUT) p->pipes[1].openStream();
+    if (flags & REDIR_STDERR) p->pipes[2].openStream();
+    for (unsigned i = 3; i < p->pipes.size(); i++)
+      p->pipes[i].openStream();
+  }
 
 #ifdef F_SETPIPE_SZ
   // Max pipe size
@@ -480,7 +583,7 @@ void Subprocess::exec(const vector<string> &_args, unsigned flags,
       uint32_t size = String::parseU32(num);
 
       for (unsigned i = 0; i < p->pipes.size(); i++)
-        if (p->pipes[i].stream.isSet())
+        if (hasPipeHandle(i) || p->pipes[i].stream.isSet())
           if (fcntl(p->pipes[i].getParentHandle(), F_SETPIPE_SZ, size) == -1)
             LOG_WARNING("Failed to set pipe " << i << " size to " << size);
     }
@@ -492,12 +595,110 @@ void Subprocess::exec(const vector<string> &_args, unsigned flags,
 #endif // F_SETPIPE_SZ
 
   // Close pipe child ends
-  closePipes();
+  for (unsigned i = 0; i < p->pipes.size(); i++)
+    p->pipes[i].closeChild();
 
   running = true;
 }
 
 
+#ifndef _WIN32
+bool Subprocess::spawn(const vector<string> &_args, unsigned flags,
+                       ProcessPriority priority) {
+  // Fall back to fork() for what posix_spawn() cannot do
+#ifndef HAVE_SPAWN_CHDIR
+  if (!wd.empty()) return false;
+#endif
+#ifndef HAVE_SPAWN_CLOSEFROM
+  if (flags & CLOSE_FDS) return false;
+#endif
+  if ((flags & CLOSE_FDS) && 3 < p->pipes.size()) return false;
+
+  // Arguments
+  vector<char *> args;
+  for (unsigned i = 0; i < _args.size(); i++)
+    args.push_back((char *)_args[i].c_str());
+  args.push_back(0);
+
+  // Environment
+  vector<string> envStrs;
+  if (!(flags & CLEAR_ENVIRONMENT))
+    for (char **env = environ; env && *env; env++) {
+      const char *equal = strchr(*env, '=');
+      if (equal && find(string(*env, equal - *env)) != end()) continue;
+      envStrs.push_back(*env);
+    }
+
+  for (iterator it = begin(); it != end(); it++)
+    envStrs.push_back(it->first + "=" + it->second);
+
+  vector<char *> env;
+  for (unsigned i = 0; i < envStrs.size(); i++)
+    env.push_back((char *)envStrs[i].c_str());
+  env.push_back(0);
+
+  // Descriptors
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+
+  auto dup = [&] (Pipe &pipe, int target) {
+    posix_spawn_file_actions_addclose(&actions, pipe.getParentHandle());
+    if (target != -1)
+      posix_spawn_file_actions_adddup2(&actions, pipe.getChildHandle(),
+                                       target);
+  };
+
+  if (flags & REDIR_STDIN) dup(p->pipes[0], 0);
+  if (flags & REDIR_STDOUT) dup(p->pipes[1], 1);
+  if (flags & MERGE_STDOUT_AND_STDERR)
+    posix_spawn_file_actions_adddup2(&actions, 1, 2);
+  if (flags & REDIR_STDERR) dup(p->pipes[2], 2);
+
+  if (flags & NULL_STDOUT)
+    posix_spawn_file_actions_addopen(&actions, 1, "/dev/null", O_WRONLY, 0);
+  if (flags & NULL_STDERR)
+    posix_spawn_file_actions_addopen(&actions, 2, "/dev/null", O_WRONLY, 0);
+
+  for (unsigned i = 3; i < p->pipes.size(); i++) dup(p->pipes[i], -1);
+
+#ifdef HAVE_SPAWN_CLOSEFROM
+  if (flags & CLOSE_FDS) posix_spawn_file_actions_addclosefrom_np(&actions, 3);
+#endif
+
+#ifdef HAVE_SPAWN_CHDIR
+  if (!wd.empty())
+    posix_spawn_file_actions_addchdir_np(&actions, wd.c_str());
+#endif
+
+  // Attributes
+  posix_spawnattr_t attr;
+  posix_spawnattr_init(&attr);
+
+  if (flags & CREATE_PROCESS_GROUP) {
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+    posix_spawnattr_setpgroup(&attr, 0);
+  }
+
+  pid_t pid;
+  int err = ((flags & SHELL) ? posix_spawnp : posix_spawn)
+    (&pid, args[0], &actions, &attr, &args[0], &env[0]);
+
+  posix_spawnattr_destroy(&attr);
+  posix_spawn_file_actions_destroy(&actions);
+
+  if (err) THROW("Failed to execute: " << String::join(_args) << ": "
+                 << SysError(err));
+
+  p->pid = pid;
+
+  // Priority cannot be set by posix_spawn() so set it right after
+  TRY_CATCH_WARNING(SystemUtilities::setPriority(priority, pid));
+
+  return true;
+}
+#endif // _WIN32
+
+
 void Subprocess::exec(const string &command, unsigned flags,
                       ProcessPriority priority) {
   vector<string> args;
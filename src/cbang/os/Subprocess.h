@@ -57,6 +57,9 @@ namespace cb {
       W32_WAIT_FOR_INPUT_IDLE = 1 << 10,
       MAX_PIPE_SIZE           = 1 << 11,
       USE_VFORK               = 1 << 12,
+      USE_SPAWN               = 1 << 13,
+      CLOSE_FDS               = 1 << 14,
+      NO_PIPE_STREAMS         = 1 << 15,
       };
 
   protected:
@@ -89,6 +92,12 @@ namespace cb {
 
     unsigned createPipe(bool toChild);
     handle_t getPipeHandle(unsigned i, bool childEnd = true);
+    unsigned getPipeCount() const;
+    bool isPipeToChild(unsigned i) const;
+    /// @return True if the parent end of pipe @param i is an open handle
+    bool hasPipeHandle(unsigned i) const;
+    /// Close both ends of pipe @param i
+    void closePipe(unsigned i);
 
     const SmartPointer<std::iostream> &getStream(unsigned i) const;
     std::ostream &getStdIn() const {return *getStream(0);}
@@ -117,6 +126,10 @@ namespace cb {
     static std::string assemble(const std::vector<std::string> &args);
 
   protected:
+#ifndef _WIN32
+    bool spawn(const std::vector<std::string> &args, unsigned flags,
+               ProcessPriority priority);
+#endif
     void closeProcessHandles();
     void closeStreams();
     void closePipes();
@@ -45,6 +45,8 @@
 
 #include <boost/filesystem/operations.hpp>
 
+#include <set>
+
 #if defined(_WIN32)
 #define WIN32_LEAN_AND_MEAN // Avoid including winsock.h
 #include <windows.h>
@@ -110,6 +112,87 @@ uint32_t SystemInfo::getCPUCount() const {
 }
 
 
+vector<unsigned> SystemInfo::getCoreCPUs() {
+  vector<unsigned> cpus;
+  unsigned count = getCPUCount();
+
+#ifdef __linux__
+  // Use the kernel's topology, sibling threads are often not adjacent
+  set<pair<string, string> > seen;
+  string base = "/sys/devices/system/cpu/cpu";
+
+  for (unsigned cpu = 0; cpu < count; cpu++) {
+    string dir = base + String(cpu) + "/topology/";
+    if (!SystemUtilities::exists(dir + "core_id")) break;
+
+    string package = String::trim(
+      SystemUtilities::read(dir + "physical_package_id"));
+    string core = String::trim(SystemUtilities::read(dir + "core_id"));
+
+    if (seen.insert(make_pair(package, core)).second) cpus.push_back(cpu);
+  }
+
+  if (!cpus.empty()) return cpus;
+#endif // __linux__
+
+  // Otherwise assume sibling threads are numbered consecutively
+  uint32_t logical, cores, threads;
+  getCPUCounts(logical, cores, threads);
+  if (!threads) threads = 1;
+
+  for (unsigned cpu = 0; cpu < count; cpu += threads) cpus.push_back(cpu);
+
+  return cpus;
+}
+
+
+uint32_t SystemInfo::getNUMANodeCount() const {
+  uint32_t count = 0;
+
+#ifdef __linux__
+  while (SystemUtilities::exists("/sys/devices/system/node/node" +
+                                 String(count) + "/cpulist")) count++;
+#endif
+
+  return count ? count : 1;
+}
+
+
+vector<unsigned> SystemInfo::getNUMANodeCPUs(unsigned node) const {
+  vector<unsigned> cpus;
+
+#ifdef __linux__
+  string path =
+    "/sys/devices/system/node/node" + String(node) + "/cpulist";
+
+  if (SystemUtilities::exists(path)) {
+    // Format is a comma separated list of ranges, e.g. "0-3,8-11"
+    vector<string> ranges;
+    String::tokenize(String::trim(SystemUtilities::read(path)), ranges, ",");
+
+    for (unsigned i = 0; i < ranges.size(); i++) {
+      vector<string> bounds;
+      String::tokenize(ranges[i], bounds, "-");
+      if (bounds.empty()) continue;
+
+      unsigned first = String::parseU32(bounds[0]);
+      unsigned last = bounds.size() == 2 ? String::parseU32(bounds[1]) : first;
+
+      for (unsigned cpu = first; cpu <= last; cpu++) cpus.push_back(cpu);
+    }
+
+    return cpus;
+  }
+#endif // __linux__
+
+  if (node) THROW("Invalid NUMA node " << node);
+
+  for (unsigned cpu = 0; cpu < getCPUCount(); cpu++) cpus.push_back(cpu);
+
+  return cpus;
+}
+
+
 uint64_t SystemInfo::getMemoryInfo(memory_info_t type) const {
 #if defined(_WIN32)
   MEMORYSTATUSEX info;
@@ -221,29 +304,37 @@ Version SystemInfo::getOSVersion() const {
 }
 
 
-void SystemInfo::add(Info &info) {
-  const char *category = "System";
+void SystemInfo::getInfo(values_t &values) {
+  auto add =
+    [&] (const string &key, const string &value) {
+      values.push_back(make_pair(key, value));
+    };
 
-  info.add(category, "CPU", getCPUBrand());
-  info.add(category, "CPU ID",
-           SSTR(getCPUVendor() << " Family " << getCPUFamily() << " Model "
-                << getCPUModel() << " Stepping " << getCPUStepping()));
-  info.add(category, "CPUs", String(getCPUCount()));
+  add("CPU", getCPUBrand());
+  add("CPU ID", SSTR(getCPUVendor() << " Family " << getCPUFamily()
+                     << " Model " << getCPUModel() << " Stepping "
+                     << getCPUStepping()));
+  add("CPUs", String(getCPUCount()));
 
-  info.add(category, "Memory", HumanSize(getTotalMemory()).toString() + "B");
-  info.add(category, "Free Memory",
-           HumanSize(getFreeMemory()).toString() + "B");
-  info.add(category, "Threads", getThreadsType().toString());
+  add("Memory", HumanSize(getTotalMemory()).toString() + "B");
+  add("Free Memory", HumanSize(getFreeMemory()).toString() + "B");
+  add("Threads", getThreadsType().toString());
 
   Version osVersion = getOSVersion();
-  info.add(category, "OS Version",
-           SSTR((unsigned)osVersion.getMajor() << '.'
-                << (unsigned)osVersion.getMinor()));
-
-  info.add(category, "Has Battery",
-           String(PowerManagement::instance().hasBattery()));
-  info.add(category, "On Battery",
-           String(PowerManagement::instance().onBattery()));
+  add("OS Version", SSTR((unsigned)osVersion.getMajor() << '.'
+                         << (unsigned)osVersion.getMinor()));
+
+  add("Has Battery", String(PowerManagement::instance().hasBattery()));
+  add("On Battery", String(PowerManagement::instance().onBattery()));
+}
+
+
+void SystemInfo::add(Info &info) {
+  values_t values;
+  getInfo(values);
+
+  for (unsigned i = 0; i < values.size(); i++)
+    info.add("System", values[i].first, values[i].second);
 }
 
 
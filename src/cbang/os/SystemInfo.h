@@ -62,6 +62,13 @@ namespace cb {
     SystemInfo(Inaccessible);
 
     uint32_t getCPUCount() const;
+
+    /// @return One logical CPU index for each physical core.
+    std::vector<unsigned> getCoreCPUs();
+    uint32_t getNUMANodeCount() const;
+    /// @return The logical CPU indices belonging to a NUMA node.
+    std::vector<unsigned> getNUMANodeCPUs(unsigned node) const;
+
     ThreadsType getThreadsType() {return threadsType;}
 
     uint64_t getMemoryInfo(memory_info_t type) const;
@@ -74,6 +81,9 @@ namespace cb {
 
     Version getOSVersion() const;
 
+    typedef std::vector<std::pair<std::string, std::string> > values_t;
+    /// Collect the "System" Info entries without touching Info
+    void getInfo(values_t &values);
     void add(Info &info);
 
   protected:
@@ -0,0 +1,300 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "SystemSampler.h"
+#include "SystemInfo.h"
+#include "SystemUtilities.h"
+
+#include <cbang/Catch.h>
+#include <cbang/String.h>
+#include <cbang/time/Timer.h>
+#include <cbang/json/Sink.h>
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <algorithm>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace cb;
+
+
+void SystemStats::write(JSON::Sink &sink) const {
+  sink.beginDict();
+  sink.insert("time", time);
+  sink.insert("interval", interval);
+
+  sink.insertDict("cpu");
+  sink.insert("usage", cpuUsage);
+  sink.insertList("cores");
+  for (auto usage: coreUsage) sink.append(usage);
+  sink.endList();
+  sink.endDict();
+
+  sink.insertDict("memory");
+  sink.insert("total", memoryTotal);
+  sink.insert("free", memoryFree);
+  sink.insert("usable", memoryUsable);
+  sink.insert("swap_free", swapFree);
+  sink.endDict();
+
+  sink.insertDict("disk_free");
+  for (auto &disk: diskFree) sink.insert(disk.first, disk.second);
+  sink.endDict();
+
+  sink.insertDict("network");
+  sink.insert("rx_bytes", netRxBytes);
+  sink.insert("tx_bytes", netTxBytes);
+  sink.insert("rx_rate", netRxRate);
+  sink.insert("tx_rate", netTxRate);
+  sink.endDict();
+
+  sink.insertDict("process");
+  sink.insert("cpu_time", processCPUTime);
+  sink.insert("cpu_usage", processCPUUsage);
+  sink.insert("rss", processRSS);
+  sink.insert("threads", processThreads);
+  sink.endDict();
+
+  sink.endDict();
+}
+
+
+SystemSampler::SystemSampler(double interval) :
+  interval(interval), current(0) {
+  readers[0] = readers[1] = 0;
+  setName("SystemSampler");
+}
+
+
+SystemSampler::~SystemSampler() {
+  stop();
+  join();
+}
+
+
+void SystemSampler::access(
+  const function<void (const SystemStats &)> &cb) const {
+  unsigned slot = acquire();
+
+  try {
+    cb(samples[slot]);
+  } catch (...) {
+    release(slot);
+    throw;
+  }
+
+  release(slot);
+}
+
+
+SystemStats SystemSampler::get() const {
+  SystemStats stats;
+  access([&] (const SystemStats &s) {stats = s;});
+  return stats;
+}
+
+
+void SystemSampler::start() {
+  SystemStats stats;
+  sample(stats);
+  publish(stats);
+
+  Thread::start();
+}
+
+
+void SystemSampler::write(JSON::Sink &sink) const {
+  access([&] (const SystemStats &s) {s.write(sink);});
+}
+
+
+unsigned SystemSampler::acquire() const {
+  while (true) {
+    unsigned slot = current.load();
+    readers[slot]++;
+
+    // The sampler may have moved on and started replacing this slot
+    if (current.load() == slot) return slot;
+    readers[slot]--;
+  }
+}
+
+
+namespace {
+  double usage(uint64_t busy, uint64_t total) {
+    return total ? min(1.0, (double)busy / total) : 0;
+  }
+}
+
+
+void SystemSampler::sample(SystemStats &stats) {
+  stats.time = Timer::now();
+  stats.interval = last.time ? stats.time - last.time : 0;
+
+  SystemInfo &info = SystemInfo::instance();
+  stats.memoryTotal = info.getTotalMemory();
+  stats.memoryFree = info.getFreeMemory();
+  stats.memoryUsable = info.getUsableMemory();
+  stats.swapFree = info.getFreeSwapMemory();
+
+  stats.diskFree.clear();
+  for (auto &path: disks)
+    try {
+      stats.diskFree.push_back(make_pair(path, info.getFreeDiskSpace(path)));
+    } CATCH_DEBUG(3);
+
+  stats.processCPUTime = SystemUtilities::getCPUTime();
+
+#ifdef __linux__
+  // Busy and total jiffies of all CPUs, then each CPU
+  vector<pair<uint64_t, uint64_t> > cpu;
+  ifstream stat("/proc/stat");
+  string line;
+
+  while (getline(stat, line) && !line.compare(0, 3, "cpu")) {
+    istringstream str(line.substr(line.find(' ')));
+    uint64_t total = 0;
+    uint64_t idle = 0;
+    uint64_t value;
+
+    // user nice system idle iowait irq softirq steal
+    for (unsigned i = 0; i < 8 && str >> value; i++) {
+      total += value;
+      if (i == 3 || i == 4) idle += value;
+    }
+
+    cpu.push_back(make_pair(total - idle, total));
+  }
+
+  stats.coreUsage.clear();
+  for (unsigned i = 0; i < cpu.size(); i++) {
+    double u = 0;
+
+    if (i < lastCPU.size())
+      u = usage(cpu[i].first - lastCPU[i].first,
+                cpu[i].second - lastCPU[i].second);
+
+    if (i) stats.coreUsage.push_back(u);
+    else stats.cpuUsage = u;
+  }
+
+  lastCPU = cpu;
+
+  // Interface counters
+  ifstream dev("/proc/net/dev");
+  stats.netRxBytes = stats.netTxBytes = 0;
+
+  while (getline(dev, line)) {
+    size_t colon = line.find(':');
+    if (colon == string::npos) continue; // Header
+
+    string name = line.substr(0, colon);
+    name.erase(0, name.find_first_not_of(' '));
+    if (name == "lo") continue;
+
+    istringstream str(line.substr(colon + 1));
+    uint64_t values[9] = {0};
+    for (unsigned i = 0; i < 9 && str >> values[i]; i++) continue;
+
+    stats.netRxBytes += values[0];
+    stats.netTxBytes += values[8];
+  }
+
+  // Process memory and threads
+  ifstream statm("/proc/self/statm");
+  uint64_t size = 0;
+  uint64_t resident = 0;
+  if (statm >> size >> resident)
+    stats.processRSS = resident * sysconf(_SC_PAGESIZE);
+
+  ifstream pstat("/proc/self/stat");
+  if (getline(pstat, line)) {
+    // Fields after the command name, which may contain spaces
+    istringstream str(line.substr(line.rfind(')') + 2));
+    string field;
+    for (unsigned i = 0; i < 18 && str >> field; i++)
+      if (i == 17) stats.processThreads = String::parseU32(field);
+  }
+#endif // __linux__
+
+  if (stats.interval) {
+    // Counters restart when interfaces are removed
+    if (last.netRxBytes <= stats.netRxBytes)
+      stats.netRxRate = (stats.netRxBytes - last.netRxBytes) / stats.interval;
+    if (last.netTxBytes <= stats.netTxBytes)
+      stats.netTxRate = (stats.netTxBytes - last.netTxBytes) / stats.interval;
+    stats.processCPUUsage =
+      (stats.processCPUTime - last.processCPUTime) / stats.interval;
+  }
+
+  last = stats;
+}
+
+
+void SystemSampler::publish(SystemStats &stats) {
+  unsigned next = !current.load();
+
+  // Readers only hold a sample briefly
+  while (readers[next].load()) this_thread::yield();
+
+  swap(samples[next], stats);
+  current.store(next);
+}
+
+
+void SystemSampler::run() {
+  double next = Timer::now() + interval;
+
+  while (!shouldShutdown()) {
+    double now = Timer::now();
+
+    if (now < next) {
+      // Sleep in steps so that stop() is not delayed by long intervals
+      Timer::sleep(min(next - now, 0.25));
+      continue;
+    }
+
+    next = max(next + interval, now);
+
+    try {
+      SystemStats stats;
+      sample(stats);
+      publish(stats);
+    } CATCH_ERROR;
+  }
+}
@@ -0,0 +1,130 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "Thread.h"
+
+#include <cbang/json/Serializable.h>
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <atomic>
+#include <functional>
+
+
+namespace cb {
+  /// One sample of SystemSampler.  Rates are over the previous interval.
+  struct SystemStats : public JSON::Serializable {
+    double time = 0;     ///< Timer::now() when sampled, zero if never
+    double interval = 0; ///< Seconds since the previous sample
+
+    double cpuUsage = 0; ///< All CPUs, from zero to one
+    std::vector<double> coreUsage; ///< Each logical CPU
+
+    uint64_t memoryTotal = 0;
+    uint64_t memoryFree = 0;
+    uint64_t memoryUsable = 0;
+    uint64_t swapFree = 0;
+
+    typedef std::vector<std::pair<std::string, uint64_t> > disks_t;
+    disks_t diskFree; ///< Free bytes at each path added to the sampler
+
+    uint64_t netRxBytes = 0; ///< All interfaces except loopback
+    uint64_t netTxBytes = 0;
+    double netRxRate = 0;    ///< Bytes per second
+    double netTxRate = 0;
+
+    double processCPUTime = 0;  ///< Seconds, see SystemUtilities
+    double processCPUUsage = 0; ///< CPUs used by this process
+    uint64_t processRSS = 0;    ///< Resident bytes
+    unsigned processThreads = 0;
+
+    // From JSON::Serializable
+    void write(JSON::Sink &sink) const;
+  };
+
+
+  /**
+   * Samples system and process metrics on its own thread so that callers,
+   * such as status pages, only read the latest sample.  Readers never
+   * block and never wait for the sampler, which instead waits for any
+   * reader still holding the older of its two samples before replacing it.
+   *
+   * CPU, network and process details other than CPU time are only sampled
+   * on Linux.  Elsewhere they are left zero.
+   */
+  class SystemSampler : public Thread, public JSON::Serializable {
+    double interval;
+    std::vector<std::string> disks;
+
+    SystemStats samples[2];
+    std::atomic<unsigned> current;
+    mutable std::atomic<unsigned> readers[2];
+
+    // Counters from the previous sample
+    std::vector<std::pair<uint64_t, uint64_t> > lastCPU;
+    SystemStats last;
+
+  public:
+    /// @param interval seconds between samples
+    SystemSampler(double interval = 1);
+    ~SystemSampler();
+
+    double getInterval() const {return interval;}
+
+    /// Must be called before start()
+    void addDisk(const std::string &path) {disks.push_back(path);}
+
+    /// Call @param cb with the latest sample, without copying it
+    void access(const std::function<void (const SystemStats &)> &cb) const;
+    SystemStats get() const;
+
+    /// Take the first sample then start the thread
+    void start();
+
+    // From JSON::Serializable
+    void write(JSON::Sink &sink) const;
+
+  protected:
+    unsigned acquire() const;
+    void release(unsigned slot) const {readers[slot]--;}
+
+    void sample(SystemStats &stats);
+    void publish(SystemStats &stats);
+
+    // From Thread
+    void run();
+  };
+}
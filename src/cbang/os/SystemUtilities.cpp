@@ -73,12 +73,20 @@
 #include <grp.h>
 #endif // _WIN32
 
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#include <linux/fs.h>
+#endif // __linux__
+
 #ifdef __FreeBSD__
 #include <sys/sysctl.h>
 #endif // __FeeBSD__
 
 #ifdef __APPLE__
 #include <mach-o/dyld.h>
+#include <sys/clonefile.h>
 #endif // __APPLE__
 
 #include <fcntl.h>
@@ -89,6 +97,7 @@
 #include <fstream>
 #include <iomanip>
 #include <vector>
+#include <algorithm>
 
 #define BOOST_SYSTEM_NO_DEPRECATED
 
@@ -102,6 +111,21 @@ using namespace cb::SystemUtilities;
 namespace fs = boost::filesystem;
 
 
+namespace {
+  const size_t copyBufferSize = 1 << 20;
+  const size_t copyStepSize = 1 << 23; // Bytes per progress callback
+
+
+#ifndef _WIN32
+  struct FDCloser {
+    int fd;
+    FDCloser(int fd) : fd(fd) {}
+    ~FDCloser() {::close(fd);}
+  };
+#endif
+}
+
+
 namespace cb {
   namespace SystemUtilities {
 #ifdef _WIN32
@@ -597,32 +621,143 @@ namespace cb {
     }
 
 
-    uint64_t cp(const string &src, const string &dst, uint64_t length) {
+#ifdef _WIN32
+    uint64_t cp(const string &src, const string &dst, uint64_t length,
+                const SmartPointer<TransferCallback> &callback) {
       SmartPointer<iostream> in = open(src, ios::in);
       SmartPointer<iostream> out = open(dst, ios::out | ios::trunc);
 
-      uint64_t bytes = cp(*in, *out, length);
+      uint64_t bytes = 0;
+      vector<char> buffer(copyBufferSize);
+
+      while (!in->fail() && !out->fail() && length) {
+        in->read(&buffer[0], min(length, (uint64_t)buffer.size()));
+        streamsize size = in->gcount();
+        if (!size) break;
+
+        out->write(&buffer[0], size);
+        bytes += size;
+        length -= size;
+
+        if (callback.isSet() && !callback->transferCallback(size)) break;
+      }
 
+      out->flush();
       if (out->fail())
         THROW("Failed to copy '" << src << "' to '" << dst << "'");
 
       return bytes;
     }
 
+#else // _WIN32
+    uint64_t cp(const string &src, const string &dst, uint64_t length,
+                const SmartPointer<TransferCallback> &callback) {
+      int in = ::open(src.c_str(), O_RDONLY);
+      if (in < 0) THROW("Failed to open '" << src << "': " << SysError());
+      FDCloser closeIn(in);
+
+      struct stat info;
+      if (fstat(in, &info))
+        THROW("Failed to stat '" << src << "': " << SysError());
+
+      uint64_t size = (uint64_t)info.st_size;
+      bool whole = S_ISREG(info.st_mode) && size <= length;
+
+      ensureDirectory(dirname(dst));
+
+#ifdef __APPLE__
+      // Clone the whole file if the destination does not exist yet
+      if (whole && !exists(dst) && !clonefile(src.c_str(), dst.c_str(), 0)) {
+        if (callback.isSet()) callback->transferCallback(size);
+        return size;
+      }
+#endif
+
+      int out = ::open(dst.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (out < 0) THROW("Failed to open '" << dst << "': " << SysError());
+      FDCloser closeOut(out);
+
+#if defined(__linux__) && defined(FICLONE)
+      // Share the source's extents on filesystems with reflinks
+      if (whole && !ioctl(out, FICLONE, in)) {
+        if (callback.isSet()) callback->transferCallback(size);
+        return size;
+      }
+#endif
+
+      uint64_t bytes = 0;
+      bool inKernel = S_ISREG(info.st_mode);
+      vector<char> buffer;
+
+      while (length) {
+        size_t count = min(length, (uint64_t)copyStepSize);
+        ssize_t ret = -1;
+
+#ifdef __linux__
+        if (inKernel) {
+#ifdef SYS_copy_file_range
+          ret = syscall(SYS_copy_file_range, in, 0, out, 0, count, 0);
+          // Older kernels or different filesystems
+          if (ret < 0 && !bytes &&
+              (errno == ENOSYS || errno == EXDEV || errno == EINVAL ||
+               errno == EOPNOTSUPP))
+#endif
+            ret = sendfile(out, in, 0, count);
+
+          // Pseudo files may report no data to the kernel copy
+          if (!bytes && (!ret || (ret < 0 && (errno == ENOSYS ||
+                                               errno == EINVAL))))
+            inKernel = false;
+        }
+#else
+        inKernel = false;
+#endif
+
+        if (!inKernel) {
+          if (buffer.empty()) buffer.resize(copyBufferSize);
+
+          ret = ::read(in, &buffer[0], min(count, buffer.size()));
+
+          for (ssize_t i = 0; 0 < ret && i < ret;) {
+            ssize_t n = ::write(out, &buffer[i], ret - i);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) {ret = -1; break;}
+            i += n;
+          }
+        }
+
+        if (ret < 0) {
+          if (errno == EINTR) continue;
+          THROW("Failed to copy '" << src << "' to '" << dst << "': "
+                << SysError());
+        }
+
+        if (!ret) break; // End of file
+
+        bytes += ret;
+        length -= ret;
+
+        if (callback.isSet() && !callback->transferCallback(ret)) break;
+      }
+
+      return bytes;
+    }
+#endif // _WIN32
+
 
     uint64_t cp(istream &in, ostream &out, uint64_t length) {
-      char buffer[4096];
+      vector<char> buffer(copyBufferSize);
       uint64_t bytes = 0;
 
       while (!in.fail() && !out.fail() && length) {
-        size_t size = 4096;
+        size_t size = buffer.size();
         if (length < size) size = length;
 
-        in.read(buffer, size);
+        in.read(&buffer[0], size);
 
         if ((size = in.gcount())) {
           bytes += size;
-          out.write(buffer, size);
+          out.write(&buffer[0], size);
           length -= size;
         }
       }
@@ -653,8 +788,8 @@ namespace cb {
     }
 
 
-    void rotate(const string &path, const string &dir, unsigned maxFiles) {
-      if (!exists(path)) return;
+    string rotate(const string &path, const string &dir, unsigned maxFiles) {
+      if (!exists(path)) return string();
 
       string target;
 
@@ -677,33 +812,45 @@ namespace cb {
       rename(path, target);
 
       // Remove old log files
-      if (maxFiles) {
-        string base = basename(path);
-        if (!ext.empty())
-          base = base.substr(0, base.length() - ext.length() - 1);
-
-        string searchDir;
-        if (dir.empty()) searchDir = dirname(path);
-        else searchDir = dir;
-
-        string pattern =  String::escapeRE(base) +
-          "-[0-9]{8}-[0-9]{6}\\." + String::escapeRE(ext);
-        DirectoryWalker walker(searchDir, pattern, 1);
-        set<string> files;
-
-        while (walker.hasNext()) files.insert(walker.next());
-
-        if (maxFiles < files.size()) {
-          unsigned count = files.size() - maxFiles;
-          set<string>::iterator it;
-          for (it = files.begin(); it != files.end() && count; it++) {
-            LOG_INFO(3, "Removing old file '" << *it << "'");
-            unlink(*it);
-            count--;
-          }
-        }
+      if (maxFiles) removeRotated(path, dir, maxFiles);
+
+      return target;
+    }
+
+
+    void removeRotated(const string &path, const string &dir,
+                       unsigned maxFiles, uint64_t maxBytes) {
+      string ext = extension(path);
+      string base = basename(path);
+      if (!ext.empty()) base = base.substr(0, base.length() - ext.length() - 1);
+
+      string searchDir;
+      if (dir.empty()) searchDir = dirname(path);
+      else searchDir = dir;
+
+      // Also match rotated files which have since been compressed
+      string pattern =  String::escapeRE(base) + "-[0-9]{8}-[0-9]{6}\\." +
+        String::escapeRE(ext) + "(\\.gz|\\.bz2)?";
+      DirectoryWalker walker(searchDir, pattern, 1);
+      set<string> files; // Oldest first
+      uint64_t bytes = 0;
+
+      while (walker.hasNext()) {
+        string file = walker.next();
+        if (maxBytes) bytes += getFileSize(file);
+        files.insert(file);
       }
 
+      unsigned count = files.size();
+      set<string>::iterator it;
+      for (it = files.begin(); it != files.end(); it++, count--) {
+        if ((!maxFiles || count <= maxFiles) &&
+            (!maxBytes || bytes <= maxBytes)) break;
+
+        if (maxBytes) bytes -= getFileSize(*it);
+        LOG_INFO(3, "Removing old file '" << *it << "'");
+        unlink(*it);
+      }
     }
 
 
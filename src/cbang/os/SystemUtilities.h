@@ -40,6 +40,7 @@
 #include <cbang/util/StringMap.h>
 
 #include <cbang/enum/ProcessPriority.h>
+#include <cbang/iostream/Transfer.h>
 
 #include <limits>
 
@@ -107,8 +108,16 @@ namespace cb {
     bool unlink(const std::string &filename);
     void symlink(const std::string &oldname, const std::string &newname);
     void link(const std::string &oldname, const std::string &newname);
+    /**
+     * Copy a file in the kernel where possible: by reflink, if the
+     * filesystem supports it, then copy_file_range() or sendfile() on
+     * Linux, otherwise through a large buffer.  @param callback is given
+     * the bytes copied by each step and may return false to stop early.
+     * @return The number of bytes copied.
+     */
     uint64_t cp(const std::string &src, const std::string &dst,
-                uint64_t length = ~0);
+                uint64_t length = ~0,
+                const SmartPointer<TransferCallback> &callback = 0);
     uint64_t cp(std::istream &in, std::ostream &out, uint64_t length = ~0);
     void rename(const std::string &src, const std::string &dst);
     SmartPointer<std::iostream>
@@ -122,8 +131,18 @@ namespace cb {
     std::string read(const std::string &filename, uint64_t length = ~0);
     void truncate(const std::string &path, unsigned long length);
     void chmod(const std::string &path, unsigned mode);
-    void rotate(const std::string &path, const std::string &dir = std::string(),
-                unsigned maxFiles = 0);
+    /// @return The rotated file name or an empty string if @param path
+    /// does not exist.
+    std::string rotate(const std::string &path,
+                       const std::string &dir = std::string(),
+                       unsigned maxFiles = 0);
+    /**
+     * Remove the oldest files rotated from @param path, including compressed
+     * ones, until no more than @param maxFiles and @param maxBytes remain.
+     * Zero means no limit.
+     */
+    void removeRotated(const std::string &path, const std::string &dir,
+                       unsigned maxFiles, uint64_t maxBytes = 0);
     int openModeToFlags(std::ios::openmode mode);
 
 
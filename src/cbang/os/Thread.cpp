@@ -52,6 +52,7 @@
 #else // pthreads
 #include <signal.h>
 #include <pthread.h>
+#include <sched.h>
 #include <errno.h>
 #endif
 
@@ -232,6 +233,7 @@ uint64_t Thread::self() {
 
 
 Thread &Thread::current() {return *threads.get();}
+Thread *Thread::getCurrent() {return threads.isSet() ? threads.get() : 0;}
 
 
 void Thread::starter() {
@@ -240,6 +242,7 @@ void Thread::starter() {
 
   try {
     Logger::instance().setThreadID(getID());
+    applySettings();
     LOG_INFO(5, "Started thread " << getID() << " on PID "
              << SystemUtilities::getPID());
     run();
@@ -270,3 +273,39 @@ void Thread::done() {
     } CATCH_ERROR;
   }
 }
+
+
+void Thread::applySettings() {
+  if (!name.empty()) {
+#if defined(__APPLE__)
+    pthread_setname_np(name.c_str());
+#elif defined(__linux__)
+    pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#endif
+  }
+
+  if (affinity.empty()) return;
+
+#if defined(_WIN32)
+  DWORD_PTR mask = 0;
+  for (unsigned i = 0; i < affinity.size(); i++)
+    if (affinity[i] < sizeof(mask) * 8) mask |= (DWORD_PTR)1 << affinity[i];
+
+  if (!SetThreadAffinityMask(GetCurrentThread(), mask))
+    LOG_WARNING("Failed to set thread " << id << " affinity: " << SysError());
+
+#elif defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (unsigned i = 0; i < affinity.size(); i++)
+    if (affinity[i] < CPU_SETSIZE) CPU_SET(affinity[i], &set);
+
+  int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  if (err)
+    LOG_WARNING("Failed to set thread " << id << " affinity: "
+                << SysError(err));
+
+#else
+  LOG_WARNING("Thread affinity not supported on this platform");
+#endif
+}
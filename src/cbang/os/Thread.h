@@ -35,6 +35,9 @@
 #include <cbang/StdTypes.h>
 #include <cbang/util/UniqueID.h>
 
+#include <string>
+#include <vector>
+
 namespace cb {
   template <typename T> class ThreadLocalStorage;
 
@@ -57,6 +60,8 @@ namespace cb {
     bool destroy;
     unsigned id;
     int exitStatus;
+    std::string name;
+    std::vector<unsigned> affinity;
 
     static ThreadLocalStorage<Thread *> threads;
 
@@ -103,6 +108,21 @@ namespace cb {
 
     int getExitStatus() const {return exitStatus;}
 
+    /**
+     * Set the name reported by the OS, e.g. in top or perf.  Linux truncates
+     * names to 15 characters.  Takes effect when the thread is started.
+     */
+    void setName(const std::string &name) {this->name = name;}
+    const std::string &getName() const {return name;}
+
+    /**
+     * Restrict the thread to the listed logical CPUs.  An empty list allows
+     * all CPUs.  Takes effect when the thread is started.  Not supported on
+     * OS X.
+     */
+    void setAffinity(const std::vector<unsigned> &cpus) {affinity = cpus;}
+    const std::vector<unsigned> &getAffinity() const {return affinity;}
+
     /**
      * When true the thread routine should exit as soon as possible.
      * @return True if a call to stop() has signaled this thread should end.
@@ -121,6 +141,8 @@ namespace cb {
     static uint64_t self();
 
     static Thread &current();
+    /// @return The calling Thread or null if it was not started by a Thread
+    static Thread *getCurrent();
 
     /// This function is used internally to start the thread.
     virtual void starter();
@@ -134,6 +156,9 @@ namespace cb {
 
     /// Called just before thread exit
     virtual void done();
+
+    /// Apply name and affinity from the running thread
+    void applySettings();
   };
 
 
@@ -0,0 +1,152 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "ThreadLocalStorage.h"
+#include "Mutex.h"
+
+#include <cbang/SmartPointer.h>
+#include <cbang/Exception.h>
+#include <cbang/util/SmartLock.h>
+
+#include <functional>
+#include <set>
+
+
+namespace cb {
+  /**
+   * A value per thread which other threads can visit, e.g. counters which
+   * are updated without contention and summed when reported, or per
+   * thread free lists.  get() is lock free after a thread's first call.
+   *
+   * When a thread exits its value is folded into a retired value with the
+   * merge function, if one was given, so totals are not lost.  Values are
+   * visited while their threads may be updating them, so members which
+   * are read this way should be std::atomic.
+   */
+  template <typename T>
+  class ThreadCache {
+  public:
+    typedef std::function<void (T &into, const T &from)> merge_t;
+
+  protected:
+    struct registry_t {
+      Mutex lock;
+      std::set<T *> values;
+      T retired;
+      merge_t merge;
+    };
+
+    typedef typename SmartPointer<registry_t>::Protected registry_ptr_t;
+
+    struct entry_t {
+      T value;
+      registry_ptr_t registry;
+
+      entry_t(const registry_ptr_t &registry) : value(), registry(registry) {}
+    };
+
+    const unsigned index;
+    registry_ptr_t registry;
+
+
+    static void destroy(void *ptr) {
+      entry_t *entry = (entry_t *)ptr;
+      registry_t &reg = *entry->registry;
+
+      {
+        SmartLock lock(&reg.lock);
+        reg.values.erase(&entry->value);
+        if (reg.merge) reg.merge(reg.retired, entry->value);
+      }
+
+      delete entry;
+    }
+
+  public:
+    ThreadCache(merge_t merge = 0) :
+      index(ThreadLocalSlots::allocate()), registry(new registry_t) {
+      registry->merge = merge;
+    }
+
+    ThreadCache(const ThreadCache &) = delete;
+    ThreadCache &operator=(const ThreadCache &) = delete;
+
+
+    /// @return The calling thread's value
+    T &get() {
+      ThreadLocalSlots::slot_t *slot = ThreadLocalSlots::find(index);
+      if (slot) return ((entry_t *)slot->value)->value;
+
+      entry_t *entry = new entry_t(registry);
+      {
+        SmartLock lock(&registry->lock);
+        registry->values.insert(&entry->value);
+      }
+
+      ThreadLocalSlots::slot_t &s = ThreadLocalSlots::get(index);
+      s.value = entry;
+      s.destroy = destroy;
+
+      return entry->value;
+    }
+
+    T &operator*() {return get();}
+    T *operator->() {return &get();}
+
+
+    /// Call @param cb with the retired value then each live thread's value
+    void forEach(std::function<void (const T &)> cb) const {
+      SmartLock lock(&registry->lock);
+      cb(registry->retired);
+      for (auto value: registry->values) cb(*value);
+    }
+
+
+    /// Merge all values into @param total, requires a merge function
+    void aggregate(T &total) const {
+      SmartLock lock(&registry->lock);
+      if (!registry->merge) CBANG_THROW("ThreadCache has no merge function");
+
+      registry->merge(total, registry->retired);
+      for (auto value: registry->values) registry->merge(total, *value);
+    }
+
+
+    T aggregate() const {
+      T total = T();
+      aggregate(total);
+      return total;
+    }
+  };
+}
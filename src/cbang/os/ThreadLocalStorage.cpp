@@ -0,0 +1,97 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "ThreadLocalStorage.h"
+
+#include <atomic>
+
+using namespace cb;
+
+
+namespace {
+  std::atomic<unsigned> nextIndex(0);
+
+  // A plain pointer stays valid while other thread_local objects are
+  // destroyed, the guard frees the slots once the thread exits.
+  thread_local ThreadLocalSlots *current = 0;
+
+  struct Guard {
+    ~Guard() {
+      ThreadLocalSlots *slots = current;
+      current = 0; // Values see a fresh table if they use storage
+      delete slots;
+    }
+  };
+
+  thread_local Guard guard;
+}
+
+
+ThreadLocalSlots::~ThreadLocalSlots() {
+  for (unsigned i = 0; i < slots.size(); i++)
+    if (slots[i].value) slots[i].destroy(slots[i].value);
+}
+
+
+unsigned ThreadLocalSlots::allocate() {return nextIndex++;}
+
+
+ThreadLocalSlots::slot_t *ThreadLocalSlots::find(unsigned index) {
+  ThreadLocalSlots *slots = current;
+  if (!slots || slots->slots.size() <= index) return 0;
+
+  slot_t *slot = &slots->slots[index];
+  return slot->value ? slot : 0;
+}
+
+
+ThreadLocalSlots::slot_t &ThreadLocalSlots::get(unsigned index) {
+  if (!current) {
+    (void)&guard; // Construct the guard
+    current = new ThreadLocalSlots;
+  }
+
+  std::vector<slot_t> &slots = current->slots;
+  if (slots.size() <= index) slots.resize(index + 1, slot_t{0, 0});
+
+  return slots[index];
+}
+
+
+void ThreadLocalSlots::release(unsigned index) {
+  slot_t *slot = find(index);
+  if (!slot) return;
+
+  void *value = slot->value;
+  slot->value = 0;
+  slot->destroy(value);
+}
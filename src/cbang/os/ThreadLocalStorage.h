@@ -32,63 +32,95 @@
 
 #pragma once
 
-#include "Mutex.h"
-#include "Thread.h"
+#include <vector>
 
-#include <cbang/StdTypes.h>
 
-#include <cbang/util/SmartLock.h>
+namespace cb {
+  /**
+   * The slots of the calling thread shared by every ThreadLocalStorage and
+   * ThreadCache.  Each instance allocates an index once and finds its value
+   * through a thread_local table without locking.  Values are destroyed
+   * when their thread exits.
+   */
+  class ThreadLocalSlots {
+  public:
+    typedef void (*destroy_t)(void *value);
 
-#include <map>
+    struct slot_t {
+      void *value;
+      destroy_t destroy;
+    };
 
-namespace cb {
-  template <typename T>
-  class ThreadLocalStorage : public Mutex {
   protected:
-    typedef std::map<uint64_t, T> storage_t;
-    storage_t storage;
+    std::vector<slot_t> slots;
 
   public:
-    T &get() {
-      SmartLock lock(this);
+    ~ThreadLocalSlots();
 
-      typename storage_t::iterator it = storage.find(Thread::self());
-      if (it == storage.end())
-        it = storage.insert
-          (typename storage_t::value_type(Thread::self(), T())).first;
+    /// Indices are never reused, so stale values cannot be seen
+    static unsigned allocate();
 
-      return it->second;
-    }
+    /// @return The calling thread's slot or 0 if it was never set
+    static slot_t *find(unsigned index);
+    /// @return The calling thread's slot, created if necessary
+    static slot_t &get(unsigned index);
+    /// Destroy the calling thread's value, if any
+    static void release(unsigned index);
+  };
 
-    T &get(T defaultValue) {
-      SmartLock lock(this);
 
-      typename storage_t::iterator it = storage.find(Thread::self());
-      if (it == storage.end())
-        it = storage.insert
-          (typename storage_t::value_type(Thread::self(), defaultValue)).first;
+  /**
+   * A value per thread.  Access is lock free.  Values of a destroyed
+   * instance live on until their threads exit.
+   */
+  template <typename T>
+  class ThreadLocalStorage {
+    const unsigned index;
+
+    static void destroy(void *value) {delete (T *)value;}
 
-      return it->second;
+
+    T *find() const {
+      ThreadLocalSlots::slot_t *slot = ThreadLocalSlots::find(index);
+      return slot ? (T *)slot->value : 0;
     }
 
-    bool isSet() const {
-      SmartLock lock(this);
-      return storage.find(Thread::self()) != storage.end();
+
+    T &create(const T &value) {
+      ThreadLocalSlots::slot_t &slot = ThreadLocalSlots::get(index);
+      slot.value = new T(value);
+      slot.destroy = destroy;
+      return *(T *)slot.value;
     }
 
-    void set(const T &value) {
-      SmartLock lock(this);
+  public:
+    ThreadLocalStorage() : index(ThreadLocalSlots::allocate()) {}
+    ThreadLocalStorage(const ThreadLocalStorage &) = delete;
+    ThreadLocalStorage &operator=(const ThreadLocalStorage &) = delete;
+
 
-      typename storage_t::iterator it = storage.find(Thread::self());
-      if (it == storage.end())
-        storage.insert(typename storage_t::value_type(Thread::self(), value));
-      else it->second = value;
+    T &get() {
+      T *value = find();
+      return value ? *value : create(T());
     }
 
-    void clear() {
-      SmartLock lock(this);
-      typename storage_t::iterator it = storage.find(Thread::self());
-      if (it != storage.end()) storage.erase(it);
+
+    T &get(T defaultValue) {
+      T *value = find();
+      return value ? *value : create(defaultValue);
     }
+
+
+    bool isSet() const {return find();}
+
+
+    void set(const T &value) {
+      T *current = find();
+      if (current) *current = value;
+      else create(value);
+    }
+
+
+    void clear() {ThreadLocalSlots::release(index);}
   };
 }
@@ -31,14 +31,46 @@
 \******************************************************************************/
 
 #include "ThreadPool.h"
+#include "SystemInfo.h"
+
+#include <cbang/String.h>
 
 using namespace cb;
 using namespace std;
 
 
 ThreadPool::ThreadPool(unsigned size) {
+  bool physical = size == PHYSICAL_CORES;
+  if (physical) size = SystemInfo::instance().getCoreCPUs().size();
+
   for (unsigned i = 0; i < size; i++)
     pool.push_back(new ThreadFunc<ThreadPool>(this, &ThreadPool::run));
+
+  if (physical) pinPhysicalCores();
+}
+
+
+void ThreadPool::setNames(const string &prefix) {
+  for (unsigned i = 0; i < pool.size(); i++)
+    pool[i]->setName(prefix + String(i));
+}
+
+
+void ThreadPool::setAffinity(const vector<unsigned> &cpus, bool pin) {
+  for (unsigned i = 0; i < pool.size(); i++)
+    if (pin && !cpus.empty())
+      pool[i]->setAffinity(vector<unsigned>(1, cpus[i % cpus.size()]));
+    else pool[i]->setAffinity(cpus);
+}
+
+
+void ThreadPool::bindNUMANode(unsigned node) {
+  setAffinity(SystemInfo::instance().getNUMANodeCPUs(node), false);
+}
+
+
+void ThreadPool::pinPhysicalCores() {
+  setAffinity(SystemInfo::instance().getCoreCPUs());
 }
 
 
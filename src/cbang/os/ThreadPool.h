@@ -36,6 +36,7 @@
 
 #include <cbang/SmartPointer.h>
 
+#include <string>
 #include <vector>
 
 
@@ -46,9 +47,30 @@ namespace cb {
     pool_t pool;
 
   public:
+    /// Pass as size to start one thread per physical core, each pinned
+    static const unsigned PHYSICAL_CORES = ~0U;
+
     ThreadPool(unsigned size);
     virtual ~ThreadPool() {}
 
+    unsigned getSize() const {return pool.size();}
+
+    /// Name threads "<prefix><index>" for tools like top and perf.
+    void setNames(const std::string &prefix);
+
+    /**
+     * Set thread CPU affinity.  If pin is true thread i is pinned to
+     * cpus[i % cpus.size()], otherwise every thread may run on any of the
+     * listed CPUs.  Must be called before start().
+     */
+    void setAffinity(const std::vector<unsigned> &cpus, bool pin = true);
+
+    /// Restrict all threads to the CPUs of a NUMA node.
+    void bindNUMANode(unsigned node);
+
+    /// Pin each thread to a different physical core as far as possible.
+    void pinPhysicalCores();
+
     virtual void start();
     virtual void stop();
     virtual void join();
@@ -0,0 +1,96 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "PacketArrayField.h"
+#include "FPPacketField.h"
+
+namespace cb {
+  /***
+   * An array of floating point values stored as byte swapped fixed point
+   * packet fields.
+   */
+  template <typename INT_T, unsigned MULTIPLIER, typename EXT_T>
+  class FPPacketArrayField : public PacketArrayField<INT_T, EXT_T> {
+  public:
+    typedef PacketArrayField<INT_T, EXT_T> Super;
+    typedef FPPacketField<INT_T, MULTIPLIER, EXT_T> field_t;
+
+    FPPacketArrayField(void *data, unsigned length) : Super(data, length) {}
+
+    field_t operator[](unsigned i) const {return field_t(Super::data + i);}
+    EXT_T get(unsigned i) const {return (*this)[i].get();}
+
+    void get(EXT_T *values, unsigned count, unsigned offset = 0) const {
+      Super::check(offset, count);
+      INT_T buf[256];
+
+      for (unsigned i = 0; i < count; i += 256) {
+        unsigned n = std::min(256U, count - i);
+        htonArray(buf, Super::data + offset + i, n);
+        for (unsigned j = 0; j < n; j++)
+          values[i + j] = (EXT_T)buf[j] / MULTIPLIER;
+      }
+    }
+
+    void set(const EXT_T *values, unsigned count, unsigned offset = 0) {
+      Super::check(offset, count);
+      INT_T buf[256];
+
+      for (unsigned i = 0; i < count; i += 256) {
+        unsigned n = std::min(256U, count - i);
+        for (unsigned j = 0; j < n; j++)
+          buf[j] = (INT_T)(values[i + j] * MULTIPLIER);
+        htonArray(Super::data + offset + i, buf, n);
+      }
+    }
+
+    // The raw fixed point values are not useful as a view
+    const INT_T *view() const = delete;
+  };
+
+  typedef FPPacketArrayField<int16_t,  100, float>  PFS16F2Array;
+  typedef FPPacketArrayField<uint16_t, 100, float>  PFU16F2Array;
+  typedef FPPacketArrayField<int32_t,  100, double> PFS32F2Array;
+  typedef FPPacketArrayField<uint32_t, 100, double> PFU32F2Array;
+  typedef FPPacketArrayField<int64_t,  100, double> PFS64F2Array;
+  typedef FPPacketArrayField<uint64_t, 100, double> PFU64F2Array;
+
+  typedef FPPacketArrayField<int16_t,  1000, float>  PFS16F3Array;
+  typedef FPPacketArrayField<uint16_t, 1000, float>  PFU16F3Array;
+  typedef FPPacketArrayField<int32_t,  1000, double> PFS32F3Array;
+  typedef FPPacketArrayField<uint32_t, 1000, double> PFU32F3Array;
+  typedef FPPacketArrayField<int64_t,  1000, double> PFS64F3Array;
+  typedef FPPacketArrayField<uint64_t, 1000, double> PFU64F3Array;
+}
@@ -96,6 +96,12 @@ Packet::Packet(const DB::Blob &blob) :
 }
 
 
+Packet::Packet(SliceBuffer &buf) :
+  data((char *)buf.pullup()), size(buf.getLength()), deallocate(false) {
+  if (data) block = buf.begin()->block;
+}
+
+
 Packet::~Packet() {
   if (deallocate && data) {
     free(data);
@@ -111,6 +117,7 @@ Packet &Packet::operator=(const Packet &o) {
   size = o.size;
   memcpy(data, o.data, size);
   deallocate = true;
+  block.release();
   return *this;
 }
 
@@ -120,6 +127,7 @@ void Packet::set(char *data, unsigned size, bool deallocate) {
   this->data = data;
   this->size = size;
   this->deallocate = deallocate;
+  block.release();
 }
 
 
@@ -128,6 +136,7 @@ void Packet::steal(Packet &packet) {
   data = packet.data;
   size = packet.size;
   deallocate = packet.deallocate;
+  block = packet.block;
   packet.deallocate = false;
 }
 
@@ -137,6 +146,15 @@ void Packet::copy(Packet &packet) {
 }
 
 
+char *Packet::getSpan(unsigned offset, unsigned bytes) {
+  if (size < offset || size - offset < bytes)
+    THROW("Packet span [" << offset << ", " << (uint64_t)offset + bytes
+          << ") out of range [0, " << size << ")");
+
+  return data + offset;
+}
+
+
 void Packet::increase(unsigned capacity) {
   if (capacity && capacity < size) return;
 
@@ -159,4 +177,5 @@ void Packet::increase(unsigned capacity) {
   data = newData;
   size = newSize;
   deallocate = true;
+  block.release();
 }
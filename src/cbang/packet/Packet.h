@@ -34,9 +34,13 @@
 
 #include "PacketField.h"
 #include "FPPacketField.h"
+#include "PacketArrayField.h"
+#include "FPPacketArrayField.h"
 #include "StringPacketField.h"
 #include "EnumerationPacketField.h"
 
+#include <cbang/buffer/SliceBuffer.h>
+
 #include <ostream>
 #include <string>
 
@@ -50,6 +54,7 @@ namespace cb {
     char *data;
     unsigned size;
     bool deallocate;
+    SliceBuffer::BlockPtr block;
 
   public:
     Packet();
@@ -57,6 +62,12 @@ namespace cb {
     Packet(char *data, unsigned size, bool deallocate = false);
     Packet(const std::string &s);
     Packet(const DB::Blob &blob);
+    /**
+     * Reference the contents of @param buf without copying them, unless
+     * they must first be made contiguous.  The packet's data is shared with
+     * any other buffer referencing the same memory.
+     */
+    Packet(SliceBuffer &buf);
     Packet(const Packet &o);
     Packet(Packet &o, bool steal = false);
     virtual ~Packet();
@@ -74,6 +85,21 @@ namespace cb {
 
     void clear() {if (data) memset(data, 0, size);}
 
+    /// @return @param bytes of data at @param offset, throws if out of range
+    char *getSpan(unsigned offset, unsigned bytes);
+
+    /**
+     * Access @param length fields of an array type, such as PFU32Array,
+     * at @param offset bytes.
+     */
+    template <typename ARRAY_T>
+    ARRAY_T getArray(unsigned offset, unsigned length) {
+      typedef typename ARRAY_T::int_t int_t;
+      unsigned bytes = length <= ~0U / sizeof(int_t) ?
+        length * sizeof(int_t) : ~0U;
+      return ARRAY_T(getSpan(offset, bytes), length);
+    }
+
     virtual std::ostream &print(std::ostream &stream) const {return stream;}
   };
 
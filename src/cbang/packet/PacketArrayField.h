@@ -0,0 +1,131 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "PacketField.h"
+
+#include <cbang/Exception.h>
+#include <cbang/net/SwabArray.h>
+
+#include <algorithm>
+#include <type_traits>
+
+namespace cb {
+  /***
+   * An array of byte swapped packet fields.  Spans of values are converted
+   * at once with vectorized byte swapping rather than one field at a time.
+   */
+  template <typename INT_T, typename EXT_T = INT_T>
+  class PacketArrayField {
+  public:
+    typedef INT_T int_t;
+    typedef EXT_T ext_t;
+    typedef PacketField<INT_T, EXT_T> field_t;
+
+  protected:
+    INT_T *data;
+    const unsigned length;
+
+  public:
+    PacketArrayField(void *data, unsigned length) :
+      data((INT_T *)data), length(length) {}
+
+    unsigned getLength() const {return length;}
+
+    field_t operator[](unsigned i) const {return field_t(data + i);}
+    EXT_T get(unsigned i) const {return (*this)[i].get();}
+
+    /// Convert @param count values starting at @param offset to host order
+    void get(EXT_T *values, unsigned count, unsigned offset = 0) const {
+      check(offset, count);
+
+      if (std::is_same<INT_T, EXT_T>::value)
+        htonArray((INT_T *)values, data + offset, count);
+
+      else {
+        INT_T buf[256];
+
+        for (unsigned i = 0; i < count; i += 256) {
+          unsigned n = std::min(256U, count - i);
+          htonArray(buf, data + offset + i, n);
+          for (unsigned j = 0; j < n; j++) values[i + j] = (EXT_T)buf[j];
+        }
+      }
+    }
+
+    /// Store @param count values in network order starting at @param offset
+    void set(const EXT_T *values, unsigned count, unsigned offset = 0) {
+      check(offset, count);
+
+      if (std::is_same<INT_T, EXT_T>::value)
+        htonArray(data + offset, (const INT_T *)values, count);
+
+      else {
+        INT_T buf[256];
+
+        for (unsigned i = 0; i < count; i += 256) {
+          unsigned n = std::min(256U, count - i);
+          for (unsigned j = 0; j < n; j++) buf[j] = (INT_T)values[i + j];
+          htonArray(data + offset + i, buf, n);
+        }
+      }
+    }
+
+    /// Convert the whole array to or from host order in place
+    void swab() {htonArray(data, data, length);}
+
+    /// True if the host is in network byte order so view() is usable
+    static bool isHostOrder()
+    {return sizeof(INT_T) == 1 || BYTE_ORDER == BIG_ENDIAN;}
+
+    /// The values in place, without copying, if isHostOrder() otherwise null
+    const INT_T *view() const {return isHostOrder() ? data : 0;}
+
+  protected:
+    void check(unsigned offset, unsigned count) const {
+      if (length < offset || length - offset < count)
+        THROW("Packet array access [" << offset << ", "
+              << (uint64_t)offset + count
+              << ") out of range [0, " << length << ")");
+    }
+  };
+
+
+  typedef PacketArrayField<int16_t>  PFS16Array;
+  typedef PacketArrayField<uint16_t> PFU16Array;
+  typedef PacketArrayField<int32_t>  PFS32Array;
+  typedef PacketArrayField<uint32_t> PFU32Array;
+  typedef PacketArrayField<int64_t>  PFS64Array;
+  typedef PacketArrayField<uint64_t> PFU64Array;
+}
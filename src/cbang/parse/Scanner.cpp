@@ -34,11 +34,25 @@
 
 #include <cbang/Exception.h>
 #include <cbang/String.h>
+#include <cbang/util/ByteScan.h>
+
+#include <algorithm>
+#include <cstring>
+
 
 using namespace cb;
 using namespace std;
 
 
+namespace {
+  bool contains(const int *s, int c) {
+    for (; *s; s++)
+      if (*s == c) return true;
+    return false;
+  }
+}
+
+
 int Scanner::defaultWS[6] = {0x20, 0x09, 0x0d, 0x0a, 0xfeff, 0};
 
 
@@ -46,9 +60,18 @@ Scanner::Scanner(const InputSource &source) : x(-2), source(source) {
   location.setCol(-1);
   location.setLine(1);
   if (!source.getName().empty()) location.setFilename(source.getName());
+
+  if (source.getData()) {
+    start = current = ptr = indexed = lineStart = counted = source.getData();
+    end = start + source.getLength();
+  }
 }
 
 
+Scanner::Scanner(const char *data, unsigned length, const string &name) :
+  Scanner(InputSource(data, length, name)) {}
+
+
 bool Scanner::hasMore() {
   if (x == -2) advance();
   return x != -1;
@@ -61,6 +84,8 @@ int Scanner::peek() {
 
 
 void Scanner::advance() {
+  if (start) return setPosition(ptr);
+
   x = next();
 
   switch (x) {
@@ -99,6 +124,8 @@ bool Scanner::consume(int c) {
 
 
 string Scanner::seek(const int *s, bool inverse, bool skip) {
+  if (start) return seekBuffer(s, inverse, skip);
+
   string buffer;
 
   while (hasMore()) {
@@ -156,3 +183,125 @@ int Scanner::next() {
 
   return x;
 }
+
+
+int Scanner::decode(const char *&p) const {
+  // Same as next() but from the buffer
+  int x = (uint8_t)*p++;
+
+  int width = 0;
+  if ((x & 0xe0) == 0xc0) width = 1;
+  else if ((x & 0xf0) == 0xe0) width = 2;
+  else if ((x & 0xf8) == 0xf0) width = 3;
+
+  if (width) {
+    bool extractedChars = false;
+    uint32_t utf8 = x & ((1 << (6 - width)) - 1);
+
+    for (int i = 0; i < width && p < end; i++) {
+      int c = (uint8_t)*p;
+
+      if ((c & 0xc0) != 0x80) break; // Not UTF-8
+
+      utf8 = (utf8 << 6) | (c & 0x3f);
+
+      p++;
+      extractedChars = true;
+
+      if (i == width - 1) return utf8;
+    }
+
+    if (extractedChars) THROW("Invalid UTF-8 data");
+  }
+
+  return x;
+}
+
+
+void Scanner::setPosition(const char *p) {
+  current = ptr = p;
+  x = p < end ? decode(ptr) : -1;
+}
+
+
+string Scanner::seekBuffer(const int *s, bool inverse, bool skip) {
+  if (x == -2) advance();
+
+  // ASCII members of the set as a bit table
+  uint64_t table[2] = {0, 0};
+  bool nonASCII = false;
+  unsigned n = 0;
+  char first[2] = {0, 0};
+
+  for (const int *c = s; *c; c++)
+    if (0 <= *c && *c < 0x80) {
+      table[*c >> 6] |= (uint64_t)1 << (*c & 63);
+      if (n < 2) first[n] = *c;
+      n++;
+
+    } else nonASCII = true;
+
+  const char *begin = current;
+
+  while (x != -1) {
+    const char *p = current;
+
+    if (!inverse && !nonASCII && n <= 2) {
+      // Stop only at one or two ASCII characters
+      if (!n) p = end;
+      else if (n == 1) {
+        p = (const char *)memchr(p, first[0], end - p);
+        if (!p) p = end;
+
+      } else p = scanForEither(p, end, first[0], first[1]);
+
+    } else
+      for (; p < end; p++) {
+        uint8_t c = *p;
+        if (0x80 <= c) break;
+        if (((table[c >> 6] >> (c & 63)) & 1) != inverse) break;
+      }
+
+    if (p != current) setPosition(p);
+
+    // Stopped at the end, at an ASCII character or to check a code point
+    if (x < 0x80 || contains(s, x) != inverse) break;
+
+    advance();
+  }
+
+  return skip ? string() : string(begin, current);
+}
+
+
+void Scanner::updateLocation() const {
+  if (!start || x == -2) return;
+
+  const char *p = x == -1 ? end : current;
+
+  // Extend the newline index through p
+  const char *limit = p < end ? p + 1 : end;
+  while (indexed < limit) {
+    const char *nl = (const char *)memchr(indexed, '\n', limit - indexed);
+    if (!nl) {indexed = limit; break;}
+
+    newlines.push_back(nl);
+    indexed = nl + 1;
+  }
+
+  unsigned line =
+    upper_bound(newlines.begin(), newlines.end(), p) - newlines.begin();
+  const char *ls = line ? newlines[line - 1] : start;
+
+  // Count code points, except '\r', from the line start
+  if (ls != lineStart || p < counted) {
+    lineStart = counted = ls;
+    count = 0;
+  }
+
+  for (; counted < p; counted++)
+    if ((*counted & 0xc0) != 0x80 && *counted != '\r') count++;
+
+  location.setLine(line + 1);
+  location.setCol(count + (x == '\r' ? 0 : 1) - 1);
+}
@@ -35,19 +35,44 @@
 #include <cbang/FileLocation.h>
 #include <cbang/io/InputSource.h>
 
+#include <vector>
+
 namespace cb {
+  /**
+   * Reads UTF-8 code points from an InputSource.  Sources which provide
+   * their data as one contiguous buffer, such as memory or mapped files,
+   * are scanned in place.  Then seek() passes over runs of ASCII with a
+   * lookup table, or memchr() and SSE2 when it stops at one or two ASCII
+   * characters, and the location is only computed when requested, from an
+   * index of the newlines seen so far.
+   */
   class Scanner {
     int x;
     InputSource source;
-    FileLocation location;
+    mutable FileLocation location;
+
+    // Set when scanning a contiguous buffer
+    const char *start = 0;
+    const char *end = 0;
+    const char *current = 0; // The location of x
+    const char *ptr = 0;     // After x
+
+    mutable std::vector<const char *> newlines;
+    mutable const char *indexed = 0;
+    mutable const char *lineStart = 0;
+    mutable const char *counted = 0;
+    mutable unsigned count = 0;
 
   public:
     static int defaultWS[6];
 
     Scanner(const InputSource &source);
+    Scanner(const char *data, unsigned length,
+            const std::string &name = "<memory>");
 
-    FileLocation &getLocation() {return location;}
-    const FileLocation &getLocation() const {return location;}
+    FileLocation &getLocation() {updateLocation(); return location;}
+    const FileLocation &getLocation() const
+      {updateLocation(); return location;}
 
     bool hasMore();
     int peek();
@@ -59,5 +84,9 @@ namespace cb {
 
   protected:
     int next();
+    int decode(const char *&p) const;
+    void setPosition(const char *p);
+    std::string seekBuffer(const int *s, bool inverse, bool skip);
+    void updateLocation() const;
   };
 }
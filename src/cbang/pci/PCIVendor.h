@@ -34,30 +34,21 @@
 
 #include <cbang/StdTypes.h>
 
-#include <string>
-#include <set>
-
 
 namespace cb {
   class PCIVendor {
     uint16_t id;
     const char *name;
 
-    typedef std::set<PCIVendor> vendors_t;
-    static vendors_t vendors;
-
   public:
-    PCIVendor(uint16_t id, const char *name) : id(id), name(name) {}
+    constexpr PCIVendor(uint16_t id, const char *name) : id(id), name(name) {}
 
     uint16_t getID() const {return id;}
     const char *getName() const {return name;}
 
     bool operator<(const PCIVendor &v) const {return id < v.id;}
 
+    /// Binary search of the static vendor table
     static const PCIVendor *find(uint16_t id);
-
-  private:
-    static void add(uint16_t id, const char *name);
-    static void load();
   };
 }
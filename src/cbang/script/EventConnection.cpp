@@ -0,0 +1,191 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "EventConnection.h"
+#include "EventServer.h"
+
+#include <cbang/event/ConcurrentPool.h>
+#include <cbang/log/Logger.h>
+
+#include <sstream>
+
+using namespace std;
+using namespace cb;
+using namespace cb::Script;
+
+
+#undef CBANG_LOG_PREFIX
+#define CBANG_LOG_PREFIX << "SCRIPT" << getID() << ':'
+
+
+class EventConnection::Task :
+  public Event::ConcurrentPool::QueuedTask<string>, public streambuf {
+  SmartPointer<EventConnection> con;
+  string line;
+
+  static const unsigned bufferSize = 4096;
+  char buffer[bufferSize];
+
+public:
+  Task(EventConnection &con, const string &line) :
+    QueuedTask<string>(con.server.getBase(), 0), con(&con), line(line) {
+    setp(buffer, buffer + bufferSize);
+  }
+
+
+  // From streambuf
+  int overflow(int c) {
+    sync();
+
+    if (c != EOF) {
+      *pptr() = c;
+      pbump(1);
+    }
+
+    return c == EOF ? 0 : c;
+  }
+
+
+  int sync() {
+    if (pbase() != pptr()) {
+      enqueue(string(pbase(), pptr()));
+      setp(buffer, buffer + bufferSize);
+    }
+
+    return 0;
+  }
+
+
+  // From Task, in the pool
+  void run() {
+    ostream out(this);
+    con->execute(line, out);
+    con->update(Context(*con, out));
+    out.flush();
+  }
+
+
+  // From QueuedTask, on the event loop
+  void process(string data) {
+    if (!con->closed) con->getOutput().add(data);
+  }
+
+
+  void complete() {
+    dequeue();
+    QueuedTask<string>::complete();
+    con->commandDone();
+  }
+};
+
+
+EventConnection::EventConnection(EventServer &server,
+                                 const SmartPointer<Socket> &socket,
+                                 const IPAddress &peer,
+                                 const SmartPointer<SSLContext> &sslCtx) :
+  BufferEvent(server.getBase(), true, socket, sslCtx), server(server),
+  peer(peer) {}
+
+
+void EventConnection::start() {
+  parent = &server;
+
+  ostringstream out;
+  greet(out);
+  getOutput().add(out.str());
+
+  setRead(true);
+}
+
+
+void EventConnection::shutdown() {
+  if (closed) return;
+  closed = true;
+
+  LOG_DEBUG(2, "Closing connection");
+
+  SmartPointer<EventConnection> self = this; // Don't deallocate yet
+  close();
+  server.remove(*this);
+}
+
+
+void EventConnection::readCB() {
+  Event::Buffer &input = getInput();
+
+  string line;
+  while (input.readLine(line, server.getMaxLineLength(),
+                        Event::Buffer::EOL_ANY))
+    lines.push(line);
+
+  if (server.getMaxLineLength() < input.getLength()) {
+    LOG_WARNING("Line too long from " << peer);
+    return shutdown();
+  }
+
+  dispatch();
+}
+
+
+void EventConnection::writeCB() {
+  if (isQuitting() && !running) shutdown();
+}
+
+
+void EventConnection::errorCB(short what, int err) {
+  LOG_DEBUG(3, "Error " << getEventsString(what) << " from " << peer);
+  shutdown();
+}
+
+
+void EventConnection::dispatch() {
+  if (closed || running || lines.empty() || isQuitting()) return;
+
+  running = true;
+  string line = lines.front();
+  lines.pop();
+
+  server.getPool().submit(new Task(*this, line));
+}
+
+
+void EventConnection::commandDone() {
+  running = false;
+
+  if (closed) return;
+  if (isQuitting()) {
+    if (!getOutput().getLength()) shutdown();
+    return;
+  }
+
+  dispatch();
+}
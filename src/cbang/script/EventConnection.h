@@ -0,0 +1,86 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Processor.h"
+
+#include <cbang/event/BufferEvent.h>
+#include <cbang/net/IPAddress.h>
+
+#include <string>
+#include <queue>
+
+
+namespace cb {
+  namespace Script {
+    class EventServer;
+
+    /**
+     * One EventServer session.  Complete input lines are queued and run
+     * in order on the server's ConcurrentPool.  Command output is sent
+     * as it is produced, whenever the handler flushes Context::stream or
+     * has written a few KiB, so long running commands can report
+     * progress.
+     */
+    class EventConnection : public Event::BufferEvent, public Processor {
+      EventServer &server;
+      IPAddress peer;
+
+      std::queue<std::string> lines;
+      bool running = false;
+      bool closed = false;
+
+      class Task;
+
+    public:
+      EventConnection(EventServer &server, const SmartPointer<Socket> &socket,
+                      const IPAddress &peer,
+                      const SmartPointer<SSLContext> &sslCtx = 0);
+
+      const IPAddress &getPeer() const {return peer;}
+      bool isClosed() const {return closed;}
+
+      void start();
+      void shutdown();
+
+      // From BufferEvent
+      void readCB();
+      void writeCB();
+      void errorCB(short what, int err);
+
+    protected:
+      void dispatch();
+      void commandDone();
+    };
+  }
+}
@@ -0,0 +1,113 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "EventServer.h"
+#include "EventConnection.h"
+
+#include <cbang/event/Base.h>
+#include <cbang/event/Event.h>
+#include <cbang/socket/Socket.h>
+#include <cbang/log/Logger.h>
+
+using namespace cb;
+using namespace cb::Script;
+
+
+EventServer::EventServer(Event::Base &base, Event::ConcurrentPool &pool,
+                         const std::string &name, Handler *parent,
+                         const SmartPointer<SSLContext> &sslCtx) :
+  Environment(name, parent), base(base), pool(pool), sslCtx(sslCtx) {}
+
+
+EventServer::~EventServer() {close();}
+
+
+void EventServer::bind(const IPAddress &addr) {
+  if (socket.isSet()) THROW("Already bound");
+
+  SmartPointer<Socket> socket = new Socket;
+  socket->setReuseAddr(true);
+  socket->bind(addr);
+  socket->listen();
+
+  typedef Event::EventFlag F;
+  acceptEvent = base.newEvent(socket->get(), this, &EventServer::acceptCB,
+                              F::EVENT_READ | F::EVENT_PERSIST |
+                              F::EVENT_NO_SELF_REF);
+  acceptEvent->add();
+
+  this->socket = socket;
+}
+
+
+void EventServer::close() {
+  if (acceptEvent.isSet()) acceptEvent->del();
+  acceptEvent.release();
+  socket.release();
+
+  while (!connections.empty()) connections.front()->shutdown();
+}
+
+
+void EventServer::remove(EventConnection &con) {
+  for (auto it = connections.begin(); it != connections.end(); it++)
+    if (it->get() == &con) {
+      connections.erase(it);
+      break;
+    }
+}
+
+
+SmartPointer<EventConnection>
+EventServer::createConnection(const SmartPointer<Socket> &socket,
+                              const IPAddress &peer) {
+  return new EventConnection(*this, socket, peer, sslCtx);
+}
+
+
+void EventServer::acceptCB() {
+  IPAddress peer;
+  auto newSocket = socket->accept(&peer);
+  if (newSocket.isNull()) return;
+
+  if (!ipFilter.isAllowed(peer)) {
+    LOG_INFO(3, "Rejected script connection from " << peer);
+    return;
+  }
+
+  LOG_DEBUG(4, "New script connection from " << peer);
+
+  auto con = createConnection(newSocket, peer);
+  con->setTimeouts(timeout, timeout);
+  connections.push_back(con);
+  con->start();
+}
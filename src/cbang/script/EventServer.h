@@ -0,0 +1,111 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Environment.h"
+
+#include <cbang/SmartPointer.h>
+#include <cbang/net/IPAddress.h>
+#include <cbang/net/IPAddressFilter.h>
+
+#include <list>
+
+
+namespace cb {
+  class Socket;
+  class SSLContext;
+
+  namespace Event {
+    class Base;
+    class Event;
+    class ConcurrentPool;
+  }
+
+  namespace Script {
+    class EventConnection;
+
+    /**
+     * Serves the command protocol of Server on an Event::Base.  Input is
+     * read and output written on the event loop while commands run on a
+     * ConcurrentPool, one at a time per connection, so a slow command
+     * does not hold up other sessions.  Handlers added to the server are
+     * shared by all connections and may be called concurrently.
+     */
+    class EventServer : public Environment {
+      Event::Base &base;
+      Event::ConcurrentPool &pool;
+      SmartPointer<SSLContext> sslCtx;
+
+      SmartPointer<Socket> socket;
+      SmartPointer<Event::Event> acceptEvent;
+      IPAddressFilter ipFilter;
+
+      unsigned maxLineLength = 4096;
+      unsigned timeout = 0;
+
+      typedef std::list<SmartPointer<EventConnection> > connections_t;
+      connections_t connections;
+
+    public:
+      EventServer(Event::Base &base, Event::ConcurrentPool &pool,
+                  const std::string &name, Handler *parent = 0,
+                  const SmartPointer<SSLContext> &sslCtx = 0);
+      ~EventServer();
+
+      Event::Base &getBase() const {return base;}
+      Event::ConcurrentPool &getPool() const {return pool;}
+
+      IPAddressFilter &getIPFilter() {return ipFilter;}
+
+      unsigned getMaxLineLength() const {return maxLineLength;}
+      void setMaxLineLength(unsigned x) {maxLineLength = x;}
+
+      unsigned getTimeout() const {return timeout;}
+      /// Seconds a connection may be idle, zero for no limit
+      void setTimeout(unsigned x) {timeout = x;}
+
+      unsigned getConnectionCount() const {return connections.size();}
+
+      void bind(const IPAddress &addr);
+      void close();
+      void remove(EventConnection &con);
+
+    protected:
+      virtual SmartPointer<EventConnection>
+      createConnection(const SmartPointer<Socket> &socket,
+                       const IPAddress &peer);
+
+      void acceptCB();
+    };
+  }
+}
@@ -51,7 +51,7 @@ using namespace cb;
 using namespace cb::Script;
 
 
-Processor::Processor(const string &name) : Environment(name) {
+Processor::Processor(const string &name) : Environment(name), quit(false) {
   typedef Processor P;
   typedef MemberFunctor<P> MF;
 
@@ -69,13 +69,12 @@ void Processor::run(Handler &handler, Socket &socket) {
   socket.setKeepAlive(true);
 
   ostringstream out;
-  Context ctx(*this, out);
 
   const unsigned size = 4096;
   unsigned fill = 0;
   char buffer[size];
 
-  Handler::eval(ctx, "$(eval $greeting $prompt)");
+  greet(out);
 
   quit = false;
   while (socket.isOpen()) {
@@ -121,26 +120,37 @@ void Processor::run(Handler &handler, Socket &socket) {
         }
       if (i == fill && line.empty()) break;
 
-      // Process line
-      try {
-        Arguments args;
-        Arguments::parse(args, line);
-        if (!args.size()) continue;
+      execute(line, out);
+    }
+  }
 
-        out << '\n';
-        bool handled = eval(Context(*this, out, args));
-        if (!handled)
-          out << "ERROR: unknown command or variable '" << args[0] << "'\n";
+  parent = 0;
+}
 
-      } catch (const Exception &e) {
-        out << "ERROR: " << e << '\n';
-      }
 
-      Handler::eval(ctx, "$(eval $prompt)");
-    }
+void Processor::greet(ostream &out) {
+  Context ctx(*this, out);
+  Handler::eval(ctx, "$(eval $greeting $prompt)");
+}
+
+
+void Processor::execute(const string &line, ostream &out) {
+  try {
+    Arguments args;
+    Arguments::parse(args, line);
+    if (!args.size()) return;
+
+    out << '\n';
+    bool handled = eval(Context(*this, out, args));
+    if (!handled)
+      out << "ERROR: unknown command or variable '" << args[0] << "'\n";
+
+  } catch (const Exception &e) {
+    out << "ERROR: " << e << '\n';
   }
 
-  parent = 0;
+  Context ctx(*this, out);
+  Handler::eval(ctx, "$(eval $prompt)");
 }
 
 
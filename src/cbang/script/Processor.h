@@ -49,6 +49,13 @@ namespace cb {
 
       void run(Handler &handler, Socket &socket);
 
+      bool isQuitting() const {return quit;}
+
+      /// Write the greeting and first prompt
+      void greet(std::ostream &out);
+      /// Evaluate one command line and write its output and the next prompt
+      void execute(const std::string &line, std::ostream &out);
+
       virtual void update(const Context &ctx) {}
 
     protected:
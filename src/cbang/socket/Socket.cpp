@@ -136,6 +136,43 @@ streamsize Socket::write(const char *data, streamsize length, unsigned flags) {
 }
 
 
+streamsize Socket::writev(const SocketBuffer *bufs, unsigned count,
+                          unsigned flags) {
+  if (!isOpen()) THROW("Socket not open");
+  bool blocking = !(flags & NONBLOCKING) && getBlocking();
+  LOG_DEBUG(5, "Socket start " << (blocking ? "" : "non-")
+            << "blocking writev of " << count << " buffers");
+
+  streamsize bytes = impl->writev(bufs, count, flags);
+
+  LOG_DEBUG(5, "Socket writev " << bytes);
+
+  return bytes;
+}
+
+
+unsigned Socket::sendMessages(const SocketMessage *msgs, unsigned count,
+                              unsigned flags) {
+  if (!isOpen()) THROW("Socket not open");
+
+  unsigned sent = impl->sendMessages(msgs, count, flags);
+  LOG_DEBUG(5, "Socket sent " << sent << " of " << count << " messages");
+
+  return sent;
+}
+
+
+unsigned Socket::receiveMessages(SocketMessage *msgs, unsigned count,
+                                 unsigned flags) {
+  if (!isOpen()) THROW("Socket not open");
+
+  unsigned received = impl->receiveMessages(msgs, count, flags);
+  LOG_DEBUG(5, "Socket received " << received << " messages");
+
+  return received;
+}
+
+
 streamsize Socket::read(char *data, streamsize length, unsigned flags) {
   if (!isOpen()) THROW("Socket not open");
   bool blocking = !(flags & NONBLOCKING) && getBlocking();
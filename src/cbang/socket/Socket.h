@@ -85,6 +85,7 @@ namespace cb {
     virtual bool canWrite(double timeout = 0) const;
 
     virtual void setReuseAddr(bool reuse) {impl->setReuseAddr(reuse);}
+    virtual void setReusePort(bool reuse) {impl->setReusePort(reuse);}
     virtual void setBlocking(bool blocking) {impl->setBlocking(blocking);}
     virtual bool getBlocking() const {return impl->getBlocking();}
     virtual void setKeepAlive(bool keepAlive) {impl->setKeepAlive(keepAlive);}
@@ -98,7 +99,38 @@ namespace cb {
     virtual void setReceiveBuf(int size = INT_MAX) {impl->setReceiveBuf(size);}
     virtual void setSendBuf(int size = INT_MAX) {impl->setSendBuf(size);}
 
+    /// Disable Nagle's algorithm so small writes are sent immediately.
+    virtual void setNoDelay(bool noDelay) {impl->setNoDelay(noDelay);}
+
+    /**
+     * While corked, partial frames are held back so that writes issued
+     * separately, e.g. a header and its body, leave in full packets.
+     */
+    virtual void setCork(bool cork) {impl->setCork(cork);}
+
+    /// Accept TCP Fast Open on a listener.  Call before listen().
+    virtual void setFastOpen(unsigned queueLength)
+    {impl->setFastOpen(queueLength);}
+
+    /// Send data with the SYN of the next connect().
+    virtual void setFastOpenConnect(bool enable)
+    {impl->setFastOpenConnect(enable);}
+
+    /// Wake a listener only once data arrives on a new connection.
+    virtual void setDeferAccept(unsigned seconds)
+    {impl->setDeferAccept(seconds);}
+
+    /// Busy poll the device queue on blocking receives.
+    virtual void setBusyPoll(unsigned usec) {impl->setBusyPoll(usec);}
+
     virtual void open() {impl->open();}
+    virtual void openUDP() {impl->openUDP();}
+
+    /**
+     * Open a Unix domain stream socket.  bind() and connect() open one
+     * on their own when given a "unix:" address.
+     */
+    virtual void openUnix() {impl->openUnix();}
     virtual void bind(const IPAddress &ip) {impl->bind(ip);}
     virtual void listen(int backlog = -1) {impl->listen(backlog);}
     virtual SmartPointer<Socket> accept(IPAddress *ip = 0)
@@ -115,6 +147,34 @@ namespace cb {
     virtual std::streamsize read(char *data, std::streamsize length,
                                  unsigned flags = 0);
 
+    /// Write several buffers, in order, with as few system calls as possible.
+    virtual std::streamsize writev(const SocketBuffer *bufs, unsigned count,
+                                   unsigned flags = 0);
+
+    /**
+     * Send several datagrams on a UDP socket.  Messages with an unset
+     * address are sent to the connected peer.
+     * @return The number of messages sent.
+     */
+    virtual unsigned sendMessages(const SocketMessage *msgs, unsigned count,
+                                  unsigned flags = 0);
+
+    /**
+     * Receive up to @param count datagrams on a UDP socket.  Only
+     * the first receive blocks.
+     * @return The number of messages received.
+     */
+    virtual unsigned receiveMessages(SocketMessage *msgs, unsigned count,
+                                     unsigned flags = 0);
+
+    /**
+     * Get the identity of the process at the other end of a connected
+     * Unix domain socket, as recorded by the kernel.
+     * @return False if unavailable.
+     */
+    virtual bool getPeerCredentials(SocketCredentials &cred) const
+    {return impl->getPeerCredentials(cred);}
+
     /// Close an open connection.
     virtual void close() {impl->close();}
 
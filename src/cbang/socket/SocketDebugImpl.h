@@ -61,6 +61,7 @@ namespace cb {
     // From SocketImpl
     bool isOpen() const {return socketOpen;}
     void setReuseAddr(bool reuse) {}
+    void setReusePort(bool reuse) {}
     void setBlocking(bool blocking) {this->blocking = blocking;}
     bool getBlocking() const {return blocking;}
     void open() {socketOpen = true;}
@@ -55,7 +55,11 @@ typedef int socklen_t;  // Unix socket length
 
 #else // _WIN32
 #include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <netdb.h>
 #include <unistd.h>
 #include <fcntl.h>
@@ -73,14 +77,64 @@ typedef int socklen_t;  // Unix socket length
 #include <errno.h>
 #include <time.h>
 #include <string.h>
+#include <stddef.h>
 
 using namespace std;
 using namespace cb;
 
 
+// Buffers or messages passed to a single system call
+static const unsigned maxBatch = 64;
+
+
+static void toSockAddr(const IPAddress &ip, struct sockaddr_in &addr) {
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(ip.getPort());
+  addr.sin_addr.s_addr = htonl(ip.getIP());
+}
+
+
+static IPAddress fromSockAddr(const struct sockaddr_in &addr) {
+  return IPAddress(ntohl(addr.sin_addr.s_addr), ntohs(addr.sin_port));
+}
+
+
+#ifndef _WIN32
+static socklen_t toSockAddr(const IPAddress &ip, struct sockaddr_un &addr) {
+  string path = ip.getUnixPath();
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+
+  if (path.empty() || sizeof(addr.sun_path) <= path.length())
+    THROW("Invalid Unix socket path '" << path << "'");
+
+  memcpy(addr.sun_path, path.data(), path.length());
+
+  // A leading '@' names a Linux abstract socket, which is not NUL terminated
+  if (path[0] == '@') {
+    addr.sun_path[0] = 0;
+    return offsetof(struct sockaddr_un, sun_path) + path.length();
+  }
+
+  return sizeof(addr);
+}
+#endif
+
+
+static bool wouldBlock(int err) {
+#ifdef _WIN32
+  return !err || err == WSAEWOULDBLOCK || err == WSAENOBUFS;
+#else
+  return err == EAGAIN || err == EWOULDBLOCK;
+#endif
+}
+
+
 SocketDefaultImpl::SocketDefaultImpl(Socket *parent) :
   SocketImpl(parent), socket(INVALID_SOCKET), blocking(true),
-  connected(false) {
+  connected(false), local(false) {
   Socket::initialize();
 }
 
@@ -97,6 +151,29 @@ void SocketDefaultImpl::open() {
 }
 
 
+void SocketDefaultImpl::openUDP() {
+  if (isOpen()) THROW("Socket already open");
+
+  if ((socket = ::socket(PF_INET, SOCK_DGRAM, IPPROTO_UDP)) == INVALID_SOCKET)
+    THROW("Failed to create UDP socket");
+}
+
+
+void SocketDefaultImpl::openUnix() {
+#ifdef _WIN32
+  THROW("Unix sockets not supported on this platform");
+
+#else
+  if (isOpen()) THROW("Socket already open");
+
+  if ((socket = ::socket(PF_UNIX, SOCK_STREAM, 0)) == INVALID_SOCKET)
+    THROW("Failed to create Unix socket: " << SysError());
+
+  local = true;
+#endif
+}
+
+
 void SocketDefaultImpl::setReuseAddr(bool reuse) {
   if (!isOpen()) open();
 
@@ -113,6 +190,23 @@ void SocketDefaultImpl::setReuseAddr(bool reuse) {
 }
 
 
+void SocketDefaultImpl::setReusePort(bool reuse) {
+#ifdef SO_REUSEPORT
+  if (!isOpen()) open();
+
+  int opt = reuse;
+
+  SysError::clear();
+  if (setsockopt((socket_t)socket, SOL_SOCKET, SO_REUSEPORT, (char *)&opt,
+                 sizeof(opt)))
+    THROW("Failed to set reuse port: " << SysError());
+
+#else
+  if (reuse) THROW("SO_REUSEPORT not supported on this platform");
+#endif
+}
+
+
 void SocketDefaultImpl::setBlocking(bool blocking) {
   if (!isOpen()) open();
 
@@ -222,7 +316,115 @@ void SocketDefaultImpl::setSendBuf(int size) {
 }
 
 
+void SocketDefaultImpl::setNoDelay(bool noDelay) {
+  if (!isOpen()) open();
+  if (local) return; // TCP only
+
+  int opt = noDelay;
+
+  if (setsockopt((socket_t)socket, IPPROTO_TCP, TCP_NODELAY, (char *)&opt,
+                 sizeof(opt)))
+    THROW("Could not set TCP no delay: " << SysError());
+}
+
+
+void SocketDefaultImpl::setCork(bool cork) {
+#if defined(TCP_CORK) || defined(TCP_NOPUSH)
+  if (!isOpen()) open();
+  if (local) return;
+
+  int opt = cork;
+
+#ifdef TCP_CORK
+  int name = TCP_CORK;
+#else
+  int name = TCP_NOPUSH;
+#endif
+
+  if (setsockopt((socket_t)socket, IPPROTO_TCP, name, (char *)&opt,
+                 sizeof(opt)))
+    THROW("Could not set TCP cork: " << SysError());
+
+#else
+  if (cork) THROW("TCP cork not supported on this platform");
+#endif
+}
+
+
+void SocketDefaultImpl::setFastOpen(unsigned queueLength) {
+#ifdef TCP_FASTOPEN
+  if (!isOpen()) open();
+  if (local) return;
+
+#ifdef __APPLE__
+  int opt = !!queueLength; // A flag rather than a queue length
+#else
+  int opt = queueLength;
+#endif
+
+  if (setsockopt((socket_t)socket, IPPROTO_TCP, TCP_FASTOPEN, (char *)&opt,
+                 sizeof(opt)))
+    THROW("Could not set TCP fast open: " << SysError());
+
+#else
+  if (queueLength) THROW("TCP fast open not supported on this platform");
+#endif
+}
+
+
+void SocketDefaultImpl::setFastOpenConnect(bool enable) {
+#ifdef TCP_FASTOPEN_CONNECT
+  if (!isOpen()) open();
+  if (local) return;
+
+  int opt = enable;
+
+  if (setsockopt((socket_t)socket, IPPROTO_TCP, TCP_FASTOPEN_CONNECT,
+                 (char *)&opt, sizeof(opt)))
+    THROW("Could not set TCP fast open connect: " << SysError());
+
+#else
+  if (enable)
+    THROW("TCP fast open connect not supported on this platform");
+#endif
+}
+
+
+void SocketDefaultImpl::setDeferAccept(unsigned seconds) {
+#ifdef TCP_DEFER_ACCEPT
+  if (!isOpen()) open();
+  if (local) return;
+
+  int opt = seconds;
+
+  if (setsockopt((socket_t)socket, IPPROTO_TCP, TCP_DEFER_ACCEPT, (char *)&opt,
+                 sizeof(opt)))
+    THROW("Could not set TCP defer accept: " << SysError());
+
+#else
+  if (seconds) THROW("TCP defer accept not supported on this platform");
+#endif
+}
+
+
+void SocketDefaultImpl::setBusyPoll(unsigned usec) {
+#ifdef SO_BUSY_POLL
+  if (!isOpen()) open();
+
+  int opt = usec;
+
+  if (setsockopt((socket_t)socket, SOL_SOCKET, SO_BUSY_POLL, (char *)&opt,
+                 sizeof(opt)))
+    THROW("Could not set busy poll to " << usec << ": " << SysError());
+
+#else
+  if (usec) THROW("SO_BUSY_POLL not supported on this platform");
+#endif
+}
+
+
 void SocketDefaultImpl::bind(const IPAddress &ip) {
+  if (ip.isUnix()) return bindUnix(ip);
   if (!isOpen()) open();
 
   struct sockaddr_in addr;
@@ -265,8 +467,17 @@ SmartPointer<Socket> SocketDefaultImpl::accept(IPAddress *ip) {
   if ((aSock->socket =
        ::accept((socket_t)socket, (struct sockaddr *)&addr, &len)) !=
       INVALID_SOCKET) {
-    IPAddress inAddr = ntohl(addr.sin_addr.s_addr);
-    inAddr.setPort(ntohs(addr.sin_port));
+    IPAddress inAddr;
+
+    // Unix peers are usually unnamed so report the listener's path
+    if (local) {
+      inAddr = IPAddress("unix:" + path);
+      aSock->local = true;
+
+    } else {
+      inAddr = ntohl(addr.sin_addr.s_addr);
+      inAddr.setPort(ntohs(addr.sin_port));
+    }
 
     if (ip) *ip = inAddr;
 
@@ -284,6 +495,7 @@ SmartPointer<Socket> SocketDefaultImpl::accept(IPAddress *ip) {
 
 
 void SocketDefaultImpl::connect(const IPAddress &ip) {
+  if (ip.isUnix()) return connectUnix(ip);
   if (!isOpen()) open();
 
   LOG_INFO(3, "Connecting to " << ip);
@@ -377,6 +589,242 @@ streamsize SocketDefaultImpl::read(char *data, streamsize length,
 }
 
 
+streamsize SocketDefaultImpl::writev(const SocketBuffer *bufs, unsigned count,
+                                     unsigned flags) {
+  if (!isOpen()) THROW("Socket not open");
+  if (maxBatch < count) count = maxBatch;
+
+  streamsize length = 0;
+  for (unsigned i = 0; i < count; i++) length += bufs[i].length;
+  if (!length) return 0;
+
+  SysError::clear();
+
+#ifdef _WIN32
+  WSABUF iov[maxBatch];
+  for (unsigned i = 0; i < count; i++) {
+    iov[i].buf = (char *)bufs[i].data;
+    iov[i].len = bufs[i].length;
+  }
+
+  DWORD sent = 0;
+  streamsize ret =
+    WSASend((SOCKET)socket, iov, count, &sent, 0, 0, 0) ? -1 : sent;
+
+#else
+  struct iovec iov[maxBatch];
+  for (unsigned i = 0; i < count; i++) {
+    iov[i].iov_base = (void *)bufs[i].data;
+    iov[i].iov_len = bufs[i].length;
+  }
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = iov;
+  msg.msg_iovlen = count;
+
+  int f = MSG_NOSIGNAL;
+  if (flags & Socket::NONBLOCKING) f |= MSG_DONTWAIT;
+
+  streamsize ret = sendmsg((socket_t)socket, &msg, f);
+#endif
+
+  int err = SysError::get();
+
+  LOG_DEBUG(5, "sendmsg() = " << ret << " of " << length << " in " << count
+            << " buffers");
+
+  if (ret < 0) {
+    if (wouldBlock(err)) return 0;
+    THROW("Send error: " << err << ": " << SysError(err));
+  }
+
+  if (!out.isNull()) // Capture
+    for (unsigned i = 0, left = ret; i < count && left; i++) {
+      unsigned n = left < bufs[i].length ? left : bufs[i].length;
+      out->write(bufs[i].data, n);
+      left -= n;
+    }
+
+  return ret;
+}
+
+
+unsigned SocketDefaultImpl::sendMessages(const SocketMessage *msgs,
+                                         unsigned count, unsigned flags) {
+  if (!isOpen()) THROW("Socket not open");
+  if (maxBatch < count) count = maxBatch;
+  if (!count) return 0;
+
+  int f = MSG_NOSIGNAL;
+  if (flags & Socket::NONBLOCKING) f |= MSG_DONTWAIT;
+
+  struct sockaddr_in addrs[maxBatch];
+  for (unsigned i = 0; i < count; i++) toSockAddr(msgs[i].ip, addrs[i]);
+
+  SysError::clear();
+
+#ifdef __linux__
+  struct iovec iov[maxBatch];
+  struct mmsghdr hdrs[maxBatch];
+  memset(hdrs, 0, sizeof(hdrs));
+
+  for (unsigned i = 0; i < count; i++) {
+    iov[i].iov_base = msgs[i].data;
+    iov[i].iov_len = msgs[i].length;
+    hdrs[i].msg_hdr.msg_iov = &iov[i];
+    hdrs[i].msg_hdr.msg_iovlen = 1;
+
+    if (msgs[i].ip.getIP()) {
+      hdrs[i].msg_hdr.msg_name = &addrs[i];
+      hdrs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+    }
+  }
+
+  int ret = sendmmsg((socket_t)socket, hdrs, count, f);
+  int err = SysError::get();
+
+  LOG_DEBUG(5, "sendmmsg() = " << ret << " of " << count);
+
+  if (ret < 0) {
+    if (wouldBlock(err)) return 0;
+    THROW("Send error: " << err << ": " << SysError(err));
+  }
+
+  return ret;
+
+#else
+  unsigned sent = 0;
+
+  for (; sent < count; sent++) {
+    const SocketMessage &msg = msgs[sent];
+    const struct sockaddr *addr =
+      msg.ip.getIP() ? (struct sockaddr *)&addrs[sent] : 0;
+
+    int ret = sendto((socket_t)socket, msg.data, msg.length, f, addr,
+                     addr ? sizeof(addrs[sent]) : 0);
+
+    if (ret < 0) {
+      int err = SysError::get();
+      if (sent || wouldBlock(err)) break;
+      THROW("Send error: " << err << ": " << SysError(err));
+    }
+  }
+
+  return sent;
+#endif
+}
+
+
+unsigned SocketDefaultImpl::receiveMessages(SocketMessage *msgs,
+                                            unsigned count, unsigned flags) {
+  if (!isOpen()) THROW("Socket not open");
+  if (maxBatch < count) count = maxBatch;
+  if (!count) return 0;
+
+  int f = 0;
+  if (flags & Socket::NONBLOCKING) f |= MSG_DONTWAIT;
+  if (flags & Socket::PEEK) f |= MSG_PEEK;
+
+  struct sockaddr_in addrs[maxBatch];
+
+  SysError::clear();
+
+#ifdef __linux__
+  struct iovec iov[maxBatch];
+  struct mmsghdr hdrs[maxBatch];
+  memset(hdrs, 0, sizeof(hdrs));
+
+  for (unsigned i = 0; i < count; i++) {
+    iov[i].iov_base = msgs[i].data;
+    iov[i].iov_len = msgs[i].length;
+    hdrs[i].msg_hdr.msg_iov = &iov[i];
+    hdrs[i].msg_hdr.msg_iovlen = 1;
+    hdrs[i].msg_hdr.msg_name = &addrs[i];
+    hdrs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+  }
+
+  // Only wait for the first message
+  int ret = recvmmsg((socket_t)socket, hdrs, count, f | MSG_WAITFORONE, 0);
+  int err = SysError::get();
+
+  LOG_DEBUG(5, "recvmmsg() = " << ret << " of " << count);
+
+  if (ret < 0) {
+    if (wouldBlock(err)) return 0;
+    THROW("Receive error: " << err << ": " << SysError(err));
+  }
+
+  for (int i = 0; i < ret; i++) {
+    msgs[i].ip = fromSockAddr(addrs[i]);
+    msgs[i].length = hdrs[i].msg_len;
+  }
+
+  return ret;
+
+#else
+  unsigned received = 0;
+
+  for (; received < count; received++) {
+    SocketMessage &msg = msgs[received];
+    socklen_t len = sizeof(addrs[received]);
+
+    int ret = recvfrom((socket_t)socket, msg.data, msg.length, f,
+                       (struct sockaddr *)&addrs[received], &len);
+
+    if (ret < 0) {
+      int err = SysError::get();
+      if (received || wouldBlock(err)) break;
+      THROW("Receive error: " << err << ": " << SysError(err));
+    }
+
+    msg.ip = fromSockAddr(addrs[received]);
+    msg.length = ret;
+
+#ifdef _WIN32
+    break; // Cannot receive more without blocking
+#else
+    f |= MSG_DONTWAIT; // Only wait for the first message
+#endif
+  }
+
+  return received;
+#endif
+}
+
+
+bool SocketDefaultImpl::getPeerCredentials(SocketCredentials &cred) const {
+  if (!isOpen() || !local) return false;
+
+#if defined(SO_PEERCRED)
+  struct ucred uc;
+  socklen_t len = sizeof(uc);
+
+  if (getsockopt((socket_t)socket, SOL_SOCKET, SO_PEERCRED, &uc, &len))
+    return false;
+
+  cred.pid = uc.pid;
+  cred.uid = uc.uid;
+  cred.gid = uc.gid;
+  return true;
+
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__)
+  uid_t uid;
+  gid_t gid;
+
+  if (getpeereid((socket_t)socket, &uid, &gid)) return false;
+
+  cred.pid = 0;
+  cred.uid = uid;
+  cred.gid = gid;
+  return true;
+
+#else
+  return false;
+#endif
+}
+
+
 void SocketDefaultImpl::close() {
   if (!isOpen()) return;
 
@@ -395,6 +843,7 @@ void SocketDefaultImpl::close() {
   in = out = 0; // Flush capture
 
   socket = INVALID_SOCKET;
+  local = false;
 }
 
 
@@ -413,6 +862,63 @@ socket_t SocketDefaultImpl::adopt() {
 }
 
 
+void SocketDefaultImpl::bindUnix(const IPAddress &ip) {
+#ifdef _WIN32
+  THROW("Unix sockets not supported on this platform");
+
+#else
+  if (!isOpen()) openUnix();
+
+  struct sockaddr_un addr;
+  socklen_t len = toSockAddr(ip, addr);
+  string path = ip.getUnixPath();
+
+  // Remove a socket left behind by a previous process
+  struct stat info;
+  if (path[0] != '@' && !lstat(path.c_str(), &info) && S_ISSOCK(info.st_mode))
+    ::unlink(path.c_str());
+
+  SysError::clear();
+  if (::bind((socket_t)socket, (struct sockaddr *)&addr, len) == SOCKET_ERROR)
+    THROW("Could not bind socket to " << ip << ": " << SysError());
+
+  this->path = path;
+#endif
+}
+
+
+void SocketDefaultImpl::connectUnix(const IPAddress &ip) {
+#ifdef _WIN32
+  THROW("Unix sockets not supported on this platform");
+
+#else
+  if (!isOpen()) openUnix();
+
+  LOG_INFO(3, "Connecting to " << ip);
+
+  try {
+    struct sockaddr_un addr;
+    socklen_t len = toSockAddr(ip, addr);
+
+    // A full listen queue fails with EAGAIN rather than EINPROGRESS
+    SysError::clear();
+    if (::connect((socket_t)socket, (struct sockaddr *)&addr, len) == -1)
+      if (SysError::get() != SOCKET_INPROGRESS)
+        THROW("Failed to connect to " << ip << ": " << SysError());
+
+    connected = true;
+    path = ip.getUnixPath();
+    capture(ip, false);
+
+  } catch (const Exception &e) {
+    close();
+
+    throw;
+  }
+#endif
+}
+
+
 void SocketDefaultImpl::capture(const IPAddress &addr, bool incoming) {
   SocketDebugger &debugger = SocketDebugger::instance();
   if (!debugger.getCapture()) return;
@@ -423,7 +929,7 @@ void SocketDefaultImpl::capture(const IPAddress &addr, bool incoming) {
   uint64_t id = debugger.getNextConnectionID();
 
   string prefix = dir + "/" + String(id) + "-" + (incoming ? "in" : "out") +
-    "-" + addr.toString() + "-";
+    "-" + String::replace(addr.toString(), '/', '_') + "-";
 
 #ifdef _WIN32
   prefix = String::replace(prefix, ':', '-');
@@ -44,6 +44,8 @@ namespace cb {
     socket_t socket;
     bool blocking;
     bool connected;
+    bool local;
+    std::string path;
 
     SmartPointer<std::iostream> in;
     SmartPointer<std::iostream> out;
@@ -58,6 +60,7 @@ namespace cb {
     // From SocketImpl
     bool isOpen() const;
     void setReuseAddr(bool reuse);
+    void setReusePort(bool reuse);
     void setBlocking(bool blocking);
     bool getBlocking() const {return blocking;}
     void setKeepAlive(bool keepAlive);
@@ -68,7 +71,15 @@ namespace cb {
     void setReceiveTimeout(double timeout);
     void setReceiveBuf(int size);
     void setSendBuf(int size);
+    void setNoDelay(bool noDelay);
+    void setCork(bool cork);
+    void setFastOpen(unsigned queueLength);
+    void setFastOpenConnect(bool enable);
+    void setDeferAccept(unsigned seconds);
+    void setBusyPoll(unsigned usec);
     void open();
+    void openUDP();
+    void openUnix();
     void bind(const IPAddress &ip);
     void listen(int backlog);
     SmartPointer<Socket> accept(IPAddress *ip);
@@ -76,12 +87,21 @@ namespace cb {
     std::streamsize write(const char *data, std::streamsize length,
                           unsigned flags);
     std::streamsize read(char *data, std::streamsize length, unsigned flags);
+    std::streamsize writev(const SocketBuffer *bufs, unsigned count,
+                           unsigned flags);
+    unsigned sendMessages(const SocketMessage *msgs, unsigned count,
+                          unsigned flags);
+    unsigned receiveMessages(SocketMessage *msgs, unsigned count,
+                             unsigned flags);
+    bool getPeerCredentials(SocketCredentials &cred) const;
     void close();
     socket_t get() const {return socket;}
     void set(socket_t socket);
     socket_t adopt();
 
   protected:
+    void bindUnix(const IPAddress &ip);
+    void connectUnix(const IPAddress &ip);
     void capture(const IPAddress &addr, bool incoming);
   };
 }
@@ -0,0 +1,392 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "SocketHandoff.h"
+#include "Socket.h"
+#include "SocketImpl.h"
+
+#include <cbang/Exception.h>
+#include <cbang/Catch.h>
+#include <cbang/String.h>
+#include <cbang/json/JSON.h>
+#include <cbang/log/Logger.h>
+#include <cbang/os/SysError.h>
+#include <cbang/util/SmartLock.h>
+#include <cbang/net/IPAddress.h>
+
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+using namespace std;
+using namespace cb;
+
+
+namespace {
+  const char ACK = 'A';
+
+
+#ifndef _WIN32
+  void closeFDs(vector<socket_t> &fds) {
+    for (unsigned i = 0; i < fds.size(); i++) ::close(fds[i]);
+    fds.clear();
+  }
+#endif
+}
+
+
+SocketHandoff::SocketHandoff(Inaccessible) {setName("SocketHandoff");}
+
+
+SocketHandoff::~SocketHandoff() {
+  stopListening();
+
+  // Close inherited listeners which were never claimed
+#ifndef _WIN32
+  for (auto it = inherited.begin(); it != inherited.end(); it++)
+    ::close(it->second);
+#endif
+}
+
+
+void SocketHandoff::add(const string &name, socket_t fd) {
+  SmartLock l(&lock);
+  listeners[name] = fd;
+}
+
+
+void SocketHandoff::remove(const string &name) {
+  SmartLock l(&lock);
+  listeners.erase(name);
+}
+
+
+void SocketHandoff::addState(const string &name, state_cb_t cb) {
+  SmartLock l(&lock);
+  stateCBs[name] = cb;
+}
+
+
+void SocketHandoff::removeState(const string &name) {
+  SmartLock l(&lock);
+  stateCBs.erase(name);
+}
+
+
+void SocketHandoff::listen(const string &path, callback_t cb) {
+#ifdef _WIN32
+  THROW("Socket handoff not supported on this platform");
+
+#else
+  if (isRunning()) THROW("Already serving socket handoffs");
+  Thread::join();
+
+  server = new Socket;
+  server->bind(IPAddress("unix:" + path));
+  server->listen();
+  callback = cb;
+
+  LOG_INFO(1, "Serving socket handoffs on " << path);
+
+  start();
+#endif
+}
+
+
+void SocketHandoff::stopListening() {
+  Thread::join();
+  server.release();
+}
+
+
+void SocketHandoff::receive(const string &path, double timeout) {
+#ifdef _WIN32
+  THROW("Socket handoff not supported on this platform");
+
+#else
+  Socket peer;
+  peer.connect(IPAddress("unix:" + path));
+  peer.setTimeout(timeout);
+
+  vector<socket_t> fds;
+  string data = receiveFDs(peer.get(), fds);
+
+  try {
+    JSON::ValuePtr msg = JSON::Reader::parseString(data);
+    auto &names = *msg->get("sockets");
+    if (names.size() != fds.size())
+      THROW("Expected " << names.size() << " sockets, received "
+            << fds.size());
+
+    SmartLock l(&lock);
+
+    for (unsigned i = 0; i < names.size(); i++)
+      inherited[names.getString(i)] = fds[i];
+    fds.clear();
+
+    if (msg->has("state")) {
+      auto &state = *msg->get("state");
+      for (unsigned i = 0; i < state.size(); i++)
+        inheritedState[state.keyAt(i)] = state.getString(i);
+    }
+
+  } catch (...) {
+    closeFDs(fds);
+    throw;
+  }
+
+  // The old process keeps accepting until the listeners are safely here
+  if (::send(peer.get(), &ACK, 1, MSG_NOSIGNAL) != 1)
+    THROW("Failed to acknowledge socket handoff: " << SysError());
+
+  LOG_INFO(1, "Received " << inherited.size() << " listener(s) from "
+           << path);
+#endif
+}
+
+
+bool SocketHandoff::take(const string &name, socket_t &fd) {
+  SmartLock l(&lock);
+
+  auto it = inherited.find(name);
+  if (it == inherited.end()) return false;
+
+  fd = it->second;
+  inherited.erase(it);
+
+  return true;
+}
+
+
+string SocketHandoff::getState(const string &name) const {
+  SmartLock l(&lock);
+  auto it = inheritedState.find(name);
+  return it == inheritedState.end() ? string() : it->second;
+}
+
+
+void SocketHandoff::sendFDs(socket_t s, const string &data,
+                            const vector<socket_t> &fds) {
+#ifdef _WIN32
+  THROW("Socket handoff not supported on this platform");
+
+#else
+  if (maxSockets < fds.size())
+    THROW("Cannot hand off more than " << maxSockets << " sockets");
+
+  // Length prefixed message, the descriptors travel with its first byte
+  string msg(4, 0);
+  for (unsigned i = 0; i < 4; i++)
+    msg[i] = (char)(data.size() >> (8 * (3 - i)));
+  msg += data;
+
+  struct iovec iov;
+  iov.iov_base = (void *)msg.data();
+  iov.iov_len = msg.size();
+
+  struct msghdr hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.msg_iov = &iov;
+  hdr.msg_iovlen = 1;
+
+  vector<char> control(CMSG_SPACE(sizeof(int) * fds.size()));
+  if (!fds.empty()) {
+    hdr.msg_control = control.data();
+    hdr.msg_controllen = control.size();
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+
+    int *dst = (int *)CMSG_DATA(cmsg);
+    for (unsigned i = 0; i < fds.size(); i++) dst[i] = (int)fds[i];
+  }
+
+  ssize_t ret;
+  do ret = sendmsg(s, &hdr, MSG_NOSIGNAL);
+  while (ret < 0 && errno == EINTR);
+  if (ret < 0) THROW("Failed to send sockets: " << SysError());
+
+  for (size_t sent = ret; sent < msg.size(); sent += ret) {
+    ret = ::send(s, msg.data() + sent, msg.size() - sent, MSG_NOSIGNAL);
+    if (ret < 0 && errno == EINTR) ret = 0;
+    else if (ret <= 0) THROW("Failed to send socket handoff: " << SysError());
+  }
+#endif
+}
+
+
+string SocketHandoff::receiveFDs(socket_t s, vector<socket_t> &fds) {
+#ifdef _WIN32
+  THROW("Socket handoff not supported on this platform");
+
+#else
+  char buf[4096];
+  struct iovec iov;
+  iov.iov_base = buf;
+  iov.iov_len = sizeof(buf);
+
+  vector<char> control(CMSG_SPACE(sizeof(int) * maxSockets));
+  struct msghdr hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.msg_iov = &iov;
+  hdr.msg_iovlen = 1;
+  hdr.msg_control = control.data();
+  hdr.msg_controllen = control.size();
+
+  int flags = 0;
+#ifdef MSG_CMSG_CLOEXEC
+  flags |= MSG_CMSG_CLOEXEC;
+#endif
+
+  ssize_t ret;
+  do ret = recvmsg(s, &hdr, flags);
+  while (ret < 0 && errno == EINTR);
+  if (ret < 0) THROW("Failed to receive sockets: " << SysError());
+  if (!ret) THROW("Socket handoff closed by peer");
+
+  for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr); cmsg;
+       cmsg = CMSG_NXTHDR(&hdr, cmsg))
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+      unsigned count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+      int *src = (int *)CMSG_DATA(cmsg);
+      for (unsigned i = 0; i < count; i++) fds.push_back(src[i]);
+    }
+
+  try {
+    if (hdr.msg_flags & MSG_CTRUNC) THROW("Too many sockets in handoff");
+
+    string data(buf, ret);
+    uint32_t length = 0;
+
+    while (data.size() < 4 || data.size() < 4 + (size_t)length) {
+      if (4 <= data.size() && !length)
+        for (unsigned i = 0; i < 4; i++)
+          length = (length << 8) | (uint8_t)data[i];
+
+      if (4 <= data.size() && data.size() == 4 + (size_t)length) break;
+
+      ret = ::recv(s, buf, sizeof(buf), 0);
+      if (ret < 0 && errno == EINTR) continue;
+      if (ret < 0) THROW("Failed to receive socket handoff: " << SysError());
+      if (!ret) THROW("Socket handoff closed by peer");
+      data.append(buf, ret);
+    }
+
+    for (unsigned i = 0; i < 4; i++)
+      length = (length << 8) | (uint8_t)data[i];
+
+    return data.substr(4, length);
+
+  } catch (...) {
+    closeFDs(fds);
+    throw;
+  }
+#endif
+}
+
+
+void SocketHandoff::serve(Socket &peer) {
+#ifndef _WIN32
+  SocketCredentials cred;
+  if (!peer.getPeerCredentials(cred))
+    THROW("Could not identify socket handoff peer");
+  if (cred.uid && cred.uid != getuid())
+    THROW("Refusing socket handoff to UID " << cred.uid);
+
+  JSON::Dict msg;
+  vector<socket_t> fds;
+
+  {
+    SmartLock l(&lock);
+
+    msg.insertList("sockets");
+    auto &sockets = *msg.get("sockets");
+    for (auto it = listeners.begin(); it != listeners.end(); it++) {
+      sockets.append(it->first);
+      fds.push_back(it->second);
+    }
+
+    msg.insertDict("state");
+    auto &state = *msg.get("state");
+    for (auto it = stateCBs.begin(); it != stateCBs.end(); it++)
+      TRY_CATCH_ERROR(state.insert(it->first, it->second()));
+  }
+
+  peer.setTimeout(30);
+  sendFDs(peer.get(), msg.toString(0, true), fds);
+
+  // Keep serving the listeners until the new process has them
+  char ack = 0;
+  ssize_t ret;
+  do ret = ::recv(peer.get(), &ack, 1, 0);
+  while (ret < 0 && errno == EINTR);
+  if (ret != 1 || ack != ACK) THROW("Socket handoff was not acknowledged");
+
+  LOG_INFO(1, "Handed off " << fds.size() << " listener(s) to PID "
+           << cred.pid);
+#endif
+}
+
+
+void SocketHandoff::run() {
+  bool handedOff = false;
+
+  while (!shouldShutdown() && !handedOff) {
+    if (!server->canRead(0.25)) continue;
+
+    auto peer = server->accept();
+    if (peer.isNull()) continue;
+
+    try {
+      serve(*peer);
+      handedOff = true;
+    } CATCH_ERROR;
+  }
+
+  // Close without removing the path which now belongs to the new process
+  server->close();
+
+  if (handedOff && callback) TRY_CATCH_ERROR(callback());
+}
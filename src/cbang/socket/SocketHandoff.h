@@ -0,0 +1,130 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "SocketType.h"
+
+#include <cbang/os/Thread.h>
+#include <cbang/os/Mutex.h>
+#include <cbang/util/Singleton.h>
+#include <cbang/SmartPointer.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+
+
+namespace cb {
+  class Socket;
+
+  /**
+   * Hand listening sockets from a running process to its replacement so
+   * that connections are accepted throughout a restart.
+   *
+   * The running process registers each listener with add() and serves
+   * them on a Unix socket with listen().  A new process calls receive()
+   * before binding.  It is passed duplicates of the listeners, over
+   * SCM_RIGHTS, and named state such as TLS session ticket keys.  Binding
+   * code then calls take() instead of opening a new socket.  Once the new
+   * process has acknowledged the transfer the old one stops serving
+   * handoffs and calls its callback, typically to drain its connections
+   * and exit.
+   *
+   * Only processes running as the same user, or root, may connect.
+   */
+  class SocketHandoff : public Singleton<SocketHandoff>, protected Thread {
+  public:
+    typedef std::function<std::string ()> state_cb_t;
+    typedef std::function<void ()> callback_t;
+
+  protected:
+    Mutex lock;
+    std::map<std::string, socket_t> listeners;
+    std::map<std::string, state_cb_t> stateCBs;
+
+    std::map<std::string, socket_t> inherited;
+    std::map<std::string, std::string> inheritedState;
+
+    SmartPointer<Socket> server;
+    callback_t callback;
+
+  public:
+    /// The most sockets which can be handed off at once
+    static const unsigned maxSockets = 250;
+
+    SocketHandoff(Inaccessible);
+    ~SocketHandoff();
+
+    /// Offer the listener @param fd under @param name, usually its address
+    void add(const std::string &name, socket_t fd);
+    void remove(const std::string &name);
+
+    /// @param cb is called from the handoff thread to produce the value
+    void addState(const std::string &name, state_cb_t cb);
+    void removeState(const std::string &name);
+
+    /**
+     * Serve handoffs on the Unix socket at @param path, replacing any
+     * socket left there.  @param cb is called from the handoff thread
+     * after a new process has received the listeners.
+     */
+    void listen(const std::string &path, callback_t cb);
+    bool isListening() const {return isRunning();}
+    void stopListening();
+
+    /// Connect to @param path and receive listeners and state
+    void receive(const std::string &path, double timeout = 10);
+
+    /**
+     * Claim an inherited listener.
+     * @return False if no listener named @param name was received.
+     */
+    bool take(const std::string &name, socket_t &fd);
+    /// @return The state named @param name or an empty string
+    std::string getState(const std::string &name) const;
+
+    /// Send @param data and @param fds on the connected Unix socket @param s
+    static void sendFDs(socket_t s, const std::string &data,
+                        const std::vector<socket_t> &fds);
+    /// Receive a message sent with sendFDs()
+    static std::string receiveFDs(socket_t s, std::vector<socket_t> &fds);
+
+  protected:
+    void serve(Socket &peer);
+
+    // From Thread
+    void run();
+  };
+}
@@ -38,3 +38,19 @@ using namespace cb;
 
 
 Socket *SocketImpl::createSocket() {return new Socket;}
+
+
+std::streamsize SocketImpl::writev(const SocketBuffer *bufs, unsigned count,
+                                   unsigned flags) {
+  std::streamsize total = 0;
+
+  for (unsigned i = 0; i < count; i++) {
+    std::streamsize ret = write(bufs[i].data, bufs[i].length, flags);
+    if (ret <= 0) return total ? total : ret;
+
+    total += ret;
+    if (ret < bufs[i].length) break; // Short write
+  }
+
+  return total;
+}
@@ -46,6 +46,30 @@ namespace cb {
   class SSL;
   class SSLContext;
 
+
+  /// A buffer for scatter/gather socket writes
+  struct SocketBuffer {
+    const char *data;
+    std::streamsize length;
+  };
+
+
+  /// A datagram for batched UDP I/O
+  struct SocketMessage {
+    IPAddress ip;           ///< Destination or, when receiving, the source
+    char *data;
+    std::streamsize length; ///< Buffer size or, when receiving, bytes read
+  };
+
+
+  /// The process identity of a Unix domain socket peer
+  struct SocketCredentials {
+    int pid;      ///< Zero where the platform does not report it
+    unsigned uid;
+    unsigned gid;
+  };
+
+
   /// Socket implementation interface
   class SocketImpl {
   protected:
@@ -63,6 +87,7 @@ namespace cb {
     virtual Socket *createSocket();
     virtual bool isOpen() const = 0;
     virtual void setReuseAddr(bool reuse) = 0;
+    virtual void setReusePort(bool reuse) {}
     virtual void setBlocking(bool blocking) = 0;
     virtual bool getBlocking() const = 0;
     virtual void setKeepAlive(bool keepAlive) {}
@@ -73,7 +98,15 @@ namespace cb {
     virtual void setReceiveTimeout(double timeout) {}
     virtual void setReceiveBuf(int size = INT_MAX) {}
     virtual void setSendBuf(int size = INT_MAX) {}
+    virtual void setNoDelay(bool noDelay) {}
+    virtual void setCork(bool cork) {}
+    virtual void setFastOpen(unsigned queueLength) {}
+    virtual void setFastOpenConnect(bool enable) {}
+    virtual void setDeferAccept(unsigned seconds) {}
+    virtual void setBusyPoll(unsigned usec) {}
     virtual void open() = 0;
+    virtual void openUDP() {THROW("UDP not supported");}
+    virtual void openUnix() {THROW("Unix sockets not supported");}
     virtual void bind(const IPAddress &ip) = 0;
     virtual void listen(int backlog) = 0;
     virtual SmartPointer<Socket> accept(IPAddress *ip) = 0;
@@ -82,6 +115,16 @@ namespace cb {
                                   unsigned flags) = 0;
     virtual std::streamsize read(char *data, std::streamsize length,
                                  unsigned flags) = 0;
+    virtual std::streamsize writev(const SocketBuffer *bufs, unsigned count,
+                                   unsigned flags);
+    virtual unsigned sendMessages(const SocketMessage *msgs, unsigned count,
+                                  unsigned flags)
+    {THROW("Batched send not supported");}
+    virtual unsigned receiveMessages(SocketMessage *msgs, unsigned count,
+                                     unsigned flags)
+    {THROW("Batched receive not supported");}
+    virtual bool getPeerCredentials(SocketCredentials &cred) const
+    {return false;}
     virtual void close() = 0;
     virtual socket_t get() const = 0;
     virtual void set(socket_t socket) = 0;
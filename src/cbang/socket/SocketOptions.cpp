@@ -0,0 +1,79 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "SocketOptions.h"
+#include "Socket.h"
+
+#include <cbang/config/Options.h>
+
+using namespace std;
+using namespace cb;
+
+
+void SocketOptions::addOptions(Options &options, const string &prefix) {
+  options.addTarget(prefix + "tcp-nodelay", noDelay, "Disable Nagle's "
+                    "algorithm so that small writes are not delayed.");
+  options.addTarget(prefix + "tcp-fastopen", fastOpen, "Enable TCP Fast "
+                    "Open.  For listeners this is the queue length of pending "
+                    "fast open requests.");
+  options.addTarget(prefix + "tcp-defer-accept", deferAccept, "Accept "
+                    "connections only once data arrives or after this many "
+                    "seconds.  Zero to disable.");
+  options.addTarget(prefix + "socket-busy-poll", busyPoll, "Microseconds to "
+                    "busy poll the device queue on receive.  Zero to "
+                    "disable.");
+  options.addTarget(prefix + "socket-send-buffer", sendBuffer, "Socket send "
+                    "buffer size in bytes.  Zero for the default.");
+  options.addTarget(prefix + "socket-receive-buffer", receiveBuffer, "Socket "
+                    "receive buffer size in bytes.  Zero for the default.");
+}
+
+
+void SocketOptions::applyListener(Socket &socket) const {
+  if (fastOpen) socket.setFastOpen(fastOpen);
+  if (deferAccept) socket.setDeferAccept(deferAccept);
+  if (receiveBuffer) socket.setReceiveBuffer(receiveBuffer);
+}
+
+
+void SocketOptions::applyAccepted(Socket &socket) const {
+  if (noDelay) socket.setNoDelay(true);
+  if (busyPoll) socket.setBusyPoll(busyPoll);
+  if (sendBuffer) socket.setSendBuffer(sendBuffer);
+  if (receiveBuffer) socket.setReceiveBuffer(receiveBuffer);
+}
+
+
+void SocketOptions::applyConnect(Socket &socket) const {
+  applyAccepted(socket);
+  if (fastOpen) socket.setFastOpenConnect(true);
+}
@@ -0,0 +1,65 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <string>
+
+
+namespace cb {
+  class Socket;
+  class Options;
+
+  /// TCP tuning applied to listeners, accepted and outgoing sockets
+  class SocketOptions {
+  public:
+    bool noDelay;
+    unsigned fastOpen;    ///< Listener queue length, non-zero for clients
+    unsigned deferAccept; ///< Seconds
+    unsigned busyPoll;    ///< Microseconds
+    int sendBuffer;       ///< Zero for the system default
+    int receiveBuffer;    ///< Zero for the system default
+
+    SocketOptions() :
+      noDelay(false), fastOpen(0), deferAccept(0), busyPoll(0),
+      sendBuffer(0), receiveBuffer(0) {}
+
+    /// Register each setting as an option named with @param prefix
+    void addOptions(Options &options, const std::string &prefix = "");
+
+    /// Call between bind() and listen()
+    void applyListener(Socket &socket) const;
+    void applyAccepted(Socket &socket) const;
+    /// Call before connect()
+    void applyConnect(Socket &socket) const;
+  };
+}
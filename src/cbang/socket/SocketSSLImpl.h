@@ -64,6 +64,15 @@ namespace cb {
     std::streamsize write(const char *data, std::streamsize length,
                           unsigned flags);
     std::streamsize read(char *data, std::streamsize length, unsigned flags);
+    std::streamsize writev(const SocketBuffer *bufs, unsigned count,
+                           unsigned flags)
+    {return SocketImpl::writev(bufs, count, flags);}
+    unsigned sendMessages(const SocketMessage *msgs, unsigned count,
+                          unsigned flags)
+    {return SocketImpl::sendMessages(msgs, count, flags);}
+    unsigned receiveMessages(SocketMessage *msgs, unsigned count,
+                             unsigned flags)
+    {return SocketImpl::receiveMessages(msgs, count, flags);}
     void close();
   };
 }
@@ -48,6 +48,7 @@ using namespace std;
 using namespace cb;
 
 
+SocketServer::SocketServer() : sockSet(true) {}
 SocketServer::~SocketServer() {} // Hide destructor
 
 
@@ -91,16 +92,27 @@ void SocketServer::startup() {
 }
 
 
+double SocketServer::getServiceTimeout() const {
+  // Without wake() support poll so that stop() is noticed
+  return SocketSet::canWake() ? -1 : 0.1;
+}
+
+
+void SocketServer::wake() {sockSet.wake();}
+
+
 void SocketServer::service() {
   // Add listeners
-  SocketSet sockSet;
+  sockSet.clear();
   for (unsigned i = 0; i < ports.size(); i++)
     sockSet.add(ports[i]->socket, SocketSet::READ);
 
   // Add others
   addConnectionSockets(sockSet);
 
-  if (sockSet.select(0.1) || connectionsReady()) {
+  double timeout = connectionsReady() ? 0 : getServiceTimeout();
+
+  if (sockSet.select(timeout) || !timeout) {
     // Process connections
     processConnections(sockSet);
 
@@ -122,6 +134,9 @@ void SocketServer::service() {
             continue;
           }
 
+          // The descriptor may have been used by a closed connection
+          sockSet.forget(*client);
+
           SocketConnectionPtr con = createConnection(client, clientIP);
           con->setIncomingIP(ports[i]->ip);
           client = 0; // Release socket pointer
@@ -181,6 +196,12 @@ void SocketServer::start() {
 }
 
 
+void SocketServer::stop() {
+  Thread::stop();
+  wake();
+}
+
+
 void SocketServer::run() {
   try {
     Timer timer;
@@ -33,6 +33,7 @@
 #pragma once
 
 #include "Socket.h"
+#include "SocketSet.h"
 #include "SocketConnection.h"
 
 #include <cbang/os/Thread.h>
@@ -44,7 +45,6 @@
 #include <list>
 
 namespace cb {
-  class SocketSet;
   class SSLContext;
 
   class SocketServer : public Thread, public Mutex {
@@ -64,10 +64,12 @@ namespace cb {
     connections_t connections;
 
     IPAddressFilter ipFilter;
+    SocketSet sockSet;
 
   public:
     typedef connections_t::const_iterator iterator;
 
+    SocketServer();
     virtual ~SocketServer();
 
     Socket &addListenPort(const IPAddress &ip,
@@ -93,6 +95,15 @@ namespace cb {
     virtual void processConnections(SocketSet &sockSet) {}
     virtual void closeConnection(const SocketConnectionPtr &con) {};
 
+    /**
+     * @return The longest service() should wait for socket activity or -1 to
+     * wait until activity or wake().
+     */
+    virtual double getServiceTimeout() const;
+
+    /// Interrupt service() if it is waiting on sockets.
+    void wake();
+
     // These functions should only be called directly if threading is not used
     virtual void startup();
     virtual void service();
@@ -102,6 +113,7 @@ namespace cb {
 
     // From Thread
     void start();
+    void stop();
 
   protected:
     // From Thread
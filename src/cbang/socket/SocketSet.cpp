@@ -30,6 +30,7 @@
 
 \******************************************************************************/
 
+
 #include "SocketSet.h"
 
 #include "Winsock.h"
@@ -45,13 +46,349 @@
 
 #include <cbang/os/SysError.h>
 
+#if defined(__linux__)
+#define CBANG_SOCKET_EPOLL
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || \
+  defined(__NetBSD__) || defined(__DragonFly__)
+#define CBANG_SOCKET_KQUEUE
+#endif
+
 #ifndef _WIN32
 #include <sys/select.h>
 #include <sys/types.h>
 #endif
 
+#if defined(CBANG_SOCKET_EPOLL)
+#include <sys/epoll.h>
+#elif defined(CBANG_SOCKET_KQUEUE)
+#include <sys/event.h>
+#include <sys/time.h>
+#endif
+
+#if defined(CBANG_SOCKET_EPOLL) || defined(CBANG_SOCKET_KQUEUE)
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <map>
+#include <vector>
+#endif
+
 using namespace cb;
 
+
+#if defined(CBANG_SOCKET_EPOLL) || defined(CBANG_SOCKET_KQUEUE)
+struct SocketSet::private_t {
+  typedef std::map<socket_t, int> events_t;
+
+  int fd;
+  int wakeFDs[2];
+  bool edgeTriggered;
+
+  events_t interest;   // What the caller asked for
+  events_t registered; // What the kernel knows
+  events_t ready;      // Results of the last select()
+
+  private_t() : fd(-1), edgeTriggered(false) {wakeFDs[0] = wakeFDs[1] = -1;}
+  private_t(const private_t &o) :
+    fd(-1), edgeTriggered(o.edgeTriggered), interest(o.interest) {
+    wakeFDs[0] = wakeFDs[1] = -1;
+  }
+
+
+  ~private_t() {
+    if (fd != -1) ::close(fd);
+    if (wakeFDs[0] != -1) ::close(wakeFDs[0]);
+    if (wakeFDs[1] != -1) ::close(wakeFDs[1]);
+  }
+
+
+  void open() {
+    if (fd != -1) return;
+
+#ifdef CBANG_SOCKET_EPOLL
+    fd = epoll_create1(EPOLL_CLOEXEC);
+    if (fd == -1) THROW("epoll_create1() " << SysError());
+#else
+    fd = kqueue();
+    if (fd == -1) THROW("kqueue() " << SysError());
+#endif
+
+    // Wake pipe, always level triggered
+    if (::pipe(wakeFDs)) THROW("pipe() " << SysError());
+
+    for (unsigned i = 0; i < 2; i++) {
+      fcntl(wakeFDs[i], F_SETFL, fcntl(wakeFDs[i], F_GETFL) | O_NONBLOCK);
+      fcntl(wakeFDs[i], F_SETFD, FD_CLOEXEC);
+    }
+
+    ctl(wakeFDs[0], 0, READ, false);
+  }
+
+
+  void forget(socket_t s) {
+    events_t::iterator it = registered.find(s);
+    if (it == registered.end()) return;
+
+    ctl(s, it->second, 0, true);
+    registered.erase(it);
+  }
+
+
+  void sync() {
+    open();
+
+    // Drop registrations no longer wanted
+    for (events_t::iterator it = registered.begin(); it != registered.end();) {
+      if (interest.find(it->first) == interest.end()) {
+        ctl(it->first, it->second, 0, true);
+        registered.erase(it++);
+
+      } else it++;
+    }
+
+    // Add or update the rest
+    for (events_t::iterator it = interest.begin(); it != interest.end();
+         it++) {
+      int &current = registered[it->first];
+      if (current == it->second) continue;
+
+      ctl(it->first, current, it->second, edgeTriggered);
+      current = it->second;
+    }
+  }
+
+
+#ifdef CBANG_SOCKET_EPOLL
+  static uint32_t toEPoll(int type) {
+    return ((type & READ) ? EPOLLIN : 0) | ((type & WRITE) ? EPOLLOUT : 0) |
+      ((type & EXCEPT) ? EPOLLPRI : 0);
+  }
+
+
+  void ctl(int s, int from, int to, bool edge) {
+    struct epoll_event ev;
+    ev.events = toEPoll(to) | (edge ? EPOLLET : 0);
+    ev.data.fd = s;
+
+    if (!to) {
+      // Fails if the descriptor has already been closed
+      epoll_ctl(fd, EPOLL_CTL_DEL, s, &ev);
+      return;
+    }
+
+    int op = from ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if (!epoll_ctl(fd, op, s, &ev)) return;
+
+    // The kernel's view may differ from ours if a descriptor was reused
+    if (errno == ENOENT && op == EPOLL_CTL_MOD) op = EPOLL_CTL_ADD;
+    else if (errno == EEXIST && op == EPOLL_CTL_ADD) op = EPOLL_CTL_MOD;
+    else THROW("epoll_ctl() " << SysError());
+
+    if (epoll_ctl(fd, op, s, &ev)) THROW("epoll_ctl() " << SysError());
+  }
+
+
+  int wait(double timeout) {
+    std::vector<struct epoll_event> events(registered.size() + 1);
+    int t = timeout < 0 ? -1 : (int)(timeout * 1000 + 0.5);
+
+    int ret = epoll_wait(fd, &events[0], events.size(), t);
+    if (ret < 0) {
+      if (errno == EINTR) return 0;
+      THROW("epoll_wait() " << SysError());
+    }
+
+    int count = 0;
+    for (int i = 0; i < ret; i++) {
+      int s = events[i].data.fd;
+      uint32_t e = events[i].events;
+
+      if (s == wakeFDs[0]) {drain(); continue;}
+
+      // Like select(), report errors and hangups as readable and writable
+      int type = 0;
+      if (e & (EPOLLIN | EPOLLERR | EPOLLHUP)) type |= READ;
+      if (e & (EPOLLOUT | EPOLLERR | EPOLLHUP)) type |= WRITE;
+      if (e & EPOLLPRI) type |= EXCEPT;
+
+      if ((type &= interest[s])) {ready[s] = type; count++;}
+    }
+
+    return count;
+  }
+
+#else // CBANG_SOCKET_KQUEUE
+  void ctl(int s, int from, int to, bool edge) {
+    struct kevent changes[2];
+    int n = 0;
+
+    // kqueue has no equivalent of select()'s exceptional conditions.  They
+    // are reported along with EV_EOF on the read filter instead.
+    bool fromRead = from & (READ | EXCEPT);
+    bool toRead = to & (READ | EXCEPT);
+    bool fromWrite = from & WRITE;
+    bool toWrite = to & WRITE;
+    unsigned short flags = EV_RECEIPT | (edge ? EV_CLEAR : 0);
+
+    if (fromRead != toRead)
+      EV_SET(&changes[n++], s, EVFILT_READ,
+             flags | (toRead ? EV_ADD : EV_DELETE), 0, 0, 0);
+    if (fromWrite != toWrite)
+      EV_SET(&changes[n++], s, EVFILT_WRITE,
+             flags | (toWrite ? EV_ADD : EV_DELETE), 0, 0, 0);
+    if (!n) return;
+
+    struct kevent results[2];
+    int ret = kevent(fd, changes, n, results, n, 0);
+    if (ret < 0) THROW("kevent() " << SysError());
+
+    for (int i = 0; i < ret; i++) {
+      int err = (results[i].flags & EV_ERROR) ? (int)results[i].data : 0;
+
+      // Deletes fail if the descriptor has already been closed
+      if (err && !(changes[i].flags & EV_DELETE))
+        THROW("kevent() " << SysError(err));
+    }
+  }
+
+
+  int wait(double timeout) {
+    std::vector<struct kevent> events(2 * registered.size() + 1);
+    struct timespec ts = Timer::toTimeSpec(timeout < 0 ? 0 : timeout);
+
+    int ret = kevent(fd, 0, 0, &events[0], events.size(),
+                     timeout < 0 ? 0 : &ts);
+    if (ret < 0) {
+      if (errno == EINTR) return 0;
+      THROW("kevent() " << SysError());
+    }
+
+    int count = 0;
+    for (int i = 0; i < ret; i++) {
+      int s = (int)events[i].ident;
+
+      if (s == wakeFDs[0]) {drain(); continue;}
+
+      int type = 0;
+      if (events[i].filter == EVFILT_READ) type |= READ;
+      if (events[i].filter == EVFILT_WRITE) type |= WRITE;
+      if (events[i].flags & (EV_EOF | EV_ERROR)) type |= EXCEPT;
+
+      if ((type &= interest[s])) {
+        int &r = ready[s];
+        if (!r) count++;
+        r |= type;
+      }
+    }
+
+    return count;
+  }
+#endif // CBANG_SOCKET_KQUEUE
+
+
+  void drain() {
+    char buf[64];
+    while (0 < ::read(wakeFDs[0], buf, sizeof(buf))) continue;
+  }
+};
+
+
+SocketSet::SocketSet(bool wakeable) : p(new private_t), maxFD(-1) {
+  Socket::initialize();
+  if (wakeable) p->open();
+}
+
+
+SocketSet::SocketSet(const SocketSet &s) :
+  p(new private_t(*s.p)), maxFD(s.maxFD) {}
+
+
+SocketSet::~SocketSet() {
+  zap(p);
+}
+
+
+void SocketSet::clear() {
+  p->interest.clear();
+  p->ready.clear();
+  maxFD = -1;
+}
+
+
+void SocketSet::add(const Socket &socket, int type) {
+  if (!socket.isOpen()) THROW("Socket not open");
+  socket_t s = (socket_t)socket.get();
+
+  if (type & ALL) p->interest[s] |= type & ALL;
+  if (maxFD < (int)s) maxFD = s;
+}
+
+
+void SocketSet::remove(const Socket &socket, int type) {
+  if (!socket.isOpen()) THROW("Socket not open");
+  socket_t s = (socket_t)socket.get();
+
+  private_t::events_t::iterator it = p->interest.find(s);
+  if (it == p->interest.end()) return;
+
+  if (!(it->second &= ~type)) p->interest.erase(it);
+
+  it = p->ready.find(s);
+  if (it != p->ready.end() && !(it->second &= ~type)) p->ready.erase(it);
+}
+
+
+bool SocketSet::isSet(const Socket &socket, int type) const {
+  if (!socket.isOpen()) THROW("Socket not open");
+  socket_t s = (socket_t)socket.get();
+
+  private_t::events_t::const_iterator it;
+
+  if (SocketDebugger::instance().isEnabled()) {
+    it = p->interest.find(s);
+    return it != p->interest.end() && (it->second & type & (READ | WRITE));
+  }
+
+  it = p->ready.find(s);
+  return it != p->ready.end() && (it->second & type);
+}
+
+
+void SocketSet::forget(const Socket &socket) {
+  if (!socket.isOpen()) THROW("Socket not open");
+  p->forget((socket_t)socket.get());
+}
+
+
+void SocketSet::setEdgeTriggered(bool edgeTriggered) {
+  if (p->fd != -1) THROW("Edge triggering must be set before select()");
+  p->edgeTriggered = edgeTriggered;
+}
+
+
+bool SocketSet::canWake() {return true;}
+
+
+void SocketSet::wake() {
+  if (p->wakeFDs[1] == -1) THROW("SocketSet not wakeable");
+  if (::write(p->wakeFDs[1], "", 1) < 0 && errno != EAGAIN)
+    THROW("Wake failed: " << SysError());
+}
+
+
+bool SocketSet::select(double timeout) {
+  if (SocketDebugger::instance().isEnabled()) return true;
+
+  p->ready.clear();
+  p->sync();
+
+  SysError::clear();
+  return p->wait(timeout);
+}
+
+
+#else // select()
 struct SocketSet::private_t {
   fd_set read;
   fd_set write;
@@ -59,7 +396,7 @@ struct SocketSet::private_t {
 };
 
 
-SocketSet::SocketSet() : p(new private_t) {
+SocketSet::SocketSet(bool wakeable) : p(new private_t) {
   Socket::initialize();
   clear();
 }
@@ -117,6 +454,18 @@ bool SocketSet::isSet(const Socket &socket, int type) const {
 }
 
 
+void SocketSet::forget(const Socket &socket) {}
+
+
+void SocketSet::setEdgeTriggered(bool edgeTriggered) {
+  if (edgeTriggered) THROW("Edge triggering not supported by select()");
+}
+
+
+bool SocketSet::canWake() {return false;}
+void SocketSet::wake() {}
+
+
 bool SocketSet::select(double timeout) {
   if (SocketDebugger::instance().isEnabled()) return true;
 
@@ -130,3 +479,4 @@ bool SocketSet::select(double timeout) {
   if (ret < 0) THROW("select() " << SysError());
   return ret;
 }
+#endif // select()
@@ -37,6 +37,17 @@
 namespace cb {
   class Socket;
 
+  /**
+   * A set of sockets to wait on.  On Linux this uses epoll and on BSD and
+   * OS X kqueue, otherwise select().
+   *
+   * With epoll and kqueue the set keeps its kernel registrations between
+   * calls to select() and only sends changes.  It may therefore be cleared
+   * and refilled on every iteration of a loop without paying for each socket.
+   * Because the OS silently drops the registrations of closed sockets a
+   * socket reusing such a descriptor must be passed to forget() before being
+   * added to a set which outlived the old socket.
+   */
   class SocketSet {
     struct private_t;
     private_t *p;
@@ -50,7 +61,8 @@ namespace cb {
       ALL    = READ | WRITE | EXCEPT
     } type_t;
 
-    SocketSet();
+    /// @param wakeable Allow wake() to be called from other threads.
+    SocketSet(bool wakeable = false);
     SocketSet(const SocketSet &s);
     ~SocketSet();
 
@@ -59,6 +71,26 @@ namespace cb {
     void remove(const Socket &socket, int type = ALL);
     bool isSet(const Socket &socket, int type = ALL) const;
 
+    /// Drop any registration held for this socket's descriptor.
+    void forget(const Socket &socket);
+
+    /**
+     * Only report sockets when they become ready rather than while they are
+     * ready.  Ready sockets must then be read or written until they would
+     * block.  Must be called before the first select().  Only supported with
+     * epoll and kqueue.
+     */
+    void setEdgeTriggered(bool edgeTriggered);
+
+    /// @return True if wake() can interrupt select() on this platform.
+    static bool canWake();
+
+    /**
+     * Cause a blocked select() to return.  Safe to call from any thread if
+     * the set was constructed wakeable.  Does nothing if canWake() is false.
+     */
+    void wake();
+
     /**
      * Check if the sockets in the set are ready.
      *
@@ -0,0 +1,136 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/String.h>
+#include <cbang/json/Sink.h>
+
+#include <string>
+#include <type_traits>
+
+
+namespace cb {
+  namespace MakeStruct {
+    /// FNV-1a, usable in case labels.  Equal hashes fail to compile.
+    constexpr uint32_t hash(const char *s, uint32_t h = 2166136261u) {
+      return *s ? hash(s + 1, (h ^ (uint8_t)*s) * 16777619u) : h;
+    }
+
+
+    inline uint32_t hash(const std::string &s) {return hash(s.c_str());}
+
+
+    // Write members to a Sink
+    inline void writeJSON(JSON::Sink &sink, bool value) {
+      sink.writeBoolean(value);
+    }
+
+
+    inline void writeJSON(JSON::Sink &sink, const std::string &value) {
+      sink.write(value);
+    }
+
+
+    template <typename T, typename F>
+    typename std::enable_if<std::is_integral<T>::value &&
+                            std::is_signed<T>::value>::type
+    writeJSON(JSON::Sink &sink, T value, F) {sink.write((int64_t)value);}
+
+
+    template <typename T, typename F>
+    typename std::enable_if<std::is_integral<T>::value &&
+                            !std::is_signed<T>::value>::type
+    writeJSON(JSON::Sink &sink, T value, F) {sink.write((uint64_t)value);}
+
+
+    template <typename T, typename F>
+    typename std::enable_if<std::is_floating_point<T>::value>::type
+    writeJSON(JSON::Sink &sink, T value, F) {sink.write((double)value);}
+
+
+    template <typename F>
+    void writeJSON(JSON::Sink &sink, bool value, F) {writeJSON(sink, value);}
+
+
+    template <typename F>
+    void writeJSON(JSON::Sink &sink, const std::string &value, F) {
+      writeJSON(sink, value);
+    }
+
+
+    /// Other types are written as strings with the member's PRINT
+    template <typename T, typename F>
+    typename std::enable_if<!std::is_arithmetic<T>::value>::type
+    writeJSON(JSON::Sink &sink, const T &value, F print) {sink.write(print());}
+
+
+    // Assign Sink values to members
+    inline std::string toString(const std::string &value) {return value;}
+    inline std::string toString(bool value) {return value ? "true" : "false";}
+    template <typename V>
+    std::string toString(V value) {return cb::String(value);}
+
+
+    template <typename T, typename V, typename F>
+    typename std::enable_if<std::is_arithmetic<T>::value &&
+                            std::is_arithmetic<V>::value>::type
+    assignJSON(T &member, V value, F) {member = (T)value;}
+
+
+    template <typename T, typename F>
+    typename std::enable_if<std::is_arithmetic<T>::value>::type
+    assignJSON(T &member, const std::string &value, F parse) {
+      member = parse(value);
+    }
+
+
+    template <typename F>
+    void assignJSON(std::string &member, const std::string &value, F) {
+      member = value;
+    }
+
+
+    /// Other types are parsed from strings with the member's PARSE
+    template <typename T, typename V, typename F>
+    typename std::enable_if<!std::is_arithmetic<T>::value &&
+                            !std::is_same<T, std::string>::value>::type
+    assignJSON(T &member, const V &value, F parse) {
+      member = parse(toString(value));
+    }
+
+
+    template <typename V, typename F>
+    typename std::enable_if<std::is_arithmetic<V>::value>::type
+    assignJSON(std::string &member, V value, F) {member = toString(value);}
+  }
+}
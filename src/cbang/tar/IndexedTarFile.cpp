@@ -0,0 +1,313 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "IndexedTarFile.h"
+
+#include <cbang/String.h>
+#include <cbang/os/SystemUtilities.h>
+#include <cbang/Catch.h>
+#include <cbang/log/Logger.h>
+#include <cbang/iostream/BZip2Decompressor.h>
+#include <cbang/iostream/ZstdDecompressor.h>
+#include <cbang/iostream/LZ4Decompressor.h>
+
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+namespace io = boost::iostreams;
+
+#include <algorithm>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace cb;
+using namespace std;
+
+
+namespace {
+  const char *indexMagic = "cbang-tar-index 1";
+
+
+  uint64_t padded(uint64_t size) {return (size + 511) & ~(uint64_t)511;}
+
+
+  class DecompressingStream : public io::filtering_istream {
+    SmartPointer<istream> file;
+
+  public:
+    DecompressingStream(const SmartPointer<istream> &file,
+                        TarFile::compression_t compression) : file(file) {
+      switch (compression) {
+      case TarFile::TARFILE_BZIP2: push(BZip2Decompressor()); break;
+      case TarFile::TARFILE_GZIP: push(io::zlib_decompressor()); break;
+#ifdef HAVE_ZSTD
+      case TarFile::TARFILE_ZSTD: push(ZstdDecompressor()); break;
+#endif
+#ifdef HAVE_LZ4
+      case TarFile::TARFILE_LZ4: push(LZ4Decompressor()); break;
+#endif
+      default: THROW("Invalid compression type " << compression);
+      }
+
+      push(*file);
+    }
+
+    ~DecompressingStream() {reset();}
+  };
+}
+
+
+struct IndexedTarFile::private_t {
+  const char *data = 0;
+  uint64_t length = 0;
+};
+
+
+bool IndexedTarFile::Entry::isFile() const {
+  return type == TarHeader::NORMAL_FILE || type == TarHeader::CONTIGUOUS_FILE;
+}
+
+
+IndexedTarFile::IndexedTarFile(const string &path, compression_t compression,
+                               const string &_indexPath) :
+  path(path), compression(compression == TARFILE_AUTO ? infer(path) :
+                          compression),
+  archiveSize(SystemUtilities::getFileSize(path)),
+  archiveModTime(SystemUtilities::getModificationTime(path)),
+  pri(new private_t) {
+
+  string indexPath = _indexPath.empty() ? path + ".idx" : _indexPath;
+  bool loaded = false;
+
+  if (indexPath != "-" && SystemUtilities::exists(indexPath))
+    try {
+      loaded = loadIndex(*SystemUtilities::iopen(indexPath));
+      if (!loaded) LOG_INFO(3, "Tar index '" << indexPath << "' is stale");
+    } CATCH_WARNING;
+
+  if (!loaded) {
+    buildIndex();
+
+    if (indexPath != "-")
+      try {
+        saveIndex(*SystemUtilities::oopen(indexPath));
+      } CATCH_WARNING;
+  }
+
+  if (this->compression == TARFILE_NONE) map();
+}
+
+
+IndexedTarFile::~IndexedTarFile() {
+#ifndef _WIN32
+  if (pri->data) munmap((void *)pri->data, pri->length);
+#endif
+  delete pri;
+}
+
+
+bool IndexedTarFile::isMapped() const {return pri->data;}
+
+
+const IndexedTarFile::Entry *IndexedTarFile::find(const string &name) const {
+  auto it = index.find(name);
+  return it == index.end() ? 0 : &entries[it->second];
+}
+
+
+const IndexedTarFile::Entry &IndexedTarFile::get(const string &name) const {
+  const Entry *entry = find(name);
+  if (!entry) THROW("'" << name << "' not found in tar file '" << path << "'");
+  return *entry;
+}
+
+
+const char *IndexedTarFile::getData(const Entry &entry) const {
+  if (!pri->data) THROW("Tar file '" << path << "' is not memory mapped");
+  return pri->data + entry.offset;
+}
+
+
+string IndexedTarFile::read(const Entry &entry) const {
+  if (pri->data) return string(getData(entry), entry.size);
+
+  ostringstream str;
+  extract(entry, str);
+  return str.str();
+}
+
+
+void IndexedTarFile::extract(const Entry &entry, ostream &out) const {
+  if (pri->data) {
+    out.write(getData(entry), entry.size);
+    if (out.fail()) THROW("Failed to write '" << entry.filename << "'");
+    return;
+  }
+
+  SmartPointer<istream> in = open();
+  if (compression == TARFILE_NONE) in->seekg(entry.offset);
+  else in->ignore(entry.offset);
+
+  vector<char> buf(1 << 20);
+  uint64_t remaining = entry.size;
+
+  while (remaining) {
+    in->read(&buf[0], min((uint64_t)buf.size(), remaining));
+    streamsize n = in->gcount();
+    if (!n) THROW("Error reading '" << entry.filename << "' from " << path);
+
+    out.write(&buf[0], n);
+    if (out.fail()) THROW("Failed to write '" << entry.filename << "'");
+    remaining -= n;
+  }
+}
+
+
+void IndexedTarFile::buildIndex() {
+  LOG_INFO(3, "Indexing tar file '" << path << "'");
+
+  entries.clear();
+  index.clear();
+
+  SmartPointer<istream> in = open();
+  TarHeader header;
+  uint64_t offset = 0;
+
+  // A missing footer is tolerated
+  while (header.read(*in) && !header.isEOF()) {
+    offset += 512;
+
+    Entry entry;
+    entry.filename = header.getFilename();
+    entry.type = header.getType();
+    entry.mode = header.getMode();
+    entry.modTime = header.getModTime();
+    entry.size = header.getSize();
+    entry.offset = offset;
+    add(entry);
+
+    // Skip the data without reading it when possible
+    offset += padded(entry.size);
+    if (compression == TARFILE_NONE) in->seekg(offset);
+    else in->ignore(padded(entry.size));
+  }
+}
+
+
+bool IndexedTarFile::loadIndex(istream &stream) {
+  entries.clear();
+  index.clear();
+
+  string line;
+  if (!getline(stream, line) || line != indexMagic)
+    THROW("Invalid tar index");
+
+  vector<string> tokens;
+  if (!getline(stream, line) || String::tokenize(line, tokens) != 2)
+    THROW("Invalid tar index");
+
+  if (String::parseU64(tokens[0]) != archiveSize ||
+      String::parseU64(tokens[1]) != archiveModTime) return false;
+
+  while (getline(stream, line)) {
+    tokens.clear();
+    if (String::tokenize(line, tokens, " ", false, 6) != 6)
+      THROW("Invalid tar index entry: " << line);
+
+    Entry entry;
+    entry.offset = String::parseU64(tokens[0]);
+    entry.size = String::parseU64(tokens[1]);
+    entry.modTime = String::parseU64(tokens[2]);
+    entry.mode = String::parseU32(tokens[3]);
+    entry.type = (TarHeader::type_t)String::parseU32(tokens[4]);
+    entry.filename = String::unescapeC(tokens[5]);
+
+    if (compression == TARFILE_NONE &&
+        archiveSize < entry.offset + entry.size)
+      THROW("Invalid tar index entry: " << line);
+
+    add(entry);
+  }
+
+  return true;
+}
+
+
+void IndexedTarFile::saveIndex(ostream &stream) const {
+  stream << indexMagic << '\n' << archiveSize << ' ' << archiveModTime << '\n';
+
+  for (auto it = begin(); it != end(); it++)
+    stream << it->offset << ' ' << it->size << ' ' << it->modTime << ' '
+           << it->mode << ' ' << (unsigned)it->type << ' '
+           << String::escapeC(it->filename) << '\n';
+
+  if (stream.fail()) THROW("Failed to write tar index");
+}
+
+
+void IndexedTarFile::add(const Entry &entry) {
+  // Later entries replace earlier ones, as when tar extracts the archive
+  index[entry.filename] = entries.size();
+  entries.push_back(entry);
+}
+
+
+void IndexedTarFile::map() {
+#ifndef _WIN32
+  if (!archiveSize || (size_t)archiveSize != archiveSize) return;
+
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd == -1) return;
+
+  void *data = mmap(0, archiveSize, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+
+  if (data == MAP_FAILED) {
+    LOG_DEBUG(3, "Failed to memory map '" << path << "'");
+    return;
+  }
+
+  pri->data = (const char *)data;
+  pri->length = archiveSize;
+#endif
+}
+
+
+SmartPointer<istream> IndexedTarFile::open() const {
+  SmartPointer<istream> file = SystemUtilities::iopen(path);
+  if (compression == TARFILE_NONE) return file;
+  return new DecompressingStream(file, compression);
+}
@@ -0,0 +1,112 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "TarFile.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+
+
+namespace cb {
+  /**
+   * Random access to the files in a tar archive.  The offset of each file
+   * is found with one pass over the archive and kept in a sidecar index,
+   * by default "<path>.idx", which is reused while the archive's size and
+   * modification time are unchanged.  Uncompressed archives are memory
+   * mapped, where supported, so file data can be read without copying.
+   * Compressed archives must still be decompressed up to the file.
+   */
+  class IndexedTarFile : public TarFile {
+  public:
+    struct Entry {
+      std::string filename;
+      TarHeader::type_t type;
+      uint32_t mode;
+      uint64_t modTime;
+      uint64_t size;
+      uint64_t offset; ///< Of the data in the uncompressed archive
+
+      bool isFile() const;
+    };
+
+    typedef std::vector<Entry> entries_t;
+    typedef entries_t::const_iterator iterator;
+
+  protected:
+    std::string path;
+    compression_t compression;
+    uint64_t archiveSize;
+    uint64_t archiveModTime;
+
+    entries_t entries;
+    std::map<std::string, unsigned> index;
+
+    struct private_t;
+    private_t *pri;
+
+  public:
+    /// An empty @param indexPath uses "<path>.idx", "-" disables the sidecar
+    IndexedTarFile(const std::string &path,
+                   compression_t compression = TARFILE_AUTO,
+                   const std::string &indexPath = std::string());
+    ~IndexedTarFile();
+
+    const std::string &getPath() const {return path;}
+    compression_t getCompression() const {return compression;}
+    bool isMapped() const;
+
+    unsigned getCount() const {return entries.size();}
+    iterator begin() const {return entries.begin();}
+    iterator end() const {return entries.end();}
+
+    const Entry *find(const std::string &filename) const;
+    const Entry &get(const std::string &filename) const;
+
+    /// A pointer to the file's data, valid for the life of this object
+    const char *getData(const Entry &entry) const;
+    std::string read(const Entry &entry) const;
+    void extract(const Entry &entry, std::ostream &out) const;
+
+    void buildIndex();
+    bool loadIndex(std::istream &stream);
+    void saveIndex(std::ostream &stream) const;
+
+  protected:
+    void add(const Entry &entry);
+    void map();
+    SmartPointer<std::istream> open() const;
+  };
+}
@@ -192,6 +192,16 @@ void Tar::readFile(ostream &dst, istream &src) {
 }
 
 
+void Tar::readFile(char *dst, istream &src) {
+  streamsize size = getSize();
+
+  src.read(dst, size);
+  if (src.gcount() != size) THROW("Error reading tar file");
+
+  src.ignore(compute_padding(size));
+}
+
+
 void Tar::skipFile(istream &src) {
   src.ignore(getSize() + compute_padding(getSize()));
 }
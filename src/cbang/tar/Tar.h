@@ -64,6 +64,8 @@ namespace cb {
 
     /// NOTE: You must call readHeader() and check TarHeader::isEOF()
     void readFile(std::ostream &dst, std::istream &src);
+    /// Read the file into @param dst which must have room for getSize()
+    void readFile(char *dst, std::istream &src);
     /// NOTE: You must call readHeader() and check TarHeader::isEOF()
     void skipFile(std::istream &src);
   };
@@ -48,6 +48,8 @@ namespace cb {
       TARFILE_BZIP2,
       TARFILE_GZIP,
       TARFILE_NONE,
+      TARFILE_ZSTD,
+      TARFILE_LZ4,
     } compression_t;
 
     static compression_t infer(const std::string &path);
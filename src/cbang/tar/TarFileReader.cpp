@@ -34,18 +34,108 @@
 
 #include <cbang/os/SystemUtilities.h>
 #include <cbang/os/SysError.h>
+#include <cbang/os/ParallelPipeline.h>
+#include <cbang/String.h>
 #include <cbang/log/Logger.h>
 #include <cbang/iostream/BZip2Decompressor.h>
+#include <cbang/iostream/ZstdDecompressor.h>
+#include <cbang/iostream/LZ4Decompressor.h>
+#ifdef HAVE_OPENSSL
+#include <cbang/iostream/AEADDecryptor.h>
+#endif
 
 #include <boost/ref.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/filter/zlib.hpp>
 namespace io = boost::iostreams;
 
+#include <set>
+#include <vector>
+#include <functional>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 using namespace cb;
 using namespace std;
 
 
+namespace {
+  struct Item {
+    std::string path;
+    uint32_t mode = 0;
+    std::vector<char> data;
+  };
+
+
+  void saveFile(const string &path, const char *data, uint64_t length,
+                uint32_t mode) {
+#ifdef _WIN32
+    SmartPointer<ostream> out = SystemUtilities::oopen(path);
+    out->write(data, length);
+    if (out->fail()) THROW("Failed to write '" << path << "'");
+
+#else // _WIN32
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+                    (mode & 0777) ? (mode & 0777) : 0644);
+    if (fd == -1) THROW("Failed to open '" << path << "': " << SysError());
+
+#ifdef __linux__
+    // Allocate the whole file up front so it is laid out contiguously
+    if (length) posix_fallocate(fd, 0, length);
+#endif // __linux__
+
+    while (length) {
+      ssize_t n = ::write(fd, data, length);
+
+      if (n < 0) {
+        if (errno == EINTR) continue;
+        int err = errno;
+        ::close(fd);
+        THROW("Failed to write '" << path << "': " << SysError(err));
+      }
+
+      data += n;
+      length -= n;
+    }
+
+    if (::close(fd))
+      THROW("Failed to close '" << path << "': " << SysError());
+#endif // _WIN32
+  }
+
+
+  void syncPath(const string &path) {
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) THROW("Failed to open '" << path << "': " << SysError());
+
+    int ret = fsync(fd);
+    int err = errno;
+    ::close(fd);
+
+    if (ret) THROW("Failed to sync '" << path << "': " << SysError(err));
+#endif // _WIN32
+  }
+
+
+  string checkPath(const string &name) {
+    vector<string> parts;
+    String::tokenize(name, parts, "/");
+
+    if (name.empty() || name[0] == '/')
+      THROW("Refusing to extract '" << name << "'");
+
+    for (auto &part: parts)
+      if (part == "..") THROW("Refusing to extract '" << name << "'");
+
+    return String::join(parts, "/");
+  }
+}
+
+
 struct TarFileReader::private_t {
   io::filtering_istream filter;
 };
@@ -69,6 +159,19 @@ TarFileReader::TarFileReader(istream &stream, compression_t compression) :
 }
 
 
+#ifdef HAVE_OPENSSL
+TarFileReader::TarFileReader(istream &stream, compression_t compression,
+                             const string &key) :
+  pri(new private_t), stream(SmartPointer<istream>::Phony(&stream)),
+  didReadHeader(false) {
+
+  addCompression(compression);
+  pri->filter.push(AEADDecryptor(key));
+  pri->filter.push(*this->stream);
+}
+#endif // HAVE_OPENSSL
+
+
 TarFileReader::~TarFileReader() {
   delete pri;
 }
@@ -119,11 +222,99 @@ string TarFileReader::extract(ostream &out) {
 }
 
 
+unsigned TarFileReader::extractAll(const string &path, ParallelPool &pool,
+                                   bool sync, uint64_t maxBuffer) {
+  set<string> dirs;
+  vector<string> files;
+  vector<string> large; // Written by the source
+
+  function<void (const string &)> ensureDir = [&] (const string &dir) {
+    if (!dirs.insert(dir).second || SystemUtilities::isDirectory(dir)) return;
+
+    string parent = SystemUtilities::dirname(dir);
+    if (parent != dir && parent != ".") ensureDir(parent);
+    SystemUtilities::mkdir(dir, false);
+  };
+
+  ensureDir(path);
+
+  auto source = [&] (Item &item) {
+    for (; hasMore(); didReadHeader = false) {
+      string name = checkPath(getFilename());
+      string target = path + "/" + name;
+      type_t type = getType();
+
+      if (name.empty() || type == DIRECTORY) {
+        if (!name.empty()) ensureDir(target);
+        skipFile(pri->filter);
+        continue;
+      }
+
+      if (TarHeader::type[0] && type != NORMAL_FILE &&
+          type != CONTIGUOUS_FILE) {
+        LOG_WARNING("Skipping tar entry '" << name << "' of type "
+                    << TarHeader::type[0]);
+        skipFile(pri->filter);
+        continue;
+      }
+
+      ensureDir(SystemUtilities::dirname(target));
+
+      if (maxBuffer < getSize()) {
+        LOG_DEBUG(5, "Extracting: " << target);
+        readFile(*SystemUtilities::oopen(target), pri->filter);
+        large.push_back(target);
+        continue;
+      }
+
+      item.path = target;
+      item.mode = getMode();
+      item.data.resize(getSize());
+      if (getSize()) readFile(&item.data[0], pri->filter);
+      didReadHeader = false;
+
+      return true;
+    }
+
+    return false;
+  };
+
+  auto stage = [] (Item &item) {
+    LOG_DEBUG(5, "Extracting: " << item.path);
+    saveFile(item.path, item.data.data(), item.data.size(), item.mode);
+    vector<char>().swap(item.data);
+  };
+
+  auto sink = [&] (Item &item) {files.push_back(item.path);};
+
+  ParallelPipeline<Item>(pool)
+    .setSource(source).addStage(stage).setSink(sink).run();
+  files.insert(files.end(), large.begin(), large.end());
+
+  if (sync) {
+    pool.parallelFor(0, files.size(), 64, [&] (uint64_t first, uint64_t last) {
+      for (uint64_t i = first; i < last; i++) syncPath(files[i]);
+    });
+
+    // Directory entries make the new files durable
+    for (auto &dir: dirs) syncPath(dir);
+  }
+
+  return files.size();
+}
+
+
 void TarFileReader::addCompression(compression_t compression) {
   switch (compression) {
   case TARFILE_NONE: break; // none
   case TARFILE_BZIP2: pri->filter.push(BZip2Decompressor()); break;
   case TARFILE_GZIP: pri->filter.push(io::zlib_decompressor()); break;
+#ifdef HAVE_ZSTD
+  case TARFILE_ZSTD: pri->filter.push(ZstdDecompressor()); break;
+#endif
+#ifdef HAVE_LZ4
+  case TARFILE_LZ4: pri->filter.push(LZ4Decompressor()); break;
+#endif
   default: THROW("Invalid compression type " << compression);
   }
 }
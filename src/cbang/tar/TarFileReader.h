@@ -35,12 +35,15 @@
 #include "TarFile.h"
 
 #include <cbang/SmartPointer.h>
+#include <cbang/config.h>
 
 #include <istream>
 #include <string>
 
 
 namespace cb {
+  class ParallelPool;
+
   class TarFileReader : public TarFile {
     struct private_t;
     private_t *pri;
@@ -51,6 +54,11 @@ namespace cb {
     TarFileReader(const std::string &path,
                   compression_t compression = TARFILE_AUTO);
     TarFileReader(std::istream &stream, compression_t compression);
+#ifdef HAVE_OPENSSL
+    /// Read an archive written with an AEADStream under @param key
+    TarFileReader(std::istream &stream, compression_t compression,
+                  const std::string &key);
+#endif // HAVE_OPENSSL
     ~TarFileReader();
 
     bool hasMore();
@@ -59,6 +67,23 @@ namespace cb {
     std::string extract(const std::string &path = ".");
     std::string extract(std::ostream &out);
 
+    /**
+     * Extract the remaining directories and regular files under
+     * @param path.  Entries are decompressed and parsed on the calling
+     * thread.  Buffered file data is written by the workers of
+     * @param pool while the next entries are read.  Files larger than
+     * @param maxBuffer bytes are written by the calling thread.  If
+     * @param sync is set the files and directories are flushed to disk
+     * together, in parallel, once all have been written.
+     *
+     * Other entry types are skipped and absolute paths or paths with ".."
+     * components are rejected.
+     *
+     * @return The number of files extracted.
+     */
+    unsigned extractAll(const std::string &path, ParallelPool &pool,
+                        bool sync = false, uint64_t maxBuffer = 16 << 20);
+
   protected:
     void addCompression(compression_t compression);
   };
@@ -32,9 +32,16 @@
 
 #include "TarFileWriter.h"
 
+#include <cbang/Catch.h>
 #include <cbang/os/SystemUtilities.h>
 
 #include <cbang/iostream/BZip2Compressor.h>
+#include <cbang/iostream/ParallelCompressor.h>
+#include <cbang/iostream/ZstdCompressor.h>
+#include <cbang/iostream/LZ4Compressor.h>
+#ifdef HAVE_OPENSSL
+#include <cbang/iostream/AEADEncryptor.h>
+#endif
 
 #include <boost/ref.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
@@ -51,24 +58,39 @@ struct TarFileWriter::private_t {
 
 
 TarFileWriter::TarFileWriter(const string &path, ios::openmode mode, int perm,
-                 compression_t compression) :
+                             compression_t compression, unsigned threads) :
   pri(new private_t),
   stream(SystemUtilities::open(path, mode | ios::out, perm)) {
 
-  addCompression(compression == TARFILE_AUTO ? infer(path) : compression);
+  addCompression(compression == TARFILE_AUTO ? infer(path) : compression,
+                 threads);
   pri->filter.push(*this->stream);
 }
 
 
-TarFileWriter::TarFileWriter(ostream &stream, compression_t compression) :
+TarFileWriter::TarFileWriter(ostream &stream, compression_t compression,
+                             unsigned threads) :
+  pri(new private_t), stream(SmartPointer<ostream>::Phony(&stream)) {
+
+  addCompression(compression, threads);
+  pri->filter.push(*this->stream);
+}
+
+
+#ifdef HAVE_OPENSSL
+TarFileWriter::TarFileWriter(ostream &stream, compression_t compression,
+                             const AEADStream &aead) :
   pri(new private_t), stream(SmartPointer<ostream>::Phony(&stream)) {
 
   addCompression(compression);
+  pri->filter.push(AEADEncryptor(aead));
   pri->filter.push(*this->stream);
 }
+#endif // HAVE_OPENSSL
 
 
 TarFileWriter::~TarFileWriter() {
+  TRY_CATCH_ERROR(writeFooter(pri->filter));
   delete pri;
 }
 
@@ -108,11 +130,32 @@ void TarFileWriter::writeHeader(type_t type, const string &filename,
 }
 
 
-void TarFileWriter::addCompression(compression_t compression) {
+void TarFileWriter::addCompression(compression_t compression,
+                                   unsigned threads) {
+  if (threads != 1)
+    switch (compression) {
+    case TARFILE_BZIP2:
+      pri->filter.push(ParallelCompressor(ParallelCompressor::BZIP2, threads));
+      return;
+
+    case TARFILE_GZIP:
+      // Same zlib format as io::zlib_compressor
+      pri->filter.push(ParallelCompressor(ParallelCompressor::ZLIB, threads));
+      return;
+
+    default: break;
+    }
+
   switch (compression) {
   case TARFILE_NONE: break; // none
   case TARFILE_BZIP2: pri->filter.push(BZip2Compressor()); break;
   case TARFILE_GZIP: pri->filter.push(io::zlib_compressor()); break;
+#ifdef HAVE_ZSTD
+  case TARFILE_ZSTD: pri->filter.push(ZstdCompressor()); break;
+#endif
+#ifdef HAVE_LZ4
+  case TARFILE_LZ4: pri->filter.push(LZ4Compressor()); break;
+#endif
   default: THROW("Invalid compression type " << compression);
   }
 }
@@ -35,6 +35,7 @@
 #include "TarFile.h"
 
 #include <cbang/SmartPointer.h>
+#include <cbang/config.h>
 #include <cbang/StdTypes.h>
 
 #include <ostream>
@@ -42,15 +43,29 @@
 
 
 namespace cb {
+  class AEADStream;
+
   class TarFileWriter : public TarFile {
     struct private_t;
     private_t *pri;
     SmartPointer<std::ostream> stream;
 
   public:
+    /**
+     * With @param threads other than one, compressed archives are
+     * compressed in blocks on that many threads, zero for one per CPU.
+     * The output is still a single bzip2 or zlib stream.
+     */
     TarFileWriter(const std::string &path, std::ios::openmode mode,
-                  int perm = 0644, compression_t compression = TARFILE_AUTO);
-    TarFileWriter(std::ostream &stream, compression_t compression);
+                  int perm = 0644, compression_t compression = TARFILE_AUTO,
+                  unsigned threads = 1);
+    TarFileWriter(std::ostream &stream, compression_t compression,
+                  unsigned threads = 1);
+#ifdef HAVE_OPENSSL
+    /// Compress, then encrypt and authenticate, with @param aead
+    TarFileWriter(std::ostream &stream, compression_t compression,
+                  const AEADStream &aead);
+#endif // HAVE_OPENSSL
     ~TarFileWriter();
 
     void add(const std::string &path,
@@ -65,6 +80,6 @@ namespace cb {
   protected:
     void writeHeader(type_t type, const std::string &filename, uint64_t size,
                      uint32_t mode);
-    void addCompression(compression_t compression);
+    void addCompression(compression_t compression, unsigned threads = 1);
   };
 }
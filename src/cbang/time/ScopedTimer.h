@@ -0,0 +1,63 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Timer.h"
+
+#include <cbang/util/Histogram.h>
+
+
+namespace cb {
+  /**
+   * Records the time from construction to destruction in a Histogram.
+   * The time stamp counter is read at both ends so the overhead is a few
+   * nanoseconds.  Values are recorded in units of @param unitNS, by
+   * default microseconds, to match the HTTP latency histograms.
+   */
+  class ScopedTimer {
+    Histogram *histogram;
+    uint64_t unitNS;
+    uint64_t start;
+
+  public:
+    ScopedTimer(Histogram &histogram, uint64_t unitNS = 1000) :
+      histogram(&histogram), unitNS(unitNS), start(Timer::cycles()) {}
+    ~ScopedTimer() {if (histogram) histogram->record(getElapsedNS() / unitNS);}
+
+    uint64_t getElapsedNS() const
+    {return Timer::cyclesToNS(Timer::cycles() - start);}
+
+    /// Do not record anything
+    void cancel() {histogram = 0;}
+  };
+}
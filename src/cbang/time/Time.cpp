@@ -36,6 +36,7 @@
 #include <cbang/time/Time.h>
 
 #include <sstream>
+#include <ctime>
 #include <locale>
 #include <exception>
 
@@ -101,10 +102,7 @@ Time Time::parse(const string &s, const string &format) {
 }
 
 
-uint64_t Time::now() {
-  return (uint64_t)(pt::second_clock::universal_time() -
-                    pt::ptime(epoch)).total_seconds();
-}
+uint64_t Time::now() {return (uint64_t)::time(0);}
 
 
 int32_t Time::offset() {
@@ -32,6 +32,18 @@
 
 #include <cbang/time/Timer.h>
 
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+  defined(_M_IX86)
+#define CBANG_HAVE_TSC
+#include <cbang/os/CPUID.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
 #ifdef _WIN32
 #include <cbang/socket/Winsock.h> // For timeval
 
@@ -48,6 +60,43 @@
 using namespace cb;
 
 
+namespace {
+#ifdef CBANG_HAVE_TSC
+  bool haveInvariantTSC() {
+    CPUID cpuid;
+    if (cpuid.cpuID(0x80000000).EAX() < 0x80000007) return false;
+    return cpuid.cpuID(0x80000007).EDX(8, 8);
+  }
+
+
+  bool useTSC() {
+    static bool use = haveInvariantTSC();
+    return use;
+  }
+#endif // CBANG_HAVE_TSC
+
+
+  double calibrateCycles() {
+#ifdef CBANG_HAVE_TSC
+    if (!useTSC()) return 1;
+
+    // Spin for a few milliseconds rather than sleep to stay on this CPU
+    uint64_t startNS = Timer::monotonicNS();
+    uint64_t start = __rdtsc();
+    uint64_t ns;
+
+    do ns = Timer::monotonicNS() - startNS;
+    while (ns < 5000000);
+
+    return (double)(__rdtsc() - start) / ns;
+
+#else
+    return 1;
+#endif
+  }
+}
+
+
 Timer::Timer(bool start) : started(false), startTime(0), endTime(0) {
   if (start) this->start();
 }
@@ -55,19 +104,19 @@ Timer::Timer(bool start) : started(false), startTime(0), endTime(0) {
 
 void Timer::start() {
   started = true;
-  startTime = now();
+  startTime = monotonic();
 }
 
 
 double Timer::stop() {
-  endTime = now();
+  endTime = monotonic();
   started = false;
   return endTime - startTime;
 }
 
 
 double Timer::delta() {
-  if (started) return now() - startTime;
+  if (started) return monotonic() - startTime;
   else return endTime - startTime;
 }
 
@@ -84,7 +133,7 @@ bool Timer::every(double secs) {
     return true;
   }
 
-  double t = now();
+  double t = monotonic();
   if (secs <= t - startTime) {
     startTime = t;
     return true;
@@ -119,6 +168,43 @@ double Timer::now() {
 }
 
 
+double Timer::monotonic() {return monotonicNS() * 1e-9;}
+
+
+uint64_t Timer::monotonicNS() {
+#ifdef _WIN32
+  static LARGE_INTEGER freq = {};
+  if (!freq.QuadPart) QueryPerformanceFrequency(&freq);
+
+  LARGE_INTEGER count;
+  QueryPerformanceCounter(&count);
+
+  uint64_t c = count.QuadPart;
+  uint64_t f = freq.QuadPart;
+  return c / f * 1000000000 + c % f * 1000000000 / f;
+
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+
+uint64_t Timer::cycles() {
+#ifdef CBANG_HAVE_TSC
+  if (useTSC()) return __rdtsc();
+#endif
+  return monotonicNS();
+}
+
+
+double Timer::getCyclesPerNS() {
+  static double rate = calibrateCycles();
+  return rate;
+}
+
+
 double Timer::sleep(double t) {
   if (t <= 0) return 0;
 
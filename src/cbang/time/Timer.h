@@ -37,13 +37,19 @@
 #undef min
 #endif // _WIN32
 
+#include <cstdint>
+
 
 struct timeval;
 struct timespec;
 
 
 namespace cb {
-  /// Time events or access current system time
+  /**
+   * Time events or access current system time.  Intervals measured by
+   * Timer instances use the monotonic clock so they are not affected by
+   * changes to the system time.
+   */
   class Timer {
     bool started;
     double startTime;
@@ -90,6 +96,25 @@ namespace cb {
      */
     static double now();
 
+    /// @return Seconds on a monotonic clock with an arbitrary epoch
+    static double monotonic();
+
+    /// @return Nanoseconds on a monotonic clock with an arbitrary epoch
+    static uint64_t monotonicNS();
+
+    /**
+     * Read the CPU time stamp counter if it runs at a constant rate,
+     * otherwise return monotonicNS().  This is cheaper than reading a clock
+     * when timing short sections of code.  Convert differences with
+     * cyclesToNS().
+     */
+    static uint64_t cycles();
+
+    /// Measured once, on first use, against monotonicNS()
+    static double getCyclesPerNS();
+    static uint64_t cyclesToNS(uint64_t cycles)
+    {return (uint64_t)(cycles / getCyclesPerNS());}
+
     static double sleep(double t);
 
 #ifndef _WIN32
@@ -1,78 +1,176 @@
-/******************************************************************************\
+#include "ACLSet.h"
 
-          This file is part of the C! library.  A.K.A the cbang library.
+#include <cbang/Exception.h>
+#include <cbang/json/JSON.h>
+#include <cbang/log/Logger.h>
+#include <cbang/util/SmartInc.h>
 
-                Copyright (c) 2003-2019, Cauldron Development LLC
-                   Copyright (c) 2003-2017, Stanford University
-                               All rights reserved.
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
 
-         The C! library is free software: you can redistribute it and/or
-        modify it under the terms of the GNU Lesser General Public License
-       as published by the Free Software Foundation, either version 2.1 of
-               the License, or (at your option) any later version.
+using namespace std;
+using namespace cb;
 
-        The C! library is distributed in the hope that it will be useful,
-          but WITHOUT ANY WARRANTY; without even the implied warranty of
-        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
-                 Lesser General Public License for more details.
 
-         You should have received a copy of the GNU Lesser General Public
-                 License along with the C! library.  If not, see
-                         <http://www.gnu.org/licenses/>.
+namespace {
+  typedef vector<uint64_t> bits_t;
 
-        In addition, BSD licensing may be granted on a case by case basis
-        by written permission from at least one of the copyright holders.
-           You may request written permission by emailing the authors.
 
-                  For information regarding this software email:
-                                 Joseph Coffland
-                          joseph@cauldrondevelopment.com
+  void setBit(bits_t &bits, unsigned i) {
+    if (bits.size() <= i / 64) bits.resize(i / 64 + 1);
+    bits[i / 64] |= (uint64_t)1 << (i % 64);
+  }
 
-\******************************************************************************/
 
-#include "ACLSet.h"
+  bool testBit(const bits_t &bits, unsigned i) {
+    return i / 64 < bits.size() && (bits[i / 64] >> (i % 64)) & 1;
+  }
 
-#include <cbang/Exception.h>
-#include <cbang/json/JSON.h>
-#include <cbang/log/Logger.h>
 
-using namespace std;
-using namespace cb;
+  void orBits(bits_t &a, const bits_t &b) {
+    if (a.size() < b.size()) a.resize(b.size());
+    for (unsigned i = 0; i < b.size(); i++) a[i] |= b[i];
+  }
+
+
+  /// The end of the next parent path of @param path after @param start.
+  /// Each parent ends before a '/', except "/" itself.
+  size_t nextPrefix(const string &path, size_t start) {
+    if (!start && path[0] == '/') return 1;
+    size_t end = path.find('/', start + 1);
+    return end == string::npos ? path.size() : end;
+  }
+
+
+  struct Chunk {
+    const char *data;
+    size_t length;
+  };
+
+
+  bool operator<(const pair<string, unsigned> &a, const Chunk &b) {
+    int cmp = memcmp(a.first.data(), b.data, min(a.first.size(), b.length));
+    return cmp < 0 || (!cmp && a.first.size() < b.length);
+  }
+}
+
+
+struct ACLSet::Snapshot {
+  struct Node {
+    vector<pair<string, unsigned> > children; // Sorted by chunk
+    int acl = -1;
+  };
+
+  struct Entry {
+    bits_t users; // Including members of the ACL's groups
+    bits_t groups;
+  };
+
+  unordered_map<string, unsigned> userIDs;
+  unordered_map<string, unsigned> groupIDs;
+  vector<Node> nodes;
+  vector<Entry> entries;
+
+
+  Snapshot() : nodes(1) {}
+
+
+  unsigned insert(const string &path) {
+    unsigned node = 0;
+
+    for (size_t start = 0; start < path.size();) {
+      size_t end = nextPrefix(path, start);
+      string chunk = path.substr(start, end - start);
+
+      auto &children = nodes[node].children;
+      unsigned i;
+      for (i = 0; i < children.size(); i++)
+        if (children[i].first == chunk) break;
+
+      if (i == children.size()) {
+        children.push_back(make_pair(chunk, (unsigned)nodes.size()));
+        nodes.push_back(Node());
+      }
+
+      node = nodes[node].children[i].second;
+      start = end;
+    }
+
+    return node;
+  }
+
+
+  void sort() {
+    for (unsigned i = 0; i < nodes.size(); i++)
+      std::sort(nodes[i].children.begin(), nodes[i].children.end());
+  }
+
+
+  const Entry *find(const string &path) const {
+    const Entry *entry = 0;
+    unsigned node = 0;
+
+    for (size_t start = 0; start < path.size();) {
+      size_t end = nextPrefix(path, start);
+      Chunk chunk = {path.data() + start, end - start};
+
+      auto &children = nodes[node].children;
+      auto it = lower_bound(children.begin(), children.end(), chunk);
+      if (it == children.end() || it->first.size() != chunk.length ||
+          memcmp(it->first.data(), chunk.data, chunk.length)) break;
+
+      node = it->second;
+      if (0 <= nodes[node].acl) entry = &entries[nodes[node].acl];
+      start = end;
+    }
+
+    return entry;
+  }
+};
+
+
+ACLSet::ACLSet() {update();}
+ACLSet::~ACLSet() {}
 
 
 void ACLSet::clear() {
-  cache.clear();
   acls.clear();
   groups.clear();
   users.clear();
+  update();
 }
 
 
 bool ACLSet::allow(const string &path, const string &user) const {
-  // Check cache
-  if (!flushDirtyCache()) {
-    cache_t::const_iterator it = cache.find(path);
-    if (it != cache.end()) {
-      cache_users_t::const_iterator it2 = it->second.find(user);
-      if (it2 != it->second.end()) return it2->second;
-    }
-  }
+  auto snapshot = getSnapshot();
 
-  return cache[path][user] = allowNoCache(path, user);
+  auto it = snapshot->userIDs.find(user);
+  if (it == snapshot->userIDs.end()) return false;
+
+  const Snapshot::Entry *entry = snapshot->find(path);
+  bool allow = entry && testBit(entry->users, it->second);
+
+  LOG_DEBUG(5, __func__ << '(' << path << ", " << user << ") = " << allow);
+
+  return allow;
 }
 
 
 bool ACLSet::allowGroup(const string &path, const string &group) const {
-  // Check cache
-  if (!flushDirtyCache()) {
-    cache_t::const_iterator it = groupCache.find(path);
-    if (it != groupCache.end()) {
-      cache_users_t::const_iterator it2 = it->second.find(group);
-      if (it2 != it->second.end()) return it2->second;
-    }
-  }
+  auto snapshot = getSnapshot();
+
+  auto it = snapshot->groupIDs.find(group);
+  if (it == snapshot->groupIDs.end()) return false;
 
-  return groupCache[path][group] = allowGroupNoCache(path, group);
+  const Snapshot::Entry *entry = snapshot->find(path);
+  bool allow = entry && testBit(entry->groups, it->second);
+
+  LOG_DEBUG(5, __func__ << '(' << path << ", @" << group << ") = " << allow);
+
+  return allow;
 }
 
 
@@ -82,13 +180,12 @@ bool ACLSet::hasUser(const string &user) const {
 
 
 void ACLSet::addUser(const string &user) {
-  dirty = true;
   users.insert(user);
+  update();
 }
 
 
 void ACLSet::delUser(const string &user) {
-  dirty = true;
   users.erase(user);
 
   // Remove from groups
@@ -98,6 +195,8 @@ void ACLSet::delUser(const string &user) {
   // Remove from ACLS
   for (acls_t::iterator it = acls.begin(); it != acls.end(); it++)
     it->second.users.erase(user);
+
+  update();
 }
 
 
@@ -108,18 +207,19 @@ bool ACLSet::hasGroup(const string &group) const {
 
 
 void ACLSet::addGroup(const string &group) {
-  dirty = true;
   groups.insert(groups_t::value_type(group, Group()));
+  update();
 }
 
 
 void ACLSet::delGroup(const string &group) {
-  dirty = true;
   groups.erase(group);
 
   // Remove from ACLS
   for (acls_t::iterator it = acls.begin(); it != acls.end(); it++)
     it->second.groups.erase(group);
+
+  update();
 }
 
 
@@ -133,20 +233,20 @@ bool ACLSet::groupHasUser(const string &groupName, const string &user) const {
 
 
 void ACLSet::groupAddUser(const string &group, const string &user) {
-  dirty = true;
-  addUser(user);
+  users.insert(user);
   groups.insert(groups_t::value_type(group, Group())).
     first->second.users.insert(user);
+  update();
 }
 
 
 void ACLSet::groupDelUser(const string &groupName, const string &user) {
-  dirty = true;
   groups_t::iterator it = groups.find(groupName);
   if (it == groups.end()) THROW("Group '" << groupName << "' does not exist");
   Group &group = it->second;
 
   group.users.erase(user);
+  update();
 }
 
 
@@ -156,14 +256,14 @@ bool ACLSet::hasACL(const string &path) const {
 
 
 void ACLSet::addACL(const string &path) {
-  dirty = true;
   acls.insert(acls_t::value_type(path, ACL()));
+  update();
 }
 
 
 void ACLSet::delACL(const string &path) {
-  dirty = true;
   acls.erase(path);
+  update();
 }
 
 
@@ -177,20 +277,20 @@ bool ACLSet::aclHasUser(const string &path, const string &user) const {
 
 
 void ACLSet::aclAddUser(const string &path, const string &user) {
-  dirty = true;
-  addUser(user);
+  users.insert(user);
   acls.insert(acls_t::value_type(path, ACL())).
     first->second.users.insert(user);
+  update();
 }
 
 
 void ACLSet::aclDelUser(const string &path, const string &user) {
-  dirty = true;
   acls_t::iterator it = acls.find(path);
   if (it == acls.end()) THROW("ACL '" << path << "' does not exist");
   ACL &acl = it->second;
 
   acl.users.erase(user);
+  update();
 }
 
 
@@ -204,24 +304,39 @@ bool ACLSet::aclHasGroup(const string &path, const string &group) const {
 
 
 void ACLSet::aclAddGroup(const string &path, const string &group) {
-  dirty = true;
-  addGroup(group);
+  groups.insert(groups_t::value_type(group, Group()));
   acls.insert(acls_t::value_type(path, ACL())).
     first->second.groups.insert(group);
+  update();
 }
 
 
 void ACLSet::aclDelGroup(const string &path, const string &group) {
-  dirty = true;
   acls_t::iterator it = acls.find(path);
   if (it == acls.end()) THROW("ACL '" << path << "' does not exist");
   ACL &acl = it->second;
 
   acl.groups.erase(group);
+  update();
 }
 
 
 void ACLSet::read(const JSON::Value &json) {
+  // Compile once after everything has been read
+  try {
+    SmartInc<unsigned> inc(batch);
+    parse(json);
+
+  } catch (...) {
+    update();
+    throw;
+  }
+
+  update();
+}
+
+
+void ACLSet::parse(const JSON::Value &json) {
   clear();
 
   auto &dict = json.getDict();
@@ -341,75 +456,54 @@ void ACLSet::write(JSON::Sink &sink) const {
 }
 
 
-bool ACLSet::flushDirtyCache() const {
-  if (!dirty) return false;
-
-  cache.clear();
-  groupCache.clear();
-  dirty = false;
-
-  return true;
-}
-
-
-string ACLSet::parentPath(const string &path) {
-  size_t pos = path.find_last_of('/');
-  if (!pos && path != "/") return "/";
-  if (!pos || pos == string::npos) return "";
-  return path.substr(0, pos);
+shared_ptr<const ACLSet::Snapshot> ACLSet::getSnapshot() const {
+  return atomic_load(&snapshot);
 }
 
 
-bool ACLSet::allowNoCache(const string &_path, const string &user) const {
-  // Check if user exists
-  if (users.find(user) == users.end()) return false;
-
-  // Find ACL
-  for (string path = _path; !path.empty(); path = parentPath(path)) {
-    LOG_DEBUG(5, __func__ << '(' << path << ", " << user << ')');
-
-    acls_t::const_iterator it = acls.find(path);
-    if (it != acls.end()) {
-      const ACL &acl = it->second;
+void ACLSet::update() {
+  if (batch) return;
 
-      // Check users
-      if (acl.users.find(user) != acl.users.end()) return true;
+  shared_ptr<Snapshot> snap = make_shared<Snapshot>();
 
-      // Check groups
-      string_set_t::const_iterator it2;
-      for (it2 = acl.groups.begin(); it2 != acl.groups.end(); it2++) {
-        groups_t::const_iterator it3 = groups.find(*it2);
-        if (it3 == groups.end())
-          THROW("ACL contains non-existant group '" << *it2);
+  for (auto it = users.begin(); it != users.end(); it++)
+    snap->userIDs.insert(make_pair(*it, (unsigned)snap->userIDs.size()));
 
-        const Group &group = it3->second;
-        if (group.users.find(user) != group.users.end()) return true;
-      }
+  vector<bits_t> members;
+  for (auto it = groups.begin(); it != groups.end(); it++) {
+    snap->groupIDs.insert(make_pair(it->first, (unsigned)members.size()));
+    members.push_back(bits_t());
 
-      break;
+    const string_set_t &users = it->second.users;
+    for (auto it2 = users.begin(); it2 != users.end(); it2++) {
+      auto id = snap->userIDs.find(*it2);
+      if (id != snap->userIDs.end()) setBit(members.back(), id->second);
     }
   }
 
-  return false;
-}
+  for (auto it = acls.begin(); it != acls.end(); it++) {
+    Snapshot::Entry entry;
+    const ACL &acl = it->second;
 
+    for (auto it2 = acl.users.begin(); it2 != acl.users.end(); it2++) {
+      auto id = snap->userIDs.find(*it2);
+      if (id != snap->userIDs.end()) setBit(entry.users, id->second);
+    }
 
-bool ACLSet::allowGroupNoCache(const string &_path, const string &group) const {
-  // Check if group exists
-  if (groups.find(group) == groups.end()) return false;
-
-  // Find ACL
-  for (string path = _path; !path.empty(); path = parentPath(path)) {
-    LOG_DEBUG(5, __func__ << '(' << path << ", @" << group << ')');
-
-    acls_t::const_iterator it = acls.find(path);
-    if (it != acls.end()) {
-      const ACL &acl = it->second;
+    for (auto it2 = acl.groups.begin(); it2 != acl.groups.end(); it2++) {
+      auto id = snap->groupIDs.find(*it2);
+      if (id == snap->groupIDs.end())
+        THROW("ACL contains non-existant group '" << *it2);
 
-      // Check groups
-      return acl.groups.find(group) != acl.groups.end();
+      setBit(entry.groups, id->second);
+      orBits(entry.users, members[id->second]);
     }
+
+    snap->nodes[snap->insert(it->first)].acl = snap->entries.size();
+    snap->entries.push_back(entry);
   }
 
-  return false;
+  snap->sort();
+
+  atomic_store(&snapshot, shared_ptr<const Snapshot>(snap));
 }
@@ -37,6 +37,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <memory>
 
 
 namespace cb {
@@ -45,12 +46,20 @@ namespace cb {
     class Value;
   }
 
+  /**
+   * A set of users, groups and path based access control lists.  The
+   * nearest ACL at or above a path decides access.
+   *
+   * Every change compiles the ACLs into an immutable path trie with user
+   * and group bitsets which is published atomically.  allow() and
+   * allowGroup() only read the current snapshot so they may be called
+   * from any number of threads, including while another thread changes
+   * the set.  Changes and the other accessors must not run concurrently.
+   */
   class ACLSet : public JSON::Serializable {
-    mutable bool dirty;
-    typedef std::map<std::string, bool> cache_users_t;
-    typedef std::map<std::string, cache_users_t> cache_t;
-    mutable cache_t cache;
-    mutable cache_t groupCache;
+    struct Snapshot;
+    std::shared_ptr<const Snapshot> snapshot;
+    unsigned batch = 0;
 
     typedef std::set<std::string> string_set_t;
 
@@ -73,7 +82,8 @@ namespace cb {
     users_t users;
 
   public:
-    ACLSet() : dirty(false) {}
+    ACLSet();
+    ~ACLSet();
 
     void clear();
 
@@ -130,11 +140,10 @@ namespace cb {
     using cb::Serializable::write;
 
   protected:
-    bool flushDirtyCache() const;
-    static std::string parentPath(const std::string &path);
-    bool allowNoCache(const std::string &path, const std::string &user) const;
-    bool allowGroupNoCache(const std::string &path,
-                           const std::string &group) const;
+    void parse(const JSON::Value &value);
+    std::shared_ptr<const Snapshot> getSnapshot() const;
+    /// Recompile and publish the snapshot unless a batch is in progress
+    void update();
   };
 
 
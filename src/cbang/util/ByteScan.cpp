@@ -0,0 +1,134 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "ByteScan.h"
+
+#include <cbang/os/CPUDispatch.h>
+
+#ifdef CBANG_SIMD_X86
+#include <immintrin.h>
+#endif
+
+using namespace cb;
+
+
+namespace {
+  typedef const char *(*either_t)(const char *, const char *, char, char);
+  typedef const char *(*past_t)(const char *, const char *, char);
+
+
+  const char *eitherNone(const char *p, const char *end, char a, char b) {
+    while (p < end && *p != a && *p != b) p++;
+    return p;
+  }
+
+
+  const char *pastNone(const char *p, const char *end, char c) {
+    while (p < end && *p == c) p++;
+    return p;
+  }
+
+
+#ifdef CBANG_SIMD_X86
+  CBANG_TARGET_SSE2 const char *
+  eitherSSE2(const char *p, const char *end, char a, char b) {
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+
+    for (; 16 <= end - p; p += 16) {
+      __m128i chunk = _mm_loadu_si128((const __m128i *)p);
+      unsigned mask = _mm_movemask_epi8(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, va), _mm_cmpeq_epi8(chunk, vb)));
+
+      if (mask) return p + __builtin_ctz(mask);
+    }
+
+    return eitherNone(p, end, a, b);
+  }
+
+
+  CBANG_TARGET_AVX2 const char *
+  eitherAVX2(const char *p, const char *end, char a, char b) {
+    const __m256i va = _mm256_set1_epi8(a);
+    const __m256i vb = _mm256_set1_epi8(b);
+
+    for (; 32 <= end - p; p += 32) {
+      __m256i chunk = _mm256_loadu_si256((const __m256i *)p);
+      unsigned mask = _mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, va),
+                        _mm256_cmpeq_epi8(chunk, vb)));
+
+      if (mask) return p + __builtin_ctz(mask);
+    }
+
+    return eitherSSE2(p, end, a, b);
+  }
+
+
+  CBANG_TARGET_SSE2 const char *
+  pastSSE2(const char *p, const char *end, char c) {
+    const __m128i vc = _mm_set1_epi8(c);
+
+    // Most runs are short, only scan blocks which start with c
+    for (; 16 <= end - p && *p == c; p += 16) {
+      __m128i chunk = _mm_loadu_si128((const __m128i *)p);
+      unsigned mask = ~_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, vc)) & 0xffff;
+
+      if (mask) return p + __builtin_ctz(mask);
+    }
+
+    return pastNone(p, end, c);
+  }
+
+
+  const CPUDispatch::Function<either_t>
+  eitherFn(eitherNone, eitherSSE2, eitherAVX2);
+  const CPUDispatch::Function<past_t> pastFn(pastNone, pastSSE2);
+
+#else // CBANG_SIMD_X86
+  const CPUDispatch::Function<either_t> eitherFn(eitherNone);
+  const CPUDispatch::Function<past_t> pastFn(pastNone);
+#endif // CBANG_SIMD_X86
+}
+
+
+namespace cb {
+  const char *scanForEither(const char *p, const char *end, char a, char b) {
+    return eitherFn(p, end, a, b);
+  }
+
+
+  const char *scanPast(const char *p, const char *end, char c) {
+    return pastFn(p, end, c);
+  }
+}
@@ -0,0 +1,157 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "CRC32C.h"
+
+#include <cbang/os/CPUDispatch.h>
+
+#include <cstring>
+
+#ifdef CBANG_SIMD_X86
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define CBANG_CRC32C_ARM
+#endif
+
+using namespace cb;
+
+
+namespace {
+  typedef uint32_t (*crc_t)(uint32_t, const uint8_t *, size_t);
+
+
+  struct Tables {
+    uint32_t t[8][256];
+
+    Tables() {
+      for (unsigned i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (unsigned j = 0; j < 8; j++)
+          crc = (crc >> 1) ^ (0x82f63b78 & -(crc & 1));
+        t[0][i] = crc;
+      }
+
+      for (unsigned i = 0; i < 256; i++)
+        for (unsigned j = 1; j < 8; j++)
+          t[j][i] = (t[j - 1][i] >> 8) ^ t[0][t[j - 1][i] & 0xff];
+    }
+  };
+
+
+  const Tables &tables() {
+    static Tables tables;
+    return tables;
+  }
+
+
+  uint32_t crcNone(uint32_t crc, const uint8_t *p, size_t n) {
+    const auto &t = tables().t;
+
+    for (; n && ((uintptr_t)p & 7); n--)
+      crc = t[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+
+    // Slicing-by-8, the words are read little endian
+    for (; 8 <= n; n -= 8, p += 8) {
+      uint32_t lo =
+        crc ^ (p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24);
+      crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^
+        t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+        t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+    }
+
+    while (n--) crc = t[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+
+    return crc;
+  }
+
+
+#ifdef CBANG_SIMD_X86
+  CBANG_TARGET_SSE42
+  uint32_t crcSSE42(uint32_t crc, const uint8_t *p, size_t n) {
+    for (; n && ((uintptr_t)p & 7); n--) crc = _mm_crc32_u8(crc, *p++);
+
+#ifdef __x86_64__
+    uint64_t crc64 = crc;
+    for (; 8 <= n; n -= 8, p += 8) {
+      uint64_t word;
+      memcpy(&word, p, 8);
+      crc64 = _mm_crc32_u64(crc64, word);
+    }
+    crc = (uint32_t)crc64;
+#endif
+
+    for (; 4 <= n; n -= 4, p += 4) {
+      uint32_t word;
+      memcpy(&word, p, 4);
+      crc = _mm_crc32_u32(crc, word);
+    }
+
+    while (n--) crc = _mm_crc32_u8(crc, *p++);
+
+    return crc;
+  }
+
+
+  // Every CPU with AVX2 also has SSE4.2
+  const CPUDispatch::Function<crc_t> crcFn(crcNone, 0, crcSSE42);
+
+#elif defined(CBANG_CRC32C_ARM)
+  uint32_t crcARM(uint32_t crc, const uint8_t *p, size_t n) {
+    for (; n && ((uintptr_t)p & 7); n--) crc = __crc32cb(crc, *p++);
+
+    for (; 8 <= n; n -= 8, p += 8) {
+      uint64_t word;
+      memcpy(&word, p, 8);
+      crc = __crc32cd(crc, word);
+    }
+
+    while (n--) crc = __crc32cb(crc, *p++);
+
+    return crc;
+  }
+
+
+  const CPUDispatch::Function<crc_t> crcFn(crcNone, 0, 0, 0, crcARM);
+
+#else
+  const CPUDispatch::Function<crc_t> crcFn(crcNone);
+#endif
+}
+
+
+uint32_t CRC32C::extend(uint32_t crc, const void *data, size_t length) {
+  return ~crcFn(~crc, (const uint8_t *)data, length);
+}
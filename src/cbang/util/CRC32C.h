@@ -0,0 +1,62 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+
+namespace cb {
+  /**
+   * CRC-32C (Castagnoli), as used by iSCSI, ext4 and LevelDB.  Computed
+   * with the SSE4.2 or ARMv8 CRC instructions when available, otherwise
+   * eight bytes at a time from tables.
+   */
+  class CRC32C {
+    uint32_t crc;
+
+  public:
+    CRC32C(uint32_t crc = 0) : crc(crc) {}
+
+    void reset() {crc = 0;}
+    void update(const void *data, size_t length)
+      {crc = extend(crc, data, length);}
+    uint32_t get() const {return crc;}
+
+    /// @return the CRC of @param crc's data followed by @param data
+    static uint32_t extend(uint32_t crc, const void *data, size_t length);
+    static uint32_t compute(const void *data, size_t length)
+      {return extend(0, data, length);}
+  };
+}
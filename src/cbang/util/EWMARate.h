@@ -0,0 +1,76 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/time/Time.h>
+
+#include <cmath>
+
+
+namespace cb {
+  /**
+   * An exponentially weighted moving average of the rate of events.  Unlike
+   * Rate it keeps no buckets, so it is cheap to update and query and uses
+   * only a few words of memory.  Older events are discounted smoothly with
+   * a time constant of @param window seconds instead of dropping out of a
+   * fixed window.
+   */
+  class EWMARate {
+    double window;
+    double rate = 0;
+    double total = 0;
+    uint64_t last = 0;
+
+  public:
+    EWMARate(double window = 60) : window(window) {}
+
+
+    void reset() {rate = total = last = 0;}
+
+
+    double getTotal() const {return total;}
+
+
+    double get(uint64_t now = Time::now()) const {
+      if (!last || now <= last) return rate;
+      return rate * std::exp(-(double)(now - last) / window);
+    }
+
+
+    void event(double value = 1, uint64_t now = Time::now()) {
+      rate = get(now) + value / window;
+      total += value;
+      if (last < now) last = now;
+    }
+  };
+}
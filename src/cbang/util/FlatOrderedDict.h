@@ -0,0 +1,332 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <functional>
+
+#include <cbang/Errors.h>
+
+
+namespace cb {
+  template <typename KEY> struct FlatHash : public std::hash<KEY> {};
+
+
+  /// Hashes std::string keys and character ranges alike, with FNV-1a
+  template <> struct FlatHash<std::string> {
+    size_t operator()(const std::string &key) const
+    {return (*this)(key.data(), key.size());}
+
+    size_t operator()(const char *key, size_t length) const {
+      uint64_t hash = 14695981039346656037ULL;
+
+      for (size_t i = 0; i < length; i++)
+        hash = (hash ^ (unsigned char)key[i]) * 1099511628211ULL;
+
+      return (size_t)hash;
+    }
+  };
+
+
+  /**
+   * An OrderedDict which indexes its entries with an open addressing hash
+   * table rather than a std::map.  Small dictionaries are searched linearly
+   * and have no index at all.  Erased keys leave tombstones in the index
+   * which are reclaimed by later inserts or a rehash.
+   *
+   * Dictionaries with std::string keys may also be searched by C string,
+   * including string literals, without constructing a std::string.
+   */
+  template <typename T, typename KEY = std::string,
+            typename HASH = FlatHash<KEY> >
+  class FlatOrderedDict : protected std::vector<std::pair<KEY, T> > {
+    typedef T type_t;
+    typedef std::vector<std::pair<KEY, type_t> > vector_t;
+
+    enum {SLOT_EMPTY = -1, SLOT_TOMBSTONE = -2};
+    static const unsigned linearMax = 8;
+
+    std::vector<int> slots;
+    unsigned tombstones = 0;
+
+  public:
+    void clear() {
+      vector_t::clear();
+      slots.clear();
+      tombstones = 0;
+    }
+
+
+    typedef typename vector_t::size_type size_type;
+    using vector_t::empty;
+    using vector_t::size;
+
+    typedef typename vector_t::const_iterator iterator;
+    typedef typename vector_t::const_iterator const_iterator;
+    iterator begin() const {return vector_t::begin();}
+    iterator end() const {return vector_t::end();}
+
+
+    void update(const FlatOrderedDict &o) {
+      for (iterator it = o.begin(); it != o.end(); it++)
+        insert(it->first, it->second);
+    }
+
+
+    int lookup(const KEY &key) const {
+      if (slots.empty()) {
+        for (size_type i = 0; i < size(); i++)
+          if (this->at(i).first == key) return i;
+        return -1;
+      }
+
+      int slot = findSlot(key);
+      return slot < 0 ? -1 : slots[slot];
+    }
+
+
+    int lookup(const char *key, size_t length) const {
+      if (slots.empty()) {
+        for (size_type i = 0; i < size(); i++)
+          if (equals(this->at(i).first, key, length)) return i;
+        return -1;
+      }
+
+      unsigned slot = HASH()(key, length) & mask();
+
+      while (true) {
+        int i = slots[slot];
+        if (i == SLOT_EMPTY) return -1;
+        if (0 <= i && equals(this->at(i).first, key, length)) return i;
+        slot = (slot + 1) & mask();
+      }
+    }
+
+
+    template <size_t N>
+    int lookup(const char (&key)[N]) const {return lookup(key, strlen(key));}
+
+
+    size_type indexOf(const KEY &key) const {
+      int i = lookup(key);
+      if (i < 0) CBANG_KEY_ERROR("Key '" << key << "' not found");
+      return i;
+    }
+
+
+    const KEY &keyAt(size_type i) const {
+      if (size() <= i) CBANG_KEY_ERROR("Index " << i << " out of range");
+      return this->at(i).first;
+    }
+
+
+    bool has(const KEY &key) const {return lookup(key) != -1;}
+
+
+    template <size_t N>
+    bool has(const char (&key)[N]) const {return lookup(key) != -1;}
+
+
+    const type_t &get(size_type i) const {
+      if (size() <= i) CBANG_KEY_ERROR("Index " << i << " out of range");
+      return this->at(i).second;
+    }
+
+
+    type_t &get(size_type i) {
+      if (size() <= i) CBANG_KEY_ERROR("Index " << i << " out of range");
+      return this->at(i).second;
+    }
+
+
+    const type_t &get(size_type i, const type_t &defaultValue) const {
+      if (size() <= i) return defaultValue;
+      return this->at(i).second;
+    }
+
+
+    const type_t &get(const KEY &key) const {
+      return this->at(indexOf(key)).second;
+    }
+
+
+    type_t &get(const KEY &key) {return this->at(indexOf(key)).second;}
+
+
+    template <size_t N>
+    const type_t &get(const char (&key)[N]) const {
+      int i = lookup(key);
+      if (i < 0) CBANG_KEY_ERROR("Key '" << key << "' not found");
+      return this->at(i).second;
+    }
+
+
+    const type_t &get(const KEY &key, const type_t &defaultValue) const {
+      int i = lookup(key);
+      return i < 0 ? defaultValue : this->at(i).second;
+    }
+
+
+    size_type insert(const KEY &key, const type_t &value) {
+      int i = lookup(key);
+
+      if (i < 0) {
+        vector_t::push_back(typename vector_t::value_type(key, value));
+        indexLast();
+        return size() - 1;
+      }
+
+      this->at(i).second = value;
+
+      return i;
+    }
+
+
+    size_type insert(const KEY &key, type_t &&value) {
+      int i = lookup(key);
+
+      if (i < 0) {
+        vector_t::push_back
+          (typename vector_t::value_type(key, std::move(value)));
+        indexLast();
+        return size() - 1;
+      }
+
+      this->at(i).second = std::move(value);
+
+      return i;
+    }
+
+
+    type_t &operator[](size_type i) {
+      if (size() <= i) CBANG_KEY_ERROR("Index " << i << " out of range");
+      return this->at(i).second;
+    }
+
+
+    const type_t &operator[](size_type i) const {return get(i);}
+
+
+    type_t &operator[](const KEY &key) {
+      int i = lookup(key);
+      if (0 <= i) return this->at(i).second;
+
+      vector_t::push_back(typename vector_t::value_type(key, T()));
+      indexLast();
+
+      return vector_t::back().second;
+    }
+
+
+    const type_t &operator[](const KEY &key) const {return get(key);}
+
+
+    /// Note, erase() still moves the entries which follow @param i
+    void erase(size_type i) {erase(keyAt(i));}
+
+
+    void erase(const KEY &key) {
+      size_type i = indexOf(key);
+
+      if (!slots.empty()) {
+        slots[findSlot(key)] = SLOT_TOMBSTONE;
+        tombstones++;
+
+        for (unsigned j = 0; j < slots.size(); j++)
+          if ((int)i < slots[j]) slots[j]--;
+      }
+
+      vector_t::erase(vector_t::begin() + i);
+
+      // Fall back to linear search when small again
+      if (size() <= linearMax / 2) {
+        slots.clear();
+        tombstones = 0;
+      }
+    }
+
+
+  protected:
+    unsigned mask() const {return slots.size() - 1;}
+
+
+    static bool equals(const KEY &a, const char *b, size_t length) {
+      return a.size() == length && !a.compare(0, length, b, length);
+    }
+
+
+    int findSlot(const KEY &key) const {
+      unsigned slot = HASH()(key) & mask();
+
+      while (true) {
+        int i = slots[slot];
+        if (i == SLOT_EMPTY) return -1;
+        if (0 <= i && this->at(i).first == key) return slot;
+        slot = (slot + 1) & mask();
+      }
+    }
+
+
+    void place(size_type i) {
+      unsigned slot = HASH()(this->at(i).first) & mask();
+
+      while (0 <= slots[slot]) slot = (slot + 1) & mask();
+      if (slots[slot] == SLOT_TOMBSTONE) tombstones--;
+
+      slots[slot] = i;
+    }
+
+
+    void rehash() {
+      unsigned capacity = 16;
+      while (capacity < size() * 2) capacity *= 2;
+
+      slots.assign(capacity, SLOT_EMPTY);
+      tombstones = 0;
+
+      for (size_type i = 0; i < size(); i++) place(i);
+    }
+
+
+    void indexLast() {
+      if (slots.empty()) {
+        if (linearMax < size()) rehash();
+
+      } else if (slots.size() * 3 <= (size() + tombstones) * 4) rehash();
+      else place(size() - 1);
+    }
+  };
+}
@@ -0,0 +1,141 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "Histogram.h"
+
+#include <cbang/json/Sink.h>
+
+using namespace cb;
+
+
+namespace {
+  inline unsigned msb(uint64_t x) {
+#if defined(__GNUC__)
+    return 63 - __builtin_clzll(x);
+#else
+    unsigned n = 0;
+    while (x >>= 1) n++;
+    return n;
+#endif
+  }
+}
+
+
+void Histogram::reset() {
+  for (unsigned i = 0; i < numBuckets; i++)
+    counts[i].store(0, std::memory_order_relaxed);
+
+  count = sum = max = 0;
+  min = ~(uint64_t)0;
+}
+
+
+void Histogram::record(uint64_t value) {
+  counts[getIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  count.fetch_add(1, std::memory_order_relaxed);
+  sum.fetch_add(value, std::memory_order_relaxed);
+
+  uint64_t x = min.load(std::memory_order_relaxed);
+  while (value < x && !min.compare_exchange_weak(x, value)) continue;
+
+  x = max.load(std::memory_order_relaxed);
+  while (x < value && !max.compare_exchange_weak(x, value)) continue;
+}
+
+
+double Histogram::getMean() const {
+  uint64_t count = this->count;
+  return count ? (double)sum / count : 0;
+}
+
+
+uint64_t Histogram::getPercentile(double p) const {
+  uint64_t total = 0;
+  for (unsigned i = 0; i < numBuckets; i++)
+    total += counts[i].load(std::memory_order_relaxed);
+  if (!total) return 0;
+
+  uint64_t target = (uint64_t)(p / 100 * total + 0.5);
+  if (target < 1) target = 1;
+  if (total < target) target = total;
+
+  uint64_t seen = 0;
+  for (unsigned i = 0; i < numBuckets; i++) {
+    seen += counts[i].load(std::memory_order_relaxed);
+
+    if (target <= seen) {
+      uint64_t value = getHighest(i);
+      uint64_t max = getMax();
+      return max < value ? max : value;
+    }
+  }
+
+  return getMax();
+}
+
+
+unsigned Histogram::getIndex(uint64_t value) {
+  if (value < subBuckets) return value;
+
+  unsigned shift = msb(value) - subBits;
+  if (maxBits - subBits <= shift) return numBuckets - 1;
+
+  return (shift + 1) * subBuckets + (value >> shift) - subBuckets;
+}
+
+
+uint64_t Histogram::getLowest(unsigned index) {
+  if (index < subBuckets) return index;
+
+  unsigned shift = index / subBuckets - 1;
+  return (uint64_t)(subBuckets + index % subBuckets) << shift;
+}
+
+
+uint64_t Histogram::getHighest(unsigned index) {
+  if (index == numBuckets - 1) return ~(uint64_t)0;
+  return getLowest(index + 1) - 1;
+}
+
+
+void Histogram::write(JSON::Sink &sink) const {
+  sink.beginDict();
+  sink.insert("count", getCount());
+  sink.insert("min", getMin());
+  sink.insert("max", getMax());
+  sink.insert("mean", getMean());
+  sink.insert("p50", getPercentile(50));
+  sink.insert("p90", getPercentile(90));
+  sink.insert("p99", getPercentile(99));
+  sink.insert("p999", getPercentile(99.9));
+  sink.endDict();
+}
@@ -0,0 +1,91 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/json/Serializable.h>
+
+#include <atomic>
+#include <cstdint>
+
+
+namespace cb {
+  /**
+   * A lock-free log-linear histogram in the style of HdrHistogram.  Each
+   * power of two is split into 32 linear sub-buckets so recorded values
+   * are resolved to within about 3%.  Values up to 2^36 are held, larger
+   * values are counted in the highest bucket.  Any thread may record
+   * while another reads, though a snapshot taken concurrently with
+   * recording may be slightly inconsistent.
+   */
+  class Histogram : public JSON::Serializable {
+  public:
+    static const unsigned subBits = 5;
+    static const unsigned subBuckets = 1 << subBits;
+    static const unsigned maxBits = 36;
+    static const unsigned numBuckets = (maxBits - subBits + 1) * subBuckets;
+
+  protected:
+    std::atomic<uint64_t> counts[numBuckets];
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> min;
+    std::atomic<uint64_t> max;
+
+  public:
+    Histogram() {reset();}
+
+    void reset();
+    void record(uint64_t value);
+
+    uint64_t getCount() const {return count;}
+    uint64_t getSum() const {return sum;}
+    uint64_t getMin() const {return count ? min.load() : 0;}
+    uint64_t getMax() const {return max;}
+    double getMean() const;
+
+    uint64_t getBucketCount(unsigned index) const
+    {return counts[index].load(std::memory_order_relaxed);}
+
+    /// @return The value below which @param p percent of values fall.
+    uint64_t getPercentile(double p) const;
+
+    static unsigned getIndex(uint64_t value);
+    /// @return The smallest value counted in bucket @param index.
+    static uint64_t getLowest(unsigned index);
+    /// @return The largest value counted in bucket @param index.
+    static uint64_t getHighest(unsigned index);
+
+    // From JSON::Serializable
+    void write(JSON::Sink &sink) const;
+  };
+}
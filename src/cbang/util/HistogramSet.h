@@ -0,0 +1,87 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Histogram.h"
+
+#include <cbang/os/Mutex.h>
+#include <cbang/util/SmartLock.h>
+#include <cbang/json/Serializable.h>
+#include <cbang/json/Sink.h>
+
+#include <string>
+#include <map>
+
+
+namespace cb {
+  /// A thread safe set of named Histograms
+  class HistogramSet : public JSON::Serializable, public Mutex {
+    typedef std::map<const std::string, Histogram> histograms_t;
+    histograms_t histograms;
+
+  public:
+    /// Histograms are never removed so the reference remains valid.
+    Histogram &get(const std::string &key) {
+      SmartLock lock(this);
+      return histograms[key];
+    }
+
+
+    bool has(const std::string &key) const {
+      SmartLock lock(this);
+      return histograms.find(key) != histograms.end();
+    }
+
+
+    void reset() {
+      SmartLock lock(this);
+      for (auto it = histograms.begin(); it != histograms.end(); it++)
+        it->second.reset();
+    }
+
+
+    void record(const std::string &key, uint64_t value) {get(key).record(value);}
+
+
+    // From JSON::Serializable
+    void write(JSON::Sink &sink) const {
+      SmartLock lock(this);
+      sink.beginDict();
+      for (auto it = histograms.begin(); it != histograms.end(); it++) {
+        sink.beginInsert(it->first);
+        it->second.write(sink);
+      }
+      sink.endDict();
+    }
+  };
+}
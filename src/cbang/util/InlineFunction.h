@@ -0,0 +1,253 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cbang/Exception.h>
+
+#include <new>
+#include <cstddef>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+
+namespace cb {
+  template <typename Sig, unsigned Size = 48> class InlineFunction;
+
+
+  /**
+   * A std::function replacement which stores callables of up to @param Size
+   * bytes inline.  Larger callables, or those which may throw when moved,
+   * are allocated on the heap.  Moving never allocates.  Callables which
+   * cannot be copied, such as lambdas capturing a unique_ptr, may be
+   * stored but copying the InlineFunction then throws.
+   */
+  template <typename R, typename... Args, unsigned Size>
+  class InlineFunction<R (Args...), Size> {
+    typedef typename std::aligned_storage<Size>::type storage_t;
+
+    struct Ops {
+      R (*invoke)(void *, Args &&...);
+      void (*move)(void *dst, void *src); // Also destroys src
+      void (*copy)(void *dst, const void *src);
+      void (*destroy)(void *);
+    };
+
+
+    template <typename T>
+    struct IsInline {
+      static const bool value = sizeof(T) <= Size &&
+        alignof(T) <= alignof(storage_t) &&
+        std::is_nothrow_move_constructible<T>::value;
+    };
+
+
+    template <typename T, bool = std::is_copy_constructible<T>::value>
+    struct Copier {
+      static T *copy(const T &o) {return new T(o);}
+      static void copy(void *dst, const T &o) {new (dst) T(o);}
+    };
+
+
+    template <typename T>
+    struct Copier<T, false> {
+      static T *copy(const T &o)
+      {CBANG_THROW("Cannot copy a non-copyable function");}
+      static void copy(void *dst, const T &o) {copy(o);}
+    };
+
+
+    template <typename T>
+    struct InlineOps {
+      static R invoke(void *p, Args &&...args)
+      {return (*(T *)p)(std::forward<Args>(args)...);}
+
+      static void move(void *dst, void *src) {
+        new (dst) T(std::move(*(T *)src));
+        ((T *)src)->~T();
+      }
+
+      static void copy(void *dst, const void *src)
+      {Copier<T>::copy(dst, *(const T *)src);}
+
+      static void destroy(void *p) {((T *)p)->~T();}
+
+      static const Ops ops;
+    };
+
+
+    template <typename T>
+    struct HeapOps {
+      static R invoke(void *p, Args &&...args)
+      {return (**(T **)p)(std::forward<Args>(args)...);}
+
+      static void move(void *dst, void *src) {*(T **)dst = *(T **)src;}
+
+      static void copy(void *dst, const void *src)
+      {*(T **)dst = Copier<T>::copy(**(T *const *)src);}
+
+      static void destroy(void *p) {delete *(T **)p;}
+
+      static const Ops ops;
+    };
+
+
+    template <typename F, typename T = typename std::decay<F>::type>
+    struct IsCallable {
+      template <typename U>
+      static auto test(U *u) -> decltype(
+        (*u)(std::declval<Args>()...), std::true_type());
+
+      template <typename U> static std::false_type test(...);
+
+      static const bool value =
+        !std::is_same<T, InlineFunction>::value &&
+        decltype(test<T>(0))::value;
+    };
+
+
+    mutable storage_t storage;
+    const Ops *ops = 0;
+
+  public:
+    InlineFunction() {}
+    InlineFunction(std::nullptr_t) {}
+
+    template <typename F, typename = typename std::enable_if<
+                            IsCallable<F>::value>::type>
+    InlineFunction(F &&f) {assign(std::forward<F>(f));}
+
+    InlineFunction(const InlineFunction &o) : ops(o.ops)
+    {if (ops) ops->copy(&storage, &o.storage);}
+
+    InlineFunction(InlineFunction &&o) noexcept : ops(o.ops) {
+      if (ops) ops->move(&storage, &o.storage);
+      o.ops = 0;
+    }
+
+    ~InlineFunction() {clear();}
+
+
+    InlineFunction &operator=(const InlineFunction &o) {
+      if (this != &o) {
+        InlineFunction tmp(o);
+        *this = std::move(tmp);
+      }
+
+      return *this;
+    }
+
+
+    InlineFunction &operator=(InlineFunction &&o) noexcept {
+      if (this != &o) {
+        clear();
+        if (o.ops) o.ops->move(&storage, &o.storage);
+        ops = o.ops;
+        o.ops = 0;
+      }
+
+      return *this;
+    }
+
+
+    InlineFunction &operator=(std::nullptr_t) {clear(); return *this;}
+
+
+    template <typename F>
+    typename std::enable_if<IsCallable<F>::value, InlineFunction &>::type
+    operator=(F &&f) {
+      clear();
+      assign(std::forward<F>(f));
+      return *this;
+    }
+
+
+    explicit operator bool() const {return ops;}
+    bool operator==(std::nullptr_t) const {return !ops;}
+    bool operator!=(std::nullptr_t) const {return ops;}
+
+
+    R operator()(Args... args) const {
+      if (!ops) CBANG_THROW("Call of empty function");
+      return ops->invoke(&storage, std::forward<Args>(args)...);
+    }
+
+
+    void clear() {
+      if (ops) ops->destroy(&storage);
+      ops = 0;
+    }
+
+  protected:
+    template <typename F, typename T = typename std::decay<F>::type>
+    typename std::enable_if<IsInline<T>::value>::type assign(F &&f) {
+      if (isNull(f)) return;
+      new (&storage) T(std::forward<F>(f));
+      ops = &InlineOps<T>::ops;
+    }
+
+
+    template <typename F, typename T = typename std::decay<F>::type>
+    typename std::enable_if<!IsInline<T>::value>::type assign(F &&f) {
+      if (isNull(f)) return;
+      *(T **)&storage = new T(std::forward<F>(f));
+      ops = &HeapOps<T>::ops;
+    }
+
+
+    // Empty std::functions and null function pointers stay empty
+    template <typename T> static bool isNull(const T &) {return false;}
+    template <typename T> static bool isNull(T *f) {return !f;}
+    template <typename S> static bool isNull(const std::function<S> &f)
+    {return !f;}
+  };
+
+
+  template <typename R, typename... Args, unsigned Size>
+  template <typename T>
+  const typename InlineFunction<R (Args...), Size>::Ops
+  InlineFunction<R (Args...), Size>::InlineOps<T>::ops = {
+    &InlineOps<T>::invoke, &InlineOps<T>::move, &InlineOps<T>::copy,
+    &InlineOps<T>::destroy
+  };
+
+
+  template <typename R, typename... Args, unsigned Size>
+  template <typename T>
+  const typename InlineFunction<R (Args...), Size>::Ops
+  InlineFunction<R (Args...), Size>::HeapOps<T>::ops = {
+    &HeapOps<T>::invoke, &HeapOps<T>::move, &HeapOps<T>::copy,
+    &HeapOps<T>::destroy
+  };
+}
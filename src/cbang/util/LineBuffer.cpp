@@ -50,12 +50,18 @@ using namespace std;
 using namespace cb;
 
 
+LineBuffer::LineBuffer(unsigned bufferSize) :
+  buffer(bufferSize ? bufferSize : 1), head(0), fill(0) {}
+
+
 void LineBuffer::write(const char *data, unsigned length) {
   while (length) {
-    unsigned space = bufferSize - fill;
+    unsigned space = makeSpace();
     unsigned bytes = space < length ? space : length;
 
-    memcpy(buffer, data, bytes);
+    memcpy(&buffer[fill], data, bytes);
+    fill += bytes;
+    data += bytes;
     length -= bytes;
 
     extractLines();
@@ -65,9 +71,9 @@ void LineBuffer::write(const char *data, unsigned length) {
 
 void LineBuffer::read(istream &stream) {
   while (true) {
-    streamsize space = bufferSize - fill;
+    streamsize space = makeSpace();
 
-    stream.read(buffer + fill, space);
+    stream.read(&buffer[fill], space);
     streamsize bytes = stream.gcount();
 
     if (!bytes) break;
@@ -80,11 +86,28 @@ void LineBuffer::read(istream &stream) {
 }
 
 
+bool LineBuffer::readSome(istream &stream) {
+  makeSpace();
+
+  int c = stream.get();
+  if (c == char_traits<char>::eof()) return false;
+  buffer[fill++] = c;
+
+  // Whatever else is already buffered
+  unsigned space = makeSpace();
+  if (space) fill += stream.readsome(&buffer[fill], space);
+
+  extractLines();
+
+  return true;
+}
+
+
 void LineBuffer::read(int fd) {
   while (true) {
-    ssize_t space = bufferSize - fill;
+    ssize_t space = makeSpace();
 
-    ssize_t bytes = ::read(fd, buffer + fill, space);
+    ssize_t bytes = ::read(fd, &buffer[fill], space);
 
     if (bytes == -1 && errno != EAGAIN && errno != EWOULDBLOCK)
       THROW("Failed to read file descriptor: " << SysError());
@@ -100,35 +123,36 @@ void LineBuffer::read(int fd) {
 
 
 void LineBuffer::flush() {
-  if (fill) {
-    line(buffer, bufferSize);
-    fill = 0;
-  }
+  if (head < fill) line(&buffer[head], fill - head);
+  head = fill = 0;
 }
 
 
-void LineBuffer::extractLines() {
-  while (true) {
-    const char *end = buffer + fill;
-    bool done = true;
-
-    for (const char *eol = buffer; eol < end; eol++)
-      if (*eol == '\n') {
-        unsigned length = eol - buffer;
-
-        line(buffer, length);
-        length++; // Skip \n
+unsigned LineBuffer::makeSpace() {
+  if (fill == buffer.size() && head) {
+    // Move the partial line to the front
+    fill -= head;
+    if (fill) memmove(&buffer[0], &buffer[head], fill);
+    head = 0;
+  }
 
-        fill -= length;
-        memmove(buffer, buffer + length, fill);
+  return buffer.size() - fill;
+}
 
-        done = false;
-        break;
-      }
 
-    if (done) break;
+void LineBuffer::extractLines() {
+  while (head < fill) {
+    const char *begin = &buffer[head];
+    const char *eol = (const char *)memchr(begin, '\n', fill - head);
+    if (!eol) break;
+
+    unsigned length = eol - begin;
+    head += length + 1; // Skip \n
+    line(begin, length);
   }
 
+  if (head == fill) head = fill = 0;
+
   // Dump buffer if full
-  if (fill == bufferSize) flush();
+  else if (!head && fill == buffer.size()) flush();
 }
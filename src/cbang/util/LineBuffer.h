@@ -30,30 +30,49 @@
 
 \******************************************************************************/
 
+
 #pragma once
 
 #include <iostream>
+#include <vector>
 
 
 namespace cb {
+  /**
+   * Splits a byte stream into lines.  Each complete line is passed to line()
+   * as a view into the buffer, without its '\n'.  Only a trailing partial
+   * line is ever moved, when more space is needed, so the cost is linear in
+   * the data.  Lines longer than the buffer are passed on in pieces.
+   */
   class LineBuffer {
-    static const unsigned bufferSize = 64 * 1024;
-    char buffer[bufferSize];
+    std::vector<char> buffer;
+    unsigned head;
     unsigned fill;
 
   public:
-    LineBuffer() : fill(0) {}
+    LineBuffer(unsigned bufferSize = 64 * 1024);
     virtual ~LineBuffer() {}
 
+    /// The bytes of an incomplete line
+    unsigned getPending() const {return fill - head;}
+
     void write(const char *data, unsigned length);
     void read(std::istream &stream);
+    /**
+     * Block until @param stream has data then read what it has buffered.
+     * Unlike read(), lines are passed on as soon as they arrive.
+     * @return false at the end of the stream.
+     */
+    bool readSome(std::istream &stream);
     void read(int fd);
 
+    /// Pass on any incomplete line
     void flush();
 
     virtual void line(const char *data, unsigned length) = 0;
 
   protected:
+    unsigned makeSpace();
     void extractLines();
   };
 }
@@ -0,0 +1,141 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "NonCopyable.h"
+
+#include <atomic>
+#include <cstddef>
+
+
+namespace cb {
+  /**
+   * A bounded lock-free multiple producer, multiple consumer queue.
+   *
+   * The capacity is rounded up to a power of two.  push() fails when the
+   * queue is full and pop() fails when it is empty, neither ever blocks.
+   * Popped slots are reset to T() so values such as SmartPointers are
+   * released promptly.
+   */
+  template <typename T>
+  class MPMCQueue : public NonCopyable {
+    struct Cell {
+      std::atomic<size_t> sequence;
+      T value;
+    };
+
+    Cell *cells;
+    size_t mask;
+
+    // Keep producer and consumer positions on separate cache lines
+    char pad0[64];
+    std::atomic<size_t> enqueuePos;
+    char pad1[64];
+    std::atomic<size_t> dequeuePos;
+    char pad2[64];
+
+  public:
+    MPMCQueue(size_t capacity) : enqueuePos(0), dequeuePos(0) {
+      size_t size = 2;
+      while (size < capacity) size <<= 1;
+
+      cells = new Cell[size];
+      mask = size - 1;
+
+      for (size_t i = 0; i < size; i++)
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    ~MPMCQueue() {delete [] cells;}
+
+
+    size_t getCapacity() const {return mask + 1;}
+
+
+    /// @return An approximate count of queued values.
+    size_t size() const {
+      size_t head = dequeuePos.load(std::memory_order_relaxed);
+      size_t tail = enqueuePos.load(std::memory_order_relaxed);
+      return head < tail ? tail - head : 0;
+    }
+
+
+    bool empty() const {return !size();}
+
+
+    bool push(const T &value) {
+      size_t pos = enqueuePos.load(std::memory_order_relaxed);
+
+      while (true) {
+        Cell &cell = cells[pos & mask];
+        size_t seq = cell.sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+        if (!diff) {
+          if (enqueuePos.compare_exchange_weak
+              (pos, pos + 1, std::memory_order_relaxed)) {
+            cell.value = value;
+            cell.sequence.store(pos + 1, std::memory_order_release);
+            return true;
+          }
+
+        } else if (diff < 0) return false; // Full
+        else pos = enqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+
+
+    bool pop(T &value) {
+      size_t pos = dequeuePos.load(std::memory_order_relaxed);
+
+      while (true) {
+        Cell &cell = cells[pos & mask];
+        size_t seq = cell.sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+
+        if (!diff) {
+          if (dequeuePos.compare_exchange_weak
+              (pos, pos + 1, std::memory_order_relaxed)) {
+            value = cell.value;
+            cell.value = T();
+            cell.sequence.store(pos + mask + 1, std::memory_order_release);
+            return true;
+          }
+
+        } else if (diff < 0) return false; // Empty
+        else pos = dequeuePos.load(std::memory_order_relaxed);
+      }
+    }
+  };
+}
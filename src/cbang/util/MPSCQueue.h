@@ -0,0 +1,114 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "NonCopyable.h"
+
+#include <atomic>
+#include <utility>
+
+
+namespace cb {
+  /**
+   * An unbounded lock-free multiple producer, single consumer queue.
+   *
+   * Any thread may call push().  Only one thread at a time may call pop()
+   * or empty().  A pop() which races with a concurrent push() may miss the
+   * newly pushed value, so producers should notify the consumer after
+   * pushing.
+   */
+  template <typename T>
+  class MPSCQueue : public NonCopyable {
+    struct Node {
+      std::atomic<Node *> next;
+      T value;
+
+      Node() : next(0) {}
+      Node(const T &value) : next(0), value(value) {}
+      Node(T &&value) : next(0), value(std::move(value)) {}
+    };
+
+    std::atomic<Node *> head; // Newest node, producers push here
+    Node *tail;               // Stub node, consumer pops after this
+
+  public:
+    MPSCQueue() : head(new Node), tail(head.load()) {}
+
+    ~MPSCQueue() {
+      while (tail) {
+        Node *next = tail->next.load(std::memory_order_relaxed);
+        delete tail;
+        tail = next;
+      }
+    }
+
+
+    void push(const T &value) {publish(new Node(value));}
+    void push(T &&value) {publish(new Node(std::move(value)));}
+
+
+    /**
+     * Push @param value and reset it to T() before it becomes visible to
+     * the consumer.  Useful for handing off values, such as SmartPointers
+     * with non-atomic reference counts, which must not be touched by the
+     * producer once consumed.
+     */
+    void transfer(T &value) {
+      Node *node = new Node(value);
+      value = T();
+      publish(node);
+    }
+
+
+    bool pop(T &value) {
+      Node *next = tail->next.load(std::memory_order_acquire);
+      if (!next) return false;
+
+      value = std::move(next->value);
+      next->value = T(); // Next becomes the stub
+      delete tail;
+      tail = next;
+
+      return true;
+    }
+
+
+    bool empty() const {return !tail->next.load(std::memory_order_acquire);}
+
+  protected:
+    void publish(Node *node) {
+      Node *prev = head.exchange(node, std::memory_order_acq_rel);
+      prev->next.store(node, std::memory_order_release);
+    }
+  };
+}
@@ -0,0 +1,201 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "MemoryAccounting.h"
+
+#include <cbang/json/Sink.h>
+#include <cbang/util/SmartLock.h>
+
+#include <fstream>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace cb;
+
+
+#if defined(__GNUC__) && !defined(_WIN32)
+// Resolved only when jemalloc or tcmalloc is linked
+extern "C" {
+  int mallctl(const char *name, void *oldp, size_t *oldlenp, void *newp,
+              size_t newlen) __attribute__((weak));
+  int MallocExtension_GetNumericProperty(const char *property, size_t *value)
+    __attribute__((weak));
+}
+#define HAVE_WEAK_MALLOC_STATS
+#endif
+
+
+namespace {
+#ifdef HAVE_WEAK_MALLOC_STATS
+  void insertProperty(JSON::Sink &sink, const char *key, const char *name) {
+    size_t value;
+
+    if (mallctl) {
+      size_t len = sizeof(value);
+      if (!mallctl(name, &value, &len, 0, 0)) sink.insert(key, value);
+
+    } else if (MallocExtension_GetNumericProperty(name, &value))
+      sink.insert(key, value);
+  }
+#endif
+
+
+  uint64_t getResidentBytes() {
+#ifdef __linux__
+    uint64_t size, resident;
+    ifstream statm("/proc/self/statm");
+    if (statm >> size >> resident)
+      return resident * (uint64_t)sysconf(_SC_PAGESIZE);
+#endif
+    return 0;
+  }
+}
+
+
+atomic<bool> MemoryAccounting::enabled(false);
+
+
+MemoryAccounting::~MemoryAccounting() {
+  // Tags are not freed, static references to them may outlive this object
+}
+
+
+MemoryTag &MemoryAccounting::getTag(const string &name) {
+  SmartLock guard(&lock);
+
+  auto it = tags.find(name);
+  if (it != tags.end()) return *it->second;
+
+  return *(tags[name] = new MemoryTag(name));
+}
+
+
+void MemoryAccounting::addSource(const string &name, source_t cb) {
+  SmartLock guard(&lock);
+  sources[name] = cb;
+}
+
+
+void MemoryAccounting::removeSource(const string &name) {
+  SmartLock guard(&lock);
+  sources.erase(name);
+}
+
+
+void MemoryAccounting::writeAllocatorStats(JSON::Sink &sink) {
+  sink.beginDict();
+
+  uint64_t resident = getResidentBytes();
+  if (resident) sink.insert("rss", resident);
+
+#ifdef HAVE_WEAK_MALLOC_STATS
+  if (mallctl) {
+    sink.insert("allocator", "jemalloc");
+
+    // Refresh the cached statistics
+    uint64_t epoch = 1;
+    size_t len = sizeof(epoch);
+    mallctl("epoch", &epoch, &len, &epoch, len);
+
+    insertProperty(sink, "allocated", "stats.allocated");
+    insertProperty(sink, "active", "stats.active");
+    insertProperty(sink, "metadata", "stats.metadata");
+    insertProperty(sink, "resident", "stats.resident");
+    insertProperty(sink, "mapped", "stats.mapped");
+    insertProperty(sink, "retained", "stats.retained");
+    sink.endDict();
+    return;
+  }
+
+  if (MallocExtension_GetNumericProperty) {
+    sink.insert("allocator", "tcmalloc");
+
+    insertProperty(sink, "allocated", "generic.current_allocated_bytes");
+    insertProperty(sink, "heap", "generic.heap_size");
+    insertProperty(sink, "free", "tcmalloc.pageheap_free_bytes");
+    insertProperty(sink, "unmapped", "tcmalloc.pageheap_unmapped_bytes");
+    sink.endDict();
+    return;
+  }
+#endif // HAVE_WEAK_MALLOC_STATS
+
+#if defined(__GLIBC__) && \
+  (2 < __GLIBC__ || (__GLIBC__ == 2 && 33 <= __GLIBC_MINOR__))
+  struct mallinfo2 info = mallinfo2();
+
+  sink.insert("allocator", "glibc");
+  sink.insert("allocated", (uint64_t)info.uordblks + info.hblkhd);
+  sink.insert("arena", (uint64_t)info.arena);
+  sink.insert("mapped", (uint64_t)info.hblkhd);
+  sink.insert("free", (uint64_t)info.fordblks);
+#endif
+
+  sink.endDict();
+}
+
+
+void MemoryAccounting::write(JSON::Sink &sink) const {
+  SmartLock guard(&lock);
+
+  sink.beginDict();
+  sink.insertBoolean("enabled", isEnabled());
+
+  sink.insertDict("tags");
+  for (auto it = tags.begin(); it != tags.end(); it++) {
+    const MemoryTag &tag = *it->second;
+
+    sink.insertDict(tag.getName());
+    sink.insert("bytes", tag.getBytes());
+    sink.insert("allocs", tag.getAllocs());
+    sink.insert("frees", tag.getFrees());
+    sink.endDict();
+  }
+  sink.endDict();
+
+  sink.insertDict("sources");
+  for (auto it = sources.begin(); it != sources.end(); it++)
+    sink.insert(it->first, it->second());
+  sink.endDict();
+
+  sink.beginInsert("allocator");
+  writeAllocatorStats(sink);
+
+  sink.endDict();
+}
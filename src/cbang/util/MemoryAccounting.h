@@ -0,0 +1,162 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "Singleton.h"
+
+#include <cbang/os/Mutex.h>
+#include <cbang/json/Serializable.h>
+
+#include <string>
+#include <map>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+
+namespace cb {
+  /// Bytes and allocations charged to one subsystem
+  class MemoryTag {
+    std::string name;
+    std::atomic<int64_t> bytes;
+    std::atomic<uint64_t> allocs;
+    std::atomic<uint64_t> frees;
+
+  public:
+    MemoryTag(const std::string &name) :
+      name(name), bytes(0), allocs(0), frees(0) {}
+
+    const std::string &getName() const {return name;}
+    int64_t getBytes() const {return bytes;}
+    uint64_t getAllocs() const {return allocs;}
+    uint64_t getFrees() const {return frees;}
+
+    /// Only counted while MemoryAccounting is enabled
+    inline void allocated(size_t size);
+    inline void released(size_t size);
+  };
+
+
+  /**
+   * Optional memory accounting by subsystem.  Subsystems charge their
+   * allocations to a named MemoryTag, either directly or with an
+   * AccountedAllocator, while accounting is enabled.  Subsystems which
+   * already track their memory may instead add a source which is read
+   * when the report is written.  Enable accounting before the tagged
+   * memory is allocated, otherwise releases of memory allocated earlier
+   * are subtracted.
+   *
+   * The report also includes the statistics of jemalloc or tcmalloc, when
+   * either is linked, otherwise those of glibc malloc.
+   */
+  class MemoryAccounting : public Singleton<MemoryAccounting>,
+                           public JSON::Serializable {
+  public:
+    typedef std::function<uint64_t ()> source_t;
+
+  protected:
+    static std::atomic<bool> enabled;
+
+    mutable Mutex lock;
+    std::map<std::string, MemoryTag *> tags; // Never freed
+    std::map<std::string, source_t> sources;
+
+  public:
+    MemoryAccounting(Inaccessible) {}
+    ~MemoryAccounting();
+
+    static bool isEnabled() {return enabled.load(std::memory_order_relaxed);}
+    static void setEnabled(bool x) {enabled = x;}
+
+    /// The returned tag stays valid for the life of the process
+    MemoryTag &getTag(const std::string &name);
+    /// @param cb returns the bytes currently held by subsystem @param name
+    void addSource(const std::string &name, source_t cb);
+    void removeSource(const std::string &name);
+
+    static void writeAllocatorStats(JSON::Sink &sink);
+
+    // From JSON::Serializable
+    void write(JSON::Sink &sink) const;
+  };
+
+
+  inline void MemoryTag::allocated(size_t size) {
+    if (!MemoryAccounting::isEnabled()) return;
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    allocs.fetch_add(1, std::memory_order_relaxed);
+  }
+
+
+  inline void MemoryTag::released(size_t size) {
+    if (!MemoryAccounting::isEnabled()) return;
+    bytes.fetch_sub(size, std::memory_order_relaxed);
+    frees.fetch_add(1, std::memory_order_relaxed);
+  }
+
+
+  /// A standard allocator which charges a MemoryTag
+  template <typename T>
+  class AccountedAllocator {
+    template <typename U> friend class AccountedAllocator;
+    MemoryTag *tag;
+
+  public:
+    typedef T value_type;
+
+    AccountedAllocator(MemoryTag &tag) : tag(&tag) {}
+    template <typename U>
+    AccountedAllocator(const AccountedAllocator<U> &o) : tag(o.tag) {}
+
+    T *allocate(size_t n) {
+      T *p = std::allocator<T>().allocate(n);
+      tag->allocated(n * sizeof(T));
+      return p;
+    }
+
+    void deallocate(T *p, size_t n) {
+      tag->released(n * sizeof(T));
+      std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const AccountedAllocator<U> &o) const
+    {return tag == o.tag;}
+    template <typename U>
+    bool operator!=(const AccountedAllocator<U> &o) const
+    {return tag != o.tag;}
+  };
+}
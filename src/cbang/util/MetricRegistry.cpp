@@ -0,0 +1,325 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "MetricRegistry.h"
+#include "Histogram.h"
+
+#include <cbang/Exception.h>
+#include <cbang/util/SmartLock.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+using namespace cb;
+
+
+namespace {
+  bool isValidName(const string &name, bool colons = true) {
+    if (name.empty()) return false;
+
+    for (unsigned i = 0; i < name.size(); i++) {
+      char c = name[i];
+      if (('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || c == '_' ||
+          (colons && c == ':') || (i && '0' <= c && c <= '9')) continue;
+      return false;
+    }
+
+    return true;
+  }
+
+
+  string escape(const string &s, bool quotes) {
+    string result;
+
+    for (unsigned i = 0; i < s.size(); i++)
+      switch (s[i]) {
+      case '\\': result += "\\\\"; break;
+      case '\n': result += "\\n"; break;
+      case '"': result += quotes ? "\\\"" : "\""; break;
+      default: result += s[i]; break;
+      }
+
+    return result;
+  }
+
+
+  const char *typeName(MetricRegistry::type_t type) {
+    switch (type) {
+    case MetricRegistry::METRIC_COUNTER: return "counter";
+    case MetricRegistry::METRIC_GAUGE: return "gauge";
+    case MetricRegistry::METRIC_HISTOGRAM: return "histogram";
+    }
+
+    return "untyped";
+  }
+}
+
+
+struct MetricRegistry::Series {
+  string labels;
+  string prefix;
+  callback_t cb;
+
+  SmartPointer<Counter> counter;
+  SmartPointer<Gauge> gauge;
+
+  SmartPointer<Histogram> hist;
+  double scale = 1;
+  vector<unsigned> limits; // Histogram buckets at or below each bound
+  vector<string> bucketPrefixes;
+  string sumPrefix;
+  string countPrefix;
+};
+
+
+struct MetricRegistry::Family {
+  type_t type;
+  string name;
+  string header;
+  vector<SmartPointer<Series> > series;
+};
+
+
+MetricRegistry::MetricRegistry() {}
+MetricRegistry::~MetricRegistry() {}
+
+
+MetricRegistry::Counter &
+MetricRegistry::addCounter(const string &name, const string &help,
+                           const labels_t &labels) {
+  SmartLock lock(this);
+
+  Series &series = addSeries(getFamily(METRIC_COUNTER, name, help), labels);
+  Counter *counter = new Counter;
+  series.counter = counter;
+  series.cb = [counter] () {return (double)counter->get();};
+
+  return *counter;
+}
+
+
+MetricRegistry::Gauge &
+MetricRegistry::addGauge(const string &name, const string &help,
+                         const labels_t &labels) {
+  SmartLock lock(this);
+
+  Series &series = addSeries(getFamily(METRIC_GAUGE, name, help), labels);
+  Gauge *gauge = new Gauge;
+  series.gauge = gauge;
+  series.cb = [gauge] () {return (double)gauge->get();};
+
+  return *gauge;
+}
+
+
+void MetricRegistry::addCallback(type_t type, const string &name,
+                                 const string &help, callback_t cb,
+                                 const labels_t &labels) {
+  if (type == METRIC_HISTOGRAM) THROW("Use addHistogram()");
+  if (!cb) THROW("Callback cannot be NULL");
+
+  SmartLock lock(this);
+  addSeries(getFamily(type, name, help), labels).cb = cb;
+}
+
+
+void MetricRegistry::addHistogram(const string &name, const string &help,
+                                  const SmartPointer<Histogram> &hist,
+                                  const vector<double> &_bounds, double scale,
+                                  const labels_t &labels) {
+  if (hist.isNull()) THROW("Histogram cannot be NULL");
+
+  vector<double> bounds = _bounds;
+  sort(bounds.begin(), bounds.end());
+  bounds.erase(unique(bounds.begin(), bounds.end()), bounds.end());
+
+  SmartLock lock(this);
+
+  Family &family = getFamily(METRIC_HISTOGRAM, name, help);
+  Series &series = addSeries(family, labels);
+
+  series.hist = hist;
+  series.scale = scale;
+
+  unsigned limit = 0;
+  for (unsigned i = 0; i <= bounds.size(); i++) {
+    labels_t bucketLabels = labels;
+    string le;
+
+    if (i < bounds.size()) {
+      while (limit < Histogram::numBuckets &&
+             Histogram::getHighest(limit) * scale <= bounds[i]) limit++;
+      series.limits.push_back(limit);
+      appendNumber(le, bounds[i]);
+
+    } else le = "+Inf";
+
+    bucketLabels.push_back(labels_t::value_type("le", le));
+    series.bucketPrefixes.push_back
+      (name + "_bucket" + formatLabels(bucketLabels) + " ");
+  }
+
+  series.sumPrefix = name + "_sum" + series.labels + " ";
+  series.countPrefix = name + "_count" + series.labels + " ";
+}
+
+
+unsigned MetricRegistry::getFamilyCount() const {
+  SmartLock lock(this);
+  return families.size();
+}
+
+
+void MetricRegistry::render(string &out) const {
+  SmartLock lock(this);
+
+  for (unsigned i = 0; i < families.size(); i++) {
+    const Family &family = *families[i];
+    out += family.header;
+
+    for (unsigned j = 0; j < family.series.size(); j++) {
+      const Series &series = *family.series[j];
+
+      if (series.hist.isNull()) {
+        out += series.prefix;
+        appendNumber(out, series.cb());
+        out += '\n';
+        continue;
+      }
+
+      const Histogram &hist = *series.hist;
+      uint64_t cumulative = 0;
+      unsigned bucket = 0;
+
+      for (unsigned k = 0; k < series.bucketPrefixes.size(); k++) {
+        unsigned limit = k < series.limits.size() ?
+          series.limits[k] : Histogram::numBuckets;
+
+        for (; bucket < limit; bucket++)
+          cumulative += hist.getBucketCount(bucket);
+
+        out += series.bucketPrefixes[k];
+        appendNumber(out, cumulative);
+        out += '\n';
+      }
+
+      out += series.sumPrefix;
+      appendNumber(out, hist.getSum() * series.scale);
+      out += '\n';
+      out += series.countPrefix;
+      appendNumber(out, cumulative);
+      out += '\n';
+    }
+  }
+}
+
+
+string MetricRegistry::formatLabels(const labels_t &labels) {
+  if (labels.empty()) return "";
+
+  string s = "{";
+
+  for (unsigned i = 0; i < labels.size(); i++) {
+    const string &name = labels[i].first;
+    if (!isValidName(name, false)) THROW("Invalid label name '" << name << "'");
+
+    if (i) s += ',';
+    s += name + "=\"" + escape(labels[i].second, true) + '"';
+  }
+
+  return s + "}";
+}
+
+
+void MetricRegistry::appendNumber(string &out, double x) {
+  if (std::isnan(x)) {out += "NaN"; return;}
+  if (std::isinf(x)) {out += x < 0 ? "-Inf" : "+Inf"; return;}
+
+  char buf[32];
+  int n;
+
+  if (x == floor(x) && fabs(x) < 9007199254740992.0)
+    n = snprintf(buf, sizeof(buf), "%lld", (long long)x);
+  else {
+    // Prefer the shortest representation which reads back exactly
+    n = snprintf(buf, sizeof(buf), "%.15g", x);
+    if (strtod(buf, 0) != x) n = snprintf(buf, sizeof(buf), "%.17g", x);
+  }
+
+  out.append(buf, n);
+}
+
+
+MetricRegistry::Family &
+MetricRegistry::getFamily(type_t type, const string &name,
+                          const string &help) {
+  if (!isValidName(name)) THROW("Invalid metric name '" << name << "'");
+
+  auto it = index.find(name);
+  if (it != index.end()) {
+    Family &family = *families[it->second];
+    if (family.type != type)
+      THROW("Metric '" << name << "' is already a " << typeName(family.type));
+    return family;
+  }
+
+  SmartPointer<Family> family = new Family;
+  family->type = type;
+  family->name = name;
+  family->header = "# HELP " + name + " " + escape(help, false) + "\n" +
+    "# TYPE " + name + " " + typeName(type) + "\n";
+
+  index[name] = families.size();
+  families.push_back(family);
+
+  return *family;
+}
+
+
+MetricRegistry::Series &
+MetricRegistry::addSeries(Family &family, const labels_t &labels) {
+  string formatted = formatLabels(labels);
+
+  for (unsigned i = 0; i < family.series.size(); i++)
+    if (family.series[i]->labels == formatted)
+      THROW("Metric " << family.name << formatted << " already exists");
+
+  SmartPointer<Series> series = new Series;
+  series->labels = formatted;
+  series->prefix = family.name + formatted + " ";
+  family.series.push_back(series);
+
+  return *series;
+}
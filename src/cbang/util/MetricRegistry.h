@@ -0,0 +1,135 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/SmartPointer.h>
+#include <cbang/os/Mutex.h>
+#include <cbang/util/ShardedCounter.h>
+
+#include <string>
+#include <vector>
+#include <map>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+
+
+namespace cb {
+  class Histogram;
+
+  /**
+   * A registry of counters, gauges and histograms which can be rendered in
+   * the Prometheus text exposition format.  Metrics with the same name
+   * form a family and are distinguished by their labels.  Label strings
+   * and line prefixes are formatted once when a metric is added so
+   * rendering only appends to the caller's buffer.
+   */
+  class MetricRegistry : public Mutex {
+  public:
+    typedef std::vector<std::pair<std::string, std::string> > labels_t;
+    typedef std::function<double ()> callback_t;
+
+    typedef enum {
+      METRIC_COUNTER,
+      METRIC_GAUGE,
+      METRIC_HISTOGRAM,
+    } type_t;
+
+
+    class Counter {
+      ShardedCounter value;
+
+    public:
+      void inc(uint64_t x = 1) {value.add(x);}
+      uint64_t get() const {return value.get();}
+    };
+
+
+    class Gauge {
+      std::atomic<int64_t> value;
+
+    public:
+      Gauge() : value(0) {}
+
+      void set(int64_t x) {value = x;}
+      void inc(int64_t x = 1) {value.fetch_add(x, std::memory_order_relaxed);}
+      void dec(int64_t x = 1) {value.fetch_sub(x, std::memory_order_relaxed);}
+      int64_t get() const {return value;}
+    };
+
+  protected:
+    struct Series;
+    struct Family;
+
+    std::vector<SmartPointer<Family> > families;
+    std::map<std::string, unsigned> index;
+
+  public:
+    MetricRegistry();
+    ~MetricRegistry();
+
+    Counter &addCounter(const std::string &name, const std::string &help,
+                        const labels_t &labels = labels_t());
+    Gauge &addGauge(const std::string &name, const std::string &help,
+                    const labels_t &labels = labels_t());
+
+    /// Add a counter or gauge whose value is read from @param cb.
+    void addCallback(type_t type, const std::string &name,
+                     const std::string &help, callback_t cb,
+                     const labels_t &labels = labels_t());
+
+    /**
+     * Export @param hist with cumulative buckets at each of the upper
+     * @param bounds.  Recorded values are multiplied by @param scale,
+     * e.g. 1e-6 to export microseconds as seconds.  Each bound is rounded
+     * to the histogram's resolution.
+     */
+    void addHistogram(const std::string &name, const std::string &help,
+                      const SmartPointer<Histogram> &hist,
+                      const std::vector<double> &bounds, double scale = 1,
+                      const labels_t &labels = labels_t());
+
+    unsigned getFamilyCount() const;
+
+    /// Append all metrics to @param out in the text exposition format.
+    void render(std::string &out) const;
+
+    static std::string formatLabels(const labels_t &labels);
+    static void appendNumber(std::string &out, double x);
+
+  protected:
+    Family &getFamily(type_t type, const std::string &name,
+                      const std::string &help);
+    Series &addSeries(Family &family, const labels_t &labels);
+  };
+}
@@ -0,0 +1,154 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace cb {
+  /**
+   * Recycles the memory of objects of type T, and of classes derived from
+   * it, through per thread free lists rather than returning it to the heap.
+   * Objects are still fully constructed and destroyed, only their storage
+   * is reused, so frequently created short lived objects avoid most
+   * allocator traffic.  Each thread keeps at most maxIdle blocks of each
+   * size.  The free lists are released when the thread exits.
+   */
+  template <typename T>
+  class PoolAllocated {
+    struct List {
+      std::size_t size;
+      std::vector<void *> blocks;
+    };
+
+
+    struct Pool {
+      std::vector<List> lists;
+
+      ~Pool() {
+        for (unsigned i = 0; i < lists.size(); i++)
+          for (unsigned j = 0; j < lists[i].blocks.size(); j++) {
+            std::free(lists[i].blocks[j]);
+            idle()--;
+          }
+      }
+
+
+      List &get(std::size_t size) {
+        for (unsigned i = 0; i < lists.size(); i++)
+          if (lists[i].size == size) return lists[i];
+
+        lists.push_back(List());
+        lists.back().size = size;
+        return lists.back();
+      }
+    };
+
+
+    struct Reaper {
+      Pool *&pool;
+      bool &done;
+      ~Reaper() {delete pool; pool = 0; done = true;}
+    };
+
+
+    /// @return The current thread's Pool or null once it has exited
+    static Pool *getPool() {
+      static thread_local Pool *pool = 0;
+      static thread_local bool done = false;
+
+      if (!pool && !done) {
+        static thread_local Reaper reaper = {pool, done};
+        pool = new Pool;
+      }
+
+      return pool;
+    }
+
+
+    static std::atomic<unsigned> &idle()
+    {static std::atomic<unsigned> count(0); return count;}
+    static std::atomic<uint64_t> &hits()
+    {static std::atomic<uint64_t> count(0); return count;}
+    static std::atomic<uint64_t> &misses()
+    {static std::atomic<uint64_t> count(0); return count;}
+
+  public:
+    static const unsigned maxIdle = 256;
+
+    /// @return The number of idle blocks held by all threads.
+    static unsigned getPoolIdle() {return idle();}
+    /// @return The number of allocations served from a free list.
+    static uint64_t getPoolHits() {return hits();}
+    /// @return The number of allocations which went to the heap.
+    static uint64_t getPoolMisses() {return misses();}
+
+
+    static void *operator new(std::size_t size) {
+      Pool *pool = getPool();
+      std::vector<void *> *blocks = pool ? &pool->get(size).blocks : 0;
+
+      if (blocks && !blocks->empty()) {
+        void *ptr = blocks->back();
+        blocks->pop_back();
+        idle()--;
+        hits()++;
+        return ptr;
+      }
+
+      misses()++;
+      void *ptr = std::malloc(size);
+      if (!ptr) throw std::bad_alloc();
+      return ptr;
+    }
+
+
+    static void operator delete(void *ptr, std::size_t size) {
+      if (!ptr) return;
+
+      Pool *pool = getPool();
+      std::vector<void *> *blocks = pool ? &pool->get(size).blocks : 0;
+
+      if (blocks && blocks->size() < maxIdle) {
+        blocks->push_back(ptr);
+        idle()++;
+
+      } else std::free(ptr);
+    }
+  };
+}
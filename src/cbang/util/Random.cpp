@@ -32,40 +32,227 @@
 
 #include "Random.h"
 
+#include <cbang/Exception.h>
 #include <cbang/config.h>
 
+#include <atomic>
+
+#include <string.h>
+
 #ifdef HAVE_OPENSSL
 #include <openssl/rand.h>
-#else
+
+#elif defined(_WIN32)
+#define _CRT_RAND_S
 #include <stdlib.h>
+
+#else
+#include <cbang/os/SysError.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifndef _WIN32
+#include <pthread.h>
 #endif
 
 using namespace cb;
 
 
-Random::Random(Inaccessible) {}
+namespace {
+  // Incremented to make every thread reseed before its next output
+  std::atomic<unsigned> epoch(1);
 
 
-void Random::addEntropy(const void *buffer, uint32_t bytes, double entropy) {
+  void osBytes(void *buffer, unsigned bytes) {
 #ifdef HAVE_OPENSSL
-  RAND_add(buffer, bytes, entropy ? entropy : bytes);
+    if (RAND_bytes((unsigned char *)buffer, bytes) != 1)
+      THROW("Failed to get random bytes from OpenSSL");
+
+#elif defined(_WIN32)
+    uint8_t *ptr = (uint8_t *)buffer;
+    for (unsigned i = 0; i < bytes; i += sizeof(unsigned)) {
+      unsigned x;
+      if (rand_s(&x)) THROW("rand_s() failed");
+      unsigned n = bytes - i < sizeof(x) ? bytes - i : sizeof(x);
+      memcpy(ptr + i, &x, n);
+    }
 
 #else
-  if (sizeof(unsigned) <= bytes) srand(*(unsigned *)buffer);
+    int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) THROW("Failed to open /dev/urandom: " << SysError());
+
+    uint8_t *ptr = (uint8_t *)buffer;
+    while (bytes) {
+      ssize_t ret = read(fd, ptr, bytes);
+
+      if (ret <= 0) {
+        if (ret < 0 && errno == EINTR) continue;
+        close(fd);
+        THROW("Failed to read /dev/urandom: " << SysError());
+      }
+
+      ptr += ret;
+      bytes -= ret;
+    }
+
+    close(fd);
 #endif
-}
+  }
 
 
-void Random::bytes(void *buffer, uint32_t bytes) {
-#ifdef HAVE_OPENSSL
-  RAND_bytes((unsigned char *)buffer, bytes);
+#ifndef _WIN32
+  void afterFork() {epoch++;}
+#endif
 
-#else
-  while (1 < bytes) {
-    bytes -= 2;
-    ((uint16_t *)buffer)[bytes / 2] = ::rand();
+
+  /***
+   * ChaCha20 with fast key erasure.  Each refill generates a buffer of
+   * blocks, takes the first 32 bytes as the next key and wipes output as
+   * it is consumed, so earlier output cannot be recovered from the state.
+   */
+  class Generator {
+    static const unsigned BLOCKS = 8;
+    static const unsigned KEY_SIZE = 32;
+    static const uint64_t RESEED_BYTES = 1 << 20;
+
+    uint32_t key[8] = {};
+    alignas(16) uint8_t buffer[64 * BLOCKS];
+    unsigned offset = sizeof(buffer);
+    uint64_t generated = 0;
+    unsigned seedEpoch = 0;
+
+  public:
+    ~Generator() {wipe(key, sizeof(key)); wipe(buffer, sizeof(buffer));}
+
+
+    static void wipe(void *ptr, unsigned bytes) {
+      volatile uint8_t *p = (volatile uint8_t *)ptr;
+      while (bytes--) *p++ = 0;
+    }
+
+
+    void mix(const void *data, unsigned bytes) {
+      const uint8_t *src = (const uint8_t *)data;
+      uint8_t *k = (uint8_t *)key;
+      for (unsigned i = 0; i < bytes; i++) k[i % KEY_SIZE] ^= src[i];
+      refill();
+    }
+
+
+    void bytes(void *data, unsigned bytes) {
+      uint8_t *dst = (uint8_t *)data;
+
+      while (bytes) {
+        if (seedEpoch != epoch.load(std::memory_order_relaxed) ||
+            RESEED_BYTES <= generated) reseed();
+        if (offset == sizeof(buffer)) refill();
+
+        unsigned n = sizeof(buffer) - offset;
+        if (bytes < n) n = bytes;
+
+        memcpy(dst, buffer + offset, n);
+        memset(buffer + offset, 0, n);
+
+        offset += n;
+        generated += n;
+        dst += n;
+        bytes -= n;
+      }
+    }
+
+
+  protected:
+    void reseed() {
+      seedEpoch = epoch.load();
+      generated = 0;
+
+      uint32_t seed[8];
+      osBytes(seed, sizeof(seed));
+      for (unsigned i = 0; i < 8; i++) key[i] ^= seed[i];
+      wipe(seed, sizeof(seed));
+
+      refill();
+    }
+
+
+    static uint32_t rotl(uint32_t x, unsigned n) {
+      return (x << n) | (x >> (32 - n));
+    }
+
+
+    static void quarterRound(uint32_t *x, int a, int b, int c, int d) {
+      x[a] += x[b]; x[d] = rotl(x[d] ^ x[a], 16);
+      x[c] += x[d]; x[b] = rotl(x[b] ^ x[c], 12);
+      x[a] += x[b]; x[d] = rotl(x[d] ^ x[a], 8);
+      x[c] += x[d]; x[b] = rotl(x[b] ^ x[c], 7);
+    }
+
+
+    void block(uint32_t counter, uint32_t *x, uint32_t *out) const {
+      // "expand 32-byte k", key, 64-bit block counter and a zero nonce
+      const uint32_t in[16] = {
+        0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,
+        key[0], key[1], key[2], key[3], key[4], key[5], key[6], key[7],
+        counter, 0, 0, 0,
+      };
+
+      memcpy(x, in, sizeof(in));
+
+      for (unsigned i = 0; i < 10; i++) {
+        quarterRound(x, 0, 4,  8, 12);
+        quarterRound(x, 1, 5,  9, 13);
+        quarterRound(x, 2, 6, 10, 14);
+        quarterRound(x, 3, 7, 11, 15);
+        quarterRound(x, 0, 5, 10, 15);
+        quarterRound(x, 1, 6, 11, 12);
+        quarterRound(x, 2, 7,  8, 13);
+        quarterRound(x, 3, 4,  9, 14);
+      }
+
+      for (unsigned i = 0; i < 16; i++) out[i] = x[i] + in[i];
+    }
+
+
+    void refill() {
+      uint32_t x[16];
+      uint32_t *out = (uint32_t *)buffer;
+
+      // The key changes every refill so the counter can restart at zero
+      for (unsigned i = 0; i < BLOCKS; i++) block(i, x, out + 16 * i);
+      wipe(x, sizeof(x));
+
+      memcpy(key, buffer, KEY_SIZE);
+      memset(buffer, 0, KEY_SIZE);
+      offset = KEY_SIZE;
+    }
+  };
+
+
+  Generator &getGenerator() {
+    static thread_local Generator generator;
+    return generator;
   }
+}
+
+
+Random::Random(Inaccessible) {
+#ifndef _WIN32
+  pthread_atfork(0, 0, afterFork);
+#endif
+}
+
 
-  if (bytes) *(uint8_t *)buffer = ::rand();
+void Random::addEntropy(const void *buffer, uint32_t bytes, double entropy) {
+#ifdef HAVE_OPENSSL
+  RAND_add(buffer, bytes, entropy ? entropy : bytes);
 #endif
+
+  getGenerator().mix(buffer, bytes);
+  epoch++;
+}
+
+
+void Random::bytes(void *buffer, uint32_t bytes) {
+  getGenerator().bytes(buffer, bytes);
 }
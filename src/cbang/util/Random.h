@@ -38,6 +38,12 @@
 
 
 namespace cb {
+  /**
+   * Cryptographically secure random numbers.  Each thread has its own
+   * ChaCha20 generator, seeded from the OS, so calls do not contend on a
+   * lock.  Generators are reseeded after every megabyte of output, after
+   * fork() and after addEntropy().
+   */
   class Random : public Singleton<Random> {
   public:
     Random(Inaccessible);
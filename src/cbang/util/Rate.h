@@ -38,23 +38,33 @@
 
 
 namespace cb {
+  /**
+   * Measures the rate of events over a sliding window of @param size
+   * buckets, each @param period seconds long.  A running sum of the
+   * window is maintained so get() does not have to visit every bucket.
+   * The ring of buckets is rounded up to a power of two.
+   */
   class Rate {
   public:
     std::vector<double> buckets;
+    const unsigned size;
     const unsigned period;
     double total;
+    double sum;
 
+    unsigned mask;
     unsigned last;
     unsigned head;
     unsigned fill;
 
   public:
     Rate(unsigned size = 60 * 5, unsigned period = 1) :
-      buckets(size), period(period) {reset();}
+      buckets(ringSize(size)), size(size ? size : 1), period(period),
+      mask(buckets.size() - 1) {reset();}
 
 
     void reset() {
-      total = last = head = 0;
+      total = sum = last = head = 0;
       fill = 1;
       buckets[0] = 0;
     }
@@ -66,18 +76,18 @@ namespace cb {
     double get(uint64_t now = Time::now()) const {
       if (!last) return 0; // No events
       unsigned delta = now / period - last;
-      if (buckets.size() <= delta) return 0; // Too long since last event
+      if (size <= delta) return 0; // Too long since last event
 
       // Accounting for the delta ignore buckets which are too old
-      unsigned maxFill = buckets.size() - delta;
+      unsigned maxFill = size - delta;
       unsigned fill = maxFill < this->fill ? maxFill : this->fill;
 
       if (fill < 2) return 0; // Need at least two buckets
 
-      // Count up the buckets
-      double count = 0;
-      for (unsigned i = 0; i < fill; i++)
-        count += buckets[(head + buckets.size() - i) % buckets.size()];
+      // Subtract the oldest buckets which have left the window
+      double count = sum;
+      for (unsigned i = fill; i < this->fill; i++)
+        count -= buckets[(head - i) & mask];
 
       // Divide by the total time
       return count / ((fill + delta) * period);
@@ -87,20 +97,82 @@ namespace cb {
     void event(double value = 1, uint64_t now = Time::now()) {
       unsigned time = now / period;
 
-      if (last) {
-        unsigned delta = time - last;
+      if (last) advance(time);
 
-        // Advance, clearing any expired buckets along the way
-        for (unsigned i = 0; i < delta && i < buckets.size(); i++) {
-          if (fill < buckets.size()) fill++;
-          if (++head == buckets.size()) head = 0;
+      buckets[head] += value; // Sum event
+      sum += value;
+      total += value;
+      last = time;
+    }
+
+
+    /// Add the events of @param o, which must have the same size and period
+    void add(const Rate &o) {
+      if (!o.last) return;
+
+      if (!last) {
+        buckets = o.buckets;
+        total = o.total;
+        sum = o.sum;
+        last = o.last;
+        head = o.head;
+        fill = o.fill;
+        return;
+      }
+
+      // Line up both windows at the later time
+      Rate other(o);
+      unsigned time = last < other.last ? other.last : last;
+      advance(time);
+      other.advance(time);
+
+      for (unsigned i = fill; i < other.fill; i++)
+        buckets[(head - i) & mask] = 0;
+      if (fill < other.fill) fill = other.fill;
+
+      for (unsigned i = 0; i < other.fill; i++)
+        buckets[(head - i) & mask] += other.buckets[(other.head - i) & mask];
+
+      sum += other.sum;
+      total += other.total;
+    }
+
+
+  protected:
+    void advance(unsigned time) {
+      unsigned delta = time - last;
+
+      if (size <= delta) { // The whole window has expired
+        for (unsigned i = 0; i < size; i++) buckets[(head - i) & mask] = 0;
+        fill = size;
+        sum = 0;
+
+      } else // Advance, dropping buckets which leave the window
+        for (unsigned i = 0; i < delta; i++) {
+          if (fill < size) fill++;
+          else sum -= buckets[(head - (size - 1)) & mask];
+
+          head = (head + 1) & mask;
           buckets[head] = 0;
+
+          // Recompute the sum once per lap so rounding errors don't build
+          if (!head) resum();
         }
-      }
 
-      buckets[head] += value; // Sum event
-      total += value;
       last = time;
     }
+
+
+    static unsigned ringSize(unsigned size) {
+      unsigned ring = 1;
+      while (ring < size) ring <<= 1;
+      return ring;
+    }
+
+
+    void resum() {
+      sum = 0;
+      for (unsigned i = 0; i < fill; i++) sum += buckets[(head - i) & mask];
+    }
   };
 }
@@ -33,8 +33,11 @@
 #pragma once
 
 #include "Rate.h"
+#include "Sharded.h"
 
 #include <cbang/Exception.h>
+#include <cbang/os/SpinLock.h>
+#include <cbang/util/SmartLock.h>
 #include <cbang/json/Serializable.h>
 #include <cbang/json/Sink.h>
 
@@ -43,39 +46,68 @@
 
 
 namespace cb {
+  /**
+   * A thread safe set of named Rates.  Each thread records events in its
+   * own shard, see Sharded, so event() does not contend.  Reads merge the
+   * shards.
+   */
   class RateSet : public JSON::Serializable {
     const unsigned size;
     const unsigned period;
 
     typedef std::map<const std::string, Rate> rates_t;
-    rates_t rates;
+
+    struct shard_t {
+      SpinLock lock;
+      rates_t rates;
+    };
+
+    Sharded<shard_t> shards;
 
   public:
     RateSet(unsigned size = 60 * 5, unsigned period = 1) :
       size(size), period(period) {}
 
 
-    Rate &getRate(const std::string &key) {
-      return rates.insert(rates_t::value_type(key, Rate(size, period)))
-        .first->second;
-    }
+    /// @return The Rate of @param key merged across threads
+    Rate getRate(const std::string &key) const {
+      Rate rate(size, period);
+      bool found = false;
 
+      for (unsigned i = 0; i < shards.size(); i++) {
+        const shard_t &shard = shards.at(i);
+        SmartLock lock(&shard.lock);
 
-    const Rate &getRate(const std::string &key) const {
-      auto it = rates.find(key);
-      if (it == rates.end()) CBANG_THROW("Rate '" << key << "' not in set");
-      return it->second;
+        auto it = shard.rates.find(key);
+        if (it != shard.rates.end()) {
+          rate.add(it->second);
+          found = true;
+        }
+      }
+
+      if (!found) CBANG_THROW("Rate '" << key << "' not in set");
+      return rate;
     }
 
 
     void reset() {
-      for (auto it = rates.begin(); it != rates.end(); it++)
-        it->second.reset();
+      for (unsigned i = 0; i < shards.size(); i++) {
+        shard_t &shard = shards.at(i);
+        SmartLock lock(&shard.lock);
+        for (auto it = shard.rates.begin(); it != shard.rates.end(); it++)
+          it->second.reset();
+      }
     }
 
 
     bool has(const std::string &key) const {
-      return rates.find(key) != rates.end();
+      for (unsigned i = 0; i < shards.size(); i++) {
+        const shard_t &shard = shards.at(i);
+        SmartLock lock(&shard.lock);
+        if (shard.rates.find(key) != shard.rates.end()) return true;
+      }
+
+      return false;
     }
 
 
@@ -86,14 +118,29 @@ namespace cb {
 
     void event(const std::string &key, double value = 1,
                uint64_t now = Time::now()) {
-      getRate(key).event(value, now);
+      shard_t &shard = shards.local();
+      SmartLock lock(&shard.lock);
+
+      shard.rates.insert(rates_t::value_type(key, Rate(size, period)))
+        .first->second.event(value, now);
     }
 
 
     // From JSON::Serializable
     void write(JSON::Sink &sink) const {
+      rates_t merged;
+
+      for (unsigned i = 0; i < shards.size(); i++) {
+        const shard_t &shard = shards.at(i);
+        SmartLock lock(&shard.lock);
+
+        for (auto it = shard.rates.begin(); it != shard.rates.end(); it++)
+          merged.insert(rates_t::value_type(it->first, Rate(size, period)))
+            .first->second.add(it->second);
+      }
+
       sink.beginDict();
-      for (auto it = rates.begin(); it != rates.end(); it++)
+      for (auto it = merged.begin(); it != merged.end(); it++)
         sink.insert(it->first, it->second.get());
       sink.endDict();
     }
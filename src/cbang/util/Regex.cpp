@@ -32,7 +32,14 @@
 
 #include "Regex.h"
 
+#include <cbang/os/Mutex.h>
+#include <cbang/util/SmartLock.h>
+
 #include <boost/regex.hpp>
+#include <re2/re2.h>
+
+#include <list>
+#include <map>
 
 
 using namespace cb;
@@ -61,18 +68,54 @@ namespace {
 }
 
 
-struct Regex::private_t {
-  boost::regex re;
+struct Regex::private_t : public Mutex {
+  string pattern;
+  SmartPointer<RE2> re2;
+  SmartPointer<boost::regex> re;
 
-  private_t(const string &pattern) try : re(pattern) {
-  } catch (const boost::regex_error &e) {
-    THROW("Failed to parse regex: " << e.what());
+  private_t(const string &pattern, type_t type) : pattern(pattern) {
+    if (type != TYPE_BOOST) {
+      RE2::Options options;
+      options.set_log_errors(false);
+      options.set_longest_match(type == TYPE_POSIX);
+
+      // Like Boost.Regex, '.' matches newlines and '^' and '$' match at them
+      re2 = new RE2("(?ms)" + pattern, options);
+      if (!re2->ok()) re2.release();
+    }
+
+    if (re2.isNull()) re = compileBoost(); // Report syntax errors now
+  }
+
+
+  SmartPointer<boost::regex> compileBoost() const {
+    try {
+      return new boost::regex(pattern);
+    } catch (const boost::regex_error &e) {
+      THROW("Failed to parse regex: " << e.what());
+    }
+  }
+
+
+  const boost::regex &getBoost() {
+    if (re2.isNull()) return *re; // Compiled by the constructor
+
+    SmartLock lock(this);
+    if (re.isNull()) re = compileBoost();
+    return *re;
   }
 };
 
 
 struct Regex::Match::private_t {
   boost::smatch m;
+
+  // Set when matched with RE2, Boost.Regex is run on demand by format()
+  Regex::pri_t re;
+  string subject;
+  bool anchored = false;
+
+  vector<unsigned> positions;
 };
 
 
@@ -81,6 +124,17 @@ Regex::Match::Match(type_t type) : pri(new private_t), type(type) {}
 
 string Regex::Match::format(const std::string &fmt) const {
   try {
+    if (pri->re.isSet()) {
+      const boost::regex &re = pri->re->getBoost();
+      const string &s = pri->subject;
+      auto flags = typeToMatchFlags(type);
+
+      if (pri->anchored) boost::regex_match(s, pri->m, re, flags);
+      else boost::regex_search(s, pri->m, re, flags);
+
+      pri->re.release();
+    }
+
     return pri->m.format(fmt, typeToFormatFlags(type));
 
   } catch (const boost::regex_error &e) {
@@ -91,46 +145,70 @@ string Regex::Match::format(const std::string &fmt) const {
 
 unsigned Regex::Match::position(unsigned i) const {
   if (size() <= i) THROW("Invalid match subgroup " << i);
-  return pri->m.position(i);
+  return pri->positions[i];
 }
 
 
 Regex::Regex(const string &pattern, type_t type) :
-  pri(new private_t(pattern)), type(type) {}
+  pri(compile(pattern, type)), type(type) {}
 
 
-string Regex::toString() const {return pri->re.str();}
+struct Regex::cache_t : public Mutex {
+  typedef pair<int, string> key_t;
+  typedef list<pair<key_t, pri_t> > lru_t;
 
+  unsigned size = 256;
+  lru_t lru;
+  map<key_t, lru_t::iterator> index;
 
-bool Regex::match(const string &s) const {
-  try {
-    return boost::regex_match(s, pri->re);
-
-  } catch (const boost::regex_error &e) {
-    THROW("Match error: " << e.what());
+  void trim() {
+    while (size < lru.size()) {
+      index.erase(lru.back().first);
+      lru.pop_back();
+    }
   }
+};
+
+
+Regex::cache_t &Regex::getCache() {
+  static cache_t cache;
+  return cache;
 }
 
 
-bool Regex::match(const string &s, Match &m) const {
+void Regex::setCacheSize(unsigned size) {
+  cache_t &cache = getCache();
+  SmartLock lock(&cache);
+  cache.size = size;
+  cache.trim();
+}
+
+
+string Regex::toString() const {return pri->pattern;}
+
+
+bool Regex::match(const string &s) const {
+  if (pri->re2.isSet()) return RE2::FullMatch(s, *pri->re2);
+
   try {
-    if (!boost::regex_match(s, m.pri->m, pri->re, typeToMatchFlags(type)))
-      return false;
+    return boost::regex_match(s, pri->getBoost());
 
   } catch (const boost::regex_error &e) {
     THROW("Match error: " << e.what());
   }
+}
 
-  for (unsigned i = 0; i < m.pri->m.size(); i++)
-    m.push_back(string(m.pri->m[i].first, m.pri->m[i].second));
 
-  return true;
+bool Regex::match(const string &s, Match &m) const {
+  return find(s, m, true);
 }
 
 
 bool Regex::search(const string &s) const {
+  if (pri->re2.isSet()) return RE2::PartialMatch(s, *pri->re2);
+
   try {
-    return boost::regex_search(s, pri->re);
+    return boost::regex_search(s, pri->getBoost());
 
   } catch (const boost::regex_error &e) {
     THROW("Search error: " << e.what());
@@ -139,22 +217,89 @@ bool Regex::search(const string &s) const {
 
 
 bool Regex::search(const string &s, Match &m) const {
+  return find(s, m, false);
+}
+
+
+string Regex::replace(const string &s, const string &r) const {
+  return boost::regex_replace(s, pri->getBoost(), r,
+                              typeToMatchFlags(type) | typeToFormatFlags(type));
+}
+
+
+Regex::pri_t Regex::compile(const string &pattern, type_t type) {
+  cache_t &cache = getCache();
+  cache_t::key_t key(type, pattern);
+
+  {
+    SmartLock lock(&cache);
+
+    auto it = cache.index.find(key);
+    if (it != cache.index.end()) {
+      cache.lru.splice(cache.lru.begin(), cache.lru, it->second);
+      return it->second->second;
+    }
+  }
+
+  // Compile without holding the lock
+  pri_t pri = new private_t(pattern, type);
+
+  SmartLock lock(&cache);
+  if (cache.index.find(key) == cache.index.end() && cache.size) {
+    cache.lru.push_front(make_pair(key, pri));
+    cache.index[key] = cache.lru.begin();
+    cache.trim();
+  }
+
+  return pri;
+}
+
+
+bool Regex::find(const string &s, Match &m, bool anchored) const {
+  m.clear();
+  m.pri->positions.clear();
+
+  if (pri->re2.isSet()) {
+    const RE2 &re2 = *pri->re2;
+    int n = re2.NumberOfCapturingGroups() + 1;
+    vector<re2::StringPiece> groups(n);
+
+    if (!re2.Match(s, 0, s.length(), anchored ? RE2::ANCHOR_BOTH :
+                   RE2::UNANCHORED, groups.data(), n))
+      return false;
+
+    for (int i = 0; i < n; i++) {
+      const re2::StringPiece &g = groups[i];
+      m.push_back(g.data() ? string(g.data(), g.size()) : string());
+      m.pri->positions.push_back(g.data() ? g.data() - s.data() : -1);
+    }
+
+    m.pri->re = pri;
+    m.pri->subject = s;
+    m.pri->anchored = anchored;
+
+    return true;
+  }
+
+  boost::smatch &bm = m.pri->m;
+  m.pri->re.release();
+
   try {
-    if (!boost::regex_search(s, m.pri->m, pri->re, typeToMatchFlags(type)))
+    const boost::regex &re = pri->getBoost();
+    auto flags = typeToMatchFlags(type);
+
+    if (anchored ? !boost::regex_match(s, bm, re, flags) :
+        !boost::regex_search(s, bm, re, flags))
       return false;
 
   } catch (const boost::regex_error &e) {
-    THROW("Search error: " << e.what());
+    THROW((anchored ? "Match" : "Search") << " error: " << e.what());
   }
 
-  for (unsigned i = 0; i < m.pri->m.size(); i++)
-    m.push_back(string(m.pri->m[i].first, m.pri->m[i].second));
+  for (unsigned i = 0; i < bm.size(); i++) {
+    m.push_back(string(bm[i].first, bm[i].second));
+    m.pri->positions.push_back(bm.position(i));
+  }
 
   return true;
 }
-
-
-string Regex::replace(const string &s, const string &r) const {
-  return boost::regex_replace(s, pri->re, r,
-                              typeToMatchFlags(type) | typeToFormatFlags(type));
-}
@@ -39,9 +39,25 @@
 
 
 namespace cb {
+  /**
+   * Patterns use Perl syntax.  TYPE_POSIX and TYPE_PERL patterns are run
+   * with RE2, which matches in linear time, unless they use features RE2
+   * does not support, such as backreferences or lookaround.  Those and
+   * TYPE_BOOST patterns are run with Boost.Regex.  TYPE_POSIX selects the
+   * leftmost longest match, though where a pattern is ambiguous RE2 may
+   * assign subgroups differently than POSIX rules.  replace() and
+   * Match::format() always use Boost.Regex so that format strings are
+   * interpreted as before.
+   *
+   * Compiled patterns are shared through a process wide LRU cache keyed
+   * by pattern and type, so constructing a Regex for a recently used
+   * pattern does not compile it again.
+   */
   class Regex {
     struct private_t;
-    SmartPointer<private_t> pri;
+    struct cache_t;
+    typedef SmartPointer<private_t>::Protected pri_t;
+    pri_t pri;
 
   public:
     typedef enum {
@@ -71,6 +87,9 @@ namespace cb {
 
     Regex(const std::string &pattern, type_t type = TYPE_POSIX);
 
+    /// Set the maximum number of compiled patterns kept, default 256
+    static void setCacheSize(unsigned size);
+
     std::string toString() const;
 
     bool match(const std::string &s) const;
@@ -80,5 +99,10 @@ namespace cb {
     bool search(const std::string &s, Match &m) const;
 
     std::string replace(const std::string &s, const std::string &r) const;
+
+  protected:
+    static cache_t &getCache();
+    static pri_t compile(const std::string &pattern, type_t type);
+    bool find(const std::string &s, Match &m, bool anchored) const;
   };
 }
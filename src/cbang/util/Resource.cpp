@@ -45,6 +45,13 @@ const Resource &Resource::get(const string &path) const {
 }
 
 
+const Resource *FileResource::getEncoded(const string &coding) const {
+  if (coding == "gzip") return gzip;
+  if (coding == "br") return brotli;
+  return 0;
+}
+
+
 const Resource *DirectoryResource::find(const string &path) const {
   if (path.empty()) return 0;
   if (path[0] == '/') return find(path.substr(1));
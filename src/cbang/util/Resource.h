@@ -62,6 +62,11 @@ namespace cb {
     {CBANG_THROW(__func__ << "() not supported by resource");}
     virtual std::string toString() const
     {CBANG_THROW(__func__ << "() not supported by resource");}
+    /// A quoted strong entity tag or null if there is none.
+    virtual const char *getETag() const {return 0;}
+    /// Precompressed variant for a content @param coding or null.
+    virtual const Resource *getEncoded(const std::string &coding) const
+    {return 0;}
 
     const Resource &get(const std::string &path) const;
   };
@@ -71,13 +76,21 @@ namespace cb {
   public:
     const char *data;
     const unsigned length;
+    const char *etag;
+    const Resource *gzip;
+    const Resource *brotli;
 
-    FileResource(const char *name, const char *data, unsigned length) :
-      Resource(name), data(data), length(length) {}
+    FileResource(const char *name, const char *data, unsigned length,
+                 const char *etag = 0, const Resource *gzip = 0,
+                 const Resource *brotli = 0) :
+      Resource(name), data(data), length(length), etag(etag), gzip(gzip),
+      brotli(brotli) {}
 
     const char *getData() const {return data;}
     unsigned getLength() const {return length;}
     std::string toString() const {return std::string(data, length);}
+    const char *getETag() const {return etag;}
+    const Resource *getEncoded(const std::string &coding) const;
   };
 
 
@@ -0,0 +1,176 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "ResourceBundle.h"
+
+#include <cbang/Exception.h>
+#include <cbang/net/Swab.h>
+
+#include <cstring>
+
+using namespace std;
+using namespace cb;
+
+
+namespace {
+  const unsigned headerSize = 16;
+  const unsigned entrySize = 56;
+
+  enum {
+    ENTRY_DIRECTORY = 1 << 0,
+  };
+
+
+  uint32_t read32(const char *p) {
+    uint32_t x;
+    memcpy(&x, p, 4);
+    return hton32(x);
+  }
+
+
+  uint64_t read64(const char *p) {
+    uint64_t x;
+    memcpy(&x, p, 8);
+    return hton64(x);
+  }
+}
+
+
+struct ResourceBundle::Entry {
+  uint64_t name;
+  uint64_t data;
+  uint64_t length;
+  uint64_t etag;
+  uint32_t flags;
+  uint32_t first;
+  uint32_t count;
+  uint32_t gzip;
+  uint32_t brotli;
+};
+
+
+ResourceBundle::ResourceBundle(const string &path) : file(path) {
+  const char *data = file.getData();
+
+  if (file.getLength() < headerSize || memcmp(data, "CBRB", 4))
+    THROW("'" << path << "' is not a resource bundle");
+
+  if (read32(data + 4) != version)
+    THROW("Unsupported resource bundle version " << read32(data + 4)
+          << " in '" << path << "'");
+
+  uint32_t count = read32(data + 8);
+  if (!count || (file.getLength() - headerSize) / entrySize < count)
+    THROW("Resource bundle '" << path << "' is truncated");
+
+  resources.resize(count);
+  children.reserve(count);
+  root = build(0, count);
+}
+
+
+ResourceBundle::Entry ResourceBundle::readEntry(uint32_t index) const {
+  const char *p = file.getData() + headerSize + (uint64_t)index * entrySize;
+  Entry e;
+
+  e.name   = read64(p);
+  e.data   = read64(p + 8);
+  e.length = read64(p + 16);
+  e.etag   = read64(p + 24);
+  e.flags  = read32(p + 32);
+  e.first  = read32(p + 36);
+  e.count  = read32(p + 40);
+  e.gzip   = read32(p + 44);
+  e.brotli = read32(p + 48);
+
+  return e;
+}
+
+
+const char *ResourceBundle::getString(uint64_t offset) const {
+  uint64_t length = file.getLength();
+  const char *s = file.getData() + offset;
+
+  if (length <= offset || !memchr(s, 0, length - offset))
+    THROW("Invalid string in resource bundle '" << getPath() << "'");
+
+  return s;
+}
+
+
+const Resource *ResourceBundle::build(uint32_t index, uint32_t count) {
+  if (resources[index].isSet()) return resources[index].get();
+
+  Entry e = readEntry(index);
+  const char *name = getString(e.name);
+
+  // References must be to later entries, which rules out cycles
+  auto check = [&] (uint32_t ref) {
+    if (ref && (ref <= index || count <= ref))
+      THROW("Invalid entry " << ref << " in resource bundle '" << getPath()
+            << "'");
+  };
+
+  if (e.flags & ENTRY_DIRECTORY) {
+    check(e.first);
+    if (e.count && count - e.first < e.count)
+      THROW("Invalid directory in resource bundle '" << getPath() << "'");
+
+    children.push_back(vector<const Resource *>());
+    vector<const Resource *> &list = children.back();
+
+    for (uint32_t i = 0; i < e.count; i++)
+      list.push_back(build(e.first + i, count));
+    list.push_back(0);
+
+    resources[index] = new DirectoryResource(name, &list[0]);
+
+  } else {
+    if (file.getLength() < e.data || file.getLength() - e.data < e.length ||
+        (uint32_t)e.length != e.length)
+      THROW("Invalid data in resource bundle '" << getPath() << "'");
+
+    check(e.gzip);
+    check(e.brotli);
+
+    const char *etag = e.etag ? getString(e.etag) : 0;
+    const Resource *gzip = e.gzip ? build(e.gzip, count) : 0;
+    const Resource *brotli = e.brotli ? build(e.brotli, count) : 0;
+
+    resources[index] =
+      new FileResource(name, file.getData() + e.data, e.length, etag, gzip,
+                       brotli);
+  }
+
+  return resources[index].get();
+}
@@ -0,0 +1,80 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "Resource.h"
+
+#include <cbang/SmartPointer.h>
+#include <cbang/io/MappedFile.h>
+#include <cbang/util/NonCopyable.h>
+
+#include <vector>
+
+
+namespace cb {
+  /**
+   * A Resource tree read from a bundle file written by the ResourceBundle
+   * builder in config/resources.  The bundle is memory mapped so its pages
+   * are loaded on demand and shared by every process serving it.  Names,
+   * data, ETags and precompressed variants all point into the mapping, so
+   * the Resources are only valid for the lifetime of the bundle.
+   *
+   * All integers are stored in network byte order.  The file starts with
+   * the magic "CBRB", a version, an entry count and a reserved word.  Entry
+   * zero is the root.  A directory's children are consecutive entries and
+   * every reference is to a later entry.
+   */
+  class ResourceBundle : public NonCopyable {
+    MappedFile file;
+
+    std::vector<SmartPointer<Resource> > resources;
+    std::vector<std::vector<const Resource *> > children;
+    const Resource *root = 0;
+
+  public:
+    static const uint32_t version = 1;
+
+    ResourceBundle(const std::string &path);
+
+    const std::string &getPath() const {return file.getPath();}
+    const Resource &getRoot() const {return *root;}
+
+  protected:
+    struct Entry;
+
+    Entry readEntry(uint32_t index) const;
+    const char *getString(uint64_t offset) const;
+    const Resource *build(uint32_t index, uint32_t count);
+  };
+}
@@ -0,0 +1,99 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include <cbang/StdTypes.h>
+#include <cbang/util/NonCopyable.h>
+
+#include <new>
+
+
+namespace cb {
+  /// Assigns threads to shards, see Sharded
+  class Shards {
+  public:
+    static const unsigned COUNT = 16;
+    static const unsigned CACHE_LINE = 64;
+
+    /// @return The calling thread's shard
+    static unsigned get() {
+      static thread_local unsigned shard = assign();
+      return shard;
+    }
+
+  protected:
+    static unsigned assign();
+  };
+
+
+  /**
+   * A copy of @param T for each of Shards::COUNT shards, each on its own
+   * cache lines.  Threads are assigned shards round robin, so threads
+   * which update local() rarely share a cache line.  Readers visit every
+   * shard.
+   */
+  template <typename T>
+  class Sharded : public NonCopyable {
+    static const unsigned STRIDE =
+      (sizeof(T) + Shards::CACHE_LINE - 1) / Shards::CACHE_LINE *
+      Shards::CACHE_LINE;
+
+    char *mem;
+    char *base;
+
+  public:
+    Sharded() {
+      // Over allocate so the shards can be aligned to cache lines
+      mem = new char[Shards::COUNT * STRIDE + Shards::CACHE_LINE - 1];
+      uintptr_t addr = (uintptr_t)mem + Shards::CACHE_LINE - 1;
+      base = (char *)(addr - addr % Shards::CACHE_LINE);
+
+      for (unsigned i = 0; i < Shards::COUNT; i++) new (base + i * STRIDE) T();
+    }
+
+
+    ~Sharded() {
+      for (unsigned i = 0; i < Shards::COUNT; i++) at(i).~T();
+      delete [] mem;
+    }
+
+
+    static unsigned size() {return Shards::COUNT;}
+
+    T &at(unsigned i) {return *(T *)(base + i * STRIDE);}
+    const T &at(unsigned i) const {return *(const T *)(base + i * STRIDE);}
+
+    /// @return The calling thread's shard
+    T &local() {return at(Shards::get());}
+  };
+}
@@ -0,0 +1,83 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "Sharded.h"
+
+#include <cbang/StdTypes.h>
+
+#include <atomic>
+
+
+namespace cb {
+  /**
+   * A counter for statistics updated by many threads.  Each thread adds to
+   * its own cache line and get() sums the shards, so updates do not
+   * contend but reads cost Shards::COUNT loads.
+   */
+  class ShardedCounter {
+    Sharded<std::atomic<uint64_t> > shards;
+
+  public:
+    ShardedCounter(uint64_t value = 0) {reset(value);}
+
+    void add(uint64_t x = 1)
+    {shards.local().fetch_add(x, std::memory_order_relaxed);}
+    void sub(uint64_t x = 1)
+    {shards.local().fetch_sub(x, std::memory_order_relaxed);}
+
+    ShardedCounter &operator++() {add(); return *this;}
+    void operator++(int) {add();}
+    ShardedCounter &operator--() {sub(); return *this;}
+    void operator--(int) {sub();}
+    ShardedCounter &operator+=(uint64_t x) {add(x); return *this;}
+    ShardedCounter &operator-=(uint64_t x) {sub(x); return *this;}
+
+
+    uint64_t get() const {
+      uint64_t total = 0;
+      for (unsigned i = 0; i < shards.size(); i++)
+        total += shards.at(i).load(std::memory_order_relaxed);
+      return total;
+    }
+
+    operator uint64_t() const {return get();}
+
+
+    /// Not atomic with respect to concurrent updates
+    void reset(uint64_t value = 0) {
+      for (unsigned i = 0; i < shards.size(); i++)
+        shards.at(i).store(i ? 0 : value, std::memory_order_relaxed);
+    }
+  };
+}
@@ -32,18 +32,35 @@
 
 #include "Singleton.h"
 
+#include <cbang/os/SpinLock.h>
+
 using namespace cb;
 
 
+namespace {
+  // Different singletons may be created concurrently, e.g. by GPUDetector
+  SpinLock lock;
+}
+
+
 SingletonDealloc *SingletonDealloc::singleton = 0;
 
 
 SingletonDealloc &SingletonDealloc::instance() {
+  lock.lock();
   if (!singleton) singleton = new SingletonDealloc;
+  lock.unlock();
   return *singleton;
 }
 
 
+void SingletonDealloc::add(Base *singleton) {
+  lock.lock();
+  singletons.push_back(singleton);
+  lock.unlock();
+}
+
+
 void SingletonDealloc::deallocate() {
   singletons_t::reverse_iterator it;
   for (it = singletons.rbegin(); it != singletons.rend(); it++)
@@ -57,7 +57,7 @@ namespace cb {
 
     static SingletonDealloc &instance();
 
-    void add(Base *singleton) {singletons.push_back(singleton);}
+    void add(Base *singleton);
     void deallocate();
   };
 
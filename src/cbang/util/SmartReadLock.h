@@ -32,14 +32,15 @@
 
 #pragma once
 
-#include <cbang/os/RWLock.h>
+#include <cbang/util/RWLockable.h>
 
 namespace cb {
   class SmartReadLock {
-    const RWLock *lock;
+    const RWLockable *lock;
 
   public:
-    SmartReadLock(const RWLock *lock, bool alreadyLocked = false) : lock(lock) {
+    SmartReadLock(const RWLockable *lock, bool alreadyLocked = false) :
+      lock(lock) {
       if (!alreadyLocked) lock->readLock();
     }
     ~SmartReadLock() {lock->unlock();}
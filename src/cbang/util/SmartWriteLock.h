@@ -32,14 +32,14 @@
 
 #pragma once
 
-#include <cbang/os/RWLock.h>
+#include <cbang/util/RWLockable.h>
 
 namespace cb {
   class SmartWriteLock {
-    const RWLock *lock;
+    const RWLockable *lock;
 
   public:
-    SmartWriteLock(const RWLock *lock, bool alreadyLocked = false) :
+    SmartWriteLock(const RWLockable *lock, bool alreadyLocked = false) :
       lock(lock) {
       if (!alreadyLocked) lock->writeLock();
     }
@@ -0,0 +1,416 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include "XXH3.h"
+
+#include <cbang/os/CPUDispatch.h>
+
+#include <cstring>
+#include <algorithm>
+
+#ifdef CBANG_SIMD_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+using namespace cb;
+
+
+namespace {
+  const uint8_t secret[192] = {
+      0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c,
+      0xf7, 0x21, 0xad, 0x1c, 0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb,
+      0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f, 0xcb, 0x79, 0xe6, 0x4e,
+      0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+      0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6,
+      0x81, 0x3a, 0x26, 0x4c, 0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb,
+      0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3, 0x71, 0x64, 0x48, 0x97,
+      0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+      0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7,
+      0xc7, 0x0b, 0x4f, 0x1d, 0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31,
+      0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64, 0xea, 0xc5, 0xac, 0x83,
+      0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+      0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26,
+      0x29, 0xd4, 0x68, 0x9e, 0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc,
+      0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce, 0x45, 0xcb, 0x3a, 0x8f,
+      0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e
+  };
+
+  const unsigned STRIPE = 64;
+  const unsigned BLOCK_STRIPES = (sizeof(secret) - STRIPE) / 8;
+  const unsigned SECRET_LIMIT = sizeof(secret) - STRIPE;
+
+  const uint32_t PRIME32_1 = 0x9e3779b1;
+  const uint32_t PRIME32_2 = 0x85ebca77;
+  const uint32_t PRIME32_3 = 0xc2b2ae3d;
+  const uint64_t PRIME64_1 = 0x9e3779b185ebca87ULL;
+  const uint64_t PRIME64_2 = 0xc2b2ae3d27d4eb4fULL;
+  const uint64_t PRIME64_3 = 0x165667b19e3779f9ULL;
+  const uint64_t PRIME64_4 = 0x85ebca77c2b2ae63ULL;
+  const uint64_t PRIME64_5 = 0x27d4eb2f165667c5ULL;
+  const uint64_t PRIME_MX1 = 0x165667919e3779f9ULL;
+  const uint64_t PRIME_MX2 = 0x9fb21c651e98df25ULL;
+
+
+  // The hash is defined on little endian words
+  inline uint32_t read32(const uint8_t *p) {
+    return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+  }
+
+
+  inline uint64_t read64(const uint8_t *p) {
+    return read32(p) | (uint64_t)read32(p + 4) << 32;
+  }
+
+
+  inline uint64_t rotl64(uint64_t x, unsigned r) {
+    return (x << r) | (x >> (64 - r));
+  }
+
+
+  inline uint64_t swap64(uint64_t x) {return __builtin_bswap64(x);}
+
+
+  inline uint64_t mulFold64(uint64_t a, uint64_t b) {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 p = (unsigned __int128)a * b;
+    return (uint64_t)p ^ (uint64_t)(p >> 64);
+
+#else
+    uint64_t loLo = (a & 0xffffffff) * (b & 0xffffffff);
+    uint64_t hiLo = (a >> 32) * (b & 0xffffffff);
+    uint64_t loHi = (a & 0xffffffff) * (b >> 32);
+    uint64_t hiHi = (a >> 32) * (b >> 32);
+    uint64_t cross = (loLo >> 32) + (hiLo & 0xffffffff) + loHi;
+    uint64_t hi = (hiLo >> 32) + (cross >> 32) + hiHi;
+    uint64_t lo = (cross << 32) | (loLo & 0xffffffff);
+    return lo ^ hi;
+#endif
+  }
+
+
+  uint64_t avalanche64(uint64_t h) {
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    return h ^ (h >> 32);
+  }
+
+
+  uint64_t avalanche(uint64_t h) {
+    h ^= h >> 37;
+    h *= PRIME_MX1;
+    return h ^ (h >> 32);
+  }
+
+
+  uint64_t rrmxmx(uint64_t h, uint64_t len) {
+    h ^= rotl64(h, 49) ^ rotl64(h, 24);
+    h *= PRIME_MX2;
+    h ^= (h >> 35) + len;
+    h *= PRIME_MX2;
+    return h ^ (h >> 28);
+  }
+
+
+  inline uint64_t mix16(const uint8_t *p, const uint8_t *s) {
+    return mulFold64(read64(p) ^ read64(s), read64(p + 8) ^ read64(s + 8));
+  }
+
+
+  uint64_t hash0To16(const uint8_t *p, size_t len) {
+    if (8 < len) {
+      uint64_t lo = read64(p) ^ (read64(secret + 24) ^ read64(secret + 32));
+      uint64_t hi =
+        read64(p + len - 8) ^ (read64(secret + 40) ^ read64(secret + 48));
+      return avalanche(len + swap64(lo) + hi + mulFold64(lo, hi));
+    }
+
+    if (4 <= len) {
+      uint64_t in = read32(p + len - 4) + ((uint64_t)read32(p) << 32);
+      return rrmxmx(in ^ (read64(secret + 8) ^ read64(secret + 16)), len);
+    }
+
+    if (len) {
+      uint32_t combined = (uint32_t)p[0] << 16 | (uint32_t)p[len >> 1] << 24 |
+        p[len - 1] | (uint32_t)len << 8;
+      return avalanche64(combined ^ (read32(secret) ^ read32(secret + 4)));
+    }
+
+    return avalanche64(read64(secret + 56) ^ read64(secret + 64));
+  }
+
+
+  uint64_t hash17To128(const uint8_t *p, size_t len) {
+    uint64_t acc = len * PRIME64_1;
+
+    if (32 < len) {
+      if (64 < len) {
+        if (96 < len) {
+          acc += mix16(p + 48, secret + 96);
+          acc += mix16(p + len - 64, secret + 112);
+        }
+
+        acc += mix16(p + 32, secret + 64);
+        acc += mix16(p + len - 48, secret + 80);
+      }
+
+      acc += mix16(p + 16, secret + 32);
+      acc += mix16(p + len - 32, secret + 48);
+    }
+
+    acc += mix16(p, secret);
+    acc += mix16(p + len - 16, secret + 16);
+
+    return avalanche(acc);
+  }
+
+
+  uint64_t hash129To240(const uint8_t *p, size_t len) {
+    uint64_t acc = len * PRIME64_1;
+    unsigned rounds = len / 16;
+
+    for (unsigned i = 0; i < 8; i++) acc += mix16(p + 16 * i, secret + 16 * i);
+    acc = avalanche(acc);
+
+    uint64_t end = mix16(p + len - 16, secret + 136 - 17);
+    for (unsigned i = 8; i < rounds; i++)
+      end += mix16(p + 16 * i, secret + 16 * (i - 8) + 3);
+
+    return avalanche(acc + end);
+  }
+
+
+  uint64_t hashShort(const uint8_t *p, size_t len) {
+    if (len <= 16) return hash0To16(p, len);
+    if (len <= 128) return hash17To128(p, len);
+    return hash129To240(p, len);
+  }
+
+
+  typedef void (*accumulate_t)(uint64_t *, const uint8_t *, const uint8_t *,
+                               size_t);
+
+
+  inline void accumulate512(uint64_t *acc, const uint8_t *p,
+                            const uint8_t *s) {
+    for (unsigned i = 0; i < 8; i++) {
+      uint64_t data = read64(p + 8 * i);
+      uint64_t key = data ^ read64(s + 8 * i);
+      acc[i ^ 1] += data;
+      acc[i] += (key & 0xffffffff) * (key >> 32);
+    }
+  }
+
+
+  void accumulateNone(uint64_t *acc, const uint8_t *p, const uint8_t *s,
+                      size_t stripes) {
+    for (size_t i = 0; i < stripes; i++)
+      accumulate512(acc, p + i * STRIPE, s + i * 8);
+  }
+
+
+#ifdef CBANG_SIMD_X86
+  CBANG_TARGET_AVX2
+  void accumulateAVX2(uint64_t *acc, const uint8_t *p, const uint8_t *s,
+                      size_t stripes) {
+    __m256i a0 = _mm256_loadu_si256((const __m256i *)acc);
+    __m256i a1 = _mm256_loadu_si256((const __m256i *)(acc + 4));
+
+    for (size_t i = 0; i < stripes; i++, p += STRIPE, s += 8) {
+      __m256i d0 = _mm256_loadu_si256((const __m256i *)p);
+      __m256i d1 = _mm256_loadu_si256((const __m256i *)(p + 32));
+      __m256i k0 = _mm256_xor_si256(
+        d0, _mm256_loadu_si256((const __m256i *)s));
+      __m256i k1 = _mm256_xor_si256(
+        d1, _mm256_loadu_si256((const __m256i *)(s + 32)));
+
+      // Low times high half of each key word
+      __m256i p0 = _mm256_mul_epu32(k0, _mm256_srli_epi64(k0, 32));
+      __m256i p1 = _mm256_mul_epu32(k1, _mm256_srli_epi64(k1, 32));
+
+      // Each data word is added to its neighbour's accumulator
+      a0 = _mm256_add_epi64(a0, _mm256_shuffle_epi32(d0, 0x4e));
+      a1 = _mm256_add_epi64(a1, _mm256_shuffle_epi32(d1, 0x4e));
+      a0 = _mm256_add_epi64(a0, p0);
+      a1 = _mm256_add_epi64(a1, p1);
+    }
+
+    _mm256_storeu_si256((__m256i *)acc, a0);
+    _mm256_storeu_si256((__m256i *)(acc + 4), a1);
+  }
+
+
+  const CPUDispatch::Function<accumulate_t>
+  accumulateFn(accumulateNone, 0, accumulateAVX2);
+
+#else // CBANG_SIMD_X86
+  const CPUDispatch::Function<accumulate_t> accumulateFn(accumulateNone);
+#endif // CBANG_SIMD_X86
+
+
+  void scramble(uint64_t *acc) {
+    const uint8_t *s = secret + SECRET_LIMIT;
+
+    for (unsigned i = 0; i < 8; i++) {
+      uint64_t a = acc[i];
+      a ^= a >> 47;
+      a ^= read64(s + 8 * i);
+      acc[i] = a * PRIME32_1;
+    }
+  }
+
+
+  /// Accumulate @param n stripes, @param count of the block are done
+  const uint8_t *consume(uint64_t *acc, unsigned &count, const uint8_t *p,
+                         size_t n) {
+    accumulate_t fn = accumulateFn;
+
+    while (BLOCK_STRIPES - count <= n) {
+      size_t todo = BLOCK_STRIPES - count;
+      fn(acc, p, secret + count * 8, todo);
+      scramble(acc);
+      p += todo * STRIPE;
+      n -= todo;
+      count = 0;
+    }
+
+    if (n) {
+      fn(acc, p, secret + count * 8, n);
+      p += n * STRIPE;
+      count += n;
+    }
+
+    return p;
+  }
+
+
+  uint64_t merge(const uint64_t *acc, uint64_t len) {
+    uint64_t result = len * PRIME64_1;
+    const uint8_t *s = secret + 11;
+
+    for (unsigned i = 0; i < 4; i++)
+      result += mulFold64(acc[2 * i] ^ read64(s + 16 * i),
+                          acc[2 * i + 1] ^ read64(s + 16 * i + 8));
+
+    return avalanche(result);
+  }
+
+
+  const uint64_t initAcc[8] = {
+    PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3,
+    PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1,
+  };
+}
+
+
+void XXH3::reset() {
+  memcpy(acc, initAcc, sizeof(acc));
+  buffered = stripes = 0;
+  total = 0;
+}
+
+
+void XXH3::update(const void *data, size_t length) {
+  const uint8_t *p = (const uint8_t *)data;
+  const uint8_t *end = p + length;
+  total += length;
+
+  if (buffered + length <= sizeof(buffer)) {
+    memcpy(buffer + buffered, p, length);
+    buffered += length;
+    return;
+  }
+
+  // Only whole stripes are consumed before the input is known to go on, so
+  // that the last stripe is left for get()
+  if (buffered) {
+    unsigned fill = sizeof(buffer) - buffered;
+    memcpy(buffer + buffered, p, fill);
+    p += fill;
+    consume(acc, stripes, buffer, sizeof(buffer) / STRIPE);
+    buffered = 0;
+  }
+
+  if (sizeof(buffer) < (size_t)(end - p)) {
+    p = consume(acc, stripes, p, (end - p - 1) / STRIPE);
+    // Keep the last consumed stripe in case less than a stripe remains
+    memcpy(buffer + sizeof(buffer) - STRIPE, p - STRIPE, STRIPE);
+  }
+
+  memcpy(buffer, p, end - p);
+  buffered = end - p;
+}
+
+
+uint64_t XXH3::get() const {
+  if (total <= 240) return hashShort(buffer, total);
+
+  uint64_t acc[8];
+  memcpy(acc, this->acc, sizeof(acc));
+  const uint8_t *last;
+  uint8_t lastStripe[STRIPE];
+
+  if (STRIPE <= buffered) {
+    unsigned count = stripes;
+    consume(acc, count, buffer, (buffered - 1) / STRIPE);
+    last = buffer + buffered - STRIPE;
+
+  } else {
+    // The last stripe starts in the previously consumed data
+    unsigned catchup = STRIPE - buffered;
+    memcpy(lastStripe, buffer + sizeof(buffer) - catchup, catchup);
+    memcpy(lastStripe + catchup, buffer, buffered);
+    last = lastStripe;
+  }
+
+  accumulate512(acc, last, secret + SECRET_LIMIT - 7);
+
+  return merge(acc, total);
+}
+
+
+uint64_t XXH3::compute(const void *data, size_t length) {
+  const uint8_t *p = (const uint8_t *)data;
+  if (length <= 240) return hashShort(p, length);
+
+  uint64_t acc[8];
+  memcpy(acc, initAcc, sizeof(acc));
+
+  unsigned count = 0;
+  consume(acc, count, p, (length - 1) / STRIPE);
+  accumulate512(acc, p + length - STRIPE, secret + SECRET_LIMIT - 7);
+
+  return merge(acc, length);
+}
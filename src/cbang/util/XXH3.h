@@ -0,0 +1,62 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+
+namespace cb {
+  /**
+   * The 64-bit XXH3 hash with the default secret and no seed.  Values
+   * match the reference xxHash library's XXH3_64bits().  Long inputs are
+   * accumulated with AVX2 when available.
+   */
+  class XXH3 {
+    uint64_t acc[8];
+    uint8_t buffer[256];
+    unsigned buffered;
+    unsigned stripes;
+    uint64_t total;
+
+  public:
+    XXH3() {reset();}
+
+    void reset();
+    void update(const void *data, size_t length);
+    uint64_t get() const;
+
+    static uint64_t compute(const void *data, size_t length);
+  };
+}
@@ -0,0 +1,106 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include "XMLWriter.h"
+
+#include <cbang/Catch.h>
+#include <cbang/iostream/VectorDevice.h>
+
+#include <vector>
+#include <functional>
+
+namespace cb {
+  /**
+   * An XMLWriter which appends directly to a contiguous buffer.  With a
+   * chunk callback the buffer is handed off and cleared each time it
+   * reaches the chunk size, so large documents need not be held in
+   * memory whole.
+   */
+  class XMLBufferWriter : public XMLWriter {
+  public:
+    typedef std::function<void (const char *data, size_t size)> chunk_cb_t;
+
+  private:
+    std::vector<char> buffer;
+    VectorStream<char> stream;
+
+    size_t chunkSize = ~(size_t)0;
+    chunk_cb_t chunkCB;
+
+  public:
+    XMLBufferWriter(bool pretty = false) :
+      XMLWriter(stream, pretty), stream(buffer) {}
+    ~XMLBufferWriter() {TRY_CATCH_ERROR(flush());}
+
+#ifdef _WIN32
+    const char *data() const {return &buffer[0];}
+#else
+    const char *data() const {return buffer.data();}
+#endif
+
+    size_t size() const {return buffer.size();}
+    std::string toString() const {return std::string(data(), size());}
+    void clear() {buffer.clear();}
+
+    /// Call @param cb with every @param chunkSize bytes written
+    void setChunkCallback(size_t chunkSize, const chunk_cb_t &cb) {
+      this->chunkSize = chunkSize;
+      chunkCB = cb;
+    }
+
+    /// Pass any pending output to the chunk callback, if set.  Also
+    /// called on destruction.
+    void flush() {
+      if (chunkCB && !buffer.empty()) {
+        chunkCB(data(), size());
+        buffer.clear();
+      }
+    }
+
+  protected:
+    // From XMLWriter, append directly rather than through the stream
+    void put(char c) {
+      buffer.push_back(c);
+      if (chunkSize <= buffer.size()) flush();
+    }
+
+    void put(const char *s, size_t n) {
+      buffer.insert(buffer.end(), s, s + n);
+      if (chunkSize <= buffer.size()) flush();
+    }
+
+    using XMLWriter::put;
+  };
+}
@@ -40,7 +40,10 @@
 
 namespace cb {
   class XMLFileTracker : public XMLHandler {
+  public:
     typedef std::set<std::string> files_t;
+
+  protected:
     files_t files;
     typedef std::vector<files_t::const_iterator> stack_t;
     stack_t stack;
@@ -48,6 +51,8 @@ namespace cb {
   public:
     bool hasFile() const {return !stack.empty();}
     const std::string &getCurrentFile();
+    /// Every file read so far, e.g. for Event::FileWatcher
+    const files_t &getFiles() const {return files;}
 
     // From XMLHandler
     void pushFile(const std::string &filename);
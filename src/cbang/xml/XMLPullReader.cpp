@@ -0,0 +1,374 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include "XMLPullReader.h"
+
+#include <cbang/Exception.h>
+#include <cbang/String.h>
+#include <cbang/os/SystemUtilities.h>
+
+#include <expat.h>
+
+#include <algorithm>
+
+using namespace std;
+using namespace cb;
+
+static const int BUFFER_SIZE = 64 * 1024;
+
+
+struct XMLPullReader::Frame {
+  XMLPullReader &reader;
+  InputSource source;
+  XML_Parser parser;
+  bool skipRoot;
+  unsigned depth = 0;
+  unsigned skipDepth = 0;
+  streamsize offset = 0;
+  bool final = false;
+
+  // Names and values for the events of one chunk of input.  The vectors
+  // are cleared but keep their capacity between chunks.
+  struct Attr {
+    const string *name;
+    unsigned offset;
+    unsigned length;
+  };
+
+  struct Event {
+    event_t type;
+    const string *name;
+    unsigned attrBegin;
+    unsigned attrEnd;
+    unsigned offset;
+    unsigned length;
+    int line;
+    int column;
+  };
+
+  vector<Event> events;
+  unsigned index = 0;
+  vector<Attr> attrs;
+  vector<char> values;
+  vector<const string *> stack;
+
+
+  Frame(XMLPullReader &reader, const InputSource &source, bool skipRoot) :
+    reader(reader), source(source), parser(XML_ParserCreate("UTF-8")),
+    skipRoot(skipRoot) {
+    if (!parser) THROW("Failed to create XML parser");
+
+    XML_SetElementHandler(parser, &Frame::start, &Frame::end);
+    XML_SetCharacterDataHandler(parser, &Frame::text);
+    XML_SetUserData(parser, this);
+  }
+
+
+  ~Frame() {XML_ParserFree(parser);}
+
+
+  const Event &get() const {return events[index];}
+
+
+  View getValue(unsigned offset, unsigned length) const {
+    return View(values.data() + offset, length);
+  }
+
+
+  bool next() {
+    if (index + 1 < events.size()) {index++; return true;}
+
+    events.clear();
+    attrs.clear();
+    values.clear();
+    index = 0;
+
+    while (events.empty()) {
+      if (final) return false;
+      parse();
+    }
+
+    return true;
+  }
+
+
+  void parse() {
+    XML_Status status;
+    const char *data = source.getData();
+
+    if (data) {
+      // Mapped or in memory input is handed to expat without a stream
+      streamsize length = source.getLength();
+      streamsize count = min((streamsize)BUFFER_SIZE, length - offset);
+      final = offset + count == length;
+      status = XML_Parse(parser, data + offset, count, final);
+      offset += count;
+
+    } else {
+      void *buf = XML_GetBuffer(parser, BUFFER_SIZE);
+      if (!buf) THROW("Failed to allocate XML parser buffer");
+
+      source.getStream().read((char *)buf, BUFFER_SIZE);
+      streamsize count = source.getStream().gcount();
+      final = !count;
+      status = XML_ParseBuffer(parser, count, final);
+    }
+
+    if (status != XML_STATUS_OK) {
+      XML_Error code = XML_GetErrorCode(parser);
+      int line = XML_GetCurrentLineNumber(parser);
+      int column = XML_GetCurrentColumnNumber(parser);
+
+      throw Exception(string("Parse failed: ") + String(code) + ": " +
+                      XML_ErrorString(code),
+                      FileLocation(source.getName(), line, column));
+    }
+  }
+
+
+  unsigned store(const char *s, unsigned length) {
+    unsigned offset = values.size();
+    values.insert(values.end(), s, s + length);
+    return offset;
+  }
+
+
+  void add(event_t type, const string *name, unsigned offset = 0,
+           unsigned length = 0) {
+    unsigned count = attrs.size();
+    int line = XML_GetCurrentLineNumber(parser);
+    int column = XML_GetCurrentColumnNumber(parser);
+
+    events.push_back
+      ({type, name, count, count, offset, length, line, column});
+  }
+
+
+  static void start(void *data, const char *name, const char **atts) {
+    Frame &f = *(Frame *)data;
+
+    const string &interned = f.reader.intern(name, strlen(name));
+    f.stack.push_back(&interned);
+    f.add(START_ELEMENT, &interned);
+
+    for (unsigned i = 0; atts[i]; i += 2) {
+      unsigned length = strlen(atts[i + 1]);
+      unsigned offset = f.store(atts[i + 1], length);
+      f.attrs.push_back
+        ({&f.reader.intern(atts[i], strlen(atts[i])), offset, length});
+    }
+
+    f.events.back().attrEnd = f.attrs.size();
+  }
+
+
+  static void end(void *data, const char *name) {
+    Frame &f = *(Frame *)data;
+
+    f.add(END_ELEMENT, f.stack.back());
+    f.stack.pop_back();
+  }
+
+
+  static void text(void *data, const char *s, int length) {
+    Frame &f = *(Frame *)data;
+
+    // Expat may pass text from temporary storage so it is always copied.
+    // Consecutive chunks are merged.
+    if (!f.events.empty() && f.events.back().type == TEXT) {
+      f.store(s, length);
+      f.events.back().length += length;
+
+    } else f.add(TEXT, 0, f.store(s, length), length);
+  }
+};
+
+
+XMLPullReader::XMLPullReader(const InputSource &source, bool xinclude) :
+  xinclude(xinclude), depth(0), event(END_DOCUMENT), current(0) {
+  push(source, false);
+}
+
+
+XMLPullReader::~XMLPullReader() {}
+
+
+XMLPullReader::event_t XMLPullReader::next() {
+  if (event == END_ELEMENT) depth--;
+  current = 0;
+
+  while (!frames.empty()) {
+    Frame &f = *frames.back();
+    if (!f.next()) {frames.pop_back(); continue;}
+
+    const Frame::Event &e = f.get();
+
+    // Skip the contents of an <include>
+    if (f.skipDepth) {
+      if (e.type == START_ELEMENT) f.skipDepth++;
+      else if (e.type == END_ELEMENT) f.skipDepth--;
+      continue;
+    }
+
+    unsigned level = f.depth;
+    if (e.type == START_ELEMENT) level = ++f.depth;
+    else if (e.type == END_ELEMENT) f.depth--;
+
+    // Skip the root element of an <include children="true">
+    if (f.skipRoot && (e.type == TEXT ? !level : level == 1)) continue;
+
+    current = &f;
+
+    if (xinclude && e.type == START_ELEMENT && *e.name == "include") {
+      View file = getAttribute("file");
+      if (file.empty()) THROW("Empty 'file' attribute");
+
+      string path =
+        SystemUtilities::absolute(f.source.getName(), file.toString());
+      bool children = getAttribute("children") == "true";
+
+      f.depth--;
+      f.skipDepth = 1;
+      current = 0;
+
+      push(InputSource(path), children);
+      continue;
+    }
+
+    if (e.type == START_ELEMENT) depth++;
+    return event = e.type;
+  }
+
+  return event = END_DOCUMENT;
+}
+
+
+void XMLPullReader::skip() {
+  if (event != START_ELEMENT) THROW("Not at the start of an element");
+
+  unsigned target = depth;
+
+  while (next() != END_DOCUMENT)
+    if (event == END_ELEMENT && depth == target) return;
+}
+
+
+const string &XMLPullReader::getName() const {
+  const Frame::Event &e = get().get();
+  if (!e.name) THROW("Event does not have a name");
+  return *e.name;
+}
+
+
+XMLPullReader::View XMLPullReader::getText() const {
+  const Frame::Event &e = get().get();
+  if (e.type != TEXT) THROW("Not a text event");
+  return get().getValue(e.offset, e.length);
+}
+
+
+unsigned XMLPullReader::getAttributeCount() const {
+  const Frame::Event &e = get().get();
+  return e.attrEnd - e.attrBegin;
+}
+
+
+const string &XMLPullReader::getAttributeName(unsigned i) const {
+  if (getAttributeCount() <= i) THROW("Invalid attribute index " << i);
+  return *get().attrs[get().get().attrBegin + i].name;
+}
+
+
+XMLPullReader::View XMLPullReader::getAttributeValue(unsigned i) const {
+  if (getAttributeCount() <= i) THROW("Invalid attribute index " << i);
+  const Frame::Attr &attr = get().attrs[get().get().attrBegin + i];
+  return get().getValue(attr.offset, attr.length);
+}
+
+
+bool XMLPullReader::hasAttribute(const string &name) const {
+  for (unsigned i = 0; i < getAttributeCount(); i++)
+    if (getAttributeName(i) == name) return true;
+
+  return false;
+}
+
+
+XMLPullReader::View XMLPullReader::getAttribute(const string &name) const {
+  for (unsigned i = 0; i < getAttributeCount(); i++)
+    if (getAttributeName(i) == name) return getAttributeValue(i);
+
+  return View();
+}
+
+
+XMLAttributes XMLPullReader::getAttributes() const {
+  XMLAttributes attrs;
+
+  for (unsigned i = 0; i < getAttributeCount(); i++)
+    attrs[getAttributeName(i)] = getAttributeValue(i).toString();
+
+  return attrs;
+}
+
+
+const string &XMLPullReader::getFilename() const {
+  return get().source.getName();
+}
+
+
+FileLocation XMLPullReader::getLocation() const {
+  const Frame::Event &e = get().get();
+  return FileLocation(getFilename(), e.line, e.column);
+}
+
+
+const string &XMLPullReader::intern(const char *name, unsigned length) {
+  // Reusing the key avoids an allocation once its capacity is reached
+  key.assign(name, length);
+
+  auto it = names.find(key);
+  if (it == names.end()) it = names.insert(key).first;
+
+  return *it;
+}
+
+
+void XMLPullReader::push(const InputSource &source, bool skipRoot) {
+  frames.push_back(new Frame(*this, source, skipRoot));
+}
+
+
+const XMLPullReader::Frame &XMLPullReader::get() const {
+  if (!current) THROW("No current XML event");
+  return *current;
+}
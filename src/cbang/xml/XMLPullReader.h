@@ -0,0 +1,134 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#pragma once
+
+#include "XMLAttributes.h"
+
+#include <cbang/SmartPointer.h>
+#include <cbang/FileLocation.h>
+#include <cbang/io/InputSource.h>
+
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <cstring>
+
+
+namespace cb {
+  /**
+   * A pull parser built on expat.  Events are read one at a time with
+   * next().  Element and attribute names are interned, and attribute
+   * values and text are views which are valid until the next call to
+   * next().  Once warmed up no memory is allocated per element.
+   *
+   * Text may be split over several consecutive TEXT events.
+   *
+   * <include file="..." children="true"/> elements are replaced by the
+   * contents of the referenced file, as with XMLReader.
+   */
+  class XMLPullReader {
+  public:
+    typedef enum {
+      START_ELEMENT,
+      END_ELEMENT,
+      TEXT,
+      END_DOCUMENT,
+    } event_t;
+
+
+    struct View {
+      const char *data;
+      unsigned length;
+
+      View(const char *data = 0, unsigned length = 0) :
+        data(data), length(length) {}
+
+      bool empty() const {return !length;}
+      std::string toString() const {return std::string(data, length);}
+
+      bool operator==(const char *s) const
+      {return !strncmp(data, s, length) && !s[length];}
+      bool operator==(const std::string &s) const
+      {return s.length() == length && !memcmp(data, s.data(), length);}
+      bool operator!=(const char *s) const {return !(*this == s);}
+      bool operator!=(const std::string &s) const {return !(*this == s);}
+    };
+
+  protected:
+    struct Frame;
+    std::vector<SmartPointer<Frame> > frames;
+    std::unordered_set<std::string> names;
+    std::string key;
+
+    bool xinclude;
+    unsigned depth;
+    event_t event;
+    Frame *current;
+
+  public:
+    XMLPullReader(const InputSource &source, bool xinclude = true);
+    ~XMLPullReader();
+
+    event_t next();
+    event_t getEvent() const {return event;}
+    /// Skip to the END_ELEMENT matching the current START_ELEMENT
+    void skip();
+
+    /// The depth of the current element, the document root is at depth 1
+    unsigned getDepth() const {return depth;}
+
+    /// @return The interned element name, for START and END_ELEMENT
+    const std::string &getName() const;
+    /// @return The text, for TEXT
+    View getText() const;
+
+    unsigned getAttributeCount() const;
+    const std::string &getAttributeName(unsigned i) const;
+    View getAttributeValue(unsigned i) const;
+    bool hasAttribute(const std::string &name) const;
+    /// @return The attribute's value or an empty View if not set
+    View getAttribute(const std::string &name) const;
+    /// Copy the attributes, e.g. for use with an XMLHandler
+    XMLAttributes getAttributes() const;
+
+    const std::string &getFilename() const;
+    FileLocation getLocation() const;
+
+    /// Intern @param length bytes at @param name
+    const std::string &intern(const char *name, unsigned length);
+
+  protected:
+    void push(const InputSource &source, bool skipRoot);
+    const Frame &get() const;
+  };
+}
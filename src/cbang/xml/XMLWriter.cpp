@@ -30,16 +30,53 @@
 
 \******************************************************************************/
 
+
 #include "XMLWriter.h"
 
 #include <ctype.h>
+#include <string.h>
 
 using namespace std;
 using namespace cb;
 
 
+namespace {
+  /// Replacements by character, null for characters written as is
+  struct EscapeTable {
+    const char *text[256];
+    const char *attr[256];
+    uint8_t length[256];
+
+    EscapeTable() {
+      for (unsigned i = 0; i < 256; i++) text[i] = attr[i] = 0;
+
+      text['<'] = attr['<'] = "&lt;";
+      text['>'] = attr['>'] = "&gt;";
+      text['&'] = attr['&'] = "&amp;";
+      attr['"'] = "&quot;";
+      attr['\''] = "&apos;";
+      attr['\r'] = "";
+#ifdef _WIN32
+      attr['\n'] = "\r\n";
+#endif
+
+      for (unsigned i = 0; i < 256; i++)
+        length[i] = attr[i] ? strlen(attr[i]) : 0;
+    }
+  };
+
+
+  const EscapeTable &escapes() {
+    static EscapeTable table;
+    return table;
+  }
+}
+
+
 void XMLWriter::entityRef(const string &name) {
-  stream << '&' << name << ';';
+  put('&');
+  put(name);
+  put(';');
   startOfLine = false;
 }
 
@@ -52,14 +89,20 @@ void XMLWriter::startElement(const string &name, const std::string &attrs) {
 void XMLWriter::startElement(const string &name, const XMLAttributes &attrs) {
   startOfLine = false; // Always start element on a new line
 
-  if (!closed) stream << '>';
+  if (!closed) put('>');
   if (depth) wrap();
 
-  stream << '<' << escape(name);
+  put('<');
+  putEscaped(name);
 
   XMLAttributes::const_iterator it;
-  for (it = attrs.begin(); it != attrs.end(); it++)
-    stream << ' ' << escape(it->first) << "='" << escape(it->second) << '\'';
+  for (it = attrs.begin(); it != attrs.end(); it++) {
+    put(' ');
+    putEscaped(it->first);
+    put("='", 2);
+    putEscaped(it->second);
+    put('\'');
+  }
 
   closed = false;
   depth++;
@@ -70,12 +113,14 @@ void XMLWriter::endElement(const string &name) {
   depth--;
 
   if (!closed) {
-    stream << "/>";
+    put("/>", 2);
     closed = true;
 
   } else {
     wrap();
-    stream << "</" << escape(name) << '>';
+    put("</", 2);
+    putEscaped(name);
+    put('>');
   }
 
   startOfLine = false;
@@ -85,29 +130,24 @@ void XMLWriter::endElement(const string &name) {
 void XMLWriter::text(const string &text) {
   if (!text.length()) return;
 
-  string::const_iterator it = text.begin();
+  const char *s = text.data();
+  const char *end = s + text.length();
 
   if (!closed) {
-    stream << '>';
+    put('>');
     closed = true;
     startOfLine = false;
 
-    if (pretty) while (it != text.end() && isspace(*it)) it++;
+    if (pretty) while (s != end && isspace(*s)) s++;
     wrap();
   }
 
-  for (; it != text.end(); it++) {
-    if (dontEscapeText) stream << *it;
-    else
-      switch (*it) {
-      case '<': stream << "&lt;"; break;
-      case '>': stream << "&gt;"; break;
-      case '&': stream << "&amp;"; break;
-      default: stream << *it; break;
-      }
+  if (s == end) return;
 
-    startOfLine = *it == '\n' || *it == '\r';
-  }
+  if (dontEscapeText) put(s, end - s);
+  else putEscaped(s, end - s, false);
+
+  startOfLine = end[-1] == '\n' || end[-1] == '\r';
 
   // TODO wrap lines at 80 columns in pretty print mode?
 }
@@ -117,29 +157,31 @@ void XMLWriter::cdata(const string &data) {
   if (!data.length()) return;
 
   if (!closed) {
-    stream << '>';
+    put('>');
     closed = true;
     startOfLine = false;
   }
 
-  stream << "<![CDATA[" << data << "]]>";
+  put("<![CDATA[", 9);
+  put(data);
+  put("]]>", 3);
 }
 
 
 void XMLWriter::comment(const string &text) {
   startOfLine = false; // Always start comment on a new line
 
-  if (!closed) stream << '>';
+  if (!closed) put('>');
 
   wrap();
-  stream << "<!-- ";
+  put("<!-- ", 5);
 
   bool dash = false;
   for (string::const_iterator it = text.begin(); it != text.end(); it++) {
     if (*it == '-') {
       if (dash) {
         // Drop double dash
-        stream.put(' ');
+        put(' ');
         dash = false;
         continue;
       }
@@ -149,13 +191,13 @@ void XMLWriter::comment(const string &text) {
     switch (*it) {
     case '\r': break;
 #ifdef _WIN32
-    case '\n': stream.put('\r');
+    case '\n': put('\r');
 #endif
-    default: stream.put(*it);
+    default: put(*it);
     }
   }
 
-  stream << " -->";
+  put(" -->", 4);
   closed = true;
   startOfLine = false;
 }
@@ -164,7 +206,7 @@ void XMLWriter::comment(const string &text) {
 void XMLWriter::indent() {
   if (pretty) {
     for (unsigned i = 0; i < depth; i++)
-      stream << "  ";
+      put("  ", 2);
     startOfLine = false;
   }
 }
@@ -174,9 +216,9 @@ void XMLWriter::wrap() {
   if (pretty) {
     if (!startOfLine) {
 #ifdef _WIN32
-      stream << "\r\n";
+      put("\r\n", 2);
 #else
-      stream << '\n';
+      put('\n');
 #endif
     }
 
@@ -188,19 +230,12 @@ void XMLWriter::wrap() {
 const string XMLWriter::escape(const string &name) {
   string result;
 
-  for (string::const_iterator it = name.begin(); it != name.end(); it++)
-    switch (*it) {
-    case '<': result += "&lt;"; break;
-    case '>': result += "&gt;"; break;
-    case '&': result += "&amp;"; break;
-    case '"': result += "&quot;"; break;
-    case '\'': result += "&apos;"; break;
-    case '\r': break;
-#ifdef _WIN32
-    case '\n': result += "\r\n"; break;
-#endif
-    default: result += *it; break;
-    }
+  const char *const *table = escapes().attr;
+  for (string::const_iterator it = name.begin(); it != name.end(); it++) {
+    const char *rep = table[(uint8_t)*it];
+    if (rep) result += rep;
+    else result += *it;
+  }
 
   return result;
 }
@@ -212,3 +247,22 @@ void XMLWriter::simpleElement(const string &name, const string &content,
   text(content);
   endElement(name);
 }
+
+
+void XMLWriter::putEscaped(const char *s, size_t n, bool attr) {
+  const EscapeTable &escapeTable = escapes();
+  const char *const *table = attr ? escapeTable.attr : escapeTable.text;
+  const char *end = s + n;
+
+  // Write runs of plain characters at once
+  while (s < end) {
+    const char *run = s;
+    while (s < end && !table[(uint8_t)*s]) s++;
+    if (run < s) put(run, s - run);
+
+    if (s < end) {
+      uint8_t c = *s++;
+      put(table[c], escapeTable.length[c]);
+    }
+  }
+}
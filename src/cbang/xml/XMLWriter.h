@@ -75,5 +75,15 @@ namespace cb {
                        const XMLAttributes &attrs = XMLAttributes());
 
     static const std::string escape(const std::string &name);
+
+  protected:
+    virtual void put(char c) {stream.put(c);}
+    virtual void put(const char *s, size_t n) {stream.write(s, n);}
+    void put(const std::string &s) {put(s.data(), s.length());}
+
+    /// Escape text or, with @param attr, names and attribute values
+    void putEscaped(const std::string &s, bool attr = true)
+      {putEscaped(s.data(), s.length(), attr);}
+    void putEscaped(const char *s, size_t n, bool attr = true);
   };
 }
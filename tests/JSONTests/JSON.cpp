@@ -35,8 +35,19 @@
 #include <cbang/json/Value.h>
 #include <cbang/json/Reader.h>
 #include <cbang/json/YAMLReader.h>
+#include <cbang/json/BufferReader.h>
+#include <cbang/json/Builder.h>
+#include <cbang/json/CBORWriter.h>
+#include <cbang/json/CBORReader.h>
+#include <cbang/json/View.h>
+#include <cbang/json/RecordStream.h>
+#include <cbang/json/Schema.h>
+#include <cbang/json/SchemaValidator.h>
+#include <cbang/io/InputSource.h>
 
 #include <iostream>
+#include <iterator>
+#include <sstream>
 
 using namespace std;
 using namespace cb::JSON;
@@ -46,16 +57,107 @@ int main(int argc, char *argv[]) {
   try {
     ValuePtr data;
 
-    if (argc == 2 && string(argv[1]) == "--yaml") {
+    if (argc == 2 && (string(argv[1]) == "--yaml" ||
+                      string(argv[1]) == "--yaml-shared")) {
       YAMLReader reader(cin);
       YAMLReader::docs_t docs;
 
+      reader.setShareAnchors(string(argv[1]) == "--yaml-shared");
+
       reader.parse(docs);
       for (unsigned i = 0; i < docs.size(); i++) {
         if (i) cout << '\n';
         cout << *docs[i];
       }
 
+    } else if (argc == 2 && string(argv[1]) == "--arena") {
+      string s((istreambuf_iterator<char>(cin)), istreambuf_iterator<char>());
+      Builder builder(new Arena(1024));
+
+      BufferReader(s).parse(builder);
+      data = builder.getRoot();
+      if (!data.isNull()) cout << *data;
+
+    } else if (argc == 2 && string(argv[1]) == "--interned") {
+      Builder builder;
+      builder.setKeyPool(new KeyPool);
+
+      Reader(cin).parse(builder);
+      data = builder.getRoot();
+      if (!data.isNull()) cout << *data->copy(true);
+
+    } else if (argc == 2 && string(argv[1]) == "--number-lists") {
+      Builder builder;
+      builder.setNumberLists(true);
+
+      Reader(cin).parse(builder);
+      data = builder.getRoot();
+      if (!data.isNull()) cout << data->toString(0, true) << '\n'
+                                << *data->copy(true);
+
+    } else if (argc == 2 && string(argv[1]) == "--cbor") {
+      // Round trip through CBOR
+      ostringstream str;
+      CBORWriter writer(str);
+      Reader(cin).parse(writer);
+      writer.close();
+
+      data = CBORReader::parseString(str.str());
+      if (!data.isNull()) cout << *data;
+
+    } else if (2 < argc && string(argv[1]) == "--view") {
+      string s((istreambuf_iterator<char>(cin)), istreambuf_iterator<char>());
+      View view(s);
+
+      for (int i = 2; i < argc; i++) {
+        ValuePtr value = view.select(argv[i], ValuePtr());
+        cout << argv[i] << ": ";
+        if (value.isNull()) cout << "<missing>";
+        else cout << value->toString(0, true);
+        cout << '\n';
+      }
+
+    } else if (2 < argc && string(argv[1]) == "--select") {
+      data = Reader(cin).parse();
+
+      for (int i = 2; i < argc; i++) {
+        vector<ConstValuePtr> results = data->selectAll(argv[i]);
+        cout << argv[i] << ":";
+        if (results.empty()) cout << " <missing>";
+        for (unsigned j = 0; j < results.size(); j++)
+          cout << ' ' << results[j]->toString(0, true);
+        cout << '\n';
+      }
+
+    } else if (argc == 3 && string(argv[1]) == "--records") {
+      RecordStream stream(argv[2], [] (const ValuePtr &record) {
+          cout << record->toString(0, true) << '\n';
+        });
+
+      stream.read(cb::InputSource(cin));
+      cout << stream.getCount() << " records\n";
+
+    } else if (argc == 2 && string(argv[1]) == "--schema") {
+      // The first line is the schema, each following line a document
+      string line;
+      getline(cin, line);
+      Schema schema(*Reader::parseString(line));
+
+      while (getline(cin, line)) {
+        if (line.empty()) continue;
+
+        Builder builder;
+        SchemaValidator
+          validator(schema, cb::SmartPointer<Sink>::Phony(&builder));
+
+        try {
+          Reader::parseString(line, validator);
+          cout << "valid: " << builder.getRoot()->toString(0, true) << '\n';
+        } catch (const cb::Exception &e) {
+          cout << "invalid: " << e.getMessage() << '\n';
+        }
+      }
+
     } else {
       Reader reader(cin);
       data = reader.parse();
@@ -33,22 +33,62 @@
 #include <cbang/net/Base64.h>
 
 #include <cbang/Catch.h>
+#include <cbang/String.h>
 #include <cbang/os/SystemUtilities.h>
+#include <cbang/time/Timer.h>
 
 #include <iostream>
+#include <vector>
+#include <cstdlib>
 
 using namespace std;
 using namespace cb;
 
 
 int usage(const char *name) {
-  cerr << "Usage: " << name << " <-d | -e | -u | -U> [<string>]" << endl;
+  cerr << "Usage: " << name << " <-d | -e | -u | -U> [<string>]\n"
+       << "       " << name << " -b [<bytes>]" << endl;
   return 1;
 }
 
 
+// Not run by the harness, reports encode and decode throughput
+int benchmark(unsigned size) {
+  string data(size, 0);
+  for (unsigned i = 0; i < size; i++) data[i] = (char)rand();
+
+  Base64 codec;
+  vector<char> encoded(codec.getEncodedLength(size));
+  vector<char> decoded(codec.getMaxDecodedLength(encoded.size()));
+
+  const unsigned rounds = 100;
+  double start = Timer::now();
+  for (unsigned i = 0; i < rounds; i++)
+    codec.encode(data.data(), size, encoded.data());
+  double encodeTime = Timer::now() - start;
+
+  start = Timer::now();
+  unsigned length = 0;
+  for (unsigned i = 0; i < rounds; i++)
+    length = codec.decode(encoded.data(), encoded.size(), decoded.data());
+  double decodeTime = Timer::now() - start;
+
+  if (string(decoded.data(), length) != data) THROW("Round trip failed");
+
+  double mb = (double)size * rounds / (1 << 20);
+  cout << "encode " << String::printf("%.1f", mb / encodeTime) << " MiB/s\n"
+       << "decode " << String::printf("%.1f", mb / decodeTime) << " MiB/s"
+       << endl;
+
+  return 0;
+}
+
+
 int main(int argc, char *argv[]) {
   try {
+    if (1 < argc && string("-b") == argv[1])
+      return benchmark(argc == 3 ? String::parseU32(argv[2]) : 1 << 20);
+
     string input;
     if (argc == 2) input = SystemUtilities::read(cin);
     else if (argc == 3) input = argv[2];
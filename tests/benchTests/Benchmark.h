@@ -0,0 +1,277 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#pragma once
+
+#include <cbang/Exception.h>
+#include <cbang/String.h>
+#include <cbang/json/Reader.h>
+#include <cbang/json/Writer.h>
+#include <cbang/os/SystemUtilities.h>
+#include <cbang/time/Timer.h>
+
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <string>
+
+
+/**
+ * A small microbenchmark harness.  Each benchmark is a function which
+ * performs its operation @c count times.  The harness finds a batch size
+ * which runs for at least the sample time, warms up, then times a number
+ * of batches and reports nanoseconds per operation.  Results may be
+ * written as JSON and later compared against as a baseline.
+ */
+class BenchmarkSuite {
+public:
+  typedef std::function<void (unsigned count)> func_t;
+
+  struct Result {
+    std::string name;
+    unsigned batch;
+    std::vector<double> samples; // Sorted ns per operation
+
+    double getPercentile(double p) const {
+      unsigned i = (unsigned)(p * samples.size());
+      return samples[i < samples.size() ? i : samples.size() - 1];
+    }
+
+    double getMedian() const {return getPercentile(0.5);}
+
+    double getMean() const {
+      double sum = 0;
+      for (unsigned i = 0; i < samples.size(); i++) sum += samples[i];
+      return sum / samples.size();
+    }
+
+    void write(cb::JSON::Sink &sink) const {
+      sink.beginDict();
+      sink.insert("batch", batch);
+      sink.insert("samples", (unsigned)samples.size());
+      sink.insert("min", samples.front());
+      sink.insert("median", getMedian());
+      sink.insert("mean", getMean());
+      sink.insert("p90", getPercentile(0.9));
+      sink.insert("p99", getPercentile(0.99));
+      sink.insert("max", samples.back());
+      sink.endDict();
+    }
+  };
+
+protected:
+  std::vector<std::pair<std::string, func_t> > benchmarks;
+
+  std::string filter;
+  unsigned samples = 20;
+  double warmup = 0.1;
+  double sampleTime = 0.01;
+  std::string jsonFile;
+  std::string baselineFile;
+  double threshold = 0.1;
+
+public:
+  void add(const std::string &name, func_t func) {
+    benchmarks.push_back(std::make_pair(name, func));
+  }
+
+
+  /// Keep the compiler from discarding a computed value
+  template <typename T> static void consume(const T &x) {
+#ifdef __GNUC__
+    asm volatile("" : : "g"(&x) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &x;
+#endif
+  }
+
+
+  static double time(const func_t &func, unsigned count) {
+    double start = cb::Timer::monotonic();
+    func(count);
+    return cb::Timer::monotonic() - start;
+  }
+
+
+  Result run(const std::string &name, const func_t &func) const {
+    Result result;
+    result.name = name;
+
+    // Grow the batch until one takes at least the sample time
+    unsigned batch = 1;
+    while (true) {
+      double t = time(func, batch);
+      if (sampleTime <= t || (1U << 30) <= batch) break;
+
+      double scale = 0 < t ? 1.5 * sampleTime / t : 10;
+      batch = (unsigned)std::min(batch * std::max(2.0, std::min(scale, 100.0)),
+                                 (double)(1U << 30));
+    }
+
+    result.batch = batch;
+
+    double end = cb::Timer::monotonic() + warmup;
+    while (cb::Timer::monotonic() < end) time(func, batch);
+
+    for (unsigned i = 0; i < samples; i++)
+      result.samples.push_back(time(func, batch) * 1e9 / batch);
+
+    std::sort(result.samples.begin(), result.samples.end());
+
+    return result;
+  }
+
+
+  /// @return False if any benchmark regressed against the baseline
+  bool compare(const std::vector<Result> &results) const {
+    cb::JSON::ValuePtr baseline =
+      cb::JSON::Reader::parse(cb::InputSource(baselineFile));
+    const cb::JSON::Value &base = *baseline->get("benchmarks");
+    bool ok = true;
+
+    std::cout << "\n" << cb::String::printf("%-32s %10s %10s %8s",
+                                            "benchmark", "baseline", "median",
+                                            "change") << std::endl;
+
+    for (unsigned i = 0; i < results.size(); i++) {
+      const Result &r = results[i];
+      if (!base.has(r.name)) continue;
+
+      double old = base.get(r.name)->getNumber("median");
+      double change = old ? r.getMedian() / old - 1 : 0;
+      const char *flag = "";
+
+      if (threshold < change) {flag = "  REGRESSION"; ok = false;}
+      else if (change < -threshold) flag = "  improved";
+
+      std::cout << cb::String::printf("%-32s %10.2f %10.2f %+7.1f%%%s",
+                                      r.name.c_str(), old, r.getMedian(),
+                                      change * 100, flag) << std::endl;
+    }
+
+    return ok;
+  }
+
+
+  void write(const std::vector<Result> &results, std::ostream &stream) const {
+    cb::JSON::Writer writer(stream);
+
+    writer.beginDict();
+    writer.insertDict("benchmarks");
+    for (unsigned i = 0; i < results.size(); i++) {
+      writer.beginInsert(results[i].name);
+      results[i].write(writer);
+    }
+    writer.endDict();
+    writer.endDict();
+    writer.close();
+    stream << std::endl;
+  }
+
+
+  static int usage(const char *name) {
+    std::cerr
+      << "Usage: " << name << " [options]\n"
+      << "  --filter <string>     Only run benchmarks containing <string>\n"
+      << "  --samples <n>         Timed batches per benchmark, default 20\n"
+      << "  --warmup <secs>       Untimed run time, default 0.1\n"
+      << "  --sample-time <secs>  Minimum batch time, default 0.01\n"
+      << "  --json <file>         Write results as JSON, - for stdout\n"
+      << "  --baseline <file>     Compare against JSON from a previous run\n"
+      << "  --threshold <frac>    Slowdown flagged as a regression, "
+      "default 0.1\n"
+      << "  --list                List benchmarks and exit\n";
+    return 1;
+  }
+
+
+  int main(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+      std::string arg = argv[i];
+
+      if (arg == "--list") {
+        for (unsigned j = 0; j < benchmarks.size(); j++)
+          std::cout << benchmarks[j].first << '\n';
+        return 0;
+      }
+
+      if (argc <= i + 1) return usage(argv[0]);
+      std::string value = argv[++i];
+
+      if (arg == "--filter") filter = value;
+      else if (arg == "--samples") samples = cb::String::parseU32(value);
+      else if (arg == "--warmup") warmup = cb::String::parseDouble(value);
+      else if (arg == "--sample-time")
+        sampleTime = cb::String::parseDouble(value);
+      else if (arg == "--json") jsonFile = value;
+      else if (arg == "--baseline") baselineFile = value;
+      else if (arg == "--threshold") threshold = cb::String::parseDouble(value);
+      else return usage(argv[0]);
+    }
+
+    if (!samples) THROW("--samples must be at least 1");
+
+    std::vector<Result> results;
+    bool quiet = jsonFile == "-";
+
+    if (!quiet)
+      std::cout << cb::String::printf("%-32s %10s %10s %10s %10s",
+                                      "benchmark", "batch", "median ns",
+                                      "p90 ns", "p99 ns") << std::endl;
+
+    for (unsigned i = 0; i < benchmarks.size(); i++) {
+      const std::string &name = benchmarks[i].first;
+      if (!filter.empty() && name.find(filter) == std::string::npos)
+        continue;
+
+      results.push_back(run(name, benchmarks[i].second));
+      const Result &r = results.back();
+
+      if (!quiet)
+        std::cout << cb::String::printf
+          ("%-32s %10u %10.2f %10.2f %10.2f", name.c_str(), r.batch,
+           r.getMedian(), r.getPercentile(0.9), r.getPercentile(0.99))
+                  << std::endl;
+    }
+
+    if (quiet) write(results, std::cout);
+    else if (!jsonFile.empty())
+      write(results, *cb::SystemUtilities::oopen(jsonFile));
+
+    if (!baselineFile.empty() && !compare(results)) return 2;
+
+    return 0;
+  }
+};
@@ -0,0 +1,338 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+// Microbenchmarks of common operations.  Not run by the harness.
+//
+// Save a baseline with "benchmarks --json base.json" then check a later
+// build with "benchmarks --baseline base.json" which exits with status 2
+// if any median slowed by more than the threshold.
+
+#include "Benchmark.h"
+
+#include <cbang/Catch.h>
+#include <cbang/SmartPointer.h>
+#include <cbang/event/Buffer.h>
+#include <cbang/event/Headers.h>
+#include <cbang/event/MultipartParser.h>
+#include <cbang/json/JSON.h>
+#include <cbang/net/Base64.h>
+#include <cbang/net/SwabArray.h>
+#include <cbang/net/URI.h>
+#include <cbang/net/URIView.h>
+#include <cbang/util/ACLSet.h>
+#include <cbang/util/OrderedDict.h>
+#include <cbang/util/Rate.h>
+#include <cbang/util/Regex.h>
+
+using namespace std;
+using namespace cb;
+
+
+namespace {
+  const char *jsonDoc =
+    "{\"id\": 12345, \"name\": \"example\", \"enabled\": true, "
+    "\"ratio\": 0.75, \"tags\": [\"a\", \"b\", \"c\"], "
+    "\"owner\": {\"user\": \"joe\", \"groups\": [\"admin\", \"dev\"]}, "
+    "\"values\": [1, 2, 3, 4, 5, 6, 7, 8, 9, 10], \"note\": null}";
+
+  const char *uriString =
+    "https://user@www.example.com:8443/api/v1/items/42?sort=name&limit=10"
+    "#top";
+
+  const char *headerString =
+    "Host: www.example.com\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64)\r\n"
+    "Accept: text/html,application/xhtml+xml\r\n"
+    "Accept-Encoding: gzip, deflate\r\n"
+    "Accept-Language: en-US,en;q=0.5\r\n"
+    "Connection: keep-alive\r\n"
+    "Cookie: sid=0123456789abcdef\r\n"
+    "\r\n";
+
+
+  struct Object {};
+
+
+  template <typename Ptr>
+  void copyPointer(unsigned count) {
+    Ptr ptr = new Object;
+    for (unsigned i = 0; i < count; i++) {
+      Ptr copy = ptr;
+      BenchmarkSuite::consume(copy);
+    }
+  }
+
+
+  void addJSON(BenchmarkSuite &suite) {
+    suite.add("json.parse", [] (unsigned count) {
+        string s = jsonDoc;
+        for (unsigned i = 0; i < count; i++)
+          BenchmarkSuite::consume(JSON::Reader::parseString(s));
+      });
+
+    JSON::ValuePtr doc = JSON::Reader::parseString(jsonDoc);
+    suite.add("json.write", [doc] (unsigned count) {
+        for (unsigned i = 0; i < count; i++)
+          BenchmarkSuite::consume(doc->toString(0, true));
+      });
+
+    JSON::Path path("owner.groups.1");
+    suite.add("json.select", [doc, path] (unsigned count) {
+        for (unsigned i = 0; i < count; i++)
+          BenchmarkSuite::consume(path.select(*doc));
+      });
+
+    suite.add("json.select.string", [doc] (unsigned count) {
+        for (unsigned i = 0; i < count; i++)
+          BenchmarkSuite::consume(doc->select("owner.groups.1"));
+      });
+  }
+
+
+  void addOrderedDict(BenchmarkSuite &suite) {
+    vector<string> keys;
+    for (unsigned i = 0; i < 100; i++)
+      keys.push_back(String::printf("key%u", i));
+
+    suite.add("dict.insert", [keys] (unsigned count) {
+        for (unsigned i = 0; i < count; i += keys.size()) {
+          OrderedDict<int> dict;
+          for (unsigned j = 0; j < keys.size() && i + j < count; j++)
+            dict.insert(keys[j], j);
+          BenchmarkSuite::consume(dict);
+        }
+      });
+
+    OrderedDict<int> dict;
+    for (unsigned i = 0; i < keys.size(); i++) dict.insert(keys[i], i);
+
+    suite.add("dict.lookup", [keys, dict] (unsigned count) {
+        for (unsigned i = 0; i < count; i++)
+          BenchmarkSuite::consume(dict.lookup(keys[i % keys.size()]));
+      });
+  }
+
+
+  void addSmartPointer(BenchmarkSuite &suite) {
+    suite.add("pointer.copy", copyPointer<SmartPointer<Object> >);
+    suite.add("pointer.copy.protected",
+              copyPointer<SmartPointer<Object>::Protected>);
+  }
+
+
+  void addBase64(BenchmarkSuite &suite) {
+    string data;
+    for (unsigned i = 0; i < 1024; i++) data += (char)(i * 7);
+    Base64 codec;
+    string encoded = codec.encode(data);
+
+    suite.add("base64.encode.1k", [data, codec] (unsigned count) {
+        vector<char> buf(codec.getEncodedLength(data.size()));
+        for (unsigned i = 0; i < count; i++) {
+          codec.encode(data.data(), data.size(), buf.data());
+          BenchmarkSuite::consume(buf[0]);
+        }
+      });
+
+    suite.add("base64.decode.1k", [encoded, codec] (unsigned count) {
+        vector<char> buf(codec.getMaxDecodedLength(encoded.size()));
+        for (unsigned i = 0; i < count; i++) {
+          codec.decode(encoded.data(), encoded.size(), buf.data());
+          BenchmarkSuite::consume(buf[0]);
+        }
+      });
+  }
+
+
+  void addSwab(BenchmarkSuite &suite) {
+    vector<uint32_t> data(4096);
+    for (unsigned i = 0; i < data.size(); i++) data[i] = i * 2654435761U;
+
+    suite.add("swab.scalar.16k", [data] (unsigned count) {
+        vector<uint32_t> out(data.size());
+        for (unsigned i = 0; i < count; i++) {
+          for (unsigned j = 0; j < data.size(); j++) out[j] = hton32(data[j]);
+          BenchmarkSuite::consume(out[0]);
+        }
+      });
+
+    suite.add("swab.array.16k", [data] (unsigned count) {
+        vector<uint32_t> out(data.size());
+        for (unsigned i = 0; i < count; i++) {
+          hton32Array(out.data(), data.data(), data.size());
+          BenchmarkSuite::consume(out[0]);
+        }
+      });
+  }
+
+
+  void addURI(BenchmarkSuite &suite) {
+    suite.add("uri.parse", [] (unsigned count) {
+        for (unsigned i = 0; i < count; i++)
+          BenchmarkSuite::consume(URI(uriString));
+      });
+
+    suite.add("uri.view", [] (unsigned count) {
+        for (unsigned i = 0; i < count; i++)
+          BenchmarkSuite::consume(URIView(uriString));
+      });
+  }
+
+
+  void addRegex(BenchmarkSuite &suite) {
+    suite.add("regex.construct", [] (unsigned count) {
+        for (unsigned i = 0; i < count; i++)
+          BenchmarkSuite::consume(Regex("/api/v1/items/([0-9]+)"));
+      });
+
+    Regex re("/api/v1/items/([0-9]+)");
+    suite.add("regex.match", [re] (unsigned count) {
+        Regex::Match m;
+        for (unsigned i = 0; i < count; i++)
+          BenchmarkSuite::consume(re.match("/api/v1/items/42", m));
+      });
+  }
+
+
+  void addHeaders(BenchmarkSuite &suite) {
+    suite.add("headers.parse", [] (unsigned count) {
+        for (unsigned i = 0; i < count; i++) {
+          Event::Buffer buf(headerString);
+          Event::Headers hdrs;
+          hdrs.parse(buf);
+          BenchmarkSuite::consume(hdrs);
+        }
+      });
+  }
+
+
+  struct CountingParser : public Event::MultipartParser {
+    uint64_t bytes = 0;
+
+    CountingParser(const string &boundary) :
+      Event::MultipartParser(boundary) {}
+
+    void onPartData(const Part &part, const char *data, unsigned length)
+      {bytes += length;}
+  };
+
+
+  void addMultipart(BenchmarkSuite &suite) {
+    string boundary = "----FormBoundary7MA4YWxkTrZu0gW";
+    string body = "--" + boundary + "\r\n"
+      "Content-Disposition: form-data; name=\"file\"; filename=\"a.bin\"\r\n"
+      "\r\n";
+    for (unsigned i = 0; i < 1 << 16; i++) body += (char)('a' + i % 26);
+    body += "\r\n--" + boundary + "--\r\n";
+
+    // 64KiB part arriving in 4KiB reads
+    suite.add("multipart.parse", [boundary, body] (unsigned count) {
+        for (unsigned i = 0; i < count; i++) {
+          CountingParser parser(boundary);
+
+          for (unsigned j = 0; j < body.length(); j += 4096) {
+            Event::Buffer buf(body.data() + j,
+                              min<unsigned>(4096, body.length() - j));
+            parser.parse(buf);
+          }
+
+          BenchmarkSuite::consume(parser.bytes);
+        }
+      });
+  }
+
+
+  void addRate(BenchmarkSuite &suite) {
+    suite.add("rate.event", [] (unsigned count) {
+        Rate rate(300, 1);
+        for (unsigned i = 0; i < count; i++) rate.event(1, 1000 + i / 64);
+        BenchmarkSuite::consume(rate);
+      });
+
+    Rate rate(300, 1);
+    for (unsigned i = 0; i < 300; i++) rate.event(i, 1000 + i);
+
+    suite.add("rate.get", [rate] (unsigned count) {
+        for (unsigned i = 0; i < count; i++)
+          BenchmarkSuite::consume(rate.get(1300));
+      });
+  }
+
+
+  void addACLSet(BenchmarkSuite &suite) {
+    SmartPointer<ACLSet> acls = new ACLSet;
+
+    for (unsigned i = 0; i < 32; i++) {
+      string user = String::printf("user%u", i);
+      string group = String::printf("group%u", i % 4);
+      acls->addUser(user);
+      if (!acls->hasGroup(group)) acls->addGroup(group);
+      acls->groupAddUser(group, user);
+    }
+
+    for (unsigned i = 0; i < 16; i++) {
+      string path = String::printf("/api/v%u/", i);
+      acls->addACL(path);
+      acls->aclAddUser(path, String::printf("user%u", i));
+      acls->aclAddGroup(path, String::printf("group%u", i % 4));
+    }
+
+    suite.add("acl.allow", [acls] (unsigned count) {
+        for (unsigned i = 0; i < count; i++)
+          BenchmarkSuite::consume(acls->allow("/api/v7/items/42", "user31"));
+      });
+  }
+}
+
+
+int main(int argc, char *argv[]) {
+  try {
+    BenchmarkSuite suite;
+
+    addJSON(suite);
+    addOrderedDict(suite);
+    addSmartPointer(suite);
+    addBase64(suite);
+    addSwab(suite);
+    addURI(suite);
+    addRegex(suite);
+    addHeaders(suite);
+    addMultipart(suite);
+    addRate(suite);
+    addACLSet(suite);
+
+    return suite.main(argc, argv);
+  } CATCH_ERROR;
+
+  return 1;
+}
@@ -0,0 +1,146 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+// Measures the heap used by idle Event::Connections and Websockets.  Not
+// run by the harness.
+
+#include <cbang/Catch.h>
+#include <cbang/String.h>
+#include <cbang/SmartPointer.h>
+#include <cbang/event/Base.h>
+#include <cbang/event/Connection.h>
+#include <cbang/event/Websocket.h>
+#include <cbang/net/IPAddress.h>
+#include <cbang/socket/Socket.h>
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using namespace cb;
+
+
+#ifdef __GLIBC__
+namespace {
+  uint64_t heapUsed() {
+#if __GLIBC_PREREQ(2, 33)
+    return mallinfo2().uordblks;
+#else
+    return (unsigned)mallinfo().uordblks;
+#endif
+  }
+
+
+  struct Idle {
+    vector<int> peers;
+    vector<SmartPointer<Event::Connection> > cons;
+    vector<SmartPointer<Event::Websocket> > websockets;
+
+    ~Idle() {for (auto fd: peers) ::close(fd);}
+  };
+
+
+  uint64_t measure(Event::Base &base, Idle &idle, unsigned count,
+                   bool websocket) {
+    uint64_t before = heapUsed();
+
+    for (unsigned i = 0; i < count; i++) {
+      int fds[2];
+      if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds))
+        THROW("socketpair() failed");
+      idle.peers.push_back(fds[1]);
+
+      SmartPointer<Socket> socket = new Socket;
+      socket->set(fds[0]);
+
+      idle.cons.push_back(new Event::Connection
+                          (base, true, IPAddress("127.0.0.1"), socket));
+
+      if (websocket)
+        idle.websockets.push_back
+          (new Event::Websocket(Event::RequestMethod::HTTP_GET, URI("/ws"),
+                                Version(1, 1)));
+    }
+
+    return (heapUsed() - before) / count;
+  }
+}
+#endif
+
+
+int main(int argc, char *argv[]) {
+  try {
+#ifdef __GLIBC__
+    unsigned count = 1 < argc ? String::parseU32(argv[1]) : 4096;
+
+    // Each idle connection holds one end of a socket pair
+    rlimit limit;
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    count = min<uint64_t>(count, (limit.rlim_cur - 64) / 4);
+    if (!count) THROW("Too few file descriptors");
+
+    cout << String::printf("sizeof Connection=%u BufferEvent=%u "
+                           "Websocket=%u", (unsigned)sizeof(Event::Connection),
+                           (unsigned)sizeof(Event::BufferEvent),
+                           (unsigned)sizeof(Event::Websocket)) << endl;
+
+    Event::Base base;
+    Idle idle;
+
+    uint64_t con = measure(base, idle, count, false);
+    uint64_t ws = measure(base, idle, count, true);
+
+    cout << String::printf("%u idle connections            %6u bytes each",
+                           count, (unsigned)con) << endl;
+    cout << String::printf("%u idle connections+websockets %6u bytes each",
+                           count, (unsigned)ws) << endl;
+
+#else
+    cout << "Heap statistics require glibc" << endl;
+#endif
+
+    return 0;
+  } CATCH_ERROR;
+
+  return 1;
+}
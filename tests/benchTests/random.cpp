@@ -0,0 +1,116 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+// Compares Random with OpenSSL's global generator.  Not run by the harness.
+
+#include <cbang/util/Random.h>
+#include <cbang/Catch.h>
+#include <cbang/String.h>
+#include <cbang/os/Thread.h>
+#include <cbang/time/Timer.h>
+
+#include <openssl/rand.h>
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace cb;
+
+
+namespace {
+  struct Generator : public Thread {
+    bool openssl;
+    unsigned size;
+    unsigned count;
+
+    Generator(bool openssl, unsigned size, unsigned count) :
+      openssl(openssl), size(size), count(count) {}
+
+    void run() {
+      vector<uint8_t> buffer(size);
+
+      for (unsigned i = 0; i < count; i++)
+        if (openssl) RAND_bytes(&buffer[0], size);
+        else Random::instance().bytes(&buffer[0], size);
+    }
+  };
+
+
+  double bench(bool openssl, unsigned threads, unsigned size, unsigned count) {
+    vector<SmartPointer<Generator> > generators;
+
+    for (unsigned i = 0; i < threads; i++)
+      generators.push_back(new Generator(openssl, size, count / threads));
+
+    double start = Timer::now();
+    for (unsigned i = 0; i < threads; i++) generators[i]->start();
+    for (unsigned i = 0; i < threads; i++) generators[i]->join();
+
+    // Nanoseconds per call
+    return (Timer::now() - start) * 1e9 / count;
+  }
+}
+
+
+int main(int argc, char *argv[]) {
+  try {
+    unsigned count = 1 < argc ? String::parseU32(argv[1]) : 1000000;
+
+    Random::instance();
+
+    cout << "ns per call by request size and thread count" << endl;
+    cout << String::printf("%-8s %6s", "source", "bytes");
+    unsigned threads[] = {1, 2, 4, 8};
+    for (unsigned i = 0; i < 4; i++)
+      cout << String::printf(" %8ut", threads[i]);
+    cout << endl;
+
+    unsigned sizes[] = {4, 8, 32, 1024};
+    for (unsigned i = 0; i < 4; i++)
+      for (unsigned openssl = 0; openssl < 2; openssl++) {
+        cout << String::printf("%-8s %6u", openssl ? "openssl" : "random",
+                               sizes[i]);
+
+        for (unsigned j = 0; j < 4; j++)
+          cout << String::printf
+            (" %9.2f", bench(openssl, threads[j], sizes[i], count));
+
+        cout << endl;
+      }
+
+    return 0;
+  } CATCH_ERROR;
+
+  return 1;
+}
@@ -0,0 +1,166 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+// Compares SmartPointer reference counting costs.  Not run by the harness.
+
+#include <cbang/SmartPointer.h>
+#include <cbang/Catch.h>
+#include <cbang/String.h>
+#include <cbang/os/Mutex.h>
+#include <cbang/os/Thread.h>
+#include <cbang/time/Timer.h>
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace cb;
+
+
+namespace {
+  struct Object {};
+
+
+  // The previous lock based ProtectedRefCounterImpl, for comparison
+  template<typename T, class Dealloc_T = DeallocNew<T> >
+  class MutexRefCounterImpl : public RefCounterImpl<T, Dealloc_T>, Mutex {
+    typedef RefCounterImpl<T, Dealloc_T> Super_T;
+    using Super_T::count;
+
+  public:
+    static RefCounter *create() {return new MutexRefCounterImpl;}
+    static bool staticIsProtected() {return true;}
+    bool isProtected() const {return true;}
+
+    unsigned getCount() const {
+      lock();
+      unsigned x = count;
+      unlock();
+      return x;
+    }
+
+    void incCount() {
+      lock();
+      count++;
+      unlock();
+    }
+
+    void decCount(const void *ptr) {
+      lock();
+      if (!count) {unlock(); Super_T::raise("Already zero!");}
+
+      if (!--count) {
+        unlock();
+        Super_T::release(ptr);
+
+      } else unlock();
+    }
+  };
+
+
+  template <typename Ptr>
+  struct Copier : public Thread {
+    Ptr ptr;
+    unsigned count;
+
+    Copier(const Ptr &ptr, unsigned count) : ptr(ptr), count(count) {}
+
+    void run() {
+      for (unsigned i = 0; i < count; i++) Ptr copy = ptr;
+    }
+  };
+
+
+  template <typename Ptr>
+  double bench(unsigned threads, unsigned count, bool shared) {
+    Ptr ptr = new Object;
+    vector<SmartPointer<Copier<Ptr> > > copiers;
+
+    for (unsigned i = 0; i < threads; i++)
+      copiers.push_back
+        (new Copier<Ptr>(shared ? ptr : Ptr(new Object), count));
+
+    double start = Timer::now();
+    for (unsigned i = 0; i < threads; i++) copiers[i]->start();
+    for (unsigned i = 0; i < threads; i++) copiers[i]->join();
+
+    // Nanoseconds per copy and release
+    return (Timer::now() - start) * 1e9 / ((double)threads * count);
+  }
+
+
+  template <typename Ptr>
+  void report(const char *name, size_t size, unsigned count, bool share) {
+    cout << String::printf("%-10s %4u bytes", name, (unsigned)size);
+
+    unsigned threads[] = {1, 2, 4, 8};
+    for (unsigned i = 0; i < 4; i++) {
+      unsigned n = count / threads[i];
+      cout << String::printf(" %8.2f", bench<Ptr>(threads[i], n, false));
+
+      // Sharing unprotected pointers between threads is not safe
+      if (share) cout << String::printf(" %8.2f", bench<Ptr>(threads[i], n,
+                                                             true));
+      else cout << "        -";
+    }
+
+    cout << endl;
+  }
+}
+
+
+int main(int argc, char *argv[]) {
+  try {
+    unsigned count = 1 < argc ? String::parseU32(argv[1]) : 10000000;
+
+    cout << "ns per copy of separate (t) and shared (s) pointers by thread "
+      "count" << endl;
+    cout << String::printf("%-10s %10s", "counter", "size");
+    unsigned threads[] = {1, 2, 4, 8};
+    for (unsigned i = 0; i < 4; i++)
+      cout << String::printf(" %7ut %7us", threads[i], threads[i]);
+    cout << endl;
+
+    report<SmartPointer<Object> >
+      ("plain", sizeof(RefCounterImpl<Object>), count, false);
+    report<SmartPointer<Object>::Protected>
+      ("atomic", sizeof(ProtectedRefCounterImpl<Object>), count, true);
+    report<SmartPointer<Object, DeallocNew<Object>,
+                        MutexRefCounterImpl<Object> > >
+      ("mutex", sizeof(MutexRefCounterImpl<Object>), count, true);
+
+    return 0;
+  } CATCH_ERROR;
+
+  return 1;
+}
@@ -0,0 +1,110 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+// Compares String numeric parsing and formatting with the libc functions
+// they replaced.  Not run by the harness.
+
+#include <cbang/String.h>
+#include <cbang/Catch.h>
+#include <cbang/time/Timer.h>
+
+#include <iostream>
+#include <vector>
+
+#include <stdlib.h>
+
+using namespace std;
+using namespace cb;
+
+
+namespace {
+  uint64_t sink = 0;
+
+
+  template <typename F>
+  void report(const char *name, const vector<string> &values, unsigned count,
+              F f) {
+    double start = Timer::now();
+
+    for (unsigned i = 0; i < count; i++)
+      for (unsigned j = 0; j < values.size(); j++)
+        sink += f(values[j]);
+
+    double ns = (Timer::now() - start) * 1e9 / ((double)count * values.size());
+    cout << String::printf("%-20s %8.2f ns", name, ns) << endl;
+  }
+
+
+  uint64_t libcU32(const string &s) {return strtoul(s.c_str(), 0, 0);}
+  uint64_t libcS64(const string &s) {return strtoll(s.c_str(), 0, 0);}
+  uint64_t parseU32(const string &s) {return String::parseU32(s, true);}
+  uint64_t parseS64(const string &s) {return String::parseS64(s, true);}
+
+
+  uint64_t parseU32View(const string &s) {
+    return String::parseU32(s.data(), s.length(), true);
+  }
+
+
+  uint64_t libcFormat(const string &s) {
+    return String::printf("%llu", (long long unsigned)s.length()).length();
+  }
+
+
+  uint64_t format(const string &s) {
+    return String((uint64_t)s.length() * 1000003).length();
+  }
+}
+
+
+int main(int argc, char *argv[]) {
+  try {
+    unsigned count = 1 < argc ? String::parseU32(argv[1]) : 100000;
+
+    vector<string> values;
+    for (unsigned i = 0; i < 100; i++)
+      values.push_back(String((uint32_t)(i * 2654435761U) >> (i % 32)));
+
+    report("strtoul()", values, count, libcU32);
+    report("parseU32()", values, count, parseU32);
+    report("parseU32(ptr, len)", values, count, parseU32View);
+    report("strtoll()", values, count, libcS64);
+    report("parseS64()", values, count, parseS64);
+    report("printf(\"%llu\")", values, count, libcFormat);
+    report("String(uint64_t)", values, count, format);
+
+    return sink == 0;
+  } CATCH_ERROR;
+
+  return 1;
+}
@@ -0,0 +1,122 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include <cbang/openssl/AEADStream.h>
+#include <cbang/iostream/AEADEncryptor.h>
+#include <cbang/iostream/AEADDecryptor.h>
+#include <cbang/Catch.h>
+
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/copy.hpp>
+
+#include <sstream>
+
+using namespace std;
+using namespace cb;
+
+
+string encrypt(const string &data, AEADStream::cipher_t cipher) {
+  ostringstream out;
+
+  {
+    io::filtering_ostream stream;
+    stream.push(AEADEncryptor("secret", cipher, 16));
+    stream.push(out);
+    stream.write(data.data(), data.size());
+  }
+
+  return out.str();
+}
+
+
+string decrypt(const string &data) {
+  istringstream in(data);
+  io::filtering_istream stream;
+  stream.push(AEADDecryptor("secret"));
+  stream.push(in);
+
+  ostringstream out;
+  io::copy(stream, out);
+
+  return out.str();
+}
+
+
+void check(const string &name, const string &data) {
+  try {
+    decrypt(data);
+    cout << name << "=accepted" << endl;
+  } catch (const Exception &e) {cout << name << '=' << e.getMessage() << endl;}
+}
+
+
+int main(int argc, char *argv[]) {
+  try {
+    for (unsigned i = 1; i <= 2; i++) {
+      AEADStream::cipher_t cipher = (AEADStream::cipher_t)i;
+
+      for (unsigned size: {0, 1, 16, 17, 100}) {
+        string data;
+        for (unsigned j = 0; j < size; j++) data += (char)('a' + j % 26);
+
+        string encrypted = encrypt(data, cipher);
+        AEADStream aead("secret", encrypted.substr(0, AEADStream::HEADER_SIZE));
+
+        cout << "cipher=" << i << " size=" << size
+             << " encrypted=" << encrypted.size()
+             << " expected=" << aead.getEncryptedSize(size)
+             << " match=" << (decrypt(encrypted) == data) << endl;
+      }
+    }
+
+    string data(100, 'x');
+    string encrypted = encrypt(data, AEADStream::AES_256_GCM);
+    AEADStream aead("secret", encrypted.substr(0, AEADStream::HEADER_SIZE));
+
+    // Random access
+    char frame[16];
+    unsigned length =
+      aead.decrypt(3, false, encrypted.data() + aead.getFrameOffset(3),
+                   aead.getEncryptedFrameSize(), frame);
+    cout << "frame3=" << string(frame, length) << endl;
+
+    string modified = encrypted;
+    modified[aead.getFrameOffset(2) + 5] ^= 1;
+    check("modified", modified);
+    check("truncated", encrypted.substr(0, aead.getFrameOffset(4)));
+    check("short", encrypted.substr(0, 10));
+
+    return 0;
+  } CATCH_ERROR;
+
+  return 1;
+}
@@ -0,0 +1,74 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+#include <cbang/String.h>
+#include <cbang/openssl/HMACContext.h>
+#include <cbang/event/Buffer.h>
+#include <cbang/Catch.h>
+
+using namespace std;
+using namespace cb;
+
+
+int main(int argc, char *argv[]) {
+  // Test data from RFC 4231, test case 2
+
+  try {
+    HMACContext hmac("Jefe");
+    string data = "what do ya want for nothing?";
+
+    cout << "sign=" << String::hexEncode(hmac.sign(data)) << endl;
+    cout << "reuse=" << String::hexEncode(hmac.sign(data)) << endl;
+
+    hmac.update(data.substr(0, 8));
+    HMACContext copy(hmac);
+    hmac.update(data.substr(8));
+    cout << "incremental=" << String::hexEncode(hmac.finalize()) << endl;
+    cout << "copy=" << String::hexEncode(copy.sign(data)) << endl;
+
+    Event::Buffer buf;
+    for (unsigned i = 0; i < data.size(); i += 4) buf.add(data.substr(i, 4));
+    cout << "buffer=" << String::hexEncode(hmac.sign(buf)) << endl;
+
+    vector<string> macs = hmac.sign(vector<string>{data, "", data});
+    for (unsigned i = 0; i < macs.size(); i++)
+      cout << "batch" << i << '=' << String::hexEncode(macs[i]) << endl;
+
+    cout << "verify=" << hmac.verify(data, macs[0]) << endl;
+    cout << "verify-bad=" << hmac.verify(data + ".", macs[0]) << endl;
+    cout << "verify-short=" << hmac.verify(data, macs[0].substr(1)) << endl;
+
+    return 0;
+  } CATCH_ERROR;
+
+  return 1;
+}
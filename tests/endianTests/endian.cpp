@@ -31,6 +31,7 @@
 \******************************************************************************/
 
 #include <cbang/net/Swab.h>
+#include <cbang/packet/Packet.h>
 #include <cbang/String.h>
 #include <cbang/Catch.h>
 
@@ -38,6 +39,7 @@
 #include <iomanip>
 #include <typeinfo>
 #include <limits>
+#include <vector>
 
 using namespace cb;
 using namespace std;
@@ -57,8 +59,87 @@ using namespace std;
 
 
 
+template <typename T, typename SWAP>
+void testArray(const char *name, SWAP swap) {
+  // Every length and alignment through the vector and tail loops
+  vector<char> src(8 * 80 + 8), dst(src.size());
+  for (unsigned i = 0; i < src.size(); i++) src[i] = (char)(i * 37 + 11);
+
+  unsigned errors = 0;
+  for (unsigned align = 0; align < 8; align++)
+    for (unsigned count = 0; count <= 80; count++) {
+      fill(dst.begin(), dst.end(), 0);
+      char *in = &src[align];
+      char *out = &dst[align];
+      htonArray((T *)out, (const T *)in, count);
+
+      for (unsigned i = 0; i < count; i++) {
+        T x, y;
+        memcpy(&x, in + i * sizeof(T), sizeof(T));
+        memcpy(&y, out + i * sizeof(T), sizeof(T));
+        if ((T)swap(x) != y) errors++;
+      }
+    }
+
+  cout << name << "Array " << (errors ? "FAILED" : "ok") << endl;
+}
+
+
+int testArrays() {
+  testArray<uint16_t>("hton16", [] (uint16_t x) {return hton16(x);});
+  testArray<uint32_t>("hton32", [] (uint32_t x) {return hton32(x);});
+  testArray<uint64_t>("hton64", [] (uint64_t x) {return hton64(x);});
+
+  // In place
+  PFU32Array::int_t raw[3] = {hton32(1U), hton32(2U), hton32(3U)};
+  PFU32Array a(raw, 3);
+  a.swab();
+  cout << "swab " << raw[0] << " " << raw[1] << " " << raw[2] << endl;
+
+  // Packet array fields
+  Packet packet(64);
+  int32_t ints[4] = {-2, -1, 0, 70000};
+  packet.getArray<PFS32Array>(8, 4).set(ints, 4);
+  PFS32 field(packet.getData() + 20);
+  cout << "field " << packet.getArray<PFS32Array>(8, 4)[1] << " "
+       << field << endl;
+
+  int32_t out[4];
+  packet.getArray<PFS32Array>(8, 4).get(out, 2, 2);
+  cout << "get " << out[0] << " " << out[1] << endl;
+
+  PacketArrayField<int16_t, int> wide(packet.getData() + 32, 2);
+  int in[2] = {-300, 300};
+  int res[2];
+  wide.set(in, 2);
+  wide.get(res, 2);
+  cout << "wide " << res[0] << " " << res[1] << endl;
+
+  double fp[3] = {1.25, -2.5, 3.75};
+  double fpOut[3];
+  PFS32F2Array fpa = packet.getArray<PFS32F2Array>(40, 3);
+  fpa.set(fp, 3);
+  fpa.get(fpOut, 3);
+  cout << "fp " << fpOut[0] << " " << fpOut[1] << " " << fpOut[2] << " "
+       << fpa[2] << endl;
+
+  try {
+    packet.getArray<PFU64Array>(60, 1);
+  } catch (const Exception &e) {cout << e.getMessage() << endl;}
+
+  try {
+    uint32_t values[2];
+    a.get(values, 2, 2);
+  } catch (const Exception &e) {cout << e.getMessage() << endl;}
+
+  return 0;
+}
+
+
 int main(int argc, char *argv[]) {
   try {
+    if (argc == 2 && string(argv[1]) == "--arrays") return testArrays();
+
     if (argc != 2) {
       cout << "Usage: " << argv[0] << " <number>" << endl;
       return 1;
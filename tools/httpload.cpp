@@ -0,0 +1,366 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+// HTTP load generator for end-to-end benchmarks of Event::HTTP servers.
+//
+// In the default closed loop mode each of --concurrency workers sends its
+// next request as soon as the last one completes.  With --rate requests
+// are instead issued on a fixed schedule and latency is measured from
+// the scheduled time, so a stalled server is not hidden by the generator
+// backing off (coordinated omission).
+
+#include <cbang/Catch.h>
+#include <cbang/String.h>
+
+#include <cbang/event/Base.h>
+#include <cbang/event/DNSBase.h>
+#include <cbang/event/Event.h>
+#include <cbang/event/Client.h>
+#include <cbang/event/ConnectionPool.h>
+#include <cbang/event/OutgoingRequest.h>
+
+#include <cbang/config/CommandLine.h>
+#include <cbang/json/JSON.h>
+#include <cbang/log/Logger.h>
+#include <cbang/openssl/SSLContext.h>
+#include <cbang/os/SystemUtilities.h>
+#include <cbang/time/Timer.h>
+#include <cbang/util/Histogram.h>
+#include <cbang/util/Random.h>
+
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <map>
+
+using namespace std;
+using namespace cb;
+
+
+namespace {
+  struct Target {
+    Event::RequestMethod method;
+    URI uri;
+    string body;
+    string contentType;
+    unsigned weight;
+
+    Target(Event::RequestMethod method, const URI &uri, unsigned weight = 1)
+      : method(method), uri(uri), weight(weight) {}
+  };
+
+
+  class LoadGenerator {
+    Event::Base base;
+    Event::DNSBase dns;
+    Event::Client client;
+
+    vector<Target> targets;
+    vector<unsigned> cumulative;
+
+    unsigned concurrency;
+    double rate;
+    double duration;
+    uint64_t maxRequests;
+    bool checkJSON;
+
+    SmartPointer<Event::Event> arrivalEvent;
+    SmartPointer<Event::Event> stopEvent;
+
+    double startTime = 0;
+    double endTime = 0;
+    bool stopping = false;
+    unsigned outstanding = 0;
+    uint64_t issued = 0;
+
+    Histogram latency; // Microseconds
+    map<unsigned, uint64_t> statuses;
+    uint64_t errors = 0;
+    uint64_t invalid = 0;
+    uint64_t bytes = 0;
+
+  public:
+    LoadGenerator(const vector<Target> &targets,
+                  const SmartPointer<SSLContext> &sslCtx, unsigned concurrency,
+                  double rate, double duration, uint64_t maxRequests,
+                  bool keepAlive, bool checkJSON) :
+      dns(base), client(base, dns, sslCtx), targets(targets),
+      concurrency(concurrency ? concurrency : 1), rate(rate),
+      duration(duration), maxRequests(maxRequests), checkJSON(checkJSON) {
+
+      unsigned total = 0;
+      for (unsigned i = 0; i < targets.size(); i++)
+        cumulative.push_back(total += targets[i].weight);
+      if (!total) THROW("No requests to send");
+
+      Event::ConnectionPool &pool = *client.getPool();
+      if (keepAlive) {
+        pool.setMaxPerHost(this->concurrency);
+        pool.setMaxIdle(max(pool.getMaxIdle(), this->concurrency));
+
+      } else pool.setMaxIdle(0);
+
+      arrivalEvent = base.newEvent(this, &LoadGenerator::arrival, 0);
+      stopEvent = base.newEvent(this, &LoadGenerator::stop, 0);
+    }
+
+
+    void run() {
+      startTime = Timer::monotonic();
+      if (duration) stopEvent->add(duration);
+
+      if (rate) arrival();
+      else for (unsigned i = 0; i < concurrency; i++) issue(startTime);
+
+      base.dispatch();
+    }
+
+
+    void write(JSON::Sink &sink) const {
+      double elapsed = endTime - startTime;
+      uint64_t completed = latency.getCount();
+
+      sink.beginDict();
+      sink.insert("mode", rate ? "open" : "closed");
+      sink.insert("concurrency", concurrency);
+      if (rate) sink.insert("rate", rate);
+      sink.insert("elapsed", elapsed);
+      sink.insert("requests", completed);
+      sink.insert("errors", errors);
+      if (checkJSON) sink.insert("invalid_json", invalid);
+      sink.insert("bytes", bytes);
+      sink.insert("throughput", elapsed ? completed / elapsed : 0);
+
+      sink.insertDict("status");
+      for (auto it = statuses.begin(); it != statuses.end(); it++)
+        sink.insert(String(it->first), it->second);
+      sink.endDict();
+
+      sink.beginInsert("latency_us");
+      latency.write(sink);
+      sink.endDict();
+    }
+
+
+  protected:
+    bool done() const {
+      return stopping || (maxRequests && maxRequests <= issued);
+    }
+
+
+    const Target &pick() const {
+      if (targets.size() == 1) return targets[0];
+
+      unsigned x = Random::instance().rand<uint32_t>() % cumulative.back();
+      unsigned i =
+        upper_bound(cumulative.begin(), cumulative.end(), x) -
+        cumulative.begin();
+
+      return targets[i];
+    }
+
+
+    void issue(double scheduled) {
+      const Target &target = pick();
+      issued++;
+      outstanding++;
+
+      auto cb = [this, scheduled] (Event::Request &req) {
+        response(req, scheduled);
+      };
+
+      SmartPointer<Event::OutgoingRequest> req =
+        client.call(target.uri, target.method, target.body, cb);
+
+      if (!target.contentType.empty()) req->setContentType(target.contentType);
+      req->send();
+    }
+
+
+    void response(Event::Request &req, double scheduled) {
+      double now = Timer::monotonic();
+      outstanding--;
+
+      if (req.getConnectionError()) errors++;
+      else {
+        statuses[req.getResponseCode()]++;
+        bytes += req.getInputBuffer().getLength();
+
+        if (checkJSON)
+          try {
+            req.getJSONMessage();
+          } catch (const Exception &) {invalid++;}
+      }
+
+      latency.record((uint64_t)((now - scheduled) * 1e6));
+
+      if (done()) {
+        if (!outstanding) finish(now);
+
+      } else if (rate) arrival();
+      else issue(now);
+    }
+
+
+    void arrival() {
+      while (!done()) {
+        double now = Timer::monotonic();
+        double next = startTime + issued / rate;
+
+        if (now < next) {arrivalEvent->add(next - now); return;}
+
+        // Requests which cannot be sent yet keep their scheduled time
+        if (concurrency <= outstanding) return;
+
+        issue(next);
+      }
+
+      if (!outstanding) finish(Timer::monotonic());
+    }
+
+
+    void stop() {
+      stopping = true;
+      arrivalEvent->del();
+      if (!outstanding) finish(Timer::monotonic());
+    }
+
+
+    void finish(double now) {
+      if (endTime) return;
+      endTime = now;
+      base.loopExit();
+    }
+  };
+
+
+  void readMix(const string &path, vector<Target> &targets) {
+    JSON::ValuePtr mix = JSON::Reader::parse(InputSource(path));
+
+    for (unsigned i = 0; i < mix->size(); i++) {
+      const JSON::Value &entry = *mix->get(i);
+
+      Target target(Event::RequestMethod::parse
+                    (entry.getString("method", "GET")),
+                    URI(entry.getString("url")), entry.getU32("weight", 1));
+
+      if (entry.has("body")) {
+        const JSON::Value &body = *entry.get("body");
+
+        if (body.isString()) target.body = body.getString();
+        else {
+          target.body = body.toString(0, true);
+          target.contentType = "application/json";
+        }
+      }
+
+      target.contentType = entry.getString("type", target.contentType);
+      targets.push_back(target);
+    }
+  }
+}
+
+
+int main(int argc, char *argv[]) {
+  try {
+    string method = "GET";
+    string mix;
+    string output;
+    uint32_t concurrency = 16;
+    double rate = 0;
+    double duration = 10;
+    uint64_t requests = 0;
+    bool keepAlive = true;
+    bool checkJSON = false;
+
+    // Per request logging would dominate the measurement
+    Logger::instance().setVerbosity(0);
+
+    CommandLine cmdLine;
+    Logger::instance().addOptions(cmdLine);
+    cmdLine.setUsageArgs("[urls...]");
+
+    cmdLine.addTarget("method", method, "HTTP method for URLs given on the "
+                      "command line", 'x');
+    cmdLine.addTarget("mix", mix, "A JSON file listing requests to send, "
+                      "each with \"url\" and optionally \"method\", \"body\", "
+                      "\"type\" and \"weight\".  Non-string bodies are sent "
+                      "as JSON.");
+    cmdLine.addTarget("concurrency", concurrency, "Maximum requests in "
+                      "flight", 'c');
+    cmdLine.addTarget("rate", rate, "Requests per second on a fixed "
+                      "schedule.  Zero runs closed loop.", 'r');
+    cmdLine.addTarget("duration", duration, "Seconds to run, zero for no "
+                      "limit", 'd');
+    cmdLine.addTarget("requests", requests, "Stop after this many requests, "
+                      "zero for no limit", 'n');
+    cmdLine.addTarget("keep-alive", keepAlive, "Reuse connections");
+    cmdLine.addTarget("check-json", checkJSON, "Parse each response as JSON "
+                      "and count failures");
+    cmdLine.addTarget("output", output, "Write the JSON report to this file "
+                      "rather than stdout", 'o');
+
+    cmdLine.parse(argc, argv);
+
+    vector<Target> targets;
+    const vector<string> &urls = cmdLine.getPositionalArgs();
+    for (unsigned i = 0; i < urls.size(); i++)
+      targets.push_back
+        (Target(Event::RequestMethod::parse(method), URI(urls[i])));
+
+    if (!mix.empty()) readMix(mix, targets);
+    if (targets.empty()) THROW("No URLs given");
+    if (!duration && !requests) THROW("Need a --duration or --requests limit");
+
+    SmartPointer<SSLContext> sslCtx;
+    for (unsigned i = 0; i < targets.size(); i++)
+      if (targets[i].uri.getScheme() == "https") sslCtx = new SSLContext;
+
+    LoadGenerator gen(targets, sslCtx, concurrency, rate, duration, requests,
+                      keepAlive, checkJSON);
+    gen.run();
+
+    SmartPointer<ostream> file;
+    if (!output.empty()) file = SystemUtilities::oopen(output);
+    ostream &stream = file.isSet() ? *file : cout;
+
+    JSON::Writer writer(stream, 0, false);
+    gen.write(writer);
+    writer.close();
+    stream << endl;
+
+    return 0;
+  } CATCH_ERROR;
+
+  return 1;
+}
@@ -0,0 +1,118 @@
+/******************************************************************************\
+
+          This file is part of the C! library.  A.K.A the cbang library.
+
+                Copyright (c) 2003-2019, Cauldron Development LLC
+                   Copyright (c) 2003-2017, Stanford University
+                               All rights reserved.
+
+         The C! library is free software: you can redistribute it and/or
+        modify it under the terms of the GNU Lesser General Public License
+       as published by the Free Software Foundation, either version 2.1 of
+               the License, or (at your option) any later version.
+
+        The C! library is distributed in the hope that it will be useful,
+          but WITHOUT ANY WARRANTY; without even the implied warranty of
+        MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+                 Lesser General Public License for more details.
+
+         You should have received a copy of the GNU Lesser General Public
+                 License along with the C! library.  If not, see
+                         <http://www.gnu.org/licenses/>.
+
+        In addition, BSD licensing may be granted on a case by case basis
+        by written permission from at least one of the copyright holders.
+           You may request written permission by emailing the authors.
+
+                  For information regarding this software email:
+                                 Joseph Coffland
+                          joseph@cauldrondevelopment.com
+
+\******************************************************************************/
+
+
+#include <cbang/Catch.h>
+#include <cbang/String.h>
+
+#include <cbang/log/BinaryLog.h>
+#include <cbang/log/Logger.h>
+#include <cbang/time/Time.h>
+#include <cbang/config/CommandLine.h>
+#include <cbang/os/SystemUtilities.h>
+
+#include <iostream>
+
+using namespace std;
+using namespace cb;
+
+
+namespace {
+  const char *levelName(int level) {
+    switch (level & Logger::LEVEL_MASK) {
+    case Logger::LEVEL_RAW:      return "";
+    case Logger::LEVEL_ERROR:    return "ERROR";
+    case Logger::LEVEL_CRITICAL: return "CRITICAL";
+    case Logger::LEVEL_WARNING:  return "WARNING";
+    case Logger::LEVEL_INFO:     return "INFO";
+    case Logger::LEVEL_DEBUG:    return "DEBUG";
+    default: return "UNKNOWN";
+    }
+  }
+
+
+  void print(istream &stream, bool showDate, bool showThread,
+             bool showDomain) {
+    BinaryLogReader reader(stream);
+    BinaryLogReader::Record r;
+
+    while (reader.next(r)) {
+      if (r.level != Logger::LEVEL_RAW) {
+        uint64_t secs = r.time / 1000000;
+
+        if (showDate) cout << Time(secs, "%Y-%m-%d:");
+        cout << Time(secs, "%H:%M:%S")
+             << String::printf(".%06u:", (unsigned)(r.time % 1000000));
+
+        if (showThread) cout << r.thread << ':';
+
+        cout << levelName(r.level);
+        int verbosity = r.level >> 8;
+        if (verbosity) cout << '(' << verbosity << ')';
+        cout << ':';
+
+        if (showDomain && !r.domain.empty()) cout << r.domain << ':';
+      }
+
+      cout << r.message << '\n';
+    }
+  }
+}
+
+
+int main(int argc, char *argv[]) {
+  try {
+    bool showDate = true;
+    bool showThread = false;
+    bool showDomain = true;
+
+    CommandLine cmdLine;
+    cmdLine.setUsageArgs("[log files...]");
+    cmdLine.addTarget("date", showDate, "Print dates.");
+    cmdLine.addTarget("thread", showThread, "Print thread IDs.");
+    cmdLine.addTarget("domain", showDomain, "Print log domains.");
+
+    cmdLine.parse(argc, argv);
+
+    const vector<string> &files = cmdLine.getPositionalArgs();
+
+    if (files.empty()) print(cin, showDate, showThread, showDomain);
+
+    for (unsigned i = 0; i < files.size(); i++)
+      print(*SystemUtilities::iopen(files[i]), showDate, showThread,
+            showDomain);
+
+    return 0;
+  } CATCH_ERROR;
+
+  return 1;
+}